@@ -0,0 +1,782 @@
+/**
+ * @file
+ * @brief command line tool that loads BACnet devices with a mix of
+ *  ReadProperty, ReadPropertyMultiple and SubscribeCOV requests, at a
+ *  chosen rate and number of requests in flight, and reports the
+ *  requests per second, the latency percentiles, and the failures.
+ *  The objects can also be kept subscribed for COV during the load.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define PRINT_ENABLED 1
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/abort.h"
+#include "bacnet/apdu.h"
+#include "bacnet/bactext.h"
+#include "bacnet/npdu.h"
+#include "bacnet/reject.h"
+#include "bacnet/version.h"
+/* some demo stuff needed */
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/client/bac-async.h"
+#include "bacnet/basic/client/bac-cov.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/datalink/dlenv.h"
+
+#if BACNET_SVC_SERVER
+#error "App requires server-only features disabled! Set BACNET_SVC_SERVER=0"
+#endif
+
+/* number of --object sets */
+#ifndef BACLOAD_OBJECT_SETS_MAX
+#define BACLOAD_OBJECT_SETS_MAX 8
+#endif
+/* seconds of each COV subscription */
+#ifndef BACLOAD_COV_LIFETIME
+#define BACLOAD_COV_LIFETIME 120
+#endif
+/* subscriber process identifier of the COV subscriptions */
+#ifndef BACLOAD_COV_PROCESS_ID
+#define BACLOAD_COV_PROCESS_ID 1
+#endif
+
+/* the kinds of requests in the mix */
+enum bacload_service {
+    BACLOAD_RP = 0,
+    BACLOAD_RPM = 1,
+    BACLOAD_COV = 2,
+    BACLOAD_SERVICES = 3
+};
+static const char *Service_Name[BACLOAD_SERVICES] = { "rp", "rpm", "cov" };
+
+/* counters of one kind of request */
+struct bacload_counters {
+    unsigned long sent;
+    unsigned long ok;
+    unsigned long errors;
+    unsigned long timeouts;
+    unsigned long aborts;
+    unsigned long rejects;
+};
+
+/* a range of objects of one type */
+struct bacload_object_set {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t first;
+    uint32_t last;
+};
+
+/* a request in flight */
+struct bacload_slot {
+    bool used;
+    enum bacload_service service;
+    unsigned long start;
+};
+
+/* buffer used for receive */
+static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+/* task timer for TSM timeouts */
+static struct mstimer BACnet_TSM_Timer;
+static struct bacload_counters Counters[BACLOAD_SERVICES];
+static struct bacload_slot Slots[BACNET_ASYNC_REQUESTS_MAX];
+static unsigned Slots_In_Flight;
+/* milliseconds of each reply, for the percentiles */
+static uint32_t *Latency;
+static unsigned long Latency_Count;
+static unsigned long Latency_Size;
+static unsigned long COV_Notifications;
+static BACNET_COV_NOTIFICATION COV_Notification_Count;
+/* values of the subscriptions that are kept during the load */
+static unsigned long Subscription_Values;
+/* the properties of each ReadPropertyMultiple */
+static BACNET_PROPERTY_ID RPM_Properties[3] = { PROP_PRESENT_VALUE,
+    PROP_STATUS_FLAGS, PROP_OBJECT_NAME };
+
+/**
+ * @brief Keep the latency of one reply
+ * @param milliseconds - the latency
+ */
+static void latency_add(unsigned long milliseconds)
+{
+    uint32_t *latency;
+    unsigned long size;
+
+    if (Latency_Count >= Latency_Size) {
+        size = Latency_Size ? (Latency_Size * 2) : 4096;
+        latency = realloc(Latency, size * sizeof(*Latency));
+        if (!latency) {
+            return;
+        }
+        Latency = latency;
+        Latency_Size = size;
+    }
+    Latency[Latency_Count++] = (uint32_t)milliseconds;
+}
+
+static int latency_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Get a percentile of the sorted latencies
+ * @param permille - the percentile in tenths of a percent, such as 999
+ * @return the latency in milliseconds
+ */
+static unsigned long latency_percentile(unsigned permille)
+{
+    unsigned long index;
+
+    if (Latency_Count == 0) {
+        return 0;
+    }
+    index = ((Latency_Count * permille) + 999) / 1000;
+    if (index > 0) {
+        index--;
+    }
+
+    return Latency[index];
+}
+
+/**
+ * @brief Count the result of one request as it completes
+ * @param handle [in] handle of the request
+ * @param device_id [in] device instance number of the request
+ * @param rp_data [in] the result of the request
+ * @param value [in] the first decoded value, or NULL
+ * @param context [in] the slot of the request
+ */
+static void request_complete(BACNET_ASYNC_HANDLE handle,
+    uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    void *context)
+{
+    struct bacload_slot *slot = context;
+    struct bacload_counters *counters;
+    BACNET_ERROR_CODE error_code = rp_data->error_code;
+
+    (void)handle;
+    (void)device_id;
+    (void)value;
+    counters = &Counters[slot->service];
+    if ((error_code == ERROR_CODE_ABORT_TSM_TIMEOUT) ||
+        (error_code == ERROR_CODE_TIMEOUT)) {
+        /* no reply, and so no latency */
+        counters->timeouts++;
+    } else {
+        if (error_code == ERROR_CODE_SUCCESS) {
+            counters->ok++;
+        } else if (abort_valid_error_code(error_code)) {
+            counters->aborts++;
+        } else if (reject_valid_error_code(error_code)) {
+            counters->rejects++;
+        } else {
+            counters->errors++;
+        }
+        latency_add(mstimer_now() - slot->start);
+    }
+    slot->used = false;
+    Slots_In_Flight--;
+}
+
+/**
+ * @brief Count a COV notification of our subscriptions
+ * @param cov_data [in] data decoded from the COV notification
+ */
+static void handler_cov_notification_count(BACNET_COV_DATA *cov_data)
+{
+    (void)cov_data;
+    COV_Notifications++;
+}
+
+/**
+ * @brief Count a value of a subscription that is kept during the load,
+ *  from a notification or from a poll
+ * @param id [in] identifier of the subscription
+ * @param cov_data [in] the values
+ * @param context [in] not used
+ */
+static void subscription_value(
+    BACNET_COV_CLIENT_ID id, BACNET_COV_DATA *cov_data, void *context)
+{
+    (void)id;
+    (void)cov_data;
+    (void)context;
+    Subscription_Values++;
+}
+
+/**
+ * @brief Send one request of the mix
+ * @param service - the kind of request
+ * @param device_id - the device
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @param object_property - property of a ReadProperty
+ * @return true if the request was added
+ */
+static bool request_send(enum bacload_service service,
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    BACNET_ASYNC_HANDLE handle = BACNET_ASYNC_HANDLE_NONE;
+    struct bacload_slot *slot = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_ASYNC_REQUESTS_MAX; i++) {
+        if (!Slots[i].used) {
+            slot = &Slots[i];
+            break;
+        }
+    }
+    if (!slot) {
+        return false;
+    }
+    slot->service = service;
+    slot->start = mstimer_now();
+    switch (service) {
+        case BACLOAD_RPM:
+            RPM_Properties[0] = object_property;
+            handle = bacnet_async_read_property_multiple(device_id,
+                object_type, object_instance, RPM_Properties,
+                sizeof(RPM_Properties) / sizeof(RPM_Properties[0]),
+                request_complete, slot);
+            break;
+        case BACLOAD_COV:
+            handle = bacnet_async_subscribe_cov(device_id, object_type,
+                object_instance, BACLOAD_COV_PROCESS_ID, false,
+                BACLOAD_COV_LIFETIME, request_complete, slot);
+            break;
+        default:
+            handle = bacnet_async_read_property(device_id, object_type,
+                object_instance, object_property, BACNET_ARRAY_ALL,
+                request_complete, slot);
+            break;
+    }
+    if (handle == BACNET_ASYNC_HANDLE_NONE) {
+        return false;
+    }
+    slot->used = true;
+    Slots_In_Flight++;
+    Counters[service].sent++;
+
+    return true;
+}
+
+/**
+ * @brief Run the TSM timer, the requests, and the receive of one pass
+ *  of the main loop
+ */
+static void bacload_task(void)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint16_t pdu_len;
+
+    if (mstimer_expired(&BACnet_TSM_Timer)) {
+        mstimer_reset(&BACnet_TSM_Timer);
+        tsm_timer_milliseconds(mstimer_interval(&BACnet_TSM_Timer));
+    }
+    bacnet_async_task();
+    bacnet_cov_client_task();
+    /* returns 0 bytes on timeout */
+    pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, 1);
+    if (pdu_len) {
+        npdu_handler(&src, &Rx_Buf[0], pdu_len);
+    }
+}
+
+/**
+ * @brief Bind to the devices before the load starts, so that the
+ *  binding is not part of the latency of the first requests
+ * @param first - first device instance
+ * @param last - last device instance
+ * @return true if every device was bound within the APDU timeout
+ */
+static bool bacload_bind(uint32_t first, uint32_t last)
+{
+    BACNET_ADDRESS dest = { 0 };
+    struct mstimer timer;
+    unsigned max_apdu = 0;
+    uint32_t device_id;
+    bool bound = false;
+
+    Send_WhoIs(first, last);
+    mstimer_set(&timer, apdu_timeout());
+    while (!bound && !mstimer_expired(&timer)) {
+        bacload_task();
+        bound = true;
+        for (device_id = first; device_id <= last; device_id++) {
+            if (!address_bind_request(device_id, &max_apdu, &dest)) {
+                bound = false;
+                break;
+            }
+        }
+    }
+
+    return bound;
+}
+
+/**
+ * @brief Parse a number, or a range of numbers such as 1-10
+ * @param arg - the argument
+ * @param first [out] the first number
+ * @param last [out] the last number, which is the first for a number
+ * @return true if the argument was a number or a range
+ */
+static bool range_parse(const char *arg, uint32_t *first, uint32_t *last)
+{
+    char *end = NULL;
+
+    *first = (uint32_t)strtoul(arg, &end, 0);
+    if (end == arg) {
+        return false;
+    }
+    *last = *first;
+    if (*end == '-') {
+        arg = end + 1;
+        *last = (uint32_t)strtoul(arg, &end, 0);
+        if (end == arg) {
+            return false;
+        }
+    }
+
+    return (*end == 0) && (*first <= *last);
+}
+
+/**
+ * @brief Parse the request mix, such as rp=8,rpm=1,cov=1
+ * @param arg - the argument
+ * @param weight [out] the weight of each kind of request
+ * @return true if the mix was valid
+ */
+static bool mix_parse(const char *arg, unsigned weight[BACLOAD_SERVICES])
+{
+    const char *name = arg;
+    char *end = NULL;
+    unsigned total = 0;
+    unsigned i;
+    size_t len;
+
+    memset(weight, 0, sizeof(unsigned) * BACLOAD_SERVICES);
+    while (*name) {
+        for (i = 0; i < BACLOAD_SERVICES; i++) {
+            len = strlen(Service_Name[i]);
+            if ((strncmp(name, Service_Name[i], len) == 0) &&
+                ((name[len] == '=') || (name[len] == ':'))) {
+                break;
+            }
+        }
+        if (i >= BACLOAD_SERVICES) {
+            return false;
+        }
+        name += len + 1;
+        weight[i] = (unsigned)strtoul(name, &end, 0);
+        if (end == name) {
+            return false;
+        }
+        total += weight[i];
+        name = end;
+        if (*name == ',') {
+            name++;
+        } else if (*name) {
+            return false;
+        }
+    }
+
+    return total > 0;
+}
+
+/**
+ * @brief Print the counters and the latencies of the load
+ * @param elapsed - milliseconds of the load
+ */
+static void bacload_report(unsigned long elapsed)
+{
+    struct bacload_counters total = { 0 };
+    struct bacload_counters *counters;
+    unsigned long completed;
+    unsigned i;
+
+    printf("%-8s %10s %10s %10s %10s %10s %10s\n", "service", "sent", "ok",
+        "error", "timeout", "abort", "reject");
+    for (i = 0; i < BACLOAD_SERVICES; i++) {
+        counters = &Counters[i];
+        if (counters->sent == 0) {
+            continue;
+        }
+        printf("%-8s %10lu %10lu %10lu %10lu %10lu %10lu\n",
+            Service_Name[i], counters->sent, counters->ok, counters->errors,
+            counters->timeouts, counters->aborts, counters->rejects);
+        total.sent += counters->sent;
+        total.ok += counters->ok;
+        total.errors += counters->errors;
+        total.timeouts += counters->timeouts;
+        total.aborts += counters->aborts;
+        total.rejects += counters->rejects;
+    }
+    printf("%-8s %10lu %10lu %10lu %10lu %10lu %10lu\n", "total", total.sent,
+        total.ok, total.errors, total.timeouts, total.aborts, total.rejects);
+    completed = total.ok + total.errors + total.timeouts + total.aborts +
+        total.rejects;
+    printf("%lu requests completed in %lu.%03lu s: %.1f requests/s\n",
+        completed, elapsed / 1000, elapsed % 1000,
+        elapsed ? ((double)completed * 1000.0 / (double)elapsed) : 0.0);
+    if (Latency_Count) {
+        qsort(Latency, Latency_Count, sizeof(*Latency), latency_compare);
+        printf("latency: p50 %lu ms, p99 %lu ms, p999 %lu ms, "
+               "max %lu ms\n",
+            latency_percentile(500), latency_percentile(990),
+            latency_percentile(999), (unsigned long)Latency[Latency_Count - 1]);
+    }
+    if (Counters[BACLOAD_COV].sent || bacnet_cov_client_count()) {
+        printf("COV notifications received: %lu\n", COV_Notifications);
+    }
+    if (bacnet_cov_client_count()) {
+        printf("subscriptions: %u active, %u polling, %u pending, "
+               "%u retry: %lu values\n",
+            bacnet_cov_client_status_count(BACNET_COV_CLIENT_STATUS_ACTIVE),
+            bacnet_cov_client_status_count(BACNET_COV_CLIENT_STATUS_POLLING),
+            bacnet_cov_client_status_count(BACNET_COV_CLIENT_STATUS_PENDING),
+            bacnet_cov_client_status_count(BACNET_COV_CLIENT_STATUS_RETRY),
+            Subscription_Values);
+    }
+}
+
+/**
+ * @brief Keep a COV subscription to each of the objects of each device
+ *  during the load
+ * @param device_first - first device instance
+ * @param device_last - last device instance
+ * @param objects - the sets of objects
+ * @param object_sets - number of sets of objects
+ * @return number of subscriptions
+ */
+static unsigned bacload_subscribe(uint32_t device_first,
+    uint32_t device_last,
+    const struct bacload_object_set *objects,
+    unsigned object_sets)
+{
+    BACNET_COV_CLIENT_ID id;
+    uint32_t device_id, object_instance, instance;
+    unsigned count = 0;
+    unsigned i;
+
+    for (device_id = device_first; device_id <= device_last; device_id++) {
+        for (i = 0; i < object_sets; i++) {
+            for (instance = objects[i].first; instance <= objects[i].last;
+                 instance++) {
+                object_instance = instance;
+                if ((objects[i].object_type == OBJECT_DEVICE) &&
+                    (object_instance == BACNET_MAX_INSTANCE)) {
+                    object_instance = device_id;
+                }
+                id = bacnet_cov_client_subscribe(device_id,
+                    objects[i].object_type, object_instance, false,
+                    BACLOAD_COV_LIFETIME, subscription_value, NULL);
+                if (id == BACNET_COV_CLIENT_ID_NONE) {
+                    return count;
+                }
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+static void Init_Service_Handlers(void)
+{
+    Device_Init(NULL);
+    /* we need to handle who-is
+       to support dynamic device binding to us */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_IS, handler_who_is);
+    /* set the handler for all the services we don't implement
+       It is required to send the proper reject message... */
+    apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
+    /* we must implement read property - it's required! */
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
+    /* the replies, errors, and binding of our requests */
+    bacnet_async_init();
+    /* the subscriptions that are kept, and their notifications */
+    bacnet_cov_client_init();
+    COV_Notification_Count.callback = handler_cov_notification_count;
+    handler_ucov_notification_add(&COV_Notification_Count);
+}
+
+static void print_usage(char *filename)
+{
+    printf("Usage: %s device-instance[-last]\n", filename);
+    printf("       [--mix rp=N,rpm=N,cov=N][--rate N][--concurrency N]\n");
+    printf("       [--duration seconds][--count N]\n");
+    printf("       [--object object-type instance[-last]]...\n");
+    printf("       [--property property][--subscribe]"
+           "[--version][--help]\n");
+}
+
+static void print_help(char *filename)
+{
+    printf("Load BACnet devices with requests, and report the requests\n"
+           "per second, the latency, and the timeouts and aborts.\n");
+    printf("\n");
+    printf("device-instance[-last]:\n"
+           "BACnet Device Object Instance number, or a range of them,\n"
+           "of the devices to load in turn.\n");
+    printf("\n");
+    printf("--mix rp=N,rpm=N,cov=N:\n"
+           "The weights of ReadProperty, ReadPropertyMultiple of three\n"
+           "properties, and SubscribeCOV requests. The default is rp=1.\n");
+    printf("\n");
+    printf("--rate N:\n"
+           "Requests per second, or 0 to send as fast as the requests\n"
+           "complete. The default is 0.\n");
+    printf("\n");
+    printf("--concurrency N:\n"
+           "Number of requests in flight, from 1 to %u. The default\n"
+           "is 1.\n",
+        (unsigned)BACNET_ASYNC_REQUESTS_MAX);
+    printf("\n");
+    printf("--duration seconds:\n"
+           "Time to send requests. The default is 10 seconds.\n");
+    printf("\n");
+    printf("--count N:\n"
+           "Number of requests to send, or 0 for no limit other than\n"
+           "the duration. The default is 0.\n");
+    printf("\n");
+    printf("--object object-type instance[-last]:\n"
+           "Objects to request in turn, given once or more. The default\n"
+           "is the Device object of each device.\n");
+    printf("\n");
+    printf("--property property:\n"
+           "The property of ReadProperty, and the first property of\n"
+           "ReadPropertyMultiple. The default is present-value, or\n"
+           "object-name for the Device object.\n");
+    printf("\n");
+    printf("--subscribe:\n"
+           "Also keep a COV subscription to each of the objects of each\n"
+           "device during the load, renewed before it expires, and poll\n"
+           "the objects of a device that refuses COV. At most %u.\n",
+        (unsigned)BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX);
+    printf("\n");
+    printf("Example:\n"
+           "To load devices 123 to 126 with 100 requests per second,\n"
+           "8 in flight, to Analog Input 1 to 20, you could send:\n"
+           "%s 123-126 --mix rp=8,rpm=1,cov=1 --rate 100 "
+           "--concurrency 8 --object analog-input 1-20\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    struct bacload_object_set objects[BACLOAD_OBJECT_SETS_MAX];
+    unsigned object_sets = 0;
+    unsigned weight[BACLOAD_SERVICES] = { 1, 0, 0 };
+    unsigned long rate = 0;
+    unsigned long concurrency = 1;
+    unsigned long duration = 10;
+    unsigned long count = 0;
+    uint32_t device_first = 0, device_last = 0;
+    bool device_found = false;
+    unsigned object_property = PROP_PRESENT_VALUE;
+    bool property_found = false;
+    bool subscribe = false;
+    unsigned object_type = 0;
+    unsigned long request = 0;
+    unsigned long start, elapsed;
+    unsigned long devices, objects_count, total_weight, pick;
+    struct bacload_object_set *set;
+    uint32_t device_id, object_instance;
+    enum bacload_service service;
+    unsigned i;
+    int argi = 0;
+    char *filename = NULL;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        } else if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2026 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        } else if (strcmp(argv[argi], "--mix") == 0) {
+            if ((++argi >= argc) || !mix_parse(argv[argi], weight)) {
+                fprintf(stderr, "mix invalid\n");
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--rate") == 0) {
+            if (++argi < argc) {
+                rate = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--concurrency") == 0) {
+            if (++argi < argc) {
+                concurrency = strtoul(argv[argi], NULL, 0);
+            }
+            if ((concurrency == 0) ||
+                (concurrency > BACNET_ASYNC_REQUESTS_MAX)) {
+                fprintf(stderr, "concurrency invalid\n");
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--duration") == 0) {
+            if (++argi < argc) {
+                duration = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--count") == 0) {
+            if (++argi < argc) {
+                count = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--object") == 0) {
+            if (((argi + 2) >= argc) ||
+                (object_sets >= BACLOAD_OBJECT_SETS_MAX)) {
+                fprintf(stderr, "object invalid\n");
+                return 1;
+            }
+            set = &objects[object_sets];
+            if (!bactext_object_type_strtol(argv[argi + 1], &object_type)) {
+                fprintf(stderr, "object-type=%s invalid\n", argv[argi + 1]);
+                return 1;
+            }
+            set->object_type = (BACNET_OBJECT_TYPE)object_type;
+            if (!range_parse(argv[argi + 2], &set->first, &set->last) ||
+                (set->last > BACNET_MAX_INSTANCE)) {
+                fprintf(stderr, "object-instance=%s invalid\n",
+                    argv[argi + 2]);
+                return 1;
+            }
+            object_sets++;
+            argi += 2;
+        } else if (strcmp(argv[argi], "--property") == 0) {
+            if ((++argi >= argc) ||
+                !bactext_property_strtol(argv[argi], &object_property)) {
+                fprintf(stderr, "property invalid\n");
+                return 1;
+            }
+            property_found = true;
+        } else if (strcmp(argv[argi], "--subscribe") == 0) {
+            subscribe = true;
+        } else if (!device_found) {
+            if (!range_parse(argv[argi], &device_first, &device_last) ||
+                (device_last >= BACNET_MAX_INSTANCE)) {
+                fprintf(stderr, "device-instance=%s invalid\n", argv[argi]);
+                return 1;
+            }
+            device_found = true;
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (!device_found) {
+        print_usage(filename);
+        return 0;
+    }
+    if (object_sets == 0) {
+        /* the Device object of each device, which is its own instance */
+        objects[0].object_type = OBJECT_DEVICE;
+        objects[0].first = BACNET_MAX_INSTANCE;
+        objects[0].last = BACNET_MAX_INSTANCE;
+        object_sets = 1;
+        if (!property_found) {
+            object_property = PROP_OBJECT_NAME;
+        }
+    }
+    devices = (unsigned long)(device_last - device_first) + 1;
+    objects_count = 0;
+    for (i = 0; i < object_sets; i++) {
+        objects_count += (objects[i].last - objects[i].first) + 1;
+    }
+    total_weight = 0;
+    for (i = 0; i < BACLOAD_SERVICES; i++) {
+        total_weight += weight[i];
+    }
+    /* setup my info */
+    Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
+    Init_Service_Handlers();
+    dlenv_init();
+    atexit(datalink_cleanup);
+    mstimer_set(&BACnet_TSM_Timer, 50);
+    if (!bacload_bind(device_first, device_last)) {
+        fprintf(stderr, "Error: unable to bind to the devices!\n");
+        return 1;
+    }
+    if (subscribe &&
+        (bacload_subscribe(device_first, device_last, objects, object_sets) <
+            (devices * objects_count))) {
+        fprintf(stderr, "Warning: only %u subscriptions are kept!\n",
+            bacnet_cov_client_count());
+    }
+    start = mstimer_now();
+    for (;;) {
+        elapsed = mstimer_now() - start;
+        if ((elapsed >= (duration * 1000UL)) ||
+            (count && (request >= count))) {
+            if (Slots_In_Flight == 0) {
+                break;
+            }
+        } else {
+            while ((Slots_In_Flight < concurrency) &&
+                (!count || (request < count)) &&
+                (!rate || (request < ((elapsed * rate) / 1000UL) + 1))) {
+                /* each device in turn, then each object, then the mix */
+                pick = (request / devices) % objects_count;
+                set = &objects[0];
+                for (i = 0; i < object_sets; i++) {
+                    set = &objects[i];
+                    if (pick <= (set->last - set->first)) {
+                        break;
+                    }
+                    pick -= (set->last - set->first) + 1;
+                }
+                device_id = device_first + (uint32_t)(request % devices);
+                object_instance = set->first + (uint32_t)pick;
+                if ((set->object_type == OBJECT_DEVICE) &&
+                    (object_instance == BACNET_MAX_INSTANCE)) {
+                    object_instance = device_id;
+                }
+                pick = request % total_weight;
+                for (i = 0; i < BACLOAD_SERVICES; i++) {
+                    if (pick < weight[i]) {
+                        break;
+                    }
+                    pick -= weight[i];
+                }
+                service = (enum bacload_service)i;
+                if (!request_send(service, device_id, set->object_type,
+                        object_instance,
+                        (BACNET_PROPERTY_ID)object_property)) {
+                    break;
+                }
+                request++;
+            }
+        }
+        bacload_task();
+    }
+    elapsed = mstimer_now() - start;
+    bacload_report(elapsed);
+    free(Latency);
+
+    return 0;
+}
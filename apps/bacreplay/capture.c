@@ -0,0 +1,351 @@
+/**
+ * @file
+ * @brief Reader of the capture files of the replay tool: libpcap files
+ *  with microsecond or nanosecond timestamps in either byte order, and
+ *  pcapng files with one or more interfaces, such as the files written
+ *  by Wireshark, tcpdump, and mstpcap.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "capture.h"
+
+/* number of interfaces of a pcapng file */
+#ifndef CAPTURE_INTERFACES_MAX
+#define CAPTURE_INTERFACES_MAX 8
+#endif
+
+#define PCAP_MAGIC_USEC 0xA1B2C3D4UL
+#define PCAP_MAGIC_NSEC 0xA1B23C4DUL
+#define PCAPNG_SECTION_HEADER 0x0A0D0D0AUL
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4DUL
+#define PCAPNG_INTERFACE_DESCRIPTION 1UL
+#define PCAPNG_SIMPLE_PACKET 3UL
+#define PCAPNG_ENHANCED_PACKET 6UL
+#define PCAPNG_OPTION_IF_TSRESOL 9
+
+/* an interface of a pcapng file */
+struct capture_interface {
+    uint32_t link_type;
+    /* power of 10, or of 2 when the high bit is set, of the resolution */
+    uint8_t resolution;
+};
+
+static FILE *Capture_File;
+static bool Capture_Pcapng;
+/* the file was written with the other byte order */
+static bool Capture_Swapped;
+static bool Capture_Nanoseconds;
+static uint32_t Capture_Link_Type;
+static struct capture_interface Capture_Interface[CAPTURE_INTERFACES_MAX];
+static unsigned Capture_Interfaces;
+static uint64_t Capture_Timestamp;
+static unsigned long Capture_Skipped;
+/* a pcapng block, with its header and trailer */
+static uint8_t Capture_Block[CAPTURE_PACKET_MAX + 64];
+
+static uint32_t capture_u32(const uint8_t *buffer)
+{
+    uint32_t value;
+
+    memcpy(&value, buffer, sizeof(value));
+    if (Capture_Swapped) {
+        value = ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) |
+            ((value >> 8) & 0xFF00) | (value >> 24);
+    }
+
+    return value;
+}
+
+static uint16_t capture_u16(const uint8_t *buffer)
+{
+    uint16_t value;
+
+    memcpy(&value, buffer, sizeof(value));
+    if (Capture_Swapped) {
+        value = (uint16_t)((value << 8) | (value >> 8));
+    }
+
+    return value;
+}
+
+/**
+ * @brief Convert a timestamp of a pcapng interface to microseconds
+ * @param ticks - the timestamp in units of the resolution
+ * @param resolution - the if_tsresol of the interface
+ * @return microseconds
+ */
+static uint64_t capture_microseconds(uint64_t ticks, uint8_t resolution)
+{
+    uint64_t mask;
+    unsigned shift, exponent;
+
+    if (resolution & 0x80) {
+        shift = resolution & 0x7F;
+        if (shift >= 64) {
+            return 0;
+        }
+        mask = (((uint64_t)1) << shift) - 1;
+        return ((ticks >> shift) * 1000000ULL) +
+            (((ticks & mask) * 1000000ULL) >> shift);
+    }
+    exponent = resolution;
+    while (exponent < 6) {
+        ticks *= 10;
+        exponent++;
+    }
+    while (exponent > 6) {
+        ticks /= 10;
+        exponent--;
+    }
+
+    return ticks;
+}
+
+/**
+ * @brief Open a capture file, and read its file header
+ * @param filename - name of the file
+ * @return true if the file is a libpcap or pcapng file
+ */
+bool capture_open(const char *filename)
+{
+    uint8_t header[24];
+    uint32_t magic;
+
+    capture_close();
+    Capture_File = fopen(filename, "rb");
+    if (!Capture_File) {
+        return false;
+    }
+    if (fread(header, sizeof(header), 1, Capture_File) != 1) {
+        capture_close();
+        return false;
+    }
+    Capture_Swapped = false;
+    Capture_Pcapng = false;
+    Capture_Interfaces = 0;
+    Capture_Timestamp = 0;
+    Capture_Skipped = 0;
+    magic = capture_u32(&header[0]);
+    if (magic == PCAPNG_SECTION_HEADER) {
+        /* the section header is read again as the first block */
+        Capture_Pcapng = true;
+        rewind(Capture_File);
+        return true;
+    }
+    if ((magic != PCAP_MAGIC_USEC) && (magic != PCAP_MAGIC_NSEC)) {
+        Capture_Swapped = true;
+        magic = capture_u32(&header[0]);
+    }
+    if ((magic != PCAP_MAGIC_USEC) && (magic != PCAP_MAGIC_NSEC)) {
+        capture_close();
+        return false;
+    }
+    Capture_Nanoseconds = (magic == PCAP_MAGIC_NSEC);
+    /* the low 16 bits are the link type, and the others are flags */
+    Capture_Link_Type = capture_u32(&header[20]) & 0xFFFF;
+
+    return true;
+}
+
+/**
+ * @brief Read the next packet of a libpcap file
+ * @param packet [out] the packet
+ * @return true if a packet was read, or false at the end of the file
+ */
+static bool capture_pcap_read(struct capture_packet *packet)
+{
+    uint8_t header[16];
+    uint32_t seconds, fraction, length;
+
+    for (;;) {
+        if (fread(header, sizeof(header), 1, Capture_File) != 1) {
+            return false;
+        }
+        seconds = capture_u32(&header[0]);
+        fraction = capture_u32(&header[4]);
+        length = capture_u32(&header[8]);
+        if (length > sizeof(packet->data)) {
+            if (fseek(Capture_File, (long)length, SEEK_CUR) != 0) {
+                return false;
+            }
+            Capture_Skipped++;
+            continue;
+        }
+        if (length && (fread(packet->data, length, 1, Capture_File) != 1)) {
+            return false;
+        }
+        if (Capture_Nanoseconds) {
+            fraction /= 1000;
+        }
+        packet->timestamp = ((uint64_t)seconds * 1000000ULL) + fraction;
+        packet->link_type = Capture_Link_Type;
+        packet->length = length;
+        return true;
+    }
+}
+
+/**
+ * @brief Keep an interface of a pcapng file, with its link type and the
+ *  resolution of its timestamps
+ * @param body - the body of the Interface Description Block
+ * @param length - number of octets of the body
+ */
+static void capture_pcapng_interface(const uint8_t *body, uint32_t length)
+{
+    struct capture_interface *interface;
+    uint32_t offset = 8;
+    uint16_t code, option_length;
+
+    if ((length < 8) || (Capture_Interfaces >= CAPTURE_INTERFACES_MAX)) {
+        return;
+    }
+    interface = &Capture_Interface[Capture_Interfaces];
+    interface->link_type = capture_u16(&body[0]);
+    interface->resolution = 6;
+    while ((offset + 4) <= length) {
+        code = capture_u16(&body[offset]);
+        option_length = capture_u16(&body[offset + 2]);
+        offset += 4;
+        if ((code == 0) || ((offset + option_length) > length)) {
+            break;
+        }
+        if ((code == PCAPNG_OPTION_IF_TSRESOL) && (option_length >= 1)) {
+            interface->resolution = body[offset];
+        }
+        offset += (option_length + 3U) & ~3U;
+    }
+    Capture_Interfaces++;
+}
+
+/**
+ * @brief Read the next packet of a pcapng file
+ * @param packet [out] the packet
+ * @return true if a packet was read, or false at the end of the file
+ */
+static bool capture_pcapng_read(struct capture_packet *packet)
+{
+    const struct capture_interface *interface;
+    uint32_t type, length, body_length, captured, interface_id;
+    uint64_t ticks;
+    uint8_t *body;
+
+    for (;;) {
+        if (fread(Capture_Block, 8, 1, Capture_File) != 1) {
+            return false;
+        }
+        type = capture_u32(&Capture_Block[0]);
+        if (type == PCAPNG_SECTION_HEADER) {
+            /* each section has its byte order and interfaces */
+            if (fread(&Capture_Block[8], 4, 1, Capture_File) != 1) {
+                return false;
+            }
+            Capture_Swapped = false;
+            if (capture_u32(&Capture_Block[8]) != PCAPNG_BYTE_ORDER_MAGIC) {
+                Capture_Swapped = true;
+            }
+            if (capture_u32(&Capture_Block[8]) != PCAPNG_BYTE_ORDER_MAGIC) {
+                return false;
+            }
+            Capture_Interfaces = 0;
+            length = capture_u32(&Capture_Block[4]);
+            if ((length < 28) ||
+                (fseek(Capture_File, (long)length - 12, SEEK_CUR) != 0)) {
+                return false;
+            }
+            continue;
+        }
+        length = capture_u32(&Capture_Block[4]);
+        if ((length < 12) || (length & 3)) {
+            return false;
+        }
+        if (length > sizeof(Capture_Block)) {
+            if (fseek(Capture_File, (long)length - 8, SEEK_CUR) != 0) {
+                return false;
+            }
+            if ((type == PCAPNG_ENHANCED_PACKET) ||
+                (type == PCAPNG_SIMPLE_PACKET)) {
+                Capture_Skipped++;
+            }
+            continue;
+        }
+        if (fread(&Capture_Block[8], length - 8, 1, Capture_File) != 1) {
+            return false;
+        }
+        body = &Capture_Block[8];
+        body_length = length - 12;
+        if (type == PCAPNG_INTERFACE_DESCRIPTION) {
+            capture_pcapng_interface(body, body_length);
+        } else if ((type == PCAPNG_ENHANCED_PACKET) && (body_length >= 20)) {
+            interface_id = capture_u32(&body[0]);
+            captured = capture_u32(&body[12]);
+            if ((interface_id >= Capture_Interfaces) ||
+                (captured > (body_length - 20))) {
+                Capture_Skipped++;
+                continue;
+            }
+            interface = &Capture_Interface[interface_id];
+            ticks = ((uint64_t)capture_u32(&body[4]) << 32) |
+                capture_u32(&body[8]);
+            Capture_Timestamp =
+                capture_microseconds(ticks, interface->resolution);
+            packet->timestamp = Capture_Timestamp;
+            packet->link_type = interface->link_type;
+            packet->length = captured;
+            memcpy(packet->data, &body[20], captured);
+            return true;
+        } else if ((type == PCAPNG_SIMPLE_PACKET) && (body_length >= 4)) {
+            /* no timestamp, so it is sent with the packet before it */
+            captured = capture_u32(&body[0]);
+            if ((Capture_Interfaces == 0) || (captured > (body_length - 4))) {
+                Capture_Skipped++;
+                continue;
+            }
+            packet->timestamp = Capture_Timestamp;
+            packet->link_type = Capture_Interface[0].link_type;
+            packet->length = captured;
+            memcpy(packet->data, &body[4], captured);
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Read the next packet of the capture file
+ * @param packet [out] the packet
+ * @return true if a packet was read, or false at the end of the file
+ */
+bool capture_read(struct capture_packet *packet)
+{
+    if (!Capture_File || !packet) {
+        return false;
+    }
+    if (Capture_Pcapng) {
+        return capture_pcapng_read(packet);
+    }
+
+    return capture_pcap_read(packet);
+}
+
+/**
+ * @brief Get the number of packets that were too long to read
+ * @return number of packets
+ */
+unsigned long capture_skipped(void)
+{
+    return Capture_Skipped;
+}
+
+/**
+ * @brief Close the capture file
+ */
+void capture_close(void)
+{
+    if (Capture_File) {
+        fclose(Capture_File);
+        Capture_File = NULL;
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @brief API of the reader of the capture files of the replay tool, in
+ *  the libpcap or pcapng formats
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACREPLAY_CAPTURE_H
+#define BACREPLAY_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* largest packet that is read, and longer packets are skipped */
+#ifndef CAPTURE_PACKET_MAX
+#define CAPTURE_PACKET_MAX 2048
+#endif
+
+/* the data link types that are replayed */
+#define CAPTURE_LINK_NULL 0
+#define CAPTURE_LINK_ETHERNET 1
+#define CAPTURE_LINK_RAW 101
+#define CAPTURE_LINK_LINUX_SLL 113
+#define CAPTURE_LINK_BACNET_MS_TP 165
+#define CAPTURE_LINK_IPV4 228
+#define CAPTURE_LINK_LINUX_SLL2 276
+
+/* one packet of a capture file */
+struct capture_packet {
+    /* microseconds since the epoch */
+    uint64_t timestamp;
+    /* data link type of the interface of the packet */
+    uint32_t link_type;
+    uint32_t length;
+    uint8_t data[CAPTURE_PACKET_MAX];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+bool capture_open(const char *filename);
+bool capture_read(struct capture_packet *packet);
+unsigned long capture_skipped(void);
+void capture_close(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,1046 @@
+/**
+ * @file
+ * @brief command line tool that replays the BACnet requests of a capture
+ *  file against a server, at the timing of the capture, N times faster,
+ *  or as fast as the server replies. The requests of BACnet/IP captures
+ *  are sent over UDP to a target such as apps/server, and the requests
+ *  of MS/TP captures from mstpcap are given to a server in this process
+ *  over the loopback datalink. The replies are matched to the requests,
+ *  and the requests per second and the latency of each service are
+ *  reported.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define PRINT_ENABLED 1
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bactext.h"
+#include "bacnet/npdu.h"
+#include "bacnet/version.h"
+/* some demo stuff needed */
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/datalink/datalink.h"
+#include "capture.h"
+
+#if !defined(BACDL_LOOPBACK)
+#error "App requires the loopback datalink! Set BACDL=loopback"
+#endif
+
+/* MAC addresses of the server and of the replay on the loopback network */
+#ifndef BACREPLAY_SERVER_MAC
+#define BACREPLAY_SERVER_MAC 0x01
+#endif
+#ifndef BACREPLAY_CLIENT_MAC
+#define BACREPLAY_CLIENT_MAC 0xFE
+#endif
+/* number of invoke IDs, which limits the requests in flight */
+#define BACREPLAY_INVOKE_IDS 256
+
+/* MS/TP frame types that carry an NPDU */
+#define MSTP_FRAME_DATA_EXPECTING_REPLY 5
+#define MSTP_FRAME_DATA_NOT_EXPECTING_REPLY 6
+#define MSTP_FRAME_HEADER_SIZE 8
+
+/* counters of one service */
+struct bacreplay_counters {
+    unsigned long sent;
+    unsigned long ok;
+    unsigned long errors;
+    unsigned long rejects;
+    unsigned long aborts;
+    unsigned long timeouts;
+    /* microseconds of each reply, for the percentiles */
+    uint32_t *latency;
+    unsigned long latency_count;
+    unsigned long latency_size;
+};
+
+/* a confirmed request in flight, by its invoke ID */
+struct bacreplay_request {
+    bool used;
+    uint8_t service;
+    uint64_t sent;
+};
+
+/* counters of the requests of each service */
+static struct bacreplay_counters Confirmed[MAX_BACNET_CONFIRMED_SERVICE];
+static struct bacreplay_counters Unconfirmed[MAX_BACNET_UNCONFIRMED_SERVICE];
+static struct bacreplay_request Requests[BACREPLAY_INVOKE_IDS];
+static unsigned Requests_In_Flight;
+static unsigned Next_Invoke_ID;
+/* counters of the packets of the capture */
+static unsigned long Packets_Read;
+static unsigned long Packets_Other;
+static unsigned long Packets_Segmented;
+static unsigned long Packets_Unsupported;
+/* replies to requests that timed out, and messages that are not replies */
+static unsigned long Replies_Late;
+static unsigned long Messages_Other;
+
+/* the target: a BACnet/IP server, or the server in this process */
+static bool Target_Loopback;
+static struct sockaddr_in Target_Address;
+static int Target_Socket = -1;
+/* the packets of the capture that are replayed */
+static uint16_t Capture_Port = 0xBAC0;
+static bool Capture_Server_Set;
+static struct in_addr Capture_Server_Address;
+static uint8_t Capture_Server_MAC;
+/* replay speed, where 0 is as fast as the replies allow */
+static double Replay_Speed = 1.0;
+static unsigned Replay_Window = 32;
+static unsigned long Replay_Timeout = 3000;
+
+static uint8_t Receive_Buffer[MAX_MPDU];
+static uint8_t Request_PDU[MAX_MPDU];
+static struct capture_packet Packet;
+
+/**
+ * @brief Get a monotonic time
+ * @return microseconds
+ */
+static uint64_t bacreplay_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000ULL) +
+        ((uint64_t)ts.tv_nsec / 1000ULL);
+}
+
+/**
+ * @brief Keep the latency of one reply
+ * @param counters - counters of the service
+ * @param microseconds - the latency
+ */
+static void latency_add(
+    struct bacreplay_counters *counters, uint64_t microseconds)
+{
+    uint32_t *latency;
+    unsigned long size;
+
+    if (counters->latency_count >= counters->latency_size) {
+        size = counters->latency_size ? (counters->latency_size * 2) : 1024;
+        latency = realloc(counters->latency, size * sizeof(*latency));
+        if (!latency) {
+            return;
+        }
+        counters->latency = latency;
+        counters->latency_size = size;
+    }
+    if (microseconds > UINT32_MAX) {
+        microseconds = UINT32_MAX;
+    }
+    counters->latency[counters->latency_count++] = (uint32_t)microseconds;
+}
+
+static int latency_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Get a percentile of the sorted latencies of a service
+ * @param counters - counters of the service
+ * @param permille - the percentile in tenths of a percent, such as 999
+ * @return the latency in microseconds
+ */
+static unsigned long latency_percentile(
+    const struct bacreplay_counters *counters, unsigned permille)
+{
+    unsigned long index;
+
+    if (counters->latency_count == 0) {
+        return 0;
+    }
+    index = ((counters->latency_count * permille) + 999) / 1000;
+    if (index > 0) {
+        index--;
+    }
+
+    return counters->latency[index];
+}
+
+/**
+ * @brief Find the NPDU of a BVLL message
+ * @param mpdu - the BVLL message
+ * @param mpdu_len - number of octets of the message
+ * @param npdu_len [out] number of octets of the NPDU
+ * @return offset of the NPDU, or 0 if the message does not carry one
+ */
+static unsigned bvlc_npdu_offset(
+    uint8_t *mpdu, unsigned mpdu_len, unsigned *npdu_len)
+{
+    unsigned offset = 0;
+    uint16_t length = 0;
+
+    if ((mpdu_len < 4) || (mpdu[0] != BVLL_TYPE_BACNET_IP)) {
+        return 0;
+    }
+    decode_unsigned16(&mpdu[2], &length);
+    if ((length < 4) || (length > mpdu_len)) {
+        return 0;
+    }
+    if ((mpdu[1] == BVLC_ORIGINAL_UNICAST_NPDU) ||
+        (mpdu[1] == BVLC_ORIGINAL_BROADCAST_NPDU)) {
+        offset = 4;
+    } else if (mpdu[1] == BVLC_FORWARDED_NPDU) {
+        /* after the B/IP address of the originating device */
+        offset = 10;
+    }
+    if ((offset == 0) || (offset >= length)) {
+        return 0;
+    }
+    *npdu_len = length - offset;
+
+    return offset;
+}
+
+/**
+ * @brief Find the NPDU of a BACnet/IP packet of the capture that was
+ *  sent to the captured server
+ * @param packet - the packet, from its link layer header
+ * @param npdu_len [out] number of octets of the NPDU
+ * @return the NPDU, or NULL if the packet is not replayed
+ */
+static uint8_t *bacreplay_bip_npdu(
+    struct capture_packet *packet, unsigned *npdu_len)
+{
+    uint8_t *data = packet->data;
+    unsigned length = packet->length;
+    unsigned offset = 0, header_len, udp_len;
+    uint16_t protocol = 0, fragment = 0, port = 0;
+    struct in_addr destination;
+
+    switch (packet->link_type) {
+        case CAPTURE_LINK_ETHERNET:
+            if (length < 14) {
+                return NULL;
+            }
+            decode_unsigned16(&data[12], &protocol);
+            offset = 14;
+            /* VLAN tags */
+            while (((protocol == 0x8100) || (protocol == 0x88A8)) &&
+                (length >= (offset + 4))) {
+                decode_unsigned16(&data[offset + 2], &protocol);
+                offset += 4;
+            }
+            break;
+        case CAPTURE_LINK_LINUX_SLL:
+            if (length < 16) {
+                return NULL;
+            }
+            decode_unsigned16(&data[14], &protocol);
+            offset = 16;
+            break;
+        case CAPTURE_LINK_LINUX_SLL2:
+            if (length < 20) {
+                return NULL;
+            }
+            decode_unsigned16(&data[0], &protocol);
+            offset = 20;
+            break;
+        case CAPTURE_LINK_NULL:
+            /* the address family, in the byte order of the host */
+            protocol = 0x0800;
+            offset = 4;
+            break;
+        case CAPTURE_LINK_RAW:
+        case CAPTURE_LINK_IPV4:
+            protocol = 0x0800;
+            break;
+        default:
+            return NULL;
+    }
+    if ((protocol != 0x0800) || (length < (offset + 20)) ||
+        ((data[offset] >> 4) != 4)) {
+        return NULL;
+    }
+    header_len = (data[offset] & 0x0F) * 4;
+    decode_unsigned16(&data[offset + 6], &fragment);
+    /* UDP, and not a fragment */
+    if ((header_len < 20) || (data[offset + 9] != 17) ||
+        (fragment & 0x3FFF) || (length < (offset + header_len + 8))) {
+        return NULL;
+    }
+    memcpy(&destination.s_addr, &data[offset + 16], 4);
+    offset += header_len;
+    decode_unsigned16(&data[offset + 2], &port);
+    if ((port != Capture_Port) ||
+        (Capture_Server_Set &&
+            (destination.s_addr != Capture_Server_Address.s_addr))) {
+        return NULL;
+    }
+    decode_unsigned16(&data[offset + 4], &protocol);
+    udp_len = protocol;
+    if ((udp_len < 8) || (length < (offset + udp_len))) {
+        return NULL;
+    }
+    offset += 8;
+    header_len = bvlc_npdu_offset(&data[offset], udp_len - 8, npdu_len);
+    if (header_len == 0) {
+        return NULL;
+    }
+
+    return &data[offset + header_len];
+}
+
+/**
+ * @brief Find the NPDU of an MS/TP frame of the capture that was sent
+ *  to the captured server
+ * @param packet - the frame, from its preamble
+ * @param npdu_len [out] number of octets of the NPDU
+ * @return the NPDU, or NULL if the frame is not replayed
+ */
+static uint8_t *bacreplay_mstp_npdu(
+    struct capture_packet *packet, unsigned *npdu_len)
+{
+    uint8_t *data = packet->data;
+    uint16_t length = 0;
+
+    if ((packet->length < MSTP_FRAME_HEADER_SIZE) || (data[0] != 0x55) ||
+        (data[1] != 0xFF)) {
+        return NULL;
+    }
+    if ((data[2] != MSTP_FRAME_DATA_EXPECTING_REPLY) &&
+        (data[2] != MSTP_FRAME_DATA_NOT_EXPECTING_REPLY)) {
+        return NULL;
+    }
+    if (Capture_Server_Set && (data[3] != Capture_Server_MAC) &&
+        (data[3] != 0xFF)) {
+        return NULL;
+    }
+    decode_unsigned16(&data[5], &length);
+    if ((length == 0) || (packet->length < (MSTP_FRAME_HEADER_SIZE + length))) {
+        return NULL;
+    }
+    *npdu_len = length;
+
+    return &data[MSTP_FRAME_HEADER_SIZE];
+}
+
+/**
+ * @brief Rewrite a captured request for the target. The routing of the
+ *  NPDU is removed, since the request is sent to the target itself, and
+ *  a confirmed request is given one of our invoke IDs and does not
+ *  accept a segmented reply.
+ * @param npdu - the captured NPDU
+ * @param npdu_len - number of octets of the NPDU
+ * @param pdu [out] the request
+ * @param npdu_data [out] the network layer data of the request
+ * @param service [out] the service choice
+ * @param confirmed [out] true for a confirmed request
+ * @param apdu_offset [out] offset of the APDU of the request
+ * @return number of octets of the request, or 0 if it is not replayed
+ */
+static unsigned bacreplay_request_encode(uint8_t *npdu,
+    unsigned npdu_len,
+    uint8_t *pdu,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *service,
+    bool *confirmed,
+    unsigned *apdu_offset)
+{
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    BACNET_NPDU_DATA data = { 0 };
+    uint8_t *apdu;
+    unsigned apdu_len;
+    int offset, len;
+
+    offset = bacnet_npdu_decode(npdu, (uint16_t)npdu_len, &dest, &src, &data);
+    if ((offset <= 0) || ((unsigned)offset >= npdu_len) ||
+        data.network_layer_message) {
+        Packets_Other++;
+        return 0;
+    }
+    apdu = &npdu[offset];
+    apdu_len = npdu_len - offset;
+    switch (apdu[0] & 0xF0) {
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+            if (apdu_len < 4) {
+                Packets_Other++;
+                return 0;
+            }
+            if (apdu[0] & BIT(3)) {
+                Packets_Segmented++;
+                return 0;
+            }
+            *confirmed = true;
+            *service = apdu[3];
+            if (*service >= MAX_BACNET_CONFIRMED_SERVICE) {
+                Packets_Unsupported++;
+                return 0;
+            }
+            break;
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            if (apdu_len < 2) {
+                Packets_Other++;
+                return 0;
+            }
+            *confirmed = false;
+            *service = apdu[1];
+            if (*service >= MAX_BACNET_UNCONFIRMED_SERVICE) {
+                Packets_Unsupported++;
+                return 0;
+            }
+            break;
+        default:
+            /* replies, which the target sends */
+            Packets_Other++;
+            return 0;
+    }
+    npdu_encode_npdu_data(npdu_data, *confirmed, data.priority);
+    len = npdu_encode_pdu(pdu, NULL, NULL, npdu_data);
+    if ((len + apdu_len) > MAX_MPDU) {
+        Packets_Other++;
+        return 0;
+    }
+    memcpy(&pdu[len], apdu, apdu_len);
+    *apdu_offset = len;
+    if (*confirmed) {
+        /* segmented-response-accepted */
+        pdu[len] &= (uint8_t)~BIT(1);
+    }
+
+    return len + apdu_len;
+}
+
+/**
+ * @brief Send a request to the target
+ * @param npdu_data - the network layer data of the request
+ * @param pdu - the request
+ * @param pdu_len - number of octets of the request
+ * @return true if the request was sent
+ */
+static bool bacreplay_send(
+    BACNET_NPDU_DATA *npdu_data, uint8_t *pdu, unsigned pdu_len)
+{
+    BACNET_ADDRESS dest = { 0 };
+    uint8_t mpdu[MAX_MPDU + 4];
+
+    if (Target_Loopback) {
+        dest.mac_len = 1;
+        dest.mac[0] = BACREPLAY_SERVER_MAC;
+        (void)loopback_node_set(BACREPLAY_CLIENT_MAC);
+        return loopback_send_pdu(&dest, npdu_data, pdu, pdu_len) > 0;
+    }
+    mpdu[0] = BVLL_TYPE_BACNET_IP;
+    mpdu[1] = BVLC_ORIGINAL_UNICAST_NPDU;
+    encode_unsigned16(&mpdu[2], (uint16_t)(pdu_len + 4));
+    memcpy(&mpdu[4], pdu, pdu_len);
+
+    return sendto(Target_Socket, mpdu, pdu_len + 4, 0,
+               (struct sockaddr *)&Target_Address,
+               sizeof(Target_Address)) > 0;
+}
+
+/**
+ * @brief Take a free invoke ID for a confirmed request
+ * @return the invoke ID, or BACREPLAY_INVOKE_IDS if none are free
+ */
+static unsigned bacreplay_invoke_id(void)
+{
+    unsigned i, invoke_id;
+
+    for (i = 0; i < BACREPLAY_INVOKE_IDS; i++) {
+        invoke_id = (Next_Invoke_ID + i) % BACREPLAY_INVOKE_IDS;
+        if (!Requests[invoke_id].used) {
+            Next_Invoke_ID = (invoke_id + 1) % BACREPLAY_INVOKE_IDS;
+            return invoke_id;
+        }
+    }
+
+    return BACREPLAY_INVOKE_IDS;
+}
+
+/**
+ * @brief Match a message from the target to a request in flight
+ * @param npdu - the message
+ * @param npdu_len - number of octets of the message
+ */
+static void bacreplay_reply(uint8_t *npdu, unsigned npdu_len)
+{
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    BACNET_NPDU_DATA data = { 0 };
+    struct bacreplay_request *request;
+    struct bacreplay_counters *counters;
+    uint8_t *apdu;
+    uint8_t pdu_type;
+    int offset;
+
+    offset = bacnet_npdu_decode(npdu, (uint16_t)npdu_len, &dest, &src, &data);
+    if ((offset <= 0) || ((unsigned)(offset + 2) > npdu_len) ||
+        data.network_layer_message) {
+        Messages_Other++;
+        return;
+    }
+    apdu = &npdu[offset];
+    pdu_type = apdu[0] & 0xF0;
+    if ((pdu_type == PDU_TYPE_CONFIRMED_SERVICE_REQUEST) ||
+        (pdu_type == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) ||
+        (pdu_type == PDU_TYPE_SEGMENT_ACK)) {
+        /* such as the I-Am replies to Who-Is, and COV notifications */
+        Messages_Other++;
+        return;
+    }
+    request = &Requests[apdu[1]];
+    if (!request->used) {
+        Replies_Late++;
+        return;
+    }
+    counters = &Confirmed[request->service];
+    switch (pdu_type) {
+        case PDU_TYPE_SIMPLE_ACK:
+        case PDU_TYPE_COMPLEX_ACK:
+            counters->ok++;
+            break;
+        case PDU_TYPE_ERROR:
+            counters->errors++;
+            break;
+        case PDU_TYPE_REJECT:
+            counters->rejects++;
+            break;
+        default:
+            counters->aborts++;
+            break;
+    }
+    latency_add(counters, bacreplay_now() - request->sent);
+    request->used = false;
+    Requests_In_Flight--;
+}
+
+/**
+ * @brief Count the requests in flight that were not answered in time
+ * @param now - the time, in microseconds
+ */
+static void bacreplay_timeouts(uint64_t now)
+{
+    struct bacreplay_request *request;
+    unsigned i;
+
+    for (i = 0; (i < BACREPLAY_INVOKE_IDS) && Requests_In_Flight; i++) {
+        request = &Requests[i];
+        if (request->used &&
+            ((now - request->sent) >= (Replay_Timeout * 1000ULL))) {
+            Confirmed[request->service].timeouts++;
+            request->used = false;
+            Requests_In_Flight--;
+        }
+    }
+}
+
+/**
+ * @brief Let the server in this process handle its requests, and take
+ *  the replies from the queue of the replay on the loopback network
+ */
+static void bacreplay_loopback_task(void)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint16_t pdu_len;
+
+    (void)loopback_node_set(BACREPLAY_SERVER_MAC);
+    while ((pdu_len = loopback_receive(
+                &src, Receive_Buffer, sizeof(Receive_Buffer), 0)) > 0) {
+        npdu_handler(&src, Receive_Buffer, pdu_len);
+    }
+    (void)loopback_node_set(BACREPLAY_CLIENT_MAC);
+    while ((pdu_len = loopback_receive(
+                &src, Receive_Buffer, sizeof(Receive_Buffer), 0)) > 0) {
+        bacreplay_reply(Receive_Buffer, pdu_len);
+    }
+}
+
+/**
+ * @brief Receive the replies of the target until a time
+ * @param until - the time to wait until, in microseconds, or 0 to take
+ *  only the replies that are waiting
+ */
+static void bacreplay_receive(uint64_t until)
+{
+    struct pollfd fds = { 0 };
+    uint64_t now;
+    unsigned offset, npdu_len = 0;
+    int timeout, len;
+
+    do {
+        now = bacreplay_now();
+        if (Target_Loopback) {
+            bacreplay_loopback_task();
+        } else {
+            timeout = 0;
+            if (until > (now + 1000)) {
+                /* shorter waits are spent spinning, for the timing */
+                timeout = (int)((until - now) / 1000);
+                if (timeout > 100) {
+                    timeout = 100;
+                }
+            }
+            fds.fd = Target_Socket;
+            fds.events = POLLIN;
+            if (poll(&fds, 1, timeout) > 0) {
+                while ((len = recv(Target_Socket, Receive_Buffer,
+                            sizeof(Receive_Buffer), MSG_DONTWAIT)) > 0) {
+                    offset =
+                        bvlc_npdu_offset(Receive_Buffer, len, &npdu_len);
+                    if (offset) {
+                        bacreplay_reply(&Receive_Buffer[offset], npdu_len);
+                    } else {
+                        Messages_Other++;
+                    }
+                }
+            }
+        }
+        now = bacreplay_now();
+        bacreplay_timeouts(now);
+    } while (now < until);
+}
+
+/**
+ * @brief Replay the requests of the capture file
+ * @param filename - name of the capture file
+ * @return true if the capture file was replayed
+ */
+static bool bacreplay_file(const char *filename)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    struct bacreplay_counters *counters;
+    uint64_t first = 0, start = 0, when, now;
+    unsigned npdu_len = 0, pdu_len, invoke_id = 0, apdu_offset;
+    uint8_t *npdu;
+    uint8_t service = 0;
+    bool confirmed = false;
+    bool started = false;
+
+    if (!capture_open(filename)) {
+        return false;
+    }
+    while (capture_read(&Packet)) {
+        Packets_Read++;
+        if (Packet.link_type == CAPTURE_LINK_BACNET_MS_TP) {
+            npdu = bacreplay_mstp_npdu(&Packet, &npdu_len);
+        } else {
+            npdu = bacreplay_bip_npdu(&Packet, &npdu_len);
+        }
+        if (!npdu) {
+            Packets_Other++;
+            continue;
+        }
+        pdu_len = bacreplay_request_encode(npdu, npdu_len, Request_PDU,
+            &npdu_data, &service, &confirmed, &apdu_offset);
+        if (pdu_len == 0) {
+            continue;
+        }
+        if (!started) {
+            first = Packet.timestamp;
+            start = bacreplay_now();
+            started = true;
+        }
+        if ((Replay_Speed > 0.0) && (Packet.timestamp > first)) {
+            when = start +
+                (uint64_t)((double)(Packet.timestamp - first) / Replay_Speed);
+            bacreplay_receive(when);
+        }
+        if (confirmed) {
+            /* wait for a slot of the window and a free invoke ID */
+            while ((Requests_In_Flight >= Replay_Window) ||
+                ((invoke_id = bacreplay_invoke_id()) >=
+                    BACREPLAY_INVOKE_IDS)) {
+                bacreplay_receive(bacreplay_now() + 1000);
+            }
+            /* the invoke ID follows the PDU type and the max APDU */
+            Request_PDU[apdu_offset + 2] = (uint8_t)invoke_id;
+            counters = &Confirmed[service];
+        } else {
+            counters = &Unconfirmed[service];
+        }
+        now = bacreplay_now();
+        if (!bacreplay_send(&npdu_data, Request_PDU, pdu_len)) {
+            continue;
+        }
+        counters->sent++;
+        if (confirmed) {
+            Requests[invoke_id].used = true;
+            Requests[invoke_id].service = service;
+            Requests[invoke_id].sent = now;
+            Requests_In_Flight++;
+        }
+        bacreplay_receive(0);
+    }
+    capture_close();
+
+    return true;
+}
+
+/**
+ * @brief Print the counters and the latencies of each service
+ * @param elapsed - microseconds of the replay
+ */
+static void bacreplay_report(uint64_t elapsed)
+{
+    struct bacreplay_counters *counters;
+    unsigned long sent = 0, completed = 0;
+    double seconds = (double)elapsed / 1000000.0;
+    unsigned i;
+
+    printf("%-32s %8s %8s %6s %6s %6s %7s %10s %8s %8s %8s\n", "service",
+        "sent", "ok", "error", "reject", "abort", "timeout", "requests/s",
+        "p50 us", "p99 us", "max us");
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        counters = &Confirmed[i];
+        if (counters->sent == 0) {
+            continue;
+        }
+        if (counters->latency_count) {
+            qsort(counters->latency, counters->latency_count,
+                sizeof(*counters->latency), latency_compare);
+        }
+        printf("%-32s %8lu %8lu %6lu %6lu %6lu %7lu %10.1f %8lu %8lu %8lu\n",
+            bactext_confirmed_service_name(i), counters->sent, counters->ok,
+            counters->errors, counters->rejects, counters->aborts,
+            counters->timeouts,
+            seconds > 0.0 ? ((double)counters->sent / seconds) : 0.0,
+            latency_percentile(counters, 500),
+            latency_percentile(counters, 990),
+            latency_percentile(counters, 1000));
+        sent += counters->sent;
+        completed += counters->ok + counters->errors + counters->rejects +
+            counters->aborts;
+    }
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        counters = &Unconfirmed[i];
+        if (counters->sent == 0) {
+            continue;
+        }
+        printf("%-32s %8lu %8s %6s %6s %6s %7s %10.1f\n",
+            bactext_unconfirmed_service_name(i), counters->sent, "-", "-",
+            "-", "-", "-",
+            seconds > 0.0 ? ((double)counters->sent / seconds) : 0.0);
+        sent += counters->sent;
+    }
+    printf("%lu requests replayed in %.3f s: %.1f requests/s, "
+           "%lu confirmed requests answered\n",
+        sent, seconds, seconds > 0.0 ? ((double)sent / seconds) : 0.0,
+        completed);
+    printf("%lu packets read: %lu not requests, %lu segmented, "
+           "%lu unknown services, %lu too long\n",
+        Packets_Read, Packets_Other, Packets_Segmented, Packets_Unsupported,
+        capture_skipped());
+    if (Replies_Late || Messages_Other) {
+        printf("%lu replies after the timeout, %lu other messages "
+               "received\n",
+            Replies_Late, Messages_Other);
+    }
+}
+
+static void Init_Service_Handlers(uint32_t device_id)
+{
+    BACNET_CREATE_OBJECT_DATA object_data = { 0 };
+    unsigned int i = 0;
+
+    Device_Init(NULL);
+    if (device_id <= BACNET_MAX_INSTANCE) {
+        Device_Set_Object_Instance_Number(device_id);
+    }
+    /* an object of each type that can be created, as in apps/server */
+    object_data.object_instance = BACNET_MAX_INSTANCE;
+    for (i = 0; i <= BACNET_OBJECT_TYPE_LAST; i++) {
+        object_data.object_type = i;
+        (void)Device_Create_Object(&object_data);
+    }
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_IS, handler_who_is);
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_HAS, handler_who_has);
+    apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, handler_read_property_multiple);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, handler_write_property);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, handler_write_property_multiple);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_RANGE, handler_read_range);
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_UTC_TIME_SYNCHRONIZATION, handler_timesync_utc);
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_TIME_SYNCHRONIZATION, handler_timesync);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY,
+        handler_cov_subscribe_property);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL,
+        handler_device_communication_control);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_CREATE_OBJECT, handler_create_object);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_DELETE_OBJECT, handler_delete_object);
+    handler_cov_init();
+}
+
+/**
+ * @brief Parse the target, which is loopback or an IPv4 address with
+ *  an optional UDP port
+ * @param arg - the argument
+ * @return true if the target is valid
+ */
+static bool target_parse(const char *arg)
+{
+    char address[32] = { 0 };
+    const char *port;
+    size_t len;
+
+    if (strcmp(arg, "loopback") == 0) {
+        Target_Loopback = true;
+        return true;
+    }
+    Target_Loopback = false;
+    Target_Address.sin_family = AF_INET;
+    Target_Address.sin_port = htons(0xBAC0);
+    port = strchr(arg, ':');
+    len = port ? (size_t)(port - arg) : strlen(arg);
+    if ((len == 0) || (len >= sizeof(address))) {
+        return false;
+    }
+    memcpy(address, arg, len);
+    if (port) {
+        Target_Address.sin_port =
+            htons((uint16_t)strtoul(port + 1, NULL, 0));
+    }
+
+    return inet_pton(AF_INET, address, &Target_Address.sin_addr) == 1;
+}
+
+static void print_usage(char *filename)
+{
+    printf("Usage: %s capture.pcap\n", filename);
+    printf("       [--target address[:port]|loopback][--port N]\n");
+    printf("       [--speed N][--window N][--timeout ms][--repeat N]\n");
+    printf("       [--capture-server address|mac][--capture-port N]\n");
+    printf("       [--instance N][--version][--help]\n");
+}
+
+static void print_help(char *filename)
+{
+    printf("Replay the BACnet requests of a capture file against a\n"
+           "server, and report the requests per second and the latency\n"
+           "of each service.\n");
+    printf("\n");
+    printf("capture.pcap:\n"
+           "A libpcap or pcapng file of BACnet/IP traffic, or of MS/TP\n"
+           "traffic such as a file of mstpcap. Only the requests are\n"
+           "replayed, and segmented requests are skipped.\n");
+    printf("\n");
+    printf("--target address[:port]|loopback:\n"
+           "The BACnet/IP server, such as apps/server, or loopback for\n"
+           "a server in this process on the loopback datalink. The\n"
+           "default is 127.0.0.1:47808 for BACnet/IP captures. MS/TP\n"
+           "captures are always replayed on the loopback datalink.\n");
+    printf("\n");
+    printf("--port N:\n"
+           "The local UDP port of the replay. The default is any port.\n");
+    printf("\n");
+    printf("--speed N:\n"
+           "Replay N times faster than the capture, such as 0.5 or 10,\n"
+           "or 0 to send each request as soon as the window allows.\n"
+           "The default is 1, the timing of the capture.\n");
+    printf("\n");
+    printf("--window N:\n"
+           "Number of confirmed requests in flight, from 1 to 255.\n"
+           "The default is 32.\n");
+    printf("\n");
+    printf("--timeout ms:\n"
+           "Time to wait for each reply. The default is 3000 ms.\n");
+    printf("\n");
+    printf("--repeat N:\n"
+           "Replay the capture N times. The default is 1.\n");
+    printf("\n");
+    printf("--capture-server address|mac:\n"
+           "Only replay the packets sent to this IPv4 address, or to this\n"
+           "MS/TP MAC address, in the capture. The default is all of the\n"
+           "requests of the capture.\n");
+    printf("\n");
+    printf("--capture-port N:\n"
+           "Only replay the packets sent to this UDP port in the capture.\n"
+           "The default is 47808.\n");
+    printf("\n");
+    printf("--instance N:\n"
+           "Device object instance of the server in this process, such\n"
+           "as the instance of the captured server.\n");
+    printf("\n");
+    printf("Example:\n"
+           "To replay a capture at ten times its speed against a server\n"
+           "at 192.168.0.10, you could send:\n"
+           "%s incident.pcap --target 192.168.0.10 --speed 10\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    struct sockaddr_in local = { 0 };
+    unsigned long repeat = 1, i;
+    uint32_t device_id = BACNET_MAX_INSTANCE + 1;
+    uint16_t local_port = 0;
+    uint8_t link_type_mstp = 0;
+    uint64_t start, elapsed;
+    bool target_found = false;
+    char *capture_name = NULL;
+    char *filename = NULL;
+    int argi = 0;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        } else if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2026 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        } else if (strcmp(argv[argi], "--target") == 0) {
+            if ((++argi >= argc) || !target_parse(argv[argi])) {
+                fprintf(stderr, "target invalid\n");
+                return 1;
+            }
+            target_found = true;
+        } else if (strcmp(argv[argi], "--port") == 0) {
+            if (++argi < argc) {
+                local_port = (uint16_t)strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--speed") == 0) {
+            if (++argi < argc) {
+                Replay_Speed = strtod(argv[argi], NULL);
+            }
+            if (Replay_Speed < 0.0) {
+                fprintf(stderr, "speed invalid\n");
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--window") == 0) {
+            if (++argi < argc) {
+                Replay_Window = (unsigned)strtoul(argv[argi], NULL, 0);
+            }
+            if ((Replay_Window == 0) ||
+                (Replay_Window >= BACREPLAY_INVOKE_IDS)) {
+                fprintf(stderr, "window invalid\n");
+                return 1;
+            }
+        } else if (strcmp(argv[argi], "--timeout") == 0) {
+            if (++argi < argc) {
+                Replay_Timeout = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--repeat") == 0) {
+            if (++argi < argc) {
+                repeat = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--capture-server") == 0) {
+            if (++argi >= argc) {
+                fprintf(stderr, "capture-server invalid\n");
+                return 1;
+            }
+            if (inet_pton(AF_INET, argv[argi], &Capture_Server_Address) !=
+                1) {
+                Capture_Server_MAC = (uint8_t)strtoul(argv[argi], NULL, 0);
+            }
+            Capture_Server_Set = true;
+        } else if (strcmp(argv[argi], "--capture-port") == 0) {
+            if (++argi < argc) {
+                Capture_Port = (uint16_t)strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--instance") == 0) {
+            if (++argi < argc) {
+                device_id = (uint32_t)strtoul(argv[argi], NULL, 0);
+            }
+        } else if (!capture_name) {
+            capture_name = argv[argi];
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (!capture_name) {
+        print_usage(filename);
+        return 0;
+    }
+    if (!capture_open(capture_name)) {
+        fprintf(stderr, "Error: unable to read %s!\n", capture_name);
+        return 1;
+    }
+    if (capture_read(&Packet) &&
+        (Packet.link_type == CAPTURE_LINK_BACNET_MS_TP)) {
+        link_type_mstp = 1;
+    }
+    capture_close();
+    if (link_type_mstp) {
+        /* the MS/TP addresses are on the loopback network */
+        Target_Loopback = true;
+    } else if (!target_found) {
+        (void)target_parse("127.0.0.1");
+    }
+    if (Target_Loopback) {
+        Init_Service_Handlers(device_id);
+        if (!loopback_init(NULL) ||
+            !loopback_node_set(BACREPLAY_SERVER_MAC) ||
+            !loopback_node_set(BACREPLAY_CLIENT_MAC)) {
+            fprintf(stderr, "Error: unable to start the loopback network!\n");
+            return 1;
+        }
+        atexit(loopback_cleanup);
+    } else {
+        Target_Socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        local.sin_family = AF_INET;
+        local.sin_port = htons(local_port);
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        if ((Target_Socket < 0) ||
+            (bind(Target_Socket, (struct sockaddr *)&local, sizeof(local)) <
+                0)) {
+            fprintf(stderr, "Error: unable to open the UDP port!\n");
+            return 1;
+        }
+    }
+    start = bacreplay_now();
+    for (i = 0; i < repeat; i++) {
+        if (!bacreplay_file(capture_name)) {
+            fprintf(stderr, "Error: unable to read %s!\n", capture_name);
+            return 1;
+        }
+    }
+    /* the replies of the last requests */
+    while (Requests_In_Flight) {
+        bacreplay_receive(bacreplay_now() + 1000);
+    }
+    elapsed = bacreplay_now() - start;
+    bacreplay_report(elapsed);
+    if (Target_Socket >= 0) {
+        close(Target_Socket);
+    }
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        free(Confirmed[i].latency);
+    }
+
+    return 0;
+}
@@ -32,10 +32,12 @@
 #include "bacnet/version.h"
 /* some demo stuff needed */
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/client/bac-dump.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/filename.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/static_pool.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/datalink/dlenv.h"
@@ -55,6 +57,10 @@
 
 /* buffer used for receive */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+#if BACNET_SEGMENTATION_ENABLED
+/* buffer used to reassemble a segmented reply */
+static uint8_t Reassembly_Buf[BACNET_SEGMENTATION_BUFFER_SIZE];
+#endif
 
 /* target information converted from command line */
 static uint32_t Target_Device_Object_Instance = BACNET_MAX_INSTANCE;
@@ -154,6 +160,8 @@ static bool ShowValues = false;
 static bool ShowDeviceObjectOnly = false;
 /* read required and optional properties when RPM ALL does not work */
 static bool Optional_Properties = false;
+/* number of RPM requests in flight, or 0 to read one object at a time */
+static unsigned Dump_Window = 0;
 
 #if !defined(PRINT_ERRORS)
 #define PRINT_ERRORS 1
@@ -235,7 +243,7 @@ static void MyReadPropertyAckHandler(uint8_t *service_request,
 
     if (address_match(&Target_Address, src) &&
         (service_data->invoke_id == Request_Invoke_ID)) {
-        rp_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+        rp_data = bacnet_calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
         if (rp_data) {
             len = rp_ack_fully_decode_service_request(
                 service_request, service_len, rp_data);
@@ -249,7 +257,7 @@ static void MyReadPropertyAckHandler(uint8_t *service_request,
             if (len < 0) { /* Eg, failed due to no segmentation */
                 Error_Detected = true;
             }
-            free(rp_data);
+            bacnet_free(rp_data);
         }
     }
 }
@@ -264,7 +272,7 @@ static void MyReadPropertyMultipleAckHandler(uint8_t *service_request,
 
     if (address_match(&Target_Address, src) &&
         (service_data->invoke_id == Request_Invoke_ID)) {
-        rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+        rpm_data = bacnet_calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
         if (rpm_data) {
             len = rpm_ack_decode_service_request(
                 service_request, service_len, rpm_data);
@@ -280,7 +288,7 @@ static void MyReadPropertyMultipleAckHandler(uint8_t *service_request,
                 Error_Detected = true;
             }
             rpm_data = rpm_data_free(rpm_data);
-            free(rpm_data);
+            bacnet_free(rpm_data);
         }
     }
 }
@@ -762,7 +770,7 @@ static void PrintReadPropertyData(BACNET_OBJECT_TYPE object_type,
 
         old_value = value;
         value = value->next; /* next or NULL */
-        free(old_value);
+        bacnet_free(old_value);
     } /* End while loop */
 }
 
@@ -790,7 +798,7 @@ static void BuildPropRequest(BACNET_READ_ACCESS_DATA *rpm_object)
     BACNET_PROPERTY_REFERENCE *oldEntry = rpm_object->listOfProperties;
     for (i = 0; Property_Value_List[i].property_id != -1; i++) {
         if (propEntry == NULL) {
-            propEntry = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+            propEntry = bacnet_calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
             assert(propEntry);
             oldEntry->next = propEntry;
         }
@@ -937,7 +945,7 @@ static EPICS_STATES ProcessRPMData(
                 while (value) {
                     old_value = value;
                     value = value->next;
-                    free(old_value);
+                    bacnet_free(old_value);
                 }
             } else if (myState == GET_HEADING_RESPONSE) {
                 Property_Value_List[i++].value = rpm_property->value;
@@ -953,11 +961,11 @@ static EPICS_STATES ProcessRPMData(
             }
             old_rpm_property = rpm_property;
             rpm_property = rpm_property->next;
-            free(old_rpm_property);
+            bacnet_free(old_rpm_property);
         }
         old_rpm_data = rpm_data;
         rpm_data = rpm_data->next;
-        free(old_rpm_data);
+        bacnet_free(old_rpm_data);
     }
 
     /* Now determine the next state */
@@ -989,8 +997,8 @@ static EPICS_STATES ProcessRPMData(
 
 static void print_usage(char *filename)
 {
-    printf("Usage: %s [-v] [-d] [-p sport] [-t target_mac [-n dnet]]"
-           " device-instance\n",
+    printf("Usage: %s [-v] [-d] [-o] [-w window] [-p sport]"
+           " [-t target_mac [-n dnet]] device-instance\n",
         filename);
     printf("       [--version][--help]\n");
 }
@@ -1007,6 +1015,11 @@ static void print_help(char *filename)
     printf("\n");
     printf("-v: show values instead of '?' \n");
     printf("-d: show only device object properties\n");
+    printf("-o: read the optional properties too, when reading all the\n");
+    printf("    properties of an object at once does not work\n");
+    printf("-w: read the objects with a window of ReadPropertyMultiple\n");
+    printf("    requests in flight, such as 4, instead of one at a time.\n");
+    printf("    The device must execute ReadPropertyMultiple.\n");
     printf("-p: Use sport for \"my\" port.  0xBAC0 is default.\n");
     printf("    Allows you to communicate with a localhost target.\n");
     printf("-t: declare target's MAC instead of using Who-Is to bind to  \n");
@@ -1060,6 +1073,11 @@ static int CheckCommandLineArgs(int argc, char *argv[])
                 case 'd':
                     ShowDeviceObjectOnly = true;
                     break;
+                case 'w':
+                    if (++i < argc) {
+                        Dump_Window = (unsigned)strtol(argv[i], NULL, 0);
+                    }
+                    break;
                 case 'p':
                     if (++i < argc) {
 #if defined(BACDL_BIP)
@@ -1388,7 +1406,7 @@ static void StartNextObject(
     Property_List_Index = Property_List_Length = 0;
     rpm_object->object_type = pNewObject->type;
     rpm_object->object_instance = pNewObject->instance;
-    rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+    rpm_property = bacnet_calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
     rpm_object->listOfProperties = rpm_property;
     rpm_object->next = NULL;
     assert(rpm_property);
@@ -1396,6 +1414,198 @@ static void StartNextObject(
     rpm_property->propertyArrayIndex = BACNET_ARRAY_ALL;
 }
 
+/** Decode the values of a property that was read by the dump.
+ *
+ * @param object_type [in] The BACnet Object type of the property.
+ * @param property [in] The property, with its encoded value or error.
+ * @param rpm_property [out] The property, with its list of values
+ *                           to be freed, or its error.
+ */
+static void DumpPropertyValue(BACNET_OBJECT_TYPE object_type,
+    const BACNET_DUMP_PROPERTY *property,
+    BACNET_PROPERTY_REFERENCE *rpm_property)
+{
+    BACNET_APPLICATION_DATA_VALUE *value, *old_value = NULL;
+    uint8_t *apdu = property->application_data;
+    int apdu_len = (int)property->application_data_len;
+    int len;
+
+    rpm_property->propertyIdentifier = property->object_property;
+    rpm_property->propertyArrayIndex = BACNET_ARRAY_ALL;
+    rpm_property->error.error_class = property->error_class;
+    rpm_property->error.error_code = property->error_code;
+    rpm_property->value = NULL;
+    rpm_property->next = NULL;
+    if (property->error_code != ERROR_CODE_SUCCESS) {
+        return;
+    }
+    if (apdu_len == 0) {
+        /* Special case for an empty array - we decode it as null */
+        value = bacnet_calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+        if (value) {
+            bacapp_value_list_init(value, 1);
+        }
+        rpm_property->value = value;
+    }
+    while (apdu_len > 0) {
+        value = bacnet_calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+        if (!value) {
+            break;
+        }
+        len = bacapp_decode_known_property(
+            apdu, apdu_len, value, object_type, property->object_property);
+        if (len < 0) {
+            bacnet_free(value);
+            break;
+        }
+        if (old_value) {
+            old_value->next = value;
+        } else {
+            rpm_property->value = value;
+        }
+        old_value = value;
+        if (len == 0) {
+            /* an empty structure */
+            break;
+        }
+        apdu += len;
+        apdu_len -= len;
+    }
+    if (!rpm_property->value) {
+        rpm_property->error.error_class = ERROR_CLASS_PROPERTY;
+        rpm_property->error.error_code = ERROR_CODE_OTHER;
+    }
+}
+
+/** Print an object that was read by the dump, with its properties in
+ * the order they were read.  For the Device object, the heading is
+ * printed first, from its properties.
+ *
+ * @param object [in] The object that was read.
+ */
+static void PrintDumpObject(const BACNET_DUMP_OBJECT *object)
+{
+    BACNET_PROPERTY_REFERENCE rpm_property;
+    BACNET_PROPERTY_REFERENCE heading_property;
+    unsigned i, j;
+
+    if (object->object_type == OBJECT_DEVICE) {
+        for (i = 0; i < object->property_count; i++) {
+            for (j = 0; Property_Value_List[j].property_id != -1; j++) {
+                if (Property_Value_List[j].property_id ==
+                    (int32_t)object->property[i].object_property) {
+                    /* We won't free these values; they will free at exit */
+                    DumpPropertyValue(object->object_type,
+                        &object->property[i], &heading_property);
+                    Property_Value_List[j].value = heading_property.value;
+                }
+            }
+        }
+        if (!ShowDeviceObjectOnly) {
+            PrintHeading();
+        }
+        Print_Device_Heading();
+    } else {
+        /* Closing brace for the previous Object */
+        printf("  }, \n");
+        /* Opening brace for the new Object */
+        printf("  { \n");
+    }
+    for (i = 0; i < object->property_count; i++) {
+        DumpPropertyValue(
+            object->object_type, &object->property[i], &rpm_property);
+        fprintf(stdout, "    ");
+        Print_Property_Identifier(rpm_property.propertyIdentifier);
+        fprintf(stdout, ": ");
+        PrintReadPropertyData(
+            object->object_type, object->object_instance, &rpm_property);
+    }
+    if (object->object_type == OBJECT_DEVICE) {
+        printf("  -- Found %u Objects \n", bacnet_dump_object_count());
+    }
+}
+
+/** Read the device with a window of ReadPropertyMultiple requests in
+ * flight, each for all the properties of its objects, and print each
+ * object once it is read, in the order of the Object_List.
+ *
+ * @param timeout [in] Milliseconds to wait for a packet.
+ * @param timeout_seconds [in] Seconds without any reply until giving up.
+ */
+static void DumpDevice(unsigned timeout, time_t timeout_seconds)
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_DUMP_OBJECT *object;
+    unsigned max_apdu = 0;
+    uint16_t pdu_len = 0;
+    time_t elapsed_seconds = 0;
+    time_t last_seconds = 0;
+    time_t current_seconds = time(NULL);
+    bool device_printed = false;
+
+    /* keep the binding, since the address cache is initialized again */
+    (void)address_bind_request(
+        Target_Device_Object_Instance, &max_apdu, &dest);
+    bacnet_dump_init();
+    address_add(Target_Device_Object_Instance, max_apdu, &dest);
+    bacnet_dump_window_set(Dump_Window);
+#if BACNET_SEGMENTATION_ENABLED
+    /* accept replies that are too large for one APDU */
+    tsm_reassembly_buffer_set(&Reassembly_Buf[0], sizeof(Reassembly_Buf));
+#endif
+    if (!bacnet_dump_start(
+            Target_Device_Object_Instance, Optional_Properties)) {
+        fprintf(stderr, "\rError: Unable to read the device.\n");
+        return;
+    }
+    while (!bacnet_dump_finished()) {
+        last_seconds = current_seconds;
+        current_seconds = time(NULL);
+        if (current_seconds != last_seconds) {
+            tsm_timer_milliseconds(
+                (uint16_t)((current_seconds - last_seconds) * 1000));
+            datalink_maintenance_timer(current_seconds - last_seconds);
+            elapsed_seconds += (current_seconds - last_seconds);
+        }
+        pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
+        if (pdu_len) {
+            npdu_handler(&src, &Rx_Buf[0], pdu_len);
+            elapsed_seconds = 0;
+        }
+        bacnet_dump_task();
+        /* print the objects that are read, while the others are read */
+        object = bacnet_dump_object_take();
+        while (object) {
+            PrintDumpObject(object);
+            bacnet_dump_object_free(object);
+            device_printed = true;
+            if (ShowDeviceObjectOnly) {
+                break;
+            }
+            object = bacnet_dump_object_take();
+        }
+        if (ShowDeviceObjectOnly && device_printed) {
+            /* Closing brace for the Device Object */
+            printf("  }, \n");
+            return;
+        }
+        if (elapsed_seconds > timeout_seconds) {
+            fprintf(stderr, "\rError: APDU Timeout! (%lds)\n",
+                (long int)elapsed_seconds);
+            break;
+        }
+    }
+    if (bacnet_dump_failed()) {
+        fprintf(stdout, "    -- Failed to get the Object_List \n");
+        Error_Count++;
+    }
+    if (device_printed) {
+        /* Closing brace for the last Object */
+        printf("  } \n");
+    }
+}
+
 /** Main function of the bacepics program.
  *
  * @see Device_Set_Object_Instance_Number, Keylist_Create, address_init,
@@ -1530,8 +1740,15 @@ int main(int argc, char *argv[])
                     }
                     /* else, loop back and try again */
                     continue;
+                } else if (Dump_Window > 0) {
+                    DumpDevice(timeout, timeout_seconds);
+                    /* done with all Objects, signal end of this while loop
+                     */
+                    myState = NEXT_OBJECT;
+                    myObject.type = MAX_BACNET_OBJECT_TYPE;
                 } else {
-                    rpm_object = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+                    rpm_object =
+                        bacnet_calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
                     assert(rpm_object);
                     myState = GET_HEADING_INFO;
                 }
@@ -28,6 +28,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/datalink/dlenv.h"
 /* include the device object */
@@ -37,6 +38,10 @@
 #ifdef BACNET_TEST_VMAC
 #include "bacnet/basic/bbmd6/vmac.h"
 #endif
+#if defined(BACNET_METRICS_HTTP)
+#include "bacnet/basic/service/metrics.h"
+#include "metrics_http.h"
+#endif
 /* me! */
 #include "gateway.h"
 
@@ -60,8 +65,142 @@ int DNET_list[2] = {
 /* current version of the BACnet stack */
 static const char *BACnet_Version = BACNET_VERSION_TEXT;
 
-/* routed devices - I-Am on startup */
-static unsigned Routed_Device_Index;
+/* number of Devices, including the gateway */
+static unsigned Routed_Device_Total = MAX_NUM_DEVICES;
+
+/* number of Analog Input objects of each routed Device */
+#ifndef GATEWAY_POINTS
+#define GATEWAY_POINTS 4
+#endif
+
+/** The object database of a routed Device, which is paged in when the
+ * Device is first accessed, such as from the registers of a Modbus device.
+ */
+struct gateway_database {
+    uint32_t device_instance;
+    float present_value[GATEWAY_POINTS];
+};
+
+static void *Gateway_Database_Create(uint32_t device_instance)
+{
+    struct gateway_database *database;
+    unsigned i;
+
+    database = calloc(1, sizeof(struct gateway_database));
+    if (database) {
+        database->device_instance = device_instance;
+        for (i = 0; i < GATEWAY_POINTS; i++) {
+            database->present_value[i] =
+                (float)((device_instance % 100) + i) / 4.0f;
+        }
+    }
+
+    return database;
+}
+
+static void Gateway_Database_Release(void *database)
+{
+    free(database);
+}
+
+static unsigned Gateway_Database_Object_Count(void *database)
+{
+    (void)database;
+    return GATEWAY_POINTS;
+}
+
+static bool Gateway_Database_Object_List_Identifier(void *database,
+    uint32_t array_index,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *instance)
+{
+    (void)database;
+    if ((array_index == 0) || (array_index > GATEWAY_POINTS)) {
+        return false;
+    }
+    *object_type = OBJECT_ANALOG_INPUT;
+    *instance = array_index - 1;
+
+    return true;
+}
+
+static bool Gateway_Database_Valid_Object_Id(
+    void *database, BACNET_OBJECT_TYPE object_type, uint32_t instance)
+{
+    (void)database;
+    return (object_type == OBJECT_ANALOG_INPUT) && (instance < GATEWAY_POINTS);
+}
+
+static int Gateway_Database_Read_Property(
+    void *database, BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    struct gateway_database *points = database;
+    BACNET_BIT_STRING bit_string;
+    BACNET_CHARACTER_STRING char_string;
+    char text[32];
+    uint8_t *apdu = rpdata->application_data;
+    int apdu_len = 0;
+
+    if (rpdata->array_index != BACNET_ARRAY_ALL) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+    switch (rpdata->object_property) {
+        case PROP_OBJECT_IDENTIFIER:
+            apdu_len = encode_application_object_id(
+                &apdu[0], rpdata->object_type, rpdata->object_instance);
+            break;
+        case PROP_OBJECT_NAME:
+            snprintf(text, sizeof(text), "Point %lu-%lu",
+                (unsigned long)points->device_instance,
+                (unsigned long)rpdata->object_instance);
+            characterstring_init_ansi(&char_string, text);
+            apdu_len =
+                encode_application_character_string(&apdu[0], &char_string);
+            break;
+        case PROP_OBJECT_TYPE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], rpdata->object_type);
+            break;
+        case PROP_PRESENT_VALUE:
+            apdu_len = encode_application_real(
+                &apdu[0], points->present_value[rpdata->object_instance]);
+            break;
+        case PROP_STATUS_FLAGS:
+            bitstring_init(&bit_string);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, false);
+            apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
+            break;
+        case PROP_EVENT_STATE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], EVENT_STATE_NORMAL);
+            break;
+        case PROP_OUT_OF_SERVICE:
+            apdu_len = encode_application_boolean(&apdu[0], false);
+            break;
+        case PROP_UNITS:
+            apdu_len = encode_application_enumerated(&apdu[0], UNITS_NO_UNITS);
+            break;
+        default:
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+    }
+
+    return apdu_len;
+}
+
+/** The provider of the read-only object databases of the routed Devices */
+static const ROUTED_DEVICE_DATABASE_PROVIDER Gateway_Database_Provider = {
+    Gateway_Database_Create, Gateway_Database_Release,
+    Gateway_Database_Object_Count, Gateway_Database_Object_List_Identifier,
+    Gateway_Database_Valid_Object_Id, Gateway_Database_Read_Property, NULL
+};
 
 /** Initialize the Device Objects and each of the child Object instances.
  * @param first_object_instance Set the first (gateway) Device to this
@@ -79,7 +218,7 @@ static void Devices_Init(uint32_t first_object_instance)
     Routed_Device_Set_Description(DEV_DESCR_GATEWAY, strlen(DEV_DESCR_GATEWAY));
 
     /* Now initialize the remote Device objects. */
-    for (i = 1; i < MAX_NUM_DEVICES; i++) {
+    for (i = 1; i < (int)Routed_Device_Total; i++) {
         snprintf(nameText, MAX_DEV_NAME_LEN, "%s %d", DEV_NAME_BASE, i + 1);
         snprintf(descText, MAX_DEV_DESC_LEN, "%s %d", DEV_DESCR_REMOTE, i);
         characterstring_init_ansi(&name_string, nameText);
@@ -101,6 +240,7 @@ static void Initialize_Device_Addresses(void)
     int i = 0; /* First entry is Gateway Device */
     uint32_t virtual_mac = 0;
     BACNET_ADDRESS virtual_address = { 0 };
+    BACNET_ADDRESS device_address = { 0 };
     DEVICE_OBJECT_DATA *pDev = NULL;
     /* Setup info for the main gateway device first */
     pDev = Get_Routed_Device_Object(i);
@@ -122,23 +262,24 @@ static void Initialize_Device_Addresses(void)
 #error "No support for this Data Link Layer type "
 #endif
     bacnet_address_copy(&pDev->bacDevAddr, &virtual_address);
-    /* broadcast an I-Am on startup */
-    Send_I_Am(&Handler_Transmit_Buffer[0]);
 
-    for (i = 1; i < MAX_NUM_DEVICES; i++) {
+    for (i = 1; i < Routed_Device_Count(); i++) {
         pDev = Get_Routed_Device_Object(i);
         if (pDev == NULL) {
             continue;
         }
         /* start with the router address */
-        bacnet_address_copy(&pDev->bacDevAddr, &virtual_address);
+        bacnet_address_copy(&device_address, &virtual_address);
         /* add the network number to each gateway device */
-        pDev->bacDevAddr.net = VIRTUAL_DNET;
+        device_address.net = VIRTUAL_DNET;
         /* use a virtual MAC for each gateway device */
         virtual_mac = pDev->bacObj.Object_Instance_Number;
-        encode_unsigned24(&pDev->bacDevAddr.adr[0], virtual_mac);
-        pDev->bacDevAddr.len = 3;
+        encode_unsigned24(&device_address.adr[0], virtual_mac);
+        device_address.len = 3;
+        Routed_Device_Address_Set(i, &device_address);
     }
+    /* broadcast an I-Am for each Device on startup, paced */
+    routing_who_is_request(NULL, 0, BACNET_MAX_INSTANCE);
 }
 
 /** Initialize the handlers we will utilize.
@@ -148,6 +289,9 @@ static void Init_Service_Handlers(uint32_t first_object_instance)
 {
     Device_Init(NULL);
     Routing_Device_Init(first_object_instance);
+    /* the objects of the routed Devices are created on demand */
+    Routed_Device_Database_Provider_Set(&Gateway_Database_Provider);
+    atexit(Routed_Device_Database_Release_All);
 
     /* we need to handle who-is to support dynamic device binding
      * For the gateway, we will use the unicast variety so we can
@@ -201,7 +345,8 @@ static void Init_Service_Handlers(uint32_t first_object_instance)
  *      tsm_timer_milliseconds
  *
  * @param argc [in] Arg count.
- * @param argv [in] Takes one argument: the Device Instance #.
+ * @param argv [in] Takes the Device Instance # of the gateway, and
+ *  optionally the number of Devices, including the gateway.
  * @return 0 on success.
  */
 int main(int argc, char *argv[])
@@ -214,6 +359,11 @@ int main(int argc, char *argv[])
     uint32_t elapsed_seconds = 0;
     uint32_t elapsed_milliseconds = 0;
     uint32_t first_object_instance = FIRST_DEVICE_NUMBER;
+    struct mstimer who_is_timer = { 0 };
+#if defined(BACNET_METRICS_HTTP)
+    uint32_t uptime_seconds = 0;
+    char *metrics_port = NULL;
+#endif
 #ifdef BACNET_TEST_VMAC
     /* Router data */
     BACNET_DEVICE_PROFILE *device;
@@ -231,17 +381,37 @@ int main(int argc, char *argv[])
             exit(1);
         }
     }
+    if (argc > 2) {
+        Routed_Device_Total = strtoul(argv[2], NULL, 0);
+        if ((Routed_Device_Total == 0) || (Routed_Device_Total >= UINT16_MAX)) {
+            printf("Error: Invalid number of Devices %s \n", argv[2]);
+            exit(1);
+        }
+    }
     printf("BACnet Router Demo\n"
            "BACnet Stack Version %s\n"
            "BACnet Device ID: %u\n"
            "Max APDU: %d\n"
            "Max Devices: %d\n",
-        BACnet_Version, first_object_instance, MAX_APDU, MAX_NUM_DEVICES);
+        BACnet_Version, first_object_instance, MAX_APDU,
+        (int)Routed_Device_Total);
     Init_Service_Handlers(first_object_instance);
     dlenv_init();
     atexit(datalink_cleanup);
     Devices_Init(first_object_instance);
     Initialize_Device_Addresses();
+#if defined(BACNET_METRICS_HTTP)
+    metrics_port = getenv("BACNET_METRICS_PORT");
+    if (metrics_port) {
+        if (metrics_http_start((uint16_t)strtoul(metrics_port, NULL, 0))) {
+            atexit(metrics_http_stop);
+            printf("BACnet Metrics: port %s\n", metrics_port);
+        } else {
+            fprintf(
+                stderr, "BACnet Metrics: port %s failed\n", metrics_port);
+        }
+    }
+#endif
 
 #ifdef BACNET_TEST_VMAC
     /* initialize vmac table and router device */
@@ -250,6 +420,7 @@ int main(int argc, char *argv[])
 #endif
     /* configure the timeout values */
     last_seconds = time(NULL);
+    mstimer_set(&who_is_timer, 0);
 
     /* broadcast an I-am-router-to-network on startup */
     printf("Remote Network DNET Number %d \n", DNET_list[0]);
@@ -260,7 +431,13 @@ int main(int argc, char *argv[])
         /* input */
         current_seconds = time(NULL);
 
-        /* returns 0 bytes on timeout */
+        /* returns 0 bytes on timeout, which is short while the
+           Devices are sending their I-Am */
+        if (routing_who_is_pending()) {
+            timeout = 10;
+        } else {
+            timeout = 1000;
+        }
         pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
 
         /* process */
@@ -277,14 +454,20 @@ int main(int argc, char *argv[])
             Load_Control_State_Machine_Handler();
             elapsed_milliseconds = elapsed_seconds * 1000;
             tsm_timer_milliseconds(elapsed_milliseconds);
+#if defined(BACNET_METRICS_HTTP)
+            uptime_seconds += elapsed_seconds;
+            bacnet_metrics_publish(uptime_seconds);
+#endif
         }
         handler_cov_task();
         /* output */
-        if (Routed_Device_Index < MAX_NUM_DEVICES) {
-            Routed_Device_Index++;
-            Get_Routed_Device_Object(Routed_Device_Index);
-            /* broadcast an I-Am for each routed Device now */
-            Send_I_Am(&Handler_Transmit_Buffer[0]);
+        elapsed_milliseconds = mstimer_elapsed(&who_is_timer);
+        if (elapsed_milliseconds) {
+            mstimer_restart(&who_is_timer);
+            if (elapsed_milliseconds > UINT16_MAX) {
+                elapsed_milliseconds = UINT16_MAX;
+            }
+            routing_who_is_timer((uint16_t)elapsed_milliseconds);
         }
     }
     /* Dummy return */
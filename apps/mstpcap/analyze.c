@@ -0,0 +1,681 @@
+/**
+ * @file
+ * @brief Offline analysis of MS/TP capture files.
+ *
+ * The capture is read in a single streaming pass, so that captures of
+ * many hours can be analyzed in constant memory. Both the libpcap and
+ * the pcapng formats written by mstpcap are read. For each frame, the
+ * time on the wire is derived from its length and the baud rate, and
+ * the frame is compared with the frame before it to find token passes,
+ * token retries, answered and unanswered Poll For Master frames and the
+ * replies to Data Expecting Reply frames.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/crc.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "analyze.h"
+
+/* define our Data Link Type for libPCAP */
+#define DLT_BACNET_MS_TP 165
+/* largest block or record that is kept - the rest is discarded */
+#define ANALYZE_BLOCK_MAX 2048
+/* number of histogram buckets, the last one is open ended */
+#define ANALYZE_BUCKETS 9
+
+/* upper limits of the histogram buckets, in microseconds */
+static const uint32_t Analyze_Bucket_Limit[ANALYZE_BUCKETS - 1] = { 1000,
+    2000, 5000, 10000, 20000, 50000, 100000, 250000 };
+static const char *Analyze_Bucket_Name[ANALYZE_BUCKETS] = { "<1", "<2",
+    "<5", "<10", "<20", "<50", "<100", "<250", ">=250" };
+
+struct analyze_reader {
+    FILE *file;
+    bool pcapng;
+    /* the file was written on a host with the other byte order */
+    bool swapped;
+    /* timestamp units per second */
+    uint64_t ts_units;
+    uint8_t block[ANALYZE_BLOCK_MAX];
+};
+
+struct analyze_latency {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint32_t bucket[ANALYZE_BUCKETS];
+};
+
+struct analyze_station {
+    /* frames sent by the station */
+    uint64_t frames;
+    uint64_t octets;
+    uint64_t busy_ns;
+    /* tokens passed, and tokens passed again to the same station */
+    uint64_t tokens;
+    uint64_t token_retries;
+    uint64_t retry_ns;
+    /* Poll For Master frames sent, such frames that nobody answered,
+       and the time taken by the polls and the waits for a reply */
+    uint64_t pfm;
+    uint64_t pfm_unanswered;
+    uint64_t pfm_ns;
+    /* time between passing the token and passing it again */
+    bool token_seen;
+    uint64_t last_token_ns;
+    struct analyze_latency rotation;
+    /* time to begin using a received token */
+    struct analyze_latency token_usage;
+    /* time to answer a Data Expecting Reply or Test Request frame */
+    struct analyze_latency reply;
+};
+
+struct analyze_state {
+    uint32_t baud;
+    bool started;
+    uint64_t first_ns;
+    uint64_t last_ns;
+    uint64_t frames;
+    uint64_t invalid;
+    uint64_t busy_ns;
+    /* the previous frame */
+    bool prev_valid;
+    uint64_t prev_end_ns;
+    uint8_t prev_type;
+    uint8_t prev_dst;
+    uint8_t prev_src;
+    struct analyze_station station[256];
+};
+
+static struct analyze_reader Analyze_Reader;
+static struct analyze_state Analyze_State;
+
+static uint16_t analyze_u16(
+    const struct analyze_reader *reader, const uint8_t *buffer)
+{
+    uint16_t value;
+
+    memcpy(&value, buffer, sizeof(value));
+    if (reader->swapped) {
+        value = (uint16_t)((value << 8) | (value >> 8));
+    }
+
+    return value;
+}
+
+static uint32_t analyze_u32(
+    const struct analyze_reader *reader, const uint8_t *buffer)
+{
+    uint32_t value;
+
+    memcpy(&value, buffer, sizeof(value));
+    if (reader->swapped) {
+        value = ((value & 0x000000FFUL) << 24) |
+            ((value & 0x0000FF00UL) << 8) | ((value & 0x00FF0000UL) >> 8) |
+            ((value & 0xFF000000UL) >> 24);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Read octets from the capture, discarding the ones that do not
+ *  fit, so that the capture can be a pipe
+ * @param reader - the capture reader
+ * @param buffer - where to store the octets, or NULL to discard them
+ * @param size - size of the buffer
+ * @param length - number of octets to read
+ * @return true if all of the octets were read
+ */
+static bool analyze_read(struct analyze_reader *reader,
+    uint8_t *buffer,
+    size_t size,
+    size_t length)
+{
+    uint8_t discard[256];
+    size_t count;
+
+    if (buffer) {
+        count = length < size ? length : size;
+        if (fread(buffer, 1, count, reader->file) != count) {
+            return false;
+        }
+        length -= count;
+    }
+    while (length > 0) {
+        count = length < sizeof(discard) ? length : sizeof(discard);
+        if (fread(discard, 1, count, reader->file) != count) {
+            return false;
+        }
+        length -= count;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Open a capture file and read its file header
+ * @param reader - the capture reader
+ * @param filename - name of the libpcap or pcapng file
+ * @return true if the file is an MS/TP capture
+ */
+static bool analyze_open(struct analyze_reader *reader, const char *filename)
+{
+    uint8_t *header = reader->block;
+    uint32_t magic;
+    uint32_t length;
+
+    reader->file = fopen(filename, "rb");
+    if (!reader->file) {
+        fprintf(stderr, "mstpcap[analyze]: failed to open %s: %s\n",
+            filename, strerror(errno));
+        return false;
+    }
+    reader->pcapng = false;
+    reader->swapped = false;
+    reader->ts_units = 1000000UL;
+    if (!analyze_read(reader, header, ANALYZE_BLOCK_MAX, 4)) {
+        return false;
+    }
+    memcpy(&magic, header, sizeof(magic));
+    if (magic == 0x0A0D0D0AUL) {
+        /* pcapng Section Header Block */
+        if (!analyze_read(reader, header, ANALYZE_BLOCK_MAX, 8)) {
+            return false;
+        }
+        memcpy(&magic, &header[4], sizeof(magic));
+        if (magic == 0x4D3C2B1AUL) {
+            reader->swapped = true;
+        } else if (magic != 0x1A2B3C4DUL) {
+            fprintf(stderr, "mstpcap[analyze]: invalid byte order\n");
+            return false;
+        }
+        length = analyze_u32(reader, &header[0]);
+        if (length < 12) {
+            return false;
+        }
+        reader->pcapng = true;
+        return analyze_read(reader, NULL, 0, length - 12);
+    }
+    if ((magic == 0xd4c3b2a1UL) || (magic == 0x4d3cb2a1UL)) {
+        reader->swapped = true;
+    }
+    if ((magic == 0xa1b23c4dUL) || (magic == 0x4d3cb2a1UL)) {
+        reader->ts_units = 1000000000UL;
+    } else if ((magic != 0xa1b2c3d4UL) && (magic != 0xd4c3b2a1UL)) {
+        fprintf(stderr, "mstpcap[analyze]: invalid magic number\n");
+        return false;
+    }
+    if (!analyze_read(reader, header, ANALYZE_BLOCK_MAX, 20)) {
+        return false;
+    }
+    if (analyze_u32(reader, &header[16]) != DLT_BACNET_MS_TP) {
+        fprintf(stderr, "mstpcap[analyze]: invalid data link type (DLT)\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the timestamp resolution from the options of a pcapng
+ *  Interface Description Block
+ * @param reader - the capture reader
+ * @param length - length of the block body
+ */
+static void analyze_interface(struct analyze_reader *reader, size_t length)
+{
+    const uint8_t *block = reader->block;
+    size_t offset = 8;
+    uint16_t code, option_length;
+    unsigned i;
+
+    reader->ts_units = 1000000UL;
+    while ((offset + 4) <= length) {
+        code = analyze_u16(reader, &block[offset]);
+        option_length = analyze_u16(reader, &block[offset + 2]);
+        offset += 4;
+        if ((code == 0) || ((offset + option_length) > length)) {
+            break;
+        }
+        if ((code == 9) && (option_length >= 1) && !(block[offset] & 0x80) &&
+            (block[offset] <= 9)) {
+            /* if_tsresol as a power of ten */
+            reader->ts_units = 1;
+            for (i = 0; i < block[offset]; i++) {
+                reader->ts_units *= 10;
+            }
+        }
+        offset += (option_length + 3) & ~3U;
+    }
+}
+
+/**
+ * @brief Read the next frame of the capture
+ * @param reader - the capture reader
+ * @param ts_ns - the timestamp of the frame, in nanoseconds
+ * @param data - the frame
+ * @param length - the number of frame octets that were captured
+ * @return true if a frame was read, false at the end of the capture
+ */
+static bool analyze_next(struct analyze_reader *reader,
+    uint64_t *ts_ns,
+    const uint8_t **data,
+    size_t *length)
+{
+    uint8_t *block = reader->block;
+    uint64_t ts;
+    uint32_t type, block_length, captured;
+    size_t body;
+
+    if (!reader->pcapng) {
+        if (!analyze_read(reader, block, ANALYZE_BLOCK_MAX, 16)) {
+            return false;
+        }
+        ts = (uint64_t)analyze_u32(reader, &block[0]) * reader->ts_units +
+            analyze_u32(reader, &block[4]);
+        captured = analyze_u32(reader, &block[8]);
+        if (!analyze_read(reader, block, ANALYZE_BLOCK_MAX, captured)) {
+            return false;
+        }
+        *ts_ns = ts * (1000000000UL / reader->ts_units);
+        *data = block;
+        *length = captured < ANALYZE_BLOCK_MAX ? captured : ANALYZE_BLOCK_MAX;
+        return true;
+    }
+    for (;;) {
+        if (!analyze_read(reader, block, ANALYZE_BLOCK_MAX, 8)) {
+            return false;
+        }
+        type = analyze_u32(reader, &block[0]);
+        if (type == 0x0A0D0D0AUL) {
+            /* a new section, which may have another byte order */
+            if (!analyze_read(reader, &block[8], 4, 4)) {
+                return false;
+            }
+            memcpy(&type, &block[8], sizeof(type));
+            reader->swapped = (type == 0x4D3C2B1AUL);
+            type = 0x0A0D0D0AUL;
+        }
+        block_length = analyze_u32(reader, &block[4]);
+        if (block_length < 12) {
+            return false;
+        }
+        body = block_length - 12;
+        if (type == 0x0A0D0D0AUL) {
+            /* the rest of the section header and the trailing length */
+            if ((body < 4) || !analyze_read(reader, NULL, 0, body)) {
+                return false;
+            }
+            continue;
+        }
+        if (!analyze_read(reader, block, ANALYZE_BLOCK_MAX, body) ||
+            !analyze_read(reader, NULL, 0, 4)) {
+            return false;
+        }
+        if (body > ANALYZE_BLOCK_MAX) {
+            body = ANALYZE_BLOCK_MAX;
+        }
+        if (type == 1) {
+            analyze_interface(reader, body);
+        } else if ((type == 6) && (body >= 20)) {
+            /* Enhanced Packet Block */
+            ts = ((uint64_t)analyze_u32(reader, &block[4]) << 32) |
+                analyze_u32(reader, &block[8]);
+            captured = analyze_u32(reader, &block[12]);
+            if (captured > (body - 20)) {
+                captured = body - 20;
+            }
+            if (reader->ts_units >= 1000000000UL) {
+                *ts_ns = ts;
+            } else {
+                *ts_ns = ts * (1000000000UL / reader->ts_units);
+            }
+            *data = &block[20];
+            *length = captured;
+            return true;
+        }
+    }
+}
+
+static void analyze_latency_add(struct analyze_latency *latency, uint64_t ns)
+{
+    unsigned i;
+
+    latency->count++;
+    latency->sum_ns += ns;
+    if (ns > latency->max_ns) {
+        latency->max_ns = ns;
+    }
+    for (i = 0; i < (ANALYZE_BUCKETS - 1); i++) {
+        if (ns < ((uint64_t)Analyze_Bucket_Limit[i] * 1000UL)) {
+            break;
+        }
+    }
+    latency->bucket[i]++;
+}
+
+static void analyze_latency_merge(
+    struct analyze_latency *total, const struct analyze_latency *latency)
+{
+    unsigned i;
+
+    total->count += latency->count;
+    total->sum_ns += latency->sum_ns;
+    if (latency->max_ns > total->max_ns) {
+        total->max_ns = latency->max_ns;
+    }
+    for (i = 0; i < ANALYZE_BUCKETS; i++) {
+        total->bucket[i] += latency->bucket[i];
+    }
+}
+
+/**
+ * @brief Determine if a frame type answers a request
+ * @param type - the frame type
+ * @return true if the frame type is a reply or Reply Postponed
+ */
+static bool analyze_reply_frame(uint8_t type)
+{
+    switch (type) {
+        case FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY:
+        case FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY:
+        case FRAME_TYPE_REPLY_POSTPONED:
+        case FRAME_TYPE_TEST_RESPONSE:
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Account for one captured frame
+ * @param state - the analysis so far
+ * @param ts_ns - time at the end of the frame, in nanoseconds
+ * @param data - the frame, starting with the preamble
+ * @param length - number of octets in the frame
+ */
+static void analyze_frame(struct analyze_state *state,
+    uint64_t ts_ns,
+    const uint8_t *data,
+    size_t length)
+{
+    struct analyze_station *station;
+    uint64_t wire_ns, start_ns, gap_ns = 0;
+    uint8_t type, dst, src;
+    bool valid, retry = false;
+
+    /* 10 bits per octet: start, 8 data bits, and stop */
+    wire_ns = ((uint64_t)length * 10ULL * 1000000000ULL) / state->baud;
+    start_ns = ts_ns > wire_ns ? ts_ns - wire_ns : 0;
+    if (!state->started) {
+        state->started = true;
+        state->first_ns = start_ns;
+    } else {
+        if (start_ns < state->prev_end_ns) {
+            /* timestamps are taken when the frame is done, perhaps late */
+            start_ns = state->prev_end_ns;
+            wire_ns = ts_ns > start_ns ? ts_ns - start_ns : 0;
+        }
+        gap_ns = start_ns - state->prev_end_ns;
+    }
+    if (ts_ns > state->last_ns) {
+        state->last_ns = ts_ns;
+    }
+    state->frames++;
+    state->busy_ns += wire_ns;
+    valid = (length >= 8) && (data[0] == 0x55) && (data[1] == 0xFF) &&
+        (CRC_Calc_Header_Buffer(&data[2], 6, 0xFF) == 0x55);
+    if (!valid) {
+        state->invalid++;
+        if (state->prev_valid &&
+            (state->prev_type == FRAME_TYPE_POLL_FOR_MASTER)) {
+            state->station[state->prev_src].pfm_unanswered++;
+            state->station[state->prev_src].pfm_ns += gap_ns;
+        }
+        state->prev_valid = false;
+        state->prev_end_ns = ts_ns;
+        return;
+    }
+    type = data[2];
+    dst = data[3];
+    src = data[4];
+    station = &state->station[src];
+    station->frames++;
+    station->octets += length;
+    station->busy_ns += wire_ns;
+    if (state->prev_valid) {
+        switch (state->prev_type) {
+            case FRAME_TYPE_TOKEN:
+                if ((type == FRAME_TYPE_TOKEN) &&
+                    (src == state->prev_src) && (dst == state->prev_dst)) {
+                    /* the token was not used, so it was passed again */
+                    retry = true;
+                    station->token_retries++;
+                    station->retry_ns += gap_ns + wire_ns;
+                } else if (src == state->prev_dst) {
+                    analyze_latency_add(&station->token_usage, gap_ns);
+                }
+                break;
+            case FRAME_TYPE_POLL_FOR_MASTER:
+                state->station[state->prev_src].pfm_ns += gap_ns;
+                if ((type == FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER) &&
+                    (src == state->prev_dst) && (dst == state->prev_src)) {
+                    state->station[state->prev_src].pfm_ns += wire_ns;
+                } else {
+                    state->station[state->prev_src].pfm_unanswered++;
+                }
+                break;
+            case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
+            case FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY:
+            case FRAME_TYPE_TEST_REQUEST:
+                if ((src == state->prev_dst) && (dst == state->prev_src) &&
+                    analyze_reply_frame(type)) {
+                    analyze_latency_add(&station->reply, gap_ns);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (type == FRAME_TYPE_TOKEN) {
+        station->tokens++;
+        if (!retry) {
+            if (station->token_seen) {
+                analyze_latency_add(
+                    &station->rotation, ts_ns - station->last_token_ns);
+            }
+            station->token_seen = true;
+            station->last_token_ns = ts_ns;
+        }
+    } else if (type == FRAME_TYPE_POLL_FOR_MASTER) {
+        station->pfm++;
+        station->pfm_ns += wire_ns;
+    }
+    state->prev_valid = true;
+    state->prev_end_ns = ts_ns;
+    state->prev_type = type;
+    state->prev_dst = dst;
+    state->prev_src = src;
+}
+
+static double analyze_ms(uint64_t ns)
+{
+    return (double)ns / 1000000.0;
+}
+
+static double analyze_percent(uint64_t ns, uint64_t duration_ns)
+{
+    if (duration_ns == 0) {
+        return 0.0;
+    }
+
+    return ((double)ns * 100.0) / (double)duration_ns;
+}
+
+static double analyze_average_ms(const struct analyze_latency *latency)
+{
+    if (latency->count == 0) {
+        return 0.0;
+    }
+
+    return analyze_ms(latency->sum_ns / latency->count);
+}
+
+static void analyze_histogram_print(FILE *out,
+    const char *title,
+    const struct analyze_latency *latency,
+    unsigned station)
+{
+    unsigned i;
+
+    if (station < 256) {
+        fprintf(out, "%-8u", station);
+    } else {
+        fprintf(out, "%-8s", title);
+    }
+    for (i = 0; i < ANALYZE_BUCKETS; i++) {
+        fprintf(out, "%-8lu", (unsigned long)latency->bucket[i]);
+    }
+    fprintf(out, "%.3f/%.3f\n", analyze_average_ms(latency),
+        analyze_ms(latency->max_ns));
+}
+
+static void analyze_histogram_header(FILE *out, const char *title)
+{
+    unsigned i;
+
+    fprintf(out, "\n==== %s (ms) ====\n", title);
+    fprintf(out, "%-8s", "MAC");
+    for (i = 0; i < ANALYZE_BUCKETS; i++) {
+        fprintf(out, "%-8s", Analyze_Bucket_Name[i]);
+    }
+    fprintf(out, "Avg/Max\n");
+}
+
+static void analyze_print(const struct analyze_state *state, FILE *out)
+{
+    const struct analyze_station *station;
+    struct analyze_latency rotation = { 0 };
+    struct analyze_latency usage = { 0 };
+    struct analyze_latency reply = { 0 };
+    uint64_t duration_ns = 0;
+    uint64_t pfm_ns = 0, retry_ns = 0;
+    uint64_t pfm = 0, pfm_unanswered = 0, retries = 0;
+    unsigned i;
+
+    if (state->last_ns > state->first_ns) {
+        duration_ns = state->last_ns - state->first_ns;
+    }
+    for (i = 0; i < 256; i++) {
+        station = &state->station[i];
+        analyze_latency_merge(&rotation, &station->rotation);
+        analyze_latency_merge(&usage, &station->token_usage);
+        analyze_latency_merge(&reply, &station->reply);
+        pfm += station->pfm;
+        pfm_unanswered += station->pfm_unanswered;
+        pfm_ns += station->pfm_ns;
+        retries += station->token_retries;
+        retry_ns += station->retry_ns;
+    }
+    fprintf(out, "\n==== MS/TP Trace Analysis ====\n");
+    fprintf(out, "Duration: %.3f s at %lu bps\n",
+        (double)duration_ns / 1000000000.0, (unsigned long)state->baud);
+    fprintf(out, "Frames: %lu, Invalid: %lu\n", (unsigned long)state->frames,
+        (unsigned long)state->invalid);
+    fprintf(out, "Bus Utilization: %.2f%%, Idle: %.2f%%\n",
+        analyze_percent(state->busy_ns, duration_ns),
+        100.0 - analyze_percent(state->busy_ns, duration_ns));
+    fprintf(out, "Token Rotation: avg %.3f ms, max %.3f ms, %lu rotations\n",
+        analyze_average_ms(&rotation), analyze_ms(rotation.max_ns),
+        (unsigned long)rotation.count);
+    fprintf(out, "Poll For Master: %lu polls, %lu unanswered, %.2f%% of bus\n",
+        (unsigned long)pfm, (unsigned long)pfm_unanswered,
+        analyze_percent(pfm_ns, duration_ns));
+    fprintf(out, "Token Retries: %lu, %.2f%% of bus\n", (unsigned long)retries,
+        analyze_percent(retry_ns, duration_ns));
+    fprintf(out, "\n==== MS/TP Station Utilization ====\n");
+    fprintf(out, "%-8s%-10s%-12s%-8s%-10s%-8s%-8s%-8s%-8s%-10s%-10s\n", "MAC",
+        "Frames", "Octets", "Util%", "Tokens", "Retries", "PFM", "NoRPFM",
+        "PFM%", "Trot-avg", "Trot-max");
+    for (i = 0; i < 256; i++) {
+        station = &state->station[i];
+        if (station->frames == 0) {
+            continue;
+        }
+        fprintf(out, "%-8u%-10lu%-12lu%-8.2f%-10lu%-8lu%-8lu%-8lu%-8.2f",
+            i, (unsigned long)station->frames,
+            (unsigned long)station->octets,
+            analyze_percent(station->busy_ns, duration_ns),
+            (unsigned long)station->tokens,
+            (unsigned long)station->token_retries,
+            (unsigned long)station->pfm,
+            (unsigned long)station->pfm_unanswered,
+            analyze_percent(station->pfm_ns, duration_ns));
+        fprintf(out, "%-10.3f%-10.3f\n", analyze_average_ms(&station->rotation),
+            analyze_ms(station->rotation.max_ns));
+    }
+    analyze_histogram_header(out, "Reply Latency");
+    for (i = 0; i < 256; i++) {
+        if (state->station[i].reply.count) {
+            analyze_histogram_print(out, NULL, &state->station[i].reply, i);
+        }
+    }
+    analyze_histogram_print(out, "All", &reply, 256);
+    analyze_histogram_header(out, "Token Usage Latency");
+    for (i = 0; i < 256; i++) {
+        if (state->station[i].token_usage.count) {
+            analyze_histogram_print(
+                out, NULL, &state->station[i].token_usage, i);
+        }
+    }
+    analyze_histogram_print(out, "All", &usage, 256);
+    fflush(out);
+}
+
+/**
+ * @brief Analyze an MS/TP capture file in one pass, and print the token
+ *  rotation time, the utilization of each station, the reply latency
+ *  histograms, the retry and Poll For Master overhead, and the
+ *  percentage of time that the bus was idle.
+ * @param filename - name of the libpcap or pcapng capture file
+ * @param baud - baud rate of the captured bus, used for the frame times
+ * @param out - where to print the results
+ * @return true if the capture was read
+ */
+bool mstp_analyze_file(const char *filename, uint32_t baud, FILE *out)
+{
+    struct analyze_reader *reader = &Analyze_Reader;
+    struct analyze_state *state = &Analyze_State;
+    const uint8_t *data = NULL;
+    uint64_t ts_ns = 0;
+    size_t length = 0;
+    bool status;
+
+    memset(state, 0, sizeof(*state));
+    state->baud = baud ? baud : 38400;
+    status = analyze_open(reader, filename);
+    if (status) {
+        while (analyze_next(reader, &ts_ns, &data, &length)) {
+            analyze_frame(state, ts_ns, data, length);
+        }
+        analyze_print(state, out);
+    }
+    if (reader->file) {
+        fclose(reader->file);
+        reader->file = NULL;
+    }
+
+    return status;
+}
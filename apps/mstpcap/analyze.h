@@ -0,0 +1,24 @@
+/**
+ * @file
+ * @brief Offline analysis of MS/TP capture files: token rotation,
+ *  utilization, reply latency, retry and Poll For Master overhead
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef MSTPCAP_ANALYZE_H
+#define MSTPCAP_ANALYZE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+bool mstp_analyze_file(const char *filename, uint32_t baud, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -39,6 +39,9 @@
 #include <string.h>
 #include <errno.h>
 #include <time.h>
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -54,6 +57,7 @@
 /* OS specific includes */
 #include "bacport.h"
 #include "rs485.h"
+#include "analyze.h"
 
 #ifdef _WIN32
 #define strncasecmp(x, y, z) _strnicmp(x, y, z)
@@ -68,6 +72,16 @@
 #endif
 
 #define MSTP_HEADER_MAX (2 + 1 + 1 + 1 + 2 + 1)
+/* largest frame written to the capture: header, data, and data CRC */
+#define MSTP_CAPTURE_FRAME_MAX (MSTP_HEADER_MAX + DLMSTP_MPDU_MAX + 2)
+/* number of frames buffered between the reader and the writer thread.
+   Must be a power of two. */
+#ifndef MSTP_CAPTURE_RING_SIZE
+#define MSTP_CAPTURE_RING_SIZE 1024
+#endif
+#if (MSTP_CAPTURE_RING_SIZE & (MSTP_CAPTURE_RING_SIZE - 1))
+#error MSTP_CAPTURE_RING_SIZE must be a power of two
+#endif
 
 /* local port data - shared with RS-485 */
 static struct mstp_port_struct_t MSTP_Port;
@@ -136,6 +150,8 @@ struct mstp_statistics {
 #define MAX_MSTP_DEVICES 256
 static struct mstp_statistics MSTP_Statistics[MAX_MSTP_DEVICES];
 static uint32_t Invalid_Frame_Count;
+/* frames lost because the writer fell behind the reader */
+static uint32_t Dropped_Frame_Count;
 
 static uint32_t timeval_diff_ms(struct timeval *old, struct timeval *now)
 {
@@ -387,6 +403,10 @@ static void packet_statistics_print(void)
     fprintf(stdout, "Node Count: %u\n", node_count);
     fprintf(stdout, "Invalid Frame Count: %lu\n",
         (long unsigned int)Invalid_Frame_Count);
+    if (Dropped_Frame_Count) {
+        fprintf(stdout, "Dropped Frame Count: %lu\n",
+            (long unsigned int)Dropped_Frame_Count);
+    }
     fflush(stdout);
 }
 
@@ -457,6 +477,36 @@ uint16_t MSTP_Get_Reply(
 
 static char Capture_Filename[64] = "mstp_20090123091200.cap";
 static FILE *File_Handle = NULL; /* stream pointer */
+/* capture file formats */
+#define CAPTURE_FORMAT_PCAP 0
+#define CAPTURE_FORMAT_PCAPNG 1
+static unsigned Capture_Format = CAPTURE_FORMAT_PCAP;
+/* limits which start a new capture file - zero disables the limit */
+static uint32_t Rotate_Packets = 65535;
+static uint64_t Rotate_Bytes;
+static uint32_t Rotate_Seconds;
+/* size, number of packets, and creation time of the capture file */
+static uint64_t File_Bytes;
+static uint32_t File_Packets;
+static time_t File_Time;
+
+/* a received frame waiting to be written to the capture */
+struct mstp_capture_frame {
+    struct timespec ts;
+    uint32_t length;
+    uint8_t data[MSTP_CAPTURE_FRAME_MAX];
+};
+/* single producer (reader), single consumer (writer) ring of frames */
+static struct mstp_capture_frame Capture_Ring[MSTP_CAPTURE_RING_SIZE];
+static unsigned Capture_Head;
+static unsigned Capture_Tail;
+/* one record of the capture file: block header, frame, and trailer */
+static uint8_t Capture_Record[32 + MSTP_CAPTURE_FRAME_MAX + 4];
+#if !defined(_WIN32)
+static pthread_t Capture_Writer;
+static bool Capture_Writer_Running;
+static bool Capture_Writer_Stop;
+#endif
 #if defined(_WIN32)
 static HANDLE Pipe_Handle = INVALID_HANDLE_VALUE; /* pipe handle */
 static void named_pipe_create(char *pipe_name)
@@ -577,6 +627,10 @@ static void filename_create_new(void)
     BACNET_TIME btime;
     char *filename = &Capture_Filename[0];
     size_t filename_size = sizeof(Capture_Filename);
+    const char *extension = "cap";
+    static char last_stamp[24];
+    static unsigned sequence;
+    char stamp[24];
 
     if (Wireshark_Capture) {
         return;
@@ -585,10 +639,26 @@ static void filename_create_new(void)
         fclose(File_Handle);
     }
     File_Handle = NULL;
+    File_Bytes = 0;
+    File_Packets = 0;
+    File_Time = time(NULL);
+    if (Capture_Format == CAPTURE_FORMAT_PCAPNG) {
+        extension = "pcapng";
+    }
     datetime_local(&bdate, &btime, NULL, NULL);
-    snprintf(filename, filename_size, "mstp_%04d%02d%02d%02d%02d%02d.cap",
+    snprintf(stamp, sizeof(stamp), "%04d%02d%02d%02d%02d%02d",
         (int)bdate.year, (int)bdate.month, (int)bdate.day, (int)btime.hour,
         (int)btime.min, (int)btime.sec);
+    if (strcmp(stamp, last_stamp) == 0) {
+        /* rotated more than once within a second */
+        sequence++;
+        snprintf(filename, filename_size, "mstp_%s_%u.%s", stamp, sequence,
+            extension);
+    } else {
+        sequence = 0;
+        snprintf(filename, filename_size, "mstp_%s.%s", stamp, extension);
+    }
+    memcpy(last_stamp, stamp, sizeof(last_stamp));
     File_Handle = fopen(filename, "wb");
     if (File_Handle) {
         fprintf(stdout, "mstpcap: saving capture to %s\n", filename);
@@ -598,51 +668,282 @@ static void filename_create_new(void)
     }
 }
 
-/* write packet to file in libpcap format */
+/**
+ * @brief Store a 16-bit or 32-bit value in host byte order, which is
+ *  what the libpcap and pcapng readers expect from the magic numbers
+ */
+static void capture_put_u16(uint8_t *buffer, uint16_t value)
+{
+    memcpy(buffer, &value, sizeof(value));
+}
+
+static void capture_put_u32(uint8_t *buffer, uint32_t value)
+{
+    memcpy(buffer, &value, sizeof(value));
+}
+
+/* write the file header in libpcap or pcapng format */
 static void write_global_header(void)
 {
-    uint32_t magic_number = 0xa1b2c3d4; /* magic number */
-    uint16_t version_major = 2; /* major version number */
-    uint16_t version_minor = 4; /* minor version number */
-    int32_t thiszone = 0; /* GMT to local correction */
-    uint32_t sigfigs = 0; /* accuracy of timestamps */
-    uint32_t snaplen = 65535; /* max length of captured packets, in octets */
-    uint32_t network = DLT_BACNET_MS_TP; /* data link type - BACNET_MS_TP */
-
-    /* create a new file. */
-    (void)data_write_header(
-        &magic_number, sizeof(magic_number), 1);
-    (void)data_write_header(
-        &version_major, sizeof(version_major), 1);
-    (void)data_write_header(
-        &version_minor, sizeof(version_minor), 1);
-    (void)data_write_header(&thiszone, sizeof(thiszone), 1);
-    (void)data_write_header(&sigfigs, sizeof(sigfigs), 1);
-    (void)data_write_header(&snaplen, sizeof(snaplen), 1);
-    (void)data_write_header(&network, sizeof(network), 1);
-    fflush(File_Handle);
+    uint8_t header[28 + 32] = { 0 };
+    size_t len = 0;
+
+    if (Capture_Format == CAPTURE_FORMAT_PCAPNG) {
+        /* Section Header Block */
+        capture_put_u32(&header[0], 0x0A0D0D0A);
+        capture_put_u32(&header[4], 28);
+        capture_put_u32(&header[8], 0x1A2B3C4D);
+        capture_put_u16(&header[12], 1);
+        capture_put_u16(&header[14], 0);
+        /* section length is not specified */
+        memset(&header[16], 0xFF, 8);
+        capture_put_u32(&header[24], 28);
+        /* Interface Description Block with nanosecond timestamps */
+        capture_put_u32(&header[28], 1);
+        capture_put_u32(&header[32], 32);
+        capture_put_u16(&header[36], DLT_BACNET_MS_TP);
+        capture_put_u16(&header[38], 0);
+        capture_put_u32(&header[40], 65535);
+        /* if_tsresol = 10^-9 */
+        capture_put_u16(&header[44], 9);
+        capture_put_u16(&header[46], 1);
+        header[48] = 9;
+        /* opt_endofopt */
+        capture_put_u32(&header[52], 0);
+        capture_put_u32(&header[56], 32);
+        len = 28 + 32;
+    } else {
+        capture_put_u32(&header[0], 0xa1b2c3d4);
+        /* version 2.4 */
+        capture_put_u16(&header[4], 2);
+        capture_put_u16(&header[6], 4);
+        /* GMT to local correction and accuracy of timestamps */
+        capture_put_u32(&header[8], 0);
+        capture_put_u32(&header[12], 0);
+        /* max length of captured packets, in octets */
+        capture_put_u32(&header[16], 65535);
+        capture_put_u32(&header[20], DLT_BACNET_MS_TP);
+        len = 24;
+    }
+    (void)data_write_header(header, len, 1);
+    File_Bytes += len;
+    if (File_Handle) {
+        fflush(File_Handle);
+    }
+}
+
+/**
+ * @brief Determine if the capture file is full and should be rotated
+ * @param frame - the next frame to be written
+ * @return true if a new capture file is needed
+ */
+static bool capture_rotate_needed(const struct mstp_capture_frame *frame)
+{
+    if (Wireshark_Capture || (File_Packets == 0)) {
+        return false;
+    }
+    if (Rotate_Packets && (File_Packets >= Rotate_Packets)) {
+        return true;
+    }
+    if (Rotate_Bytes && (File_Bytes >= Rotate_Bytes)) {
+        return true;
+    }
+    if (Rotate_Seconds &&
+        ((frame->ts.tv_sec - File_Time) >= (time_t)Rotate_Seconds)) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Write one captured frame as a libpcap record or as a pcapng
+ *  Enhanced Packet Block, rotating the capture file when it is full.
+ *  The record is written with a single call so that a pipe reader
+ *  never sees a partial record.
+ * @param frame - the captured frame
+ */
+static void capture_frame_write(const struct mstp_capture_frame *frame)
+{
+    uint64_t ns;
+    size_t len = 0;
+    size_t pad;
+
+    if (capture_rotate_needed(frame)) {
+        filename_create_new();
+        write_global_header();
+    }
+    if (Capture_Format == CAPTURE_FORMAT_PCAPNG) {
+        pad = (4 - (frame->length % 4)) % 4;
+        len = 32 + frame->length + pad;
+        ns = ((uint64_t)frame->ts.tv_sec * 1000000000ULL) +
+            (uint64_t)frame->ts.tv_nsec;
+        capture_put_u32(&Capture_Record[0], 6);
+        capture_put_u32(&Capture_Record[4], (uint32_t)len);
+        /* interface ID */
+        capture_put_u32(&Capture_Record[8], 0);
+        capture_put_u32(&Capture_Record[12], (uint32_t)(ns >> 32));
+        capture_put_u32(&Capture_Record[16], (uint32_t)ns);
+        capture_put_u32(&Capture_Record[20], frame->length);
+        capture_put_u32(&Capture_Record[24], frame->length);
+        memcpy(&Capture_Record[28], frame->data, frame->length);
+        memset(&Capture_Record[28 + frame->length], 0, pad);
+        capture_put_u32(&Capture_Record[len - 4], (uint32_t)len);
+    } else {
+        capture_put_u32(&Capture_Record[0], (uint32_t)frame->ts.tv_sec);
+        capture_put_u32(&Capture_Record[4], frame->ts.tv_nsec / 1000);
+        capture_put_u32(&Capture_Record[8], frame->length);
+        capture_put_u32(&Capture_Record[12], frame->length);
+        memcpy(&Capture_Record[16], frame->data, frame->length);
+        len = 16 + frame->length;
+    }
+    (void)data_write(Capture_Record, len, 1);
+    File_Bytes += len;
+    File_Packets++;
+}
+
+/**
+ * @brief Get the next free frame of the capture ring
+ * @return the free frame, or NULL if the writer has fallen a full ring
+ *  behind the reader and the frame has to be dropped
+ */
+static struct mstp_capture_frame *capture_frame_next(void)
+{
+#if !defined(_WIN32)
+    unsigned tail;
+
+    if (Capture_Writer_Running) {
+        tail = __atomic_load_n(&Capture_Tail, __ATOMIC_ACQUIRE);
+        if ((Capture_Head - tail) >= MSTP_CAPTURE_RING_SIZE) {
+            return NULL;
+        }
+    }
+#endif
+    return &Capture_Ring[Capture_Head % MSTP_CAPTURE_RING_SIZE];
+}
+
+/**
+ * @brief Hand the frame filled by the reader to the writer thread,
+ *  or write it directly when there is no writer thread
+ * @param frame - the frame from capture_frame_next()
+ */
+static void capture_frame_commit(struct mstp_capture_frame *frame)
+{
+#if !defined(_WIN32)
+    if (Capture_Writer_Running) {
+        __atomic_store_n(&Capture_Head, Capture_Head + 1, __ATOMIC_RELEASE);
+        return;
+    }
+#endif
+    capture_frame_write(frame);
+}
+
+#if !defined(_WIN32)
+/**
+ * @brief Writer thread which drains the capture ring to the file or pipe,
+ *  so that slow storage or a slow pipe reader never stalls the reader
+ * @param arg - not used
+ * @return NULL
+ */
+static void *capture_writer_thread(void *arg)
+{
+    struct timespec idle = { 0, 1000000L };
+    unsigned head;
+    bool flush = false;
+
+    (void)arg;
+    for (;;) {
+        head = __atomic_load_n(&Capture_Head, __ATOMIC_ACQUIRE);
+        if (head == Capture_Tail) {
+            if (__atomic_load_n(&Capture_Writer_Stop, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            if (flush && File_Handle) {
+                /* the reader is quiet, so push out what was written */
+                fflush(File_Handle);
+            }
+            flush = false;
+            nanosleep(&idle, NULL);
+            continue;
+        }
+        capture_frame_write(
+            &Capture_Ring[Capture_Tail % MSTP_CAPTURE_RING_SIZE]);
+        __atomic_store_n(&Capture_Tail, Capture_Tail + 1, __ATOMIC_RELEASE);
+        flush = true;
+    }
+
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Start the writer thread. Without it, the frames are written
+ *  by the reader as they are received.
+ */
+static void capture_writer_start(void)
+{
+#if !defined(_WIN32)
+    Capture_Head = 0;
+    Capture_Tail = 0;
+    Capture_Writer_Stop = false;
+    if (pthread_create(
+            &Capture_Writer, NULL, capture_writer_thread, NULL) == 0) {
+        Capture_Writer_Running = true;
+    }
+#endif
 }
 
+/**
+ * @brief Stop the writer thread after it writes every queued frame
+ */
+static void capture_writer_stop(void)
+{
+#if !defined(_WIN32)
+    if (Capture_Writer_Running) {
+        __atomic_store_n(&Capture_Writer_Stop, true, __ATOMIC_RELEASE);
+        pthread_join(Capture_Writer, NULL);
+        Capture_Writer_Running = false;
+    }
+#endif
+}
+
+/**
+ * @brief Capture the frame that was just received, or that was broken
+ * @param mstp_port - port with the received frame
+ * @param header_len - number of header octets received
+ */
 static void write_received_packet(
     struct mstp_port_struct_t *mstp_port, size_t header_len)
 {
-    uint32_t ts_sec = 0; /* timestamp seconds */
-    uint32_t ts_usec = 0; /* timestamp microseconds */
-    uint32_t incl_len = 0; /* number of octets of packet saved in file */
-    uint32_t orig_len = 0; /* actual length of packet */
     uint32_t data_crc_len = 2;
-    uint8_t header[MSTP_HEADER_MAX] = { 0 }; /* MS/TP header */
+    uint8_t *header;
+    struct mstp_capture_frame *frame;
     struct timeval tv;
     size_t max_data = 0;
 
+#if defined(_WIN32)
     gettimeofday(&tv, NULL);
-    ts_sec = tv.tv_sec;
-    ts_usec = tv.tv_usec;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    tv.tv_sec = ts.tv_sec;
+    tv.tv_usec = ts.tv_nsec / 1000;
+#endif
     if (mstp_port->ReceivedValidFrame) {
         packet_statistics(&tv, mstp_port);
     }
-    (void)data_write(&ts_sec, sizeof(ts_sec), 1);
-    (void)data_write(&ts_usec, sizeof(ts_usec), 1);
+    frame = capture_frame_next();
+    if (!frame) {
+        Dropped_Frame_Count++;
+        return;
+    }
+#if defined(_WIN32)
+    frame->ts.tv_sec = tv.tv_sec;
+    frame->ts.tv_nsec = tv.tv_usec * 1000L;
+#else
+    frame->ts = ts;
+#endif
     if (mstp_port->ReceivedInvalidFrame) {
         if (mstp_port->Index) {
             max_data = min(mstp_port->InputBufferSize, mstp_port->Index);
@@ -652,29 +953,20 @@ static void write_received_packet(
                     so only 1 for checksum */
                 data_crc_len = 1;
             }
-            incl_len = orig_len = header_len + max_data + data_crc_len;
-        } else {
-            /* header only */
-            incl_len = orig_len = header_len;
-        }
-    } else {
-        if (mstp_port->DataLength) {
-            max_data =
-                min(mstp_port->InputBufferSize, mstp_port->DataLength);
-            incl_len = orig_len = header_len + max_data + data_crc_len;
-        } else {
-            /* header only - or at least some bytes of the header */
-            incl_len = orig_len = header_len;
         }
+    } else if (mstp_port->DataLength) {
+        max_data = min(mstp_port->InputBufferSize, mstp_port->DataLength);
     }
-    (void)data_write(&incl_len, sizeof(incl_len), 1);
-    (void)data_write(&orig_len, sizeof(orig_len), 1);
+    max_data = min(max_data, DLMSTP_MPDU_MAX);
+    header = &frame->data[0];
+    memset(header, 0, MSTP_HEADER_MAX);
     if (header_len == 1) {
         header[0] = mstp_port->DataRegister;
     } else if (header_len == 2) {
         header[0] = 0x55;
         header[1] = mstp_port->DataRegister;
     } else {
+        header_len = min(header_len, MSTP_HEADER_MAX);
         header[0] = 0x55;
         header[1] = 0xFF;
         header[2] = mstp_port->FrameType;
@@ -684,12 +976,14 @@ static void write_received_packet(
         header[6] = LO_BYTE(mstp_port->DataLength);
         header[7] = mstp_port->HeaderCRCActual;
     }
-    (void)data_write(header, header_len, 1);
+    frame->length = header_len;
     if (max_data) {
-        (void)data_write(mstp_port->InputBuffer, max_data, 1);
-        (void)data_write((char *)&mstp_port->DataCRCActualMSB, 1, 1);
-        (void)data_write((char *)&mstp_port->DataCRCActualLSB, 1, 1);
+        memcpy(&frame->data[header_len], mstp_port->InputBuffer, max_data);
+        frame->data[header_len + max_data] = mstp_port->DataCRCActualMSB;
+        frame->data[header_len + max_data + 1] = mstp_port->DataCRCActualLSB;
+        frame->length += max_data + data_crc_len;
     }
+    capture_frame_commit(frame);
 }
 
 /* read header from file in libpcap format */
@@ -774,7 +1068,6 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
     uint8_t header[8] = { 0 }; /* MS/TP header */
     struct timeval tv;
     size_t count = 0;
-    unsigned i = 0;
 
     if (File_Handle) {
         count = fread(&ts_sec, sizeof(ts_sec), 1, File_Handle);
@@ -814,11 +1107,7 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
         mstp_port->SourceAddress = header[4];
         mstp_port->DataLength = MAKE_WORD(header[6], header[5]);
         mstp_port->HeaderCRCActual = header[7];
-        mstp_port->HeaderCRC = 0xFF;
-        for (i = 2; i < 8; i++) {
-            mstp_port->HeaderCRC =
-                CRC_Calc_Header(header[i], mstp_port->HeaderCRC);
-        }
+        mstp_port->HeaderCRC = CRC_Calc_Header_Buffer(&header[2], 6, 0xFF);
         if (mstp_port->HeaderCRC == 0x55) {
             mstp_port->ReceivedValidFrame = true;
             mstp_port->ReceivedInvalidFrame = false;
@@ -851,11 +1140,8 @@ static bool read_received_packet(struct mstp_port_struct_t *mstp_port)
                 File_Handle = NULL;
                 return false;
             }
-            mstp_port->DataCRC = 0xFFFF;
-            for (i = 0; i < mstp_port->DataLength; i++) {
-                mstp_port->DataCRC = CRC_Calc_Data(
-                    mstp_port->InputBuffer[i], mstp_port->DataCRC);
-            }
+            mstp_port->DataCRC = CRC_Calc_Data_Buffer(
+                mstp_port->InputBuffer, mstp_port->DataLength, 0xFFFF);
             mstp_port->DataCRC =
                 CRC_Calc_Data(mstp_port->DataCRCActualMSB, mstp_port->DataCRC);
             mstp_port->DataCRC =
@@ -887,6 +1173,13 @@ static void cleanup(void)
     if (!Wireshark_Capture) {
         packet_statistics_print();
     }
+    capture_writer_stop();
+#if !defined(_WIN32)
+    if (FD_Pipe != -1) {
+        close(FD_Pipe);
+        FD_Pipe = -1;
+    }
+#endif
     if (File_Handle) {
         fflush(File_Handle); /* stream pointer */
         fclose(File_Handle); /* stream pointer */
@@ -918,9 +1211,7 @@ static BOOL WINAPI CtrlCHandler(DWORD dwCtrlType)
 static void sig_int(int signo)
 {
     (void)signo;
-    if (FD_Pipe != -1) {
-        close(FD_Pipe);
-    }
+    /* the pipe is closed at exit, after the queued frames are written */
     Exit_Requested = true;
     exit(0);
 }
@@ -936,10 +1227,15 @@ static void signal_init(void)
 static void print_usage(char *filename)
 {
     printf("Usage: %s", filename);
-    printf(" [--scan <filename>]\n");
+    printf(" [--scan <filename>][--analyze <filename>]\n");
     printf(" [--extcap-interface port]\n");
     printf(" [--extcap-interfaces][--extcap-dlts][--extcap-config]\n");
     printf(" [--capture][--baud baud][--fifo pipe]\n");
+#if !defined(_WIN32)
+    printf(" [--stdout]\n");
+#endif
+    printf(" [--pcapng][--rotate-packets count][--rotate-size bytes]\n");
+    printf(" [--rotate-time seconds]\n");
     printf(" [--version][--help]\n");
 }
 
@@ -948,11 +1244,19 @@ static void print_help(char *filename)
     printf("%s --scan <filename>\n"
            "perform statistic analysis on MS/TP capture file.\n",
         filename);
+    printf("%s [--baud baud] --analyze <filename>\n"
+           "compute token rotation, utilization, reply latency, retry\n"
+           "and Poll For Master overhead, and bus idle time of a libpcap\n"
+           "or pcapng MS/TP capture file in a single pass. The baud rate\n"
+           "of the captured bus sets the time of each frame on the wire.\n",
+        filename);
     printf("\n");
     printf("Captures MS/TP packets from a serial interface\n"
         "and writes them to a file or a pipe, or scans a file for stats."
         "Filename is of the form mstp_20090123091200.cap (timestamp).\n"
-        "New files are created after receiving 65535 packets.\n");
+        "New files are created after receiving 65535 packets.\n"
+        "Frames are handed off to a writer thread, so that slow storage\n"
+        "or a slow pipe reader does not cause frames to be missed.\n");
     printf("\n");
     printf("Command line options:\n"
            "[--extcap-interface port] - serial interface.\n"
@@ -970,7 +1274,17 @@ static void print_help(char *filename)
 #else
            "    Supported values: any file name\n"
 #endif
-           "    Use that name as the interface name in Wireshark.\n");
+           "    Use that name as the interface name in Wireshark.\n"
+#if !defined(_WIN32)
+           "[--stdout] - write the capture to standard output,\n"
+           "    for example to pipe it into wireshark -k -i -\n"
+#endif
+           "[--pcapng] - write pcapng with nanosecond timestamps\n"
+           "    instead of libpcap. The --scan option reads libpcap.\n"
+           "[--rotate-packets count] - start a new file after count\n"
+           "    packets. Defaults to 65535. Zero disables the limit.\n"
+           "[--rotate-size bytes] - start a new file after bytes.\n"
+           "[--rotate-time seconds] - start a new file after seconds.\n");
     printf("\n");
     printf("%s [--extcap-interfaces][--extcap-dlts][--extcap-config]\n"
            "[--capture][--baud baud][--fifo pipe]\n"
@@ -1005,6 +1319,7 @@ int main(int argc, char *argv[])
     uint32_t header_len = 0;
     int argi = 0;
     char *filename = NULL;
+    char *analyze_filename = NULL;
 
     MSTP_Port.InputBuffer = &RxBuffer[0];
     MSTP_Port.InputBufferSize = sizeof(RxBuffer);
@@ -1058,6 +1373,15 @@ int main(int argc, char *argv[])
                 return 1;
             }
         }
+        if (strcmp(argv[argi], "--analyze") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A file name must be provided.\n");
+                return 1;
+            }
+            /* analyzed after all of the options, which set the baud */
+            analyze_filename = argv[argi];
+        }
         if (strcmp(argv[argi], "--extcap-interfaces") == 0) {
             RS485_Print_Ports();
             return 0;
@@ -1140,6 +1464,49 @@ int main(int argc, char *argv[])
             }
             named_pipe_create(argv[argi]);
         }
+#if !defined(_WIN32)
+        if (strcmp(argv[argi], "--stdout") == 0) {
+            /* the capture is the output, so no status is printed,
+               and any other messages are sent to stderr */
+            Wireshark_Capture = true;
+            fflush(stdout);
+            FD_Pipe = dup(STDOUT_FILENO);
+            (void)dup2(STDERR_FILENO, STDOUT_FILENO);
+        }
+#endif
+        if (strcmp(argv[argi], "--pcapng") == 0) {
+            Capture_Format = CAPTURE_FORMAT_PCAPNG;
+        }
+        if (strcmp(argv[argi], "--rotate-packets") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A packet count must be provided.\n");
+                return 0;
+            }
+            Rotate_Packets = strtoul(argv[argi], NULL, 0);
+        }
+        if (strcmp(argv[argi], "--rotate-size") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A file size must be provided.\n");
+                return 0;
+            }
+            Rotate_Bytes = strtoull(argv[argi], NULL, 0);
+        }
+        if (strcmp(argv[argi], "--rotate-time") == 0) {
+            argi++;
+            if (argi >= argc) {
+                printf("A number of seconds must be provided.\n");
+                return 0;
+            }
+            Rotate_Seconds = strtoul(argv[argi], NULL, 0);
+        }
+    }
+    if (analyze_filename) {
+        if (!mstp_analyze_file(analyze_filename, my_baud, stdout)) {
+            return 1;
+        }
+        return 0;
     }
     if (Exit_Requested) {
         return 0;
@@ -1163,6 +1530,7 @@ int main(int argc, char *argv[])
 #endif
     filename_create_new();
     write_global_header();
+    capture_writer_start();
     /* run forever */
     for (;;) {
         RS485_Check_UART_Data(mstp_port);
@@ -1214,10 +1582,9 @@ int main(int argc, char *argv[])
                 fflush(stdout);
             }
             if (packet_count >= 65535) {
+                /* the writer starts new files at its rotation limits */
                 packet_statistics_print();
                 packet_statistics_clear();
-                filename_create_new();
-                write_global_header();
                 packet_count = 0;
             }
         }
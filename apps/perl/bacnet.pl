@@ -518,6 +518,277 @@ sub WriteProperty {
     return ($answer, $isFailure);
 }
 
+=head2 ReadPropertyMany
+
+This function reads many properties of many devices at once, with the
+ReadPropertyMultiple requests to each device in flight at the same time.
+The devices are bound as needed. There are no built in retry mechanisms.
+NOTE: all enumerations are defined in F<bacenum.h> 
+
+=head3 Inputs to ReadPropertyMany
+
+=begin html
+<ul>
+  <li><b>r_answerList</b>   - reference to a list where to store the answers, in the order of the requests</li>
+  <li><b>list</b>           - a list of property reads</li>
+  <ul>
+    <li><b>deviceInstance</b> - the instance number of the device we are reading</li>
+    <li><b>objectType</b>     - the enumeration for the object name to read from</li>
+    <li><b>objectInstance</b> - the instance number of the object we are reading</li>
+    <li><b>propertyName</b>   - the enumeration  for the property name we are reading</li>
+    <li><b>index</b>          - the index number we are reading from. Use -1 if not applicable</li>
+  </ul>
+</ul>
+
+=end html
+
+=head3 Outputs from ReadPropertyMany
+
+=begin html
+<ul>
+  <li><b>failures</b> - the number of reads that failed. The value, or the error, of each read is returned in r_answerList</li>
+</ul>
+
+=end html
+
+=head3 Example of ReadPropertyMany
+
+The following example will read AV0.PresentValue from devices 1234 and 5678
+
+    my @answers = ();
+    my @requests = ();
+    push @requests, [1234, 'OBJECT_ANALOG_VALUE', 0, 'PROP_PRESENT_VALUE', -1];
+    push @requests, [5678, 'OBJECT_ANALOG_VALUE', 0, 'PROP_PRESENT_VALUE', -1];
+    my $failures = ReadPropertyMany(\@answers, @requests);
+
+=cut
+
+sub ReadPropertyMany
+{
+    my $r_answerList = shift;
+    my @list = @ARG;
+    my @modifiedList = ();
+
+    foreach my $r_prop (@list)
+    {
+        my @tmpList = ();
+        push @tmpList, $$r_prop[$_] for (0 .. 4);
+        (undef, $tmpList[1]) = LookupEnumValue('BACNET_OBJECT_TYPE', $$r_prop[1]);
+        (undef, $tmpList[3]) = LookupEnumValue('BACNET_PROPERTY_ID', $$r_prop[3]);
+        push @modifiedList, \@tmpList;
+    }
+
+    my $failures = BacnetReadPropertyMany($r_answerList, @modifiedList);
+    if ($failures)
+    {
+        BacnetGetError($errorMsg);
+    }
+    Log('ReadPropertyMany: ' . scalar(@list) . " reads, $failures failed");
+
+    return $failures;
+}
+
+=head2 WritePropertyMany
+
+This function writes many properties of many devices at once, with the
+WritePropertyMultiple requests to each device in flight at the same time.
+The devices are bound as needed. There are no built in retry mechanisms.
+NOTE: all enumerations are defined in F<bacenum.h> 
+
+=head3 Inputs to WritePropertyMany
+
+=begin html
+<ul>
+  <li><b>r_answerList</b>   - reference to a list where to store the answers, in the order of the requests</li>
+  <li><b>list</b>           - a list of property writes</li>
+  <ul>
+    <li><b>deviceInstance</b> - the instance number of the device we are writing</li>
+    <li><b>objectName</b>     - the enumeration for the object name we are writing</li>
+    <li><b>objectInstance</b> - the instance number of the object we are writing</li>
+    <li><b>propertyName</b>   - the enumeration for the property name we are writing</li>
+    <li><b>tagName</b>        - the enumeration for the type of value we are writing. To specify context tags, prepend the tag name with "Cn:" where 'n' is the context number.</li>
+    <li><b>value</b>          - the value we are writing</li>
+    <li><b>priority</b>       - Optional (default 0): the priority within Priority Array to write at. Use 1-16 when specify priority, 0 to not specify priority.</li>
+    <li><b>index</b>          - Optional (default -1): the index within an array we are writing to. Use positive number to indicate index, -1 to not specify index.</li>
+  </ul>
+</ul>
+
+=end html
+
+=head3 Outputs from WritePropertyMany
+
+=begin html
+<ul>
+  <li><b>failures</b> - the number of writes that failed. The acknowledgement, or the error, of each write is returned in r_answerList</li>
+</ul>
+
+=end html
+
+=head3 Example of WritePropertyMany
+
+The following example will write 1.0 to AV0.PresentValue in devices 1234 and 5678
+
+    my @answers = ();
+    my @requests = ();
+    push @requests, [1234, 'OBJECT_ANALOG_VALUE', 0, 'PROP_PRESENT_VALUE', 'BACNET_APPLICATION_TAG_REAL', 1.0];
+    push @requests, [5678, 'OBJECT_ANALOG_VALUE', 0, 'PROP_PRESENT_VALUE', 'BACNET_APPLICATION_TAG_REAL', 1.0];
+    my $failures = WritePropertyMany(\@answers, @requests);
+
+=cut
+
+sub WritePropertyMany
+{
+    my $r_answerList = shift;
+    my @list = @ARG;
+    my @modifiedList = ();
+
+    foreach my $r_prop (@list)
+    {
+        my ($device, $objectName, $objectInstance, $propertyName, $tagName, $value, $priority, $index) = @{$r_prop};
+        my (undef, $objectValue) = LookupEnumValue('BACNET_OBJECT_TYPE', $objectName);
+        my (undef, $propertyValue) = LookupEnumValue('BACNET_PROPERTY_ID', $propertyName);
+
+        my $tagValue = '';
+        if ($tagName =~ /^(C\d+):(.*)$/)
+        {
+            $tagName = $2;
+            $tagValue = "$1 ";
+        }
+        my (undef, $tagNewValue) = LookupEnumValue('BACNET_APPLICATION_TAG', $tagName);
+        $tagValue .= $tagNewValue;
+
+        # a priority of 0 means we are not writing to a priority array,
+        # and an index of -1 means that we are not writing to an array
+        $priority = 0 unless defined($priority);
+        $index = -1 unless defined($index);
+        push @modifiedList, [$device, $objectValue, $objectInstance, $propertyValue, $priority, $index, $tagValue, $value];
+    }
+
+    my $failures = BacnetWritePropertyMany($r_answerList, @modifiedList);
+    if ($failures)
+    {
+        BacnetGetError($errorMsg);
+    }
+    Log('WritePropertyMany: ' . scalar(@list) . " writes, $failures failed");
+
+    return $failures;
+}
+
+=head2 SubscribeCOVMany
+
+This function subscribes to the changes of value of many objects of many
+devices at once. The subscriptions are renewed before their lifetime ends,
+and an object of a device that does not take the subscription is polled.
+Use WaitForCOVNotifications to receive the values.
+NOTE: all enumerations are defined in F<bacenum.h> 
+
+=head3 Inputs to SubscribeCOVMany
+
+=begin html
+<ul>
+  <li><b>r_answerList</b>   - reference to a list where to store the status of each subscription, in the order of the requests</li>
+  <li><b>list</b>           - a list of subscriptions</li>
+  <ul>
+    <li><b>deviceInstance</b> - the instance number of the device of the object</li>
+    <li><b>objectType</b>     - the enumeration for the object name to subscribe to</li>
+    <li><b>objectInstance</b> - the instance number of the object to subscribe to</li>
+    <li><b>confirmed</b>      - Optional (default 0): non-zero for confirmed notifications</li>
+    <li><b>lifetime</b>       - Optional (default 300): the lifetime of the subscription in seconds</li>
+  </ul>
+</ul>
+
+=end html
+
+=head3 Outputs from SubscribeCOVMany
+
+=begin html
+<ul>
+  <li><b>failures</b> - the number of subscriptions that are not active or polled yet. The status of each subscription ('active', 'polling', or 'retry') is returned in r_answerList</li>
+</ul>
+
+=end html
+
+=head3 Example of SubscribeCOVMany
+
+The following example will subscribe to AV0 in devices 1234 and 5678, and
+print the notifications of the next minute
+
+    my @answers = ();
+    my @notifications = ();
+    my $failures = SubscribeCOVMany(\@answers,
+        [1234, 'OBJECT_ANALOG_VALUE', 0], [5678, 'OBJECT_ANALOG_VALUE', 0]);
+    WaitForCOVNotifications(60, \@notifications);
+    print "$_\n" foreach (@notifications);
+
+=cut
+
+sub SubscribeCOVMany
+{
+    my $r_answerList = shift;
+    my @list = @ARG;
+    my @modifiedList = ();
+
+    foreach my $r_prop (@list)
+    {
+        my ($device, $objectName, $objectInstance, $confirmed, $lifetime) = @{$r_prop};
+        my (undef, $objectValue) = LookupEnumValue('BACNET_OBJECT_TYPE', $objectName);
+
+        $confirmed = 0 unless defined($confirmed);
+        $lifetime = 300 unless defined($lifetime);
+        push @modifiedList, [$device, $objectValue, $objectInstance, $confirmed, $lifetime];
+    }
+
+    my $failures = BacnetSubscribeCOVMany($r_answerList, @modifiedList);
+    if ($failures)
+    {
+        BacnetGetError($errorMsg);
+    }
+    Log('SubscribeCOVMany: ' . scalar(@list) . " subscriptions, $failures failed");
+
+    return $failures;
+}
+
+=head2 WaitForCOVNotifications
+
+This function waits for the notifications of the subscriptions of
+SubscribeCOVMany, and for the values of the objects that are polled.
+
+=head3 Inputs to WaitForCOVNotifications
+
+=begin html
+<ul>
+  <li><b>seconds</b>            - the number of seconds to wait</li>
+  <li><b>r_notificationList</b> - reference to a list where to store the notifications, in the order received</li>
+</ul>
+
+=end html
+
+=head3 Outputs from WaitForCOVNotifications
+
+=begin html
+<ul>
+  <li><b>count</b> - the number of notifications. Each one is returned in r_notificationList as 'Device[n] object-type[n] property=value;...'</li>
+</ul>
+
+=end html
+
+=head3 Example of WaitForCOVNotifications
+
+See SubscribeCOVMany
+
+=cut
+
+sub WaitForCOVNotifications
+{
+    my $seconds = shift;
+    my $r_notificationList = shift;
+
+    my $count = BacnetWaitForCOVNotifications($seconds, $r_notificationList);
+    Log("WaitForCOVNotifications: $count notifications");
+
+    return $count;
+}
+
 =head2 TimeSync
 
 This function implements the TimeSync and UTCTimeSync services
@@ -7,6 +7,10 @@
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/arf.h"
+#include "bacnet/basic/client/bac-async.h"
+#include "bacnet/basic/client/bac-cov.h"
+#include "bacnet/basic/client/bac-rpm.h"
+#include "bacnet/basic/client/bac-wpm.h"
 
 /* Free is redefined as a macro, but Perl does not like that. */
 #undef free
@@ -22,6 +26,7 @@ static bool isReadPropertyMultipleHandlerRegistered = false;
 static bool isWritePropertyHandlerRegistered = false;
 static bool isAtomicWriteFileHandlerRegistered = false;
 static bool isAtomicReadFileHandlerRegistered = false;
+static bool isCovClientInitialized = false;
 
 /****************************************/
 /* Logging Support */
@@ -107,9 +112,9 @@ static void My_Error_Handler(BACNET_ADDRESS *src,
 /* Decode the ReadProperty Ack and pass to perl */
 /****************************************/
 #define MAX_ACK_STRING 512
-void rp_ack_extract_data(BACNET_READ_PROPERTY_DATA *data)
+static void rp_data_extract_string(
+    BACNET_READ_PROPERTY_DATA *data, char *ackString)
 {
-    char ackString[MAX_ACK_STRING] = "";
     char *pAckString = &ackString[0];
     BACNET_OBJECT_PROPERTY_VALUE object_value; /* for bacapp printing */
     BACNET_APPLICATION_DATA_VALUE value; /* for decode value data */
@@ -158,6 +163,15 @@ void rp_ack_extract_data(BACNET_READ_PROPERTY_DATA *data)
             strncat(pAckString, "}", 1);
             pAckString += 1;
         }
+    }
+}
+
+void rp_ack_extract_data(BACNET_READ_PROPERTY_DATA *data)
+{
+    char ackString[MAX_ACK_STRING] = "";
+
+    if (data) {
+        rp_data_extract_string(data, ackString);
         /* Now let's call a Perl function to display the data */
         __LogAnswer(ackString, 0);
     }
@@ -662,6 +676,43 @@ int BacnetReadPropertyMultiple(int deviceInstanceNumber, ...)
     return isFailure;
 }
 
+/****************************************************/
+/* Handle the tag/value pair of a write. If successful, return true. If */
+/* failure, return false and log the error details */
+/****************************************************/
+static bool Parse_Tag_Value(const char *tag,
+    const char *value,
+    BACNET_APPLICATION_DATA_VALUE *propertyValue)
+{
+    char msg[MAX_ERROR_STRING];
+    uint8_t context_tag = 0;
+    BACNET_APPLICATION_TAG property_tag;
+
+    if (toupper(tag[0]) == 'C') {
+        context_tag = strtol(&tag[1], NULL, 0);
+        propertyValue->context_tag = context_tag;
+        propertyValue->context_specific = true;
+    } else {
+        propertyValue->context_specific = false;
+    }
+    property_tag = strtol(tag, NULL, 0);
+
+    if (property_tag >= MAX_BACNET_APPLICATION_TAG) {
+        snprintf(msg, sizeof(msg), "Error: tag=%u - it must be less than %u",
+            property_tag, MAX_BACNET_APPLICATION_TAG);
+        LogError(msg);
+        return false;
+    }
+    if (!bacapp_parse_application_data(property_tag, value, propertyValue)) {
+        snprintf(msg, sizeof(msg), "Error: unable to parse the tag value");
+        LogError(msg);
+        return false;
+    }
+    propertyValue->next = NULL;
+
+    return true;
+}
+
 /****************************************************/
 /* This is the interface to WriteProperty */
 /****************************************************/
@@ -674,7 +725,6 @@ int BacnetWriteProperty(int deviceInstanceNumber,
     const char *tag,
     const char *value)
 {
-    char msg[MAX_ERROR_STRING];
     int isFailure = 1;
 
     if (!isWritePropertyHandlerRegistered) {
@@ -695,33 +745,11 @@ int BacnetWriteProperty(int deviceInstanceNumber,
     }
     /* Loop for eary exit; */
     do {
-        /* Handle the tag/value pair */
-        uint8_t context_tag = 0;
-        BACNET_APPLICATION_TAG property_tag;
         BACNET_APPLICATION_DATA_VALUE propertyValue;
 
-        if (toupper(tag[0]) == 'C') {
-            context_tag = strtol(&tag[1], NULL, 0);
-            propertyValue.context_tag = context_tag;
-            propertyValue.context_specific = true;
-        } else {
-            propertyValue.context_specific = false;
-        }
-        property_tag = strtol(tag, NULL, 0);
-
-        if (property_tag >= MAX_BACNET_APPLICATION_TAG) {
-            snprintf(msg, sizeof(msg), "Error: tag=%u - it must be less than %u",
-                property_tag, MAX_BACNET_APPLICATION_TAG);
-            LogError(msg);
-            break;
-        }
-        if (!bacapp_parse_application_data(
-                property_tag, value, &propertyValue)) {
-            snprintf(msg, sizeof(msg), "Error: unable to parse the tag value");
-            LogError(msg);
+        if (!Parse_Tag_Value(tag, value, &propertyValue)) {
             break;
         }
-        propertyValue.next = NULL;
 
         /* Send out the message */
         Request_Invoke_ID = Send_Write_Property_Request(deviceInstanceNumber,
@@ -928,3 +956,595 @@ int BacnetAtomicReadFile(int deviceInstanceNumber,
     Error_Detected = 0;
     return isFailure;
 }
+
+/****************************************************/
+/*             Batch Interface API                  */
+/****************************************************/
+
+/* One property read, property write, or COV subscription of a batch */
+typedef struct {
+    AV *request;
+    uint32_t device;
+    BACNET_OBJECT_TYPE type;
+    uint32_t instance;
+    BACNET_PROPERTY_ID property;
+    BACNET_ARRAY_INDEX index;
+    BACNET_COV_CLIENT_ID subscription;
+    bool has_result;
+} BATCH_ITEM;
+
+static BATCH_ITEM *Batch_Item = NULL;
+static unsigned Batch_Count = 0;
+static unsigned Batch_First_Open = 0;
+static unsigned Batch_Failures = 0;
+static AV *Batch_Results = NULL;
+static AV *Batch_Notifications = NULL;
+
+/****************************************************/
+/* Fetch the integer at the given position of an item of a batch */
+/****************************************************/
+static int Batch_Item_IV(AV *pAV, int n)
+{
+    SV **pSV = av_fetch(pAV, n, 0);
+
+    return pSV ? SvIV(*pSV) : 0;
+}
+
+/****************************************************/
+/* Fetch the string at the given position of an item of a batch */
+/****************************************************/
+static const char *Batch_Item_PV(AV *pAV, int n)
+{
+    SV **pSV = av_fetch(pAV, n, 0);
+
+    return pSV ? SvPV_nolen(*pSV) : "";
+}
+
+/****************************************************/
+/* Check that each item of a batch is an array reference holding at least */
+/* the given number of fields, and allocate the state of the batch. */
+/* If successful, return true. If failure, return false and log the error */
+/* details */
+/****************************************************/
+static bool Batch_Prepare(SV *results, SV **items, int count, int fields)
+{
+    int i;
+    SV *pSV;
+
+    if (!SvROK(results) || (SvTYPE(SvRV(results)) != SVt_PVAV)) {
+        LogError("The results must be an array reference");
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        pSV = items[i];
+        if (!SvROK(pSV) || (SvTYPE(SvRV(pSV)) != SVt_PVAV) ||
+            (av_len((AV *)SvRV(pSV)) + 1 < fields)) {
+            char msg[MAX_ERROR_STRING];
+            snprintf(msg, sizeof(msg),
+                "Item %d of the batch must be an array of %d values", i,
+                fields);
+            LogError(msg);
+            return false;
+        }
+    }
+    Batch_Item = calloc(count ? count : 1, sizeof(BATCH_ITEM));
+    if (!Batch_Item) {
+        LogError("Unable to allocate the batch");
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        Batch_Item[i].request = (AV *)SvRV(items[i]);
+    }
+    Batch_Count = count;
+    Batch_First_Open = 0;
+    Batch_Failures = 0;
+    Batch_Results = (AV *)SvRV(results);
+    av_clear(Batch_Results);
+
+    return true;
+}
+
+/****************************************************/
+/* The clients of a batch start with an empty address cache, so keep the */
+/* devices that are already bound, such as with BindToDevice */
+/****************************************************/
+static BACNET_ADDRESS_BINDING_ADD *Batch_Bindings_Save(unsigned *count)
+{
+    BACNET_ADDRESS_BINDING_ADD *list;
+    unsigned index;
+
+    *count = 0;
+    list = calloc(MAX_ADDRESS_CACHE, sizeof(BACNET_ADDRESS_BINDING_ADD));
+    if (!list) {
+        return NULL;
+    }
+    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+        BACNET_ADDRESS_BINDING_ADD *binding = &list[*count];
+        if (address_get_by_index(index, &binding->device_id,
+                &binding->max_apdu, &binding->address)) {
+            if (!address_segmentation(
+                    binding->device_id, &binding->segmentation)) {
+                binding->segmentation = SEGMENTATION_NONE;
+            }
+            (*count)++;
+        }
+    }
+
+    return list;
+}
+
+static void Batch_Bindings_Restore(
+    BACNET_ADDRESS_BINDING_ADD *list, unsigned count)
+{
+    address_add_list(list, count);
+    free(list);
+}
+
+/****************************************************/
+/* Free the state of a batch, and give the confirmed service handlers back */
+/* to the single request calls, since the clients of the batch took them */
+/****************************************************/
+static void Batch_Release(void)
+{
+    free(Batch_Item);
+    Batch_Item = NULL;
+    Batch_Count = 0;
+    Batch_Results = NULL;
+    isReadPropertyHandlerRegistered = false;
+    isReadPropertyMultipleHandlerRegistered = false;
+    isWritePropertyHandlerRegistered = false;
+    isAtomicWriteFileHandlerRegistered = false;
+    isAtomicReadFileHandlerRegistered = false;
+    apdu_set_abort_handler(MyAbortHandler);
+    apdu_set_reject_handler(MyRejectHandler);
+}
+
+/****************************************************/
+/* Find the first item of the batch without a result that matches a reply */
+/****************************************************/
+static BATCH_ITEM *Batch_Item_Find(uint32_t device,
+    BACNET_OBJECT_TYPE type,
+    uint32_t instance,
+    BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX index)
+{
+    unsigned i;
+    BATCH_ITEM *item;
+
+    for (i = Batch_First_Open; i < Batch_Count; i++) {
+        item = &Batch_Item[i];
+        if (item->has_result || (item->device != device) ||
+            (item->type != type) || (item->instance != instance) ||
+            (item->property != property)) {
+            continue;
+        }
+        /* a whole array is given back one element at a time */
+        if ((item->index == index) ||
+            ((item->index == BACNET_ARRAY_ALL) && (index == 1))) {
+            return item;
+        }
+    }
+
+    return NULL;
+}
+
+/****************************************************/
+/* Store the result of an item of the batch */
+/****************************************************/
+static void Batch_Result_Store(BATCH_ITEM *item, const char *result)
+{
+    item->has_result = true;
+    av_store(Batch_Results, item - Batch_Item, newSVpv(result, 0));
+    while ((Batch_First_Open < Batch_Count) &&
+        Batch_Item[Batch_First_Open].has_result) {
+        Batch_First_Open++;
+    }
+}
+
+/****************************************************/
+/* Store the error of an item of the batch */
+/****************************************************/
+static void Batch_Error_Store(BATCH_ITEM *item,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    char msg[MAX_ERROR_STRING];
+
+    snprintf(msg, sizeof(msg), "BACnet Error: %s: %s",
+        bactext_error_class_name(error_class),
+        bactext_error_code_name(error_code));
+    Batch_Result_Store(item, msg);
+    Batch_Failures++;
+}
+
+/****************************************************/
+/* Process a PDU if one comes in, and keep the timers going */
+/****************************************************/
+static void Batch_Receive(time_t *last_seconds)
+{
+    time_t current_seconds = time(NULL);
+    uint16_t pdu_len = 0;
+    BACNET_ADDRESS src = { 0 };
+    uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+
+    pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, 10);
+    if (pdu_len) {
+        npdu_handler(&src, &Rx_Buf[0], pdu_len);
+    }
+    if (current_seconds != *last_seconds) {
+        tsm_timer_milliseconds(((current_seconds - *last_seconds) * 1000));
+        datalink_maintenance_timer(current_seconds - *last_seconds);
+        *last_seconds = current_seconds;
+    }
+}
+
+/****************************************************/
+/* Give the items of the batch without a result an APDU Timeout error */
+/****************************************************/
+static void Batch_Timeout(void)
+{
+    unsigned i;
+
+    for (i = Batch_First_Open; i < Batch_Count; i++) {
+        if (!Batch_Item[i].has_result) {
+            Batch_Error_Store(&Batch_Item[i], ERROR_CLASS_COMMUNICATION,
+                ERROR_CODE_TIMEOUT);
+        }
+    }
+    LogError("APDU Timeout");
+}
+
+static void Batch_Read_Value_Handler(uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    char ackString[MAX_ACK_STRING] = "";
+    BATCH_ITEM *item;
+
+    item = Batch_Item_Find(device_id, rp_data->object_type,
+        rp_data->object_instance, rp_data->object_property,
+        rp_data->array_index);
+    if (!item) {
+        return;
+    }
+    if (value) {
+        /* the encoded value holds every element of an array */
+        rp_data_extract_string(rp_data, ackString);
+        Batch_Result_Store(item, ackString);
+    } else if (rp_data->error_code == ERROR_CODE_SUCCESS) {
+        Batch_Error_Store(item, ERROR_CLASS_PROPERTY,
+            ERROR_CODE_INVALID_DATA_TYPE);
+    } else {
+        Batch_Error_Store(item, rp_data->error_class, rp_data->error_code);
+    }
+}
+
+/****************************************************/
+/* This is the interface to read many properties of many devices, with */
+/* the ReadPropertyMultiple requests in flight at the same time. Each item */
+/* is an array of device, object type, object instance, property, and */
+/* index. The result of each item is stored in the results array in the */
+/* same order. Return the number of items that failed */
+/****************************************************/
+int BacnetReadPropertyMany(SV *results, ...)
+{
+    Inline_Stack_Vars;
+    int count = Inline_Stack_Items - 1;
+    int next = 0;
+    time_t last_seconds = time(NULL);
+    time_t idle_seconds = last_seconds;
+    time_t timeout_seconds = (apdu_timeout() / 1000) * apdu_retries();
+    unsigned last_open = 0;
+    BACNET_ADDRESS_BINDING_ADD *bindings;
+    unsigned binding_count;
+    int isFailure;
+
+    if (!Batch_Prepare(results, &Inline_Stack_Item(1), count, 5)) {
+        return count ? count : 1;
+    }
+    bindings = Batch_Bindings_Save(&binding_count);
+    bacnet_rpm_plan_init();
+    Batch_Bindings_Restore(bindings, binding_count);
+    bacnet_rpm_plan_value_callback_set(Batch_Read_Value_Handler);
+    while ((next < count) || !bacnet_rpm_plan_idle()) {
+        while (next < count) {
+            BATCH_ITEM *item = &Batch_Item[next];
+            AV *pAV = item->request;
+            int index = Batch_Item_IV(pAV, 4);
+
+            item->device = Batch_Item_IV(pAV, 0);
+            item->type = Batch_Item_IV(pAV, 1);
+            item->instance = Batch_Item_IV(pAV, 2);
+            item->property = Batch_Item_IV(pAV, 3);
+            item->index =
+                (index == -1) ? BACNET_ARRAY_ALL : (BACNET_ARRAY_INDEX)index;
+            if (!bacnet_rpm_plan_read_add(item->device, item->type,
+                    item->instance, item->property, item->index)) {
+                break;
+            }
+            next++;
+        }
+        Batch_Receive(&last_seconds);
+        bacnet_rpm_plan_task();
+        if (Batch_First_Open != last_open) {
+            last_open = Batch_First_Open;
+            idle_seconds = last_seconds;
+        } else if ((last_seconds - idle_seconds) > timeout_seconds) {
+            break;
+        }
+    }
+    bacnet_rpm_plan_value_callback_set(NULL);
+    if (Batch_First_Open < Batch_Count) {
+        Batch_Timeout();
+    }
+    isFailure = Batch_Failures;
+    Batch_Release();
+
+    return isFailure;
+}
+
+static void Batch_Write_Handler(
+    uint32_t device_instance, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BATCH_ITEM *item;
+
+    item = Batch_Item_Find(device_instance, wp_data->object_type,
+        wp_data->object_instance, wp_data->object_property,
+        wp_data->array_index);
+    if (!item) {
+        return;
+    }
+    if (wp_data->error_code == ERROR_CODE_SUCCESS) {
+        Batch_Result_Store(item, "Acknowledged");
+    } else {
+        Batch_Error_Store(item, wp_data->error_class, wp_data->error_code);
+    }
+}
+
+/****************************************************/
+/* This is the interface to write many properties of many devices, with */
+/* the WritePropertyMultiple requests in flight at the same time. Each item */
+/* is an array of device, object type, object instance, property, priority, */
+/* index, tag, and value. The result of each item is stored in the results */
+/* array in the same order. Return the number of items that failed */
+/****************************************************/
+int BacnetWritePropertyMany(SV *results, ...)
+{
+    Inline_Stack_Vars;
+    int count = Inline_Stack_Items - 1;
+    int next = 0;
+    time_t last_seconds = time(NULL);
+    time_t idle_seconds = last_seconds;
+    time_t timeout_seconds = (apdu_timeout() / 1000) * apdu_retries();
+    unsigned last_open = 0;
+    BACNET_ADDRESS_BINDING_ADD *bindings;
+    unsigned binding_count;
+    int isFailure;
+
+    if (!Batch_Prepare(results, &Inline_Stack_Item(1), count, 8)) {
+        return count ? count : 1;
+    }
+    bindings = Batch_Bindings_Save(&binding_count);
+    bacnet_wpm_plan_init();
+    Batch_Bindings_Restore(bindings, binding_count);
+    bacnet_wpm_plan_callback_set(Batch_Write_Handler);
+    while ((next < count) || !bacnet_wpm_plan_idle()) {
+        while (next < count) {
+            BATCH_ITEM *item = &Batch_Item[next];
+            AV *pAV = item->request;
+            int index = Batch_Item_IV(pAV, 5);
+            BACNET_APPLICATION_DATA_VALUE propertyValue;
+
+            item->device = Batch_Item_IV(pAV, 0);
+            item->type = Batch_Item_IV(pAV, 1);
+            item->instance = Batch_Item_IV(pAV, 2);
+            item->property = Batch_Item_IV(pAV, 3);
+            item->index =
+                (index == -1) ? BACNET_ARRAY_ALL : (BACNET_ARRAY_INDEX)index;
+            if (!Parse_Tag_Value(Batch_Item_PV(pAV, 6),
+                    Batch_Item_PV(pAV, 7), &propertyValue)) {
+                Batch_Error_Store(
+                    item, ERROR_CLASS_PROPERTY, ERROR_CODE_INVALID_DATA_TYPE);
+            } else if (!bacnet_wpm_plan_write_add(item->device, item->type,
+                           item->instance, item->property, item->index,
+                           Batch_Item_IV(pAV, 4), &propertyValue)) {
+                break;
+            }
+            next++;
+        }
+        Batch_Receive(&last_seconds);
+        bacnet_wpm_plan_task();
+        if (Batch_First_Open != last_open) {
+            last_open = Batch_First_Open;
+            idle_seconds = last_seconds;
+        } else if ((last_seconds - idle_seconds) > timeout_seconds) {
+            break;
+        }
+    }
+    bacnet_wpm_plan_callback_set(NULL);
+    if (Batch_First_Open < Batch_Count) {
+        Batch_Timeout();
+    }
+    isFailure = Batch_Failures;
+    Batch_Release();
+
+    return isFailure;
+}
+
+/****************************************************/
+/* Keep the values of a COV notification, or of a polled subscription, */
+/* until they are given to WaitForCOVNotifications */
+/****************************************************/
+static void Batch_COV_Handler(
+    BACNET_COV_CLIENT_ID id, BACNET_COV_DATA *cov_data, void *context)
+{
+    char ackString[MAX_ACK_STRING] = "";
+    size_t len;
+    BACNET_PROPERTY_VALUE *pValue;
+    BACNET_OBJECT_PROPERTY_VALUE object_value;
+    BACNET_APPLICATION_DATA_VALUE *value;
+
+    (void)id;
+    (void)context;
+    if (!Batch_Notifications) {
+        return;
+    }
+    len = snprintf(ackString, sizeof(ackString), "Device[%lu] %s[%lu]",
+        (unsigned long)cov_data->initiatingDeviceIdentifier,
+        bactext_object_type_name(cov_data->monitoredObjectIdentifier.type),
+        (unsigned long)cov_data->monitoredObjectIdentifier.instance);
+    for (pValue = cov_data->listOfValues; pValue; pValue = pValue->next) {
+        if (len >= sizeof(ackString)) {
+            break;
+        }
+        len += snprintf(&ackString[len], sizeof(ackString) - len, " %s=",
+            bactext_property_name(pValue->propertyIdentifier));
+        object_value.object_type = cov_data->monitoredObjectIdentifier.type;
+        object_value.object_instance =
+            cov_data->monitoredObjectIdentifier.instance;
+        object_value.object_property = pValue->propertyIdentifier;
+        object_value.array_index = pValue->propertyArrayIndex;
+        for (value = &pValue->value; value; value = value->next) {
+            if (len >= sizeof(ackString)) {
+                break;
+            }
+            object_value.value = value;
+            len += bacapp_snprintf_value(
+                &ackString[len], sizeof(ackString) - len, &object_value);
+            if (value->next && (len < sizeof(ackString))) {
+                len += snprintf(
+                    &ackString[len], sizeof(ackString) - len, ",");
+            }
+        }
+        if (pValue->next && (len < sizeof(ackString))) {
+            len += snprintf(&ackString[len], sizeof(ackString) - len, ";");
+        }
+    }
+    av_push(Batch_Notifications, newSVpv(ackString, 0));
+}
+
+/****************************************************/
+/* Start the COV client once, since the subscriptions are kept and renewed */
+/* until the end of the script */
+/****************************************************/
+static void Batch_COV_Init(void)
+{
+    BACNET_ADDRESS_BINDING_ADD *bindings;
+    unsigned binding_count;
+
+    if (!isCovClientInitialized) {
+        bindings = Batch_Bindings_Save(&binding_count);
+        bacnet_async_init();
+        bacnet_cov_client_init();
+        Batch_Bindings_Restore(bindings, binding_count);
+        isCovClientInitialized = true;
+    }
+}
+
+/****************************************************/
+/* This is the interface to subscribe to the COV of many objects of many */
+/* devices. Each item is an array of device, object type, object instance, */
+/* confirmed, and lifetime. The status of each subscription is stored in the */
+/* results array in the same order, once none of them is pending. A device */
+/* that does not take the subscription is polled. Return the number of */
+/* subscriptions that failed */
+/****************************************************/
+int BacnetSubscribeCOVMany(SV *results, ...)
+{
+    Inline_Stack_Vars;
+    int count = Inline_Stack_Items - 1;
+    int i;
+    time_t last_seconds = time(NULL);
+    time_t start_seconds = last_seconds;
+    time_t timeout_seconds = (apdu_timeout() / 1000) * apdu_retries();
+    BACNET_COV_CLIENT_STATUS status;
+    bool pending;
+    int isFailure;
+
+    if (!Batch_Prepare(results, &Inline_Stack_Item(1), count, 5)) {
+        return count ? count : 1;
+    }
+    Batch_COV_Init();
+    for (i = 0; i < count; i++) {
+        BATCH_ITEM *item = &Batch_Item[i];
+        AV *pAV = item->request;
+
+        item->device = Batch_Item_IV(pAV, 0);
+        item->type = Batch_Item_IV(pAV, 1);
+        item->instance = Batch_Item_IV(pAV, 2);
+        item->subscription = bacnet_cov_client_subscribe(item->device,
+            item->type, item->instance, Batch_Item_IV(pAV, 3) ? true : false,
+            Batch_Item_IV(pAV, 4), Batch_COV_Handler, NULL);
+        if (item->subscription == BACNET_COV_CLIENT_ID_NONE) {
+            Batch_Error_Store(item, ERROR_CLASS_RESOURCES,
+                ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT);
+        }
+    }
+    do {
+        Batch_Receive(&last_seconds);
+        bacnet_async_task();
+        bacnet_cov_client_task();
+        pending = false;
+        for (i = 0; i < count; i++) {
+            if (!Batch_Item[i].has_result &&
+                (bacnet_cov_client_status(Batch_Item[i].subscription) ==
+                    BACNET_COV_CLIENT_STATUS_PENDING)) {
+                pending = true;
+            }
+        }
+    } while (pending && ((last_seconds - start_seconds) <= timeout_seconds));
+    for (i = 0; i < count; i++) {
+        BATCH_ITEM *item = &Batch_Item[i];
+        if (item->has_result) {
+            continue;
+        }
+        status = bacnet_cov_client_status(item->subscription);
+        if (status == BACNET_COV_CLIENT_STATUS_ACTIVE) {
+            Batch_Result_Store(item, "active");
+        } else if (status == BACNET_COV_CLIENT_STATUS_POLLING) {
+            Batch_Result_Store(item, "polling");
+        } else {
+            Batch_Result_Store(item, "retry");
+            Batch_Failures++;
+        }
+    }
+    isFailure = Batch_Failures;
+    /* the COV client keeps the abort and reject handlers */
+    free(Batch_Item);
+    Batch_Item = NULL;
+    Batch_Count = 0;
+    Batch_Results = NULL;
+
+    return isFailure;
+}
+
+/****************************************************/
+/* This is the interface to wait for the COV notifications of the */
+/* subscriptions, and for the values of the objects that are polled. Each */
+/* notification is pushed onto the notifications array as a string. Return */
+/* the number of notifications */
+/****************************************************/
+int BacnetWaitForCOVNotifications(int seconds, SV *notifications)
+{
+    time_t last_seconds = time(NULL);
+    time_t start_seconds = last_seconds;
+    int count;
+
+    if (!SvROK(notifications) ||
+        (SvTYPE(SvRV(notifications)) != SVt_PVAV)) {
+        LogError("The notifications must be an array reference");
+        return 0;
+    }
+    Batch_COV_Init();
+    Batch_Notifications = (AV *)SvRV(notifications);
+    av_clear(Batch_Notifications);
+    while ((last_seconds - start_seconds) < seconds) {
+        Batch_Receive(&last_seconds);
+        bacnet_async_task();
+        bacnet_cov_client_task();
+    }
+    count = av_len(Batch_Notifications) + 1;
+    Batch_Notifications = NULL;
+
+    return count;
+}
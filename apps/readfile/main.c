@@ -25,6 +25,7 @@
 #include "bacnet/version.h"
 /* some demo stuff needed */
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/client/bac-file.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/filename.h"
 #include "bacnet/basic/services.h"
@@ -44,11 +45,10 @@ static uint32_t Target_File_Object_Instance = BACNET_MAX_INSTANCE;
 static uint32_t Target_Device_Object_Instance = BACNET_MAX_INSTANCE;
 static BACNET_ADDRESS Target_Address;
 static char *Local_File_Name = NULL;
-static int Target_File_Start_Position;
-static unsigned int Target_File_Requested_Octet_Count;
-static bool End_Of_File_Detected = false;
+static FILE *Local_File = NULL;
+static bool Local_File_Resume = false;
+static unsigned Target_File_Window = 4;
 static bool Error_Detected = false;
-static uint8_t Request_Invoke_ID = 0;
 
 static void Atomic_Read_File_Error_Handler(BACNET_ADDRESS *src,
     uint8_t invoke_id,
@@ -56,7 +56,7 @@ static void Atomic_Read_File_Error_Handler(BACNET_ADDRESS *src,
     BACNET_ERROR_CODE error_code)
 {
     if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
+        bacnet_file_transfer_error(invoke_id)) {
         printf("BACnet Error: %s: %s\n",
             bactext_error_class_name((int)error_class),
             bactext_error_code_name((int)error_code));
@@ -69,10 +69,10 @@ static void MyAbortHandler(
 {
     (void)server;
     if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
+        bacnet_file_transfer_abort(invoke_id)) {
+        /* the chunk is sent again */
         printf(
             "BACnet Abort: %s\n", bactext_abort_reason_name((int)abort_reason));
-        Error_Detected = true;
     }
 }
 
@@ -80,7 +80,7 @@ static void MyRejectHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
 {
     if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
+        bacnet_file_transfer_error(invoke_id)) {
         printf("BACnet Reject: %s\n",
             bactext_reject_reason_name((int)reject_reason));
         Error_Detected = true;
@@ -93,69 +93,20 @@ static void AtomicReadFileAckHandler(uint8_t *service_request,
     BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
 {
     int len = 0;
-    int result = 0;
     BACNET_ATOMIC_READ_FILE_DATA data;
-    FILE *pFile = NULL; /* stream pointer */
-    size_t octets_written = 0;
-    size_t octet_count = 0;
-    uint8_t *octet_buffer = NULL;
 
-    if (address_match(&Target_Address, src) &&
-        (service_data->invoke_id == Request_Invoke_ID)) {
-        len =
-            arf_ack_decode_service_request(service_request, service_len, &data);
-        if ((len > 0) && (data.access == FILE_STREAM_ACCESS)) {
-            if (data.type.stream.fileStartPosition == 0) {
-                pFile = fopen(Local_File_Name, "wb");
-            } else {
-                pFile = fopen(Local_File_Name, "rb+");
-            }
-            if (pFile) {
-                octet_count = octetstring_length(&data.fileData[0]);
-                if (octet_count == 0) {
-                    /* asked for many octets, and got zero. Force EOF */
-                    if (!data.endOfFile) {
-                        fprintf(stderr, "Missing EOF!\n");
-                        data.endOfFile = true;
-                    }
-                } else {
-                    result = fseek(
-                        pFile, data.type.stream.fileStartPosition, SEEK_SET);
-                    if (result == 0) {
-                        /* unit to write in bytes -
-                           in our case, an octet is one byte */
-                        octet_buffer = octetstring_value(&data.fileData[0]);
-                        octets_written =
-                            fwrite(octet_buffer, 1, octet_count, pFile);
-                        if (octets_written != octet_count) {
-                            fprintf(stderr,
-                                "Unable to write data to file \"%s\".\n",
-                                Local_File_Name);
-                        } else {
-                            Target_File_Start_Position =
-                                data.type.stream.fileStartPosition +
-                                octets_written;
-                            printf(
-                                "\r%d bytes", (int)Target_File_Start_Position);
-                        }
-                        fflush(pFile);
-                    } else {
-                        fprintf(stderr, "Unable to seek to %d!\n",
-                            data.type.stream.fileStartPosition);
-                    }
-                }
-                fclose(pFile);
-            }
-            if (data.endOfFile) {
-                End_Of_File_Detected = true;
-                printf("\n");
-            }
-        } else {
-            fprintf(stderr, "Decode error! %d bytes decoded.\n", len);
-        }
+    if (!address_match(&Target_Address, src)) {
+        return;
+    }
+    len = arf_ack_decode_service_request(service_request, service_len, &data);
+    if (len <= 0) {
+        fprintf(stderr, "Decode error! %d bytes decoded.\n", len);
+    } else if (!bacnet_file_transfer_read_ack(service_data->invoke_id, &data)) {
+        fprintf(stderr, "Invoke ID mismatch! Invoke ID=%d\n",
+            service_data->invoke_id);
     } else {
-        fprintf(stderr, "Address & Invoke ID mismatch! Invoke ID=%d\n",
-            Request_Invoke_ID);
+        printf("\r%lu bytes", (unsigned long)bacnet_file_transfer_octets());
+        fflush(stdout);
     }
 }
 
@@ -208,7 +159,7 @@ static void Init_Service_Handlers(void)
 static void print_usage(char *filename)
 {
     printf("Usage: %s device-instance file-instance local-name\n", filename);
-    printf("       [--version][--help]\n");
+    printf("       [--window N][--resume][--version][--help]\n");
 }
 
 static void print_help(char *filename)
@@ -230,6 +181,15 @@ static void print_help(char *filename)
     printf("local-name:\n"
         "The name of the file that will be stored locally.\n");
     printf("\n");
+    printf("--window N:\n"
+        "The number of AtomicReadFile requests in flight at one time,\n"
+        "from 1 to %u. The default is %u.\n",
+        (unsigned)BACNET_FILE_TRANSFER_WINDOW_MAX, Target_File_Window);
+    printf("\n");
+    printf("--resume:\n"
+        "Continue a transfer that failed: the file is read from the\n"
+        "size of the local file, which is kept.\n");
+    printf("\n");
     printf("Example:\n"
         "If you want read File 2 from Device 123 and save it to temp.txt,\n"
         "use the following command:\n"
@@ -247,10 +207,14 @@ int main(int argc, char *argv[])
     time_t last_seconds = 0;
     time_t current_seconds = 0;
     time_t timeout_seconds = 0;
-    uint8_t invoke_id = 0;
+    time_t start_seconds = 0;
     bool found = false;
-    uint16_t my_max_apdu = 0;
+    bool started = false;
+    long position = 0;
+    unsigned long octets = 0;
+    unsigned long seconds = 0;
     int argi = 0;
+    int target_args = 0;
     char *filename = NULL;
 
     /* print help if requested */
@@ -270,15 +234,28 @@ int main(int argc, char *argv[])
                    "FITNESS FOR A PARTICULAR PURPOSE.\n");
             return 0;
         }
+        if (strcmp(argv[argi], "--window") == 0) {
+            if (++argi < argc) {
+                Target_File_Window = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--resume") == 0) {
+            Local_File_Resume = true;
+        } else {
+            /* decode the command line parameters */
+            if (target_args == 0) {
+                Target_Device_Object_Instance = strtol(argv[argi], NULL, 0);
+            } else if (target_args == 1) {
+                Target_File_Object_Instance = strtol(argv[argi], NULL, 0);
+            } else if (target_args == 2) {
+                Local_File_Name = argv[argi];
+            }
+            target_args++;
+        }
     }
-    if (argc < 4) {
+    if (target_args < 3) {
         print_usage(filename);
         return 0;
     }
-    /* decode the command line parameters */
-    Target_Device_Object_Instance = strtol(argv[1], NULL, 0);
-    Target_File_Object_Instance = strtol(argv[2], NULL, 0);
-    Local_File_Name = argv[3];
     if (Target_Device_Object_Instance > BACNET_MAX_INSTANCE) {
         fprintf(stderr, "device-instance=%u - not greater than %u\n",
             Target_Device_Object_Instance, BACNET_MAX_INSTANCE);
@@ -289,6 +266,26 @@ int main(int argc, char *argv[])
             Target_File_Object_Instance, BACNET_MAX_INSTANCE);
         return 1;
     }
+    if ((Target_File_Window == 0) ||
+        (Target_File_Window > BACNET_FILE_TRANSFER_WINDOW_MAX)) {
+        fprintf(stderr, "window=%u - not 1 to %u\n", Target_File_Window,
+            (unsigned)BACNET_FILE_TRANSFER_WINDOW_MAX);
+        return 1;
+    }
+    if (Local_File_Resume) {
+        Local_File = fopen(Local_File_Name, "rb+");
+        if (Local_File && (fseek(Local_File, 0L, SEEK_END) == 0)) {
+            position = ftell(Local_File);
+        }
+    }
+    if (!Local_File) {
+        position = 0;
+        Local_File = fopen(Local_File_Name, "wb");
+    }
+    if (!Local_File || (position < 0)) {
+        fprintf(stderr, "Unable to open file \"%s\".\n", Local_File_Name);
+        return 1;
+    }
     /* setup my info */
     Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
     address_init();
@@ -328,44 +325,26 @@ int main(int argc, char *argv[])
                 Target_Device_Object_Instance, &max_apdu, &Target_Address);
         }
         if (found) {
-            /* calculate the smaller of our APDU size or theirs
-               and remove the overhead of the APDU (about 16 octets max).
-               note: we could fail if there is a bottle neck (router)
-               and smaller MPDU in betweeen. */
-            if (max_apdu < MAX_APDU) {
-                my_max_apdu = max_apdu;
-            } else {
-                my_max_apdu = MAX_APDU;
-            }
-            /* Typical sizes are 50, 128, 206, 480, 1024, and 1476 octets */
-            if (my_max_apdu <= 50) {
-                Target_File_Requested_Octet_Count = my_max_apdu - 20;
-            } else if (my_max_apdu <= 480) {
-                Target_File_Requested_Octet_Count = my_max_apdu - 32;
-            } else if (my_max_apdu <= 1476) {
-                Target_File_Requested_Octet_Count = my_max_apdu - 64;
-            } else {
-                Target_File_Requested_Octet_Count = my_max_apdu / 2;
-            }
-            /* has the previous invoke id expired or returned?
-               note: invoke ID = 0 is invalid, so it will be idle */
-            if ((invoke_id == 0) || tsm_invoke_id_free(invoke_id)) {
-                if (End_Of_File_Detected || Error_Detected) {
-                    break;
-                }
-                /* the ACK will increment the start position if OK */
+            if (!started) {
                 /* we'll read the file in chunks
                    less than max_apdu to keep unsegmented */
-                invoke_id =
-                    Send_Atomic_Read_File_Stream(Target_Device_Object_Instance,
-                        Target_File_Object_Instance, Target_File_Start_Position,
-                        Target_File_Requested_Octet_Count);
-                Request_Invoke_ID = invoke_id;
-            } else if (tsm_invoke_id_failed(invoke_id)) {
-                fprintf(stderr, "\rError: TSM Timeout!\n");
-                tsm_free_invoke_id(invoke_id);
-                /* try again or abort? */
-                Error_Detected = true;
+                started = bacnet_file_transfer_read_start(
+                    Target_Device_Object_Instance, Target_File_Object_Instance,
+                    Local_File, (int32_t)position,
+                    bacnet_file_transfer_chunk_size(max_apdu, false),
+                    Target_File_Window);
+                if (!started) {
+                    Error_Detected = true;
+                    break;
+                }
+                start_seconds = current_seconds;
+            }
+            bacnet_file_transfer_task();
+            if (!bacnet_file_transfer_busy()) {
+                if (bacnet_file_transfer_failed()) {
+                    fprintf(stderr, "\rError: file transfer failed!\n");
+                    Error_Detected = true;
+                }
                 break;
             }
         } else {
@@ -380,7 +359,13 @@ int main(int argc, char *argv[])
         /* keep track of time for next check */
         last_seconds = current_seconds;
     }
-
+    fclose(Local_File);
+    if (started) {
+        octets = bacnet_file_transfer_octets();
+        seconds = (unsigned long)(time(NULL) - start_seconds);
+        printf("\n%lu bytes in %lu seconds (%lu bytes/second)\n", octets,
+            seconds, seconds ? (octets / seconds) : octets);
+    }
     if (Error_Detected) {
         return 1;
     }
@@ -0,0 +1,209 @@
+/**
+ * @file
+ * @brief command line tool that reads properties of objects in other
+ *  BACnet devices with the ReadProperty service, with all of the reads
+ *  in flight at once, and prints each value as its reply arrives.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define PRINT_ENABLED 1
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/bactext.h"
+#include "bacnet/npdu.h"
+#include "bacnet/version.h"
+/* some demo stuff needed */
+#include "bacnet/basic/client/bac-async.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/datalink/dlenv.h"
+
+#if BACNET_SVC_SERVER
+#error "App requires server-only features disabled! Set BACNET_SVC_SERVER=0"
+#endif
+
+/* buffer used for receive */
+static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+/* task timer for TSM timeouts */
+static struct mstimer BACnet_TSM_Timer;
+static bool Error_Detected = false;
+
+/**
+ * @brief Print the result of one read as it completes
+ * @param handle [in] handle of the request
+ * @param device_id [in] device instance number of the request
+ * @param rp_data [in] the result of the request
+ * @param value [in] the first decoded value, or NULL
+ * @param context [in] not used
+ */
+static void read_property_complete(BACNET_ASYNC_HANDLE handle,
+    uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    void *context)
+{
+    (void)handle;
+    (void)value;
+    (void)context;
+    printf("%lu %s %lu %s: ", (unsigned long)device_id,
+        bactext_object_type_name(rp_data->object_type),
+        (unsigned long)rp_data->object_instance,
+        bactext_property_name(rp_data->object_property));
+    if (rp_data->error_code == ERROR_CODE_SUCCESS) {
+        rp_ack_print_data(rp_data);
+    } else {
+        printf("BACnet Error: %s: %s\n",
+            bactext_error_class_name((int)rp_data->error_class),
+            bactext_error_code_name((int)rp_data->error_code));
+        Error_Detected = true;
+    }
+}
+
+static void Init_Service_Handlers(void)
+{
+    Device_Init(NULL);
+    /* we need to handle who-is
+       to support dynamic device binding to us */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_IS, handler_who_is);
+    /* set the handler for all the services we don't implement
+       It is required to send the proper reject message... */
+    apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
+    /* we must implement read property - it's required! */
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
+    /* the replies, errors, and binding of our requests */
+    bacnet_async_init();
+}
+
+static void print_usage(char *filename)
+{
+    printf("Usage: %s device-instance object-type object-instance "
+           "property\n",
+        filename);
+    printf("       [device-instance object-type object-instance "
+           "property]...\n");
+    printf("       [--version][--help]\n");
+}
+
+static void print_help(char *filename)
+{
+    printf("Read properties from objects in BACnet devices\n"
+           "and print the values. All of the reads are sent\n"
+           "without waiting for the replies of the others.\n");
+    printf("\n");
+    printf("device-instance:\n"
+           "BACnet Device Object Instance number that you are\n"
+           "trying to communicate to.\n");
+    printf("\n");
+    printf("object-type:\n"
+           "The object type name string or the integer value of\n"
+           "the enumeration BACNET_OBJECT_TYPE in bacenum.h.\n");
+    printf("\n");
+    printf("object-instance:\n"
+           "The object instance number of the object.\n");
+    printf("\n");
+    printf("property:\n"
+           "The property name string or the integer value of the\n"
+           "enumeration BACNET_PROPERTY_ID in bacenum.h.\n");
+    printf("\n");
+    printf("Example:\n"
+           "If you want read the Present-Value of Analog Output 101\n"
+           "and of Analog Input 2 in Device 123, you could send:\n"
+           "%s 123 analog-output 101 present-value "
+           "123 analog-input 2 present-value\n",
+        filename);
+}
+
+int main(int argc, char *argv[])
+{
+    BACNET_ADDRESS src = { 0 }; /* address where message came from */
+    uint16_t pdu_len = 0;
+    unsigned timeout = 10; /* milliseconds */
+    uint32_t device_id = 0;
+    uint32_t object_instance = 0;
+    unsigned object_type = 0;
+    unsigned object_property = 0;
+    int argi = 0;
+    char *filename = NULL;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        }
+        if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            printf("Copyright (C) 2026 by Steve Karg and others.\n"
+                   "This is free software; see the source for copying "
+                   "conditions.\n"
+                   "There is NO warranty; not even for MERCHANTABILITY or\n"
+                   "FITNESS FOR A PARTICULAR PURPOSE.\n");
+            return 0;
+        }
+    }
+    if ((argc < 5) || (((argc - 1) % 4) != 0)) {
+        print_usage(filename);
+        return 0;
+    }
+    /* setup my info */
+    Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
+    Init_Service_Handlers();
+    dlenv_init();
+    atexit(datalink_cleanup);
+    for (argi = 1; (argi + 3) < argc; argi += 4) {
+        device_id = strtol(argv[argi], NULL, 0);
+        if (device_id >= BACNET_MAX_INSTANCE) {
+            fprintf(stderr, "device-instance=%s invalid\n", argv[argi]);
+            return 1;
+        }
+        if (!bactext_object_type_strtol(argv[argi + 1], &object_type)) {
+            fprintf(stderr, "object-type=%s invalid\n", argv[argi + 1]);
+            return 1;
+        }
+        object_instance = strtol(argv[argi + 2], NULL, 0);
+        if (!bactext_property_strtol(argv[argi + 3], &object_property)) {
+            fprintf(stderr, "property=%s invalid\n", argv[argi + 3]);
+            return 1;
+        }
+        if (bacnet_async_read_property(device_id,
+                (BACNET_OBJECT_TYPE)object_type, object_instance,
+                (BACNET_PROPERTY_ID)object_property, BACNET_ARRAY_ALL,
+                read_property_complete, NULL) == BACNET_ASYNC_HANDLE_NONE) {
+            fprintf(stderr, "Error: too many requests!\n");
+            return 1;
+        }
+    }
+    mstimer_set(&BACnet_TSM_Timer, 50);
+    /* until every request has completed */
+    while (bacnet_async_pending() > 0) {
+        if (mstimer_expired(&BACnet_TSM_Timer)) {
+            mstimer_reset(&BACnet_TSM_Timer);
+            tsm_timer_milliseconds(mstimer_interval(&BACnet_TSM_Timer));
+        }
+        bacnet_async_task();
+        /* returns 0 bytes on timeout */
+        pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
+        /* process */
+        if (pdu_len) {
+            npdu_handler(&src, &Rx_Buf[0], pdu_len);
+        }
+    }
+    if (Error_Detected) {
+        return 1;
+    }
+
+    return 0;
+}
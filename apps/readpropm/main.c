@@ -34,6 +34,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/filename.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/static_pool.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/datalink/dlenv.h"
@@ -46,6 +47,10 @@
 
 /* buffer used for receive */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+#if BACNET_SEGMENTATION_ENABLED
+/* buffer used to reassemble a segmented reply */
+static uint8_t Reassembly_Buf[BACNET_SEGMENTATION_BUFFER_SIZE];
+#endif
 
 /* global variables used in this file */
 static uint32_t Target_Device_Object_Instance = BACNET_MAX_INSTANCE;
@@ -120,7 +125,7 @@ static void My_Read_Property_Multiple_Ack_Handler(uint8_t *service_request,
 
     if (address_match(&Target_Address, src) &&
         (service_data->invoke_id == Request_Invoke_ID)) {
-        rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+        rpm_data = bacnet_calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
         if (rpm_data) {
             len = rpm_ack_decode_service_request(
                 service_request, service_len, rpm_data);
@@ -139,15 +144,15 @@ static void My_Read_Property_Multiple_Ack_Handler(uint8_t *service_request,
                     while (value) {
                         old_value = value;
                         value = value->next;
-                        free(old_value);
+                        bacnet_free(old_value);
                     }
                     old_rpm_property = rpm_property;
                     rpm_property = rpm_property->next;
-                    free(old_rpm_property);
+                    bacnet_free(old_rpm_property);
                 }
                 old_rpm_data = rpm_data;
                 rpm_data = rpm_data->next;
-                free(old_rpm_data);
+                bacnet_free(old_rpm_data);
             }
         }
     }
@@ -174,6 +179,10 @@ static void Init_Service_Handlers(void)
     apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
     apdu_set_abort_handler(MyAbortHandler);
     apdu_set_reject_handler(MyRejectHandler);
+#if BACNET_SEGMENTATION_ENABLED
+    /* accept replies that are too large for one APDU */
+    tsm_reassembly_buffer_set(&Reassembly_Buf[0], sizeof(Reassembly_Buf));
+#endif
 }
 
 static void cleanup(void)
@@ -190,11 +199,11 @@ static void cleanup(void)
         while (rpm_property) {
             old_rpm_property = rpm_property;
             rpm_property = rpm_property->next;
-            free(old_rpm_property);
+            bacnet_free(old_rpm_property);
         }
         old_rpm_object = rpm_object;
         rpm_object = rpm_object->next;
-        free(old_rpm_object);
+        bacnet_free(old_rpm_object);
     }
 }
 
@@ -402,11 +411,11 @@ int main(int argc, char *argv[])
                 if (tag_value_arg == 0) {
                     if (rpm_object) {
                         rpm_object->next =
-                            calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+                            bacnet_calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
                         rpm_object = rpm_object->next;
                     } else {
                         Read_Access_Data =
-                            calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+                            bacnet_calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
                         rpm_object = Read_Access_Data;
                         atexit(cleanup);
                     }
@@ -436,7 +445,8 @@ int main(int argc, char *argv[])
                     }
                     tag_value_arg++;
                 } else if (tag_value_arg == 2) {
-                    rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+                    rpm_property =
+                        bacnet_calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
                     rpm_object->listOfProperties = rpm_property;
                     property_token = strtok(argv[argi], ",");
                     /* add all the properties and optional index to our list */
@@ -463,8 +473,8 @@ int main(int argc, char *argv[])
                         /* is there another property? */
                         property_token = strtok(NULL, ",");
                         if (property_token) {
-                            rpm_property->next =
-                                calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+                            rpm_property->next = bacnet_calloc(
+                                1, sizeof(BACNET_PROPERTY_REFERENCE));
                             rpm_property = rpm_property->next;
                         } else {
                             rpm_property->next = NULL;
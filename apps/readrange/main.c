@@ -44,6 +44,10 @@
 
 /* buffer used for receive */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+#if BACNET_SEGMENTATION_ENABLED
+/* buffer used to reassemble a segmented reply */
+static uint8_t Reassembly_Buf[BACNET_SEGMENTATION_BUFFER_SIZE];
+#endif
 
 /* converted command line arguments */
 static uint32_t Target_Device_Object_Instance = BACNET_MAX_INSTANCE;
@@ -119,6 +123,10 @@ static void Init_Service_Handlers(void)
     apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
     apdu_set_abort_handler(MyAbortHandler);
     apdu_set_reject_handler(MyRejectHandler);
+#if BACNET_SEGMENTATION_ENABLED
+    /* accept replies that are too large for one APDU */
+    tsm_reassembly_buffer_set(&Reassembly_Buf[0], sizeof(Reassembly_Buf));
+#endif
 }
 
 static void print_usage(char *filename)
@@ -9,9 +9,12 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <signal.h>
 #include <time.h>
-#include <assert.h>
+#if !defined(_WIN32)
+#include <poll.h>
+#endif
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -24,8 +27,10 @@
 #include "bacnet/version.h"
 /* some demo modules we use */
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/npdu/route_table.h"
 #include "bacnet/basic/services.h"
 /* port agnostic file */
 #include "bacport.h"
@@ -61,28 +66,50 @@ static uint32_t Device_Instance_Number = BACNET_MAX_INSTANCE;
  * unreachability due to the imposition of a congestion control
  * restriction.
  */
-typedef struct _dnet {
+typedef struct router_port {
     uint8_t mac[MAX_MAC_LEN];
     uint8_t mac_len;
     uint16_t net;
     bool enabled;
-    struct _dnet *dnets;
-    struct _dnet *next;
-} DNET;
-/* The list of DNETs that our router can reach. */
-static DNET *Router_Table_Head;
+} ROUTER_PORT;
+/* the BACnet/IP and the BACnet/IPv6 ports */
+#define ROUTER_PORTS_MAX 2
+static ROUTER_PORT Router_Ports[ROUTER_PORTS_MAX];
+static unsigned Router_Ports_Count;
+/* number of entries of the routing table, a power of two, which holds
+   three quarters as many networks */
+#ifndef ROUTER_ROUTES_MAX
+#define ROUTER_ROUTES_MAX 256
+#endif
+/* The networks that our router can reach, each with its port, including
+   the directly connected networks of the ports */
+static BACNET_ROUTE_ENTRY Router_Routes[ROUTER_ROUTES_MAX];
+static BACNET_ROUTE_TABLE Router_Table;
 /* track our directly connected ports network number */
 static uint16_t BIP_Net;
 static uint16_t BIP6_Net;
+/* octets reserved in front of each received NPDU, so that a routed
+   message has its NPCI encoded in place in front of its APDU */
+#define ROUTER_HEADROOM MAX_NPDU
 /* buffer for receiving packets from the directly connected ports */
-static uint8_t BIP_Rx_Buffer[BIP_MPDU_MAX];
-static uint8_t BIP6_Rx_Buffer[BIP6_MPDU_MAX];
+static uint8_t BIP_Rx_Buffer[ROUTER_HEADROOM + BIP_MPDU_MAX];
+static uint8_t BIP6_Rx_Buffer[ROUTER_HEADROOM + BIP6_MPDU_MAX];
 /* buffer for transmitting from any port */
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 static uint8_t Tx_Buffer[MAX(BIP_MPDU_MAX, BIP6_MPDU_MAX)];
 /* main loop exit control */
 static bool Exit_Requested;
 
+/* number of times each network is received from before the timers run */
+#define ROUTER_RECEIVE_MAX 32
+/* milliseconds that each network is received from when there is no
+   descriptor to wait on */
+#if defined(_WIN32)
+#define ROUTER_RECEIVE_TIMEOUT 5
+#else
+#define ROUTER_RECEIVE_TIMEOUT 0
+#endif
+
 /**
  * Search the router table to find a matching DNET entry
  *
@@ -94,60 +121,39 @@ static bool Exit_Requested;
  * The caller will need to compare the sought after net with the
  * returned port->net to determine if the addr is filled.
  */
-static DNET *dnet_find(uint16_t net, BACNET_ADDRESS *addr)
+static ROUTER_PORT *dnet_find(uint16_t net, BACNET_ADDRESS *addr)
 {
-    DNET *port = Router_Table_Head;
-    DNET *dnet = NULL;
-    unsigned int i = 0;
+    BACNET_ROUTE_ENTRY *route;
+    ROUTER_PORT *port;
 
-    while (port != NULL) {
-        if (net == port->net) {
-            /* DNET is directly connected to the router */
-            return port;
-        } else if (port->dnets) {
-            /* search router ports DNET list */
-            dnet = port->dnets;
-            while (dnet != NULL) {
-                if (net == dnet->net) {
-                    if (addr) {
-                        addr->mac_len = dnet->mac_len;
-                        for (i = 0; i < MAX_MAC_LEN; i++) {
-                            addr->mac[i] = dnet->mac[i];
-                        }
-                    }
-                    return port;
-                }
-                dnet = dnet->next;
-            }
-        }
-        port = port->next;
+    route = bacnet_route_find(&Router_Table, net);
+    if (!route) {
+        return NULL;
+    }
+    port = route->port;
+    if (addr && (port->net != net)) {
+        /* DNET is reached through the next router on the port */
+        addr->mac_len = route->mac_len;
+        memcpy(addr->mac, route->mac, MAX_MAC_LEN);
     }
 
-    return NULL;
+    return port;
 }
 
 static bool port_find(uint16_t snet, BACNET_ADDRESS *addr)
 {
-    DNET *port = NULL;
-    bool found = false;
-    unsigned int i = 0;
+    ROUTER_PORT *port = NULL;
 
-    port = Router_Table_Head;
-    while (port) {
-        if (port->net == snet) {
-            if (addr) {
-                addr->mac_len = port->mac_len;
-                for (i = 0; i < MAX_MAC_LEN; i++) {
-                    addr->mac[i] = port->mac[i];
-                }
-            }
-            found = true;
-            break;
-        }
-        port = port->next;
+    port = dnet_find(snet, NULL);
+    if (!port || (port->net != snet)) {
+        return false;
+    }
+    if (addr) {
+        addr->mac_len = port->mac_len;
+        memcpy(addr->mac, port->mac, MAX_MAC_LEN);
     }
 
-    return found;
+    return true;
 }
 
 /**
@@ -158,43 +164,24 @@ static bool port_find(uint16_t snet, BACNET_ADDRESS *addr)
  */
 static void port_add(uint16_t snet, BACNET_ADDRESS *addr)
 {
-    DNET *port = NULL;
-    DNET *dnet = NULL;
-    unsigned int i = 0;
+    ROUTER_PORT *port = NULL;
 
-    port = dnet_find(snet, NULL);
-    if (!port) {
-        port = Router_Table_Head;
-        if (!port) {
-            /* create first port */
-            port = (DNET *)calloc(1, sizeof(DNET));
-            assert(port);
-            Router_Table_Head = port;
-        } else {
-            while (port) {
-                if (port->next) {
-                    port = port->next;
-                } else {
-                    /* create next port */
-                    dnet = (DNET *)calloc(1, sizeof(DNET));
-                    assert(dnet);
-                    port->next = dnet;
-                    port = port->next;
-                    break;
-                }
-            }
-        }
-        port->net = snet;
-        if (addr) {
-            port->mac_len = addr->mac_len;
-            for (i = 0; i < MAX_MAC_LEN; i++) {
-                port->mac[i] = addr->mac[i];
-            }
-        } else {
-            port->mac_len = 0;
-        }
-        port->enabled = true;
+    if (dnet_find(snet, NULL) || (Router_Ports_Count >= ROUTER_PORTS_MAX)) {
+        return;
+    }
+    port = &Router_Ports[Router_Ports_Count];
+    if (!bacnet_route_add(&Router_Table, snet, port, NULL, 0)) {
+        return;
+    }
+    Router_Ports_Count++;
+    port->net = snet;
+    if (addr) {
+        port->mac_len = addr->mac_len;
+        memcpy(port->mac, addr->mac, MAX_MAC_LEN);
+    } else {
+        port->mac_len = 0;
     }
+    port->enabled = true;
 }
 
 /**
@@ -206,14 +193,10 @@ static void port_add(uint16_t snet, BACNET_ADDRESS *addr)
  */
 static void dnet_add(uint16_t snet, uint16_t net, BACNET_ADDRESS *addr)
 {
-    DNET *dnet = NULL;
-    DNET *port = NULL;
-    DNET *prior_dnet = NULL;
-    unsigned int i = 0;
+    ROUTER_PORT *port = NULL;
 
     /* make sure NETs are not repeated */
-    dnet = dnet_find(net, NULL);
-    if (dnet) {
+    if (dnet_find(net, NULL)) {
         return;
     }
     /* start with the source network number table */
@@ -221,58 +204,9 @@ static void dnet_add(uint16_t snet, uint16_t net, BACNET_ADDRESS *addr)
     if (!port) {
         return;
     }
-    dnet = port->dnets;
-    if (dnet == NULL) {
-        /* first DNET to add */
-        dnet = (DNET *)calloc(1, sizeof(DNET));
-        assert(dnet);
-        port->dnets = dnet;
-        if (addr) {
-            dnet->mac_len = addr->mac_len;
-            for (i = 0; i < MAX_MAC_LEN; i++) {
-                dnet->mac[i] = addr->mac[i];
-            }
-        }
-        dnet->net = net;
-        dnet->enabled = true;
-        dnet->next = NULL;
-    } else {
-        while (dnet != NULL) {
-            if (dnet->net == net) {
-                /* make sure NETs are not repeated */
-                return;
-            }
-            prior_dnet = dnet;
-            dnet = dnet->next;
-        }
-        /* next DNET to add */
-        dnet = (DNET *)calloc(1, sizeof(DNET));
-        if (addr) {
-            dnet->mac_len = addr->mac_len;
-            for (i = 0; i < MAX_MAC_LEN; i++) {
-                dnet->mac[i] = addr->mac[i];
-            }
-        }
-        dnet->net = net;
-        dnet->enabled = true;
-        dnet->next = NULL;
-        prior_dnet->next = dnet;
-    }
-}
-
-/**
- * Free the DNET data of a route
- *
- * @param dnets - router info to be freed
- */
-static void dnet_cleanup(DNET *dnets)
-{
-    DNET *dnet = dnets;
-    while (dnet != NULL) {
-        debug_printf("DNET %u removed\n", (unsigned)dnet->net);
-        dnet = dnet->next;
-        free(dnets);
-        dnets = dnet;
+    if (!bacnet_route_add(&Router_Table, net, port,
+            addr ? addr->mac : NULL, addr ? addr->mac_len : 0)) {
+        debug_printf("DNET %u not added: routing table full\n", (unsigned)net);
     }
 }
 
@@ -343,8 +277,8 @@ static void send_i_am_router_to_network(uint16_t snet, uint16_t net)
     BACNET_NPDU_DATA npdu_data;
     int pdu_len = 0;
     int len = 0;
-    DNET *port = NULL;
-    DNET *dnet = NULL;
+    BACNET_ROUTE_ENTRY *route = NULL;
+    ROUTER_PORT *port = NULL;
 
     datalink_get_broadcast_address(&dest);
     npdu_encode_npdu_network(&npdu_data, NETWORK_MESSAGE_I_AM_ROUTER_TO_NETWORK,
@@ -364,21 +298,13 @@ static void send_i_am_router_to_network(uint16_t snet, uint16_t net)
             This enables routers to build or update their routing table
             entries for each of the network numbers contained in the message.
         */
-        port = Router_Table_Head;
-        while (port != NULL) {
+        while ((route = bacnet_route_next(&Router_Table, route)) != NULL) {
+            port = route->port;
             if (port->net != snet) {
-                debug_printf("%u,", port->net);
-                len = encode_unsigned16(&Tx_Buffer[pdu_len], port->net);
+                debug_printf("%u,", route->net);
+                len = encode_unsigned16(&Tx_Buffer[pdu_len], route->net);
                 pdu_len += len;
-                dnet = port->dnets;
-                while (dnet != NULL) {
-                    debug_printf("%u,", dnet->net);
-                    len = encode_unsigned16(&Tx_Buffer[pdu_len], dnet->net);
-                    pdu_len += len;
-                    dnet = dnet->next;
-                }
             }
-            port = port->next;
         }
         debug_printf("from %u\n", snet);
     }
@@ -407,7 +333,7 @@ static void send_initialize_routing_table_ack(uint8_t snet, BACNET_ADDRESS *dst)
     int len = 0;
     uint8_t count = 0;
     uint8_t port_id = 1;
-    DNET *port = NULL;
+    unsigned i = 0;
 
     if (dst) {
         bacnet_address_copy(&dest, dst);
@@ -420,11 +346,7 @@ static void send_initialize_routing_table_ack(uint8_t snet, BACNET_ADDRESS *dst)
        our downstream BACnet network. */
     pdu_len = npdu_encode_pdu(&Tx_Buffer[0], &dest, NULL, &npdu_data);
     /* First, count the number of Ports we will encode */
-    port = Router_Table_Head;
-    while (port != NULL) {
-        count++;
-        port = port->next;
-    }
+    count = (uint8_t)Router_Ports_Count;
     Tx_Buffer[pdu_len] = count;
     pdu_len++;
     if (count > 0) {
@@ -432,16 +354,14 @@ static void send_initialize_routing_table_ack(uint8_t snet, BACNET_ADDRESS *dst)
          * We will simply use a positive index for PortID,
          * and have no PortInfo.
          */
-        port = Router_Table_Head;
-        while (port != NULL) {
-            len = encode_unsigned16(&Tx_Buffer[pdu_len], port->net);
+        for (i = 0; i < Router_Ports_Count; i++) {
+            len = encode_unsigned16(&Tx_Buffer[pdu_len], Router_Ports[i].net);
             pdu_len += len;
             Tx_Buffer[pdu_len] = port_id;
             pdu_len++;
             port_id++;
             Tx_Buffer[pdu_len] = 0;
             pdu_len++;
-            port = port->next;
         }
     }
     /* Now send the message */
@@ -576,9 +496,10 @@ static void who_is_router_to_network_handler(uint16_t snet,
     uint8_t *npdu,
     uint16_t npdu_len)
 {
-    DNET *port = NULL;
+    ROUTER_PORT *port = NULL;
     uint16_t network = 0;
     uint16_t len = 0;
+    unsigned i = 0;
 
     (void)src;
     (void)npdu_data;
@@ -594,12 +515,11 @@ static void who_is_router_to_network_handler(uint16_t snet,
                 }
             } else {
                 /* discover the next router on the path to the network */
-                port = Router_Table_Head;
-                while (port) {
-                    if (port->net != snet) {
-                        send_who_is_router_to_network(port->net, network);
+                for (i = 0; i < Router_Ports_Count; i++) {
+                    if (Router_Ports[i].net != snet) {
+                        send_who_is_router_to_network(
+                            Router_Ports[i].net, network);
                     }
-                    port = port->next;
                 }
             }
         } else {
@@ -780,6 +700,36 @@ static void routed_src_address(
     }
 }
 
+/**
+ * @brief Encode the NPCI of a routed message in place, directly in front
+ *  of its APDU, so that the APDU is not copied before it is sent.
+ *  The APDU is in a receive buffer, after at least ROUTER_HEADROOM octets.
+ * @param dest [in] The destination address of the message.
+ * @param src [in] The source address of the message.
+ * @param npdu [in] The NPCI data of the message.
+ * @param apdu [in] The APDU of the message in the receive buffer.
+ * @param apdu_len [in] The number of octets of the APDU.
+ * @param pdu_len [out] The number of octets of the NPCI and APDU.
+ * @return The start of the NPCI in front of the APDU.
+ */
+static uint8_t *routed_npdu_encode(BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu,
+    uint8_t *apdu,
+    uint16_t apdu_len,
+    uint16_t *pdu_len)
+{
+    uint8_t npci[MAX_NPDU];
+    int npci_len = 0;
+
+    npci_len = npdu_encode_pdu(&npci[0], dest, src, npdu);
+    /* the received NPCI is decoded already, and is overwritten */
+    memmove(apdu - npci_len, &npci[0], npci_len);
+    *pdu_len = npci_len + apdu_len;
+
+    return apdu - npci_len;
+}
+
 /**
  * If a BACnet NPDU is received with NPCI indicating that the message
  * should be relayed by virtue of the presence of a non-broadcast
@@ -806,11 +756,13 @@ static void routed_apdu_handler(uint16_t snet,
     uint8_t *apdu,
     uint16_t apdu_len)
 {
-    DNET *port = NULL;
+    ROUTER_PORT *port = NULL;
     BACNET_ADDRESS local_dest;
     BACNET_ADDRESS remote_dest;
     BACNET_ADDRESS router_src;
-    int npdu_len = 0;
+    uint8_t *pdu = NULL;
+    uint16_t pdu_len = 0;
+    unsigned i = 0;
 
     /* for broadcast messages no search is needed */
     if (dest->net == BACNET_BROADCAST_NETWORK) {
@@ -830,18 +782,15 @@ static void routed_apdu_handler(uint16_t snet,
         npdu->hop_count--;
         routed_src_address(&router_src, snet, src);
         /* encode both source and destination for broadcast */
-        npdu_len =
-            npdu_encode_pdu(&Tx_Buffer[0], &local_dest, &router_src, npdu);
-        memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
+        pdu = routed_npdu_encode(
+            &local_dest, &router_src, npdu, apdu, apdu_len, &pdu_len);
         /* send to my other ports */
         debug_printf("Routing a BROADCAST from %u\n", (unsigned)snet);
-        port = Router_Table_Head;
-        while (port != NULL) {
-            if (port->net != snet) {
-                datalink_send_pdu(port->net, &local_dest, npdu, &Tx_Buffer[0],
-                    npdu_len + apdu_len);
+        for (i = 0; i < Router_Ports_Count; i++) {
+            if (Router_Ports[i].net != snet) {
+                datalink_send_pdu(
+                    Router_Ports[i].net, &local_dest, npdu, pdu, pdu_len);
             }
-            port = port->next;
         }
         return;
     }
@@ -862,11 +811,9 @@ static void routed_apdu_handler(uint16_t snet,
             local_dest.net = 0;
             npdu->hop_count--;
             routed_src_address(&router_src, snet, src);
-            npdu_len =
-                npdu_encode_pdu(&Tx_Buffer[0], &local_dest, &router_src, npdu);
-            memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
-            datalink_send_pdu(port->net, &local_dest, npdu, &Tx_Buffer[0],
-                npdu_len + apdu_len);
+            pdu = routed_npdu_encode(
+                &local_dest, &router_src, npdu, apdu, apdu_len, &pdu_len);
+            datalink_send_pdu(port->net, &local_dest, npdu, pdu, pdu_len);
         } else {
             debug_printf(
                 "Routing to another Router %u\n", (unsigned)remote_dest.net);
@@ -879,11 +826,9 @@ static void routed_apdu_handler(uint16_t snet,
                 discarded. */
             npdu->hop_count--;
             routed_src_address(&router_src, snet, src);
-            npdu_len =
-                npdu_encode_pdu(&Tx_Buffer[0], &remote_dest, &router_src, npdu);
-            memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
-            datalink_send_pdu(port->net, &remote_dest, npdu, &Tx_Buffer[0],
-                npdu_len + apdu_len);
+            pdu = routed_npdu_encode(
+                &remote_dest, &router_src, npdu, apdu, apdu_len, &pdu_len);
+            datalink_send_pdu(port->net, &remote_dest, npdu, pdu, pdu_len);
         }
     } else if (dest->net) {
         debug_printf("Routing to Unknown Route %u\n", (unsigned)dest->net);
@@ -892,16 +837,14 @@ static void routed_apdu_handler(uint16_t snet,
         npdu->hop_count--;
         /* encode both source and destination */
         routed_src_address(&router_src, snet, src);
-        npdu_len = npdu_encode_pdu(&Tx_Buffer[0], dest, &router_src, npdu);
-        memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
+        pdu = routed_npdu_encode(
+            dest, &router_src, npdu, apdu, apdu_len, &pdu_len);
         /* send to all other ports */
-        port = Router_Table_Head;
-        while (port != NULL) {
-            if (port->net != snet) {
-                datalink_send_pdu(port->net, dest, npdu, &Tx_Buffer[0],
-                	npdu_len + apdu_len);
+        for (i = 0; i < Router_Ports_Count; i++) {
+            if (Router_Ports[i].net != snet) {
+                datalink_send_pdu(
+                    Router_Ports[i].net, dest, npdu, pdu, pdu_len);
             }
-            port = port->next;
         }
         /*  If the next router is unknown, an attempt shall be made to
             identify it using a Who-Is-Router-To-Network message. */
@@ -1037,6 +980,7 @@ static void datalink_init(void)
     } else {
         BIP_Net = 1;
     }
+    bacnet_route_table_init(&Router_Table, Router_Routes, ROUTER_ROUTES_MAX);
     /* configure the first entry in the table - home port */
     bip_get_my_address(&my_address);
     port_add(BIP_Net, &my_address);
@@ -1058,17 +1002,14 @@ static void datalink_init(void)
  */
 static void cleanup(void)
 {
-    DNET *port = NULL;
+    BACNET_ROUTE_ENTRY *route = NULL;
 
     fprintf(stderr, "Cleaning up...\n");
-    /* clean up the remote networks */
-    port = Router_Table_Head;
-    while (port != NULL) {
-        dnet_cleanup(port->dnets);
-        port = port->next;
+    while ((route = bacnet_route_next(&Router_Table, NULL)) != NULL) {
+        debug_printf("DNET %u removed\n", (unsigned)route->net);
+        bacnet_route_remove(&Router_Table, route->net);
     }
-    /* clean up the directly connected networks */
-    dnet_cleanup(Router_Table_Head);
+    Router_Ports_Count = 0;
 }
 
 #if defined(_WIN32)
@@ -1112,6 +1053,45 @@ static void control_c_hooks(void)
 }
 #endif
 
+/**
+ * @brief Wait until a packet is received from either network, or until
+ *  the timeout, so that the timers run without delay and the router
+ *  sleeps while there is nothing to do
+ * @param timeout - number of milliseconds to wait
+ */
+static void router_wait(unsigned long timeout)
+{
+#if defined(_WIN32)
+    /* the networks are received from with a timeout instead */
+    (void)timeout;
+#else
+    int sockets[3];
+    struct pollfd fds[3];
+    nfds_t nfds = 0;
+    unsigned i, j;
+
+    sockets[0] = bip_get_socket();
+    sockets[1] = bip_get_broadcast_socket();
+    sockets[2] = bip6_get_socket();
+    for (i = 0; i < 3; i++) {
+        if (sockets[i] < 0) {
+            continue;
+        }
+        for (j = 0; j < nfds; j++) {
+            if (fds[j].fd == sockets[i]) {
+                break;
+            }
+        }
+        if (j == nfds) {
+            fds[nfds].fd = sockets[i];
+            fds[nfds].events = POLLIN;
+            nfds++;
+        }
+    }
+    (void)poll(fds, nfds, (int)timeout);
+#endif
+}
+
 /**
  * @brief Get the Device object instance number
  * @return The Device object instance number
@@ -1137,6 +1117,9 @@ int main(int argc, char *argv[])
     time_t last_seconds = 0;
     time_t current_seconds = 0;
     uint32_t elapsed_seconds = 0;
+    struct mstimer maintenance_timer = { 0 };
+    bool received = false;
+    unsigned i = 0;
 
     printf("BACnet Simple IP to IPv6 Router Demo\n");
     printf("BACnet Stack Version %s\n", BACnet_Version);
@@ -1148,6 +1131,7 @@ int main(int argc, char *argv[])
     control_c_hooks();
     /* configure the timeout values */
     last_seconds = time(NULL);
+    mstimer_set(&maintenance_timer, 1000);
     /* broadcast an I-Am on startup */
     printf("BACnet/IP Network: %u\n", (unsigned)BIP_Net);
     send_i_am_router_to_network(BIP_Net, 0);
@@ -1155,25 +1139,42 @@ int main(int argc, char *argv[])
     send_i_am_router_to_network(BIP6_Net, 0);
     /* loop forever */
     for (;;) {
-        /* input */
-        current_seconds = time(NULL);
-        /* returns 0 bytes on timeout */
-        pdu_len =
-            bip_receive(&src, &BIP_Rx_Buffer[0], sizeof(BIP_Rx_Buffer), 5);
-        /* process */
-        if (pdu_len) {
-            debug_printf("BACnet/IP Received packet\n");
-            my_routing_npdu_handler(BIP_Net, &src, &BIP_Rx_Buffer[0], pdu_len);
+        /* wait for either network, or for the next maintenance second */
+        if (!mstimer_expired(&maintenance_timer)) {
+            router_wait(mstimer_remaining(&maintenance_timer));
         }
-        /* returns 0 bytes on timeout */
-        pdu_len =
-            bip6_receive(&src, &BIP6_Rx_Buffer[0], sizeof(BIP6_Rx_Buffer), 5);
-        /* process */
-        if (pdu_len) {
-            debug_printf("BACnet/IPv6 Received packet\n");
-            my_routing_npdu_handler(
-                BIP6_Net, &src, &BIP6_Rx_Buffer[0], pdu_len);
+        /* input: everything that was received, up to a limit */
+        for (i = 0; i < ROUTER_RECEIVE_MAX; i++) {
+            received = false;
+            /* returns 0 bytes on timeout */
+            pdu_len = bip_receive(&src, &BIP_Rx_Buffer[ROUTER_HEADROOM],
+                BIP_MPDU_MAX, ROUTER_RECEIVE_TIMEOUT);
+            /* process */
+            if (pdu_len) {
+                debug_printf("BACnet/IP Received packet\n");
+                my_routing_npdu_handler(
+                    BIP_Net, &src, &BIP_Rx_Buffer[ROUTER_HEADROOM], pdu_len);
+                received = true;
+            }
+            /* returns 0 bytes on timeout */
+            pdu_len = bip6_receive(&src, &BIP6_Rx_Buffer[ROUTER_HEADROOM],
+                BIP6_MPDU_MAX, ROUTER_RECEIVE_TIMEOUT);
+            /* process */
+            if (pdu_len) {
+                debug_printf("BACnet/IPv6 Received packet\n");
+                my_routing_npdu_handler(
+                    BIP6_Net, &src, &BIP6_Rx_Buffer[ROUTER_HEADROOM],
+                    pdu_len);
+                received = true;
+            }
+            if (!received) {
+                break;
+            }
         }
+        if (mstimer_expired(&maintenance_timer)) {
+            mstimer_restart(&maintenance_timer);
+        }
+        current_seconds = time(NULL);
         /* at least one second has passed */
         elapsed_seconds = (uint32_t)(current_seconds - last_seconds);
         if (elapsed_seconds) {
@@ -35,6 +35,7 @@
 #include "bacnet/datalink/bip.h"
 #include "bacnet/datalink/bvlc.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
+#include "proxy.h"
 
 /* current version of the BACnet stack */
 static const char *BACnet_Version = BACNET_VERSION_TEXT;
@@ -803,6 +804,32 @@ static void routed_src_address(
     }
 }
 
+/**
+ * Send a reply of the read-proxy to a client, with the device of the
+ * MS/TP network as the source of the message.
+ *
+ * @param client [in] The BACNET_ADDRESS of the client.
+ * @param mac [in] The MS/TP MAC address of the device.
+ * @param apdu [in] The APDU of the reply.
+ * @param apdu_len [in] The number of octets of the APDU.
+ */
+static void proxy_send_pdu(
+    BACNET_ADDRESS *client, uint8_t mac, uint8_t *apdu, uint16_t apdu_len)
+{
+    BACNET_ADDRESS device = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int npdu_len = 0;
+
+    device.net = MSTP_Net;
+    device.len = 1;
+    device.adr[0] = mac;
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(&Tx_Buffer[0], client, &device, &npdu_data);
+    memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
+    datalink_send_pdu(
+        BIP_Net, client, &npdu_data, &Tx_Buffer[0], npdu_len + apdu_len);
+}
+
 /**
  * If a BACnet NPDU is received with NPCI indicating that the message
  * should be relayed by virtue of the presence of a non-broadcast
@@ -868,9 +895,19 @@ static void routed_apdu_handler(uint16_t snet,
         }
         return;
     }
+    if ((snet == MSTP_Net) && (src->net == 0) && (src->mac_len == 1)) {
+        /* learn the values read by the clients */
+        proxy_reply(src->mac[0], apdu, apdu_len);
+    }
     remote_dest = *dest;
     port = dnet_find(dest->net, &remote_dest);
     if (port) {
+        if ((port->net == dest->net) && (port->net == MSTP_Net) &&
+            (snet != MSTP_Net) && (dest->len == 1) &&
+            proxy_request(dest->adr[0], src, apdu, apdu_len)) {
+            log_printf("Proxy for MS/TP MAC %u\n", (unsigned)dest->adr[0]);
+            return;
+        }
         if (port->net == dest->net) {
             log_printf("Routing to Port %u\n", (unsigned)dest->net);
             /*  Case 1: the router is directly
@@ -1067,6 +1104,9 @@ static void datalink_init(void)
         exit(1);
     }
     atexit(dlmstp_cleanup);
+    /* a request routed to the IP network is answered after the next
+       token, so a Reply Postponed is sent without waiting Treply_delay */
+    dlmstp_set_reply_postpone_routed(true);
     /* router network numbers */
     pEnv = getenv("BACNET_IP_NET");
     if (pEnv) {
@@ -1087,6 +1127,13 @@ static void datalink_init(void)
     /* configure the next entry in the table */
     dlmstp_get_my_address(&my_address);
     port_add(MSTP_Net, &my_address);
+    /* read-proxy for the MS/TP devices */
+    pEnv = getenv("BACNET_ROUTER_PROXY");
+    if (pEnv) {
+        proxy_init(strtoul(pEnv, NULL, 0),
+            getenv("BACNET_ROUTER_PROXY_PROPERTIES"), proxy_send_pdu);
+        log_printf("Proxy freshness=%lums\n", strtoul(pEnv, NULL, 0));
+    }
 }
 
 /**
@@ -0,0 +1,551 @@
+/**
+ * @file
+ * @brief Read-proxy of the simple router.  The values of the configured
+ *  properties are learned from the ReadProperty and ReadPropertyMultiple
+ *  acknowledgements that the MS/TP devices send to the clients on the
+ *  other networks.  While a value is fresh, requests for it are answered
+ *  by the router, and while a read of it is on its way to the device,
+ *  other clients reading it wait for that one reply, so the MS/TP traffic
+ *  is one read per property per freshness period however many clients
+ *  poll it.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/bacdef.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacenum.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "proxy.h"
+
+/* a client waiting for the read of a property sent to the device */
+struct proxy_waiter {
+    BACNET_ADDRESS client;
+    uint8_t invoke_id;
+    unsigned long since;
+    bool used;
+};
+
+/* a property of a device of the MS/TP network */
+struct proxy_point {
+    uint8_t mac;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    uint8_t value[PROXY_VALUE_MAX];
+    uint16_t value_len;
+    /* milliseconds when the value was learned */
+    unsigned long updated;
+    bool valid;
+    /* milliseconds when a read was sent on to the device */
+    unsigned long requested;
+    bool pending;
+    struct proxy_waiter waiter[PROXY_WAITERS_MAX];
+    bool used;
+};
+
+static struct proxy_point Proxy_Point[PROXY_POINTS_MAX];
+static BACNET_PROPERTY_ID Proxy_Property[PROXY_PROPERTIES_MAX];
+static unsigned Proxy_Properties;
+static unsigned long Proxy_Freshness;
+static proxy_send_function Proxy_Send;
+static unsigned long Proxy_Hits;
+static unsigned long Proxy_Misses;
+/* MS/TP MAC address of the device of the RPM-ACK being learned */
+static uint8_t Proxy_Reply_MAC;
+/* the acknowledgement sent by the router */
+static uint8_t Proxy_Buffer[MAX_APDU];
+static BACNET_WRITE_PROPERTY_DATA Proxy_Write_Data;
+
+/**
+ * @brief Determine if a property is one of the properties that are cached
+ * @param object_property - the property identifier
+ * @return true if the property is cached
+ */
+static bool proxy_property_configured(BACNET_PROPERTY_ID object_property)
+{
+    unsigned i;
+
+    for (i = 0; i < Proxy_Properties; i++) {
+        if (Proxy_Property[i] == object_property) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Find the cached property of a device
+ * @return the point, or NULL if the property is not cached
+ */
+static struct proxy_point *proxy_point_find(
+    uint8_t mac,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    struct proxy_point *point;
+    unsigned i;
+
+    for (i = 0; i < PROXY_POINTS_MAX; i++) {
+        point = &Proxy_Point[i];
+        if (point->used && (point->mac == mac) &&
+            (point->object_type == object_type) &&
+            (point->object_instance == object_instance) &&
+            (point->object_property == object_property) &&
+            (point->array_index == array_index)) {
+            return point;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the cached property of a device, or add it by replacing
+ *  an unused point or the point learned longest ago with nobody waiting
+ * @return the point, or NULL if every point has clients waiting
+ */
+static struct proxy_point *proxy_point_add(
+    uint8_t mac,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    struct proxy_point *point, *oldest = NULL;
+    unsigned long now = mstimer_now();
+    unsigned i;
+
+    point = proxy_point_find(
+        mac, object_type, object_instance, object_property, array_index);
+    if (point) {
+        return point;
+    }
+    for (i = 0; i < PROXY_POINTS_MAX; i++) {
+        point = &Proxy_Point[i];
+        if (!point->used) {
+            oldest = point;
+            break;
+        }
+        if (point->pending && ((now - point->requested) < PROXY_PENDING_MS)) {
+            continue;
+        }
+        if (!oldest || ((now - point->updated) > (now - oldest->updated))) {
+            oldest = point;
+        }
+    }
+    if (oldest) {
+        memset(oldest, 0, sizeof(*oldest));
+        oldest->used = true;
+        oldest->mac = mac;
+        oldest->object_type = object_type;
+        oldest->object_instance = object_instance;
+        oldest->object_property = object_property;
+        oldest->array_index = array_index;
+    }
+
+    return oldest;
+}
+
+/**
+ * @brief Determine if the cached value of a point is within the
+ *  freshness bound
+ * @param point - the point
+ * @return true if the value can be sent to a client
+ */
+static bool proxy_point_fresh(const struct proxy_point *point)
+{
+    return point && point->valid &&
+        ((mstimer_now() - point->updated) < Proxy_Freshness);
+}
+
+/**
+ * @brief Keep a value read from a device, and answer the clients that
+ *  were waiting for it
+ * @param mac - MS/TP MAC address of the device
+ * @param rp_data - the value
+ */
+static void proxy_learn(uint8_t mac, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    struct proxy_point *point;
+    struct proxy_waiter *waiter;
+    BACNET_READ_PROPERTY_DATA reply_data;
+    unsigned long now = mstimer_now();
+    unsigned i;
+    int apdu_len;
+
+    if (!proxy_property_configured(rp_data->object_property) ||
+        (rp_data->application_data_len <= 0) ||
+        (rp_data->application_data_len > PROXY_VALUE_MAX)) {
+        return;
+    }
+    point = proxy_point_add(
+        mac, rp_data->object_type, rp_data->object_instance,
+        rp_data->object_property, rp_data->array_index);
+    if (!point) {
+        return;
+    }
+    memcpy(
+        point->value, rp_data->application_data,
+        rp_data->application_data_len);
+    point->value_len = (uint16_t)rp_data->application_data_len;
+    point->updated = now;
+    point->valid = true;
+    point->pending = false;
+    reply_data = *rp_data;
+    reply_data.application_data = point->value;
+    for (i = 0; i < PROXY_WAITERS_MAX; i++) {
+        waiter = &point->waiter[i];
+        if (waiter->used && ((now - waiter->since) < PROXY_PENDING_MS)) {
+            apdu_len = rp_ack_encode_apdu(
+                &Proxy_Buffer[0], waiter->invoke_id, &reply_data);
+            if (Proxy_Send) {
+                Proxy_Send(
+                    &waiter->client, mac, &Proxy_Buffer[0],
+                    (uint16_t)apdu_len);
+            }
+        }
+        waiter->used = false;
+    }
+}
+
+/**
+ * @brief Learn a value of an RPM-ACK
+ * @param device_id - not used
+ * @param rp_data - the value
+ */
+static void proxy_rpm_ack_value(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    (void)device_id;
+    if (rp_data->error_code == ERROR_CODE_SUCCESS) {
+        proxy_learn(Proxy_Reply_MAC, rp_data);
+    }
+}
+
+/**
+ * @brief Answer a ReadProperty request from the cache, or hold it until
+ *  the reply to the read already sent to the device
+ * @return true if the request is not to be sent on to the device
+ */
+static bool proxy_read_property(
+    uint8_t mac,
+    BACNET_ADDRESS *client,
+    uint8_t invoke_id,
+    int max_apdu,
+    uint8_t *service_request,
+    unsigned service_len)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    struct proxy_point *point;
+    struct proxy_waiter *waiter, *free_waiter = NULL;
+    unsigned long now = mstimer_now();
+    unsigned i;
+    int apdu_len;
+
+    if (rp_decode_service_request(service_request, service_len, &rp_data) <=
+        0) {
+        return false;
+    }
+    if (!proxy_property_configured(rp_data.object_property)) {
+        return false;
+    }
+    point = proxy_point_find(
+        mac, rp_data.object_type, rp_data.object_instance,
+        rp_data.object_property, rp_data.array_index);
+    if (proxy_point_fresh(point)) {
+        rp_data.application_data = point->value;
+        rp_data.application_data_len = point->value_len;
+        apdu_len = rp_ack_encode_apdu(NULL, invoke_id, &rp_data);
+        if ((apdu_len <= max_apdu) &&
+            (apdu_len <= (int)sizeof(Proxy_Buffer))) {
+            apdu_len =
+                rp_ack_encode_apdu(&Proxy_Buffer[0], invoke_id, &rp_data);
+            if (Proxy_Send) {
+                Proxy_Send(client, mac, &Proxy_Buffer[0], (uint16_t)apdu_len);
+            }
+            Proxy_Hits++;
+            return true;
+        }
+    }
+    Proxy_Misses++;
+    if (point && point->pending &&
+        ((now - point->requested) < PROXY_PENDING_MS)) {
+        /* coalesce with the read already on its way to the device */
+        for (i = 0; i < PROXY_WAITERS_MAX; i++) {
+            waiter = &point->waiter[i];
+            if (waiter->used && ((now - waiter->since) >= PROXY_PENDING_MS)) {
+                waiter->used = false;
+            }
+            if (!waiter->used && !free_waiter) {
+                free_waiter = waiter;
+            }
+        }
+        if (free_waiter) {
+            free_waiter->client = *client;
+            free_waiter->invoke_id = invoke_id;
+            free_waiter->since = now;
+            free_waiter->used = true;
+            return true;
+        }
+        return false;
+    }
+    point = proxy_point_add(
+        mac, rp_data.object_type, rp_data.object_instance,
+        rp_data.object_property, rp_data.array_index);
+    if (point) {
+        point->pending = true;
+        point->requested = now;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Answer a ReadPropertyMultiple request from the cache when every
+ *  property that it reads is fresh
+ * @return true if the request was answered
+ */
+static bool proxy_read_property_multiple(
+    uint8_t mac,
+    BACNET_ADDRESS *client,
+    uint8_t invoke_id,
+    int max_apdu,
+    uint8_t *service_request,
+    unsigned service_len)
+{
+    BACNET_RPM_DATA rpm_data = { 0 };
+    struct proxy_point *point;
+    unsigned decode_len = 0;
+    int apdu_len, len;
+
+    apdu_len = rpm_ack_encode_apdu_init(&Proxy_Buffer[0], invoke_id);
+    while (decode_len < service_len) {
+        len = rpm_decode_object_id(
+            &service_request[decode_len], service_len - decode_len, &rpm_data);
+        if (len <= 0) {
+            return false;
+        }
+        decode_len += len;
+        apdu_len += rpm_ack_encode_apdu_object_begin(
+            &Proxy_Buffer[apdu_len], &rpm_data);
+        for (;;) {
+            len = rpm_decode_object_end(
+                &service_request[decode_len], service_len - decode_len);
+            if (len > 0) {
+                decode_len += len;
+                apdu_len +=
+                    rpm_ack_encode_apdu_object_end(&Proxy_Buffer[apdu_len]);
+                break;
+            }
+            len = rpm_decode_object_property(
+                &service_request[decode_len], service_len - decode_len,
+                &rpm_data);
+            if (len <= 0) {
+                return false;
+            }
+            decode_len += len;
+            if (!proxy_property_configured(rpm_data.object_property)) {
+                return false;
+            }
+            point = proxy_point_find(
+                mac, rpm_data.object_type, rpm_data.object_instance,
+                rpm_data.object_property, rpm_data.array_index);
+            if (!proxy_point_fresh(point)) {
+                Proxy_Misses++;
+                return false;
+            }
+            /* room for the property reference, the value, and the ends */
+            if ((apdu_len + 24 + point->value_len) >
+                (int)sizeof(Proxy_Buffer)) {
+                return false;
+            }
+            apdu_len += rpm_ack_encode_apdu_object_property(
+                &Proxy_Buffer[apdu_len], rpm_data.object_property,
+                rpm_data.array_index);
+            apdu_len += rpm_ack_encode_apdu_object_property_value(
+                &Proxy_Buffer[apdu_len], point->value, point->value_len);
+        }
+    }
+    if (apdu_len > max_apdu) {
+        return false;
+    }
+    if (Proxy_Send) {
+        Proxy_Send(client, mac, &Proxy_Buffer[0], (uint16_t)apdu_len);
+    }
+    Proxy_Hits++;
+
+    return true;
+}
+
+/**
+ * @brief Forget the cached values of a property written by a client
+ */
+static void proxy_write_property(
+    uint8_t mac, uint8_t *service_request, unsigned service_len)
+{
+    struct proxy_point *point;
+    unsigned i;
+
+    if (wp_decode_service_request(
+            service_request, service_len, &Proxy_Write_Data) <= 0) {
+        return;
+    }
+    for (i = 0; i < PROXY_POINTS_MAX; i++) {
+        point = &Proxy_Point[i];
+        if (point->used && (point->mac == mac) &&
+            (point->object_type == Proxy_Write_Data.object_type) &&
+            (point->object_instance == Proxy_Write_Data.object_instance) &&
+            (point->object_property == Proxy_Write_Data.object_property)) {
+            point->valid = false;
+        }
+    }
+}
+
+/**
+ * @brief Handle a confirmed request from a client to a device of the
+ *  MS/TP network
+ * @param mac - MS/TP MAC address of the device
+ * @param client - address of the client
+ * @param apdu - the APDU of the request
+ * @param apdu_len - number of octets of the APDU
+ * @return true if the request was answered, or is waiting for the reply
+ *  to the same read, and is not to be sent on to the device
+ */
+bool proxy_request(
+    uint8_t mac, BACNET_ADDRESS *client, uint8_t *apdu, uint16_t apdu_len)
+{
+    uint8_t invoke_id;
+    int max_apdu;
+
+    if (!Proxy_Freshness || !client || !apdu || (apdu_len < 4)) {
+        return false;
+    }
+    /* confirmed request that is not segmented */
+    if ((apdu[0] & 0xF8) != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
+        return false;
+    }
+    max_apdu = decode_max_apdu(apdu[1]);
+    invoke_id = apdu[2];
+    switch (apdu[3]) {
+        case SERVICE_CONFIRMED_READ_PROPERTY:
+            return proxy_read_property(
+                mac, client, invoke_id, max_apdu, &apdu[4], apdu_len - 4);
+        case SERVICE_CONFIRMED_READ_PROP_MULTIPLE:
+            return proxy_read_property_multiple(
+                mac, client, invoke_id, max_apdu, &apdu[4], apdu_len - 4);
+        case SERVICE_CONFIRMED_WRITE_PROPERTY:
+            proxy_write_property(mac, &apdu[4], apdu_len - 4);
+            break;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Learn the values of a reply from a device of the MS/TP network
+ * @param mac - MS/TP MAC address of the device
+ * @param apdu - the APDU of the reply
+ * @param apdu_len - number of octets of the APDU
+ */
+void proxy_reply(uint8_t mac, uint8_t *apdu, uint16_t apdu_len)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    if (!Proxy_Freshness || !apdu || (apdu_len < 3)) {
+        return;
+    }
+    /* complex acknowledgement that is not segmented */
+    if ((apdu[0] & 0xF8) != PDU_TYPE_COMPLEX_ACK) {
+        return;
+    }
+    if (apdu[2] == SERVICE_CONFIRMED_READ_PROPERTY) {
+        if (rp_ack_decode_service_request(&apdu[3], apdu_len - 3, &rp_data) >
+            0) {
+            proxy_learn(mac, &rp_data);
+        }
+    } else if (apdu[2] == SERVICE_CONFIRMED_READ_PROP_MULTIPLE) {
+        Proxy_Reply_MAC = mac;
+        rpm_ack_object_property_process(
+            &apdu[3], apdu_len - 3, 0, &rp_data, proxy_rpm_ack_value);
+    }
+}
+
+/**
+ * @brief Get the number of requests answered from the cache
+ * @return number of requests
+ */
+unsigned long proxy_hits(void)
+{
+    return Proxy_Hits;
+}
+
+/**
+ * @brief Get the number of reads of cached properties that were not fresh
+ * @return number of reads
+ */
+unsigned long proxy_misses(void)
+{
+    return Proxy_Misses;
+}
+
+/**
+ * @brief Determine if the proxy is enabled
+ * @return true if requests are answered from the cache
+ */
+bool proxy_enabled(void)
+{
+    return Proxy_Freshness != 0;
+}
+
+/**
+ * @brief Initialize the proxy
+ * @param freshness_ms - milliseconds that a value is sent to clients
+ *  after it was read from the device, or 0 to disable the proxy
+ * @param properties - comma separated property identifiers that are
+ *  cached, or NULL for Present_Value and Status_Flags
+ * @param send - function to send the replies of the router to clients
+ */
+void proxy_init(
+    unsigned long freshness_ms,
+    const char *properties,
+    proxy_send_function send)
+{
+    char *end = NULL;
+    unsigned long value;
+
+    memset(Proxy_Point, 0, sizeof(Proxy_Point));
+    Proxy_Freshness = freshness_ms;
+    Proxy_Send = send;
+    Proxy_Hits = 0;
+    Proxy_Misses = 0;
+    Proxy_Properties = 0;
+    if (!properties || !properties[0]) {
+        Proxy_Property[Proxy_Properties++] = PROP_PRESENT_VALUE;
+        Proxy_Property[Proxy_Properties++] = PROP_STATUS_FLAGS;
+        return;
+    }
+    while (*properties && (Proxy_Properties < PROXY_PROPERTIES_MAX)) {
+        value = strtoul(properties, &end, 0);
+        if (end == properties) {
+            break;
+        }
+        Proxy_Property[Proxy_Properties++] = (BACNET_PROPERTY_ID)value;
+        properties = end;
+        if (*properties == ',') {
+            properties++;
+        }
+    }
+}
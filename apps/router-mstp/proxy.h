@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @brief API of the read-proxy of the simple router, which answers
+ *  ReadProperty and ReadPropertyMultiple requests for the MS/TP devices
+ *  from a cache of the values of configured properties
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef ROUTER_MSTP_PROXY_H
+#define ROUTER_MSTP_PROXY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/bacdef.h"
+
+/* number of properties read from the devices that are cached */
+#ifndef PROXY_POINTS_MAX
+#define PROXY_POINTS_MAX 256
+#endif
+/* largest encoded value that is cached */
+#ifndef PROXY_VALUE_MAX
+#define PROXY_VALUE_MAX 64
+#endif
+/* number of configured property identifiers */
+#ifndef PROXY_PROPERTIES_MAX
+#define PROXY_PROPERTIES_MAX 8
+#endif
+/* number of clients waiting for the one read of a property */
+#ifndef PROXY_WAITERS_MAX
+#define PROXY_WAITERS_MAX 4
+#endif
+/* milliseconds that clients wait for a read sent to a device */
+#ifndef PROXY_PENDING_MS
+#define PROXY_PENDING_MS 3000UL
+#endif
+
+/**
+ * @brief Send an APDU from a device of the MS/TP network to a client
+ * @param client - address of the client
+ * @param mac - MS/TP MAC address of the device
+ * @param apdu - the APDU
+ * @param apdu_len - number of octets of the APDU
+ */
+typedef void (*proxy_send_function)(
+    BACNET_ADDRESS *client, uint8_t mac, uint8_t *apdu, uint16_t apdu_len);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+void proxy_init(
+    unsigned long freshness_ms,
+    const char *properties,
+    proxy_send_function send);
+bool proxy_enabled(void);
+bool proxy_request(
+    uint8_t mac, BACNET_ADDRESS *client, uint8_t *apdu, uint16_t apdu_len);
+void proxy_reply(uint8_t mac, uint8_t *apdu, uint16_t apdu_len);
+unsigned long proxy_hits(void);
+unsigned long proxy_misses(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -328,15 +328,26 @@ int dl_ip_recv(
                 (void)decode_unsigned16(&data->buff[2], &buff_len);
                 /* subtract off the BVLC header */
                 buff_len -= 4;
-                if (buff_len < data->max_buff) {
-                    /* allocate data message stucture */
-                    (*msg_data) = (MSG_DATA *)malloc(sizeof(MSG_DATA));
-                    (*msg_data)->pdu_len = buff_len;
-                    (*msg_data)->pdu = (uint8_t *)malloc((*msg_data)->pdu_len);
-                    /* fill up data message structure */
-                    memmove(&(*msg_data)->pdu[0], &data->buff[4],
-                        (*msg_data)->pdu_len);
-                    memmove(&(*msg_data)->src, src, sizeof(BACNET_ADDRESS));
+                if ((buff_len < data->max_buff) &&
+                    (buff_len <= MSG_DATA_PDU_MAX)) {
+                    /* allocate data message stucture from the pool */
+                    (*msg_data) = alloc_data();
+                    if (*msg_data) {
+                        (*msg_data)->pdu = alloc_pdu();
+                    }
+                    if ((*msg_data) && (*msg_data)->pdu) {
+                        /* fill up data message structure */
+                        (*msg_data)->pdu_len = buff_len;
+                        memmove(&(*msg_data)->pdu[0], &data->buff[4],
+                            (*msg_data)->pdu_len);
+                        memmove(
+                            &(*msg_data)->src, src, sizeof(BACNET_ADDRESS));
+                    } else {
+                        free_data(*msg_data);
+                        buff_len = 0;
+
+                        PRINT(ERROR, "BIP: No message buffer. Discarded!\n");
+                    }
                 }
                 /* ignore packets that are too large */
                 else {
@@ -361,15 +372,26 @@ int dl_ip_recv(
                 (void)decode_unsigned16(&data->buff[2], &buff_len);
                 /* subtract off the BVLC header */
                 buff_len -= 10;
-                if (buff_len < data->max_buff) {
-                    /* allocate data message stucture */
-                    (*msg_data) = (MSG_DATA *)malloc(sizeof(MSG_DATA));
-                    (*msg_data)->pdu_len = buff_len;
-                    (*msg_data)->pdu = (uint8_t *)malloc((*msg_data)->pdu_len);
-                    /* fill up data message structure */
-                    memmove(&(*msg_data)->pdu[0], &data->buff[4 + 6],
-                        (*msg_data)->pdu_len);
-                    memmove(&(*msg_data)->src, src, sizeof(BACNET_ADDRESS));
+                if ((buff_len < data->max_buff) &&
+                    (buff_len <= MSG_DATA_PDU_MAX)) {
+                    /* allocate data message stucture from the pool */
+                    (*msg_data) = alloc_data();
+                    if (*msg_data) {
+                        (*msg_data)->pdu = alloc_pdu();
+                    }
+                    if ((*msg_data) && (*msg_data)->pdu) {
+                        /* fill up data message structure */
+                        (*msg_data)->pdu_len = buff_len;
+                        memmove(&(*msg_data)->pdu[0], &data->buff[4 + 6],
+                            (*msg_data)->pdu_len);
+                        memmove(
+                            &(*msg_data)->src, src, sizeof(BACNET_ADDRESS));
+                    } else {
+                        free_data(*msg_data);
+                        buff_len = 0;
+
+                        PRINT(ERROR, "BIP: No message buffer. Discarded!\n");
+                    }
                 } else {
                     /* ignore packets that are too large */
                     buff_len = 0;
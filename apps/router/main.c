@@ -52,6 +52,7 @@
 #include "network_layer.h"
 #include "ipmodule.h"
 #include "mstpmodule.h"
+#include "routecache.h"
 
 #define KEY_ESC 27
 
@@ -81,6 +82,10 @@ int kbhit();
 
 inline bool is_network_msg(BACMSG *msg);
 
+bool send_to_port(ROUTER_PORT *port, BACMSG *msg);
+
+void check_ports_available(void);
+
 int main(int argc, char *argv[])
 {
     ROUTER_PORT *port;
@@ -119,26 +124,34 @@ int main(int argc, char *argv[])
             switch (bacmsg->type) {
                 case DATA: {
                     MSGBOX_ID msg_src = bacmsg->origin;
+                    MSG_DATA *recv_data = (MSG_DATA *)bacmsg->data;
+                    bool network_msg = is_network_msg(bacmsg);
 
-                    /* allocate message structure */
-                    msg_data = malloc(sizeof(MSG_DATA));
+                    /* allocate message structure from the pool */
+                    msg_data = alloc_data();
                     if (!msg_data) {
                         PRINT(ERROR, "Error: Could not allocate memory\n");
+                        free_data(recv_data);
                         break;
                     }
 
                     /* print_msg(bacmsg); */
 
-                    if (is_network_msg(bacmsg)) {
+                    if (network_msg) {
                         buff_len =
                             process_network_message(bacmsg, msg_data, &buff);
-                        if (buff_len == 0) {
-                            free_data(bacmsg->data);
-                            break;
-                        }
                     } else {
                         buff_len = process_msg(bacmsg, msg_data, &buff);
                     }
+                    /* the received PDU is no longer needed */
+                    msg_data->pdu = NULL;
+                    if ((buff_len == -1) && !network_msg &&
+                        route_cache_hold(bacmsg, msg_data->dest.net)) {
+                        /* held until the network is found */
+                        free_data(msg_data);
+                        break;
+                    }
+                    free_data(recv_data);
 
                     /* if buff_len */
                     /* >0 - form new message and send */
@@ -155,34 +168,49 @@ int main(int argc, char *argv[])
 
                         /* print_msg(bacmsg); */
 
-                        if (is_network_msg(bacmsg)) {
+                        if (network_msg) {
                             msg_data->ref_count = 1;
-                            send_to_msgbox(msg_src, &msg_storage);
+                            if (!send_to_msgbox(msg_src, &msg_storage)) {
+                                check_data(msg_data);
+                            }
                         } else if (msg_data->dest.net !=
                             BACNET_BROADCAST_NETWORK) {
                             msg_data->ref_count = 1;
                             port =
                                 find_dnet(msg_data->dest.net, &msg_data->dest);
-                            send_to_msgbox(port->port_id, &msg_storage);
+                            if (dnet_route_aged(msg_data->dest.net)) {
+                                route_cache_refresh(msg_data->dest.net);
+                            }
+                            if (!dnet_rate_allow(msg_data->dest.net)) {
+                                port->dropped++;
+                                check_data(msg_data);
+                            } else if (!send_to_port(port, &msg_storage)) {
+                                check_data(msg_data);
+                            }
                         } else {
                             port = head;
                             msg_data->ref_count = port_count - 1;
                             while (port != NULL) {
-                                if (port->port_id == msg_src ||
-                                    port->state == FINISHED) {
+                                if (port->port_id == msg_src) {
                                     port = port->next;
                                     continue;
                                 }
-                                send_to_msgbox(port->port_id, &msg_storage);
+                                if ((port->state == FINISHED) ||
+                                    !send_to_port(port, &msg_storage)) {
+                                    /* release the reference of the port */
+                                    check_data(msg_data);
+                                }
                                 port = port->next;
                             }
                         }
                     } else if (buff_len == -1) {
-                        uint16_t net = msg_data->dest.net; /* NET to find */
-                        PRINT(INFO, "Searching NET...\n");
-                        send_network_message(
-                            NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK, msg_data,
-                            &buff, &net);
+                        /* search once for the NET, unless it is already
+                           searched or known to be unreachable */
+                        if (!route_cache_search(msg_data->dest.net)) {
+                            PRINT(INFO, "NET %u searched. Message discarded\n",
+                                (unsigned)msg_data->dest.net);
+                        }
+                        free_data(msg_data);
                     } else {
                         /* if invalid message send Reject-Message-To-Network */
                         PRINT(ERROR, "Error: Invalid message\n");
@@ -193,12 +221,52 @@ int main(int argc, char *argv[])
                 default:
                     break;
             }
+            check_ports_available();
+            route_cache_maintenance();
         }
     }
 
     return 0;
 }
 
+/* queue a routed message to a port, unless the port is congested */
+bool send_to_port(ROUTER_PORT *port, BACMSG *msg)
+{
+    if (msgbox_depth(port->port_id) >= ROUTER_PORT_BUSY_DEPTH) {
+        if (!port->busy) {
+            PRINT(INFO, "%s busy. Sending Router-Busy-To-Network\n",
+                port->iface);
+            port->busy = true;
+            send_router_busy_message(port, true);
+        }
+        port->dropped++;
+        return false;
+    }
+    if (!send_to_msgbox(port->port_id, msg)) {
+        port->dropped++;
+        return false;
+    }
+
+    return true;
+}
+
+/* announce the ports which have drained their queue */
+void check_ports_available(void)
+{
+    ROUTER_PORT *port = head;
+
+    while (port != NULL) {
+        if (port->busy &&
+            (msgbox_depth(port->port_id) <= ROUTER_PORT_AVAILABLE_DEPTH)) {
+            PRINT(INFO, "%s available. Sending Router-Available-To-Network\n",
+                port->iface);
+            port->busy = false;
+            send_router_busy_message(port, false);
+        }
+        port = port->next;
+    }
+}
+
 void print_help()
 {
     printf(
@@ -681,6 +749,7 @@ bool init_router()
     /* add main message box id to all ports */
     while (port != NULL) {
         port->main_id = msgboxid;
+        add_port_route(port);
         port = port->next;
     }
 
@@ -729,6 +798,16 @@ void cleanup()
         port = port->next;
     }
 
+    port = head;
+    while (port != NULL) {
+        if (port->dropped) {
+            PRINT(INFO, "%s: %lu messages dropped\n", port->iface,
+                port->dropped);
+        }
+        port = port->next;
+    }
+    route_cache_cleanup();
+
     port = head;
     while (port != NULL) {
         if (port->state == FINISHED) {
@@ -739,8 +818,6 @@ void cleanup()
             head = port;
         }
     }
-
-    pthread_mutex_destroy(&msg_lock);
 }
 
 void print_msg(BACMSG *msg)
@@ -781,6 +858,13 @@ uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
     destport = find_dnet(data->dest.net, NULL);
     assert(srcport);
 
+    if (destport && (data->dest.net != BACNET_BROADCAST_NETWORK) &&
+        (get_dnet_flags(data->dest.net) & ROUTE_BUSY)) {
+        /* a router to the network is busy, so drop the traffic */
+        PRINT(INFO, "NET %u busy. Message discarded\n",
+            (unsigned)data->dest.net);
+        return 0;
+    }
     if (srcport && destport) {
         data->src.net = srcport->route_info.net;
 
@@ -803,7 +887,13 @@ uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
 
         buff_len = npdu_len + data->pdu_len - apdu_offset;
 
-        *buff = (uint8_t *)malloc(buff_len);
+        if (buff_len > MSG_DATA_PDU_MAX) {
+            return 0;
+        }
+        *buff = alloc_pdu();
+        if (*buff == NULL) {
+            return 0;
+        }
         memmove(*buff, npdu, npdu_len); /* copy newly formed NPDU */
         memmove(*buff + npdu_len, &data->pdu[apdu_offset],
             apdu_len); /* copy APDU */
@@ -813,9 +903,6 @@ uint16_t process_msg(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
         return -1;
     }
 
-    /* delete received message */
-    free_data((MSG_DATA *)msg->data);
-
     return buff_len;
 }
 
@@ -30,73 +30,331 @@
 #include <errno.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <pthread.h>
+#include <semaphore.h>
 #include "msgqueue.h"
 
-pthread_mutex_t msg_lock = PTHREAD_MUTEX_INITIALIZER;
+/* The message boxes and the message data pools are bounded lock-free
+   ring queues. Each cell has a sequence number which tells the producers
+   and the consumers whether the cell is free or holds an element, so
+   that the head and tail are claimed without a lock. */
+struct msg_ring {
+    size_t head;
+    size_t tail;
+    size_t mask;
+    size_t elem_size;
+    size_t *seq;
+    uint8_t *cells;
+};
+
+/* Each message box has one ring for each network priority of the NPDU,
+   and the receive takes from the highest priority ring first, so that
+   life safety and alarm messages are not queued behind bulk transfers. */
+#define MSGBOX_PRIORITIES 4
+
+struct msgbox {
+    struct msg_ring ring[MSGBOX_PRIORITIES];
+    /* number of messages in the ring, for the blocking receive */
+    sem_t count;
+    bool valid;
+};
+
+#if (MSGBOX_SIZE & (MSGBOX_SIZE - 1))
+#error "MSGBOX_SIZE must be a power of two"
+#endif
+#if (MSG_DATA_POOL_SIZE & (MSG_DATA_POOL_SIZE - 1))
+#error "MSG_DATA_POOL_SIZE must be a power of two"
+#endif
+
+static struct msgbox Msgbox[MSGBOX_MAX];
+static BACMSG Msgbox_Cells[MSGBOX_MAX][MSGBOX_PRIORITIES][MSGBOX_SIZE];
+static size_t Msgbox_Seq[MSGBOX_MAX][MSGBOX_PRIORITIES][MSGBOX_SIZE];
+static int Msgbox_Count;
+
+static MSG_DATA Msg_Data_Pool[MSG_DATA_POOL_SIZE];
+static uint8_t Msg_Pdu_Pool[MSG_DATA_POOL_SIZE][MSG_DATA_PDU_MAX];
+static struct msg_ring Msg_Data_Free;
+static MSG_DATA *Msg_Data_Free_Cells[MSG_DATA_POOL_SIZE];
+static size_t Msg_Data_Free_Seq[MSG_DATA_POOL_SIZE];
+static struct msg_ring Msg_Pdu_Free;
+static uint8_t *Msg_Pdu_Free_Cells[MSG_DATA_POOL_SIZE];
+static size_t Msg_Pdu_Free_Seq[MSG_DATA_POOL_SIZE];
+static pthread_once_t Msg_Pool_Once = PTHREAD_ONCE_INIT;
+
+static void ring_init(struct msg_ring *ring,
+    void *cells,
+    size_t *seq,
+    size_t size,
+    size_t elem_size)
+{
+    size_t i;
+
+    ring->head = 0;
+    ring->tail = 0;
+    ring->mask = size - 1;
+    ring->elem_size = elem_size;
+    ring->seq = seq;
+    ring->cells = cells;
+    for (i = 0; i < size; i++) {
+        __atomic_store_n(&ring->seq[i], i, __ATOMIC_RELAXED);
+    }
+}
+
+/* returns false if the ring is full */
+static bool ring_push(struct msg_ring *ring, const void *elem)
+{
+    size_t pos, seq, cell;
+    intptr_t diff;
+
+    pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = pos & ring->mask;
+        seq = __atomic_load_n(&ring->seq[cell], __ATOMIC_ACQUIRE);
+        diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+    memcpy(&ring->cells[cell * ring->elem_size], elem, ring->elem_size);
+    __atomic_store_n(&ring->seq[cell], pos + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/* returns false if the ring is empty */
+static bool ring_pop(struct msg_ring *ring, void *elem)
+{
+    size_t pos, seq, cell;
+    intptr_t diff;
+
+    pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    for (;;) {
+        cell = pos & ring->mask;
+        seq = __atomic_load_n(&ring->seq[cell], __ATOMIC_ACQUIRE);
+        diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, true,
+                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+    memcpy(elem, &ring->cells[cell * ring->elem_size], ring->elem_size);
+    __atomic_store_n(&ring->seq[cell], pos + ring->mask + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static void msg_pool_init(void)
+{
+    MSG_DATA *data;
+    uint8_t *pdu;
+    unsigned i;
+
+    ring_init(&Msg_Data_Free, Msg_Data_Free_Cells, Msg_Data_Free_Seq,
+        MSG_DATA_POOL_SIZE, sizeof(MSG_DATA *));
+    ring_init(&Msg_Pdu_Free, Msg_Pdu_Free_Cells, Msg_Pdu_Free_Seq,
+        MSG_DATA_POOL_SIZE, sizeof(uint8_t *));
+    for (i = 0; i < MSG_DATA_POOL_SIZE; i++) {
+        data = &Msg_Data_Pool[i];
+        pdu = &Msg_Pdu_Pool[i][0];
+        ring_push(&Msg_Data_Free, &data);
+        ring_push(&Msg_Pdu_Free, &pdu);
+    }
+}
+
+static struct msgbox *msgbox_get(MSGBOX_ID id)
+{
+    if ((id < 0) || (id >= MSGBOX_MAX)) {
+        return NULL;
+    }
+    if (!__atomic_load_n(&Msgbox[id].valid, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+
+    return &Msgbox[id];
+}
+
+/* the network priority of a message, from the control octet of its NPDU,
+   and service messages, such as a shutdown, come before the data */
+static unsigned msgbox_priority(const BACMSG *msg)
+{
+    const MSG_DATA *data;
+
+    if (msg->type != DATA) {
+        return MESSAGE_PRIORITY_LIFE_SAFETY;
+    }
+    data = msg->data;
+    if (!data || !data->pdu || (data->pdu_len < 2)) {
+        return MESSAGE_PRIORITY_NORMAL;
+    }
+
+    return data->pdu[1] & 0x03;
+}
 
 MSGBOX_ID create_msgbox()
 {
     MSGBOX_ID msgboxid;
+    struct msgbox *box;
+    unsigned i;
 
-    msgboxid = msgget(IPC_PRIVATE, 0666 | IPC_CREAT);
-    if (msgboxid == INVALID_MSGBOX_ID) {
+    pthread_once(&Msg_Pool_Once, msg_pool_init);
+    msgboxid = __atomic_fetch_add(&Msgbox_Count, 1, __ATOMIC_RELAXED);
+    if (msgboxid >= MSGBOX_MAX) {
+        return INVALID_MSGBOX_ID;
+    }
+    box = &Msgbox[msgboxid];
+    for (i = 0; i < MSGBOX_PRIORITIES; i++) {
+        ring_init(&box->ring[i], &Msgbox_Cells[msgboxid][i][0],
+            &Msgbox_Seq[msgboxid][i][0], MSGBOX_SIZE, sizeof(BACMSG));
+    }
+    if (sem_init(&box->count, 0, 0) != 0) {
         return INVALID_MSGBOX_ID;
     }
+    __atomic_store_n(&box->valid, true, __ATOMIC_RELEASE);
 
     return msgboxid;
 }
 
 bool send_to_msgbox(MSGBOX_ID dest, BACMSG *msg)
 {
-    int err;
+    struct msgbox *box;
 
-    err = msgsnd(dest, msg, sizeof(BACMSG) - sizeof(MSGTYPE), 0);
-    if (err) {
+    box = msgbox_get(dest);
+    if (!box) {
+        return false;
+    }
+    if (!ring_push(&box->ring[msgbox_priority(msg)], msg)) {
         return false;
     }
+    sem_post(&box->count);
+
     return true;
 }
 
 BACMSG *recv_from_msgbox(MSGBOX_ID src, BACMSG *msg, int flags)
 {
-    int recv_bytes;
+    struct msgbox *box;
+    unsigned i;
+    int err;
 
-    recv_bytes = msgrcv(src, msg, sizeof(BACMSG) - sizeof(MSGTYPE), 0, flags);
-    if (recv_bytes > 0) {
-        return msg;
+    box = msgbox_get(src);
+    if (!box) {
+        return NULL;
+    }
+    if (flags & IPC_NOWAIT) {
+        err = sem_trywait(&box->count);
     } else {
+        do {
+            err = sem_wait(&box->count);
+        } while ((err != 0) && (errno == EINTR));
+    }
+    if (err != 0) {
         return NULL;
     }
+    /* each count is posted after its message is in a ring */
+    for (;;) {
+        for (i = MSGBOX_PRIORITIES; i > 0; i--) {
+            if (ring_pop(&box->ring[i - 1], msg)) {
+                return msg;
+            }
+        }
+    }
+
+    return msg;
 }
 
 void del_msgbox(MSGBOX_ID msgboxid)
 {
-    if (msgboxid == INVALID_MSGBOX_ID) {
-        return;
+    struct msgbox *box;
+
+    box = msgbox_get(msgboxid);
+    if (box) {
+        /* pending messages are discarded, as with the removal
+           of a System V message queue */
+        __atomic_store_n(&box->valid, false, __ATOMIC_RELEASE);
+    }
+}
+
+unsigned msgbox_depth(MSGBOX_ID msgboxid)
+{
+    struct msgbox *box;
+    size_t head, tail;
+    unsigned depth = 0;
+    unsigned i;
+
+    box = msgbox_get(msgboxid);
+    if (!box) {
+        return 0;
+    }
+    for (i = 0; i < MSGBOX_PRIORITIES; i++) {
+        head = __atomic_load_n(&box->ring[i].head, __ATOMIC_RELAXED);
+        tail = __atomic_load_n(&box->ring[i].tail, __ATOMIC_RELAXED);
+        if (tail > head) {
+            depth += (unsigned)(tail - head);
+        }
+    }
+
+    return depth;
+}
+
+MSG_DATA *alloc_data(void)
+{
+    MSG_DATA *data = NULL;
+
+    pthread_once(&Msg_Pool_Once, msg_pool_init);
+    if (ring_pop(&Msg_Data_Free, &data)) {
+        memset(data, 0, sizeof(MSG_DATA));
     } else {
-        msgctl(msgboxid, IPC_RMID, NULL);
+        data = NULL;
     }
+
+    return data;
 }
 
-void free_data(MSG_DATA *data)
+uint8_t *alloc_pdu(void)
 {
-    if (data->pdu) {
-        free(data->pdu);
-        data->pdu = NULL;
+    uint8_t *pdu = NULL;
+
+    pthread_once(&Msg_Pool_Once, msg_pool_init);
+    if (!ring_pop(&Msg_Pdu_Free, &pdu)) {
+        pdu = NULL;
     }
+
+    return pdu;
+}
+
+void free_data(MSG_DATA *data)
+{
+    /* the pools always have room for their own elements, but a push can
+       see the cell of a pop that is still in progress, so retry */
     if (data) {
-        free(data);
-        data = NULL;
+        if (data->pdu) {
+            while (!ring_push(&Msg_Pdu_Free, &data->pdu)) {
+            }
+            data->pdu = NULL;
+        }
+        while (!ring_push(&Msg_Data_Free, &data)) {
+        }
     }
 }
 
 void check_data(MSG_DATA *data)
 {
-    /* lock and decrement messages reference count */
-    pthread_mutex_lock(&msg_lock);
-    if (--data->ref_count == 0) {
+    /* decrement messages reference count, the last reference frees */
+    if (__atomic_sub_fetch(&data->ref_count, 1, __ATOMIC_ACQ_REL) == 0) {
         free_data(data);
     }
-    pthread_mutex_unlock(&msg_lock);
 }
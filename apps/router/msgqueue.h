@@ -33,16 +33,31 @@
 #include <stdbool.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
-#include <sys/msg.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/npdu.h"
 
-extern pthread_mutex_t msg_lock;
-
 #define INVALID_MSGBOX_ID -1
 
+/* number of message boxes: one for the router and one per port */
+#ifndef MSGBOX_MAX
+#define MSGBOX_MAX 16
+#endif
+/* number of messages of each network priority in each message box -
+   power of two */
+#ifndef MSGBOX_SIZE
+#define MSGBOX_SIZE 256
+#endif
+/* number of preallocated message data structures and PDU buffers */
+#ifndef MSG_DATA_POOL_SIZE
+#define MSG_DATA_POOL_SIZE 512
+#endif
+/* size of the PDU buffers - largest NPDU of any router port */
+#ifndef MSG_DATA_PDU_MAX
+#define MSG_DATA_PDU_MAX (MAX_NPDU + 1476)
+#endif
+
 typedef int MSGBOX_ID;
 
 typedef enum {
@@ -81,7 +96,7 @@ bool send_to_msgbox(
     MSGBOX_ID dest,
     BACMSG * msg);
 
-/* returns received message */
+/* returns received message, flags are 0 to wait or IPC_NOWAIT */
 BACMSG *recv_from_msgbox(
     MSGBOX_ID src,
     BACMSG * msg,
@@ -90,6 +105,18 @@ BACMSG *recv_from_msgbox(
 void del_msgbox(
     MSGBOX_ID msgboxid);
 
+/* returns the number of messages waiting in the message box */
+unsigned msgbox_depth(
+    MSGBOX_ID msgboxid);
+
+/* allocate message data structure from the pool */
+MSG_DATA *alloc_data(
+    void);
+
+/* allocate a MSG_DATA_PDU_MAX sized PDU buffer from the pool */
+uint8_t *alloc_pdu(
+    void);
+
 /* free message data structure */
 void free_data(
     MSG_DATA * data);
@@ -33,6 +33,7 @@
 #include "mstpmodule.h"
 #include "bacnet/bacint.h"
 #include "dlmstp_linux.h"
+#include "dlmstp_engine.h"
 #include <termios.h>
 
 #define MSTP_THREAD_PRINT_ENABLED
@@ -90,14 +91,19 @@ void *dl_mstp_thread(void *pArgs)
     dlmstp_set_mac_address(&mstp_port, port->route_info.mac[0]);
     dlmstp_set_max_info_frames(&mstp_port, port->params.mstp_params.max_frames);
     dlmstp_set_max_master(&mstp_port, port->params.mstp_params.max_master);
-    if (!dlmstp_init(&mstp_port, port->iface)) {
+    /* the state machines of every MS/TP port run in the engine thread */
+    if (!dlmstp_engine_add_port(&mstp_port, port->iface)) {
         printf("MSTP %s init failed. Stop.\n", port->iface);
+        port->state = INIT_FAILED;
+        return NULL;
     }
     mstp_port.Treply_timeout = 260;
     mstp_port.Tusage_timeout = 30;
 
     port->port_id = create_msgbox();
     if (port->port_id == INVALID_MSGBOX_ID) {
+        dlmstp_engine_remove_port(&mstp_port);
+        dlmstp_cleanup(&mstp_port);
         port->state = INIT_FAILED;
         return NULL;
     }
@@ -145,14 +151,21 @@ void *dl_mstp_thread(void *pArgs)
         } else {
             pdu_len = dlmstp_receive(&mstp_port, NULL, NULL, 0, 5);
 
-            if (pdu_len > 0) {
-                msg_data = (MSG_DATA *)malloc(sizeof(MSG_DATA));
+            if ((pdu_len > 0) && (pdu_len <= MSG_DATA_PDU_MAX)) {
+                /* allocate data message stucture from the pool */
+                msg_data = alloc_data();
+                if (msg_data) {
+                    msg_data->pdu = alloc_pdu();
+                }
+                if (!msg_data || !msg_data->pdu) {
+                    free_data(msg_data);
+                    continue;
+                }
                 memmove(&(msg_data->src),
                     (const void *)&(shared_port_data.Receive_Packet.address),
                     sizeof(shared_port_data.Receive_Packet.address));
                 msg_data->src.adr[0] = msg_data->src.mac[0];
                 msg_data->src.len = 1;
-                msg_data->pdu = (uint8_t *)malloc(pdu_len);
                 memmove(msg_data->pdu,
                     (const void *)&(shared_port_data.Receive_Packet.pdu),
                     pdu_len);
@@ -170,6 +183,7 @@ void *dl_mstp_thread(void *pArgs)
         }
     }
 
+    dlmstp_engine_remove_port(&mstp_port);
     dlmstp_cleanup(&mstp_port);
     port->state = FINISHED;
 
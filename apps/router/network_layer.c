@@ -30,6 +30,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "network_layer.h"
+#include "routecache.h"
 #include "bacnet/bacint.h"
 
 uint16_t process_network_message(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
@@ -90,8 +91,10 @@ uint16_t process_network_message(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
             for (i = 0; i < net_count; i++) {
                 decode_unsigned16(&data->pdu[apdu_offset + 2 * i],
                     &net); /* decode received NET values */
-                add_dnet(&srcport->route_info, net,
+                add_dnet(srcport, net,
                     data->src); /* and update routing table */
+                /* route the messages held for the network */
+                route_cache_resolved(net);
             }
             break;
         }
@@ -106,6 +109,10 @@ uint16_t process_network_message(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
                     break;
                 case 1:
                     PRINT(ERROR, "Error: Network unreachable\n");
+                    if (apdu_len >= 3) {
+                        decode_unsigned16(&data->pdu[apdu_offset + 1], &net);
+                        route_cache_unreachable(net);
+                    }
                     break;
                 case 2:
                     PRINT(ERROR, "Error: Network is busy\n");
@@ -129,7 +136,7 @@ uint16_t process_network_message(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
                     int i = 1;
                     decode_unsigned16(&data->pdu[apdu_offset + i],
                         &net); /* decode received NET values */
-                    add_dnet(&srcport->route_info, net,
+                    add_dnet(srcport, net,
                         data->src); /* and update routing table */
                     if (data->pdu[apdu_offset + i + 3] >
                         0) { /* find next NET value */
@@ -154,7 +161,7 @@ uint16_t process_network_message(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
                     int i = 1;
                     decode_unsigned16(&data->pdu[apdu_offset + i],
                         &net); /* decode received NET values */
-                    add_dnet(&srcport->route_info, net,
+                    add_dnet(srcport, net,
                         data->src); /* and update routing table */
                     if (data->pdu[apdu_offset + i + 3] >
                         0) { /* find next NET value */
@@ -166,10 +173,23 @@ uint16_t process_network_message(BACMSG *msg, MSG_DATA *data, uint8_t **buff)
             }
             break;
 
+        case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
+        case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK: {
+            bool busy = (npdu_data.network_message_type ==
+                NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK);
+            int net_count = apdu_len / 2;
+            int i;
+            PRINT(INFO, "Recieved Router-%s-To-Network message\n",
+                busy ? "Busy" : "Available");
+            for (i = 0; i < net_count; i++) {
+                decode_unsigned16(&data->pdu[apdu_offset + 2 * i],
+                    &net); /* decode received NET values */
+                set_dnet_flags(net, ROUTE_BUSY, busy);
+            }
+            break;
+        }
         case NETWORK_MESSAGE_INVALID:
         case NETWORK_MESSAGE_I_COULD_BE_ROUTER_TO_NETWORK:
-        case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
-        case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK:
         case NETWORK_MESSAGE_ESTABLISH_CONNECTION_TO_NETWORK:
         case NETWORK_MESSAGE_DISCONNECT_CONNECTION_TO_NETWORK:
             /* hell if I know what to do with these messages */
@@ -213,7 +233,10 @@ uint16_t create_network_message(
     }
     init_npdu(&npdu_data, network_message_type, data_expecting_reply);
 
-    *buff = (uint8_t *)malloc(128); /* resolve different length */
+    *buff = alloc_pdu();
+    if (*buff == NULL) {
+        return 0;
+    }
 
     /* manual destination setup for Init-RT-Table-Ack message */
     data->dest.net = BACNET_BROADCAST_NETWORK;
@@ -288,10 +311,25 @@ uint16_t create_network_message(
             }
             break;
 
-        case NETWORK_MESSAGE_INVALID:
-        case NETWORK_MESSAGE_I_COULD_BE_ROUTER_TO_NETWORK:
         case NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK:
         case NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK:
+            if (val != NULL) {
+                /* the networks reached through the congested port */
+                ROUTER_PORT *port = (ROUTER_PORT *)val;
+                DNET *dnet = port->route_info.dnets;
+                buff_len +=
+                    encode_unsigned16(*buff + buff_len, port->route_info.net);
+                while (dnet != NULL) {
+                    buff_len += encode_unsigned16(*buff + buff_len, dnet->net);
+                    dnet = dnet->next;
+                    if ((buff_len + 2) > MSG_DATA_PDU_MAX) {
+                        break;
+                    }
+                }
+            }
+            break;
+        case NETWORK_MESSAGE_INVALID:
+        case NETWORK_MESSAGE_I_COULD_BE_ROUTER_TO_NETWORK:
         case NETWORK_MESSAGE_ESTABLISH_CONNECTION_TO_NETWORK:
         case NETWORK_MESSAGE_DISCONNECT_CONNECTION_TO_NETWORK:
             /* hell if I know what to do with these messages */
@@ -326,12 +364,19 @@ void send_network_message(BACNET_NETWORK_MESSAGE_TYPE network_message_type,
     int16_t buff_len;
 
     if (!data) {
-        data = (MSG_DATA *)malloc(sizeof(MSG_DATA));
+        data = alloc_data();
+        if (!data) {
+            return;
+        }
         data->dest.net = BACNET_BROADCAST_NETWORK;
         data->dest.len = 0;
     }
 
     buff_len = create_network_message(network_message_type, data, buff, val);
+    if (buff_len == 0) {
+        free_data(data);
+        return;
+    }
 
     /* form network message */
     data->pdu = *buff;
@@ -342,11 +387,51 @@ void send_network_message(BACNET_NETWORK_MESSAGE_TYPE network_message_type,
 
     data->ref_count = port_count;
     while (port != NULL) {
-        if (port->state == FINISHED) {
-            port = port->next;
-            continue;
+        if ((port->state == FINISHED) ||
+            !send_to_msgbox(port->port_id, &msg)) {
+            /* release the reference of the port */
+            check_data(data);
+        }
+        port = port->next;
+    }
+}
+
+void send_router_busy_message(ROUTER_PORT *busy_port, bool busy)
+{
+    BACMSG msg;
+    MSG_DATA *data;
+    ROUTER_PORT *port = head;
+    uint8_t *buff = NULL;
+    int16_t buff_len;
+
+    data = alloc_data();
+    if (!data) {
+        return;
+    }
+    data->dest.net = BACNET_BROADCAST_NETWORK;
+    data->dest.len = 0;
+    buff_len = create_network_message(busy
+            ? NETWORK_MESSAGE_ROUTER_BUSY_TO_NETWORK
+            : NETWORK_MESSAGE_ROUTER_AVAILABLE_TO_NETWORK,
+        data, &buff, busy_port);
+    if (buff_len == 0) {
+        free_data(data);
+        return;
+    }
+    data->pdu = buff;
+    data->pdu_len = buff_len;
+    msg.origin = head->main_id;
+    msg.type = DATA;
+    msg.data = data;
+
+    /* tell the other networks, the congested port is not used */
+    data->ref_count = port_count;
+    while (port != NULL) {
+        if ((port == busy_port) || (port->state == FINISHED) ||
+            !send_to_msgbox(port->port_id, &msg)) {
+            /* release the reference of the port */
+            check_data(data);
         }
-        send_to_msgbox(port->port_id, &msg);
         port = port->next;
     }
 }
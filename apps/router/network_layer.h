@@ -59,6 +59,10 @@ void send_network_message(
     uint8_t ** buff,
     void *val);
 
+void send_router_busy_message(
+    ROUTER_PORT * busy_port,
+    bool busy);
+
 void init_npdu(
     BACNET_NPDU_DATA * npdu_data,
     BACNET_NETWORK_MESSAGE_TYPE network_message_type,
@@ -29,8 +29,95 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "bacnet/basic/sys/mstimer.h"
 #include "portthread.h"
 
+/* router data of a route in the routing table */
+typedef struct _route_data {
+    DNET *dnet; /* NULL if the network is directly connected */
+#if ROUTER_DNET_RATE
+    unsigned long tokens; /* thousandths of a message */
+    unsigned long stamp; /* milliseconds */
+#endif
+    struct _route_data *next; /* next unused route data */
+} ROUTE_DATA;
+
+/* routing table of the reachable networks, found by network number */
+static BACNET_ROUTE_ENTRY Route_Entries[ROUTER_ROUTE_ENTRIES];
+static BACNET_ROUTE_TABLE Route_Table;
+static ROUTE_DATA Route_Data[ROUTER_MAX_ROUTES];
+static ROUTE_DATA *Route_Data_Free;
+static bool Route_Table_Ready;
+/* networks which did not fit in the routing table are in the DNET lists */
+static bool Route_Table_Full;
+
+static BACNET_ROUTE_ENTRY *route_get(uint16_t net)
+{
+    if (!Route_Table_Ready) {
+        return NULL;
+    }
+
+    return bacnet_route_find(&Route_Table, net);
+}
+
+static DNET *route_dnet(BACNET_ROUTE_ENTRY *route)
+{
+    return ((ROUTE_DATA *)route->data)->dnet;
+}
+
+static BACNET_ROUTE_ENTRY *route_add(
+    uint16_t net, ROUTER_PORT *port, DNET *dnet)
+{
+    BACNET_ROUTE_ENTRY *route;
+    ROUTE_DATA *data;
+    unsigned i;
+
+    if (!Route_Table_Ready) {
+        bacnet_route_table_init(
+            &Route_Table, Route_Entries, ROUTER_ROUTE_ENTRIES);
+        Route_Data_Free = NULL;
+        for (i = ROUTER_MAX_ROUTES; i > 0; i--) {
+            Route_Data[i - 1].next = Route_Data_Free;
+            Route_Data_Free = &Route_Data[i - 1];
+        }
+        Route_Table_Ready = true;
+    }
+    route = bacnet_route_find(&Route_Table, net);
+    if (route) {
+        return route;
+    }
+    data = Route_Data_Free;
+    if (data) {
+        route = bacnet_route_add(&Route_Table, net, port,
+            dnet ? dnet->mac : NULL, dnet ? dnet->mac_len : 0);
+    }
+    if (!route) {
+        Route_Table_Full = true;
+        return NULL;
+    }
+    Route_Data_Free = data->next;
+    data->next = NULL;
+    data->dnet = dnet;
+#if ROUTER_DNET_RATE
+    data->tokens = ROUTER_DNET_BURST * 1000UL;
+    data->stamp = mstimer_now();
+#endif
+    route->data = data;
+    route->learned = mstimer_now();
+
+    return route;
+}
+
+static void route_remove(BACNET_ROUTE_ENTRY *route)
+{
+    ROUTE_DATA *data = route->data;
+
+    data->dnet = NULL;
+    data->next = Route_Data_Free;
+    Route_Data_Free = data;
+    (void)bacnet_route_remove(&Route_Table, route->net);
+}
+
 ROUTER_PORT *find_snet(MSGBOX_ID id)
 {
     ROUTER_PORT *port = head;
@@ -49,12 +136,28 @@ ROUTER_PORT *find_dnet(uint16_t net, BACNET_ADDRESS *addr)
 {
     ROUTER_PORT *port = head;
     DNET *dnet;
+    BACNET_ROUTE_ENTRY *route;
 
     /* for broadcast messages no search is needed */
     if (net == BACNET_BROADCAST_NETWORK) {
         return port;
     }
 
+    route = route_get(net);
+    if (route) {
+        if (!(route->flags & ROUTE_REACHABLE)) {
+            return NULL;
+        }
+        if (addr && route_dnet(route)) {
+            addr->len = route->mac_len;
+            memmove(&addr->adr[0], &route->mac[0], MAX_MAC_LEN);
+        }
+        return route->port;
+    }
+    if (!Route_Table_Full) {
+        return NULL;
+    }
+
     while (port != NULL) {
         /* check if DNET is directly connected to the router */
         if (net == port->route_info.net) {
@@ -80,41 +183,155 @@ ROUTER_PORT *find_dnet(uint16_t net, BACNET_ADDRESS *addr)
     return NULL;
 }
 
-void add_dnet(RT_ENTRY *route_info, uint16_t net, BACNET_ADDRESS addr)
+void add_port_route(ROUTER_PORT *port)
 {
+    (void)route_add(port->route_info.net, port, NULL);
+}
+
+void add_dnet(ROUTER_PORT *port, uint16_t net, BACNET_ADDRESS addr)
+{
+    RT_ENTRY *route_info = &port->route_info;
     DNET *dnet = route_info->dnets;
-    DNET *tmp;
+    DNET *tmp = NULL;
+    BACNET_ROUTE_ENTRY *route;
+    ROUTE_DATA *data;
 
-    if (dnet == NULL) {
-        route_info->dnets = (DNET *)malloc(sizeof(DNET));
-        memmove(&route_info->dnets->mac_len, &addr.len, 1);
-        memmove(&route_info->dnets->mac[0], &addr.adr[0], MAX_MAC_LEN);
-        route_info->dnets->net = net;
-        route_info->dnets->state = true;
-        route_info->dnets->next = NULL;
-    } else {
-        while (dnet != NULL) {
-            if (dnet->net == net) { /* make sure NETs are not repeated */
-                return;
-            }
-            tmp = dnet;
-            dnet = dnet->next;
+    while (dnet != NULL) {
+        if (dnet->net == net) { /* make sure NETs are not repeated */
+            break;
         }
-
+        tmp = dnet;
+        dnet = dnet->next;
+    }
+    if (dnet == NULL) {
         dnet = (DNET *)malloc(sizeof(DNET));
+        if (dnet == NULL) {
+            return;
+        }
         memmove(&dnet->mac_len, &addr.len, 1);
         memmove(&dnet->mac[0], &addr.adr[0], MAX_MAC_LEN);
         dnet->net = net;
         dnet->state = true;
         dnet->next = NULL;
-        tmp->next = dnet;
+        if (tmp) {
+            tmp->next = dnet;
+        } else {
+            route_info->dnets = dnet;
+        }
+    }
+
+    route = route_get(net);
+    if (route == NULL) {
+        (void)route_add(net, port, dnet);
+    } else if (!(route->flags & ROUTE_REACHABLE) && route_dnet(route)) {
+        /* the network is reachable again, maybe through another port */
+        data = route->data;
+        data->dnet = dnet;
+        route->port = port;
+        route->mac_len = dnet->mac_len;
+        memmove(&route->mac[0], &dnet->mac[0], MAX_MAC_LEN);
+        route->flags |= ROUTE_REACHABLE;
+        route->learned = mstimer_now();
+        dnet->state = true;
+    } else if (route_dnet(route)) {
+        route->learned = mstimer_now();
+    }
+}
+
+bool set_dnet_flags(uint16_t net, uint8_t flags, bool state)
+{
+    BACNET_ROUTE_ENTRY *route;
+
+    route = route_get(net);
+    if (route == NULL) {
+        return false;
+    }
+    if (state) {
+        route->flags |= flags;
+    } else {
+        route->flags &= ~flags;
     }
+    if ((flags & ROUTE_REACHABLE) && route_dnet(route)) {
+        route_dnet(route)->state = state;
+    }
+
+    return true;
+}
+
+uint8_t get_dnet_flags(uint16_t net)
+{
+    BACNET_ROUTE_ENTRY *route;
+
+    route = route_get(net);
+    if (route == NULL) {
+        return 0;
+    }
+
+    return route->flags;
+}
+
+bool dnet_route_aged(uint16_t net)
+{
+    BACNET_ROUTE_ENTRY *route;
+    unsigned long now;
+
+    route = route_get(net);
+    if ((route == NULL) || (route_dnet(route) == NULL)) {
+        return false;
+    }
+    now = mstimer_now();
+    if ((now - route->learned) < ROUTER_ROUTE_TTL_MS) {
+        return false;
+    }
+    route->learned = now;
+
+    return true;
+}
+
+bool dnet_rate_allow(uint16_t net)
+{
+#if ROUTER_DNET_RATE
+    BACNET_ROUTE_ENTRY *route;
+    ROUTE_DATA *data;
+    unsigned long now, elapsed;
+
+    route = route_get(net);
+    if (route == NULL) {
+        return true;
+    }
+    data = route->data;
+    /* token bucket refilled at ROUTER_DNET_RATE messages per second */
+    now = mstimer_now();
+    elapsed = now - data->stamp;
+    data->stamp = now;
+    if (elapsed > (ROUTER_DNET_BURST * 1000UL)) {
+        elapsed = ROUTER_DNET_BURST * 1000UL;
+    }
+    data->tokens += elapsed * ROUTER_DNET_RATE;
+    if (data->tokens > (ROUTER_DNET_BURST * 1000UL)) {
+        data->tokens = ROUTER_DNET_BURST * 1000UL;
+    }
+    if (data->tokens < 1000UL) {
+        return false;
+    }
+    data->tokens -= 1000UL;
+#else
+    (void)net;
+#endif
+
+    return true;
 }
 
 void cleanup_dnets(DNET *dnets)
 {
     DNET *dnet = dnets;
+    BACNET_ROUTE_ENTRY *route;
+
     while (dnet != NULL) {
+        route = route_get(dnet->net);
+        if (route && (route_dnet(route) == dnet)) {
+            route_remove(route);
+        }
         dnet = dnet->next;
         free(dnets);
         dnets = dnet;
@@ -36,6 +36,7 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/npdu.h"
+#include "bacnet/basic/npdu/route_table.h"
 /* router utils */
 #include "msgqueue.h"
 
@@ -105,6 +106,43 @@ typedef struct _routing_table_entry {
     DNET *dnets;
 } RT_ENTRY;
 
+/* routing table size - number of networks that are found in O(1) */
+#ifndef ROUTER_MAX_ROUTES
+#define ROUTER_MAX_ROUTES 2048
+#endif
+/* routing table entries, a power of two, of which at most three
+   quarters are used */
+#ifndef ROUTER_ROUTE_ENTRIES
+#define ROUTER_ROUTE_ENTRIES (2 * ROUTER_MAX_ROUTES)
+#endif
+
+/* routing table flags */
+#define ROUTE_REACHABLE BACNET_ROUTE_REACHABLE
+#define ROUTE_BUSY BACNET_ROUTE_BUSY
+
+/* port queue depth where the router becomes busy to the networks
+   of the port and drops the traffic for them */
+#ifndef ROUTER_PORT_BUSY_DEPTH
+#define ROUTER_PORT_BUSY_DEPTH ((MSGBOX_SIZE * 3) / 4)
+#endif
+/* port queue depth where the router is available again */
+#ifndef ROUTER_PORT_AVAILABLE_DEPTH
+#define ROUTER_PORT_AVAILABLE_DEPTH (MSGBOX_SIZE / 4)
+#endif
+/* milliseconds that a network learned from another router is used
+   before the router searches for it again */
+#ifndef ROUTER_ROUTE_TTL_MS
+#define ROUTER_ROUTE_TTL_MS 600000UL
+#endif
+/* routed messages per second to each DNET, or 0 for no limit */
+#ifndef ROUTER_DNET_RATE
+#define ROUTER_DNET_RATE 0
+#endif
+/* number of messages that can be sent to a DNET in a burst */
+#ifndef ROUTER_DNET_BURST
+#define ROUTER_DNET_BURST (ROUTER_DNET_RATE)
+#endif
+
 typedef struct _port {
     DL_TYPE type;
     PORT_STATE state;
@@ -114,6 +152,8 @@ typedef struct _port {
     PORT_FUNC func;
     RT_ENTRY route_info;
     PORT_PARAMS params;
+    bool busy; /* Router-Busy-To-Network was sent for this port */
+    unsigned long dropped; /* messages not queued to this port */
     struct _port *next; /* pointer to next list node */
 } ROUTER_PORT;
 
@@ -131,10 +171,33 @@ ROUTER_PORT *find_dnet(
 
 /* add reacheble network for specified router port */
 void add_dnet(
-    RT_ENTRY * route_info,
+    ROUTER_PORT * port,
     uint16_t net,
     BACNET_ADDRESS addr);
 
+/* add the directly connected network of a router port */
+void add_port_route(
+    ROUTER_PORT * port);
+
+/* set or clear the routing table flags of a network */
+bool set_dnet_flags(
+    uint16_t net,
+    uint8_t flags,
+    bool state);
+
+/* get the routing table flags of a network, or 0 if unknown */
+uint8_t get_dnet_flags(
+    uint16_t net);
+
+/* check if the route to a network learned from another router is due
+   to be searched for again, which restarts its time to live */
+bool dnet_route_aged(
+    uint16_t net);
+
+/* take a message from the rate limit of a network */
+bool dnet_rate_allow(
+    uint16_t net);
+
 void cleanup_dnets(
     DNET * dnets);
 
@@ -0,0 +1,257 @@
+/**
+ * @file
+ * @brief Cache of the networks that the router is resolving with
+ *  Who-Is-Router-To-Network, and of the networks found unreachable.
+ *  The messages for a network being resolved are held, and are routed
+ *  when an I-Am-Router-To-Network for the network is received.  Each
+ *  network is queried at most once per ROUTE_CACHE_QUERY_MS however many
+ *  messages are sent to it, and a network that is rejected as unreachable
+ *  or not found is not queried again until ROUTE_CACHE_NEGATIVE_MS.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/mstimer.h"
+#include "network_layer.h"
+#include "portthread.h"
+#include "routecache.h"
+
+typedef enum {
+    ROUTE_CACHE_FREE,
+    ROUTE_CACHE_PENDING,
+    ROUTE_CACHE_UNREACHABLE
+} ROUTE_CACHE_STATE;
+
+typedef struct _route_cache_entry {
+    uint16_t net;
+    ROUTE_CACHE_STATE state;
+    /* the network is in the routing table, and its route has aged */
+    bool refresh;
+    /* milliseconds of the last query, or when it became unreachable */
+    unsigned long stamp;
+    uint8_t queries;
+    BACMSG queue[ROUTE_CACHE_QUEUE];
+    unsigned count;
+} ROUTE_CACHE_ENTRY;
+
+static ROUTE_CACHE_ENTRY Route_Cache[ROUTE_CACHE_SIZE];
+
+static ROUTE_CACHE_ENTRY *route_cache_find(uint16_t net)
+{
+    unsigned i;
+
+    for (i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        if ((Route_Cache[i].state != ROUTE_CACHE_FREE) &&
+            (Route_Cache[i].net == net)) {
+            return &Route_Cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* discard the held messages of an entry */
+static void route_cache_release(ROUTE_CACHE_ENTRY *entry)
+{
+    unsigned i;
+
+    for (i = 0; i < entry->count; i++) {
+        free_data((MSG_DATA *)entry->queue[i].data);
+    }
+    entry->count = 0;
+}
+
+/* take a free entry, or the entry unreachable for the longest time */
+static ROUTE_CACHE_ENTRY *route_cache_new(uint16_t net)
+{
+    ROUTE_CACHE_ENTRY *entry = NULL;
+    unsigned long now = mstimer_now();
+    unsigned i;
+
+    for (i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        if (Route_Cache[i].state == ROUTE_CACHE_FREE) {
+            entry = &Route_Cache[i];
+            break;
+        }
+        if ((Route_Cache[i].state == ROUTE_CACHE_UNREACHABLE) &&
+            (!entry ||
+                ((now - Route_Cache[i].stamp) > (now - entry->stamp)))) {
+            entry = &Route_Cache[i];
+        }
+    }
+    if (entry) {
+        route_cache_release(entry);
+        memset(entry, 0, sizeof(*entry));
+        entry->net = net;
+        entry->state = ROUTE_CACHE_PENDING;
+    }
+
+    return entry;
+}
+
+static void route_cache_query(ROUTE_CACHE_ENTRY *entry)
+{
+    uint16_t net = entry->net;
+    uint8_t *buff = NULL;
+
+    PRINT(INFO, "Searching NET %u...\n", (unsigned)net);
+    send_network_message(
+        NETWORK_MESSAGE_WHO_IS_ROUTER_TO_NETWORK, NULL, &buff, &net);
+    entry->stamp = mstimer_now();
+    entry->queries++;
+}
+
+static void route_cache_set_unreachable(ROUTE_CACHE_ENTRY *entry)
+{
+    PRINT(INFO, "NET %u unreachable\n", (unsigned)entry->net);
+    route_cache_release(entry);
+    entry->state = ROUTE_CACHE_UNREACHABLE;
+    entry->refresh = false;
+    entry->stamp = mstimer_now();
+    (void)set_dnet_flags(entry->net, ROUTE_REACHABLE, false);
+}
+
+/* query again, give up, or forget an entry when its time is up */
+static void route_cache_age(ROUTE_CACHE_ENTRY *entry, unsigned long now)
+{
+    if (entry->state == ROUTE_CACHE_PENDING) {
+        if ((now - entry->stamp) >= ROUTE_CACHE_QUERY_MS) {
+            if (entry->queries >= ROUTE_CACHE_QUERIES) {
+                route_cache_set_unreachable(entry);
+            } else {
+                route_cache_query(entry);
+            }
+        }
+    } else if (entry->state == ROUTE_CACHE_UNREACHABLE) {
+        if ((now - entry->stamp) >= ROUTE_CACHE_NEGATIVE_MS) {
+            entry->state = ROUTE_CACHE_FREE;
+        }
+    }
+}
+
+bool route_cache_hold(BACMSG *msg, uint16_t net)
+{
+    ROUTE_CACHE_ENTRY *entry;
+
+    if (!msg || (net == 0) || (net == BACNET_BROADCAST_NETWORK)) {
+        return false;
+    }
+    entry = route_cache_find(net);
+    if (entry) {
+        route_cache_age(entry, mstimer_now());
+    }
+    if (entry && (entry->state == ROUTE_CACHE_UNREACHABLE)) {
+        return false;
+    }
+    if (!entry || (entry->state == ROUTE_CACHE_FREE)) {
+        entry = route_cache_new(net);
+        if (!entry) {
+            return false;
+        }
+        route_cache_query(entry);
+    }
+    if (entry->count >= ROUTE_CACHE_QUEUE) {
+        /* discard the oldest message */
+        free_data((MSG_DATA *)entry->queue[0].data);
+        memmove(
+            &entry->queue[0], &entry->queue[1],
+            (ROUTE_CACHE_QUEUE - 1) * sizeof(entry->queue[0]));
+        entry->count--;
+    }
+    entry->queue[entry->count++] = *msg;
+
+    return true;
+}
+
+bool route_cache_search(uint16_t net)
+{
+    ROUTE_CACHE_ENTRY *entry;
+
+    if ((net == 0) || (net == BACNET_BROADCAST_NETWORK)) {
+        return false;
+    }
+    entry = route_cache_find(net);
+    if (entry) {
+        route_cache_age(entry, mstimer_now());
+        if (entry->state != ROUTE_CACHE_FREE) {
+            return false;
+        }
+    }
+    entry = route_cache_new(net);
+    if (!entry) {
+        return false;
+    }
+    route_cache_query(entry);
+
+    return true;
+}
+
+void route_cache_refresh(uint16_t net)
+{
+    ROUTE_CACHE_ENTRY *entry;
+
+    entry = route_cache_find(net);
+    if (entry) {
+        return;
+    }
+    entry = route_cache_new(net);
+    if (entry) {
+        entry->refresh = true;
+        route_cache_query(entry);
+    }
+}
+
+void route_cache_resolved(uint16_t net)
+{
+    ROUTE_CACHE_ENTRY *entry;
+    ROUTER_PORT *port = head;
+    unsigned i;
+
+    entry = route_cache_find(net);
+    if (!entry) {
+        return;
+    }
+    /* the held messages are routed again by the main loop */
+    for (i = 0; i < entry->count; i++) {
+        if (!port || !send_to_msgbox(port->main_id, &entry->queue[i])) {
+            free_data((MSG_DATA *)entry->queue[i].data);
+        }
+    }
+    entry->count = 0;
+    entry->state = ROUTE_CACHE_FREE;
+}
+
+void route_cache_unreachable(uint16_t net)
+{
+    ROUTE_CACHE_ENTRY *entry;
+
+    entry = route_cache_find(net);
+    if (!entry) {
+        entry = route_cache_new(net);
+    }
+    if (entry) {
+        route_cache_set_unreachable(entry);
+    }
+}
+
+void route_cache_maintenance(void)
+{
+    unsigned long now = mstimer_now();
+    unsigned i;
+
+    for (i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        route_cache_age(&Route_Cache[i], now);
+    }
+}
+
+void route_cache_cleanup(void)
+{
+    unsigned i;
+
+    for (i = 0; i < ROUTE_CACHE_SIZE; i++) {
+        route_cache_release(&Route_Cache[i]);
+        Route_Cache[i].state = ROUTE_CACHE_FREE;
+    }
+}
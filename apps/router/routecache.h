@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief Cache of the networks that the router is resolving with
+ *  Who-Is-Router-To-Network, and of the networks found unreachable
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef ROUTECACHE_H
+#define ROUTECACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "msgqueue.h"
+
+/* number of networks being resolved or unreachable at the same time */
+#ifndef ROUTE_CACHE_SIZE
+#define ROUTE_CACHE_SIZE 32
+#endif
+/* number of messages held for a network while it is resolved */
+#ifndef ROUTE_CACHE_QUEUE
+#define ROUTE_CACHE_QUEUE 8
+#endif
+/* milliseconds between the Who-Is-Router-To-Network of a network */
+#ifndef ROUTE_CACHE_QUERY_MS
+#define ROUTE_CACHE_QUERY_MS 2000UL
+#endif
+/* number of Who-Is-Router-To-Network before a network is unreachable */
+#ifndef ROUTE_CACHE_QUERIES
+#define ROUTE_CACHE_QUERIES 3
+#endif
+/* milliseconds that an unreachable network is not queried again */
+#ifndef ROUTE_CACHE_NEGATIVE_MS
+#define ROUTE_CACHE_NEGATIVE_MS 60000UL
+#endif
+
+/* hold a message for a network that is not in the routing table,
+   and search for it; false if the message is to be discarded */
+bool route_cache_hold(
+    BACMSG * msg,
+    uint16_t net);
+
+/* search for a network without a message to hold, such as for a
+   Who-Is-Router-To-Network; false if it is searched or unreachable */
+bool route_cache_search(
+    uint16_t net);
+
+/* search again for a network whose route has aged in the routing table */
+void route_cache_refresh(
+    uint16_t net);
+
+/* a router to the network was found: the held messages are routed */
+void route_cache_resolved(
+    uint16_t net);
+
+/* the network is unreachable: the held messages are discarded */
+void route_cache_unreachable(
+    uint16_t net);
+
+/* send the searches that are due, and end the ones with no answer */
+void route_cache_maintenance(
+    void);
+
+/* discard the held messages */
+void route_cache_cleanup(
+    void);
+
+#endif /* end of ROUTECACHE_H */
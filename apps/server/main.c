@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <signal.h>
 #include <string.h>
+#include <time.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -28,6 +29,7 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/filename.h"
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/timer_wheel.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/datalink/dlenv.h"
@@ -43,7 +45,9 @@
 #include "bacnet/basic/object/color_temperature.h"
 #endif
 #include "bacnet/basic/object/lc.h"
+#include "bacnet/basic/object/schedule.h"
 #include "bacnet/basic/object/trendlog.h"
+#include "bacnet/basic/object/trendlog_multiple.h"
 #include "bacnet/basic/object/structured_view.h"
 #if defined(INTRINSIC_REPORTING)
 #include "bacnet/basic/object/nc.h"
@@ -54,6 +58,13 @@
 #if defined(BAC_UCI)
 #include "bacnet/basic/ucix/ucix.h"
 #endif /* defined(BAC_UCI) */
+#if defined(BACNET_SERVER_WORKERS)
+#include "workers.h"
+#endif
+#if defined(BACNET_METRICS_HTTP)
+#include "bacnet/basic/service/metrics.h"
+#include "metrics_http.h"
+#endif
 
 /* (Doxygen note: The next two lines pull all the following Javadoc
  *  into the ServerDemo module.) */
@@ -63,19 +74,27 @@
 /* current version of the BACnet stack */
 static const char *BACnet_Version = BACNET_VERSION_TEXT;
 /* task timer for various BACnet timeouts */
-static struct mstimer BACnet_Task_Timer;
+static struct timer_wheel_timer BACnet_Task_Timer;
 /* task timer for TSM timeouts */
-static struct mstimer BACnet_TSM_Timer;
+static struct timer_wheel_timer BACnet_TSM_Timer;
 /* task timer for address binding timeouts */
-static struct mstimer BACnet_Address_Timer;
+static struct timer_wheel_timer BACnet_Address_Timer;
 #if defined(INTRINSIC_REPORTING)
 /* task timer for notification recipient timeouts */
-static struct mstimer BACnet_Notification_Timer;
+static struct timer_wheel_timer BACnet_Notification_Timer;
 #endif
 /* task timer for objects */
-static struct mstimer BACnet_Object_Timer;
+static struct timer_wheel_timer BACnet_Object_Timer;
+#if defined(BACNET_METRICS_HTTP)
+/* seconds since the server was started, for the metrics */
+static uint32_t Server_Uptime_Seconds;
+#endif
+/* longest wait for a packet, in milliseconds */
+#define SERVER_RECEIVE_TIMEOUT_MAX 1000UL
 /** Buffer used for receiving */
+#if !defined(datalink_receive_buffer)
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+#endif
 
 /* configure an example structured view object subordinate list */
 #if (BACNET_PROTOCOL_REVISION >= 4)
@@ -154,6 +173,120 @@ static void Structured_View_Update(void)
     Structured_View_Node_Type_Set(instance, BACNET_NODE_ROOM);
 }
 
+/**
+ * @brief Run the 1 second tasks
+ * @param context - not used
+ */
+static void Server_Task_Seconds(void *context)
+{
+    uint32_t elapsed_seconds;
+    BACNET_DATE_TIME bdatetime;
+
+    (void)context;
+    elapsed_seconds = timer_wheel_interval(&BACnet_Task_Timer) / 1000;
+    dcc_timer_seconds(elapsed_seconds);
+    datalink_maintenance_timer(elapsed_seconds);
+    dlenv_maintenance_timer(elapsed_seconds);
+    handler_cov_timer_seconds(elapsed_seconds);
+    Load_Control_State_Machine_Handler();
+    trend_log_timer(elapsed_seconds);
+    trend_log_multiple_timer(elapsed_seconds);
+#if defined(INTRINSIC_REPORTING)
+    Device_local_reporting();
+#endif
+    Device_getCurrentDateTime(&bdatetime);
+    Schedule_Evaluate(&bdatetime);
+#if defined(BACNET_TIME_MASTER)
+    handler_timesync_task(&bdatetime);
+#endif
+#if defined(BACNET_METRICS_HTTP)
+    Server_Uptime_Seconds += elapsed_seconds;
+    bacnet_metrics_publish(Server_Uptime_Seconds);
+#endif
+}
+
+/**
+ * @brief Run the TSM timeouts
+ * @param context - not used
+ */
+static void Server_Task_TSM(void *context)
+{
+    (void)context;
+    tsm_timer_milliseconds(timer_wheel_interval(&BACnet_TSM_Timer));
+#if defined(INTRINSIC_REPORTING)
+    Notification_Class_Event_Queue_Task();
+#endif
+}
+
+/**
+ * @brief Run the address binding timeouts
+ * @param context - not used
+ */
+static void Server_Task_Address(void *context)
+{
+    (void)context;
+    address_cache_timer(timer_wheel_interval(&BACnet_Address_Timer) / 1000);
+}
+
+/**
+ * @brief Ask again the devices whose address bindings are about to expire
+ * @param dest - address of the device, or of its network
+ * @param low_limit - lowest device-id to ask
+ * @param high_limit - highest device-id to ask
+ */
+static void Server_Address_Refresh(
+    BACNET_ADDRESS *dest, uint32_t low_limit, uint32_t high_limit)
+{
+    Send_WhoIs_To_Network(dest, (int32_t)low_limit, (int32_t)high_limit);
+}
+
+#if defined(INTRINSIC_REPORTING)
+/**
+ * @brief Run the notification recipient timeouts
+ * @param context - not used
+ */
+static void Server_Task_Notification(void *context)
+{
+    (void)context;
+    Notification_Class_find_recipient();
+}
+#endif
+
+/**
+ * @brief Run the object timers
+ * @param context - not used
+ */
+static void Server_Task_Objects(void *context)
+{
+    (void)context;
+    Device_Timer(timer_wheel_interval(&BACnet_Object_Timer));
+}
+
+/**
+ * @brief Clock of the startup profile, in microseconds of processor time
+ * @return the processor time in microseconds
+ */
+static unsigned long Init_Profile_Clock(void)
+{
+    return (unsigned long)((double)clock() * 1000000.0 / CLOCKS_PER_SEC);
+}
+
+/**
+ * @brief Print the time that the Init function of an object type took
+ * @param object_type - object type, or MAX_BACNET_OBJECT_TYPE for all
+ * @param elapsed - time in microseconds
+ */
+static void
+Init_Profile_Report(BACNET_OBJECT_TYPE object_type, unsigned long elapsed)
+{
+    if (object_type == MAX_BACNET_OBJECT_TYPE) {
+        printf("Init Device: %lu us total\n", elapsed);
+    } else {
+        printf("Init %s: %lu us\n", bactext_object_type_name(object_type),
+            elapsed);
+    }
+}
+
 /** Initialize the handlers we will utilize.
  * @see Device_Init, apdu_set_unconfirmed_handler, apdu_set_confirmed_handler
  */
@@ -195,6 +328,10 @@ static void Init_Service_Handlers(void)
     /* set the handler for all the services we don't implement */
     /* It is required to send the proper reject message... */
     apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
+    /* learn the max-APDU of the devices from their requests, and wait
+       for each device as long as it takes to reply to our requests */
+    apdu_set_peer_capability_handler(address_peer_capability_update);
+    tsm_set_peer_timeout_handler(address_apdu_timeout);
     /* Set the handlers for any confirmed services that we support. */
     /* We must implement read property - it's required! */
     apdu_set_confirmed_handler(
@@ -221,6 +358,8 @@ static void Init_Service_Handlers(void)
         SERVICE_UNCONFIRMED_TIME_SYNCHRONIZATION, handler_timesync);
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY,
+        handler_cov_subscribe_property);
     apdu_set_unconfirmed_handler(
         SERVICE_UNCONFIRMED_COV_NOTIFICATION, handler_ucov_notification);
     /* handle communication so we can shutup when asked */
@@ -245,15 +384,48 @@ static void Init_Service_Handlers(void)
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_DELETE_OBJECT, handler_delete_object);
     /* configure the cyclic timers */
-    mstimer_set(&BACnet_Task_Timer, 1000UL);
-    mstimer_set(&BACnet_TSM_Timer, 50UL);
-    mstimer_set(&BACnet_Address_Timer, 60UL*1000UL);
-    mstimer_set(&BACnet_Object_Timer, 100UL);
+    timer_wheel_init();
+    timer_wheel_set(&BACnet_Task_Timer, Server_Task_Seconds, NULL, 1000UL,
+        1000UL);
+    timer_wheel_set(&BACnet_TSM_Timer, Server_Task_TSM, NULL, 50UL, 50UL);
+    timer_wheel_set(&BACnet_Address_Timer, Server_Task_Address, NULL,
+        60UL * 1000UL, 60UL * 1000UL);
+    timer_wheel_set(&BACnet_Object_Timer, Server_Task_Objects, NULL, 100UL,
+        100UL);
 #if defined(INTRINSIC_REPORTING)
-    mstimer_set(&BACnet_Notification_Timer, NC_RESCAN_RECIPIENTS_SECS*1000UL);
+    timer_wheel_set(&BACnet_Notification_Timer, Server_Task_Notification,
+        NULL, NC_RESCAN_RECIPIENTS_SECS * 1000UL,
+        NC_RESCAN_RECIPIENTS_SECS * 1000UL);
 #endif
 }
 
+/**
+ * @brief Run the cyclic tasks of the BACnet stack and the objects whose
+ *  timers expired, and the tasks that run on each loop
+ */
+static void Server_Tasks(void)
+{
+    timer_wheel_task();
+    handler_cov_task();
+}
+
+/**
+ * @brief Get the milliseconds to wait for a packet, which is until the
+ *  next deadline of the cyclic tasks
+ * @return milliseconds to wait for a packet
+ */
+static unsigned Server_Receive_Timeout(void)
+{
+    uint32_t milliseconds;
+
+    milliseconds = timer_wheel_next();
+    if (milliseconds > SERVER_RECEIVE_TIMEOUT_MAX) {
+        milliseconds = SERVER_RECEIVE_TIMEOUT_MAX;
+    }
+
+    return (unsigned)milliseconds;
+}
+
 static void print_usage(const char *filename)
 {
     printf("Usage: %s [device-instance [device-name]]\n", filename);
@@ -268,6 +440,14 @@ static void print_help(const char *filename)
            "trying simulate.\n"
            "device-name:\n"
            "The Device object-name is the text name for the device.\n"
+#if defined(BACNET_SERVER_WORKERS)
+           "\nSet the BACNET_SERVER_WORKERS environment variable to the\n"
+           "number of worker threads that handle confirmed requests.\n"
+#endif
+#if defined(BACNET_METRICS_HTTP)
+           "\nSet the BACNET_METRICS_PORT environment variable to the\n"
+           "TCP port that serves GET /metrics in the Prometheus format.\n"
+#endif
            "\nExample:\n");
     printf("To simulate Device 123, use the following command:\n"
            "%s 123\n",
@@ -293,12 +473,16 @@ int main(int argc, char *argv[])
 {
     BACNET_ADDRESS src = { 0 }; /* address where message came from */
     uint16_t pdu_len = 0;
-    unsigned timeout = 1; /* milliseconds */
-    uint32_t elapsed_milliseconds = 0;
-    uint32_t elapsed_seconds = 0;
+#if defined(datalink_receive_buffer)
+    uint8_t *pdu = NULL;
+#endif
     BACNET_CHARACTER_STRING DeviceName;
-#if defined(BACNET_TIME_MASTER)
-    BACNET_DATE_TIME bdatetime;
+#if defined(BACNET_SERVER_WORKERS)
+    unsigned workers = 0;
+    char *pEnv = NULL;
+#endif
+#if defined(BACNET_METRICS_HTTP)
+    char *metrics_port = NULL;
 #endif
 #if defined(BAC_UCI)
     int uciId = 0;
@@ -351,6 +535,11 @@ int main(int argc, char *argv[])
     /* load any static address bindings to show up
        in our device bindings list */
     address_init();
+    address_refresh_callback_set(Server_Address_Refresh);
+    if (getenv("BACNET_INIT_PROFILE")) {
+        /* report the startup time of each object type */
+        Device_Init_Profile_Set(Init_Profile_Clock, Init_Profile_Report);
+    }
     Init_Service_Handlers();
     /* initialize timesync callback function. */
     handler_timesync_set_callback_set(&datetime_timesync);
@@ -377,60 +566,57 @@ int main(int argc, char *argv[])
     }
     dlenv_init();
     atexit(datalink_cleanup);
+#if defined(BACNET_METRICS_HTTP)
+    metrics_port = getenv("BACNET_METRICS_PORT");
+    if (metrics_port) {
+        if (metrics_http_start((uint16_t)strtoul(metrics_port, NULL, 0))) {
+            atexit(metrics_http_stop);
+            printf("BACnet Metrics: port %s\n", metrics_port);
+        } else {
+            fprintf(
+                stderr, "BACnet Metrics: port %s failed\n", metrics_port);
+        }
+    }
+#endif
     /* broadcast an I-Am on startup */
     Send_I_Am(&Handler_Transmit_Buffer[0]);
+#if defined(BACNET_SERVER_WORKERS)
+    pEnv = getenv("BACNET_SERVER_WORKERS");
+    if (pEnv) {
+        workers = strtoul(pEnv, NULL, 0);
+    }
+    if (workers && server_workers_init(workers)) {
+        atexit(server_workers_cleanup);
+        printf("BACnet Server Workers: %u\n", server_workers_count());
+        /* confirmed requests are handled by the worker threads */
+        for (;;) {
+            server_workers_receive(Server_Receive_Timeout());
+            server_workers_lock();
+            Server_Tasks();
+            server_workers_unlock();
+        }
+    }
+#endif
     /* loop forever */
     for (;;) {
         /* input */
-        pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
+#if defined(datalink_receive_buffer)
+        /* the NPDU is decoded in place in the datalink receive buffer */
+        pdu_len =
+            datalink_receive_buffer(&src, &pdu, Server_Receive_Timeout());
+        if (pdu_len) {
+            npdu_handler(&src, pdu, pdu_len);
+        }
+#else
+        pdu_len = datalink_receive(
+            &src, &Rx_Buf[0], MAX_MPDU, Server_Receive_Timeout());
 
         /* process */
         if (pdu_len) {
             npdu_handler(&src, &Rx_Buf[0], pdu_len);
         }
-        if (mstimer_expired(&BACnet_Task_Timer)) {
-            mstimer_reset(&BACnet_Task_Timer);
-            elapsed_milliseconds = mstimer_interval(&BACnet_Task_Timer);
-            elapsed_seconds = elapsed_milliseconds/1000;
-            /* 1 second tasks */
-            dcc_timer_seconds(elapsed_seconds);
-            datalink_maintenance_timer(elapsed_seconds);
-            dlenv_maintenance_timer(elapsed_seconds);
-            handler_cov_timer_seconds(elapsed_seconds);
-            Load_Control_State_Machine_Handler();
-            trend_log_timer(elapsed_seconds);
-#if defined(INTRINSIC_REPORTING)
-            Device_local_reporting();
-#endif
-#if defined(BACNET_TIME_MASTER)
-            Device_getCurrentDateTime(&bdatetime);
-            handler_timesync_task(&bdatetime);
-#endif
-        }
-        if (mstimer_expired(&BACnet_TSM_Timer)) {
-            mstimer_reset(&BACnet_TSM_Timer);
-            elapsed_milliseconds = mstimer_interval(&BACnet_TSM_Timer);
-            tsm_timer_milliseconds(elapsed_milliseconds);
-        }
-        if (mstimer_expired(&BACnet_Address_Timer)) {
-            mstimer_reset(&BACnet_Address_Timer);
-            elapsed_milliseconds = mstimer_interval(&BACnet_Address_Timer);
-            elapsed_seconds = elapsed_milliseconds/1000;
-            address_cache_timer(elapsed_seconds);
-        }
-        handler_cov_task();
-#if defined(INTRINSIC_REPORTING)
-        if (mstimer_expired(&BACnet_Notification_Timer)) {
-            mstimer_reset(&BACnet_Notification_Timer);
-            Notification_Class_find_recipient();
-        }
 #endif
-        /* output */
-        if (mstimer_expired(&BACnet_Object_Timer)) {
-            mstimer_reset(&BACnet_Object_Timer);
-            elapsed_milliseconds = mstimer_interval(&BACnet_Object_Timer);
-            Device_Timer(elapsed_milliseconds);
-        }
+        Server_Tasks();
     }
 
     return 0;
@@ -0,0 +1,294 @@
+/**
+ * @file
+ * @brief Worker thread pool for the BACnet server demo.
+ *
+ * The receive loop reads from the datalink and handles unconfirmed
+ * messages, network layer messages and replies inline. Confirmed requests
+ * are queued to a worker thread selected from the source address, so that
+ * the requests from one peer are always handled by the same worker and in
+ * the order they were received.
+ *
+ * The stack object tables, the TSM, the COV subscriptions, the address
+ * cache and the datalink send path are shared by every service handler,
+ * so the handlers run under one stack lock. The datalink wait, the copy
+ * of each request, and the queue handoff are done outside of the lock.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <poll.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/npdu.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/datalink/datalink.h"
+#include "workers.h"
+
+/* a confirmed request waiting for a worker */
+struct server_worker_message {
+    BACNET_ADDRESS src;
+    uint16_t pdu_len;
+    uint8_t pdu[MAX_MPDU];
+};
+
+struct server_worker {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_cond_t space;
+    unsigned head;
+    unsigned count;
+    struct server_worker_message queue[SERVER_WORKERS_QUEUE_SIZE];
+};
+
+static struct server_worker Server_Workers[SERVER_WORKERS_MAX];
+static unsigned Server_Workers_Count;
+static volatile bool Server_Workers_Stop;
+/* guards the stack handlers, objects and datalink */
+static pthread_mutex_t Server_Stack_Mutex = PTHREAD_MUTEX_INITIALIZER;
+/* buffer used by the receive loop */
+static uint8_t Server_Rx_Buf[MAX_MPDU];
+
+/**
+ * @brief Lock the stack, for use by the tasks of the main loop
+ */
+void server_workers_lock(void)
+{
+    pthread_mutex_lock(&Server_Stack_Mutex);
+}
+
+/**
+ * @brief Unlock the stack
+ */
+void server_workers_unlock(void)
+{
+    pthread_mutex_unlock(&Server_Stack_Mutex);
+}
+
+/**
+ * @brief Get the number of worker threads that are running
+ * @return number of worker threads, or 0 if not running
+ */
+unsigned server_workers_count(void)
+{
+    return Server_Workers_Count;
+}
+
+/**
+ * @brief Select the worker for a peer, so that every request from
+ *  the peer is handled by the same worker in the order received
+ * @param src - source address of the request
+ * @return index of the worker
+ */
+static unsigned server_workers_select(const BACNET_ADDRESS *src)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned i;
+
+    for (i = 0; (i < src->mac_len) && (i < MAX_MAC_LEN); i++) {
+        hash = (hash ^ src->mac[i]) * 16777619UL;
+    }
+    hash = (hash ^ (src->net & 0xFF)) * 16777619UL;
+    hash = (hash ^ (src->net >> 8)) * 16777619UL;
+    for (i = 0; (i < src->len) && (i < MAX_MAC_LEN); i++) {
+        hash = (hash ^ src->adr[i]) * 16777619UL;
+    }
+
+    return hash % Server_Workers_Count;
+}
+
+/**
+ * @brief Queue a confirmed request to the worker for its peer. When the
+ *  queue of the worker is full, wait for it to make room so that the
+ *  requests back up into the datalink rather than being dropped.
+ * @param src - source address of the request
+ * @param pdu - the NPDU of the request
+ * @param pdu_len - number of bytes in the NPDU
+ * @return true if the request was queued
+ */
+static bool server_workers_dispatch(
+    const BACNET_ADDRESS *src, const uint8_t *pdu, uint16_t pdu_len)
+{
+    struct server_worker *worker;
+    struct server_worker_message *message;
+    bool status = false;
+
+    worker = &Server_Workers[server_workers_select(src)];
+    pthread_mutex_lock(&worker->mutex);
+    while ((worker->count >= SERVER_WORKERS_QUEUE_SIZE) &&
+        !Server_Workers_Stop) {
+        pthread_cond_wait(&worker->space, &worker->mutex);
+    }
+    if (!Server_Workers_Stop) {
+        message = &worker->queue[(worker->head + worker->count) %
+            SERVER_WORKERS_QUEUE_SIZE];
+        message->src = *src;
+        message->pdu_len = pdu_len;
+        memcpy(message->pdu, pdu, pdu_len);
+        worker->count++;
+        pthread_cond_signal(&worker->cond);
+        status = true;
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    return status;
+}
+
+/**
+ * @brief Worker thread which handles the queued confirmed requests
+ * @param arg - the worker
+ * @return NULL
+ */
+static void *server_workers_thread(void *arg)
+{
+    struct server_worker *worker = arg;
+    struct server_worker_message *message;
+
+    pthread_mutex_lock(&worker->mutex);
+    for (;;) {
+        while ((worker->count == 0) && !Server_Workers_Stop) {
+            pthread_cond_wait(&worker->cond, &worker->mutex);
+        }
+        if (Server_Workers_Stop) {
+            break;
+        }
+        /* the receive loop only appends, so the head message is ours
+           while the worker mutex is released */
+        message = &worker->queue[worker->head];
+        pthread_mutex_unlock(&worker->mutex);
+        pthread_mutex_lock(&Server_Stack_Mutex);
+        npdu_handler(&message->src, message->pdu, message->pdu_len);
+        pthread_mutex_unlock(&Server_Stack_Mutex);
+        pthread_mutex_lock(&worker->mutex);
+        worker->head = (worker->head + 1) % SERVER_WORKERS_QUEUE_SIZE;
+        worker->count--;
+        pthread_cond_signal(&worker->space);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief Wait for the datalink to become readable, without the stack lock
+ * @param timeout - number of milliseconds to wait
+ */
+static void server_workers_wait(unsigned timeout)
+{
+    struct pollfd fds[BACNET_DATALINK_SOCKETS_MAX];
+    int sockets[BACNET_DATALINK_SOCKETS_MAX];
+    unsigned i, count;
+
+    count = datalink_sockets(sockets, BACNET_DATALINK_SOCKETS_MAX);
+    for (i = 0; i < count; i++) {
+        fds[i].fd = sockets[i];
+        fds[i].events = POLLIN;
+    }
+    /* with no descriptor to wait on, sleep and then poll the datalink */
+    (void)poll(count ? fds : NULL, (nfds_t)count, (int)timeout);
+}
+
+/**
+ * @brief Receive from the datalink and dispatch the messages. Confirmed
+ *  requests are queued to the workers, and any other message is handled
+ *  while holding the stack lock. At most one queue worth of messages
+ *  is received per call so that the caller can run its tasks.
+ * @param timeout - number of milliseconds to wait for a message
+ */
+void server_workers_receive(unsigned timeout)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint16_t pdu_len = 0;
+    unsigned i;
+
+    for (i = 0; i < SERVER_WORKERS_QUEUE_SIZE; i++) {
+        pthread_mutex_lock(&Server_Stack_Mutex);
+        pdu_len = datalink_receive(&src, &Server_Rx_Buf[0], MAX_MPDU, 0);
+        if (pdu_len && !npdu_confirmed_service(&Server_Rx_Buf[0], pdu_len)) {
+            npdu_handler(&src, &Server_Rx_Buf[0], pdu_len);
+            pdu_len = 0;
+        } else if (pdu_len == 0) {
+            pthread_mutex_unlock(&Server_Stack_Mutex);
+            /* nothing more to receive, so wait for the datalink */
+            server_workers_wait(timeout);
+            break;
+        }
+        pthread_mutex_unlock(&Server_Stack_Mutex);
+        if (pdu_len) {
+            (void)server_workers_dispatch(&src, &Server_Rx_Buf[0], pdu_len);
+        }
+    }
+}
+
+/**
+ * @brief Start the worker threads
+ * @param count - number of worker threads, up to SERVER_WORKERS_MAX
+ * @return true if the worker threads were started
+ */
+bool server_workers_init(unsigned count)
+{
+    struct server_worker *worker;
+    unsigned i;
+
+    if ((count == 0) || (Server_Workers_Count > 0)) {
+        return false;
+    }
+    if (count > SERVER_WORKERS_MAX) {
+        count = SERVER_WORKERS_MAX;
+    }
+    Server_Workers_Stop = false;
+    for (i = 0; i < count; i++) {
+        worker = &Server_Workers[i];
+        worker->head = 0;
+        worker->count = 0;
+        pthread_mutex_init(&worker->mutex, NULL);
+        pthread_cond_init(&worker->cond, NULL);
+        pthread_cond_init(&worker->space, NULL);
+        if (pthread_create(
+                &worker->thread, NULL, server_workers_thread, worker) != 0) {
+            pthread_cond_destroy(&worker->space);
+            pthread_cond_destroy(&worker->cond);
+            pthread_mutex_destroy(&worker->mutex);
+            break;
+        }
+        Server_Workers_Count++;
+    }
+    if (Server_Workers_Count < count) {
+        server_workers_cleanup();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Stop the worker threads. Any queued requests are discarded.
+ */
+void server_workers_cleanup(void)
+{
+    struct server_worker *worker;
+    unsigned i;
+
+    Server_Workers_Stop = true;
+    for (i = 0; i < Server_Workers_Count; i++) {
+        worker = &Server_Workers[i];
+        pthread_mutex_lock(&worker->mutex);
+        pthread_cond_signal(&worker->cond);
+        pthread_cond_broadcast(&worker->space);
+        pthread_mutex_unlock(&worker->mutex);
+    }
+    for (i = 0; i < Server_Workers_Count; i++) {
+        worker = &Server_Workers[i];
+        pthread_join(worker->thread, NULL);
+        pthread_cond_destroy(&worker->space);
+        pthread_cond_destroy(&worker->cond);
+        pthread_mutex_destroy(&worker->mutex);
+    }
+    Server_Workers_Count = 0;
+}
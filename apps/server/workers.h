@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief Worker thread pool for the BACnet server demo. Confirmed requests
+ * are handed to a pool of worker threads, with the requests from each peer
+ * pinned to one worker so that they are handled in the order received.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef SERVER_WORKERS_H
+#define SERVER_WORKERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** maximum number of worker threads */
+#ifndef SERVER_WORKERS_MAX
+#define SERVER_WORKERS_MAX 16
+#endif
+/** number of messages that can wait for each worker thread */
+#ifndef SERVER_WORKERS_QUEUE_SIZE
+#define SERVER_WORKERS_QUEUE_SIZE 32
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+bool server_workers_init(unsigned count);
+void server_workers_cleanup(void);
+unsigned server_workers_count(void);
+void server_workers_receive(unsigned timeout);
+void server_workers_lock(void);
+void server_workers_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
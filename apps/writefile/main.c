@@ -24,6 +24,7 @@
 #include "bacnet/whois.h"
 /* some demo stuff needed */
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/client/bac-file.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/filename.h"
 #include "bacnet/basic/services.h"
@@ -42,9 +43,8 @@ static uint32_t Target_File_Requested_Octet_Count;
 static uint8_t Target_File_Requested_Octet_Pad_Byte;
 static BACNET_ADDRESS Target_Address;
 static char *Local_File_Name = NULL;
-static bool End_Of_File_Detected = false;
+static unsigned Target_File_Window = 4;
 static bool Error_Detected = false;
-static uint8_t Current_Invoke_ID = 0;
 
 static void Atomic_Write_File_Error_Handler(BACNET_ADDRESS *src,
     uint8_t invoke_id,
@@ -52,7 +52,7 @@ static void Atomic_Write_File_Error_Handler(BACNET_ADDRESS *src,
     BACNET_ERROR_CODE error_code)
 {
     if (address_match(&Target_Address, src) &&
-        (invoke_id == Current_Invoke_ID)) {
+        bacnet_file_transfer_error(invoke_id)) {
         printf("\r\nBACnet Error!\r\n");
         printf("Error Class: %s\r\n", bactext_error_class_name(error_class));
         printf("Error Code: %s\r\n", bactext_error_code_name(error_code));
@@ -65,10 +65,10 @@ static void MyAbortHandler(
 {
     (void)server;
     if (address_match(&Target_Address, src) &&
-        (invoke_id == Current_Invoke_ID)) {
+        bacnet_file_transfer_abort(invoke_id)) {
+        /* the chunk is sent again */
         printf("BACnet Abort: %s\r\n",
             bactext_abort_reason_name((int)abort_reason));
-        Error_Detected = true;
     }
 }
 
@@ -76,7 +76,7 @@ static void MyRejectHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
 {
     if (address_match(&Target_Address, src) &&
-        (invoke_id == Current_Invoke_ID)) {
+        bacnet_file_transfer_error(invoke_id)) {
         printf("BACnet Reject: %s\r\n",
             bactext_reject_reason_name((int)reject_reason));
         Error_Detected = true;
@@ -136,27 +136,47 @@ int main(int argc, char *argv[])
     time_t last_seconds = 0;
     time_t current_seconds = 0;
     time_t timeout_seconds = 0;
-    int fileStartPosition = 0;
+    time_t start_seconds = 0;
     unsigned requestedOctetCount = 0;
-    uint8_t invoke_id = 0;
     bool found = false;
-    uint16_t my_max_apdu = 0;
+    bool started = false;
     FILE *pFile = NULL;
-    static BACNET_OCTET_STRING fileData;
-    size_t len = 0;
-    bool pad_byte = false;
+    int pad_byte = -1;
+    uint32_t octets = 0;
+    uint32_t last_octets = 0;
+    unsigned long seconds = 0;
+    int argi = 0;
+    int target_args = 0;
 
-    if (argc < 4) {
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--window") == 0) {
+            if (++argi < argc) {
+                Target_File_Window = strtoul(argv[argi], NULL, 0);
+            }
+            continue;
+        }
+        /* decode the command line parameters */
+        if (target_args == 0) {
+            Target_Device_Object_Instance = strtol(argv[argi], NULL, 0);
+        } else if (target_args == 1) {
+            Target_File_Object_Instance = strtol(argv[argi], NULL, 0);
+        } else if (target_args == 2) {
+            Local_File_Name = argv[argi];
+        } else if (target_args == 3) {
+            Target_File_Requested_Octet_Count = strtol(argv[argi], NULL, 0);
+        } else if (target_args == 4) {
+            Target_File_Requested_Octet_Pad_Byte = strtol(argv[argi], NULL, 0);
+            pad_byte = Target_File_Requested_Octet_Pad_Byte;
+        }
+        target_args++;
+    }
+    if (target_args < 3) {
         /* FIXME: what about access method - record or stream? */
         printf("%s device-instance file-instance local-name [octet count] [pad "
-               "value]\r\n",
+               "value] [--window N]\r\n",
             filename_remove_path(argv[0]));
         return 0;
     }
-    /* decode the command line parameters */
-    Target_Device_Object_Instance = strtol(argv[1], NULL, 0);
-    Target_File_Object_Instance = strtol(argv[2], NULL, 0);
-    Local_File_Name = argv[3];
     if (Target_Device_Object_Instance > BACNET_MAX_INSTANCE) {
         fprintf(stderr, "device-instance=%u - not greater than %u\r\n",
             Target_Device_Object_Instance, BACNET_MAX_INSTANCE);
@@ -167,12 +187,16 @@ int main(int argc, char *argv[])
             Target_File_Object_Instance, BACNET_MAX_INSTANCE);
         return 1;
     }
-    if (argc > 4) {
-        Target_File_Requested_Octet_Count = strtol(argv[4], NULL, 0);
+    if ((Target_File_Window == 0) ||
+        (Target_File_Window > BACNET_FILE_TRANSFER_WINDOW_MAX)) {
+        fprintf(stderr, "window=%u - not 1 to %u\r\n", Target_File_Window,
+            (unsigned)BACNET_FILE_TRANSFER_WINDOW_MAX);
+        return 1;
     }
-    if (argc > 5) {
-        Target_File_Requested_Octet_Pad_Byte = strtol(argv[5], NULL, 0);
-        pad_byte = true;
+    pFile = fopen(Local_File_Name, "rb");
+    if (!pFile) {
+        fprintf(stderr, "Unable to open file \"%s\".\r\n", Local_File_Name);
+        return 1;
     }
     /* setup my info */
     Device_Set_Object_Instance_Number(BACNET_MAX_INSTANCE);
@@ -213,70 +237,36 @@ int main(int argc, char *argv[])
                 Target_Device_Object_Instance, &max_apdu, &Target_Address);
         }
         if (found) {
-            if (Target_File_Requested_Octet_Count) {
-                requestedOctetCount = Target_File_Requested_Octet_Count;
-            } else {
-                /* calculate the smaller of our APDU size or theirs
-                   and remove the overhead of the APDU (varies depending on
-                   size). note: we could fail if there is a bottle neck (router)
-                   and smaller MPDU in betweeen. */
-                if (max_apdu < MAX_APDU) {
-                    my_max_apdu = max_apdu;
+            if (!started) {
+                if (Target_File_Requested_Octet_Count) {
+                    requestedOctetCount = Target_File_Requested_Octet_Count;
                 } else {
-                    my_max_apdu = MAX_APDU;
+                    /* we'll send the file in chunks
+                       less than max_apdu to keep unsegmented */
+                    requestedOctetCount =
+                        bacnet_file_transfer_chunk_size(max_apdu, true);
                 }
-                /* Typical sizes are 50, 128, 206, 480, 1024, and 1476 octets */
-                if (my_max_apdu <= 50) {
-                    requestedOctetCount = my_max_apdu - 19;
-                } else if (my_max_apdu <= 480) {
-                    requestedOctetCount = my_max_apdu - 32;
-                } else if (my_max_apdu <= 1476) {
-                    requestedOctetCount = my_max_apdu - 64;
-                } else {
-                    requestedOctetCount = my_max_apdu / 2;
-                }
-            }
-            /* has the previous invoke id expired or returned?
-               note: invoke ID = 0 is invalid, so it will be idle */
-            if ((invoke_id == 0) || tsm_invoke_id_free(invoke_id)) {
-                if (End_Of_File_Detected || Error_Detected) {
-                    printf("\r\n");
+                started = bacnet_file_transfer_write_start(
+                    Target_Device_Object_Instance, Target_File_Object_Instance,
+                    pFile, requestedOctetCount, Target_File_Window, pad_byte);
+                if (!started) {
+                    Error_Detected = true;
                     break;
                 }
-                if (invoke_id != 0) {
-                    fileStartPosition += requestedOctetCount;
-                }
-                /* we'll read the file in chunks
-                   less than max_apdu to keep unsegmented */
-                pFile = fopen(Local_File_Name, "rb");
-                if (pFile) {
-                    (void)fseek(pFile, fileStartPosition, SEEK_SET);
-                    len = fread(octetstring_value(&fileData), 1,
-                        requestedOctetCount, pFile);
-                    if (len < requestedOctetCount) {
-                        End_Of_File_Detected = true;
-                        if (pad_byte) {
-                            memset(octetstring_value(&fileData) + len + 1,
-                                (int)Target_File_Requested_Octet_Pad_Byte,
-                                requestedOctetCount - len);
-                            len = requestedOctetCount;
-                        }
-                    }
-                    octetstring_truncate(&fileData, len);
-                    fclose(pFile);
-                } else {
-                    End_Of_File_Detected = true;
+                start_seconds = current_seconds;
+            }
+            bacnet_file_transfer_task();
+            octets = bacnet_file_transfer_octets();
+            if (octets != last_octets) {
+                printf("\rSent %lu bytes", (unsigned long)octets);
+                fflush(stdout);
+                last_octets = octets;
+            }
+            if (!bacnet_file_transfer_busy()) {
+                if (bacnet_file_transfer_failed()) {
+                    fprintf(stderr, "\rError: file transfer failed!\r\n");
+                    Error_Detected = true;
                 }
-                printf("\rSending %d bytes", (int)(fileStartPosition + len));
-                invoke_id = Send_Atomic_Write_File_Stream(
-                    Target_Device_Object_Instance, Target_File_Object_Instance,
-                    fileStartPosition, &fileData);
-                Current_Invoke_ID = invoke_id;
-            } else if (tsm_invoke_id_failed(invoke_id)) {
-                fprintf(stderr, "\rError: TSM Timeout!\r\n");
-                tsm_free_invoke_id(invoke_id);
-                Error_Detected = true;
-                /* try again or abort? */
                 break;
             }
         } else {
@@ -291,7 +281,13 @@ int main(int argc, char *argv[])
         /* keep track of time for next check */
         last_seconds = current_seconds;
     }
-
+    fclose(pFile);
+    if (started) {
+        seconds = (unsigned long)(time(NULL) - start_seconds);
+        printf("\r\n%lu bytes in %lu seconds (%lu bytes/second)\r\n",
+            (unsigned long)octets, seconds,
+            seconds ? ((unsigned long)octets / seconds) : octets);
+    }
     if (Error_Detected) {
         return 1;
     }
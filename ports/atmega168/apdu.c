@@ -109,6 +109,15 @@ uint16_t apdu_decode_confirmed_service_request(uint8_t *apdu, /* APDU data */
     return len;
 }
 
+/* the requests are checked for the DCC state by apdu_handler() */
+bool apdu_dcc_npdu_discard(const uint8_t *npdu, uint16_t npdu_len)
+{
+    (void)npdu;
+    (void)npdu_len;
+
+    return false;
+}
+
 void apdu_handler(BACNET_ADDRESS *src,
     uint8_t *apdu, /* APDU data */
     uint16_t apdu_len)
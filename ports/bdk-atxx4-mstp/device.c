@@ -57,7 +57,7 @@ static const char *BACnet_Version = BACNET_VERSION_TEXT;
 int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata);
 bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
 
-static struct my_object_functions {
+static const struct my_object_functions {
     BACNET_OBJECT_TYPE Object_Type;
     object_init_function Object_Init;
     object_count_function Object_Count;
@@ -122,10 +122,10 @@ static const int Device_Properties_Optional[] = { PROP_MAX_MASTER,
 
 static const int Device_Properties_Proprietary[] = { 512, 513, 9600, -1 };
 
-static struct my_object_functions *Device_Objects_Find_Functions(
+static const struct my_object_functions *Device_Objects_Find_Functions(
     BACNET_OBJECT_TYPE Object_Type)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     pObject = &Object_Table[0];
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
@@ -145,7 +145,7 @@ static struct my_object_functions *Device_Objects_Find_Functions(
 int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 {
     int apdu_len = BACNET_STATUS_ERROR;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 #if (BACNET_PROTOCOL_REVISION >= 14)
     struct special_property_list_t property_list;
 #endif
@@ -180,7 +180,7 @@ int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
     bool status = false;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* initialize the default return values */
     pObject = Device_Objects_Find_Functions(wp_data->object_type);
@@ -224,7 +224,7 @@ void Device_Objects_Property_List(BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     struct special_property_list_t *pPropertyList)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     (void)object_instance;
     pPropertyList->Required.pList = NULL;
@@ -404,7 +404,7 @@ BACNET_REINITIALIZED_STATE Device_Reinitialized_State(void)
 
 void Device_Init(object_functions_t *object_table)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* we don't use the object table passed in
        since there is extra stuff we don't need in there. */
@@ -489,7 +489,7 @@ void Device_Inc_Database_Revision(void)
 unsigned Device_Object_List_Count(void)
 {
     unsigned count = 0; /* number of objects */
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* initialize the default return values */
     pObject = &Object_Table[0];
@@ -509,7 +509,7 @@ bool Device_Object_List_Identifier(
     bool status = false;
     uint32_t count = 0;
     uint32_t object_index = 0;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* array index zero is length - so invalid */
     if (array_index == 0) {
@@ -578,7 +578,7 @@ bool Device_Valid_Object_Name(BACNET_CHARACTER_STRING *object_name1,
     uint32_t max_objects = 0, i = 0;
     bool check_id = false;
     BACNET_CHARACTER_STRING object_name2;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     max_objects = Device_Object_List_Count();
     for (i = 1; i <= max_objects; i++) {
@@ -607,7 +607,7 @@ bool Device_Valid_Object_Id(
     BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
 {
     bool status = false; /* return value */
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     pObject = Device_Objects_Find_Functions((BACNET_OBJECT_TYPE)object_type);
     if ((pObject != NULL) && (pObject->Object_Valid_Instance != NULL)) {
@@ -621,7 +621,7 @@ bool Device_Object_Name_Copy(BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     BACNET_CHARACTER_STRING *object_name)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
     bool found = false;
 
     pObject = Device_Objects_Find_Functions(object_type);
@@ -642,7 +642,7 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     uint32_t count = 0;
     uint8_t *apdu = NULL;
     int apdu_max = 0;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     if ((rpdata->application_data == NULL) ||
         (rpdata->application_data_len == 0)) {
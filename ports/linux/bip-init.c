@@ -32,12 +32,18 @@
  -------------------------------------------
 ####COPYRIGHTEND####*/
 /* linux Ethernet/IP specific */
+#ifndef _GNU_SOURCE
+/* for recvmmsg() and sendmmsg() */
+#define _GNU_SOURCE
+#endif
 #include <asm/types.h>
 #include <netinet/ether.h>
 #include <netinet/in.h>
 #include <net/if.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <linux/filter.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <sys/types.h>
@@ -49,11 +55,14 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <poll.h>
 /* BACnet specific */
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacint.h"
 #include "bacnet/datalink/bip.h"
+#include "bacnet/datalink/dlstats.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/platform.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 #include "bacport.h"
 
@@ -63,6 +72,24 @@
 static int BIP_Socket = -1;
 static int BIP_Broadcast_Socket = -1;
 
+/* largest number of unicast sockets that share the port with SO_REUSEPORT,
+   or 1 for a single unicast socket */
+#ifndef BIP_SOCKET_SHARDS_MAX
+#define BIP_SOCKET_SHARDS_MAX 8
+#endif
+/* 1 to steer each datagram to the shard of the CPU that received it, which
+   keeps each peer on one shard while the NIC keeps its flow on one queue.
+   0 uses the hash of the source address and port done by the kernel. */
+#ifndef BIP_SOCKET_SHARDS_CPU_STEERING
+#define BIP_SOCKET_SHARDS_CPU_STEERING 1
+#endif
+/* the unicast sockets, where shard 0 is BIP_Socket */
+static int BIP_Shard_Socket[BIP_SOCKET_SHARDS_MAX];
+static unsigned BIP_Shard_Count = 1;
+static unsigned BIP_Shard_Open;
+/* the shard socket that this thread received from, to reply from it */
+static BACNET_STACK_THREAD_LOCAL int BIP_Reply_Socket = -1;
+
 /* NOTE: we store address and port in network byte order
    since BACnet/IP uses network byte order for all address byte arrays
 */
@@ -81,6 +108,63 @@ static bool BIP_Debug = false;
 /* interface name */
 static char BIP_Interface_Name[IF_NAMESIZE] = { 0 };
 
+/* number of MPDUs received with one recvmmsg() call,
+   or 0 to receive one MPDU per select() and recvfrom() */
+#ifndef BIP_RECEIVE_BATCH_SIZE
+#define BIP_RECEIVE_BATCH_SIZE 16
+#endif
+#if BIP_RECEIVE_BATCH_SIZE
+/* epoll instance watching both sockets */
+static int BIP_Epoll_Socket = -1;
+/* ring of received MPDUs, returned one per bip_receive() call */
+static uint8_t BIP_Receive_Buffer[BIP_RECEIVE_BATCH_SIZE][BIP_MPDU_MAX];
+static struct mmsghdr BIP_Receive_Msg[BIP_RECEIVE_BATCH_SIZE];
+static struct iovec BIP_Receive_Iov[BIP_RECEIVE_BATCH_SIZE];
+static struct sockaddr_in BIP_Receive_Addr[BIP_RECEIVE_BATCH_SIZE];
+static int BIP_Receive_Socket[BIP_RECEIVE_BATCH_SIZE];
+static unsigned BIP_Receive_Index;
+static unsigned BIP_Receive_Count;
+#endif
+/* receive buffer for bip_receive_buffer() when not using the ring */
+static uint8_t BIP_Receive_NPDU[BIP_MPDU_MAX];
+/* number of MPDUs sent with one sendmmsg() call */
+#ifndef BIP_SEND_BATCH_SIZE
+#define BIP_SEND_BATCH_SIZE 16
+#endif
+
+/* number of host names whose addresses are kept, so that a name, such as
+   the BBMD of each foreign device registration, is not resolved again
+   each time it is used, or zero to resolve the name each time */
+#ifndef BIP_DNS_CACHE_SIZE
+#define BIP_DNS_CACHE_SIZE 8
+#endif
+/* seconds that a resolved address is used before it is resolved again.
+   It is resolved by a thread, while the last address is still used. */
+#ifndef BIP_DNS_CACHE_SECONDS
+#define BIP_DNS_CACHE_SECONDS 300
+#endif
+/* seconds before a name that was not resolved is tried again */
+#ifndef BIP_DNS_CACHE_FAILED_SECONDS
+#define BIP_DNS_CACHE_FAILED_SECONDS 30
+#endif
+/* longest host name that is kept, and longer ones are resolved each time */
+#define BIP_DNS_NAME_MAX 128
+
+#if BIP_DNS_CACHE_SIZE
+struct bip_dns_entry {
+    char name[BIP_DNS_NAME_MAX];
+    uint8_t address[IP_ADDRESS_MAX];
+    /* the last resolution found an address */
+    bool valid;
+    /* a thread is resolving the name again */
+    bool refreshing;
+    time_t expires;
+    time_t used;
+};
+static struct bip_dns_entry BIP_DNS_Cache[BIP_DNS_CACHE_SIZE];
+static pthread_mutex_t BIP_DNS_Mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 /**
  * @brief Print the IPv4 address with debug info
  * @param str - debug info string
@@ -302,6 +386,8 @@ uint8_t bip_get_subnet_prefix(void)
 int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in bip_dest = { 0 };
+    int sock_fd = BIP_Socket;
+    int rv = 0;
 
     /* assumes that the driver has already been initialized */
     if (BIP_Socket < 0) {
@@ -318,65 +404,120 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
     /* Send the packet */
     debug_print_ipv4(
         "Sending MPDU->", &bip_dest.sin_addr, bip_dest.sin_port, mtu_len);
-    return sendto(BIP_Socket, (char *)mtu, mtu_len, 0,
-        (struct sockaddr *)&bip_dest, sizeof(struct sockaddr));
+    /* a shard thread replies from the socket it received on */
+    if (BIP_Reply_Socket >= 0) {
+        sock_fd = BIP_Reply_Socket;
+    }
+    rv = sendto(sock_fd, (char *)mtu, mtu_len, 0, (struct sockaddr *)&bip_dest,
+        sizeof(struct sockaddr));
+    if (rv < 0) {
+        datalink_stats_error(PORT_TYPE_BIP, DATALINK_STATS_TX_DROPPED);
+    } else {
+        datalink_stats_sent(PORT_TYPE_BIP, mtu_len);
+    }
+
+    return rv;
 }
 
 /**
- * BACnet/IP Datalink Receive handler.
+ * @brief Send the same MPDU to a list of destinations, using one
+ *  sendmmsg() call per batch of destinations
  *
- * @param src - returns the source address
- * @param npdu - returns the NPDU buffer
- * @param max_npdu -maximum size of the NPDU buffer
- * @param timeout - number of milliseconds to wait for a packet
+ * @param dest - array of BACNET_IP_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses in the array
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
  *
- * @return Number of bytes received, or 0 if none or timeout.
+ * @return Upon successful completion, returns the number of MPDUs sent.
+ *  Otherwise, -1 shall be returned and errno set to indicate the error.
  */
-uint16_t bip_receive(
-    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+int bip_send_mpdu_list(BACNET_IP_ADDRESS *dest,
+    unsigned dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
 {
-    uint16_t npdu_len = 0; /* return value */
-    fd_set read_fds;
-    int max = 0;
-    struct timeval select_timeout;
-    struct sockaddr_in sin = { 0 };
-    BACNET_IP_ADDRESS addr = { 0 };
-    socklen_t sin_len = sizeof(sin);
-    int received_bytes = 0;
-    int offset = 0;
-    uint16_t i = 0;
-    int socket;
+    struct sockaddr_in bip_dest[BIP_SEND_BATCH_SIZE];
+    struct mmsghdr msg[BIP_SEND_BATCH_SIZE];
+    struct iovec iov = { 0 };
+    unsigned count = 0;
+    unsigned sent = 0;
+    unsigned i = 0;
+    int rv = 0;
 
-    /* Make sure the socket is open */
+    /* assumes that the driver has already been initialized */
     if (BIP_Socket < 0) {
-        return 0;
+        if (BIP_Debug) {
+            fprintf(stderr, "BIP: driver not initialized!\n");
+            fflush(stderr);
+        }
+        return BIP_Socket;
     }
-    /* we could just use a non-blocking socket, but that consumes all
-       the CPU time.  We can use a timeout; it is only supported as
-       a select. */
-    if (timeout >= 1000) {
-        select_timeout.tv_sec = timeout / 1000;
-        select_timeout.tv_usec =
-            1000 * (timeout - select_timeout.tv_sec * 1000);
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 1000 * timeout;
+    iov.iov_base = mtu;
+    iov.iov_len = mtu_len;
+    while (sent < dest_count) {
+        count = dest_count - sent;
+        if (count > BIP_SEND_BATCH_SIZE) {
+            count = BIP_SEND_BATCH_SIZE;
+        }
+        memset(bip_dest, 0, sizeof(bip_dest));
+        memset(msg, 0, sizeof(msg));
+        for (i = 0; i < count; i++) {
+            /* load destination IP address */
+            bip_dest[i].sin_family = AF_INET;
+            memcpy(&bip_dest[i].sin_addr.s_addr, &dest[sent + i].address[0],
+                4);
+            bip_dest[i].sin_port = htons(dest[sent + i].port);
+            debug_print_ipv4("Sending MPDU->", &bip_dest[i].sin_addr,
+                bip_dest[i].sin_port, mtu_len);
+            msg[i].msg_hdr.msg_name = &bip_dest[i];
+            msg[i].msg_hdr.msg_namelen = sizeof(bip_dest[i]);
+            msg[i].msg_hdr.msg_iov = &iov;
+            msg[i].msg_hdr.msg_iovlen = 1;
+        }
+        rv = sendmmsg(BIP_Socket, msg, count, 0);
+        if (rv <= 0) {
+            for (i = sent; i < dest_count; i++) {
+                datalink_stats_error(PORT_TYPE_BIP, DATALINK_STATS_TX_DROPPED);
+            }
+            return sent ? (int)sent : -1;
+        }
+        for (i = 0; i < (unsigned)rv; i++) {
+            datalink_stats_sent(PORT_TYPE_BIP, mtu_len);
+        }
+        sent += rv;
     }
-    FD_ZERO(&read_fds);
-    FD_SET(BIP_Socket, &read_fds);
-    FD_SET(BIP_Broadcast_Socket, &read_fds);
 
-    max = BIP_Socket > BIP_Broadcast_Socket ? BIP_Socket : BIP_Broadcast_Socket;
+    return (int)sent;
+}
+
+/**
+ * @brief Validate a received MPDU and pass it through the BVLC handlers.
+ *  The MPDU is decoded in place, and the NPDU is left in the buffer
+ *  after the BVLC header.
+ *
+ * @param src - returns the source address
+ * @param npdu - the received MPDU
+ * @param max_npdu - maximum size of the NPDU buffer
+ * @param received_bytes - number of bytes received into the NPDU buffer
+ * @param socket - the socket the MPDU was received on
+ * @param sin - the source IP address and UDP port of the MPDU
+ * @param npdu_offset - returns the offset of the NPDU in the buffer
+ *
+ * @return Number of bytes in the NPDU, or 0 if none.
+ */
+static uint16_t bip_receive_mpdu(BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t max_npdu,
+    int received_bytes,
+    int socket,
+    struct sockaddr_in *sin,
+    uint16_t *npdu_offset)
+{
+    uint16_t npdu_len = 0; /* return value */
+    BACNET_IP_ADDRESS addr = { 0 };
+    int offset = 0;
+    int max = 0;
 
-    /* see if there is a packet for us */
-    if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
-        socket = FD_ISSET(BIP_Socket, &read_fds) ? BIP_Socket :
-            BIP_Broadcast_Socket;
-        received_bytes = recvfrom(socket, (char *)&npdu[0], max_npdu, 0,
-            (struct sockaddr *)&sin, &sin_len);
-    } else {
-        return 0;
-    }
     /* See if there is a problem */
     if (received_bytes < 0) {
         return 0;
@@ -385,8 +526,10 @@ uint16_t bip_receive(
     if (received_bytes == 0) {
         return 0;
     }
+    datalink_stats_received(PORT_TYPE_BIP, (uint32_t)received_bytes);
     /* the signature of a BACnet/IPv packet */
     if (npdu[0] != BVLL_TYPE_BACNET_IP) {
+        datalink_stats_error(PORT_TYPE_BIP, DATALINK_STATS_RX_DROPPED);
         return 0;
     }
     /* Erase up to 16 bytes after the received bytes as safety margin to
@@ -405,12 +548,12 @@ uint16_t bip_receive(
        shall be transmitted with the most significant octet first). This
        address shall be referred to as a B/IPv4 address.
     */
-    memcpy(&addr.address[0], &sin.sin_addr.s_addr, 4);
-    addr.port = ntohs(sin.sin_port);
+    memcpy(&addr.address[0], &sin->sin_addr.s_addr, 4);
+    addr.port = ntohs(sin->sin_port);
     debug_print_ipv4(
-        "Received MPDU->", &sin.sin_addr, sin.sin_port, received_bytes);
+        "Received MPDU->", &sin->sin_addr, sin->sin_port, received_bytes);
     /* pass the packet into the BBMD handler */
-    if (socket == BIP_Socket) {
+    if (socket != BIP_Broadcast_Socket) {
         offset = bvlc_handler(&addr, src, npdu, received_bytes);
     } else {
         offset = bvlc_broadcast_handler(&addr, src, npdu, received_bytes);
@@ -418,17 +561,15 @@ uint16_t bip_receive(
     if (offset > 0) {
         npdu_len = received_bytes - offset;
         debug_print_ipv4(
-            "Received NPDU->", &sin.sin_addr, sin.sin_port, npdu_len);
+            "Received NPDU->", &sin->sin_addr, sin->sin_port, npdu_len);
         if (npdu_len <= max_npdu) {
-            /* shift the buffer to return a valid NPDU */
-            for (i = 0; i < npdu_len; i++) {
-                npdu[i] = npdu[offset + i];
-            }
+            *npdu_offset = (uint16_t)offset;
         } else {
             if (BIP_Debug) {
                 fprintf(stderr, "BIP: NPDU dropped!\n");
                 fflush(stderr);
             }
+            datalink_stats_error(PORT_TYPE_BIP, DATALINK_STATS_OVERSIZE_FRAME);
             npdu_len = 0;
         }
     }
@@ -436,6 +577,307 @@ uint16_t bip_receive(
     return npdu_len;
 }
 
+/**
+ * @brief Receive one MPDU using select() and recvfrom()
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+static uint16_t bip_receive_select(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    fd_set read_fds;
+    int max = 0;
+    struct timeval select_timeout;
+    struct sockaddr_in sin = { 0 };
+    socklen_t sin_len = sizeof(sin);
+    int received_bytes = 0;
+    uint16_t npdu_len = 0;
+    uint16_t offset = 0;
+    int socket;
+    unsigned i;
+
+    /* we could just use a non-blocking socket, but that consumes all
+       the CPU time.  We can use a timeout; it is only supported as
+       a select. */
+    if (timeout >= 1000) {
+        select_timeout.tv_sec = timeout / 1000;
+        select_timeout.tv_usec =
+            1000 * (timeout - select_timeout.tv_sec * 1000);
+    } else {
+        select_timeout.tv_sec = 0;
+        select_timeout.tv_usec = 1000 * timeout;
+    }
+    FD_ZERO(&read_fds);
+    FD_SET(BIP_Broadcast_Socket, &read_fds);
+    max = BIP_Broadcast_Socket;
+    for (i = 0; i < BIP_Shard_Count; i++) {
+        FD_SET(BIP_Shard_Socket[i], &read_fds);
+        if (BIP_Shard_Socket[i] > max) {
+            max = BIP_Shard_Socket[i];
+        }
+    }
+
+    /* see if there is a packet for us */
+    if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
+        socket = BIP_Broadcast_Socket;
+        for (i = 0; i < BIP_Shard_Count; i++) {
+            if (FD_ISSET(BIP_Shard_Socket[i], &read_fds)) {
+                socket = BIP_Shard_Socket[i];
+                break;
+            }
+        }
+        received_bytes = recvfrom(socket, (char *)&npdu[0], max_npdu, 0,
+            (struct sockaddr *)&sin, &sin_len);
+    } else {
+        return 0;
+    }
+
+    npdu_len = bip_receive_mpdu(
+        src, npdu, max_npdu, received_bytes, socket, &sin, &offset);
+    if (npdu_len > 0) {
+        /* shift the buffer to return a valid NPDU */
+        memmove(&npdu[0], &npdu[offset], npdu_len);
+    }
+
+    return npdu_len;
+}
+
+#if BIP_RECEIVE_BATCH_SIZE
+/**
+ * @brief Fill the receive ring with a batch of MPDUs from each socket
+ *  that is ready, using one recvmmsg() call per socket
+ *
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return number of MPDUs in the receive ring
+ */
+static unsigned bip_receive_batch(unsigned timeout)
+{
+    struct epoll_event events[BIP_SOCKET_SHARDS_MAX + 1];
+    int nfds = 0;
+    int n = 0;
+    int i = 0;
+    unsigned j = 0;
+    unsigned count = 0;
+
+    BIP_Receive_Index = 0;
+    BIP_Receive_Count = 0;
+    nfds = epoll_wait(BIP_Epoll_Socket, events, BIP_Shard_Count + 1,
+        (int)timeout);
+    for (i = 0; i < nfds; i++) {
+        if (!(events[i].events & EPOLLIN)) {
+            continue;
+        }
+        for (j = count; j < BIP_RECEIVE_BATCH_SIZE; j++) {
+            BIP_Receive_Iov[j].iov_base = &BIP_Receive_Buffer[j][0];
+            BIP_Receive_Iov[j].iov_len = sizeof(BIP_Receive_Buffer[j]);
+            memset(&BIP_Receive_Msg[j], 0, sizeof(BIP_Receive_Msg[j]));
+            BIP_Receive_Msg[j].msg_hdr.msg_iov = &BIP_Receive_Iov[j];
+            BIP_Receive_Msg[j].msg_hdr.msg_iovlen = 1;
+            BIP_Receive_Msg[j].msg_hdr.msg_name = &BIP_Receive_Addr[j];
+            BIP_Receive_Msg[j].msg_hdr.msg_namelen =
+                sizeof(BIP_Receive_Addr[j]);
+        }
+        n = recvmmsg(events[i].data.fd, &BIP_Receive_Msg[count],
+            BIP_RECEIVE_BATCH_SIZE - count, MSG_DONTWAIT, NULL);
+        for (j = 0; (n > 0) && (j < (unsigned)n); j++) {
+            BIP_Receive_Socket[count + j] = events[i].data.fd;
+        }
+        if (n > 0) {
+            count += n;
+        }
+        if (count >= BIP_RECEIVE_BATCH_SIZE) {
+            break;
+        }
+    }
+    BIP_Receive_Count = count;
+
+    return count;
+}
+#endif
+
+/**
+ * @brief BACnet/IP Datalink Receive handler, returning the NPDU in place
+ *  in a receive buffer owned by the datalink.  The NPDU is only valid
+ *  until the next call to bip_receive_buffer() or bip_receive().
+ *
+ * @param src - returns the source address
+ * @param npdu - returns a pointer to the NPDU in the receive buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes in the NPDU, or 0 if none or timeout.
+ */
+uint16_t bip_receive_buffer(
+    BACNET_ADDRESS *src, uint8_t **npdu, unsigned timeout)
+{
+    uint16_t npdu_len = 0;
+#if BIP_RECEIVE_BATCH_SIZE
+    uint16_t offset = 0;
+    unsigned i = 0;
+#endif
+
+    /* Make sure the socket is open */
+    if (BIP_Socket < 0) {
+        return 0;
+    }
+#if BIP_RECEIVE_BATCH_SIZE
+    if (BIP_Epoll_Socket >= 0) {
+        /* return the MPDUs already received before asking for more */
+        if (BIP_Receive_Index >= BIP_Receive_Count) {
+            if (bip_receive_batch(timeout) == 0) {
+                return 0;
+            }
+        }
+        i = BIP_Receive_Index;
+        BIP_Receive_Index++;
+        npdu_len = bip_receive_mpdu(src, &BIP_Receive_Buffer[i][0],
+            sizeof(BIP_Receive_Buffer[i]), (int)BIP_Receive_Msg[i].msg_len,
+            BIP_Receive_Socket[i], &BIP_Receive_Addr[i], &offset);
+        if (npdu_len > 0) {
+            *npdu = &BIP_Receive_Buffer[i][offset];
+        }
+
+        return npdu_len;
+    }
+#endif
+    npdu_len = bip_receive_select(
+        src, &BIP_Receive_NPDU[0], sizeof(BIP_Receive_NPDU), timeout);
+    if (npdu_len > 0) {
+        *npdu = &BIP_Receive_NPDU[0];
+    }
+
+    return npdu_len;
+}
+
+/**
+ * BACnet/IP Datalink Receive handler.
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+#if BIP_RECEIVE_BATCH_SIZE
+    uint16_t npdu_len = 0;
+    uint8_t *pdu = NULL;
+#endif
+
+    /* Make sure the socket is open */
+    if (BIP_Socket < 0) {
+        return 0;
+    }
+#if BIP_RECEIVE_BATCH_SIZE
+    if (BIP_Epoll_Socket >= 0) {
+        npdu_len = bip_receive_buffer(src, &pdu, timeout);
+        if (npdu_len > max_npdu) {
+            if (BIP_Debug) {
+                fprintf(stderr, "BIP: NPDU dropped!\n");
+                fflush(stderr);
+            }
+            datalink_stats_error(PORT_TYPE_BIP, DATALINK_STATS_OVERSIZE_FRAME);
+            npdu_len = 0;
+        }
+        if (npdu_len > 0) {
+            /* copy only the NPDU into the caller buffer */
+            memcpy(npdu, pdu, npdu_len);
+        }
+
+        return npdu_len;
+    }
+#endif
+
+    return bip_receive_select(src, npdu, max_npdu, timeout);
+}
+
+/**
+ * @brief Set the number of unicast sockets that share the BACnet/IP port
+ *  with SO_REUSEPORT, so that the kernel spreads the received datagrams
+ *  over them and each one can be received on its own thread.
+ *  Call before bip_init().
+ * @param count - number of sockets, 1..BIP_SOCKET_SHARDS_MAX
+ * @return true if the number of sockets is valid
+ */
+bool bip_set_socket_shards(unsigned count)
+{
+    if ((count == 0) || (count > BIP_SOCKET_SHARDS_MAX) ||
+        (BIP_Socket >= 0)) {
+        return false;
+    }
+    BIP_Shard_Count = count;
+
+    return true;
+}
+
+/**
+ * @brief Get the number of unicast sockets that share the BACnet/IP port
+ * @return number of sockets
+ */
+unsigned bip_socket_shards(void)
+{
+    return BIP_Shard_Count;
+}
+
+/**
+ * @brief BACnet/IP Datalink Receive handler for one unicast socket shard.
+ *  Each shard may be received on its own thread, and the replies sent by
+ *  that thread with bip_send_mpdu() go out of the same socket.
+ *  Broadcasts are still received by bip_receive().
+ * @note The BVLC handler updates the BBMD tables, so the shard threads
+ *  serialize their calls when the BBMD is enabled, as they serialize the
+ *  calls of npdu_handler().
+ *
+ * @param shard - shard index, 0..bip_socket_shards() - 1
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip_receive_shard(unsigned shard,
+    BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t max_npdu,
+    unsigned timeout)
+{
+    struct pollfd fds = { 0 };
+    struct sockaddr_in sin = { 0 };
+    socklen_t sin_len = sizeof(sin);
+    int received_bytes = 0;
+    uint16_t npdu_len = 0;
+    uint16_t offset = 0;
+
+    if ((BIP_Socket < 0) || (shard >= BIP_Shard_Count)) {
+        return 0;
+    }
+    fds.fd = BIP_Shard_Socket[shard];
+    fds.events = POLLIN;
+    if (poll(&fds, 1, (int)timeout) <= 0) {
+        return 0;
+    }
+    received_bytes = recvfrom(fds.fd, (char *)&npdu[0], max_npdu, 0,
+        (struct sockaddr *)&sin, &sin_len);
+    BIP_Reply_Socket = fds.fd;
+    npdu_len = bip_receive_mpdu(
+        src, npdu, max_npdu, received_bytes, fds.fd, &sin, &offset);
+    if (npdu_len > 0) {
+        /* shift the buffer to return a valid NPDU */
+        memmove(&npdu[0], &npdu[offset], npdu_len);
+    }
+
+    return npdu_len;
+}
+
 /**
  * The common send function for BACnet/IP application layer
  *
@@ -456,32 +898,207 @@ int bip_send_pdu(BACNET_ADDRESS *dest,
     return bvlc_send_pdu(dest, npdu_data, pdu, pdu_len);
 }
 
+/**
+ * @brief Resolve a host name to its first IPv4 address
+ * @param host_name - the host name
+ * @param address - the IPv4 address, in network byte order
+ * @return true if the name was resolved
+ */
+static bool bip_dns_resolve(const char *host_name, uint8_t *address)
+{
+    struct addrinfo hints = { 0 };
+    struct addrinfo *result = NULL;
+    const struct sockaddr_in *sin;
+
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host_name, NULL, &hints, &result) != 0) {
+        return false;
+    }
+    sin = (const struct sockaddr_in *)(void *)result->ai_addr;
+    memcpy(address, &sin->sin_addr, IP_ADDRESS_MAX);
+    freeaddrinfo(result);
+
+    return true;
+}
+
+#if BIP_DNS_CACHE_SIZE
+/**
+ * @brief Get the seconds of the monotonic clock
+ * @return seconds
+ */
+static time_t bip_dns_seconds(void)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec;
+}
+
+/**
+ * @brief Keep the result of a resolution of a cached name
+ * @param entry - the cached name, with BIP_DNS_Mutex locked
+ * @param valid - true if the name was resolved
+ * @param address - the IPv4 address that was found
+ */
+static void bip_dns_entry_update(
+    struct bip_dns_entry *entry, bool valid, const uint8_t *address)
+{
+    /* keep the last address when the name server is not answering */
+    if (valid || !entry->valid) {
+        entry->valid = valid;
+        memcpy(entry->address, address, IP_ADDRESS_MAX);
+    }
+    entry->expires = bip_dns_seconds() +
+        (valid ? BIP_DNS_CACHE_SECONDS : BIP_DNS_CACHE_FAILED_SECONDS);
+}
+
+/**
+ * @brief Thread that resolves a cached name again
+ * @param arg - the cached name
+ * @return NULL
+ */
+static void *bip_dns_refresh_thread(void *arg)
+{
+    struct bip_dns_entry *entry = arg;
+    char host_name[BIP_DNS_NAME_MAX];
+    uint8_t address[IP_ADDRESS_MAX] = { 0 };
+    bool valid;
+
+    pthread_mutex_lock(&BIP_DNS_Mutex);
+    memcpy(host_name, entry->name, sizeof(host_name));
+    pthread_mutex_unlock(&BIP_DNS_Mutex);
+    valid = bip_dns_resolve(host_name, address);
+    pthread_mutex_lock(&BIP_DNS_Mutex);
+    bip_dns_entry_update(entry, valid, address);
+    entry->refreshing = false;
+    pthread_mutex_unlock(&BIP_DNS_Mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief Start a thread to resolve a cached name again
+ * @param entry - the cached name, with BIP_DNS_Mutex locked
+ */
+static void bip_dns_refresh(struct bip_dns_entry *entry)
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    if (entry->refreshing) {
+        return;
+    }
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&thread, &attr, bip_dns_refresh_thread, entry) == 0) {
+        entry->refreshing = true;
+    }
+    pthread_attr_destroy(&attr);
+}
+
+/**
+ * @brief Get the address of a host name from the cache. A stale address
+ *  is returned while a thread resolves the name again, so that only the
+ *  first use of a name waits for the name server.
+ * @param host_name - the host name
+ * @param address - the IPv4 address, in network byte order
+ * @return true if the name was resolved
+ */
+static bool bip_dns_cache_resolve(const char *host_name, uint8_t *address)
+{
+    struct bip_dns_entry *entry = NULL;
+    uint8_t resolved[IP_ADDRESS_MAX] = { 0 };
+    time_t now;
+    bool valid;
+    unsigned i;
+
+    if (strlen(host_name) >= BIP_DNS_NAME_MAX) {
+        return bip_dns_resolve(host_name, address);
+    }
+    now = bip_dns_seconds();
+    pthread_mutex_lock(&BIP_DNS_Mutex);
+    for (i = 0; i < BIP_DNS_CACHE_SIZE; i++) {
+        if (strcmp(BIP_DNS_Cache[i].name, host_name) == 0) {
+            entry = &BIP_DNS_Cache[i];
+            break;
+        }
+    }
+    if (entry) {
+        entry->used = now;
+        if (now >= entry->expires) {
+            bip_dns_refresh(entry);
+        }
+        valid = entry->valid;
+        memcpy(address, entry->address, IP_ADDRESS_MAX);
+        pthread_mutex_unlock(&BIP_DNS_Mutex);
+        return valid;
+    }
+    pthread_mutex_unlock(&BIP_DNS_Mutex);
+    valid = bip_dns_resolve(host_name, resolved);
+    memcpy(address, resolved, IP_ADDRESS_MAX);
+    pthread_mutex_lock(&BIP_DNS_Mutex);
+    /* replace the name used least recently that is not being resolved */
+    for (i = 0; i < BIP_DNS_CACHE_SIZE; i++) {
+        if (BIP_DNS_Cache[i].refreshing) {
+            continue;
+        }
+        if (BIP_DNS_Cache[i].name[0] == 0) {
+            entry = &BIP_DNS_Cache[i];
+            break;
+        }
+        if (!entry || (BIP_DNS_Cache[i].used < entry->used)) {
+            entry = &BIP_DNS_Cache[i];
+        }
+    }
+    if (entry) {
+        snprintf(entry->name, sizeof(entry->name), "%s", host_name);
+        entry->valid = false;
+        entry->used = now;
+        bip_dns_entry_update(entry, valid, resolved);
+    }
+    pthread_mutex_unlock(&BIP_DNS_Mutex);
+
+    return valid;
+}
+#endif
+
 /**
  * @brief gets an IP address by hostname (or string of numbers)
  *
  * gets an IP address by name, where name can be a string that is an
- * IP address in dotted form, or a name that is a domain name
+ * IP address in dotted form, or a name that is a domain name.
+ * The addresses of names are cached, and resolved again by a thread
+ * when they are stale, so only the first use of a name waits for the
+ * name server.
  *
  * @param host_name - the host name
  * @return true if the address was retrieved
  */
 bool bip_get_addr_by_name(const char *host_name, BACNET_IP_ADDRESS *addr)
 {
-    struct hostent *host_ent;
+    uint8_t address[IP_ADDRESS_MAX] = { 0 };
+    bool status;
 
-    if ((host_ent = gethostbyname(host_name)) == NULL) {
+    if (!host_name) {
         return false;
     }
-
-    if (addr) {
-        /* Host addresses in a struct hostent structure are always
-           given in network byte order */
-        /* h_addr: This is a synonym for h_addr_list[0];
-           in other words, it is the first host address.*/
-        memcpy(&addr->address[0], host_ent->h_addr, 4);
+    if (inet_pton(AF_INET, host_name, address) == 1) {
+        status = true;
+    } else {
+#if BIP_DNS_CACHE_SIZE
+        status = bip_dns_cache_resolve(host_name, address);
+#else
+        status = bip_dns_resolve(host_name, address);
+#endif
+    }
+    if (status && addr) {
+        /* in network byte order */
+        memcpy(&addr->address[0], address, IP_ADDRESS_MAX);
     }
 
-    return true;
+    return status;
 }
 
 /**
@@ -830,7 +1447,13 @@ void bip_set_interface(char *ifname)
     }
 }
 
-static int createSocket(struct sockaddr_in *sin)
+/**
+ * @brief Create a UDP socket bound to an address and port
+ * @param sin - the address and port
+ * @param reuseport - true to share the port with other sockets
+ * @return the socket, or -1 on error
+ */
+static int createSocket(struct sockaddr_in *sin, bool reuseport)
 {
     int status = 0; /* return from socket lib calls */
     int sockopt = 0;
@@ -850,6 +1473,15 @@ static int createSocket(struct sockaddr_in *sin)
         close(sock_fd);
         return status;
     }
+    /* share the port with the other unicast socket shards */
+    if (reuseport) {
+        status = setsockopt(
+            sock_fd, SOL_SOCKET, SO_REUSEPORT, &sockopt, sizeof(sockopt));
+        if (status < 0) {
+            close(sock_fd);
+            return status;
+        }
+    }
     /* allow us to send a broadcast */
     status = setsockopt(
         sock_fd, SOL_SOCKET, SO_BROADCAST, &sockopt, sizeof(sockopt));
@@ -876,6 +1508,111 @@ static int createSocket(struct sockaddr_in *sin)
     return sock_fd;
 }
 
+#if BIP_RECEIVE_BATCH_SIZE
+/**
+ * @brief Create the epoll instance that watches all of the sockets.
+ *  If it fails, bip_receive() uses select() and recvfrom().
+ */
+static void bip_receive_epoll_init(void)
+{
+    struct epoll_event event = { 0 };
+    unsigned i;
+
+    if (BIP_Epoll_Socket != -1) {
+        close(BIP_Epoll_Socket);
+    }
+    BIP_Receive_Index = 0;
+    BIP_Receive_Count = 0;
+    BIP_Epoll_Socket = epoll_create1(EPOLL_CLOEXEC);
+    if (BIP_Epoll_Socket < 0) {
+        if (BIP_Debug) {
+            perror("epoll_create1: ");
+        }
+        return;
+    }
+    for (i = 0; i < BIP_Shard_Count; i++) {
+        event.events = EPOLLIN;
+        event.data.fd = BIP_Shard_Socket[i];
+        if (epoll_ctl(BIP_Epoll_Socket, EPOLL_CTL_ADD, BIP_Shard_Socket[i],
+                &event) != 0) {
+            break;
+        }
+    }
+    if (i == BIP_Shard_Count) {
+        event.events = EPOLLIN;
+        event.data.fd = BIP_Broadcast_Socket;
+        if (epoll_ctl(BIP_Epoll_Socket, EPOLL_CTL_ADD, BIP_Broadcast_Socket,
+                &event) == 0) {
+            return;
+        }
+    }
+    if (BIP_Debug) {
+        perror("epoll_ctl: ");
+    }
+    close(BIP_Epoll_Socket);
+    BIP_Epoll_Socket = -1;
+}
+#endif
+
+#if BIP_SOCKET_SHARDS_CPU_STEERING
+/**
+ * @brief Attach the program to the group of unicast sockets that steers
+ *  each datagram to the shard of the CPU that received it.
+ *  If it fails, the kernel steers with the hash of the source address.
+ * @param sock_fd - one of the sockets of the group
+ */
+static void bip_socket_shards_steering(int sock_fd)
+{
+    struct sock_filter code[] = {
+        /* A = the CPU that received the datagram */
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF + SKF_AD_CPU },
+        /* A = A % number of shards */
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, BIP_Shard_Count },
+        /* return A, the index of the socket in the group */
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_fprog prog = { 0 };
+
+    prog.len = sizeof(code) / sizeof(code[0]);
+    prog.filter = code;
+    if (setsockopt(sock_fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog,
+            sizeof(prog)) < 0) {
+        if (BIP_Debug) {
+            perror("SO_ATTACH_REUSEPORT_CBPF: ");
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Open the unicast sockets, sharing the port when there are
+ *  several shards
+ * @param sin - the unicast address and port
+ * @return true if all of the sockets are open
+ */
+static bool bip_socket_shards_init(struct sockaddr_in *sin)
+{
+    bool reuseport = (BIP_Shard_Count > 1);
+    int sock_fd = -1;
+
+    BIP_Shard_Open = 0;
+    while (BIP_Shard_Open < BIP_Shard_Count) {
+        sock_fd = createSocket(sin, reuseport);
+        if (sock_fd < 0) {
+            return false;
+        }
+        BIP_Shard_Socket[BIP_Shard_Open] = sock_fd;
+        BIP_Shard_Open++;
+    }
+#if BIP_SOCKET_SHARDS_CPU_STEERING
+    if (reuseport) {
+        bip_socket_shards_steering(BIP_Shard_Socket[0]);
+    }
+#endif
+
+    return true;
+}
+
 /** Initialize the BACnet/IP services at the given interface.
  * @ingroup DLBIP
  * -# Gets the local IP address and local broadcast address from the system,
@@ -885,6 +1622,8 @@ static int createSocket(struct sockaddr_in *sin)
  * -# Configures the socket so it can send broadcasts
  * -# Binds the socket to the local IP address at the specified port for
  *    BACnet/IP (by default, 0xBAC0 = 47808).
+ * -# Opens the other unicast sockets that share the port, when set with
+ *    bip_set_socket_shards()
  *
  * @note For Linux, ifname is eth0, ath0, arc0, and others.
  *
@@ -916,11 +1655,11 @@ bool bip_init(char *ifname)
     memset(&(sin.sin_zero), '\0', sizeof(sin.sin_zero));
 
     sin.sin_addr.s_addr = BIP_Address.s_addr;
-    sock_fd = createSocket(&sin);
-    BIP_Socket = sock_fd;
-    if (sock_fd < 0) {
+    if (!bip_socket_shards_init(&sin)) {
+        bip_cleanup();
         return false;
     }
+    BIP_Socket = BIP_Shard_Socket[0];
     if (BIP_Broadcast_Binding_Address_Override) {
         sin.sin_addr.s_addr = BIP_Broadcast_Binding_Address.s_addr;
     } else {
@@ -932,11 +1671,14 @@ bool bip_init(char *ifname)
         sin.sin_addr.s_addr = BIP_Broadcast_Addr.s_addr;
 #endif
     }
-    sock_fd = createSocket(&sin);
+    sock_fd = createSocket(&sin, false);
     BIP_Broadcast_Socket = sock_fd;
     if (sock_fd < 0) {
         return false;
     }
+#if BIP_RECEIVE_BATCH_SIZE
+    bip_receive_epoll_init();
+#endif
 
     bvlc_init();
 
@@ -957,9 +1699,12 @@ bool bip_valid(void)
  */
 void bip_cleanup(void)
 {
-    if (BIP_Socket != -1) {
-        close(BIP_Socket);
+    unsigned i;
+
+    for (i = 0; i < BIP_Shard_Open; i++) {
+        close(BIP_Shard_Socket[i]);
     }
+    BIP_Shard_Open = 0;
     BIP_Socket = -1;
 
     if (BIP_Broadcast_Socket != -1) {
@@ -967,5 +1712,14 @@ void bip_cleanup(void)
     }
     BIP_Broadcast_Socket = -1;
 
+#if BIP_RECEIVE_BATCH_SIZE
+    if (BIP_Epoll_Socket != -1) {
+        close(BIP_Epoll_Socket);
+    }
+    BIP_Epoll_Socket = -1;
+    BIP_Receive_Index = 0;
+    BIP_Receive_Count = 0;
+#endif
+
     return;
 }
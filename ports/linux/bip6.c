@@ -32,7 +32,12 @@
  -------------------------------------------
 ####COPYRIGHTEND####*/
 
+#ifndef _GNU_SOURCE
+/* for recvmmsg() and sendmmsg() */
+#define _GNU_SOURCE
+#endif
 #include <ifaddrs.h>
+#include <sys/epoll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h> /* for standard integer types uint8_t etc. */
@@ -40,6 +45,7 @@
 #include "bacnet/bacdcode.h"
 #include "bacnet/config.h"
 #include "bacnet/datalink/bip6.h"
+#include "bacnet/datalink/dlstats.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd6/h_bbmd6.h"
 #include "bacport.h"
@@ -95,6 +101,29 @@ static int BIP6_Socket_Scope_Id = 0;
 static BACNET_IP6_ADDRESS BIP6_Addr;
 static BACNET_IP6_ADDRESS BIP6_Broadcast_Addr;
 
+/* number of MPDUs received with one recvmmsg() call,
+   or 0 to receive one MPDU per select() and recvfrom() */
+#ifndef BIP6_RECEIVE_BATCH_SIZE
+#define BIP6_RECEIVE_BATCH_SIZE 16
+#endif
+#if BIP6_RECEIVE_BATCH_SIZE
+/* epoll instance watching the socket */
+static int BIP6_Epoll_Socket = -1;
+/* ring of received MPDUs, returned one per bip6_receive() call */
+static uint8_t BIP6_Receive_Buffer[BIP6_RECEIVE_BATCH_SIZE][BIP6_MPDU_MAX];
+static struct mmsghdr BIP6_Receive_Msg[BIP6_RECEIVE_BATCH_SIZE];
+static struct iovec BIP6_Receive_Iov[BIP6_RECEIVE_BATCH_SIZE];
+static struct sockaddr_in6 BIP6_Receive_Addr[BIP6_RECEIVE_BATCH_SIZE];
+static unsigned BIP6_Receive_Index;
+static unsigned BIP6_Receive_Count;
+#endif
+/* receive buffer for bip6_receive_buffer() when not using the ring */
+static uint8_t BIP6_Receive_NPDU[BIP6_MPDU_MAX];
+/* number of MPDUs sent with one sendmmsg() call */
+#ifndef BIP6_SEND_BATCH_SIZE
+#define BIP6_SEND_BATCH_SIZE 16
+#endif
+
 /**
  * Set the interface name. On Linux, ifname is the /dev/ name of the interface.
  *
@@ -153,6 +182,15 @@ void bip6_set_port(uint16_t port)
     BIP6_Broadcast_Addr.port = port;
 }
 
+/**
+ * @brief Return the active BIP6 socket.
+ * @return The active BIP6 socket, or -1 if uninitialized.
+ */
+int bip6_get_socket(void)
+{
+    return BIP6_Socket;
+}
+
 /**
  * Get the BACnet IPv6 UDP port number
  *
@@ -233,6 +271,32 @@ bool bip6_get_broadcast_addr(BACNET_IP6_ADDRESS *addr)
     return bvlc6_address_copy(addr, &BIP6_Broadcast_Addr);
 }
 
+/**
+ * @brief Convert a BACnet/IPv6 address to a socket address
+ * @param dest - BACnet/IPv6 address and UDP port
+ * @param sin6 - returns the socket address
+ */
+static void bip6_socket_address(
+    BACNET_IP6_ADDRESS *dest, struct sockaddr_in6 *sin6)
+{
+    uint16_t addr16[8];
+
+    memset(sin6, 0, sizeof(*sin6));
+    sin6->sin6_family = AF_INET6;
+    bvlc6_address_get(dest, &addr16[0], &addr16[1], &addr16[2], &addr16[3],
+        &addr16[4], &addr16[5], &addr16[6], &addr16[7]);
+    sin6->sin6_addr.s6_addr16[0] = htons(addr16[0]);
+    sin6->sin6_addr.s6_addr16[1] = htons(addr16[1]);
+    sin6->sin6_addr.s6_addr16[2] = htons(addr16[2]);
+    sin6->sin6_addr.s6_addr16[3] = htons(addr16[3]);
+    sin6->sin6_addr.s6_addr16[4] = htons(addr16[4]);
+    sin6->sin6_addr.s6_addr16[5] = htons(addr16[5]);
+    sin6->sin6_addr.s6_addr16[6] = htons(addr16[6]);
+    sin6->sin6_addr.s6_addr16[7] = htons(addr16[7]);
+    sin6->sin6_port = htons(dest->port);
+    sin6->sin6_scope_id = BIP6_Socket_Scope_Id;
+}
+
 /**
  * The send function for BACnet/IPv6 driver layer
  *
@@ -247,30 +311,88 @@ bool bip6_get_broadcast_addr(BACNET_IP6_ADDRESS *addr)
 int bip6_send_mpdu(BACNET_IP6_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in6 bvlc_dest = { 0 };
-    uint16_t addr16[8];
+    int rv = 0;
 
     /* assumes that the driver has already been initialized */
     if (BIP6_Socket < 0) {
         return 0;
     }
     /* load destination IP address */
-    bvlc_dest.sin6_family = AF_INET6;
-    bvlc6_address_get(dest, &addr16[0], &addr16[1], &addr16[2], &addr16[3],
-        &addr16[4], &addr16[5], &addr16[6], &addr16[7]);
-    bvlc_dest.sin6_addr.s6_addr16[0] = htons(addr16[0]);
-    bvlc_dest.sin6_addr.s6_addr16[1] = htons(addr16[1]);
-    bvlc_dest.sin6_addr.s6_addr16[2] = htons(addr16[2]);
-    bvlc_dest.sin6_addr.s6_addr16[3] = htons(addr16[3]);
-    bvlc_dest.sin6_addr.s6_addr16[4] = htons(addr16[4]);
-    bvlc_dest.sin6_addr.s6_addr16[5] = htons(addr16[5]);
-    bvlc_dest.sin6_addr.s6_addr16[6] = htons(addr16[6]);
-    bvlc_dest.sin6_addr.s6_addr16[7] = htons(addr16[7]);
-    bvlc_dest.sin6_port = htons(dest->port);
-    bvlc_dest.sin6_scope_id = BIP6_Socket_Scope_Id;
+    bip6_socket_address(dest, &bvlc_dest);
     debug_print_ipv6("Sending MPDU->", &bvlc_dest.sin6_addr);
     /* Send the packet */
-    return sendto(BIP6_Socket, (char *)mtu, mtu_len, 0,
+    rv = sendto(BIP6_Socket, (char *)mtu, mtu_len, 0,
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
+    if (rv < 0) {
+        datalink_stats_error(PORT_TYPE_BIP6, DATALINK_STATS_TX_DROPPED);
+    } else {
+        datalink_stats_sent(PORT_TYPE_BIP6, mtu_len);
+    }
+
+    return rv;
+}
+
+/**
+ * @brief Send the same MPDU to a list of destinations, using one
+ *  sendmmsg() call per batch of destinations
+ *
+ * @param dest - array of BACNET_IP6_ADDRESS destination addresses
+ * @param dest_count - number of destination addresses in the array
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ *
+ * @return Upon successful completion, returns the number of MPDUs sent.
+ *  Otherwise, -1 shall be returned and errno set to indicate the error.
+ */
+int bip6_send_mpdu_list(BACNET_IP6_ADDRESS *dest,
+    unsigned dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    struct sockaddr_in6 bvlc_dest[BIP6_SEND_BATCH_SIZE];
+    struct mmsghdr msg[BIP6_SEND_BATCH_SIZE];
+    struct iovec iov = { 0 };
+    unsigned count = 0;
+    unsigned sent = 0;
+    unsigned i = 0;
+    int rv = 0;
+
+    /* assumes that the driver has already been initialized */
+    if (BIP6_Socket < 0) {
+        return BIP6_Socket;
+    }
+    iov.iov_base = mtu;
+    iov.iov_len = mtu_len;
+    while (sent < dest_count) {
+        count = dest_count - sent;
+        if (count > BIP6_SEND_BATCH_SIZE) {
+            count = BIP6_SEND_BATCH_SIZE;
+        }
+        memset(msg, 0, sizeof(msg));
+        for (i = 0; i < count; i++) {
+            /* load destination IP address */
+            bip6_socket_address(&dest[sent + i], &bvlc_dest[i]);
+            debug_print_ipv6("Sending MPDU->", &bvlc_dest[i].sin6_addr);
+            msg[i].msg_hdr.msg_name = &bvlc_dest[i];
+            msg[i].msg_hdr.msg_namelen = sizeof(bvlc_dest[i]);
+            msg[i].msg_hdr.msg_iov = &iov;
+            msg[i].msg_hdr.msg_iovlen = 1;
+        }
+        rv = sendmmsg(BIP6_Socket, msg, count, 0);
+        if (rv <= 0) {
+            for (i = sent; i < dest_count; i++) {
+                datalink_stats_error(
+                    PORT_TYPE_BIP6, DATALINK_STATS_TX_DROPPED);
+            }
+            return sent ? (int)sent : -1;
+        }
+        for (i = 0; i < (unsigned)rv; i++) {
+            datalink_stats_sent(PORT_TYPE_BIP6, mtu_len);
+        }
+        sent += rv;
+    }
+
+    return (int)sent;
 }
 
 /**
@@ -294,7 +416,69 @@ int bip6_send_pdu(BACNET_ADDRESS *dest,
 }
 
 /**
- * BACnet/IP Datalink Receive handler.
+ * @brief Validate a received MPDU and pass it through the BVLC handler.
+ *  The MPDU is decoded in place, and the NPDU is left in the buffer
+ *  after the BVLC header.
+ *
+ * @param src - returns the source address
+ * @param npdu - the received MPDU
+ * @param max_npdu - maximum size of the NPDU buffer
+ * @param received_bytes - number of bytes received into the NPDU buffer
+ * @param sin - the source IPv6 address and UDP port of the MPDU
+ * @param npdu_offset - returns the offset of the NPDU in the buffer
+ *
+ * @return Number of bytes in the NPDU, or 0 if none.
+ */
+static uint16_t bip6_receive_mpdu(BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t max_npdu,
+    int received_bytes,
+    struct sockaddr_in6 *sin,
+    uint16_t *npdu_offset)
+{
+    uint16_t npdu_len = 0; /* return value */
+    BACNET_IP6_ADDRESS addr = { { 0 } };
+    int offset = 0;
+
+    /* See if there is a problem */
+    if (received_bytes < 0) {
+        return 0;
+    }
+    /* no problem, just no bytes */
+    if (received_bytes == 0) {
+        return 0;
+    }
+    datalink_stats_received(PORT_TYPE_BIP6, (uint32_t)received_bytes);
+    /* the signature of a BACnet/IPv6 packet */
+    if (npdu[0] != BVLL_TYPE_BACNET_IP6) {
+        datalink_stats_error(PORT_TYPE_BIP6, DATALINK_STATS_RX_DROPPED);
+        return 0;
+    }
+    /* pass the packet into the BBMD handler */
+    debug_print_ipv6("Received MPDU->", &sin->sin6_addr);
+    bvlc6_address_set(&addr, ntohs(sin->sin6_addr.s6_addr16[0]),
+        ntohs(sin->sin6_addr.s6_addr16[1]), ntohs(sin->sin6_addr.s6_addr16[2]),
+        ntohs(sin->sin6_addr.s6_addr16[3]), ntohs(sin->sin6_addr.s6_addr16[4]),
+        ntohs(sin->sin6_addr.s6_addr16[5]), ntohs(sin->sin6_addr.s6_addr16[6]),
+        ntohs(sin->sin6_addr.s6_addr16[7]));
+    addr.port = ntohs(sin->sin6_port);
+    offset = bvlc6_handler(&addr, src, npdu, received_bytes);
+    if (offset > 0) {
+        npdu_len = received_bytes - offset;
+        if (npdu_len <= max_npdu) {
+            *npdu_offset = (uint16_t)offset;
+        } else {
+            datalink_stats_error(
+                PORT_TYPE_BIP6, DATALINK_STATS_OVERSIZE_FRAME);
+            npdu_len = 0;
+        }
+    }
+
+    return npdu_len;
+}
+
+/**
+ * @brief Receive one MPDU using select() and recvfrom()
  *
  * @param src - returns the source address
  * @param npdu - returns the NPDU buffer
@@ -303,24 +487,18 @@ int bip6_send_pdu(BACNET_ADDRESS *dest,
  *
  * @return Number of bytes received, or 0 if none or timeout.
  */
-uint16_t bip6_receive(
+static uint16_t bip6_receive_select(
     BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
 {
-    uint16_t npdu_len = 0; /* return value */
     fd_set read_fds;
     int max = 0;
     struct timeval select_timeout;
     struct sockaddr_in6 sin = { 0 };
-    BACNET_IP6_ADDRESS addr = { { 0 } };
     socklen_t sin_len = sizeof(sin);
     int received_bytes = 0;
-    int offset = 0;
-    uint16_t i = 0;
+    uint16_t npdu_len = 0;
+    uint16_t offset = 0;
 
-    /* Make sure the socket is open */
-    if (BIP6_Socket < 0) {
-        return 0;
-    }
     /* we could just use a non-blocking socket, but that consumes all
        the CPU time.  We can use a timeout; it is only supported as
        a select. */
@@ -342,48 +520,198 @@ uint16_t bip6_receive(
     } else {
         return 0;
     }
-    /* See if there is a problem */
-    if (received_bytes < 0) {
+    npdu_len =
+        bip6_receive_mpdu(src, npdu, max_npdu, received_bytes, &sin, &offset);
+    if (npdu_len > 0) {
+        /* shift the buffer to return a valid NPDU */
+        memmove(&npdu[0], &npdu[offset], npdu_len);
+    }
+
+    return npdu_len;
+}
+
+#if BIP6_RECEIVE_BATCH_SIZE
+/**
+ * @brief Fill the receive ring with a batch of MPDUs, using one
+ *  recvmmsg() call
+ *
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return number of MPDUs in the receive ring
+ */
+static unsigned bip6_receive_batch(unsigned timeout)
+{
+    struct epoll_event event;
+    int n = 0;
+    unsigned j = 0;
+
+    BIP6_Receive_Index = 0;
+    BIP6_Receive_Count = 0;
+    if (epoll_wait(BIP6_Epoll_Socket, &event, 1, (int)timeout) <= 0) {
         return 0;
     }
-    /* no problem, just no bytes */
-    if (received_bytes == 0) {
+    if (!(event.events & EPOLLIN)) {
         return 0;
     }
-    /* the signature of a BACnet/IPv6 packet */
-    if (npdu[0] != BVLL_TYPE_BACNET_IP6) {
+    for (j = 0; j < BIP6_RECEIVE_BATCH_SIZE; j++) {
+        BIP6_Receive_Iov[j].iov_base = &BIP6_Receive_Buffer[j][0];
+        BIP6_Receive_Iov[j].iov_len = sizeof(BIP6_Receive_Buffer[j]);
+        memset(&BIP6_Receive_Msg[j], 0, sizeof(BIP6_Receive_Msg[j]));
+        BIP6_Receive_Msg[j].msg_hdr.msg_iov = &BIP6_Receive_Iov[j];
+        BIP6_Receive_Msg[j].msg_hdr.msg_iovlen = 1;
+        BIP6_Receive_Msg[j].msg_hdr.msg_name = &BIP6_Receive_Addr[j];
+        BIP6_Receive_Msg[j].msg_hdr.msg_namelen =
+            sizeof(BIP6_Receive_Addr[j]);
+    }
+    n = recvmmsg(BIP6_Socket, &BIP6_Receive_Msg[0], BIP6_RECEIVE_BATCH_SIZE,
+        MSG_DONTWAIT, NULL);
+    if (n > 0) {
+        BIP6_Receive_Count = (unsigned)n;
+    }
+
+    return BIP6_Receive_Count;
+}
+#endif
+
+/**
+ * @brief BACnet/IPv6 Datalink Receive handler, returning the NPDU in
+ *  place in a receive buffer owned by the datalink.  The NPDU is only
+ *  valid until the next call to bip6_receive_buffer() or bip6_receive().
+ *
+ * @param src - returns the source address
+ * @param npdu - returns a pointer to the NPDU in the receive buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes in the NPDU, or 0 if none or timeout.
+ */
+uint16_t bip6_receive_buffer(
+    BACNET_ADDRESS *src, uint8_t **npdu, unsigned timeout)
+{
+    uint16_t npdu_len = 0;
+#if BIP6_RECEIVE_BATCH_SIZE
+    uint16_t offset = 0;
+    unsigned i = 0;
+#endif
+
+    /* Make sure the socket is open */
+    if (BIP6_Socket < 0) {
         return 0;
     }
-    /* pass the packet into the BBMD handler */
-    debug_print_ipv6("Received MPDU->", &sin.sin6_addr);
-    bvlc6_address_set(&addr, ntohs(sin.sin6_addr.s6_addr16[0]),
-        ntohs(sin.sin6_addr.s6_addr16[1]), ntohs(sin.sin6_addr.s6_addr16[2]),
-        ntohs(sin.sin6_addr.s6_addr16[3]), ntohs(sin.sin6_addr.s6_addr16[4]),
-        ntohs(sin.sin6_addr.s6_addr16[5]), ntohs(sin.sin6_addr.s6_addr16[6]),
-        ntohs(sin.sin6_addr.s6_addr16[7]));
-    addr.port = ntohs(sin.sin6_port);
-    offset = bvlc6_handler(&addr, src, npdu, received_bytes);
-    if (offset > 0) {
-        npdu_len = received_bytes - offset;
-        if (npdu_len <= max_npdu) {
-            /* shift the buffer to return a valid NPDU */
-            for (i = 0; i < npdu_len; i++) {
-                npdu[i] = npdu[offset + i];
+#if BIP6_RECEIVE_BATCH_SIZE
+    if (BIP6_Epoll_Socket >= 0) {
+        /* return the MPDUs already received before asking for more */
+        if (BIP6_Receive_Index >= BIP6_Receive_Count) {
+            if (bip6_receive_batch(timeout) == 0) {
+                return 0;
             }
-        } else {
-            npdu_len = 0;
         }
+        i = BIP6_Receive_Index;
+        BIP6_Receive_Index++;
+        npdu_len = bip6_receive_mpdu(src, &BIP6_Receive_Buffer[i][0],
+            sizeof(BIP6_Receive_Buffer[i]), (int)BIP6_Receive_Msg[i].msg_len,
+            &BIP6_Receive_Addr[i], &offset);
+        if (npdu_len > 0) {
+            *npdu = &BIP6_Receive_Buffer[i][offset];
+        }
+
+        return npdu_len;
+    }
+#endif
+    npdu_len = bip6_receive_select(
+        src, &BIP6_Receive_NPDU[0], sizeof(BIP6_Receive_NPDU), timeout);
+    if (npdu_len > 0) {
+        *npdu = &BIP6_Receive_NPDU[0];
     }
 
     return npdu_len;
 }
 
+/**
+ * BACnet/IP Datalink Receive handler.
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip6_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+#if BIP6_RECEIVE_BATCH_SIZE
+    uint16_t npdu_len = 0;
+    uint8_t *pdu = NULL;
+#endif
+
+    /* Make sure the socket is open */
+    if (BIP6_Socket < 0) {
+        return 0;
+    }
+#if BIP6_RECEIVE_BATCH_SIZE
+    if (BIP6_Epoll_Socket >= 0) {
+        npdu_len = bip6_receive_buffer(src, &pdu, timeout);
+        if (npdu_len > max_npdu) {
+            datalink_stats_error(
+                PORT_TYPE_BIP6, DATALINK_STATS_OVERSIZE_FRAME);
+            npdu_len = 0;
+        }
+        if (npdu_len > 0) {
+            /* copy only the NPDU into the caller buffer */
+            memcpy(npdu, pdu, npdu_len);
+        }
+
+        return npdu_len;
+    }
+#endif
+
+    return bip6_receive_select(src, npdu, max_npdu, timeout);
+}
+
+#if BIP6_RECEIVE_BATCH_SIZE
+/**
+ * @brief Create the epoll instance that watches the socket.
+ *  If it fails, bip6_receive() uses select() and recvfrom().
+ */
+static void bip6_receive_epoll_init(void)
+{
+    struct epoll_event event = { 0 };
+
+    if (BIP6_Epoll_Socket != -1) {
+        close(BIP6_Epoll_Socket);
+    }
+    BIP6_Receive_Index = 0;
+    BIP6_Receive_Count = 0;
+    BIP6_Epoll_Socket = epoll_create1(EPOLL_CLOEXEC);
+    if (BIP6_Epoll_Socket < 0) {
+        PRINTF("BIP6: epoll_create1 failed\n");
+        return;
+    }
+    event.events = EPOLLIN;
+    event.data.fd = BIP6_Socket;
+    if (epoll_ctl(BIP6_Epoll_Socket, EPOLL_CTL_ADD, BIP6_Socket, &event) == 0) {
+        return;
+    }
+    PRINTF("BIP6: epoll_ctl failed\n");
+    close(BIP6_Epoll_Socket);
+    BIP6_Epoll_Socket = -1;
+}
+#endif
+
 /** Cleanup and close out the BACnet/IP services by closing the socket.
  * @ingroup DLBIP6
  */
 void bip6_cleanup(void)
 {
     bvlc6_cleanup();
+#if BIP6_RECEIVE_BATCH_SIZE
+    if (BIP6_Epoll_Socket != -1) {
+        close(BIP6_Epoll_Socket);
+    }
+    BIP6_Epoll_Socket = -1;
+    BIP6_Receive_Index = 0;
+    BIP6_Receive_Count = 0;
+#endif
     if (BIP6_Socket != -1) {
         close(BIP6_Socket);
     }
@@ -491,6 +819,9 @@ bool bip6_init(char *ifname)
         BIP6_Socket = -1;
         return false;
     }
+#if BIP6_RECEIVE_BATCH_SIZE
+    bip6_receive_epoll_init();
+#endif
     bvlc6_init();
 
     return true;
@@ -37,8 +37,10 @@
 #include "bacnet/npdu.h"
 #include "bacnet/datalink/mstp.h"
 #include "bacnet/datalink/dlmstp.h"
-#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/datalink/dlstats.h"
+#include "bacnet/basic/sys/ringbuf_spsc.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/trace.h"
 /* OS Specific include */
 #include "bacport.h"
 /* port specific */
@@ -59,7 +61,10 @@ static pthread_cond_t Received_Frame_Flag;
 static pthread_mutex_t Received_Frame_Mutex;
 static pthread_cond_t Master_Done_Flag;
 static pthread_mutex_t Master_Done_Mutex;
-static pthread_mutex_t Ring_Buffer_Mutex;
+/* mechanism for the state machine to wait for a reply to be queued */
+static pthread_cond_t Reply_Ready_Flag;
+static pthread_mutex_t Reply_Ready_Mutex;
+static bool Reply_Ready;
 static pthread_mutex_t Thread_Mutex;
 static pthread_t hThread;
 static bool run_thread;
@@ -81,7 +86,9 @@ struct mstp_pdu_packet {
 #define MSTP_PDU_PACKET_COUNT 8
 #endif
 static struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
-static RING_BUFFER PDU_Queue;
+/* the thread that sends the PDUs is the producer, and the MS/TP
+   state machine thread is the consumer */
+static RINGBUF_SPSC PDU_Queue;
 /* The minimum time without a DataAvailable or ReceiveError event */
 /* that a node must wait for a station to begin replying to a */
 /* confirmed request: 255 milliseconds. (Implementations may use */
@@ -189,10 +196,11 @@ void dlmstp_cleanup(void)
     pthread_cond_destroy(&Received_Frame_Flag);
     pthread_cond_destroy(&Receive_Packet_Flag);
     pthread_cond_destroy(&Master_Done_Flag);
+    pthread_cond_destroy(&Reply_Ready_Flag);
     pthread_mutex_destroy(&Received_Frame_Mutex);
     pthread_mutex_destroy(&Receive_Packet_Mutex);
     pthread_mutex_destroy(&Master_Done_Mutex);
-    pthread_mutex_destroy(&Ring_Buffer_Mutex);
+    pthread_mutex_destroy(&Reply_Ready_Mutex);
 }
 
 /* returns number of bytes sent on success, zero on failure */
@@ -205,8 +213,8 @@ int dlmstp_send_pdu(
     int bytes_sent = 0;
     struct mstp_pdu_packet *pkt;
     unsigned i = 0;
-    pthread_mutex_lock(&Ring_Buffer_Mutex);
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(&PDU_Queue);
+
+    pkt = (struct mstp_pdu_packet *)Ringbuf_SPSC_Data_Peek(&PDU_Queue);
     if (pkt) {
         pkt->data_expecting_reply = npdu_data->data_expecting_reply;
         for (i = 0; i < pdu_len; i++) {
@@ -219,11 +227,20 @@ int dlmstp_send_pdu(
             /* mac_len = 0 is a broadcast address */
             pkt->destination_mac = MSTP_BROADCAST_ADDRESS;
         }
-        if (Ringbuf_Data_Put(&PDU_Queue, (uint8_t *)pkt)) {
+        if (Ringbuf_SPSC_Data_Put(&PDU_Queue, pkt)) {
             bytes_sent = pdu_len;
+            BACNET_TRACE(NPDU_TX, dest ? dest->net : 0, pdu_len);
+            /* wake the state machine if it waits for a reply */
+            pthread_mutex_lock(&Reply_Ready_Mutex);
+            Reply_Ready = true;
+            pthread_cond_signal(&Reply_Ready_Flag);
+            pthread_mutex_unlock(&Reply_Ready_Mutex);
         }
     }
-    pthread_mutex_unlock(&Ring_Buffer_Mutex);
+    if (bytes_sent == 0) {
+        /* the transmit queue is full */
+        datalink_stats_error(PORT_TYPE_MSTP, DATALINK_STATS_TX_DROPPED);
+    }
 
     return bytes_sent;
 }
@@ -264,6 +281,30 @@ uint16_t dlmstp_receive(
     return pdu_len;
 }
 
+/**
+ * @brief Wait for a PDU to be queued, such as the reply to a Data Expecting
+ *  Reply frame, until Treply_delay after the frame, rather than polling
+ *  for the reply
+ */
+static void dlmstp_reply_wait(void)
+{
+    struct timespec abstime;
+    uint32_t silence;
+
+    silence = MSTP_Port.SilenceTimer(&MSTP_Port);
+    if (silence > MSTP_Port.Treply_delay) {
+        return;
+    }
+    pthread_mutex_lock(&Reply_Ready_Mutex);
+    if (!Reply_Ready) {
+        get_abstime(&abstime, (MSTP_Port.Treply_delay - silence) + 1);
+        pthread_cond_timedwait(
+            &Reply_Ready_Flag, &Reply_Ready_Mutex, &abstime);
+    }
+    Reply_Ready = false;
+    pthread_mutex_unlock(&Reply_Ready_Mutex);
+}
+
 static void *dlmstp_master_fsm_task(void *pArg)
 {
     uint32_t silence = 0;
@@ -311,6 +352,10 @@ static void *dlmstp_master_fsm_task(void *pArg)
                         run_loop = false;
                     pthread_mutex_unlock(&Thread_Mutex);
                 }
+                if (MSTP_Port.master_state ==
+                    MSTP_MASTER_STATE_ANSWER_DATA_REQUEST) {
+                    dlmstp_reply_wait();
+                }
             } else if (MSTP_Port.This_Station < 255) {
                 MSTP_Slave_Node_FSM(&MSTP_Port);
             }
@@ -354,6 +399,7 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
     pthread_mutex_lock(&Receive_Packet_Mutex);
     if (Receive_Packet.ready) {
         debug_printf("MS/TP: Dropped! Not Ready.\n");
+        datalink_stats_error(PORT_TYPE_MSTP, DATALINK_STATS_RX_DROPPED);
     } else {
         /* bounds check - maybe this should send an abort? */
         pdu_len = mstp_port->DataLength;
@@ -370,6 +416,7 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
             &Receive_Packet.address, mstp_port->SourceAddress);
         Receive_Packet.pdu_len = mstp_port->DataLength;
         Receive_Packet.ready = true;
+        datalink_stats_received(PORT_TYPE_MSTP, pdu_len);
         pthread_cond_signal(&Receive_Packet_Flag);
     }
     pthread_mutex_unlock(&Receive_Packet_Mutex);
@@ -386,12 +433,10 @@ uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     struct mstp_pdu_packet *pkt;
 
     (void)timeout;
-    pthread_mutex_lock(&Ring_Buffer_Mutex);
-    if (Ringbuf_Empty(&PDU_Queue)) {
-        pthread_mutex_unlock(&Ring_Buffer_Mutex);
+    pkt = (struct mstp_pdu_packet *)Ringbuf_SPSC_Peek(&PDU_Queue);
+    if (!pkt) {
         return 0;
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
     if (pkt->data_expecting_reply) {
         frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
     } else {
@@ -402,8 +447,8 @@ uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
         &mstp_port->OutputBuffer[0], /* <-- loading this */
         mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
         mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&PDU_Queue, NULL);
-    pthread_mutex_unlock(&Ring_Buffer_Mutex);
+    (void)Ringbuf_SPSC_Pop(&PDU_Queue, NULL);
+    datalink_stats_sent(PORT_TYPE_MSTP, pdu_len);
 
     return pdu_len;
 }
@@ -560,10 +605,10 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     struct mstp_pdu_packet *pkt;
 
     (void)timeout;
-    if (Ringbuf_Empty(&PDU_Queue)) {
+    pkt = (struct mstp_pdu_packet *)Ringbuf_SPSC_Peek(&PDU_Queue);
+    if (!pkt) {
         return 0;
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&PDU_Queue);
     /* is this the reply to the DER? */
     matched = dlmstp_compare_data_expecting_reply(
         &mstp_port->InputBuffer[0], mstp_port->DataLength,
@@ -582,7 +627,7 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
         &mstp_port->OutputBuffer[0], /* <-- loading this */
         mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
         mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&PDU_Queue, NULL);
+    (void)Ringbuf_SPSC_Pop(&PDU_Queue, NULL);
 
     return pdu_len;
 }
@@ -646,6 +691,17 @@ uint8_t dlmstp_max_master(void)
     return MSTP_Port.Nmax_master;
 }
 
+/**
+ * @brief Send the Reply Postponed frame at once for a Data Expecting Reply
+ *  frame that is routed to another network, whose reply is not available
+ *  within Treply_delay, such as in a router
+ * @param enable - true to postpone the routed requests at once
+ */
+void dlmstp_set_reply_postpone_routed(bool enable)
+{
+    MSTP_Port.Reply_Postpone = enable ? MSTP_Reply_Postpone_Routed : NULL;
+}
+
 /* RS485 Baud Rate 9600, 19200, 38400, 57600, 115200 */
 void dlmstp_set_baud_rate(uint32_t baud)
 {
@@ -702,11 +758,10 @@ bool dlmstp_init(char *ifname)
         exit(1);
     }
 
-    pthread_mutex_init(&Ring_Buffer_Mutex, NULL);
     pthread_mutex_init(&Thread_Mutex, NULL);
 
     /* initialize PDU queue */
-    Ringbuf_Init(
+    Ringbuf_SPSC_Init(
         &PDU_Queue, (uint8_t *)&PDU_Buffer, sizeof(struct mstp_pdu_packet),
         MSTP_PDU_PACKET_COUNT);
     /* initialize packet queue */
@@ -727,6 +782,22 @@ bool dlmstp_init(char *ifname)
             ifname);
         exit(1);
     }
+    Reply_Ready = false;
+    rv = pthread_cond_init(&Reply_Ready_Flag, &attr);
+    if (rv != 0) {
+        fprintf(
+            stderr,
+            "MS/TP Interface: %s\n cannot allocate PThread Condition.\n",
+            ifname);
+        exit(1);
+    }
+    rv = pthread_mutex_init(&Reply_Ready_Mutex, NULL);
+    if (rv != 0) {
+        fprintf(
+            stderr, "MS/TP Interface: %s\n cannot allocate PThread Mutex.\n",
+            ifname);
+        exit(1);
+    }
     /* initialize hardware */
     if (ifname) {
         RS485_Set_Interface(ifname);
@@ -0,0 +1,387 @@
+/**
+ * @file
+ * @brief MS/TP engine which runs the state machines of many MS/TP ports
+ *  from one thread.
+ *
+ * Each port added to the engine is opened with dlmstp_init_port(), and
+ * its serial port and a timerfd are added to one epoll set. The engine
+ * thread wakes when octets arrive or when the timer expires, feeds the
+ * received octets to the Receive Frame FSM, and runs the Master or Slave
+ * Node FSM when a frame was received or when the timeout of its current
+ * state, such as Tno_token, Treply_timeout or Tusage_timeout, is due.
+ * The timer is then armed for the next timeout of that port.
+ *
+ * Frames are written to the serial port without waiting for them to
+ * drain, so that a transmission on one trunk does not stall the others,
+ * and the silence timer of the port starts once the last octet has been
+ * transmitted. For real-time mode, dlmstp_engine_realtime() gives the
+ * engine thread a SCHED_FIFO priority and CPU affinity, and each port
+ * may set RS485_Low_Latency before it is added.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "bacnet/basic/sys/fifo.h"
+#include "dlmstp_linux.h"
+#include "dlmstp_engine.h"
+
+/* an MS/TP port served by the engine */
+struct dlmstp_engine_port {
+    struct mstp_port_struct_t *mstp_port;
+    int timer_fd;
+};
+
+static struct dlmstp_engine_port Engine_Ports[DLMSTP_ENGINE_PORTS_MAX];
+static unsigned Engine_Port_Count;
+static int Engine_Epoll_Handle = -1;
+/* guards the port table, and the ports while they are serviced */
+static pthread_mutex_t Engine_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t Engine_Once = PTHREAD_ONCE_INIT;
+static pthread_t Engine_Thread;
+static bool Engine_Thread_Running;
+
+/**
+ * @brief Get the time until the Master or Slave Node FSM of a port has
+ *  to run, when no frame has been received
+ * @param mstp_port - the MS/TP port
+ * @return number of milliseconds, or zero if the FSM has to run now
+ */
+static uint32_t dlmstp_engine_node_timeout(
+    struct mstp_port_struct_t *mstp_port)
+{
+    uint32_t silence;
+    uint32_t timeout;
+
+    if (mstp_port->ReceivedValidFrame || mstp_port->ReceivedInvalidFrame) {
+        return 0;
+    }
+    silence = mstp_port->SilenceTimer(mstp_port);
+    if (mstp_port->This_Station > DEFAULT_MAX_MASTER) {
+        /* the Slave Node FSM answers frames, and polls for a reply
+           within Treply_delay of a frame */
+        if (silence < mstp_port->Treply_delay) {
+            return 0;
+        }
+        return Tno_token;
+    }
+    switch (mstp_port->master_state) {
+        case MSTP_MASTER_STATE_IDLE:
+            timeout = Tno_token;
+            break;
+        case MSTP_MASTER_STATE_WAIT_FOR_REPLY:
+            timeout = mstp_port->Treply_timeout;
+            break;
+        case MSTP_MASTER_STATE_PASS_TOKEN:
+        case MSTP_MASTER_STATE_POLL_FOR_MASTER:
+            timeout = mstp_port->Tusage_timeout;
+            break;
+        case MSTP_MASTER_STATE_NO_TOKEN:
+            if (mstp_port->EventCount > Nmin_octets) {
+                return 0;
+            }
+            timeout = Tno_token + (Tslot * mstp_port->This_Station);
+            break;
+        default:
+            /* the remaining states transition without a timeout, or
+               poll for a reply to send */
+            return 0;
+    }
+    if (silence >= timeout) {
+        return 0;
+    }
+
+    return timeout - silence;
+}
+
+/**
+ * @brief Arm the timer of a port for its next timeout
+ * @param port - the engine port
+ */
+static void dlmstp_engine_timer_arm(struct dlmstp_engine_port *port)
+{
+    struct mstp_port_struct_t *mstp_port = port->mstp_port;
+    struct itimerspec timer = { 0 };
+    uint32_t timeout, silence;
+
+    timeout = dlmstp_engine_node_timeout(mstp_port);
+    if (mstp_port->receive_state != MSTP_RECEIVE_STATE_IDLE) {
+        /* a partial frame is aborted after Tframe_abort */
+        silence = mstp_port->SilenceTimer(mstp_port);
+        if (silence > mstp_port->Tframe_abort) {
+            timeout = 0;
+        } else if ((mstp_port->Tframe_abort + 1 - silence) < timeout) {
+            timeout = mstp_port->Tframe_abort + 1 - silence;
+        }
+    }
+    if (timeout == 0) {
+        /* poll again at the timer resolution of the state machines */
+        timeout = 1;
+    }
+    timer.it_value.tv_sec = timeout / 1000;
+    timer.it_value.tv_nsec = (timeout % 1000) * 1000000L;
+    (void)timerfd_settime(port->timer_fd, 0, &timer, NULL);
+}
+
+/**
+ * @brief Run the Master or Slave Node FSM of a port
+ * @param mstp_port - the MS/TP port
+ */
+static void dlmstp_engine_node_fsm(struct mstp_port_struct_t *mstp_port)
+{
+    if (mstp_port->This_Station <= DEFAULT_MAX_MASTER) {
+        while (MSTP_Master_Node_FSM(mstp_port)) {
+            /* do nothing while immediate transitioning */
+        }
+    } else if (mstp_port->This_Station < 255) {
+        MSTP_Slave_Node_FSM(mstp_port);
+    }
+}
+
+/**
+ * @brief Read the octets waiting on the serial port of a port, run its
+ *  state machines over them and over any timeout that is due, and
+ *  arm its timer for the next timeout
+ * @param port - the engine port
+ */
+static void dlmstp_engine_port_task(struct dlmstp_engine_port *port)
+{
+    struct mstp_port_struct_t *mstp_port = port->mstp_port;
+    SHARED_MSTP_DATA *poSharedData;
+    uint8_t buf[512];
+    uint64_t expirations;
+    ssize_t n;
+    bool received_frame;
+
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    (void)read(port->timer_fd, &expirations, sizeof(expirations));
+    /* the serial port is in raw mode with VMIN and VTIME of zero,
+       so the read returns zero once no octets are waiting */
+    while ((n = read(poSharedData->RS485_Handle, buf, sizeof(buf))) > 0) {
+        if (!FIFO_Add(&poSharedData->Rx_FIFO, buf, (unsigned)n)) {
+            break;
+        }
+    }
+    do {
+        received_frame =
+            mstp_port->ReceivedValidFrame || mstp_port->ReceivedInvalidFrame;
+        if (!received_frame) {
+            if (!mstp_port->DataAvailable &&
+                (FIFO_Count(&poSharedData->Rx_FIFO) > 0)) {
+                mstp_port->DataRegister = FIFO_Get(&poSharedData->Rx_FIFO);
+                mstp_port->DataAvailable = true;
+            }
+            MSTP_Receive_Frame_FSM(mstp_port);
+        }
+        if (dlmstp_engine_node_timeout(mstp_port) == 0) {
+            dlmstp_engine_node_fsm(mstp_port);
+        }
+        received_frame =
+            mstp_port->ReceivedValidFrame || mstp_port->ReceivedInvalidFrame;
+    } while (!received_frame &&
+        (mstp_port->DataAvailable ||
+            (FIFO_Count(&poSharedData->Rx_FIFO) > 0)));
+    dlmstp_engine_timer_arm(port);
+}
+
+/**
+ * @brief Thread which waits for the serial ports and timers of all of
+ *  the engine ports, and services the ports that are ready
+ * @param arg - not used
+ * @return NULL
+ */
+static void *dlmstp_engine_thread(void *arg)
+{
+    struct epoll_event events[DLMSTP_ENGINE_PORTS_MAX * 2];
+    struct dlmstp_engine_port *port;
+    int count, i;
+
+    (void)arg;
+    for (;;) {
+        count = epoll_wait(Engine_Epoll_Handle, events,
+            DLMSTP_ENGINE_PORTS_MAX * 2, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("MS/TP engine: epoll_wait");
+            break;
+        }
+        pthread_mutex_lock(&Engine_Mutex);
+        for (i = 0; i < count; i++) {
+            /* both events of a port carry the index of the port, and
+               a port removed since the wait has no MS/TP port */
+            port = &Engine_Ports[events[i].data.u32];
+            if (port->mstp_port) {
+                dlmstp_engine_port_task(port);
+            }
+        }
+        pthread_mutex_unlock(&Engine_Mutex);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Create the epoll set and start the engine thread, once
+ */
+static void dlmstp_engine_init(void)
+{
+    Engine_Epoll_Handle = epoll_create1(EPOLL_CLOEXEC);
+    if (Engine_Epoll_Handle < 0) {
+        perror("MS/TP engine: epoll_create1");
+        return;
+    }
+    if (pthread_create(&Engine_Thread, NULL, dlmstp_engine_thread, NULL) !=
+        0) {
+        fprintf(stderr, "MS/TP engine: failed to start thread\n");
+        close(Engine_Epoll_Handle);
+        Engine_Epoll_Handle = -1;
+        return;
+    }
+    pthread_detach(Engine_Thread);
+    Engine_Thread_Running = true;
+}
+
+/**
+ * @brief Run the engine thread in real-time mode, with a SCHED_FIFO
+ *  priority and pinned to CPUs, so that Tslot, Tusage_timeout and the
+ *  frame turnaround are kept on a loaded host
+ * @param priority - SCHED_FIFO priority from 1 to 99, or 0 to keep the
+ *  default scheduling
+ * @param cpu_mask - CPUs to run on, one bit per CPU, or 0 for any CPU
+ * @return true if the settings were applied
+ */
+bool dlmstp_engine_realtime(int priority, unsigned long cpu_mask)
+{
+    pthread_once(&Engine_Once, dlmstp_engine_init);
+    if (!Engine_Thread_Running) {
+        return false;
+    }
+
+    return dlmstp_thread_realtime(Engine_Thread, priority, cpu_mask);
+}
+
+/**
+ * @brief Initialize an MS/TP port and add it to the engine, which
+ *  runs its state machines instead of a thread for the port
+ * @param poPort - the MS/TP port, with the shared data in UserData
+ * @param ifname - name of the serial port, such as /dev/ttyUSB0
+ * @return true if the port was added
+ */
+bool dlmstp_engine_add_port(void *poPort, char *ifname)
+{
+    struct mstp_port_struct_t *mstp_port = poPort;
+    SHARED_MSTP_DATA *poSharedData;
+    struct dlmstp_engine_port *port = NULL;
+    struct epoll_event event = { 0 };
+    unsigned i;
+    bool status = false;
+
+    if (!mstp_port || !mstp_port->UserData) {
+        return false;
+    }
+    pthread_once(&Engine_Once, dlmstp_engine_init);
+    if (Engine_Epoll_Handle < 0) {
+        return false;
+    }
+    if (!dlmstp_init_port(mstp_port, ifname)) {
+        return false;
+    }
+    poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    pthread_mutex_lock(&Engine_Mutex);
+    for (i = 0; i < DLMSTP_ENGINE_PORTS_MAX; i++) {
+        if (!Engine_Ports[i].mstp_port) {
+            port = &Engine_Ports[i];
+            break;
+        }
+    }
+    if (port) {
+        port->timer_fd =
+            timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    }
+    if (port && (port->timer_fd >= 0)) {
+        poSharedData->RS485_No_Drain = true;
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        if ((epoll_ctl(Engine_Epoll_Handle, EPOLL_CTL_ADD,
+                 poSharedData->RS485_Handle, &event) == 0) &&
+            (epoll_ctl(Engine_Epoll_Handle, EPOLL_CTL_ADD, port->timer_fd,
+                 &event) == 0)) {
+            port->mstp_port = mstp_port;
+            Engine_Port_Count++;
+            dlmstp_engine_timer_arm(port);
+            status = true;
+        } else {
+            perror("MS/TP engine: epoll_ctl");
+            (void)epoll_ctl(Engine_Epoll_Handle, EPOLL_CTL_DEL,
+                poSharedData->RS485_Handle, NULL);
+            close(port->timer_fd);
+        }
+    }
+    pthread_mutex_unlock(&Engine_Mutex);
+    if (!status) {
+        fprintf(stderr, "MS/TP engine: cannot add %s\n", ifname);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Remove an MS/TP port from the engine. Once this returns, the
+ *  engine no longer uses the port, which may then be closed with
+ *  dlmstp_cleanup().
+ * @param poPort - the MS/TP port
+ */
+void dlmstp_engine_remove_port(void *poPort)
+{
+    SHARED_MSTP_DATA *poSharedData;
+    struct dlmstp_engine_port *port;
+    unsigned i;
+
+    pthread_mutex_lock(&Engine_Mutex);
+    for (i = 0; i < DLMSTP_ENGINE_PORTS_MAX; i++) {
+        port = &Engine_Ports[i];
+        if (port->mstp_port && (port->mstp_port == poPort)) {
+            poSharedData = (SHARED_MSTP_DATA *)port->mstp_port->UserData;
+            (void)epoll_ctl(Engine_Epoll_Handle, EPOLL_CTL_DEL,
+                poSharedData->RS485_Handle, NULL);
+            (void)epoll_ctl(
+                Engine_Epoll_Handle, EPOLL_CTL_DEL, port->timer_fd, NULL);
+            close(port->timer_fd);
+            port->timer_fd = -1;
+            port->mstp_port = NULL;
+            Engine_Port_Count--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&Engine_Mutex);
+}
+
+/**
+ * @brief Get the number of MS/TP ports served by the engine
+ * @return number of ports
+ */
+unsigned dlmstp_engine_port_count(void)
+{
+    unsigned count;
+
+    pthread_mutex_lock(&Engine_Mutex);
+    count = Engine_Port_Count;
+    pthread_mutex_unlock(&Engine_Mutex);
+
+    return count;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief MS/TP engine which runs the state machines of many MS/TP ports
+ *  from one thread, waiting on the serial ports and on a timer for each
+ *  port with epoll instead of polling from two threads per port.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef DLMSTP_ENGINE_H
+#define DLMSTP_ENGINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/** maximum number of MS/TP ports served by the engine */
+#ifndef DLMSTP_ENGINE_PORTS_MAX
+#define DLMSTP_ENGINE_PORTS_MAX 32
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool dlmstp_engine_add_port(void *poPort, char *ifname);
+BACNET_STACK_EXPORT
+void dlmstp_engine_remove_port(void *poPort);
+BACNET_STACK_EXPORT
+unsigned dlmstp_engine_port_count(void);
+BACNET_STACK_EXPORT
+bool dlmstp_engine_realtime(int priority, unsigned long cpu_mask);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
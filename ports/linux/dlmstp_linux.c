@@ -22,6 +22,10 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *
  *********************************************************************/
+#ifndef _GNU_SOURCE
+/* for pthread_setaffinity_np() */
+#define _GNU_SOURCE
+#endif
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
@@ -29,6 +33,8 @@
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -38,6 +44,7 @@
 #include "bacnet/datalink/mstp.h"
 #include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/trace.h"
 /* port specific */
 #include "dlmstp_linux.h"
 #include "rs485.h"
@@ -57,11 +64,20 @@
         if (x < 0xFFFF)               \
             x++;                      \
     }
+/**
+ * @brief Get the silence time of an MS/TP port from the monotonic clock,
+ *  which is zero while a frame written to the serial port without
+ *  waiting for it to drain is still being transmitted
+ * @param poPort - the MS/TP port
+ * @return number of milliseconds of silence on the line
+ */
 uint32_t Timer_Silence(void *poPort)
 {
-    struct timeval now, tmp_diff;
+    struct timespec now;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    int64_t res;
+
     if (!mstp_port) {
         return -1;
     }
@@ -69,14 +85,11 @@ uint32_t Timer_Silence(void *poPort)
     if (!poSharedData) {
         return -1;
     }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    res = ((int64_t)(now.tv_sec - poSharedData->start.tv_sec) * 1000) +
+        ((now.tv_nsec - poSharedData->start.tv_nsec) / 1000000L);
 
-    int32_t res;
-
-    gettimeofday(&now, NULL);
-    timersub(&poSharedData->start, &now, &tmp_diff);
-    res = ((tmp_diff.tv_sec) * 1000 + (tmp_diff.tv_usec) / 1000);
-
-    return (res >= 0 ? res : -res);
+    return (res >= 0 ? (uint32_t)res : 0);
 }
 
 void Timer_Silence_Reset(void *poPort)
@@ -91,19 +104,64 @@ void Timer_Silence_Reset(void *poPort)
         return;
     }
 
-    gettimeofday(&poSharedData->start, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &poSharedData->start);
 }
 
 void get_abstime(struct timespec *abstime, unsigned long milliseconds)
 {
-    struct timeval now, offset, result;
-
-    gettimeofday(&now, NULL);
-    offset.tv_sec = 0;
-    offset.tv_usec = milliseconds * 1000;
-    timeradd(&now, &offset, &result);
-    abstime->tv_sec = result.tv_sec;
-    abstime->tv_nsec = result.tv_usec * 1000;
+    /* sem_timedwait() and pthread_cond_timedwait() use CLOCK_REALTIME */
+    clock_gettime(CLOCK_REALTIME, abstime);
+    abstime->tv_sec += milliseconds / 1000;
+    abstime->tv_nsec += (milliseconds % 1000) * 1000000L;
+    if (abstime->tv_nsec >= 1000000000L) {
+        abstime->tv_sec++;
+        abstime->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * @brief Run an MS/TP thread with a real-time priority, pinned to CPUs,
+ *  so that the MS/TP timing is kept under load
+ * @param thread - the thread
+ * @param priority - SCHED_FIFO priority from 1 to 99, or 0 to keep the
+ *  scheduling policy of the thread
+ * @param cpu_mask - CPUs to run on, one bit per CPU, or 0 for any CPU
+ * @return true if the settings were applied
+ */
+bool dlmstp_thread_realtime(
+    pthread_t thread, int priority, unsigned long cpu_mask)
+{
+    struct sched_param param = { 0 };
+    cpu_set_t cpus;
+    unsigned cpu;
+    bool status = true;
+    int rv;
+
+    if (priority > 0) {
+        param.sched_priority = priority;
+        rv = pthread_setschedparam(thread, SCHED_FIFO, &param);
+        if (rv != 0) {
+            fprintf(stderr, "MS/TP: SCHED_FIFO priority %d: %s\n", priority,
+                strerror(rv));
+            status = false;
+        }
+    }
+    if (cpu_mask) {
+        CPU_ZERO(&cpus);
+        for (cpu = 0; cpu < (sizeof(cpu_mask) * 8); cpu++) {
+            if (cpu_mask & (1UL << cpu)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        rv = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+        if (rv != 0) {
+            fprintf(stderr, "MS/TP: CPU mask %lx: %s\n", cpu_mask,
+                strerror(rv));
+            status = false;
+        }
+    }
+
+    return status;
 }
 
 void dlmstp_cleanup(void *poPort)
@@ -120,6 +178,9 @@ void dlmstp_cleanup(void *poPort)
 
     /* restore the old port settings */
     tcsetattr(poSharedData->RS485_Handle, TCSANOW, &poSharedData->RS485_oldtio);
+    if (poSharedData->RS485_Low_Latency) {
+        (void)RS485_Set_Low_Latency(poSharedData->RS485_Handle, false);
+    }
     close(poSharedData->RS485_Handle);
 
     pthread_cond_destroy(&poSharedData->Received_Frame_Flag);
@@ -129,6 +190,171 @@ void dlmstp_cleanup(void *poPort)
     pthread_mutex_destroy(&poSharedData->Master_Done_Mutex);
 }
 
+/**
+ * @brief Decode the reply matching fields of a confirmed request
+ *  received in a Data Expecting Reply frame
+ * @param key - the fields to fill in
+ * @param request_pdu - the NPDU of the request
+ * @param request_pdu_len - number of octets in the request
+ * @param src_address - MS/TP source address of the request
+ * @return true if the request is a confirmed request that can be matched
+ */
+static bool dlmstp_request_key(
+    struct dlmstp_reply_key *key,
+    uint8_t *request_pdu,
+    uint16_t request_pdu_len,
+    uint8_t src_address)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int offset;
+
+    key->valid = false;
+    memset(&key->address, 0, sizeof(key->address));
+    key->address.mac[0] = src_address;
+    key->address.mac_len = 1;
+    offset = bacnet_npdu_decode(
+        request_pdu, request_pdu_len, NULL, &key->address, &npdu_data);
+    if ((offset <= 0) || npdu_data.network_layer_message) {
+        debug_printf("DLMSTP: DER Compare failed: "
+                     "Request is Network message.\n");
+        return false;
+    }
+    if ((offset + 4) > request_pdu_len) {
+        return false;
+    }
+    key->pdu_type = request_pdu[offset] & 0xF0;
+    if (key->pdu_type != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
+        debug_printf("DLMSTP: DER Compare failed: "
+                     "Not Confirmed Request.\n");
+        return false;
+    }
+    key->invoke_id = request_pdu[offset + 2];
+    /* segmented message? */
+    if (request_pdu[offset] & BIT(3)) {
+        if ((offset + 6) > request_pdu_len) {
+            return false;
+        }
+        key->service_choice = request_pdu[offset + 5];
+    } else {
+        key->service_choice = request_pdu[offset + 3];
+    }
+    key->protocol_version = npdu_data.protocol_version;
+    key->valid = true;
+
+    return true;
+}
+
+/**
+ * @brief Decode the reply matching fields of a PDU to send, which
+ *  could be the reply to a Data Expecting Reply frame
+ * @param key - the fields to fill in
+ * @param reply_pdu - the NPDU to send
+ * @param reply_pdu_len - number of octets in the NPDU
+ * @param dest_address - MS/TP destination address of the NPDU
+ * @return true if the NPDU is an acknowledgement, error, reject or
+ *  abort that can be matched
+ */
+static bool dlmstp_reply_key(
+    struct dlmstp_reply_key *key,
+    uint8_t *reply_pdu,
+    uint16_t reply_pdu_len,
+    uint8_t dest_address)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int offset;
+
+    key->valid = false;
+    memset(&key->address, 0, sizeof(key->address));
+    key->address.mac[0] = dest_address;
+    key->address.mac_len = 1;
+    offset = bacnet_npdu_decode(
+        reply_pdu, reply_pdu_len, &key->address, NULL, &npdu_data);
+    if ((offset <= 0) || npdu_data.network_layer_message) {
+        return false;
+    }
+    if ((offset + 2) > reply_pdu_len) {
+        return false;
+    }
+    /* reply could be a lot of things:
+       confirmed, simple ack, abort, reject, error */
+    key->pdu_type = reply_pdu[offset] & 0xF0;
+    key->invoke_id = reply_pdu[offset + 1];
+    key->service_choice = 0;
+    switch (key->pdu_type) {
+        case PDU_TYPE_SIMPLE_ACK:
+        case PDU_TYPE_ERROR:
+            if ((offset + 3) > reply_pdu_len) {
+                return false;
+            }
+            key->service_choice = reply_pdu[offset + 2];
+            break;
+        case PDU_TYPE_COMPLEX_ACK:
+            /* segmented message? */
+            if (reply_pdu[offset] & BIT(3)) {
+                if ((offset + 5) > reply_pdu_len) {
+                    return false;
+                }
+                key->service_choice = reply_pdu[offset + 4];
+            } else {
+                if ((offset + 3) > reply_pdu_len) {
+                    return false;
+                }
+                key->service_choice = reply_pdu[offset + 2];
+            }
+            break;
+        case PDU_TYPE_REJECT:
+        case PDU_TYPE_ABORT:
+            /* these don't have service choice included */
+            break;
+        default:
+            return false;
+    }
+    key->protocol_version = npdu_data.protocol_version;
+    key->valid = true;
+
+    return true;
+}
+
+/**
+ * @brief Compare the reply matching fields of a request and a reply
+ * @param request - the fields of the Data Expecting Reply request
+ * @param reply - the fields of the queued reply
+ * @return true if the reply answers the request
+ */
+static bool dlmstp_reply_key_match(
+    struct dlmstp_reply_key *request, struct dlmstp_reply_key *reply)
+{
+    if (!request->valid || !reply->valid) {
+        return false;
+    }
+    if (request->invoke_id != reply->invoke_id) {
+        debug_printf("DLMSTP: DER Compare failed: "
+                     "Invoke ID mismatch.\n");
+        return false;
+    }
+    if ((reply->pdu_type != PDU_TYPE_REJECT) &&
+        (reply->pdu_type != PDU_TYPE_ABORT) &&
+        (request->service_choice != reply->service_choice)) {
+        debug_printf("DLMSTP: DER Compare failed: "
+                     "Service choice mismatch.\n");
+        return false;
+    }
+    if (request->protocol_version != reply->protocol_version) {
+        debug_printf("DLMSTP: DER Compare failed: "
+                     "NPDU Protocol Version mismatch.\n");
+        return false;
+    }
+    /* the NDPU priority doesn't get passed through the stack, and
+       all outgoing messages have NORMAL priority, so it is not compared */
+    if (!bacnet_address_same(&request->address, &reply->address)) {
+        debug_printf("DLMSTP: DER Compare failed: "
+                     "BACnet Address mismatch.\n");
+        return false;
+    }
+
+    return true;
+}
+
 /* returns number of bytes sent on success, zero on failure */
 int dlmstp_send_pdu(
     void *poPort,
@@ -138,7 +364,6 @@ int dlmstp_send_pdu(
 { /* number of bytes of data */
     int bytes_sent = 0;
     struct mstp_pdu_packet *pkt;
-    unsigned i = 0;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
     if (!mstp_port) {
@@ -149,17 +374,22 @@ int dlmstp_send_pdu(
         return 0;
     }
 
+    if (pdu_len > sizeof(pkt->buffer)) {
+        return 0;
+    }
     pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(&poSharedData->PDU_Queue);
     if (pkt) {
         pkt->data_expecting_reply =
             BACNET_DATA_EXPECTING_REPLY(pdu[BACNET_PDU_CONTROL_BYTE_OFFSET]);
-        for (i = 0; i < pdu_len; i++) {
-            pkt->buffer[i] = pdu[i];
-        }
+        memcpy(pkt->buffer, pdu, pdu_len);
         pkt->length = pdu_len;
         pkt->destination_mac = dest->mac[0];
+        /* decode once the fields that match this to a DER */
+        (void)dlmstp_reply_key(
+            &pkt->reply_key, pkt->buffer, pkt->length, pkt->destination_mac);
         if (Ringbuf_Data_Put(&poSharedData->PDU_Queue, (uint8_t *)pkt)) {
             bytes_sent = pdu_len;
+            BACNET_TRACE(NPDU_TX, dest->net, pdu_len);
         }
     }
 
@@ -339,6 +569,16 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
         return 0;
     }
 
+    if ((mstp_port->FrameType == FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) ||
+        (mstp_port->FrameType ==
+            FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY)) {
+        /* decode once the fields that match the reply to this request */
+        (void)dlmstp_request_key(&poSharedData->Request_Key,
+            &mstp_port->InputBuffer[0], mstp_port->DataLength,
+            mstp_port->SourceAddress);
+    } else {
+        poSharedData->Request_Key.valid = false;
+    }
     if (!poSharedData->Receive_Packet.ready) {
         /* bounds check - maybe this should send an abort? */
         pdu_len = mstp_port->DataLength;
@@ -410,127 +650,18 @@ bool dlmstp_compare_data_expecting_reply(
     uint16_t reply_pdu_len,
     uint8_t dest_address)
 {
-    uint16_t offset;
-    /* One way to check the message is to compare NPDU
-       src, dest, along with the APDU type, invoke id.
-       Seems a bit overkill */
-    struct DER_compare_t {
-        BACNET_NPDU_DATA npdu_data;
-        BACNET_ADDRESS address;
-        uint8_t pdu_type;
-        uint8_t invoke_id;
-        uint8_t service_choice;
-    };
-    struct DER_compare_t request;
-    struct DER_compare_t reply;
-
-    /* unused parameters */
-    request_pdu_len = request_pdu_len;
-    reply_pdu_len = reply_pdu_len;
-    /* decode the request data */
-    request.address.mac[0] = src_address;
-    request.address.mac_len = 1;
-    offset = bacnet_npdu_decode(
-        request_pdu, request_pdu_len, NULL, &request.address,
-        &request.npdu_data);
-    if (request.npdu_data.network_layer_message) {
-        debug_printf("DLMSTP: DER Compare failed: "
-                     "Request is Network message.\n");
-        return false;
-    }
-    request.pdu_type = request_pdu[offset] & 0xF0;
-    if (request.pdu_type != PDU_TYPE_CONFIRMED_SERVICE_REQUEST) {
-        debug_printf("DLMSTP: DER Compare failed: "
-                     "Not Confirmed Request.\n");
-        return false;
-    }
-    request.invoke_id = request_pdu[offset + 2];
-    /* segmented message? */
-    if (request_pdu[offset] & BIT(3)) {
-        request.service_choice = request_pdu[offset + 5];
-    } else {
-        request.service_choice = request_pdu[offset + 3];
-    }
-    /* decode the reply data */
-    reply.address.mac[0] = dest_address;
-    reply.address.mac_len = 1;
-    offset = bacnet_npdu_decode(
-        reply_pdu, reply_pdu_len, &reply.address, NULL, &reply.npdu_data);
-    if (reply.npdu_data.network_layer_message) {
-        debug_printf("DLMSTP: DER Compare failed: "
-                     "Reply is Network message.\n");
-        return false;
-    }
-    /* reply could be a lot of things:
-       confirmed, simple ack, abort, reject, error */
-    reply.pdu_type = reply_pdu[offset] & 0xF0;
-    switch (reply.pdu_type) {
-        case PDU_TYPE_SIMPLE_ACK:
-            reply.invoke_id = reply_pdu[offset + 1];
-            reply.service_choice = reply_pdu[offset + 2];
-            break;
-        case PDU_TYPE_COMPLEX_ACK:
-            reply.invoke_id = reply_pdu[offset + 1];
-            /* segmented message? */
-            if (reply_pdu[offset] & BIT(3)) {
-                reply.service_choice = reply_pdu[offset + 4];
-            } else {
-                reply.service_choice = reply_pdu[offset + 2];
-            }
-            break;
-        case PDU_TYPE_ERROR:
-            reply.invoke_id = reply_pdu[offset + 1];
-            reply.service_choice = reply_pdu[offset + 2];
-            break;
-        case PDU_TYPE_REJECT:
-        case PDU_TYPE_ABORT:
-            reply.invoke_id = reply_pdu[offset + 1];
-            break;
-        default:
-            return false;
-    }
-    /* these don't have service choice included */
-    if ((reply.pdu_type == PDU_TYPE_REJECT) ||
-        (reply.pdu_type == PDU_TYPE_ABORT)) {
-        if (request.invoke_id != reply.invoke_id) {
-            debug_printf("DLMSTP: DER Compare failed: "
-                         "Invoke ID mismatch.\n");
-            return false;
-        }
-    } else {
-        if (request.invoke_id != reply.invoke_id) {
-            debug_printf("DLMSTP: DER Compare failed: "
-                         "Invoke ID mismatch.\n");
-            return false;
-        }
-        if (request.service_choice != reply.service_choice) {
-            debug_printf("DLMSTP: DER Compare failed: "
-                         "Service choice mismatch.\n");
-            return false;
-        }
-    }
-    if (request.npdu_data.protocol_version !=
-        reply.npdu_data.protocol_version) {
-        debug_printf("DLMSTP: DER Compare failed: "
-                     "NPDU Protocol Version mismatch.\n");
-        return false;
-    }
-#if 0
-    /* the NDPU priority doesn't get passed through the stack, and
-       all outgoing messages have NORMAL priority */
-    if (request.npdu_data.priority != reply.npdu_data.priority) {
-        debug_printf(
-            "DLMSTP: DER Compare failed: " "NPDU Priority mismatch.\n");
+    struct dlmstp_reply_key request;
+    struct dlmstp_reply_key reply;
+
+    if (!dlmstp_request_key(
+            &request, request_pdu, request_pdu_len, src_address)) {
         return false;
     }
-#endif
-    if (!bacnet_address_same(&request.address, &reply.address)) {
-        debug_printf("DLMSTP: DER Compare failed: "
-                     "BACnet Address mismatch.\n");
+    if (!dlmstp_reply_key(&reply, reply_pdu, reply_pdu_len, dest_address)) {
         return false;
     }
 
-    return true;
+    return dlmstp_reply_key_match(&request, &reply);
 }
 
 /* Get the reply to a DATA_EXPECTING_REPLY frame, or nothing */
@@ -549,27 +680,28 @@ uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     if (Ringbuf_Empty(&poSharedData->PDU_Queue)) {
         return 0;
     }
+    if (!poSharedData->Request_Key.valid) {
+        /* no request that is waiting for a reply */
+        return 0;
+    }
+    /* is this the reply to the DER? The keys of the request and of each
+       queued packet were decoded when they were received and queued. */
     pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&poSharedData->PDU_Queue);
-    /* is this the reply to the DER? */
-    matched = dlmstp_compare_data_expecting_reply(
-        &mstp_port->InputBuffer[0], mstp_port->DataLength,
-        mstp_port->SourceAddress, (uint8_t *)&pkt->buffer[0], pkt->length,
-        pkt->destination_mac);
-    if (!matched) {
-        /* Walk the rest of the ring buffer to see if we can find a match */
-        while (!matched &&
-               (pkt = (struct mstp_pdu_packet *)Ringbuf_Peek_Next(
-                    &poSharedData->PDU_Queue, (uint8_t *)pkt)) != NULL) {
-            matched = dlmstp_compare_data_expecting_reply(
-                &mstp_port->InputBuffer[0], mstp_port->DataLength,
-                mstp_port->SourceAddress, (uint8_t *)&pkt->buffer[0],
-                pkt->length, pkt->destination_mac);
-        }
+    while (pkt && !matched) {
+        matched = dlmstp_reply_key_match(
+            &poSharedData->Request_Key, &pkt->reply_key);
         if (!matched) {
-            /* Still didn't find a match so just bail out */
-            return 0;
+            /* Walk the rest of the ring buffer to find a match */
+            pkt = (struct mstp_pdu_packet *)Ringbuf_Peek_Next(
+                &poSharedData->PDU_Queue, (uint8_t *)pkt);
         }
     }
+    if (!matched) {
+        /* didn't find a match so just bail out */
+        return 0;
+    }
+    /* the request is answered */
+    poSharedData->Request_Key.valid = false;
     if (pkt->data_expecting_reply) {
         frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
     } else {
@@ -775,9 +907,16 @@ void dlmstp_get_broadcast_address(BACNET_ADDRESS *dest)
     return;
 }
 
-bool dlmstp_init(void *poPort, char *ifname)
+/**
+ * @brief Open and configure the serial port of an MS/TP port, and
+ *  initialize the MS/TP state machines, without starting the thread
+ *  that runs them
+ * @param poPort - the MS/TP port, with the shared data in UserData
+ * @param ifname - name of the serial port, such as /dev/ttyUSB0
+ * @return true if the port was initialized
+ */
+bool dlmstp_init_port(void *poPort, char *ifname)
 {
-    unsigned long hThread = 0;
     int rv = 0;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
@@ -847,8 +986,17 @@ bool dlmstp_init(void *poPort, char *ifname)
     newtio.c_oflag = 0;
     /* no processing */
     newtio.c_lflag = 0;
+    /* read returns at once with the octets received so far, since the
+       state machines wait for the port with select() or epoll */
+    newtio.c_cc[VMIN] = 0;
+    newtio.c_cc[VTIME] = 0;
     /* activate the settings for the port after flushing I/O */
     tcsetattr(poSharedData->RS485_Handle, TCSAFLUSH, &newtio);
+    if (poSharedData->RS485_Low_Latency &&
+        !RS485_Set_Low_Latency(poSharedData->RS485_Handle, true)) {
+        fprintf(stderr, "RS485: %s has no low latency mode\n",
+            poSharedData->RS485_Port_Name);
+    }
     /* flush any data waiting */
     usleep(200000);
     tcflush(poSharedData->RS485_Handle, TCIOFLUSH);
@@ -861,7 +1009,7 @@ bool dlmstp_init(void *poPort, char *ifname)
     mstp_port->InputBufferSize = sizeof(poSharedData->RxBuffer);
     mstp_port->OutputBuffer = &poSharedData->TxBuffer[0];
     mstp_port->OutputBufferSize = sizeof(poSharedData->TxBuffer);
-    gettimeofday(&poSharedData->start, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &poSharedData->start);
     mstp_port->SilenceTimer = Timer_Silence;
     mstp_port->SilenceTimerReset = Timer_Silence_Reset;
     MSTP_Init(mstp_port);
@@ -869,9 +1017,27 @@ bool dlmstp_init(void *poPort, char *ifname)
     debug_fprintf(stderr, "MS/TP Max_Master: %02X\n", mstp_port->Nmax_master);
     debug_fprintf(
         stderr, "MS/TP Max_Info_Frames: %u\n", mstp_port->Nmax_info_frames);
-    rv = pthread_create(&hThread, NULL, dlmstp_master_fsm_task, mstp_port);
+
+    return true;
+}
+
+bool dlmstp_init(void *poPort, char *ifname)
+{
+    pthread_t hThread;
+    SHARED_MSTP_DATA *poSharedData;
+    int rv = 0;
+
+    if (!dlmstp_init_port(poPort, ifname)) {
+        return false;
+    }
+    rv = pthread_create(&hThread, NULL, dlmstp_master_fsm_task, poPort);
     if (rv != 0) {
         fprintf(stderr, "Failed to start Master Node FSM task\n");
+    } else {
+        poSharedData =
+            (SHARED_MSTP_DATA *)((struct mstp_port_struct_t *)poPort)->UserData;
+        (void)dlmstp_thread_realtime(
+            hThread, poSharedData->RT_Priority, poSharedData->RT_CPU_Mask);
     }
 
     return true;
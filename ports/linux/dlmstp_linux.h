@@ -28,6 +28,8 @@
 /*#include "bacnet/datalink/dlmstp.h" */
 #include <sys/types.h>
 #include <semaphore.h>
+#include <pthread.h>
+#include <time.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -57,11 +59,23 @@ typedef struct dlmstp_packet {
     uint8_t pdu[DLMSTP_MPDU_MAX];      /* packet */
 } DLMSTP_PACKET;
 
+/* the fields which match a reply to a Data Expecting Reply frame,
+   decoded once from the request or from the queued reply */
+struct dlmstp_reply_key {
+    bool valid;
+    uint8_t pdu_type;
+    uint8_t invoke_id;
+    uint8_t service_choice;
+    uint8_t protocol_version;
+    BACNET_ADDRESS address;
+};
+
 /* data structure for MS/TP PDU Queue */
 struct mstp_pdu_packet {
     bool data_expecting_reply;
     uint8_t destination_mac;
     uint16_t length;
+    struct dlmstp_reply_key reply_key;
     uint8_t buffer[DLMSTP_MPDU_MAX];
 };
 
@@ -107,9 +121,24 @@ typedef struct shared_mstp_data {
     FIFO_BUFFER Rx_FIFO;
     /* buffer size needs to be a power of 2 */
     uint8_t Rx_Buffer[4096];
-    struct timeval start;
+    /* when the line became silent, from CLOCK_MONOTONIC */
+    struct timespec start;
+    /* real-time mode: the SCHED_FIFO priority of the thread that runs
+       the state machines, or 0 for the default scheduling */
+    int RT_Priority;
+    /* real-time mode: the CPUs for that thread, one bit per CPU,
+       or 0 for any CPU */
+    unsigned long RT_CPU_Mask;
+    /* set ASYNC_LOW_LATENCY on the serial port */
+    bool RS485_Low_Latency;
+
+    /* when true, frames are written without waiting for them to drain,
+       and the silence timer starts after the last octet is transmitted */
+    bool RS485_No_Drain;
 
     RING_BUFFER PDU_Queue;
+    /* the request of the last Data Expecting Reply frame received */
+    struct dlmstp_reply_key Request_Key;
 
     struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
 
@@ -124,6 +153,10 @@ extern "C" {
         void *poShared,
         char *ifname);
     BACNET_STACK_EXPORT
+    bool dlmstp_init_port(
+        void *poShared,
+        char *ifname);
+    BACNET_STACK_EXPORT
     void dlmstp_reset(
         void *poShared);
     BACNET_STACK_EXPORT
@@ -210,6 +243,12 @@ extern "C" {
     bool dlmstp_sole_master(
         void);
 
+    BACNET_STACK_EXPORT
+    bool dlmstp_thread_realtime(
+        pthread_t thread,
+        int priority,
+        unsigned long cpu_mask);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -36,8 +36,13 @@
 #include <stdbool.h> /* for the standard bool type. */
 
 #include "bacport.h"
+#include <poll.h>
+#include <sys/mman.h>
+#include <linux/filter.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/datalink/ethernet.h"
+#include "bacnet/datalink/dlstats.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/bacint.h"
 
 /** @file linux/ethernet.c  Provides Linux-specific functions for
@@ -55,6 +60,32 @@ uint8_t Ethernet_MAC_Address[MAX_MAC_LEN] = { 0 };
 static int eth802_sockfd = -1; /* 802.2 file handle */
 static struct sockaddr eth_addr = { 0 }; /* used for binding 802.2 */
 
+/* size of each block of the receive ring, a multiple of the page size */
+#ifndef ETHERNET_RING_BLOCK_SIZE
+#define ETHERNET_RING_BLOCK_SIZE (1 << 16)
+#endif
+/* number of blocks of the receive ring */
+#ifndef ETHERNET_RING_BLOCK_COUNT
+#define ETHERNET_RING_BLOCK_COUNT 16
+#endif
+/* size that the kernel reserves for each frame of a block */
+#ifndef ETHERNET_RING_FRAME_SIZE
+#define ETHERNET_RING_FRAME_SIZE 2048
+#endif
+/* milliseconds until the kernel hands over a block that is not full */
+#ifndef ETHERNET_RING_TIMEOUT
+#define ETHERNET_RING_TIMEOUT 4
+#endif
+/* TPACKET_V3 receive ring of the 802.2 socket, or NULL when the socket
+   is the SOCK_PACKET socket that is read one frame at a time */
+static uint8_t *Ring_Buffer = NULL;
+/* block of the ring that is read next */
+static unsigned Ring_Block = 0;
+/* next frame, and the frames left, of the block handed over by the
+   kernel, or NULL when the block is not handed over yet */
+static struct tpacket3_hdr *Ring_Frame = NULL;
+static uint32_t Ring_Frames = 0;
+
 bool ethernet_valid(void)
 {
     return (eth802_sockfd >= 0);
@@ -62,6 +93,14 @@ bool ethernet_valid(void)
 
 void ethernet_cleanup(void)
 {
+    if (Ring_Buffer) {
+        munmap(Ring_Buffer,
+            (size_t)ETHERNET_RING_BLOCK_SIZE * ETHERNET_RING_BLOCK_COUNT);
+        Ring_Buffer = NULL;
+        Ring_Frame = NULL;
+        Ring_Frames = 0;
+        Ring_Block = 0;
+    }
     if (ethernet_valid())
         close(eth802_sockfd);
     eth802_sockfd = -1;
@@ -167,6 +206,81 @@ static int ethernet_bind(struct sockaddr *eth_addr, char *interface_name)
     return sock_fd;
 }
 
+/* opens an 802.2 packet socket with a TPACKET_V3 receive ring, so that
+   the frames are read in blocks from the mapped ring without a system
+   call for each frame, and that only the BACnet frames are received */
+static int ethernet_ring_bind(char *interface_name)
+{
+    /* accept the 802.3 frames to the BACnet LLC DSAP 0x82 */
+    static struct sock_filter filter[] = {
+        BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12),
+        BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, ETH_DATA_LEN, 2, 0),
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 14),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x82, 1, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0xFFFF),
+    };
+    struct sock_fprog program = { 0 };
+    struct tpacket_req3 req = { 0 };
+    struct sockaddr_ll addr = { 0 };
+    int version = TPACKET_V3;
+    size_t size = (size_t)ETHERNET_RING_BLOCK_SIZE * ETHERNET_RING_BLOCK_COUNT;
+    void *ring;
+    int sock_fd;
+
+    /* no protocol, so that nothing is received until the bind */
+    sock_fd = socket(PF_PACKET, SOCK_RAW, 0);
+    if (sock_fd < 0) {
+        return -1;
+    }
+    program.len = sizeof(filter) / sizeof(filter[0]);
+    program.filter = filter;
+    req.tp_block_size = ETHERNET_RING_BLOCK_SIZE;
+    req.tp_block_nr = ETHERNET_RING_BLOCK_COUNT;
+    req.tp_frame_size = ETHERNET_RING_FRAME_SIZE;
+    req.tp_frame_nr = (ETHERNET_RING_BLOCK_SIZE / ETHERNET_RING_FRAME_SIZE) *
+        ETHERNET_RING_BLOCK_COUNT;
+    req.tp_retire_blk_tov = ETHERNET_RING_TIMEOUT;
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_802_2);
+    addr.sll_ifindex = (int)if_nametoindex(interface_name);
+    if ((addr.sll_ifindex == 0) ||
+        (setsockopt(sock_fd, SOL_SOCKET, SO_ATTACH_FILTER, &program,
+             sizeof(program)) != 0) ||
+        (setsockopt(sock_fd, SOL_PACKET, PACKET_VERSION, &version,
+             sizeof(version)) != 0) ||
+        (setsockopt(sock_fd, SOL_PACKET, PACKET_RX_RING, &req,
+             sizeof(req)) != 0)) {
+        fprintf(stderr, "ethernet: Unable to set up the receive ring: %s\n",
+            strerror(errno));
+        close(sock_fd);
+        return -1;
+    }
+    ring = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, sock_fd, 0);
+    if (ring == MAP_FAILED) {
+        fprintf(stderr, "ethernet: Unable to map the receive ring: %s\n",
+            strerror(errno));
+        close(sock_fd);
+        return -1;
+    }
+    if (bind(sock_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "ethernet: Unable to bind 802.2 socket : %s\n",
+            strerror(errno));
+        munmap(ring, size);
+        close(sock_fd);
+        return -1;
+    }
+    Ring_Buffer = ring;
+    Ring_Block = 0;
+    Ring_Frame = NULL;
+    Ring_Frames = 0;
+    fprintf(stderr, "ethernet: receive ring of %u blocks on \"%s\"\n",
+        (unsigned)ETHERNET_RING_BLOCK_COUNT, interface_name);
+    atexit(ethernet_cleanup);
+
+    return sock_fd;
+}
+
 /* function to find the local ethernet MAC address */
 static int get_local_hwaddr(const char *ifname, unsigned char *mac)
 {
@@ -190,24 +304,36 @@ static int get_local_hwaddr(const char *ifname, unsigned char *mac)
 
 bool ethernet_init(char *interface_name)
 {
-    if (interface_name) {
-        get_local_hwaddr(interface_name, Ethernet_MAC_Address);
+    if (!interface_name) {
+        interface_name = "eth0";
+    }
+    get_local_hwaddr(interface_name, Ethernet_MAC_Address);
+    eth802_sockfd = ethernet_ring_bind(interface_name);
+    if (eth802_sockfd < 0) {
         eth802_sockfd = ethernet_bind(&eth_addr, interface_name);
-    } else {
-        get_local_hwaddr("eth0", Ethernet_MAC_Address);
-        eth802_sockfd = ethernet_bind(&eth_addr, "eth0");
     }
 
     return ethernet_valid();
 }
 
+/* sends a frame, from the bound packet socket of the receive ring
+   or else to the interface of the SOCK_PACKET socket */
+static int ethernet_frame_send(uint8_t *mtu, int mtu_len)
+{
+    if (Ring_Buffer) {
+        return send(eth802_sockfd, mtu, mtu_len, 0);
+    }
+
+    return sendto(eth802_sockfd, mtu, mtu_len, 0,
+        (struct sockaddr *)&eth_addr, sizeof(struct sockaddr));
+}
+
 int ethernet_send(uint8_t *mtu, int mtu_len)
 {
     int bytes = 0;
 
     /* Send the packet */
-    bytes = sendto(eth802_sockfd, &mtu, mtu_len, 0,
-        (struct sockaddr *)&eth_addr, sizeof(struct sockaddr));
+    bytes = ethernet_frame_send(mtu, mtu_len);
     /* did it get sent? */
     if (bytes < 0)
         fprintf(
@@ -267,6 +393,7 @@ int ethernet_send_pdu(BACNET_ADDRESS *dest, /* destination address */
     mtu_len = 17;
     if ((mtu_len + pdu_len) > ETHERNET_MPDU_MAX) {
         fprintf(stderr, "ethernet: PDU is too big to send!\n");
+        datalink_stats_error(PORT_TYPE_ETHERNET, DATALINK_STATS_TX_DROPPED);
         return -4;
     }
     memcpy(&mtu[mtu_len], pdu, pdu_len);
@@ -275,16 +402,120 @@ int ethernet_send_pdu(BACNET_ADDRESS *dest, /* destination address */
     encode_unsigned16(&mtu[12], 3 + pdu_len);
 
     /* Send the packet */
-    bytes = sendto(eth802_sockfd, &mtu, mtu_len, 0,
-        (struct sockaddr *)&eth_addr, sizeof(struct sockaddr));
+    bytes = ethernet_frame_send(&mtu[0], mtu_len);
     /* did it get sent? */
-    if (bytes < 0)
+    if (bytes < 0) {
         fprintf(
             stderr, "ethernet: Error sending packet: %s\n", strerror(errno));
+        datalink_stats_error(PORT_TYPE_ETHERNET, DATALINK_STATS_TX_DROPPED);
+    } else {
+        datalink_stats_sent(PORT_TYPE_ETHERNET, (uint32_t)mtu_len);
+        BACNET_TRACE(NPDU_TX, dest->net, pdu_len);
+    }
 
     return bytes;
 }
 
+/* copies the PDU of a received 802.2 frame */
+/* returns the number of octets in the PDU, or zero if it is not for us */
+static uint16_t ethernet_frame_pdu(BACNET_ADDRESS *src, /* source address */
+    uint8_t *pdu, /* PDU data */
+    uint16_t max_pdu, /* amount of space available in the PDU  */
+    uint8_t *buf, /* the received frame */
+    int received_bytes)
+{
+    uint16_t pdu_len = 0; /* return value */
+
+    if (received_bytes < 17)
+        return 0;
+
+    /* the signature of an 802.2 BACnet packet */
+    if ((buf[14] != 0x82) && (buf[15] != 0x82)) {
+        /*fprintf(stderr,"ethernet: Non-BACnet packet\n"); */
+        return 0;
+    }
+    /* copy the source address */
+    src->mac_len = 6;
+    memmove(src->mac, &buf[6], 6);
+
+    /* check destination address for when */
+    /* the Ethernet card is in promiscious mode */
+    if ((memcmp(&buf[0], Ethernet_MAC_Address, 6) != 0) &&
+        (memcmp(&buf[0], Ethernet_Broadcast, 6) != 0)) {
+        /*fprintf(stderr, "ethernet: This packet isn't for us\n"); */
+        return 0;
+    }
+    datalink_stats_received(PORT_TYPE_ETHERNET, (uint32_t)received_bytes);
+
+    (void)decode_unsigned16(&buf[12], &pdu_len);
+    if ((pdu_len < 3) || ((pdu_len + 14) > received_bytes)) {
+        /* the length is shorter than the LLC, or longer than the frame */
+        return 0;
+    }
+    pdu_len -= 3 /* DSAP, SSAP, LLC Control */;
+    /* copy the buffer into the PDU */
+    if (pdu_len < max_pdu)
+        memmove(&pdu[0], &buf[17], pdu_len);
+    /* ignore packets that are too large */
+    else {
+        datalink_stats_error(
+            PORT_TYPE_ETHERNET, DATALINK_STATS_OVERSIZE_FRAME);
+        pdu_len = 0;
+    }
+
+    return pdu_len;
+}
+
+/* receives an 802.2 framed packet from the receive ring */
+/* returns the number of octets in the PDU, or zero on failure */
+static uint16_t ethernet_ring_receive(BACNET_ADDRESS *src, /* source address */
+    uint8_t *pdu, /* PDU data */
+    uint16_t max_pdu, /* amount of space available in the PDU  */
+    unsigned timeout)
+{ /* number of milliseconds to wait for a packet */
+    struct tpacket_block_desc *block;
+    struct tpacket3_hdr *frame;
+    struct pollfd fds;
+    uint16_t pdu_len = 0; /* return value */
+
+    block = (struct tpacket_block_desc *)&Ring_Buffer[(size_t)Ring_Block *
+        ETHERNET_RING_BLOCK_SIZE];
+    if (!Ring_Frame) {
+        /* wait for the kernel to hand over the block */
+        if (!(block->hdr.bh1.block_status & TP_STATUS_USER)) {
+            fds.fd = eth802_sockfd;
+            fds.events = POLLIN | POLLERR;
+            fds.revents = 0;
+            if (poll(&fds, 1, (int)timeout) <= 0)
+                return 0;
+            if (!(block->hdr.bh1.block_status & TP_STATUS_USER))
+                return 0;
+        }
+        __sync_synchronize();
+        Ring_Frames = block->hdr.bh1.num_pkts;
+        Ring_Frame = (struct tpacket3_hdr *)((uint8_t *)block +
+            block->hdr.bh1.offset_to_first_pkt);
+    }
+    /* the frames of the block, until one is for us */
+    while (Ring_Frames && (pdu_len == 0)) {
+        frame = Ring_Frame;
+        pdu_len = ethernet_frame_pdu(src, pdu, max_pdu,
+            (uint8_t *)frame + frame->tp_mac, (int)frame->tp_snaplen);
+        Ring_Frames--;
+        Ring_Frame =
+            (struct tpacket3_hdr *)((uint8_t *)frame + frame->tp_next_offset);
+    }
+    if (Ring_Frames == 0) {
+        /* hand the block back to the kernel */
+        __sync_synchronize();
+        block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        Ring_Block = (Ring_Block + 1) % ETHERNET_RING_BLOCK_COUNT;
+        Ring_Frame = NULL;
+    }
+
+    return pdu_len;
+}
+
 /* receives an 802.2 framed packet */
 /* returns the number of octets in the PDU, or zero on failure */
 uint16_t ethernet_receive(BACNET_ADDRESS *src, /* source address */
@@ -294,7 +525,6 @@ uint16_t ethernet_receive(BACNET_ADDRESS *src, /* source address */
 { /* number of milliseconds to wait for a packet */
     int received_bytes;
     uint8_t buf[ETHERNET_MPDU_MAX] = { 0 }; /* data */
-    uint16_t pdu_len = 0; /* return value */
     fd_set read_fds;
     int max;
     struct timeval select_timeout;
@@ -302,6 +532,8 @@ uint16_t ethernet_receive(BACNET_ADDRESS *src, /* source address */
     /* Make sure the socket is open */
     if (eth802_sockfd <= 0)
         return 0;
+    if (Ring_Buffer)
+        return ethernet_ring_receive(src, pdu, max_pdu, timeout);
 
     /* we could just use a non-blocking socket, but that consumes all
        the CPU time.  We can use a timeout; it is only supported as
@@ -337,33 +569,7 @@ uint16_t ethernet_receive(BACNET_ADDRESS *src, /* source address */
     if (received_bytes == 0)
         return 0;
 
-    /* the signature of an 802.2 BACnet packet */
-    if ((buf[14] != 0x82) && (buf[15] != 0x82)) {
-        /*fprintf(stderr,"ethernet: Non-BACnet packet\n"); */
-        return 0;
-    }
-    /* copy the source address */
-    src->mac_len = 6;
-    memmove(src->mac, &buf[6], 6);
-
-    /* check destination address for when */
-    /* the Ethernet card is in promiscious mode */
-    if ((memcmp(&buf[0], Ethernet_MAC_Address, 6) != 0) &&
-        (memcmp(&buf[0], Ethernet_Broadcast, 6) != 0)) {
-        /*fprintf(stderr, "ethernet: This packet isn't for us\n"); */
-        return 0;
-    }
-
-    (void)decode_unsigned16(&buf[12], &pdu_len);
-    pdu_len -= 3 /* DSAP, SSAP, LLC Control */;
-    /* copy the buffer into the PDU */
-    if (pdu_len < max_pdu)
-        memmove(&pdu[0], &buf[17], pdu_len);
-    /* ignore packets that are too large */
-    else
-        pdu_len = 0;
-
-    return pdu_len;
+    return ethernet_frame_pdu(src, pdu, max_pdu, buf, received_bytes);
 }
 
 void ethernet_set_my_address(BACNET_ADDRESS *my_address)
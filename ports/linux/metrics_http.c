@@ -0,0 +1,225 @@
+/**
+ * @file
+ * @brief A small HTTP endpoint that serves the counters of the stack.
+ *
+ * The endpoint has its own thread, which only reads the snapshot that
+ * the stack thread publishes with bacnet_metrics_publish(), so that a
+ * scrape never holds a lock the stack needs or touches the state of the
+ * stack.  Each connection is answered and closed, as HTTP/1.0, one at a
+ * time: GET /metrics answers the snapshot as text, before the first
+ * snapshot is published it answers 503, and other paths answer 404.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/service/metrics.h"
+#include "metrics_http.h"
+
+static int Metrics_Socket = -1;
+static pthread_t Metrics_Thread;
+static volatile bool Metrics_Running;
+/* used only by the thread of the endpoint */
+static BACNET_METRICS_SNAPSHOT Metrics_Snapshot;
+static char Metrics_Text[METRICS_HTTP_BUFFER_SIZE];
+
+/**
+ * @brief Write all of a buffer to a connection
+ * @param fd [in] the connection
+ * @param buffer [in] the octets to write
+ * @param length [in] the number of octets
+ */
+static void metrics_http_write(int fd, const char *buffer, size_t length)
+{
+    ssize_t written;
+
+    while (length > 0) {
+        written = send(fd, buffer, length, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        buffer += written;
+        length -= (size_t)written;
+    }
+}
+
+/**
+ * @brief Write a response to a connection
+ * @param fd [in] the connection
+ * @param status [in] the status line, such as "200 OK"
+ * @param body [in] the body of the response
+ * @param length [in] the octets of the body
+ */
+static void metrics_http_respond(
+    int fd, const char *status, const char *body, size_t length)
+{
+    char header[160];
+    int len;
+
+    len = snprintf(header, sizeof(header),
+        "HTTP/1.0 %s\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: %lu\r\n"
+        "Connection: close\r\n\r\n",
+        status, (unsigned long)length);
+    if ((len > 0) && ((size_t)len < sizeof(header))) {
+        metrics_http_write(fd, header, (size_t)len);
+        metrics_http_write(fd, body, length);
+    }
+}
+
+/**
+ * @brief Read the request line of a connection, and answer it
+ * @param fd [in] the connection
+ */
+static void metrics_http_serve(int fd)
+{
+    static const char not_found[] = "Not Found\n";
+    static const char unavailable[] = "No metrics yet\n";
+    static const char too_large[] = "Metrics do not fit the buffer\n";
+    char request[256];
+    size_t length = 0;
+    ssize_t received;
+    int len;
+
+    /* only the request line is needed */
+    while (length < (sizeof(request) - 1)) {
+        received = recv(fd, &request[length], sizeof(request) - 1 - length, 0);
+        if (received <= 0) {
+            if ((received < 0) && (errno == EINTR)) {
+                continue;
+            }
+            break;
+        }
+        length += (size_t)received;
+        request[length] = 0;
+        if (strchr(request, '\n')) {
+            break;
+        }
+    }
+    request[length] = 0;
+    if ((strncmp(request, "GET /metrics ", 13) != 0) &&
+        (strncmp(request, "GET /metrics\r", 13) != 0) &&
+        (strncmp(request, "GET /metrics?", 13) != 0)) {
+        metrics_http_respond(
+            fd, "404 Not Found", not_found, sizeof(not_found) - 1);
+    } else if (!bacnet_metrics_read(&Metrics_Snapshot)) {
+        metrics_http_respond(fd, "503 Service Unavailable", unavailable,
+            sizeof(unavailable) - 1);
+    } else {
+        len = bacnet_metrics_text(
+            &Metrics_Snapshot, Metrics_Text, sizeof(Metrics_Text));
+        if (len < 0) {
+            metrics_http_respond(fd, "500 Internal Server Error", too_large,
+                sizeof(too_large) - 1);
+        } else {
+            metrics_http_respond(fd, "200 OK", Metrics_Text, (size_t)len);
+        }
+    }
+}
+
+/**
+ * @brief Accept and answer the connections until the endpoint is stopped
+ * @param arg - not used
+ * @return NULL
+ */
+static void *metrics_http_thread(void *arg)
+{
+    struct timeval timeout;
+    struct pollfd fds;
+    int fd;
+
+    (void)arg;
+    timeout.tv_sec = METRICS_HTTP_TIMEOUT_MS / 1000;
+    timeout.tv_usec = (METRICS_HTTP_TIMEOUT_MS % 1000) * 1000;
+    while (Metrics_Running) {
+        fds.fd = Metrics_Socket;
+        fds.events = POLLIN;
+        fds.revents = 0;
+        /* wake up each second to see if the endpoint was stopped */
+        if (poll(&fds, 1, 1000) <= 0) {
+            continue;
+        }
+        fd = accept(Metrics_Socket, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        /* a slow client does not keep the others waiting for long */
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        metrics_http_serve(fd);
+        close(fd);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Start the endpoint on a TCP port of all the interfaces
+ * @param port [in] the TCP port, such as 9100
+ * @return true if the endpoint was started, or was already running
+ */
+bool metrics_http_start(uint16_t port)
+{
+    struct sockaddr_in sin = { 0 };
+    int value = 1;
+
+    if (Metrics_Running) {
+        return true;
+    }
+    Metrics_Socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (Metrics_Socket < 0) {
+        return false;
+    }
+    setsockopt(
+        Metrics_Socket, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_ANY);
+    sin.sin_port = htons(port);
+    if ((bind(Metrics_Socket, (struct sockaddr *)&sin, sizeof(sin)) < 0) ||
+        (listen(Metrics_Socket, 4) < 0)) {
+        close(Metrics_Socket);
+        Metrics_Socket = -1;
+        return false;
+    }
+    Metrics_Running = true;
+    if (pthread_create(
+            &Metrics_Thread, NULL, metrics_http_thread, NULL) != 0) {
+        Metrics_Running = false;
+        close(Metrics_Socket);
+        Metrics_Socket = -1;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Stop the endpoint, and wait for its thread to end
+ */
+void metrics_http_stop(void)
+{
+    if (!Metrics_Running) {
+        return;
+    }
+    Metrics_Running = false;
+    pthread_join(Metrics_Thread, NULL);
+    close(Metrics_Socket);
+    Metrics_Socket = -1;
+}
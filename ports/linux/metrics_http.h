@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief A small HTTP endpoint that serves the published snapshot of the
+ *  counters of the stack as GET /metrics in the Prometheus text format,
+ *  from its own thread, so that a scrape never waits on the stack.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef METRICS_HTTP_H
+#define METRICS_HTTP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* octets of the largest metrics text that is served */
+#ifndef METRICS_HTTP_BUFFER_SIZE
+#define METRICS_HTTP_BUFFER_SIZE (64UL * 1024UL)
+#endif
+
+/* milliseconds that a client has to send its request */
+#ifndef METRICS_HTTP_TIMEOUT_MS
+#define METRICS_HTTP_TIMEOUT_MS 2000
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool metrics_http_start(uint16_t port);
+BACNET_STACK_EXPORT
+void metrics_http_stop(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
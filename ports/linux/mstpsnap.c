@@ -32,17 +32,24 @@
  License.
  -------------------------------------------
 ####COPYRIGHTEND####*/
+#ifndef _GNU_SOURCE
+/* for sendmmsg() */
+#define _GNU_SOURCE
+#endif
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
-#/* BACnet Stack defines - first */
+#include <pthread.h>
+#include <time.h>
+/* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/sys/bytes.h"
+#include "bacnet/basic/sys/ringbuf_spsc.h"
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstp.h"
 #include "bacnet/datalink/dlmstp.h"
@@ -68,6 +75,33 @@ static uint8_t RxBuffer[DLMSTP_MPDU_MAX];
 static uint8_t TxBuffer[DLMSTP_MPDU_MAX];
 static struct mstimer Silence_Timer;
 
+/* number of SNAP frames waiting for the sender - a power of two */
+#ifndef SNAP_FRAME_COUNT
+#define SNAP_FRAME_COUNT 256
+#endif
+/* number of SNAP frames sent with one sendmmsg() call */
+#ifndef SNAP_SEND_BATCH_SIZE
+#define SNAP_SEND_BATCH_SIZE 32
+#endif
+/* a received MS/TP frame wrapped in a SNAP frame, waiting to be sent */
+struct snap_frame {
+    /* when the preamble of the MS/TP frame was received */
+    struct timespec ts;
+    uint16_t mtu_len;
+    uint8_t mtu[1500];
+};
+static struct snap_frame Snap_Buffer[SNAP_FRAME_COUNT];
+/* the receive state machine is the producer, and the sender thread
+   is the consumer */
+static RINGBUF_SPSC Snap_Queue;
+static struct snap_frame Snap_Batch[SNAP_SEND_BATCH_SIZE];
+static pthread_t Snap_Sender;
+static int Snap_Socket = -1;
+static volatile bool Exit_Requested;
+/* frames captured, and frames lost because the sender fell behind */
+static uint32_t Packet_Count;
+static uint32_t Dropped_Count;
+
 static uint32_t Timer_Silence(void *pArg)
 {
     uint32_t delta_time = 0;
@@ -167,14 +201,29 @@ static int network_init(const char *name, int protocol)
     return sockfd;
 }
 
+/**
+ * @brief Wrap the received MS/TP frame in a SNAP frame, and queue it
+ *  for the sender, so that the receive state machine never waits for
+ *  the network
+ * @param mstp_port - port with the received frame
+ * @param ts - when the preamble of the frame was received
+ */
 static void snap_received_packet(
-    struct mstp_port_struct_t *mstp_port, int sockfd)
+    struct mstp_port_struct_t *mstp_port, const struct timespec *ts)
 {
+    struct snap_frame *frame;
+    uint8_t *mtu;
     uint16_t mtu_len = 0; /* number of octets of packet saved in file */
     unsigned i = 0; /* counter */
-    static uint8_t mtu[1500] = { 0 };
     uint16_t max_data = 0;
 
+    frame = (struct snap_frame *)Ringbuf_SPSC_Data_Peek(&Snap_Queue);
+    if (!frame) {
+        Dropped_Count++;
+        return;
+    }
+    frame->ts = *ts;
+    mtu = &frame->mtu[0];
     mtu[0] = 0;
     mtu[1] = 0;
     mtu[2] = 0;
@@ -196,8 +245,8 @@ static void snap_received_packet(
     mtu[19] = 0x90; /* Organization Code: Cimetrics */
     mtu[20] = 0x00; /* Protocol ID */
     mtu[21] = 0x01; /* Protocol ID */
-    mtu[22] = 0x00; /* delta time */
-    mtu[23] = 0x00; /* delta time */
+    mtu[22] = 0x00; /* delta time - set by the sender */
+    mtu[23] = 0x00; /* delta time - set by the sender */
     mtu[24] = 0x80; /* unknown byte */
     mtu[25] = mstp_port->FrameType;
     mtu[26] = mstp_port->DestinationAddress;
@@ -208,6 +257,7 @@ static void snap_received_packet(
     mtu_len = 31;
     if (mstp_port->DataLength) {
         max_data = min(mstp_port->InputBufferSize, mstp_port->DataLength);
+        max_data = min(max_data, sizeof(frame->mtu) - 31 - 2);
         for (i = 0; i < max_data; i++) {
             mtu[31 + i] = mstp_port->InputBuffer[i];
         }
@@ -217,7 +267,97 @@ static void snap_received_packet(
     }
     /* Ethernet length is data only - not address or length bytes */
     encode_unsigned16(&mtu[12], mtu_len - 14);
-    (void)write(sockfd, &mtu[0], mtu_len);
+    frame->mtu_len = mtu_len;
+    if (Ringbuf_SPSC_Data_Put(&Snap_Queue, frame)) {
+        Packet_Count++;
+    } else {
+        Dropped_Count++;
+    }
+}
+
+/**
+ * @brief Milliseconds from one frame to the next, for the delta time
+ *  of the SNAP frame
+ * @param old - when the previous frame was received
+ * @param now - when the frame was received
+ * @return the milliseconds from old to now, at most 0xFFFF
+ */
+static uint16_t snap_delta_time(
+    const struct timespec *old, const struct timespec *now)
+{
+    int64_t ms;
+
+    ms = ((int64_t)now->tv_sec - old->tv_sec) * 1000 +
+        (now->tv_nsec - old->tv_nsec) / 1000000L;
+    if (ms < 0) {
+        ms = 0;
+    } else if (ms > 0xFFFF) {
+        ms = 0xFFFF;
+    }
+
+    return (uint16_t)ms;
+}
+
+/**
+ * @brief Take the queued SNAP frames, and send them with one sendmmsg()
+ *  call per batch of frames, until the reader stops
+ * @param arg - not used
+ * @return NULL
+ */
+static void *snap_sender_thread(void *arg)
+{
+    struct mmsghdr msg[SNAP_SEND_BATCH_SIZE];
+    struct iovec iov[SNAP_SEND_BATCH_SIZE];
+    struct timespec old_ts = { 0 };
+    const struct timespec idle = { 0, 1000000L };
+    unsigned count, sent, i;
+    uint32_t send_failed = 0;
+    int rv;
+
+    (void)arg;
+    for (;;) {
+        count = 0;
+        while ((count < SNAP_SEND_BATCH_SIZE) &&
+            Ringbuf_SPSC_Pop(&Snap_Queue, (uint8_t *)&Snap_Batch[count])) {
+            count++;
+        }
+        if (count == 0) {
+            if (Exit_Requested) {
+                break;
+            }
+            nanosleep(&idle, NULL);
+            continue;
+        }
+        memset(msg, 0, sizeof(msg));
+        for (i = 0; i < count; i++) {
+            if (old_ts.tv_sec || old_ts.tv_nsec) {
+                encode_unsigned16(&Snap_Batch[i].mtu[22],
+                    snap_delta_time(&old_ts, &Snap_Batch[i].ts));
+            }
+            old_ts = Snap_Batch[i].ts;
+            iov[i].iov_base = &Snap_Batch[i].mtu[0];
+            iov[i].iov_len = Snap_Batch[i].mtu_len;
+            msg[i].msg_hdr.msg_iov = &iov[i];
+            msg[i].msg_hdr.msg_iovlen = 1;
+        }
+        sent = 0;
+        while (sent < count) {
+            rv = sendmmsg(Snap_Socket, &msg[sent], count - sent, 0);
+            if (rv <= 0) {
+                if ((rv < 0) && (errno == EINTR)) {
+                    continue;
+                }
+                break;
+            }
+            sent += rv;
+        }
+        send_failed += count - sent;
+        fprintf(stdout, "\r%u packets, %u dropped", (unsigned)Packet_Count,
+            (unsigned)(Dropped_Count + send_failed));
+        fflush(stdout);
+    }
+
+    return NULL;
 }
 
 static void cleanup(void)
@@ -229,8 +369,8 @@ static void sig_int(int signo)
 {
     (void)signo;
 
-    cleanup();
-    exit(0);
+    /* the main loop stops, and the sender sends what is queued */
+    Exit_Requested = true;
 }
 
 void signal_init(void)
@@ -246,9 +386,10 @@ int main(int argc, char *argv[])
 {
     struct mstp_port_struct_t *mstp_port;
     long my_baud = 38400;
-    uint32_t packet_count = 0;
     int sockfd = -1;
     char *my_interface = "eth0";
+    MSTP_RECEIVE_STATE receive_state = MSTP_RECEIVE_STATE_IDLE;
+    struct timespec frame_ts = { 0 };
 
     /* mimic our pointer in the state machine */
     mstp_port = &MSTP_Port;
@@ -282,6 +423,9 @@ int main(int argc, char *argv[])
     if (sockfd == -1) {
         return 1;
     }
+    Snap_Socket = sockfd;
+    Ringbuf_SPSC_Init(&Snap_Queue, (uint8_t *)&Snap_Buffer,
+        sizeof(struct snap_frame), SNAP_FRAME_COUNT);
     RS485_Set_Baud_Rate(my_baud);
     RS485_Initialize();
     MSTP_Port.InputBuffer = &RxBuffer[0];
@@ -303,25 +447,32 @@ int main(int argc, char *argv[])
 #else
     signal_init();
 #endif
-    /* run forever */
-    for (;;) {
+    if (pthread_create(&Snap_Sender, NULL, snap_sender_thread, NULL) != 0) {
+        perror("Unable to start the sender");
+        return 1;
+    }
+    /* run until asked to stop */
+    while (!Exit_Requested) {
         RS485_Check_UART_Data(mstp_port);
         MSTP_Receive_Frame_FSM(mstp_port);
+        if ((receive_state == MSTP_RECEIVE_STATE_IDLE) &&
+            (mstp_port->receive_state != MSTP_RECEIVE_STATE_IDLE)) {
+            /* the preamble of a frame, which is when the frame began,
+               rather than when the rest of it was received */
+            clock_gettime(CLOCK_REALTIME, &frame_ts);
+        }
+        receive_state = mstp_port->receive_state;
         /* process the data portion of the frame */
         if (mstp_port->ReceivedValidFrame) {
             mstp_port->ReceivedValidFrame = false;
-            snap_received_packet(mstp_port, sockfd);
-            packet_count++;
+            snap_received_packet(mstp_port, &frame_ts);
         } else if (mstp_port->ReceivedInvalidFrame) {
             mstp_port->ReceivedInvalidFrame = false;
-            fprintf(stderr, "ReceivedInvalidFrame\n");
-            snap_received_packet(mstp_port, sockfd);
-            packet_count++;
-        }
-        if (!(packet_count % 100)) {
-            fprintf(stdout, "\r%hu packets", packet_count);
+            snap_received_packet(mstp_port, &frame_ts);
         }
     }
+    pthread_join(Snap_Sender, NULL);
+    fprintf(stdout, "\n");
 
     return 0;
 }
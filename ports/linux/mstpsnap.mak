@@ -14,7 +14,7 @@ DEFINES = $(BACNET_DEFINES) $(BACDL_DEFINE)
 BACNET_PORT = linux
 BACNET_PORT_DIR = .
 BACNET_SOURCE_DIR = ../../src
-BACNET_INCLUDE = ../../include
+BACNET_INCLUDE = ../../src
 
 # Compiler Setup
 INCLUDES = -I$(BACNET_INCLUDE) -I$(BACNET_PORT_DIR)
@@ -35,14 +35,17 @@ LFLAGS = -Wl,-Map=$(TARGET).map,$(LIBRARIES),--gc-sections
 
 SRCS = mstpsnap.c \
 	${BACNET_PORT_DIR}/rs485.c \
-	${BACNET_PORT_DIR}/timer.c \
-	${BACNET_SOURCE_DIR}/bacint.c \
-	${BACNET_SOURCE_DIR}/mstp.c \
-	${BACNET_SOURCE_DIR}/fifo.c \
-	${BACNET_SOURCE_DIR}/mstptext.c \
-	${BACNET_SOURCE_DIR}/debug.c \
-	${BACNET_SOURCE_DIR}/indtext.c \
-	${BACNET_SOURCE_DIR}/crc.c
+	${BACNET_PORT_DIR}/mstimer-init.c \
+	${BACNET_SOURCE_DIR}/bacnet/bacint.c \
+	${BACNET_SOURCE_DIR}/bacnet/datalink/mstp.c \
+	${BACNET_SOURCE_DIR}/bacnet/basic/sys/fifo.c \
+	${BACNET_SOURCE_DIR}/bacnet/basic/sys/mstimer.c \
+	${BACNET_SOURCE_DIR}/bacnet/basic/sys/ringbuf_spsc.c \
+	${BACNET_SOURCE_DIR}/bacnet/datalink/mstptext.c \
+	${BACNET_SOURCE_DIR}/bacnet/basic/sys/debug.c \
+	${BACNET_SOURCE_DIR}/bacnet/indtext.c \
+	${BACNET_SOURCE_DIR}/bacnet/datalink/cobs.c \
+	${BACNET_SOURCE_DIR}/bacnet/datalink/crc.c
 
 OBJS = ${SRCS:.c=.o}
 
@@ -390,6 +390,7 @@ void RS485_Send_Frame(
     uint32_t baud;
     ssize_t written = 0;
     int greska;
+    uint64_t tx_nsec;
     SHARED_MSTP_DATA *poSharedData = NULL;
 
     if (mstp_port) {
@@ -438,7 +439,7 @@ void RS485_Send_Frame(
         greska = errno;
         if (written <= 0) {
             printf("write error: %s\n", strerror(greska));
-        } else {
+        } else if (!poSharedData->RS485_No_Drain) {
             /* wait until all output has been transmitted. */
             tcdrain(poSharedData->RS485_Handle);
         }
@@ -447,6 +448,17 @@ void RS485_Send_Frame(
         if (mstp_port) {
             mstp_port->SilenceTimerReset((void *)mstp_port);
         }
+        if (poSharedData->RS485_No_Drain && (written > 0) && baud) {
+            /* the line is silent once the last octet is transmitted,
+               at 10 bit times per octet */
+            tx_nsec = ((uint64_t)written * 10000000000ULL) / baud;
+            poSharedData->start.tv_sec += tx_nsec / 1000000000ULL;
+            poSharedData->start.tv_nsec += tx_nsec % 1000000000ULL;
+            if (poSharedData->start.tv_nsec >= 1000000000L) {
+                poSharedData->start.tv_sec++;
+                poSharedData->start.tv_nsec -= 1000000000L;
+            }
+        }
     }
 
     return;
@@ -533,6 +545,33 @@ void RS485_Check_UART_Data(struct mstp_port_struct_t *mstp_port)
     }
 }
 
+/**
+ * @brief Set or clear the low latency mode of a serial port, in which
+ *  the driver hands each received octet up at once instead of batching
+ *  them, such as the 16 ms latency timer of FTDI USB adapters
+ * @param handle - file handle of the open serial port
+ * @param enable - true to set ASYNC_LOW_LATENCY, false to clear it
+ * @return true if the driver supports the setting
+ */
+bool RS485_Set_Low_Latency(int handle, bool enable)
+{
+    struct serial_struct serinfo;
+
+    if (ioctl(handle, TIOCGSERIAL, &serinfo) != 0) {
+        return false;
+    }
+    if (enable) {
+        serinfo.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        serinfo.flags &= ~ASYNC_LOW_LATENCY;
+    }
+    if (ioctl(handle, TIOCSSERIAL, &serinfo) != 0) {
+        return false;
+    }
+
+    return true;
+}
+
 void RS485_Cleanup(void)
 {
     /* restore the old port settings */
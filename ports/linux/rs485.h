@@ -74,6 +74,10 @@ extern "C" {
         uint32_t baud);
 
     BACNET_STACK_EXPORT
+    bool RS485_Set_Low_Latency(
+        int handle,
+        bool enable);
+    BACNET_STACK_EXPORT
     void RS485_Cleanup(
         void);
     BACNET_STACK_EXPORT
@@ -0,0 +1,252 @@
+/**
+ * @file
+ * @brief Write-behind of the snapshot of the object database to a file.
+ *
+ * The snapshot is kept in a buffer in RAM, so that handling a
+ * WriteProperty never waits on storage.  The changes are coalesced in
+ * the buffer, where a newer write of a property replaces the older
+ * one, and are written to the file in a batch when the interval has
+ * passed or enough records were appended.
+ *
+ * The records are append-only, so a batch is written in an order that
+ * survives a stop at any point: first the appended records, then the
+ * header that commits them, then the older records that were killed in
+ * place.  After a stop before the header, the appended records are
+ * beyond the committed end and are ignored; after a stop before the
+ * kills, the older record with the same key is killed again when the
+ * snapshot is loaded.  When the buffer was compacted the records moved,
+ * so the whole snapshot is written to a new file that then replaces
+ * the old one.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/snapshot.h"
+#include "snapshot_file.h"
+
+static uint8_t *Snapshot_Buffer;
+static int Snapshot_File = -1;
+static char Snapshot_Pathname[PATH_MAX];
+/* octets of the buffer that are in the file */
+static size_t Snapshot_Flushed;
+/* generation of the records that are in the file */
+static unsigned Snapshot_Flushed_Generation;
+/* the whole snapshot is written again, such as after a failed write */
+static bool Snapshot_Rewrite;
+/* milliseconds since the last write to the file */
+static uint32_t Snapshot_Elapsed;
+
+/**
+ * @brief Write a range of the buffer to the file, and wait for it to
+ *  reach the storage
+ * @param fd [in] the file
+ * @param offset [in] first octet of the range
+ * @param length [in] octets of the range
+ * @return true if the range was written
+ */
+static bool snapshot_file_write(int fd, size_t offset, size_t length)
+{
+    ssize_t written;
+
+    while (length > 0) {
+        written =
+            pwrite(fd, &Snapshot_Buffer[offset], length, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        offset += (size_t)written;
+        length -= (size_t)written;
+    }
+
+    return (fdatasync(fd) == 0);
+}
+
+/**
+ * @brief Write the whole snapshot to a new file, which then replaces
+ *  the old file
+ * @return true if the snapshot was written
+ */
+static bool snapshot_file_rewrite(void)
+{
+    char pathname[PATH_MAX + 4];
+    size_t used = snapshot_used();
+    int fd;
+
+    snprintf(pathname, sizeof(pathname), "%s.new", Snapshot_Pathname);
+    fd = open(pathname, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (!snapshot_file_write(fd, 0, used) ||
+        (rename(pathname, Snapshot_Pathname) != 0)) {
+        close(fd);
+        (void)unlink(pathname);
+        return false;
+    }
+    close(Snapshot_File);
+    Snapshot_File = fd;
+
+    return true;
+}
+
+/**
+ * @brief Keep the snapshot of the object database in a buffer that is
+ *  written behind to a file.  The snapshot in the file, if any, is read
+ *  into the buffer; call snapshot_restore() after the objects are
+ *  initialized to replay it.
+ * @param pathname [in] name of the snapshot file
+ * @param buffer [in] the buffer, which is used until the file is closed
+ * @param size [in] octets of the buffer
+ * @return true if the file holds a complete snapshot
+ */
+bool snapshot_file_open(const char *pathname, uint8_t *buffer, size_t size)
+{
+    size_t length = 0;
+    ssize_t count;
+    bool status;
+
+    snapshot_file_close();
+    if (!pathname || !buffer || (size <= SNAPSHOT_HEADER_SIZE) ||
+        (strlen(pathname) >= sizeof(Snapshot_Pathname))) {
+        return false;
+    }
+    Snapshot_File = open(pathname, O_RDWR | O_CREAT, 0644);
+    if (Snapshot_File < 0) {
+        return false;
+    }
+    while (length < size) {
+        count = pread(Snapshot_File, &buffer[length], size - length,
+            (off_t)length);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (count == 0) {
+            break;
+        }
+        length += (size_t)count;
+    }
+    memset(&buffer[length], 0, size - length);
+    snprintf(Snapshot_Pathname, sizeof(Snapshot_Pathname), "%s", pathname);
+    Snapshot_Buffer = buffer;
+    status = snapshot_init(buffer, size);
+    /* the records that were damaged in the file are beyond the end */
+    Snapshot_Flushed = snapshot_used();
+    Snapshot_Flushed_Generation = snapshot_generation();
+    Snapshot_Rewrite = false;
+    Snapshot_Elapsed = 0;
+
+    return status;
+}
+
+/**
+ * @brief Write the changes to the snapshot to its file now, such as
+ *  before a planned power down
+ * @return true if the file holds all of the changes
+ */
+bool snapshot_file_flush(void)
+{
+    size_t offset = 0;
+    size_t length = 0;
+    size_t used;
+    size_t end;
+    bool dirty;
+    bool status = true;
+
+    if (Snapshot_File < 0) {
+        return false;
+    }
+    Snapshot_Elapsed = 0;
+    dirty = snapshot_dirty(&offset, &length);
+    if (!dirty && !Snapshot_Rewrite) {
+        return true;
+    }
+    used = snapshot_used();
+    if (Snapshot_Rewrite ||
+        (snapshot_generation() != Snapshot_Flushed_Generation)) {
+        status = snapshot_file_rewrite();
+    } else {
+        if (used > Snapshot_Flushed) {
+            status = snapshot_file_write(
+                Snapshot_File, Snapshot_Flushed, used - Snapshot_Flushed);
+        }
+        if (status && (offset < SNAPSHOT_HEADER_SIZE)) {
+            status =
+                snapshot_file_write(Snapshot_File, 0, SNAPSHOT_HEADER_SIZE);
+        }
+        end = offset + length;
+        if (end > Snapshot_Flushed) {
+            end = Snapshot_Flushed;
+        }
+        if (offset < SNAPSHOT_HEADER_SIZE) {
+            offset = SNAPSHOT_HEADER_SIZE;
+        }
+        if (status && (end > offset)) {
+            status =
+                snapshot_file_write(Snapshot_File, offset, end - offset);
+        }
+    }
+    if (status) {
+        Snapshot_Flushed = used;
+        Snapshot_Flushed_Generation = snapshot_generation();
+    }
+    /* the range that changed was taken, so write all of it next time */
+    Snapshot_Rewrite = !status;
+
+    return status;
+}
+
+/**
+ * @brief Write the changes to the snapshot to its file when the
+ *  interval has passed, or when enough records were appended
+ * @param milliseconds [in] milliseconds since the last call
+ */
+void snapshot_file_timer(uint16_t milliseconds)
+{
+    size_t used;
+
+    if (Snapshot_File < 0) {
+        return;
+    }
+    if (Snapshot_Elapsed < SNAPSHOT_FILE_INTERVAL_MS) {
+        Snapshot_Elapsed += milliseconds;
+    }
+    used = snapshot_used();
+    if ((Snapshot_Elapsed >= SNAPSHOT_FILE_INTERVAL_MS) ||
+        (used >= (Snapshot_Flushed + SNAPSHOT_FILE_THRESHOLD))) {
+        (void)snapshot_file_flush();
+    }
+}
+
+/**
+ * @brief Write the changes to the snapshot to its file, and stop
+ *  keeping the snapshot.  The file keeps the snapshot for the next
+ *  start.
+ */
+void snapshot_file_close(void)
+{
+    if (Snapshot_File >= 0) {
+        (void)snapshot_file_flush();
+        (void)snapshot_init(NULL, 0);
+        close(Snapshot_File);
+        Snapshot_File = -1;
+        Snapshot_Buffer = NULL;
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ * @file
+ * @brief Write-behind of the snapshot of the object database to a file,
+ *  so that the changes to the objects are saved in batches rather than
+ *  as each WriteProperty is handled.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef SNAPSHOT_FILE_H
+#define SNAPSHOT_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* milliseconds that a change waits before it is written to the file */
+#ifndef SNAPSHOT_FILE_INTERVAL_MS
+#define SNAPSHOT_FILE_INTERVAL_MS 30000
+#endif
+
+/* octets of appended records that are written to the file without
+   waiting for the interval */
+#ifndef SNAPSHOT_FILE_THRESHOLD
+#define SNAPSHOT_FILE_THRESHOLD 4096
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool snapshot_file_open(const char *pathname, uint8_t *buffer, size_t size);
+BACNET_STACK_EXPORT
+bool snapshot_file_flush(void);
+BACNET_STACK_EXPORT
+void snapshot_file_timer(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void snapshot_file_close(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
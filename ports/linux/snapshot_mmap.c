@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @brief Snapshot of the object database in a memory mapped file.
+ *
+ * The file is mapped shared and given to the snapshot as its buffer, so
+ * each change to the objects is written to the page cache as it is
+ * recorded, and the kernel writes the changed pages back to the file in
+ * the background.  On restart the mapped file is the snapshot: it is
+ * checked in place and replayed with snapshot_restore(), and nothing is
+ * read or copied.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/snapshot.h"
+#include "snapshot_mmap.h"
+
+static uint8_t *Snapshot_Address;
+static size_t Snapshot_Length;
+
+/**
+ * @brief Keep the snapshot of the object database in a memory mapped
+ *  file.  The file is created if needed.  Call snapshot_restore() after
+ *  the objects are initialized to replay the snapshot in the file.
+ * @param pathname [in] name of the snapshot file
+ * @param size [in] octets of the snapshot file
+ * @return true if the file holds a complete snapshot
+ */
+bool snapshot_mmap_open(const char *pathname, size_t size)
+{
+    struct stat st;
+    void *address;
+    int fd;
+
+    snapshot_mmap_close();
+    if (!pathname || (size <= SNAPSHOT_HEADER_SIZE)) {
+        return false;
+    }
+    fd = open(pathname, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if ((fstat(fd, &st) != 0) ||
+        (((size_t)st.st_size != size) && (ftruncate(fd, size) != 0))) {
+        close(fd);
+        return false;
+    }
+    address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    /* the mapping stays valid after the file is closed */
+    close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    Snapshot_Address = address;
+    Snapshot_Length = size;
+
+    return snapshot_init(Snapshot_Address, Snapshot_Length);
+}
+
+/**
+ * @brief Write the changed pages of the snapshot back to its file
+ * @param wait [in] true to wait for the write to finish, such as before
+ *  a planned power down, or false to only start the write
+ * @return true if the write was started or finished
+ */
+bool snapshot_mmap_sync(bool wait)
+{
+    size_t offset = 0;
+    size_t length = 0;
+    long page_size;
+    size_t start;
+
+    if (!Snapshot_Address) {
+        return false;
+    }
+    if (!snapshot_dirty(&offset, &length)) {
+        return true;
+    }
+    page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0) {
+        page_size = 4096;
+    }
+    /* msync wants the address on a page boundary */
+    start = offset - (offset % (size_t)page_size);
+    length += offset - start;
+
+    return (msync(&Snapshot_Address[start], length,
+                wait ? MS_SYNC : MS_ASYNC) == 0);
+}
+
+/**
+ * @brief Stop keeping the snapshot in its file.  The file keeps the
+ *  snapshot for the next start.
+ */
+void snapshot_mmap_close(void)
+{
+    if (Snapshot_Address) {
+        (void)snapshot_init(NULL, 0);
+        (void)msync(Snapshot_Address, Snapshot_Length, MS_SYNC);
+        munmap(Snapshot_Address, Snapshot_Length);
+        Snapshot_Address = NULL;
+        Snapshot_Length = 0;
+    }
+}
@@ -0,0 +1,32 @@
+/**
+ * @file
+ * @brief Snapshot of the object database in a memory mapped file, so that
+ *  the changes to the objects survive a restart and are restored without
+ *  reading the file.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef SNAPSHOT_MMAP_H
+#define SNAPSHOT_MMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool snapshot_mmap_open(const char *pathname, size_t size);
+BACNET_STACK_EXPORT
+bool snapshot_mmap_sync(bool wait);
+BACNET_STACK_EXPORT
+void snapshot_mmap_close(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
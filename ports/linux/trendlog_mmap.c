@@ -0,0 +1,324 @@
+/**
+ * @file
+ * @brief Trend Log and Event Log storage in memory mapped ring files.
+ *
+ * Each file holds a small header, the state of the circular buffer, and
+ * the records of one trend log or event log. The file is mapped shared,
+ * so records are written to the page cache as they are inserted and the
+ * kernel writes them back to the file. On restart the header is checked and
+ * the log carries on from the stored buffer state, without reading or
+ * replaying any records. A file whose header does not match the record
+ * layout or the buffer size is started again as an empty log.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/event_log.h"
+#include "bacnet/basic/object/trendlog.h"
+#include "trendlog_mmap.h"
+
+/* "BTLG" */
+#define TRENDLOG_MMAP_MAGIC 0x42544C47UL
+/* "BELG" */
+#define EVENT_LOG_MMAP_MAGIC 0x42454C47UL
+#define TRENDLOG_MMAP_VERSION 1
+/* the records start at a fixed offset after the header */
+#define TRENDLOG_MMAP_HEADER_SIZE 64
+
+struct trendlog_mmap_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t buffer_size;
+    TL_LOG_RING ring;
+};
+
+struct trendlog_mmap_file {
+    bool in_use;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    uint8_t *address;
+    size_t length;
+};
+
+static struct trendlog_mmap_file Trendlog_File[TRENDLOG_MMAP_MAX];
+
+static void trendlog_mmap_log_close(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+
+/**
+ * @brief Find the file of a trend log or event log
+ * @param object_type [in] OBJECT_TRENDLOG or OBJECT_EVENT_LOG
+ * @param object_instance [in] BACnet object instance number of the log
+ * @return the file, or NULL if the log has none
+ */
+static struct trendlog_mmap_file *trendlog_mmap_find(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    unsigned i;
+
+    for (i = 0; i < TRENDLOG_MMAP_MAX; i++) {
+        if (Trendlog_File[i].in_use &&
+            (Trendlog_File[i].object_type == object_type) &&
+            (Trendlog_File[i].object_instance == object_instance)) {
+            return &Trendlog_File[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Give the records in a ring file to a trend log or event log
+ * @param object_type [in] OBJECT_TRENDLOG or OBJECT_EVENT_LOG
+ * @param object_instance [in] BACnet object instance number of the log
+ * @param records [in] the records in the ring file, or NULL for RAM
+ * @param buffer_size [in] number of records in the ring file
+ * @param ring [in] the state of the circular buffer in the ring file
+ * @return true if the log uses the records
+ */
+static bool trendlog_mmap_buffer_set(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint8_t *records,
+    uint32_t buffer_size,
+    TL_LOG_RING *ring)
+{
+    if (object_type == OBJECT_EVENT_LOG) {
+        return Event_Log_Buffer_Set(
+            object_instance, (EL_DATA_REC *)records, buffer_size, ring);
+    }
+
+    return Trend_Log_Buffer_Set(
+        object_instance, (TL_DATA_REC *)records, buffer_size, ring);
+}
+
+/**
+ * @brief Store the records of a log in a memory mapped ring file.
+ *  The file is created if needed, and an existing log is recovered.
+ * @param object_type [in] OBJECT_TRENDLOG or OBJECT_EVENT_LOG
+ * @param object_instance [in] BACnet object instance number of the log
+ * @param pathname [in] name of the ring file
+ * @param buffer_size [in] number of records in the ring file
+ * @return true if the log is stored in the file
+ */
+static bool trendlog_mmap_log_open(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    const char *pathname,
+    uint32_t buffer_size)
+{
+    struct trendlog_mmap_file *file = NULL;
+    struct trendlog_mmap_header *header;
+    struct stat st;
+    uint64_t length64;
+    size_t length;
+    uint32_t record_size;
+    uint32_t magic;
+    void *address;
+    unsigned i;
+    int fd;
+
+    if (!pathname || (buffer_size == 0)) {
+        return false;
+    }
+    if (object_type == OBJECT_EVENT_LOG) {
+        record_size = sizeof(EL_DATA_REC);
+        magic = EVENT_LOG_MMAP_MAGIC;
+    } else {
+        record_size = sizeof(TL_DATA_REC);
+        magic = TRENDLOG_MMAP_MAGIC;
+    }
+    length64 =
+        TRENDLOG_MMAP_HEADER_SIZE + ((uint64_t)buffer_size * record_size);
+    length = (size_t)length64;
+    if ((uint64_t)length != length64) {
+        return false;
+    }
+    trendlog_mmap_log_close(object_type, object_instance);
+    for (i = 0; i < TRENDLOG_MMAP_MAX; i++) {
+        if (!Trendlog_File[i].in_use) {
+            file = &Trendlog_File[i];
+            break;
+        }
+    }
+    if (!file) {
+        return false;
+    }
+    fd = open(pathname, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if ((fstat(fd, &st) != 0) ||
+        (((size_t)st.st_size != length) && (ftruncate(fd, length) != 0))) {
+        close(fd);
+        return false;
+    }
+    address =
+        mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    /* the mapping stays valid after the file is closed */
+    close(fd);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    header = (struct trendlog_mmap_header *)address;
+    if ((header->magic != magic) ||
+        (header->version != TRENDLOG_MMAP_VERSION) ||
+        (header->record_size != record_size) ||
+        (header->buffer_size != buffer_size)) {
+        /* new file, or records that we can not use: start empty */
+        memset(header, 0, sizeof(*header));
+        header->magic = magic;
+        header->version = TRENDLOG_MMAP_VERSION;
+        header->record_size = record_size;
+        header->buffer_size = buffer_size;
+    }
+    if (!trendlog_mmap_buffer_set(object_type, object_instance,
+            (uint8_t *)address + TRENDLOG_MMAP_HEADER_SIZE, buffer_size,
+            &header->ring)) {
+        munmap(address, length);
+        return false;
+    }
+    file->in_use = true;
+    file->object_type = object_type;
+    file->object_instance = object_instance;
+    file->address = address;
+    file->length = length;
+
+    return true;
+}
+
+/**
+ * @brief Write the records of a log back to its ring file, and wait
+ *  for the write to finish
+ * @param object_type [in] OBJECT_TRENDLOG or OBJECT_EVENT_LOG
+ * @param object_instance [in] BACnet object instance number of the log
+ * @return true if the records were written
+ */
+static bool trendlog_mmap_log_sync(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    struct trendlog_mmap_file *file;
+
+    file = trendlog_mmap_find(object_type, object_instance);
+    if (!file) {
+        return false;
+    }
+
+    return (msync(file->address, file->length, MS_SYNC) == 0);
+}
+
+/**
+ * @brief Stop storing the records of a log in its ring file.
+ *  The log goes back to its RAM buffer, and the file keeps the history.
+ * @param object_type [in] OBJECT_TRENDLOG or OBJECT_EVENT_LOG
+ * @param object_instance [in] BACnet object instance number of the log
+ */
+static void trendlog_mmap_log_close(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    struct trendlog_mmap_file *file;
+
+    file = trendlog_mmap_find(object_type, object_instance);
+    if (file) {
+        (void)trendlog_mmap_buffer_set(
+            object_type, object_instance, NULL, 0, NULL);
+        (void)msync(file->address, file->length, MS_SYNC);
+        munmap(file->address, file->length);
+        file->in_use = false;
+    }
+}
+
+/**
+ * @brief Store the records of a trend log in a memory mapped ring file.
+ *  The file is created if needed, and an existing log is recovered.
+ * @param object_instance [in] BACnet object instance number of the log
+ * @param pathname [in] name of the ring file
+ * @param buffer_size [in] number of records in the ring file
+ * @return true if the log is stored in the file
+ */
+bool trendlog_mmap_open(
+    uint32_t object_instance, const char *pathname, uint32_t buffer_size)
+{
+    return trendlog_mmap_log_open(
+        OBJECT_TRENDLOG, object_instance, pathname, buffer_size);
+}
+
+/**
+ * @brief Write the records of a trend log back to its ring file, and wait
+ *  for the write to finish, such as before a planned power down
+ * @param object_instance [in] BACnet object instance number of the log
+ * @return true if the records were written
+ */
+bool trendlog_mmap_sync(uint32_t object_instance)
+{
+    return trendlog_mmap_log_sync(OBJECT_TRENDLOG, object_instance);
+}
+
+/**
+ * @brief Stop storing the records of a trend log in its ring file.
+ *  The log goes back to its RAM buffer, and the file keeps the history.
+ * @param object_instance [in] BACnet object instance number of the log
+ */
+void trendlog_mmap_close(uint32_t object_instance)
+{
+    trendlog_mmap_log_close(OBJECT_TRENDLOG, object_instance);
+}
+
+/**
+ * @brief Store the records of an event log in a memory mapped ring file.
+ *  The file is created if needed, and an existing log is recovered.
+ * @param object_instance [in] BACnet object instance number of the log
+ * @param pathname [in] name of the ring file
+ * @param buffer_size [in] number of records in the ring file
+ * @return true if the log is stored in the file
+ */
+bool trendlog_mmap_event_log_open(
+    uint32_t object_instance, const char *pathname, uint32_t buffer_size)
+{
+    return trendlog_mmap_log_open(
+        OBJECT_EVENT_LOG, object_instance, pathname, buffer_size);
+}
+
+/**
+ * @brief Write the records of an event log back to its ring file, and
+ *  wait for the write to finish
+ * @param object_instance [in] BACnet object instance number of the log
+ * @return true if the records were written
+ */
+bool trendlog_mmap_event_log_sync(uint32_t object_instance)
+{
+    return trendlog_mmap_log_sync(OBJECT_EVENT_LOG, object_instance);
+}
+
+/**
+ * @brief Stop storing the records of an event log in its ring file.
+ * @param object_instance [in] BACnet object instance number of the log
+ */
+void trendlog_mmap_event_log_close(uint32_t object_instance)
+{
+    trendlog_mmap_log_close(OBJECT_EVENT_LOG, object_instance);
+}
+
+/**
+ * @brief Close the ring files of all the logs, such as at exit
+ */
+void trendlog_mmap_cleanup(void)
+{
+    unsigned i;
+
+    for (i = 0; i < TRENDLOG_MMAP_MAX; i++) {
+        if (Trendlog_File[i].in_use) {
+            trendlog_mmap_log_close(Trendlog_File[i].object_type,
+                Trendlog_File[i].object_instance);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @brief Trend Log and Event Log storage in memory mapped ring files,
+ *  one file per log, so that the history of a log survives a restart
+ *  without using heap.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef TRENDLOG_MMAP_H
+#define TRENDLOG_MMAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/** maximum number of logs stored in memory mapped files */
+#ifndef TRENDLOG_MMAP_MAX
+#define TRENDLOG_MMAP_MAX 8
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool trendlog_mmap_open(
+    uint32_t object_instance, const char *pathname, uint32_t buffer_size);
+BACNET_STACK_EXPORT
+bool trendlog_mmap_sync(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void trendlog_mmap_close(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool trendlog_mmap_event_log_open(
+    uint32_t object_instance, const char *pathname, uint32_t buffer_size);
+BACNET_STACK_EXPORT
+bool trendlog_mmap_event_log_sync(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void trendlog_mmap_event_log_close(uint32_t object_instance);
+BACNET_STACK_EXPORT
+void trendlog_mmap_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -56,7 +56,7 @@
 
 
 /* clang-format off */
-static struct my_object_functions {
+static const struct my_object_functions {
     BACNET_OBJECT_TYPE Object_Type;
     object_init_function Object_Init;
     object_count_function Object_Count;
@@ -157,10 +157,10 @@ static const int Device_Properties_Proprietary[] = { -1 };
  * @return Pointer to the group of object helper functions that implement this
  *         type of Object.
  */
-static struct my_object_functions *Device_Objects_Find_Functions(
+static const struct my_object_functions *Device_Objects_Find_Functions(
     BACNET_OBJECT_TYPE Object_Type)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     pObject = &Object_Table[0];
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
@@ -190,7 +190,7 @@ void Device_Objects_Property_List(BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     struct special_property_list_t *pPropertyList)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     (void)object_instance;
     pPropertyList->Required.pList = NULL;
@@ -522,7 +522,7 @@ void Device_UUID_Get(uint8_t *uuid, size_t length)
 unsigned Device_Object_List_Count(void)
 {
     unsigned count = 0; /* number of objects */
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* initialize the default return values */
     pObject = &Object_Table[0];
@@ -552,7 +552,7 @@ bool Device_Object_List_Identifier(
     bool status = false;
     uint32_t count = 0;
     uint32_t object_index = 0;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* array index zero is length - so invalid */
     if (array_index == 0) {
@@ -630,7 +630,7 @@ bool Device_Valid_Object_Name(BACNET_CHARACTER_STRING *object_name1,
     uint32_t max_objects = 0, i = 0;
     bool check_id = false;
     BACNET_CHARACTER_STRING object_name2;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     max_objects = Device_Object_List_Count();
     for (i = 1; i <= max_objects; i++) {
@@ -664,7 +664,7 @@ bool Device_Valid_Object_Id(
     BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
 {
     bool status = false; /* return value */
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     pObject = Device_Objects_Find_Functions((BACNET_OBJECT_TYPE)object_type);
     if ((pObject != NULL) && (pObject->Object_Valid_Instance != NULL)) {
@@ -684,7 +684,7 @@ bool Device_Object_Name_Copy(BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
     BACNET_CHARACTER_STRING *object_name)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
     bool found = false;
 
     pObject = Device_Objects_Find_Functions(object_type);
@@ -706,7 +706,7 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     uint32_t i = 0;
     uint32_t count = 0;
     uint8_t *apdu = NULL;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
     uint16_t apdu_max = 0;
 
     if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
@@ -859,7 +859,8 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
  * @return The length of the APDU on success, else BACNET_STATUS_ERROR
  */
 static int Read_Property_Common(
-    struct my_object_functions *pObject, BACNET_READ_PROPERTY_DATA *rpdata)
+    const struct my_object_functions *pObject,
+    BACNET_READ_PROPERTY_DATA *rpdata)
 {
     int apdu_len = BACNET_STATUS_ERROR;
     BACNET_CHARACTER_STRING char_string;
@@ -948,7 +949,7 @@ static int Read_Property_Common(
 int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 {
     int apdu_len = BACNET_STATUS_ERROR;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* initialize the default return values */
     rpdata->error_class = ERROR_CLASS_OBJECT;
@@ -1185,7 +1186,7 @@ static bool Device_Write_Property_Object_Name(
 bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
     bool status = false;
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* initialize the default return values */
     wp_data->error_class = ERROR_CLASS_OBJECT;
@@ -1234,7 +1235,7 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
  */
 void Device_Init(object_functions_t *object_table)
 {
-    struct my_object_functions *pObject = NULL;
+    const struct my_object_functions *pObject = NULL;
 
     /* we don't use the object table passed in
        since there is extra stuff we don't need in there. */
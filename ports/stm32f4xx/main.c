@@ -52,7 +52,9 @@ static struct dlmstp_rs485_driver RS485_Driver = {
     .baud_rate = rs485_baud_rate,
     .baud_rate_set = rs485_baud_rate_set,
     .silence_milliseconds = rs485_silence_milliseconds,
-    .silence_reset = rs485_silence_reset
+    .silence_reset = rs485_silence_reset,
+    .read_block = rs485_bytes_available,
+    .read_block_release = rs485_bytes_release
 };
 static struct dlmstp_user_data_t MSTP_User_Data;
 static uint8_t Input_Buffer[DLMSTP_MPDU_MAX];
@@ -59,6 +59,10 @@
     #define RS485_AF_PINSOURCE_RX GPIO_PinSource9
     #define RS485_AF_PINSOURCE_TX GPIO_PinSource14
     #define RS485_AF_FUNCTION     GPIO_AF_USART6
+    /* USART6_RX - DMA2 Stream 1 Channel 5 */
+    #define RS485_DMA_RCC         RCC_AHB1Periph_DMA2
+    #define RS485_DMA_STREAM      DMA2_Stream1
+    #define RS485_DMA_CHANNEL     DMA_Channel_5
 #endif
 #if defined(RS485_DFR0259_ENABLED)
     /* DFR0259 RS485 Shield - CE=PF15 */
@@ -73,10 +77,20 @@
     #define RS485_RTS_GPIO    GPIOD
 #endif
 
+#if RS485_RX_DMA_ENABLED
+/* circular DMA buffer for storing received bytes */
+/* BACnet DLMSTP_MPDU_MAX for MS/TP is 1501 bytes */
+static uint8_t Receive_DMA_Data[NEXT_POWER_OF_2(DLMSTP_MPDU_MAX)];
+/* index of the next byte to be processed */
+static volatile uint16_t Receive_DMA_Tail;
+/* index of the next byte to be written, at the last idle line */
+static volatile uint16_t Receive_DMA_Idle;
+#else
 /* buffer for storing received bytes - size must be power of two */
 /* BACnet DLMSTP_MPDU_MAX for MS/TP is 1501 bytes */
 static uint8_t Receive_Queue_Data[NEXT_POWER_OF_2(DLMSTP_MPDU_MAX)];
 static FIFO_BUFFER Receive_Queue;
+#endif
 
 /* buffer for storing bytes to transmit */
 /* BACnet DLMSTP_MPDU_MAX for MS/TP is 1501 bytes */
@@ -121,13 +135,120 @@ bool rs485_receive_error(void)
     return false;
 }
 
+#if RS485_RX_DMA_ENABLED
+/**
+ * @brief Get the index of the next byte that the DMA writes
+ * @return index into the circular DMA buffer
+ */
+static uint16_t rs485_dma_head(void)
+{
+    uint16_t head;
+
+    head = sizeof(Receive_DMA_Data) - DMA_GetCurrDataCounter(RS485_DMA_STREAM);
+    if (head >= sizeof(Receive_DMA_Data)) {
+        head = 0;
+    }
+
+    return head;
+}
+
+/**
+ * @brief Get the number of bytes between two indexes of the circular
+ *  DMA buffer
+ * @param tail - index of the first byte
+ * @param head - index after the last byte
+ * @return number of bytes
+ */
+static uint16_t rs485_dma_count(uint16_t tail, uint16_t head)
+{
+    return (head - tail) & (sizeof(Receive_DMA_Data) - 1);
+}
+
+/**
+ * @brief Get the received bytes that are contiguous in the DMA buffer,
+ *  without removing them
+ * @param data - returns a pointer to the first byte
+ * @return number of bytes, which can be less than all the received bytes
+ *  when they wrap around the end of the DMA buffer
+ */
+uint16_t rs485_bytes_available(const uint8_t **data)
+{
+    uint16_t head, tail;
+
+    head = rs485_dma_head();
+    tail = Receive_DMA_Tail;
+    if (Transmitting) {
+        /* discard the echo of our own transmission */
+        Receive_DMA_Tail = head;
+        return 0;
+    }
+    if (data) {
+        *data = &Receive_DMA_Data[tail];
+    }
+    if (head < tail) {
+        return sizeof(Receive_DMA_Data) - tail;
+    }
+
+    return head - tail;
+}
+
+/**
+ * @brief Remove the processed bytes from the DMA buffer
+ * @param length - number of bytes processed
+ */
+void rs485_bytes_release(uint16_t length)
+{
+    if (length) {
+        Receive_DMA_Tail =
+            (Receive_DMA_Tail + length) & (sizeof(Receive_DMA_Data) - 1);
+    }
+}
+#else
+/**
+ * @brief Get the received bytes that are contiguous in the receive queue,
+ *  without removing them
+ * @param data - returns a pointer to the first byte
+ * @return number of bytes, which can be less than all the received bytes
+ *  when they wrap around the end of the receive queue
+ */
+uint16_t rs485_bytes_available(const uint8_t **data)
+{
+    return (uint16_t)FIFO_Peek_Contiguous(&Receive_Queue, data);
+}
+
+/**
+ * @brief Remove the processed bytes from the receive queue
+ * @param length - number of bytes processed
+ */
+void rs485_bytes_release(uint16_t length)
+{
+    (void)FIFO_Pull(&Receive_Queue, NULL, length);
+}
+#endif
+
 /**
  * @brief USARTx interrupt handler sub-routine
  */
 void RS485_USARTx_ISR(void)
 {
     uint8_t data_byte;
+#if RS485_RX_DMA_ENABLED
+    uint16_t head;
 
+    if (USART_GetITStatus(RS485_USARTx, USART_IT_IDLE) != RESET) {
+        /* the end of a burst of bytes: the silence on the wire starts
+           now, rather than when the bytes are processed */
+        head = rs485_dma_head();
+        if (!Transmitting) {
+            RS485_Receive_Bytes += rs485_dma_count(Receive_DMA_Idle, head);
+            rs485_silence_reset();
+        }
+        Receive_DMA_Idle = head;
+        /* IDLE is cleared by a read of SR followed by a read of DR */
+        data_byte = USART_ReceiveData(RS485_USARTx);
+        (void)data_byte;
+    }
+#else
     if (USART_GetITStatus(RS485_USARTx, USART_IT_RXNE) != RESET) {
         /* Read one byte from the receive data register */
         data_byte = USART_ReceiveData(RS485_USARTx);
@@ -137,6 +258,7 @@ void RS485_USARTx_ISR(void)
         }
         USART_ClearITPendingBit(RS485_USARTx, USART_IT_RXNE);
     }
+#endif
     if (USART_GetITStatus(RS485_USARTx, USART_IT_TXE) != RESET) {
         if (FIFO_Count(&Transmit_Queue)) {
             USART_SendData(RS485_USARTx, FIFO_Get(&Transmit_Queue));
@@ -154,8 +276,14 @@ void RS485_USARTx_ISR(void)
         rs485_rts_enable(false);
         /* disable the USART to generate interrupts on TX complete */
         USART_ITConfig(RS485_USARTx, USART_IT_TC, DISABLE);
+#if RS485_RX_DMA_ENABLED
+        /* discard the echo of our own transmission */
+        Receive_DMA_Tail = rs485_dma_head();
+        Receive_DMA_Idle = Receive_DMA_Tail;
+#else
         /* enable the USART to generate interrupts on RX not empty */
         USART_ITConfig(RS485_USARTx, USART_IT_RXNE, ENABLE);
+#endif
         USART_ClearITPendingBit(RS485_USARTx, USART_IT_TC);
     }
     /* check for errors and clear them */
@@ -208,6 +336,18 @@ bool rs485_rts_enabled(void)
 bool rs485_byte_available(uint8_t *data_register)
 {
     bool data_available = false; /* return value */
+#if RS485_RX_DMA_ENABLED
+    const uint8_t *data = NULL;
+
+    if (rs485_bytes_available(&data)) {
+        if (data_register) {
+            *data_register = data[0];
+            rs485_bytes_release(1);
+        }
+        rs485_silence_reset();
+        data_available = true;
+    }
+#else
 
     if (!FIFO_Empty(&Receive_Queue)) {
         if (data_register) {
@@ -216,6 +356,7 @@ bool rs485_byte_available(uint8_t *data_register)
         rs485_silence_reset();
         data_available = true;
     }
+#endif
 
     return data_available;
 }
@@ -232,8 +373,10 @@ void rs485_bytes_send(uint8_t *buffer, uint16_t nbytes)
         if (FIFO_Add(&Transmit_Queue, buffer, nbytes)) {
             rs485_silence_reset();
             rs485_rts_enable(true);
+#if !RS485_RX_DMA_ENABLED
             /* disable the USART to generate interrupts on RX not empty */
             USART_ITConfig(RS485_USARTx, USART_IT_RXNE, DISABLE);
+#endif
             /* enable the USART to generate interrupts on TX empty */
             USART_ITConfig(RS485_USARTx, USART_IT_TXE, ENABLE);
             /* TXE interrupt will load the first byte */
@@ -313,6 +456,38 @@ uint32_t rs485_bytes_received(void)
     return RS485_Receive_Bytes;
 }
 
+#if RS485_RX_DMA_ENABLED
+/**
+ * @brief Configure the DMA stream that writes the received bytes into
+ *  the circular DMA buffer
+ */
+static void rs485_dma_init(void)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(RS485_DMA_RCC, ENABLE);
+    DMA_DeInit(RS485_DMA_STREAM);
+    DMA_StructInit(&DMA_InitStructure);
+    DMA_InitStructure.DMA_Channel = RS485_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&RS485_USARTx->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)&Receive_DMA_Data[0];
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = sizeof(Receive_DMA_Data);
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_Init(RS485_DMA_STREAM, &DMA_InitStructure);
+    DMA_Cmd(RS485_DMA_STREAM, ENABLE);
+    Receive_DMA_Tail = 0;
+    Receive_DMA_Idle = 0;
+    USART_DMACmd(RS485_USARTx, USART_DMAReq_Rx, ENABLE);
+}
+#endif
+
 /**
  * @brief Initialize the USART for RS485
  */
@@ -322,8 +497,12 @@ void rs485_init(void)
     NVIC_InitTypeDef NVIC_InitStructure;
 
     /* initialize the Rx and Tx byte queues */
+#if RS485_RX_DMA_ENABLED
+    rs485_dma_init();
+#else
     FIFO_Init(&Receive_Queue, &Receive_Queue_Data[0],
         (unsigned)sizeof(Receive_Queue_Data));
+#endif
     FIFO_Init(&Transmit_Queue, &Transmit_Queue_Data[0],
         (unsigned)sizeof(Transmit_Queue_Data));
 
@@ -367,8 +546,13 @@ void rs485_init(void)
     NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
+#if RS485_RX_DMA_ENABLED
+    /* enable the USART to generate interrupts on an idle line */
+    USART_ITConfig(RS485_USARTx, USART_IT_IDLE, ENABLE);
+#else
     /* enable the USART to generate interrupts on RX */
     USART_ITConfig(RS485_USARTx, USART_IT_RXNE, ENABLE);
+#endif
 
     rs485_baud_rate_set(Baud_Rate);
 
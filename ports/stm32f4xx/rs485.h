@@ -39,6 +39,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/* receive with a circular DMA buffer and the idle-line interrupt,
+   instead of an interrupt for each byte */
+#ifndef RS485_RX_DMA_ENABLED
+#define RS485_RX_DMA_ENABLED 0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -46,6 +52,8 @@ extern "C" {
 void rs485_rts_enable(bool enable);
 bool rs485_rts_enabled(void);
 bool rs485_byte_available(uint8_t *data_register);
+uint16_t rs485_bytes_available(const uint8_t **data);
+void rs485_bytes_release(uint16_t length);
 bool rs485_receive_error(void);
 
 void rs485_bytes_send(uint8_t *buffer, uint16_t nbytes);
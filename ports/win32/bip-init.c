@@ -66,6 +66,36 @@ static struct in_addr BIP_Broadcast_Binding_Address;
 /* enable debugging */
 static bool BIP_Debug;
 
+/* number of overlapped receives that are outstanding on each socket,
+   or 0 to receive one MPDU per select() and recvfrom() */
+#ifndef BIP_RECEIVE_OVERLAPPED
+#define BIP_RECEIVE_OVERLAPPED 8
+#endif
+#if BIP_RECEIVE_OVERLAPPED
+/* completion key of the BACnet/IP sockets */
+#define BIP_COMPLETION_KEY ((ULONG_PTR)0xBAC0)
+#ifndef SIO_UDP_CONNRESET
+#define SIO_UDP_CONNRESET _WSAIOW(IOC_VENDOR, 12)
+#endif
+/* an overlapped receive of an MPDU from one of the sockets */
+struct bip_receive_request {
+    /* first member, so that the completed OVERLAPPED is the request */
+    WSAOVERLAPPED overlapped;
+    WSABUF wsabuf;
+    SOCKET socket;
+    struct sockaddr_in sin;
+    INT sin_len;
+    DWORD flags;
+    uint8_t buffer[BIP_MPDU_MAX];
+};
+/* I/O completion port of both sockets, or NULL to use select() */
+static HANDLE BIP_Completion_Port = NULL;
+static struct bip_receive_request
+    BIP_Receive_Request[2][BIP_RECEIVE_OVERLAPPED];
+/* handles the completions of the application on the same port */
+static bip_completion_handler_t BIP_Completion_Handler;
+#endif
+
 /**
  * @brief Print the IPv4 address with debug info
  * @param str - debug info string
@@ -263,8 +293,8 @@ static void bip_init_windows(void)
     WSADATA wd;
 
     if (!BIP_Initialized) {
-        Result = WSAStartup((1 << 8) | 1, &wd);
-        /*Result = WSAStartup(MAKEWORD(2,2), &wd); */
+        /* version 2.2 for the overlapped receives */
+        Result = WSAStartup(MAKEWORD(2, 2), &wd);
         if (Result != 0) {
             print_last_error("TCP/IP stack initialization failed");
             exit(1);
@@ -469,60 +499,30 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 }
 
 /**
- * BACnet/IP Datalink Receive handler.
+ * @brief Handle an MPDU that was received into the NPDU buffer
  *
  * @param src - returns the source address
- * @param npdu - returns the NPDU buffer
+ * @param npdu - the received MPDU, which returns the NPDU
  * @param max_npdu -maximum size of the NPDU buffer
- * @param timeout - number of milliseconds to wait for a packet
+ * @param socket - socket that received the MPDU
+ * @param sin - address that the MPDU was received from
+ * @param received_bytes - number of bytes of the MPDU
  *
- * @return Number of bytes received, or 0 if none or timeout.
+ * @return Number of bytes of the NPDU, or 0 if none.
  */
-uint16_t bip_receive(
-    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+static uint16_t bip_receive_mpdu(BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t max_npdu,
+    SOCKET socket,
+    struct sockaddr_in *sin,
+    int received_bytes)
 {
     uint16_t npdu_len = 0; /* return value */
-    fd_set read_fds;
-    int max = 0;
-    struct timeval select_timeout;
-    struct sockaddr_in sin = { 0 };
     BACNET_IP_ADDRESS addr = { 0 };
-    socklen_t sin_len = sizeof(sin);
-    int received_bytes = 0;
+    int max = 0;
     int offset = 0;
     uint16_t i = 0;
-    SOCKET socket;
-
-    /* Make sure the socket is open */
-    if (BIP_Socket == INVALID_SOCKET) {
-        return 0;
-    }
-    /* we could just use a non-blocking socket, but that consumes all
-       the CPU time.  We can use a timeout; it is only supported as
-       a select. */
-    if (timeout >= 1000) {
-        select_timeout.tv_sec = timeout / 1000;
-        select_timeout.tv_usec =
-            1000 * (timeout - select_timeout.tv_sec * 1000);
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 1000 * timeout;
-    }
-    FD_ZERO(&read_fds);
-    FD_SET(BIP_Socket, &read_fds);
-    FD_SET(BIP_Broadcast_Socket, &read_fds);
 
-    max = BIP_Socket > BIP_Broadcast_Socket ? BIP_Socket : BIP_Broadcast_Socket;
-
-    /* see if there is a packet for us */
-    if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
-        socket = FD_ISSET(BIP_Socket, &read_fds) ? BIP_Socket :
-            BIP_Broadcast_Socket;
-        received_bytes = recvfrom(socket, (char *)&npdu[0], max_npdu, 0,
-            (struct sockaddr *)&sin, &sin_len);
-    } else {
-        return 0;
-    }
     /* See if there is a problem */
     if (received_bytes < 0) {
         return 0;
@@ -551,10 +551,10 @@ uint16_t bip_receive(
        shall be transmitted with the most significant octet first). This
        address shall be referred to as a B/IPv4 address.
     */
-    memcpy(&addr.address[0], &sin.sin_addr.s_addr, 4);
-    addr.port = ntohs(sin.sin_port);
+    memcpy(&addr.address[0], &sin->sin_addr.s_addr, 4);
+    addr.port = ntohs(sin->sin_port);
     debug_print_ipv4(
-        "Received MPDU->", &sin.sin_addr, sin.sin_port, received_bytes);
+        "Received MPDU->", &sin->sin_addr, sin->sin_port, received_bytes);
     /* pass the packet into the BBMD handler */
     offset = socket == BIP_Socket ?
         bvlc_handler(&addr, src, npdu, received_bytes) :
@@ -574,6 +574,237 @@ uint16_t bip_receive(
     return npdu_len;
 }
 
+#if BIP_RECEIVE_OVERLAPPED
+/**
+ * @brief Post an overlapped receive, which completes on the I/O
+ *  completion port when an MPDU is received
+ * @param request - the receive to post
+ * @return true if the receive is outstanding
+ */
+static bool bip_receive_post(struct bip_receive_request *request)
+{
+    int rv = 0;
+
+    memset(&request->overlapped, 0, sizeof(request->overlapped));
+    request->wsabuf.buf = (char *)&request->buffer[0];
+    request->wsabuf.len = sizeof(request->buffer);
+    request->sin_len = sizeof(request->sin);
+    request->flags = 0;
+    rv = WSARecvFrom(request->socket, &request->wsabuf, 1, NULL,
+        &request->flags, (struct sockaddr *)&request->sin, &request->sin_len,
+        &request->overlapped, NULL);
+    if ((rv == SOCKET_ERROR) && (WSAGetLastError() != WSA_IO_PENDING)) {
+        print_last_error("WSARecvFrom");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Wait on the I/O completion port for a completed receive, and
+ *  post the receive again after its MPDU is copied out
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+static uint16_t bip_receive_completion(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    struct bip_receive_request *request = NULL;
+    OVERLAPPED *overlapped = NULL;
+    ULONG_PTR key = 0;
+    DWORD bytes = 0;
+    BOOL success = FALSE;
+    uint16_t npdu_len = 0;
+
+    success = GetQueuedCompletionStatus(
+        BIP_Completion_Port, &bytes, &key, &overlapped, (DWORD)timeout);
+    if (!overlapped) {
+        /* timeout */
+        return 0;
+    }
+    if (key != BIP_COMPLETION_KEY) {
+        /* a completion of a handle of the application */
+        if (BIP_Completion_Handler) {
+            BIP_Completion_Handler(
+                (uintptr_t)key, (uint32_t)bytes, overlapped, success);
+        }
+        return 0;
+    }
+    request = (struct bip_receive_request *)overlapped;
+    if (request->socket == INVALID_SOCKET) {
+        /* cancelled when the socket was closed */
+        return 0;
+    }
+    if (success && (bytes > 0) && (bytes <= max_npdu)) {
+        memcpy(npdu, &request->buffer[0], bytes);
+        npdu_len = bip_receive_mpdu(
+            src, npdu, max_npdu, request->socket, &request->sin, (int)bytes);
+    }
+    /* a failed receive, such as after an ICMP error, is posted again */
+    (void)bip_receive_post(request);
+
+    return npdu_len;
+}
+
+/**
+ * @brief Associate both sockets with an I/O completion port, and post
+ *  the overlapped receives on each of them.
+ *  If it fails, bip_receive() uses select() and recvfrom().
+ */
+static void bip_receive_completion_init(void)
+{
+    SOCKET sockets[2];
+    struct bip_receive_request *request;
+    BOOL value = FALSE;
+    DWORD bytes = 0;
+    unsigned i, j;
+
+    sockets[0] = BIP_Socket;
+    sockets[1] = BIP_Broadcast_Socket;
+    BIP_Completion_Port =
+        CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (!BIP_Completion_Port) {
+        print_last_error("CreateIoCompletionPort");
+        return;
+    }
+    for (i = 0; i < 2; i++) {
+        /* do not fail the receives after an ICMP port unreachable */
+        (void)WSAIoctl(sockets[i], SIO_UDP_CONNRESET, &value, sizeof(value),
+            NULL, 0, &bytes, NULL, NULL);
+        if (!CreateIoCompletionPort((HANDLE)sockets[i], BIP_Completion_Port,
+                BIP_COMPLETION_KEY, 0)) {
+            print_last_error("CreateIoCompletionPort");
+            CloseHandle(BIP_Completion_Port);
+            BIP_Completion_Port = NULL;
+            return;
+        }
+    }
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < BIP_RECEIVE_OVERLAPPED; j++) {
+            request = &BIP_Receive_Request[i][j];
+            request->socket = sockets[i];
+            (void)bip_receive_post(request);
+        }
+    }
+}
+
+/**
+ * @brief Close the I/O completion port, after the sockets are closed
+ *  so that their receives are cancelled
+ */
+static void bip_receive_completion_cleanup(void)
+{
+    unsigned i, j;
+
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < BIP_RECEIVE_OVERLAPPED; j++) {
+            BIP_Receive_Request[i][j].socket = INVALID_SOCKET;
+        }
+    }
+    if (BIP_Completion_Port) {
+        CloseHandle(BIP_Completion_Port);
+        BIP_Completion_Port = NULL;
+    }
+}
+#endif
+
+/**
+ * @brief Get the I/O completion port that bip_receive() waits on, so that
+ *  an application can associate its own handles with it, with a key other
+ *  than that of the BACnet/IP sockets, and have their completions handled
+ *  in its event loop while bip_receive() waits until its next deadline.
+ * @return the HANDLE of the I/O completion port, or NULL if none
+ */
+void *bip_get_completion_port(void)
+{
+#if BIP_RECEIVE_OVERLAPPED
+    return BIP_Completion_Port;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief Set the handler of the completions of the application handles
+ *  that are dequeued by bip_receive()
+ * @param handler - function called with the key, the number of bytes,
+ *  the OVERLAPPED and the success of each completion, or NULL for none
+ */
+void bip_set_completion_handler(bip_completion_handler_t handler)
+{
+#if BIP_RECEIVE_OVERLAPPED
+    BIP_Completion_Handler = handler;
+#else
+    (void)handler;
+#endif
+}
+
+/**
+ * BACnet/IP Datalink Receive handler.
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    fd_set read_fds;
+    int max = 0;
+    struct timeval select_timeout;
+    struct sockaddr_in sin = { 0 };
+    socklen_t sin_len = sizeof(sin);
+    int received_bytes = 0;
+    SOCKET socket;
+
+    /* Make sure the socket is open */
+    if (BIP_Socket == INVALID_SOCKET) {
+        return 0;
+    }
+#if BIP_RECEIVE_OVERLAPPED
+    if (BIP_Completion_Port) {
+        return bip_receive_completion(src, npdu, max_npdu, timeout);
+    }
+#endif
+    /* we could just use a non-blocking socket, but that consumes all
+       the CPU time.  We can use a timeout; it is only supported as
+       a select. */
+    if (timeout >= 1000) {
+        select_timeout.tv_sec = timeout / 1000;
+        select_timeout.tv_usec =
+            1000 * (timeout - select_timeout.tv_sec * 1000);
+    } else {
+        select_timeout.tv_sec = 0;
+        select_timeout.tv_usec = 1000 * timeout;
+    }
+    FD_ZERO(&read_fds);
+    FD_SET(BIP_Socket, &read_fds);
+    FD_SET(BIP_Broadcast_Socket, &read_fds);
+
+    max = BIP_Socket > BIP_Broadcast_Socket ? BIP_Socket : BIP_Broadcast_Socket;
+
+    /* see if there is a packet for us */
+    if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
+        socket = FD_ISSET(BIP_Socket, &read_fds) ? BIP_Socket :
+            BIP_Broadcast_Socket;
+        received_bytes = recvfrom(socket, (char *)&npdu[0], max_npdu, 0,
+            (struct sockaddr *)&sin, &sin_len);
+    } else {
+        return 0;
+    }
+
+    return bip_receive_mpdu(src, npdu, max_npdu, socket, &sin, received_bytes);
+}
+
 /**
  * The common send function for BACnet/IP application layer
  *
@@ -898,6 +1129,9 @@ bool bip_init(char *ifname)
     if (sock_fd == INVALID_SOCKET) {
         return false;
     }
+#if BIP_RECEIVE_OVERLAPPED
+    bip_receive_completion_init();
+#endif
     bvlc_init();
 
     return true;
@@ -930,6 +1164,9 @@ void bip_cleanup(void)
         closesocket(sock_fd);
     }
     BIP_Broadcast_Socket = INVALID_SOCKET;
+#if BIP_RECEIVE_OVERLAPPED
+    bip_receive_completion_cleanup();
+#endif
 
     if (BIP_Initialized) {
         BIP_Initialized = false;
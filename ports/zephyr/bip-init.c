@@ -41,6 +41,10 @@
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/socket_select.h>
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+#include <zephyr/net/net_context.h>
+#include <zephyr/net/net_pkt.h>
+#endif
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -62,6 +66,30 @@ LOG_MODULE_DECLARE(bacnet, CONFIG_BACNETSTACK_LOG_LEVEL);
 static int BIP_Socket = -1;
 static int BIP_Broadcast_Socket = -1;
 
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+#ifndef CONFIG_BACDL_BIP_RX_QUEUE
+#define CONFIG_BACDL_BIP_RX_QUEUE 4
+#endif
+/* a packet given by the network stack, waiting for bip_receive() */
+struct bip_rx_entry {
+    struct net_pkt *pkt;
+    BACNET_IP_ADDRESS addr;
+    bool broadcast;
+};
+/* network context that receives both the unicast and broadcast packets */
+static struct net_context *BIP_Context;
+K_MSGQ_DEFINE(BIP_Rx_Queue,
+    sizeof(struct bip_rx_entry),
+    CONFIG_BACDL_BIP_RX_QUEUE,
+    4);
+/* the BVLC header, read in place when it is within one fragment */
+struct bip_bvlc_header {
+    uint8_t type;
+    uint8_t function;
+    uint16_t length;
+} __packed;
+#endif
+
 /* NOTE: we store address and port in network byte order
    since BACnet/IP uses network byte order for all address byte arrays
 */
@@ -280,17 +308,26 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in bip_dest = { 0 };
 
+    /* load destination IP address */
+    bip_dest.sin_family = AF_INET;
+    memcpy(&bip_dest.sin_addr.s_addr, &dest->address[0], IP_ADDRESS_MAX);
+    bip_dest.sin_port = htons(dest->port);
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+    if (BIP_Context) {
+        debug_print_ipv4(
+            "Sending MPDU->", &bip_dest.sin_addr, bip_dest.sin_port, mtu_len);
+        return net_context_sendto(BIP_Context, mtu, mtu_len,
+            (struct sockaddr *)&bip_dest, sizeof(struct sockaddr_in), NULL,
+            K_NO_WAIT, NULL);
+    }
+#endif
+
     /* assumes that the driver has already been initialized */
     if (BIP_Socket < 0) {
         LOG_ERR("%s:%d - Socket not initialized!", THIS_FILE, __LINE__);
         return BIP_Socket;
     }
 
-    /* load destination IP address */
-    bip_dest.sin_family = AF_INET;
-    memcpy(&bip_dest.sin_addr.s_addr, &dest->address[0], IP_ADDRESS_MAX);
-    bip_dest.sin_port = htons(dest->port);
-
     /* Send the packet */
     debug_print_ipv4(
         "Sending MPDU->", &bip_dest.sin_addr, bip_dest.sin_port, mtu_len);
@@ -298,6 +335,138 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
         (struct sockaddr *)&bip_dest, sizeof(struct sockaddr));
 }
 
+/**
+ * @brief Process a received BACnet/IP MPDU
+ * @param src - returns the source address
+ * @param npdu - the MPDU, which returns the NPDU
+ * @param max_npdu - maximum size of the NPDU buffer
+ * @param addr - B/IPv4 address of the sender
+ * @param received_bytes - number of bytes of the MPDU
+ * @param broadcast - true if the MPDU was sent to the broadcast address
+ * @return Number of bytes of the NPDU, or 0 if none
+ */
+static uint16_t bip_receive_mpdu(BACNET_ADDRESS *src,
+    uint8_t *npdu,
+    uint16_t max_npdu,
+    BACNET_IP_ADDRESS *addr,
+    int received_bytes,
+    bool broadcast)
+{
+    uint16_t npdu_len = 0;
+    struct in_addr sin_addr;
+    int offset = 0;
+    uint16_t i = 0;
+
+    /* the signature of a BACnet/IP packet */
+    if (npdu[0] != BVLL_TYPE_BACNET_IP) {
+        LOG_WRN("%s:%d - RX bad packet", THIS_FILE, __LINE__);
+        return 0;
+    }
+    memcpy(&sin_addr.s_addr, &addr->address[0], IP_ADDRESS_MAX);
+    debug_print_ipv4("Received MPDU->", &sin_addr, htons(addr->port),
+        received_bytes);
+    /* pass the packet into the BBMD handler */
+    offset = broadcast
+        ? bvlc_broadcast_handler(addr, src, npdu, received_bytes)
+        : bvlc_handler(addr, src, npdu, received_bytes);
+    if (offset > 0) {
+        npdu_len = received_bytes - offset;
+        debug_print_ipv4(
+            "Received NPDU->", &sin_addr, htons(addr->port), npdu_len);
+        if (npdu_len <= max_npdu) {
+            /* shift the buffer to return a valid NPDU */
+            for (i = 0; i < npdu_len; i++) {
+                npdu[i] = npdu[offset + i];
+            }
+        } else {
+            LOG_WRN("%s:%d - NPDU dropped!", THIS_FILE, __LINE__);
+            npdu_len = 0;
+        }
+    }
+
+    return npdu_len;
+}
+
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+/**
+ * @brief Receive callback of the network context, called from the thread
+ *  of the network stack, which queues the packet for bip_receive() and
+ *  wakes the thread waiting in it
+ * @param context - network context
+ * @param pkt - the received packet, with the cursor at the UDP payload
+ * @param ip_hdr - IP header of the packet
+ * @param proto_hdr - UDP header of the packet
+ * @param status - 0 when a packet is received
+ * @param user_data - not used
+ */
+static void bip_net_context_recv(struct net_context *context,
+    struct net_pkt *pkt,
+    union net_ip_header *ip_hdr,
+    union net_proto_header *proto_hdr,
+    int status,
+    void *user_data)
+{
+    struct bip_rx_entry entry = { 0 };
+
+    (void)context;
+    (void)user_data;
+    if (!pkt) {
+        return;
+    }
+    if ((status < 0) || !ip_hdr || !proto_hdr) {
+        net_pkt_unref(pkt);
+        return;
+    }
+    entry.pkt = pkt;
+    memcpy(&entry.addr.address[0], &ip_hdr->ipv4->src, IP_ADDRESS_MAX);
+    entry.addr.port = ntohs(proto_hdr->udp->src_port);
+    entry.broadcast =
+        memcmp(&ip_hdr->ipv4->dst, &BIP_Address, IP_ADDRESS_MAX) != 0;
+    if (k_msgq_put(&BIP_Rx_Queue, &entry, K_NO_WAIT) != 0) {
+        LOG_WRN("%s:%d - RX queue full", THIS_FILE, __LINE__);
+        net_pkt_unref(pkt);
+    }
+}
+
+/**
+ * @brief Receive the next MPDU queued by the network stack, and copy it
+ *  once from the fragments of the packet into the NPDU buffer, after
+ *  the BVLC header was checked on the fragments
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu - maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+static uint16_t bip_net_context_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    NET_PKT_DATA_ACCESS_DEFINE(bvlc_access, struct bip_bvlc_header);
+    struct bip_bvlc_header *bvlc;
+    struct bip_rx_entry entry;
+    size_t received_bytes;
+    uint16_t npdu_len = 0;
+
+    if (k_msgq_get(&BIP_Rx_Queue, &entry, K_MSEC(timeout)) != 0) {
+        return 0;
+    }
+    received_bytes = net_pkt_remaining_data(entry.pkt);
+    bvlc = net_pkt_get_data(entry.pkt, &bvlc_access);
+    if (!bvlc || (bvlc->type != BVLL_TYPE_BACNET_IP) ||
+        (ntohs(bvlc->length) != received_bytes)) {
+        LOG_WRN("%s:%d - RX bad packet", THIS_FILE, __LINE__);
+    } else if (received_bytes > max_npdu) {
+        LOG_WRN("%s:%d - MPDU dropped!", THIS_FILE, __LINE__);
+    } else if (net_pkt_read(entry.pkt, npdu, received_bytes) == 0) {
+        npdu_len = bip_receive_mpdu(src, npdu, max_npdu, &entry.addr,
+            (int)received_bytes, entry.broadcast);
+    }
+    net_pkt_unref(entry.pkt);
+
+    return npdu_len;
+}
+#endif
+
 /**
  * BACnet/IP Datalink Receive handler.
  *
@@ -311,7 +480,6 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 uint16_t bip_receive(
     BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
 {
-    uint16_t npdu_len = 0; /* return value */
     zsock_fd_set read_fds;
     int max = 0;
     struct zsock_timeval select_timeout;
@@ -319,10 +487,13 @@ uint16_t bip_receive(
     BACNET_IP_ADDRESS addr = { { 0 } };
     socklen_t sin_len = sizeof(sin);
     int received_bytes = 0;
-    int offset = 0;
-    uint16_t i = 0;
     int socket;
 
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+    if (BIP_Context) {
+        return bip_net_context_receive(src, npdu, max_npdu, timeout);
+    }
+#endif
     /* Make sure the socket is open */
     if (BIP_Socket < 0) {
         return 0;
@@ -365,11 +536,6 @@ uint16_t bip_receive(
     if (received_bytes == 0) {
         return 0;
     }
-    /* the signature of a BACnet/IP packet */
-    if (npdu[0] != BVLL_TYPE_BACNET_IP) {
-        LOG_WRN("%s:%d - RX bad packet", THIS_FILE, __LINE__);
-        return 0;
-    }
 
     /* Data link layer addressing between B/IPv4 nodes consists of a 32-bit
        IPv4 address followed by a two-octet UDP port number (both of which
@@ -380,28 +546,8 @@ uint16_t bip_receive(
     memcpy(&addr.address[0], &sin.sin_addr.s_addr, IP_ADDRESS_MAX);
     addr.port = ntohs(sin.sin_port);
 
-    debug_print_ipv4(
-        "Received MPDU->", &sin.sin_addr, sin.sin_port, received_bytes);
-    /* pass the packet into the BBMD handler */
-    offset = socket == BIP_Socket
-        ? bvlc_handler(&addr, src, npdu, received_bytes)
-        : bvlc_broadcast_handler(&addr, src, npdu, received_bytes);
-    if (offset > 0) {
-        npdu_len = received_bytes - offset;
-        debug_print_ipv4(
-            "Received NPDU->", &sin.sin_addr, sin.sin_port, npdu_len);
-        if (npdu_len <= max_npdu) {
-            /* shift the buffer to return a valid NPDU */
-            for (i = 0; i < npdu_len; i++) {
-                npdu[i] = npdu[offset + i];
-            }
-        } else {
-            LOG_WRN("%s:%d - NPDU dropped!", THIS_FILE, __LINE__);
-            npdu_len = 0;
-        }
-    }
-
-    return npdu_len;
+    return bip_receive_mpdu(src, npdu, max_npdu, &addr, received_bytes,
+        socket != BIP_Socket);
 }
 
 /**
@@ -557,6 +703,64 @@ static int createSocket(struct sockaddr_in *sin)
     return sock_fd;
 }
 
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+/**
+ * @brief Create the network context bound to any address at the BACnet/IP
+ *  port, which receives the packets to the unicast address and to the
+ *  broadcast address with a callback
+ * @return true if the network context receives
+ */
+static bool bip_net_context_init(void)
+{
+    struct sockaddr_in sin = { 0 };
+    int status;
+
+    status = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &BIP_Context);
+    if (status < 0) {
+        LOG_ERR("%s:%d - net_context_get() failure: %d", THIS_FILE,
+            __LINE__, status);
+        BIP_Context = NULL;
+        return false;
+    }
+    sin.sin_family = AF_INET;
+    sin.sin_port = BIP_Port;
+    sin.sin_addr.s_addr = htonl(INADDR_ANY);
+    status = net_context_bind(
+        BIP_Context, (struct sockaddr *)&sin, sizeof(struct sockaddr_in));
+    if (status >= 0) {
+        status =
+            net_context_recv(BIP_Context, bip_net_context_recv, K_NO_WAIT,
+                NULL);
+    }
+    if (status < 0) {
+        LOG_ERR("%s:%d - net_context_bind() failure: %d", THIS_FILE,
+            __LINE__, status);
+        net_context_put(BIP_Context);
+        BIP_Context = NULL;
+        return false;
+    }
+    LOG_DBG("Network context bound");
+
+    return true;
+}
+
+/**
+ * @brief Release the network context and the packets still queued
+ */
+static void bip_net_context_cleanup(void)
+{
+    struct bip_rx_entry entry;
+
+    if (BIP_Context) {
+        net_context_put(BIP_Context);
+        BIP_Context = NULL;
+    }
+    while (k_msgq_get(&BIP_Rx_Queue, &entry, K_NO_WAIT) == 0) {
+        net_pkt_unref(entry.pkt);
+    }
+}
+#endif
+
 /** Initialize the BACnet/IP services at the given interface.
  * @ingroup DLBIP
  * -# Gets the local IP address and local broadcast address from the system,
@@ -587,6 +791,13 @@ bool bip_init(char *ifname)
         return false;
     }
 
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+    if (bip_net_context_init()) {
+        bvlc_init();
+        LOG_DBG("bip_init() success");
+        return true;
+    }
+#endif
     /* bind the socket to the local port number and IP address */
     sin.sin_family = AF_INET;
     sin.sin_port = BIP_Port;
@@ -617,6 +828,11 @@ bool bip_init(char *ifname)
  */
 bool bip_valid(void)
 {
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+    if (BIP_Context) {
+        return true;
+    }
+#endif
     return (BIP_Socket != -1);
 }
 
@@ -629,6 +845,9 @@ void bip_cleanup(void)
 
     memset(&BIP_Address, 0, sizeof(BIP_Address));
     memset(&BIP_Broadcast_Addr, 0, sizeof(BIP_Broadcast_Addr));
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+    bip_net_context_cleanup();
+#endif
 
     if (BIP_Socket != -1) {
         zsock_close(BIP_Socket);
@@ -32,6 +32,7 @@
 #include "bacnet/calendar_entry.h"
 #include "bacnet/special_event.h"
 #include "bacnet/basic/sys/platform.h"
+#include "bacnet/basic/sys/static_pool.h"
 
 /**
  * @brief Encode application data given by a pointer into the APDU.
@@ -1849,8 +1850,8 @@ bool bacapp_copy(
 /**
  * @brief Returns the length of data between an opening tag and a closing tag.
  * Expects that the first octet contain the opening tag.
- * Include a value property identifier for context specific data
- * such as the value received in a WriteProperty request.
+ * Context specific data, such as the value received in a WriteProperty
+ * request, is skipped using the length in its tag.
  *
  * @param apdu Pointer to the APDU buffer
  * @param apdu_size Bytes valid in the buffer
@@ -1861,80 +1862,12 @@ bool bacapp_copy(
 int bacapp_data_len(
     uint8_t *apdu, unsigned apdu_size, BACNET_PROPERTY_ID property)
 {
-    int len = 0;
-    int total_len = 0;
-    int apdu_len = 0;
-    BACNET_TAG tag = { 0 };
-    uint8_t opening_tag_number = 0;
-    uint8_t opening_tag_number_counter = 0;
-    bool total_len_enable = false;
-
+    (void)property;
     if (!apdu) {
         return BACNET_STATUS_ERROR;
     }
-    if (apdu_size <= apdu_len) {
-        /* error: exceeding our buffer limit */
-        return BACNET_STATUS_ERROR;
-    }
-    if (!bacnet_is_opening_tag(apdu, apdu_size)) {
-        /* error: opening tag is missing */
-        return BACNET_STATUS_ERROR;
-    }
-    do {
-        len = bacnet_tag_decode(apdu, apdu_size - apdu_len, &tag);
-        if (len == 0) {
-            return BACNET_STATUS_ERROR;
-        }
-        if (tag.opening) {
-            if (opening_tag_number_counter == 0) {
-                opening_tag_number = tag.number;
-                opening_tag_number_counter = 1;
-                total_len_enable = false;
-            } else if (tag.number == opening_tag_number) {
-                total_len_enable = true;
-                opening_tag_number_counter++;
-            } else {
-                total_len_enable = true;
-            }
-        } else if (tag.closing) {
-            if (tag.number == opening_tag_number) {
-                if (opening_tag_number_counter > 0) {
-                    opening_tag_number_counter--;
-                }
-            }
-            total_len_enable = true;
-        } else if (tag.context) {
-#if defined(BACAPP_COMPLEX_TYPES)
-            /* context-specific tagged data */
-            len = bacapp_decode_context_data_len(
-                apdu, apdu_size - apdu_len, property);
-            total_len_enable = true;
-#endif
-        } else {
-            /* application tagged data */
-            len =
-                bacapp_decode_application_data_len(apdu, apdu_size - apdu_len);
-            total_len_enable = true;
-        }
-        if (opening_tag_number_counter > 0) {
-            if (len > 0) {
-                if (total_len_enable) {
-                    total_len += len;
-                }
-            } else {
-                /* error: len is not incrementing */
-                return BACNET_STATUS_ERROR;
-            }
-            apdu_len += len;
-            if (apdu_size <= apdu_len) {
-                /* error: exceeding our buffer limit */
-                return BACNET_STATUS_ERROR;
-            }
-            apdu += len;
-        }
-    } while (opening_tag_number_counter > 0);
 
-    return total_len;
+    return bacnet_enclosed_data_length(apdu, apdu_size);
 }
 
 /**
@@ -2614,7 +2547,7 @@ bool bacapp_print_value(
         char str[str_len + 1];
 #else
         char *str;
-        str = calloc(sizeof(char), str_len + 1);
+        str = bacnet_calloc(sizeof(char), str_len + 1);
         if (!str) {
             return false;
         }
@@ -2627,7 +2560,7 @@ bool bacapp_print_value(
         /* nothing to do with stack based RAM */
 #else
         if (str) {
-            free(str);
+            bacnet_free(str);
         }
 #endif
         retval = true;
@@ -2651,7 +2584,8 @@ static char *ltrim(char *str, const char *trimmedchars)
     if (str[0] == 0) {
         return str;
     }
-    while (strchr(trimmedchars, *str)) {
+    /* strchr() finds the NUL that ends the string, so stop there */
+    while (*str && strchr(trimmedchars, *str)) {
         str++;
     }
     return str;
@@ -2680,10 +2614,47 @@ static char *trim(char *str, const char *trimmedchars)
 }
 
 #if defined(BACAPP_WEEKLY_SCHEDULE)
+/**
+ * @brief Find the next token of a string, like strtok(), but keeping the
+ *  position in the string of the caller so that many strings can be
+ *  parsed at the same time, such as by several threads.
+ * @param str - string for the first token, or NULL for the next token
+ * @param delimiter - character that separates the tokens
+ * @param position - [in,out] position of the next token
+ * @return the token, terminated by a NUL, or NULL if there are no more
+ */
+static char *strtok_next(char *str, char delimiter, char **position)
+{
+    char *token;
+    char *end;
+
+    token = str ? str : *position;
+    if (!token) {
+        return NULL;
+    }
+    while (*token == delimiter) {
+        token++;
+    }
+    if (*token == 0) {
+        *position = NULL;
+        return NULL;
+    }
+    end = strchr(token, delimiter);
+    if (end) {
+        *end = 0;
+        *position = end + 1;
+    } else {
+        *position = NULL;
+    }
+
+    return token;
+}
+
 static bool
 parse_weeklyschedule(char *str, BACNET_APPLICATION_DATA_VALUE *value)
 {
     char *chunk, *comma, *space, *t, *v, *colonpos, *sqpos;
+    char *position = NULL;
     int daynum = 0, tvnum = 0;
     unsigned int inner_tag;
     BACNET_APPLICATION_DATA_VALUE dummy_value = { 0 };
@@ -2706,7 +2677,7 @@ parse_weeklyschedule(char *str, BACNET_APPLICATION_DATA_VALUE *value)
     value->tag = BACNET_APPLICATION_TAG_WEEKLY_SCHEDULE;
 
     /* Parse the inner tag */
-    chunk = strtok(str, ";");
+    chunk = strtok_next(str, ';', &position);
     chunk = ltrim(chunk, "(");
     if (false ==
         bacapp_parse_application_data(
@@ -2719,7 +2690,7 @@ parse_weeklyschedule(char *str, BACNET_APPLICATION_DATA_VALUE *value)
         inner_tag = (int)dummy_value.type.Unsigned_Int;
     }
 
-    chunk = strtok(NULL, ";");
+    chunk = strtok_next(NULL, ';', &position);
 
     while (chunk != NULL) {
         dsch = &value->type.Weekly_Schedule.weeklySchedule[daynum];
@@ -2735,9 +2706,9 @@ parse_weeklyschedule(char *str, BACNET_APPLICATION_DATA_VALUE *value)
         chunk = rtrim(ltrim(chunk, "([ "), " ])");
 
         /* The list can be empty */
+        tvnum = 0;
         if (chunk[0] != 0) {
             /* loop through the time value pairs */
-            tvnum = 0;
             do {
                 /* Find the comma delimiter, replace with NUL (like strtok) */
                 comma = strchr(chunk, ',');
@@ -2790,7 +2761,7 @@ parse_weeklyschedule(char *str, BACNET_APPLICATION_DATA_VALUE *value)
         dsch->TV_Count = tvnum;
 
         /* Find the start of the next day */
-        chunk = strtok(NULL, ";");
+        chunk = strtok_next(NULL, ';', &position);
         daynum++;
     }
 
@@ -2858,7 +2829,9 @@ static bool strtod_checked(const char *s, double *out)
 
 /* used to load the app data struct with the proper data
    converted from a command line argument.
-   "argv" is not const to allow using strtok internally. It MAY be modified. */
+   "argv" is not const to allow tokens to be split in place. It MAY be
+   modified. The parse uses no static data, so different strings can be
+   parsed at the same time. */
 bool bacapp_parse_application_data(
     BACNET_APPLICATION_TAG tag_number,
     char *argv,
@@ -3090,6 +3063,53 @@ bool bacapp_parse_application_data(
 
     return status;
 }
+
+/**
+ * @brief Parse a column of strings of one application tag, such as the
+ *  values of a file of property writes, into an array of values. Each
+ *  value is single, with no next value, so that it can be given to a
+ *  property write, such as bacnet_wpm_plan_write_add(). Each row is
+ *  parsed on its own, without static data, so that the rows of a large
+ *  column can be split between threads, each with its own range of rows.
+ * @param tag_number - application tag of all of the values
+ * @param argv - column of strings, which MAY be modified
+ * @param row_count - number of strings, values and row status
+ * @param value - array of values, one for each string
+ * @param row_status - array of the result of each row, true if the row
+ *  was parsed, or NULL if only the count is needed
+ * @return number of rows that were parsed
+ */
+size_t bacapp_parse_application_data_array(
+    BACNET_APPLICATION_TAG tag_number,
+    char **argv,
+    size_t row_count,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    bool *row_status)
+{
+    size_t row;
+    size_t parsed = 0;
+    bool status;
+
+    if (!argv || !value) {
+        return 0;
+    }
+    for (row = 0; row < row_count; row++) {
+        status = false;
+        if (argv[row] || (tag_number == BACNET_APPLICATION_TAG_NULL)) {
+            status = bacapp_parse_application_data(
+                tag_number, argv[row], &value[row]);
+        }
+        value[row].next = NULL;
+        if (status) {
+            parsed++;
+        }
+        if (row_status) {
+            row_status[row] = status;
+        }
+    }
+
+    return parsed;
+}
 #else
 bool bacapp_parse_application_data(
     BACNET_APPLICATION_TAG tag_number,
@@ -3101,6 +3121,26 @@ bool bacapp_parse_application_data(
     (void)value;
     return false;
 }
+
+size_t bacapp_parse_application_data_array(
+    BACNET_APPLICATION_TAG tag_number,
+    char **argv,
+    size_t row_count,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    bool *row_status)
+{
+    size_t row;
+
+    (void)tag_number;
+    (void)argv;
+    (void)value;
+    if (row_status) {
+        for (row = 0; row < row_count; row++) {
+            row_status[row] = false;
+        }
+    }
+    return 0;
+}
 #endif /* BACAPP_PRINT_ENABLED */
 
 /**
@@ -3390,6 +3430,437 @@ int bacapp_property_value_decode(
     return apdu_len;
 }
 
+/**
+ * @brief Decode one primitive application tagged value without copying
+ *  its octet string, character string or bit string payload, which is
+ *  referenced in the buffer instead.
+ *
+ * @param apdu - buffer of data to be decoded, which must outlive the value
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - decoded value reference, if decoded. The next member
+ *  is left alone.
+ *
+ * @return the number of apdu bytes consumed, 0 on bad args, or
+ * BACNET_STATUS_ERROR
+ */
+int bacapp_decode_application_data_ref(
+    uint8_t *apdu, uint32_t apdu_size, BACNET_APPLICATION_DATA_VALUE_REF *value)
+{
+    int len = 0;
+    int tag_len = 0;
+    uint32_t len_value = 0;
+    uint8_t *payload = NULL;
+    BACNET_TAG tag = { 0 };
+
+    if (!value) {
+        return 0;
+    }
+    tag_len = bacnet_tag_decode(apdu, apdu_size, &tag);
+    if ((tag_len <= 0) || !tag.application) {
+        if (apdu && (apdu_size > 0)) {
+            return BACNET_STATUS_ERROR;
+        }
+        return 0;
+    }
+    len_value = tag.len_value_type;
+    payload = &apdu[tag_len];
+    value->tag = tag.number;
+    switch (tag.number) {
+        case BACNET_APPLICATION_TAG_NULL:
+            break;
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            /* the value is in the tag */
+            value->type.Boolean = decode_boolean(len_value);
+            len_value = 0;
+            break;
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            len = bacnet_unsigned_decode(
+                payload, apdu_size - tag_len, len_value,
+                &value->type.Unsigned_Int);
+            break;
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            len = bacnet_signed_decode(
+                payload, apdu_size - tag_len, len_value,
+                &value->type.Signed_Int);
+            break;
+        case BACNET_APPLICATION_TAG_REAL:
+            len = bacnet_real_decode(
+                payload, apdu_size - tag_len, len_value, &value->type.Real);
+            break;
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            len = bacnet_double_decode(
+                payload, apdu_size - tag_len, len_value, &value->type.Double);
+            break;
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            len = bacnet_enumerated_decode(
+                payload, apdu_size - tag_len, len_value,
+                &value->type.Enumerated);
+            break;
+        case BACNET_APPLICATION_TAG_DATE:
+            len = bacnet_date_decode(
+                payload, apdu_size - tag_len, len_value, &value->type.Date);
+            break;
+        case BACNET_APPLICATION_TAG_TIME:
+            len = bacnet_time_decode(
+                payload, apdu_size - tag_len, len_value, &value->type.Time);
+            break;
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            len = bacnet_object_id_decode(
+                payload, apdu_size - tag_len, len_value,
+                &value->type.Object_Id.type, &value->type.Object_Id.instance);
+            break;
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            if (len_value <= (apdu_size - tag_len)) {
+                value->type.Payload.value = payload;
+                value->type.Payload.length = len_value;
+                value->type.Payload.prefix = 0;
+                len = len_value;
+            }
+            break;
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            /* the first octet is the character set, or the unused bits */
+            if ((len_value > 0) && (len_value <= (apdu_size - tag_len))) {
+                value->type.Payload.prefix = payload[0];
+                value->type.Payload.value = &payload[1];
+                value->type.Payload.length = len_value - 1;
+                len = len_value;
+            }
+            break;
+        default:
+            return BACNET_STATUS_ERROR;
+    }
+    if ((len < 0) || ((uint32_t)len != len_value)) {
+        return BACNET_STATUS_ERROR;
+    }
+    value->apdu = apdu;
+    value->apdu_len = tag_len + len_value;
+
+    return (int)value->apdu_len;
+}
+
+/**
+ * @brief Copy a value reference into a full application value, which
+ *  copies the octet string, character string or bit string payload.
+ *
+ * @param ref - value reference from bacapp_decode_application_data_ref()
+ * @param value - application value to fill. The next member is kept.
+ *
+ * @return true if the value was copied, false if it does not fit
+ *  or that data type is not supported
+ */
+bool bacapp_value_ref_materialize(
+    BACNET_APPLICATION_DATA_VALUE_REF *ref,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    int len = 0;
+    BACNET_APPLICATION_DATA_VALUE *next = NULL;
+
+    if (!ref || !value || !ref->apdu) {
+        return false;
+    }
+    next = value->next;
+    len = bacapp_decode_application_data(ref->apdu, ref->apdu_len, value);
+    value->next = next;
+
+    return (len > 0) && ((uint32_t)len == ref->apdu_len);
+}
+
+/**
+ * @brief Compare a value reference with an application value, without
+ *  copying the referenced payload.
+ *
+ * @param ref - value reference from bacapp_decode_application_data_ref()
+ * @param value - application value to compare
+ *
+ * @return true if matching or same, false if different
+ */
+bool bacapp_same_value_ref(
+    BACNET_APPLICATION_DATA_VALUE_REF *ref,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    bool status = false;
+#if defined(BACAPP_BIT_STRING)
+    BACNET_BIT_STRING bit_string = { 0 };
+#endif
+
+    if ((ref == NULL) || (value == NULL)) {
+        return false;
+    }
+    if (value->context_specific || (ref->tag != value->tag)) {
+        return false;
+    }
+    switch (ref->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            status = true;
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            status = (ref->type.Boolean == value->type.Boolean);
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            status = (ref->type.Unsigned_Int == value->type.Unsigned_Int);
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            status = (ref->type.Signed_Int == value->type.Signed_Int);
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            status = !islessgreater(ref->type.Real, value->type.Real);
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            status = !islessgreater(ref->type.Double, value->type.Double);
+            break;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            status = (ref->type.Enumerated == value->type.Enumerated);
+            break;
+#endif
+#if defined(BACAPP_DATE)
+        case BACNET_APPLICATION_TAG_DATE:
+            status =
+                (datetime_compare_date(&ref->type.Date, &value->type.Date) ==
+                 0);
+            break;
+#endif
+#if defined(BACAPP_TIME)
+        case BACNET_APPLICATION_TAG_TIME:
+            status =
+                (datetime_compare_time(&ref->type.Time, &value->type.Time) ==
+                 0);
+            break;
+#endif
+#if defined(BACAPP_OBJECT_ID)
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            status =
+                ((ref->type.Object_Id.type == value->type.Object_Id.type) &&
+                 (ref->type.Object_Id.instance ==
+                  value->type.Object_Id.instance));
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            if ((ref->type.Payload.prefix ==
+                 characterstring_encoding(&value->type.Character_String)) &&
+                (ref->type.Payload.length ==
+                 characterstring_length(&value->type.Character_String))) {
+                status =
+                    (memcmp(
+                         ref->type.Payload.value,
+                         characterstring_value(&value->type.Character_String),
+                         ref->type.Payload.length) == 0);
+            }
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            if (ref->type.Payload.length ==
+                octetstring_length(&value->type.Octet_String)) {
+                status =
+                    (memcmp(
+                         ref->type.Payload.value,
+                         octetstring_value(&value->type.Octet_String),
+                         ref->type.Payload.length) == 0);
+            }
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            /* bit strings are small, and stored in reversed bit order */
+            if (bacnet_bitstring_decode(
+                    ref->type.Payload.value - 1, ref->type.Payload.length + 1,
+                    ref->type.Payload.length + 1, &bit_string) > 0) {
+                status = bitstring_same(&bit_string, &value->type.Bit_String);
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * Initialize an array (or single) #BACNET_PROPERTY_VALUE_REF
+ *
+ * @param value - one or more #BACNET_PROPERTY_VALUE_REF elements
+ * @param count - number of #BACNET_PROPERTY_VALUE_REF elements
+ */
+void bacapp_property_value_ref_list_init(
+    BACNET_PROPERTY_VALUE_REF *value, size_t count)
+{
+    size_t i = 0;
+
+    if (value && count) {
+        for (i = 0; i < count; i++) {
+            value->propertyIdentifier = MAX_BACNET_PROPERTY_ID;
+            value->propertyArrayIndex = BACNET_ARRAY_ALL;
+            value->priority = BACNET_NO_PRIORITY;
+            value->value.tag = BACNET_APPLICATION_TAG_NULL;
+            value->value.apdu = NULL;
+            value->value.apdu_len = 0;
+            value->value.next = NULL;
+            value->application_data = NULL;
+            value->application_data_len = 0;
+            if ((i + 1) < count) {
+                value->next = value + 1;
+            } else {
+                value->next = NULL;
+            }
+            value++;
+        }
+    }
+}
+
+/**
+ * @brief Decode one BACnetPropertyValue value, like
+ *  bacapp_property_value_decode(), into value references into the buffer.
+ *  Values after the first are decoded into the value->value.next list
+ *  while it lasts and are skipped after that, and all the values can be
+ *  found again from application_data.
+ *
+ * @param apdu Pointer to the buffer of encoded value, which must outlive
+ *  the value
+ * @param apdu_size Size of the buffer holding the encode value
+ * @param value Pointer to the property value reference
+ *
+ * @return Bytes decoded or BACNET_STATUS_ERROR on error.
+ */
+int bacapp_property_value_ref_decode(
+    uint8_t *apdu, uint32_t apdu_size, BACNET_PROPERTY_VALUE_REF *value)
+{
+    int len = 0;
+    int apdu_len = 0;
+    uint32_t enumerated_value = 0;
+    uint32_t len_value_type = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    BACNET_APPLICATION_DATA_VALUE_REF *app_data = NULL;
+    BACNET_APPLICATION_DATA_VALUE_REF skip_data = { 0 };
+
+    if (!value) {
+        return bacapp_property_value_decode(apdu, apdu_size, NULL);
+    }
+    /* property-identifier [0] BACnetPropertyIdentifier */
+    len = bacnet_enumerated_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 0, &enumerated_value);
+    if (len > 0) {
+        value->propertyIdentifier = enumerated_value;
+        apdu_len += len;
+    } else {
+        return BACNET_STATUS_ERROR;
+    }
+    /* property-array-index [1] Unsigned OPTIONAL */
+    value->propertyArrayIndex = BACNET_ARRAY_ALL;
+    if (bacnet_is_context_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len, &len_value_type)) {
+        apdu_len += len;
+        len = bacnet_unsigned_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, len_value_type,
+            &unsigned_value);
+        if ((len > 0) && (unsigned_value <= UINT32_MAX)) {
+            apdu_len += len;
+            value->propertyArrayIndex = unsigned_value;
+        } else {
+            return BACNET_STATUS_ERROR;
+        }
+    }
+    /* property-value [2] ABSTRACT-SYNTAX.&Type */
+    if (!bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 2, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    value->application_data = &apdu[apdu_len];
+    app_data = &value->value;
+    do {
+        len = bacapp_decode_application_data_ref(
+            &apdu[apdu_len], apdu_size - apdu_len,
+            app_data ? app_data : &skip_data);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        if (app_data) {
+            app_data = app_data->next;
+        }
+    } while (!bacnet_is_closing_tag_number(
+        &apdu[apdu_len], apdu_size - apdu_len, 2, &len));
+    value->application_data_len = &apdu[apdu_len] - value->application_data;
+    apdu_len += len;
+    /* priority [3] Unsigned (1..16) OPTIONAL */
+    value->priority = BACNET_NO_PRIORITY;
+    if (bacnet_is_context_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 3, &len, &len_value_type)) {
+        apdu_len += len;
+        len = bacnet_unsigned_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, len_value_type,
+            &unsigned_value);
+        if ((len > 0) && (unsigned_value <= UINT8_MAX)) {
+            apdu_len += len;
+            value->priority = unsigned_value;
+        } else {
+            return BACNET_STATUS_ERROR;
+        }
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Copy a property value reference into a full property value,
+ *  decoding all its values into the value->value list while it lasts.
+ *
+ * @param ref - property value reference from
+ *  bacapp_property_value_ref_decode()
+ * @param value - property value to fill
+ *
+ * @return true if all the values were copied
+ */
+bool bacapp_property_value_ref_materialize(
+    BACNET_PROPERTY_VALUE_REF *ref, BACNET_PROPERTY_VALUE *value)
+{
+    int len = 0;
+    uint32_t apdu_len = 0;
+    BACNET_APPLICATION_DATA_VALUE *app_data = NULL;
+    BACNET_APPLICATION_DATA_VALUE *next = NULL;
+
+    if (!ref || !value || !ref->application_data) {
+        return false;
+    }
+    value->propertyIdentifier = ref->propertyIdentifier;
+    value->propertyArrayIndex = ref->propertyArrayIndex;
+    value->priority = ref->priority;
+    app_data = &value->value;
+    while (app_data != NULL) {
+        next = app_data->next;
+        len = bacapp_decode_application_data(
+            &ref->application_data[apdu_len],
+            ref->application_data_len - apdu_len, app_data);
+        app_data->next = next;
+        if (len <= 0) {
+            return false;
+        }
+        apdu_len += len;
+        if (apdu_len >= ref->application_data_len) {
+            return true;
+        }
+        app_data = app_data->next;
+    }
+
+    return false;
+}
+
 /* generic - can be used by other unit tests
    returns true if matching or same, false if different */
 bool bacapp_same_value(
@@ -160,6 +160,51 @@ typedef struct BACnet_Property_Value {
     struct BACnet_Property_Value *next;
 } BACNET_PROPERTY_VALUE;
 
+/* A primitive application tagged value that refers to the octet string,
+   character string and bit string payloads in the decoded buffer instead
+   of copying them, so it is small.  The buffer must outlive the value. */
+struct BACnet_Application_Data_Value_Ref;
+typedef struct BACnet_Application_Data_Value_Ref {
+    uint8_t tag; /* application tag data type */
+    union {
+        /* NULL - not needed as it is encoded in the tag alone */
+        bool Boolean;
+        BACNET_UNSIGNED_INTEGER Unsigned_Int;
+        int32_t Signed_Int;
+        float Real;
+        double Double;
+        uint32_t Enumerated;
+        BACNET_DATE Date;
+        BACNET_TIME Time;
+        BACNET_OBJECT_ID Object_Id;
+        /* octet string, character string or bit string payload */
+        struct {
+            uint8_t *value;
+            uint32_t length;
+            /* character set, or number of unused bits */
+            uint8_t prefix;
+        } Payload;
+    } type;
+    /* the whole encoding of the value, including the tag */
+    uint8_t *apdu;
+    uint32_t apdu_len;
+    /* simple linked list if needed */
+    struct BACnet_Application_Data_Value_Ref *next;
+} BACNET_APPLICATION_DATA_VALUE_REF;
+
+struct BACnet_Property_Value_Ref;
+typedef struct BACnet_Property_Value_Ref {
+    BACNET_PROPERTY_ID propertyIdentifier;
+    BACNET_ARRAY_INDEX propertyArrayIndex;
+    BACNET_APPLICATION_DATA_VALUE_REF value;
+    /* all the values between the property-value tags */
+    uint8_t *application_data;
+    uint32_t application_data_len;
+    uint8_t priority;
+    /* simple linked list */
+    struct BACnet_Property_Value_Ref *next;
+} BACNET_PROPERTY_VALUE_REF;
+
 /* used for printing values */
 struct BACnet_Object_Property_Value;
 typedef struct BACnet_Object_Property_Value {
@@ -198,6 +243,33 @@ extern "C" {
         uint32_t apdu_size,
         BACNET_PROPERTY_VALUE *value);
 
+    BACNET_STACK_EXPORT
+    int bacapp_decode_application_data_ref(
+        uint8_t *apdu,
+        uint32_t apdu_size,
+        BACNET_APPLICATION_DATA_VALUE_REF *value);
+    BACNET_STACK_EXPORT
+    bool bacapp_value_ref_materialize(
+        BACNET_APPLICATION_DATA_VALUE_REF *ref,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    bool bacapp_same_value_ref(
+        BACNET_APPLICATION_DATA_VALUE_REF *ref,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    void bacapp_property_value_ref_list_init(
+        BACNET_PROPERTY_VALUE_REF *value,
+        size_t count);
+    BACNET_STACK_EXPORT
+    int bacapp_property_value_ref_decode(
+        uint8_t *apdu,
+        uint32_t apdu_size,
+        BACNET_PROPERTY_VALUE_REF *value);
+    BACNET_STACK_EXPORT
+    bool bacapp_property_value_ref_materialize(
+        BACNET_PROPERTY_VALUE_REF *ref,
+        BACNET_PROPERTY_VALUE *value);
+
     BACNET_STACK_EXPORT
     int bacapp_encode_data(
         uint8_t * apdu,
@@ -321,6 +393,13 @@ extern "C" {
         BACNET_APPLICATION_TAG tag_number,
         char *argv,
         BACNET_APPLICATION_DATA_VALUE * value);
+    BACNET_STACK_EXPORT
+    size_t bacapp_parse_application_data_array(
+        BACNET_APPLICATION_TAG tag_number,
+        char **argv,
+        size_t row_count,
+        BACNET_APPLICATION_DATA_VALUE * value,
+        bool *row_status);
 
     BACNET_STACK_EXPORT
     bool bacapp_print_value(
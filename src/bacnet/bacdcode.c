@@ -5,6 +5,7 @@
  * @date 2004
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
+#include <limits.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -193,6 +194,13 @@ int decode_max_apdu(uint8_t octet)
     return max_apdu;
 }
 
+/* The single octet of a tag with a tag number of 0..14 and a length of
+   0..4, which is the whole tag of the fixed width primitives, and is
+   stored directly by their encoders instead of through encode_tag() */
+#define TAG_OCTET(tag_number, context_specific, len_value_type) \
+    ((uint8_t)(((tag_number) << 4) | ((context_specific) ? BIT(3) : 0) | \
+        (len_value_type)))
+
 /**
  * Encode a BACnet tag and returns the number of bytes consumed.
  * (From clause 20.2.1 General Rules for Encoding BACnet Tags)
@@ -948,6 +956,113 @@ bool bacnet_is_closing_tag_number(
     return match;
 }
 
+/* Octets used by a tag and its content, by the first octet of the tag.
+   Closing and opening tags are marked, and zero marks a tag with an
+   extended tag number or length that has to be decoded. */
+#define TAG_SCAN_OPENING 0x40
+#define TAG_SCAN_CLOSING 0x80
+#define TAG_SCAN_LENGTH(x)                                                  \
+    (IS_EXTENDED_TAG_NUMBER(x) || IS_EXTENDED_VALUE(x)                      \
+            ? 0                                                             \
+            : IS_CONTEXT_SPECIFIC(x)                                        \
+            ? (IS_OPENING_TAG(x)                                            \
+                      ? TAG_SCAN_OPENING                                    \
+                      : (IS_CLOSING_TAG(x) ? TAG_SCAN_CLOSING               \
+                                           : 1 + ((x)&0x07)))               \
+            : (IS_OPENING_TAG(x) || IS_CLOSING_TAG(x) ||                    \
+                      (((x) >> 4) == BACNET_APPLICATION_TAG_BOOLEAN)        \
+                    ? 1                                                     \
+                    : 1 + ((x)&0x07)))
+#define TAG_SCAN_ROW(x)                                                     \
+    TAG_SCAN_LENGTH((x) + 0x0), TAG_SCAN_LENGTH((x) + 0x1),                 \
+        TAG_SCAN_LENGTH((x) + 0x2), TAG_SCAN_LENGTH((x) + 0x3),             \
+        TAG_SCAN_LENGTH((x) + 0x4), TAG_SCAN_LENGTH((x) + 0x5),             \
+        TAG_SCAN_LENGTH((x) + 0x6), TAG_SCAN_LENGTH((x) + 0x7),             \
+        TAG_SCAN_LENGTH((x) + 0x8), TAG_SCAN_LENGTH((x) + 0x9),             \
+        TAG_SCAN_LENGTH((x) + 0xA), TAG_SCAN_LENGTH((x) + 0xB),             \
+        TAG_SCAN_LENGTH((x) + 0xC), TAG_SCAN_LENGTH((x) + 0xD),             \
+        TAG_SCAN_LENGTH((x) + 0xE), TAG_SCAN_LENGTH((x) + 0xF)
+static const uint8_t Tag_Scan_Length[256] = { TAG_SCAN_ROW(0x00),
+    TAG_SCAN_ROW(0x10), TAG_SCAN_ROW(0x20), TAG_SCAN_ROW(0x30),
+    TAG_SCAN_ROW(0x40), TAG_SCAN_ROW(0x50), TAG_SCAN_ROW(0x60),
+    TAG_SCAN_ROW(0x70), TAG_SCAN_ROW(0x80), TAG_SCAN_ROW(0x90),
+    TAG_SCAN_ROW(0xA0), TAG_SCAN_ROW(0xB0), TAG_SCAN_ROW(0xC0),
+    TAG_SCAN_ROW(0xD0), TAG_SCAN_ROW(0xE0), TAG_SCAN_ROW(0xF0) };
+
+/**
+ * @brief Returns the length of the data between an opening tag and its
+ *  matching closing tag, such as to skip constructed data.
+ *  Tags with a short tag number and length are sized with a table from
+ *  their first octet, so that only the other tags are decoded.
+ *  Context tagged data is skipped with the length from its tag, which
+ *  holds the content octets for every primitive datatype.
+ *
+ * @param apdu - buffer of data starting with the opening tag
+ * @param apdu_size - number of bytes in the buffer
+ *
+ * @return number of bytes between the opening and the closing tag 0..N,
+ *  or BACNET_STATUS_ERROR if the data is malformed or not all in the buffer
+ */
+int bacnet_enclosed_data_length(uint8_t *apdu, size_t apdu_size)
+{
+    size_t offset = 0;
+    size_t opening_len = 0;
+    unsigned depth = 0;
+    uint32_t remaining = 0;
+    int len = 0;
+    BACNET_TAG tag = { 0 };
+
+    if (!apdu || !bacnet_is_opening_tag(apdu, apdu_size)) {
+        return BACNET_STATUS_ERROR;
+    }
+    do {
+        if (offset >= apdu_size) {
+            /* error: the closing tag is missing */
+            return BACNET_STATUS_ERROR;
+        }
+        len = Tag_Scan_Length[apdu[offset]];
+        if (len == TAG_SCAN_OPENING) {
+            depth++;
+            len = 1;
+        } else if (len == TAG_SCAN_CLOSING) {
+            depth--;
+            len = 1;
+        } else if (len == 0) {
+            remaining = (uint32_t)(apdu_size - offset);
+            if ((size_t)remaining != (apdu_size - offset)) {
+                remaining = UINT32_MAX;
+            }
+            len = bacnet_tag_decode(&apdu[offset], remaining, &tag);
+            if (len <= 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            if (tag.opening) {
+                depth++;
+            } else if (tag.closing) {
+                depth--;
+            } else if (!tag.application ||
+                (tag.number != BACNET_APPLICATION_TAG_BOOLEAN)) {
+                if (tag.len_value_type > (remaining - len)) {
+                    return BACNET_STATUS_ERROR;
+                }
+                len += (int)tag.len_value_type;
+            }
+        }
+        if (opening_len == 0) {
+            opening_len = len;
+        }
+        if (depth == 0) {
+            break;
+        }
+        offset += len;
+    } while (true);
+    if ((offset - opening_len) > INT_MAX) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return (int)(offset - opening_len);
+}
+
 /**
  * @brief Encode an boolean value.
  * From clause 20.2.3 Encoding of a Boolean Value
@@ -1849,6 +1964,13 @@ int encode_context_object_id(uint8_t *apdu,
     uint8_t *apdu_offset = NULL;
 
     /* length of object id is 4 octets, as per 20.2.14 */
+    if (tag_number <= 14) {
+        if (apdu) {
+            apdu[0] = TAG_OCTET(tag_number, true, 4);
+            (void)encode_bacnet_object_id(&apdu[1], object_type, instance);
+        }
+        return 5;
+    }
     len = encode_tag(apdu, tag_number, true, 4);
     if (apdu) {
         apdu_offset = &apdu[len];
@@ -1872,19 +1994,13 @@ int encode_context_object_id(uint8_t *apdu,
 int encode_application_object_id(
     uint8_t *apdu, BACNET_OBJECT_TYPE object_type, uint32_t instance)
 {
-    int len = 0;
-    uint8_t *apdu_offset = NULL;
-
-    /* get the length by using NULL APDU */
-    len = encode_bacnet_object_id(NULL, object_type, instance);
-    len = encode_tag(
-        apdu, BACNET_APPLICATION_TAG_OBJECT_ID, false, (uint32_t)len);
+    /* length of object id is 4 octets, as per 20.2.14 */
     if (apdu) {
-        apdu_offset = &apdu[len];
+        apdu[0] = TAG_OCTET(BACNET_APPLICATION_TAG_OBJECT_ID, false, 4);
+        (void)encode_bacnet_object_id(&apdu[1], object_type, instance);
     }
-    len += encode_bacnet_object_id(apdu_offset, object_type, instance);
 
-    return len;
+    return 5;
 }
 
 #if BACNET_USE_OCTETSTRING
@@ -2220,7 +2336,6 @@ int encode_bacnet_character_string(
     uint8_t *apdu, BACNET_CHARACTER_STRING *char_string)
 {
     uint32_t apdu_len = 1 /*encoding */;
-    uint32_t i;
     size_t length;
     char *value;
 
@@ -2228,8 +2343,8 @@ int encode_bacnet_character_string(
     if (apdu) {
         apdu[0] = characterstring_encoding(char_string);
         value = characterstring_value(char_string);
-        for (i = 0; i < length; i++) {
-            apdu[1 + i] = (uint8_t)value[i];
+        if (length) {
+            memcpy(&apdu[1], value, length);
         }
     }
     apdu_len += length;
@@ -2291,6 +2406,91 @@ int encode_context_character_string(
     return len;
 }
 
+/**
+ * @brief Get the length of a C string to be encoded as a BACnet Character
+ *  String, which is zero when it would not fit in one, the same as
+ *  characterstring_init_ansi()
+ * @param value - C string, or NULL
+ * @return number of characters to be encoded
+ */
+static size_t character_string_ansi_length(const char *value)
+{
+    size_t length = 0;
+
+    if (value) {
+        length = strlen(value);
+        /* save a byte at the end for NULL, as does the string */
+        if (length > (MAX_CHARACTER_STRING_BYTES - 1)) {
+            length = 0;
+        }
+    }
+
+    return length;
+}
+
+/**
+ * @brief Encode a C string as an application tagged BACnet Character
+ *  String in ANSI X3.4 encoding, without an intermediate
+ *  BACNET_CHARACTER_STRING copy
+ *  from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param value - C string to be encoded, or NULL for an empty string
+ *
+ * @return returns the number of apdu bytes consumed
+ */
+int encode_application_character_string_ansi(uint8_t *apdu, const char *value)
+{
+    int len = 0;
+    size_t length;
+
+    length = character_string_ansi_length(value);
+    len = encode_tag(apdu, BACNET_APPLICATION_TAG_CHARACTER_STRING, false,
+        (uint32_t)(1 + length));
+    if (apdu) {
+        apdu[len] = CHARACTER_ANSI_X34;
+        if (length) {
+            memcpy(&apdu[len + 1], value, length);
+        }
+    }
+    len += 1 + (int)length;
+
+    return len;
+}
+
+/**
+ * @brief Encode a C string as a context tagged BACnet Character
+ *  String in ANSI X3.4 encoding, without an intermediate
+ *  BACNET_CHARACTER_STRING copy
+ *  from 20.2.9 Encoding of a Character String Value
+ *  and 20.2.1 General Rules for Encoding BACnet Tags
+ *
+ * @param apdu - buffer to hold the bytes, or NULL for length
+ * @param tag_number - context tag number to encode
+ * @param value - C string to be encoded, or NULL for an empty string
+ *
+ * @return returns the number of apdu bytes consumed
+ */
+int encode_context_character_string_ansi(
+    uint8_t *apdu, uint8_t tag_number, const char *value)
+{
+    int len = 0;
+    size_t length;
+
+    length = character_string_ansi_length(value);
+    len = encode_tag(apdu, tag_number, true, (uint32_t)(1 + length));
+    if (apdu) {
+        apdu[len] = CHARACTER_ANSI_X34;
+        if (length) {
+            memcpy(&apdu[len + 1], value, length);
+        }
+    }
+    len += 1 + (int)length;
+
+    return len;
+}
+
 /**
  * @brief Decodes from bytes into a BACnet Character String value
  * from clause 20.2.9 Encoding of a Character String Value
@@ -2796,6 +2996,13 @@ int encode_context_unsigned(
     uint8_t *apdu_offset = NULL;
 
     /* length of unsigned is variable, as per 20.2.4 */
+    if ((tag_number <= 14) && (value <= UINT8_MAX)) {
+        if (apdu) {
+            apdu[0] = TAG_OCTET(tag_number, true, 1);
+            apdu[1] = (uint8_t)value;
+        }
+        return 2;
+    }
     len = bacnet_unsigned_length(value);
     len = encode_tag(apdu, tag_number, true, (uint32_t)len);
     if (apdu) {
@@ -2821,6 +3028,13 @@ int encode_application_unsigned(uint8_t *apdu, BACNET_UNSIGNED_INTEGER value)
     int len = 0;
     uint8_t *apdu_offset = NULL;
 
+    if (value <= UINT8_MAX) {
+        if (apdu) {
+            apdu[0] = TAG_OCTET(BACNET_APPLICATION_TAG_UNSIGNED_INT, false, 1);
+            apdu[1] = (uint8_t)value;
+        }
+        return 2;
+    }
     len = bacnet_unsigned_length(value);
     len = encode_tag(
         apdu, BACNET_APPLICATION_TAG_UNSIGNED_INT, false, (uint32_t)len);
@@ -3047,6 +3261,13 @@ int encode_application_enumerated(uint8_t *apdu, uint32_t value)
     int len = 0; /* return value */
     uint8_t *apdu_offset = NULL;
 
+    if (value <= UINT8_MAX) {
+        if (apdu) {
+            apdu[0] = TAG_OCTET(BACNET_APPLICATION_TAG_ENUMERATED, false, 1);
+            apdu[1] = (uint8_t)value;
+        }
+        return 2;
+    }
     len = bacnet_unsigned_length(value);
     len = encode_tag(
         apdu, BACNET_APPLICATION_TAG_ENUMERATED, false, (uint32_t)len);
@@ -3074,6 +3295,13 @@ int encode_context_enumerated(uint8_t *apdu, uint8_t tag_number, uint32_t value)
     int len = 0; /* return value */
     uint8_t *apdu_offset = NULL;
 
+    if ((tag_number <= 14) && (value <= UINT8_MAX)) {
+        if (apdu) {
+            apdu[0] = TAG_OCTET(tag_number, true, 1);
+            apdu[1] = (uint8_t)value;
+        }
+        return 2;
+    }
     len = bacnet_unsigned_length(value);
     len = encode_tag(apdu, tag_number, true, (uint32_t)len);
     if (apdu) {
@@ -3372,17 +3600,13 @@ int encode_context_signed(uint8_t *apdu, uint8_t tag_number, int32_t value)
  */
 int encode_application_real(uint8_t *apdu, float value)
 {
-    int len = 0;
-    uint8_t *apdu_offset = NULL;
-
     /* length of REAL is 4 octets, as per 20.2.6 */
-    len = encode_tag(apdu, BACNET_APPLICATION_TAG_REAL, false, 4);
     if (apdu) {
-        apdu_offset = &apdu[len];
+        apdu[0] = TAG_OCTET(BACNET_APPLICATION_TAG_REAL, false, 4);
+        (void)encode_bacnet_real(value, &apdu[1]);
     }
-    len += encode_bacnet_real(value, apdu_offset);
 
-    return len;
+    return 5;
 }
 
 /**
@@ -3402,6 +3626,13 @@ int encode_context_real(uint8_t *apdu, uint8_t tag_number, float value)
     uint8_t *apdu_offset = NULL;
 
     /* length of REAL is 4 octets, as per 20.2.6 */
+    if (tag_number <= 14) {
+        if (apdu) {
+            apdu[0] = TAG_OCTET(tag_number, true, 4);
+            (void)encode_bacnet_real(value, &apdu[1]);
+        }
+        return 5;
+    }
     len = encode_tag(apdu, tag_number, true, 4);
     if (apdu) {
         apdu_offset = &apdu[len];
@@ -4496,3 +4727,325 @@ int bacnet_array_encode(uint32_t object_instance,
 
     return apdu_len;
 }
+
+/**
+ * @brief Start decoding the fields of a buffer with a cursor
+ * @param cursor - cursor to be initialized
+ * @param apdu - buffer of the encoded fields
+ * @param apdu_size - number of bytes in the buffer
+ */
+void bacnet_cursor_init(
+    BACNET_DECODE_CURSOR *cursor, uint8_t *apdu, uint32_t apdu_size)
+{
+    if (cursor) {
+        cursor->apdu = apdu;
+        cursor->apdu_size = apdu ? apdu_size : 0;
+        cursor->apdu_len = 0;
+        cursor->error = apdu ? false : true;
+    }
+}
+
+/**
+ * @brief Determine if any field decoded with a cursor has failed
+ * @param cursor - cursor of the decoding
+ * @return true if a field failed, or there was no buffer
+ */
+bool bacnet_cursor_error(const BACNET_DECODE_CURSOR *cursor)
+{
+    return (cursor ? cursor->error : true);
+}
+
+/**
+ * @brief Fail the decoding with a cursor, such as when a decoded
+ *  value is out of range.  The fields after it are not decoded.
+ * @param cursor - cursor of the decoding
+ */
+void bacnet_cursor_error_set(BACNET_DECODE_CURSOR *cursor)
+{
+    if (cursor) {
+        cursor->error = true;
+    }
+}
+
+/**
+ * @brief Get the number of bytes decoded with a cursor
+ * @param cursor - cursor of the decoding
+ * @return number of bytes decoded, or BACNET_STATUS_ERROR if a field failed
+ */
+int bacnet_cursor_len(const BACNET_DECODE_CURSOR *cursor)
+{
+    if (!cursor || cursor->error) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return (int)cursor->apdu_len;
+}
+
+/**
+ * @brief Get the number of bytes not yet decoded with a cursor
+ * @param cursor - cursor of the decoding
+ * @return number of bytes remaining, or zero if a field failed
+ */
+uint32_t bacnet_cursor_remaining(const BACNET_DECODE_CURSOR *cursor)
+{
+    if (!cursor || cursor->error) {
+        return 0;
+    }
+
+    return cursor->apdu_size - cursor->apdu_len;
+}
+
+/**
+ * @brief Get the next byte to be decoded with a cursor, such as for
+ *  decoding a field with a function that does not take a cursor,
+ *  followed by bacnet_cursor_skip() with the length decoded.
+ * @param cursor - cursor of the decoding
+ * @return pointer to the next byte, or NULL if a field failed
+ */
+uint8_t *bacnet_cursor_apdu(const BACNET_DECODE_CURSOR *cursor)
+{
+    if (!cursor || cursor->error) {
+        return NULL;
+    }
+
+    return &cursor->apdu[cursor->apdu_len];
+}
+
+/**
+ * @brief Move a cursor past a field
+ * @param cursor - cursor of the decoding
+ * @param len - number of bytes of the field, or a negative decode error
+ * @return true if the field was within the remaining bytes
+ */
+bool bacnet_cursor_skip(BACNET_DECODE_CURSOR *cursor, int len)
+{
+    if (!cursor || cursor->error) {
+        return false;
+    }
+    if ((len < 0) || ((uint32_t)len > (cursor->apdu_size - cursor->apdu_len))) {
+        cursor->error = true;
+        return false;
+    }
+    cursor->apdu_len += (uint32_t)len;
+
+    return true;
+}
+
+/**
+ * @brief Move a cursor past a decoded field, or fail the decoding
+ * @param cursor - cursor of the decoding
+ * @param len - number of bytes decoded, or zero or negative on error
+ * @return true if the field was decoded
+ */
+static bool cursor_advance(BACNET_DECODE_CURSOR *cursor, int len)
+{
+    if (len <= 0) {
+        cursor->error = true;
+        return false;
+    }
+    cursor->apdu_len += (uint32_t)len;
+
+    return true;
+}
+
+/**
+ * @brief Determine if the next field of a cursor has a context tag,
+ *  such as for an OPTIONAL field.  The cursor does not move.
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @return true if the next field has the context tag
+ */
+bool bacnet_cursor_is_context_tag(
+    const BACNET_DECODE_CURSOR *cursor, uint8_t tag_number)
+{
+    if (!cursor || cursor->error) {
+        return false;
+    }
+
+    return bacnet_is_context_tag_number(&cursor->apdu[cursor->apdu_len],
+        cursor->apdu_size - cursor->apdu_len, tag_number, NULL, NULL);
+}
+
+/**
+ * @brief Determine if the next field of a cursor is an opening tag,
+ *  such as for an OPTIONAL constructed field.  The cursor does not move.
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @return true if the next field is the opening tag
+ */
+bool bacnet_cursor_is_opening_tag(
+    const BACNET_DECODE_CURSOR *cursor, uint8_t tag_number)
+{
+    if (!cursor || cursor->error) {
+        return false;
+    }
+
+    return bacnet_is_opening_tag_number(&cursor->apdu[cursor->apdu_len],
+        cursor->apdu_size - cursor->apdu_len, tag_number, NULL);
+}
+
+/**
+ * @brief Decode an opening tag with a cursor
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @return true if decoded
+ */
+bool bacnet_cursor_opening_tag(BACNET_DECODE_CURSOR *cursor, uint8_t tag_number)
+{
+    int len = 0;
+
+    if (!cursor || cursor->error) {
+        return false;
+    }
+    if (!bacnet_is_opening_tag_number(&cursor->apdu[cursor->apdu_len],
+            cursor->apdu_size - cursor->apdu_len, tag_number, &len)) {
+        len = 0;
+    }
+
+    return cursor_advance(cursor, len);
+}
+
+/**
+ * @brief Decode a closing tag with a cursor
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @return true if decoded
+ */
+bool bacnet_cursor_closing_tag(BACNET_DECODE_CURSOR *cursor, uint8_t tag_number)
+{
+    int len = 0;
+
+    if (!cursor || cursor->error) {
+        return false;
+    }
+    if (!bacnet_is_closing_tag_number(&cursor->apdu[cursor->apdu_len],
+            cursor->apdu_size - cursor->apdu_len, tag_number, &len)) {
+        len = 0;
+    }
+
+    return cursor_advance(cursor, len);
+}
+
+/**
+ * @brief Decode a context tagged Unsigned field with a cursor
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @param value - the value decoded
+ * @return true if decoded
+ */
+bool bacnet_cursor_unsigned_context(BACNET_DECODE_CURSOR *cursor,
+    uint8_t tag_number,
+    BACNET_UNSIGNED_INTEGER *value)
+{
+    if (!cursor || cursor->error) {
+        return false;
+    }
+
+    return cursor_advance(cursor,
+        bacnet_unsigned_context_decode(&cursor->apdu[cursor->apdu_len],
+            cursor->apdu_size - cursor->apdu_len, tag_number, value));
+}
+
+/**
+ * @brief Decode a context tagged Enumerated field with a cursor
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @param value - the value decoded
+ * @return true if decoded
+ */
+bool bacnet_cursor_enumerated_context(
+    BACNET_DECODE_CURSOR *cursor, uint8_t tag_number, uint32_t *value)
+{
+    if (!cursor || cursor->error) {
+        return false;
+    }
+
+    return cursor_advance(cursor,
+        bacnet_enumerated_context_decode(&cursor->apdu[cursor->apdu_len],
+            cursor->apdu_size - cursor->apdu_len, tag_number, value));
+}
+
+/**
+ * @brief Decode a context tagged BOOLEAN field with a cursor
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @param value - the value decoded
+ * @return true if decoded
+ */
+bool bacnet_cursor_boolean_context(
+    BACNET_DECODE_CURSOR *cursor, uint8_t tag_number, bool *value)
+{
+    if (!cursor || cursor->error) {
+        return false;
+    }
+
+    return cursor_advance(cursor,
+        bacnet_boolean_context_decode(&cursor->apdu[cursor->apdu_len],
+            cursor->apdu_size - cursor->apdu_len, tag_number, value));
+}
+
+/**
+ * @brief Decode a context tagged BACnetObjectIdentifier field with a cursor
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number to match
+ * @param object_type - the object type decoded
+ * @param instance - the object instance decoded
+ * @return true if decoded
+ */
+bool bacnet_cursor_object_id_context(BACNET_DECODE_CURSOR *cursor,
+    uint8_t tag_number,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *instance)
+{
+    if (!cursor || cursor->error) {
+        return false;
+    }
+
+    return cursor_advance(cursor,
+        bacnet_object_id_context_decode(&cursor->apdu[cursor->apdu_len],
+            cursor->apdu_size - cursor->apdu_len, tag_number, object_type,
+            instance));
+}
+
+/**
+ * @brief Decode a constructed field, such as ABSTRACT-SYNTAX.&Type,
+ *  with a cursor, leaving the data between the opening and closing tags
+ *  to be decoded later
+ * @param cursor - cursor of the decoding
+ * @param tag_number - context tag number of the opening and closing tags
+ * @param data - the data between the tags, or NULL
+ * @param data_len - the number of bytes between the tags, or NULL
+ * @return true if decoded
+ */
+bool bacnet_cursor_enclosed_data(BACNET_DECODE_CURSOR *cursor,
+    uint8_t tag_number,
+    uint8_t **data,
+    uint32_t *data_len)
+{
+    int len;
+    uint32_t start;
+
+    if (!cursor || cursor->error) {
+        return false;
+    }
+    start = cursor->apdu_len;
+    len = bacnet_enclosed_data_length(&cursor->apdu[cursor->apdu_len],
+        cursor->apdu_size - cursor->apdu_len);
+    if ((len < 0) || !bacnet_cursor_opening_tag(cursor, tag_number)) {
+        cursor->error = true;
+        return false;
+    }
+    if (data) {
+        *data = &cursor->apdu[cursor->apdu_len];
+    }
+    if (data_len) {
+        *data_len = (uint32_t)len;
+    }
+    cursor->apdu_len += (uint32_t)len;
+    if (!bacnet_cursor_closing_tag(cursor, tag_number)) {
+        cursor->apdu_len = start;
+        return false;
+    }
+
+    return true;
+}
@@ -44,6 +44,17 @@ typedef struct BACnetTag {
 /* max size of a BACnet tag */
 #define BACNET_TAG_SIZE 7
 
+/* A cursor for decoding the fields of a service request one after another,
+   which carries the remaining length of the buffer and an error flag that
+   is set by the first field that fails, so that the fields are bounds
+   checked as they go and the error is checked once at the end */
+typedef struct BACnetDecodeCursor {
+    uint8_t *apdu;
+    uint32_t apdu_size;
+    uint32_t apdu_len;
+    bool error;
+} BACNET_DECODE_CURSOR;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -83,6 +94,8 @@ bool bacnet_is_opening_tag_number(
 BACNET_STACK_EXPORT
 bool bacnet_is_closing_tag_number(
     uint8_t *apdu, uint32_t apdu_size, uint8_t tag_number, int *tag_length);
+BACNET_STACK_EXPORT
+int bacnet_enclosed_data_length(uint8_t *apdu, size_t apdu_size);
 
 BACNET_STACK_DEPRECATED("Use bacnet_tag_decode() instead")
 BACNET_STACK_EXPORT
@@ -326,6 +339,12 @@ int encode_application_character_string(
 BACNET_STACK_EXPORT
 int encode_context_character_string(
     uint8_t *apdu, uint8_t tag_number, BACNET_CHARACTER_STRING *char_string);
+BACNET_STACK_EXPORT
+int encode_application_character_string_ansi(
+    uint8_t *apdu, const char *value);
+BACNET_STACK_EXPORT
+int encode_context_character_string_ansi(
+    uint8_t *apdu, uint8_t tag_number, const char *value);
 BACNET_STACK_DEPRECATED("Use bacnet_character_string_decode() instead")
 BACNET_STACK_EXPORT
 int decode_character_string(
@@ -537,6 +556,54 @@ int bacnet_array_encode(uint32_t object_instance,
     uint8_t *apdu,
     int max_apdu);
 
+BACNET_STACK_EXPORT
+void bacnet_cursor_init(
+    BACNET_DECODE_CURSOR *cursor, uint8_t *apdu, uint32_t apdu_size);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_error(const BACNET_DECODE_CURSOR *cursor);
+BACNET_STACK_EXPORT
+void bacnet_cursor_error_set(BACNET_DECODE_CURSOR *cursor);
+BACNET_STACK_EXPORT
+int bacnet_cursor_len(const BACNET_DECODE_CURSOR *cursor);
+BACNET_STACK_EXPORT
+uint32_t bacnet_cursor_remaining(const BACNET_DECODE_CURSOR *cursor);
+BACNET_STACK_EXPORT
+uint8_t *bacnet_cursor_apdu(const BACNET_DECODE_CURSOR *cursor);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_skip(BACNET_DECODE_CURSOR *cursor, int len);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_is_context_tag(
+    const BACNET_DECODE_CURSOR *cursor, uint8_t tag_number);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_is_opening_tag(
+    const BACNET_DECODE_CURSOR *cursor, uint8_t tag_number);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_opening_tag(
+    BACNET_DECODE_CURSOR *cursor, uint8_t tag_number);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_closing_tag(
+    BACNET_DECODE_CURSOR *cursor, uint8_t tag_number);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_unsigned_context(BACNET_DECODE_CURSOR *cursor,
+    uint8_t tag_number,
+    BACNET_UNSIGNED_INTEGER *value);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_enumerated_context(
+    BACNET_DECODE_CURSOR *cursor, uint8_t tag_number, uint32_t *value);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_boolean_context(
+    BACNET_DECODE_CURSOR *cursor, uint8_t tag_number, bool *value);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_object_id_context(BACNET_DECODE_CURSOR *cursor,
+    uint8_t tag_number,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *instance);
+BACNET_STACK_EXPORT
+bool bacnet_cursor_enclosed_data(BACNET_DECODE_CURSOR *cursor,
+    uint8_t tag_number,
+    uint8_t **data,
+    uint32_t *data_len);
+
 /* from clause 20.2.1.2 Tag Number */
 /* true if extended tag numbering is used */
 #define IS_EXTENDED_TAG_NUMBER(x) (((x)&0xF0) == 0xF0)
@@ -557,6 +624,12 @@ int bacnet_array_encode(uint32_t object_instance,
 /* true if the tag is a closing tag */
 #define IS_CLOSING_TAG(x) (((x)&0x07) == 7)
 
+/* true if the tag octet is a one octet context tag with tag number n,
+   holding a primitive value of 1 to 4 octets */
+#define IS_CONTEXT_TAG_SHORT(x, n) \
+    ((((x)&0xF8) == ((((n)&0x0F) << 4) | BIT(3))) && (((x)&0x07) >= 1) && \
+        (((x)&0x07) <= 4))
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -77,9 +77,9 @@ bool bacnet_recipient_same(BACNET_RECIPIENT *r1, BACNET_RECIPIENT *r2)
         }
         if (status) {
             if (r1->tag == BACNET_RECIPIENT_TAG_DEVICE) {
-                if ((r1->type.device.type == r2->type.device.type) &&
-                    (r1->type.device.instance == r2->type.device.instance)) {
-                    status = true;
+                if ((r1->type.device.type != r2->type.device.type) ||
+                    (r1->type.device.instance != r2->type.device.instance)) {
+                    status = false;
                 }
             } else if (r1->tag == BACNET_RECIPIENT_TAG_ADDRESS) {
                 status =
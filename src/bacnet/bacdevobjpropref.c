@@ -267,8 +267,8 @@ int bacnet_device_object_property_reference_context_decode(uint8_t *apdu,
  * @return true if the values are the same
  */
 bool bacnet_device_object_property_reference_same(
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value1,
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value2)
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value1,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value2)
 {
     bool status = false;
 
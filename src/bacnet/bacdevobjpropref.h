@@ -133,8 +133,8 @@ int bacnet_device_object_reference_context_decode(uint8_t *apdu,
 
 BACNET_STACK_EXPORT
 bool bacnet_device_object_property_reference_same(
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value1, 
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value2);
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value1,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *value2);
 
 BACNET_STACK_EXPORT
 bool bacnet_device_object_reference_same(
@@ -0,0 +1,488 @@
+/**
+ * @file
+ * @brief Export BACnet property values as text or as JSON into a dynamic
+ *  buffer. The common values are formatted without snprintf(), and the
+ *  others with bacapp_snprintf_value(), so that the text is the same as
+ *  the text of bacapp_snprintf_value(). An export of many values appends
+ *  to one buffer, which may be written and reset as it grows.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/bactext.h"
+#include "bacnet/bacexport.h"
+
+/* bytes reserved for a value formatted by bacapp_snprintf_value(), which
+   is formatted again if it does not fit */
+#define BACEXPORT_TEXT_RESERVE 64
+/* decimals of a real value, as %f of bacapp_snprintf_value() */
+#define BACEXPORT_REAL_DECIMALS 6
+
+/**
+ * @brief Append a value formatted by bacapp_snprintf_value()
+ * @param b - buffer
+ * @param object_value - value to append
+ * @return true if the value was appended
+ */
+static bool bacexport_snprintf_value(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    size_t space;
+    int len;
+
+    if (!dbuf_reserve(b, BACEXPORT_TEXT_RESERVE)) {
+        return false;
+    }
+    space = b->size - b->count;
+    len = bacapp_snprintf_value(&b->data[b->count], space, object_value);
+    if (len < 0) {
+        b->data[b->count] = 0;
+        return false;
+    }
+    if ((size_t)len >= space) {
+        if (!dbuf_reserve(b, (size_t)len)) {
+            b->data[b->count] = 0;
+            return false;
+        }
+        space = b->size - b->count;
+        len = bacapp_snprintf_value(&b->data[b->count], space, object_value);
+    }
+    b->count += (size_t)len;
+    b->data[b->count] = 0;
+
+    return true;
+}
+
+/**
+ * @brief Determine if a character string is printable ASCII, which
+ *  bacapp_snprintf_value() prints as it is
+ * @param str - string
+ * @param len - number of bytes of the string
+ * @return true if each byte is printable ASCII
+ */
+static bool bacexport_printable(const char *str, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        if ((str[i] < 0x20) || (str[i] > 0x7E)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Append a bit string as a comma separated list of bits
+ * @param b - buffer
+ * @param bit_string - bit string to append
+ * @param open - character before the bits
+ * @param close - character after the bits
+ */
+static void bacexport_bit_string(
+    DYNAMIC_BUFFER *b, BACNET_BIT_STRING *bit_string, char open, char close)
+{
+    uint8_t len, i;
+
+    len = bitstring_bits_used(bit_string);
+    dbuf_append_char(b, open);
+    for (i = 0; i < len; i++) {
+        if (i) {
+            dbuf_append_char(b, ',');
+        }
+        if (bitstring_bit(bit_string, i)) {
+            dbuf_append(b, "true", 4);
+        } else {
+            dbuf_append(b, "false", 5);
+        }
+    }
+    dbuf_append_char(b, close);
+}
+
+/**
+ * @brief Append a property value as text, the same text as
+ *  bacapp_snprintf_value() of the value
+ * @param b - buffer
+ * @param object_value - value to append, with its object and property
+ * @return true if the value was appended, false if there is no value
+ *  or no memory
+ */
+bool bacexport_text_value(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    BACNET_APPLICATION_DATA_VALUE *value;
+    const char *str;
+    size_t len;
+
+    if (!b || !object_value || !object_value->value) {
+        return false;
+    }
+    value = object_value->value;
+    switch (value->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            dbuf_append(b, "Null", 4);
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            if (value->type.Boolean) {
+                dbuf_append(b, "TRUE", 4);
+            } else {
+                dbuf_append(b, "FALSE", 5);
+            }
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            dbuf_append_unsigned(b, value->type.Unsigned_Int);
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            dbuf_append_signed(b, value->type.Signed_Int);
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            dbuf_append_real(
+                b, (double)value->type.Real, BACEXPORT_REAL_DECIMALS);
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            dbuf_append_real(b, value->type.Double, BACEXPORT_REAL_DECIMALS);
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            dbuf_append_hex(b, octetstring_value(&value->type.Octet_String),
+                octetstring_length(&value->type.Octet_String));
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            str = characterstring_value(&value->type.Character_String);
+            len = characterstring_length(&value->type.Character_String);
+            if (!bacexport_printable(str, len)) {
+                return bacexport_snprintf_value(b, object_value);
+            }
+            dbuf_append_char(b, '"');
+            dbuf_append(b, str, len);
+            dbuf_append_char(b, '"');
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            bacexport_bit_string(b, &value->type.Bit_String, '{', '}');
+            break;
+#endif
+#if defined(BACAPP_OBJECT_ID)
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            if (value->type.Object_Id.type > BACNET_OBJECT_TYPE_LAST) {
+                return bacexport_snprintf_value(b, object_value);
+            }
+            dbuf_append_char(b, '(');
+            dbuf_append_string(
+                b, bactext_object_type_name(value->type.Object_Id.type));
+            dbuf_append(b, ", ", 2);
+            dbuf_append_unsigned(b, value->type.Object_Id.instance);
+            dbuf_append_char(b, ')');
+            break;
+#endif
+        default:
+            /* the enumerations are named by property, and the other
+               values have their own notation */
+            return bacexport_snprintf_value(b, object_value);
+    }
+
+    return !b->error;
+}
+
+/**
+ * @brief Append a string as a JSON string, in quotes and with escapes
+ * @param b - buffer
+ * @param str - string, which need not be NULL terminated
+ * @param len - number of bytes of the string
+ * @param encoding - BACnet character set of the string: UTF-8 is
+ *  appended as it is, ISO 8859-1 is converted to UTF-8, and the bytes
+ *  above ASCII of the other character sets are replaced by '?'
+ * @return true if the string was appended
+ */
+bool bacexport_json_string(
+    DYNAMIC_BUFFER *b, const char *str, size_t len, uint8_t encoding)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char *start;
+    unsigned char c;
+    char escape[6];
+    size_t i;
+
+    if (!b || (!str && len)) {
+        return false;
+    }
+    dbuf_append_char(b, '"');
+    if (!str) {
+        dbuf_append_char(b, '"');
+        return !b->error;
+    }
+    /* runs of bytes without escapes are appended at once */
+    start = str;
+    for (i = 0; i < len; i++) {
+        c = (unsigned char)str[i];
+        if ((c >= 0x20) && (c != '"') && (c != '\\') &&
+            ((c < 0x80) || (encoding == CHARACTER_UTF8))) {
+            continue;
+        }
+        dbuf_append(b, start, (size_t)(&str[i] - start));
+        start = &str[i + 1];
+        if ((c == '"') || (c == '\\')) {
+            escape[0] = '\\';
+            escape[1] = (char)c;
+            dbuf_append(b, escape, 2);
+        } else if (c < 0x20) {
+            escape[0] = '\\';
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = hex[c >> 4];
+            escape[5] = hex[c & 0x0F];
+            dbuf_append(b, escape, 6);
+        } else if (encoding == CHARACTER_ISO8859) {
+            escape[0] = (char)(0xC0 | (c >> 6));
+            escape[1] = (char)(0x80 | (c & 0x3F));
+            dbuf_append(b, escape, 2);
+        } else {
+            dbuf_append_char(b, '?');
+        }
+    }
+    dbuf_append(b, start, (size_t)(&str[len] - start));
+    dbuf_append_char(b, '"');
+
+    return !b->error;
+}
+
+/**
+ * @brief Append a name from a text table as a JSON string, or the number
+ *  when it has no name
+ * @param b - buffer
+ * @param name - name, or NULL
+ * @param number - number to use when there is no name
+ */
+static void bacexport_json_name(
+    DYNAMIC_BUFFER *b, const char *name, uint32_t number)
+{
+    if (name) {
+        dbuf_append_char(b, '"');
+        dbuf_append_string(b, name);
+        dbuf_append_char(b, '"');
+    } else {
+        dbuf_append_unsigned(b, number);
+    }
+}
+
+/**
+ * @brief Append the members of an object identifier to a JSON object
+ * @param b - buffer
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ */
+static void bacexport_json_object_id(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    dbuf_append_string(b, "\"object-type\":");
+    bacexport_json_name(b,
+        (object_type <= BACNET_OBJECT_TYPE_LAST)
+            ? bactext_object_type_name(object_type)
+            : NULL,
+        object_type);
+    dbuf_append_string(b, ",\"object-instance\":");
+    dbuf_append_unsigned(b, object_instance);
+}
+
+/**
+ * @brief Append a property value as a JSON value: null, true and false,
+ *  numbers, strings, and arrays of the bits of a bit string. A real
+ *  value that is not finite is null. An octet string is a string of
+ *  hexadecimal digits, an object identifier is an object, and the other
+ *  values are the string of their text.
+ * @param b - buffer
+ * @param object_value - value to append, with its object and property
+ * @return true if the value was appended
+ */
+bool bacexport_json_value(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    BACNET_APPLICATION_DATA_VALUE *value;
+    DYNAMIC_BUFFER text;
+#if defined(BACAPP_REAL) || defined(BACAPP_DOUBLE)
+    double real_value;
+#endif
+
+    if (!b || !object_value || !object_value->value) {
+        return false;
+    }
+    value = object_value->value;
+    switch (value->tag) {
+#if defined(BACAPP_NULL)
+        case BACNET_APPLICATION_TAG_NULL:
+            dbuf_append(b, "null", 4);
+            break;
+#endif
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            if (value->type.Boolean) {
+                dbuf_append(b, "true", 4);
+            } else {
+                dbuf_append(b, "false", 5);
+            }
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            dbuf_append_unsigned(b, value->type.Unsigned_Int);
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            dbuf_append_signed(b, value->type.Signed_Int);
+            break;
+#endif
+#if defined(BACAPP_REAL) || defined(BACAPP_DOUBLE)
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+#endif
+#if defined(BACAPP_REAL) && defined(BACAPP_DOUBLE)
+            real_value = (value->tag == BACNET_APPLICATION_TAG_REAL)
+                ? (double)value->type.Real
+                : value->type.Double;
+#elif defined(BACAPP_REAL)
+            real_value = (double)value->type.Real;
+#else
+            real_value = value->type.Double;
+#endif
+            if (isfinite(real_value)) {
+                dbuf_append_real(b, real_value, BACEXPORT_REAL_DECIMALS);
+            } else {
+                dbuf_append(b, "null", 4);
+            }
+            break;
+#endif
+#if defined(BACAPP_OCTET_STRING)
+        case BACNET_APPLICATION_TAG_OCTET_STRING:
+            dbuf_append_char(b, '"');
+            dbuf_append_hex(b, octetstring_value(&value->type.Octet_String),
+                octetstring_length(&value->type.Octet_String));
+            dbuf_append_char(b, '"');
+            break;
+#endif
+#if defined(BACAPP_CHARACTER_STRING)
+        case BACNET_APPLICATION_TAG_CHARACTER_STRING:
+            bacexport_json_string(b,
+                characterstring_value(&value->type.Character_String),
+                characterstring_length(&value->type.Character_String),
+                characterstring_encoding(&value->type.Character_String));
+            break;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            bacexport_bit_string(b, &value->type.Bit_String, '[', ']');
+            break;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            dbuf_append_unsigned(b, value->type.Enumerated);
+            break;
+#endif
+#if defined(BACAPP_OBJECT_ID)
+        case BACNET_APPLICATION_TAG_OBJECT_ID:
+            dbuf_append_char(b, '{');
+            bacexport_json_object_id(b, value->type.Object_Id.type,
+                value->type.Object_Id.instance);
+            dbuf_append_char(b, '}');
+            break;
+#endif
+        default:
+            dbuf_init(&text);
+            if (!bacexport_snprintf_value(&text, object_value)) {
+                dbuf_cleanup(&text);
+                b->error = true;
+                return false;
+            }
+            bacexport_json_string(
+                b, dbuf_data(&text), dbuf_count(&text), CHARACTER_UTF8);
+            dbuf_cleanup(&text);
+            break;
+    }
+
+    return !b->error;
+}
+
+/**
+ * @brief Append a property as a JSON object with its object identifier,
+ *  property identifier, array index when it is an element of an array,
+ *  and value. A property with a list of values has an array of values.
+ * @param b - buffer
+ * @param object_value - property and its list of values
+ * @return true if the property was appended
+ */
+bool bacexport_json_property(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_PROPERTY_VALUE *object_value)
+{
+    BACNET_OBJECT_PROPERTY_VALUE element;
+    BACNET_APPLICATION_DATA_VALUE *value;
+    bool list;
+
+    if (!b || !object_value) {
+        return false;
+    }
+    dbuf_append_char(b, '{');
+    bacexport_json_object_id(
+        b, object_value->object_type, object_value->object_instance);
+    dbuf_append_string(b, ",\"property\":");
+    bacexport_json_name(b,
+        bactext_property_name_default(object_value->object_property, NULL),
+        object_value->object_property);
+    if (object_value->array_index != BACNET_ARRAY_ALL) {
+        dbuf_append_string(b, ",\"array-index\":");
+        dbuf_append_unsigned(b, object_value->array_index);
+    }
+    dbuf_append_string(b, ",\"value\":");
+    value = object_value->value;
+    list = value && value->next;
+    if (list) {
+        dbuf_append_char(b, '[');
+    }
+    element = *object_value;
+    if (!value) {
+        dbuf_append(b, "null", 4);
+    }
+    while (value) {
+        element.value = value;
+        if (!bacexport_json_value(b, &element)) {
+            return false;
+        }
+        value = value->next;
+        if (value) {
+            dbuf_append_char(b, ',');
+        }
+    }
+    if (list) {
+        dbuf_append_char(b, ']');
+    }
+    dbuf_append_char(b, '}');
+
+    return !b->error;
+}
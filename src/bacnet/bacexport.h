@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief API to export BACnet property values as text or as JSON into a
+ *  dynamic buffer, for the export of many property values.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_EXPORT_H
+#define BACNET_EXPORT_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/basic/sys/dbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool bacexport_text_value(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_PROPERTY_VALUE *object_value);
+BACNET_STACK_EXPORT
+bool bacexport_json_string(
+    DYNAMIC_BUFFER *b, const char *str, size_t len, uint8_t encoding);
+BACNET_STACK_EXPORT
+bool bacexport_json_value(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_PROPERTY_VALUE *object_value);
+BACNET_STACK_EXPORT
+bool bacexport_json_property(
+    DYNAMIC_BUFFER *b, BACNET_OBJECT_PROPERTY_VALUE *object_value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
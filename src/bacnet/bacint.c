@@ -8,11 +8,83 @@
  */
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bacint.h"
+#include "bacnet/basic/sys/bigend.h"
 
+#ifdef BACNET_BIG_ENDIAN
+/* The byte order of the host is known when compiling, so the values are
+   copied with memcpy, which compiles to an unaligned load or store, and
+   swapped with one instruction where the host is little-endian. */
+int encode_unsigned16(uint8_t *apdu, uint16_t value)
+{
+    if (apdu) {
+        value = BACNET_NETWORK_ORDER16(value);
+        memcpy(apdu, &value, 2);
+    }
+
+    return 2;
+}
+
+int decode_unsigned16(uint8_t *apdu, uint16_t *value)
+{
+    uint16_t network_value;
+
+    if (apdu && value) {
+        memcpy(&network_value, apdu, 2);
+        *value = BACNET_NETWORK_ORDER16(network_value);
+    }
+
+    return 2;
+}
+
+int encode_unsigned24(uint8_t *apdu, uint32_t value)
+{
+    if (apdu) {
+        value = BACNET_NETWORK_ORDER32(value << 8);
+        memcpy(apdu, &value, 3);
+    }
+
+    return 3;
+}
+
+int decode_unsigned24(uint8_t *apdu, uint32_t *value)
+{
+    uint32_t network_value = 0;
+
+    if (apdu && value) {
+        memcpy(&network_value, apdu, 3);
+        *value = BACNET_NETWORK_ORDER32(network_value) >> 8;
+    }
+
+    return 3;
+}
+
+int encode_unsigned32(uint8_t *apdu, uint32_t value)
+{
+    if (apdu) {
+        value = BACNET_NETWORK_ORDER32(value);
+        memcpy(apdu, &value, 4);
+    }
+
+    return 4;
+}
+
+int decode_unsigned32(uint8_t *apdu, uint32_t *value)
+{
+    uint32_t network_value;
+
+    if (apdu && value) {
+        memcpy(&network_value, apdu, 4);
+        *value = BACNET_NETWORK_ORDER32(network_value);
+    }
+
+    return 4;
+}
+#else
 int encode_unsigned16(uint8_t *apdu, uint16_t value)
 {
     if (apdu) {
@@ -78,6 +150,7 @@ int decode_unsigned32(uint8_t *apdu, uint32_t *value)
 
     return 4;
 }
+#endif
 
 #ifdef UINT64_MAX
 /**
@@ -21,6 +21,23 @@
 
 /* from clause 20.2.6 Encoding of a Real Number Value */
 /* returns the number of apdu bytes consumed */
+#ifdef BACNET_BIG_ENDIAN
+int decode_real(uint8_t *apdu, float *real_value)
+{
+    uint32_t value;
+
+    if (apdu) {
+        /* NOTE: assumes the compiler stores float as IEEE-754 float */
+        memcpy(&value, apdu, 4);
+        value = BACNET_NETWORK_ORDER32(value);
+        if (real_value) {
+            memcpy(real_value, &value, 4);
+        }
+    }
+
+    return 4;
+}
+#else
 int decode_real(uint8_t *apdu, float *real_value)
 {
     union {
@@ -48,6 +65,7 @@ int decode_real(uint8_t *apdu, float *real_value)
 
     return 4;
 }
+#endif
 
 int decode_real_safe(uint8_t *apdu, uint32_t len_value, float *real_value)
 {
@@ -63,6 +81,21 @@ int decode_real_safe(uint8_t *apdu, uint32_t len_value, float *real_value)
 
 /* from clause 20.2.6 Encoding of a Real Number Value */
 /* returns the number of apdu bytes consumed */
+#ifdef BACNET_BIG_ENDIAN
+int encode_bacnet_real(float value, uint8_t *apdu)
+{
+    uint32_t network_value;
+
+    if (apdu) {
+        /* NOTE: assumes the compiler stores float as IEEE-754 float */
+        memcpy(&network_value, &value, 4);
+        network_value = BACNET_NETWORK_ORDER32(network_value);
+        memcpy(apdu, &network_value, 4);
+    }
+
+    return 4;
+}
+#else
 int encode_bacnet_real(float value, uint8_t *apdu)
 {
     union {
@@ -88,11 +121,29 @@ int encode_bacnet_real(float value, uint8_t *apdu)
 
     return 4;
 }
+#endif
 
 #if BACNET_USE_DOUBLE
 
 /* from clause 20.2.7 Encoding of a Double Precision Real Number Value */
 /* returns the number of apdu bytes consumed */
+#ifdef BACNET_BIG_ENDIAN
+int decode_double(uint8_t *apdu, double *double_value)
+{
+    uint64_t value;
+
+    if (apdu) {
+        /* NOTE: assumes the compiler stores double as IEEE-754 double */
+        memcpy(&value, apdu, 8);
+        value = BACNET_NETWORK_ORDER64(value);
+        if (double_value) {
+            memcpy(double_value, &value, 8);
+        }
+    }
+
+    return 8;
+}
+#else
 int decode_double(uint8_t *apdu, double *double_value)
 {
     union {
@@ -128,6 +179,7 @@ int decode_double(uint8_t *apdu, double *double_value)
 
     return 8;
 }
+#endif
 
 int decode_double_safe(uint8_t *apdu, uint32_t len_value, double *double_value)
 {
@@ -143,6 +195,21 @@ int decode_double_safe(uint8_t *apdu, uint32_t len_value, double *double_value)
 
 /* from clause 20.2.7 Encoding of a Double Precision Real Number Value */
 /* returns the number of apdu bytes consumed */
+#ifdef BACNET_BIG_ENDIAN
+int encode_bacnet_double(double value, uint8_t *apdu)
+{
+    uint64_t network_value;
+
+    if (apdu) {
+        /* NOTE: assumes the compiler stores double as IEEE-754 double */
+        memcpy(&network_value, &value, 8);
+        network_value = BACNET_NETWORK_ORDER64(network_value);
+        memcpy(apdu, &network_value, 8);
+    }
+
+    return 8;
+}
+#else
 int encode_bacnet_double(double value, uint8_t *apdu)
 {
     union {
@@ -177,3 +244,4 @@ int encode_bacnet_double(double value, uint8_t *apdu)
     return 8;
 }
 #endif
+#endif
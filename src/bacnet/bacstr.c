@@ -364,7 +364,6 @@ bool characterstring_init(BACNET_CHARACTER_STRING *char_string,
     size_t length)
 {
     bool status = false; /* return value */
-    size_t i; /* counter */
 
     if (char_string) {
         char_string->length = 0;
@@ -373,18 +372,12 @@ bool characterstring_init(BACNET_CHARACTER_STRING *char_string,
            note: assumes printable characters */
         if (length <= CHARACTER_STRING_CAPACITY) {
             if (value) {
-                for (i = 0; i < MAX_CHARACTER_STRING_BYTES; i++) {
-                    if (i < length) {
-                        char_string->value[char_string->length] = value[i];
-                        char_string->length++;
-                    } else {
-                        char_string->value[i] = 0;
-                    }
-                }
+                memcpy(char_string->value, value, length);
+                char_string->length = length;
+                memset(&char_string->value[length], 0,
+                    MAX_CHARACTER_STRING_BYTES - length);
             } else {
-                for (i = 0; i < MAX_CHARACTER_STRING_BYTES; i++) {
-                    char_string->value[i] = 0;
-                }
+                memset(char_string->value, 0, MAX_CHARACTER_STRING_BYTES);
             }
             status = true;
         }
@@ -490,20 +483,14 @@ bool characterstring_ansi_copy(
 bool characterstring_same(
     BACNET_CHARACTER_STRING *dest, BACNET_CHARACTER_STRING *src)
 {
-    size_t i; /* counter */
     bool same_status = false;
 
     if (src && dest) {
         if ((src->encoding == dest->encoding) &&
             (src->length == dest->length) &&
             (src->length <= MAX_CHARACTER_STRING_BYTES)) {
-            same_status = true;
-            for (i = 0; i < src->length; i++) {
-                if (src->value[i] != dest->value[i]) {
-                    same_status = false;
-                    break;
-                }
-            }
+            same_status =
+                (memcmp(src->value, dest->value, src->length) == 0);
         }
     } else if (src) {
         if (src->length == 0) {
@@ -712,6 +699,45 @@ bool characterstring_set_encoding(
     return status;
 }
 
+/* word at a time tests of the octets of a string, with as many octets in
+   a word as in a size_t, so that runs of ASCII text are checked without a
+   branch for each octet */
+#define WORD_ONES ((size_t)-1 / 0xFF)
+#define WORD_HIGHS (WORD_ONES * 0x80)
+/* true if any octet of the word has the high bit set */
+#define WORD_HAS_HIGH(w) (((w)&WORD_HIGHS) != 0)
+/* true if any octet of the word is less than n, when no high bits are set */
+#define WORD_HAS_LESS(w, n) ((((w) - (WORD_ONES * (n))) & WORD_HIGHS) != 0)
+
+/**
+ * @brief Count the octets at the start of a string that are in whole
+ *  words of octets in the range low..0x7F, other than 0x7F if excluded
+ * @param str - start of the octets
+ * @param length - number of octets
+ * @param low - lowest octet value of the range, 1..0x7F
+ * @param no_delete - true if 0x7F is excluded from the range
+ * @return number of octets, which is a multiple of the word size
+ */
+static size_t string_word_span(
+    const unsigned char *str, size_t length, uint8_t low, bool no_delete)
+{
+    size_t span = 0;
+    size_t word;
+
+    while ((length - span) >= sizeof(word)) {
+        memcpy(&word, &str[span], sizeof(word));
+        if (WORD_HAS_HIGH(word) || WORD_HAS_LESS(word, low)) {
+            break;
+        }
+        if (no_delete && WORD_HAS_LESS(word ^ (WORD_ONES * 0x7F), 1)) {
+            break;
+        }
+        span += sizeof(word);
+    }
+
+    return span;
+}
+
 /**
  * @brief Returns true if string is printable.
  *
@@ -745,7 +771,9 @@ bool characterstring_printable(BACNET_CHARACTER_STRING *char_string)
             if (imax > CHARACTER_STRING_CAPACITY) {
                 imax = CHARACTER_STRING_CAPACITY;
             }
-            for (i = 0; i < imax; i++) {
+            i = string_word_span((const unsigned char *)char_string->value,
+                imax, 0x20, true);
+            for (; i < imax; i++) {
                 chr = char_string->value[i];
                 if ((chr < 0x20) || (chr > 0x7E)) {
                     status = false;
@@ -802,8 +830,14 @@ bool utf8_isvalid(const char *str, size_t length)
         return false;
     }
     /* Check characters. */
-    pend = (unsigned char *)str + length;
+    pend = (const unsigned char *)str + length;
     for (p = (const unsigned char *)str; p < pend; p++) {
+        /* runs of ASCII characters, a word at a time */
+        ab = string_word_span(p, (size_t)(pend - p), 1, false);
+        if (ab) {
+            p += ab - 1;
+            continue;
+        }
         c = *p;
         /* null in middle of string */
         if (c == 0) {
@@ -817,10 +851,9 @@ bool utf8_isvalid(const char *str, size_t length)
             return false;
         }
         ab = (size_t)trailingBytesForUTF8[c];
-        if (length < ab) {
+        if ((size_t)(pend - p - 1) < ab) {
             return false;
         }
-        length -= ab;
 
         p++;
         /* Check top bits in the second byte */
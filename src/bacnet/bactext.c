@@ -14,28 +14,39 @@
 static const char *ASHRAE_Reserved_String = "Reserved for Use by ASHRAE";
 static const char *Vendor_Proprietary_String = "Vendor Proprietary Value";
 
+/* the largest lists are searched by name with a hash table */
+#ifndef BACTEXT_HASH_ENABLED
+#define BACTEXT_HASH_ENABLED 1
+#endif
+
+/* Convert a text value of an integer, with no other text. */
+static bool bactext_strtol_value(const char *search_name, unsigned *found_index)
+{
+    char *endptr;
+    long value;
+
+    value = strtol(search_name, &endptr, 0);
+    if (endptr == search_name) {
+        /* No digits found */
+        return false;
+    } else if (*endptr != '\0') {
+        /* Extra text found */
+        return false;
+    } else {
+        *found_index = (unsigned)value;
+        return true;
+    }
+}
+
 /* Search for a text value first based on the corresponding text list, then by
  * attempting to convert to an integer value. */
 static bool bactext_strtol_index(
     INDTEXT_DATA *istring, const char *search_name, unsigned *found_index)
 {
-    char *endptr;
-    long value;
-
     if (indtext_by_istring(istring, search_name, found_index) == true) {
         return true;
     } else {
-        value = strtol(search_name, &endptr, 0);
-        if (endptr == search_name) {
-            /* No digits found */
-            return false;
-        } else if (*endptr != '\0') {
-            /* Extra text found */
-            return false;
-        } else {
-            *found_index = (unsigned)value;
-            return true;
-        }
+        return bactext_strtol_value(search_name, found_index);
     }
 }
 
@@ -224,16 +235,34 @@ const char *bactext_object_type_name(unsigned index)
         Vendor_Proprietary_String);
 }
 
+#if BACTEXT_HASH_ENABLED
+#define OBJECT_TYPE_HASH_SIZE 128
+static uint16_t Object_Type_Hash_Slots[OBJECT_TYPE_HASH_SIZE];
+static INDTEXT_HASH Object_Type_Hash = { bacnet_object_type_names,
+    Object_Type_Hash_Slots, OBJECT_TYPE_HASH_SIZE, false };
+#endif
+
 bool bactext_object_type_index(const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_HASH_ENABLED
+    return indtext_hash_by_istring(
+        &Object_Type_Hash, search_name, found_index);
+#else
     return indtext_by_istring(
         bacnet_object_type_names, search_name, found_index);
+#endif
 }
 
 bool bactext_object_type_strtol(const char *search_name, unsigned *found_index)
 {
-    return bactext_strtol_index(
-        bacnet_object_type_names, search_name, found_index);
+    if (!search_name) {
+        return false;
+    }
+    if (bactext_object_type_index(search_name, found_index)) {
+        return true;
+    }
+
+    return bactext_strtol_value(search_name, found_index);
 }
 
 INDTEXT_DATA bacnet_property_names[] = {
@@ -753,20 +782,43 @@ const char *bactext_property_name_default(
         bacnet_property_names, index, default_string);
 }
 
+#if BACTEXT_HASH_ENABLED
+#define PROPERTY_HASH_SIZE 1024
+static uint16_t Property_Hash_Slots[PROPERTY_HASH_SIZE];
+static INDTEXT_HASH Property_Hash = { bacnet_property_names,
+    Property_Hash_Slots, PROPERTY_HASH_SIZE, false };
+#endif
+
 unsigned bactext_property_id(const char *name)
 {
-    return indtext_by_istring_default(bacnet_property_names, name, 0);
+    unsigned index = 0;
+
+    if (!bactext_property_index(name, &index)) {
+        index = 0;
+    }
+
+    return index;
 }
 
 bool bactext_property_index(const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_HASH_ENABLED
+    return indtext_hash_by_istring(&Property_Hash, search_name, found_index);
+#else
     return indtext_by_istring(bacnet_property_names, search_name, found_index);
+#endif
 }
 
 bool bactext_property_strtol(const char *search_name, unsigned *found_index)
 {
-    return bactext_strtol_index(
-        bacnet_property_names, search_name, found_index);
+    if (!search_name) {
+        return false;
+    }
+    if (bactext_property_index(search_name, found_index)) {
+        return true;
+    }
+
+    return bactext_strtol_value(search_name, found_index);
 }
 
 INDTEXT_DATA bacnet_engineering_unit_names[] = {
@@ -1183,11 +1235,23 @@ const char *bactext_engineering_unit_name(unsigned index)
     return ASHRAE_Reserved_String;
 }
 
+#if BACTEXT_HASH_ENABLED
+#define ENGINEERING_UNIT_HASH_SIZE 1024
+static uint16_t Engineering_Unit_Hash_Slots[ENGINEERING_UNIT_HASH_SIZE];
+static INDTEXT_HASH Engineering_Unit_Hash = { bacnet_engineering_unit_names,
+    Engineering_Unit_Hash_Slots, ENGINEERING_UNIT_HASH_SIZE, false };
+#endif
+
 bool bactext_engineering_unit_index(
     const char *search_name, unsigned *found_index)
 {
+#if BACTEXT_HASH_ENABLED
+    return indtext_hash_by_istring(
+        &Engineering_Unit_Hash, search_name, found_index);
+#else
     return indtext_by_istring(
         bacnet_engineering_unit_names, search_name, found_index);
+#endif
 }
 
 INDTEXT_DATA bacnet_reject_reason_names[] = { { REJECT_REASON_OTHER, "Other" },
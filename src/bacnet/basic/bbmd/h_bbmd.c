@@ -13,7 +13,11 @@
 #include "bacnet/npdu.h"
 #include "bacnet/datalink/bip.h"
 #include "bacnet/datalink/bvlc.h"
+#include "bacnet/datalink/dlstats.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/dedup.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 
@@ -46,10 +50,61 @@ static uint8_t BVLC_Function_Code = BVLC_INVALID;
 static BACNET_IP_ADDRESS BVLC_Global_Address;
 /** Flag to indicate if NAT handling is enabled/disabled */
 static bool BVLC_NAT_Handling = false;
+/* milliseconds that a broadcast is remembered, so that the copies of it
+   that arrive again through other BBMDs are dropped, or 0 to disable */
+#ifndef BVLC_DEDUP_WINDOW_MS
+#define BVLC_DEDUP_WINDOW_MS 1000
+#endif
+/* number of broadcasts remembered within the window */
+#ifndef BVLC_DEDUP_SIZE
+#define BVLC_DEDUP_SIZE 32
+#endif
+#if BVLC_DEDUP_WINDOW_MS
+static BACNET_DEDUP_ENTRY BVLC_Dedup_Entries[BVLC_DEDUP_SIZE];
+static BACNET_DEDUP BVLC_Dedup = { BVLC_Dedup_Entries, BVLC_DEDUP_SIZE, 0,
+    BVLC_DEDUP_WINDOW_MS, 0 };
+#endif
 /** if we are a foreign device, store the remote BBMD address/port here */
 static BACNET_IP_ADDRESS Remote_BBMD;
 /** if we are a foreign device, store the Time-To-Live Seconds here */
 static uint16_t Remote_BBMD_TTL_Seconds;
+#if BBMD_CLIENT_ENABLED
+/* seconds to wait for the BVLC-Result of a registration, after which
+   the BBMD is not used until it answers */
+#ifndef REMOTE_BBMD_TIMEOUT_SECONDS
+#define REMOTE_BBMD_TIMEOUT_SECONDS 3
+#endif
+/* seconds between the registrations that check the health of each BBMD
+   of a list, or zero to register only when the lease is renewed */
+#ifndef REMOTE_BBMD_CHECK_SECONDS
+#define REMOTE_BBMD_CHECK_SECONDS 30
+#endif
+/* milliseconds that a BBMD must answer faster than one of a higher
+   priority to be used instead of it */
+#ifndef REMOTE_BBMD_LATENCY_MARGIN_MS
+#define REMOTE_BBMD_LATENCY_MARGIN_MS 20
+#endif
+/** The BBMDs that we are registered with as a foreign device, in the
+    order of their priority. Remote_BBMD is the healthiest of them, which
+    Distribute-Broadcast-To-Network is sent to. */
+struct remote_bbmd {
+    BACNET_IP_ADDRESS address;
+    /* the last registration was acknowledged */
+    bool registered;
+    /* a registration was sent, and its BVLC-Result was not received */
+    bool pending;
+    unsigned long sent_ms;
+    uint16_t pending_seconds;
+    /* smoothed milliseconds from a registration to its BVLC-Result */
+    uint16_t latency_ms;
+    /* registrations that were refused or not answered, since the last
+       one that was acknowledged */
+    uint8_t failures;
+};
+static struct remote_bbmd Remote_BBMD_List[MAX_REMOTE_BBMD_ENTRIES];
+static unsigned Remote_BBMD_Count;
+static uint16_t Remote_BBMD_Check_Seconds;
+#endif
 #if BBMD_ENABLED || BBMD_CLIENT_ENABLED
 /* local buffer & length for sending */
 static uint8_t BVLC_Buffer[BIP_MPDU_MAX];
@@ -66,6 +121,354 @@ static BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY
 #define MAX_FD_ENTRIES 128
 #endif
 static BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY FD_Table[MAX_FD_ENTRIES];
+/* Number of hash buckets used to find an FDT entry by B/IPv4 address.
+   Any size works; a value near MAX_FD_ENTRIES keeps chains short. */
+#ifndef FD_TABLE_HASH_SIZE
+#define FD_TABLE_HASH_SIZE MAX_FD_ENTRIES
+#endif
+/* Timer wheel of one second ticks for retiring FDT entries.  Only the
+   bucket for each elapsed second is visited by the maintenance timer,
+   and the remaining time of the entries in it is updated. */
+#ifndef FD_TIMER_WHEEL_SIZE
+#define FD_TIMER_WHEEL_SIZE 16
+#endif
+/* Entry numbers are one-based so that zero means no entry. */
+typedef uint16_t FD_TABLE_INDEX;
+#define FD_TABLE_INDEX_NONE 0
+static struct fd_table_node {
+    /* next entry in the address hash chain */
+    FD_TABLE_INDEX hash_next;
+    /* timer wheel bucket links */
+    FD_TABLE_INDEX timer_next;
+    FD_TABLE_INDEX timer_prev;
+    /* maintenance timer clock when the entry expires */
+    uint32_t expiry;
+} FD_Node[MAX_FD_ENTRIES];
+static FD_TABLE_INDEX FD_Hash[FD_TABLE_HASH_SIZE];
+static FD_TABLE_INDEX FD_Timer_Wheel[FD_TIMER_WHEEL_SIZE];
+/* stack of entries that are not valid */
+static FD_TABLE_INDEX FD_Free[MAX_FD_ENTRIES];
+static unsigned FD_Free_Count;
+/* seconds elapsed in the maintenance timer */
+static uint32_t FD_Timer_Clock;
+/* false when the FDT may have been changed outside of this module */
+static bool FD_Index_Valid;
+/* buffer for encoding a Forwarded-NPDU once for all destinations */
+static uint8_t BVLC_Forward_Buffer[BIP_MPDU_MAX];
+/* destinations for forwarding, rebuilt when the BDT or FDT changes */
+static BACNET_IP_ADDRESS BBMD_Forward_List[MAX_BBMD_ENTRIES];
+static unsigned BBMD_Forward_Count;
+static bool BBMD_Forward_List_Valid;
+static BACNET_IP_ADDRESS FD_Forward_List[MAX_FD_ENTRIES];
+static unsigned FD_Forward_Count;
+static bool FD_Forward_List_Valid;
+/* my IP address when the forwarding destinations were built */
+static BACNET_IP_ADDRESS Forward_List_Address;
+#endif
+
+#if BBMD_ENABLED
+/**
+ * @brief Rebuild the forwarding destinations before the next forward,
+ *  because the BDT, the FDT, or the NAT handling has changed.
+ */
+static void bbmd_forward_list_invalidate(void)
+{
+    BBMD_Forward_List_Valid = false;
+    FD_Forward_List_Valid = false;
+}
+
+/**
+ * @brief Compute the hash bucket for a B/IPv4 address
+ * @param addr - B/IPv4 address
+ * @return hash bucket index
+ */
+static unsigned bbmd_fdt_hash(const BACNET_IP_ADDRESS *addr)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned i = 0;
+
+    for (i = 0; i < IP_ADDRESS_MAX; i++) {
+        hash = (hash ^ addr->address[i]) * 16777619UL;
+    }
+    hash = (hash ^ (addr->port & 0xFF)) * 16777619UL;
+    hash = (hash ^ (addr->port >> 8)) * 16777619UL;
+
+    return (unsigned)(hash & 0xFFFFFFFFUL) % FD_TABLE_HASH_SIZE;
+}
+
+/**
+ * @brief Place an FDT entry on the timer wheel bucket of its expiry
+ * @param index - one-based FDT entry number
+ */
+static void bbmd_fdt_timer_link(FD_TABLE_INDEX index)
+{
+    struct fd_table_node *node = &FD_Node[index - 1];
+    unsigned bucket = node->expiry % FD_TIMER_WHEEL_SIZE;
+
+    node->timer_prev = FD_TABLE_INDEX_NONE;
+    node->timer_next = FD_Timer_Wheel[bucket];
+    if (node->timer_next != FD_TABLE_INDEX_NONE) {
+        FD_Node[node->timer_next - 1].timer_prev = index;
+    }
+    FD_Timer_Wheel[bucket] = index;
+}
+
+/**
+ * @brief Remove an FDT entry from the timer wheel
+ * @param index - one-based FDT entry number
+ */
+static void bbmd_fdt_timer_unlink(FD_TABLE_INDEX index)
+{
+    struct fd_table_node *node = &FD_Node[index - 1];
+
+    if (node->timer_prev != FD_TABLE_INDEX_NONE) {
+        FD_Node[node->timer_prev - 1].timer_next = node->timer_next;
+    } else {
+        FD_Timer_Wheel[node->expiry % FD_TIMER_WHEEL_SIZE] = node->timer_next;
+    }
+    if (node->timer_next != FD_TABLE_INDEX_NONE) {
+        FD_Node[node->timer_next - 1].timer_prev = node->timer_prev;
+    }
+    node->timer_next = FD_TABLE_INDEX_NONE;
+    node->timer_prev = FD_TABLE_INDEX_NONE;
+}
+
+/**
+ * @brief Remove an FDT entry from the address hash chain
+ * @param index - one-based FDT entry number
+ */
+static void bbmd_fdt_hash_unlink(FD_TABLE_INDEX index)
+{
+    FD_TABLE_INDEX *link = NULL;
+
+    link = &FD_Hash[bbmd_fdt_hash(&FD_Table[index - 1].dest_address)];
+    while (*link != FD_TABLE_INDEX_NONE) {
+        if (*link == index) {
+            *link = FD_Node[index - 1].hash_next;
+            break;
+        }
+        link = &FD_Node[*link - 1].hash_next;
+    }
+    FD_Node[index - 1].hash_next = FD_TABLE_INDEX_NONE;
+}
+
+/**
+ * @brief Start the timer of an FDT entry from its remaining time
+ * @param index - one-based FDT entry number
+ */
+static void bbmd_fdt_timer_start(FD_TABLE_INDEX index)
+{
+    FD_Node[index - 1].expiry =
+        FD_Timer_Clock + FD_Table[index - 1].ttl_seconds_remaining;
+    bbmd_fdt_timer_link(index);
+}
+
+/**
+ * @brief Update the remaining time of an FDT entry from its expiry
+ * @param index - one-based FDT entry number
+ */
+static void bbmd_fdt_remaining_update(FD_TABLE_INDEX index)
+{
+    uint32_t remaining = 0;
+
+    if (FD_Node[index - 1].expiry > FD_Timer_Clock) {
+        remaining = FD_Node[index - 1].expiry - FD_Timer_Clock;
+    }
+    if (remaining > UINT16_MAX) {
+        remaining = UINT16_MAX;
+    }
+    FD_Table[index - 1].ttl_seconds_remaining = (uint16_t)remaining;
+}
+
+/**
+ * @brief Build the address hash and the timer wheel from the FDT,
+ *  if the FDT may have been changed outside of this module.
+ */
+static void bbmd_fdt_index_sync(void)
+{
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry = NULL;
+    FD_TABLE_INDEX index = 0;
+    unsigned bucket = 0;
+    unsigned i = 0;
+
+    if (FD_Index_Valid) {
+        return;
+    }
+    for (i = 0; i < FD_TABLE_HASH_SIZE; i++) {
+        FD_Hash[i] = FD_TABLE_INDEX_NONE;
+    }
+    for (i = 0; i < FD_TIMER_WHEEL_SIZE; i++) {
+        FD_Timer_Wheel[i] = FD_TABLE_INDEX_NONE;
+    }
+    FD_Free_Count = 0;
+    /* push the free entries from the end, so the first one is used first */
+    for (i = MAX_FD_ENTRIES; i > 0; i--) {
+        index = (FD_TABLE_INDEX)i;
+        fdt_entry = &FD_Table[index - 1];
+        FD_Node[index - 1].hash_next = FD_TABLE_INDEX_NONE;
+        FD_Node[index - 1].timer_next = FD_TABLE_INDEX_NONE;
+        FD_Node[index - 1].timer_prev = FD_TABLE_INDEX_NONE;
+        if (fdt_entry->valid && fdt_entry->ttl_seconds_remaining) {
+            bucket = bbmd_fdt_hash(&fdt_entry->dest_address);
+            FD_Node[index - 1].hash_next = FD_Hash[bucket];
+            FD_Hash[bucket] = index;
+            bbmd_fdt_timer_start(index);
+        } else {
+            fdt_entry->valid = false;
+            FD_Free[FD_Free_Count] = index;
+            FD_Free_Count++;
+        }
+    }
+    FD_Index_Valid = true;
+}
+
+/**
+ * @brief Find the FDT entry for a B/IPv4 address
+ * @param addr - B/IPv4 address
+ * @return one-based FDT entry number, or FD_TABLE_INDEX_NONE
+ */
+static FD_TABLE_INDEX bbmd_fdt_entry_find(const BACNET_IP_ADDRESS *addr)
+{
+    FD_TABLE_INDEX index = 0;
+
+    index = FD_Hash[bbmd_fdt_hash(addr)];
+    while (index != FD_TABLE_INDEX_NONE) {
+        if (!bvlc_address_different(&FD_Table[index - 1].dest_address, addr)) {
+            break;
+        }
+        index = FD_Node[index - 1].hash_next;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Retire an FDT entry and return it to the free stack
+ * @param index - one-based FDT entry number
+ */
+static void bbmd_fdt_entry_retire(FD_TABLE_INDEX index)
+{
+    bbmd_fdt_hash_unlink(index);
+    bbmd_fdt_timer_unlink(index);
+    FD_Table[index - 1].valid = false;
+    FD_Table[index - 1].ttl_seconds_remaining = 0;
+    if (FD_Free_Count < MAX_FD_ENTRIES) {
+        FD_Free[FD_Free_Count] = index;
+        FD_Free_Count++;
+    }
+    FD_Forward_List_Valid = false;
+}
+
+/**
+ * @brief Add or renew an entry in the Foreign-Device-Table
+ * @param addr - B/IPv4 address to be added
+ * @param ttl_seconds - Time-to-Live T, in seconds
+ * @return true if the Foreign Device entry was added or already exists
+ */
+static bool bbmd_fdt_entry_add(BACNET_IP_ADDRESS *addr, uint16_t ttl_seconds)
+{
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry = NULL;
+    FD_TABLE_INDEX index = 0;
+    unsigned bucket = 0;
+
+    bbmd_fdt_index_sync();
+    index = bbmd_fdt_entry_find(addr);
+    if (index != FD_TABLE_INDEX_NONE) {
+        /* am I here already?  If so, update my time to live... */
+        bbmd_fdt_timer_unlink(index);
+    } else if (FD_Free_Count > 0) {
+        FD_Free_Count--;
+        index = FD_Free[FD_Free_Count];
+        fdt_entry = &FD_Table[index - 1];
+        bvlc_address_copy(&fdt_entry->dest_address, addr);
+        fdt_entry->valid = true;
+        bucket = bbmd_fdt_hash(addr);
+        FD_Node[index - 1].hash_next = FD_Hash[bucket];
+        FD_Hash[bucket] = index;
+        FD_Forward_List_Valid = false;
+    } else {
+        return false;
+    }
+    fdt_entry = &FD_Table[index - 1];
+    fdt_entry->ttl_seconds = ttl_seconds;
+    /* Upon receipt of a BVLL Register-Foreign-Device message,
+       a BBMD shall start a timer with a value equal to the
+       Time-to-Live parameter supplied plus a fixed grace
+       period of 30 seconds. */
+    if (ttl_seconds < (UINT16_MAX - 30)) {
+        fdt_entry->ttl_seconds_remaining = ttl_seconds + 30;
+    } else {
+        fdt_entry->ttl_seconds_remaining = UINT16_MAX;
+    }
+    bbmd_fdt_timer_start(index);
+
+    return true;
+}
+
+/**
+ * @brief Delete an entry in the Foreign-Device-Table
+ * @param addr - B/IPv4 address to be deleted
+ * @return true if the Foreign Device entry was found and removed.
+ */
+static bool bbmd_fdt_entry_delete(BACNET_IP_ADDRESS *addr)
+{
+    FD_TABLE_INDEX index = 0;
+
+    bbmd_fdt_index_sync();
+    index = bbmd_fdt_entry_find(addr);
+    if (index == FD_TABLE_INDEX_NONE) {
+        return false;
+    }
+    bbmd_fdt_entry_retire(index);
+
+    return true;
+}
+
+/**
+ * @brief Update the remaining time of every valid FDT entry
+ */
+static void bbmd_fdt_remaining_refresh(void)
+{
+    FD_TABLE_INDEX index = 0;
+
+    bbmd_fdt_index_sync();
+    for (index = 1; index <= MAX_FD_ENTRIES; index++) {
+        if (FD_Table[index - 1].valid) {
+            bbmd_fdt_remaining_update(index);
+        }
+    }
+}
+
+/**
+ * @brief Advance the FDT timer wheel and retire the expired entries
+ * @param seconds - number of elapsed seconds since the last call
+ */
+static void bbmd_fdt_maintenance_timer(uint16_t seconds)
+{
+    FD_TABLE_INDEX index = 0;
+    FD_TABLE_INDEX next = 0;
+    uint32_t count = seconds;
+    uint32_t tick = 0;
+
+    bbmd_fdt_index_sync();
+    FD_Timer_Clock += seconds;
+    /* visit the bucket of each elapsed second, at most once */
+    if (count > FD_TIMER_WHEEL_SIZE) {
+        count = FD_TIMER_WHEEL_SIZE;
+    }
+    for (tick = FD_Timer_Clock - count + 1; count > 0; tick++, count--) {
+        index = FD_Timer_Wheel[tick % FD_TIMER_WHEEL_SIZE];
+        while (index != FD_TABLE_INDEX_NONE) {
+            next = FD_Node[index - 1].timer_next;
+            if (FD_Node[index - 1].expiry <= FD_Timer_Clock) {
+                bbmd_fdt_entry_retire(index);
+            } else {
+                bbmd_fdt_remaining_update(index);
+            }
+            index = next;
+        }
+    }
+}
 #endif
 
 /**
@@ -220,6 +623,7 @@ void bvlc_bdt_restore_local(void)
             memcpy(BBMD_Table, BBMD_Table_tmp,
                 sizeof(BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY) *
                     MAX_BBMD_ENTRIES);
+            bbmd_forward_list_invalidate();
         }
     }
 }
@@ -233,6 +637,161 @@ void bvlc_bdt_restore_local(void)
 #endif
 #endif
 
+#if BBMD_CLIENT_ENABLED
+/**
+ * @brief Choose the healthiest of the BBMDs that we are registered with,
+ *  which Distribute-Broadcast-To-Network is sent to. A BBMD that
+ *  acknowledged its registration is healthier than one that did not,
+ *  then one with fewer failures, then one that answers faster by the
+ *  margin, and otherwise the one of the higher priority.
+ */
+static void remote_bbmd_select(void)
+{
+    struct remote_bbmd *best = NULL;
+    struct remote_bbmd *bbmd;
+    unsigned i;
+
+    for (i = 0; i < Remote_BBMD_Count; i++) {
+        bbmd = &Remote_BBMD_List[i];
+        if (!best) {
+            best = bbmd;
+        } else if (bbmd->registered != best->registered) {
+            if (bbmd->registered) {
+                best = bbmd;
+            }
+        } else if (bbmd->failures != best->failures) {
+            if (bbmd->failures < best->failures) {
+                best = bbmd;
+            }
+        } else if (bbmd->registered &&
+            ((bbmd->latency_ms + REMOTE_BBMD_LATENCY_MARGIN_MS) <
+                best->latency_ms)) {
+            best = bbmd;
+        }
+    }
+    if (best) {
+        if (bvlc_address_different(&Remote_BBMD, &best->address)) {
+            debug_print_bip("Use BBMD", &best->address);
+        }
+        bvlc_address_copy(&Remote_BBMD, &best->address);
+    }
+}
+
+/**
+ * @brief Send a Register-Foreign-Device to one of the BBMDs
+ * @param bbmd - the BBMD
+ * @return Positive number (of bytes sent) on success, or -1 on failure
+ */
+static int remote_bbmd_register(struct remote_bbmd *bbmd)
+{
+    BVLC_Buffer_Len = bvlc_encode_register_foreign_device(
+        &BVLC_Buffer[0], sizeof(BVLC_Buffer), Remote_BBMD_TTL_Seconds);
+    if (!bbmd->pending) {
+        bbmd->pending = true;
+        bbmd->pending_seconds = 0;
+        bbmd->sent_ms = mstimer_now();
+    }
+
+    return bip_send_mpdu(&bbmd->address, &BVLC_Buffer[0], BVLC_Buffer_Len);
+}
+
+/**
+ * @brief Count a failure of one of the BBMDs, and use another one
+ * @param bbmd - the BBMD
+ */
+static void remote_bbmd_failed(struct remote_bbmd *bbmd)
+{
+    bbmd->pending = false;
+    bbmd->registered = false;
+    if (bbmd->failures < UINT8_MAX) {
+        bbmd->failures++;
+    }
+    remote_bbmd_select();
+}
+
+/**
+ * @brief Handle a BVLC-Result from one of the BBMDs that we registered
+ *  with, measuring the time since the registration was sent
+ * @param addr - B/IPv4 address of the BBMD
+ * @param result_code - the BVLC-Result code
+ */
+static void remote_bbmd_result(BACNET_IP_ADDRESS *addr, uint16_t result_code)
+{
+    struct remote_bbmd *bbmd = NULL;
+    unsigned long latency_ms;
+    unsigned i;
+
+    for (i = 0; i < Remote_BBMD_Count; i++) {
+        if (!bvlc_address_different(&Remote_BBMD_List[i].address, addr)) {
+            bbmd = &Remote_BBMD_List[i];
+            break;
+        }
+    }
+    if (!bbmd) {
+        return;
+    }
+    if (result_code == BVLC_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK) {
+        remote_bbmd_failed(bbmd);
+    } else if (result_code == BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK) {
+        remote_bbmd_failed(bbmd);
+    } else if (
+        (result_code == BVLC_RESULT_SUCCESSFUL_COMPLETION) && bbmd->pending) {
+        latency_ms = mstimer_now() - bbmd->sent_ms;
+        if (latency_ms > UINT16_MAX) {
+            latency_ms = UINT16_MAX;
+        }
+        if (bbmd->registered) {
+            latency_ms = ((3UL * bbmd->latency_ms) + latency_ms) / 4;
+        }
+        bbmd->latency_ms = (uint16_t)latency_ms;
+        bbmd->pending = false;
+        bbmd->registered = true;
+        bbmd->failures = 0;
+        remote_bbmd_select();
+    }
+}
+
+/**
+ * @brief Time out the registrations that were not answered, and check
+ *  the health of each BBMD of a list with another registration
+ * @param seconds - number of elapsed seconds
+ */
+static void remote_bbmd_maintenance_timer(uint16_t seconds)
+{
+    struct remote_bbmd *bbmd;
+    unsigned i;
+
+    for (i = 0; i < Remote_BBMD_Count; i++) {
+        bbmd = &Remote_BBMD_List[i];
+        if (!bbmd->pending) {
+            continue;
+        }
+        if (seconds >= (UINT16_MAX - bbmd->pending_seconds)) {
+            bbmd->pending_seconds = UINT16_MAX;
+        } else {
+            bbmd->pending_seconds += seconds;
+        }
+        if (bbmd->pending_seconds >= REMOTE_BBMD_TIMEOUT_SECONDS) {
+            remote_bbmd_failed(bbmd);
+        }
+    }
+    if ((REMOTE_BBMD_CHECK_SECONDS == 0) || (Remote_BBMD_Count < 2)) {
+        return;
+    }
+    if (seconds >= (UINT16_MAX - Remote_BBMD_Check_Seconds)) {
+        Remote_BBMD_Check_Seconds = UINT16_MAX;
+    } else {
+        Remote_BBMD_Check_Seconds += seconds;
+    }
+    if (Remote_BBMD_Check_Seconds >= REMOTE_BBMD_CHECK_SECONDS) {
+        Remote_BBMD_Check_Seconds = 0;
+        for (i = 0; i < Remote_BBMD_Count; i++) {
+            (void)remote_bbmd_register(&Remote_BBMD_List[i]);
+        }
+    }
+}
+#endif
+
 /** A timer function that is called about once a second.
  *
  * @param seconds - number of elapsed seconds since the last call
@@ -240,10 +799,12 @@ void bvlc_bdt_restore_local(void)
 void bvlc_maintenance_timer(uint16_t seconds)
 {
 #if BBMD_ENABLED
-    bvlc_foreign_device_table_maintenance_timer(&FD_Table[0], seconds);
-#else
-    (void)seconds;
+    bbmd_fdt_maintenance_timer(seconds);
 #endif
+#if BBMD_CLIENT_ENABLED
+    remote_bbmd_maintenance_timer(seconds);
+#endif
+    (void)seconds;
 }
 
 /**
@@ -302,163 +863,199 @@ static bool bbmd_bdt_member_mask_is_unicast(BACNET_IP_ADDRESS *addr)
     return unicast;
 }
 
-/** Send a BVLL Forwarded-NPDU message on its local IP subnet using
- * the local B/IP broadcast address as the destination address.
- *
- * @param bip_src - source IP address and UDP port
- * @param npdu - returns the NPDU
- * @param max_npdu - amount of space available in the NPDU
- * @param npdu_length - reported length of the NPDU
- * @return number of bytes encoded in the Forwarded NPDU
- */
-static uint16_t bbmd_forward_npdu(
-    BACNET_IP_ADDRESS *bip_src, uint8_t *npdu, uint16_t npdu_length)
-{
-    BACNET_IP_ADDRESS broadcast_address = { 0 };
-    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
-    uint16_t mtu_len = 0;
-
-    mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(
-        &mtu[0], (uint16_t)sizeof(mtu), bip_src, npdu, npdu_length);
-    if (mtu_len > 0) {
-        bip_get_broadcast_addr(&broadcast_address);
-        bip_send_mpdu(&broadcast_address, mtu, mtu_len);
-        debug_printf("BVLC: Sent Forwarded-NPDU as local broadcast.\n");
-    }
-
-    return mtu_len;
-}
-
-/** Sends all Broadcast Devices a Forwarded NPDU
- *
- * @param bip_src - source IP address and UDP port
- * @param npdu - returns the NPDU
- * @param max_npdu - amount of space available in the NPDU
- * @param npdu_length - reported length of the NPDU
- * @param original - was the message an original (not forwarded)
- * @return number of bytes encoded in the Forwarded NPDU
+/**
+ * @brief Rebuild the lists of BDT and FDT destinations for forwarding
+ *  when the tables, the NAT handling, or my IP address have changed.
  */
-static uint16_t bbmd_bdt_forward_npdu(BACNET_IP_ADDRESS *bip_src,
-    uint8_t *npdu,
-    uint16_t npdu_length,
-    bool original)
+static void bbmd_forward_list_refresh(void)
 {
-    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
-    uint16_t mtu_len = 0;
-    unsigned i = 0; /* loop counter */
-    BACNET_IP_ADDRESS bip_dest = { 0 };
     BACNET_IP_ADDRESS my_addr = { 0 };
+    BACNET_IP_ADDRESS *bip_dest = NULL;
+    unsigned i = 0; /* loop counter */
 
     bip_get_addr(&my_addr);
-    /* If we are forwarding an original broadcast message and the NAT
-     * handling is enabled, change the source address to NAT routers
-     * global IP address so the recipient can reply (local IP address
-     * is not accessible from internet side.
-     *
-     * If we are forwarding a message from peer BBMD or foreign device
-     * or the NAT handling is disabled, leave the source address as is.
-     */
-    if (BVLC_NAT_Handling && original) {
-        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(&mtu[0],
-            (uint16_t)sizeof(mtu), &BVLC_Global_Address, npdu, npdu_length);
-    } else {
-        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(
-            &mtu[0], (uint16_t)sizeof(mtu), bip_src, npdu, npdu_length);
+    if (bvlc_address_different(&my_addr, &Forward_List_Address)) {
+        bvlc_address_copy(&Forward_List_Address, &my_addr);
+        BBMD_Forward_List_Valid = false;
+        FD_Forward_List_Valid = false;
     }
-    /* loop through the BDT and send one to each entry */
-    for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
-        if (BBMD_Table[i].valid) {
+    if (!BBMD_Forward_List_Valid) {
+        BBMD_Forward_Count = 0;
+        for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
+            if (!BBMD_Table[i].valid) {
+                continue;
+            }
+            bip_dest = &BBMD_Forward_List[BBMD_Forward_Count];
             bvlc_broadcast_distribution_table_entry_forward_address(
-                &bip_dest, &BBMD_Table[i]);
-            if (!bvlc_address_different(&bip_dest, &my_addr)) {
+                bip_dest, &BBMD_Table[i]);
+            if (!bvlc_address_different(bip_dest, &my_addr)) {
                 /* don't forward to our selves */
                 continue;
             }
-            if (!bvlc_address_different(&bip_dest, bip_src)) {
-                /* don't forward back to origin */
+            if (BVLC_NAT_Handling) {
+                if (bvlc_address_different(bip_dest, &BVLC_Global_Address)) {
+                    /* NAT router port forwards BACnet packets from global IP.
+                       Packets sent to that global IP by us would end up back,
+                       creating a loop. */
+                    continue;
+                }
+            }
+            BBMD_Forward_Count++;
+        }
+        BBMD_Forward_List_Valid = true;
+    }
+    if (!FD_Forward_List_Valid) {
+        FD_Forward_Count = 0;
+        for (i = 0; i < MAX_FD_ENTRIES; i++) {
+            if (!FD_Table[i].valid || !FD_Table[i].ttl_seconds_remaining) {
+                continue;
+            }
+            bip_dest = &FD_Forward_List[FD_Forward_Count];
+            bvlc_address_copy(bip_dest, &FD_Table[i].dest_address);
+            if (!bvlc_address_different(bip_dest, &my_addr)) {
+                /* don't forward to our selves */
                 continue;
             }
             if (BVLC_NAT_Handling) {
-                if (bvlc_address_different(&bip_dest, &BVLC_Global_Address)) {
+                if (bvlc_address_different(bip_dest, &BVLC_Global_Address)) {
                     /* NAT router port forwards BACnet packets from global IP.
                        Packets sent to that global IP by us would end up back,
                        creating a loop. */
                     continue;
                 }
             }
-            bip_send_mpdu(&bip_dest, mtu, mtu_len);
-            debug_print_bip("BDT Send Forwarded-NPDU", &bip_dest);
+            FD_Forward_Count++;
         }
+        FD_Forward_List_Valid = true;
     }
+}
 
-    return mtu_len;
+/**
+ * @brief Send a Forwarded-NPDU to a list of destinations, except to the
+ *  origin of the message.
+ *
+ * @param dest_list - array of destination IP addresses and UDP ports
+ * @param dest_count - number of destinations in the array
+ * @param bip_src - source IP address and UDP port of the message
+ * @param mtu - the encoded Forwarded-NPDU
+ * @param mtu_len - number of bytes in the encoded Forwarded-NPDU
+ * @param debug_str - debug info string
+ */
+static void bbmd_forward_list_send(BACNET_IP_ADDRESS *dest_list,
+    unsigned dest_count,
+    BACNET_IP_ADDRESS *bip_src,
+    uint8_t *mtu,
+    uint16_t mtu_len,
+    const char *debug_str)
+{
+    unsigned i = 0; /* loop counter */
+#if BACNET_IP_SEND_MPDU_LIST
+    unsigned first = 0;
+#endif
+
+    for (i = 0; i < dest_count; i++) {
+        if (!bvlc_address_different(&dest_list[i], bip_src)) {
+            /* don't forward back to origin */
+#if BACNET_IP_SEND_MPDU_LIST
+            if (i > first) {
+                bip_send_mpdu_list(&dest_list[first], i - first, mtu, mtu_len);
+            }
+            first = i + 1;
+#endif
+            continue;
+        }
+#if !BACNET_IP_SEND_MPDU_LIST
+        bip_send_mpdu(&dest_list[i], mtu, mtu_len);
+#endif
+        debug_print_bip(debug_str, &dest_list[i]);
+    }
+#if BACNET_IP_SEND_MPDU_LIST
+    if (dest_count > first) {
+        bip_send_mpdu_list(
+            &dest_list[first], dest_count - first, mtu, mtu_len);
+    }
+#endif
 }
 
-/** Sends all Foreign Devices a Forwarded NPDU
+/** Encode a Forwarded-NPDU once, for sending to the local IP subnet,
+ * the BDT, and the FDT.
+ *
+ * If we are forwarding an original broadcast message and the NAT
+ * handling is enabled, change the source address to NAT routers
+ * global IP address so the recipient can reply (local IP address
+ * is not accessible from internet side.
+ *
+ * If we are forwarding a message from peer BBMD or foreign device
+ * or the NAT handling is disabled, leave the source address as is.
  *
  * @param bip_src - source IP address and UDP port
- * @param npdu - returns the NPDU
- * @param max_npdu - amount of space available in the NPDU
+ * @param npdu - the NPDU
  * @param npdu_length - reported length of the NPDU
  * @param original - was the message an original (not forwarded)
  * @return number of bytes encoded in the Forwarded NPDU
  */
-static uint16_t bbmd_fdt_forward_npdu(BACNET_IP_ADDRESS *bip_src,
+static uint16_t bbmd_forward_npdu_encode(BACNET_IP_ADDRESS *bip_src,
     uint8_t *npdu,
     uint16_t npdu_length,
     bool original)
 {
-    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
     uint16_t mtu_len = 0;
-    unsigned i = 0; /* loop counter */
-    BACNET_IP_ADDRESS bip_dest = { 0 };
-    BACNET_IP_ADDRESS my_addr = { 0 };
 
-    bip_get_addr(&my_addr);
-    /* If we are forwarding an original broadcast message and the NAT
-     * handling is enabled, change the source address to NAT routers
-     * global IP address so the recipient can reply (local IP address
-     * is not accessible from internet side.
-     *
-     * If we are forwarding a message from peer BBMD or foreign device
-     * or the NAT handling is disabled, leave the source address as is.
-     */
     if (BVLC_NAT_Handling && original) {
-        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(&mtu[0],
-            (uint16_t)sizeof(mtu), &BVLC_Global_Address, npdu, npdu_length);
+        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(&BVLC_Forward_Buffer[0],
+            (uint16_t)sizeof(BVLC_Forward_Buffer), &BVLC_Global_Address, npdu,
+            npdu_length);
     } else {
-        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(
-            &mtu[0], (uint16_t)sizeof(mtu), bip_src, npdu, npdu_length);
-    }
-
-    /* loop through the FDT and send one to each entry */
-    for (i = 0; i < MAX_FD_ENTRIES; i++) {
-        if (FD_Table[i].valid && FD_Table[i].ttl_seconds_remaining) {
-            bvlc_address_copy(&bip_dest, &FD_Table[i].dest_address);
-            if (!bvlc_address_different(&bip_dest, &my_addr)) {
-                /* don't forward to our selves */
-                continue;
-            }
-            if (!bvlc_address_different(&bip_dest, bip_src)) {
-                /* don't forward back to origin */
-                continue;
-            }
-            if (BVLC_NAT_Handling) {
-                if (bvlc_address_different(&bip_dest, &BVLC_Global_Address)) {
-                    /* NAT router port forwards BACnet packets from global IP.
-                       Packets sent to that global IP by us would end up back,
-                       creating a loop. */
-                    continue;
-                }
-            }
-            bip_send_mpdu(&bip_dest, mtu, mtu_len);
-            debug_print_bip("FDT Send Forwarded-NPDU", &bip_dest);
-        }
+        mtu_len = (uint16_t)bvlc_encode_forwarded_npdu(&BVLC_Forward_Buffer[0],
+            (uint16_t)sizeof(BVLC_Forward_Buffer), bip_src, npdu, npdu_length);
     }
 
     return mtu_len;
 }
 
+/** Send a BVLL Forwarded-NPDU message on its local IP subnet using
+ * the local B/IP broadcast address as the destination address.
+ *
+ * @param mtu - the encoded Forwarded-NPDU
+ * @param mtu_len - number of bytes in the encoded Forwarded-NPDU
+ */
+static void bbmd_forward_mpdu(uint8_t *mtu, uint16_t mtu_len)
+{
+    BACNET_IP_ADDRESS broadcast_address = { 0 };
+
+    bip_get_broadcast_addr(&broadcast_address);
+    bip_send_mpdu(&broadcast_address, mtu, mtu_len);
+    debug_printf("BVLC: Sent Forwarded-NPDU as local broadcast.\n");
+}
+
+/** Sends all Broadcast Devices a Forwarded NPDU
+ *
+ * @param bip_src - source IP address and UDP port
+ * @param mtu - the encoded Forwarded-NPDU
+ * @param mtu_len - number of bytes in the encoded Forwarded-NPDU
+ */
+static void bbmd_bdt_forward_mpdu(
+    BACNET_IP_ADDRESS *bip_src, uint8_t *mtu, uint16_t mtu_len)
+{
+    bbmd_forward_list_refresh();
+    bbmd_forward_list_send(BBMD_Forward_List, BBMD_Forward_Count, bip_src,
+        mtu, mtu_len, "BDT Send Forwarded-NPDU");
+}
+
+/** Sends all Foreign Devices a Forwarded NPDU
+ *
+ * @param bip_src - source IP address and UDP port
+ * @param mtu - the encoded Forwarded-NPDU
+ * @param mtu_len - number of bytes in the encoded Forwarded-NPDU
+ */
+static void bbmd_fdt_forward_mpdu(
+    BACNET_IP_ADDRESS *bip_src, uint8_t *mtu, uint16_t mtu_len)
+{
+    bbmd_forward_list_refresh();
+    bbmd_forward_list_send(FD_Forward_List, FD_Forward_Count, bip_src, mtu,
+        mtu_len, "FDT Send Forwarded-NPDU");
+}
+
 /** Prints the Read-BDT-Ack NPDU
  *
  * @param addr - source IP address and UDP port
@@ -572,14 +1169,17 @@ int bvlc_send_pdu(BACNET_ADDRESS *dest,
     unsigned pdu_len)
 {
     BACNET_IP_ADDRESS bvlc_dest = { 0 };
-    uint8_t mtu[BIP_MPDU_MAX] = { 0 };
+    /* not cleared: only the encoded bytes are sent */
+    uint8_t mtu[BIP_MPDU_MAX];
     uint16_t mtu_len = 0;
 #if BBMD_ENABLED
     BACNET_IP_ADDRESS bip_src = { 0 };
+    uint16_t forward_len = 0;
 #endif
 
     /* this datalink doesn't need to know the npdu data */
     (void)npdu_data;
+    BACNET_TRACE(NPDU_TX, dest->net, pdu_len);
     /* handle various broadcasts: */
     if ((dest->net == BACNET_BROADCAST_NETWORK) || (dest->mac_len == 0)) {
         /* mac_len = 0 is a broadcast address */
@@ -598,8 +1198,14 @@ int bvlc_send_pdu(BACNET_ADDRESS *dest,
 #if BBMD_ENABLED
             if (mtu_len > 0) {
                 bip_get_addr(&bip_src);
-                (void)bbmd_fdt_forward_npdu(&bip_src, pdu, pdu_len, true);
-                (void)bbmd_bdt_forward_npdu(&bip_src, pdu, pdu_len, true);
+                forward_len =
+                    bbmd_forward_npdu_encode(&bip_src, pdu, pdu_len, true);
+                if (forward_len > 0) {
+                    bbmd_fdt_forward_mpdu(
+                        &bip_src, BVLC_Forward_Buffer, forward_len);
+                    bbmd_bdt_forward_mpdu(
+                        &bip_src, BVLC_Forward_Buffer, forward_len);
+                }
             }
 #endif
         }
@@ -643,10 +1249,116 @@ static int bvlc_send_result(BACNET_IP_ADDRESS *dest_addr, uint16_t result_code)
     uint16_t mtu_len = 0;
 
     mtu_len = bvlc_encode_result(&mtu[0], sizeof(mtu), result_code);
+    if (result_code != BVLC_RESULT_SUCCESSFUL_COMPLETION) {
+        datalink_stats_error(PORT_TYPE_BIP, DATALINK_STATS_BVLC_NAK);
+    }
 
     return bip_send_mpdu(dest_addr, mtu, mtu_len);
 }
 
+/**
+ * @brief Check whether a broadcast NPDU was received within the window
+ *  from the same original source, such as through another BBMD
+ * @param source - the B/IPv4 address of the node that sent the broadcast
+ * @param npdu - the NPDU of the broadcast
+ * @param npdu_len - number of bytes of the NPDU
+ * @return true if the broadcast is a repeat, which is dropped
+ */
+static bool bvlc_broadcast_repeated(
+    const BACNET_IP_ADDRESS *source, const uint8_t *npdu, uint16_t npdu_len)
+{
+#if BVLC_DEDUP_WINDOW_MS
+    uint8_t key[6];
+
+    memcpy(key, source->address, 4);
+    key[4] = (uint8_t)(source->port >> 8);
+    key[5] = (uint8_t)source->port;
+
+    return bacnet_dedup_check(
+        &BVLC_Dedup, key, sizeof(key), npdu, npdu_len, mstimer_now());
+#else
+    (void)source;
+    (void)npdu;
+    (void)npdu_len;
+
+    return false;
+#endif
+}
+
+/**
+ * @brief Get the number of broadcasts that were dropped because they were
+ *  received again within the window, such as through another BBMD
+ * @return number of broadcasts
+ */
+unsigned long bvlc_broadcast_repeated_count(void)
+{
+#if BVLC_DEDUP_WINDOW_MS
+    return bacnet_dedup_dropped(&BVLC_Dedup);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Fast path for the BVLL messages that carry an NPDU for me, which
+ *  are most of the traffic: Original-Unicast-NPDU, and Forwarded-NPDU
+ *  when the Forwarded-NPDU is not forwarded again by a BBMD.
+ *  The header is recognized with two octet compares and a length check,
+ *  and any other message is left to the full handler.
+ *
+ * @param addr - BACnet/IPv4 source address
+ * @param src - returns the BACnet source address
+ * @param mtu - The received MTU buffer.
+ * @param mtu_len - How many bytes in MTU buffer.
+ * @param forwarded - true if Forwarded-NPDU is taken by the fast path
+ *
+ * @return number of bytes offset into the NPDU for APDU, 0 if dropped,
+ *  or -1 if the message is for the full handler
+ */
+static int bvlc_npdu_fast_path(BACNET_IP_ADDRESS *addr,
+    BACNET_ADDRESS *src,
+    uint8_t *mtu,
+    uint16_t mtu_len,
+    bool forwarded)
+{
+    BACNET_IP_ADDRESS fwd_address = { 0 };
+    uint16_t message_length = 0;
+
+    if ((mtu_len < 4) || (mtu[0] != BVLL_TYPE_BACNET_IP)) {
+        return -1;
+    }
+    message_length = ((uint16_t)mtu[2] << 8) | mtu[3];
+    if (message_length != mtu_len) {
+        return -1;
+    }
+    if ((mtu[1] == BVLC_ORIGINAL_UNICAST_NPDU) && (mtu_len > 4)) {
+        if (bbmd_address_match_self(addr)) {
+            return -1;
+        }
+        BVLC_Function_Code = BVLC_ORIGINAL_UNICAST_NPDU;
+        bvlc_ip_address_to_bacnet_local(src, addr);
+
+        return 4;
+    }
+    if (forwarded && (mtu[1] == BVLC_FORWARDED_NPDU) &&
+        (mtu_len > (4 + BIP_ADDRESS_MAX))) {
+        bvlc_decode_address(&mtu[4], BIP_ADDRESS_MAX, &fwd_address);
+        if (bbmd_address_match_self(&fwd_address)) {
+            return -1;
+        }
+        BVLC_Function_Code = BVLC_FORWARDED_NPDU;
+        if (bvlc_broadcast_repeated(&fwd_address, &mtu[4 + BIP_ADDRESS_MAX],
+                mtu_len - (4 + BIP_ADDRESS_MAX))) {
+            return 0;
+        }
+        bvlc_ip_address_to_bacnet_local(src, &fwd_address);
+
+        return 4 + BIP_ADDRESS_MAX;
+    }
+
+    return -1;
+}
+
 /**
  * Use this handler when you are not a BBMD.
  * Sets the BVLC_Function_Code in case it is needed later.
@@ -676,6 +1388,10 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
     uint16_t offset = 0;
     BACNET_IP_ADDRESS fwd_address = { 0 };
 
+    function_len = bvlc_npdu_fast_path(addr, src, mtu, mtu_len, true);
+    if (function_len >= 0) {
+        return function_len;
+    }
     header_len =
         bvlc_decode_header(mtu, mtu_len, &message_type, &message_length);
     if (header_len == 4) {
@@ -687,6 +1403,13 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
                 function_len = bvlc_decode_result(pdu, pdu_len, &result_code);
                 if (function_len) {
                     BVLC_Result_Code = result_code;
+                    if (result_code != BVLC_RESULT_SUCCESSFUL_COMPLETION) {
+                        datalink_stats_error(
+                            PORT_TYPE_BIP, DATALINK_STATS_BVLC_NAK);
+                    }
+#if BBMD_CLIENT_ENABLED
+                    remote_bbmd_result(addr, result_code);
+#endif
                     debug_print_unsigned(
                         "Received Result Code =", BVLC_Result_Code);
                 }
@@ -714,8 +1437,14 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
                         debug_print_string("Dropped Forwarded-NPDU from me!");
                         break;
                     }
-                    bvlc_ip_address_to_bacnet_local(src, &fwd_address);
                     offset = header_len + function_len - npdu_len;
+                    if (bvlc_broadcast_repeated(
+                            &fwd_address, &mtu[offset], npdu_len)) {
+                        debug_print_string("Dropped Forwarded-NPDU: Repeat!");
+                        offset = 0;
+                        break;
+                    }
+                    bvlc_ip_address_to_bacnet_local(src, &fwd_address);
                     debug_print_npdu("Forwarded-NPDU", offset, npdu_len);
                 } else {
                     debug_print_string("Dropped Forwarded-NPDU: Malformed!");
@@ -833,12 +1562,18 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
     uint16_t pdu_len = 0;
     uint8_t *npdu = NULL;
     uint16_t npdu_len = 0;
+    uint16_t forward_len = 0;
     bool send_result = false;
     uint16_t offset = 0;
     uint16_t ttl_seconds = 0;
     BACNET_IP_ADDRESS fwd_address = { 0 };
     BACNET_IP_ADDRESS broadcast_address = { 0 };
 
+    /* a Forwarded-NPDU is forwarded again, in the full handler */
+    function_len = bvlc_npdu_fast_path(addr, src, mtu, mtu_len, false);
+    if (function_len >= 0) {
+        return function_len;
+    }
     header_len =
         bvlc_decode_header(mtu, mtu_len, &message_type, &message_length);
     if (header_len != 4) {
@@ -852,6 +1587,13 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
             function_len = bvlc_decode_result(pdu, pdu_len, &result_code);
             if (function_len) {
                 BVLC_Result_Code = result_code;
+                if (result_code != BVLC_RESULT_SUCCESSFUL_COMPLETION) {
+                    datalink_stats_error(
+                        PORT_TYPE_BIP, DATALINK_STATS_BVLC_NAK);
+                }
+#if BBMD_CLIENT_ENABLED
+                remote_bbmd_result(addr, result_code);
+#endif
                 debug_print_unsigned(
                     "Received Result Code =", BVLC_Result_Code);
             }
@@ -861,6 +1603,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
             function_len = bvlc_decode_write_broadcast_distribution_table(
                 pdu, pdu_len, &BBMD_Table[0]);
             if (function_len > 0) {
+                bbmd_forward_list_invalidate();
                 /* BDT changed! Save backup to file */
                 bvlc_bdt_backup_local();
                 result_code = BVLC_RESULT_SUCCESSFUL_COMPLETION;
@@ -923,6 +1666,15 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                     debug_print_string("Dropped Forwarded-NPDU from me!");
                     break;
                 }
+                offset = header_len + function_len - npdu_len;
+                npdu = &mtu[offset];
+                if (bvlc_broadcast_repeated(&fwd_address, npdu, npdu_len)) {
+                    /* the same broadcast arrived through another BBMD,
+                       and was already forwarded */
+                    debug_print_string("Dropped Forwarded-NPDU: Repeat!");
+                    offset = 0;
+                    break;
+                }
                 if (bbmd_bdt_member_mask_is_unicast(addr)) {
                     /*  Upon receipt of a BVLL Forwarded-NPDU message
                         from a BBMD which is in the receiving BBMD's BDT,
@@ -935,9 +1687,8 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                 /*  In addition, the constructed BVLL Forwarded-NPDU
                     message shall be unicast to each foreign device in
                     the BBMD's FDT. */
-                offset = header_len + function_len - npdu_len;
-                npdu = &mtu[offset];
-                (void)bbmd_fdt_forward_npdu(&fwd_address, npdu, npdu_len, false);
+                /* the received Forwarded-NPDU is sent as is */
+                bbmd_fdt_forward_mpdu(&fwd_address, mtu, mtu_len);
                 /* prepare the message for me! */
                 bvlc_ip_address_to_bacnet_local(src, &fwd_address);
                 debug_print_npdu("Forwarded-NPDU", offset, npdu_len);
@@ -957,8 +1708,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
             function_len =
                 bvlc_decode_register_foreign_device(pdu, pdu_len, &ttl_seconds);
             if (function_len) {
-                if (bvlc_foreign_device_table_entry_add(
-                        &FD_Table[0], addr, ttl_seconds)) {
+                if (bbmd_fdt_entry_add(addr, ttl_seconds)) {
                     result_code = BVLC_RESULT_SUCCESSFUL_COMPLETION;
                     send_result = true;
                 } else {
@@ -978,6 +1728,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                it shall return a BVLC-Result message to the originating device
                with a result code of X'0040' indicating that the read attempt
                has failed. */
+            bbmd_fdt_remaining_refresh();
             BVLC_Buffer_Len = bvlc_encode_read_foreign_device_table_ack(
                 BVLC_Buffer, sizeof(BVLC_Buffer), &FD_Table[0]);
             if (BVLC_Buffer_Len > 0) {
@@ -1008,8 +1759,7 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
             function_len =
                 bvlc_decode_delete_foreign_device(pdu, pdu_len, &fwd_address);
             if (function_len > 0) {
-                if (bvlc_foreign_device_table_entry_delete(
-                        &FD_Table[0], &fwd_address)) {
+                if (bbmd_fdt_entry_delete(&fwd_address)) {
                     result_code = BVLC_RESULT_SUCCESSFUL_COMPLETION;
                     send_result = true;
                 } else {
@@ -1038,10 +1788,17 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                it shall return a BVLC-Result message to the foreign device
                with a result code of X'0060' indicating that the forwarding
                attempt was unsuccessful */
-            npdu_len = bbmd_forward_npdu(addr, pdu, pdu_len);
+            if (bvlc_broadcast_repeated(addr, pdu, pdu_len)) {
+                debug_print_string(
+                    "Dropped Distribute-Broadcast-To-Network: Repeat!");
+                offset = 0;
+                break;
+            }
+            npdu_len = bbmd_forward_npdu_encode(addr, pdu, pdu_len, false);
             if (npdu_len > 0) {
-                (void)bbmd_fdt_forward_npdu(addr, pdu, pdu_len, false);
-                (void)bbmd_bdt_forward_npdu(addr, pdu, pdu_len, false);
+                bbmd_forward_mpdu(BVLC_Forward_Buffer, npdu_len);
+                bbmd_fdt_forward_mpdu(addr, BVLC_Forward_Buffer, npdu_len);
+                bbmd_bdt_forward_mpdu(addr, BVLC_Forward_Buffer, npdu_len);
             } else {
                 result_code = BVLC_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
                 send_result = true;
@@ -1105,9 +1862,19 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                     offset = 0;
                     debug_print_string("Dropped Original-Broadcast-NPDU: "
                                        "Confirmed Service!");
+                } else if (bvlc_broadcast_repeated(addr, npdu, npdu_len)) {
+                    offset = 0;
+                    debug_print_string(
+                        "Dropped Original-Broadcast-NPDU: Repeat!");
                 } else {
-                    (void)bbmd_fdt_forward_npdu(addr, npdu, npdu_len, true);
-                    (void)bbmd_bdt_forward_npdu(addr, npdu, npdu_len, true);
+                    forward_len = bbmd_forward_npdu_encode(
+                        addr, npdu, npdu_len, true);
+                    if (forward_len > 0) {
+                        bbmd_fdt_forward_mpdu(
+                            addr, BVLC_Forward_Buffer, forward_len);
+                        bbmd_bdt_forward_mpdu(
+                            addr, BVLC_Forward_Buffer, forward_len);
+                    }
                     debug_print_npdu(
                         "Original-Broadcast-NPDU", offset, npdu_len);
                 }
@@ -1194,14 +1961,63 @@ int bvlc_broadcast_handler(BACNET_IP_ADDRESS *addr,
  */
 int bvlc_register_with_bbmd(BACNET_IP_ADDRESS *bbmd_addr, uint16_t ttl_seconds)
 {
+    return bvlc_register_with_bbmds(bbmd_addr, 1, ttl_seconds);
+}
+
+/** Register as a foreign device with each BBMD of a prioritized list.
+ * Distribute-Broadcast-To-Network is sent to the healthiest of them,
+ * which is chosen from their BVLC-Result answers and how fast they are,
+ * so that another BBMD is used as soon as one stops answering.
+ * Each BBMD forwards the broadcasts of its BDT to us, so a broadcast may
+ * be received from more than one of them.
+ * Registering again with the same list keeps the health of each BBMD.
+ * @param bbmd_list - IPv4 addresses of the BBMDs, highest priority first
+ * @param count - number of BBMDs, up to MAX_REMOTE_BBMD_ENTRIES
+ * @param ttl_seconds - Lease time to use when registering.
+ * @return Positive number (of bytes sent) on success,
+ *         0 if no registration request is sent, or
+ *         -1 if registration fails.
+ */
+int bvlc_register_with_bbmds(
+    BACNET_IP_ADDRESS *bbmd_list, unsigned count, uint16_t ttl_seconds)
+{
+    bool same_list;
+    int status, retval = 0;
+    unsigned i;
+
+    if (!bbmd_list) {
+        return 0;
+    }
+    if (count > MAX_REMOTE_BBMD_ENTRIES) {
+        count = MAX_REMOTE_BBMD_ENTRIES;
+    }
+    same_list = (count == Remote_BBMD_Count);
+    for (i = 0; same_list && (i < count); i++) {
+        if (bvlc_address_different(
+                &Remote_BBMD_List[i].address, &bbmd_list[i])) {
+            same_list = false;
+        }
+    }
+    if (!same_list) {
+        memset(Remote_BBMD_List, 0, sizeof(Remote_BBMD_List));
+        for (i = 0; i < count; i++) {
+            bvlc_address_copy(&Remote_BBMD_List[i].address, &bbmd_list[i]);
+        }
+        Remote_BBMD_Count = count;
+        Remote_BBMD_Check_Seconds = 0;
+    }
     /* Store the BBMD address and port so that we won't broadcast locally. */
     /* We are a foreign device! */
-    bvlc_address_copy(&Remote_BBMD, bbmd_addr);
     Remote_BBMD_TTL_Seconds = ttl_seconds;
-    BVLC_Buffer_Len = bvlc_encode_register_foreign_device(
-        &BVLC_Buffer[0], sizeof(BVLC_Buffer), ttl_seconds);
+    remote_bbmd_select();
+    for (i = 0; i < count; i++) {
+        status = remote_bbmd_register(&Remote_BBMD_List[i]);
+        if ((status > 0) || (retval == 0)) {
+            retval = status;
+        }
+    }
 
-    return bip_send_mpdu(bbmd_addr, &BVLC_Buffer[0], BVLC_Buffer_Len);
+    return retval;
 }
 
 /** Get the remote BBMD address that was used to Register as a foreign device
@@ -1224,6 +2040,48 @@ uint16_t bvlc_remote_bbmd_lifetime(void)
 {
     return Remote_BBMD_TTL_Seconds;
 }
+
+/**
+ * @brief Get the number of BBMDs that we registered with
+ * @return number of BBMDs
+ */
+unsigned bvlc_remote_bbmd_count(void)
+{
+    return Remote_BBMD_Count;
+}
+
+/**
+ * @brief Get the health of one of the BBMDs that we registered with
+ * @param index - 0 for the BBMD of the highest priority
+ * @param bbmd_addr - IPv4 address of the BBMD, or NULL
+ * @param registered - true if its last registration was acknowledged,
+ *  or NULL
+ * @param latency_ms - smoothed milliseconds of its answers, or NULL
+ * @return true if the index is valid
+ */
+bool bvlc_remote_bbmd_health(unsigned index,
+    BACNET_IP_ADDRESS *bbmd_addr,
+    bool *registered,
+    uint16_t *latency_ms)
+{
+    const struct remote_bbmd *bbmd;
+
+    if (index >= Remote_BBMD_Count) {
+        return false;
+    }
+    bbmd = &Remote_BBMD_List[index];
+    if (bbmd_addr) {
+        bvlc_address_copy(bbmd_addr, &bbmd->address);
+    }
+    if (registered) {
+        *registered = bbmd->registered;
+    }
+    if (latency_ms) {
+        *latency_ms = bbmd->latency_ms;
+    }
+
+    return true;
+}
 #endif
 
 #if BBMD_CLIENT_ENABLED
@@ -1320,6 +2178,10 @@ void bvlc_set_function_code(uint8_t function_code)
  */
 BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *bvlc_fdt_list(void)
 {
+    bbmd_fdt_remaining_refresh();
+    /* the caller may change the table */
+    FD_Index_Valid = false;
+    bbmd_forward_list_invalidate();
     return &FD_Table[0];
 }
 
@@ -1329,6 +2191,8 @@ BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *bvlc_fdt_list(void)
  */
 BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY *bvlc_bdt_list(void)
 {
+    /* the caller may change the table */
+    bbmd_forward_list_invalidate();
     return &BBMD_Table[0];
 }
 
@@ -1338,6 +2202,7 @@ BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY *bvlc_bdt_list(void)
 void bvlc_bdt_list_clear(void)
 {
     bvlc_broadcast_distribution_table_valid_clear(&BBMD_Table[0]);
+    bbmd_forward_list_invalidate();
     /* BDT changed! Save backup to file */
     bvlc_bdt_backup_local();
 }
@@ -1362,6 +2227,9 @@ void bvlc_set_global_address_for_nat(const BACNET_IP_ADDRESS *addr)
 {
     bvlc_address_copy(&BVLC_Global_Address, addr);
     BVLC_NAT_Handling = true;
+#if BBMD_ENABLED
+    bbmd_forward_list_invalidate();
+#endif
     debug_print_bip("NAT Address enabled", addr);
 }
 
@@ -1371,6 +2239,9 @@ void bvlc_set_global_address_for_nat(const BACNET_IP_ADDRESS *addr)
 void bvlc_disable_nat(void)
 {
     BVLC_NAT_Handling = false;
+#if BBMD_ENABLED
+    bbmd_forward_list_invalidate();
+#endif
     debug_print_string("NAT Address disabled");
 }
 
@@ -1381,7 +2252,13 @@ void bvlc_init(void)
     bvlc_broadcast_distribution_table_link_array(
         &BBMD_Table[0], MAX_BBMD_ENTRIES);
     bvlc_foreign_device_table_link_array(&FD_Table[0], MAX_FD_ENTRIES);
+    FD_Index_Valid = false;
+    bbmd_forward_list_invalidate();
 #else
     debug_print_string("Initializing (BBMD Disabled).");
 #endif
+#if BVLC_DEDUP_WINDOW_MS
+    bacnet_dedup_init(&BVLC_Dedup, BVLC_Dedup_Entries, BVLC_DEDUP_SIZE,
+        BVLC_DEDUP_WINDOW_MS);
+#endif
 }
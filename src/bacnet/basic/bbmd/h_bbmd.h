@@ -16,6 +16,12 @@
 /* BACnet Stack API */
 #include "bacnet/datalink/bvlc.h"
 
+/* number of BBMDs that a foreign device registers with, in the order of
+   their priority */
+#ifndef MAX_REMOTE_BBMD_ENTRIES
+#define MAX_REMOTE_BBMD_ENTRIES 4
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -64,6 +70,8 @@ void bvlc_set_function_code(uint8_t function_code);
 
 BACNET_STACK_EXPORT
 void bvlc_maintenance_timer(uint16_t seconds);
+BACNET_STACK_EXPORT
+unsigned long bvlc_broadcast_repeated_count(void);
 
 BACNET_STACK_EXPORT
 void bvlc_init(void);
@@ -94,6 +102,18 @@ void bvlc_remote_bbmd_address(
 BACNET_STACK_EXPORT
 uint16_t bvlc_remote_bbmd_lifetime(
     void);
+/* registers with a prioritized list of bbmds as a foreign device */
+BACNET_STACK_EXPORT
+int bvlc_register_with_bbmds(BACNET_IP_ADDRESS *address_list,
+    unsigned count,
+    uint16_t time_to_live_seconds);
+BACNET_STACK_EXPORT
+unsigned bvlc_remote_bbmd_count(void);
+BACNET_STACK_EXPORT
+bool bvlc_remote_bbmd_health(unsigned index,
+    BACNET_IP_ADDRESS *address,
+    bool *registered,
+    uint16_t *latency_ms);
 
 /* Local interface to manage BBMD.
  * The interface user needs to handle mutual exclusion if needed i.e.
@@ -12,7 +12,9 @@
 #include "bacnet/bacdcode.h"
 #include "bacnet/datalink/bip6.h"
 #include "bacnet/datalink/bvlc6.h"
+#include "bacnet/datalink/dlstats.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd6/vmac.h"
 #include "bacnet/basic/bbmd6/h_bbmd6.h"
@@ -51,6 +53,14 @@ static uint8_t BVLC6_Function_Code = BVLC6_RESULT;
 static BACNET_IP6_ADDRESS Remote_BBMD;
 /** if we are a foreign device, store the Time-To-Live Seconds here */
 static uint16_t Remote_BBMD_TTL_Seconds;
+/* a device whose VMAC is unknown, and which was asked for it */
+struct bbmd6_resolution_negative {
+    uint32_t device_id;
+    /* seconds until the device may be asked again, or 0 if unused */
+    uint16_t ttl_seconds_remaining;
+};
+static struct bbmd6_resolution_negative
+    BBMD6_Resolution_Negative[BBMD6_RESOLUTION_NEGATIVE_ENTRIES];
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
 /* local buffer & length for sending */
 static uint8_t BVLC6_Buffer[BIP6_MPDU_MAX];
@@ -66,6 +76,9 @@ static BACNET_IP6_BROADCAST_DISTRIBUTION_TABLE_ENTRY
 #define MAX_FD6_ENTRIES 128
 #endif
 static BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY FD_Table[MAX_FD6_ENTRIES];
+/* destinations of one forwarded message, sent as one list */
+static BACNET_IP6_ADDRESS BBMD6_Forward_List[MAX_BBMD6_ENTRIES];
+static BACNET_IP6_ADDRESS FD6_Forward_List[MAX_FD6_ENTRIES];
 #endif
 
 /**
@@ -83,9 +96,17 @@ void bvlc6_debug_enable(void)
  */
 void bvlc6_maintenance_timer(uint16_t seconds)
 {
-#if defined(BACDL_BIP6) && BBMD6_ENABLED
     unsigned i = 0;
 
+    for (i = 0; i < BBMD6_RESOLUTION_NEGATIVE_ENTRIES; i++) {
+        if (BBMD6_Resolution_Negative[i].ttl_seconds_remaining > seconds) {
+            BBMD6_Resolution_Negative[i].ttl_seconds_remaining -= seconds;
+        } else {
+            BBMD6_Resolution_Negative[i].ttl_seconds_remaining = 0;
+        }
+    }
+    (void)VMAC_Maintenance_Timer(seconds);
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
     for (i = 0; i < MAX_FD6_ENTRIES; i++) {
         if (FD_Table[i].valid) {
             if (FD_Table[i].ttl_seconds_remaining) {
@@ -100,11 +121,49 @@ void bvlc6_maintenance_timer(uint16_t seconds)
             }
         }
     }
-#else
-    (void)seconds;
 #endif
 }
 
+/**
+ * @brief Finds a device that was asked for its VMAC and has not answered
+ * @param device_id - device ID of the VMAC
+ * @return the entry of the device, or NULL if not found
+ */
+static struct bbmd6_resolution_negative *bbmd6_resolution_negative_find(
+    uint32_t device_id)
+{
+    unsigned i = 0;
+
+    for (i = 0; i < BBMD6_RESOLUTION_NEGATIVE_ENTRIES; i++) {
+        if (BBMD6_Resolution_Negative[i].ttl_seconds_remaining &&
+            (BBMD6_Resolution_Negative[i].device_id == device_id)) {
+            return &BBMD6_Resolution_Negative[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Remembers that a device was asked for its VMAC, reusing the
+ *  entry that expires first when all of them are in use
+ * @param device_id - device ID of the VMAC
+ */
+static void bbmd6_resolution_negative_add(uint32_t device_id)
+{
+    struct bbmd6_resolution_negative *entry = &BBMD6_Resolution_Negative[0];
+    unsigned i = 0;
+
+    for (i = 1; i < BBMD6_RESOLUTION_NEGATIVE_ENTRIES; i++) {
+        if (BBMD6_Resolution_Negative[i].ttl_seconds_remaining <
+            entry->ttl_seconds_remaining) {
+            entry = &BBMD6_Resolution_Negative[i];
+        }
+    }
+    entry->device_id = device_id;
+    entry->ttl_seconds_remaining = BBMD6_RESOLUTION_NEGATIVE_TTL_SECONDS;
+}
+
 /**
  * Sets the IPv6 source address from a VMAC address structure
  *
@@ -168,6 +227,7 @@ static void bbmd6_add_vmac(uint32_t device_id, BACNET_IP6_ADDRESS *addr)
     uint32_t list_device_id = 0;
     struct vmac_data *vmac;
     struct vmac_data new_vmac;
+    struct bbmd6_resolution_negative *negative;
     unsigned i = 0;
 
     if (bbmd6_address_to_vmac(&new_vmac, addr)) {
@@ -214,6 +274,13 @@ static void bbmd6_add_vmac(uint32_t device_id, BACNET_IP6_ADDRESS *addr)
                     (unsigned long)device_id);
             }
         }
+        /* hearing from the device keeps its VMAC, and answers
+           any Address-Resolution that asked for it */
+        (void)VMAC_Lifetime_Set(device_id, BBMD6_VMAC_TTL_SECONDS);
+        negative = bbmd6_resolution_negative_find(device_id);
+        if (negative) {
+            negative->ttl_seconds_remaining = 0;
+        }
     }
 }
 
@@ -256,16 +323,15 @@ static bool bbmd6_address_from_bacnet_address(
     uint32_t device_id = 0;
 
     if (addr && baddr) {
-        status = bvlc6_vmac_address_get(baddr, &device_id);
-        if (status) {
+        if (bvlc6_vmac_address_get(baddr, &device_id)) {
+            if (vmac_src) {
+                *vmac_src = device_id;
+            }
             vmac = VMAC_Find_By_Key(device_id);
             if (vmac) {
                 PRINTF("BVLC6: Found VMAC %lu (len=%u).\n",
                     (unsigned long)device_id, (unsigned)vmac->mac_len);
                 status = bbmd6_address_from_vmac(addr, vmac);
-                if (vmac_src) {
-                    *vmac_src = device_id;
-                }
             }
         }
     }
@@ -273,6 +339,38 @@ static bool bbmd6_address_from_bacnet_address(
     return status;
 }
 
+/**
+ * @brief Asks for the IPv6 address of a VMAC that is not in the VMAC
+ *  table, unless it was asked for recently and has not answered yet.
+ *  A foreign device asks its BBMD, which forwards the question.
+ * @param vmac_target - VMAC address (Device ID) to resolve
+ */
+static void bbmd6_address_resolve(uint32_t vmac_target)
+{
+    BACNET_IP6_ADDRESS bvlc_dest = { 0 };
+    uint8_t mtu[BIP6_MPDU_MAX] = { 0 };
+    uint16_t mtu_len = 0;
+    uint32_t vmac_src = 0;
+
+    if (bbmd6_resolution_negative_find(vmac_target)) {
+        PRINTF("BVLC6: VMAC %lu is not resolved yet.\n",
+            (unsigned long)vmac_target);
+        return;
+    }
+    bbmd6_resolution_negative_add(vmac_target);
+    if (Remote_BBMD.port) {
+        bvlc6_address_copy(&bvlc_dest, &Remote_BBMD);
+    } else {
+        bip6_get_broadcast_addr(&bvlc_dest);
+    }
+    vmac_src = Device_Object_Instance_Number();
+    mtu_len = bvlc6_encode_address_resolution(
+        mtu, sizeof(mtu), vmac_src, vmac_target);
+    bip6_send_mpdu(&bvlc_dest, mtu, mtu_len);
+    PRINTF("BVLC6: Sent Address-Resolution for %lu.\n",
+        (unsigned long)vmac_target);
+}
+
 /**
  * The common send function for BACnet/IPv6 application layer
  *
@@ -298,6 +396,7 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
 
     /* this datalink doesn't need to know the npdu data */
     (void)npdu_data;
+    BACNET_TRACE(NPDU_TX, dest->net, pdu_len);
     /* handle various broadcasts: */
     if ((dest->net == BACNET_BROADCAST_NETWORK) || (dest->mac_len == 0)) {
         /* mac_len = 0 is a broadcast address */
@@ -320,7 +419,11 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
         /* net > 0 and net < 65535 are network specific broadcast if len = 0 */
         if (dest->mac_len == 3) {
             /* network specific broadcast to address */
-            bbmd6_address_from_bacnet_address(&bvlc_dest, &vmac_dst, dest);
+            if (!bbmd6_address_from_bacnet_address(
+                    &bvlc_dest, &vmac_dst, dest)) {
+                bbmd6_address_resolve(vmac_dst);
+                return -1;
+            }
         } else {
             bip6_get_broadcast_addr(&bvlc_dest);
         }
@@ -330,7 +433,12 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
         PRINTF("BVLC6: Sent Original-Broadcast-NPDU.\n");
     } else if (dest->mac_len == 3) {
         /* valid unicast */
-        bbmd6_address_from_bacnet_address(&bvlc_dest, &vmac_dst, dest);
+        if (!bbmd6_address_from_bacnet_address(&bvlc_dest, &vmac_dst, dest)) {
+            /* the message is dropped, and sent again by the
+               retries of the application once the VMAC is known */
+            bbmd6_address_resolve(vmac_dst);
+            return -1;
+        }
         PRINTF("BVLC6: Sending to VMAC %lu.\n", (unsigned long)vmac_dst);
         vmac_src = Device_Object_Instance_Number();
         mtu_len = bvlc6_encode_original_unicast(
@@ -345,6 +453,32 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
 }
 
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
+/**
+ * @brief Send the same MPDU to a list of destinations, with one call
+ *  to the datalink when the port can send a list
+ * @param dest_list - array of destination IPv6 addresses and UDP ports
+ * @param dest_count - number of destinations in the array
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ */
+static void bbmd6_send_mpdu_list(BACNET_IP6_ADDRESS *dest_list,
+    unsigned dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
+{
+#if BACNET_IP6_SEND_MPDU_LIST
+    if (dest_count > 0) {
+        bip6_send_mpdu_list(dest_list, dest_count, mtu, mtu_len);
+    }
+#else
+    unsigned i = 0;
+
+    for (i = 0; i < dest_count; i++) {
+        bip6_send_mpdu(&dest_list[i], mtu, mtu_len);
+    }
+#endif
+}
+
 /**
  * The send function for Broacast Distribution Table
  *
@@ -357,18 +491,22 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
 static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
 {
     BACNET_IP6_ADDRESS my_addr = { 0 };
+    unsigned count = 0;
     unsigned i = 0; /* loop counter */
 
     if (mtu) {
         bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
+        for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
             if (BBMD_Table[i].valid) {
                 if (bvlc6_address_different(
                         &my_addr, &BBMD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&BBMD_Table[i].bip6_address, mtu, mtu_len);
+                    bvlc6_address_copy(&BBMD6_Forward_List[count],
+                        &BBMD_Table[i].bip6_address);
+                    count++;
                 }
             }
         }
+        bbmd6_send_mpdu_list(BBMD6_Forward_List, count, mtu, mtu_len);
     }
 }
 
@@ -384,18 +522,22 @@ static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
 static void bbmd6_send_pdu_fdt(uint8_t *mtu, unsigned int mtu_len)
 {
     BACNET_IP6_ADDRESS my_addr = { 0 };
+    unsigned count = 0;
     unsigned i = 0; /* loop counter */
 
     if (mtu) {
         bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_FD_ENTRIES; i++) {
+        for (i = 0; i < MAX_FD6_ENTRIES; i++) {
             if (FD_Table[i].valid) {
                 if (bvlc6_address_different(
                         &my_addr, &FD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
+                    bvlc6_address_copy(
+                        &FD6_Forward_List[count], &FD_Table[i].bip6_address);
+                    count++;
                 }
             }
         }
+        bbmd6_send_mpdu_list(FD6_Forward_List, count, mtu, mtu_len);
     }
 }
 
@@ -415,26 +557,34 @@ static void bbmd6_send_forward_npdu(BACNET_IP6_ADDRESS *address,
 {
     uint8_t mtu[BIP6_MPDU_MAX] = { 0 };
     uint16_t mtu_len = 0;
+    unsigned count = 0;
     unsigned i = 0; /* loop counter */
 
-    for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
+    for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
         if (BBMD_Table[i].valid) {
             if (bbmd6_address_match_self(&BBMD_Table[i].bip6_address)) {
                 /* don't forward to our selves */
             } else {
-                bip6_send_mpdu(&BBMD_Table[i].bip6_address, mtu, mtu_len);
+                bvlc6_address_copy(
+                    &BBMD6_Forward_List[count], &BBMD_Table[i].bip6_address);
+                count++;
             }
         }
     }
-    for (i = 0; i < MAX_FD_ENTRIES; i++) {
+    bbmd6_send_mpdu_list(BBMD6_Forward_List, count, mtu, mtu_len);
+    count = 0;
+    for (i = 0; i < MAX_FD6_ENTRIES; i++) {
         if (FD_Table[i].valid) {
             if (bbmd6_address_match_self(&FD_Table[i].bip6_address)) {
                 /* don't forward to our selves */
             } else {
-                bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
+                bvlc6_address_copy(
+                    &FD6_Forward_List[count], &FD_Table[i].bip6_address);
+                count++;
             }
         }
     }
+    bbmd6_send_mpdu_list(FD6_Forward_List, count, mtu, mtu_len);
 }
 
 #endif
@@ -457,6 +607,9 @@ static int bvlc6_send_result(
     uint16_t mtu_len = 0;
 
     mtu_len = bvlc6_encode_result(&mtu[0], sizeof(mtu), vmac_src, result_code);
+    if (result_code != BVLC6_RESULT_SUCCESSFUL_COMPLETION) {
+        datalink_stats_error(PORT_TYPE_BIP6, DATALINK_STATS_BVLC_NAK);
+    }
 
     return bip6_send_mpdu(dest_addr, mtu, mtu_len);
 }
@@ -634,6 +787,40 @@ static void bbmd6_address_resolution_ack_handler(
     }
 }
 
+/**
+ * Handler for Forwarded-Address-Resolution
+ *
+ * @param addr - BACnet/IPv6 source address any NAK or reply back to.
+ * @param pdu - The received NPDU+APDU buffer.
+ * @param pdu_len - How many bytes in NPDU+APDU buffer.
+ */
+static void bbmd6_forwarded_address_resolution_handler(
+    BACNET_IP6_ADDRESS *addr, uint8_t *pdu, uint16_t pdu_len)
+{
+    BACNET_IP6_ADDRESS fwd_address = { 0 };
+    int function_len = 0;
+    uint32_t vmac_src = 0;
+    uint32_t vmac_target = 0;
+    uint32_t vmac_me = 0;
+
+    if (addr && pdu) {
+        PRINTF("BIP6: Received Forwarded-Address-Resolution.\n");
+        function_len = bvlc6_decode_forwarded_address_resolution(
+            pdu, pdu_len, &vmac_src, &vmac_target, &fwd_address);
+        if (function_len && !bbmd6_address_match_self(&fwd_address)) {
+            bbmd6_add_vmac(vmac_src, &fwd_address);
+            vmac_me = Device_Object_Instance_Number();
+            if (vmac_target == vmac_me) {
+                /* The Address-Resolution-ACK message is unicast
+                   to the B/IPv6 node that originally initiated
+                   the Address-Resolution message. */
+                bvlc6_send_address_resolution_ack(
+                    &fwd_address, vmac_me, vmac_src);
+            }
+        }
+    }
+}
+
 /**
  * Use this handler when you are not a BBMD.
  * Sets the BVLC6_Function_Code in case it is needed later.
@@ -677,6 +864,10 @@ int bvlc6_bbmd_disabled_handler(BACNET_IP6_ADDRESS *addr,
                     bvlc6_decode_result(pdu, pdu_len, &vmac_src, &result_code);
                 if (function_len) {
                     BVLC6_Result_Code = result_code;
+                    if (result_code != BVLC6_RESULT_SUCCESSFUL_COMPLETION) {
+                        datalink_stats_error(
+                            PORT_TYPE_BIP6, DATALINK_STATS_BVLC_NAK);
+                    }
                     /* The Virtual MAC address table shall be updated
                        using the respective parameter values of the
                        incoming messages. */
@@ -779,8 +970,8 @@ int bvlc6_bbmd_disabled_handler(BACNET_IP6_ADDRESS *addr,
                 }
                 break;
             case BVLC6_FORWARDED_ADDRESS_RESOLUTION:
-                result_code = BVLC6_RESULT_ADDRESS_RESOLUTION_NAK;
-                send_result = true;
+                bbmd6_forwarded_address_resolution_handler(
+                    addr, pdu, pdu_len);
                 break;
             case BVLC6_ADDRESS_RESOLUTION:
                 bbmd6_address_resolution_handler(addr, pdu, pdu_len);
@@ -844,6 +1035,7 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
     bool send_result = false;
     uint16_t offset = 0;
     BACNET_IP6_ADDRESS fwd_address = { { 0 } };
+    BACNET_IP6_ADDRESS bvlc_dest = { { 0 } };
 
     header_len =
         bvlc6_decode_header(mtu, mtu_len, &message_type, &message_length);
@@ -857,6 +1049,10 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                     bvlc6_decode_result(pdu, pdu_len, &vmac_src, &result_code);
                 if (function_len) {
                     BVLC6_Result_Code = result_code;
+                    if (result_code != BVLC6_RESULT_SUCCESSFUL_COMPLETION) {
+                        datalink_stats_error(
+                            PORT_TYPE_BIP6, DATALINK_STATS_BVLC_NAK);
+                    }
                     /* The Virtual MAC address table shall be updated
                        using the respective parameter values of the
                        incoming messages. */
@@ -976,8 +1172,8 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                 }
                 break;
             case BVLC6_FORWARDED_ADDRESS_RESOLUTION:
-                result_code = BVLC6_RESULT_ADDRESS_RESOLUTION_NAK;
-                send_result = true;
+                bbmd6_forwarded_address_resolution_handler(
+                    addr, pdu, pdu_len);
                 break;
             case BVLC6_ADDRESS_RESOLUTION:
                 bbmd6_address_resolution_handler(addr, pdu, pdu_len);
@@ -1106,6 +1302,7 @@ uint8_t bvlc6_get_function_code(void)
 void bvlc6_cleanup(void)
 {
     VMAC_Cleanup();
+    memset(BBMD6_Resolution_Negative, 0, sizeof(BBMD6_Resolution_Negative));
 }
 
 /**
@@ -16,6 +16,21 @@
 /* BACnet Stack API */
 #include "bacnet/datalink/bvlc6.h"
 
+/* seconds that a learned VMAC is kept without hearing from its device,
+   or 0 to keep it until its address or device ID changes */
+#ifndef BBMD6_VMAC_TTL_SECONDS
+#define BBMD6_VMAC_TTL_SECONDS 900
+#endif
+/* number of devices that are remembered as not yet answering an
+   Address-Resolution */
+#ifndef BBMD6_RESOLUTION_NEGATIVE_ENTRIES
+#define BBMD6_RESOLUTION_NEGATIVE_ENTRIES 16
+#endif
+/* seconds before such a device is asked again */
+#ifndef BBMD6_RESOLUTION_NEGATIVE_TTL_SECONDS
+#define BBMD6_RESOLUTION_NEGATIVE_TTL_SECONDS 10
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
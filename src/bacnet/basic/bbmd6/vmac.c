@@ -10,9 +10,11 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/static_pool.h"
 /* me! */
 #include "bacnet/basic/bbmd6/vmac.h"
 
@@ -33,8 +35,110 @@ void VMAC_Debug_Enable(void)
 /* This module is used to handle the virtual MAC address binding that */
 /* occurs in BACnet for ZigBee or IPv6. */
 
+/* Number of hash buckets used by the device-id and address indexes.
+   Any size works; a value near the number of neighbors keeps chains
+   short. */
+#ifndef VMAC_HASH_SIZE
+#define VMAC_HASH_SIZE 1024
+#endif
+
+/* a VMAC in the list, with the links of its hash chains */
+struct vmac_entry {
+    /* first, so that a pointer to the entry is a pointer to the data */
+    struct vmac_data vmac;
+    uint32_t device_id;
+    /* seconds until the entry is removed, or 0 to keep it */
+    uint16_t ttl_seconds_remaining;
+    struct vmac_entry *key_next;
+    struct vmac_entry *data_next;
+};
+
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist VMAC_List;
+/* hash chains of the entries by device ID and by VMAC address */
+static struct vmac_entry *VMAC_Key_Hash[VMAC_HASH_SIZE];
+static struct vmac_entry *VMAC_Data_Hash[VMAC_HASH_SIZE];
+
+/**
+ * @brief Compute the hash bucket for a device instance
+ * @param device_id - device instance number
+ * @return hash bucket index
+ */
+static unsigned vmac_key_hash(uint32_t device_id)
+{
+    /* Knuth multiplicative hash spreads sequential instances */
+    return (unsigned)((device_id * 2654435761UL) & 0xFFFFFFFFUL) %
+        VMAC_HASH_SIZE;
+}
+
+/**
+ * @brief Compute the hash bucket for a VMAC address, using only the
+ *  octets that are compared by VMAC_Match()
+ * @param vmac - VMAC address
+ * @return hash bucket index
+ */
+static unsigned vmac_data_hash(const struct vmac_data *vmac)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned int mac_len = VMAC_MAC_MAX;
+    unsigned int i = 0;
+
+    if (vmac->mac_len < mac_len) {
+        mac_len = (unsigned int)vmac->mac_len;
+    }
+    hash = (hash ^ vmac->mac_len) * 16777619UL;
+    for (i = 0; i < mac_len; i++) {
+        hash = (hash ^ vmac->mac[i]) * 16777619UL;
+    }
+
+    return (unsigned)(hash & 0xFFFFFFFFUL) % VMAC_HASH_SIZE;
+}
+
+/**
+ * @brief Remove an entry from both of its hash chains
+ * @param entry - the entry to remove
+ */
+static void vmac_hash_unlink(const struct vmac_entry *entry)
+{
+    struct vmac_entry **link;
+
+    link = &VMAC_Key_Hash[vmac_key_hash(entry->device_id)];
+    while (*link) {
+        if (*link == entry) {
+            *link = entry->key_next;
+            break;
+        }
+        link = &(*link)->key_next;
+    }
+    link = &VMAC_Data_Hash[vmac_data_hash(&entry->vmac)];
+    while (*link) {
+        if (*link == entry) {
+            *link = entry->data_next;
+            break;
+        }
+        link = &(*link)->data_next;
+    }
+}
+
+/**
+ * @brief Finds the entry of a device ID
+ * @param device_id - BACnet device object instance number
+ * @return the entry, or NULL if not found
+ */
+static struct vmac_entry *vmac_entry_find(uint32_t device_id)
+{
+    struct vmac_entry *entry;
+
+    entry = VMAC_Key_Hash[vmac_key_hash(device_id)];
+    while (entry) {
+        if (entry->device_id == device_id) {
+            break;
+        }
+        entry = entry->key_next;
+    }
+
+    return entry;
+}
 
 /**
  * Returns the number of VMAC in the list
@@ -55,14 +159,17 @@ unsigned int VMAC_Count(void)
 bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
 {
     bool status = false;
+    struct vmac_entry *entry = NULL;
     struct vmac_data *pVMAC = NULL;
+    unsigned bucket = 0;
     int index = 0;
     size_t i = 0;
 
-    pVMAC = Keylist_Data(VMAC_List, device_id);
+    pVMAC = VMAC_Find_By_Key(device_id);
     if (!pVMAC) {
-        pVMAC = calloc(1, sizeof(struct vmac_data));
-        if (pVMAC) {
+        entry = bacnet_calloc(1, sizeof(struct vmac_entry));
+        if (entry) {
+            pVMAC = &entry->vmac;
             /* copy the MAC into the data store */
             for (i = 0; i < sizeof(pVMAC->mac); i++) {
                 if (i < src->mac_len) {
@@ -72,13 +179,22 @@ bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
                 }
             }
             pVMAC->mac_len = src->mac_len;
-            index = Keylist_Data_Add(VMAC_List, device_id, pVMAC);
+            entry->device_id = device_id;
+            index = Keylist_Data_Add(VMAC_List, device_id, entry);
             if (index >= 0) {
+                bucket = vmac_key_hash(device_id);
+                entry->key_next = VMAC_Key_Hash[bucket];
+                VMAC_Key_Hash[bucket] = entry;
+                bucket = vmac_data_hash(pVMAC);
+                entry->data_next = VMAC_Data_Hash[bucket];
+                VMAC_Data_Hash[bucket] = entry;
                 status = true;
                 if (VMAC_Debug) {
                     debug_fprintf(
                         stderr, "VMAC %u added.\n", (unsigned int)device_id);
                 }
+            } else {
+                bacnet_free(entry);
             }
         }
     }
@@ -96,11 +212,12 @@ bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
 bool VMAC_Delete(uint32_t device_id)
 {
     bool status = false;
-    struct vmac_data *pVMAC;
+    struct vmac_entry *entry;
 
-    pVMAC = Keylist_Data_Delete(VMAC_List, device_id);
-    if (pVMAC) {
-        free(pVMAC);
+    entry = Keylist_Data_Delete(VMAC_List, device_id);
+    if (entry) {
+        vmac_hash_unlink(entry);
+        bacnet_free(entry);
         status = true;
     }
 
@@ -116,7 +233,67 @@ bool VMAC_Delete(uint32_t device_id)
  */
 struct vmac_data *VMAC_Find_By_Key(uint32_t device_id)
 {
-    return Keylist_Data(VMAC_List, device_id);
+    struct vmac_entry *entry;
+
+    entry = vmac_entry_find(device_id);
+
+    return entry ? &entry->vmac : NULL;
+}
+
+/**
+ * @brief Sets the number of seconds that a VMAC is kept in the list
+ *  before VMAC_Maintenance_Timer() removes it
+ * @param device_id - BACnet device object instance number
+ * @param ttl_seconds - seconds to keep the VMAC, or 0 to keep it
+ *  until it is deleted
+ * @return true if the VMAC is in the list
+ */
+bool VMAC_Lifetime_Set(uint32_t device_id, uint16_t ttl_seconds)
+{
+    struct vmac_entry *entry;
+
+    entry = vmac_entry_find(device_id);
+    if (entry) {
+        entry->ttl_seconds_remaining = ttl_seconds;
+    }
+
+    return entry != NULL;
+}
+
+/**
+ * @brief Ages the VMAC that have a lifetime, and removes the ones
+ *  whose lifetime has run out
+ * @param seconds - number of elapsed seconds since the last call
+ * @return number of VMAC that were removed
+ */
+unsigned int VMAC_Maintenance_Timer(uint16_t seconds)
+{
+    struct vmac_entry *entry;
+    unsigned int count = 0;
+    int index;
+
+    index = Keylist_Count(VMAC_List);
+    while (index > 0) {
+        index--;
+        entry = Keylist_Data_Index(VMAC_List, index);
+        if (!entry || !entry->ttl_seconds_remaining) {
+            continue;
+        }
+        if (entry->ttl_seconds_remaining > seconds) {
+            entry->ttl_seconds_remaining -= seconds;
+            continue;
+        }
+        if (VMAC_Debug) {
+            debug_fprintf(stderr, "VMAC %u expired.\n",
+                (unsigned int)entry->device_id);
+        }
+        (void)Keylist_Data_Delete_By_Index(VMAC_List, index);
+        vmac_hash_unlink(entry);
+        bacnet_free(entry);
+        count++;
+    }
+
+    return count;
 }
 
 /** Compare the VMAC address
@@ -183,7 +360,8 @@ bool VMAC_Match(struct vmac_data *vmac1, struct vmac_data *vmac2)
 }
 
 /**
- * Finds a VMAC in the list by seeking a matching VMAC address
+ * Finds a VMAC in the list by seeking a matching VMAC address,
+ * using the hash index of the VMAC addresses
  *
  * @param vmac - VMAC address that will be sought
  * @param device_id - BACnet device object instance number
@@ -192,25 +370,23 @@ bool VMAC_Match(struct vmac_data *vmac1, struct vmac_data *vmac2)
  */
 bool VMAC_Find_By_Data(struct vmac_data *vmac, uint32_t *device_id)
 {
-    bool status = false;
-    struct vmac_data *list_vmac;
-    int count = 0;
-    int index = 0;
+    struct vmac_entry *entry;
 
-    count = Keylist_Count(VMAC_List);
-    while (count) {
-        index = count - 1;
-        list_vmac = Keylist_Data_Index(VMAC_List, index);
-        if (list_vmac) {
-            if (VMAC_Match(vmac, list_vmac)) {
-                status = Keylist_Index_Key(VMAC_List, index, device_id);
-                break;
+    if (!vmac) {
+        return false;
+    }
+    entry = VMAC_Data_Hash[vmac_data_hash(vmac)];
+    while (entry) {
+        if (VMAC_Match(vmac, &entry->vmac)) {
+            if (device_id) {
+                *device_id = entry->device_id;
             }
+            return true;
         }
-        count--;
+        entry = entry->data_next;
     }
 
-    return status;
+    return false;
 }
 
 /**
@@ -218,6 +394,7 @@ bool VMAC_Find_By_Data(struct vmac_data *vmac, uint32_t *device_id)
  */
 void VMAC_Cleanup(void)
 {
+    struct vmac_entry *entry;
     struct vmac_data *pVMAC;
     const int index = 0;
     unsigned i = 0;
@@ -228,7 +405,8 @@ void VMAC_Cleanup(void)
             if (VMAC_Debug) {
                 Keylist_Index_Key(VMAC_List, index, &device_id);
             }
-            pVMAC = Keylist_Data_Delete_By_Index(VMAC_List, index);
+            entry = Keylist_Data_Delete_By_Index(VMAC_List, index);
+            pVMAC = entry ? &entry->vmac : NULL;
             if (pVMAC) {
                 if (VMAC_Debug) {
                     debug_fprintf(
@@ -239,12 +417,14 @@ void VMAC_Cleanup(void)
                     }
                     debug_fprintf(stderr, "]\n");
                 }
-                free(pVMAC);
+                bacnet_free(entry);
             }
         } while (pVMAC);
         Keylist_Delete(VMAC_List);
         VMAC_List = NULL;
     }
+    memset(VMAC_Key_Hash, 0, sizeof(VMAC_Key_Hash));
+    memset(VMAC_Data_Hash, 0, sizeof(VMAC_Data_Hash));
 }
 
 /**
@@ -41,6 +41,10 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool VMAC_Delete(uint32_t device_id);
     BACNET_STACK_EXPORT
+    bool VMAC_Lifetime_Set(uint32_t device_id, uint16_t ttl_seconds);
+    BACNET_STACK_EXPORT
+    unsigned int VMAC_Maintenance_Timer(uint16_t seconds);
+    BACNET_STACK_EXPORT
     bool VMAC_Different(
         struct vmac_data *vmac1,
         struct vmac_data *vmac2);
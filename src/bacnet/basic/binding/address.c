@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -17,6 +18,7 @@
 #include "bacnet/bacdcode.h"
 #include "bacnet/readrange.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/memstats.h"
 
 /* we are likely compiling the demo command line tools if print enabled */
 #if !defined(BACNET_ADDRESS_CACHE_FILE)
@@ -24,6 +26,26 @@
 #define BACNET_ADDRESS_CACHE_FILE
 #endif
 #endif
+#ifdef BACNET_ADDRESS_CACHE_FILE
+/* seconds between the binary snapshots of the cache that are saved by
+   address_cache_timer(), or 0 to save them only when asked */
+#ifndef BACNET_ADDRESS_SNAPSHOT_INTERVAL
+#define BACNET_ADDRESS_SNAPSHOT_INTERVAL 0
+#endif
+/* 1 to load a snapshot from a memory map of the file,
+   which needs the POSIX mmap() and fileno() */
+#ifndef BACNET_ADDRESS_SNAPSHOT_MMAP
+#if !defined(_WIN32) && (defined(_POSIX_C_SOURCE) || defined(__APPLE__))
+#define BACNET_ADDRESS_SNAPSHOT_MMAP 1
+#else
+#define BACNET_ADDRESS_SNAPSHOT_MMAP 0
+#endif
+#endif
+#if BACNET_ADDRESS_SNAPSHOT_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#endif
 
 /* This module is used to handle the address binding that */
 /* occurs in BACnet.  A device id is bound to a MAC address. */
@@ -31,6 +53,7 @@
 
 static uint32_t Top_Protected_Entry;
 static uint32_t Own_Device_ID = 0xFFFFFFFF;
+static address_refresh_callback_t Address_Refresh_Callback;
 
 /* The address cache is used for binding to BACnet devices */
 /* The number of entries corresponds to the number of */
@@ -41,14 +64,88 @@ static uint32_t Own_Device_ID = 0xFFFFFFFF;
 #define MAX_ADDRESS_CACHE 255
 #endif
 
+/* Number of hash buckets used by the device-id and address indexes.
+   Any size works; a value near MAX_ADDRESS_CACHE keeps chains short. */
+#if !defined(ADDRESS_CACHE_HASH_SIZE)
+#define ADDRESS_CACHE_HASH_SIZE MAX_ADDRESS_CACHE
+#endif
+
+/* Bounds of the APDU timeout of a device that is derived from its
+   round trip time, in milliseconds, and the most times that it is
+   doubled while the requests to the device are timing out. */
+#if !defined(ADDRESS_APDU_TIMEOUT_MIN)
+#define ADDRESS_APDU_TIMEOUT_MIN 500
+#endif
+#if !defined(ADDRESS_APDU_TIMEOUT_MAX)
+#define ADDRESS_APDU_TIMEOUT_MAX 60000
+#endif
+#if !defined(ADDRESS_APDU_TIMEOUT_BACKOFF_MAX)
+#define ADDRESS_APDU_TIMEOUT_BACKOFF_MAX 4
+#endif
+/* seconds before a bound entry expires that its device is asked again
+   with a Who-Is, so that the entry is renewed before a request needs it */
+#if !defined(ADDRESS_REFRESH_TIME)
+#define ADDRESS_REFRESH_TIME 600
+#endif
+/* most entries asked again at each call of address_cache_timer() */
+#if !defined(ADDRESS_REFRESH_BATCH)
+#define ADDRESS_REFRESH_BATCH 16
+#endif
+/* most device-ids between two entries of the same network that are
+   asked with one Who-Is range */
+#if !defined(ADDRESS_REFRESH_GAP)
+#define ADDRESS_REFRESH_GAP 4
+#endif
+
+/* Entry number type - sized to the cache so that large caches are allowed.
+   Entry numbers are one-based so that zero-initialized memory holds a
+   valid, empty set of indexes. */
+#if (MAX_ADDRESS_CACHE < UINT16_MAX)
+typedef uint16_t ADDRESS_CACHE_INDEX;
+#else
+typedef uint32_t ADDRESS_CACHE_INDEX;
+#endif
+#define ADDRESS_CACHE_INDEX_NONE 0
+#define ADDRESS_CACHE_ENTRY(n) (&Address_Cache[(n)-1])
+
 static struct Address_Cache_Entry {
     uint8_t Flags;
     uint32_t device_id;
     unsigned max_apdu;
+    /* segmentation supported, from the I-Am of the device */
+    uint8_t segmentation;
+    /* maximum segments accepted, from the requests of the device */
+    uint8_t max_segments;
+    /* smoothed round trip time, in milliseconds, or 0 when not known */
+    uint16_t round_trip_time;
+    /* smoothed mean deviation of the round trip time, in milliseconds */
+    uint16_t round_trip_variance;
+    /* times that the APDU timeout is doubled, since a request timed out */
+    uint8_t timeout_backoff;
     BACNET_ADDRESS address;
     uint32_t TimeToLive;
+    /* next entry in the device-id hash chain, or in the free list */
+    ADDRESS_CACHE_INDEX device_next;
+    /* next entry in the address hash chain */
+    ADDRESS_CACHE_INDEX address_next;
+    /* least-recently-used list links */
+    ADDRESS_CACHE_INDEX lru_prev;
+    ADDRESS_CACHE_INDEX lru_next;
+    /* true if the entry is linked into the address hash table */
+    bool address_hashed;
 } Address_Cache[MAX_ADDRESS_CACHE];
 
+/* hash table heads for lookup by device-id and by address */
+static ADDRESS_CACHE_INDEX Device_Hash[ADDRESS_CACHE_HASH_SIZE];
+static ADDRESS_CACHE_INDEX Address_Hash[ADDRESS_CACHE_HASH_SIZE];
+/* list of released entries that are not holding a slot */
+static ADDRESS_CACHE_INDEX Free_Head;
+/* number of entries at the start of the table that have ever been used */
+static ADDRESS_CACHE_INDEX Used_Count;
+/* most recently used entry is at the head, least at the tail */
+static ADDRESS_CACHE_INDEX LRU_Head;
+static ADDRESS_CACHE_INDEX LRU_Tail;
+
 /* State flags for cache entries */
 
 /* Address cache entry in use */
@@ -59,6 +156,8 @@ static struct Address_Cache_Entry {
 #define BAC_ADDR_STATIC BIT(2)
 /* Opportunistically added address with short TTL */
 #define BAC_ADDR_SHORT_TTL BIT(3)
+/* Who-Is sent for an entry that is about to expire */
+#define BAC_ADDR_REFRESH BIT(4)
 /* Freed up but held for caller to fill */
 #define BAC_ADDR_RESERVED BIT(7)
 
@@ -69,6 +168,292 @@ static struct Address_Cache_Entry {
 #define BAC_ADDR_SHORT_TIME BAC_ADDR_SECS_1HOUR
 #define BAC_ADDR_FOREVER 0xFFFFFFFF /* Permanent entry */
 
+/**
+ * @brief Compute the hash bucket for a device instance
+ * @param device_id - device instance number
+ * @return hash bucket index
+ */
+static unsigned address_device_hash(uint32_t device_id)
+{
+    /* Knuth multiplicative hash spreads sequential instances */
+    return (unsigned)((device_id * 2654435761UL) & 0xFFFFFFFFUL) %
+        ADDRESS_CACHE_HASH_SIZE;
+}
+
+/**
+ * @brief Compute the hash bucket for a BACnet address, using only the
+ *  fields that are compared by bacnet_address_same()
+ * @param src - BACnet address
+ * @return hash bucket index
+ */
+static unsigned address_mac_hash(BACNET_ADDRESS *src)
+{
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
+    uint8_t len;
+
+    len = src->mac_len;
+    if (len > MAX_MAC_LEN) {
+        len = MAX_MAC_LEN;
+    }
+    hash = (hash ^ len) * 16777619UL;
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ src->mac[i]) * 16777619UL;
+    }
+    hash = (hash ^ (src->net & 0xFF)) * 16777619UL;
+    hash = (hash ^ (src->net >> 8)) * 16777619UL;
+    if (src->net != 0) {
+        len = src->len;
+        if (len > MAX_MAC_LEN) {
+            len = MAX_MAC_LEN;
+        }
+        hash = (hash ^ len) * 16777619UL;
+        for (i = 0; i < len; i++) {
+            hash = (hash ^ src->adr[i]) * 16777619UL;
+        }
+    }
+
+    return (unsigned)(hash & 0xFFFFFFFFUL) % ADDRESS_CACHE_HASH_SIZE;
+}
+
+/**
+ * @brief Remove an entry from the least-recently-used list
+ * @param index - entry number
+ */
+static void address_lru_unlink(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = ADDRESS_CACHE_ENTRY(index);
+
+    if (pMatch->lru_prev != ADDRESS_CACHE_INDEX_NONE) {
+        ADDRESS_CACHE_ENTRY(pMatch->lru_prev)->lru_next = pMatch->lru_next;
+    } else if (LRU_Head == index) {
+        LRU_Head = pMatch->lru_next;
+    }
+    if (pMatch->lru_next != ADDRESS_CACHE_INDEX_NONE) {
+        ADDRESS_CACHE_ENTRY(pMatch->lru_next)->lru_prev = pMatch->lru_prev;
+    } else if (LRU_Tail == index) {
+        LRU_Tail = pMatch->lru_prev;
+    }
+    pMatch->lru_prev = ADDRESS_CACHE_INDEX_NONE;
+    pMatch->lru_next = ADDRESS_CACHE_INDEX_NONE;
+}
+
+/**
+ * @brief Move an entry to the most-recently-used end of the LRU list
+ * @param index - entry number
+ */
+static void address_lru_touch(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = ADDRESS_CACHE_ENTRY(index);
+
+    if (LRU_Head == index) {
+        return;
+    }
+    address_lru_unlink(index);
+    pMatch->lru_next = LRU_Head;
+    if (LRU_Head != ADDRESS_CACHE_INDEX_NONE) {
+        ADDRESS_CACHE_ENTRY(LRU_Head)->lru_prev = index;
+    }
+    LRU_Head = index;
+    if (LRU_Tail == ADDRESS_CACHE_INDEX_NONE) {
+        LRU_Tail = index;
+    }
+}
+
+/**
+ * @brief Remove an entry from the address hash table
+ * @param index - entry number
+ */
+static void address_mac_unlink(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = ADDRESS_CACHE_ENTRY(index);
+    ADDRESS_CACHE_INDEX *pLink;
+
+    if (!pMatch->address_hashed) {
+        return;
+    }
+    pLink = &Address_Hash[address_mac_hash(&pMatch->address)];
+    while (*pLink != ADDRESS_CACHE_INDEX_NONE) {
+        if (*pLink == index) {
+            *pLink = pMatch->address_next;
+            break;
+        }
+        pLink = &ADDRESS_CACHE_ENTRY(*pLink)->address_next;
+    }
+    pMatch->address_next = ADDRESS_CACHE_INDEX_NONE;
+    pMatch->address_hashed = false;
+}
+
+/**
+ * @brief Store the address of an entry and index it by that address
+ * @param index - entry number
+ * @param src - BACnet address to store
+ */
+static void address_mac_set(ADDRESS_CACHE_INDEX index, BACNET_ADDRESS *src)
+{
+    struct Address_Cache_Entry *pMatch = ADDRESS_CACHE_ENTRY(index);
+    unsigned bucket;
+
+    address_mac_unlink(index);
+    bacnet_address_copy(&pMatch->address, src);
+    bucket = address_mac_hash(&pMatch->address);
+    pMatch->address_next = Address_Hash[bucket];
+    Address_Hash[bucket] = index;
+    pMatch->address_hashed = true;
+}
+
+/**
+ * @brief Remove an entry from the device-id hash table
+ * @param index - entry number
+ */
+static void address_device_unlink(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = ADDRESS_CACHE_ENTRY(index);
+    ADDRESS_CACHE_INDEX *pLink;
+
+    pLink = &Device_Hash[address_device_hash(pMatch->device_id)];
+    while (*pLink != ADDRESS_CACHE_INDEX_NONE) {
+        if (*pLink == index) {
+            *pLink = pMatch->device_next;
+            break;
+        }
+        pLink = &ADDRESS_CACHE_ENTRY(*pLink)->device_next;
+    }
+    pMatch->device_next = ADDRESS_CACHE_INDEX_NONE;
+}
+
+/**
+ * @brief Find the entry holding a slot for the given device-id
+ * @param device_id - device instance number
+ * @return entry number, or ADDRESS_CACHE_INDEX_NONE if not found
+ */
+static ADDRESS_CACHE_INDEX address_device_find(uint32_t device_id)
+{
+    ADDRESS_CACHE_INDEX index;
+
+    index = Device_Hash[address_device_hash(device_id)];
+    while (index != ADDRESS_CACHE_INDEX_NONE) {
+        if (((ADDRESS_CACHE_ENTRY(index)->Flags & BAC_ADDR_IN_USE) != 0) &&
+            (ADDRESS_CACHE_ENTRY(index)->device_id == device_id)) {
+            break;
+        }
+        index = ADDRESS_CACHE_ENTRY(index)->device_next;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Return an entry to the free list, and remove it from all indexes
+ * @param index - entry number
+ */
+static void address_entry_release(ADDRESS_CACHE_INDEX index)
+{
+    struct Address_Cache_Entry *pMatch = ADDRESS_CACHE_ENTRY(index);
+
+    if (pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) {
+        address_device_unlink(index);
+        address_mac_unlink(index);
+        address_lru_unlink(index);
+        pMatch->Flags = 0;
+        pMatch->device_next = Free_Head;
+        Free_Head = index;
+    }
+}
+
+/**
+ * @brief Take a free entry and index it by device-id
+ * @param device_id - device instance number
+ * @param flags - initial entry state flags
+ * @return entry number, or ADDRESS_CACHE_INDEX_NONE if the cache is full
+ */
+static ADDRESS_CACHE_INDEX address_entry_claim(
+    uint32_t device_id, uint8_t flags)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+    unsigned bucket;
+
+    index = Free_Head;
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        Free_Head = ADDRESS_CACHE_ENTRY(index)->device_next;
+    } else if (Used_Count < MAX_ADDRESS_CACHE) {
+        /* never used entries follow the used ones */
+        Used_Count++;
+        index = Used_Count;
+    }
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        pMatch->Flags = flags;
+        pMatch->device_id = device_id;
+        pMatch->segmentation = SEGMENTATION_NONE;
+        pMatch->max_segments = 0;
+        pMatch->round_trip_time = 0;
+        pMatch->round_trip_variance = 0;
+        pMatch->timeout_backoff = 0;
+        pMatch->address_hashed = false;
+        pMatch->address_next = ADDRESS_CACHE_INDEX_NONE;
+        bucket = address_device_hash(device_id);
+        pMatch->device_next = Device_Hash[bucket];
+        Device_Hash[bucket] = index;
+        pMatch->lru_prev = ADDRESS_CACHE_INDEX_NONE;
+        pMatch->lru_next = ADDRESS_CACHE_INDEX_NONE;
+        address_lru_touch(index);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Rebuild the hash indexes, free list and LRU list from the
+ *  entry flags.  The free entry with the lowest index is the first free
+ *  entry to be used, and the LRU order follows the index order.
+ */
+static void address_index_rebuild(void)
+{
+    struct Address_Cache_Entry *pMatch;
+    unsigned bucket;
+    ADDRESS_CACHE_INDEX index;
+
+    for (bucket = 0; bucket < ADDRESS_CACHE_HASH_SIZE; bucket++) {
+        Device_Hash[bucket] = ADDRESS_CACHE_INDEX_NONE;
+        Address_Hash[bucket] = ADDRESS_CACHE_INDEX_NONE;
+    }
+    Free_Head = ADDRESS_CACHE_INDEX_NONE;
+    LRU_Head = ADDRESS_CACHE_INDEX_NONE;
+    LRU_Tail = ADDRESS_CACHE_INDEX_NONE;
+    Used_Count = 0;
+    for (index = MAX_ADDRESS_CACHE; index > 0; index--) {
+        if (ADDRESS_CACHE_ENTRY(index)->Flags & BAC_ADDR_IN_USE) {
+            Used_Count = index;
+            break;
+        }
+    }
+    for (index = Used_Count; index > 0; index--) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        pMatch->lru_prev = ADDRESS_CACHE_INDEX_NONE;
+        pMatch->lru_next = ADDRESS_CACHE_INDEX_NONE;
+        pMatch->address_next = ADDRESS_CACHE_INDEX_NONE;
+        pMatch->address_hashed = false;
+        if ((pMatch->Flags & BAC_ADDR_IN_USE) != 0) {
+            bucket = address_device_hash(pMatch->device_id);
+            pMatch->device_next = Device_Hash[bucket];
+            Device_Hash[bucket] = index;
+            address_lru_touch(index);
+            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+                bucket = address_mac_hash(&pMatch->address);
+                pMatch->address_next = Address_Hash[bucket];
+                Address_Hash[bucket] = index;
+                pMatch->address_hashed = true;
+            }
+        } else {
+            pMatch->Flags = 0;
+            pMatch->device_next = Free_Head;
+            Free_Head = index;
+        }
+    }
+}
+
 /**
  * @brief Set the index of the first (top) address being protected.
  *
@@ -98,18 +483,13 @@ void address_own_device_id_set(uint32_t own_id)
  */
 void address_remove_device(uint32_t device_id)
 {
-    struct Address_Cache_Entry *pMatch;
-    uint32_t index = 0;
+    ADDRESS_CACHE_INDEX index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            pMatch->Flags = 0;
-            if (index < Top_Protected_Entry) {
-                Top_Protected_Entry--;
-            }
-            break;
+    index = address_device_find(device_id);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        address_entry_release(index);
+        if ((index - 1U) < Top_Protected_Entry) {
+            Top_Protected_Entry--;
         }
     }
 
@@ -117,72 +497,71 @@ void address_remove_device(uint32_t device_id)
 }
 
 /**
- * @brief Search the cache for the entry nearest expiry and delete it. Mark the
- * entry as reserved with a 1 hour TTL and return a pointer to the reserved
- * entry. Will not delete a static entry and returns NULL pointer if no
- * entry available to free up. Does not check for free entries as it is
- * assumed we are calling this due to the lack of those.
+ * @brief Free up the least recently used entry. Will not delete a static
+ * entry and returns false if no entry available to free up. Bound entries
+ * are released before entries with a bind request outstanding. Does not
+ * check for free entries as it is assumed we are calling this due to the
+ * lack of those.
  *
- * @return Pointer to the entry that has been removed or NULL.
+ * @return true if an entry has been released to the free list.
  */
-static struct Address_Cache_Entry *address_remove_oldest(void)
+static bool address_remove_oldest(void)
 {
     struct Address_Cache_Entry *pMatch;
-    struct Address_Cache_Entry *pCandidate;
-    uint32_t ulTime;
-    unsigned index;
+    ADDRESS_CACHE_INDEX index;
 
-    pCandidate = NULL;
     if (Top_Protected_Entry > (MAX_ADDRESS_CACHE - 1)) {
-        return pCandidate;
+        return false;
     }
-    /* Longest possible non static time to live */
-    ulTime = BAC_ADDR_FOREVER - 1;
-
     /* First pass - try only in use and bound entries */
-
-    for (index = Top_Protected_Entry; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags &
-                (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
-            BAC_ADDR_IN_USE) {
-            if (pMatch->TimeToLive <= ulTime) {
-                /* Shorter lived entry found */
-                ulTime = pMatch->TimeToLive;
-                pCandidate = pMatch;
-            }
+    index = LRU_Tail;
+    while (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        if (((index - 1U) >= Top_Protected_Entry) &&
+            ((pMatch->Flags &
+                 (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
+                BAC_ADDR_IN_USE)) {
+            address_entry_release(index);
+            return true;
         }
+        index = pMatch->lru_prev;
     }
-
-    if (pCandidate != NULL) {
-        /* Found something to free up */
-        pCandidate->Flags = BAC_ADDR_RESERVED;
-        /* only reserve it for a short while */
-        pCandidate->TimeToLive = BAC_ADDR_SHORT_TIME;
-        return (pCandidate);
-    }
-
     /* Second pass - try in use and un bound as last resort */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+    index = LRU_Tail;
+    while (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
         if ((pMatch->Flags &
                 (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
             ((uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ))) {
-            if (pMatch->TimeToLive <= ulTime) { /* Shorter lived entry found */
-                ulTime = pMatch->TimeToLive;
-                pCandidate = pMatch;
-            }
+            address_entry_release(index);
+            return true;
         }
+        index = pMatch->lru_prev;
     }
 
-    if (pCandidate != NULL) {
-        /* Found something to free up */
-        pCandidate->Flags = BAC_ADDR_RESERVED;
-        /* only reserve it for a short while */
-        pCandidate->TimeToLive = BAC_ADDR_SHORT_TIME;
+    return false;
+}
+
+/**
+ * @brief Claim an entry for a device, freeing the least recently used
+ *  entry if the cache is full.
+ * @param device_id - device instance number
+ * @param flags - initial entry state flags
+ * @return entry number, or ADDRESS_CACHE_INDEX_NONE if no entry available
+ */
+static ADDRESS_CACHE_INDEX address_entry_new(uint32_t device_id, uint8_t flags)
+{
+    ADDRESS_CACHE_INDEX index;
+
+    index = address_entry_claim(device_id, flags);
+    if (index == ADDRESS_CACHE_INDEX_NONE) {
+        /* See if we can squeeze it in by dropping an existing one */
+        if (address_remove_oldest()) {
+            index = address_entry_claim(device_id, flags);
+        }
     }
 
-    return (pCandidate);
+    return index;
 }
 
 #ifdef BACNET_ADDRESS_CACHE_FILE
@@ -193,6 +572,10 @@ DeviceID MAC SNET SADR MAX-APDU
 note: useful for MS/TP Slave static binding
 */
 static const char *Address_Cache_Filename = "address_cache";
+static const char *Address_Snapshot_Filename = "address_cache.bin";
+#if BACNET_ADDRESS_SNAPSHOT_INTERVAL
+static uint32_t Address_Snapshot_Seconds;
+#endif
 
 static void address_file_init(const char *pFilename)
 {
@@ -261,7 +644,12 @@ void address_init(void)
         pMatch = &Address_Cache[index];
         pMatch->Flags = 0;
     }
+    address_index_rebuild();
+    bacnet_memstats_static(MEMSTATS_ADDRESS,
+        sizeof(Address_Cache) + sizeof(Device_Hash) + sizeof(Address_Hash));
 #ifdef BACNET_ADDRESS_CACHE_FILE
+    /* the bindings learned before a restart, then the static ones */
+    (void)address_snapshot_load(Address_Snapshot_Filename);
     address_file_init(Address_Cache_Filename);
 #endif
     return;
@@ -294,6 +682,10 @@ void address_init_partial(void)
             pMatch->Flags = 0;
         }
     }
+    /* the indexes may not have survived, so derive them from the entries */
+    address_index_rebuild();
+    bacnet_memstats_static(MEMSTATS_ADDRESS,
+        sizeof(Address_Cache) + sizeof(Device_Hash) + sizeof(Address_Hash));
 #ifdef BACNET_ADDRESS_CACHE_FILE
     address_file_init(Address_Cache_Filename);
 #endif
@@ -301,6 +693,206 @@ void address_init_partial(void)
     return;
 }
 
+/**
+ * @brief Store the segmentation supported by a device, as given in its
+ *  I-Am, for a device that is in the cache
+ * @param device_id  Device-Id
+ * @param segmentation  segmentation supported by the device
+ */
+void address_segmentation_set(
+    uint32_t device_id, BACNET_SEGMENTATION segmentation)
+{
+    ADDRESS_CACHE_INDEX index;
+
+    index = address_device_find(device_id);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        ADDRESS_CACHE_ENTRY(index)->segmentation = (uint8_t)segmentation;
+    }
+}
+
+/**
+ * @brief Get the segmentation supported by a device in the cache
+ * @param device_id  Device-Id
+ * @param segmentation [out] segmentation supported by the device,
+ *  which is SEGMENTATION_NONE until the I-Am of the device says otherwise
+ * @return true if the device is in the cache
+ */
+bool address_segmentation(
+    uint32_t device_id, BACNET_SEGMENTATION *segmentation)
+{
+    ADDRESS_CACHE_INDEX index;
+
+    index = address_device_find(device_id);
+    if (index == ADDRESS_CACHE_INDEX_NONE) {
+        return false;
+    }
+    if (segmentation) {
+        *segmentation = (BACNET_SEGMENTATION)ADDRESS_CACHE_ENTRY(index)
+                            ->segmentation;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find the bound entry of a device from its address
+ * @param src - address of the device
+ * @return entry number of the device, or ADDRESS_CACHE_INDEX_NONE
+ */
+static ADDRESS_CACHE_INDEX address_mac_find(BACNET_ADDRESS *src)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+
+    if (!src) {
+        return ADDRESS_CACHE_INDEX_NONE;
+    }
+    index = Address_Hash[address_mac_hash(src)];
+    while (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        if (((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
+                BAC_ADDR_IN_USE) &&
+            bacnet_address_same(&pMatch->address, src)) {
+            break;
+        }
+        index = pMatch->address_next;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Update the capabilities of a device in the cache from what it
+ *  sent, such as the max-APDU and max-segments of its confirmed requests
+ *  and the round trip time of its replies to our requests.
+ *  The handler can be registered with apdu_set_peer_capability_handler().
+ * @param src - address of the device
+ * @param max_apdu - max-APDU it accepts, or 0 when not known
+ * @param max_segments - max-segments it accepts, or 0 when not known
+ * @param round_trip_time - milliseconds of a round trip, or 0 when
+ *  not known
+ */
+void address_peer_capability_update(BACNET_ADDRESS *src,
+    unsigned max_apdu,
+    unsigned max_segments,
+    uint16_t round_trip_time)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+    uint16_t deviation;
+
+    index = address_mac_find(src);
+    if (index == ADDRESS_CACHE_INDEX_NONE) {
+        return;
+    }
+    pMatch = ADDRESS_CACHE_ENTRY(index);
+    /* a request may only narrow what the I-Am said */
+    if (max_apdu && ((pMatch->max_apdu == 0) ||
+        (max_apdu < pMatch->max_apdu))) {
+        pMatch->max_apdu = max_apdu;
+    }
+    if (max_segments) {
+        pMatch->max_segments =
+            (uint8_t)(max_segments > UINT8_MAX ? UINT8_MAX : max_segments);
+    }
+    if (round_trip_time) {
+        if (pMatch->round_trip_time == 0) {
+            pMatch->round_trip_time = round_trip_time;
+            pMatch->round_trip_variance = round_trip_time / 2U;
+        } else {
+            /* smoothed as in RFC 6298, with gains of 1/4 and 1/8 */
+            if (round_trip_time > pMatch->round_trip_time) {
+                deviation = round_trip_time - pMatch->round_trip_time;
+            } else {
+                deviation = pMatch->round_trip_time - round_trip_time;
+            }
+            pMatch->round_trip_variance =
+                (uint16_t)(pMatch->round_trip_variance -
+                    (pMatch->round_trip_variance / 4U) + (deviation / 4U));
+            pMatch->round_trip_time = (uint16_t)(pMatch->round_trip_time -
+                (pMatch->round_trip_time / 8U) + (round_trip_time / 8U));
+        }
+        /* a reply to a request that was sent once ends the backoff */
+        pMatch->timeout_backoff = 0;
+    }
+}
+
+/**
+ * @brief Get the APDU timeout for a confirmed request to a device, from
+ *  its smoothed round trip time and variance as the retransmission
+ *  timeout of RFC 6298, doubled for each retry and kept doubled until a
+ *  request that is sent once is answered.
+ *  The handler can be registered with tsm_set_peer_timeout_handler().
+ * @param dest - address of the device
+ * @param retry_count - number of times the request was sent again
+ * @return milliseconds to wait for the reply, or 0 when the round trip
+ *  time of the device is not known and the APDU timeout is used
+ */
+uint16_t address_apdu_timeout(BACNET_ADDRESS *dest, uint8_t retry_count)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+    uint32_t timeout;
+
+    index = address_mac_find(dest);
+    if (index == ADDRESS_CACHE_INDEX_NONE) {
+        return 0;
+    }
+    pMatch = ADDRESS_CACHE_ENTRY(index);
+    if (pMatch->round_trip_time == 0) {
+        return 0;
+    }
+    if (retry_count > ADDRESS_APDU_TIMEOUT_BACKOFF_MAX) {
+        retry_count = ADDRESS_APDU_TIMEOUT_BACKOFF_MAX;
+    }
+    if (retry_count > pMatch->timeout_backoff) {
+        pMatch->timeout_backoff = retry_count;
+    }
+    timeout = (uint32_t)pMatch->round_trip_time +
+        (4UL * pMatch->round_trip_variance);
+    if (timeout < ADDRESS_APDU_TIMEOUT_MIN) {
+        timeout = ADDRESS_APDU_TIMEOUT_MIN;
+    }
+    timeout <<= pMatch->timeout_backoff;
+    if (timeout > ADDRESS_APDU_TIMEOUT_MAX) {
+        timeout = ADDRESS_APDU_TIMEOUT_MAX;
+    }
+
+    return (uint16_t)timeout;
+}
+
+/**
+ * @brief Get the capabilities of a device in the cache, which encoders
+ *  and request planners can use to size what they send to it
+ * @param device_id - device instance number
+ * @param capability [out] capabilities of the device
+ * @return true if the device is bound in the cache
+ */
+bool address_capability(
+    uint32_t device_id, BACNET_ADDRESS_CAPABILITY *capability)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+
+    index = address_device_find(device_id);
+    if (index == ADDRESS_CACHE_INDEX_NONE) {
+        return false;
+    }
+    pMatch = ADDRESS_CACHE_ENTRY(index);
+    if (pMatch->Flags & BAC_ADDR_BIND_REQ) {
+        return false;
+    }
+    if (capability) {
+        capability->max_apdu = pMatch->max_apdu;
+        capability->segmentation = (BACNET_SEGMENTATION)pMatch->segmentation;
+        capability->max_segments = pMatch->max_segments;
+        capability->round_trip_time = pMatch->round_trip_time;
+        capability->round_trip_variance = pMatch->round_trip_variance;
+    }
+
+    return true;
+}
+
 /**
  * Set the TTL info for the given device entry. If it is a bound entry we
  * set it to static or normal and can change the TTL. If it is unbound we
@@ -315,26 +907,24 @@ void address_set_device_TTL(
     uint32_t device_id, uint32_t TimeOut, bool StaticFlag)
 {
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
-
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* If bound then we have either static or normaal */
-                if (StaticFlag) {
-                    pMatch->Flags |= BAC_ADDR_STATIC;
-                    pMatch->TimeToLive = BAC_ADDR_FOREVER;
-                } else {
-                    pMatch->Flags &= ~BAC_ADDR_STATIC;
-                    pMatch->TimeToLive = TimeOut;
-                }
+    ADDRESS_CACHE_INDEX index;
+
+    index = address_device_find(device_id);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        pMatch->Flags &= ~BAC_ADDR_REFRESH;
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* If bound then we have either static or normaal */
+            if (StaticFlag) {
+                pMatch->Flags |= BAC_ADDR_STATIC;
+                pMatch->TimeToLive = BAC_ADDR_FOREVER;
             } else {
-                /* For unbound we can only set the time to live */
+                pMatch->Flags &= ~BAC_ADDR_STATIC;
                 pMatch->TimeToLive = TimeOut;
             }
-            break; /* Exit now if found at all - bound or unbound */
+        } else {
+            /* For unbound we can only set the time to live */
+            pMatch->TimeToLive = TimeOut;
         }
     }
 }
@@ -351,23 +941,20 @@ bool address_get_by_device(
 {
     struct Address_Cache_Entry *pMatch;
     bool found = false; /* return value */
-    unsigned index;
-
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* If bound then fetch data */
-                bacnet_address_copy(src, &pMatch->address);
-                if (max_apdu) {
-                    *max_apdu = pMatch->max_apdu;
-                }
-                /* Prove we found it */
-                found = true;
+    ADDRESS_CACHE_INDEX index;
+
+    index = address_device_find(device_id);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* If bound then fetch data */
+            bacnet_address_copy(src, &pMatch->address);
+            if (max_apdu) {
+                *max_apdu = pMatch->max_apdu;
             }
-            /* Exit now if found at all - bound or unbound */
-            break;
+            address_lru_touch(index);
+            /* Prove we found it */
+            found = true;
         }
     }
 
@@ -384,43 +971,34 @@ bool address_get_by_device(
  */
 bool address_get_device_id(BACNET_ADDRESS *src, uint32_t *device_id)
 {
-    struct Address_Cache_Entry *pMatch;
-    bool found = false; /* return value */
-    unsigned index;
+    ADDRESS_CACHE_INDEX index;
 
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ)) ==
-            BAC_ADDR_IN_USE) {
-            /* If bound */
-            if (bacnet_address_same(&pMatch->address, src)) {
-                if (device_id) {
-                    *device_id = pMatch->device_id;
-                }
-                found = true;
-                break;
-            }
-        }
+    index = address_mac_find(src);
+    if (index == ADDRESS_CACHE_INDEX_NONE) {
+        return false;
+    }
+    if (device_id) {
+        *device_id = ADDRESS_CACHE_ENTRY(index)->device_id;
     }
 
-    return found;
+    return true;
 }
 
 /**
- * Add a device using the given id, max_apdu and address.
- *
- * @param device_id  Pointer to the device id variable for return.
+ * @brief Add a device using the given id, max_apdu and address
+ * @param device_id  Device-Id
  * @param max_apdu  Maximum APDU size.
  * @param src  Pointer to address structure to add.
+ * @return entry number of the device, or ADDRESS_CACHE_INDEX_NONE
  */
-void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
+static ADDRESS_CACHE_INDEX address_add_entry(
+    uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
 {
-    bool found = false; /* return value */
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
+    ADDRESS_CACHE_INDEX index;
 
     if (Own_Device_ID == device_id) {
-        return;
+        return ADDRESS_CACHE_INDEX_NONE;
     }
 
     /* Note: Previously this function would ignore bind request
@@ -430,63 +1008,81 @@ void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
        bind request if it exists */
 
     /* existing device or bind request outstanding - update address */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
+    index = address_device_find(device_id);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
         /* Device already in the list, then update the values. */
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            bacnet_address_copy(&pMatch->address, src);
-            pMatch->max_apdu = max_apdu;
-            /* Pick the right time to live */
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) {
-                /* Bind requested so long time */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            } else if ((pMatch->Flags & BAC_ADDR_STATIC) != 0) {
-                /* Static already so make sure it never expires */
-                pMatch->TimeToLive = BAC_ADDR_FOREVER;
-            } else if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
-                /* Opportunistic entry so leave on short fuse */
-                pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-            } else {
-                /* Renewing existing entry */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            }
-            /* Clear bind request flag just in case */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
-            found = true;
-            break;
+        address_mac_set(index, src);
+        pMatch->max_apdu = max_apdu;
+        /* Pick the right time to live */
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) {
+            /* Bind requested so long time */
+            pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
+        } else if ((pMatch->Flags & BAC_ADDR_STATIC) != 0) {
+            /* Static already so make sure it never expires */
+            pMatch->TimeToLive = BAC_ADDR_FOREVER;
+        } else if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
+            /* Opportunistic entry so leave on short fuse */
+            pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+        } else {
+            /* Renewing existing entry */
+            pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
         }
+        /* Clear bind request flag just in case, and the refresh
+           since the device answered */
+        pMatch->Flags &= ~(BAC_ADDR_BIND_REQ | BAC_ADDR_REFRESH);
+        address_lru_touch(index);
+        return index;
     }
-    /* New device - add to cache if there is room. */
-    if (!found) {
-        for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-            pMatch = &Address_Cache[index];
-            if ((pMatch->Flags & BAC_ADDR_IN_USE) == 0) {
-                pMatch->Flags = BAC_ADDR_IN_USE;
-                pMatch->device_id = device_id;
-                pMatch->max_apdu = max_apdu;
-                bacnet_address_copy(&pMatch->address, src);
-                /* Opportunistic entry so leave on short fuse */
-                pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-                found = true;
-                break;
-            }
-        }
+    /* New device - add to cache if there is room, or squeeze it in by
+       removing the least recently used entry. */
+    index = address_entry_new(device_id, BAC_ADDR_IN_USE);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        pMatch->max_apdu = max_apdu;
+        address_mac_set(index, src);
+        /* Opportunistic entry so leave on short fuse */
+        pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
     }
-    /* If adding has failed, see if we can squeeze it in by removed the oldest
-     * entry. */
-    if (!found) {
-        pMatch = address_remove_oldest();
-        if (pMatch != NULL) {
-            pMatch->Flags = BAC_ADDR_IN_USE;
-            pMatch->device_id = device_id;
-            pMatch->max_apdu = max_apdu;
-            bacnet_address_copy(&pMatch->address, src);
-            /* Opportunistic entry so leave on short fuse */
-            pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+
+    return index;
+}
+
+/**
+ * Add a device using the given id, max_apdu and address.
+ *
+ * @param device_id  Pointer to the device id variable for return.
+ * @param max_apdu  Maximum APDU size.
+ * @param src  Pointer to address structure to add.
+ */
+void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
+{
+    (void)address_add_entry(device_id, max_apdu, src);
+}
+
+/**
+ * @brief Add many devices at once, such as the I-Am replies heard after
+ *  a global Who-Is, along with their segmentation.  Each device is found
+ *  once, rather than once to add it and again to set its segmentation.
+ * @param list  array of devices to add
+ * @param count  number of devices in the array
+ */
+void address_add_list(BACNET_ADDRESS_BINDING_ADD *list, unsigned count)
+{
+    ADDRESS_CACHE_INDEX index;
+    unsigned i;
+
+    if (!list) {
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        index = address_add_entry(
+            list[i].device_id, list[i].max_apdu, &list[i].address);
+        if (index != ADDRESS_CACHE_INDEX_NONE) {
+            ADDRESS_CACHE_ENTRY(index)->segmentation =
+                (uint8_t)list[i].segmentation;
         }
     }
-    return;
 }
 
 /**
@@ -509,62 +1105,48 @@ bool address_device_bind_request(uint32_t device_id,
 {
     bool found = false; /* return value */
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
+    ADDRESS_CACHE_INDEX index;
 
     /* existing device - update address info if currently bound */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
-                /* Already bound */
-                found = true;
-                if (src) {
-                    bacnet_address_copy(src, &pMatch->address);
-                }
-                if (max_apdu) {
-                    *max_apdu = pMatch->max_apdu;
-                }
-                if (device_ttl) {
-                    *device_ttl = pMatch->TimeToLive;
-                }
-                if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
-                    /* Was picked up opportunistacilly */
-                    /* Convert to normal entry  */
-                    pMatch->Flags &= ~BAC_ADDR_SHORT_TTL;
-                    /* And give it a decent time to live */
-                    pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-                }
+    index = address_device_find(device_id);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+            /* Already bound */
+            found = true;
+            if (src) {
+                bacnet_address_copy(src, &pMatch->address);
+            }
+            if (max_apdu) {
+                *max_apdu = pMatch->max_apdu;
+            }
+            if (device_ttl) {
+                *device_ttl = pMatch->TimeToLive;
+            }
+            if ((pMatch->Flags & BAC_ADDR_SHORT_TTL) != 0) {
+                /* Was picked up opportunistacilly */
+                /* Convert to normal entry  */
+                pMatch->Flags &= ~BAC_ADDR_SHORT_TTL;
+                /* And give it a decent time to live */
+                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
             }
-            /* True if bound, false if bind request outstanding */
-            return (found);
-        }
-    }
-
-    /* Not there already so look for a free entry to put it in */
-    /* existing device - update address info if currently bound */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if ((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) == 0) {
-            /* In use and awaiting binding */
-            pMatch->Flags = (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
-            pMatch->device_id = device_id;
-            /* No point in leaving bind requests in for long haul */
-            pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
-            /* now would be a good time to do a Who-Is request */
-            return (false);
         }
+        address_lru_touch(index);
+        /* True if bound, false if bind request outstanding */
+        return (found);
     }
 
-    /* No free entries, See if we can squeeze it in by dropping an existing one
-     */
-    pMatch = address_remove_oldest();
-    if (pMatch != NULL) {
-        pMatch->Flags = (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ);
-        pMatch->device_id = device_id;
+    /* Not there already so look for a free entry to put it in,
+       or squeeze it in by dropping an existing one */
+    index = address_entry_new(
+        device_id, (uint8_t)(BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ));
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        /* In use and awaiting binding */
         /* No point in leaving bind requests in for long haul */
-        pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+        ADDRESS_CACHE_ENTRY(index)->TimeToLive = BAC_ADDR_SHORT_TIME;
+        /* now would be a good time to do a Who-Is request */
     }
+
     return (false);
 }
 
@@ -597,24 +1179,22 @@ void address_add_binding(
     uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
 {
     struct Address_Cache_Entry *pMatch;
-    unsigned index;
+    ADDRESS_CACHE_INDEX index;
 
     /* existing device or bind request - update address */
-    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
-        pMatch = &Address_Cache[index];
-        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
-            (pMatch->device_id == device_id)) {
-            bacnet_address_copy(&pMatch->address, src);
-            pMatch->max_apdu = max_apdu;
-            /* Clear bind request flag in case it was set */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
-            /* Only update TTL if not static */
-            if ((pMatch->Flags & BAC_ADDR_STATIC) == 0) {
-                /* and set it on a long fuse */
-                pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
-            }
-            break;
+    index = address_device_find(device_id);
+    if (index != ADDRESS_CACHE_INDEX_NONE) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        address_mac_set(index, src);
+        pMatch->max_apdu = max_apdu;
+        /* Clear bind request and refresh flags in case they were set */
+        pMatch->Flags &= ~(BAC_ADDR_BIND_REQ | BAC_ADDR_REFRESH);
+        /* Only update TTL if not static */
+        if ((pMatch->Flags & BAC_ADDR_STATIC) == 0) {
+            /* and set it on a long fuse */
+            pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
         }
+        address_lru_touch(index);
     }
     return;
 }
@@ -968,6 +1548,431 @@ int rr_address_list_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     return (iLen);
 }
 
+/* Snapshot format, with multi-octet values in big-endian order:
+header: "BACA" VERSION MAC-SIZE COUNT(4)
+record: DeviceID(4) FLAGS MAX-APDU(2) SEGMENTATION MAX-SEGMENTS RTT(2)
+        RTT-VARIANCE(2) TTL(4) MAC-LEN MAC[MAX_MAC_LEN] SNET(2)
+        SADR-LEN SADR[MAX_MAC_LEN]
+note: the time to live is what was left when the snapshot was taken
+*/
+#define ADDRESS_SNAPSHOT_VERSION 1
+#define ADDRESS_SNAPSHOT_HEADER_SIZE 10
+#define ADDRESS_SNAPSHOT_RECORD_SIZE (21 + (2 * MAX_MAC_LEN))
+
+/**
+ * @brief Determine if an entry is kept in a snapshot, which are the
+ *  bound entries that are not static, since the static entries are
+ *  given again at startup
+ * @param pMatch - entry
+ * @return true if the entry is kept in a snapshot
+ */
+static bool address_snapshot_entry(const struct Address_Cache_Entry *pMatch)
+{
+    return (pMatch->Flags &
+               (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC)) ==
+        BAC_ADDR_IN_USE;
+}
+
+/**
+ * @brief Encode the header of a snapshot
+ * @param buffer - ADDRESS_SNAPSHOT_HEADER_SIZE bytes
+ * @param count - number of records that follow
+ */
+static void address_snapshot_header_encode(uint8_t *buffer, uint32_t count)
+{
+    buffer[0] = 'B';
+    buffer[1] = 'A';
+    buffer[2] = 'C';
+    buffer[3] = 'A';
+    buffer[4] = ADDRESS_SNAPSHOT_VERSION;
+    buffer[5] = MAX_MAC_LEN;
+    (void)encode_unsigned32(&buffer[6], count);
+}
+
+/**
+ * @brief Decode the header of a snapshot
+ * @param buffer - ADDRESS_SNAPSHOT_HEADER_SIZE bytes
+ * @param count - number of records that follow
+ * @return true if the header is of a snapshot of this build
+ */
+static bool address_snapshot_header_decode(
+    uint8_t *buffer, uint32_t *count)
+{
+    if ((buffer[0] != 'B') || (buffer[1] != 'A') || (buffer[2] != 'C') ||
+        (buffer[3] != 'A') || (buffer[4] != ADDRESS_SNAPSHOT_VERSION) ||
+        (buffer[5] != MAX_MAC_LEN)) {
+        return false;
+    }
+    (void)decode_unsigned32(&buffer[6], count);
+
+    return true;
+}
+
+/**
+ * @brief Encode an entry as a record of a snapshot
+ * @param buffer - ADDRESS_SNAPSHOT_RECORD_SIZE bytes
+ * @param pMatch - entry
+ */
+static void address_snapshot_record_encode(
+    uint8_t *buffer, const struct Address_Cache_Entry *pMatch)
+{
+    const BACNET_ADDRESS *src = &pMatch->address;
+    unsigned len = 0;
+
+    len += encode_unsigned32(&buffer[len], pMatch->device_id);
+    buffer[len++] = pMatch->Flags & BAC_ADDR_SHORT_TTL;
+    len += encode_unsigned16(&buffer[len], (uint16_t)pMatch->max_apdu);
+    buffer[len++] = pMatch->segmentation;
+    buffer[len++] = pMatch->max_segments;
+    len += encode_unsigned16(&buffer[len], pMatch->round_trip_time);
+    len += encode_unsigned16(&buffer[len], pMatch->round_trip_variance);
+    len += encode_unsigned32(&buffer[len], pMatch->TimeToLive);
+    buffer[len++] = src->mac_len;
+    memcpy(&buffer[len], src->mac, MAX_MAC_LEN);
+    len += MAX_MAC_LEN;
+    len += encode_unsigned16(&buffer[len], src->net);
+    buffer[len++] = src->len;
+    memcpy(&buffer[len], src->adr, MAX_MAC_LEN);
+}
+
+/**
+ * @brief Add the entry of a record of a snapshot to the cache, unless
+ *  the device is already in the cache
+ * @param buffer - ADDRESS_SNAPSHOT_RECORD_SIZE bytes
+ * @return true if the entry was added
+ */
+static bool address_snapshot_record_decode(uint8_t *buffer)
+{
+    struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+    BACNET_ADDRESS src = { 0 };
+    uint32_t device_id = 0;
+    uint8_t flags;
+    uint16_t max_apdu = 0;
+    uint8_t segmentation;
+    uint8_t max_segments;
+    uint16_t round_trip_time = 0;
+    uint16_t round_trip_variance = 0;
+    uint32_t time_to_live = 0;
+    unsigned len = 0;
+
+    len += decode_unsigned32(&buffer[len], &device_id);
+    flags = buffer[len++];
+    len += decode_unsigned16(&buffer[len], &max_apdu);
+    segmentation = buffer[len++];
+    max_segments = buffer[len++];
+    len += decode_unsigned16(&buffer[len], &round_trip_time);
+    len += decode_unsigned16(&buffer[len], &round_trip_variance);
+    len += decode_unsigned32(&buffer[len], &time_to_live);
+    src.mac_len = buffer[len++];
+    memcpy(src.mac, &buffer[len], MAX_MAC_LEN);
+    len += MAX_MAC_LEN;
+    len += decode_unsigned16(&buffer[len], &src.net);
+    src.len = buffer[len++];
+    memcpy(src.adr, &buffer[len], MAX_MAC_LEN);
+    if ((device_id > BACNET_MAX_INSTANCE) || (src.mac_len > MAX_MAC_LEN) ||
+        (src.len > MAX_MAC_LEN) ||
+        (address_device_find(device_id) != ADDRESS_CACHE_INDEX_NONE)) {
+        return false;
+    }
+    index = address_add_entry(device_id, max_apdu, &src);
+    if (index == ADDRESS_CACHE_INDEX_NONE) {
+        return false;
+    }
+    pMatch = ADDRESS_CACHE_ENTRY(index);
+    pMatch->Flags = BAC_ADDR_IN_USE | (flags & BAC_ADDR_SHORT_TTL);
+    pMatch->segmentation = segmentation;
+    pMatch->max_segments = max_segments;
+    pMatch->round_trip_time = round_trip_time;
+    pMatch->round_trip_variance = round_trip_variance;
+    pMatch->TimeToLive = time_to_live;
+
+    return true;
+}
+
+/**
+ * @brief Get the number of bytes of a snapshot of the cache
+ * @return number of bytes that address_snapshot_encode() needs
+ */
+size_t address_snapshot_size(void)
+{
+    size_t count = 0;
+    ADDRESS_CACHE_INDEX index;
+
+    for (index = 1; index <= Used_Count; index++) {
+        if (address_snapshot_entry(ADDRESS_CACHE_ENTRY(index))) {
+            count++;
+        }
+    }
+
+    return ADDRESS_SNAPSHOT_HEADER_SIZE +
+        (count * ADDRESS_SNAPSHOT_RECORD_SIZE);
+}
+
+/**
+ * @brief Encode a binary snapshot of the bound entries of the cache,
+ *  with their peer capabilities and their time to live, so that they
+ *  can be restored after a restart without binding again
+ * @param buffer - buffer to hold the snapshot
+ * @param buffer_size - number of bytes of the buffer
+ * @return number of bytes encoded, or 0 if the buffer is too small
+ */
+size_t address_snapshot_encode(uint8_t *buffer, size_t buffer_size)
+{
+    size_t len = ADDRESS_SNAPSHOT_HEADER_SIZE;
+    const struct Address_Cache_Entry *pMatch;
+    ADDRESS_CACHE_INDEX index;
+    uint32_t count = 0;
+
+    if (!buffer || (buffer_size < address_snapshot_size())) {
+        return 0;
+    }
+    for (index = 1; index <= Used_Count; index++) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        if (address_snapshot_entry(pMatch)) {
+            address_snapshot_record_encode(&buffer[len], pMatch);
+            len += ADDRESS_SNAPSHOT_RECORD_SIZE;
+            count++;
+        }
+    }
+    address_snapshot_header_encode(buffer, count);
+
+    return len;
+}
+
+/**
+ * @brief Add the entries of a binary snapshot to the cache. Devices that
+ *  are already in the cache keep their entries.
+ * @param buffer - the snapshot
+ * @param buffer_len - number of bytes of the snapshot
+ * @return number of entries added
+ */
+unsigned address_snapshot_decode(uint8_t *buffer, size_t buffer_len)
+{
+    unsigned added = 0;
+    uint32_t count = 0;
+    uint32_t i;
+
+    if (!buffer || (buffer_len < ADDRESS_SNAPSHOT_HEADER_SIZE) ||
+        !address_snapshot_header_decode(buffer, &count)) {
+        return 0;
+    }
+    buffer += ADDRESS_SNAPSHOT_HEADER_SIZE;
+    buffer_len -= ADDRESS_SNAPSHOT_HEADER_SIZE;
+    for (i = 0; i < count; i++) {
+        if (buffer_len < ADDRESS_SNAPSHOT_RECORD_SIZE) {
+            break;
+        }
+        if (address_snapshot_record_decode(buffer)) {
+            added++;
+        }
+        buffer += ADDRESS_SNAPSHOT_RECORD_SIZE;
+        buffer_len -= ADDRESS_SNAPSHOT_RECORD_SIZE;
+    }
+
+    return added;
+}
+
+#ifdef BACNET_ADDRESS_CACHE_FILE
+/**
+ * @brief Save a binary snapshot of the cache to a file. The snapshot is
+ *  written to a temporary file that then replaces the file, so that a
+ *  restart during the save leaves the previous snapshot.
+ * @param pathname - name of the file
+ * @return true if the snapshot was saved
+ */
+bool address_snapshot_save(const char *pathname)
+{
+    uint8_t record[ADDRESS_SNAPSHOT_RECORD_SIZE];
+    const struct Address_Cache_Entry *pMatch;
+    char temp_pathname[256];
+    ADDRESS_CACHE_INDEX index;
+    uint32_t count = 0;
+    FILE *pFile = NULL;
+    bool status = true;
+    int len;
+
+    len = snprintf(temp_pathname, sizeof(temp_pathname), "%s.tmp", pathname);
+    if ((len < 0) || ((size_t)len >= sizeof(temp_pathname))) {
+        return false;
+    }
+    pFile = fopen(temp_pathname, "wb");
+    if (!pFile) {
+        return false;
+    }
+    /* the count is known after the records, so it is written last */
+    address_snapshot_header_encode(record, 0);
+    if (fwrite(record, ADDRESS_SNAPSHOT_HEADER_SIZE, 1, pFile) != 1) {
+        status = false;
+    }
+    for (index = 1; status && (index <= Used_Count); index++) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        if (address_snapshot_entry(pMatch)) {
+            address_snapshot_record_encode(record, pMatch);
+            if (fwrite(record, sizeof(record), 1, pFile) != 1) {
+                status = false;
+            }
+            count++;
+        }
+    }
+    if (status) {
+        address_snapshot_header_encode(record, count);
+        if ((fseek(pFile, 0L, SEEK_SET) != 0) ||
+            (fwrite(record, ADDRESS_SNAPSHOT_HEADER_SIZE, 1, pFile) != 1)) {
+            status = false;
+        }
+    }
+    if (fclose(pFile) != 0) {
+        status = false;
+    }
+    if (status) {
+#if defined(_WIN32)
+        /* rename does not replace a file on Windows */
+        (void)remove(pathname);
+#endif
+        if (rename(temp_pathname, pathname) != 0) {
+            status = false;
+        }
+    }
+    if (!status) {
+        (void)remove(temp_pathname);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Load a binary snapshot of the cache from a file, from a memory
+ *  map of the file where it is supported
+ * @param pathname - name of the file
+ * @return number of entries added
+ */
+unsigned address_snapshot_load(const char *pathname)
+{
+    unsigned added = 0;
+    FILE *pFile = NULL;
+#if BACNET_ADDRESS_SNAPSHOT_MMAP
+    struct stat file_stat;
+    void *map;
+#else
+    uint8_t record[ADDRESS_SNAPSHOT_RECORD_SIZE];
+    uint32_t count = 0;
+    uint32_t i;
+#endif
+
+    pFile = fopen(pathname, "rb");
+    if (!pFile) {
+        return 0;
+    }
+#if BACNET_ADDRESS_SNAPSHOT_MMAP
+    if ((fstat(fileno(pFile), &file_stat) == 0) &&
+        (file_stat.st_size >= ADDRESS_SNAPSHOT_HEADER_SIZE)) {
+        /* a private map, since the decoders take a writable buffer */
+        map = mmap(NULL, (size_t)file_stat.st_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE, fileno(pFile), 0);
+        if (map != MAP_FAILED) {
+            added = address_snapshot_decode(
+                (uint8_t *)map, (size_t)file_stat.st_size);
+            (void)munmap(map, (size_t)file_stat.st_size);
+        }
+    }
+#else
+    if ((fread(record, ADDRESS_SNAPSHOT_HEADER_SIZE, 1, pFile) == 1) &&
+        address_snapshot_header_decode(record, &count)) {
+        for (i = 0; i < count; i++) {
+            if (fread(record, sizeof(record), 1, pFile) != 1) {
+                break;
+            }
+            if (address_snapshot_record_decode(record)) {
+                added++;
+            }
+        }
+    }
+#endif
+    fclose(pFile);
+
+    return added;
+}
+#endif
+
+/**
+ * @brief Set the function that sends a Who-Is for the entries that are
+ *  about to expire, which enables their refresh
+ * @param callback - function that sends a Who-Is, or NULL to let the
+ *  entries expire
+ */
+void address_refresh_callback_set(address_refresh_callback_t callback)
+{
+    Address_Refresh_Callback = callback;
+}
+
+/**
+ * @brief Ask again the devices of the bound entries that expire within
+ *  ADDRESS_REFRESH_TIME, so that their I-Am renews the entries. The
+ *  entries of a network that have device-ids close together are asked
+ *  with one Who-Is range to the network, and an entry alone is asked
+ *  with a Who-Is to its address. An entry that is not renewed expires
+ *  as before.
+ */
+static void address_refresh(void)
+{
+    ADDRESS_CACHE_INDEX batch[ADDRESS_REFRESH_BATCH];
+    struct Address_Cache_Entry *pMatch;
+    struct Address_Cache_Entry *pLast;
+    ADDRESS_CACHE_INDEX index;
+    BACNET_ADDRESS dest;
+    unsigned count = 0;
+    unsigned i;
+    unsigned j;
+
+    for (index = 1; (index <= Used_Count) && (count < ADDRESS_REFRESH_BATCH);
+         index++) {
+        pMatch = ADDRESS_CACHE_ENTRY(index);
+        /* bound entries that were not picked up opportunistically */
+        if (((pMatch->Flags &
+                 (BAC_ADDR_IN_USE | BAC_ADDR_BIND_REQ | BAC_ADDR_STATIC |
+                     BAC_ADDR_SHORT_TTL | BAC_ADDR_REFRESH)) ==
+                BAC_ADDR_IN_USE) &&
+            (pMatch->TimeToLive <= ADDRESS_REFRESH_TIME)) {
+            pMatch->Flags |= BAC_ADDR_REFRESH;
+            /* sorted by network, then by device-id */
+            for (i = count; i > 0; i--) {
+                pLast = ADDRESS_CACHE_ENTRY(batch[i - 1]);
+                if ((pLast->address.net < pMatch->address.net) ||
+                    ((pLast->address.net == pMatch->address.net) &&
+                        (pLast->device_id < pMatch->device_id))) {
+                    break;
+                }
+                batch[i] = batch[i - 1];
+            }
+            batch[i] = index;
+            count++;
+        }
+    }
+    for (i = 0; i < count; i = j) {
+        pMatch = ADDRESS_CACHE_ENTRY(batch[i]);
+        pLast = pMatch;
+        for (j = i + 1; j < count; j++) {
+            if ((ADDRESS_CACHE_ENTRY(batch[j])->address.net !=
+                    pLast->address.net) ||
+                ((ADDRESS_CACHE_ENTRY(batch[j])->device_id -
+                     pLast->device_id) > (ADDRESS_REFRESH_GAP + 1))) {
+                break;
+            }
+            pLast = ADDRESS_CACHE_ENTRY(batch[j]);
+        }
+        bacnet_address_copy(&dest, &pMatch->address);
+        if (pLast != pMatch) {
+            /* a broadcast on the network, through its router */
+            dest.len = 0;
+            if (dest.net == 0) {
+                dest.mac_len = 0;
+            }
+        }
+        Address_Refresh_Callback(&dest, pMatch->device_id, pLast->device_id);
+    }
+}
+
 /**
  * Scan the cache and eliminate any expired entries. Should be called
  * periodically to ensure the cache is managed correctly. If this function
@@ -991,8 +1996,18 @@ void address_cache_timer(uint16_t uSeconds)
             if (pMatch->TimeToLive >= uSeconds) {
                 pMatch->TimeToLive -= uSeconds;
             } else {
-                pMatch->Flags = 0;
+                address_entry_release((ADDRESS_CACHE_INDEX)(index + 1));
             }
         }
     }
+    if (Address_Refresh_Callback) {
+        address_refresh();
+    }
+#if defined(BACNET_ADDRESS_CACHE_FILE) && BACNET_ADDRESS_SNAPSHOT_INTERVAL
+    Address_Snapshot_Seconds += uSeconds;
+    if (Address_Snapshot_Seconds >= BACNET_ADDRESS_SNAPSHOT_INTERVAL) {
+        Address_Snapshot_Seconds = 0;
+        (void)address_snapshot_save(Address_Snapshot_Filename);
+    }
+#endif
 }
@@ -22,6 +22,34 @@
 #define address_mac_from_ascii(m,a) bacnet_address_mac_from_ascii(m,a)
 #define address_match(d,s) bacnet_address_same(d,s)
 
+/* a device heard in an I-Am, for adding many devices at once */
+typedef struct BACnet_Address_Binding_Add {
+    uint32_t device_id;
+    unsigned max_apdu;
+    BACNET_SEGMENTATION segmentation;
+    BACNET_ADDRESS address;
+} BACNET_ADDRESS_BINDING_ADD;
+
+/* what a device in the cache can take, for sizing what is sent to it */
+typedef struct BACnet_Address_Capability {
+    /* max-APDU from its I-Am, narrowed by its own requests */
+    unsigned max_apdu;
+    /* segmentation supported, from its I-Am */
+    BACNET_SEGMENTATION segmentation;
+    /* max-segments accepted, from its requests, or 0 when not known */
+    unsigned max_segments;
+    /* smoothed round trip time in milliseconds, or 0 when not known */
+    uint16_t round_trip_time;
+    /* smoothed mean deviation of the round trip time in milliseconds */
+    uint16_t round_trip_variance;
+} BACNET_ADDRESS_CAPABILITY;
+
+/* sends a Who-Is for the devices from low_limit to high_limit that are
+   about to expire in the cache, to a device, or to a network when
+   the address length is 0 */
+typedef void (*address_refresh_callback_t)(
+    BACNET_ADDRESS *dest, uint32_t low_limit, uint32_t high_limit);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -39,6 +67,10 @@ extern "C" {
         uint32_t device_id,
         unsigned max_apdu,
         BACNET_ADDRESS * src);
+    BACNET_STACK_EXPORT
+    void address_add_list(
+        BACNET_ADDRESS_BINDING_ADD * list,
+        unsigned count);
 
     BACNET_STACK_EXPORT
     void address_remove_device(
@@ -103,6 +135,29 @@ extern "C" {
         uint8_t * apdu,
         BACNET_READ_RANGE_DATA * pRequest);
 
+    BACNET_STACK_EXPORT
+    void address_segmentation_set(
+        uint32_t device_id,
+        BACNET_SEGMENTATION segmentation);
+    BACNET_STACK_EXPORT
+    bool address_segmentation(
+        uint32_t device_id,
+        BACNET_SEGMENTATION *segmentation);
+    BACNET_STACK_EXPORT
+    void address_peer_capability_update(
+        BACNET_ADDRESS *src,
+        unsigned max_apdu,
+        unsigned max_segments,
+        uint16_t round_trip_time);
+    BACNET_STACK_EXPORT
+    uint16_t address_apdu_timeout(
+        BACNET_ADDRESS *dest,
+        uint8_t retry_count);
+    BACNET_STACK_EXPORT
+    bool address_capability(
+        uint32_t device_id,
+        BACNET_ADDRESS_CAPABILITY *capability);
+
     BACNET_STACK_EXPORT
     void address_set_device_TTL(
         uint32_t device_id,
@@ -113,6 +168,28 @@ extern "C" {
     void address_cache_timer(
         uint16_t uSeconds);
 
+    BACNET_STACK_EXPORT
+    void address_refresh_callback_set(
+        address_refresh_callback_t callback);
+
+    BACNET_STACK_EXPORT
+    size_t address_snapshot_size(
+        void);
+    BACNET_STACK_EXPORT
+    size_t address_snapshot_encode(
+        uint8_t *buffer,
+        size_t buffer_size);
+    BACNET_STACK_EXPORT
+    unsigned address_snapshot_decode(
+        uint8_t *buffer,
+        size_t buffer_len);
+    BACNET_STACK_EXPORT
+    bool address_snapshot_save(
+        const char *pathname);
+    BACNET_STACK_EXPORT
+    unsigned address_snapshot_load(
+        const char *pathname);
+
     BACNET_STACK_EXPORT
     void address_protected_entry_index_set(uint32_t top_protected_entry_index);
     BACNET_STACK_EXPORT
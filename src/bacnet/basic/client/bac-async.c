@@ -0,0 +1,1048 @@
+/**
+ * @file
+ * @brief Read and write properties of other BACnet devices, read many
+ *  properties of an object, and subscribe to COV, without blocking.
+ *  Each request has a handle, and many requests can be in
+ *  flight at once, correlated with their replies by the invokeID from
+ *  the TSM. A request completes through its own callback, or when made
+ *  without a callback, through a result that is taken with its handle.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/abort.h"
+#include "bacnet/apdu.h"
+#include "bacnet/cov.h"
+#include "bacnet/reject.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/static_pool.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+/* me */
+#include "bacnet/basic/client/bac-async.h"
+
+/* timer for address cache */
+static struct mstimer Cache_Timer;
+#define CACHE_CYCLE_SECONDS 60
+
+/* states of a request */
+typedef enum {
+    BACNET_ASYNC_STATE_FREE = 0,
+    BACNET_ASYNC_STATE_SEND,
+    BACNET_ASYNC_STATE_BINDING,
+    BACNET_ASYNC_STATE_WAITING,
+    BACNET_ASYNC_STATE_DONE
+} BACNET_ASYNC_STATE;
+
+/* a request that is waiting, in flight, or holding its result */
+struct bacnet_async_request {
+    BACNET_ASYNC_HANDLE handle;
+    BACNET_ASYNC_STATE state;
+    /* the confirmed service of the request */
+    BACNET_CONFIRMED_SERVICE service;
+    uint8_t invoke_id;
+    uint8_t priority;
+    uint32_t device_id;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    /* the value to write, or the result of a read without a callback */
+    BACNET_APPLICATION_DATA_VALUE *value;
+    /* the properties of a ReadPropertyMultiple, linked in order */
+    BACNET_PROPERTY_REFERENCE *property_list;
+    /* the value and the properties belong to the caller */
+    bool referenced;
+    /* the subscription of a SubscribeCOV or SubscribeCOVProperty */
+    uint32_t process_id;
+    uint32_t lifetime;
+    bool confirmed;
+    bool cancellation;
+    bool cov_increment_present;
+    float cov_increment;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+    bacnet_async_callback_t callback;
+    void *context;
+    /* time to wait for the device to be bound */
+    struct mstimer bind_timer;
+    BACNET_ADDRESS address;
+};
+
+static struct bacnet_async_request Async_Request[BACNET_ASYNC_REQUESTS_MAX];
+static unsigned Async_Request_Count;
+/* changes for each new request, so that an old handle is not reused */
+static uint32_t Async_Sequence;
+/* the index of the request in flight with each invokeID, plus one */
+static uint16_t Async_Invoke[256];
+/* local storage - keeps it off the c-stack */
+static BACNET_APPLICATION_DATA_VALUE Async_Value;
+static uint8_t Async_RPM_Buffer[MAX_PDU];
+
+/**
+ * @brief Find the request of a handle
+ * @param handle [in] handle of the request
+ * @return the request, or NULL if the handle is not known
+ */
+static struct bacnet_async_request *
+bacnet_async_request_find(BACNET_ASYNC_HANDLE handle)
+{
+    struct bacnet_async_request *request;
+
+    if (handle == BACNET_ASYNC_HANDLE_NONE) {
+        return NULL;
+    }
+    request = &Async_Request[(handle - 1) % BACNET_ASYNC_REQUESTS_MAX];
+    if ((request->state == BACNET_ASYNC_STATE_FREE) ||
+        (request->handle != handle)) {
+        return NULL;
+    }
+
+    return request;
+}
+
+/**
+ * @brief Find the request in flight that matches a reply
+ * @param src [in] BACNET_ADDRESS of the source of the reply
+ * @param invoke_id [in] the invokeID of the reply
+ * @return the request, or NULL if not found
+ */
+static struct bacnet_async_request *
+bacnet_async_invoke_find(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    struct bacnet_async_request *request;
+    uint16_t index;
+
+    index = Async_Invoke[invoke_id];
+    if (index == 0) {
+        return NULL;
+    }
+    request = &Async_Request[index - 1];
+    if ((request->state != BACNET_ASYNC_STATE_WAITING) ||
+        (request->invoke_id != invoke_id) ||
+        !address_match(&request->address, src)) {
+        return NULL;
+    }
+
+    return request;
+}
+
+/**
+ * @brief Release the value and the properties of a request, which are
+ *  freed unless they belong to the caller
+ * @param request [in] the request
+ */
+static void bacnet_async_request_release(struct bacnet_async_request *request)
+{
+    if (!request->referenced) {
+        bacnet_free(request->value);
+        bacnet_free(request->property_list);
+    }
+    request->value = NULL;
+    request->property_list = NULL;
+    request->referenced = false;
+}
+
+/**
+ * @brief Free a request
+ * @param request [in] the request
+ */
+static void bacnet_async_request_free(struct bacnet_async_request *request)
+{
+    if (request->invoke_id) {
+        Async_Invoke[request->invoke_id] = 0;
+        request->invoke_id = 0;
+    }
+    bacnet_async_request_release(request);
+    request->state = BACNET_ASYNC_STATE_FREE;
+    Async_Request_Count--;
+}
+
+/**
+ * @brief Complete a request through its callback, or keep its result
+ *  until it is taken when it has no callback
+ * @param request [in] the request
+ * @param rp_data [in] the result of the request
+ * @param value [in] the first decoded value of a read, or NULL
+ */
+static void bacnet_async_request_complete(struct bacnet_async_request *request,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    bacnet_async_callback_t callback = request->callback;
+    BACNET_ASYNC_HANDLE handle = request->handle;
+    uint32_t device_id = request->device_id;
+    void *context = request->context;
+
+    if (request->invoke_id) {
+        Async_Invoke[request->invoke_id] = 0;
+        request->invoke_id = 0;
+    }
+    if (callback) {
+        /* free first, so that the callback can make new requests */
+        bacnet_async_request_free(request);
+        callback(handle, device_id, rp_data, value, context);
+        return;
+    }
+    bacnet_async_request_release(request);
+    if (value) {
+        request->value = bacnet_malloc(sizeof(BACNET_APPLICATION_DATA_VALUE));
+        if (request->value) {
+            memcpy(request->value, value, sizeof(*request->value));
+        } else {
+            rp_data->error_class = ERROR_CLASS_RESOURCES;
+            rp_data->error_code = ERROR_CODE_NO_SPACE_FOR_OBJECT;
+        }
+    }
+    request->error_class = rp_data->error_class;
+    request->error_code = rp_data->error_code;
+    request->state = BACNET_ASYNC_STATE_DONE;
+}
+
+/**
+ * @brief Complete a request without a value, such as with an error
+ * @param request [in] the request
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void bacnet_async_request_finish(struct bacnet_async_request *request,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    rp_data.object_type = request->object_type;
+    rp_data.object_instance = request->object_instance;
+    rp_data.object_property = request->object_property;
+    rp_data.array_index = request->array_index;
+    rp_data.error_class = error_class;
+    rp_data.error_code = error_code;
+    bacnet_async_request_complete(request, &rp_data, NULL);
+}
+
+/** Handler for a ReadProperty ACK.
+ *  Completes the matching request with the decoded value.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ * decoded from the APDU header of this message.
+ */
+static void My_Read_Property_Ack_Handler(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
+{
+    struct bacnet_async_request *request;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE *value = NULL;
+    int len;
+
+    request = bacnet_async_invoke_find(src, service_data->invoke_id);
+    if (!request) {
+        return;
+    }
+    len =
+        rp_ack_decode_service_request(service_request, service_len, &rp_data);
+    if (len < 0) {
+        bacnet_async_request_finish(
+            request, ERROR_CLASS_SERVICES, ERROR_CODE_INTERNAL_ERROR);
+        return;
+    }
+    len = bacapp_decode_known_property(rp_data.application_data,
+        (unsigned)rp_data.application_data_len, &Async_Value,
+        rp_data.object_type, rp_data.object_property);
+    if (len > 0) {
+        value = &Async_Value;
+    }
+    rp_data.error_class = ERROR_CLASS_SERVICES;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    bacnet_async_request_complete(request, &rp_data, value);
+}
+
+/** Handler for a WriteProperty or SubscribeCOV Simple ACK.
+ *  Completes the matching request.
+ *
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID of the acknowledged message
+ */
+static void MyWritePropertySimpleAckHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_invoke_find(src, invoke_id);
+    if (request) {
+        bacnet_async_request_finish(
+            request, ERROR_CLASS_SERVICES, ERROR_CODE_SUCCESS);
+    }
+}
+
+/** Handler for a ReadPropertyMultiple ACK.
+ *  Completes the matching request with the encoded results, which are
+ *  given to the callback without being decoded.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ * decoded from the APDU header of this message.
+ */
+static void My_Read_Property_Multiple_Ack_Handler(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
+{
+    struct bacnet_async_request *request;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    request = bacnet_async_invoke_find(src, service_data->invoke_id);
+    if (!request) {
+        return;
+    }
+    rp_data.object_type = request->object_type;
+    rp_data.object_instance = request->object_instance;
+    rp_data.object_property = request->object_property;
+    rp_data.array_index = request->array_index;
+    rp_data.application_data = service_request;
+    rp_data.application_data_len = service_len;
+    rp_data.error_class = ERROR_CLASS_SERVICES;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    bacnet_async_request_complete(request, &rp_data, NULL);
+}
+
+/**
+ * @brief Handler for an Error PDU.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void MyErrorHandler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_invoke_find(src, invoke_id);
+    if (request) {
+        bacnet_async_request_finish(request, error_class, error_code);
+    }
+}
+
+/**
+ * @brief Handler for an Abort PDU.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param abort_reason [in] the reason for the message abort
+ * @param server
+ */
+static void MyAbortHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
+{
+    struct bacnet_async_request *request;
+
+    (void)server;
+    request = bacnet_async_invoke_find(src, invoke_id);
+    if (request) {
+        bacnet_async_request_finish(request, ERROR_CLASS_SERVICES,
+            abort_convert_to_error_code(abort_reason));
+    }
+}
+
+/**
+ * @brief Handler for a Reject PDU.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param reject_reason [in] the reason for the rejection
+ */
+static void MyRejectHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_invoke_find(src, invoke_id);
+    if (request) {
+        bacnet_async_request_finish(request, ERROR_CLASS_SERVICES,
+            reject_convert_to_error_code(reject_reason));
+    }
+}
+
+/**
+ * @brief Determine if another request is already binding to a device,
+ *  so that only one Who-Is is sent for each device
+ * @param device_id [in] device instance number
+ * @return true if a request is binding to the device
+ */
+static bool bacnet_async_device_binding(uint32_t device_id)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_ASYNC_REQUESTS_MAX; i++) {
+        if ((Async_Request[i].state == BACNET_ASYNC_STATE_BINDING) &&
+            (Async_Request[i].device_id == device_id)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Send a request once its device is bound
+ * @param request [in] the request
+ * @return false if no more requests can be sent now
+ */
+static bool bacnet_async_request_send(struct bacnet_async_request *request)
+{
+    BACNET_READ_ACCESS_DATA read_access_data = { 0 };
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    unsigned max_apdu = 0;
+    uint8_t invoke_id;
+
+    if (!address_bind_request(
+            request->device_id, &max_apdu, &request->address)) {
+        if (request->state == BACNET_ASYNC_STATE_SEND) {
+            if (!bacnet_async_device_binding(request->device_id)) {
+                Send_WhoIs(request->device_id, request->device_id);
+            }
+            mstimer_set(&request->bind_timer, apdu_timeout());
+            request->state = BACNET_ASYNC_STATE_BINDING;
+        } else if (mstimer_expired(&request->bind_timer)) {
+            /* unable to bind within APDU timeout */
+            bacnet_async_request_finish(
+                request, ERROR_CLASS_SERVICES, ERROR_CODE_TIMEOUT);
+        }
+        return true;
+    }
+    if (!tsm_transaction_available()) {
+        return false;
+    }
+    switch (request->service) {
+        case SERVICE_CONFIRMED_WRITE_PROPERTY:
+            invoke_id = Send_Write_Property_Request(request->device_id,
+                request->object_type, request->object_instance,
+                request->object_property, request->value, request->priority,
+                request->array_index);
+            break;
+        case SERVICE_CONFIRMED_READ_PROP_MULTIPLE:
+            read_access_data.object_type = request->object_type;
+            read_access_data.object_instance = request->object_instance;
+            read_access_data.listOfProperties = request->property_list;
+            invoke_id = Send_Read_Property_Multiple_Request(Async_RPM_Buffer,
+                sizeof(Async_RPM_Buffer), request->device_id,
+                &read_access_data);
+            break;
+        case SERVICE_CONFIRMED_SUBSCRIBE_COV:
+        case SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY:
+            cov_data.subscriberProcessIdentifier = request->process_id;
+            cov_data.monitoredObjectIdentifier.type = request->object_type;
+            cov_data.monitoredObjectIdentifier.instance =
+                request->object_instance;
+            cov_data.cancellationRequest = request->cancellation;
+            cov_data.issueConfirmedNotifications = request->confirmed;
+            cov_data.lifetime = request->lifetime;
+            if (request->service == SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY) {
+                cov_data.covSubscribeToProperty = true;
+                cov_data.monitoredProperty.propertyIdentifier =
+                    request->object_property;
+                cov_data.monitoredProperty.propertyArrayIndex =
+                    request->array_index;
+                cov_data.covIncrementPresent = request->cov_increment_present;
+                cov_data.covIncrement = request->cov_increment;
+            }
+            invoke_id = Send_COV_Subscribe(request->device_id, &cov_data);
+            break;
+        default:
+            invoke_id = Send_Read_Property_Request(request->device_id,
+                request->object_type, request->object_instance,
+                request->object_property, request->array_index);
+            break;
+    }
+    if (invoke_id == 0) {
+        /* no invokeID available: try again later */
+        return false;
+    }
+    request->invoke_id = invoke_id;
+    Async_Invoke[invoke_id] = (uint16_t)(request - Async_Request) + 1;
+    request->state = BACNET_ASYNC_STATE_WAITING;
+
+    return true;
+}
+
+/**
+ * @brief Add a request
+ * @param device_id [in] device instance number
+ * @return the request, or NULL if there is no room
+ */
+static struct bacnet_async_request *bacnet_async_request_add(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request = NULL;
+    uint32_t index;
+
+    if (device_id >= BACNET_MAX_INSTANCE) {
+        return NULL;
+    }
+    if (Async_Request_Count >= BACNET_ASYNC_REQUESTS_MAX) {
+        return NULL;
+    }
+    for (index = 0; index < BACNET_ASYNC_REQUESTS_MAX; index++) {
+        if (Async_Request[index].state == BACNET_ASYNC_STATE_FREE) {
+            request = &Async_Request[index];
+            break;
+        }
+    }
+    if (!request) {
+        return NULL;
+    }
+    Async_Sequence++;
+    if (Async_Sequence >= (UINT32_MAX / BACNET_ASYNC_REQUESTS_MAX)) {
+        Async_Sequence = 0;
+    }
+    request->handle = (Async_Sequence * BACNET_ASYNC_REQUESTS_MAX) + index + 1;
+    request->state = BACNET_ASYNC_STATE_SEND;
+    request->service = SERVICE_CONFIRMED_READ_PROPERTY;
+    request->invoke_id = 0;
+    request->priority = BACNET_NO_PRIORITY;
+    request->device_id = device_id;
+    request->object_type = object_type;
+    request->object_instance = object_instance;
+    request->object_property = object_property;
+    request->array_index = array_index;
+    request->value = NULL;
+    request->property_list = NULL;
+    request->referenced = false;
+    request->process_id = 0;
+    request->lifetime = 0;
+    request->confirmed = false;
+    request->cancellation = false;
+    request->cov_increment_present = false;
+    request->cov_increment = 0.0f;
+    request->error_class = ERROR_CLASS_SERVICES;
+    request->error_code = ERROR_CODE_SUCCESS;
+    request->callback = callback;
+    request->context = context;
+    Async_Request_Count++;
+
+    return request;
+}
+
+/**
+ * @brief Read a property of a remote device without blocking
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read.
+ * @param array_index - Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @param callback - called when the read completes, or NULL to take the
+ *  result with bacnet_async_result()
+ * @param context - given to the callback
+ * @return handle of the request, or BACNET_ASYNC_HANDLE_NONE if there
+ *  is no room for the request
+ */
+BACNET_ASYNC_HANDLE bacnet_async_read_property(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_request_add(device_id, object_type,
+        object_instance, object_property, array_index, callback, context);
+    if (!request) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+
+    return request->handle;
+}
+
+/**
+ * @brief Write a property of a remote device without blocking
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be written.
+ * @param object_instance - Instance # of the object to be written.
+ * @param object_property - Property to be written.
+ * @param value - the value to write, which is copied
+ * @param priority - BACnet priority 1..16, or BACNET_NO_PRIORITY
+ * @param array_index - array index of the property, or BACNET_ARRAY_ALL
+ * @param callback - called when the write completes, or NULL to take the
+ *  result with bacnet_async_result()
+ * @param context - given to the callback
+ * @return handle of the request, or BACNET_ASYNC_HANDLE_NONE if there
+ *  is no room for the request
+ */
+BACNET_ASYNC_HANDLE bacnet_async_write_property(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    BACNET_ARRAY_INDEX array_index,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request;
+
+    if (!value) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request = bacnet_async_request_add(device_id, object_type,
+        object_instance, object_property, array_index, callback, context);
+    if (!request) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request->value = bacnet_malloc(sizeof(BACNET_APPLICATION_DATA_VALUE));
+    if (!request->value) {
+        bacnet_async_request_free(request);
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    memcpy(request->value, value, sizeof(BACNET_APPLICATION_DATA_VALUE));
+    request->service = SERVICE_CONFIRMED_WRITE_PROPERTY;
+    request->priority = priority;
+
+    return request->handle;
+}
+
+/**
+ * @brief Write a property of a remote device without blocking, and
+ *  without a copy of the value
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be written.
+ * @param object_instance - Instance # of the object to be written.
+ * @param object_property - Property to be written.
+ * @param value - the value to write, which is kept unchanged by the
+ *  caller until the request completes or is cancelled
+ * @param priority - BACnet priority 1..16, or BACNET_NO_PRIORITY
+ * @param array_index - array index of the property, or BACNET_ARRAY_ALL
+ * @param callback - called when the write completes, or NULL to take the
+ *  result with bacnet_async_result()
+ * @param context - given to the callback
+ * @return handle of the request, or BACNET_ASYNC_HANDLE_NONE if there
+ *  is no room for the request
+ */
+BACNET_ASYNC_HANDLE bacnet_async_write_property_ref(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    BACNET_ARRAY_INDEX array_index,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request;
+
+    if (!value) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request = bacnet_async_request_add(device_id, object_type,
+        object_instance, object_property, array_index, callback, context);
+    if (!request) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request->value = value;
+    request->referenced = true;
+    request->service = SERVICE_CONFIRMED_WRITE_PROPERTY;
+    request->priority = priority;
+
+    return request->handle;
+}
+
+/**
+ * @brief Read many properties of an object of a remote device with one
+ *  ReadPropertyMultiple request, without blocking
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose properties are read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param properties - the properties to read, which are copied
+ * @param count - number of properties, at least one
+ * @param callback - called when the read completes, with the first
+ *  property in rp_data, and the encoded results of the ACK in its
+ *  application_data, or NULL to take the result with
+ *  bacnet_async_result(), which has no value
+ * @param context - given to the callback
+ * @return handle of the request, or BACNET_ASYNC_HANDLE_NONE if there
+ *  is no room for the request
+ */
+BACNET_ASYNC_HANDLE bacnet_async_read_property_multiple(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    const BACNET_PROPERTY_ID *properties,
+    unsigned count,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request;
+    unsigned i;
+
+    if (!properties || (count == 0)) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request = bacnet_async_request_add(device_id, object_type,
+        object_instance, properties[0], BACNET_ARRAY_ALL, callback, context);
+    if (!request) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request->property_list =
+        bacnet_calloc(count, sizeof(BACNET_PROPERTY_REFERENCE));
+    if (!request->property_list) {
+        bacnet_async_request_free(request);
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    for (i = 0; i < count; i++) {
+        request->property_list[i].propertyIdentifier = properties[i];
+        request->property_list[i].propertyArrayIndex = BACNET_ARRAY_ALL;
+        if ((i + 1) < count) {
+            request->property_list[i].next = &request->property_list[i + 1];
+        }
+    }
+    request->service = SERVICE_CONFIRMED_READ_PROP_MULTIPLE;
+
+    return request->handle;
+}
+
+/**
+ * @brief Read many properties of an object of a remote device with one
+ *  ReadPropertyMultiple request, without blocking, and without a copy
+ *  of the properties
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose properties are read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param property_list - the linked properties to read, which are kept
+ *  unchanged by the caller until the request completes or is cancelled
+ * @param callback - called when the read completes, with the first
+ *  property in rp_data, and the encoded results of the ACK in its
+ *  application_data, or NULL to take the result with
+ *  bacnet_async_result(), which has no value
+ * @param context - given to the callback
+ * @return handle of the request, or BACNET_ASYNC_HANDLE_NONE if there
+ *  is no room for the request
+ */
+BACNET_ASYNC_HANDLE bacnet_async_read_property_multiple_ref(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_REFERENCE *property_list,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request;
+
+    if (!property_list) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request = bacnet_async_request_add(device_id, object_type,
+        object_instance, property_list->propertyIdentifier,
+        property_list->propertyArrayIndex, callback, context);
+    if (!request) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request->property_list = property_list;
+    request->referenced = true;
+    request->service = SERVICE_CONFIRMED_READ_PROP_MULTIPLE;
+
+    return request->handle;
+}
+
+/**
+ * @brief Subscribe to the COV notifications of an object of a remote
+ *  device without blocking. The notifications are received by the
+ *  handlers of the application.
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the monitored object.
+ * @param object_instance - Instance # of the monitored object.
+ * @param process_id - subscriber process identifier
+ * @param confirmed - true for ConfirmedCOVNotification
+ * @param lifetime - seconds of the subscription, or 0 for indefinite
+ * @param callback - called when the subscription completes, or NULL to
+ *  take the result with bacnet_async_result()
+ * @param context - given to the callback
+ * @return handle of the request, or BACNET_ASYNC_HANDLE_NONE if there
+ *  is no room for the request
+ */
+BACNET_ASYNC_HANDLE bacnet_async_subscribe_cov(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t process_id,
+    bool confirmed,
+    uint32_t lifetime,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_request_add(device_id, object_type,
+        object_instance, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, callback,
+        context);
+    if (!request) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request->service = SERVICE_CONFIRMED_SUBSCRIBE_COV;
+    request->process_id = process_id;
+    request->confirmed = confirmed;
+    request->lifetime = lifetime;
+
+    return request->handle;
+}
+
+/**
+ * @brief Subscribe to the COV notifications of an object or of one of
+ *  its properties, or cancel a subscription, without blocking. The
+ *  notifications are received by the handlers of the application.
+ * @param device_id - ID of the destination device
+ * @param cov_data - the subscription, with covSubscribeToProperty set
+ *  for a SubscribeCOVProperty, and cancellationRequest set for a
+ *  cancellation, which is copied
+ * @param callback - called when the subscription completes, or NULL to
+ *  take the result with bacnet_async_result()
+ * @param context - given to the callback
+ * @return handle of the request, or BACNET_ASYNC_HANDLE_NONE if there
+ *  is no room for the request
+ */
+BACNET_ASYNC_HANDLE bacnet_async_subscribe_cov_data(uint32_t device_id,
+    const BACNET_SUBSCRIBE_COV_DATA *cov_data,
+    bacnet_async_callback_t callback,
+    void *context)
+{
+    struct bacnet_async_request *request;
+    BACNET_PROPERTY_ID object_property = PROP_PRESENT_VALUE;
+    BACNET_ARRAY_INDEX array_index = BACNET_ARRAY_ALL;
+
+    if (!cov_data) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    if (cov_data->covSubscribeToProperty) {
+        object_property = cov_data->monitoredProperty.propertyIdentifier;
+        array_index = cov_data->monitoredProperty.propertyArrayIndex;
+    }
+    request = bacnet_async_request_add(device_id,
+        cov_data->monitoredObjectIdentifier.type,
+        cov_data->monitoredObjectIdentifier.instance, object_property,
+        array_index, callback, context);
+    if (!request) {
+        return BACNET_ASYNC_HANDLE_NONE;
+    }
+    request->service = SERVICE_CONFIRMED_SUBSCRIBE_COV;
+    if (cov_data->covSubscribeToProperty) {
+        request->service = SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY;
+        request->cov_increment_present = cov_data->covIncrementPresent;
+        request->cov_increment = cov_data->covIncrement;
+    }
+    request->process_id = cov_data->subscriberProcessIdentifier;
+    request->cancellation = cov_data->cancellationRequest;
+    request->confirmed = cov_data->issueConfirmedNotifications;
+    request->lifetime = cov_data->lifetime;
+
+    return request->handle;
+}
+
+/**
+ * @brief Get the status of a request
+ * @param handle - handle of the request
+ * @return status of the request
+ */
+BACNET_ASYNC_STATUS bacnet_async_status(BACNET_ASYNC_HANDLE handle)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_request_find(handle);
+    if (!request) {
+        return BACNET_ASYNC_STATUS_NONE;
+    }
+    if (request->state == BACNET_ASYNC_STATE_DONE) {
+        return BACNET_ASYNC_STATUS_DONE;
+    }
+
+    return BACNET_ASYNC_STATUS_PENDING;
+}
+
+/**
+ * @brief Take the result of a completed request that was made without
+ *  a callback, and free the request
+ * @param handle - handle of the request
+ * @param error_class [out] the error class, or NULL
+ * @param error_code [out] ERROR_CODE_SUCCESS, or the error code, or NULL
+ * @param value [out] the first decoded value of a read, or NULL
+ * @return true if the request was complete and its result was taken
+ */
+bool bacnet_async_result(BACNET_ASYNC_HANDLE handle,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_request_find(handle);
+    if (!request || (request->state != BACNET_ASYNC_STATE_DONE)) {
+        return false;
+    }
+    if (error_class) {
+        *error_class = request->error_class;
+    }
+    if (error_code) {
+        *error_code = request->error_code;
+    }
+    if (value) {
+        if (request->value) {
+            memcpy(value, request->value, sizeof(*value));
+        } else {
+            memset(value, 0, sizeof(*value));
+            value->tag = BACNET_APPLICATION_TAG_NULL;
+        }
+    }
+    bacnet_async_request_free(request);
+
+    return true;
+}
+
+/**
+ * @brief Cancel a request, or drop the result of a completed request.
+ *  A reply to a request in flight is ignored, and the callback is not
+ *  called.
+ * @param handle - handle of the request
+ * @return true if the request was found and freed
+ */
+bool bacnet_async_cancel(BACNET_ASYNC_HANDLE handle)
+{
+    struct bacnet_async_request *request;
+
+    request = bacnet_async_request_find(handle);
+    if (!request) {
+        return false;
+    }
+    if (request->state == BACNET_ASYNC_STATE_WAITING) {
+        tsm_free_invoke_id(request->invoke_id);
+    }
+    bacnet_async_request_free(request);
+
+    return true;
+}
+
+/**
+ * @brief Get the number of requests that are waiting, in flight, or
+ *  holding a result
+ * @return number of requests
+ */
+unsigned bacnet_async_pending(void)
+{
+    return Async_Request_Count;
+}
+
+/**
+ * @brief Handles the repetitive task of the requests: sends the waiting
+ *  requests as the TSM has room, and times out requests.
+ */
+void bacnet_async_task(void)
+{
+    struct bacnet_async_request *request;
+    bool sending = true;
+    unsigned i;
+
+    for (i = 0; i < BACNET_ASYNC_REQUESTS_MAX; i++) {
+        request = &Async_Request[i];
+        switch (request->state) {
+            case BACNET_ASYNC_STATE_SEND:
+            case BACNET_ASYNC_STATE_BINDING:
+                if (sending) {
+                    sending = bacnet_async_request_send(request);
+                }
+                break;
+            case BACNET_ASYNC_STATE_WAITING:
+                if (tsm_invoke_id_failed(request->invoke_id)) {
+                    tsm_free_invoke_id(request->invoke_id);
+                    bacnet_async_request_finish(request, ERROR_CLASS_SERVICES,
+                        ERROR_CODE_ABORT_TSM_TIMEOUT);
+                } else if (tsm_invoke_id_free(request->invoke_id)) {
+                    /* the transaction ended without a reply for us */
+                    bacnet_async_request_finish(
+                        request, ERROR_CLASS_SERVICES, ERROR_CODE_OTHER);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (mstimer_expired(&Cache_Timer)) {
+        mstimer_reset(&Cache_Timer);
+        address_cache_timer(CACHE_CYCLE_SECONDS);
+    }
+}
+
+/**
+ * @brief Initialize the requests and the handlers for their replies.
+ * @note The requests use the Abort and Reject handlers, and the
+ *  ReadProperty, WriteProperty, ReadPropertyMultiple, SubscribeCOV and
+ *  SubscribeCOVProperty handlers, so they are not used together with the
+ *  bac-rw client in the same application.
+ */
+void bacnet_async_init(void)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_ASYNC_REQUESTS_MAX; i++) {
+        if (Async_Request[i].state != BACNET_ASYNC_STATE_FREE) {
+            bacnet_async_request_release(&Async_Request[i]);
+        }
+        Async_Request[i].state = BACNET_ASYNC_STATE_FREE;
+        Async_Request[i].invoke_id = 0;
+        Async_Request[i].value = NULL;
+        Async_Request[i].property_list = NULL;
+        Async_Request[i].referenced = false;
+    }
+    Async_Request_Count = 0;
+    memset(Async_Invoke, 0, sizeof(Async_Invoke));
+    /* handle i-am to support binding to other devices */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, handler_i_am_bind);
+    /* handle the data coming back from confirmed requests */
+    apdu_set_confirmed_ack_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, My_Read_Property_Ack_Handler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, MyWritePropertySimpleAckHandler);
+    apdu_set_confirmed_ack_handler(SERVICE_CONFIRMED_READ_PROP_MULTIPLE,
+        My_Read_Property_Multiple_Ack_Handler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, MyWritePropertySimpleAckHandler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY,
+        MyWritePropertySimpleAckHandler);
+    /* handle any errors coming back */
+    apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(SERVICE_CONFIRMED_WRITE_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, MyErrorHandler);
+    apdu_set_error_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV, MyErrorHandler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY, MyErrorHandler);
+    apdu_set_abort_handler(MyAbortHandler);
+    apdu_set_reject_handler(MyRejectHandler);
+    /* learn the max-APDU and round trip time of the devices,
+       and wait for each device as long as it takes to reply */
+    apdu_set_peer_capability_handler(address_peer_capability_update);
+    tsm_set_peer_timeout_handler(address_apdu_timeout);
+    /* configure the address cache */
+    address_init();
+    /* start the cyclic 1 second timer for Address Cache */
+    mstimer_set(&Cache_Timer, CACHE_CYCLE_SECONDS * 1000);
+}
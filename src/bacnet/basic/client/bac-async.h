@@ -0,0 +1,139 @@
+/**
+ * @file
+ * @brief API to read and write properties of other BACnet devices, read
+ *  many properties of an object, and subscribe to COV, without blocking.
+ *  Each request returns a handle, and completes through its own
+ *  callback, or through a result that is taken later with the handle.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_ASYNC_H
+#define BACNET_BASIC_CLIENT_ASYNC_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
+#include "bacnet/rp.h"
+
+/* number of requests that can be waiting or in flight */
+#ifndef BACNET_ASYNC_REQUESTS_MAX
+#define BACNET_ASYNC_REQUESTS_MAX 256
+#endif
+
+/* identifies one request; zero is never a valid handle */
+typedef uint32_t BACNET_ASYNC_HANDLE;
+#define BACNET_ASYNC_HANDLE_NONE 0
+
+typedef enum bacnet_async_status {
+    /* the handle is not known, or its result was already taken */
+    BACNET_ASYNC_STATUS_NONE = 0,
+    /* the request is waiting to be sent, or is in flight */
+    BACNET_ASYNC_STATUS_PENDING,
+    /* the request is complete, and its result can be taken */
+    BACNET_ASYNC_STATUS_DONE
+} BACNET_ASYNC_STATUS;
+
+/**
+ * Completion of a request
+ *
+ * @param handle [in] handle of the request
+ * @param device_id [in] device instance number of the request
+ * @param rp_data [in] the object, property, and array index of the
+ *  request, with error_code of ERROR_CODE_SUCCESS if the request
+ *  succeeded. For a read, the encoded value is in application_data,
+ *  and for a ReadPropertyMultiple, the encoded results of the ACK.
+ * @param value [in] the first decoded value of a read, or NULL for
+ *  a write or an error
+ * @param context [in] the context given with the request
+ */
+typedef void (*bacnet_async_callback_t)(BACNET_ASYNC_HANDLE handle,
+    uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    void *context);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_async_init(void);
+BACNET_STACK_EXPORT
+void bacnet_async_task(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_async_pending(void);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_HANDLE bacnet_async_read_property(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    bacnet_async_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_HANDLE bacnet_async_write_property(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    BACNET_ARRAY_INDEX array_index,
+    bacnet_async_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_HANDLE bacnet_async_write_property_ref(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    BACNET_ARRAY_INDEX array_index,
+    bacnet_async_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_HANDLE bacnet_async_read_property_multiple(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    const BACNET_PROPERTY_ID *properties,
+    unsigned count,
+    bacnet_async_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_HANDLE bacnet_async_read_property_multiple_ref(
+    uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_REFERENCE *property_list,
+    bacnet_async_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_HANDLE bacnet_async_subscribe_cov(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t process_id,
+    bool confirmed,
+    uint32_t lifetime,
+    bacnet_async_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_HANDLE bacnet_async_subscribe_cov_data(uint32_t device_id,
+    const BACNET_SUBSCRIBE_COV_DATA *cov_data,
+    bacnet_async_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_ASYNC_STATUS bacnet_async_status(BACNET_ASYNC_HANDLE handle);
+BACNET_STACK_EXPORT
+bool bacnet_async_result(BACNET_ASYNC_HANDLE handle,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code,
+    BACNET_APPLICATION_DATA_VALUE *value);
+BACNET_STACK_EXPORT
+bool bacnet_async_cancel(BACNET_ASYNC_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
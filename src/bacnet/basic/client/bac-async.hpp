@@ -0,0 +1,564 @@
+/**
+ * @file
+ * @brief Optional C++20 header-only layer on top of the asynchronous
+ *  client API: awaitable ReadProperty, ReadPropertyMultiple,
+ *  WriteProperty and SubscribeCOV operations for coroutines, with a
+ *  timeout and cancellation for each operation.
+ * @details An operation is an object that is awaited once, such as a
+ *  temporary of a co_await expression, and that keeps its values,
+ *  properties and result in itself: in the frame of the coroutine. The
+ *  C layer refers to the operation instead of copying its data, so that
+ *  nothing is allocated per request. The coroutine is resumed from
+ *  bacnet::async::task(), or from the handler of the reply, in the
+ *  thread that runs the stack.
+ *
+ *  @code
+ *  bacnet::async::read_property read(device_id, OBJECT_ANALOG_INPUT, 1,
+ *      PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, 5000);
+ *  auto result = co_await read;
+ *  if (result.ok()) {
+ *      use(result.value);
+ *  }
+ *  @endcode
+ *
+ *  Another part of the application may call read.cancel() while the
+ *  coroutine waits, which resumes it with status::cancelled.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_ASYNC_HPP
+#define BACNET_BASIC_CLIENT_ASYNC_HPP
+#if defined(__cplusplus) && (__cplusplus >= 202002L) && \
+    defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/rp.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/client/bac-async.h"
+
+namespace bacnet {
+namespace async {
+
+    /* how an operation completed */
+    enum class status {
+        /* the device acknowledged the request */
+        success,
+        /* the device, or the stack, returned an error, reject or abort */
+        error,
+        /* the timeout of the operation expired */
+        timeout,
+        /* the operation was cancelled */
+        cancelled,
+        /* there was no room for the request */
+        busy
+    };
+
+    /* the completion of an operation without data */
+    struct result {
+        async::status status = async::status::busy;
+        BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
+        BACNET_ERROR_CODE error_code = ERROR_CODE_OTHER;
+
+        bool ok() const noexcept
+        {
+            return status == async::status::success;
+        }
+    };
+
+    /**
+     * An operation of the asynchronous client, which is awaited once.
+     * It is neither copied nor moved, since the C layer refers to it
+     * until it completes.
+     */
+    class operation {
+      public:
+        operation(const operation &) = delete;
+        operation &operator=(const operation &) = delete;
+
+        /**
+         * @brief An operation that is destroyed while it waits, such as
+         *  with the frame of its coroutine, cancels its request without
+         *  resuming the coroutine.
+         */
+        virtual ~operation()
+        {
+            if (handle_ != BACNET_ASYNC_HANDLE_NONE) {
+                (void)bacnet_async_cancel(handle_);
+                unlink();
+            }
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        /**
+         * @brief Start the request, and resume at once if there was no
+         *  room for it
+         * @param waiter - the coroutine that awaits the operation
+         * @return true if the coroutine waits for the completion
+         */
+        bool await_suspend(std::coroutine_handle<> waiter) noexcept
+        {
+            waiter_ = waiter;
+            handle_ = start();
+            if (handle_ == BACNET_ASYNC_HANDLE_NONE) {
+                result_.status = status::busy;
+                result_.error_class = ERROR_CLASS_RESOURCES;
+                result_.error_code = ERROR_CODE_NO_SPACE_FOR_OBJECT;
+                return false;
+            }
+            if (timeout_) {
+                mstimer_set(&timer_, timeout_);
+            }
+            link();
+            return true;
+        }
+
+        /**
+         * @brief Cancel the operation, if it waits, and resume its
+         *  coroutine with status::cancelled
+         * @return true if the operation was waiting
+         */
+        bool cancel() noexcept
+        {
+            return finish(status::cancelled);
+        }
+
+        /**
+         * @brief Determine if the operation waits for its completion
+         * @return true if the operation waits
+         */
+        bool pending() const noexcept
+        {
+            return handle_ != BACNET_ASYNC_HANDLE_NONE;
+        }
+
+        /**
+         * @brief Expire the operations whose timeouts have passed, each of
+         *  which resumes its coroutine with status::timeout
+         */
+        static void expire() noexcept
+        {
+            operation *op = head();
+
+            while (op) {
+                if (op->timeout_ && mstimer_expired(&op->timer_)) {
+                    (void)op->finish(status::timeout);
+                    /* the coroutine may have started or stopped any
+                       operation, so look again from the start */
+                    op = head();
+                } else {
+                    op = op->next_;
+                }
+            }
+        }
+
+      protected:
+        /**
+         * @brief Construct an operation
+         * @param timeout - milliseconds to wait for the completion, or 0
+         *  for the timeouts of the stack only, which are the APDU timeout
+         *  and retries
+         */
+        explicit operation(std::uint32_t timeout) noexcept
+            : timeout_(timeout)
+        {
+        }
+
+        /**
+         * @brief Send the request with the C layer, with callback() as the
+         *  callback and this operation as its context
+         * @return the handle of the request, or BACNET_ASYNC_HANDLE_NONE
+         */
+        virtual BACNET_ASYNC_HANDLE start() noexcept = 0;
+
+        /**
+         * @brief Keep the data of a successful completion, such as the
+         *  value of a read, before the coroutine is resumed
+         * @param rp_data - the result of the request
+         * @param value - the first decoded value of a read, or NULL
+         * @return false if the data does not fit in the operation
+         */
+        virtual bool complete(BACNET_READ_PROPERTY_DATA *rp_data,
+            BACNET_APPLICATION_DATA_VALUE *value) noexcept
+        {
+            (void)rp_data;
+            (void)value;
+            return true;
+        }
+
+        /**
+         * @brief The completion of a request of the C layer
+         */
+        static void callback(BACNET_ASYNC_HANDLE handle,
+            std::uint32_t device_id,
+            BACNET_READ_PROPERTY_DATA *rp_data,
+            BACNET_APPLICATION_DATA_VALUE *value,
+            void *context) noexcept
+        {
+            operation *op = static_cast<operation *>(context);
+
+            (void)device_id;
+            if (!op || (op->handle_ != handle)) {
+                return;
+            }
+            /* the C layer has freed its request */
+            op->handle_ = BACNET_ASYNC_HANDLE_NONE;
+            op->unlink();
+            op->result_.error_class = rp_data->error_class;
+            op->result_.error_code = rp_data->error_code;
+            if (rp_data->error_code != ERROR_CODE_SUCCESS) {
+                op->result_.status = status::error;
+            } else if (op->complete(rp_data, value)) {
+                op->result_.status = status::success;
+            } else {
+                op->result_.status = status::error;
+                op->result_.error_class = ERROR_CLASS_RESOURCES;
+                op->result_.error_code = ERROR_CODE_ABORT_BUFFER_OVERFLOW;
+            }
+            op->waiter_.resume();
+        }
+
+        result result_;
+
+      private:
+        /**
+         * @brief Complete a waiting operation without a reply
+         * @param why - status::timeout or status::cancelled
+         * @return true if the operation was waiting
+         */
+        bool finish(async::status why) noexcept
+        {
+            if (handle_ == BACNET_ASYNC_HANDLE_NONE) {
+                return false;
+            }
+            (void)bacnet_async_cancel(handle_);
+            handle_ = BACNET_ASYNC_HANDLE_NONE;
+            unlink();
+            result_.status = why;
+            result_.error_class = ERROR_CLASS_SERVICES;
+            if (why == status::timeout) {
+                result_.error_code = ERROR_CODE_TIMEOUT;
+            } else {
+                result_.error_code = ERROR_CODE_ABORT_OTHER;
+            }
+            waiter_.resume();
+
+            return true;
+        }
+
+        /* the waiting operations, linked for their timeouts */
+        static operation *&head() noexcept
+        {
+            static operation *list = nullptr;
+
+            return list;
+        }
+
+        void link() noexcept
+        {
+            next_ = head();
+            if (next_) {
+                next_->prev_ = this;
+            }
+            prev_ = nullptr;
+            head() = this;
+        }
+
+        void unlink() noexcept
+        {
+            if (prev_) {
+                prev_->next_ = next_;
+            } else if (head() == this) {
+                head() = next_;
+            }
+            if (next_) {
+                next_->prev_ = prev_;
+            }
+            next_ = nullptr;
+            prev_ = nullptr;
+        }
+
+        BACNET_ASYNC_HANDLE handle_ = BACNET_ASYNC_HANDLE_NONE;
+        std::coroutine_handle<> waiter_;
+        std::uint32_t timeout_;
+        struct mstimer timer_ = {};
+        operation *next_ = nullptr;
+        operation *prev_ = nullptr;
+    };
+
+    /**
+     * @brief Initialize the C layer of the requests and its handlers
+     */
+    inline void init() noexcept
+    {
+        bacnet_async_init();
+    }
+
+    /**
+     * @brief Handles the repetitive task of the requests: sends them as
+     *  the TSM has room, and completes the operations that time out.
+     *  Called from the loop of the application, along with the receive
+     *  of the datalink and the timers of the stack.
+     */
+    inline void task() noexcept
+    {
+        bacnet_async_task();
+        operation::expire();
+    }
+
+    /* the completion of a ReadProperty */
+    struct read_result : result {
+        /* the first decoded value */
+        BACNET_APPLICATION_DATA_VALUE value = {};
+    };
+
+    /**
+     * Read a property of a remote device
+     */
+    class read_property : public operation {
+      public:
+        read_property(std::uint32_t device_id,
+            BACNET_OBJECT_TYPE object_type,
+            std::uint32_t object_instance,
+            BACNET_PROPERTY_ID object_property,
+            BACNET_ARRAY_INDEX array_index = BACNET_ARRAY_ALL,
+            std::uint32_t timeout = 0) noexcept
+            : operation(timeout)
+            , device_id_(device_id)
+            , object_type_(object_type)
+            , object_instance_(object_instance)
+            , object_property_(object_property)
+            , array_index_(array_index)
+        {
+        }
+
+        read_result await_resume() noexcept
+        {
+            static_cast<result &>(read_) = result_;
+            return read_;
+        }
+
+      protected:
+        BACNET_ASYNC_HANDLE start() noexcept override
+        {
+            return bacnet_async_read_property(device_id_, object_type_,
+                object_instance_, object_property_, array_index_, callback,
+                this);
+        }
+
+        bool complete(BACNET_READ_PROPERTY_DATA *rp_data,
+            BACNET_APPLICATION_DATA_VALUE *value) noexcept override
+        {
+            (void)rp_data;
+            if (value) {
+                std::memcpy(&read_.value, value, sizeof(read_.value));
+            } else {
+                read_.value.tag = BACNET_APPLICATION_TAG_NULL;
+            }
+            return true;
+        }
+
+      private:
+        std::uint32_t device_id_;
+        BACNET_OBJECT_TYPE object_type_;
+        std::uint32_t object_instance_;
+        BACNET_PROPERTY_ID object_property_;
+        BACNET_ARRAY_INDEX array_index_;
+        read_result read_;
+    };
+
+    /**
+     * Write a property of a remote device. The value is kept in the
+     * operation until the request completes.
+     */
+    class write_property : public operation {
+      public:
+        write_property(std::uint32_t device_id,
+            BACNET_OBJECT_TYPE object_type,
+            std::uint32_t object_instance,
+            BACNET_PROPERTY_ID object_property,
+            const BACNET_APPLICATION_DATA_VALUE &value,
+            std::uint8_t priority = BACNET_NO_PRIORITY,
+            BACNET_ARRAY_INDEX array_index = BACNET_ARRAY_ALL,
+            std::uint32_t timeout = 0) noexcept
+            : operation(timeout)
+            , device_id_(device_id)
+            , object_type_(object_type)
+            , object_instance_(object_instance)
+            , object_property_(object_property)
+            , priority_(priority)
+            , array_index_(array_index)
+        {
+            std::memcpy(&value_, &value, sizeof(value_));
+            value_.next = nullptr;
+        }
+
+        result await_resume() const noexcept
+        {
+            return result_;
+        }
+
+      protected:
+        BACNET_ASYNC_HANDLE start() noexcept override
+        {
+            return bacnet_async_write_property_ref(device_id_, object_type_,
+                object_instance_, object_property_, &value_, priority_,
+                array_index_, callback, this);
+        }
+
+      private:
+        std::uint32_t device_id_;
+        BACNET_OBJECT_TYPE object_type_;
+        std::uint32_t object_instance_;
+        BACNET_PROPERTY_ID object_property_;
+        std::uint8_t priority_;
+        BACNET_ARRAY_INDEX array_index_;
+        BACNET_APPLICATION_DATA_VALUE value_;
+    };
+
+    /* the completion of a ReadPropertyMultiple, with the encoded results
+       of the ACK, which are decoded by the application such as with
+       rpm_ack_decode_service_request() */
+    template <std::size_t Size>
+    struct read_multiple_result : result {
+        std::uint8_t data[Size] = {};
+        std::size_t data_len = 0;
+    };
+
+    /**
+     * Read many properties of an object of a remote device with one
+     * ReadPropertyMultiple request. The properties are kept in the
+     * operation, up to Properties of them, and the encoded results in
+     * a buffer of Size bytes.
+     */
+    template <std::size_t Properties = 16, std::size_t Size = MAX_APDU>
+    class read_property_multiple : public operation {
+      public:
+        read_property_multiple(std::uint32_t device_id,
+            BACNET_OBJECT_TYPE object_type,
+            std::uint32_t object_instance,
+            const BACNET_PROPERTY_ID *properties,
+            std::size_t count,
+            std::uint32_t timeout = 0) noexcept
+            : operation(timeout)
+            , device_id_(device_id)
+            , object_type_(object_type)
+            , object_instance_(object_instance)
+            , count_(0)
+        {
+            std::size_t i;
+
+            if (!properties || (count > Properties)) {
+                /* nothing is sent, and the operation is busy */
+                return;
+            }
+            for (i = 0; i < count; i++) {
+                list_[i].propertyIdentifier = properties[i];
+                list_[i].propertyArrayIndex = BACNET_ARRAY_ALL;
+                list_[i].next = ((i + 1) < count) ? &list_[i + 1] : nullptr;
+            }
+            count_ = count;
+        }
+
+        read_multiple_result<Size> await_resume() noexcept
+        {
+            static_cast<result &>(read_) = result_;
+            return read_;
+        }
+
+      protected:
+        BACNET_ASYNC_HANDLE start() noexcept override
+        {
+            if (count_ == 0) {
+                return BACNET_ASYNC_HANDLE_NONE;
+            }
+            return bacnet_async_read_property_multiple_ref(device_id_,
+                object_type_, object_instance_, &list_[0], callback, this);
+        }
+
+        bool complete(BACNET_READ_PROPERTY_DATA *rp_data,
+            BACNET_APPLICATION_DATA_VALUE *value) noexcept override
+        {
+            std::size_t len;
+
+            (void)value;
+            len = (std::size_t)rp_data->application_data_len;
+            if (len > Size) {
+                return false;
+            }
+            if (len) {
+                std::memcpy(read_.data, rp_data->application_data, len);
+            }
+            read_.data_len = len;
+            return true;
+        }
+
+      private:
+        std::uint32_t device_id_;
+        BACNET_OBJECT_TYPE object_type_;
+        std::uint32_t object_instance_;
+        std::size_t count_;
+        BACNET_PROPERTY_REFERENCE list_[Properties] = {};
+        read_multiple_result<Size> read_;
+    };
+
+    /**
+     * Subscribe to the COV notifications of an object of a remote
+     * device. The notifications are received by the handlers of the
+     * application.
+     */
+    class subscribe_cov : public operation {
+      public:
+        subscribe_cov(std::uint32_t device_id,
+            BACNET_OBJECT_TYPE object_type,
+            std::uint32_t object_instance,
+            std::uint32_t process_id,
+            bool confirmed,
+            std::uint32_t lifetime,
+            std::uint32_t timeout = 0) noexcept
+            : operation(timeout)
+            , device_id_(device_id)
+            , object_type_(object_type)
+            , object_instance_(object_instance)
+            , process_id_(process_id)
+            , confirmed_(confirmed)
+            , lifetime_(lifetime)
+        {
+        }
+
+        result await_resume() const noexcept
+        {
+            return result_;
+        }
+
+      protected:
+        BACNET_ASYNC_HANDLE start() noexcept override
+        {
+            return bacnet_async_subscribe_cov(device_id_, object_type_,
+                object_instance_, process_id_, confirmed_, lifetime_,
+                callback, this);
+        }
+
+      private:
+        std::uint32_t device_id_;
+        BACNET_OBJECT_TYPE object_type_;
+        std::uint32_t object_instance_;
+        std::uint32_t process_id_;
+        bool confirmed_;
+        std::uint32_t lifetime_;
+    };
+
+} /* namespace async */
+} /* namespace bacnet */
+
+#endif /* C++20 coroutines */
+#endif
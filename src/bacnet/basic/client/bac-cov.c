@@ -0,0 +1,701 @@
+/**
+ * @file
+ * @brief Keep many COV and COV-property subscriptions to other BACnet
+ *  devices with the asynchronous client.
+ * @details Each subscription has its own subscriber process identifier,
+ *  the base plus its index, so that a notification finds its
+ *  subscription without a search. A subscription is renewed at a time
+ *  between one half and three quarters of its lifetime, chosen from its
+ *  index, so that the subscriptions made together are not renewed
+ *  together. The renewals, retries, and polls that are due wait in a
+ *  queue, and only a few of them are in flight at once. A device that
+ *  refuses COV, or the property, is read every poll interval instead,
+ *  and the value is given to the handler as a notification would be.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/apdu.h"
+#include "bacnet/cov.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/timer_wheel.h"
+#include "bacnet/basic/client/bac-async.h"
+/* me */
+#include "bacnet/basic/client/bac-cov.h"
+
+#if (BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX > 0xFFFF)
+#error "BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX must fit in 16 bits"
+#endif
+
+/* the renewals are due before this many milliseconds of the wheel */
+#define COV_CLIENT_DELAY_MAX 0x7FFFFFFFUL
+
+/* a subscription */
+struct bacnet_cov_client {
+    /* renewal, retry, or poll */
+    struct timer_wheel_timer timer;
+    BACNET_COV_CLIENT_STATUS status;
+    /* the identifier is the sequence and the index plus one */
+    uint16_t sequence;
+    /* waiting in the queue of due requests */
+    bool queued;
+    /* the SubscribeCOV or ReadProperty in flight */
+    BACNET_ASYNC_HANDLE handle;
+    uint32_t device_id;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    /* the property of a SubscribeCOVProperty, or the one that is polled */
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    bool cov_property;
+    bool cov_increment_present;
+    float cov_increment;
+    bool confirmed;
+    uint32_t lifetime;
+    bacnet_cov_client_callback_t callback;
+    void *context;
+};
+
+static struct bacnet_cov_client
+    COV_Client[BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX];
+static unsigned COV_Client_Count;
+/* ring of the indexes of the subscriptions that have a request due;
+   a subscription is queued at most once, so the ring never overflows */
+static uint16_t COV_Client_Queue[BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX];
+static unsigned COV_Client_Queue_Head;
+static unsigned COV_Client_Queue_Count;
+static unsigned COV_Client_In_Flight;
+static uint32_t COV_Client_Poll_Seconds = BACNET_COV_CLIENT_POLL_SECONDS;
+static BACNET_COV_NOTIFICATION Unconfirmed_COV_Notification;
+static BACNET_COV_NOTIFICATION Confirmed_COV_Notification;
+
+/**
+ * @brief Get the index of a subscription
+ * @param subscription [in] the subscription
+ * @return index of the subscription
+ */
+static unsigned bacnet_cov_client_index(
+    const struct bacnet_cov_client *subscription)
+{
+    return (unsigned)(subscription - &COV_Client[0]);
+}
+
+/**
+ * @brief Get the identifier of a subscription
+ * @param subscription [in] the subscription
+ * @return identifier of the subscription
+ */
+static BACNET_COV_CLIENT_ID bacnet_cov_client_id(
+    const struct bacnet_cov_client *subscription)
+{
+    return ((BACNET_COV_CLIENT_ID)subscription->sequence << 16) |
+        (bacnet_cov_client_index(subscription) + 1);
+}
+
+/**
+ * @brief Find the subscription of an identifier
+ * @param id [in] identifier of the subscription
+ * @return the subscription, or NULL if the identifier is not known
+ */
+static struct bacnet_cov_client *
+bacnet_cov_client_find(BACNET_COV_CLIENT_ID id)
+{
+    struct bacnet_cov_client *subscription;
+    unsigned index;
+
+    index = id & 0xFFFF;
+    if ((index == 0) || (index > BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX)) {
+        return NULL;
+    }
+    subscription = &COV_Client[index - 1];
+    if ((subscription->status == BACNET_COV_CLIENT_STATUS_NONE) ||
+        (bacnet_cov_client_id(subscription) != id)) {
+        return NULL;
+    }
+
+    return subscription;
+}
+
+/**
+ * @brief Add a subscription to the queue of due requests
+ * @param subscription [in] the subscription
+ */
+static void bacnet_cov_client_queue(struct bacnet_cov_client *subscription)
+{
+    unsigned tail;
+
+    if (subscription->queued) {
+        return;
+    }
+    tail = (COV_Client_Queue_Head + COV_Client_Queue_Count) %
+        BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX;
+    COV_Client_Queue[tail] = (uint16_t)bacnet_cov_client_index(subscription);
+    COV_Client_Queue_Count++;
+    subscription->queued = true;
+}
+
+/**
+ * @brief Timer callback: the renewal, retry, or poll is due
+ * @param context [in] the subscription
+ */
+static void bacnet_cov_client_timer_expired(void *context)
+{
+    bacnet_cov_client_queue((struct bacnet_cov_client *)context);
+}
+
+/**
+ * @brief Set the timer of a subscription
+ * @param subscription [in] the subscription
+ * @param seconds [in] seconds until the request is due, or 0 for never
+ */
+static void bacnet_cov_client_timer_set(
+    struct bacnet_cov_client *subscription, uint32_t seconds)
+{
+    uint32_t milliseconds;
+
+    timer_wheel_stop(&subscription->timer);
+    if (seconds == 0) {
+        return;
+    }
+    if (seconds > (COV_CLIENT_DELAY_MAX / 1000UL)) {
+        milliseconds = COV_CLIENT_DELAY_MAX;
+    } else {
+        milliseconds = seconds * 1000UL;
+    }
+    timer_wheel_set(&subscription->timer, bacnet_cov_client_timer_expired,
+        subscription, milliseconds, 0);
+}
+
+/**
+ * @brief Get the seconds until the renewal of a subscription: between
+ *  one half and three quarters of the lifetime, spread by the index
+ * @param subscription [in] the subscription
+ * @return seconds until the renewal, or 0 for a subscription without
+ *  a lifetime, which is never renewed
+ */
+static uint32_t bacnet_cov_client_renewal(
+    const struct bacnet_cov_client *subscription)
+{
+    uint32_t spread;
+    uint32_t seconds;
+
+    if (subscription->lifetime == 0) {
+        return 0;
+    }
+    /* Knuth's multiplicative hash scatters the neighbouring indexes */
+    spread = (uint32_t)(bacnet_cov_client_index(subscription) + 1) *
+        2654435761UL;
+    seconds = subscription->lifetime / 2;
+    seconds += (spread >> 16) % ((subscription->lifetime / 4) + 1);
+    if (seconds == 0) {
+        seconds = 1;
+    }
+
+    return seconds;
+}
+
+/**
+ * @brief Determine if an error means that the device does not give COV
+ *  of the object or the property, so that it is polled instead
+ * @param error_code [in] the error code of the SubscribeCOV
+ * @return true if the object is polled instead
+ */
+static bool bacnet_cov_client_refused(BACNET_ERROR_CODE error_code)
+{
+    switch (error_code) {
+        case ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED:
+        case ERROR_CODE_COV_SUBSCRIPTION_FAILED:
+        case ERROR_CODE_SERVICE_REQUEST_DENIED:
+        case ERROR_CODE_NOT_COV_PROPERTY:
+        case ERROR_CODE_REJECT_UNRECOGNIZED_SERVICE:
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Completion of a SubscribeCOV or SubscribeCOVProperty
+ * @param handle [in] handle of the request
+ * @param device_id [in] device instance number of the request
+ * @param rp_data [in] the result of the request
+ * @param value [in] not used
+ * @param context [in] the subscription
+ */
+static void bacnet_cov_client_subscribe_complete(BACNET_ASYNC_HANDLE handle,
+    uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    void *context)
+{
+    struct bacnet_cov_client *subscription = context;
+
+    (void)device_id;
+    (void)value;
+    if (subscription->handle != handle) {
+        return;
+    }
+    subscription->handle = BACNET_ASYNC_HANDLE_NONE;
+    COV_Client_In_Flight--;
+    if (rp_data->error_code == ERROR_CODE_SUCCESS) {
+        subscription->status = BACNET_COV_CLIENT_STATUS_ACTIVE;
+        bacnet_cov_client_timer_set(
+            subscription, bacnet_cov_client_renewal(subscription));
+    } else if (bacnet_cov_client_refused(rp_data->error_code)) {
+        subscription->status = BACNET_COV_CLIENT_STATUS_POLLING;
+        bacnet_cov_client_queue(subscription);
+    } else {
+        subscription->status = BACNET_COV_CLIENT_STATUS_RETRY;
+        bacnet_cov_client_timer_set(
+            subscription, BACNET_COV_CLIENT_RETRY_SECONDS);
+    }
+}
+
+/**
+ * @brief Completion of a ReadProperty of a subscription that is polled:
+ *  the value is given to the handler as the list of values of a
+ *  notification
+ * @param handle [in] handle of the request
+ * @param device_id [in] device instance number of the request
+ * @param rp_data [in] the result of the request
+ * @param value [in] the first decoded value, or NULL for an error
+ * @param context [in] the subscription
+ */
+static void bacnet_cov_client_poll_complete(BACNET_ASYNC_HANDLE handle,
+    uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    void *context)
+{
+    struct bacnet_cov_client *subscription = context;
+    BACNET_PROPERTY_VALUE property_value;
+    BACNET_COV_DATA cov_data;
+
+    if (subscription->handle != handle) {
+        return;
+    }
+    subscription->handle = BACNET_ASYNC_HANDLE_NONE;
+    COV_Client_In_Flight--;
+    bacnet_cov_client_timer_set(subscription, COV_Client_Poll_Seconds);
+    if ((rp_data->error_code != ERROR_CODE_SUCCESS) || !value ||
+        !subscription->callback) {
+        return;
+    }
+    memset(&property_value, 0, sizeof(property_value));
+    property_value.propertyIdentifier = subscription->object_property;
+    property_value.propertyArrayIndex = subscription->array_index;
+    memcpy(&property_value.value, value, sizeof(property_value.value));
+    property_value.value.next = NULL;
+    property_value.priority = BACNET_NO_PRIORITY;
+    property_value.next = NULL;
+    memset(&cov_data, 0, sizeof(cov_data));
+    cov_data.subscriberProcessIdentifier = BACNET_COV_CLIENT_PROCESS_ID_BASE +
+        bacnet_cov_client_index(subscription);
+    cov_data.initiatingDeviceIdentifier = device_id;
+    cov_data.monitoredObjectIdentifier.type = subscription->object_type;
+    cov_data.monitoredObjectIdentifier.instance =
+        subscription->object_instance;
+    cov_data.timeRemaining = 0;
+    cov_data.listOfValues = &property_value;
+    subscription->callback(bacnet_cov_client_id(subscription), &cov_data,
+        subscription->context);
+}
+
+/**
+ * @brief Completion of a cancellation, which is not followed up
+ * @param handle [in] handle of the request
+ * @param device_id [in] device instance number of the request
+ * @param rp_data [in] the result of the request
+ * @param value [in] not used
+ * @param context [in] not used
+ */
+static void bacnet_cov_client_cancel_complete(BACNET_ASYNC_HANDLE handle,
+    uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    void *context)
+{
+    (void)handle;
+    (void)device_id;
+    (void)rp_data;
+    (void)value;
+    (void)context;
+}
+
+/**
+ * @brief Fill in the SubscribeCOV or SubscribeCOVProperty of a
+ *  subscription
+ * @param subscription [in] the subscription
+ * @param cov_data [out] the request
+ * @param cancellation [in] true for a cancellation
+ */
+static void bacnet_cov_client_request(
+    const struct bacnet_cov_client *subscription,
+    BACNET_SUBSCRIBE_COV_DATA *cov_data,
+    bool cancellation)
+{
+    memset(cov_data, 0, sizeof(*cov_data));
+    cov_data->subscriberProcessIdentifier = BACNET_COV_CLIENT_PROCESS_ID_BASE +
+        bacnet_cov_client_index(subscription);
+    cov_data->monitoredObjectIdentifier.type = subscription->object_type;
+    cov_data->monitoredObjectIdentifier.instance =
+        subscription->object_instance;
+    cov_data->cancellationRequest = cancellation;
+    cov_data->issueConfirmedNotifications = subscription->confirmed;
+    cov_data->lifetime = subscription->lifetime;
+    cov_data->covSubscribeToProperty = subscription->cov_property;
+    cov_data->monitoredProperty.propertyIdentifier =
+        subscription->object_property;
+    cov_data->monitoredProperty.propertyArrayIndex = subscription->array_index;
+    cov_data->covIncrementPresent = subscription->cov_increment_present;
+    cov_data->covIncrement = subscription->cov_increment;
+}
+
+/**
+ * @brief Send the due request of a subscription: a SubscribeCOV, or a
+ *  ReadProperty for a subscription that is polled
+ * @param subscription [in] the subscription
+ * @return false if the asynchronous client has no room for the request
+ */
+static bool bacnet_cov_client_send(struct bacnet_cov_client *subscription)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data;
+    BACNET_ASYNC_HANDLE handle;
+
+    if (subscription->status == BACNET_COV_CLIENT_STATUS_POLLING) {
+        handle = bacnet_async_read_property(subscription->device_id,
+            subscription->object_type, subscription->object_instance,
+            subscription->object_property, subscription->array_index,
+            bacnet_cov_client_poll_complete, subscription);
+    } else {
+        bacnet_cov_client_request(subscription, &cov_data, false);
+        handle = bacnet_async_subscribe_cov_data(subscription->device_id,
+            &cov_data, bacnet_cov_client_subscribe_complete, subscription);
+    }
+    if (handle == BACNET_ASYNC_HANDLE_NONE) {
+        return false;
+    }
+    subscription->handle = handle;
+    COV_Client_In_Flight++;
+
+    return true;
+}
+
+/**
+ * @brief Give a notification to the handler of its subscription
+ * @param cov_data [in] data decoded from the COV notification
+ */
+static void bacnet_cov_client_notification(BACNET_COV_DATA *cov_data)
+{
+    struct bacnet_cov_client *subscription;
+    uint32_t index;
+
+    if (cov_data->subscriberProcessIdentifier <
+        BACNET_COV_CLIENT_PROCESS_ID_BASE) {
+        return;
+    }
+    index = cov_data->subscriberProcessIdentifier -
+        BACNET_COV_CLIENT_PROCESS_ID_BASE;
+    if (index >= BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX) {
+        return;
+    }
+    subscription = &COV_Client[index];
+    if ((subscription->status == BACNET_COV_CLIENT_STATUS_NONE) ||
+        (subscription->device_id != cov_data->initiatingDeviceIdentifier) ||
+        (subscription->object_type !=
+            cov_data->monitoredObjectIdentifier.type) ||
+        (subscription->object_instance !=
+            cov_data->monitoredObjectIdentifier.instance)) {
+        return;
+    }
+    if (subscription->callback) {
+        subscription->callback(bacnet_cov_client_id(subscription), cov_data,
+            subscription->context);
+    }
+}
+
+/**
+ * @brief Add a subscription, which is sent from the task
+ * @param device_id - ID of the device
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @param object_property - the property of a SubscribeCOVProperty, or
+ *  the property that is polled
+ * @param array_index - array index of the property
+ * @param cov_property - true for a SubscribeCOVProperty
+ * @param cov_increment - the COV increment, or NULL
+ * @param confirmed - true for confirmed notifications
+ * @param lifetime - seconds of the subscription, or 0 for no lifetime
+ * @param callback - called with the values of each notification
+ * @param context - given to the callback
+ * @return identifier of the subscription, or BACNET_COV_CLIENT_ID_NONE
+ *  if there is no room for the subscription
+ */
+static BACNET_COV_CLIENT_ID bacnet_cov_client_add(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    bool cov_property,
+    const float *cov_increment,
+    bool confirmed,
+    uint32_t lifetime,
+    bacnet_cov_client_callback_t callback,
+    void *context)
+{
+    struct bacnet_cov_client *subscription = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX; i++) {
+        if (COV_Client[i].status == BACNET_COV_CLIENT_STATUS_NONE) {
+            subscription = &COV_Client[i];
+            break;
+        }
+    }
+    if (!subscription) {
+        return BACNET_COV_CLIENT_ID_NONE;
+    }
+    subscription->sequence++;
+    subscription->status = BACNET_COV_CLIENT_STATUS_PENDING;
+    subscription->handle = BACNET_ASYNC_HANDLE_NONE;
+    subscription->device_id = device_id;
+    subscription->object_type = object_type;
+    subscription->object_instance = object_instance;
+    subscription->object_property = object_property;
+    subscription->array_index = array_index;
+    subscription->cov_property = cov_property;
+    subscription->cov_increment_present = (cov_increment != NULL);
+    subscription->cov_increment = cov_increment ? *cov_increment : 0.0f;
+    subscription->confirmed = confirmed;
+    subscription->lifetime = lifetime;
+    subscription->callback = callback;
+    subscription->context = context;
+    COV_Client_Count++;
+    bacnet_cov_client_queue(subscription);
+
+    return bacnet_cov_client_id(subscription);
+}
+
+/**
+ * @brief Subscribe to the COV notifications of an object, and keep the
+ *  subscription until it is removed
+ * @param device_id - ID of the device
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @param confirmed - true for confirmed notifications
+ * @param lifetime - seconds of the subscription, which is renewed
+ *  before it expires, or 0 for no lifetime
+ * @param callback - called with the values of each notification, and
+ *  with the Present_Value when the device refuses COV
+ * @param context - given to the callback
+ * @return identifier of the subscription, or BACNET_COV_CLIENT_ID_NONE
+ *  if there is no room for the subscription
+ */
+BACNET_COV_CLIENT_ID bacnet_cov_client_subscribe(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    bool confirmed,
+    uint32_t lifetime,
+    bacnet_cov_client_callback_t callback,
+    void *context)
+{
+    return bacnet_cov_client_add(device_id, object_type, object_instance,
+        PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, false, NULL, confirmed,
+        lifetime, callback, context);
+}
+
+/**
+ * @brief Subscribe to the COV notifications of a property of an
+ *  object, and keep the subscription until it is removed
+ * @param device_id - ID of the device
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @param object_property - the property
+ * @param array_index - array index of the property, or BACNET_ARRAY_ALL
+ * @param cov_increment - the COV increment, or NULL to use the one of
+ *  the object
+ * @param confirmed - true for confirmed notifications
+ * @param lifetime - seconds of the subscription, which is renewed
+ *  before it expires, or 0 for no lifetime
+ * @param callback - called with the values of each notification, and
+ *  with the property when the device refuses COV
+ * @param context - given to the callback
+ * @return identifier of the subscription, or BACNET_COV_CLIENT_ID_NONE
+ *  if there is no room for the subscription
+ */
+BACNET_COV_CLIENT_ID bacnet_cov_client_subscribe_property(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const float *cov_increment,
+    bool confirmed,
+    uint32_t lifetime,
+    bacnet_cov_client_callback_t callback,
+    void *context)
+{
+    return bacnet_cov_client_add(device_id, object_type, object_instance,
+        object_property, array_index, true, cov_increment, confirmed, lifetime,
+        callback, context);
+}
+
+/**
+ * @brief Remove a subscription. A subscription that the device may
+ *  hold is cancelled, without waiting for the result.
+ * @param id - identifier of the subscription
+ * @return true if the subscription was found and removed
+ */
+bool bacnet_cov_client_unsubscribe(BACNET_COV_CLIENT_ID id)
+{
+    struct bacnet_cov_client *subscription;
+    BACNET_SUBSCRIBE_COV_DATA cov_data;
+    bool subscribed;
+
+    subscription = bacnet_cov_client_find(id);
+    if (!subscription) {
+        return false;
+    }
+    timer_wheel_stop(&subscription->timer);
+    subscribed =
+        (subscription->status == BACNET_COV_CLIENT_STATUS_ACTIVE) ||
+        ((subscription->status == BACNET_COV_CLIENT_STATUS_PENDING) &&
+            (subscription->handle != BACNET_ASYNC_HANDLE_NONE));
+    if (subscription->handle != BACNET_ASYNC_HANDLE_NONE) {
+        bacnet_async_cancel(subscription->handle);
+        subscription->handle = BACNET_ASYNC_HANDLE_NONE;
+        COV_Client_In_Flight--;
+    }
+    if (subscribed) {
+        bacnet_cov_client_request(subscription, &cov_data, true);
+        (void)bacnet_async_subscribe_cov_data(subscription->device_id,
+            &cov_data, bacnet_cov_client_cancel_complete, NULL);
+    }
+    /* a queued index of a free subscription is skipped by the task */
+    subscription->status = BACNET_COV_CLIENT_STATUS_NONE;
+    subscription->callback = NULL;
+    COV_Client_Count--;
+
+    return true;
+}
+
+/**
+ * @brief Get the status of a subscription
+ * @param id - identifier of the subscription
+ * @return status of the subscription
+ */
+BACNET_COV_CLIENT_STATUS bacnet_cov_client_status(BACNET_COV_CLIENT_ID id)
+{
+    struct bacnet_cov_client *subscription;
+
+    subscription = bacnet_cov_client_find(id);
+    if (!subscription) {
+        return BACNET_COV_CLIENT_STATUS_NONE;
+    }
+
+    return subscription->status;
+}
+
+/**
+ * @brief Get the number of subscriptions
+ * @return number of subscriptions
+ */
+unsigned bacnet_cov_client_count(void)
+{
+    return COV_Client_Count;
+}
+
+/**
+ * @brief Get the number of subscriptions that have a status
+ * @param status - the status
+ * @return number of subscriptions
+ */
+unsigned bacnet_cov_client_status_count(BACNET_COV_CLIENT_STATUS status)
+{
+    unsigned count = 0;
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX; i++) {
+        if (COV_Client[i].status == status) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Set the seconds between the reads of a subscription that is
+ *  polled, from the next read
+ * @param seconds - seconds between the reads, at least 1
+ */
+void bacnet_cov_client_poll_interval_set(uint32_t seconds)
+{
+    COV_Client_Poll_Seconds = seconds ? seconds : 1;
+}
+
+/**
+ * @brief Handles the repetitive task of the subscriptions: runs the
+ *  timer wheel, and sends the due requests while only a few are in
+ *  flight. Call it from the loop of the application, together with
+ *  bacnet_async_task().
+ */
+void bacnet_cov_client_task(void)
+{
+    struct bacnet_cov_client *subscription;
+
+    timer_wheel_task();
+    while ((COV_Client_Queue_Count > 0) &&
+        (COV_Client_In_Flight < BACNET_COV_CLIENT_REQUESTS_MAX)) {
+        subscription = &COV_Client[COV_Client_Queue[COV_Client_Queue_Head]];
+        if ((subscription->status != BACNET_COV_CLIENT_STATUS_NONE) &&
+            (subscription->handle == BACNET_ASYNC_HANDLE_NONE)) {
+            if (!bacnet_cov_client_send(subscription)) {
+                /* try again when the asynchronous client has room */
+                break;
+            }
+        }
+        subscription->queued = false;
+        COV_Client_Queue_Head =
+            (COV_Client_Queue_Head + 1) % BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX;
+        COV_Client_Queue_Count--;
+    }
+}
+
+/**
+ * @brief Initialize the subscriptions, and the handlers of the COV
+ *  notifications, which are given to the subscriptions among the
+ *  other callbacks of the handlers.
+ * @note The requests are made with the asynchronous client, which is
+ *  initialized with bacnet_async_init() by the application.
+ */
+void bacnet_cov_client_init(void)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX; i++) {
+        timer_wheel_stop(&COV_Client[i].timer);
+        if (COV_Client[i].handle != BACNET_ASYNC_HANDLE_NONE) {
+            bacnet_async_cancel(COV_Client[i].handle);
+        }
+        COV_Client[i].status = BACNET_COV_CLIENT_STATUS_NONE;
+        COV_Client[i].handle = BACNET_ASYNC_HANDLE_NONE;
+        COV_Client[i].queued = false;
+        COV_Client[i].callback = NULL;
+    }
+    COV_Client_Count = 0;
+    COV_Client_Queue_Head = 0;
+    COV_Client_Queue_Count = 0;
+    COV_Client_In_Flight = 0;
+    Unconfirmed_COV_Notification.callback = bacnet_cov_client_notification;
+    handler_ucov_notification_add(&Unconfirmed_COV_Notification);
+    Confirmed_COV_Notification.callback = bacnet_cov_client_notification;
+    handler_ccov_notification_add(&Confirmed_COV_Notification);
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_COV_NOTIFICATION, handler_ucov_notification);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_COV_NOTIFICATION, handler_ccov_notification);
+}
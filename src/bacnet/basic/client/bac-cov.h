@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @brief API to keep many COV and COV-property subscriptions to other
+ *  BACnet devices: each subscription is renewed before its lifetime
+ *  expires, the renewals are spread over time, each notification is
+ *  given to the handler of its subscription, and an object of a device
+ *  that refuses COV is polled instead.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_COV_H
+#define BACNET_BASIC_CLIENT_COV_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/cov.h"
+
+/* number of subscriptions that can be kept */
+#ifndef BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX
+#define BACNET_COV_CLIENT_SUBSCRIPTIONS_MAX 256
+#endif
+/* subscriber process identifier of the first subscription; each
+   subscription uses the next one, which finds it from a notification */
+#ifndef BACNET_COV_CLIENT_PROCESS_ID_BASE
+#define BACNET_COV_CLIENT_PROCESS_ID_BASE 0x10000UL
+#endif
+/* number of SubscribeCOV or ReadProperty requests in flight at once */
+#ifndef BACNET_COV_CLIENT_REQUESTS_MAX
+#define BACNET_COV_CLIENT_REQUESTS_MAX 4
+#endif
+/* seconds until a subscription that failed is tried again */
+#ifndef BACNET_COV_CLIENT_RETRY_SECONDS
+#define BACNET_COV_CLIENT_RETRY_SECONDS 30
+#endif
+/* seconds between the reads of an object that is polled */
+#ifndef BACNET_COV_CLIENT_POLL_SECONDS
+#define BACNET_COV_CLIENT_POLL_SECONDS 60
+#endif
+
+/* identifies one subscription; zero is never a valid identifier */
+typedef uint32_t BACNET_COV_CLIENT_ID;
+#define BACNET_COV_CLIENT_ID_NONE 0
+
+typedef enum bacnet_cov_client_status {
+    /* the identifier is not known */
+    BACNET_COV_CLIENT_STATUS_NONE = 0,
+    /* the subscription is waiting to be sent, or is in flight */
+    BACNET_COV_CLIENT_STATUS_PENDING,
+    /* the device accepted the subscription */
+    BACNET_COV_CLIENT_STATUS_ACTIVE,
+    /* the device refused COV, and the property is polled */
+    BACNET_COV_CLIENT_STATUS_POLLING,
+    /* the subscription failed, and will be tried again */
+    BACNET_COV_CLIENT_STATUS_RETRY
+} BACNET_COV_CLIENT_STATUS;
+
+/**
+ * Values of a subscription
+ *
+ * @param id [in] identifier of the subscription
+ * @param cov_data [in] the values of a notification, or a list of one
+ *  value read from a device that is polled, with timeRemaining of 0
+ * @param context [in] the context given with the subscription
+ */
+typedef void (*bacnet_cov_client_callback_t)(
+    BACNET_COV_CLIENT_ID id, BACNET_COV_DATA *cov_data, void *context);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_cov_client_init(void);
+BACNET_STACK_EXPORT
+void bacnet_cov_client_task(void);
+BACNET_STACK_EXPORT
+BACNET_COV_CLIENT_ID bacnet_cov_client_subscribe(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    bool confirmed,
+    uint32_t lifetime,
+    bacnet_cov_client_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+BACNET_COV_CLIENT_ID bacnet_cov_client_subscribe_property(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const float *cov_increment,
+    bool confirmed,
+    uint32_t lifetime,
+    bacnet_cov_client_callback_t callback,
+    void *context);
+BACNET_STACK_EXPORT
+bool bacnet_cov_client_unsubscribe(BACNET_COV_CLIENT_ID id);
+BACNET_STACK_EXPORT
+BACNET_COV_CLIENT_STATUS bacnet_cov_client_status(BACNET_COV_CLIENT_ID id);
+BACNET_STACK_EXPORT
+unsigned bacnet_cov_client_count(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_cov_client_status_count(BACNET_COV_CLIENT_STATUS status);
+BACNET_STACK_EXPORT
+void bacnet_cov_client_poll_interval_set(uint32_t seconds);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -12,15 +12,47 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/binding/address.h"
 /* us */
 #include "bacnet/basic/client/bac-rw.h"
+#include "bacnet/basic/client/bac-rpm.h"
 #include "bacnet/basic/client/bac-data.h"
 
 /* number of objects data stored */
 #ifndef BACNET_DATA_OBJECT_MAX
 #define BACNET_DATA_OBJECT_MAX 16
 #endif
-/* Polling interval timer */
+/* number of buckets of the object index - a power of two */
+#ifndef BACNET_DATA_OBJECT_BUCKETS
+#define BACNET_DATA_OBJECT_BUCKETS 16
+#endif
+/* number of devices with reads in flight at the same time */
+#ifndef BACNET_DATA_DEVICE_MAX
+#define BACNET_DATA_DEVICE_MAX 32
+#endif
+/* number of reads in flight to any one device */
+#ifndef BACNET_DATA_DEVICE_READS_MAX
+#define BACNET_DATA_DEVICE_READS_MAX 8
+#endif
+/* number of reads in flight to the devices of one remote network,
+   such as an MS/TP trunk behind a router */
+#ifndef BACNET_DATA_NETWORK_READS_MAX
+#define BACNET_DATA_NETWORK_READS_MAX 16
+#endif
+/* number of reads started by each call of the task, at most */
+#ifndef BACNET_DATA_TASK_READS_MAX
+#define BACNET_DATA_TASK_READS_MAX 16
+#endif
+/* milliseconds after which a read without a reply is given up */
+#ifndef BACNET_DATA_READ_TIMEOUT_MS
+#define BACNET_DATA_READ_TIMEOUT_MS 30000UL
+#endif
+/* milliseconds to wait before trying a read that could not start */
+#ifndef BACNET_DATA_READ_DEFER_MS
+#define BACNET_DATA_READ_DEFER_MS 100UL
+#endif
+#define BACNET_DATA_INDEX_NONE UINT32_MAX
+/* Polling interval timer - holds the default polling interval */
 static struct mstimer Object_Poll_Timer;
 /* property R/W process interval timer */
 static struct mstimer Read_Write_Timer;
@@ -42,8 +74,226 @@ typedef struct bacnet_object_data {
         } type;
     } Present_Value;
     bool refresh;
+    /* milliseconds between reads, or 0 for the default interval */
+    uint32_t Poll_Interval;
+    /* time of the next read, from mstimer_now() */
+    uint32_t Poll_Due;
+    /* time of the read in flight, from mstimer_now() */
+    uint32_t Poll_Sent;
+    bool Poll_Pending;
+    /* position in the schedule, or BACNET_DATA_INDEX_NONE */
+    uint32_t Heap_Index;
+    /* next object in the same bucket, or BACNET_DATA_INDEX_NONE */
+    uint32_t Bucket_Next;
 } BACNET_DATA_OBJECT;
 static BACNET_DATA_OBJECT Object_Table[BACNET_DATA_OBJECT_MAX];
+static uint32_t Object_Count;
+/* index of the objects by device, type, and instance */
+static uint32_t Object_Bucket[BACNET_DATA_OBJECT_BUCKETS];
+/* schedule of the objects - a min-heap by the time of the next read */
+static uint32_t Poll_Heap[BACNET_DATA_OBJECT_MAX];
+static uint32_t Poll_Heap_Count;
+
+/* reads in flight to one device */
+typedef struct bacnet_data_device {
+    uint32_t Device_ID;
+    /* network number of the device, or 0 for the local network */
+    uint16_t Network;
+    uint16_t Reads;
+} BACNET_DATA_DEVICE;
+static BACNET_DATA_DEVICE Device_Table[BACNET_DATA_DEVICE_MAX];
+
+/**
+ * @brief Determine if one time from mstimer_now() is before another,
+ *  across the wrap of the milliseconds counter
+ * @param a - a time
+ * @param b - another time
+ * @return true if a is before b
+ */
+static bool bacnet_data_time_before(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) < 0);
+}
+
+/**
+ * @brief Get the bucket of an object in the object index
+ * @param  device_instance - object-instance number of the device object
+ * @param  object_type - object type of the object
+ * @param  object_instance - object-instance number of the object
+ * @return bucket of the object index
+ */
+static uint32_t bacnet_data_object_bucket(
+    uint32_t device_instance, uint16_t object_type, uint32_t object_instance)
+{
+    uint32_t hash;
+
+    hash = device_instance * 2654435761UL;
+    hash ^= ((uint32_t)object_type << 22) ^ object_instance;
+    hash *= 2246822519UL;
+    hash ^= hash >> 15;
+
+    return hash & (BACNET_DATA_OBJECT_BUCKETS - 1);
+}
+
+/**
+ * @brief Swap two objects in the schedule
+ * @param a - position in the schedule
+ * @param b - another position in the schedule
+ */
+static void bacnet_data_heap_swap(uint32_t a, uint32_t b)
+{
+    uint32_t index = Poll_Heap[a];
+
+    Poll_Heap[a] = Poll_Heap[b];
+    Poll_Heap[b] = index;
+    Object_Table[Poll_Heap[a]].Heap_Index = a;
+    Object_Table[Poll_Heap[b]].Heap_Index = b;
+}
+
+/**
+ * @brief Determine if an object in the schedule is due before another
+ * @param a - position in the schedule
+ * @param b - another position in the schedule
+ * @return true if the object at a is due before the object at b
+ */
+static bool bacnet_data_heap_before(uint32_t a, uint32_t b)
+{
+    return bacnet_data_time_before(Object_Table[Poll_Heap[a]].Poll_Due,
+        Object_Table[Poll_Heap[b]].Poll_Due);
+}
+
+/**
+ * @brief Move an object of the schedule to its place after the time of
+ *  its next read changed
+ * @param position - position of the object in the schedule
+ */
+static void bacnet_data_heap_update(uint32_t position)
+{
+    uint32_t parent, child;
+
+    while (position > 0) {
+        parent = (position - 1) / 2;
+        if (!bacnet_data_heap_before(position, parent)) {
+            break;
+        }
+        bacnet_data_heap_swap(position, parent);
+        position = parent;
+    }
+    for (;;) {
+        child = (2 * position) + 1;
+        if (child >= Poll_Heap_Count) {
+            break;
+        }
+        if (((child + 1) < Poll_Heap_Count) &&
+            bacnet_data_heap_before(child + 1, child)) {
+            child++;
+        }
+        if (!bacnet_data_heap_before(child, position)) {
+            break;
+        }
+        bacnet_data_heap_swap(position, child);
+        position = child;
+    }
+}
+
+/**
+ * @brief Schedule the next read of an object
+ * @param index - index of the object
+ * @param due - time of the next read, from mstimer_now()
+ */
+static void bacnet_data_object_schedule(uint32_t index, uint32_t due)
+{
+    BACNET_DATA_OBJECT *object = &Object_Table[index];
+
+    object->Poll_Due = due;
+    if (object->Heap_Index == BACNET_DATA_INDEX_NONE) {
+        object->Heap_Index = Poll_Heap_Count;
+        Poll_Heap[Poll_Heap_Count] = index;
+        Poll_Heap_Count++;
+    }
+    bacnet_data_heap_update(object->Heap_Index);
+}
+
+/**
+ * @brief Get the polling interval of an object
+ * @param object - BACnet object structure data pointer
+ * @return milliseconds between reads of the object
+ */
+static uint32_t bacnet_data_object_interval(const BACNET_DATA_OBJECT *object)
+{
+    if (object->Poll_Interval) {
+        return object->Poll_Interval;
+    }
+
+    return mstimer_interval(&Object_Poll_Timer);
+}
+
+/**
+ * @brief Find the reads in flight to a device
+ * @param device_id - device instance number
+ * @param add - true to take a free entry if the device is not found
+ * @return the entry of the device, or NULL if not found or none are free
+ */
+static BACNET_DATA_DEVICE *bacnet_data_device_find(uint32_t device_id, bool add)
+{
+    BACNET_DATA_DEVICE *device = NULL;
+    BACNET_DATA_DEVICE *free_device = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_DATA_DEVICE_MAX; i++) {
+        device = &Device_Table[i];
+        if (device->Reads == 0) {
+            if (!free_device) {
+                free_device = device;
+            }
+        } else if (device->Device_ID == device_id) {
+            return device;
+        }
+    }
+    if (add && free_device) {
+        free_device->Device_ID = device_id;
+        free_device->Network = 0;
+        return free_device;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Count the reads in flight to the devices of a network
+ * @param network - network number
+ * @return number of reads in flight
+ */
+static unsigned bacnet_data_network_reads(uint16_t network)
+{
+    unsigned reads = 0;
+    unsigned i;
+
+    for (i = 0; i < BACNET_DATA_DEVICE_MAX; i++) {
+        if (Device_Table[i].Network == network) {
+            reads += Device_Table[i].Reads;
+        }
+    }
+
+    return reads;
+}
+
+/**
+ * @brief Note that the read of an object has finished, or was given up
+ * @param object - BACnet object structure data pointer
+ */
+static void bacnet_data_object_read_done(BACNET_DATA_OBJECT *object)
+{
+    BACNET_DATA_DEVICE *device;
+
+    if (object->Poll_Pending) {
+        object->Poll_Pending = false;
+        device = bacnet_data_device_find(object->Device_ID, false);
+        if (device) {
+            device->Reads--;
+        }
+    }
+}
 
 /**
  * @brief Find the index of a BACnet object type of a given instance.
@@ -56,15 +306,18 @@ static int bacnet_data_object_index_find(
     uint32_t device_instance, uint16_t object_type, uint32_t object_instance)
 {
     BACNET_DATA_OBJECT *object = NULL;
-    unsigned i = 0;
+    uint32_t i = 0;
 
-    for (i = 0; i < BACNET_DATA_OBJECT_MAX; i++) {
+    i = Object_Bucket[bacnet_data_object_bucket(
+        device_instance, object_type, object_instance)];
+    while (i != BACNET_DATA_INDEX_NONE) {
         object = &Object_Table[i];
         if ((object->Device_ID == device_instance) &&
             (object->Object_Type == object_type) &&
             (object->Object_ID == object_instance)) {
-            return i;
+            return (int)i;
         }
+        i = object->Bucket_Next;
     }
 
     return BACNET_STATUS_ERROR;
@@ -77,16 +330,9 @@ static int bacnet_data_object_index_find(
  */
 static int bacnet_data_object_index_find_free(void)
 {
-    BACNET_DATA_OBJECT *object = NULL;
-    unsigned i = 0;
-
-    for (i = 0; i < BACNET_DATA_OBJECT_MAX; i++) {
-        object = &Object_Table[i];
-        if ((object->Device_ID >= BACNET_MAX_INSTANCE) &&
-            (object->Object_Type == MAX_BACNET_OBJECT_TYPE) &&
-            (object->Object_ID >= BACNET_MAX_INSTANCE)) {
-            return i;
-        }
+    /* objects are never removed, so the free elements are at the end */
+    if (Object_Count < BACNET_DATA_OBJECT_MAX) {
+        return (int)Object_Count;
     }
 
     return BACNET_STATUS_ERROR;
@@ -105,7 +351,19 @@ static void bacnet_data_object_init(void)
         object->Device_ID = BACNET_MAX_INSTANCE;
         object->Object_Type = MAX_BACNET_OBJECT_TYPE;
         object->Object_ID = BACNET_MAX_INSTANCE;
+        object->Poll_Interval = 0;
+        object->Poll_Pending = false;
+        object->Heap_Index = BACNET_DATA_INDEX_NONE;
+        object->Bucket_Next = BACNET_DATA_INDEX_NONE;
     }
+    for (i = 0; i < BACNET_DATA_OBJECT_BUCKETS; i++) {
+        Object_Bucket[i] = BACNET_DATA_INDEX_NONE;
+    }
+    for (i = 0; i < BACNET_DATA_DEVICE_MAX; i++) {
+        Device_Table[i].Reads = 0;
+    }
+    Object_Count = 0;
+    Poll_Heap_Count = 0;
 }
 
 static void bacnet_data_object_store(int index,
@@ -158,6 +416,14 @@ void bacnet_data_value_save(uint32_t device_instance,
     if (!rp_data) {
         return;
     }
+    if (rp_data->object_property == PROP_PRESENT_VALUE) {
+        /* a reply or an error ends the read in flight */
+        index = bacnet_data_object_index_find(device_instance,
+            rp_data->object_type, rp_data->object_instance);
+        if (index != BACNET_STATUS_ERROR) {
+            bacnet_data_object_read_done(&Object_Table[index]);
+        }
+    }
     if (rp_data->error_code != ERROR_CODE_SUCCESS) {
         return;
     }
@@ -189,14 +455,24 @@ void bacnet_data_value_save(uint32_t device_instance,
  * @brief Handles the BACnet Data Analog Value processing
  * @param object - BACnet object structure data pointer
  */
-static void bacnet_data_object_process(BACNET_DATA_OBJECT *object)
+static bool bacnet_data_object_process(BACNET_DATA_OBJECT *object)
 {
+    bool status = false;
+
     if (object && (object->Device_ID < BACNET_MAX_INSTANCE) &&
         (object->Object_ID < BACNET_MAX_INSTANCE)) {
-        bacnet_read_property_queue(object->Device_ID,
+#if BACNET_DATA_RPM_PLAN
+        status = bacnet_rpm_plan_read_add(object->Device_ID,
+            (BACNET_OBJECT_TYPE)object->Object_Type, object->Object_ID,
+            PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+#else
+        status = bacnet_read_property_queue(object->Device_ID,
             (BACNET_OBJECT_TYPE)object->Object_Type, object->Object_ID,
             PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+#endif
     }
+
+    return status;
 }
 
 /**
@@ -212,6 +488,7 @@ bool bacnet_data_object_add(uint32_t device_id,
 {
     BACNET_DATA_OBJECT *object = NULL;
     bool status = false;
+    uint32_t bucket;
     int index = 0;
 
     switch (object_type) {
@@ -234,6 +511,11 @@ bool bacnet_data_object_add(uint32_t device_id,
                     object->Object_Type = object_type;
                     object->Object_ID = object_instance;
                     object->refresh = true;
+                    bucket = bacnet_data_object_bucket(
+                        device_id, object_type, object_instance);
+                    object->Bucket_Next = Object_Bucket[bucket];
+                    Object_Bucket[bucket] = (uint32_t)index;
+                    Object_Count++;
                     status = true;
                 }
             } else {
@@ -241,6 +523,11 @@ bool bacnet_data_object_add(uint32_t device_id,
                 object->refresh = true;
                 status = true;
             }
+            if (status) {
+                /* read the value as soon as possible */
+                bacnet_data_object_schedule(
+                    (uint32_t)index, (uint32_t)mstimer_now());
+            }
             break;
         case OBJECT_DEVICE:
         default:
@@ -356,40 +643,159 @@ bool bacnet_data_multistate_present_value(uint32_t device_id,
 }
 
 /**
- * @brief Handles the BACnet Data repetitive task
+ * @brief Start the read of an object, unless the device or its network
+ *  already has as many reads in flight as allowed
+ * @param object - BACnet object structure data pointer
+ * @param now - the time, from mstimer_now()
+ * @return true if the read was started
+ */
+static bool bacnet_data_object_start(BACNET_DATA_OBJECT *object, uint32_t now)
+{
+    BACNET_DATA_DEVICE *device;
+    BACNET_ADDRESS address = { 0 };
+    unsigned max_apdu = 0;
+
+    device = bacnet_data_device_find(object->Device_ID, true);
+    if (!device) {
+        return false;
+    }
+    if (address_get_by_device(object->Device_ID, &max_apdu, &address)) {
+        device->Network = address.net;
+    }
+    if (device->Reads >= BACNET_DATA_DEVICE_READS_MAX) {
+        return false;
+    }
+    if (device->Network && (bacnet_data_network_reads(device->Network) >=
+                               BACNET_DATA_NETWORK_READS_MAX)) {
+        return false;
+    }
+    /* in flight before the request, in case the reply is immediate */
+    object->Poll_Pending = true;
+    object->Poll_Sent = now;
+    device->Reads++;
+    if (!bacnet_data_object_process(object)) {
+        bacnet_data_object_read_done(object);
+        return false;
+    }
+    object->refresh = false;
+
+    return true;
+}
+
+/**
+ * @brief Handles the BACnet Data repetitive task, starting the reads of
+ *  the objects that are due, soonest first
  */
 void bacnet_data_task(void)
 {
-    static unsigned object_index = 0;
     BACNET_DATA_OBJECT *object = NULL;
-    unsigned i = 0;
+    uint32_t index, interval, due, now;
+    uint32_t checked = 0;
+    unsigned reads = 0;
 
-    if (mstimer_expired(&Object_Poll_Timer)) {
-        mstimer_reset(&Object_Poll_Timer);
-        for (i = 0; i < BACNET_DATA_OBJECT_MAX; i++) {
-            object = &Object_Table[i];
-            object->refresh = true;
-        }
-    }
     if (mstimer_expired(&Read_Write_Timer)) {
         mstimer_reset(&Read_Write_Timer);
+#if BACNET_DATA_RPM_PLAN
+        bacnet_rpm_plan_task();
+#else
         bacnet_read_write_task();
+#endif
     }
-    if (bacnet_read_write_idle()) {
-        object = &Object_Table[object_index];
-        if (object->refresh) {
-            object->refresh = false;
-            bacnet_data_object_process(object);
+    now = (uint32_t)mstimer_now();
+    while ((checked < Poll_Heap_Count) &&
+        (reads < BACNET_DATA_TASK_READS_MAX)) {
+        checked++;
+        index = Poll_Heap[0];
+        object = &Object_Table[index];
+        if (bacnet_data_time_before(now, object->Poll_Due)) {
+            break;
+        }
+#if !BACNET_DATA_RPM_PLAN
+        /* without the planner, the reads are sent one at a time */
+        if (!bacnet_read_write_idle()) {
+            break;
         }
-        object_index++;
-        if (object_index >= BACNET_DATA_OBJECT_MAX) {
-            object_index = 0;
+#endif
+        interval = bacnet_data_object_interval(object);
+        if (object->Poll_Pending) {
+            if ((now - object->Poll_Sent) < BACNET_DATA_READ_TIMEOUT_MS) {
+                /* the last read has not finished - skip this one */
+                bacnet_data_object_schedule(index, now + interval);
+                continue;
+            }
+            bacnet_data_object_read_done(object);
         }
+        if (bacnet_data_object_start(object, now)) {
+            reads++;
+            due = object->Poll_Due + interval;
+            if (!bacnet_data_time_before(now, due)) {
+                /* this read was late - do not try to catch up */
+                due = now + interval;
+            }
+            bacnet_data_object_schedule(index, due);
+        } else {
+            bacnet_data_object_schedule(index, now + BACNET_DATA_READ_DEFER_MS);
+        }
+    }
+}
+
+/**
+ * @brief Set the polling interval of one BACnet Data remote value point,
+ *  adding the point if it does not exist
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param milliseconds - milliseconds between reads of the point,
+ *  or 0 for the default interval of bacnet_data_poll_seconds_set()
+ * @return true if the point exists or was added
+ */
+bool bacnet_data_object_poll_interval_set(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t milliseconds)
+{
+    int index;
+
+    /* the point is read right away, and then at its own interval */
+    if (!bacnet_data_object_add(device_id, object_type, object_instance)) {
+        return false;
+    }
+    index =
+        bacnet_data_object_index_find(device_id, object_type, object_instance);
+    if (index == BACNET_STATUS_ERROR) {
+        return false;
     }
+    Object_Table[index].Poll_Interval = milliseconds;
+
+    return true;
 }
 
 /**
- * @brief Set the BACnet Data Poll seconds
+ * @brief Get the polling interval of one BACnet Data remote value point
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is read.
+ * @param object_instance - Instance # of the object that is read.
+ * @return milliseconds between reads of the point, or 0 if the point
+ *  uses the default interval or does not exist
+ */
+uint32_t bacnet_data_object_poll_interval(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance)
+{
+    int index;
+
+    index =
+        bacnet_data_object_index_find(device_id, object_type, object_instance);
+    if (index == BACNET_STATUS_ERROR) {
+        return 0;
+    }
+
+    return Object_Table[index].Poll_Interval;
+}
+
+/**
+ * @brief Set the BACnet Data Poll seconds, the default interval of the
+ *  objects that have no polling interval of their own
  * @param seconds - number of seconds between polling intervals
  */
 void bacnet_data_poll_seconds_set(unsigned int seconds)
@@ -403,7 +809,7 @@ void bacnet_data_poll_seconds_set(unsigned int seconds)
  */
 unsigned int bacnet_data_poll_seconds(void)
 {
-    return mstimer_interval(&Object_Poll_Timer) * 1000;
+    return mstimer_interval(&Object_Poll_Timer) / 1000;
 }
 
 /**
@@ -412,9 +818,14 @@ unsigned int bacnet_data_poll_seconds(void)
 void bacnet_data_init(void)
 {
     bacnet_data_object_init();
+#if BACNET_DATA_RPM_PLAN
+    bacnet_rpm_plan_init();
+    bacnet_rpm_plan_value_callback_set(bacnet_data_value_save);
+#else
     bacnet_read_write_init();
+    bacnet_read_write_value_callback_set(bacnet_data_value_save);
+#endif
     /* start the cyclic poll timer */
     mstimer_set(&Object_Poll_Timer, 1 * 60 * 1000);
     mstimer_set(&Read_Write_Timer, 10);
-    bacnet_read_write_value_callback_set(bacnet_data_value_save);
 }
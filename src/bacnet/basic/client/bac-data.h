@@ -15,6 +15,11 @@
 #include "bacnet/bacapp.h"
 #include "bacnet/rp.h"
 
+/* use the ReadPropertyMultiple planner to poll the present values */
+#ifndef BACNET_DATA_RPM_PLAN
+#define BACNET_DATA_RPM_PLAN 0
+#endif
+
 struct bacnet_status_flags_t {
     bool in_alarm : 1;
     bool fault : 1;
@@ -43,6 +48,15 @@ bool bacnet_data_object_add(uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool bacnet_data_object_poll_interval_set(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    uint32_t milliseconds);
+BACNET_STACK_EXPORT
+uint32_t bacnet_data_object_poll_interval(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance);
+BACNET_STACK_EXPORT
 bool bacnet_data_analog_present_value(uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
     uint32_t object_instance,
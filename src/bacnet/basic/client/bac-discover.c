@@ -10,12 +10,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <assert.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bactext.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/bacint.h"
+#include "bacnet/iam.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/keylist.h"
@@ -23,7 +28,9 @@
 #include "bacnet/property.h"
 /* us */
 #include "bacnet/basic/client/bac-rw.h"
+#include "bacnet/basic/client/bac-rpm.h"
 #include "bacnet/basic/client/bac-discover.h"
+#include "bacnet/basic/sys/static_pool.h"
 
 /* send a Who-Is to discover new devices */
 static struct mstimer WhoIs_Timer;
@@ -39,6 +46,7 @@ static unsigned long Discovery_Milliseconds;
 typedef enum bacnet_discover_state_enum {
     BACNET_DISCOVER_STATE_INIT = 0,
     BACNET_DISCOVER_STATE_BINDING,
+    BACNET_DISCOVER_STATE_REVISION_REQUEST,
     BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST,
     BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_RESPONSE,
     BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST,
@@ -46,7 +54,11 @@ typedef enum bacnet_discover_state_enum {
     BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST,
     BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE,
     BACNET_DISCOVER_STATE_OBJECT_NEXT,
-    BACNET_DISCOVER_STATE_DONE
+    BACNET_DISCOVER_STATE_DONE,
+    /* states of discovery with the ReadPropertyMultiple planner */
+    BACNET_DISCOVER_STATE_PLAN_REVISION,
+    BACNET_DISCOVER_STATE_PLAN_OBJECT_LIST,
+    BACNET_DISCOVER_STATE_PLAN_OBJECTS
 } BACNET_DISCOVER_STATE;
 
 typedef struct bacnet_property_data_t {
@@ -59,8 +71,13 @@ typedef struct bacnet_object_data_t {
     /* used for discovering object data */
     uint32_t Property_List_Size;
     uint32_t Property_List_Index;
+    /* the object is in the Object_List that was last read */
+    bool Listed;
 } BACNET_OBJECT_DATA;
 
+/* largest encoded Last_Restore_Time that is kept */
+#define BACNET_DISCOVER_RESTORE_TIME_SIZE 16
+
 typedef struct bacnet_device_data_t {
     OS_Keylist Object_List;
     /* used for discovering device data */
@@ -70,6 +87,18 @@ typedef struct bacnet_device_data_t {
     struct mstimer Discovery_Timer;
     unsigned long Discovery_Elapsed_Milliseconds;
     BACNET_DISCOVER_STATE Discovery_State;
+    /* Database_Revision and Last_Restore_Time last read */
+    uint32_t Database_Revision;
+    bool Database_Revision_Valid;
+    uint8_t Last_Restore_Time[BACNET_DISCOVER_RESTORE_TIME_SIZE];
+    uint8_t Last_Restore_Time_Len;
+    /* Database_Revision and Last_Restore_Time of the last discovery */
+    uint32_t Discovered_Revision;
+    bool Discovered_Revision_Valid;
+    uint8_t Discovered_Restore_Time[BACNET_DISCOVER_RESTORE_TIME_SIZE];
+    uint8_t Discovered_Restore_Time_Len;
+    /* the Object_List was not completely read */
+    bool Discovery_Error;
 } BACNET_DEVICE_DATA;
 
 /**
@@ -85,11 +114,11 @@ static BACNET_PROPERTY_DATA *bacnet_property_data_add(OS_Keylist list, KEY key)
 
     data = Keylist_Data(list, key);
     if (!data) {
-        data = calloc(1, sizeof(BACNET_PROPERTY_DATA));
+        data = bacnet_calloc(1, sizeof(BACNET_PROPERTY_DATA));
         if (data) {
             index = Keylist_Data_Add(list, key, data);
             if (index < 0) {
-                free(data);
+                bacnet_free(data);
                 data = NULL;
             }
         }
@@ -109,8 +138,8 @@ static void bacnet_property_data_cleanup(OS_Keylist list)
     do {
         data = Keylist_Data_Pop(list);
         if (data) {
-            free(data->application_data);
-            free(data);
+            bacnet_free(data->application_data);
+            bacnet_free(data);
         }
     } while (data);
     Keylist_Delete(list);
@@ -133,14 +162,14 @@ static BACNET_OBJECT_DATA *bacnet_object_data_add(
     key = KEY_ENCODE(object_type, object_instance);
     data = Keylist_Data(list, key);
     if (!data) {
-        data = calloc(1, sizeof(BACNET_OBJECT_DATA));
+        data = bacnet_calloc(1, sizeof(BACNET_OBJECT_DATA));
         if (data) {
             data->Property_List = Keylist_Create();
             data->Property_List_Size = 0;
             data->Property_List_Index = 0;
             index = Keylist_Data_Add(list, key, data);
             if (index < 0) {
-                free(data);
+                bacnet_free(data);
                 data = NULL;
             }
         }
@@ -177,12 +206,137 @@ static void bacnet_object_data_cleanup(OS_Keylist list)
         data = Keylist_Data_Pop(list);
         if (data) {
             bacnet_property_data_cleanup(data->Property_List);
-            free(data);
+            bacnet_free(data);
         }
     } while (data);
     Keylist_Delete(list);
 }
 
+/**
+ * @brief Mark all the objects as not in the Object_List, before the
+ *  Object_List is read again
+ * @param list - Keylist of the objects
+ */
+static void bacnet_object_data_unlist(OS_Keylist list)
+{
+    BACNET_OBJECT_DATA *data = NULL;
+    int count, index;
+
+    count = Keylist_Count(list);
+    for (index = 0; index < count; index++) {
+        data = Keylist_Data_Index(list, index);
+        if (data) {
+            data->Listed = false;
+        }
+    }
+}
+
+/**
+ * @brief Remove the objects that are no longer in the Object_List,
+ *  and keep the data of the others
+ * @param list - Keylist of the objects
+ */
+static void bacnet_object_data_sweep(OS_Keylist list)
+{
+    BACNET_OBJECT_DATA *data = NULL;
+    int index;
+
+    for (index = Keylist_Count(list); index > 0; index--) {
+        data = Keylist_Data_Index(list, index - 1);
+        if (data && !data->Listed) {
+            data = Keylist_Data_Delete_By_Index(list, index - 1);
+            if (data) {
+                bacnet_property_data_cleanup(data->Property_List);
+                bacnet_free(data);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Choose the property to read from an object of the Object_List.
+ *  A new object has all of its properties read, and an object that was
+ *  already discovered has its Object_Name read, which could have changed
+ *  along with the Database_Revision.
+ * @param data - object data
+ * @return the property to read
+ */
+static BACNET_PROPERTY_ID bacnet_object_data_property(BACNET_OBJECT_DATA *data)
+{
+    if (data && (Keylist_Count(data->Property_List) > 0)) {
+        return PROP_OBJECT_NAME;
+    }
+
+    return PROP_ALL;
+}
+
+/**
+ * @brief Determine if a device is unchanged since its last discovery,
+ *  from its Database_Revision and Last_Restore_Time
+ * @param data - device data
+ * @return true if the device does not need to be discovered again
+ */
+static bool bacnet_device_data_unchanged(BACNET_DEVICE_DATA *data)
+{
+    if (!data->Database_Revision_Valid || !data->Discovered_Revision_Valid) {
+        return false;
+    }
+    if (data->Database_Revision != data->Discovered_Revision) {
+        return false;
+    }
+    /* a restore from a backup could bring back an older revision */
+    if (data->Last_Restore_Time_Len != data->Discovered_Restore_Time_Len) {
+        return false;
+    }
+
+    return (memcmp(data->Last_Restore_Time, data->Discovered_Restore_Time,
+                data->Last_Restore_Time_Len) == 0);
+}
+
+/**
+ * @brief Keep the Database_Revision and Last_Restore_Time of a complete
+ *  discovery of a device
+ * @param data - device data
+ */
+static void bacnet_device_data_snapshot(BACNET_DEVICE_DATA *data)
+{
+    if (data->Discovery_Error) {
+        data->Discovered_Revision_Valid = false;
+        return;
+    }
+    data->Discovered_Revision = data->Database_Revision;
+    data->Discovered_Revision_Valid = data->Database_Revision_Valid;
+    memcpy(data->Discovered_Restore_Time, data->Last_Restore_Time,
+        data->Last_Restore_Time_Len);
+    data->Discovered_Restore_Time_Len = data->Last_Restore_Time_Len;
+}
+
+/**
+ * @brief Prepare to read the Object_List of a device again.  The objects
+ *  are kept, and the objects that are no longer listed are removed
+ *  once the Object_List has been read.
+ * @param data - device data
+ */
+static void bacnet_device_data_relist(BACNET_DEVICE_DATA *data)
+{
+    bacnet_object_data_unlist(data->Object_List);
+    data->Discovery_Error = false;
+}
+
+/**
+ * @brief Finish the discovery of a device, and rediscover it later
+ * @param device_data - Pointer to the device data structure
+ */
+static void bacnet_device_data_done(BACNET_DEVICE_DATA *device_data)
+{
+    /* track the duration */
+    device_data->Discovery_Elapsed_Milliseconds =
+        mstimer_elapsed(&device_data->Discovery_Timer);
+    /* rediscover in the future */
+    mstimer_set(&device_data->Discovery_Timer, Discovery_Milliseconds);
+    device_data->Discovery_State = BACNET_DISCOVER_STATE_DONE;
+}
+
 /**
  * @brief Add a new device to the device list
  * @param list - Keylist to add the device to
@@ -199,7 +353,7 @@ static BACNET_DEVICE_DATA *bacnet_device_data_add(uint32_t device_instance)
         data = Keylist_Data(Device_List, key);
         if (!data) {
             /* device is not in the list */
-            data = calloc(1, sizeof(BACNET_DEVICE_DATA));
+            data = bacnet_calloc(1, sizeof(BACNET_DEVICE_DATA));
             if (data) {
                 data->Object_List = Keylist_Create();
                 data->Discovery_State = BACNET_DISCOVER_STATE_INIT;
@@ -208,7 +362,7 @@ static BACNET_DEVICE_DATA *bacnet_device_data_add(uint32_t device_instance)
                 /* add to list */
                 index = Keylist_Data_Add(Device_List, key, data);
                 if (index < 0) {
-                    free(data);
+                    bacnet_free(data);
                     data = NULL;
                 }
             }
@@ -246,7 +400,7 @@ void bacnet_discover_cleanup(void)
         data = Keylist_Data_Pop(Device_List);
         if (data) {
             bacnet_object_data_cleanup(data->Object_List);
-            free(data);
+            bacnet_free(data);
         }
     } while (data);
     Keylist_Delete(Device_List);
@@ -386,6 +540,29 @@ unsigned long bacnet_discover_device_elapsed_milliseconds(uint32_t device_id)
     return milliseconds;
 }
 
+/**
+ * @brief Get the Database_Revision of a device from its last complete
+ *  discovery
+ * @param device_id - ID of the destination device
+ * @param revision [out] Database_Revision of the device
+ * @return true if the device was discovered with a Database_Revision
+ */
+bool bacnet_discover_device_database_revision(
+    uint32_t device_id, uint32_t *revision)
+{
+    BACNET_DEVICE_DATA *device_data;
+
+    device_data = bacnet_device_data(Device_List, device_id);
+    if (!device_data || !device_data->Discovered_Revision_Valid) {
+        return false;
+    }
+    if (revision) {
+        *revision = device_data->Discovered_Revision;
+    }
+
+    return true;
+}
+
 /**
  * @brief Get a property value from the device cache
  * @param device_id - ID of the destination device
@@ -580,6 +757,9 @@ static void bacnet_device_object_property_add(uint32_t device_id,
             if (rp_data->array_index <= device_data->Object_List_Size) {
                 object_data = bacnet_object_data_add(device_data->Object_List,
                     value->type.Object_Id.type, value->type.Object_Id.instance);
+                if (object_data) {
+                    object_data->Listed = true;
+                }
                 debug_printf("add %u object-list[%u] %s-%lu %s.\n", device_id,
                     device_data->Object_List_Index,
                     bactext_object_type_name(value->type.Object_Id.type),
@@ -593,6 +773,24 @@ static void bacnet_device_object_property_add(uint32_t device_id,
             }
         }
     } else {
+        if ((rp_data->object_type == OBJECT_DEVICE) &&
+            (rp_data->object_instance == device_id) &&
+            (rp_data->object_property == PROP_DATABASE_REVISION) &&
+            (value->tag == BACNET_APPLICATION_TAG_UNSIGNED_INT)) {
+            device_data->Database_Revision = value->type.Unsigned_Int;
+            device_data->Database_Revision_Valid = true;
+        }
+        if ((rp_data->object_type == OBJECT_DEVICE) &&
+            (rp_data->object_instance == device_id) &&
+            (rp_data->object_property == PROP_LAST_RESTORE_TIME) &&
+            (rp_data->application_data_len > 0) &&
+            (rp_data->application_data_len <=
+                BACNET_DISCOVER_RESTORE_TIME_SIZE)) {
+            memcpy(device_data->Last_Restore_Time, rp_data->application_data,
+                rp_data->application_data_len);
+            device_data->Last_Restore_Time_Len =
+                (uint8_t)rp_data->application_data_len;
+        }
         /* move to next state */
         if (device_data->Discovery_State ==
             BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST) {
@@ -619,9 +817,9 @@ static void bacnet_device_object_property_add(uint32_t device_id,
         if (rp_data->application_data_len > 0) {
             if (property_data->application_data_len !=
                 rp_data->application_data_len) {
-                free(property_data->application_data);
+                bacnet_free(property_data->application_data);
                 property_data->application_data =
-                    calloc(1, rp_data->application_data_len);
+                    bacnet_calloc(1, rp_data->application_data_len);
             }
             if (property_data->application_data) {
                 property_data->application_data_len =
@@ -635,7 +833,7 @@ static void bacnet_device_object_property_add(uint32_t device_id,
                     bactext_property_name(rp_data->object_property));
             }
         } else {
-            free(property_data->application_data);
+            bacnet_free(property_data->application_data);
             property_data->application_data = NULL;
             property_data->application_data_len = 0;
         }
@@ -716,6 +914,12 @@ static void bacnet_read_property_reply(uint32_t device_id,
         return;
     }
     if (rp_data->error_code != ERROR_CODE_SUCCESS) {
+        if ((rp_data->object_type == OBJECT_DEVICE) &&
+            (rp_data->object_instance == device_id) &&
+            (rp_data->object_property == PROP_OBJECT_LIST)) {
+            /* objects that are missing would be removed */
+            device_data->Discovery_Error = true;
+        }
         Device_Error_Handler(device_id, rp_data->error_code, device_data);
     } else if (value) {
         bacnet_device_object_property_add(
@@ -734,6 +938,7 @@ void bacnet_discover_device_fsm(
     KEY key = 0;
     BACNET_OBJECT_TYPE object_type = 0;
     uint32_t object_instance = 0;
+    BACNET_PROPERTY_ID object_property = PROP_ALL;
     bool status = false;
 
     if (!device_data) {
@@ -741,9 +946,33 @@ void bacnet_discover_device_fsm(
     }
     switch (device_data->Discovery_State) {
         case BACNET_DISCOVER_STATE_INIT:
+            device_data->Database_Revision_Valid = false;
+            device_data->Last_Restore_Time_Len = 0;
+            status = bacnet_read_property_queue(device_id, OBJECT_DEVICE,
+                device_id, PROP_DATABASE_REVISION, BACNET_ARRAY_ALL);
+            if (status) {
+                /* optional property */
+                (void)bacnet_read_property_queue(device_id, OBJECT_DEVICE,
+                    device_id, PROP_LAST_RESTORE_TIME, BACNET_ARRAY_ALL);
+                device_data->Discovery_State =
+                    BACNET_DISCOVER_STATE_REVISION_REQUEST;
+            } else {
+                debug_perror(
+                    "%u database-revision fail to queue!\n", device_id);
+            }
+            break;
+        case BACNET_DISCOVER_STATE_REVISION_REQUEST:
+            /* the task runs once the replies are in */
+            if (bacnet_device_data_unchanged(device_data)) {
+                debug_printf("%u database-revision=%lu unchanged.\n",
+                    device_id, (unsigned long)device_data->Database_Revision);
+                bacnet_device_data_done(device_data);
+                break;
+            }
             status = bacnet_read_property_queue(
                 device_id, OBJECT_DEVICE, device_id, PROP_OBJECT_LIST, 0);
             if (status) {
+                bacnet_device_data_relist(device_data);
                 device_data->Discovery_State =
                     BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST;
             } else {
@@ -783,6 +1012,9 @@ void bacnet_discover_device_fsm(
                     device_data->Object_List_Index--;
                 }
             } else {
+                if (!device_data->Discovery_Error) {
+                    bacnet_object_data_sweep(device_data->Object_List);
+                }
                 device_data->Object_List_Index = 0;
                 device_data->Discovery_State =
                     BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
@@ -793,17 +1025,22 @@ void bacnet_discover_device_fsm(
             break;
         case BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE:
             if (device_data->Object_List_Index <
-                device_data->Object_List_Size) {
+                (uint32_t)Keylist_Count(device_data->Object_List)) {
                 if (Keylist_Index_Key(device_data->Object_List,
                         device_data->Object_List_Index, &key)) {
                     object_type = KEY_DECODE_TYPE(key);
                     object_instance = KEY_DECODE_ID(key);
-                    debug_printf("%u object-list[%u] %s-%u read ALL.\n",
+                    object_property =
+                        bacnet_object_data_property(Keylist_Data_Index(
+                            device_data->Object_List,
+                            device_data->Object_List_Index));
+                    debug_printf("%u object-list[%u] %s-%u read %s.\n",
                         device_id, device_data->Object_List_Index,
                         bactext_object_type_name(object_type),
-                        (unsigned)object_instance);
+                        (unsigned)object_instance,
+                        bactext_property_name(object_property));
                     status = bacnet_read_property_queue(device_id, object_type,
-                        object_instance, PROP_ALL, BACNET_ARRAY_ALL);
+                        object_instance, object_property, BACNET_ARRAY_ALL);
                 }
                 if (status) {
                     device_data->Discovery_State =
@@ -816,13 +1053,8 @@ void bacnet_discover_device_fsm(
                         (unsigned)object_instance);
                 }
             } else {
-                /* track the duration */
-                device_data->Discovery_Elapsed_Milliseconds =
-                    mstimer_elapsed(&device_data->Discovery_Timer);
-                /* rediscover in the future */
-                mstimer_set(
-                    &device_data->Discovery_Timer, Discovery_Milliseconds);
-                device_data->Discovery_State = BACNET_DISCOVER_STATE_DONE;
+                bacnet_device_data_snapshot(device_data);
+                bacnet_device_data_done(device_data);
             }
             break;
         case BACNET_DISCOVER_STATE_DONE:
@@ -839,6 +1071,174 @@ void bacnet_discover_device_fsm(
     }
 }
 
+#if BACNET_DISCOVER_RPM_PLAN
+/**
+ * @brief Get the number of property reads that can be added to the
+ *  ReadPropertyMultiple planner
+ * @return number of property reads
+ */
+static unsigned bacnet_discover_plan_room(void)
+{
+    return BACNET_RPM_PLAN_READS_MAX - bacnet_rpm_plan_pending();
+}
+
+/**
+ * @brief Non-blocking task for running BACnet discover state machine
+ *  with the ReadPropertyMultiple planner. The reads of the Object_List
+ *  elements, and of all the properties of each object, are added to the
+ *  planner in chunks, which packs them into as few requests as the
+ *  device allows, and reads many devices at once.  A device whose
+ *  Database_Revision has not changed since its last complete discovery
+ *  is not read again.
+ * @param device_id - Device ID from discovered device
+ * @param device_data - Pointer to the device data structure
+ */
+static void bacnet_discover_device_plan_fsm(
+    uint32_t device_id, BACNET_DEVICE_DATA *device_data)
+{
+    BACNET_OBJECT_TYPE object_type = 0;
+    uint32_t object_instance = 0;
+    BACNET_PROPERTY_ID object_property = PROP_ALL;
+    unsigned count = 0;
+    unsigned object_count = 0;
+    KEY key = 0;
+
+    switch (device_data->Discovery_State) {
+        case BACNET_DISCOVER_STATE_INIT:
+            if (bacnet_discover_plan_room() < 3) {
+                break;
+            }
+            device_data->Database_Revision_Valid = false;
+            device_data->Last_Restore_Time_Len = 0;
+            if (bacnet_rpm_plan_read_add(device_id, OBJECT_DEVICE, device_id,
+                    PROP_DATABASE_REVISION, BACNET_ARRAY_ALL)) {
+                bacnet_rpm_plan_read_add(device_id, OBJECT_DEVICE, device_id,
+                    PROP_LAST_RESTORE_TIME, BACNET_ARRAY_ALL);
+                bacnet_rpm_plan_read_add(device_id, OBJECT_DEVICE, device_id,
+                    PROP_OBJECT_LIST, 0);
+                device_data->Discovery_State =
+                    BACNET_DISCOVER_STATE_PLAN_REVISION;
+            }
+            break;
+        case BACNET_DISCOVER_STATE_PLAN_REVISION:
+            if (!bacnet_rpm_plan_device_idle(device_id)) {
+                break;
+            }
+            if (bacnet_device_data_unchanged(device_data)) {
+                debug_printf("%u database-revision=%lu unchanged.\n",
+                    device_id, (unsigned long)device_data->Database_Revision);
+                bacnet_device_data_done(device_data);
+                break;
+            }
+            /* objects could have been created or deleted */
+            bacnet_device_data_relist(device_data);
+            device_data->Object_List_Index = 0;
+            device_data->Discovery_State =
+                BACNET_DISCOVER_STATE_PLAN_OBJECT_LIST;
+            break;
+        case BACNET_DISCOVER_STATE_PLAN_OBJECT_LIST:
+            while ((device_data->Object_List_Index <
+                       device_data->Object_List_Size) &&
+                (count < BACNET_DISCOVER_RPM_PLAN_CHUNK) &&
+                (bacnet_discover_plan_room() > 0)) {
+                if (!bacnet_rpm_plan_read_add(device_id, OBJECT_DEVICE,
+                        device_id, PROP_OBJECT_LIST,
+                        device_data->Object_List_Index + 1)) {
+                    break;
+                }
+                device_data->Object_List_Index++;
+                count++;
+            }
+            if ((device_data->Object_List_Index >=
+                    device_data->Object_List_Size) &&
+                bacnet_rpm_plan_device_idle(device_id)) {
+                if (!device_data->Discovery_Error) {
+                    bacnet_object_data_sweep(device_data->Object_List);
+                }
+                device_data->Object_List_Index = 0;
+                device_data->Discovery_State =
+                    BACNET_DISCOVER_STATE_PLAN_OBJECTS;
+            }
+            break;
+        case BACNET_DISCOVER_STATE_PLAN_OBJECTS:
+            object_count = Keylist_Count(device_data->Object_List);
+            while ((device_data->Object_List_Index < object_count) &&
+                (count < BACNET_DISCOVER_RPM_PLAN_CHUNK) &&
+                (bacnet_discover_plan_room() > 0)) {
+                if (!Keylist_Index_Key(device_data->Object_List,
+                        device_data->Object_List_Index, &key)) {
+                    device_data->Object_List_Index++;
+                    continue;
+                }
+                object_type = KEY_DECODE_TYPE(key);
+                object_instance = KEY_DECODE_ID(key);
+                object_property = bacnet_object_data_property(
+                    Keylist_Data_Index(device_data->Object_List,
+                        device_data->Object_List_Index));
+                if (!bacnet_rpm_plan_read_add(device_id, object_type,
+                        object_instance, object_property, BACNET_ARRAY_ALL)) {
+                    break;
+                }
+                device_data->Object_List_Index++;
+                count++;
+            }
+            if ((device_data->Object_List_Index >= object_count) &&
+                bacnet_rpm_plan_device_idle(device_id)) {
+                bacnet_device_data_snapshot(device_data);
+                bacnet_device_data_done(device_data);
+            }
+            break;
+        case BACNET_DISCOVER_STATE_DONE:
+            /* finished getting all the object properties */
+            if (mstimer_expired(&device_data->Discovery_Timer)) {
+                mstimer_set(&device_data->Discovery_Timer, 0);
+                device_data->Discovery_State = BACNET_DISCOVER_STATE_INIT;
+            }
+            break;
+        default:
+            device_data->Discovery_State = BACNET_DISCOVER_STATE_INIT;
+            break;
+    }
+}
+
+/**
+ * @brief Handler for I-Am responses, which adds the device to the
+ *  address cache, for the planner, and to the device list
+ * @param service_request [in] The received message to be handled.
+ * @param service_len [in] Length of the service_request message.
+ * @param src [in] The BACNET_ADDRESS of the message's source.
+ */
+static void bacnet_discover_i_am_handler(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    int len = 0;
+    uint32_t device_id = 0;
+    unsigned max_apdu = 0;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+    uint16_t vendor_id_filter = 0;
+
+    (void)service_len;
+    len = iam_decode_service_request(
+        service_request, &device_id, &max_apdu, &segmentation, &vendor_id);
+    if (len <= 0) {
+        return;
+    }
+    if (device_id == Device_Object_Instance_Number()) {
+        return;
+    }
+    vendor_id_filter = bacnet_read_write_vendor_id_filter();
+    if ((vendor_id_filter != 0) && (vendor_id_filter != vendor_id)) {
+        /* limit discovery to specific vendor ID */
+        return;
+    }
+    address_own_device_id_set(Device_Object_Instance_Number());
+    address_add(device_id, max_apdu, src);
+    address_segmentation_set(device_id, (BACNET_SEGMENTATION)segmentation);
+    bacnet_discover_device_add(device_id, max_apdu, segmentation, vendor_id);
+}
+#endif
+
 /**
  * @brief Adds a device to the device list
  * @param device_id - Device ID from discovered device
@@ -862,7 +1262,11 @@ static void bacnet_discover_devices_task(void)
         }
         if (Keylist_Index_Key(Device_List, device_index, &key)) {
             device_id = key;
+#if BACNET_DISCOVER_RPM_PLAN
+            bacnet_discover_device_plan_fsm(device_id, device_data);
+#else
             bacnet_discover_device_fsm(device_id, device_data);
+#endif
         }
     }
 }
@@ -1027,6 +1431,14 @@ void bacnet_discover_task(void)
         dest.net = Target_DNET;
         Send_WhoIs_To_Network(&dest, -1, -1);
     }
+#if BACNET_DISCOVER_RPM_PLAN
+    if (mstimer_expired(&Read_Write_Timer)) {
+        mstimer_restart(&Read_Write_Timer);
+        bacnet_rpm_plan_task();
+    }
+    /* every device adds its reads to the planner */
+    bacnet_discover_devices_task();
+#else
     if (mstimer_expired(&Read_Write_Timer)) {
         mstimer_restart(&Read_Write_Timer);
         bacnet_read_write_task();
@@ -1034,6 +1446,7 @@ void bacnet_discover_task(void)
     if (bacnet_read_write_idle()) {
         bacnet_discover_devices_task();
     }
+#endif
 }
 
 /**
@@ -1110,6 +1523,295 @@ unsigned long bacnet_discover_read_process_milliseconds(void)
     return mstimer_interval(&Read_Write_Timer);
 }
 
+/* snapshot file of the discovered devices: a header, and then each
+   device with its objects, and each object with its properties, as
+   big-endian values in the order they are listed */
+#define DISCOVER_SNAPSHOT_MAGIC "BDS1"
+#define DISCOVER_SNAPSHOT_MAGIC_SIZE 4
+/* the device has the Database_Revision of a complete discovery */
+#define DISCOVER_SNAPSHOT_REVISION BIT(0)
+
+/* reads the values of a snapshot from memory */
+struct discover_snapshot_reader {
+    uint8_t *data;
+    size_t size;
+    size_t offset;
+    bool error;
+};
+
+/**
+ * @brief Write a 32-bit value to a snapshot file
+ * @param file - snapshot file
+ * @param value - value to write
+ * @return true if the value was written
+ */
+static bool discover_snapshot_write_u32(FILE *file, uint32_t value)
+{
+    uint8_t buffer[4];
+
+    encode_unsigned32(buffer, value);
+
+    return (fwrite(buffer, 1, sizeof(buffer), file) == sizeof(buffer));
+}
+
+/**
+ * @brief Take some octets from a snapshot
+ * @param reader - snapshot reader
+ * @param len - number of octets
+ * @return the octets, or NULL if the snapshot is too short
+ */
+static uint8_t *
+discover_snapshot_octets(struct discover_snapshot_reader *reader, size_t len)
+{
+    uint8_t *octets;
+
+    if (reader->error || ((reader->size - reader->offset) < len)) {
+        reader->error = true;
+        return NULL;
+    }
+    octets = &reader->data[reader->offset];
+    reader->offset += len;
+
+    return octets;
+}
+
+/**
+ * @brief Take a 32-bit value from a snapshot
+ * @param reader - snapshot reader
+ * @return the value, or zero if the snapshot is too short
+ */
+static uint32_t discover_snapshot_u32(struct discover_snapshot_reader *reader)
+{
+    uint32_t value = 0;
+    uint8_t *octets;
+
+    octets = discover_snapshot_octets(reader, 4);
+    if (octets) {
+        decode_unsigned32(octets, &value);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Save the discovered devices, objects and properties to a
+ *  snapshot file, so that an application can start from the snapshot
+ *  rather than from an empty list
+ * @param pathname - name of the snapshot file
+ * @return true if the snapshot was saved
+ */
+bool bacnet_discover_save(const char *pathname)
+{
+    BACNET_DEVICE_DATA *device;
+    BACNET_OBJECT_DATA *object;
+    BACNET_PROPERTY_DATA *property;
+    int device_index, object_index, property_index;
+    int device_count, object_count, property_count;
+    uint8_t header[4];
+    KEY key;
+    bool status;
+    FILE *file;
+
+    if (!pathname || !Device_List) {
+        return false;
+    }
+    file = fopen(pathname, "wb");
+    if (!file) {
+        return false;
+    }
+    device_count = Keylist_Count(Device_List);
+    status = (fwrite(DISCOVER_SNAPSHOT_MAGIC, 1, DISCOVER_SNAPSHOT_MAGIC_SIZE,
+                  file) == DISCOVER_SNAPSHOT_MAGIC_SIZE);
+    status = status && discover_snapshot_write_u32(file, device_count);
+    for (device_index = 0; status && (device_index < device_count);
+         device_index++) {
+        device = Keylist_Data_Index(Device_List, device_index);
+        status = device && Keylist_Index_Key(Device_List, device_index, &key);
+        if (!status) {
+            break;
+        }
+        header[0] = 0;
+        if (device->Discovered_Revision_Valid) {
+            header[0] |= DISCOVER_SNAPSHOT_REVISION;
+        }
+        header[1] = device->Discovered_Restore_Time_Len;
+        object_count = Keylist_Count(device->Object_List);
+        status = discover_snapshot_write_u32(file, key) &&
+            discover_snapshot_write_u32(file, device->Discovered_Revision) &&
+            (fwrite(header, 1, 2, file) == 2) &&
+            (fwrite(device->Discovered_Restore_Time, 1, header[1], file) ==
+                header[1]) &&
+            discover_snapshot_write_u32(file, object_count);
+        for (object_index = 0; status && (object_index < object_count);
+             object_index++) {
+            object = Keylist_Data_Index(device->Object_List, object_index);
+            status = object &&
+                Keylist_Index_Key(device->Object_List, object_index, &key);
+            if (!status) {
+                break;
+            }
+            property_count = Keylist_Count(object->Property_List);
+            status = discover_snapshot_write_u32(file, key) &&
+                discover_snapshot_write_u32(file, property_count);
+            for (property_index = 0;
+                 status && (property_index < property_count);
+                 property_index++) {
+                property =
+                    Keylist_Data_Index(object->Property_List, property_index);
+                status = property &&
+                    Keylist_Index_Key(
+                        object->Property_List, property_index, &key);
+                if (!status) {
+                    break;
+                }
+                status = discover_snapshot_write_u32(file, key) &&
+                    discover_snapshot_write_u32(
+                        file, property->application_data_len) &&
+                    (fwrite(property->application_data, 1,
+                         property->application_data_len, file) ==
+                        (size_t)property->application_data_len);
+            }
+        }
+    }
+    if (fclose(file) != 0) {
+        status = false;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Add the properties of one object from a snapshot
+ * @param reader - snapshot reader
+ * @param object - object data
+ */
+static void discover_snapshot_object_load(
+    struct discover_snapshot_reader *reader, BACNET_OBJECT_DATA *object)
+{
+    BACNET_PROPERTY_DATA *property;
+    uint32_t property_count, i;
+    uint32_t len;
+    uint8_t *octets;
+    KEY key;
+
+    property_count = discover_snapshot_u32(reader);
+    for (i = 0; !reader->error && (i < property_count); i++) {
+        key = discover_snapshot_u32(reader);
+        len = discover_snapshot_u32(reader);
+        octets = discover_snapshot_octets(reader, len);
+        if (!octets || (len > INT_MAX)) {
+            reader->error = true;
+            break;
+        }
+        property = bacnet_property_data_add(object->Property_List, key);
+        if (!property) {
+            continue;
+        }
+        bacnet_free(property->application_data);
+        property->application_data = NULL;
+        property->application_data_len = 0;
+        if (len > 0) {
+            property->application_data = bacnet_malloc(len);
+            if (property->application_data) {
+                memcpy(property->application_data, octets, len);
+                property->application_data_len = (int)len;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Add the devices, objects and properties of a snapshot file
+ *  to the discovered devices. Call after bacnet_discover_init().
+ *  A device from the snapshot is discovered again only when its
+ *  Database_Revision or Last_Restore_Time has changed.
+ * @param pathname - name of the snapshot file
+ * @return true if the whole snapshot was loaded
+ */
+bool bacnet_discover_load(const char *pathname)
+{
+    struct discover_snapshot_reader reader = { 0 };
+    BACNET_DEVICE_DATA *device;
+    BACNET_OBJECT_DATA *object;
+    uint32_t device_count, object_count, device_id, i, j;
+    uint32_t revision;
+    uint8_t *octets;
+    uint8_t flags, len;
+    long file_size;
+    KEY key;
+    FILE *file;
+
+    if (!pathname || !Device_List) {
+        return false;
+    }
+    file = fopen(pathname, "rb");
+    if (!file) {
+        return false;
+    }
+    /* the whole snapshot is read at once, and decoded in memory */
+    if ((fseek(file, 0, SEEK_END) == 0) && ((file_size = ftell(file)) > 0) &&
+        (fseek(file, 0, SEEK_SET) == 0)) {
+        reader.data = bacnet_malloc((size_t)file_size);
+        if (reader.data) {
+            reader.size = fread(reader.data, 1, (size_t)file_size, file);
+        }
+    }
+    fclose(file);
+    octets = discover_snapshot_octets(&reader, DISCOVER_SNAPSHOT_MAGIC_SIZE);
+    if (!octets ||
+        (memcmp(octets, DISCOVER_SNAPSHOT_MAGIC,
+             DISCOVER_SNAPSHOT_MAGIC_SIZE) != 0)) {
+        bacnet_free(reader.data);
+        return false;
+    }
+    device_count = discover_snapshot_u32(&reader);
+    for (i = 0; !reader.error && (i < device_count); i++) {
+        device_id = discover_snapshot_u32(&reader);
+        revision = discover_snapshot_u32(&reader);
+        octets = discover_snapshot_octets(&reader, 2);
+        if (!octets || (octets[1] > BACNET_DISCOVER_RESTORE_TIME_SIZE)) {
+            reader.error = true;
+            break;
+        }
+        flags = octets[0];
+        len = octets[1];
+        octets = discover_snapshot_octets(&reader, len);
+        object_count = discover_snapshot_u32(&reader);
+        if (reader.error || (device_id >= BACNET_MAX_INSTANCE)) {
+            reader.error = true;
+            break;
+        }
+        device = bacnet_device_data_add(device_id);
+        if (!device) {
+            reader.error = true;
+            break;
+        }
+        device->Discovered_Revision = revision;
+        device->Discovered_Revision_Valid =
+            (flags & DISCOVER_SNAPSHOT_REVISION) != 0;
+        memcpy(device->Discovered_Restore_Time, octets, len);
+        device->Discovered_Restore_Time_Len = len;
+        device->Object_List_Size = object_count;
+        for (j = 0; !reader.error && (j < object_count); j++) {
+            key = discover_snapshot_u32(&reader);
+            if (reader.error) {
+                break;
+            }
+            object = bacnet_object_data_add(
+                device->Object_List, KEY_DECODE_TYPE(key), KEY_DECODE_ID(key));
+            if (!object) {
+                reader.error = true;
+                break;
+            }
+            object->Listed = true;
+            discover_snapshot_object_load(&reader, object);
+        }
+    }
+    bacnet_free(reader.data);
+
+    return !reader.error;
+}
+
 /**
  * Save the I-Am service data to a data store
  *
@@ -1139,7 +1841,11 @@ void bacnet_discover_device_add(uint32_t device_instance,
 void bacnet_discover_init(void)
 {
     Device_List = Keylist_Create();
+#if BACNET_DISCOVER_RPM_PLAN
+    bacnet_rpm_plan_init();
+#else
     bacnet_read_write_init();
+#endif
     /* default value in case it is not set */
     if (!mstimer_interval(&WhoIs_Timer)) {
         mstimer_set(&WhoIs_Timer, 5UL * 60UL * 1000UL);
@@ -1150,6 +1856,12 @@ void bacnet_discover_init(void)
     if (!mstimer_interval(&Read_Write_Timer)) {
         mstimer_set(&Read_Write_Timer, 10);
     }
+#if BACNET_DISCOVER_RPM_PLAN
+    bacnet_rpm_plan_value_callback_set(bacnet_read_property_reply);
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_I_AM, bacnet_discover_i_am_handler);
+#else
     bacnet_read_write_value_callback_set(bacnet_read_property_reply);
     bacnet_read_write_device_callback_set(bacnet_discover_device_add);
+#endif
 }
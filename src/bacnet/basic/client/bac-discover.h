@@ -15,6 +15,15 @@
 #include "bacnet/bacapp.h"
 #include "bacnet/rp.h"
 
+/* use the ReadPropertyMultiple planner to discover many devices at once */
+#ifndef BACNET_DISCOVER_RPM_PLAN
+#define BACNET_DISCOVER_RPM_PLAN 0
+#endif
+/* number of reads given to the planner for each device in each task */
+#ifndef BACNET_DISCOVER_RPM_PLAN_CHUNK
+#define BACNET_DISCOVER_RPM_PLAN_CHUNK 32
+#endif
+
 /**
  * @brief Callback function for iterating the results of the device discovery.
  * @param device_id [in] The device ID of the data
@@ -53,6 +62,9 @@ BACNET_STACK_EXPORT
 unsigned long bacnet_discover_device_elapsed_milliseconds(
     uint32_t device_id);
 BACNET_STACK_EXPORT
+bool bacnet_discover_device_database_revision(
+    uint32_t device_id, uint32_t *revision);
+BACNET_STACK_EXPORT
 size_t bacnet_discover_device_memory(
     uint32_t device_id);
 BACNET_STACK_EXPORT
@@ -126,6 +138,11 @@ void bacnet_discover_device_add(
     int segmentation,
     uint16_t vendor_id);
 
+BACNET_STACK_EXPORT
+bool bacnet_discover_save(const char *pathname);
+BACNET_STACK_EXPORT
+bool bacnet_discover_load(const char *pathname);
+
 BACNET_STACK_EXPORT
 void bacnet_discover_init(void);
 
@@ -0,0 +1,722 @@
+/**
+ * @file
+ * @brief Read every object and property of a BACnet device.
+ *
+ * The elements of the Object_List are read in chunks, and as soon as an
+ * element is known, all the properties of its object are read with one
+ * ReadPropertyMultiple request.  The ReadPropertyMultiple planner keeps
+ * a window of requests in flight to the device, so the network stays
+ * busy.  Only an object whose read of all its properties fails is read
+ * again one property at a time, from the list of the required, and
+ * optionally the optional, properties of its object type.
+ *
+ * The objects are taken in the order of the Object_List, the Device
+ * object first, once all their reads are finished.  The objects that
+ * are read, or are waiting to be taken, are bounded, so formatting the
+ * objects is a separate stage that only slows the reads down when it
+ * falls behind.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/property.h"
+#include "bacnet/rp.h"
+#include "bacnet/basic/sys/static_pool.h"
+#include "bacnet/basic/client/bac-rpm.h"
+/* me */
+#include "bacnet/basic/client/bac-dump.h"
+
+/* the state of an element of the Object_List */
+#define DUMP_ELEMENT_UNKNOWN 0
+#define DUMP_ELEMENT_KNOWN 1
+#define DUMP_ELEMENT_FAILED 2
+
+/* the device that is read */
+static bool Dump_Running;
+static bool Dump_Failed;
+static uint32_t Dump_Device_ID;
+static bool Dump_Optional;
+/* the elements of the Object_List, from index 1 */
+static BACNET_OBJECT_ID *Dump_List;
+static uint8_t *Dump_List_State;
+static uint32_t Dump_List_Size;
+static bool Dump_List_Size_Known;
+/* the size could not be read, so the whole list is read at once */
+static bool Dump_List_All;
+static bool Dump_List_All_Added;
+/* next element to read, and the list reads that are not finished */
+static uint32_t Dump_List_Next;
+static unsigned Dump_List_Pending;
+/* next element whose object is read */
+static uint32_t Dump_Object_Next;
+/* the objects being read, or waiting to be taken, in the list order */
+static BACNET_DUMP_OBJECT *Dump_Object[BACNET_DUMP_OBJECTS_MAX];
+static unsigned Dump_Object_Head;
+static unsigned Dump_Object_Count;
+
+/**
+ * @brief Get the number of property reads that can be added to the
+ *  ReadPropertyMultiple planner
+ * @return number of property reads
+ */
+static unsigned bacnet_dump_plan_room(void)
+{
+    return BACNET_RPM_PLAN_READS_MAX - bacnet_rpm_plan_pending();
+}
+
+/**
+ * @brief Find an object that is being read
+ * @param object_type [in] the object type
+ * @param object_instance [in] the object instance
+ * @return the object, or NULL if not found
+ */
+static BACNET_DUMP_OBJECT *
+bacnet_dump_object_find(BACNET_OBJECT_TYPE object_type, uint32_t instance)
+{
+    BACNET_DUMP_OBJECT *object;
+    unsigned i;
+
+    for (i = 0; i < Dump_Object_Count; i++) {
+        object = Dump_Object[(Dump_Object_Head + i) % BACNET_DUMP_OBJECTS_MAX];
+        if ((object->object_type == object_type) &&
+            (object->object_instance == instance)) {
+            return object;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Add a property to an object
+ * @param object [in] the object
+ * @param rp_data [in] the property, and its value or error
+ * @return true if the property was added
+ */
+static bool bacnet_dump_property_add(
+    BACNET_DUMP_OBJECT *object, const BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    BACNET_DUMP_PROPERTY *property;
+    uint8_t *data = NULL;
+
+    property = bacnet_realloc(object->property,
+        (object->property_count + 1) * sizeof(BACNET_DUMP_PROPERTY));
+    if (!property) {
+        return false;
+    }
+    object->property = property;
+    if ((rp_data->error_code == ERROR_CODE_SUCCESS) &&
+        (rp_data->application_data_len > 0)) {
+        data = bacnet_malloc((size_t)rp_data->application_data_len);
+        if (!data) {
+            return false;
+        }
+        memcpy(data, rp_data->application_data,
+            (size_t)rp_data->application_data_len);
+    }
+    property = &object->property[object->property_count];
+    property->object_property = rp_data->object_property;
+    property->error_class = rp_data->error_class;
+    property->error_code = rp_data->error_code;
+    property->application_data = data;
+    property->application_data_len =
+        data ? (size_t)rp_data->application_data_len : 0;
+    object->property_count++;
+
+    return true;
+}
+
+/**
+ * @brief Make room for the elements of the Object_List
+ * @param size [in] the number of elements
+ * @return true if there is room
+ */
+static bool bacnet_dump_list_resize(uint32_t size)
+{
+    BACNET_OBJECT_ID *list;
+    uint8_t *state;
+
+    if (size <= Dump_List_Size) {
+        return true;
+    }
+    list = bacnet_realloc(Dump_List, (size + 1) * sizeof(BACNET_OBJECT_ID));
+    if (!list) {
+        return false;
+    }
+    Dump_List = list;
+    state = bacnet_realloc(Dump_List_State, (size + 1) * sizeof(uint8_t));
+    if (!state) {
+        return false;
+    }
+    Dump_List_State = state;
+    memset(&Dump_List_State[Dump_List_Size + 1], DUMP_ELEMENT_UNKNOWN,
+        size - Dump_List_Size);
+    Dump_List_Size = size;
+
+    return true;
+}
+
+/**
+ * @brief Store the result of a read of the Object_List, which is either
+ *  the size, an element, or all the elements of the list
+ * @param rp_data [in] the property data, or the error, of the read
+ * @param value [in] the decoded value, or NULL
+ */
+static void bacnet_dump_list_value(
+    const BACNET_READ_PROPERTY_DATA *rp_data,
+    const BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_ARRAY_INDEX index = rp_data->array_index;
+
+    if ((rp_data->error_code != ERROR_CODE_SUCCESS) || !value) {
+        if (index == 0) {
+            /* read the whole list instead */
+            Dump_List_All = true;
+        } else if (index == BACNET_ARRAY_ALL) {
+            if (Dump_List_All) {
+                Dump_Failed = true;
+            }
+        } else if (index <= Dump_List_Size) {
+            Dump_List_State[index] = DUMP_ELEMENT_FAILED;
+        }
+        return;
+    }
+    if (index == 0) {
+        if (!Dump_List_Size_Known &&
+            (value->tag == BACNET_APPLICATION_TAG_UNSIGNED_INT)) {
+            if (bacnet_dump_list_resize(value->type.Unsigned_Int)) {
+                Dump_List_Size_Known = true;
+            } else {
+                Dump_Failed = true;
+            }
+        }
+        return;
+    }
+    if (value->tag != BACNET_APPLICATION_TAG_OBJECT_ID) {
+        return;
+    }
+    if (index == BACNET_ARRAY_ALL) {
+        /* a list with only one element */
+        index = 1;
+    }
+    if (Dump_List_All && !bacnet_dump_list_resize(index)) {
+        Dump_Failed = true;
+        return;
+    }
+    if (index <= Dump_List_Size) {
+        Dump_List[index].type = value->type.Object_Id.type;
+        Dump_List[index].instance = value->type.Object_Id.instance;
+        Dump_List_State[index] = DUMP_ELEMENT_KNOWN;
+    }
+}
+
+/**
+ * @brief Store the result of a property read of the device
+ * @param device_id [in] device instance number where data originated
+ * @param rp_data [in] the property data, or the error, of the read
+ * @param value [in] the decoded value, or NULL
+ */
+static void bacnet_dump_value(uint32_t device_id,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_DUMP_OBJECT *object;
+
+    if (!Dump_Running || (device_id != Dump_Device_ID)) {
+        return;
+    }
+    if ((rp_data->object_type == OBJECT_DEVICE) &&
+        (rp_data->object_instance == Dump_Device_ID) &&
+        (rp_data->object_property == PROP_OBJECT_LIST)) {
+        /* the Object_List of the Device object is made from its
+           elements, which could also be in the read of all properties */
+        bacnet_dump_list_value(rp_data, value);
+        return;
+    }
+    object = bacnet_dump_object_find(
+        rp_data->object_type, rp_data->object_instance);
+    if (!object || object->done) {
+        return;
+    }
+    if ((rp_data->object_property == PROP_ALL) ||
+        (rp_data->object_property == PROP_REQUIRED) ||
+        (rp_data->object_property == PROP_OPTIONAL)) {
+        /* the read of all the properties failed */
+        object->failed = true;
+        return;
+    }
+    if (rp_data->error_code != ERROR_CODE_SUCCESS) {
+        if (object->individual &&
+            (rp_data->error_code == ERROR_CODE_UNKNOWN_PROPERTY)) {
+            /* the object does not have this optional property */
+            return;
+        }
+    } else if ((rp_data->array_index != BACNET_ARRAY_ALL) &&
+        (rp_data->array_index > 1)) {
+        /* the whole array was stored with its first element */
+        return;
+    }
+    if (!bacnet_dump_property_add(object, rp_data)) {
+        object->failed = true;
+    }
+}
+
+/**
+ * @brief Note that a property read of the device is finished
+ * @param device_id [in] device instance number of the read
+ * @param rp_data [in] the object, property and array index of the read
+ */
+static void
+bacnet_dump_read_done(uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    BACNET_DUMP_OBJECT *object;
+
+    if (!Dump_Running || (device_id != Dump_Device_ID)) {
+        return;
+    }
+    if ((rp_data->object_type == OBJECT_DEVICE) &&
+        (rp_data->object_instance == Dump_Device_ID) &&
+        (rp_data->object_property == PROP_OBJECT_LIST)) {
+        if (Dump_List_Pending > 0) {
+            Dump_List_Pending--;
+        }
+        return;
+    }
+    object = bacnet_dump_object_find(
+        rp_data->object_type, rp_data->object_instance);
+    if (object && (object->pending > 0)) {
+        object->pending--;
+    }
+}
+
+/**
+ * @brief Determine if all the elements of the Object_List were read
+ * @return true if the reads of the list are finished
+ */
+static bool bacnet_dump_list_finished(void)
+{
+    if (Dump_Failed) {
+        return true;
+    }
+    if (Dump_List_Pending > 0) {
+        return false;
+    }
+    if (Dump_List_All) {
+        return Dump_List_All_Added;
+    }
+
+    return Dump_List_Size_Known && (Dump_List_Next > Dump_List_Size);
+}
+
+/**
+ * @brief Add the Object_List to the Device object, from its elements
+ * @param object [in] the Device object
+ */
+static void bacnet_dump_device_object_list(BACNET_DUMP_OBJECT *object)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    uint8_t *apdu;
+    uint32_t i;
+    int len = 0;
+
+    apdu = bacnet_malloc((Dump_List_Size + 1) * 5);
+    if (!apdu) {
+        return;
+    }
+    for (i = 1; i <= Dump_List_Size; i++) {
+        if (Dump_List_State[i] == DUMP_ELEMENT_KNOWN) {
+            len += encode_application_object_id(
+                &apdu[len], Dump_List[i].type, Dump_List[i].instance);
+        }
+    }
+    rp_data.object_type = object->object_type;
+    rp_data.object_instance = object->object_instance;
+    rp_data.object_property = PROP_OBJECT_LIST;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.error_class = ERROR_CLASS_SERVICES;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    rp_data.application_data = apdu;
+    rp_data.application_data_len = len;
+    if (len == 0) {
+        rp_data.error_class = ERROR_CLASS_PROPERTY;
+        rp_data.error_code = ERROR_CODE_OTHER;
+    }
+    (void)bacnet_dump_property_add(object, &rp_data);
+    bacnet_free(apdu);
+}
+
+/**
+ * @brief Get a property that is read when an object is read one
+ *  property at a time
+ * @param object [in] the object
+ * @param index [in] the index of the property
+ * @param property [out] the property
+ * @return true if the index is a property of the object
+ */
+static bool bacnet_dump_property_list(
+    const BACNET_DUMP_OBJECT *object, unsigned index, int32_t *property)
+{
+    struct special_property_list_t list = { 0 };
+
+    property_list_special(object->object_type, &list);
+    if (index < list.Required.count) {
+        *property = list.Required.pList[index];
+        return true;
+    }
+    index -= list.Required.count;
+    if (Dump_Optional && (index < list.Optional.count)) {
+        *property = list.Optional.pList[index];
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Read the properties of an object one at a time, as many as
+ *  the planner has room for
+ * @param object [in] the object
+ * @return true if all the properties were added
+ */
+static bool bacnet_dump_object_individual(BACNET_DUMP_OBJECT *object)
+{
+    int32_t property = 0;
+
+    while (bacnet_dump_property_list(
+        object, object->next_property, &property)) {
+        if ((object->object_type == OBJECT_DEVICE) &&
+            (property == PROP_OBJECT_LIST)) {
+            /* made from the elements of the list */
+            object->next_property++;
+            continue;
+        }
+        if ((bacnet_dump_plan_room() == 0) ||
+            !bacnet_rpm_plan_read_add(Dump_Device_ID, object->object_type,
+                object->object_instance, (BACNET_PROPERTY_ID)property,
+                BACNET_ARRAY_ALL)) {
+            return false;
+        }
+        object->pending++;
+        object->next_property++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Continue the reads of an object, and see if it is finished
+ * @param object [in] the object
+ */
+static void bacnet_dump_object_task(BACNET_DUMP_OBJECT *object)
+{
+    unsigned i;
+
+    if (object->done) {
+        return;
+    }
+    if (object->failed && !object->individual && (object->pending == 0)) {
+        /* read one property at a time, instead of all at once */
+        for (i = 0; i < object->property_count; i++) {
+            bacnet_free(object->property[i].application_data);
+        }
+        object->property_count = 0;
+        object->individual = true;
+        object->failed = false;
+        object->next_property = 0;
+    }
+    if (object->individual && !bacnet_dump_object_individual(object)) {
+        return;
+    }
+    if (object->pending > 0) {
+        return;
+    }
+    if ((object->object_type == OBJECT_DEVICE) &&
+        (object->object_instance == Dump_Device_ID)) {
+        if (!bacnet_dump_list_finished()) {
+            return;
+        }
+        bacnet_dump_device_object_list(object);
+    }
+    object->done = true;
+}
+
+/**
+ * @brief Start to read all the properties of an object
+ * @param object_type [in] the object type
+ * @param object_instance [in] the object instance
+ * @return true if the object was started
+ */
+static bool
+bacnet_dump_object_start(BACNET_OBJECT_TYPE object_type, uint32_t instance)
+{
+    BACNET_DUMP_OBJECT *object;
+
+    if ((Dump_Object_Count >= BACNET_DUMP_OBJECTS_MAX) ||
+        (bacnet_dump_plan_room() == 0)) {
+        return false;
+    }
+    object = bacnet_calloc(1, sizeof(BACNET_DUMP_OBJECT));
+    if (!object) {
+        return false;
+    }
+    object->object_type = object_type;
+    object->object_instance = instance;
+    if (!bacnet_rpm_plan_read_add(Dump_Device_ID, object_type, instance,
+            PROP_ALL, BACNET_ARRAY_ALL)) {
+        bacnet_free(object);
+        return false;
+    }
+    object->pending = 1;
+    Dump_Object[(Dump_Object_Head + Dump_Object_Count) %
+        BACNET_DUMP_OBJECTS_MAX] = object;
+    Dump_Object_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Add the reads of the Object_List, one chunk at a time
+ */
+static void bacnet_dump_list_task(void)
+{
+    unsigned count = 0;
+
+    if (Dump_List_All) {
+        if (!Dump_List_All_Added && (bacnet_dump_plan_room() > 0) &&
+            bacnet_rpm_plan_read_add(Dump_Device_ID, OBJECT_DEVICE,
+                Dump_Device_ID, PROP_OBJECT_LIST, BACNET_ARRAY_ALL)) {
+            Dump_List_All_Added = true;
+            Dump_List_Pending++;
+        }
+        return;
+    }
+    if (!Dump_List_Size_Known) {
+        return;
+    }
+    while ((Dump_List_Next <= Dump_List_Size) &&
+        (count < BACNET_DUMP_LIST_CHUNK) && (bacnet_dump_plan_room() > 0)) {
+        if (Dump_List_State[Dump_List_Next] == DUMP_ELEMENT_UNKNOWN) {
+            if (!bacnet_rpm_plan_read_add(Dump_Device_ID, OBJECT_DEVICE,
+                    Dump_Device_ID, PROP_OBJECT_LIST, Dump_List_Next)) {
+                break;
+            }
+            Dump_List_Pending++;
+            count++;
+        }
+        Dump_List_Next++;
+    }
+}
+
+/**
+ * @brief Handles the repetitive task of reading the device: adds the
+ *  reads of the Object_List and of the objects, and runs the planner
+ */
+void bacnet_dump_task(void)
+{
+    unsigned i;
+
+    bacnet_rpm_plan_task();
+    if (!Dump_Running) {
+        return;
+    }
+    bacnet_dump_list_task();
+    for (i = 0; i < Dump_Object_Count; i++) {
+        bacnet_dump_object_task(
+            Dump_Object[(Dump_Object_Head + i) % BACNET_DUMP_OBJECTS_MAX]);
+    }
+    /* start the objects whose element of the list is known */
+    while (!Dump_Failed && (Dump_Object_Next <= Dump_List_Size)) {
+        if (Dump_List_State[Dump_Object_Next] == DUMP_ELEMENT_UNKNOWN) {
+            if (!bacnet_dump_list_finished()) {
+                break;
+            }
+            /* the element was never read */
+            Dump_List_State[Dump_Object_Next] = DUMP_ELEMENT_FAILED;
+        }
+        if ((Dump_List_State[Dump_Object_Next] == DUMP_ELEMENT_KNOWN) &&
+            (Dump_List[Dump_Object_Next].type != OBJECT_DEVICE)) {
+            if (!bacnet_dump_object_start(
+                    (BACNET_OBJECT_TYPE)Dump_List[Dump_Object_Next].type,
+                    Dump_List[Dump_Object_Next].instance)) {
+                break;
+            }
+        }
+        Dump_Object_Next++;
+    }
+}
+
+/**
+ * @brief Take the next object that was read, in the order of the
+ *  Object_List with the Device object first
+ * @return the object, to be freed with bacnet_dump_object_free(),
+ *  or NULL if the next object is not finished yet
+ */
+BACNET_DUMP_OBJECT *bacnet_dump_object_take(void)
+{
+    BACNET_DUMP_OBJECT *object;
+
+    if (Dump_Object_Count == 0) {
+        return NULL;
+    }
+    object = Dump_Object[Dump_Object_Head];
+    if (!object->done) {
+        return NULL;
+    }
+    Dump_Object_Head = (Dump_Object_Head + 1) % BACNET_DUMP_OBJECTS_MAX;
+    Dump_Object_Count--;
+
+    return object;
+}
+
+/**
+ * @brief Free an object that was taken
+ * @param object [in] the object
+ */
+void bacnet_dump_object_free(BACNET_DUMP_OBJECT *object)
+{
+    unsigned i;
+
+    if (!object) {
+        return;
+    }
+    for (i = 0; i < object->property_count; i++) {
+        bacnet_free(object->property[i].application_data);
+    }
+    bacnet_free(object->property);
+    bacnet_free(object);
+}
+
+/**
+ * @brief Determine if the device was read, and all its objects taken
+ * @return true if the device was read
+ */
+bool bacnet_dump_finished(void)
+{
+    if (!Dump_Running) {
+        return true;
+    }
+    if (Dump_Object_Count > 0) {
+        return false;
+    }
+    if (Dump_Failed) {
+        return true;
+    }
+
+    return bacnet_dump_list_finished() && (Dump_Object_Next > Dump_List_Size);
+}
+
+/**
+ * @brief Determine if the Object_List of the device could not be read,
+ *  so that only the Device object was read
+ * @return true if the Object_List could not be read
+ */
+bool bacnet_dump_failed(void)
+{
+    return Dump_Failed;
+}
+
+/**
+ * @brief Get the number of elements of the Object_List of the device
+ * @return number of objects of the device, including the Device object
+ */
+unsigned bacnet_dump_object_count(void)
+{
+    return Dump_List_Size;
+}
+
+/**
+ * @brief Set the number of ReadPropertyMultiple requests in flight
+ *  to the device
+ * @param requests - number of requests, at least 1
+ */
+void bacnet_dump_window_set(unsigned requests)
+{
+    bacnet_rpm_plan_concurrency_set(requests);
+}
+
+/**
+ * @brief Get the number of ReadPropertyMultiple requests in flight
+ *  to the device
+ * @return number of requests
+ */
+unsigned bacnet_dump_window(void)
+{
+    return bacnet_rpm_plan_concurrency();
+}
+
+/**
+ * @brief Free the objects and the list of a previous device
+ */
+static void bacnet_dump_cleanup(void)
+{
+    while (Dump_Object_Count > 0) {
+        bacnet_dump_object_free(Dump_Object[Dump_Object_Head]);
+        Dump_Object_Head = (Dump_Object_Head + 1) % BACNET_DUMP_OBJECTS_MAX;
+        Dump_Object_Count--;
+    }
+    Dump_Object_Head = 0;
+    bacnet_free(Dump_List);
+    Dump_List = NULL;
+    bacnet_free(Dump_List_State);
+    Dump_List_State = NULL;
+    Dump_List_Size = 0;
+}
+
+/**
+ * @brief Start to read every object and property of a device
+ * @param device_id [in] the device instance number
+ * @param optional [in] true to read the optional properties too, for
+ *  the objects that are read one property at a time
+ * @return true if the reads were started
+ */
+bool bacnet_dump_start(uint32_t device_id, bool optional)
+{
+    if (device_id >= BACNET_MAX_INSTANCE) {
+        return false;
+    }
+    bacnet_dump_cleanup();
+    Dump_Device_ID = device_id;
+    Dump_Optional = optional;
+    Dump_Failed = false;
+    Dump_List_Size_Known = false;
+    Dump_List_All = false;
+    Dump_List_All_Added = false;
+    Dump_List_Next = 1;
+    Dump_List_Pending = 0;
+    Dump_Object_Next = 1;
+    Dump_Running = true;
+    if (!bacnet_rpm_plan_read_add(
+            device_id, OBJECT_DEVICE, device_id, PROP_OBJECT_LIST, 0)) {
+        Dump_Running = false;
+        return false;
+    }
+    Dump_List_Pending++;
+    if (!bacnet_dump_object_start(OBJECT_DEVICE, device_id)) {
+        Dump_Running = false;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Initialize the reads, and the ReadPropertyMultiple planner
+ *  that sends them
+ */
+void bacnet_dump_init(void)
+{
+    bacnet_rpm_plan_init();
+    bacnet_rpm_plan_value_callback_set(bacnet_dump_value);
+    bacnet_rpm_plan_done_callback_set(bacnet_dump_read_done);
+    bacnet_dump_cleanup();
+    Dump_Running = false;
+}
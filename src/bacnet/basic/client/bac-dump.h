@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief API to read every object and property of a BACnet device, such
+ *  as for an EPICS or a backup, with ReadPropertyMultiple requests for
+ *  all the properties of many objects in flight at the same time.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_DUMP_H
+#define BACNET_BASIC_CLIENT_DUMP_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* number of objects that are being read, or were read and are waiting
+   to be taken, which bounds the memory of the objects */
+#ifndef BACNET_DUMP_OBJECTS_MAX
+#define BACNET_DUMP_OBJECTS_MAX 64
+#endif
+/* number of Object_List elements given to the planner in each task */
+#ifndef BACNET_DUMP_LIST_CHUNK
+#define BACNET_DUMP_LIST_CHUNK 32
+#endif
+
+/** One property of an object that was read */
+typedef struct bacnet_dump_property {
+    BACNET_PROPERTY_ID object_property;
+    /* ERROR_CODE_SUCCESS, or the error of the read */
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+    /* the encoded value, such as all the elements of an array */
+    uint8_t *application_data;
+    size_t application_data_len;
+} BACNET_DUMP_PROPERTY;
+
+/** One object that was read, with its properties in the order received */
+typedef struct bacnet_dump_object {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    /* the properties were read one at a time, since reading all of
+       them at once failed */
+    bool individual;
+    unsigned property_count;
+    BACNET_DUMP_PROPERTY *property;
+    /* reads of the object that are not finished */
+    unsigned pending;
+    /* index of the next property to add, when read one at a time */
+    unsigned next_property;
+    /* reading all the properties at once failed */
+    bool failed;
+    bool done;
+} BACNET_DUMP_OBJECT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_dump_init(void);
+BACNET_STACK_EXPORT
+bool bacnet_dump_start(uint32_t device_id, bool optional);
+BACNET_STACK_EXPORT
+void bacnet_dump_task(void);
+BACNET_STACK_EXPORT
+bool bacnet_dump_finished(void);
+BACNET_STACK_EXPORT
+bool bacnet_dump_failed(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_dump_object_count(void);
+BACNET_STACK_EXPORT
+BACNET_DUMP_OBJECT *bacnet_dump_object_take(void);
+BACNET_STACK_EXPORT
+void bacnet_dump_object_free(BACNET_DUMP_OBJECT *object);
+BACNET_STACK_EXPORT
+void bacnet_dump_window_set(unsigned requests);
+BACNET_STACK_EXPORT
+unsigned bacnet_dump_window(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
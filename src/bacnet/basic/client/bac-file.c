@@ -0,0 +1,475 @@
+/**
+ * @file
+ * @brief Read or write the stream of a File object in another BACnet
+ *  device with a window of AtomicReadFile or AtomicWriteFile requests
+ *  in flight, so that the transfer is not paced by the round trip of
+ *  each chunk.
+ * @note The chunks of a read may be acknowledged in any order, and are
+ *  written into the local file at their own position. A chunk that times
+ *  out or is aborted is sent again, up to BACNET_FILE_TRANSFER_RETRIES
+ *  times.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/arf.h"
+#include "bacnet/awf.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+/* me */
+#include "bacnet/basic/client/bac-file.h"
+
+/* one chunk of the file that is sent, in flight, or waiting to be sent */
+struct file_transfer_chunk {
+    bool used;
+    /* 0 when the chunk is not in flight */
+    uint8_t invoke_id;
+    uint8_t retries;
+    int32_t position;
+    uint32_t length;
+};
+static struct file_transfer_chunk File_Chunk[BACNET_FILE_TRANSFER_WINDOW_MAX];
+/* the transfer */
+static bool File_Write;
+static uint32_t File_Device_ID;
+static uint32_t File_Instance;
+static FILE *File_Handle;
+static uint32_t File_Chunk_Size;
+static unsigned File_Window;
+static int File_Pad_Byte;
+/* the next position to request, and the end of the file, which is not
+   known for a read until the end-of-file is acknowledged */
+static int32_t File_Next_Position;
+static int32_t File_End_Position;
+static bool File_Started;
+static bool File_Failed;
+static uint32_t File_Octets;
+/* the data of a write - kept off the c-stack */
+static BACNET_OCTET_STRING File_Data;
+
+/**
+ * @brief Get the size of the chunks of a transfer so that each request
+ *  and acknowledgment fits one unsegmented APDU
+ * @param max_apdu - the max-APDU-length-accepted of the other device
+ * @param write - true for AtomicWriteFile, false for AtomicReadFile
+ * @return the number of octets of each chunk
+ * @note a router with a smaller MPDU in between is not known here
+ */
+unsigned bacnet_file_transfer_chunk_size(unsigned max_apdu, bool write)
+{
+    unsigned my_max_apdu;
+
+    if (max_apdu < MAX_APDU) {
+        my_max_apdu = max_apdu;
+    } else {
+        my_max_apdu = MAX_APDU;
+    }
+    /* Typical sizes are 50, 128, 206, 480, 1024, and 1476 octets */
+    if (my_max_apdu <= 50) {
+        return my_max_apdu - (write ? 19 : 20);
+    } else if (my_max_apdu <= 480) {
+        return my_max_apdu - 32;
+    } else if (my_max_apdu <= 1476) {
+        return my_max_apdu - 64;
+    }
+
+    return my_max_apdu / 2;
+}
+
+/**
+ * @brief Start a transfer
+ */
+static void file_transfer_start(bool write,
+    uint32_t device_id,
+    uint32_t file_instance,
+    FILE *pFile,
+    unsigned octet_count,
+    unsigned window)
+{
+    memset(File_Chunk, 0, sizeof(File_Chunk));
+    File_Write = write;
+    File_Device_ID = device_id;
+    File_Instance = file_instance;
+    File_Handle = pFile;
+    File_Chunk_Size = octet_count;
+    if (write && (File_Chunk_Size > octetstring_capacity(&File_Data))) {
+        File_Chunk_Size = octetstring_capacity(&File_Data);
+    }
+    if (window == 0) {
+        window = 1;
+    } else if (window > BACNET_FILE_TRANSFER_WINDOW_MAX) {
+        window = BACNET_FILE_TRANSFER_WINDOW_MAX;
+    }
+    File_Window = window;
+    File_Pad_Byte = -1;
+    File_Next_Position = 0;
+    File_End_Position = INT32_MAX;
+    File_Started = false;
+    File_Failed = false;
+    File_Octets = 0;
+}
+
+/**
+ * @brief Start to read the stream of a File object into a local file
+ * @param device_id - device instance of the other device, which is bound
+ * @param file_instance - instance of the File object to read
+ * @param pFile - local file opened for writing, which is written at the
+ *  position of each chunk
+ * @param position - the position to start from, such as the size of
+ *  the local file to resume a transfer
+ * @param octet_count - the size of each chunk, which is usually
+ *  from bacnet_file_transfer_chunk_size()
+ * @param window - the number of requests in flight at one time
+ * @return true if the transfer was started
+ */
+bool bacnet_file_transfer_read_start(uint32_t device_id,
+    uint32_t file_instance,
+    FILE *pFile,
+    int32_t position,
+    unsigned octet_count,
+    unsigned window)
+{
+    if (!pFile || (octet_count == 0) || (position < 0)) {
+        return false;
+    }
+    file_transfer_start(
+        false, device_id, file_instance, pFile, octet_count, window);
+    File_Next_Position = position;
+
+    return true;
+}
+
+/**
+ * @brief Start to write a local file into the stream of a File object
+ * @param device_id - device instance of the other device, which is bound
+ * @param file_instance - instance of the File object to write
+ * @param pFile - local file opened for reading
+ * @param octet_count - the size of each chunk, which is usually
+ *  from bacnet_file_transfer_chunk_size()
+ * @param window - the number of requests in flight at one time
+ * @param pad_byte - value that pads the last chunk to the size of the
+ *  others, or -1 to not pad it
+ * @return true if the transfer was started
+ */
+bool bacnet_file_transfer_write_start(uint32_t device_id,
+    uint32_t file_instance,
+    FILE *pFile,
+    unsigned octet_count,
+    unsigned window,
+    int pad_byte)
+{
+    long file_size;
+
+    if (!pFile || (octet_count == 0) || (fseek(pFile, 0L, SEEK_END) != 0)) {
+        return false;
+    }
+    file_size = ftell(pFile);
+    if ((file_size < 0) || (file_size > INT32_MAX)) {
+        return false;
+    }
+    file_transfer_start(
+        true, device_id, file_instance, pFile, octet_count, window);
+    File_End_Position = (int32_t)file_size;
+    File_Pad_Byte = pad_byte;
+
+    return true;
+}
+
+/**
+ * @brief Find the chunk that is in flight with an invoke ID
+ * @param invoke_id - invoke ID of the request
+ * @return the chunk, or NULL if not found
+ */
+static struct file_transfer_chunk *file_transfer_chunk_find(uint8_t invoke_id)
+{
+    unsigned i;
+
+    if (invoke_id == 0) {
+        return NULL;
+    }
+    for (i = 0; i < BACNET_FILE_TRANSFER_WINDOW_MAX; i++) {
+        if (File_Chunk[i].used && (File_Chunk[i].invoke_id == invoke_id)) {
+            return &File_Chunk[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Make a chunk ready to be sent again, or fail the transfer when
+ *  it was sent too many times
+ * @param chunk - the chunk that was not acknowledged
+ */
+static void file_transfer_chunk_retry(struct file_transfer_chunk *chunk)
+{
+    chunk->invoke_id = 0;
+    chunk->retries++;
+    if (chunk->retries > BACNET_FILE_TRANSFER_RETRIES) {
+        File_Failed = true;
+    }
+}
+
+/**
+ * @brief Send the request of a chunk
+ * @param chunk - the chunk to send
+ */
+static void file_transfer_chunk_send(struct file_transfer_chunk *chunk)
+{
+    size_t len = 0;
+
+    if (!File_Write) {
+        chunk->invoke_id = Send_Atomic_Read_File_Stream(File_Device_ID,
+            File_Instance, chunk->position, chunk->length);
+        return;
+    }
+    if (fseek(File_Handle, chunk->position, SEEK_SET) == 0) {
+        len = fread(
+            octetstring_value(&File_Data), 1, chunk->length, File_Handle);
+    }
+    if (len != chunk->length) {
+        File_Failed = true;
+        return;
+    }
+    if ((File_Pad_Byte >= 0) && (len < File_Chunk_Size)) {
+        memset(octetstring_value(&File_Data) + len, File_Pad_Byte,
+            File_Chunk_Size - len);
+        len = File_Chunk_Size;
+    }
+    octetstring_truncate(&File_Data, len);
+    chunk->invoke_id = Send_Atomic_Write_File_Stream(
+        File_Device_ID, File_Instance, chunk->position, &File_Data);
+}
+
+/**
+ * @brief Add the next chunk of the file to a free place in the window
+ * @return true if a chunk was added
+ */
+static bool file_transfer_chunk_add(void)
+{
+    struct file_transfer_chunk *chunk = NULL;
+    unsigned used = 0;
+    unsigned i;
+    int32_t length;
+
+    if (File_Next_Position >= File_End_Position) {
+        /* an empty file is written with one empty chunk */
+        if (File_Started || (File_End_Position != 0)) {
+            return false;
+        }
+    }
+    for (i = 0; i < BACNET_FILE_TRANSFER_WINDOW_MAX; i++) {
+        if (File_Chunk[i].used) {
+            used++;
+        } else if (!chunk) {
+            chunk = &File_Chunk[i];
+        }
+    }
+    if (!chunk || (used >= File_Window)) {
+        return false;
+    }
+    length = File_End_Position - File_Next_Position;
+    if ((uint32_t)length > File_Chunk_Size) {
+        length = (int32_t)File_Chunk_Size;
+    }
+    memset(chunk, 0, sizeof(*chunk));
+    chunk->used = true;
+    chunk->position = File_Next_Position;
+    chunk->length = (uint32_t)length;
+    File_Next_Position += length;
+    File_Started = true;
+
+    return true;
+}
+
+/**
+ * @brief Keep the window of requests of the transfer full: send the
+ *  chunks that are waiting, and notice the chunks that were acknowledged
+ *  or timed out. Call often from the main loop, after the TSM timer.
+ */
+void bacnet_file_transfer_task(void)
+{
+    struct file_transfer_chunk *chunk;
+    unsigned i;
+
+    if (File_Failed || !File_Handle) {
+        return;
+    }
+    do {
+        for (i = 0; i < BACNET_FILE_TRANSFER_WINDOW_MAX; i++) {
+            chunk = &File_Chunk[i];
+            if (!chunk->used) {
+                continue;
+            }
+            if (chunk->invoke_id) {
+                if (tsm_invoke_id_failed(chunk->invoke_id)) {
+                    tsm_free_invoke_id(chunk->invoke_id);
+                    file_transfer_chunk_retry(chunk);
+                } else if (tsm_invoke_id_free(chunk->invoke_id)) {
+                    if (File_Write) {
+                        /* a SimpleACK */
+                        File_Octets += chunk->length;
+                        chunk->used = false;
+                    } else {
+                        /* freed without an acknowledgment */
+                        file_transfer_chunk_retry(chunk);
+                    }
+                }
+            }
+            if (File_Failed) {
+                return;
+            }
+            if (chunk->used && (chunk->invoke_id == 0)) {
+                if (!File_Write && (chunk->position >= File_End_Position)) {
+                    /* past the end of the file */
+                    chunk->used = false;
+                } else {
+                    file_transfer_chunk_send(chunk);
+                }
+            }
+        }
+    } while (file_transfer_chunk_add());
+}
+
+/**
+ * @brief Handle the AtomicReadFile-ACK of a chunk of the transfer
+ * @param invoke_id - invoke ID of the acknowledgment
+ * @param data - the decoded acknowledgment
+ * @return true if the acknowledgment was for a chunk of the transfer
+ */
+bool bacnet_file_transfer_read_ack(
+    uint8_t invoke_id, BACNET_ATOMIC_READ_FILE_DATA *data)
+{
+    struct file_transfer_chunk *chunk;
+    size_t len;
+    int32_t end;
+
+    chunk = file_transfer_chunk_find(invoke_id);
+    if (!chunk || File_Write || !data) {
+        return false;
+    }
+    chunk->invoke_id = 0;
+    if (data->access != FILE_STREAM_ACCESS) {
+        File_Failed = true;
+        return true;
+    }
+    len = octetstring_length(&data->fileData[0]);
+    if (len > chunk->length) {
+        len = chunk->length;
+    }
+    if (len > 0) {
+        if ((fseek(File_Handle, chunk->position, SEEK_SET) != 0) ||
+            (fwrite(octetstring_value(&data->fileData[0]), 1, len,
+                 File_Handle) != len)) {
+            File_Failed = true;
+            return true;
+        }
+        File_Octets += len;
+    }
+    end = chunk->position + (int32_t)len;
+    if (data->endOfFile || (len == 0)) {
+        /* asked for octets and got zero: the end of the file as well */
+        if (end < File_End_Position) {
+            File_End_Position = end;
+        }
+        chunk->used = false;
+    } else if (len < chunk->length) {
+        /* a short chunk: the rest of it is requested again */
+        chunk->position = end;
+        chunk->length -= len;
+    } else {
+        chunk->used = false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Handle an Abort of a chunk of the transfer, which is sent again
+ * @param invoke_id - invoke ID of the Abort
+ * @return true if the Abort was for a chunk of the transfer
+ */
+bool bacnet_file_transfer_abort(uint8_t invoke_id)
+{
+    struct file_transfer_chunk *chunk;
+
+    chunk = file_transfer_chunk_find(invoke_id);
+    if (!chunk) {
+        return false;
+    }
+    file_transfer_chunk_retry(chunk);
+
+    return true;
+}
+
+/**
+ * @brief Handle an Error or Reject of a chunk, which fails the transfer
+ * @param invoke_id - invoke ID of the Error or Reject
+ * @return true if the Error or Reject was for a chunk of the transfer
+ */
+bool bacnet_file_transfer_error(uint8_t invoke_id)
+{
+    struct file_transfer_chunk *chunk;
+
+    chunk = file_transfer_chunk_find(invoke_id);
+    if (!chunk) {
+        return false;
+    }
+    chunk->invoke_id = 0;
+    File_Failed = true;
+
+    return true;
+}
+
+/**
+ * @brief Determine if the transfer has chunks left to send or to be
+ *  acknowledged
+ * @return true if the transfer is not finished and has not failed
+ */
+bool bacnet_file_transfer_busy(void)
+{
+    unsigned i;
+
+    if (File_Failed || !File_Handle) {
+        return false;
+    }
+    if (File_Next_Position < File_End_Position) {
+        return true;
+    }
+    if (!File_Started) {
+        return true;
+    }
+    for (i = 0; i < BACNET_FILE_TRANSFER_WINDOW_MAX; i++) {
+        if (File_Chunk[i].used) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determine if the transfer failed
+ * @return true if a chunk was not acknowledged after its retries, was
+ *  answered with an Error or Reject, or the local file failed
+ */
+bool bacnet_file_transfer_failed(void)
+{
+    return File_Failed;
+}
+
+/**
+ * @brief Get the number of octets that were transferred, for progress
+ *  and throughput
+ * @return number of octets acknowledged so far
+ */
+uint32_t bacnet_file_transfer_octets(void)
+{
+    return File_Octets;
+}
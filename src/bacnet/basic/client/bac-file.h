@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief API to read or write the stream of a File object in another
+ *  BACnet device with a window of AtomicReadFile or AtomicWriteFile
+ *  requests in flight
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_FILE_H
+#define BACNET_BASIC_CLIENT_FILE_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/arf.h"
+
+/* largest number of requests in flight at one time */
+#ifndef BACNET_FILE_TRANSFER_WINDOW_MAX
+#define BACNET_FILE_TRANSFER_WINDOW_MAX 8
+#endif
+/* number of times a chunk is sent again after a timeout or abort */
+#ifndef BACNET_FILE_TRANSFER_RETRIES
+#define BACNET_FILE_TRANSFER_RETRIES 3
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+unsigned bacnet_file_transfer_chunk_size(unsigned max_apdu, bool write);
+BACNET_STACK_EXPORT
+bool bacnet_file_transfer_read_start(uint32_t device_id,
+    uint32_t file_instance,
+    FILE *pFile,
+    int32_t position,
+    unsigned octet_count,
+    unsigned window);
+BACNET_STACK_EXPORT
+bool bacnet_file_transfer_write_start(uint32_t device_id,
+    uint32_t file_instance,
+    FILE *pFile,
+    unsigned octet_count,
+    unsigned window,
+    int pad_byte);
+BACNET_STACK_EXPORT
+void bacnet_file_transfer_task(void);
+BACNET_STACK_EXPORT
+bool bacnet_file_transfer_read_ack(
+    uint8_t invoke_id, BACNET_ATOMIC_READ_FILE_DATA *data);
+BACNET_STACK_EXPORT
+bool bacnet_file_transfer_abort(uint8_t invoke_id);
+BACNET_STACK_EXPORT
+bool bacnet_file_transfer_error(uint8_t invoke_id);
+BACNET_STACK_EXPORT
+bool bacnet_file_transfer_busy(void);
+BACNET_STACK_EXPORT
+bool bacnet_file_transfer_failed(void);
+BACNET_STACK_EXPORT
+uint32_t bacnet_file_transfer_octets(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
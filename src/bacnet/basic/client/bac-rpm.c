@@ -0,0 +1,896 @@
+/**
+ * @file
+ * @brief Plan ReadPropertyMultiple requests to other BACnet devices.
+ *  Property reads are queued for each device, and packed into requests
+ *  that fit the maximum APDU and segmentation of the device found in
+ *  the address cache. Each device has a bounded number of requests
+ *  in flight, so that many devices can be read at the same time.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "bacnet/abort.h"
+#include "bacnet/apdu.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/npdu.h"
+#include "bacnet/reject.h"
+#include "bacnet/rpm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+/* me */
+#include "bacnet/basic/client/bac-rpm.h"
+
+/* end of a list of property reads */
+#define RPM_PLAN_NONE UINT16_MAX
+/* timer for address cache */
+static struct mstimer Cache_Timer;
+#define CACHE_CYCLE_SECONDS 60
+
+/* a property read that is waiting, or is part of a request in flight */
+struct rpm_plan_read {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    /* next read in the same list */
+    uint16_t next;
+    /* a result was received for this read */
+    bool done;
+};
+/* the property reads of one device */
+struct rpm_plan_device {
+    bool in_use;
+    bool binding;
+    uint32_t device_id;
+    struct mstimer bind_timer;
+    /* reads that are waiting to be sent, in order */
+    uint16_t head;
+    uint16_t tail;
+    /* number of reads allowed in one request */
+    unsigned reads_max;
+    /* number of requests in flight */
+    unsigned pending;
+};
+/* a ReadPropertyMultiple request in flight */
+struct rpm_plan_request {
+    /* zero when the request is not in use */
+    uint8_t invoke_id;
+    /* the reply could be segmented */
+    bool segmented;
+    uint16_t device;
+    /* reads that were sent in this request */
+    uint16_t head;
+    unsigned count;
+    BACNET_ADDRESS address;
+};
+
+static struct rpm_plan_read Plan_Read[BACNET_RPM_PLAN_READS_MAX];
+static uint16_t Plan_Read_Free = RPM_PLAN_NONE;
+static unsigned Plan_Read_Count;
+static struct rpm_plan_device Plan_Device[BACNET_RPM_PLAN_DEVICES_MAX];
+static struct rpm_plan_request Plan_Request[BACNET_RPM_PLAN_REQUESTS_MAX];
+static unsigned Plan_Concurrency = BACNET_RPM_PLAN_CONCURRENCY;
+/* where the data from the read is stored */
+static bacnet_read_write_value_callback_t Plan_Value_Callback;
+/* told when each property read is finished */
+static bacnet_rpm_plan_done_callback_t Plan_Done_Callback;
+/* the request whose reply is being processed */
+static struct rpm_plan_request *Plan_Current;
+/* local storage - keeps it off the c-stack */
+static BACNET_APPLICATION_DATA_VALUE Plan_Value;
+static BACNET_READ_ACCESS_DATA Plan_Access[BACNET_RPM_PLAN_REQUEST_READS_MAX];
+static BACNET_PROPERTY_REFERENCE
+    Plan_Property[BACNET_RPM_PLAN_REQUEST_READS_MAX];
+static BACNET_PROPERTY_REFERENCE
+    *Plan_Property_Last[BACNET_RPM_PLAN_REQUEST_READS_MAX];
+static uint8_t Plan_PDU[MAX_PDU];
+
+/**
+ * @brief Determine if a property read is for all, required, or optional
+ *  properties of an object, which is answered with many properties
+ * @param read [in] the property read
+ * @return true if the read is for many properties
+ */
+static bool rpm_plan_read_wildcard(const struct rpm_plan_read *read)
+{
+    return ((read->object_property == PROP_ALL) ||
+        (read->object_property == PROP_REQUIRED) ||
+        (read->object_property == PROP_OPTIONAL));
+}
+
+/**
+ * @brief Report a property read that failed to the value callback
+ * @param device_id [in] device instance number of the read
+ * @param read [in] the property read that failed
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void rpm_plan_read_error(uint32_t device_id,
+    struct rpm_plan_read *read,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    if (Plan_Value_Callback) {
+        rp_data.object_type = read->object_type;
+        rp_data.object_instance = read->object_instance;
+        rp_data.object_property = read->object_property;
+        rp_data.array_index = read->array_index;
+        rp_data.error_class = error_class;
+        rp_data.error_code = error_code;
+        Plan_Value_Callback(device_id, &rp_data, NULL);
+    }
+}
+
+/**
+ * @brief Free a list of property reads, reporting an error for each read
+ *  that did not receive a result, and that each read is finished
+ * @param device_id [in] device instance number of the reads
+ * @param head [in] first read of the list
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void rpm_plan_list_free(uint32_t device_id,
+    uint16_t head,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    struct rpm_plan_read *read;
+    uint16_t index, next;
+
+    for (index = head; index != RPM_PLAN_NONE; index = next) {
+        read = &Plan_Read[index];
+        next = read->next;
+        if (!read->done) {
+            rpm_plan_read_error(device_id, read, error_class, error_code);
+        }
+        if (Plan_Done_Callback) {
+            rp_data.object_type = read->object_type;
+            rp_data.object_instance = read->object_instance;
+            rp_data.object_property = read->object_property;
+            rp_data.array_index = read->array_index;
+            Plan_Done_Callback(device_id, &rp_data);
+        }
+        read->next = Plan_Read_Free;
+        Plan_Read_Free = index;
+        Plan_Read_Count--;
+    }
+}
+
+/**
+ * @brief Release a device when it has nothing more to read
+ * @param device [in] the device
+ */
+static void rpm_plan_device_release(struct rpm_plan_device *device)
+{
+    if ((device->head == RPM_PLAN_NONE) && (device->pending == 0) &&
+        !device->binding) {
+        device->in_use = false;
+    }
+}
+
+/**
+ * @brief Finish a request, and free its property reads
+ * @param request [in] the request
+ * @param error_class [in] the error class for reads without a result
+ * @param error_code [in] the error code for reads without a result
+ */
+static void rpm_plan_request_finish(struct rpm_plan_request *request,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    struct rpm_plan_device *device = &Plan_Device[request->device];
+
+    request->invoke_id = 0;
+    rpm_plan_list_free(device->device_id, request->head, error_class,
+        error_code);
+    request->head = RPM_PLAN_NONE;
+    device->pending--;
+    rpm_plan_device_release(device);
+}
+
+/**
+ * @brief Return the property reads of a request to the front of the
+ *  waiting reads of its device, and send fewer of them in each request.
+ * @param request [in] the request that was too large
+ */
+static void rpm_plan_request_retry(struct rpm_plan_request *request)
+{
+    struct rpm_plan_device *device = &Plan_Device[request->device];
+    uint16_t index = request->head;
+
+    while (Plan_Read[index].next != RPM_PLAN_NONE) {
+        index = Plan_Read[index].next;
+    }
+    Plan_Read[index].next = device->head;
+    if (device->head == RPM_PLAN_NONE) {
+        device->tail = index;
+    }
+    device->head = request->head;
+    device->reads_max = request->count / 2;
+    request->invoke_id = 0;
+    request->head = RPM_PLAN_NONE;
+    device->pending--;
+}
+
+/**
+ * @brief Find the request in flight that matches a reply
+ * @param src [in] BACNET_ADDRESS of the source of the reply
+ * @param invoke_id [in] the invokeID of the reply
+ * @return the request, or NULL if not found
+ */
+static struct rpm_plan_request *
+rpm_plan_request_find(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    unsigned i;
+
+    if (invoke_id == 0) {
+        return NULL;
+    }
+    for (i = 0; i < BACNET_RPM_PLAN_REQUESTS_MAX; i++) {
+        if ((Plan_Request[i].invoke_id == invoke_id) &&
+            address_match(&Plan_Request[i].address, src)) {
+            return &Plan_Request[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find a device, and optionally add it
+ * @param device_id [in] device instance number
+ * @param add [in] true to add the device if it is not found
+ * @return the device, or NULL if not found or no room to add it
+ */
+static struct rpm_plan_device *
+rpm_plan_device_find(uint32_t device_id, bool add)
+{
+    struct rpm_plan_device *device = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_RPM_PLAN_DEVICES_MAX; i++) {
+        if (Plan_Device[i].in_use) {
+            if (Plan_Device[i].device_id == device_id) {
+                return &Plan_Device[i];
+            }
+        } else if (!device) {
+            device = &Plan_Device[i];
+        }
+    }
+    if (add && device) {
+        device->in_use = true;
+        device->binding = false;
+        device->device_id = device_id;
+        device->head = RPM_PLAN_NONE;
+        device->tail = RPM_PLAN_NONE;
+        device->reads_max = BACNET_RPM_PLAN_REQUEST_READS_MAX;
+        device->pending = 0;
+
+        return device;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Decode the value of one property in a ReadPropertyMultiple-ACK,
+ *  and give it to the value callback. A whole array is split into its
+ *  elements.
+ * @param device_id [in] device instance number where data originated
+ * @param rp_data [in] the property data of the reply
+ */
+static void rpm_plan_value_process(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    BACNET_APPLICATION_DATA_VALUE *value = &Plan_Value;
+    BACNET_ARRAY_INDEX array_index = 0;
+    uint8_t *apdu = rp_data->application_data;
+    int apdu_len = rp_data->application_data_len;
+    int len;
+
+    do {
+        len = bacapp_decode_known_property(apdu, (unsigned)apdu_len, value,
+            rp_data->object_type, rp_data->object_property);
+        if (len <= 0) {
+            Plan_Value_Callback(device_id, rp_data, NULL);
+            break;
+        }
+        if ((len < apdu_len) && (rp_data->array_index == BACNET_ARRAY_ALL)) {
+            array_index = 1;
+        }
+        if (array_index) {
+            rp_data->array_index = array_index;
+            array_index++;
+        }
+        Plan_Value_Callback(device_id, rp_data, value);
+        apdu += len;
+        apdu_len -= len;
+    } while (apdu_len > 0);
+}
+
+/**
+ * @brief Match one result of a ReadPropertyMultiple-ACK to a property
+ *  read of the current request
+ * @param device_id [in] device instance number where data originated
+ * @param rp_data [in] the property data, or the error, of the reply
+ */
+static void rpm_plan_property_process(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    struct rpm_plan_read *read;
+    uint16_t index;
+
+    for (index = Plan_Current->head; index != RPM_PLAN_NONE;
+         index = read->next) {
+        read = &Plan_Read[index];
+        if ((read->object_type != rp_data->object_type) ||
+            (read->object_instance != rp_data->object_instance)) {
+            continue;
+        }
+        if (rpm_plan_read_wildcard(read) ||
+            (!read->done &&
+                (read->object_property == rp_data->object_property) &&
+                (read->array_index == rp_data->array_index))) {
+            read->done = true;
+            if (Plan_Value_Callback) {
+                if (rp_data->error_code == ERROR_CODE_SUCCESS) {
+                    rp_data->error_class = ERROR_CLASS_SERVICES;
+                    rpm_plan_value_process(device_id, rp_data);
+                } else {
+                    Plan_Value_Callback(device_id, rp_data, NULL);
+                }
+            }
+            break;
+        }
+    }
+    /* the decoder only sets the data of properties that have a value */
+    rp_data->application_data = NULL;
+    rp_data->application_data_len = 0;
+}
+
+/** Handler for a ReadPropertyMultiple ACK.
+ *  Gives the data of each property read of the request to the callback.
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ * decoded from the APDU header of this message.
+ */
+static void My_Read_Property_Multiple_Ack_Handler(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    struct rpm_plan_request *request;
+
+    request = rpm_plan_request_find(src, service_data->invoke_id);
+    if (request) {
+        Plan_Current = request;
+        rpm_ack_object_property_process(service_request, service_len,
+            Plan_Device[request->device].device_id, &rp_data,
+            rpm_plan_property_process);
+        Plan_Current = NULL;
+        /* any read without a result was missing from the reply */
+        rpm_plan_request_finish(
+            request, ERROR_CLASS_SERVICES, ERROR_CODE_INTERNAL_ERROR);
+    }
+}
+
+/**
+ * @brief Handler for an Error PDU.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void MyErrorHandler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    struct rpm_plan_request *request;
+
+    request = rpm_plan_request_find(src, invoke_id);
+    if (request) {
+        rpm_plan_request_finish(request, error_class, error_code);
+    }
+}
+
+/**
+ * @brief Handler for an Abort PDU. A request whose reply was too large
+ *  is sent again as smaller requests.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param abort_reason [in] the reason for the message abort
+ * @param server
+ */
+static void MyAbortHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
+{
+    struct rpm_plan_request *request;
+
+    (void)server;
+    request = rpm_plan_request_find(src, invoke_id);
+    if (request) {
+        if ((request->count > 1) &&
+            ((abort_reason == ABORT_REASON_BUFFER_OVERFLOW) ||
+                (abort_reason == ABORT_REASON_SEGMENTATION_NOT_SUPPORTED) ||
+                (abort_reason == ABORT_REASON_APDU_TOO_LONG))) {
+            rpm_plan_request_retry(request);
+        } else {
+            rpm_plan_request_finish(request, ERROR_CLASS_SERVICES,
+                abort_convert_to_error_code(abort_reason));
+        }
+    }
+}
+
+/**
+ * @brief Handler for a Reject PDU.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param reject_reason [in] the reason for the rejection
+ */
+static void MyRejectHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
+{
+    struct rpm_plan_request *request;
+
+    request = rpm_plan_request_find(src, invoke_id);
+    if (request) {
+        rpm_plan_request_finish(request, ERROR_CLASS_SERVICES,
+            reject_convert_to_error_code(reject_reason));
+    }
+}
+
+#if BACNET_SEGMENTATION_ENABLED
+/**
+ * @brief Determine if a device could send a segmented reply. Every
+ *  request accepts a segmented reply once a reassembly buffer is set.
+ * @param segmentation [in] segmentation support of the device
+ * @return true if a segmented reply could be received
+ */
+static bool rpm_plan_segmented_reply(BACNET_SEGMENTATION segmentation)
+{
+    if ((segmentation != SEGMENTATION_BOTH) &&
+        (segmentation != SEGMENTATION_TRANSMIT)) {
+        return false;
+    }
+
+    return (tsm_reassembly_buffer_size() > 0);
+}
+
+/**
+ * @brief Determine if a request that could get a segmented reply
+ *  is in flight. Only one segmented reply is reassembled at a time.
+ * @return true if such a request is in flight
+ */
+static bool rpm_plan_segmented_pending(void)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_RPM_PLAN_REQUESTS_MAX; i++) {
+        if (Plan_Request[i].invoke_id && Plan_Request[i].segmented) {
+            return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+/**
+ * @brief Pack the first waiting property reads of a device into the
+ *  ReadAccessSpecifications of one request. Reads of the same object
+ *  share a ReadAccessSpecification.
+ * @param device [in] the device
+ * @param request_max [in] largest encoded request APDU, in octets
+ * @param reply_max [in] largest expected reply APDU, in octets
+ * @return number of property reads that were packed
+ */
+static unsigned rpm_plan_pack(struct rpm_plan_device *device,
+    unsigned request_max,
+    unsigned reply_max)
+{
+    struct rpm_plan_read *read;
+    BACNET_READ_ACCESS_DATA *access;
+    BACNET_PROPERTY_REFERENCE *property;
+    /* confirmed request header, and complex ack header */
+    unsigned request_len = 4, expected_len = 3;
+    unsigned count = 0, objects = 0;
+    unsigned object_len, property_len, i;
+    uint16_t index;
+
+    for (index = device->head;
+         (index != RPM_PLAN_NONE) && (count < device->reads_max);
+         index = read->next) {
+        read = &Plan_Read[index];
+        access = NULL;
+        for (i = objects; i > 0; i--) {
+            if ((Plan_Access[i - 1].object_type == read->object_type) &&
+                (Plan_Access[i - 1].object_instance ==
+                    read->object_instance)) {
+                access = &Plan_Access[i - 1];
+                break;
+            }
+        }
+        object_len = 0;
+        if (!access) {
+            /* object identifier, and the list opening and closing tags */
+            object_len = encode_context_object_id(NULL, 0,
+                read->object_type, read->object_instance);
+            object_len += 2;
+        }
+        /* the reply to all the properties of an object is large,
+           so it is sent alone */
+        if ((count > 0) &&
+            (rpm_plan_read_wildcard(read) ||
+                rpm_plan_read_wildcard(&Plan_Read[device->head]))) {
+            break;
+        }
+        property_len =
+            encode_context_enumerated(NULL, 0, read->object_property);
+        if (read->array_index != BACNET_ARRAY_ALL) {
+            property_len +=
+                encode_context_unsigned(NULL, 1, read->array_index);
+        }
+        /* the reply has the same property reference, and a value
+           inside opening and closing tags */
+        if ((count > 0) &&
+            (((request_len + object_len + property_len) > request_max) ||
+                ((expected_len + object_len + property_len + 2 +
+                     BACNET_RPM_PLAN_VALUE_SIZE) > reply_max))) {
+            break;
+        }
+        request_len += object_len + property_len;
+        expected_len += object_len + property_len + 2 +
+            BACNET_RPM_PLAN_VALUE_SIZE;
+        property = &Plan_Property[count];
+        property->propertyIdentifier = read->object_property;
+        property->propertyArrayIndex = read->array_index;
+        property->value = NULL;
+        property->next = NULL;
+        if (access) {
+            i = (unsigned)(access - Plan_Access);
+            Plan_Property_Last[i]->next = property;
+        } else {
+            i = objects;
+            access = &Plan_Access[i];
+            access->object_type = read->object_type;
+            access->object_instance = read->object_instance;
+            access->listOfProperties = property;
+            access->next = NULL;
+            if (i > 0) {
+                Plan_Access[i - 1].next = access;
+            }
+            objects++;
+        }
+        Plan_Property_Last[i] = property;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Send one ReadPropertyMultiple request with the first waiting
+ *  property reads of a device
+ * @param device [in] the device
+ */
+static void rpm_plan_device_send(struct rpm_plan_device *device)
+{
+    struct rpm_plan_request *request = NULL;
+    BACNET_ADDRESS_CAPABILITY capability = { 0 };
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    BACNET_ADDRESS dest;
+    unsigned max_apdu = 0, request_max, reply_max;
+    unsigned count, i;
+    uint16_t index;
+    uint8_t invoke_id;
+    int npdu_len;
+
+    if (!address_bind_request(device->device_id, &max_apdu, &dest)) {
+        if (!device->binding) {
+            Send_WhoIs(device->device_id, device->device_id);
+            mstimer_set(&device->bind_timer, apdu_timeout());
+            device->binding = true;
+        } else if (mstimer_expired(&device->bind_timer)) {
+            /* unable to bind within APDU timeout */
+            device->binding = false;
+            rpm_plan_list_free(device->device_id, device->head,
+                ERROR_CLASS_SERVICES, ERROR_CODE_TIMEOUT);
+            device->head = RPM_PLAN_NONE;
+            device->tail = RPM_PLAN_NONE;
+        }
+        return;
+    }
+    device->binding = false;
+    for (i = 0; i < BACNET_RPM_PLAN_REQUESTS_MAX; i++) {
+        if (Plan_Request[i].invoke_id == 0) {
+            request = &Plan_Request[i];
+            break;
+        }
+    }
+    if (!request) {
+        return;
+    }
+    if (max_apdu > MAX_APDU) {
+        max_apdu = MAX_APDU;
+    }
+    /* the whole PDU must be smaller than the maximum APDU of the device */
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(NULL, &dest, &my_address, &npdu_data);
+    if ((unsigned)npdu_len >= max_apdu) {
+        return;
+    }
+    request_max = max_apdu - npdu_len - 1;
+    reply_max = max_apdu;
+    capability.segmentation = SEGMENTATION_NONE;
+    (void)address_capability(device->device_id, &capability);
+    request->segmented = false;
+#if BACNET_SEGMENTATION_ENABLED
+    if (rpm_plan_segmented_reply(capability.segmentation)) {
+        if (rpm_plan_segmented_pending()) {
+            return;
+        }
+        request->segmented = true;
+        /* each segment has a 5 octet header */
+        reply_max = BACNET_MAX_SEGMENTS_ACCEPTED * (max_apdu - 5);
+        if (reply_max > tsm_reassembly_buffer_size()) {
+            reply_max = tsm_reassembly_buffer_size();
+        }
+    }
+#endif
+    count = rpm_plan_pack(device, request_max, reply_max);
+    if (count == 0) {
+        return;
+    }
+    invoke_id = Send_Read_Property_Multiple_Request(
+        Plan_PDU, sizeof(Plan_PDU), device->device_id, &Plan_Access[0]);
+    if (invoke_id == 0) {
+        /* no invokeID available: try again later */
+        return;
+    }
+    request->invoke_id = invoke_id;
+    request->device = (uint16_t)(device - Plan_Device);
+    request->count = count;
+    bacnet_address_copy(&request->address, &dest);
+    /* move the packed reads from the device to the request */
+    request->head = device->head;
+    index = device->head;
+    for (i = 1; i < count; i++) {
+        index = Plan_Read[index].next;
+    }
+    device->head = Plan_Read[index].next;
+    Plan_Read[index].next = RPM_PLAN_NONE;
+    if (device->head == RPM_PLAN_NONE) {
+        device->tail = RPM_PLAN_NONE;
+    }
+    device->pending++;
+}
+
+/**
+ * @brief Sets the callback for when a property read returns data,
+ *  or fails
+ * @param callback - function for callback
+ */
+void bacnet_rpm_plan_value_callback_set(
+    bacnet_read_write_value_callback_t callback)
+{
+    Plan_Value_Callback = callback;
+}
+
+/**
+ * @brief Sets the callback for when a property read is finished
+ * @param callback - function for callback
+ */
+void bacnet_rpm_plan_done_callback_set(
+    bacnet_rpm_plan_done_callback_t callback)
+{
+    Plan_Done_Callback = callback;
+}
+
+/**
+ * @brief Set the number of requests in flight to any one device
+ * @param concurrency - number of requests, at least 1
+ */
+void bacnet_rpm_plan_concurrency_set(unsigned concurrency)
+{
+    if (concurrency == 0) {
+        concurrency = 1;
+    }
+    Plan_Concurrency = concurrency;
+}
+
+/**
+ * @brief Get the number of requests in flight to any one device
+ * @return number of requests
+ */
+unsigned bacnet_rpm_plan_concurrency(void)
+{
+    return Plan_Concurrency;
+}
+
+/**
+ * @brief Get the number of property reads that are waiting or in flight
+ * @return number of property reads
+ */
+unsigned bacnet_rpm_plan_pending(void)
+{
+    return Plan_Read_Count;
+}
+
+/**
+ * @brief Determine if the planner has no property reads to do
+ * @return true if all the property reads are finished
+ */
+bool bacnet_rpm_plan_idle(void)
+{
+    return (Plan_Read_Count == 0);
+}
+
+/**
+ * @brief Determine if a device has no property reads waiting or in flight
+ * @param device_id - ID of the device
+ * @return true if all the property reads of the device are finished
+ */
+bool bacnet_rpm_plan_device_idle(uint32_t device_id)
+{
+    return (rpm_plan_device_find(device_id, false) == NULL);
+}
+
+/**
+ * @brief Adds a property read of a remote device. Reads are sent in the
+ *  order that they were added for each device, and each result or error
+ *  is given to the value callback.
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be read.
+ * @param object_instance - Instance # of the object to be read.
+ * @param object_property - Property to be read. ALL, REQUIRED, or
+ * OPTIONAL are given to the value callback as each property of the reply,
+ * and are only used with BACNET_ARRAY_ALL.
+ * @param array_index [in] Optional: if the Property is an array,
+ *   - 0 for the array size
+ *   - 1 to n for individual array members
+ *   - BACNET_ARRAY_ALL (~0) for the full array to be read.
+ * @return true if added, false if not added
+ */
+bool bacnet_rpm_plan_read_add(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    struct rpm_plan_device *device;
+    struct rpm_plan_read *read;
+    uint16_t index;
+
+    if (device_id >= BACNET_MAX_INSTANCE) {
+        return false;
+    }
+    if (((object_property == PROP_ALL) || (object_property == PROP_REQUIRED) ||
+            (object_property == PROP_OPTIONAL)) &&
+        (array_index != BACNET_ARRAY_ALL)) {
+        return false;
+    }
+    if (Plan_Read_Free == RPM_PLAN_NONE) {
+        return false;
+    }
+    device = rpm_plan_device_find(device_id, true);
+    if (!device) {
+        return false;
+    }
+    index = Plan_Read_Free;
+    read = &Plan_Read[index];
+    Plan_Read_Free = read->next;
+    Plan_Read_Count++;
+    read->object_type = object_type;
+    read->object_instance = object_instance;
+    read->object_property = object_property;
+    read->array_index = array_index;
+    read->next = RPM_PLAN_NONE;
+    read->done = false;
+    if (device->tail == RPM_PLAN_NONE) {
+        device->head = index;
+    } else {
+        Plan_Read[device->tail].next = index;
+    }
+    device->tail = index;
+
+    return true;
+}
+
+/**
+ * @brief Handles the repetitive task of the planner: sends requests to
+ *  each device up to its concurrency, and times out requests.
+ */
+void bacnet_rpm_plan_task(void)
+{
+    struct rpm_plan_request *request;
+    struct rpm_plan_device *device;
+    unsigned i;
+
+    for (i = 0; i < BACNET_RPM_PLAN_REQUESTS_MAX; i++) {
+        request = &Plan_Request[i];
+        if (request->invoke_id == 0) {
+            continue;
+        }
+        if (tsm_invoke_id_failed(request->invoke_id)) {
+            tsm_free_invoke_id(request->invoke_id);
+            rpm_plan_request_finish(
+                request, ERROR_CLASS_SERVICES, ERROR_CODE_ABORT_TSM_TIMEOUT);
+        } else if (tsm_invoke_id_free(request->invoke_id)) {
+            /* the transaction ended without a reply for us */
+            rpm_plan_request_finish(
+                request, ERROR_CLASS_SERVICES, ERROR_CODE_OTHER);
+        }
+    }
+    for (i = 0; i < BACNET_RPM_PLAN_DEVICES_MAX; i++) {
+        device = &Plan_Device[i];
+        if (!device->in_use) {
+            continue;
+        }
+        if ((device->head != RPM_PLAN_NONE) &&
+            (device->pending < Plan_Concurrency)) {
+            rpm_plan_device_send(device);
+        }
+        rpm_plan_device_release(device);
+    }
+    if (mstimer_expired(&Cache_Timer)) {
+        mstimer_reset(&Cache_Timer);
+        address_cache_timer(CACHE_CYCLE_SECONDS);
+    }
+}
+
+/**
+ * @brief Initialize the planner and the handlers for its replies.
+ * @note The planner uses the Abort and Reject handlers, and the
+ *  ReadPropertyMultiple handlers, so it is not used together with
+ *  the bac-rw client in the same application.
+ */
+void bacnet_rpm_plan_init(void)
+{
+    unsigned i;
+
+    Plan_Read_Free = RPM_PLAN_NONE;
+    for (i = BACNET_RPM_PLAN_READS_MAX; i > 0; i--) {
+        Plan_Read[i - 1].next = Plan_Read_Free;
+        Plan_Read_Free = (uint16_t)(i - 1);
+    }
+    Plan_Read_Count = 0;
+    for (i = 0; i < BACNET_RPM_PLAN_DEVICES_MAX; i++) {
+        Plan_Device[i].in_use = false;
+    }
+    for (i = 0; i < BACNET_RPM_PLAN_REQUESTS_MAX; i++) {
+        Plan_Request[i].invoke_id = 0;
+        Plan_Request[i].head = RPM_PLAN_NONE;
+    }
+    /* handle i-am to support binding to other devices */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, handler_i_am_bind);
+    /* handle the data coming back from confirmed requests */
+    apdu_set_confirmed_ack_handler(SERVICE_CONFIRMED_READ_PROP_MULTIPLE,
+        My_Read_Property_Multiple_Ack_Handler);
+    /* handle any errors coming back */
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, MyErrorHandler);
+    apdu_set_abort_handler(MyAbortHandler);
+    apdu_set_reject_handler(MyRejectHandler);
+    /* learn the max-APDU and round trip time of the devices,
+       and wait for each device as long as it takes to reply */
+    apdu_set_peer_capability_handler(address_peer_capability_update);
+    tsm_set_peer_timeout_handler(address_apdu_timeout);
+    /* configure the address cache */
+    address_init();
+    /* start the cyclic 1 second timer for Address Cache */
+    mstimer_set(&Cache_Timer, CACHE_CYCLE_SECONDS * 1000);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief API to plan ReadPropertyMultiple requests to other BACnet devices,
+ *  packing many property reads for each device into as few requests as
+ *  its maximum APDU and segmentation allow.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_RPM_PLAN_H
+#define BACNET_BASIC_CLIENT_RPM_PLAN_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/rp.h"
+#include "bacnet/basic/client/bac-rw.h"
+
+/* number of property reads that can be waiting or in flight */
+#ifndef BACNET_RPM_PLAN_READS_MAX
+#define BACNET_RPM_PLAN_READS_MAX 1024
+#endif
+/* number of devices that can have property reads at the same time */
+#ifndef BACNET_RPM_PLAN_DEVICES_MAX
+#define BACNET_RPM_PLAN_DEVICES_MAX 32
+#endif
+/* number of ReadPropertyMultiple requests in flight, for all devices */
+#ifndef BACNET_RPM_PLAN_REQUESTS_MAX
+#define BACNET_RPM_PLAN_REQUESTS_MAX 16
+#endif
+/* default number of requests in flight to any one device */
+#ifndef BACNET_RPM_PLAN_CONCURRENCY
+#define BACNET_RPM_PLAN_CONCURRENCY 2
+#endif
+/* number of property reads packed into one request, at most */
+#ifndef BACNET_RPM_PLAN_REQUEST_READS_MAX
+#define BACNET_RPM_PLAN_REQUEST_READS_MAX 128
+#endif
+/* estimated size of an encoded property value in the reply, in octets */
+#ifndef BACNET_RPM_PLAN_VALUE_SIZE
+#define BACNET_RPM_PLAN_VALUE_SIZE 10
+#endif
+
+/**
+ * Note that a property read is finished, after its values or its error
+ * were given to the value callback. Reads are not added from this
+ * callback.
+ *
+ * @param device_id [in] device instance number of the read
+ * @param rp_data [in] the object, property and array index of the read
+ */
+typedef void (*bacnet_rpm_plan_done_callback_t)(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_rpm_plan_init(void);
+BACNET_STACK_EXPORT
+void bacnet_rpm_plan_task(void);
+BACNET_STACK_EXPORT
+bool bacnet_rpm_plan_idle(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_rpm_plan_pending(void);
+BACNET_STACK_EXPORT
+bool bacnet_rpm_plan_device_idle(uint32_t device_id);
+BACNET_STACK_EXPORT
+bool bacnet_rpm_plan_read_add(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index);
+BACNET_STACK_EXPORT
+void bacnet_rpm_plan_concurrency_set(unsigned concurrency);
+BACNET_STACK_EXPORT
+unsigned bacnet_rpm_plan_concurrency(void);
+BACNET_STACK_EXPORT
+void bacnet_rpm_plan_value_callback_set(
+    bacnet_read_write_value_callback_t callback);
+BACNET_STACK_EXPORT
+void bacnet_rpm_plan_done_callback_set(
+    bacnet_rpm_plan_done_callback_t callback);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
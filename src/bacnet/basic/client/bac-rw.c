@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bacnet/abort.h"
 #include "bacnet/apdu.h"
 #include "bacnet/iam.h"
@@ -41,7 +42,8 @@ typedef enum {
     BACNET_CLIENT_BINDING,
     BACNET_CLIENT_SEND,
     BACNET_CLIENT_WAITING,
-    BACNET_CLIENT_FINISHED
+    BACNET_CLIENT_FINISHED,
+    BACNET_CLIENT_DEFERRED
 } BACNET_CLIENT_STATE;
 /* data queue */
 typedef struct target_data_t {
@@ -70,6 +72,35 @@ typedef struct target_data_t {
 #endif
 static TARGET_DATA Target_Data_Buffer[TARGET_DATA_QUEUE_COUNT];
 static RING_BUFFER Target_Data_Queue;
+/* requests to unbound devices, which wait for the I-Am of the device
+   so that they do not hold up the requests to bound devices */
+#ifndef TARGET_PENDING_COUNT
+#define TARGET_PENDING_COUNT 16
+#endif
+/* milliseconds that bind requests are gathered into one Who-Is */
+#ifndef TARGET_WHOIS_DELAY
+#define TARGET_WHOIS_DELAY 100
+#endif
+/* most device-ids between two bind requests that are asked
+   with one Who-Is range */
+#ifndef TARGET_WHOIS_GAP
+#define TARGET_WHOIS_GAP 4
+#endif
+typedef struct target_pending_t {
+    TARGET_DATA target;
+    /* time until the request fails without an I-Am */
+    struct mstimer timer;
+    bool in_use : 1;
+    /* the Who-Is for the device was sent */
+    bool asked : 1;
+    /* the device is bound, and the request can be sent */
+    bool ready : 1;
+} TARGET_PENDING;
+static TARGET_PENDING Target_Pending[TARGET_PENDING_COUNT];
+static struct mstimer Target_WhoIs_Timer;
+static bool Target_WhoIs_Needed;
+/* the pending request in process, or -1 for the head of the queue */
+static int Target_Pending_Index = -1;
 /* local storage - keeps it off the c-stack */
 static BACNET_APPLICATION_DATA_VALUE Target_Decoded_Property_Value;
 /* the invoke id is needed to filter incoming messages */
@@ -138,6 +169,116 @@ static void MyRejectHandler(
     }
 }
 
+/**
+ * @brief Release the pending requests to a device that is bound
+ * @param device_id - device instance number
+ */
+static void bacnet_read_write_pending_release(uint32_t device_id)
+{
+    unsigned i;
+
+    for (i = 0; i < TARGET_PENDING_COUNT; i++) {
+        if (Target_Pending[i].in_use &&
+            (Target_Pending[i].target.device_id == device_id)) {
+            Target_Pending[i].ready = true;
+        }
+    }
+}
+
+/**
+ * @brief Move a request to an unbound device to the pending requests
+ * @param target - the request
+ * @return true if the request was moved, or false if there is no room
+ */
+static bool bacnet_read_write_pending_add(const TARGET_DATA *target)
+{
+    TARGET_PENDING *pending;
+    unsigned i;
+
+    for (i = 0; i < TARGET_PENDING_COUNT; i++) {
+        pending = &Target_Pending[i];
+        if (!pending->in_use) {
+            pending->target = *target;
+            pending->in_use = true;
+            pending->asked = false;
+            pending->ready = false;
+            mstimer_set(&pending->timer, TARGET_WHOIS_DELAY + apdu_timeout());
+            if (!Target_WhoIs_Needed) {
+                Target_WhoIs_Needed = true;
+                mstimer_set(&Target_WhoIs_Timer, TARGET_WHOIS_DELAY);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Send the Who-Is for the pending requests that were not asked,
+ *  where the device-ids that are close together are asked with one range
+ */
+static void bacnet_read_write_pending_whois(void)
+{
+    uint32_t device_id[TARGET_PENDING_COUNT];
+    unsigned count = 0;
+    unsigned i;
+    unsigned j;
+
+    for (i = 0; i < TARGET_PENDING_COUNT; i++) {
+        if (Target_Pending[i].in_use && !Target_Pending[i].asked &&
+            !Target_Pending[i].ready) {
+            Target_Pending[i].asked = true;
+            /* sorted, for the ranges */
+            for (j = count; j > 0; j--) {
+                if (device_id[j - 1] <= Target_Pending[i].target.device_id) {
+                    break;
+                }
+                device_id[j] = device_id[j - 1];
+            }
+            device_id[j] = Target_Pending[i].target.device_id;
+            count++;
+        }
+    }
+    for (i = 0; i < count; i = j) {
+        for (j = i + 1; j < count; j++) {
+            if ((device_id[j] - device_id[j - 1]) > (TARGET_WHOIS_GAP + 1)) {
+                break;
+            }
+        }
+        Send_WhoIs((int32_t)device_id[i], (int32_t)device_id[j - 1]);
+    }
+}
+
+/**
+ * @brief Fail the pending requests whose device did not answer in time
+ */
+static void bacnet_read_write_pending_timeout(void)
+{
+    BACNET_READ_PROPERTY_DATA rp_data;
+    TARGET_PENDING *pending;
+    unsigned i;
+
+    for (i = 0; i < TARGET_PENDING_COUNT; i++) {
+        pending = &Target_Pending[i];
+        if (pending->in_use && !pending->ready &&
+            ((int)i != Target_Pending_Index) &&
+            mstimer_expired(&pending->timer)) {
+            if (bacnet_read_write_value_callback) {
+                rp_data.error_class = ERROR_CLASS_SERVICES;
+                rp_data.error_code = ERROR_CODE_TIMEOUT;
+                rp_data.object_type = pending->target.object_type;
+                rp_data.object_instance = pending->target.object_instance;
+                rp_data.object_property = pending->target.object_property;
+                rp_data.array_index = pending->target.array_index;
+                bacnet_read_write_value_callback(
+                    pending->target.device_id, &rp_data, NULL);
+            }
+            pending->in_use = false;
+        }
+    }
+}
+
 /**
  * @brief Handler for I-Am responses
  * @param service_request [in] The received message to be handled.
@@ -171,12 +312,18 @@ static void My_I_Am_Bind(
             }
             if (bind) {
                 address_add_binding(device_id, max_apdu, src);
+                address_segmentation_set(
+                    device_id, (BACNET_SEGMENTATION)segmentation);
                 if (bacnet_read_write_device_callback) {
                     bacnet_read_write_device_callback(
                         device_id, max_apdu, segmentation, vendor_id);
                 }
+                found = true;
             }
         }
+        if (found) {
+            bacnet_read_write_pending_release(device_id);
+        }
     }
 
     return;
@@ -378,6 +525,10 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
             if (found) {
                 Target_Device_ID = target->device_id;
                 RW_State = BACNET_CLIENT_SEND;
+            } else if ((Target_Pending_Index < 0) &&
+                bacnet_read_write_pending_add(target)) {
+                /* wait for the I-Am without holding up the queue */
+                RW_State = BACNET_CLIENT_DEFERRED;
             } else {
                 Send_WhoIs(target->device_id, target->device_id);
                 RW_State = BACNET_CLIENT_BINDING;
@@ -479,13 +630,15 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
             }
             break;
         case BACNET_CLIENT_FINISHED:
+        case BACNET_CLIENT_DEFERRED:
             RW_State = BACNET_CLIENT_IDLE;
             break;
         default:
             break;
     }
 
-    return (RW_State == BACNET_CLIENT_FINISHED);
+    return (RW_State == BACNET_CLIENT_FINISHED) ||
+        (RW_State == BACNET_CLIENT_DEFERRED);
 }
 
 /**
@@ -515,15 +668,36 @@ void bacnet_read_write_device_callback_set(
  */
 void bacnet_read_write_task(void)
 {
-    TARGET_DATA *target;
+    TARGET_DATA *target = NULL;
     bool status = false;
     BACNET_READ_PROPERTY_DATA rp_data;
+    unsigned i;
 
-    if (!Ringbuf_Empty(&Target_Data_Queue)) {
+    if ((RW_State == BACNET_CLIENT_FINISHED) ||
+        (RW_State == BACNET_CLIENT_DEFERRED)) {
+        RW_State = BACNET_CLIENT_IDLE;
+    }
+    if (RW_State == BACNET_CLIENT_IDLE) {
+        /* released pending requests go before the queue */
+        Target_Pending_Index = -1;
+        for (i = 0; i < TARGET_PENDING_COUNT; i++) {
+            if (Target_Pending[i].in_use && Target_Pending[i].ready) {
+                Target_Pending_Index = (int)i;
+                break;
+            }
+        }
+    }
+    if (Target_Pending_Index >= 0) {
+        target = &Target_Pending[Target_Pending_Index].target;
+    } else if (!Ringbuf_Empty(&Target_Data_Queue)) {
         target = (TARGET_DATA *)Ringbuf_Peek(&Target_Data_Queue);
+    }
+    if (target) {
         status = bacnet_read_write_process(target);
         if (status) {
-            if (Error_Detected) {
+            if (RW_State == BACNET_CLIENT_DEFERRED) {
+                /* moved to the pending requests */
+            } else if (Error_Detected) {
                 if (bacnet_read_write_value_callback) {
                     rp_data.error_class = Error_Class;
                     rp_data.error_code = Error_Code;
@@ -535,9 +709,19 @@ void bacnet_read_write_task(void)
                         target->device_id, &rp_data, NULL);
                 }
             }
-            Ringbuf_Pop(&Target_Data_Queue, NULL);
+            if (Target_Pending_Index >= 0) {
+                Target_Pending[Target_Pending_Index].in_use = false;
+                Target_Pending_Index = -1;
+            } else {
+                Ringbuf_Pop(&Target_Data_Queue, NULL);
+            }
         }
     }
+    if (Target_WhoIs_Needed && mstimer_expired(&Target_WhoIs_Timer)) {
+        Target_WhoIs_Needed = false;
+        bacnet_read_write_pending_whois();
+    }
+    bacnet_read_write_pending_timeout();
     if (mstimer_expired(&Cache_Timer)) {
         mstimer_reset(&Cache_Timer);
         address_cache_timer(CACHE_CYCLE_SECONDS);
@@ -821,6 +1005,14 @@ bool bacnet_write_property_boolean_queue(uint32_t device_id,
  */
 bool bacnet_read_write_idle(void)
 {
+    unsigned i;
+
+    for (i = 0; i < TARGET_PENDING_COUNT; i++) {
+        if (Target_Pending[i].in_use) {
+            return false;
+        }
+    }
+
     return Ringbuf_Empty(&Target_Data_Queue);
 }
 
@@ -860,6 +1052,9 @@ void bacnet_read_write_init(void)
 {
     Ringbuf_Init(&Target_Data_Queue, (uint8_t *)&Target_Data_Buffer,
         TARGET_DATA_QUEUE_SIZE, TARGET_DATA_QUEUE_COUNT);
+    memset(Target_Pending, 0, sizeof(Target_Pending));
+    Target_Pending_Index = -1;
+    Target_WhoIs_Needed = false;
     /* handle i-am to support binding to other devices */
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, My_I_Am_Bind);
     /* handle the data coming back from confirmed requests */
@@ -0,0 +1,837 @@
+/**
+ * @file
+ * @brief Plan WritePropertyMultiple requests to other BACnet devices.
+ *  Property writes are queued for each device, and merged into requests
+ *  that fit the maximum APDU of the device found in the address cache.
+ *  A write to the same object, property, and priority as one that is
+ *  still waiting replaces its value. Each device has one request in
+ *  flight, so that its writes are done in the order they were added.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/abort.h"
+#include "bacnet/apdu.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/dcc.h"
+#include "bacnet/npdu.h"
+#include "bacnet/reject.h"
+#include "bacnet/wp.h"
+#include "bacnet/wpm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+/* me */
+#include "bacnet/basic/client/bac-wpm.h"
+
+/* end of a list of property writes */
+#define WPM_PLAN_NONE UINT16_MAX
+/* timer for address cache */
+static struct mstimer Cache_Timer;
+#define CACHE_CYCLE_SECONDS 60
+
+/* a property write that is waiting, or is part of a request in flight */
+struct wpm_plan_write {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    uint8_t priority;
+    /* the encoded value */
+    uint16_t value_len;
+    uint8_t value[BACNET_WPM_PLAN_VALUE_SIZE];
+    /* next write in the same list */
+    uint16_t next;
+};
+/* the property writes of one device */
+struct wpm_plan_device {
+    bool in_use;
+    bool binding;
+    /* the device does not execute WritePropertyMultiple */
+    bool single;
+    /* a request is in flight */
+    bool pending;
+    uint32_t device_id;
+    struct mstimer bind_timer;
+    /* writes that are waiting to be sent, in order */
+    uint16_t head;
+    uint16_t tail;
+    /* number of writes allowed in one request */
+    unsigned writes_max;
+};
+/* a request in flight */
+struct wpm_plan_request {
+    /* zero when the request is not in use */
+    uint8_t invoke_id;
+    uint16_t device;
+    /* writes that were sent in this request */
+    uint16_t head;
+    unsigned count;
+    BACNET_ADDRESS address;
+};
+
+static struct wpm_plan_write Plan_Write[BACNET_WPM_PLAN_WRITES_MAX];
+static uint16_t Plan_Write_Free = WPM_PLAN_NONE;
+static unsigned Plan_Write_Count;
+static struct wpm_plan_device Plan_Device[BACNET_WPM_PLAN_DEVICES_MAX];
+static struct wpm_plan_request Plan_Request[BACNET_WPM_PLAN_REQUESTS_MAX];
+/* where the result of each write is given */
+static bacnet_wpm_plan_callback_t Plan_Callback;
+/* local storage - keeps it off the c-stack */
+static BACNET_WRITE_PROPERTY_DATA Plan_Data;
+static uint8_t Plan_PDU[MAX_PDU];
+
+/**
+ * @brief Copy a property write into the local write property data
+ * @param write [in] the property write
+ * @return the write property data
+ */
+static BACNET_WRITE_PROPERTY_DATA *
+wpm_plan_write_data(const struct wpm_plan_write *write)
+{
+    Plan_Data.object_type = write->object_type;
+    Plan_Data.object_instance = write->object_instance;
+    Plan_Data.object_property = write->object_property;
+    Plan_Data.array_index = write->array_index;
+    Plan_Data.priority = write->priority;
+    memcpy(Plan_Data.application_data, write->value, write->value_len);
+    Plan_Data.application_data_len = write->value_len;
+    Plan_Data.error_class = ERROR_CLASS_SERVICES;
+    Plan_Data.error_code = ERROR_CODE_SUCCESS;
+
+    return &Plan_Data;
+}
+
+/**
+ * @brief Give the result of a property write to the callback
+ * @param device_id [in] device instance number of the write
+ * @param write [in] the property write
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code, or ERROR_CODE_SUCCESS
+ */
+static void wpm_plan_write_result(uint32_t device_id,
+    const struct wpm_plan_write *write,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    BACNET_WRITE_PROPERTY_DATA *wp_data;
+
+    if (Plan_Callback) {
+        wp_data = wpm_plan_write_data(write);
+        wp_data->error_class = error_class;
+        wp_data->error_code = error_code;
+        Plan_Callback(device_id, wp_data);
+    }
+}
+
+/**
+ * @brief Free a property write
+ * @param index [in] the property write
+ */
+static void wpm_plan_write_free(uint16_t index)
+{
+    Plan_Write[index].next = Plan_Write_Free;
+    Plan_Write_Free = index;
+    Plan_Write_Count--;
+}
+
+/**
+ * @brief Free a list of property writes, giving the same result for each
+ * @param device_id [in] device instance number of the writes
+ * @param head [in] first write of the list
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code, or ERROR_CODE_SUCCESS
+ */
+static void wpm_plan_list_free(uint32_t device_id,
+    uint16_t head,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    uint16_t index, next;
+
+    for (index = head; index != WPM_PLAN_NONE; index = next) {
+        next = Plan_Write[index].next;
+        wpm_plan_write_result(
+            device_id, &Plan_Write[index], error_class, error_code);
+        wpm_plan_write_free(index);
+    }
+}
+
+/**
+ * @brief Return a list of property writes to the front of the waiting
+ *  writes of their device, to be sent again
+ * @param device [in] the device
+ * @param head [in] first write of the list
+ */
+static void wpm_plan_list_requeue(struct wpm_plan_device *device, uint16_t head)
+{
+    uint16_t index = head;
+
+    if (head == WPM_PLAN_NONE) {
+        return;
+    }
+    while (Plan_Write[index].next != WPM_PLAN_NONE) {
+        index = Plan_Write[index].next;
+    }
+    Plan_Write[index].next = device->head;
+    if (device->head == WPM_PLAN_NONE) {
+        device->tail = index;
+    }
+    device->head = head;
+}
+
+/**
+ * @brief Release a device that has no more property writes
+ * @param device [in] the device
+ */
+static void wpm_plan_device_release(struct wpm_plan_device *device)
+{
+    if ((device->head == WPM_PLAN_NONE) && !device->pending &&
+        !device->binding) {
+        device->in_use = false;
+    }
+}
+
+/**
+ * @brief End a request, leaving its property writes with the caller
+ * @param request [in] the request
+ * @return the device of the request
+ */
+static struct wpm_plan_device *
+wpm_plan_request_end(struct wpm_plan_request *request)
+{
+    struct wpm_plan_device *device = &Plan_Device[request->device];
+
+    request->invoke_id = 0;
+    request->head = WPM_PLAN_NONE;
+    device->pending = false;
+
+    return device;
+}
+
+/**
+ * @brief Finish a request, and free its property writes with the same
+ *  result for each
+ * @param request [in] the request
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code, or ERROR_CODE_SUCCESS
+ */
+static void wpm_plan_request_finish(struct wpm_plan_request *request,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    uint16_t head = request->head;
+    struct wpm_plan_device *device;
+
+    device = wpm_plan_request_end(request);
+    wpm_plan_list_free(device->device_id, head, error_class, error_code);
+    wpm_plan_device_release(device);
+}
+
+/**
+ * @brief Find the request in flight that matches a reply
+ * @param src [in] BACNET_ADDRESS of the source of the reply
+ * @param invoke_id [in] the invokeID of the reply
+ * @return the request, or NULL if not found
+ */
+static struct wpm_plan_request *
+wpm_plan_request_find(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    unsigned i;
+
+    if (invoke_id == 0) {
+        return NULL;
+    }
+    for (i = 0; i < BACNET_WPM_PLAN_REQUESTS_MAX; i++) {
+        if ((Plan_Request[i].invoke_id == invoke_id) &&
+            address_match(&Plan_Request[i].address, src)) {
+            return &Plan_Request[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find a device, and optionally add it
+ * @param device_id [in] device instance number
+ * @param add [in] true to add the device if it is not found
+ * @return the device, or NULL if not found or no room to add it
+ */
+static struct wpm_plan_device *
+wpm_plan_device_find(uint32_t device_id, bool add)
+{
+    struct wpm_plan_device *device = NULL;
+    unsigned i;
+
+    for (i = 0; i < BACNET_WPM_PLAN_DEVICES_MAX; i++) {
+        if (Plan_Device[i].in_use) {
+            if (Plan_Device[i].device_id == device_id) {
+                return &Plan_Device[i];
+            }
+        } else if (!device) {
+            device = &Plan_Device[i];
+        }
+    }
+    if (add && device) {
+        device->in_use = true;
+        device->binding = false;
+        device->single = false;
+        device->pending = false;
+        device->device_id = device_id;
+        device->head = WPM_PLAN_NONE;
+        device->tail = WPM_PLAN_NONE;
+        device->writes_max = BACNET_WPM_PLAN_WRITES_MAX;
+
+        return device;
+    }
+
+    return NULL;
+}
+
+/** Handler for a WriteProperty or WritePropertyMultiple Simple ACK.
+ *  Every property write of the request succeeded.
+ *
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID of the acknowledged message
+ */
+static void MyWriteSimpleAckHandler(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    struct wpm_plan_request *request;
+
+    request = wpm_plan_request_find(src, invoke_id);
+    if (request) {
+        wpm_plan_request_finish(
+            request, ERROR_CLASS_SERVICES, ERROR_CODE_SUCCESS);
+    }
+}
+
+/**
+ * @brief Handler for a WritePropertyMultiple-Error. The writes before
+ *  the first failed write succeeded, and the writes after it were not
+ *  done, so they are sent again.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID of the message
+ * @param service_choice [in] the service of the message
+ * @param service_request [in] the contents of the error
+ * @param service_len [in] the length of the contents of the error
+ */
+static void MyWritePropertyMultipleErrorHandler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    uint8_t service_choice,
+    uint8_t *service_request,
+    uint16_t service_len)
+{
+    struct wpm_plan_request *request;
+    struct wpm_plan_device *device;
+    struct wpm_plan_write *write;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    uint16_t index, next;
+    int len;
+
+    (void)service_choice;
+    request = wpm_plan_request_find(src, invoke_id);
+    if (!request) {
+        return;
+    }
+    len = wpm_error_ack_decode_apdu(service_request, service_len, &Plan_Data);
+    error_class = Plan_Data.error_class;
+    error_code = Plan_Data.error_code;
+    if (len <= 0) {
+        wpm_plan_request_finish(request, error_class, error_code);
+        return;
+    }
+    object_type = Plan_Data.object_type;
+    object_instance = Plan_Data.object_instance;
+    object_property = Plan_Data.object_property;
+    array_index = Plan_Data.array_index;
+    for (index = request->head; index != WPM_PLAN_NONE;
+         index = Plan_Write[index].next) {
+        write = &Plan_Write[index];
+        if ((write->object_type == object_type) &&
+            (write->object_instance == object_instance) &&
+            (write->object_property == object_property) &&
+            (write->array_index == array_index)) {
+            break;
+        }
+    }
+    if (index == WPM_PLAN_NONE) {
+        /* the first failed write is not one of ours */
+        wpm_plan_request_finish(request, error_class, error_code);
+        return;
+    }
+    index = request->head;
+    device = wpm_plan_request_end(request);
+    for (; index != WPM_PLAN_NONE; index = next) {
+        write = &Plan_Write[index];
+        next = write->next;
+        if ((write->object_type == object_type) &&
+            (write->object_instance == object_instance) &&
+            (write->object_property == object_property) &&
+            (write->array_index == array_index)) {
+            wpm_plan_write_result(
+                device->device_id, write, error_class, error_code);
+            wpm_plan_write_free(index);
+            break;
+        }
+        wpm_plan_write_result(
+            device->device_id, write, ERROR_CLASS_SERVICES, ERROR_CODE_SUCCESS);
+        wpm_plan_write_free(index);
+    }
+    wpm_plan_list_requeue(device, next);
+    wpm_plan_device_release(device);
+}
+
+/**
+ * @brief Handler for a WriteProperty Error PDU.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void MyWritePropertyErrorHandler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    struct wpm_plan_request *request;
+
+    request = wpm_plan_request_find(src, invoke_id);
+    if (request) {
+        wpm_plan_request_finish(request, error_class, error_code);
+    }
+}
+
+/**
+ * @brief Handler for an Abort PDU. A request that was too large is sent
+ *  again as smaller requests.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param abort_reason [in] the reason for the message abort
+ * @param server
+ */
+static void MyAbortHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
+{
+    struct wpm_plan_request *request;
+    struct wpm_plan_device *device;
+    uint16_t head;
+    unsigned count;
+
+    (void)server;
+    request = wpm_plan_request_find(src, invoke_id);
+    if (!request) {
+        return;
+    }
+    if ((request->count > 1) &&
+        ((abort_reason == ABORT_REASON_BUFFER_OVERFLOW) ||
+            (abort_reason == ABORT_REASON_SEGMENTATION_NOT_SUPPORTED) ||
+            (abort_reason == ABORT_REASON_APDU_TOO_LONG))) {
+        head = request->head;
+        count = request->count;
+        device = wpm_plan_request_end(request);
+        wpm_plan_list_requeue(device, head);
+        device->writes_max = count / 2;
+    } else {
+        wpm_plan_request_finish(request, ERROR_CLASS_SERVICES,
+            abort_convert_to_error_code(abort_reason));
+    }
+}
+
+/**
+ * @brief Handler for a Reject PDU. A device that does not know the
+ *  WritePropertyMultiple service is sent each write by itself with
+ *  the WriteProperty service.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the rejected message
+ * @param reject_reason [in] the reason for the rejection
+ */
+static void MyRejectHandler(
+    BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
+{
+    struct wpm_plan_request *request;
+    struct wpm_plan_device *device;
+    uint16_t head;
+
+    request = wpm_plan_request_find(src, invoke_id);
+    if (!request) {
+        return;
+    }
+    device = &Plan_Device[request->device];
+    if ((reject_reason == REJECT_REASON_UNRECOGNIZED_SERVICE) &&
+        !device->single) {
+        head = request->head;
+        device = wpm_plan_request_end(request);
+        wpm_plan_list_requeue(device, head);
+        device->single = true;
+    } else {
+        wpm_plan_request_finish(request, ERROR_CLASS_SERVICES,
+            reject_convert_to_error_code(reject_reason));
+    }
+}
+
+/**
+ * @brief Encode the first waiting property writes of a device into
+ *  a WritePropertyMultiple request. Consecutive writes to the same
+ *  object share a WriteAccessSpecification.
+ * @param device [in] the device
+ * @param apdu [out] the buffer for the request
+ * @param apdu_max [in] largest encoded request APDU, in octets
+ * @param invoke_id [in] the invokeID of the request
+ * @param count [out] number of property writes that were encoded
+ * @return number of octets encoded
+ */
+static int wpm_plan_encode(struct wpm_plan_device *device,
+    uint8_t *apdu,
+    unsigned apdu_max,
+    uint8_t invoke_id,
+    unsigned *count)
+{
+    struct wpm_plan_write *write, *last = NULL;
+    BACNET_WRITE_PROPERTY_DATA *wp_data;
+    unsigned apdu_len, object_len, property_len;
+    uint16_t index;
+
+    *count = 0;
+    apdu_len = wpm_encode_apdu_init(apdu, invoke_id);
+    for (index = device->head;
+         (index != WPM_PLAN_NONE) && (*count < device->writes_max);
+         index = write->next) {
+        write = &Plan_Write[index];
+        object_len = 0;
+        if (!last || (last->object_type != write->object_type) ||
+            (last->object_instance != write->object_instance)) {
+            object_len = wpm_encode_apdu_object_begin(
+                NULL, write->object_type, write->object_instance);
+            if (last) {
+                object_len += wpm_encode_apdu_object_end(NULL);
+            }
+        }
+        wp_data = wpm_plan_write_data(write);
+        property_len = wpm_encode_apdu_object_property(NULL, wp_data);
+        /* room for this write, and the end of its object */
+        if ((apdu_len + object_len + property_len +
+                wpm_encode_apdu_object_end(NULL)) > apdu_max) {
+            break;
+        }
+        if (object_len) {
+            if (last) {
+                apdu_len += wpm_encode_apdu_object_end(&apdu[apdu_len]);
+            }
+            apdu_len += wpm_encode_apdu_object_begin(
+                &apdu[apdu_len], write->object_type, write->object_instance);
+        }
+        apdu_len += wpm_encode_apdu_object_property(&apdu[apdu_len], wp_data);
+        last = write;
+        (*count)++;
+    }
+    if (last) {
+        apdu_len += wpm_encode_apdu_object_end(&apdu[apdu_len]);
+    }
+
+    return (int)apdu_len;
+}
+
+/**
+ * @brief Send one request with the first waiting property writes of
+ *  a device
+ * @param device [in] the device
+ */
+static void wpm_plan_device_send(struct wpm_plan_device *device)
+{
+    struct wpm_plan_request *request = NULL;
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    BACNET_ADDRESS dest;
+    unsigned max_apdu = 0, count = 0, i;
+    uint8_t invoke_id;
+    uint16_t index;
+    int npdu_len, apdu_len;
+
+    if (!dcc_communication_enabled()) {
+        return;
+    }
+    if (!address_bind_request(device->device_id, &max_apdu, &dest)) {
+        if (!device->binding) {
+            Send_WhoIs(device->device_id, device->device_id);
+            mstimer_set(&device->bind_timer, apdu_timeout());
+            device->binding = true;
+        } else if (mstimer_expired(&device->bind_timer)) {
+            /* unable to bind within APDU timeout */
+            device->binding = false;
+            wpm_plan_list_free(device->device_id, device->head,
+                ERROR_CLASS_SERVICES, ERROR_CODE_TIMEOUT);
+            device->head = WPM_PLAN_NONE;
+            device->tail = WPM_PLAN_NONE;
+        }
+        return;
+    }
+    device->binding = false;
+    for (i = 0; i < BACNET_WPM_PLAN_REQUESTS_MAX; i++) {
+        if (Plan_Request[i].invoke_id == 0) {
+            request = &Plan_Request[i];
+            break;
+        }
+    }
+    if (!request) {
+        return;
+    }
+    if (max_apdu > MAX_APDU) {
+        max_apdu = MAX_APDU;
+    }
+    /* the whole PDU must be smaller than the maximum APDU of the device */
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(&Plan_PDU[0], &dest, &my_address, &npdu_data);
+    if ((unsigned)npdu_len >= max_apdu) {
+        return;
+    }
+    invoke_id = tsm_next_free_invokeID();
+    if (invoke_id == 0) {
+        /* no invokeID available: try again later */
+        return;
+    }
+    if (device->single) {
+        apdu_len = wp_encode_apdu(&Plan_PDU[npdu_len], invoke_id,
+            wpm_plan_write_data(&Plan_Write[device->head]));
+        count = 1;
+    } else {
+        apdu_len = wpm_plan_encode(device, &Plan_PDU[npdu_len],
+            max_apdu - npdu_len - 1, invoke_id, &count);
+    }
+    if ((count == 0) || (apdu_len <= 0) ||
+        ((unsigned)(npdu_len + apdu_len) >= max_apdu)) {
+        tsm_free_invoke_id(invoke_id);
+        if (device->head != WPM_PLAN_NONE) {
+            /* a single write that is too large for the device */
+            index = device->head;
+            device->head = Plan_Write[index].next;
+            if (device->head == WPM_PLAN_NONE) {
+                device->tail = WPM_PLAN_NONE;
+            }
+            Plan_Write[index].next = WPM_PLAN_NONE;
+            wpm_plan_list_free(device->device_id, index,
+                ERROR_CLASS_SERVICES, ERROR_CODE_ABORT_APDU_TOO_LONG);
+        }
+        return;
+    }
+    tsm_set_confirmed_unsegmented_transaction(invoke_id, &dest, &npdu_data,
+        &Plan_PDU[0], (uint16_t)(npdu_len + apdu_len));
+    (void)datalink_send_pdu(&dest, &npdu_data, &Plan_PDU[0],
+        npdu_len + apdu_len);
+    request->invoke_id = invoke_id;
+    request->device = (uint16_t)(device - Plan_Device);
+    request->count = count;
+    bacnet_address_copy(&request->address, &dest);
+    /* move the sent writes from the device to the request */
+    request->head = device->head;
+    index = device->head;
+    for (i = 1; i < count; i++) {
+        index = Plan_Write[index].next;
+    }
+    device->head = Plan_Write[index].next;
+    Plan_Write[index].next = WPM_PLAN_NONE;
+    if (device->head == WPM_PLAN_NONE) {
+        device->tail = WPM_PLAN_NONE;
+    }
+    device->pending = true;
+}
+
+/**
+ * @brief Sets the callback for the result of each property write
+ * @param callback - function for callback
+ */
+void bacnet_wpm_plan_callback_set(bacnet_wpm_plan_callback_t callback)
+{
+    Plan_Callback = callback;
+}
+
+/**
+ * @brief Get the number of property writes that are waiting or in flight
+ * @return number of property writes
+ */
+unsigned bacnet_wpm_plan_pending(void)
+{
+    return Plan_Write_Count;
+}
+
+/**
+ * @brief Determine if the planner has no property writes to do
+ * @return true if all the property writes are finished
+ */
+bool bacnet_wpm_plan_idle(void)
+{
+    return (Plan_Write_Count == 0);
+}
+
+/**
+ * @brief Adds a property write of a remote device. Writes are sent in
+ *  the order that they were added for each device. A write to the same
+ *  object, property, array index, and priority as a write that is still
+ *  waiting replaces the value of that write, and only its result is
+ *  given to the callback.
+ * @param device_id - ID of the destination device
+ * @param object_type - Type of the object whose property is to be written.
+ * @param object_instance - Instance # of the object to be written.
+ * @param object_property - Property to be written.
+ * @param array_index - array index of the property, or BACNET_ARRAY_ALL
+ * @param priority - BACnet priority 1..16, or BACNET_NO_PRIORITY
+ * @param value - the value to write
+ * @return true if added or merged, false if not added
+ */
+bool bacnet_wpm_plan_write_add(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t priority,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    struct wpm_plan_device *device;
+    struct wpm_plan_write *write;
+    uint16_t index;
+    int len;
+
+    if ((device_id >= BACNET_MAX_INSTANCE) || !value) {
+        return false;
+    }
+    len = bacapp_encode_application_data(NULL, value);
+    if ((len <= 0) || (len > BACNET_WPM_PLAN_VALUE_SIZE)) {
+        return false;
+    }
+    device = wpm_plan_device_find(device_id, true);
+    if (!device) {
+        return false;
+    }
+    for (index = device->head; index != WPM_PLAN_NONE; index = write->next) {
+        write = &Plan_Write[index];
+        if ((write->object_type == object_type) &&
+            (write->object_instance == object_instance) &&
+            (write->object_property == object_property) &&
+            (write->array_index == array_index) &&
+            (write->priority == priority)) {
+            /* the newer value replaces the value that was not sent */
+            write->value_len =
+                (uint16_t)bacapp_encode_application_data(write->value, value);
+            return true;
+        }
+    }
+    if (Plan_Write_Free == WPM_PLAN_NONE) {
+        wpm_plan_device_release(device);
+        return false;
+    }
+    index = Plan_Write_Free;
+    write = &Plan_Write[index];
+    Plan_Write_Free = write->next;
+    Plan_Write_Count++;
+    write->object_type = object_type;
+    write->object_instance = object_instance;
+    write->object_property = object_property;
+    write->array_index = array_index;
+    write->priority = priority;
+    write->value_len =
+        (uint16_t)bacapp_encode_application_data(write->value, value);
+    write->next = WPM_PLAN_NONE;
+    if (device->tail == WPM_PLAN_NONE) {
+        device->head = index;
+    } else {
+        Plan_Write[device->tail].next = index;
+    }
+    device->tail = index;
+
+    return true;
+}
+
+/**
+ * @brief Handles the repetitive task of the planner: sends a request to
+ *  each device that has waiting writes, and times out requests.
+ */
+void bacnet_wpm_plan_task(void)
+{
+    struct wpm_plan_request *request;
+    struct wpm_plan_device *device;
+    unsigned i;
+
+    for (i = 0; i < BACNET_WPM_PLAN_REQUESTS_MAX; i++) {
+        request = &Plan_Request[i];
+        if (request->invoke_id == 0) {
+            continue;
+        }
+        if (tsm_invoke_id_failed(request->invoke_id)) {
+            tsm_free_invoke_id(request->invoke_id);
+            wpm_plan_request_finish(
+                request, ERROR_CLASS_SERVICES, ERROR_CODE_ABORT_TSM_TIMEOUT);
+        } else if (tsm_invoke_id_free(request->invoke_id)) {
+            /* the transaction ended without a reply for us */
+            wpm_plan_request_finish(
+                request, ERROR_CLASS_SERVICES, ERROR_CODE_OTHER);
+        }
+    }
+    for (i = 0; i < BACNET_WPM_PLAN_DEVICES_MAX; i++) {
+        device = &Plan_Device[i];
+        if (!device->in_use) {
+            continue;
+        }
+        if ((device->head != WPM_PLAN_NONE) && !device->pending) {
+            wpm_plan_device_send(device);
+        }
+        wpm_plan_device_release(device);
+    }
+    if (mstimer_expired(&Cache_Timer)) {
+        mstimer_reset(&Cache_Timer);
+        address_cache_timer(CACHE_CYCLE_SECONDS);
+    }
+}
+
+/**
+ * @brief Initialize the planner and the handlers for its replies.
+ * @note The planner uses the Abort and Reject handlers, and the
+ *  WriteProperty and WritePropertyMultiple handlers, so it is not used
+ *  together with the bac-rw client in the same application.
+ */
+void bacnet_wpm_plan_init(void)
+{
+    unsigned i;
+
+    Plan_Write_Free = WPM_PLAN_NONE;
+    for (i = BACNET_WPM_PLAN_WRITES_MAX; i > 0; i--) {
+        Plan_Write[i - 1].next = Plan_Write_Free;
+        Plan_Write_Free = (uint16_t)(i - 1);
+    }
+    Plan_Write_Count = 0;
+    for (i = 0; i < BACNET_WPM_PLAN_DEVICES_MAX; i++) {
+        Plan_Device[i].in_use = false;
+    }
+    for (i = 0; i < BACNET_WPM_PLAN_REQUESTS_MAX; i++) {
+        Plan_Request[i].invoke_id = 0;
+        Plan_Request[i].head = WPM_PLAN_NONE;
+    }
+    /* handle i-am to support binding to other devices */
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_I_AM, handler_i_am_bind);
+    /* handle the replies of the requests */
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, MyWriteSimpleAckHandler);
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, MyWriteSimpleAckHandler);
+    /* handle any errors coming back */
+    apdu_set_complex_error_handler(SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE,
+        MyWritePropertyMultipleErrorHandler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_WRITE_PROPERTY, MyWritePropertyErrorHandler);
+    apdu_set_abort_handler(MyAbortHandler);
+    apdu_set_reject_handler(MyRejectHandler);
+    /* configure the address cache */
+    address_init();
+    /* start the cyclic 1 second timer for Address Cache */
+    mstimer_set(&Cache_Timer, CACHE_CYCLE_SECONDS * 1000);
+}
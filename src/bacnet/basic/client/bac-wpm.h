@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @brief API to plan WritePropertyMultiple requests to other BACnet
+ *  devices, merging the property writes for each device into as few
+ *  requests as its maximum APDU allows.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_WPM_PLAN_H
+#define BACNET_BASIC_CLIENT_WPM_PLAN_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/wp.h"
+
+/* number of property writes that can be waiting or in flight */
+#ifndef BACNET_WPM_PLAN_WRITES_MAX
+#define BACNET_WPM_PLAN_WRITES_MAX 256
+#endif
+/* number of devices that can have property writes at the same time */
+#ifndef BACNET_WPM_PLAN_DEVICES_MAX
+#define BACNET_WPM_PLAN_DEVICES_MAX 32
+#endif
+/* number of requests in flight, for all devices */
+#ifndef BACNET_WPM_PLAN_REQUESTS_MAX
+#define BACNET_WPM_PLAN_REQUESTS_MAX 16
+#endif
+/* size of the largest encoded value of a property write, in octets */
+#ifndef BACNET_WPM_PLAN_VALUE_SIZE
+#define BACNET_WPM_PLAN_VALUE_SIZE 32
+#endif
+
+/**
+ * Result of a property write
+ *
+ * @param device_instance [in] device instance number of the write
+ * @param wp_data [in] the object, property, array index, priority, and
+ *  encoded value of the write, with error_code of ERROR_CODE_SUCCESS if
+ *  the write succeeded
+ */
+typedef void (*bacnet_wpm_plan_callback_t)(
+    uint32_t device_instance, BACNET_WRITE_PROPERTY_DATA *wp_data);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_wpm_plan_init(void);
+BACNET_STACK_EXPORT
+void bacnet_wpm_plan_task(void);
+BACNET_STACK_EXPORT
+bool bacnet_wpm_plan_idle(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_wpm_plan_pending(void);
+BACNET_STACK_EXPORT
+bool bacnet_wpm_plan_write_add(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t priority,
+    BACNET_APPLICATION_DATA_VALUE *value);
+BACNET_STACK_EXPORT
+void bacnet_wpm_plan_callback_set(bacnet_wpm_plan_callback_t callback);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
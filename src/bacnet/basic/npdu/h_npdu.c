@@ -17,6 +17,7 @@
 #include "bacnet/apdu.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/datalink/datalink.h"
 
 #if PRINT_ENABLED
@@ -216,20 +217,29 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
     int apdu_offset = 0;
     BACNET_ADDRESS dest = { 0 };
     BACNET_NPDU_DATA npdu_data = { 0 };
+    bool discarded = true;
 
     if (pdu_len < 1) {
         return;
     }
+    if (apdu_dcc_npdu_discard(pdu, pdu_len)) {
+        /* a request that is not processed in the DCC state, dropped
+           from its header bytes before it is decoded */
+        bacnet_npdu_stats_received(pdu_len, false, true);
+        return;
+    }
 
     /* only handle the version that we know how to handle */
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
         apdu_offset =
             bacnet_npdu_decode(&pdu[0], pdu_len, &dest, src, &npdu_data);
+        BACNET_TRACE(NPDU_RX, src->net, pdu_len);
         if (npdu_data.network_layer_message) {
             if ((dest.net == 0) || (dest.net == BACNET_BROADCAST_NETWORK)) {
                 network_control_handler(
                     src, &npdu_data, &pdu[apdu_offset],
                     (uint16_t)(pdu_len - apdu_offset));
+                discarded = false;
             } else {
                 debug_printf("NPDU: message for router. Discarded!\n");
             }
@@ -253,6 +263,7 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
                     apdu_handler(
                         src, &pdu[apdu_offset],
                         (uint16_t)(pdu_len - apdu_offset));
+                    discarded = false;
                 }
             } else {
 #if PRINT_ENABLED
@@ -267,6 +278,8 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
             (unsigned)pdu[0]);
 #endif
     }
+    bacnet_npdu_stats_received(
+        pdu_len, npdu_data.network_layer_message, discarded);
 
     return;
 }
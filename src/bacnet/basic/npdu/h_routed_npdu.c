@@ -10,6 +10,8 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -18,8 +20,15 @@
 #include "bacnet/npdu.h"
 #include "bacnet/apdu.h"
 #include "bacnet/bactext.h"
+#include "bacnet/whois.h"
+#include "bacnet/whohas.h"
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/npdu/h_routed_npdu.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/dedup.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/static_pool.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/datalink/datalink.h"
 
@@ -27,6 +36,372 @@
 #include <stdio.h>
 #endif
 
+/* milliseconds that a routed broadcast is remembered, so that the copies
+   of it that arrive again through other routers are dropped, or 0 to
+   disable */
+#ifndef ROUTING_DEDUP_WINDOW_MS
+#define ROUTING_DEDUP_WINDOW_MS 1000
+#endif
+/* number of routed broadcasts remembered within the window */
+#ifndef ROUTING_DEDUP_SIZE
+#define ROUTING_DEDUP_SIZE 32
+#endif
+#if ROUTING_DEDUP_WINDOW_MS
+static BACNET_DEDUP_ENTRY Routing_Dedup_Entries[ROUTING_DEDUP_SIZE];
+static BACNET_DEDUP Routing_Dedup = { Routing_Dedup_Entries,
+    ROUTING_DEDUP_SIZE, 0, ROUTING_DEDUP_WINDOW_MS, 0 };
+#endif
+
+/* Paced Who-Is and Who-Has for the Devices of the gateway.  A broadcast
+   Who-Is or Who-Has is not given to each of the Devices at once, which
+   would send an I-Am or I-Have from each of them in one burst: the Devices
+   in its range are marked, and routing_who_is_timer() gives the request
+   to a batch of the marked Devices in each interval. */
+#ifndef ROUTING_WHO_IS_BATCH
+#define ROUTING_WHO_IS_BATCH 16
+#endif
+#ifndef ROUTING_WHO_IS_INTERVAL_MS
+#define ROUTING_WHO_IS_INTERVAL_MS 100
+#endif
+/* the Devices that are waiting for a request */
+struct routing_pending {
+    /* one bit for each Device that is waiting */
+    uint8_t *bits;
+    uint16_t size;
+    unsigned count;
+    uint16_t cursor;
+    uint32_t elapsed;
+    /* where the request came from, or a broadcast when there are several */
+    BACNET_ADDRESS source;
+    /* the request that is given to each Device */
+    uint8_t *apdu;
+    uint16_t apdu_len;
+};
+static uint8_t Who_Is_APDU[2] = { PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST,
+    SERVICE_UNCONFIRMED_WHO_IS };
+static uint8_t Who_Has_APDU[MAX_APDU];
+static struct routing_pending Who_Is_Pending = { NULL, 0, 0, 0, 0, { 0 },
+    Who_Is_APDU, sizeof(Who_Is_APDU) };
+static struct routing_pending Who_Has_Pending = { NULL, 0, 0, 0, 0, { 0 },
+    Who_Has_APDU, 0 };
+
+/**
+ * @brief Mark a Device as waiting for a request
+ * @param pending - the Devices that are waiting for the request
+ * @param idx - index of the Device
+ */
+static void routing_pending_mark(struct routing_pending *pending, uint16_t idx)
+{
+    uint16_t size;
+    uint8_t *bits;
+    uint8_t mask;
+
+    if (idx >= pending->size) {
+        size = Routed_Device_Count();
+        if (idx >= size) {
+            return;
+        }
+        bits = bacnet_realloc(pending->bits, (size + 7U) / 8U);
+        if (!bits) {
+            return;
+        }
+        memset(&bits[(pending->size + 7U) / 8U], 0,
+            ((size + 7U) / 8U) - ((pending->size + 7U) / 8U));
+        pending->bits = bits;
+        pending->size = size;
+    }
+    mask = (uint8_t)(1U << (idx % 8U));
+    if ((pending->bits[idx / 8U] & mask) == 0) {
+        pending->bits[idx / 8U] |= mask;
+        pending->count++;
+    }
+}
+
+/**
+ * @brief Mark the Devices in a range as waiting for a request
+ * @param pending - the Devices that are waiting for the request
+ * @param src - where the request came from, or NULL for a broadcast
+ * @param low_limit - lowest Device instance of the range
+ * @param high_limit - highest Device instance of the range
+ * @param first - index of the first Device that may be marked
+ */
+static void routing_pending_mark_range(struct routing_pending *pending,
+    BACNET_ADDRESS *src,
+    uint32_t low_limit,
+    uint32_t high_limit,
+    uint16_t first)
+{
+    BACNET_ADDRESS broadcast = { 0 };
+    uint32_t cursor = 0;
+    unsigned count;
+    int idx;
+
+    if (!src) {
+        datalink_get_broadcast_address(&broadcast);
+        src = &broadcast;
+    }
+    count = pending->count;
+    for (;;) {
+        idx = Routed_Device_Range_Next(low_limit, high_limit, &cursor);
+        if (idx < 0) {
+            break;
+        }
+        if (idx >= first) {
+            routing_pending_mark(pending, (uint16_t)idx);
+        }
+    }
+    if (pending->count == count) {
+        return;
+    }
+    if (count == 0) {
+        bacnet_address_copy(&pending->source, src);
+        /* the first batch goes with the next call of the timer */
+        pending->elapsed = ROUTING_WHO_IS_INTERVAL_MS;
+    } else if (!bacnet_address_same(&pending->source, src)) {
+        datalink_get_broadcast_address(&pending->source);
+    }
+}
+
+/**
+ * @brief Give the request to the next batch of the Devices that are
+ *  waiting, once in each interval
+ * @param pending - the Devices that are waiting for the request
+ * @param milliseconds - time since the last call
+ */
+static void routing_pending_timer(
+    struct routing_pending *pending, uint16_t milliseconds)
+{
+    unsigned count = 0;
+    uint16_t idx;
+    uint8_t mask;
+
+    if (pending->count == 0) {
+        return;
+    }
+    pending->elapsed += milliseconds;
+    if (pending->elapsed < ROUTING_WHO_IS_INTERVAL_MS) {
+        return;
+    }
+    pending->elapsed = 0;
+    while ((pending->count > 0) && (count < ROUTING_WHO_IS_BATCH)) {
+        if (pending->cursor >= pending->size) {
+            pending->cursor = 0;
+        }
+        idx = pending->cursor++;
+        mask = (uint8_t)(1U << (idx % 8U));
+        if ((pending->bits[idx / 8U] & mask) == 0) {
+            continue;
+        }
+        pending->bits[idx / 8U] &= (uint8_t)~mask;
+        pending->count--;
+        if (idx < Routed_Device_Count()) {
+            /* the handler answers for the current Device */
+            Get_Routed_Device_Object(idx);
+            apdu_handler(&pending->source, pending->apdu, pending->apdu_len);
+            count++;
+        }
+    }
+}
+
+/** Have the Devices in a range answer a Who-Is, paced by
+ * routing_who_is_timer(), such as for the I-Am of each Device on startup.
+ *
+ * @param src [in] The BACNET_ADDRESS of the source of the Who-Is, or NULL
+ *  for an answer to everyone.
+ * @param low_limit [in] lowest Device instance of the range
+ * @param high_limit [in] highest Device instance of the range
+ */
+void routing_who_is_request(
+    BACNET_ADDRESS *src, uint32_t low_limit, uint32_t high_limit)
+{
+    routing_pending_mark_range(&Who_Is_Pending, src, low_limit, high_limit, 0);
+}
+
+/** Get the number of Devices that are waiting for a Who-Is or a Who-Has.
+ *
+ * @return number of Devices that are waiting
+ */
+unsigned routing_who_is_pending(void)
+{
+    return Who_Is_Pending.count + Who_Has_Pending.count;
+}
+
+/** Give the Who-Is and the Who-Has to the next batch of the Devices that
+ * are waiting, once in each interval.  Call this periodically from the
+ * main loop of the application.
+ *
+ * @param milliseconds [in] time since the last call
+ */
+void routing_who_is_timer(uint16_t milliseconds)
+{
+    routing_pending_timer(&Who_Is_Pending, milliseconds);
+    routing_pending_timer(&Who_Has_Pending, milliseconds);
+}
+
+/** Determine if a message is broadcast to the Devices of the gateway.
+ *
+ * @param dest [in] The BACNET_ADDRESS of the message's destination.
+ * @param DNET_list [in] List of our reachable downstream BACnet Network
+ * numbers. Normally just one valid entry; terminated with a -1 value.
+ * @param first [out] index of the first Device that gets the message,
+ *  which is 1 when the gateway Device does not
+ * @return true if the message is broadcast to the Devices
+ */
+static bool routed_broadcast(BACNET_ADDRESS *dest, int *DNET_list,
+    uint16_t *first)
+{
+    if (dest->net == BACNET_BROADCAST_NETWORK) {
+        *first = 0;
+    } else if ((dest->net == DNET_list[0]) && (dest->len == 0)) {
+        /* all the Devices of the virtual network, without the gateway */
+        *first = 1;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/** Take a Who-Is that is broadcast to the Devices of the gateway, and
+ * mark the Devices in its range for routing_who_is_timer().
+ *
+ * @param src [in] The BACNET_ADDRESS of the message's source.
+ * @param dest [in] The BACNET_ADDRESS of the message's destination.
+ * @param DNET_list [in] List of our reachable downstream BACnet Network
+ * numbers. Normally just one valid entry; terminated with a -1 value.
+ * @param apdu [in] The apdu portion of the request.
+ * @param apdu_len [in] The total (remaining) length of the apdu.
+ * @return true if the APDU was a broadcast Who-Is, which is handled
+ */
+static bool routed_who_is_handler(BACNET_ADDRESS *src,
+    BACNET_ADDRESS *dest,
+    int *DNET_list,
+    uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    int32_t low_limit = 0;
+    int32_t high_limit = BACNET_MAX_INSTANCE;
+    uint16_t first;
+    int len;
+
+    if ((apdu_len < 2) || (apdu[0] != PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) ||
+        (apdu[1] != SERVICE_UNCONFIRMED_WHO_IS)) {
+        return false;
+    }
+    if (!routed_broadcast(dest, DNET_list, &first)) {
+        return false;
+    }
+    len = whois_decode_service_request(
+        &apdu[2], apdu_len - 2, &low_limit, &high_limit);
+    if (len == BACNET_STATUS_ERROR) {
+        /* not for anyone */
+        return true;
+    }
+    if (len == 0) {
+        low_limit = 0;
+        high_limit = BACNET_MAX_INSTANCE;
+    }
+    routing_pending_mark_range(&Who_Is_Pending, src, (uint32_t)low_limit,
+        (uint32_t)high_limit, first);
+
+    return true;
+}
+
+/** Take a Who-Has that is broadcast to the Devices of the gateway.
+ * A Device object is found by its instance or name with one lookup of
+ * the Devices, and answers at once.  Any other object is looked up once
+ * in the Object_Table that the Devices share, unless the Devices have
+ * their own object databases, and the Devices in the range are then
+ * marked for routing_who_is_timer().
+ *
+ * @param src [in] The BACNET_ADDRESS of the message's source.
+ * @param dest [in] The BACNET_ADDRESS of the message's destination.
+ * @param DNET_list [in] List of our reachable downstream BACnet Network
+ * numbers. Normally just one valid entry; terminated with a -1 value.
+ * @param apdu [in] The apdu portion of the request.
+ * @param apdu_len [in] The total (remaining) length of the apdu.
+ * @return true if the APDU was a broadcast Who-Has, which is handled
+ */
+static bool routed_who_has_handler(BACNET_ADDRESS *src,
+    BACNET_ADDRESS *dest,
+    int *DNET_list,
+    uint8_t *apdu,
+    uint16_t apdu_len)
+{
+    BACNET_WHO_HAS_DATA data;
+    uint32_t low_limit = 0;
+    uint32_t high_limit = BACNET_MAX_INSTANCE;
+    uint32_t instance;
+    uint16_t first;
+    bool found = false;
+    int len;
+    int idx = -1;
+
+    if ((apdu_len < 2) || (apdu[0] != PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) ||
+        (apdu[1] != SERVICE_UNCONFIRMED_WHO_HAS)) {
+        return false;
+    }
+    if (!routed_broadcast(dest, DNET_list, &first)) {
+        return false;
+    }
+    len = whohas_decode_service_request(&apdu[2], apdu_len - 2, &data);
+    if (len <= 0) {
+        /* not for anyone */
+        return true;
+    }
+    if ((data.low_limit != -1) && (data.high_limit != -1)) {
+        low_limit = (uint32_t)data.low_limit;
+        high_limit = (uint32_t)data.high_limit;
+    }
+    if (data.is_object_name) {
+        idx = Routed_Device_Name_Find(&data.object.name);
+    } else if (data.object.identifier.type == OBJECT_DEVICE) {
+        idx = Routed_Device_Find(data.object.identifier.instance);
+        if (idx < 0) {
+            return true;
+        }
+    }
+    if (idx >= 0) {
+        instance = Get_Routed_Device_Object(idx)->bacObj.Object_Instance_Number;
+        if ((idx >= first) && (instance >= low_limit) &&
+            (instance <= high_limit)) {
+            apdu_handler(src, apdu, apdu_len);
+        }
+        return true;
+    }
+    if (!Routed_Device_Database_Provider()) {
+        /* the Devices have the same objects as the gateway Device */
+        Get_Routed_Device_Object(0);
+        if (data.is_object_name) {
+            found = Device_Valid_Object_Name(&data.object.name, NULL, NULL);
+        } else {
+            found = Device_Valid_Object_Id(
+                (BACNET_OBJECT_TYPE)data.object.identifier.type,
+                data.object.identifier.instance);
+        }
+        if (!found) {
+            return true;
+        }
+    }
+    if (apdu_len > sizeof(Who_Has_APDU)) {
+        return false;
+    }
+    if (Who_Has_Pending.count > 0) {
+        if ((Who_Has_Pending.apdu_len != apdu_len) ||
+            (memcmp(Who_Has_Pending.apdu, apdu, apdu_len) != 0)) {
+            /* another Who-Has is waiting, so this is not paced */
+            return false;
+        }
+    } else {
+        memcpy(Who_Has_Pending.apdu, apdu, apdu_len);
+        Who_Has_Pending.apdu_len = apdu_len;
+    }
+    routing_pending_mark_range(
+        &Who_Has_Pending, src, low_limit, high_limit, first);
+
+    return true;
+}
+
 /** Handler to manage the Network Layer Control Messages received in a packet.
  *  This handler is called if the NCPI bit 7 indicates that this packet is a
  *  network layer message and there is no further DNET to pass it to.
@@ -209,7 +584,12 @@ static void routed_apdu_handler(BACNET_ADDRESS *src,
         }
         return;
     }
-
+    if (routed_who_is_handler(src, dest, DNET_list, apdu, apdu_len)) {
+        return;
+    }
+    if (routed_who_has_handler(src, dest, DNET_list, apdu, apdu_len)) {
+        return;
+    }
     while (Routed_Device_GetNext(dest, DNET_list, &cursor)) {
         apdu_handler(src, apdu, apdu_len);
         bGotOne = true;
@@ -252,6 +632,57 @@ static void routed_apdu_handler(BACNET_ADDRESS *src,
  *  @param pdu [in]  Buffer containing the NPDU and APDU of the received packet.
  *  @param pdu_len [in] The size of the received message in the pdu[] buffer.
  */
+/**
+ * @brief Check whether a broadcast APDU was received within the window
+ *  from the same source, such as through another router.  The NPCI is
+ *  not part of the key, since the hop count is different on each path.
+ * @param src - the source address, with its SNET and SADR if routed
+ * @param dest - the destination address of the NPDU
+ * @param apdu - the APDU
+ * @param apdu_len - number of bytes of the APDU
+ * @return true if the broadcast is a repeat, which is dropped
+ */
+static bool routing_broadcast_repeated(const BACNET_ADDRESS *src,
+    const BACNET_ADDRESS *dest,
+    const uint8_t *apdu,
+    uint16_t apdu_len)
+{
+#if ROUTING_DEDUP_WINDOW_MS
+    uint8_t key[3 + MAX_MAC_LEN];
+    size_t key_len = 0;
+
+    if ((dest->net != BACNET_BROADCAST_NETWORK) &&
+        ((dest->net == 0) || (dest->len != 0))) {
+        /* only the remote and global broadcasts travel through routers */
+        return false;
+    }
+    if ((src->len > MAX_MAC_LEN) || (src->mac_len > MAX_MAC_LEN)) {
+        return false;
+    }
+    key[key_len++] = (uint8_t)(src->net >> 8);
+    key[key_len++] = (uint8_t)src->net;
+    if (src->net) {
+        key[key_len++] = src->len;
+        memcpy(&key[key_len], src->adr, src->len);
+        key_len += src->len;
+    } else {
+        key[key_len++] = src->mac_len;
+        memcpy(&key[key_len], src->mac, src->mac_len);
+        key_len += src->mac_len;
+    }
+
+    return bacnet_dedup_check(
+        &Routing_Dedup, key, key_len, apdu, apdu_len, mstimer_now());
+#else
+    (void)src;
+    (void)dest;
+    (void)apdu;
+    (void)apdu_len;
+
+    return false;
+#endif
+}
+
 void routing_npdu_handler(
     BACNET_ADDRESS *src, int *DNET_list, uint8_t *pdu, uint16_t pdu_len)
 {
@@ -262,6 +693,7 @@ void routing_npdu_handler(
     /* only handle the version that we know how to handle */
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
         apdu_offset = bacnet_npdu_decode(pdu, pdu_len, &dest, src, &npdu_data);
+        BACNET_TRACE(NPDU_RX, src->net, pdu_len);
         if (apdu_offset <= 0) {
             debug_printf("NPDU: Decoding failed; Discarded!\n");
         } else if (npdu_data.network_layer_message) {
@@ -275,7 +707,10 @@ void routing_npdu_handler(
                  * since only routers can handle it (even if for our DNET) */
             }
         } else if (apdu_offset <= pdu_len) {
-            if ((dest.net == 0) || (npdu_data.hop_count > 1)) {
+            if (routing_broadcast_repeated(src, &dest, &pdu[apdu_offset],
+                    (uint16_t)(pdu_len - apdu_offset))) {
+                debug_printf("NPDU: repeated broadcast; Discarded!\n");
+            } else if ((dest.net == 0) || (npdu_data.hop_count > 1)) {
                 routed_apdu_handler(src, &dest, DNET_list, &pdu[apdu_offset],
                     (uint16_t)(pdu_len - apdu_offset));
             }
@@ -27,6 +27,18 @@ extern "C" {
         uint8_t * pdu,
         uint16_t pdu_len);
 
+    BACNET_STACK_EXPORT
+    void routing_who_is_request(
+        BACNET_ADDRESS * src,
+        uint32_t low_limit,
+        uint32_t high_limit);
+    BACNET_STACK_EXPORT
+    unsigned routing_who_is_pending(
+        void);
+    BACNET_STACK_EXPORT
+    void routing_who_is_timer(
+        uint16_t milliseconds);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,246 @@
+/**
+ * @file
+ * @brief The routing table of a BACnet router, an open addressed hash
+ *  table of the routes keyed by network number, so that each routed
+ *  message finds its route in constant time however many networks the
+ *  router knows, and where each route keeps its reachability.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/npdu/route_table.h"
+
+/**
+ * @brief Get the first entry to look at for a network
+ * @param table - the routing table
+ * @param net - network number
+ * @return entry index
+ */
+static unsigned route_table_slot(const BACNET_ROUTE_TABLE *table, uint16_t net)
+{
+    /* Knuth multiplicative hash spreads the consecutive networks */
+    return (unsigned)((((uint32_t)net * 2654435761UL) & 0xFFFFFFFFUL) >> 16) &
+        (table->size - 1);
+}
+
+/**
+ * @brief Get the entry of a network, or the empty entry where it belongs
+ * @param table - the routing table
+ * @param net - network number
+ * @return entry index
+ */
+static unsigned route_table_index(const BACNET_ROUTE_TABLE *table, uint16_t net)
+{
+    unsigned index = route_table_slot(table, net);
+
+    while ((table->entries[index].net != 0) &&
+        (table->entries[index].net != net)) {
+        index = (index + 1) & (table->size - 1);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Initialize a routing table, which is empty
+ * @param table - the routing table
+ * @param entries - the entries of the table
+ * @param size - number of entries, a power of two
+ */
+void bacnet_route_table_init(
+    BACNET_ROUTE_TABLE *table, BACNET_ROUTE_ENTRY *entries, unsigned size)
+{
+    if (!table) {
+        return;
+    }
+    /* only a power of two is used */
+    while (size & (size - 1)) {
+        size &= size - 1;
+    }
+    table->entries = entries;
+    table->size = entries ? size : 0;
+    table->count = 0;
+    if (table->size) {
+        memset(entries, 0, size * sizeof(BACNET_ROUTE_ENTRY));
+    }
+}
+
+/**
+ * @brief Find the route to a network
+ * @param table - the routing table
+ * @param net - network number
+ * @return the route, or NULL if the network is not in the table
+ */
+BACNET_ROUTE_ENTRY *bacnet_route_find(BACNET_ROUTE_TABLE *table, uint16_t net)
+{
+    BACNET_ROUTE_ENTRY *entry;
+
+    if (!table || (table->size == 0) || (net == 0) ||
+        (net == BACNET_BROADCAST_NETWORK)) {
+        return NULL;
+    }
+    entry = &table->entries[route_table_index(table, net)];
+    if (entry->net == 0) {
+        return NULL;
+    }
+
+    return entry;
+}
+
+/**
+ * @brief Add the route to a network, which is reachable
+ * @param table - the routing table
+ * @param net - network number
+ * @param port - the port of the router that the network is reached through
+ * @param mac - the next router on the port, or NULL when the network is
+ *  directly connected
+ * @param mac_len - number of octets of the next router address
+ * @return the route, which is the route already in the table for the
+ *  network, or NULL if the table is full
+ */
+BACNET_ROUTE_ENTRY *bacnet_route_add(BACNET_ROUTE_TABLE *table,
+    uint16_t net,
+    void *port,
+    const uint8_t *mac,
+    uint8_t mac_len)
+{
+    BACNET_ROUTE_ENTRY *entry;
+
+    if (!table || (table->size == 0) || (net == 0) ||
+        (net == BACNET_BROADCAST_NETWORK)) {
+        return NULL;
+    }
+    entry = &table->entries[route_table_index(table, net)];
+    if (entry->net != 0) {
+        return entry;
+    }
+    /* keep the table at most three quarters full */
+    if (((table->count + 1) * 4) > (table->size * 3)) {
+        return NULL;
+    }
+    memset(entry, 0, sizeof(BACNET_ROUTE_ENTRY));
+    entry->net = net;
+    entry->flags = BACNET_ROUTE_REACHABLE;
+    entry->port = port;
+    if (mac && mac_len) {
+        if (mac_len > MAX_MAC_LEN) {
+            mac_len = MAX_MAC_LEN;
+        }
+        memcpy(entry->mac, mac, mac_len);
+        entry->mac_len = mac_len;
+    }
+    table->count++;
+
+    return entry;
+}
+
+/**
+ * @brief Remove the route to a network. The routes that follow it are
+ *  moved back, so that no route is left behind an empty entry.
+ * @param table - the routing table
+ * @param net - network number
+ * @return true if the route was removed
+ */
+bool bacnet_route_remove(BACNET_ROUTE_TABLE *table, uint16_t net)
+{
+    unsigned mask;
+    unsigned empty;
+    unsigned index;
+    unsigned slot;
+
+    if (!bacnet_route_find(table, net)) {
+        return false;
+    }
+    mask = table->size - 1;
+    empty = route_table_index(table, net);
+    index = empty;
+    for (;;) {
+        index = (index + 1) & mask;
+        if (table->entries[index].net == 0) {
+            break;
+        }
+        slot = route_table_slot(table, table->entries[index].net);
+        /* move the route if its first entry is not between the empty
+           entry and where it is */
+        if (((index - slot) & mask) >= ((index - empty) & mask)) {
+            table->entries[empty] = table->entries[index];
+            empty = index;
+        }
+    }
+    memset(&table->entries[empty], 0, sizeof(BACNET_ROUTE_ENTRY));
+    table->count--;
+
+    return true;
+}
+
+/**
+ * @brief Get the next route of the table, such as to list the networks
+ * @param table - the routing table
+ * @param entry - the previous route, or NULL for the first route
+ * @return the next route, or NULL after the last route
+ */
+BACNET_ROUTE_ENTRY *
+bacnet_route_next(BACNET_ROUTE_TABLE *table, BACNET_ROUTE_ENTRY *entry)
+{
+    unsigned index = 0;
+
+    if (!table || (table->size == 0)) {
+        return NULL;
+    }
+    if (entry) {
+        index = (unsigned)(entry - table->entries) + 1;
+    }
+    while (index < table->size) {
+        if (table->entries[index].net != 0) {
+            return &table->entries[index];
+        }
+        index++;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set or clear flags of all the routes through a port, such as
+ *  when the port becomes busy or is available again
+ * @param table - the routing table
+ * @param port - the port of the router
+ * @param flags - the flags to set or clear
+ * @param state - true to set the flags, or false to clear them
+ * @return the number of routes through the port
+ */
+unsigned bacnet_route_port_flags_set(
+    BACNET_ROUTE_TABLE *table, void *port, uint8_t flags, bool state)
+{
+    BACNET_ROUTE_ENTRY *entry = NULL;
+    unsigned count = 0;
+
+    while ((entry = bacnet_route_next(table, entry)) != NULL) {
+        if (entry->port == port) {
+            if (state) {
+                entry->flags |= flags;
+            } else {
+                entry->flags &= ~flags;
+            }
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the number of routes of the table
+ * @param table - the routing table
+ * @return the number of routes
+ */
+unsigned bacnet_route_count(const BACNET_ROUTE_TABLE *table)
+{
+    return table ? table->count : 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief API for the routing table of a BACnet router, where the route to
+ *  a network is found by its network number in constant time, and where
+ *  the reachability of each route is kept with the route.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_NPDU_ROUTE_TABLE_H
+#define BACNET_BASIC_NPDU_ROUTE_TABLE_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/**
+ * Route Flags
+ * @{
+ */
+/* the network can receive traffic through the route */
+#define BACNET_ROUTE_REACHABLE 0x01
+/* the network is busy, as told by a Router-Busy-To-Network */
+#define BACNET_ROUTE_BUSY 0x02
+/** @} */
+
+/* the route to one network */
+typedef struct bacnet_route_entry {
+    /* network number, or 0 when the entry is empty */
+    uint16_t net;
+    uint8_t flags;
+    /* the next router on the port, or a length of 0 when the network
+       is directly connected */
+    uint8_t mac_len;
+    uint8_t mac[MAX_MAC_LEN];
+    /* the port of the router that the network is reached through */
+    void *port;
+    /* data that the router keeps with the route */
+    void *data;
+    /* milliseconds when the route was learned, kept by the router */
+    unsigned long learned;
+} BACNET_ROUTE_ENTRY;
+
+/**
+ * The routing table, whose entries are declared by the router, such as
+ * statically. The number of entries is a power of two, and the table is
+ * full when three quarters of them are routes. An entry may move when
+ * another route is removed, so the routes are found again by network
+ * number rather than kept by pointer.
+ */
+typedef struct bacnet_route_table {
+    BACNET_ROUTE_ENTRY *entries;
+    unsigned size;
+    unsigned count;
+} BACNET_ROUTE_TABLE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_route_table_init(
+    BACNET_ROUTE_TABLE *table, BACNET_ROUTE_ENTRY *entries, unsigned size);
+BACNET_STACK_EXPORT
+BACNET_ROUTE_ENTRY *bacnet_route_find(BACNET_ROUTE_TABLE *table, uint16_t net);
+BACNET_STACK_EXPORT
+BACNET_ROUTE_ENTRY *bacnet_route_add(BACNET_ROUTE_TABLE *table,
+    uint16_t net,
+    void *port,
+    const uint8_t *mac,
+    uint8_t mac_len);
+BACNET_STACK_EXPORT
+bool bacnet_route_remove(BACNET_ROUTE_TABLE *table, uint16_t net);
+BACNET_STACK_EXPORT
+BACNET_ROUTE_ENTRY *
+bacnet_route_next(BACNET_ROUTE_TABLE *table, BACNET_ROUTE_ENTRY *entry);
+BACNET_STACK_EXPORT
+unsigned bacnet_route_port_flags_set(
+    BACNET_ROUTE_TABLE *table, void *port, uint8_t flags, bool state);
+BACNET_STACK_EXPORT
+unsigned bacnet_route_count(const BACNET_ROUTE_TABLE *table);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -22,6 +22,16 @@ static bool Access_Credential_Initialized = false;
 
 static ACCESS_CREDENTIAL_DESCR ac_descr[MAX_ACCESS_CREDENTIALS];
 
+/* index from authentication factor to credential, so that a card read is
+   matched to its credential without a search of every credential */
+typedef struct {
+    uint32_t hash;
+    /* credential index times MAX_AUTHENTICATION_FACTORS plus the factor
+       index, plus one, or 0 when the entry is empty */
+    uint32_t position;
+} ACCESS_CREDENTIAL_INDEX;
+static ACCESS_CREDENTIAL_INDEX ac_index[ACCESS_CREDENTIAL_INDEX_SIZE];
+
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_GLOBAL_IDENTIFIER,
@@ -50,6 +60,143 @@ void Access_Credential_Property_Lists(
     return;
 }
 
+/**
+ * @brief Get the hash of an authentication factor, of its format and value
+ * @param af - authentication factor
+ * @return FNV-1a hash
+ */
+static uint32_t Access_Credential_Factor_Hash(BACNET_AUTHENTICATION_FACTOR *af)
+{
+    uint32_t hash = 2166136261UL;
+    uint32_t format[2];
+    const uint8_t *octets;
+    size_t len, i;
+
+    format[0] = (uint32_t)af->format_type;
+    format[1] = af->format_class;
+    octets = (const uint8_t *)format;
+    for (i = 0; i < sizeof(format); i++) {
+        hash = (hash ^ octets[i]) * 16777619UL;
+    }
+    octets = octetstring_value(&af->value);
+    len = octetstring_length(&af->value);
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ octets[i]) * 16777619UL;
+    }
+
+    return hash & 0xFFFFFFFFUL;
+}
+
+static BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *
+Access_Credential_Position_Factor(uint32_t position)
+{
+    position--;
+
+    return &ac_descr[position / MAX_AUTHENTICATION_FACTORS]
+                .auth_factors[position % MAX_AUTHENTICATION_FACTORS];
+}
+
+static bool Access_Credential_Factor_Same(
+    BACNET_AUTHENTICATION_FACTOR *af1, BACNET_AUTHENTICATION_FACTOR *af2)
+{
+    return (af1->format_type == af2->format_type) &&
+        (af1->format_class == af2->format_class) &&
+        octetstring_value_same(&af1->value, &af2->value);
+}
+
+/**
+ * @brief Add an authentication factor of a credential to the index
+ * @param object_index - credential index
+ * @param factor_index - authentication factor index
+ */
+static void Access_Credential_Index_Add(
+    unsigned object_index, unsigned factor_index)
+{
+    BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *caf;
+    uint32_t hash;
+    unsigned slot;
+
+    caf = &ac_descr[object_index].auth_factors[factor_index];
+    hash = Access_Credential_Factor_Hash(&caf->authentication_factor);
+    slot = hash % ACCESS_CREDENTIAL_INDEX_SIZE;
+    while (ac_index[slot].position != 0) {
+        slot = (slot + 1) % ACCESS_CREDENTIAL_INDEX_SIZE;
+    }
+    ac_index[slot].hash = hash;
+    ac_index[slot].position =
+        (object_index * MAX_AUTHENTICATION_FACTORS) + factor_index + 1;
+}
+
+/**
+ * @brief Remove an authentication factor of a credential from the index.
+ *  The factors that follow it are moved back, so that none is left behind
+ *  an empty entry.
+ * @param object_index - credential index
+ * @param factor_index - authentication factor index
+ */
+static void Access_Credential_Index_Remove(
+    unsigned object_index, unsigned factor_index)
+{
+    BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *caf;
+    uint32_t position;
+    unsigned slot, empty, home;
+
+    caf = &ac_descr[object_index].auth_factors[factor_index];
+    position = (object_index * MAX_AUTHENTICATION_FACTORS) + factor_index + 1;
+    slot = Access_Credential_Factor_Hash(&caf->authentication_factor) %
+        ACCESS_CREDENTIAL_INDEX_SIZE;
+    while (ac_index[slot].position != position) {
+        if (ac_index[slot].position == 0) {
+            return;
+        }
+        slot = (slot + 1) % ACCESS_CREDENTIAL_INDEX_SIZE;
+    }
+    empty = slot;
+    for (;;) {
+        slot = (slot + 1) % ACCESS_CREDENTIAL_INDEX_SIZE;
+        if (ac_index[slot].position == 0) {
+            break;
+        }
+        home = ac_index[slot].hash % ACCESS_CREDENTIAL_INDEX_SIZE;
+        if (((slot + ACCESS_CREDENTIAL_INDEX_SIZE - home) %
+                ACCESS_CREDENTIAL_INDEX_SIZE) >=
+            ((slot + ACCESS_CREDENTIAL_INDEX_SIZE - empty) %
+                ACCESS_CREDENTIAL_INDEX_SIZE)) {
+            ac_index[empty] = ac_index[slot];
+            empty = slot;
+        }
+    }
+    ac_index[empty].hash = 0;
+    ac_index[empty].position = 0;
+}
+
+/**
+ * @brief Resolve the assigned access rights of a credential, so that an
+ *  authorization does not decode them
+ * @param object_index - credential index
+ */
+static void Access_Credential_Resolve(unsigned object_index)
+{
+    ACCESS_CREDENTIAL_DESCR *ac = &ac_descr[object_index];
+    BACNET_ASSIGNED_ACCESS_RIGHTS *aar;
+    unsigned i;
+
+    ac->authorized = ac->credential_status &&
+        (ac->credential_disable == ACCESS_CREDENTIAL_DISABLE_NONE) &&
+        (ac->reliability == RELIABILITY_NO_FAULT_DETECTED);
+    ac->access_rights_count = 0;
+    for (i = 0; i < ac->assigned_access_rights_count; i++) {
+        aar = &ac->assigned_access_rights[i];
+        if (aar->enable &&
+            (aar->assigned_access_rights.objectIdentifier.type ==
+                OBJECT_ACCESS_RIGHTS)) {
+            ac->access_rights[ac->access_rights_count] =
+                aar->assigned_access_rights.objectIdentifier.instance;
+            ac->access_rights_count++;
+        }
+    }
+}
+
 void Access_Credential_Init(void)
 {
     unsigned i;
@@ -68,7 +215,9 @@ void Access_Credential_Init(void)
             memset(&ac_descr[i].expiration_time, 0, sizeof(BACNET_DATE_TIME));
             ac_descr[i].credential_disable = ACCESS_CREDENTIAL_DISABLE_NONE;
             ac_descr[i].assigned_access_rights_count = 0;
+            Access_Credential_Resolve(i);
         }
+        memset(ac_index, 0, sizeof(ac_index));
     }
 
     return;
@@ -366,3 +515,181 @@ bool Access_Credential_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 
     return status;
 }
+
+/**
+ * @brief Set the credential status, active or inactive
+ * @param object_instance - object-instance number of the object
+ * @param active - true if the credential is active
+ * @return true if the credential status was set
+ */
+bool Access_Credential_Status_Set(uint32_t object_instance, bool active)
+{
+    unsigned object_index;
+
+    object_index = Access_Credential_Instance_To_Index(object_instance);
+    if (object_index >= MAX_ACCESS_CREDENTIALS) {
+        return false;
+    }
+    ac_descr[object_index].credential_status = active;
+    Access_Credential_Resolve(object_index);
+
+    return true;
+}
+
+/**
+ * @brief Set an authentication factor of a credential, and index it
+ * @param object_instance - object-instance number of the object
+ * @param index - 0 to N for an authentication factor, where N, the number
+ *  of authentication factors, adds one
+ * @param factor - the authentication factor
+ * @return true if the authentication factor was set
+ */
+bool Access_Credential_Authentication_Factor_Set(uint32_t object_instance,
+    unsigned index,
+    BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *factor)
+{
+    ACCESS_CREDENTIAL_DESCR *ac;
+    unsigned object_index;
+
+    object_index = Access_Credential_Instance_To_Index(object_instance);
+    if ((object_index >= MAX_ACCESS_CREDENTIALS) || !factor ||
+        (index >= MAX_AUTHENTICATION_FACTORS)) {
+        return false;
+    }
+    ac = &ac_descr[object_index];
+    if (index > ac->auth_factors_count) {
+        return false;
+    }
+    if (index < ac->auth_factors_count) {
+        Access_Credential_Index_Remove(object_index, index);
+    } else {
+        ac->auth_factors_count++;
+    }
+    ac->auth_factors[index].disable = factor->disable;
+    ac->auth_factors[index].authentication_factor.format_type =
+        factor->authentication_factor.format_type;
+    ac->auth_factors[index].authentication_factor.format_class =
+        factor->authentication_factor.format_class;
+    octetstring_copy(&ac->auth_factors[index].authentication_factor.value,
+        &factor->authentication_factor.value);
+    Access_Credential_Index_Add(object_index, index);
+
+    return true;
+}
+
+/**
+ * @brief Set an assigned access rights of a credential, and resolve them
+ * @param object_instance - object-instance number of the object
+ * @param index - 0 to N for an assigned access rights, where N, the number
+ *  of assigned access rights, adds one
+ * @param rights - the assigned access rights
+ * @return true if the assigned access rights were set
+ */
+bool Access_Credential_Assigned_Access_Rights_Set(uint32_t object_instance,
+    unsigned index,
+    BACNET_ASSIGNED_ACCESS_RIGHTS *rights)
+{
+    ACCESS_CREDENTIAL_DESCR *ac;
+    unsigned object_index;
+
+    object_index = Access_Credential_Instance_To_Index(object_instance);
+    if ((object_index >= MAX_ACCESS_CREDENTIALS) || !rights ||
+        (index >= MAX_ASSIGNED_ACCESS_RIGHTS)) {
+        return false;
+    }
+    ac = &ac_descr[object_index];
+    if (index > ac->assigned_access_rights_count) {
+        return false;
+    }
+    if (index == ac->assigned_access_rights_count) {
+        ac->assigned_access_rights_count++;
+    }
+    ac->assigned_access_rights[index] = *rights;
+    Access_Credential_Resolve(object_index);
+
+    return true;
+}
+
+/**
+ * @brief Find the credential of an authentication factor, such as of a
+ *  card read, with the index rather than a search of every credential
+ * @param factor - the authentication factor
+ * @param index - the authentication factor index of the credential,
+ *  or NULL
+ * @return object-instance number of the credential, or BACNET_MAX_INSTANCE
+ *  if no credential has the authentication factor
+ */
+uint32_t Access_Credential_Authentication_Factor_Lookup(
+    BACNET_AUTHENTICATION_FACTOR *factor, unsigned *index)
+{
+    BACNET_CREDENTIAL_AUTHENTICATION_FACTOR *caf;
+    uint32_t hash;
+    unsigned slot;
+    uint32_t position;
+
+    if (!factor) {
+        return BACNET_MAX_INSTANCE;
+    }
+    hash = Access_Credential_Factor_Hash(factor);
+    slot = hash % ACCESS_CREDENTIAL_INDEX_SIZE;
+    while ((position = ac_index[slot].position) != 0) {
+        if (ac_index[slot].hash == hash) {
+            caf = Access_Credential_Position_Factor(position);
+            if (Access_Credential_Factor_Same(
+                    &caf->authentication_factor, factor)) {
+                if (index) {
+                    *index = (position - 1) % MAX_AUTHENTICATION_FACTORS;
+                }
+                return Access_Credential_Index_To_Instance(
+                    (position - 1) / MAX_AUTHENTICATION_FACTORS);
+            }
+        }
+        slot = (slot + 1) % ACCESS_CREDENTIAL_INDEX_SIZE;
+    }
+
+    return BACNET_MAX_INSTANCE;
+}
+
+/**
+ * @brief Authorize an authentication factor, such as of a card read, for
+ *  an access rights object, with the credential found by the index and its
+ *  resolved access rights
+ * @param factor - the authentication factor
+ * @param access_rights_instance - the access rights object-instance number
+ * @param object_instance - the credential object-instance number, or
+ *  BACNET_MAX_INSTANCE if no credential has the authentication factor
+ * @return true if the credential is active and enabled, and is assigned
+ *  the enabled access rights
+ */
+bool Access_Credential_Authorize(BACNET_AUTHENTICATION_FACTOR *factor,
+    uint32_t access_rights_instance,
+    uint32_t *object_instance)
+{
+    ACCESS_CREDENTIAL_DESCR *ac;
+    uint32_t instance;
+    unsigned object_index;
+    unsigned index = 0;
+    unsigned i;
+
+    instance = Access_Credential_Authentication_Factor_Lookup(factor, &index);
+    if (object_instance) {
+        *object_instance = instance;
+    }
+    object_index = Access_Credential_Instance_To_Index(instance);
+    if (object_index >= MAX_ACCESS_CREDENTIALS) {
+        return false;
+    }
+    ac = &ac_descr[object_index];
+    if (!ac->authorized ||
+        (ac->auth_factors[index].disable !=
+            ACCESS_AUTHENTICATION_FACTOR_DISABLE_NONE)) {
+        return false;
+    }
+    for (i = 0; i < ac->access_rights_count; i++) {
+        if (ac->access_rights[i] == access_rights_instance) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -38,6 +38,14 @@
 #define MAX_ASSIGNED_ACCESS_RIGHTS 4
 #endif
 
+/* number of entries of the index from authentication factor to
+   credential, which must be more than the authentication factors
+   of all the credentials */
+#ifndef ACCESS_CREDENTIAL_INDEX_SIZE
+#define ACCESS_CREDENTIAL_INDEX_SIZE \
+    (2 * MAX_ACCESS_CREDENTIALS * MAX_AUTHENTICATION_FACTORS)
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -57,6 +65,10 @@ extern "C" {
         uint32_t assigned_access_rights_count;
         BACNET_ASSIGNED_ACCESS_RIGHTS
             assigned_access_rights[MAX_ASSIGNED_ACCESS_RIGHTS];
+        /* helper values, not properties: the resolved access rights */
+        bool authorized;
+        uint32_t access_rights_count;
+        uint32_t access_rights[MAX_ASSIGNED_ACCESS_RIGHTS];
     } ACCESS_CREDENTIAL_DESCR;
 
     BACNET_STACK_EXPORT
@@ -97,6 +109,30 @@ extern "C" {
     bool Access_Credential_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
 
+    BACNET_STACK_EXPORT
+    bool Access_Credential_Status_Set(
+        uint32_t object_instance,
+        bool active);
+    BACNET_STACK_EXPORT
+    bool Access_Credential_Authentication_Factor_Set(
+        uint32_t object_instance,
+        unsigned index,
+        BACNET_CREDENTIAL_AUTHENTICATION_FACTOR * factor);
+    BACNET_STACK_EXPORT
+    bool Access_Credential_Assigned_Access_Rights_Set(
+        uint32_t object_instance,
+        unsigned index,
+        BACNET_ASSIGNED_ACCESS_RIGHTS * rights);
+    BACNET_STACK_EXPORT
+    uint32_t Access_Credential_Authentication_Factor_Lookup(
+        BACNET_AUTHENTICATION_FACTOR * factor,
+        unsigned *index);
+    BACNET_STACK_EXPORT
+    bool Access_Credential_Authorize(
+        BACNET_AUTHENTICATION_FACTOR * factor,
+        uint32_t access_rights_instance,
+        uint32_t *object_instance);
+
     BACNET_STACK_EXPORT
     uint32_t Access_Credential_Create(
         uint32_t object_instance);
@@ -6,6 +6,7 @@
  * @date 2005, 2011
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -20,13 +21,23 @@
 #include "bacnet/proplist.h"
 #include "bacnet/timestamp.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/service/alarm_active.h"
+#include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/columns.h"
 #include "bacnet/basic/sys/debug.h"
 /* me! */
 #include "bacnet/basic/object/ai.h"
 
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/* the values of the objects, in columns */
+static COLUMNS_STORE Object_Columns;
+#endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_ANALOG_INPUT;
 
@@ -97,6 +108,24 @@ static struct analog_input_descr *Analog_Input_Object_Index(int index)
 {
     return Keylist_Data_Index(Object_List, index);
 }
+
+/**
+ * @brief Update the entry of an object in the device set of the objects
+ *  with an active alarm, after its Event_State or Acked_Transitions change
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ */
+static void Analog_Input_Alarm_Active_Update(
+    uint32_t object_instance, struct analog_input_descr *pObject)
+{
+    bool active;
+
+    active = (pObject->Event_State != EVENT_STATE_NORMAL) ||
+        !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked;
+    (void)Alarm_Active_Set(Object_Type, object_instance, active);
+}
 #endif
 
 /**
@@ -170,6 +199,137 @@ float Analog_Input_Present_Value(uint32_t object_instance)
     return value;
 }
 
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/**
+ * @brief Copy the Present_Value, status flags and COV flag of an object
+ *  into its row of the columns
+ * @param pObject - object data
+ */
+static void Analog_Input_Columns_Update(struct analog_input_descr *pObject)
+{
+    uint8_t flags = 0;
+
+    if (pObject->Event_State != EVENT_STATE_NORMAL) {
+        flags |= COLUMNS_FLAG_IN_ALARM;
+    }
+    if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        flags |= COLUMNS_FLAG_FAULT;
+    }
+    if (pObject->Out_Of_Service) {
+        flags |= COLUMNS_FLAG_OUT_OF_SERVICE;
+    }
+    if (pObject->Changed) {
+        flags |= COLUMNS_FLAG_CHANGED;
+    }
+
+    columns_set(
+        &Object_Columns, pObject->Column_Row, pObject->Present_Value, flags);
+    columns_cov_set(
+        &Object_Columns, pObject->Column_Row, pObject->Prior_Value,
+        pObject->COV_Increment);
+}
+
+/**
+ * @brief Add a row to the columns for a new object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @return true if the row was added
+ */
+static bool Analog_Input_Columns_Add(
+    uint32_t object_instance, struct analog_input_descr *pObject)
+{
+    int row;
+
+    row = columns_add(&Object_Columns, object_instance);
+    if (row < 0) {
+        return false;
+    }
+    pObject->Column_Row = (unsigned)row;
+    columns_data_set(&Object_Columns, pObject->Column_Row, pObject);
+    Analog_Input_Columns_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Remove the row of a deleted object from the columns
+ * @param pObject - object data
+ */
+static void Analog_Input_Columns_Remove(struct analog_input_descr *pObject)
+{
+    struct analog_input_descr *pMoved;
+    uint32_t object_instance;
+
+    /* the last row was moved into the removed row */
+    object_instance = columns_remove(&Object_Columns, pObject->Column_Row);
+    pMoved = Analog_Input_Object(object_instance);
+    if (pMoved) {
+        pMoved->Column_Row = pObject->Column_Row;
+    }
+}
+
+/**
+ * @brief Get the Present_Value, status flags and COV flag of all of the
+ *  Analog Input objects in columns, to scan all of the objects at once
+ * @return the columns, with one row for each object
+ */
+const COLUMNS_STORE *Analog_Input_Columns(void)
+{
+    return &Object_Columns;
+}
+
+/**
+ * @brief Set the Present_Value of the objects of consecutive rows of the
+ *  columns at once, such as the samples of an I/O scan, and detect their
+ *  changes of value against their COV_Increment together. The objects
+ *  that changed are put into the COV change queue.
+ * @param row - row of the columns of the object of the first value
+ * @param value - Present_Value of each object, from the first row
+ * @param count - number of values
+ * @param changed - bitmap of COLUMNS_BITMAP_WORDS(count) words, where
+ *  bit (i % 32) of word (i / 32) is set if the object of value[i] changed
+ * @return number of objects that changed
+ */
+unsigned Analog_Input_Present_Value_Rows_Set(
+    unsigned row, const float *value, unsigned count, uint32_t *changed)
+{
+    struct analog_input_descr *pObject;
+    uint32_t object_instance;
+    unsigned changes;
+    unsigned i;
+
+    changes =
+        columns_cov_update(&Object_Columns, row, value, count, changed);
+    if (!value || !changed || (row >= Object_Columns.count)) {
+        return 0;
+    }
+    if (count > (Object_Columns.count - row)) {
+        count = Object_Columns.count - row;
+    }
+    for (i = 0; i < count; i++) {
+        pObject = Object_Columns.data[row + i];
+        object_instance = Object_Columns.instance[row + i];
+        if (islessgreater(pObject->Present_Value, value[i])) {
+            pObject->Present_Value = value[i];
+            Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
+        }
+        if (changed[i / 32] & (1UL << (i % 32))) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
+            pObject->Changed = true;
+            pObject->Prior_Value = value[i];
+        }
+    }
+
+    return changes;
+}
+#else
+#define Analog_Input_Columns_Update(pObject) ((void)0)
+#define Analog_Input_Columns_Add(object_instance, pObject) (true)
+#define Analog_Input_Columns_Remove(pObject) ((void)0)
+#endif
+
 /**
  * This function is used to detect a value change,
  * using the new value compared against the prior
@@ -177,11 +337,12 @@ float Analog_Input_Present_Value(uint32_t object_instance)
  *
  * This method will update the COV-changed attribute.
  *
- * @param index  Object index
+ * @param object_instance  Object instance number
+ * @param pObject  Object data
  * @param value  Given present value.
  */
-static void
-Analog_Input_COV_Detect(struct analog_input_descr *pObject, float value)
+static void Analog_Input_COV_Detect(
+    uint32_t object_instance, struct analog_input_descr *pObject, float value)
 {
     float prior_value = 0.0f;
     float cov_increment = 0.0f;
@@ -196,6 +357,9 @@ Analog_Input_COV_Detect(struct analog_input_descr *pObject, float value)
             cov_delta = value - prior_value;
         }
         if (cov_delta >= cov_increment) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
             pObject->Prior_Value = value;
         }
@@ -215,8 +379,10 @@ void Analog_Input_Present_Value_Set(uint32_t object_instance, float value)
 
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
-        Analog_Input_COV_Detect(pObject, value);
+        Analog_Input_COV_Detect(object_instance, pObject, value);
         pObject->Present_Value = value;
+        Analog_Input_Columns_Update(pObject);
+        Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
     }
 }
 
@@ -370,6 +536,7 @@ bool Analog_Input_Reliability_Set(
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
         pObject->Reliability = value;
+        Analog_Input_Columns_Update(pObject);
         status = true;
     }
 
@@ -405,6 +572,7 @@ void Analog_Input_Change_Of_Value_Clear(uint32_t object_instance)
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
         pObject->Changed = false;
+        Analog_Input_Columns_Update(pObject);
     }
 }
 
@@ -475,7 +643,9 @@ void Analog_Input_COV_Increment_Set(uint32_t object_instance, float value)
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
         pObject->COV_Increment = value;
-        Analog_Input_COV_Detect(pObject, pObject->Present_Value);
+        Analog_Input_COV_Detect(
+            object_instance, pObject, pObject->Present_Value);
+        Analog_Input_Columns_Update(pObject);
     }
 }
 
@@ -554,9 +724,14 @@ void Analog_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
     pObject = Analog_Input_Object(object_instance);
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
         }
         pObject->Out_Of_Service = value;
+        Analog_Input_Columns_Update(pObject);
+        Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
     }
 }
 
@@ -610,6 +785,24 @@ static int Analog_Input_Event_Time_Stamps_Encode(
 }
 #endif
 
+/**
+ * @brief Get the Status_Flags of an Analog Input object
+ * @param pObject - object instance data
+ * @param bit_string - the Status_Flags
+ */
+static void Analog_Input_Object_Status_Flags(
+    const struct analog_input_descr *pObject, BACNET_BIT_STRING *bit_string)
+{
+    bitstring_init(bit_string);
+    bitstring_set_bit(bit_string, STATUS_FLAG_IN_ALARM,
+        (pObject->Event_State != EVENT_STATE_NORMAL));
+    bitstring_set_bit(bit_string, STATUS_FLAG_FAULT,
+        (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED));
+    bitstring_set_bit(bit_string, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(
+        bit_string, STATUS_FLAG_OUT_OF_SERVICE, pObject->Out_Of_Service);
+}
+
 /**
  * @brief For a given object instance-number, handles the ReadProperty service
  * @param  rpdata Property requested, see for BACNET_READ_PROPERTY_DATA details.
@@ -657,17 +850,7 @@ int Analog_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_real(&apdu[0], real_value);
             break;
         case PROP_STATUS_FLAGS:
-            bitstring_init(&bit_string);
-            bitstring_set_bit(
-                &bit_string, STATUS_FLAG_IN_ALARM,
-                pObject->Event_State != EVENT_STATE_NORMAL);
-            bitstring_set_bit(
-                &bit_string, STATUS_FLAG_FAULT,
-                pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
-            bitstring_set_bit(
-                &bit_string, STATUS_FLAG_OUT_OF_SERVICE,
-                pObject->Out_Of_Service);
+            Analog_Input_Object_Status_Flags(pObject, &bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_EVENT_STATE:
@@ -971,10 +1154,95 @@ bool Analog_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             }
             break;
     }
+    if (status) {
+        /* limits, delays, and enables are evaluated in the next pass */
+        Device_Intrinsic_Reporting_Request(
+            Object_Type, wp_data->object_instance);
+    }
 
     return status;
 }
 
+/**
+ * @brief Get the value of a property of an Analog Input object without
+ *  encoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @return true if the value was copied, or false if the property is
+ *  read with ReadProperty instead
+ */
+bool Analog_Input_Property_Value(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    struct analog_input_descr *pObject;
+    bool status = true;
+
+    if (!value || (array_index != BACNET_ARRAY_ALL) ||
+        !(pObject = Analog_Input_Object(object_instance))) {
+        return false;
+    }
+    value->context_specific = false;
+    value->next = NULL;
+    switch (object_property) {
+        case PROP_PRESENT_VALUE:
+            value->tag = BACNET_APPLICATION_TAG_REAL;
+            value->type.Real = Analog_Input_Present_Value(object_instance);
+            break;
+        case PROP_STATUS_FLAGS:
+            value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+            Analog_Input_Object_Status_Flags(pObject, &value->type.Bit_String);
+            break;
+        case PROP_OUT_OF_SERVICE:
+            value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+            value->type.Boolean = pObject->Out_Of_Service;
+            break;
+        default:
+            status = false;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set the value of a property of an Analog Input object without
+ *  decoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @param priority - BACnet priority 1..16
+ * @return true if the value was set, or false if the property is
+ *  written with WriteProperty instead, which gives the error
+ */
+bool Analog_Input_Property_Value_Set(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    struct analog_input_descr *pObject;
+
+    if (!value || (object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL) ||
+        (value->tag != BACNET_APPLICATION_TAG_REAL)) {
+        return false;
+    }
+    (void)priority;
+    pObject = Analog_Input_Object(object_instance);
+    /* the Present_Value is writable while Out_Of_Service */
+    if (!pObject || !pObject->Out_Of_Service) {
+        return false;
+    }
+    Analog_Input_Present_Value_Set(object_instance, value->type.Real);
+
+    return true;
+}
+
 /**
  * @brief Handles the Intrinsic Reporting Service for the Analog Input Object
  * @param  object_instance - object-instance number of the object
@@ -1108,7 +1376,12 @@ void Analog_Input_Intrinsic_Reporting(uint32_t object_instance)
                 return; /* shouldn't happen */
         } /* switch (FromState) */
         ToState = CurrentAI->Event_State;
+        if (CurrentAI->Remaining_Time_Delay != CurrentAI->Time_Delay) {
+            /* a time delay is counting, once each pass */
+            Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
+        }
         if (FromState != ToState) {
+            Analog_Input_Columns_Update(CurrentAI);
             /* Event_State has changed.
                Need to fill only the basic parameters of this type of event.
                Other parameters will be filled in common function. */
@@ -1289,6 +1562,7 @@ void Analog_Input_Intrinsic_Reporting(uint32_t object_instance)
             }
         }
     }
+    Analog_Input_Alarm_Active_Update(object_instance, CurrentAI);
 #else
     (void)object_instance;
 #endif /* defined(INTRINSIC_REPORTING) */
@@ -1480,6 +1754,10 @@ int Analog_Input_Alarm_Ack(
     /* Need to send AckNotification. */
     CurrentAI->Ack_notify_data.bSendAckNotify = true;
     CurrentAI->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
+    Analog_Input_Alarm_Active_Update(
+        alarmack_data->eventObjectIdentifier.instance, CurrentAI);
+    Device_Intrinsic_Reporting_Request(
+        Object_Type, alarmack_data->eventObjectIdentifier.instance);
 
     return 1;
 }
@@ -1555,7 +1833,7 @@ uint32_t Analog_Input_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct analog_input_descr));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Description = NULL;
@@ -1580,9 +1858,15 @@ uint32_t Analog_Input_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
+                return BACNET_MAX_INSTANCE;
+            }
+            if (!Analog_Input_Columns_Add(object_instance, pObject)) {
+                Keylist_Data_Delete(Object_List, object_instance);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
+            Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
         } else {
             return BACNET_MAX_INSTANCE;
         }
@@ -1591,6 +1875,30 @@ uint32_t Analog_Input_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Analog Input objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Analog_Input_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Analog_Input_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * @brief Deletes an Analog Input object
  * @param object_instance - object-instance number of the object
@@ -1603,7 +1911,11 @@ bool Analog_Input_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Analog_Input_Columns_Remove(pObject);
+#if defined(INTRINSIC_REPORTING)
+        (void)Alarm_Active_Set(Object_Type, object_instance, false);
+#endif
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1621,10 +1933,17 @@ void Analog_Input_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
+#if defined(INTRINSIC_REPORTING)
+        Alarm_Active_Clear(Object_Type);
+#endif
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_cleanup(&Object_Columns);
+#endif
         Object_List = NULL;
     }
 }
@@ -1636,6 +1955,10 @@ void Analog_Input_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct analog_input_descr), 0);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_init(&Object_Columns);
+#endif
     }
 #if defined(INTRINSIC_REPORTING)
     /* Set handler for GetEventInformation function */
@@ -1645,5 +1968,8 @@ void Analog_Input_Init(void)
     handler_alarm_ack_set(Object_Type, Analog_Input_Alarm_Ack);
     /* Set handler for GetAlarmSummary Service */
     handler_get_alarm_summary_set(Object_Type, Analog_Input_Alarm_Summary);
+    /* GetEventInformation and GetAlarmSummary visit only the objects
+       with an active alarm */
+    Alarm_Active_Index_Set(Object_Type, Analog_Input_Instance_To_Index);
 #endif
 }
@@ -16,6 +16,7 @@
 /* BACnet Stack API */
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
+#include "bacnet/basic/sys/columns.h"
 #if defined(INTRINSIC_REPORTING)
 #include "bacnet/basic/object/nc.h"
 #include "bacnet/getevent.h"
@@ -34,6 +35,9 @@ typedef struct analog_input_descr {
     bool Changed;
     char* Object_Name;
     char* Description;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    unsigned Column_Row;
+#endif
 #if defined(INTRINSIC_REPORTING)
     uint32_t Time_Delay;
     uint32_t Notification_Class;
@@ -109,6 +113,19 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool Analog_Input_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
+    BACNET_STACK_EXPORT
+    bool Analog_Input_Property_Value(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    bool Analog_Input_Property_Value_Set(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        const BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority);
 
     BACNET_STACK_EXPORT
     float Analog_Input_Present_Value(
@@ -126,6 +143,14 @@ extern "C" {
         uint32_t object_instance,
         bool oos_flag);
 
+    BACNET_STACK_EXPORT
+    BACNET_RELIABILITY Analog_Input_Reliability(
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
+    bool Analog_Input_Reliability_Set(
+        uint32_t object_instance,
+        BACNET_RELIABILITY value);
+
     BACNET_STACK_EXPORT
     unsigned Analog_Input_Event_State(uint32_t object_instance);
     BACNET_STACK_EXPORT
@@ -175,6 +200,15 @@ extern "C" {
     uint32_t Analog_Input_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Analog_Input_Create_Bulk(uint32_t object_instance, unsigned count);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    BACNET_STACK_EXPORT
+    const COLUMNS_STORE *Analog_Input_Columns(void);
+    BACNET_STACK_EXPORT
+    unsigned Analog_Input_Present_Value_Rows_Set(
+        unsigned row, const float *value, unsigned count, uint32_t *changed);
+#endif
+    BACNET_STACK_EXPORT
     bool Analog_Input_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
@@ -28,6 +28,8 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/columns.h"
 /* me! */
 #include "ao.h"
 
@@ -39,6 +41,8 @@ struct object_data {
     float Prior_Value;
     bool Relinquished[BACNET_MAX_PRIORITY];
     float Priority_Array[BACNET_MAX_PRIORITY];
+    /* highest active priority 1..16, or 0 if all are relinquished */
+    uint8_t Active_Priority;
     float Relinquish_Default;
     float Min_Pres_Value;
     float Max_Pres_Value;
@@ -46,9 +50,18 @@ struct object_data {
     uint8_t Reliability;
     const char *Object_Name;
     const char *Description;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    unsigned Column_Row;
+#endif
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/* the values of the objects, in columns */
+static COLUMNS_STORE Object_Columns;
+#endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_ANALOG_OUTPUT;
 /* callback for present value writes */
@@ -151,6 +164,35 @@ unsigned Analog_Output_Instance_To_Index(uint32_t object_instance)
     return Keylist_Index(Object_List, object_instance);
 }
 
+/**
+ * @brief Update the active priority of an object after a priority-array
+ *  slot was commanded or relinquished, so that the present-value is
+ *  found without a search of the priority-array
+ * @param  pObject - specific object with valid data
+ * @param  priority - priority-array index value 1..16 that changed
+ */
+static void Analog_Output_Active_Priority_Update(
+    struct object_data *pObject, unsigned priority)
+{
+    unsigned p;
+
+    if (!pObject->Relinquished[priority - 1]) {
+        if ((pObject->Active_Priority == 0) ||
+            (priority < pObject->Active_Priority)) {
+            pObject->Active_Priority = priority;
+        }
+    } else if (priority == pObject->Active_Priority) {
+        /* the active priority was relinquished: find the next one */
+        pObject->Active_Priority = 0;
+        for (p = priority; p < BACNET_MAX_PRIORITY; p++) {
+            if (!pObject->Relinquished[p]) {
+                pObject->Active_Priority = p + 1;
+                break;
+            }
+        }
+    }
+}
+
 /**
  * @brief For a given object instance-number, determines the present-value
  * @param  object_instance - object-instance number of the object
@@ -159,23 +201,102 @@ unsigned Analog_Output_Instance_To_Index(uint32_t object_instance)
 float Analog_Output_Present_Value(uint32_t object_instance)
 {
     float value = 0.0;
-    uint8_t priority = 0; /* loop counter */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        value = Analog_Output_Relinquish_Default(object_instance);
-        for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-            if (!pObject->Relinquished[priority]) {
-                value = pObject->Priority_Array[priority];
-                break;
-            }
+        if (pObject->Active_Priority) {
+            value = pObject->Priority_Array[pObject->Active_Priority - 1];
+        } else {
+            value = pObject->Relinquish_Default;
         }
     }
 
     return value;
 }
 
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/**
+ * @brief Copy the Present_Value, status flags and COV flag of an object
+ *  into its row of the columns
+ * @param pObject - object data
+ */
+static void Analog_Output_Columns_Update(struct object_data *pObject)
+{
+    float value;
+    uint8_t flags = 0;
+
+    value = Analog_Output_Present_Value(
+        Object_Columns.instance[pObject->Column_Row]);
+    if (pObject->Overridden) {
+        flags |= COLUMNS_FLAG_OVERRIDDEN;
+    }
+    if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        flags |= COLUMNS_FLAG_FAULT;
+    }
+    if (pObject->Out_Of_Service) {
+        flags |= COLUMNS_FLAG_OUT_OF_SERVICE;
+    }
+    if (pObject->Changed) {
+        flags |= COLUMNS_FLAG_CHANGED;
+    }
+
+    columns_set(&Object_Columns, pObject->Column_Row, value, flags);
+}
+
+/**
+ * @brief Add a row to the columns for a new object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @return true if the row was added
+ */
+static bool Analog_Output_Columns_Add(
+    uint32_t object_instance, struct object_data *pObject)
+{
+    int row;
+
+    row = columns_add(&Object_Columns, object_instance);
+    if (row < 0) {
+        return false;
+    }
+    pObject->Column_Row = (unsigned)row;
+    Analog_Output_Columns_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Remove the row of a deleted object from the columns
+ * @param pObject - object data
+ */
+static void Analog_Output_Columns_Remove(struct object_data *pObject)
+{
+    struct object_data *pMoved;
+    uint32_t object_instance;
+
+    /* the last row was moved into the removed row */
+    object_instance = columns_remove(&Object_Columns, pObject->Column_Row);
+    pMoved = Keylist_Data(Object_List, object_instance);
+    if (pMoved) {
+        pMoved->Column_Row = pObject->Column_Row;
+    }
+}
+
+/**
+ * @brief Get the Present_Value, status flags and COV flag of all of the
+ *  Analog Output objects in columns, to scan all of the objects at once
+ * @return the columns, with one row for each object
+ */
+const COLUMNS_STORE *Analog_Output_Columns(void)
+{
+    return &Object_Columns;
+}
+#else
+#define Analog_Output_Columns_Update(pObject) ((void)0)
+#define Analog_Output_Columns_Add(object_instance, pObject) (true)
+#define Analog_Output_Columns_Remove(pObject) ((void)0)
+#endif
+
 /**
  * @brief For a given object instance-number, determines the priority
  * @param  object_instance - object-instance number of the object
@@ -183,18 +304,12 @@ float Analog_Output_Present_Value(uint32_t object_instance)
  */
 unsigned Analog_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (!pObject->Relinquished[p]) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = pObject->Active_Priority;
     }
 
     return priority;
@@ -266,6 +381,7 @@ bool Analog_Output_Relinquish_Default_Set(uint32_t object_instance, float value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Relinquish_Default = value;
+        Analog_Output_Columns_Update(pObject);
         status = true;
     }
 
@@ -275,11 +391,12 @@ bool Analog_Output_Relinquish_Default_Set(uint32_t object_instance, float value)
 /**
  * For a given object instance-number, checks the present-value for COV
  *
+ * @param  object_instance - object-instance number of the object
  * @param  pObject - specific object with valid data
  * @param  value - floating point analog value
  */
 static void Analog_Output_Present_Value_COV_Detect(
-    struct object_data *pObject, float value)
+    uint32_t object_instance, struct object_data *pObject, float value)
 {
     float prior_value = 0.0;
     float cov_increment = 0.0;
@@ -294,6 +411,9 @@ static void Analog_Output_Present_Value_COV_Detect(
             cov_delta = value - prior_value;
         }
         if (cov_delta >= cov_increment) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
             pObject->Prior_Value = value;
         }
@@ -320,8 +440,10 @@ bool Analog_Output_Present_Value_Set(
                 value >= pObject->Min_Pres_Value && value <= pObject->Max_Pres_Value) {
             pObject->Relinquished[priority - 1] = false;
             pObject->Priority_Array[priority - 1] = value;
-            Analog_Output_Present_Value_COV_Detect(
-                pObject, Analog_Output_Present_Value(object_instance));
+            Analog_Output_Active_Priority_Update(pObject, priority);
+            Analog_Output_Present_Value_COV_Detect(object_instance, pObject,
+                Analog_Output_Present_Value(object_instance));
+            Analog_Output_Columns_Update(pObject);
             status = true;
         }
     }
@@ -346,8 +468,10 @@ bool Analog_Output_Present_Value_Relinquish(
         if ((priority >= 1) && (priority <= BACNET_MAX_PRIORITY)) {
             pObject->Relinquished[priority - 1] = true;
             pObject->Priority_Array[priority - 1] = 0.0;
-            Analog_Output_Present_Value_COV_Detect(
-                pObject, Analog_Output_Present_Value(object_instance));
+            Analog_Output_Active_Priority_Update(pObject, priority);
+            Analog_Output_Present_Value_COV_Detect(object_instance, pObject,
+                Analog_Output_Present_Value(object_instance));
+            Analog_Output_Columns_Update(pObject);
             status = true;
         }
     }
@@ -599,7 +723,11 @@ void Analog_Output_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
+            Analog_Output_Columns_Update(pObject);
         }
     }
 }
@@ -637,7 +765,11 @@ void Analog_Output_Overridden_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Overridden != value) {
             pObject->Overridden = value;
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
+            Analog_Output_Columns_Update(pObject);
         }
     }
 }
@@ -697,8 +829,12 @@ bool Analog_Output_Reliability_Set(
             fault = Analog_Output_Object_Fault(pObject);
             pObject->Reliability = value;
             if (fault != Analog_Output_Object_Fault(pObject)) {
+                if (!pObject->Changed) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Changed = true;
             }
+            Analog_Output_Columns_Update(pObject);
             status = true;
         }
     }
@@ -864,6 +1000,7 @@ void Analog_Output_Change_Of_Value_Clear(uint32_t object_instance)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Changed = false;
+        Analog_Output_Columns_Update(pObject);
     }
 }
 
@@ -928,6 +1065,24 @@ void Analog_Output_COV_Increment_Set(uint32_t object_instance, float value)
     }
 }
 
+/**
+ * @brief Get the Status_Flags of an Analog Output object
+ * @param object_instance - object-instance number of the object
+ * @param bit_string - the Status_Flags
+ */
+static void Analog_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *bit_string)
+{
+    bitstring_init(bit_string);
+    bitstring_set_bit(bit_string, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(
+        bit_string, STATUS_FLAG_FAULT, Analog_Output_Fault(object_instance));
+    bitstring_set_bit(bit_string, STATUS_FLAG_OVERRIDDEN,
+        Analog_Output_Overridden(object_instance));
+    bitstring_set_bit(bit_string, STATUS_FLAG_OUT_OF_SERVICE,
+        Analog_Output_Out_Of_Service(object_instance));
+}
+
 /**
  * @brief ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -981,14 +1136,7 @@ int Analog_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_real(&apdu[0], real_value);
             break;
         case PROP_STATUS_FLAGS:
-            bitstring_init(&bit_string);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
-            state = Analog_Output_Fault(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, state);
-            state = Analog_Output_Overridden(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, state);
-            state = Analog_Output_Out_Of_Service(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, state);
+            Analog_Output_Status_Flags(rpdata->object_instance, &bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_RELIABILITY:
@@ -1148,6 +1296,87 @@ bool Analog_Output_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
+/**
+ * @brief Get the value of a property of an Analog Output object without
+ *  encoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @return true if the value was copied, or false if the property is
+ *  read with ReadProperty instead
+ */
+bool Analog_Output_Property_Value(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    bool status = true;
+
+    if (!value || (array_index != BACNET_ARRAY_ALL) ||
+        !Analog_Output_Valid_Instance(object_instance)) {
+        return false;
+    }
+    value->context_specific = false;
+    value->next = NULL;
+    switch (object_property) {
+        case PROP_PRESENT_VALUE:
+            value->tag = BACNET_APPLICATION_TAG_REAL;
+            value->type.Real = Analog_Output_Present_Value(object_instance);
+            break;
+        case PROP_STATUS_FLAGS:
+            value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+            Analog_Output_Status_Flags(
+                object_instance, &value->type.Bit_String);
+            break;
+        case PROP_OUT_OF_SERVICE:
+            value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+            value->type.Boolean = Analog_Output_Out_Of_Service(object_instance);
+            break;
+        default:
+            status = false;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set the value of a property of an Analog Output object without
+ *  decoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @param priority - BACnet priority 1..16
+ * @return true if the value was set, or false if the property is
+ *  written with WriteProperty instead, which gives the error
+ */
+bool Analog_Output_Property_Value_Set(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_PROPERTY;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+
+    if (!value || (object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL)) {
+        return false;
+    }
+    if (value->tag == BACNET_APPLICATION_TAG_REAL) {
+        return Analog_Output_Present_Value_Write(object_instance,
+            value->type.Real, priority, &error_class, &error_code);
+    }
+    if (value->tag == BACNET_APPLICATION_TAG_NULL) {
+        return Analog_Output_Present_Value_Relinquish_Write(
+            object_instance, priority, &error_class, &error_code);
+    }
+
+    return false;
+}
+
 /**
  * @brief Sets a callback used when present-value is written from BACnet
  * @param cb - callback used to provide indications
@@ -1181,7 +1410,7 @@ uint32_t Analog_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
@@ -1190,6 +1419,7 @@ uint32_t Analog_Output_Create(uint32_t object_instance)
                 pObject->Relinquished[priority] = true;
                 pObject->Priority_Array[priority] = 0.0;
             }
+            pObject->Active_Priority = 0;
             pObject->Relinquish_Default = 0.0;
             pObject->COV_Increment = 1.0;
             pObject->Prior_Value = 0.0;
@@ -1201,7 +1431,12 @@ uint32_t Analog_Output_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
+                return BACNET_MAX_INSTANCE;
+            }
+            if (!Analog_Output_Columns_Add(object_instance, pObject)) {
+                Keylist_Data_Delete(Object_List, object_instance);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1212,6 +1447,30 @@ uint32_t Analog_Output_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Analog Output objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Analog_Output_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Analog_Output_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * @brief Deletes an Analog Output object
  * @param object_instance - object-instance number of the object
@@ -1224,7 +1483,8 @@ bool Analog_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Analog_Output_Columns_Remove(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1242,10 +1502,14 @@ void Analog_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_cleanup(&Object_Columns);
+#endif
         Object_List = NULL;
     }
 }
@@ -1257,5 +1521,9 @@ void Analog_Output_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_init(&Object_Columns);
+#endif
     }
 }
@@ -8,6 +8,7 @@
  * @date 2006, 2011
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -23,13 +24,23 @@
 #include "bacnet/proplist.h"
 #include "bacnet/timestamp.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/service/alarm_active.h"
+#include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/columns.h"
 #include "bacnet/basic/sys/debug.h"
 /* me! */
 #include "bacnet/basic/object/av.h"
 
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/* the values of the objects, in columns */
+static COLUMNS_STORE Object_Columns;
+#endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_ANALOG_VALUE;
 
@@ -100,6 +111,24 @@ static struct analog_value_descr *Analog_Value_Object_Index(int index)
 {
     return Keylist_Data_Index(Object_List, index);
 }
+
+/**
+ * @brief Update the entry of an object in the device set of the objects
+ *  with an active alarm, after its Event_State or Acked_Transitions change
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ */
+static void Analog_Value_Alarm_Active_Update(
+    uint32_t object_instance, struct analog_value_descr *pObject)
+{
+    bool active;
+
+    active = (pObject->Event_State != EVENT_STATE_NORMAL) ||
+        !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked;
+    (void)Alarm_Active_Set(Object_Type, object_instance, active);
+}
 #endif
 
 /**
@@ -173,6 +202,137 @@ float Analog_Value_Present_Value(uint32_t object_instance)
     return value;
 }
 
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/**
+ * @brief Copy the Present_Value, status flags and COV flag of an object
+ *  into its row of the columns
+ * @param pObject - object data
+ */
+static void Analog_Value_Columns_Update(struct analog_value_descr *pObject)
+{
+    uint8_t flags = 0;
+
+    if (pObject->Event_State != EVENT_STATE_NORMAL) {
+        flags |= COLUMNS_FLAG_IN_ALARM;
+    }
+    if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        flags |= COLUMNS_FLAG_FAULT;
+    }
+    if (pObject->Out_Of_Service) {
+        flags |= COLUMNS_FLAG_OUT_OF_SERVICE;
+    }
+    if (pObject->Changed) {
+        flags |= COLUMNS_FLAG_CHANGED;
+    }
+
+    columns_set(
+        &Object_Columns, pObject->Column_Row, pObject->Present_Value, flags);
+    columns_cov_set(
+        &Object_Columns, pObject->Column_Row, pObject->Prior_Value,
+        pObject->COV_Increment);
+}
+
+/**
+ * @brief Add a row to the columns for a new object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @return true if the row was added
+ */
+static bool Analog_Value_Columns_Add(
+    uint32_t object_instance, struct analog_value_descr *pObject)
+{
+    int row;
+
+    row = columns_add(&Object_Columns, object_instance);
+    if (row < 0) {
+        return false;
+    }
+    pObject->Column_Row = (unsigned)row;
+    columns_data_set(&Object_Columns, pObject->Column_Row, pObject);
+    Analog_Value_Columns_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Remove the row of a deleted object from the columns
+ * @param pObject - object data
+ */
+static void Analog_Value_Columns_Remove(struct analog_value_descr *pObject)
+{
+    struct analog_value_descr *pMoved;
+    uint32_t object_instance;
+
+    /* the last row was moved into the removed row */
+    object_instance = columns_remove(&Object_Columns, pObject->Column_Row);
+    pMoved = Analog_Value_Object(object_instance);
+    if (pMoved) {
+        pMoved->Column_Row = pObject->Column_Row;
+    }
+}
+
+/**
+ * @brief Get the Present_Value, status flags and COV flag of all of the
+ *  Analog Value objects in columns, to scan all of the objects at once
+ * @return the columns, with one row for each object
+ */
+const COLUMNS_STORE *Analog_Value_Columns(void)
+{
+    return &Object_Columns;
+}
+
+/**
+ * @brief Set the Present_Value of the objects of consecutive rows of the
+ *  columns at once, such as the samples of an I/O scan, and detect their
+ *  changes of value against their COV_Increment together. The objects
+ *  that changed are put into the COV change queue.
+ * @param row - row of the columns of the object of the first value
+ * @param value - Present_Value of each object, from the first row
+ * @param count - number of values
+ * @param changed - bitmap of COLUMNS_BITMAP_WORDS(count) words, where
+ *  bit (i % 32) of word (i / 32) is set if the object of value[i] changed
+ * @return number of objects that changed
+ */
+unsigned Analog_Value_Present_Value_Rows_Set(
+    unsigned row, const float *value, unsigned count, uint32_t *changed)
+{
+    struct analog_value_descr *pObject;
+    uint32_t object_instance;
+    unsigned changes;
+    unsigned i;
+
+    changes =
+        columns_cov_update(&Object_Columns, row, value, count, changed);
+    if (!value || !changed || (row >= Object_Columns.count)) {
+        return 0;
+    }
+    if (count > (Object_Columns.count - row)) {
+        count = Object_Columns.count - row;
+    }
+    for (i = 0; i < count; i++) {
+        pObject = Object_Columns.data[row + i];
+        object_instance = Object_Columns.instance[row + i];
+        if (islessgreater(pObject->Present_Value, value[i])) {
+            pObject->Present_Value = value[i];
+            Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
+        }
+        if (changed[i / 32] & (1UL << (i % 32))) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
+            pObject->Changed = true;
+            pObject->Prior_Value = value[i];
+        }
+    }
+
+    return changes;
+}
+#else
+#define Analog_Value_Columns_Update(pObject) ((void)0)
+#define Analog_Value_Columns_Add(object_instance, pObject) (true)
+#define Analog_Value_Columns_Remove(pObject) ((void)0)
+#endif
+
 /**
  * This function is used to detect a value change,
  * using the new value compared against the prior
@@ -180,11 +340,12 @@ float Analog_Value_Present_Value(uint32_t object_instance)
  *
  * This method will update the COV-changed attribute.
  *
- * @param index  Object index
+ * @param object_instance  Object instance number
+ * @param pObject  Object data
  * @param value  Given present value.
  */
-static void
-Analog_Value_COV_Detect(struct analog_value_descr *pObject, float value)
+static void Analog_Value_COV_Detect(
+    uint32_t object_instance, struct analog_value_descr *pObject, float value)
 {
     float prior_value = 0.0f;
     float cov_increment = 0.0f;
@@ -199,6 +360,9 @@ Analog_Value_COV_Detect(struct analog_value_descr *pObject, float value)
             cov_delta = value - prior_value;
         }
         if (cov_delta >= cov_increment) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
             pObject->Prior_Value = value;
         }
@@ -224,8 +388,10 @@ bool Analog_Value_Present_Value_Set(
     (void)priority;
     pObject = Analog_Value_Object(object_instance);
     if (pObject) {
-        Analog_Value_COV_Detect(pObject, value);
+        Analog_Value_COV_Detect(object_instance, pObject, value);
         pObject->Present_Value = value;
+        Analog_Value_Columns_Update(pObject);
+        Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
         status = true;
     }
 
@@ -378,6 +544,7 @@ bool Analog_Value_Reliability_Set(
     pObject = Analog_Value_Object(object_instance);
     if (pObject) {
         pObject->Reliability = value;
+        Analog_Value_Columns_Update(pObject);
         status = true;
     }
 
@@ -413,6 +580,7 @@ void Analog_Value_Change_Of_Value_Clear(uint32_t object_instance)
     pObject = Analog_Value_Object(object_instance);
     if (pObject) {
         pObject->Changed = false;
+        Analog_Value_Columns_Update(pObject);
     }
 }
 
@@ -483,7 +651,9 @@ void Analog_Value_COV_Increment_Set(uint32_t object_instance, float value)
     pObject = Analog_Value_Object(object_instance);
     if (pObject) {
         pObject->COV_Increment = value;
-        Analog_Value_COV_Detect(pObject, pObject->Present_Value);
+        Analog_Value_COV_Detect(
+            object_instance, pObject, pObject->Present_Value);
+        Analog_Value_Columns_Update(pObject);
     }
 }
 
@@ -562,9 +732,14 @@ void Analog_Value_Out_Of_Service_Set(uint32_t object_instance, bool value)
     pObject = Analog_Value_Object(object_instance);
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
         }
         pObject->Out_Of_Service = value;
+        Analog_Value_Columns_Update(pObject);
+        Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
     }
 }
 
@@ -618,6 +793,24 @@ static int Analog_Value_Event_Time_Stamps_Encode(
 }
 #endif
 
+/**
+ * @brief Get the Status_Flags of an Analog Value object
+ * @param pObject - object instance data
+ * @param bit_string - the Status_Flags
+ */
+static void Analog_Value_Object_Status_Flags(
+    const struct analog_value_descr *pObject, BACNET_BIT_STRING *bit_string)
+{
+    bitstring_init(bit_string);
+    bitstring_set_bit(bit_string, STATUS_FLAG_IN_ALARM,
+        (pObject->Event_State != EVENT_STATE_NORMAL));
+    bitstring_set_bit(bit_string, STATUS_FLAG_FAULT,
+        (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED));
+    bitstring_set_bit(bit_string, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(
+        bit_string, STATUS_FLAG_OUT_OF_SERVICE, pObject->Out_Of_Service);
+}
+
 /**
  * @brief For a given object instance-number, handles the ReadProperty service
  * @param rpdata  Property requested, see for BACNET_READ_PROPERTY_DATA details.
@@ -673,17 +866,7 @@ int Analog_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_real(&apdu[0], real_value);
             break;
         case PROP_STATUS_FLAGS:
-            bitstring_init(&bit_string);
-            bitstring_set_bit(
-                &bit_string, STATUS_FLAG_IN_ALARM,
-                (CurrentAV->Event_State != EVENT_STATE_NORMAL));
-            bitstring_set_bit(
-                &bit_string, STATUS_FLAG_FAULT,
-                (CurrentAV->Reliability != RELIABILITY_NO_FAULT_DETECTED));
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
-            bitstring_set_bit(
-                &bit_string, STATUS_FLAG_OUT_OF_SERVICE,
-                CurrentAV->Out_Of_Service);
+            Analog_Value_Object_Status_Flags(CurrentAV, &bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_EVENT_STATE:
@@ -867,6 +1050,7 @@ bool Analog_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                        object. */
                     wp_data->error_class = ERROR_CLASS_PROPERTY;
                     wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+                    status = false;
                 } else if (Analog_Value_Present_Value_Set(
                                wp_data->object_instance, value.type.Real,
                                wp_data->priority)) {
@@ -874,6 +1058,7 @@ bool Analog_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 } else {
                     wp_data->error_class = ERROR_CLASS_PROPERTY;
                     wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                    status = false;
                 }
             } else {
                 status = false;
@@ -886,6 +1071,7 @@ bool Analog_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
             if (status) {
                 CurrentAV->Out_Of_Service = value.type.Boolean;
+                Analog_Value_Columns_Update(CurrentAV);
             }
             break;
         case PROP_UNITS:
@@ -1006,10 +1192,92 @@ bool Analog_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             }
             break;
     }
+    if (status) {
+        /* limits, delays, and enables are evaluated in the next pass */
+        Device_Intrinsic_Reporting_Request(
+            Object_Type, wp_data->object_instance);
+    }
 
     return status;
 }
 
+/**
+ * @brief Get the value of a property of an Analog Value object without
+ *  encoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @return true if the value was copied, or false if the property is
+ *  read with ReadProperty instead
+ */
+bool Analog_Value_Property_Value(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    struct analog_value_descr *pObject;
+    bool status = true;
+
+    if (!value || (array_index != BACNET_ARRAY_ALL) ||
+        !(pObject = Analog_Value_Object(object_instance))) {
+        return false;
+    }
+    value->context_specific = false;
+    value->next = NULL;
+    switch (object_property) {
+        case PROP_PRESENT_VALUE:
+            value->tag = BACNET_APPLICATION_TAG_REAL;
+            value->type.Real = Analog_Value_Present_Value(object_instance);
+            break;
+        case PROP_STATUS_FLAGS:
+            value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+            Analog_Value_Object_Status_Flags(pObject, &value->type.Bit_String);
+            break;
+        case PROP_OUT_OF_SERVICE:
+            value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+            value->type.Boolean = pObject->Out_Of_Service;
+            break;
+        default:
+            status = false;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set the value of a property of an Analog Value object without
+ *  decoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @param priority - BACnet priority 1..16
+ * @return true if the value was set, or false if the property is
+ *  written with WriteProperty instead, which gives the error
+ */
+bool Analog_Value_Property_Value_Set(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    if (!value || (object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL) ||
+        (value->tag != BACNET_APPLICATION_TAG_REAL)) {
+        return false;
+    }
+    /* Command priority 6 is reserved for use by Minimum On/Off
+       algorithm and may not be used for other purposes in any object. */
+    if (priority == 6) {
+        return false;
+    }
+
+    return Analog_Value_Present_Value_Set(
+        object_instance, value->type.Real, priority);
+}
+
 /**
  * @brief Analog Value intrinsic reporting function.
  * @param object_instance [in] BACnet object-instance number of the object
@@ -1151,8 +1419,13 @@ void Analog_Value_Intrinsic_Reporting(uint32_t object_instance)
         } /* switch (FromState) */
 
         ToState = CurrentAV->Event_State;
+        if (CurrentAV->Remaining_Time_Delay != CurrentAV->Time_Delay) {
+            /* a time delay is counting, once each pass */
+            Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
+        }
 
         if (FromState != ToState) {
+            Analog_Value_Columns_Update(CurrentAV);
             /* Event_State has changed.
                Need to fill only the basic parameters of this type of event.
                Other parameters will be filled in common function. */
@@ -1341,6 +1614,7 @@ void Analog_Value_Intrinsic_Reporting(uint32_t object_instance)
             }
         }
     }
+    Analog_Value_Alarm_Active_Update(object_instance, CurrentAV);
 #else
     (void)object_instance;
 #endif /* defined(INTRINSIC_REPORTING) */
@@ -1531,6 +1805,10 @@ int Analog_Value_Alarm_Ack(
     /* Need to send AckNotification. */
     CurrentAV->Ack_notify_data.bSendAckNotify = true;
     CurrentAV->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
+    Analog_Value_Alarm_Active_Update(
+        alarmack_data->eventObjectIdentifier.instance, CurrentAV);
+    Device_Intrinsic_Reporting_Request(
+        Object_Type, alarmack_data->eventObjectIdentifier.instance);
 
     /* Return OK */
     return 1;
@@ -1606,7 +1884,7 @@ uint32_t Analog_Value_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct analog_value_descr));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Description = NULL;
@@ -1631,9 +1909,15 @@ uint32_t Analog_Value_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
+                return BACNET_MAX_INSTANCE;
+            }
+            if (!Analog_Value_Columns_Add(object_instance, pObject)) {
+                Keylist_Data_Delete(Object_List, object_instance);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
+            Device_Intrinsic_Reporting_Request(Object_Type, object_instance);
         } else {
             return BACNET_MAX_INSTANCE;
         }
@@ -1642,6 +1926,30 @@ uint32_t Analog_Value_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Analog Value objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Analog_Value_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Analog_Value_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * @brief Deletes an Analog Value object
  * @param object_instance - object-instance number of the object
@@ -1654,7 +1962,11 @@ bool Analog_Value_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Analog_Value_Columns_Remove(pObject);
+#if defined(INTRINSIC_REPORTING)
+        (void)Alarm_Active_Set(Object_Type, object_instance, false);
+#endif
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1672,10 +1984,17 @@ void Analog_Value_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
+#if defined(INTRINSIC_REPORTING)
+        Alarm_Active_Clear(Object_Type);
+#endif
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_cleanup(&Object_Columns);
+#endif
         Object_List = NULL;
     }
 }
@@ -1687,6 +2006,10 @@ void Analog_Value_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct analog_value_descr), 0);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_init(&Object_Columns);
+#endif
     }
 #if defined(INTRINSIC_REPORTING)
     /* Set handler for GetEventInformation function */
@@ -1696,5 +2019,8 @@ void Analog_Value_Init(void)
     handler_alarm_ack_set(Object_Type, Analog_Value_Alarm_Ack);
     /* Set handler for GetAlarmSummary Service */
     handler_get_alarm_summary_set(Object_Type, Analog_Value_Alarm_Summary);
+    /* GetEventInformation and GetAlarmSummary visit only the objects
+       with an active alarm */
+    Alarm_Active_Index_Set(Object_Type, Analog_Value_Instance_To_Index);
 #endif
 }
@@ -17,6 +17,7 @@
 /* BACnet Stack API */
 #include "bacnet/bacerror.h"
 #include "bacnet/wp.h"
+#include "bacnet/basic/sys/columns.h"
 #include "bacnet/rp.h"
 #if defined(INTRINSIC_REPORTING)
 #include "bacnet/basic/object/nc.h"
@@ -36,6 +37,9 @@ typedef struct analog_value_descr {
     char* Object_Name;
     char* Description;
     BACNET_RELIABILITY Reliability;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    unsigned Column_Row;
+#endif
 #if defined(INTRINSIC_REPORTING)
     uint32_t Time_Delay;
     uint32_t Notification_Class;
@@ -93,6 +97,19 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool Analog_Value_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
+    BACNET_STACK_EXPORT
+    bool Analog_Value_Property_Value(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    bool Analog_Value_Property_Value_Set(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        const BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority);
 
     BACNET_STACK_EXPORT
     bool Analog_Value_Present_Value_Set(
@@ -188,6 +205,15 @@ extern "C" {
     uint32_t Analog_Value_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Analog_Value_Create_Bulk(uint32_t object_instance, unsigned count);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    BACNET_STACK_EXPORT
+    const COLUMNS_STORE *Analog_Value_Columns(void);
+    BACNET_STACK_EXPORT
+    unsigned Analog_Value_Present_Value_Rows_Set(
+        unsigned row, const float *value, unsigned count, uint32_t *changed);
+#endif
+    BACNET_STACK_EXPORT
     bool Analog_Value_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
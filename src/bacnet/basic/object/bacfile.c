@@ -27,22 +27,53 @@
 #include "bacnet/basic/object/bacfile.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/static_pool.h"
+#include "bacnet/basic/sys/strpool.h"
 #include "bacnet/basic/tsm/tsm.h"
 
 #ifndef FILE_RECORD_SIZE
 #define FILE_RECORD_SIZE MAX_OCTET_STRING_BYTES
 #endif
+/* milliseconds that an open file is kept open after its last stream
+   access, so that a transfer of many chunks opens the file once */
+#ifndef BACFILE_IDLE_TIMEOUT
+#define BACFILE_IDLE_TIMEOUT 5000UL
+#endif
+/* 1 to read stream data from a memory map of the open file,
+   which needs the POSIX mmap() and fileno() */
+#ifndef BACFILE_MMAP
+#if !defined(_WIN32) && (defined(_POSIX_C_SOURCE) || defined(__APPLE__))
+#define BACFILE_MMAP 1
+#else
+#define BACFILE_MMAP 0
+#endif
+#endif
+#if BACFILE_MMAP
+#include <sys/mman.h>
+#endif
 struct object_data {
     char *Object_Name;
     char *Pathname;
     BACNET_DATE_TIME Modification_Date;
-    char *File_Type;
+    /* interned, since many files share a type */
+    const char *File_Type;
     bool File_Access_Stream:1;
     bool Read_Only : 1;
     bool Archive : 1;
+    /* the file kept open for reading and update, and its size */
+    FILE *File_Handle;
+    long File_Size;
+    uint32_t File_Idle_Milliseconds;
+#if BACFILE_MMAP
+    uint8_t *File_Map;
+    size_t File_Map_Size;
+#endif
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_FILE;
 /* These three arrays are used by the ReadPropertyMultiple handler */
@@ -88,13 +119,129 @@ void BACfile_Property_Lists(
  */
 static char *bacfile_strdup(const char *s) {
     size_t size = strlen(s) + 1;
-    char *p = malloc(size);
+    char *p = bacnet_malloc(size);
     if (p != NULL) {
         memcpy(p, s, size);
     }
     return p;
 }
 
+/**
+ * @brief Unmap the open file of an object, such as when its size changes
+ * @param pObject - object data
+ */
+static void bacfile_handle_unmap(struct object_data *pObject)
+{
+#if BACFILE_MMAP
+    if (pObject->File_Map) {
+        (void)munmap(pObject->File_Map, pObject->File_Map_Size);
+        pObject->File_Map = NULL;
+        pObject->File_Map_Size = 0;
+    }
+#else
+    (void)pObject;
+#endif
+}
+
+/**
+ * @brief Unmap and close the open file of an object
+ * @param pObject - object data
+ */
+static void bacfile_handle_close(struct object_data *pObject)
+{
+    bacfile_handle_unmap(pObject);
+    if (pObject->File_Handle) {
+        fclose(pObject->File_Handle);
+        pObject->File_Handle = NULL;
+    }
+    pObject->File_Size = 0;
+}
+
+/**
+ * @brief Determines the file size for a given file
+ * @param  pFile - file handle
+ * @return  file size in bytes, or 0 if not found
+ */
+static long fsize(FILE *pFile)
+{
+    long size = 0;
+    long origin = 0;
+
+    if (pFile) {
+        origin = ftell(pFile);
+        fseek(pFile, 0L, SEEK_END);
+        size = ftell(pFile);
+        fseek(pFile, origin, SEEK_SET);
+    }
+    return (size);
+}
+
+/**
+ * @brief Get the open file of an object, opening it for reading and
+ *  update when it is not open, and restart its idle timeout.
+ * @param pObject - object data
+ * @return the file handle, or NULL if the file cannot be opened
+ */
+static FILE *bacfile_handle_open(struct object_data *pObject)
+{
+    if (!pObject->File_Handle && pObject->Pathname) {
+        pObject->File_Handle = fopen(pObject->Pathname, "rb+");
+        if (!pObject->File_Handle) {
+            /* a file that we cannot write can still be read */
+            pObject->File_Handle = fopen(pObject->Pathname, "rb");
+        }
+        if (pObject->File_Handle) {
+            pObject->File_Size = fsize(pObject->File_Handle);
+            if (pObject->File_Size < 0) {
+                pObject->File_Size = 0;
+            }
+        }
+    }
+    pObject->File_Idle_Milliseconds = 0;
+
+    return pObject->File_Handle;
+}
+
+/**
+ * @brief Copy data from the open file of an object
+ * @param pObject - object data, with an open file
+ * @param position - position in the file of the first octet
+ * @param buffer - buffer for the data
+ * @param size - number of octets to copy
+ * @return number of octets copied, less than size at the end of file
+ */
+static size_t bacfile_handle_read(
+    struct object_data *pObject, long position, uint8_t *buffer, size_t size)
+{
+    size_t len = 0;
+
+    if ((position < 0) || (position >= pObject->File_Size)) {
+        return 0;
+    }
+    if (size > (size_t)(pObject->File_Size - position)) {
+        size = (size_t)(pObject->File_Size - position);
+    }
+#if BACFILE_MMAP
+    if (!pObject->File_Map) {
+        void *map = mmap(NULL, (size_t)pObject->File_Size, PROT_READ,
+            MAP_SHARED, fileno(pObject->File_Handle), 0);
+        if (map != MAP_FAILED) {
+            pObject->File_Map = map;
+            pObject->File_Map_Size = (size_t)pObject->File_Size;
+        }
+    }
+    if (pObject->File_Map) {
+        memcpy(buffer, &pObject->File_Map[position], size);
+        return size;
+    }
+#endif
+    if (fseek(pObject->File_Handle, position, SEEK_SET) == 0) {
+        len = fread(buffer, 1, size, pObject->File_Handle);
+    }
+
+    return len;
+}
+
 /**
  * @brief For a given object instance-number, returns the pathname
  * @param  object_instance - object-instance number of the object
@@ -124,8 +271,9 @@ void bacfile_pathname_set(uint32_t object_instance, const char *pathname)
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
+        bacfile_handle_close(pObject);
         if (pObject->Pathname) {
-            free(pObject->Pathname);
+            bacnet_free(pObject->Pathname);
         }
         pObject->Pathname = bacfile_strdup(pathname);
     }
@@ -255,25 +403,6 @@ uint32_t bacfile_index_to_instance(unsigned find_index)
     return key;
 }
 
-/**
- * @brief Determines the file size for a given file
- * @param  pFile - file handle
- * @return  file size in bytes, or 0 if not found
- */
-static long fsize(FILE *pFile)
-{
-    long size = 0;
-    long origin = 0;
-
-    if (pFile) {
-        origin = ftell(pFile);
-        fseek(pFile, 0L, SEEK_END);
-        size = ftell(pFile);
-        fseek(pFile, origin, SEEK_SET);
-    }
-    return (size);
-}
-
 /**
  * @brief Read the entire file into a buffer
  * @param  object_instance - object-instance number of the object
@@ -284,21 +413,17 @@ static long fsize(FILE *pFile)
 uint32_t bacfile_read(uint32_t object_instance, uint8_t *buffer,
     uint32_t buffer_size)
 {
-    const char *pFilename = NULL;
-    FILE *pFile = NULL;
+    struct object_data *pObject;
     long file_size = 0;
 
-    pFilename = bacfile_pathname(object_instance);
-    if (pFilename) {
-        pFile = fopen(pFilename, "rb");
-        if (pFile) {
-            file_size = fsize(pFile);
-            if (buffer && (buffer_size >= file_size)) {
-                if (fread(buffer, file_size, 1, pFile) == 0) {
-                    file_size = 0;
-                }
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject && bacfile_handle_open(pObject)) {
+        file_size = pObject->File_Size;
+        if (buffer && (buffer_size >= file_size)) {
+            if (bacfile_handle_read(pObject, 0, buffer, file_size) !=
+                (size_t)file_size) {
+                file_size = 0;
             }
-            fclose(pFile);
         }
     }
 
@@ -315,11 +440,16 @@ uint32_t bacfile_read(uint32_t object_instance, uint8_t *buffer,
 uint32_t bacfile_write(uint32_t object_instance, uint8_t *buffer,
     uint32_t buffer_size)
 {
+    struct object_data *pObject;
     const char *pFilename = NULL;
     FILE *pFile = NULL;
     long file_size = 0;
 
-    pFilename = bacfile_pathname(object_instance);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        bacfile_handle_close(pObject);
+        pFilename = pObject->Pathname;
+    }
     if (pFilename) {
         /* open the file as a clean slate when starting at 0 */
         pFile = fopen(pFilename, "wb");
@@ -341,21 +471,12 @@ uint32_t bacfile_write(uint32_t object_instance, uint8_t *buffer,
  */
 BACNET_UNSIGNED_INTEGER bacfile_file_size(uint32_t object_instance)
 {
-    const char *pFilename = NULL;
-    FILE *pFile = NULL;
-    long file_position = 0;
+    struct object_data *pObject;
     BACNET_UNSIGNED_INTEGER file_size = 0;
 
-    pFilename = bacfile_pathname(object_instance);
-    if (pFilename) {
-        pFile = fopen(pFilename, "rb");
-        if (pFile) {
-            file_position = fsize(pFile);
-            if (file_position >= 0) {
-                file_size = (BACNET_UNSIGNED_INTEGER)file_position;
-            }
-            fclose(pFile);
-        }
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject && bacfile_handle_open(pObject)) {
+        file_size = (BACNET_UNSIGNED_INTEGER)pObject->File_Size;
     }
 
     return file_size;
@@ -420,14 +541,7 @@ void bacfile_file_type_set(
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        if (pObject->File_Type) {
-            if (strcmp(pObject->File_Type, mime_type) != 0) {
-                free(pObject->File_Type);
-                pObject->File_Type = bacfile_strdup(mime_type);
-            }
-        } else {
-            pObject->File_Type = bacfile_strdup(mime_type);
-        }
+        pObject->File_Type = strpool_intern(mime_type);
     }
 }
 
@@ -615,16 +729,12 @@ int bacfile_read_property(BACNET_READ_PROPERTY_DATA *rpdata)
                 encode_application_enumerated(&apdu[0], Object_Type);
             break;
         case PROP_DESCRIPTION:
-            characterstring_init_ansi(
-                &char_string, bacfile_pathname(rpdata->object_instance));
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            apdu_len = encode_application_character_string_ansi(
+                &apdu[0], bacfile_pathname(rpdata->object_instance));
             break;
         case PROP_FILE_TYPE:
-            characterstring_init_ansi(&char_string,
-                bacfile_file_type(rpdata->object_instance));
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            apdu_len = encode_application_character_string_ansi(
+                &apdu[0], bacfile_file_type(rpdata->object_instance));
             break;
         case PROP_FILE_SIZE:
             apdu_len = encode_application_unsigned(
@@ -789,26 +899,28 @@ uint32_t bacfile_instance_from_tsm(uint8_t invokeID)
 
 bool bacfile_read_stream_data(BACNET_ATOMIC_READ_FILE_DATA *data)
 {
-    const char *pFilename = NULL;
+    struct object_data *pObject;
     bool found = false;
-    FILE *pFile = NULL;
     size_t len = 0;
+    size_t size = 0;
 
-    pFilename = bacfile_pathname(data->object_instance);
-    if (pFilename) {
+    pObject = Keylist_Data(Object_List, data->object_instance);
+    if (pObject && pObject->Pathname) {
         found = true;
-        pFile = fopen(pFilename, "rb");
-        if (pFile) {
-            (void)fseek(pFile, data->type.stream.fileStartPosition, SEEK_SET);
-            len = fread(octetstring_value(&data->fileData[0]), 1,
-                data->type.stream.requestedOctetCount, pFile);
+        if (bacfile_handle_open(pObject)) {
+            size = data->type.stream.requestedOctetCount;
+            if (size > octetstring_capacity(&data->fileData[0])) {
+                size = octetstring_capacity(&data->fileData[0]);
+            }
+            len = bacfile_handle_read(pObject,
+                data->type.stream.fileStartPosition,
+                octetstring_value(&data->fileData[0]), size);
             if (len < data->type.stream.requestedOctetCount) {
                 data->endOfFile = true;
             } else {
                 data->endOfFile = false;
             }
             octetstring_truncate(&data->fileData[0], len);
-            fclose(pFile);
         } else {
             octetstring_truncate(&data->fileData[0], 0);
             data->endOfFile = true;
@@ -823,13 +935,40 @@ bool bacfile_read_stream_data(BACNET_ATOMIC_READ_FILE_DATA *data)
 
 bool bacfile_write_stream_data(BACNET_ATOMIC_WRITE_FILE_DATA *data)
 {
+    struct object_data *pObject;
     const char *pFilename = NULL;
     bool found = false;
     FILE *pFile = NULL;
+    long position = 0;
+    size_t len = 0;
 
-    pFilename = bacfile_pathname(data->object_instance);
-    if (pFilename) {
+    pObject = Keylist_Data(Object_List, data->object_instance);
+    if (pObject) {
+        pFilename = pObject->Pathname;
+    }
+    if (pFilename && (data->type.stream.fileStartPosition > 0)) {
         found = true;
+        /* write into the open file */
+        pFile = bacfile_handle_open(pObject);
+        if (pFile) {
+            position = data->type.stream.fileStartPosition;
+            len = octetstring_length(&data->fileData[0]);
+            if ((fseek(pFile, position, SEEK_SET) == 0) &&
+                (fwrite(octetstring_value(&data->fileData[0]), len, 1,
+                     pFile) == 1) &&
+                (fflush(pFile) == 0)) {
+                if ((position + (long)len) > pObject->File_Size) {
+                    /* mapped again with the new size when read */
+                    bacfile_handle_unmap(pObject);
+                    pObject->File_Size = position + (long)len;
+                }
+            } else {
+                bacfile_handle_close(pObject);
+            }
+        }
+    } else if (pFilename) {
+        found = true;
+        bacfile_handle_close(pObject);
         if (data->type.stream.fileStartPosition == 0) {
             /* open the file as a clean slate when starting at 0 */
             pFile = fopen(pFilename, "wb");
@@ -870,6 +1009,7 @@ bool bacfile_write_record_data(BACNET_ATOMIC_WRITE_FILE_DATA *data)
     pFilename = bacfile_pathname(data->object_instance);
     if (pFilename) {
         found = true;
+        bacfile_handle_close(Keylist_Data(Object_List, data->object_instance));
         if (data->type.record.fileStartRecord == 0) {
             /* open the file as a clean slate when starting at 0 */
             pFile = fopen(pFilename, "wb");
@@ -917,6 +1057,7 @@ bool bacfile_read_ack_stream_data(
     pFilename = bacfile_pathname(instance);
     if (pFilename) {
         found = true;
+        bacfile_handle_close(Keylist_Data(Object_List, instance));
         pFile = fopen(pFilename, "rb+");
         if (pFile) {
             (void)fseek(pFile, data->type.stream.fileStartPosition, SEEK_SET);
@@ -947,6 +1088,7 @@ bool bacfile_read_ack_record_data(
     pFilename = bacfile_pathname(instance);
     if (pFilename) {
         found = true;
+        bacfile_handle_close(Keylist_Data(Object_List, instance));
         pFile = fopen(pFilename, "rb+");
         if (pFile) {
             if (data->type.record.fileStartRecord > 0) {
@@ -998,7 +1140,7 @@ uint32_t bacfile_create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Pathname = NULL;
@@ -1011,7 +1153,7 @@ uint32_t bacfile_create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1022,6 +1164,30 @@ uint32_t bacfile_create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of File objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned bacfile_create_bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (bacfile_create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * @brief Deletes an object
  * @param object_instance - object-instance number of the object
@@ -1034,13 +1200,33 @@ bool bacfile_delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        bacfile_handle_close(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
     return status;
 }
 
+/**
+ * @brief Closes the open file of an object after it has not been used
+ *  for BACFILE_IDLE_TIMEOUT milliseconds
+ * @param object_instance - object-instance number of the object
+ * @param milliseconds - number of milliseconds elapsed
+ */
+void bacfile_timer(uint32_t object_instance, uint16_t milliseconds)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject && pObject->File_Handle) {
+        pObject->File_Idle_Milliseconds += milliseconds;
+        if (pObject->File_Idle_Milliseconds >= BACFILE_IDLE_TIMEOUT) {
+            bacfile_handle_close(pObject);
+        }
+    }
+}
+
 /**
  * @brief Deletes all the objects and their data
  */
@@ -1052,10 +1238,12 @@ void bacfile_cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                bacfile_handle_close(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -1067,5 +1255,6 @@ void bacfile_init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
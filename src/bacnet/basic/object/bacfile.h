@@ -156,9 +156,15 @@ extern "C" {
     uint32_t bacfile_create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned bacfile_create_bulk(uint32_t object_instance, unsigned count);
+    BACNET_STACK_EXPORT
     bool bacfile_delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    void bacfile_timer(
+        uint32_t object_instance,
+        uint16_t milliseconds);
+    BACNET_STACK_EXPORT
     void bacfile_cleanup(
         void);
     BACNET_STACK_EXPORT
@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -21,9 +22,12 @@
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 #include "bacnet/cov.h"
+#include "bacnet/basic/service/alarm_active.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/columns.h"
 /* me! */
 #include "bacnet/basic/object/bi.h"
 
@@ -60,9 +64,18 @@ struct object_data {
     ACK_NOTIFICATION Ack_notify_data;
     BACNET_BINARY_PV Alarm_Value;
 #endif
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    unsigned Column_Row;
+#endif
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/* the values of the objects, in columns */
+static COLUMNS_STORE Object_Columns;
+#endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_BINARY_INPUT;
 /* callback for present value writes */
@@ -262,16 +275,168 @@ BACNET_BINARY_PV Binary_Input_Present_Value(uint32_t object_instance)
     return value;
 }
 
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/**
+ * @brief Copy the Present_Value, status flags and COV flag of an object
+ *  into its row of the columns
+ * @param pObject - object data
+ */
+static void Binary_Input_Columns_Update(struct object_data *pObject)
+{
+    uint8_t flags = 0;
+    float value = 0.0f;
+
+    if (Binary_Input_Present_Value(
+            Object_Columns.instance[pObject->Column_Row]) == BINARY_ACTIVE) {
+        flags |= COLUMNS_FLAG_ACTIVE;
+        value = 1.0f;
+    }
+    if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        flags |= COLUMNS_FLAG_FAULT;
+    }
+    if (pObject->Out_Of_Service) {
+        flags |= COLUMNS_FLAG_OUT_OF_SERVICE;
+    }
+    if (pObject->Change_Of_Value) {
+        flags |= COLUMNS_FLAG_CHANGED;
+    }
+
+    columns_set(&Object_Columns, pObject->Column_Row, value, flags);
+}
+
+/**
+ * @brief Add a row to the columns for a new object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @return true if the row was added
+ */
+static bool Binary_Input_Columns_Add(
+    uint32_t object_instance, struct object_data *pObject)
+{
+    int row;
+
+    row = columns_add(&Object_Columns, object_instance);
+    if (row < 0) {
+        return false;
+    }
+    pObject->Column_Row = (unsigned)row;
+    columns_data_set(&Object_Columns, pObject->Column_Row, pObject);
+    Binary_Input_Columns_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Remove the row of a deleted object from the columns
+ * @param pObject - object data
+ */
+static void Binary_Input_Columns_Remove(struct object_data *pObject)
+{
+    struct object_data *pMoved;
+    uint32_t object_instance;
+
+    /* the last row was moved into the removed row */
+    object_instance = columns_remove(&Object_Columns, pObject->Column_Row);
+    pMoved = Binary_Input_Object(object_instance);
+    if (pMoved) {
+        pMoved->Column_Row = pObject->Column_Row;
+    }
+}
+
+/**
+ * @brief Get the Present_Value, status flags and COV flag of all of the
+ *  Binary Input objects in columns, to scan all of the objects at once
+ * @return the columns, with one row for each object
+ */
+const COLUMNS_STORE *Binary_Input_Columns(void)
+{
+    return &Object_Columns;
+}
+
+/**
+ * @brief Set the Present_Value of the objects of consecutive rows of the
+ *  columns at once, such as the samples of an I/O scan. The objects
+ *  whose Present_Value changed are put into the COV change queue.
+ * @param row - row of the columns of the object of the first value
+ * @param value - Present_Value of each object, from the first row
+ * @param count - number of values
+ * @param changed - bitmap of COLUMNS_BITMAP_WORDS(count) words, where
+ *  bit (i % 32) of word (i / 32) is set if the object of value[i] changed
+ * @return number of objects that changed
+ */
+unsigned Binary_Input_Present_Value_Rows_Set(
+    unsigned row,
+    const BACNET_BINARY_PV *value,
+    unsigned count,
+    uint32_t *changed)
+{
+    struct object_data *pObject;
+    unsigned changes = 0;
+    unsigned i;
+    uint8_t flags;
+    bool active;
+    bool present_value;
+
+    if (!value || !changed || (row >= Object_Columns.count)) {
+        return 0;
+    }
+    if (count > (Object_Columns.count - row)) {
+        count = Object_Columns.count - row;
+    }
+    memset(changed, 0, COLUMNS_BITMAP_WORDS(count) * sizeof(*changed));
+    /* the readers of the columns see the changes of a scan at once */
+    columns_write_begin(&Object_Columns);
+    for (i = 0; i < count; i++) {
+        if (value[i] > MAX_BINARY_PV) {
+            continue;
+        }
+        pObject = Object_Columns.data[row + i];
+        active = (value[i] == BINARY_ACTIVE);
+        /* de-polarize */
+        present_value = active != (bool)pObject->Polarity;
+        if (pObject->Present_Value == present_value) {
+            continue;
+        }
+        if (!pObject->Change_Of_Value) {
+            handler_cov_object_changed(
+                Object_Type, Object_Columns.instance[row + i]);
+        }
+        pObject->Change_Of_Value = true;
+        pObject->Present_Value = present_value;
+        flags = Object_Columns.flags[row + i] & ~COLUMNS_FLAG_ACTIVE;
+        flags |= COLUMNS_FLAG_CHANGED;
+        if (active) {
+            flags |= COLUMNS_FLAG_ACTIVE;
+        }
+        columns_set(&Object_Columns, row + i, active ? 1.0f : 0.0f, flags);
+        changed[i / 32] |= 1UL << (i % 32);
+        changes++;
+    }
+    columns_write_end(&Object_Columns);
+
+    return changes;
+}
+#else
+#define Binary_Input_Columns_Update(pObject) ((void)0)
+#define Binary_Input_Columns_Add(object_instance, pObject) (true)
+#define Binary_Input_Columns_Remove(pObject) ((void)0)
+#endif
+
 /**
  * @brief For a given object instance-number, checks the present-value for COV
+ * @param  object_instance - object-instance number of the object
  * @param  pObject - specific object with valid data
  * @param  value - floating point analog value
  */
-static void Binary_Input_Present_Value_COV_Detect(
-    struct object_data *pObject, BACNET_BINARY_PV value)
+static void Binary_Input_Present_Value_COV_Detect(uint32_t object_instance,
+    struct object_data *pObject,
+    BACNET_BINARY_PV value)
 {
     if (pObject) {
         if (Binary_Present_Value(pObject->Present_Value) != value) {
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Change_Of_Value = true;
         }
     }
@@ -310,7 +475,11 @@ void Binary_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Change_Of_Value = true;
+            Binary_Input_Columns_Update(pObject);
         }
     }
 
@@ -375,8 +544,12 @@ bool Binary_Input_Reliability_Set(
             fault = Binary_Input_Object_Fault(pObject);
             pObject->Reliability = value;
             if (fault != Binary_Input_Object_Fault(pObject)) {
+                if (!pObject->Change_Of_Value) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Change_Of_Value = true;
             }
+            Binary_Input_Columns_Update(pObject);
             status = true;
         }
     }
@@ -428,6 +601,7 @@ void Binary_Input_Change_Of_Value_Clear(uint32_t object_instance)
     pObject = Binary_Input_Object(object_instance);
     if (pObject) {
         pObject->Change_Of_Value = false;
+        Binary_Input_Columns_Update(pObject);
     }
 
     return;
@@ -489,8 +663,10 @@ bool Binary_Input_Present_Value_Set(
                     value = BINARY_INACTIVE;
                 }
             }
-            Binary_Input_Present_Value_COV_Detect(pObject, value);
+            Binary_Input_Present_Value_COV_Detect(
+                object_instance, pObject, value);
             pObject->Present_Value = Binary_Present_Value_Boolean(value);
+            Binary_Input_Columns_Update(pObject);
             status = true;
         }
     }
@@ -523,8 +699,10 @@ static bool Binary_Input_Present_Value_Write(
         if (value <= MAX_BINARY_PV) {
             if (pObject->Write_Enabled) {
                 old_value = Binary_Present_Value(pObject->Present_Value);
-                Binary_Input_Present_Value_COV_Detect(pObject, value);
+                Binary_Input_Present_Value_COV_Detect(
+                    object_instance, pObject, value);
                 pObject->Present_Value = Binary_Present_Value_Boolean(value);
+                Binary_Input_Columns_Update(pObject);
                 if (pObject->Out_Of_Service) {
                     /* The physical point that the object represents
                         is not in service. This means that changes to the
@@ -636,6 +814,7 @@ bool Binary_Input_Polarity_Set(
     pObject = Binary_Input_Object(object_instance);
     if (pObject) {
         pObject->Polarity = Binary_Polarity_Boolean(polarity);
+        Binary_Input_Columns_Update(pObject);
     }
 
     return status;
@@ -812,6 +991,23 @@ static int Binary_Input_Event_Time_Stamps_Encode(
 }
 #endif
 
+/**
+ * @brief Get the Status_Flags of a Binary Input object
+ * @param object_instance - object-instance number of the object
+ * @param bit_string - the Status_Flags
+ */
+static void Binary_Input_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *bit_string)
+{
+    bitstring_init(bit_string);
+    bitstring_set_bit(bit_string, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(
+        bit_string, STATUS_FLAG_FAULT, Binary_Input_Fault(object_instance));
+    bitstring_set_bit(bit_string, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(bit_string, STATUS_FLAG_OUT_OF_SERVICE,
+        Binary_Input_Out_Of_Service(object_instance));
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -868,13 +1064,7 @@ int Binary_Input_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
         case PROP_STATUS_FLAGS:
             /* note: see the details in the standard on how to use these */
-            bitstring_init(&bit_string);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
-            state = Binary_Input_Fault(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, state);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
-            state = Binary_Input_Out_Of_Service(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, state);
+            Binary_Input_Status_Flags(rpdata->object_instance, &bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_EVENT_STATE:
@@ -1151,6 +1341,83 @@ bool Binary_Input_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
+/**
+ * @brief Get the value of a property of a Binary Input object without
+ *  encoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @return true if the value was copied, or false if the property is
+ *  read with ReadProperty instead
+ */
+bool Binary_Input_Property_Value(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    bool status = true;
+
+    if (!value || (array_index != BACNET_ARRAY_ALL) ||
+        !Binary_Input_Valid_Instance(object_instance)) {
+        return false;
+    }
+    value->context_specific = false;
+    value->next = NULL;
+    switch (object_property) {
+        case PROP_PRESENT_VALUE:
+            value->tag = BACNET_APPLICATION_TAG_ENUMERATED;
+            value->type.Enumerated =
+                Binary_Input_Present_Value(object_instance);
+            break;
+        case PROP_STATUS_FLAGS:
+            value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+            Binary_Input_Status_Flags(
+                object_instance, &value->type.Bit_String);
+            break;
+        case PROP_OUT_OF_SERVICE:
+            value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+            value->type.Boolean = Binary_Input_Out_Of_Service(object_instance);
+            break;
+        default:
+            status = false;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set the value of a property of a Binary Input object without
+ *  decoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @param priority - BACnet priority 1..16
+ * @return true if the value was set, or false if the property is
+ *  written with WriteProperty instead, which gives the error
+ */
+bool Binary_Input_Property_Value_Set(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_PROPERTY;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+
+    if (!value || (object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL) ||
+        (value->tag != BACNET_APPLICATION_TAG_ENUMERATED)) {
+        return false;
+    }
+    (void)priority;
+
+    return Binary_Input_Present_Value_Write(object_instance,
+        value->type.Enumerated, &error_class, &error_code);
+}
+
 /**
  * @brief Sets a callback used when present-value is written from BACnet
  * @param cb - callback used to provide indications
@@ -1229,7 +1496,7 @@ uint32_t Binary_Input_Create(uint32_t object_instance)
 
     pObject = Binary_Input_Object(object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
 #if defined(INTRINSIC_REPORTING) && (BINARY_INPUT_INTRINSIC_REPORTING)
             unsigned j;
@@ -1263,11 +1530,20 @@ uint32_t Binary_Input_Create(uint32_t object_instance)
             /* Set handler for GetAlarmSummary Service */
             handler_get_alarm_summary_set(
                     Object_Type, Binary_Input_Alarm_Summary);
+            /* GetEventInformation and GetAlarmSummary visit only the
+               objects with an active alarm */
+            Alarm_Active_Index_Set(
+                Object_Type, Binary_Input_Instance_To_Index);
 #endif
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
+                return BACNET_MAX_INSTANCE;
+            }
+            if (!Binary_Input_Columns_Add(object_instance, pObject)) {
+                Keylist_Data_Delete(Object_List, object_instance);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1278,6 +1554,30 @@ uint32_t Binary_Input_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Binary Input objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Binary_Input_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Binary_Input_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Initializes the Binary Input object data
  */
@@ -1289,10 +1589,17 @@ void Binary_Input_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
+#if defined(INTRINSIC_REPORTING) && (BINARY_INPUT_INTRINSIC_REPORTING)
+        Alarm_Active_Clear(Object_Type);
+#endif
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_cleanup(&Object_Columns);
+#endif
         Object_List = NULL;
     }
 }
@@ -1309,7 +1616,11 @@ bool Binary_Input_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Binary_Input_Columns_Remove(pObject);
+#if defined(INTRINSIC_REPORTING) && (BINARY_INPUT_INTRINSIC_REPORTING)
+        (void)Alarm_Active_Set(Object_Type, object_instance, false);
+#endif
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1323,6 +1634,10 @@ void Binary_Input_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_init(&Object_Columns);
+#endif
     }
 }
 
@@ -1409,6 +1724,24 @@ static struct object_data *Binary_Input_Object_Index(int index)
 {
     return Keylist_Data_Index(Object_List, index);
 }
+
+/**
+ * @brief Update the entry of an object in the device set of the objects
+ *  with an active alarm, after its Event_State or Acked_Transitions change
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ */
+static void Binary_Input_Alarm_Active_Update(
+    uint32_t object_instance, struct object_data *pObject)
+{
+    bool active;
+
+    active = (pObject->Event_State != EVENT_STATE_NORMAL) ||
+        !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked;
+    (void)Alarm_Active_Set(Object_Type, object_instance, active);
+}
 #endif
 
 int Binary_Input_Event_Information(
@@ -1579,6 +1912,8 @@ int Binary_Input_Alarm_Ack(
     }
     pObject->Ack_notify_data.bSendAckNotify = true;
     pObject->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
+    Binary_Input_Alarm_Active_Update(
+        alarmack_data->eventObjectIdentifier.instance, pObject);
 
     return 1;
 }
@@ -1889,6 +2224,7 @@ void Binary_Input_Intrinsic_Reporting(uint32_t object_instance)
             }
         }
     }
+    Binary_Input_Alarm_Active_Update(object_instance, pObject);
 #endif /* defined(INTRINSIC_REPORTING) && (BINARY_INPUT_INTRINSIC_REPORTING) */
 }
 
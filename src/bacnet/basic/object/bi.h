@@ -17,6 +17,7 @@
 #include "bacnet/cov.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
+#include "bacnet/basic/sys/columns.h"
 
 #if (INTRINSIC_REPORTING)
 #include "bacnet/basic/object/nc.h"
@@ -148,6 +149,19 @@ extern "C" {
     bool Binary_Input_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
     BACNET_STACK_EXPORT
+    bool Binary_Input_Property_Value(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    bool Binary_Input_Property_Value_Set(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        const BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority);
+    BACNET_STACK_EXPORT
     void Binary_Input_Write_Present_Value_Callback_Set(
         binary_input_write_present_value_callback cb);
 
@@ -155,6 +169,18 @@ extern "C" {
     uint32_t Binary_Input_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Binary_Input_Create_Bulk(uint32_t object_instance, unsigned count);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    BACNET_STACK_EXPORT
+    const COLUMNS_STORE *Binary_Input_Columns(void);
+    BACNET_STACK_EXPORT
+    unsigned Binary_Input_Present_Value_Rows_Set(
+        unsigned row,
+        const BACNET_BINARY_PV *value,
+        unsigned count,
+        uint32_t *changed);
+#endif
+    BACNET_STACK_EXPORT
     bool Binary_Input_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
@@ -22,6 +22,7 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
 /* me! */
 #include "bitstring_value.h"
 
@@ -36,6 +37,8 @@ struct object_data {
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 /* callback for present value writes */
 static bitstring_value_write_present_value_callback
     BitString_Value_Write_Present_Value_Callback;
@@ -179,6 +182,10 @@ bool BitString_Value_Present_Value_Set(
     pObject = BitString_Value_Object(object_instance);
     if (pObject) {
         if (!bitstring_same(&pObject->Present_Value, value)) {
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(
+                    OBJECT_BITSTRING_VALUE, object_instance);
+            }
             pObject->Change_Of_Value = true;
         }
         status = bitstring_copy(&pObject->Present_Value, value);
@@ -272,6 +279,10 @@ void BitString_Value_Out_Of_Service_Set(
     pObject = BitString_Value_Object(object_instance);
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(
+                    OBJECT_BITSTRING_VALUE, object_instance);
+            }
             pObject->Change_Of_Value = true;
         }
         pObject->Out_Of_Service = value;
@@ -336,6 +347,10 @@ bool BitString_Value_Reliablity_Set(
             fault = BitString_Value_Object_Fault(pObject);
             pObject->Reliability = value;
             if (fault != BitString_Value_Object_Fault(pObject)) {
+                if (!pObject->Change_Of_Value) {
+                    handler_cov_object_changed(
+                        OBJECT_BITSTRING_VALUE, object_instance);
+                }
                 pObject->Change_Of_Value = true;
             }
             status = true;
@@ -759,7 +774,7 @@ uint32_t BitString_Value_Create(uint32_t object_instance)
 
     pObject = BitString_Value_Object(object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Description = NULL;
@@ -771,7 +786,7 @@ uint32_t BitString_Value_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -782,6 +797,30 @@ uint32_t BitString_Value_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of BitString Value objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned BitString_Value_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (BitString_Value_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an BitString Value object
  * @param object_instance - object-instance number of the object
@@ -794,7 +833,7 @@ bool BitString_Value_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -812,10 +851,11 @@ void BitString_Value_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -827,5 +867,6 @@ void BitString_Value_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
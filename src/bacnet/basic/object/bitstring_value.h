@@ -130,6 +130,9 @@ extern "C" {
     BACNET_STACK_EXPORT
     uint32_t BitString_Value_Create(uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned BitString_Value_Create_Bulk(
+        uint32_t object_instance, unsigned count);
+    BACNET_STACK_EXPORT
     bool BitString_Value_Delete(uint32_t object_instance);
     BACNET_STACK_EXPORT
     void BitString_Value_Cleanup(void);
@@ -20,6 +20,7 @@
 #include "bacnet/lighting.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
 #include "bacnet/proplist.h"
 /* me! */
 #include "bacnet/basic/object/blo.h"
@@ -52,6 +53,8 @@ struct object_data {
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 /* callback for present value writes */
 static binary_lighting_output_write_value_callback
     Binary_Lighting_Output_Write_Value_Callback;
@@ -462,6 +465,10 @@ static void Present_Value_Relinquish_Handler(uint32_t object_instance)
             value = Priority_Array_Value(pObject, current_priority);
         }
         if (pObject->Feedback_Value != value) {
+            if (!pObject->Changed) {
+                handler_cov_object_changed(
+                    OBJECT_BINARY_LIGHTING_OUTPUT, object_instance);
+            }
             pObject->Changed = true;
             if ((!pObject->Out_Of_Service) &&
                 (Binary_Lighting_Output_Write_Value_Callback)) {
@@ -1480,7 +1487,7 @@ uint32_t Binary_Lighting_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (!pObject) {
             return BACNET_MAX_INSTANCE;
         }
@@ -1502,7 +1509,7 @@ uint32_t Binary_Lighting_Output_Create(uint32_t object_instance)
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
-            free(pObject);
+            pool_free(&Object_Pool, pObject);
             return BACNET_MAX_INSTANCE;
         }
     }
@@ -1510,6 +1517,31 @@ uint32_t Binary_Lighting_Output_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Binary Lighting Output objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Binary_Lighting_Output_Create_Bulk(
+    uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Binary_Lighting_Output_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an object instance
  * @param object_instance - object-instance number of the object
@@ -1522,7 +1554,7 @@ bool Binary_Lighting_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1540,10 +1572,11 @@ void Binary_Lighting_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -1555,5 +1588,6 @@ void Binary_Lighting_Output_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
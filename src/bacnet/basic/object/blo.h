@@ -143,6 +143,9 @@ void Binary_Lighting_Output_Blink_Warn_Callback_Set(
 BACNET_STACK_EXPORT
 uint32_t Binary_Lighting_Output_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+unsigned Binary_Lighting_Output_Create_Bulk(
+    uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 bool Binary_Lighting_Output_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Binary_Lighting_Output_Cleanup(void);
@@ -29,6 +29,8 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/columns.h"
 /* me! */
 #include "bo.h"
 
@@ -42,14 +44,25 @@ struct object_data {
     bool Polarity : 1;
     uint16_t Priority_Array;
     uint16_t Priority_Active_Bits;
+    /* highest active priority 1..16, or 0 if all are relinquished */
+    uint8_t Active_Priority;
     uint8_t Reliability;
     const char *Object_Name;
     const char *Active_Text;
     const char *Inactive_Text;
     const char *Description;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    unsigned Column_Row;
+#endif
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/* the values of the objects, in columns */
+static COLUMNS_STORE Object_Columns;
+#endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_BINARY_OUTPUT;
 /* callback for present value writes */
@@ -158,6 +171,35 @@ unsigned Binary_Output_Instance_To_Index(uint32_t object_instance)
     return Keylist_Index(Object_List, object_instance);
 }
 
+/**
+ * @brief Update the active priority of an object after a priority-array
+ *  slot was commanded or relinquished, so that the present-value is
+ *  found without a search of the priority-array
+ * @param  pObject - specific object with valid data
+ * @param  priority - priority-array index value 1..16 that changed
+ */
+static void Binary_Output_Active_Priority_Update(
+    struct object_data *pObject, unsigned priority)
+{
+    unsigned p;
+
+    if (BIT_CHECK(pObject->Priority_Active_Bits, priority - 1)) {
+        if ((pObject->Active_Priority == 0) ||
+            (priority < pObject->Active_Priority)) {
+            pObject->Active_Priority = priority;
+        }
+    } else if (priority == pObject->Active_Priority) {
+        /* the active priority was relinquished: find the next one */
+        pObject->Active_Priority = 0;
+        for (p = priority; p < BACNET_MAX_PRIORITY; p++) {
+            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
+                pObject->Active_Priority = p + 1;
+                break;
+            }
+        }
+    }
+}
+
 /**
  * For a given object instance-number, determines the present-value
  *
@@ -168,29 +210,105 @@ unsigned Binary_Output_Instance_To_Index(uint32_t object_instance)
 BACNET_BINARY_PV Binary_Output_Present_Value(uint32_t object_instance)
 {
     BACNET_BINARY_PV value = BINARY_INACTIVE;
-    unsigned p = 0;
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        if (pObject->Relinquish_Default) {
-            value = BINARY_ACTIVE;
-        }
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-                if (BIT_CHECK(pObject->Priority_Array, p)) {
-                    value = BINARY_ACTIVE;
-                } else {
-                    value = BINARY_INACTIVE;
-                }
-                break;
+        if (pObject->Active_Priority) {
+            if (BIT_CHECK(
+                    pObject->Priority_Array, pObject->Active_Priority - 1)) {
+                value = BINARY_ACTIVE;
             }
+        } else if (pObject->Relinquish_Default) {
+            value = BINARY_ACTIVE;
         }
     }
 
     return value;
 }
 
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/**
+ * @brief Copy the Present_Value, status flags and COV flag of an object
+ *  into its row of the columns
+ * @param pObject - object data
+ */
+static void Binary_Output_Columns_Update(struct object_data *pObject)
+{
+    uint8_t flags = 0;
+    float value = 0.0f;
+
+    if (Binary_Output_Present_Value(
+            Object_Columns.instance[pObject->Column_Row]) == BINARY_ACTIVE) {
+        flags |= COLUMNS_FLAG_ACTIVE;
+        value = 1.0f;
+    }
+    if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        flags |= COLUMNS_FLAG_FAULT;
+    }
+    if (pObject->Out_Of_Service) {
+        flags |= COLUMNS_FLAG_OUT_OF_SERVICE;
+    }
+    if (pObject->Changed) {
+        flags |= COLUMNS_FLAG_CHANGED;
+    }
+
+    columns_set(&Object_Columns, pObject->Column_Row, value, flags);
+}
+
+/**
+ * @brief Add a row to the columns for a new object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @return true if the row was added
+ */
+static bool Binary_Output_Columns_Add(
+    uint32_t object_instance, struct object_data *pObject)
+{
+    int row;
+
+    row = columns_add(&Object_Columns, object_instance);
+    if (row < 0) {
+        return false;
+    }
+    pObject->Column_Row = (unsigned)row;
+    Binary_Output_Columns_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Remove the row of a deleted object from the columns
+ * @param pObject - object data
+ */
+static void Binary_Output_Columns_Remove(struct object_data *pObject)
+{
+    struct object_data *pMoved;
+    uint32_t object_instance;
+
+    /* the last row was moved into the removed row */
+    object_instance = columns_remove(&Object_Columns, pObject->Column_Row);
+    pMoved = Keylist_Data(Object_List, object_instance);
+    if (pMoved) {
+        pMoved->Column_Row = pObject->Column_Row;
+    }
+}
+
+/**
+ * @brief Get the Present_Value, status flags and COV flag of all of the
+ *  Binary Output objects in columns, to scan all of the objects at once
+ * @return the columns, with one row for each object
+ */
+const COLUMNS_STORE *Binary_Output_Columns(void)
+{
+    return &Object_Columns;
+}
+#else
+#define Binary_Output_Columns_Update(pObject) ((void)0)
+#define Binary_Output_Columns_Add(object_instance, pObject) (true)
+#define Binary_Output_Columns_Remove(pObject) ((void)0)
+#endif
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -232,18 +350,12 @@ static int Binary_Output_Priority_Array_Encode(
  */
 unsigned Binary_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = pObject->Active_Priority;
     }
 
     return priority;
@@ -277,6 +389,8 @@ bool Binary_Output_Present_Value_Set(
                 } else {
                     BIT_CLEAR(pObject->Priority_Array, priority);
                 }
+                Binary_Output_Active_Priority_Update(pObject, priority + 1);
+                Binary_Output_Columns_Update(pObject);
                 status = true;
             }
         }
@@ -307,6 +421,8 @@ bool Binary_Output_Present_Value_Relinquish(
             priority--;
             BIT_CLEAR(pObject->Priority_Active_Bits, priority);
             BIT_CLEAR(pObject->Priority_Array, priority);
+            Binary_Output_Active_Priority_Update(pObject, priority + 1);
+            Binary_Output_Columns_Update(pObject);
             status = true;
         }
     }
@@ -463,7 +579,11 @@ void Binary_Output_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
+            Binary_Output_Columns_Update(pObject);
         }
     }
 }
@@ -618,9 +738,11 @@ bool Binary_Output_Relinquish_Default_Set(
     if (pObject) {
         if (value == BINARY_ACTIVE) {
             pObject->Relinquish_Default = true;
+            Binary_Output_Columns_Update(pObject);
             status = true;
         } else if (value == BINARY_INACTIVE) {
             pObject->Relinquish_Default = false;
+            Binary_Output_Columns_Update(pObject);
             status = true;
         }
     }
@@ -689,8 +811,12 @@ bool Binary_Output_Reliability_Set(
             fault = Binary_Output_Object_Fault(pObject);
             pObject->Reliability = value;
             if (fault != Binary_Output_Object_Fault(pObject)) {
+                if (!pObject->Changed) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Changed = true;
             }
+            Binary_Output_Columns_Update(pObject);
             status = true;
         }
     }
@@ -872,6 +998,7 @@ void Binary_Output_Change_Of_Value_Clear(uint32_t object_instance)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Changed = false;
+        Binary_Output_Columns_Update(pObject);
     }
 }
 
@@ -902,6 +1029,23 @@ bool Binary_Output_Encode_Value_List(
     return status;
 }
 
+/**
+ * @brief Get the Status_Flags of a Binary Output object
+ * @param object_instance - object-instance number of the object
+ * @param bit_string - the Status_Flags
+ */
+static void Binary_Output_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *bit_string)
+{
+    bitstring_init(bit_string);
+    bitstring_set_bit(bit_string, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(
+        bit_string, STATUS_FLAG_FAULT, Binary_Output_Fault(object_instance));
+    bitstring_set_bit(bit_string, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(bit_string, STATUS_FLAG_OUT_OF_SERVICE,
+        Binary_Output_Out_Of_Service(object_instance));
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -950,13 +1094,7 @@ int Binary_Output_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
         case PROP_STATUS_FLAGS:
             /* note: see the details in the standard on how to use these */
-            bitstring_init(&bit_string);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
-            state = Binary_Output_Fault(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, state);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
-            state = Binary_Output_Out_Of_Service(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, state);
+            Binary_Output_Status_Flags(rpdata->object_instance, &bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_RELIABILITY:
@@ -1113,6 +1251,88 @@ bool Binary_Output_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
+/**
+ * @brief Get the value of a property of a Binary Output object without
+ *  encoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @return true if the value was copied, or false if the property is
+ *  read with ReadProperty instead
+ */
+bool Binary_Output_Property_Value(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    bool status = true;
+
+    if (!value || (array_index != BACNET_ARRAY_ALL) ||
+        !Binary_Output_Valid_Instance(object_instance)) {
+        return false;
+    }
+    value->context_specific = false;
+    value->next = NULL;
+    switch (object_property) {
+        case PROP_PRESENT_VALUE:
+            value->tag = BACNET_APPLICATION_TAG_ENUMERATED;
+            value->type.Enumerated =
+                Binary_Output_Present_Value(object_instance);
+            break;
+        case PROP_STATUS_FLAGS:
+            value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+            Binary_Output_Status_Flags(
+                object_instance, &value->type.Bit_String);
+            break;
+        case PROP_OUT_OF_SERVICE:
+            value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+            value->type.Boolean = Binary_Output_Out_Of_Service(object_instance);
+            break;
+        default:
+            status = false;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set the value of a property of a Binary Output object without
+ *  decoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @param priority - BACnet priority 1..16
+ * @return true if the value was set, or false if the property is
+ *  written with WriteProperty instead, which gives the error
+ */
+bool Binary_Output_Property_Value_Set(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_PROPERTY;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+
+    if (!value || (object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL)) {
+        return false;
+    }
+    if (value->tag == BACNET_APPLICATION_TAG_ENUMERATED) {
+        return Binary_Output_Present_Value_Write(object_instance,
+            value->type.Enumerated, priority, &error_class, &error_code);
+    }
+    if (value->tag == BACNET_APPLICATION_TAG_NULL) {
+        return Binary_Output_Present_Value_Relinquish_Write(
+            object_instance, priority, &error_class, &error_code);
+    }
+
+    return false;
+}
+
 /**
  * @brief Sets a callback used when present-value is written from BACnet
  * @param cb - callback used to provide indications
@@ -1145,7 +1365,7 @@ uint32_t Binary_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Reliability = RELIABILITY_NO_FAULT_DETECTED;
@@ -1157,7 +1377,12 @@ uint32_t Binary_Output_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
+                return BACNET_MAX_INSTANCE;
+            }
+            if (!Binary_Output_Columns_Add(object_instance, pObject)) {
+                Keylist_Data_Delete(Object_List, object_instance);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1168,6 +1393,30 @@ uint32_t Binary_Output_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Binary Output objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Binary_Output_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Binary_Output_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Initializes the Binary Input object data
  */
@@ -1179,10 +1428,14 @@ void Binary_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_cleanup(&Object_Columns);
+#endif
         Object_List = NULL;
     }
 }
@@ -1197,7 +1450,8 @@ bool Binary_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Binary_Output_Columns_Remove(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1211,5 +1465,9 @@ void Binary_Output_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_init(&Object_Columns);
+#endif
     }
 }
@@ -18,6 +18,7 @@
 #include "bacnet/cov.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
+#include "bacnet/basic/sys/columns.h"
 
 /**
  * @brief Callback for gateway write present value request
@@ -159,11 +160,31 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool Binary_Output_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
+    BACNET_STACK_EXPORT
+    bool Binary_Output_Property_Value(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    bool Binary_Output_Property_Value_Set(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        const BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority);
 
     BACNET_STACK_EXPORT
     uint32_t Binary_Output_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Binary_Output_Create_Bulk(
+        uint32_t object_instance, unsigned count);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    BACNET_STACK_EXPORT
+    const COLUMNS_STORE *Binary_Output_Columns(void);
+#endif
+    BACNET_STACK_EXPORT
     bool Binary_Output_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
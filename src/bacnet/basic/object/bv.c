@@ -22,8 +22,11 @@
 #include "bacnet/rp.h"
 #include "bacnet/cov.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/service/alarm_active.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/columns.h"
 /* me! */
 #include "bacnet/basic/object/bv.h"
 
@@ -60,9 +63,18 @@ struct object_data {
     ACK_NOTIFICATION Ack_notify_data;
     BACNET_BINARY_PV Alarm_Value;
 #endif
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    unsigned Column_Row;
+#endif
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/* the values of the objects, in columns */
+static COLUMNS_STORE Object_Columns;
+#endif
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_BINARY_VALUE;
 /* callback for present value writes */
@@ -264,16 +276,103 @@ BACNET_BINARY_PV Binary_Value_Present_Value(uint32_t object_instance)
     return value;
 }
 
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/**
+ * @brief Copy the Present_Value, status flags and COV flag of an object
+ *  into its row of the columns
+ * @param pObject - object data
+ */
+static void Binary_Value_Columns_Update(struct object_data *pObject)
+{
+    uint8_t flags = 0;
+    float value = 0.0f;
+
+    if (Binary_Value_Present_Value(
+            Object_Columns.instance[pObject->Column_Row]) == BINARY_ACTIVE) {
+        flags |= COLUMNS_FLAG_ACTIVE;
+        value = 1.0f;
+    }
+    if (pObject->Reliability != RELIABILITY_NO_FAULT_DETECTED) {
+        flags |= COLUMNS_FLAG_FAULT;
+    }
+    if (pObject->Out_Of_Service) {
+        flags |= COLUMNS_FLAG_OUT_OF_SERVICE;
+    }
+    if (pObject->Change_Of_Value) {
+        flags |= COLUMNS_FLAG_CHANGED;
+    }
+
+    columns_set(&Object_Columns, pObject->Column_Row, value, flags);
+}
+
+/**
+ * @brief Add a row to the columns for a new object
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ * @return true if the row was added
+ */
+static bool Binary_Value_Columns_Add(
+    uint32_t object_instance, struct object_data *pObject)
+{
+    int row;
+
+    row = columns_add(&Object_Columns, object_instance);
+    if (row < 0) {
+        return false;
+    }
+    pObject->Column_Row = (unsigned)row;
+    Binary_Value_Columns_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Remove the row of a deleted object from the columns
+ * @param pObject - object data
+ */
+static void Binary_Value_Columns_Remove(struct object_data *pObject)
+{
+    struct object_data *pMoved;
+    uint32_t object_instance;
+
+    /* the last row was moved into the removed row */
+    object_instance = columns_remove(&Object_Columns, pObject->Column_Row);
+    pMoved = Binary_Value_Object(object_instance);
+    if (pMoved) {
+        pMoved->Column_Row = pObject->Column_Row;
+    }
+}
+
+/**
+ * @brief Get the Present_Value, status flags and COV flag of all of the
+ *  Binary Value objects in columns, to scan all of the objects at once
+ * @return the columns, with one row for each object
+ */
+const COLUMNS_STORE *Binary_Value_Columns(void)
+{
+    return &Object_Columns;
+}
+#else
+#define Binary_Value_Columns_Update(pObject) ((void)0)
+#define Binary_Value_Columns_Add(object_instance, pObject) (true)
+#define Binary_Value_Columns_Remove(pObject) ((void)0)
+#endif
+
 /**
  * @brief For a given object instance-number, checks the present-value for COV
+ * @param  object_instance - object-instance number of the object
  * @param  pObject - specific object with valid data
  * @param  value - floating point analog value
  */
-static void Binary_Value_Present_Value_COV_Detect(
-    struct object_data *pObject, BACNET_BINARY_PV value)
+static void Binary_Value_Present_Value_COV_Detect(uint32_t object_instance,
+    struct object_data *pObject,
+    BACNET_BINARY_PV value)
 {
     if (pObject) {
         if (Binary_Present_Value(pObject->Present_Value) != value) {
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Change_Of_Value = true;
         }
     }
@@ -313,7 +412,11 @@ void Binary_Value_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Change_Of_Value = true;
+            Binary_Value_Columns_Update(pObject);
         }
     }
 
@@ -378,8 +481,12 @@ bool Binary_Value_Reliability_Set(
             fault = Binary_Value_Object_Fault(pObject);
             pObject->Reliability = value;
             if (fault != Binary_Value_Object_Fault(pObject)) {
+                if (!pObject->Change_Of_Value) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Change_Of_Value = true;
             }
+            Binary_Value_Columns_Update(pObject);
             status = true;
         }
     }
@@ -431,6 +538,7 @@ void Binary_Value_Change_Of_Value_Clear(uint32_t object_instance)
     pObject = Binary_Value_Object(object_instance);
     if (pObject) {
         pObject->Change_Of_Value = false;
+        Binary_Value_Columns_Update(pObject);
     }
 
     return;
@@ -494,8 +602,10 @@ bool Binary_Value_Present_Value_Set(
                     value = BINARY_INACTIVE;
                 }
             }
-            Binary_Value_Present_Value_COV_Detect(pObject, value);
+            Binary_Value_Present_Value_COV_Detect(
+                object_instance, pObject, value);
             pObject->Present_Value = Binary_Present_Value_Boolean(value);
+            Binary_Value_Columns_Update(pObject);
             status = true;
         }
     }
@@ -528,8 +638,10 @@ static bool Binary_Value_Present_Value_Write(
         if (value <= MAX_BINARY_PV) {
             if (pObject->Write_Enabled) {
                 old_value = Binary_Present_Value(pObject->Present_Value);
-                Binary_Value_Present_Value_COV_Detect(pObject, value);
+                Binary_Value_Present_Value_COV_Detect(
+                    object_instance, pObject, value);
                 pObject->Present_Value = Binary_Present_Value_Boolean(value);
+                Binary_Value_Columns_Update(pObject);
                 if (pObject->Out_Of_Service) {
                     /* The physical point that the object represents
                         is not in service. This means that changes to the
@@ -641,6 +753,7 @@ bool Binary_Value_Polarity_Set(
     pObject = Binary_Value_Object(object_instance);
     if (pObject) {
         pObject->Polarity = Binary_Polarity_Boolean(polarity);
+        Binary_Value_Columns_Update(pObject);
     }
 
     return status;
@@ -821,6 +934,23 @@ static int Binary_Value_Event_Time_Stamps_Encode(
 }
 #endif
 
+/**
+ * @brief Get the Status_Flags of a Binary Value object
+ * @param object_instance - object-instance number of the object
+ * @param bit_string - the Status_Flags
+ */
+static void Binary_Value_Status_Flags(
+    uint32_t object_instance, BACNET_BIT_STRING *bit_string)
+{
+    bitstring_init(bit_string);
+    bitstring_set_bit(bit_string, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(
+        bit_string, STATUS_FLAG_FAULT, Binary_Value_Fault(object_instance));
+    bitstring_set_bit(bit_string, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(bit_string, STATUS_FLAG_OUT_OF_SERVICE,
+        Binary_Value_Out_Of_Service(object_instance));
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -877,13 +1007,7 @@ int Binary_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
         case PROP_STATUS_FLAGS:
             /* note: see the details in the standard on how to use these */
-            bitstring_init(&bit_string);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
-            state = Binary_Value_Fault(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, state);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
-            state = Binary_Value_Out_Of_Service(rpdata->object_instance);
-            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, state);
+            Binary_Value_Status_Flags(rpdata->object_instance, &bit_string);
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
         case PROP_EVENT_STATE:
@@ -1168,6 +1292,83 @@ bool Binary_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
+/**
+ * @brief Get the value of a property of a Binary Value object without
+ *  encoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @return true if the value was copied, or false if the property is
+ *  read with ReadProperty instead
+ */
+bool Binary_Value_Property_Value(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    bool status = true;
+
+    if (!value || (array_index != BACNET_ARRAY_ALL) ||
+        !Binary_Value_Valid_Instance(object_instance)) {
+        return false;
+    }
+    value->context_specific = false;
+    value->next = NULL;
+    switch (object_property) {
+        case PROP_PRESENT_VALUE:
+            value->tag = BACNET_APPLICATION_TAG_ENUMERATED;
+            value->type.Enumerated =
+                Binary_Value_Present_Value(object_instance);
+            break;
+        case PROP_STATUS_FLAGS:
+            value->tag = BACNET_APPLICATION_TAG_BIT_STRING;
+            Binary_Value_Status_Flags(
+                object_instance, &value->type.Bit_String);
+            break;
+        case PROP_OUT_OF_SERVICE:
+            value->tag = BACNET_APPLICATION_TAG_BOOLEAN;
+            value->type.Boolean = Binary_Value_Out_Of_Service(object_instance);
+            break;
+        default:
+            status = false;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set the value of a property of a Binary Value object without
+ *  decoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @param priority - BACnet priority 1..16
+ * @return true if the value was set, or false if the property is
+ *  written with WriteProperty instead, which gives the error
+ */
+bool Binary_Value_Property_Value_Set(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_PROPERTY;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+
+    if (!value || (object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL) ||
+        (value->tag != BACNET_APPLICATION_TAG_ENUMERATED)) {
+        return false;
+    }
+    (void)priority;
+
+    return Binary_Value_Present_Value_Write(object_instance,
+        value->type.Enumerated, &error_class, &error_code);
+}
+
 /**
  * @brief Sets a callback used when present-value is written from BACnet
  * @param cb - callback used to provide indications
@@ -1246,7 +1447,7 @@ uint32_t Binary_Value_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
 #if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
             unsigned j;
@@ -1280,11 +1481,20 @@ uint32_t Binary_Value_Create(uint32_t object_instance)
             /* Set handler for GetAlarmSummary Service */
             handler_get_alarm_summary_set(
                     Object_Type, Binary_Value_Alarm_Summary);
+            /* GetEventInformation and GetAlarmSummary visit only the
+               objects with an active alarm */
+            Alarm_Active_Index_Set(
+                Object_Type, Binary_Value_Instance_To_Index);
 #endif
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
+                return BACNET_MAX_INSTANCE;
+            }
+            if (!Binary_Value_Columns_Add(object_instance, pObject)) {
+                Keylist_Data_Delete(Object_List, object_instance);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1295,6 +1505,30 @@ uint32_t Binary_Value_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Binary Value objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Binary_Value_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Binary_Value_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Initializes the Binary Input object data
  */
@@ -1306,10 +1540,17 @@ void Binary_Value_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
+#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
+        Alarm_Active_Clear(Object_Type);
+#endif
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_cleanup(&Object_Columns);
+#endif
         Object_List = NULL;
     }
 }
@@ -1324,7 +1565,11 @@ bool Binary_Value_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Binary_Value_Columns_Remove(pObject);
+#if defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING)
+        (void)Alarm_Active_Set(Object_Type, object_instance, false);
+#endif
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1338,6 +1583,10 @@ void Binary_Value_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+        columns_init(&Object_Columns);
+#endif
     }
 }
 
@@ -1423,6 +1672,24 @@ static struct object_data *Binary_Value_Object_Index(int index)
 {
     return Keylist_Data_Index(Object_List, index);
 }
+
+/**
+ * @brief Update the entry of an object in the device set of the objects
+ *  with an active alarm, after its Event_State or Acked_Transitions change
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object data
+ */
+static void Binary_Value_Alarm_Active_Update(
+    uint32_t object_instance, struct object_data *pObject)
+{
+    bool active;
+
+    active = (pObject->Event_State != EVENT_STATE_NORMAL) ||
+        !pObject->Acked_Transitions[TRANSITION_TO_OFFNORMAL].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_FAULT].bIsAcked ||
+        !pObject->Acked_Transitions[TRANSITION_TO_NORMAL].bIsAcked;
+    (void)Alarm_Active_Set(Object_Type, object_instance, active);
+}
 #endif
 
 int Binary_Value_Event_Information(
@@ -1593,6 +1860,8 @@ int Binary_Value_Alarm_Ack(
     }
     pObject->Ack_notify_data.bSendAckNotify = true;
     pObject->Ack_notify_data.EventState = alarmack_data->eventStateAcked;
+    Binary_Value_Alarm_Active_Update(
+        alarmack_data->eventObjectIdentifier.instance, pObject);
 
     return 1;
 }
@@ -1904,6 +2173,7 @@ void Binary_Value_Intrinsic_Reporting(uint32_t object_instance)
             }
         }
     }
+    Binary_Value_Alarm_Active_Update(object_instance, pObject);
 #endif /* defined(INTRINSIC_REPORTING) && (BINARY_VALUE_INTRINSIC_REPORTING) */
 }
 
@@ -17,6 +17,7 @@
 #include "bacnet/bacerror.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
+#include "bacnet/basic/sys/columns.h"
 
 #if (INTRINSIC_REPORTING)
 #include "bacnet/basic/object/nc.h"
@@ -91,6 +92,19 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool Binary_Value_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
+    BACNET_STACK_EXPORT
+    bool Binary_Value_Property_Value(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    bool Binary_Value_Property_Value_Set(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        const BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority);
 
     BACNET_STACK_EXPORT
     bool Binary_Value_Encode_Value_List(
@@ -153,6 +167,12 @@ extern "C" {
     uint32_t Binary_Value_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Binary_Value_Create_Bulk(uint32_t object_instance, unsigned count);
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    BACNET_STACK_EXPORT
+    const COLUMNS_STORE *Binary_Value_Columns(void);
+#endif
+    BACNET_STACK_EXPORT
     bool Binary_Value_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
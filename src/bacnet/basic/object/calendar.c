@@ -30,19 +30,29 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/static_pool.h"
 /* me! */
 #include "calendar.h"
 
 struct object_data {
     bool Changed : 1;
     bool Write_Enabled : 1;
+    /* the Present_Value is valid for the Present_Value_Date */
+    bool Present_Value_Valid : 1;
+    /* an entry of the Date_List may be changed through a pointer from
+       Calendar_Date_List_Get(), so the Present_Value is not kept */
+    bool Date_List_Exposed : 1;
     bool Present_Value;
+    BACNET_DATE Present_Value_Date;
     OS_Keylist Date_List;
     const char *Object_Name;
     const char *Description;
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 /* callback for present value writes */
 static calendar_write_present_value_callback
     Calendar_Write_Present_Value_Callback;
@@ -176,7 +186,6 @@ static bool Calendar_Present_Value_Write(
     if (pObject) {
         (void)priority;
         if (pObject->Write_Enabled) {
-            old_value = pObject->Present_Value;
             pObject->Present_Value = value;
             if (Calendar_Write_Present_Value_Callback) {
                 Calendar_Write_Present_Value_Callback(
@@ -204,12 +213,14 @@ static void Calendar_Date_List_Clean(OS_Keylist list)
     void *data;
     while (Keylist_Count(list) > 0) {
         data = Keylist_Data_Pop(list);
-        free(data);
+        bacnet_free(data);
     }
 }
 
 /**
  * For a given object instance-number, returns the Calendar entity by index.
+ * The entity may be changed through the returned pointer, so the
+ * Present_Value is evaluated at each use until the Date_List is deleted.
  *
  * @param  object_instance - object-instance number of the object
  * @param  index - index of entity
@@ -225,6 +236,7 @@ Calendar_Date_List_Get(uint32_t object_instance, uint8_t index)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         entry = Keylist_Data_Index(pObject->Date_List, index);
+        pObject->Date_List_Exposed = true;
     }
 
     return entry;
@@ -250,7 +262,7 @@ bool Calendar_Date_List_Add(
         return false;
     }
 
-    entry = calloc(1, sizeof(BACNET_CALENDAR_ENTRY));
+    entry = bacnet_calloc(1, sizeof(BACNET_CALENDAR_ENTRY));
     if (!entry) {
         return false;
     }
@@ -258,6 +270,7 @@ bool Calendar_Date_List_Add(
     *entry = *value;
     st = Keylist_Data_Add(
         pObject->Date_List, Keylist_Count(pObject->Date_List), entry);
+    pObject->Present_Value_Valid = false;
 
     return st;
 }
@@ -278,6 +291,8 @@ bool Calendar_Date_List_Delete_All(uint32_t object_instance)
     }
 
     Calendar_Date_List_Clean(pObject->Date_List);
+    pObject->Present_Value_Valid = false;
+    pObject->Date_List_Exposed = false;
 
     return true;
 }
@@ -313,13 +328,18 @@ int Calendar_Date_List_Encode(
     uint32_t object_instance, uint8_t *apdu, int max_apdu)
 {
     BACNET_CALENDAR_ENTRY *entry = NULL;
+    struct object_data *pObject;
     int apdu_len = 0;
     unsigned index = 0;
     unsigned size = 0;
 
-    size = Calendar_Date_List_Count(object_instance);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return 0;
+    }
+    size = Keylist_Count(pObject->Date_List);
     for (index = 0; index < size; index++) {
-        entry = Calendar_Date_List_Get(object_instance, index);
+        entry = Keylist_Data_Index(pObject->Date_List, index);
         apdu_len += bacnet_calendar_entry_encode(NULL, entry);
     }
     if (apdu_len > max_apdu) {
@@ -327,39 +347,124 @@ int Calendar_Date_List_Encode(
     }
     apdu_len = 0;
     for (index = 0; index < size; index++) {
-        entry = Calendar_Date_List_Get(object_instance, index);
+        entry = Keylist_Data_Index(pObject->Date_List, index);
         apdu_len += bacnet_calendar_entry_encode(&apdu[apdu_len], entry);
     }
 
     return apdu_len;
 }
 
+/**
+ * @brief Encode one entry of the Date_List
+ * @param object_instance - object-instance number of the object
+ * @param index - 0..N-1 entry of the Date_List
+ * @param apdu - the APDU buffer, or NULL for the length
+ * @return bytes encoded or BACNET_STATUS_ERROR for an invalid index
+ */
+int Calendar_Date_List_Element_Encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu)
+{
+    BACNET_CALENDAR_ENTRY *entry = NULL;
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (index >= (BACNET_ARRAY_INDEX)Keylist_Count(pObject->Date_List)) {
+        return BACNET_STATUS_ERROR;
+    }
+    entry = Keylist_Data_Index(pObject->Date_List, (int)index);
+    if (!entry) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return bacnet_calendar_entry_encode(apdu, entry);
+}
+
+/**
+ * @brief Determine if a property can be read with ReadRange
+ * @param pRequest [in] the ReadRange request
+ * @param pInfo [out] the request types and the elements of the list
+ * @return true if the property can be read with ReadRange
+ */
+bool Calendar_RR_Info(BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo)
+{
+    if (!Calendar_Valid_Instance(pRequest->object_instance)) {
+        pRequest->error_class = ERROR_CLASS_OBJECT;
+        pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+    } else if (pRequest->object_property == PROP_DATE_LIST) {
+        pInfo->RequestTypes = RR_BY_POSITION;
+        pInfo->Handler = NULL;
+        pInfo->Element_Encode = Calendar_Date_List_Element_Encode;
+        pInfo->Element_Count =
+            (uint32_t)Calendar_Date_List_Count(pRequest->object_instance);
+        return true;
+    } else {
+        pRequest->error_class = ERROR_CLASS_SERVICES;
+        pRequest->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+    }
+
+    return false;
+}
+
 /**
  * For a given object instance-number, determines the present-value
+ * for a date. The value is kept for the date, so that it is only
+ * evaluated again on another date or after a change to the Date_List.
  *
  * @param  object_instance - object-instance number of the object
+ * @param  date - the local date
  *
- * @return  present-value of the object
+ * @return  present-value of the object for the date
  */
-bool Calendar_Present_Value(uint32_t object_instance)
+bool Calendar_Present_Value_On_Date(
+    uint32_t object_instance, BACNET_DATE *date)
 {
-    BACNET_DATE date;
-    BACNET_TIME time;
     BACNET_CALENDAR_ENTRY *entry = NULL;
+    struct object_data *pObject;
     unsigned size = 0;
-    int index;
-
-    datetime_local(&date, &time, NULL, NULL);
+    unsigned index;
+    bool value = false;
 
-    size = Calendar_Date_List_Count(object_instance);
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject || !date) {
+        return false;
+    }
+    if (pObject->Present_Value_Valid && !pObject->Date_List_Exposed &&
+        (datetime_compare_date(&pObject->Present_Value_Date, date) == 0)) {
+        return pObject->Present_Value;
+    }
+    size = Keylist_Count(pObject->Date_List);
     for (index = 0; index < size; index++) {
-        entry = Calendar_Date_List_Get(object_instance, index);
-        if (bacapp_date_in_calendar_entry(&date, entry)) {
-            return true;
+        entry = Keylist_Data_Index(pObject->Date_List, index);
+        if (bacapp_date_in_calendar_entry(date, entry)) {
+            value = true;
+            break;
         }
     }
+    pObject->Present_Value = value;
+    datetime_copy_date(&pObject->Present_Value_Date, date);
+    pObject->Present_Value_Valid = true;
 
-    return false;
+    return value;
+}
+
+/**
+ * For a given object instance-number, determines the present-value
+ *
+ * @param  object_instance - object-instance number of the object
+ *
+ * @return  present-value of the object
+ */
+bool Calendar_Present_Value(uint32_t object_instance)
+{
+    BACNET_DATE date;
+    BACNET_TIME time;
+
+    datetime_local(&date, &time, NULL, NULL);
+
+    return Calendar_Present_Value_On_Date(object_instance, &date);
 }
 
 /**
@@ -696,20 +801,22 @@ uint32_t Calendar_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (!pObject) {
             return BACNET_MAX_INSTANCE;
         }
         pObject->Object_Name = NULL;
         pObject->Description = NULL;
         pObject->Present_Value = false;
+        pObject->Present_Value_Valid = false;
+        pObject->Date_List_Exposed = false;
         pObject->Date_List = Keylist_Create();
         pObject->Changed = false;
         pObject->Write_Enabled = false;
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
-            free(pObject);
+            pool_free(&Object_Pool, pObject);
             return BACNET_MAX_INSTANCE;
         }
     }
@@ -717,6 +824,30 @@ uint32_t Calendar_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Calendar objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Calendar_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Calendar_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an Calendar object
  * @param object_instance - object-instance number of the object
@@ -731,7 +862,7 @@ bool Calendar_Delete(uint32_t object_instance)
     if (pObject) {
         Calendar_Date_List_Clean(pObject->Date_List);
         Keylist_Delete(pObject->Date_List);
-        free(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -751,10 +882,11 @@ void Calendar_Cleanup(void)
             if (pObject) {
                 Calendar_Date_List_Clean(pObject->Date_List);
                 Keylist_Delete(pObject->Date_List);
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -766,5 +898,6 @@ void Calendar_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
@@ -15,6 +15,7 @@
 /* BACnet Stack API */
 #include "bacnet/calendar_entry.h"
 #include "bacnet/bacerror.h"
+#include "bacnet/readrange.h"
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 
@@ -58,6 +59,9 @@ bool Calendar_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
 BACNET_STACK_EXPORT
 bool Calendar_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Calendar_Present_Value_On_Date(
+    uint32_t object_instance, BACNET_DATE *date);
+BACNET_STACK_EXPORT
 void Calendar_Write_Present_Value_Callback_Set(
     calendar_write_present_value_callback cb);
 
@@ -74,6 +78,11 @@ int Calendar_Date_List_Count(uint32_t object_instance);
 BACNET_STACK_EXPORT
 int Calendar_Date_List_Encode(
     uint32_t object_instance, uint8_t *apdu, int max_apdu);
+BACNET_STACK_EXPORT
+int Calendar_Date_List_Element_Encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu);
+BACNET_STACK_EXPORT
+bool Calendar_RR_Info(BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo);
 
 BACNET_STACK_EXPORT
 char *Calendar_Description(uint32_t object_instance);
@@ -90,6 +99,8 @@ void Calendar_Write_Disable(uint32_t instance);
 BACNET_STACK_EXPORT
 uint32_t Calendar_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+unsigned Calendar_Create_Bulk(uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 bool Calendar_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Calendar_Cleanup(void);
@@ -20,6 +20,8 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/proplist.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/object/device.h"
 #if defined(CHANNEL_LIGHTING_COMMAND) || defined(CHANNEL_COLOR_COMMAND)
 #include "bacnet/lighting.h"
 #endif
@@ -40,6 +42,8 @@ struct object_data {
     unsigned Last_Priority;
     BACNET_WRITE_STATUS Write_Status;
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE Members[CHANNEL_MEMBERS_MAX];
+    /* the result of the last write of each member */
+    BACNET_WRITE_STATUS Member_Write_Status[CHANNEL_MEMBERS_MAX];
     uint16_t Number;
     uint32_t Control_Groups[CONTROL_GROUPS_MAX];
     const char *Object_Name;
@@ -48,8 +52,14 @@ struct object_data {
 
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 
 static write_property_function Write_Property_Internal_Callback;
+/* sends the writes of the members that are in another device */
+static channel_write_members_function Write_Members_Remote_Callback;
+/* the writes of the members of one remote device */
+static BACNET_WRITE_PROPERTY_DATA Write_Members_Remote[CHANNEL_MEMBERS_MAX];
 
 /* These arrays are used by the ReadPropertyMultiple handler
    property-list property (as of protocol-revision 14) */
@@ -1180,61 +1190,241 @@ bool Channel_Write_Member_Value(
     return status;
 }
 
+/**
+ * @brief Update the Write_Status of a channel from the results of the
+ *  writes of its members
+ * @param pObject - object instance data
+ */
+static void Channel_Write_Status_Update(struct object_data *pObject)
+{
+    bool failed = false;
+    unsigned m;
+
+    for (m = 0; m < CHANNEL_MEMBERS_MAX; m++) {
+        if (pObject->Member_Write_Status[m] ==
+            BACNET_WRITE_STATUS_IN_PROGRESS) {
+            pObject->Write_Status = BACNET_WRITE_STATUS_IN_PROGRESS;
+            return;
+        }
+        if (pObject->Member_Write_Status[m] == BACNET_WRITE_STATUS_FAILED) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        pObject->Write_Status = BACNET_WRITE_STATUS_FAILED;
+    } else {
+        pObject->Write_Status = BACNET_WRITE_STATUS_SUCCESSFUL;
+    }
+}
+
+/**
+ * @brief Load the WriteProperty data of a member of a channel
+ * @param wp_data - the WriteProperty data that is loaded
+ * @param pMember - the member
+ * @param value - application value
+ * @param priority - BACnet priority 0=none,1..16
+ * @return true if the value was coerced to the datatype of the member
+ */
+static bool Channel_Write_Member_Data(BACNET_WRITE_PROPERTY_DATA *wp_data,
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    wp_data->object_type = pMember->objectIdentifier.type;
+    wp_data->object_instance = pMember->objectIdentifier.instance;
+    wp_data->object_property = pMember->propertyIdentifier;
+    wp_data->array_index = pMember->arrayIndex;
+    wp_data->priority = priority;
+    wp_data->application_data_len = sizeof(wp_data->application_data);
+
+    return Channel_Write_Member_Value(wp_data, value);
+}
+
 /**
  * For a given object instance-number, sets the present-value at a given
  * priority 1..16.
  *
+ * The members in this device are written at once. When a remote callback
+ * is set, the members in other devices are grouped by device, and the
+ * callback is given the writes of each device together, so that it can
+ * send them in one WritePropertyMultiple request, and the requests of
+ * all the devices are outstanding at the same time. Their results are
+ * given with Channel_Write_Members_Device_Status_Set().
+ *
+ * @param object_instance - object-instance number of the object
  * @param pObject - object instance data
  * @param value - application value
  * @param priority - BACnet priority 0=none,1..16
  *
  * @return  true if values are within range and present-value is sent.
  */
-static bool Channel_Write_Members(struct object_data *pObject,
+static bool Channel_Write_Members(uint32_t object_instance,
+    struct object_data *pObject,
     BACNET_APPLICATION_DATA_VALUE *value,
     uint8_t priority)
 {
     BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
     bool status = false;
-    unsigned m = 0;
+    bool remote[CHANNEL_MEMBERS_MAX] = { false };
+    uint32_t my_device_id, device_id;
+    unsigned m = 0, n = 0, count = 0;
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember = NULL;
 
     if (pObject && value) {
         pObject->Write_Status = BACNET_WRITE_STATUS_IN_PROGRESS;
+        my_device_id = Device_Object_Instance_Number();
         for (m = 0; m < CHANNEL_MEMBERS_MAX; m++) {
+            pObject->Member_Write_Status[m] = BACNET_WRITE_STATUS_IDLE;
             pMember = &pObject->Members[m];
-            /* NOTE: our implementation is for internal objects only */
-            /* NOTE: we could check to match our Device ID, but then
-               we would need to update all channels when our device ID
-               changed.  Instead, we'll just screen when members are
-               set. */
+            /* NOTE: without a remote callback, every member is written
+               as an internal object. We could check to match our Device
+               ID, but then we would need to update all channels when our
+               device ID changed.  Instead, we'll just screen when members
+               are set. */
             if ((pMember->deviceIdentifier.type == OBJECT_DEVICE) &&
                 (pMember->deviceIdentifier.instance != BACNET_MAX_INSTANCE) &&
                 (pMember->objectIdentifier.instance != BACNET_MAX_INSTANCE)) {
-                wp_data.object_type = pMember->objectIdentifier.type;
-                wp_data.object_instance = pMember->objectIdentifier.instance;
-                wp_data.object_property = pMember->propertyIdentifier;
-                wp_data.array_index = pMember->arrayIndex;
-                wp_data.priority = priority;
-                wp_data.application_data_len = sizeof(wp_data.application_data);
-                status = Channel_Write_Member_Value(&wp_data, value);
+                if (Write_Members_Remote_Callback &&
+                    (pMember->deviceIdentifier.instance != my_device_id)) {
+                    remote[m] = true;
+                    continue;
+                }
+                status = Channel_Write_Member_Data(
+                    &wp_data, pMember, value, priority);
                 if (status) {
                     if (Write_Property_Internal_Callback) {
                         status = Write_Property_Internal_Callback(&wp_data);
                     }
+                }
+                if (status) {
+                    pObject->Member_Write_Status[m] =
+                        BACNET_WRITE_STATUS_SUCCESSFUL;
                 } else {
-                    pObject->Write_Status = BACNET_WRITE_STATUS_FAILED;
+                    pObject->Member_Write_Status[m] =
+                        BACNET_WRITE_STATUS_FAILED;
                 }
             }
         }
-        if (pObject->Write_Status == BACNET_WRITE_STATUS_IN_PROGRESS) {
-            pObject->Write_Status = BACNET_WRITE_STATUS_SUCCESSFUL;
+        /* one request for the members of each remote device */
+        for (m = 0; m < CHANNEL_MEMBERS_MAX; m++) {
+            if (!remote[m]) {
+                continue;
+            }
+            device_id = pObject->Members[m].deviceIdentifier.instance;
+            count = 0;
+            for (n = m; n < CHANNEL_MEMBERS_MAX; n++) {
+                pMember = &pObject->Members[n];
+                if (!remote[n] ||
+                    (pMember->deviceIdentifier.instance != device_id)) {
+                    continue;
+                }
+                remote[n] = false;
+                if (Channel_Write_Member_Data(&Write_Members_Remote[count],
+                        pMember, value, priority)) {
+                    pObject->Member_Write_Status[n] =
+                        BACNET_WRITE_STATUS_IN_PROGRESS;
+                    count++;
+                } else {
+                    pObject->Member_Write_Status[n] =
+                        BACNET_WRITE_STATUS_FAILED;
+                }
+            }
+            if (count == 0) {
+                continue;
+            }
+            status = Write_Members_Remote_Callback(
+                object_instance, device_id, Write_Members_Remote, count);
+            if (!status) {
+                (void)Channel_Write_Members_Device_Status_Set(
+                    object_instance, device_id, BACNET_WRITE_STATUS_FAILED);
+            }
         }
+        Channel_Write_Status_Update(pObject);
     }
 
     return status;
 }
 
+/**
+ * @brief Set the result of the writes of the members of a channel that
+ *  are in a remote device, such as from the acknowledgement or error of
+ *  a WritePropertyMultiple request
+ * @param object_instance - object-instance number of the channel
+ * @param device_id - device instance of the members
+ * @param status - BACNET_WRITE_STATUS_SUCCESSFUL or
+ *  BACNET_WRITE_STATUS_FAILED
+ * @return number of members whose write was in progress
+ */
+unsigned Channel_Write_Members_Device_Status_Set(uint32_t object_instance,
+    uint32_t device_id,
+    BACNET_WRITE_STATUS status)
+{
+    struct object_data *pObject;
+    unsigned count = 0;
+    unsigned m;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return 0;
+    }
+    for (m = 0; m < CHANNEL_MEMBERS_MAX; m++) {
+        if ((pObject->Member_Write_Status[m] ==
+                BACNET_WRITE_STATUS_IN_PROGRESS) &&
+            (pObject->Members[m].deviceIdentifier.instance == device_id)) {
+            pObject->Member_Write_Status[m] = status;
+            count++;
+        }
+    }
+    Channel_Write_Status_Update(pObject);
+
+    return count;
+}
+
+/**
+ * @brief Set the result of the write of one member of a channel, such as
+ *  the member named by the error of a WritePropertyMultiple request
+ * @param object_instance - object-instance number of the channel
+ * @param array_index - 1-based array index of the member
+ * @param status - the result of the write
+ * @return true if the member exists
+ */
+bool Channel_Write_Member_Status_Set(uint32_t object_instance,
+    unsigned array_index,
+    BACNET_WRITE_STATUS status)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject || (array_index == 0) ||
+        (array_index > CHANNEL_MEMBERS_MAX)) {
+        return false;
+    }
+    pObject->Member_Write_Status[array_index - 1] = status;
+    Channel_Write_Status_Update(pObject);
+
+    return true;
+}
+
+/**
+ * @brief Get the result of the last write of one member of a channel
+ * @param object_instance - object-instance number of the channel
+ * @param array_index - 1-based array index of the member
+ * @return the result of the write, or IDLE if the member was not written
+ */
+BACNET_WRITE_STATUS Channel_Write_Member_Status(
+    uint32_t object_instance, unsigned array_index)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject || (array_index == 0) ||
+        (array_index > CHANNEL_MEMBERS_MAX)) {
+        return BACNET_WRITE_STATUS_IDLE;
+    }
+
+    return pObject->Member_Write_Status[array_index - 1];
+}
+
 /**
  * For a given object instance-number, sets the present-value at a given
  * priority 1..16.
@@ -1256,8 +1446,8 @@ bool Channel_Present_Value_Set(
             if (wp_data->priority != 6 /* reserved */) {
                 status = Channel_Value_Copy(&pObject->Present_Value, value);
                 (void)status;
-                status =
-                    Channel_Write_Members(pObject, value, wp_data->priority);
+                status = Channel_Write_Members(wp_data->object_instance,
+                    pObject, value, wp_data->priority);
                 (void)status;
                 status = true;
             } else {
@@ -1638,6 +1828,17 @@ void Channel_Write_Property_Internal_Callback_Set(write_property_function cb)
     Write_Property_Internal_Callback = cb;
 }
 
+/**
+ * @brief Sets a callback used to send the writes of the members that are
+ *  in another device. Without it, every member is written internally.
+ * @param cb - callback used to send the writes of one device
+ */
+void Channel_Write_Members_Remote_Callback_Set(
+    channel_write_members_function cb)
+{
+    Write_Members_Remote_Callback = cb;
+}
+
 /**
  * @brief Creates a new object
  * @param object_instance - object-instance number of the object
@@ -1661,7 +1862,7 @@ uint32_t Channel_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             /* channel defaults */
             pObject->Object_Name = NULL;
@@ -1679,6 +1880,7 @@ uint32_t Channel_Create(uint32_t object_instance)
                 pObject->Members[m].deviceIdentifier.type = OBJECT_DEVICE;
                 pObject->Members[m].deviceIdentifier.instance =
                     BACNET_MAX_INSTANCE;
+                pObject->Member_Write_Status[m] = BACNET_WRITE_STATUS_IDLE;
             }
             pObject->Number = 0;
             for (g = 0; g < CONTROL_GROUPS_MAX; g++) {
@@ -1687,7 +1889,7 @@ uint32_t Channel_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1698,6 +1900,30 @@ uint32_t Channel_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Channel objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Channel_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Channel_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes a dynamically created object
  * @param object_instance - object-instance number of the object
@@ -1710,7 +1936,7 @@ bool Channel_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1728,10 +1954,11 @@ void Channel_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -1743,5 +1970,6 @@ void Channel_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
@@ -44,6 +44,22 @@
 #define CHANNEL_XY_COLOR
 #endif
 
+/**
+ * @brief Callback to send the writes of the members of a channel that are
+ *  in one remote device, such as in one WritePropertyMultiple request.
+ *  The writes are only valid during the call.
+ * @param object_instance - object-instance number of the channel
+ * @param device_id - device instance of the members
+ * @param wp_data - the writes, with the values encoded for the members
+ * @param count - number of writes
+ * @return true if the request was sent, and its result will be given
+ *  with Channel_Write_Members_Device_Status_Set()
+ */
+typedef bool (*channel_write_members_function)(uint32_t object_instance,
+    uint32_t device_id,
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    unsigned count);
+
 typedef struct BACnet_Channel_Value_t {
     uint8_t tag;
     union {
@@ -181,10 +197,26 @@ bool Channel_Write_Member_Value(
 BACNET_STACK_EXPORT
 void Channel_Write_Property_Internal_Callback_Set(
     write_property_function cb);
+BACNET_STACK_EXPORT
+void Channel_Write_Members_Remote_Callback_Set(
+    channel_write_members_function cb);
+BACNET_STACK_EXPORT
+unsigned Channel_Write_Members_Device_Status_Set(uint32_t object_instance,
+    uint32_t device_id,
+    BACNET_WRITE_STATUS status);
+BACNET_STACK_EXPORT
+bool Channel_Write_Member_Status_Set(uint32_t object_instance,
+    unsigned array_index,
+    BACNET_WRITE_STATUS status);
+BACNET_STACK_EXPORT
+BACNET_WRITE_STATUS Channel_Write_Member_Status(
+    uint32_t object_instance, unsigned array_index);
 
 BACNET_STACK_EXPORT
 uint32_t Channel_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+unsigned Channel_Create_Bulk(uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 bool Channel_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Channel_Cleanup(void);
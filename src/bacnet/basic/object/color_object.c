@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 /* BACnet Stack defines - first */
@@ -29,7 +30,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
-#include "bacnet/basic/sys/linear.h"
+#include "bacnet/basic/sys/pool.h"
 /* me! */
 #include "bacnet/basic/object/color_object.h"
 
@@ -55,9 +56,29 @@ struct object_data {
     BACNET_COLOR_TRANSITION Transition;
     const char *Object_Name;
     const char *Description;
+    /* the object is in the list of active transitions */
+    bool Transition_Active : 1;
+    /* a fade of the Tracking_Value, in fixed point */
+    int32_t Transition_Start_X;
+    int32_t Transition_Start_Y;
+    int32_t Transition_Target_X;
+    int32_t Transition_Target_Y;
+    uint32_t Transition_Duration;
+    uint32_t Transition_Elapsed;
+    /* the list of active transitions */
+    uint32_t Instance;
+    struct object_data *Transition_Next;
+    struct object_data *Transition_Prev;
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+/* the objects that are fading, so that the timer only has work
+   to do for them, and not for the idle objects */
+static struct object_data *Transition_List;
+/* coordinates of the transitions in fixed point, in millionths */
+#define COLOR_XY_SCALE 1000000L
 /* callback for present value writes */
 static color_write_present_value_callback Color_Write_Present_Value_Callback;
 
@@ -202,6 +223,93 @@ bool Color_Present_Value_Set(uint32_t object_instance, BACNET_XY_COLOR *value)
     return status;
 }
 
+/**
+ * @brief Convert a coordinate to fixed point
+ * @param value - CIE xy coordinate
+ * @return coordinate in millionths
+ */
+static int32_t Color_XY_Fixed(float value)
+{
+    if (isless(value, 0.0f)) {
+        return -(int32_t)((-value * COLOR_XY_SCALE) + 0.5f);
+    }
+
+    return (int32_t)((value * COLOR_XY_SCALE) + 0.5f);
+}
+
+/**
+ * @brief Remove an object from the list of active transitions
+ * @param pObject - object to remove
+ */
+static void Color_Transition_Remove(struct object_data *pObject)
+{
+    if (!pObject->Transition_Active) {
+        return;
+    }
+    if (pObject->Transition_Prev) {
+        pObject->Transition_Prev->Transition_Next = pObject->Transition_Next;
+    } else {
+        Transition_List = pObject->Transition_Next;
+    }
+    if (pObject->Transition_Next) {
+        pObject->Transition_Next->Transition_Prev = pObject->Transition_Prev;
+    }
+    pObject->Transition_Next = NULL;
+    pObject->Transition_Prev = NULL;
+    pObject->Transition_Active = false;
+}
+
+/**
+ * @brief Add an object to the list of active transitions
+ * @param pObject - object to add
+ */
+static void Color_Transition_Add(struct object_data *pObject)
+{
+    if (pObject->Transition_Active) {
+        return;
+    }
+    pObject->Transition_Prev = NULL;
+    pObject->Transition_Next = Transition_List;
+    if (Transition_List) {
+        Transition_List->Transition_Prev = pObject;
+    }
+    Transition_List = pObject;
+    pObject->Transition_Active = true;
+}
+
+/**
+ * @brief Start the transition of the Tracking_Value of an object for the
+ *  operation of its Color_Command, from the current Tracking_Value
+ * @param pObject - object whose Color_Command was set
+ */
+static void Color_Transition_Start(struct object_data *pObject)
+{
+    switch (pObject->Color_Command.operation) {
+        case BACNET_COLOR_OPERATION_FADE_TO_COLOR:
+            pObject->Transition_Start_X =
+                Color_XY_Fixed(pObject->Tracking_Value.x_coordinate);
+            pObject->Transition_Start_Y =
+                Color_XY_Fixed(pObject->Tracking_Value.y_coordinate);
+            pObject->Transition_Target_X = Color_XY_Fixed(
+                pObject->Color_Command.target.color.x_coordinate);
+            pObject->Transition_Target_Y = Color_XY_Fixed(
+                pObject->Color_Command.target.color.y_coordinate);
+            pObject->Transition_Duration =
+                pObject->Color_Command.transit.fade_time;
+            pObject->Transition_Elapsed = 0;
+            Color_Transition_Add(pObject);
+            break;
+        case BACNET_COLOR_OPERATION_NONE:
+        case BACNET_COLOR_OPERATION_STOP:
+            pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
+            Color_Transition_Remove(pObject);
+            break;
+        default:
+            Color_Transition_Remove(pObject);
+            break;
+    }
+}
+
 /**
  * For a given object instance-number, writes to the present-value
  *
@@ -235,6 +343,7 @@ static bool Color_Present_Value_Write(uint32_t object_instance,
         }
         pObject->Color_Command.operation = BACNET_COLOR_OPERATION_FADE_TO_COLOR;
         xy_color_copy(&pObject->Color_Command.target.color, value);
+        Color_Transition_Start(pObject);
         status = true;
     } else {
         *error_class = ERROR_CLASS_OBJECT;
@@ -281,6 +390,11 @@ bool Color_Tracking_Value_Set(uint32_t object_instance, BACNET_XY_COLOR *value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         xy_color_copy(&pObject->Tracking_Value, value);
+        if (pObject->Transition_Active) {
+            /* fade from the new value in the remaining fade time */
+            Color_Transition_Remove(pObject);
+            Color_Transition_Start(pObject);
+        }
         status = true;
     }
 
@@ -323,6 +437,8 @@ bool Color_Command_Set(uint32_t object_instance, BACNET_COLOR_COMMAND *value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && value) {
         color_command_copy(&pObject->Color_Command, value);
+        Color_Transition_Remove(pObject);
+        Color_Transition_Start(pObject);
         status = true;
     }
 
@@ -354,6 +470,8 @@ static bool Color_Command_Write(uint32_t object_instance,
         (void)priority;
         if (pObject->Write_Enabled) {
             color_command_copy(&pObject->Color_Command, value);
+            Color_Transition_Remove(pObject);
+            Color_Transition_Start(pObject);
             status = true;
         } else {
             *error_class = ERROR_CLASS_PROPERTY;
@@ -778,57 +896,46 @@ bool Color_Description_Set(uint32_t object_instance, char *new_name)
  * currently in progress and the Present_Value is written,
  * the color command shall be halted.
  *
- * @param  object_instance - object-instance number of the object
+ * @param pObject - object that is fading
  * @param milliseconds - number of milliseconds elapsed
  */
 static void Color_Fade_To_Color_Handler(
-    uint32_t object_instance, uint16_t milliseconds)
+    struct object_data *pObject, uint16_t milliseconds)
 {
     BACNET_XY_COLOR old_value;
-    struct object_data *pObject;
-    float x1, x2, x3, y1, y3;
+    int64_t x, y;
 
-    pObject = Keylist_Data(Object_List, object_instance);
-    if (!pObject) {
-        return;
-    }
     xy_color_copy(&old_value, &pObject->Tracking_Value);
-    if (milliseconds >= pObject->Color_Command.transit.fade_time) {
+    pObject->Transition_Elapsed += milliseconds;
+    if ((pObject->Transition_Elapsed >= pObject->Transition_Duration) ||
+        ((pObject->Transition_Start_X == pObject->Transition_Target_X) &&
+            (pObject->Transition_Start_Y == pObject->Transition_Target_Y))) {
         /* stop fading */
         xy_color_copy(
             &pObject->Tracking_Value, &pObject->Color_Command.target.color);
         pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
         pObject->Color_Command.operation = BACNET_COLOR_OPERATION_STOP;
         pObject->Color_Command.transit.fade_time = 0;
+        Color_Transition_Remove(pObject);
     } else {
-        if (xy_color_same(&old_value, &pObject->Color_Command.target.color)) {
-            /* stop fading */
-            xy_color_copy(
-                &pObject->Tracking_Value, &pObject->Color_Command.target.color);
-            pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
-            pObject->Color_Command.operation = BACNET_COLOR_OPERATION_STOP;
-            pObject->Color_Command.transit.fade_time = 0;
-        } else {
-            /* fading */
-            x1 = 0.0f;
-            x2 = (float)milliseconds;
-            x3 = (float)pObject->Color_Command.transit.fade_time;
-            y1 = old_value.x_coordinate;
-            y3 = pObject->Color_Command.target.color.x_coordinate;
-            pObject->Tracking_Value.x_coordinate = linear_interpolate(x1, x2, 
-                x3, y1, y3);
-            y1 = old_value.y_coordinate;
-            y3 = pObject->Color_Command.target.color.y_coordinate;
-            pObject->Tracking_Value.y_coordinate = linear_interpolate(x1, x2, 
-                x3, y1, y3);
-            pObject->Color_Command.transit.fade_time -= milliseconds;
-            pObject->In_Progress =
-                BACNET_COLOR_OPERATION_IN_PROGRESS_FADE_ACTIVE;
-        }
+        /* fading */
+        x = (int64_t)pObject->Transition_Target_X -
+            pObject->Transition_Start_X;
+        x = (x * pObject->Transition_Elapsed) / pObject->Transition_Duration;
+        x += pObject->Transition_Start_X;
+        y = (int64_t)pObject->Transition_Target_Y -
+            pObject->Transition_Start_Y;
+        y = (y * pObject->Transition_Elapsed) / pObject->Transition_Duration;
+        y += pObject->Transition_Start_Y;
+        pObject->Tracking_Value.x_coordinate = (float)x / COLOR_XY_SCALE;
+        pObject->Tracking_Value.y_coordinate = (float)y / COLOR_XY_SCALE;
+        pObject->Color_Command.transit.fade_time =
+            pObject->Transition_Duration - pObject->Transition_Elapsed;
+        pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_FADE_ACTIVE;
     }
     if (Color_Write_Present_Value_Callback) {
         Color_Write_Present_Value_Callback(
-            object_instance, &old_value, &pObject->Tracking_Value);
+            pObject->Instance, &old_value, &pObject->Tracking_Value);
     }
 }
 
@@ -849,8 +956,10 @@ void Color_Timer(uint32_t object_instance, uint16_t milliseconds)
                 pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
                 break;
             case BACNET_COLOR_OPERATION_FADE_TO_COLOR:
-                Color_Fade_To_Color_Handler(
-                    object_instance, milliseconds);
+                if (!pObject->Transition_Active) {
+                    Color_Transition_Start(pObject);
+                }
+                Color_Fade_To_Color_Handler(pObject, milliseconds);
                 break;
             case BACNET_COLOR_OPERATION_STOP:
                 pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
@@ -861,6 +970,44 @@ void Color_Timer(uint32_t object_instance, uint16_t milliseconds)
     }
 }
 
+/**
+ * @brief Updates the tracking value of each color object that is
+ *  fading, in one pass of the fixed point transitions, without looking
+ *  at the idle objects. Use this instead of calling Color_Timer() for
+ *  each object.
+ * @param milliseconds - number of milliseconds elapsed since previously
+ * called.  Suggest that this is called every 10 milliseconds.
+ */
+void Color_Timer_Active(uint16_t milliseconds)
+{
+    struct object_data *pObject, *pNext;
+
+    pObject = Transition_List;
+    while (pObject) {
+        /* the object leaves the list at the end of its transition */
+        pNext = pObject->Transition_Next;
+        Color_Fade_To_Color_Handler(pObject, milliseconds);
+        pObject = pNext;
+    }
+}
+
+/**
+ * @brief Get the number of color objects that are fading
+ * @return number of objects in an active transition
+ */
+unsigned Color_Timer_Active_Count(void)
+{
+    struct object_data *pObject;
+    unsigned count = 0;
+
+    for (pObject = Transition_List; pObject;
+         pObject = pObject->Transition_Next) {
+        count++;
+    }
+
+    return count;
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -1133,7 +1280,7 @@ uint32_t Color_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             /* color defaults */
@@ -1148,6 +1295,9 @@ uint32_t Color_Create(uint32_t object_instance)
                 BACNET_COLOR_OPERATION_FADE_TO_COLOR;
             pObject->Color_Command.transit.fade_time =
                 pObject->Default_Fade_Time;
+            pObject->Instance = object_instance;
+            pObject->Transition_Active = false;
+            Color_Transition_Start(pObject);
             /* initialize all the status */
             pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
             pObject->Transition = BACNET_COLOR_TRANSITION_FADE;
@@ -1156,7 +1306,8 @@ uint32_t Color_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Color_Transition_Remove(pObject);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1167,6 +1318,30 @@ uint32_t Color_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Color objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Color_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Color_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an Color object
  * @param object_instance - object-instance number of the object
@@ -1179,7 +1354,8 @@ bool Color_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Color_Transition_Remove(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1197,12 +1373,14 @@ void Color_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
+    Transition_List = NULL;
 }
 
 /**
@@ -1212,5 +1390,6 @@ void Color_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
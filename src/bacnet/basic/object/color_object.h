@@ -110,10 +110,16 @@ void Color_Write_Disable(uint32_t instance);
 
 BACNET_STACK_EXPORT
 void Color_Timer(uint32_t object_instance, uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void Color_Timer_Active(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+unsigned Color_Timer_Active_Count(void);
 
 BACNET_STACK_EXPORT
 uint32_t Color_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+unsigned Color_Create_Bulk(uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 bool Color_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Color_Cleanup(void);
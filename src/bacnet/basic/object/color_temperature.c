@@ -28,7 +28,7 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
-#include "bacnet/basic/sys/linear.h"
+#include "bacnet/basic/sys/pool.h"
 /* me! */
 #include "color_temperature.h"
 
@@ -48,9 +48,25 @@ struct object_data {
     uint32_t Present_Value_Maximum;
     const char *Object_Name;
     const char *Description;
+    /* the object is in the list of active transitions */
+    bool Transition_Active : 1;
+    /* a fade or ramp of the Tracking_Value, in Kelvin */
+    int32_t Transition_Start;
+    int32_t Transition_Target;
+    uint32_t Transition_Duration;
+    uint32_t Transition_Elapsed;
+    /* the list of active transitions */
+    uint32_t Instance;
+    struct object_data *Transition_Next;
+    struct object_data *Transition_Prev;
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+/* the objects that are fading, ramping, or stepping, so that the timer
+   only has work to do for them, and not for the idle objects */
+static struct object_data *Transition_List;
 /* callback for present value writes */
 static color_temperature_write_present_value_callback
     Color_Temperature_Write_Present_Value_Callback;
@@ -197,6 +213,107 @@ bool Color_Temperature_Present_Value_Set(
     return status;
 }
 
+/**
+ * @brief Remove an object from the list of active transitions
+ * @param pObject - object to remove
+ */
+static void Color_Temperature_Transition_Remove(struct object_data *pObject)
+{
+    if (!pObject->Transition_Active) {
+        return;
+    }
+    if (pObject->Transition_Prev) {
+        pObject->Transition_Prev->Transition_Next = pObject->Transition_Next;
+    } else {
+        Transition_List = pObject->Transition_Next;
+    }
+    if (pObject->Transition_Next) {
+        pObject->Transition_Next->Transition_Prev = pObject->Transition_Prev;
+    }
+    pObject->Transition_Next = NULL;
+    pObject->Transition_Prev = NULL;
+    pObject->Transition_Active = false;
+}
+
+/**
+ * @brief Add an object to the list of active transitions
+ * @param pObject - object to add
+ */
+static void Color_Temperature_Transition_Add(struct object_data *pObject)
+{
+    if (pObject->Transition_Active) {
+        return;
+    }
+    pObject->Transition_Prev = NULL;
+    pObject->Transition_Next = Transition_List;
+    if (Transition_List) {
+        Transition_List->Transition_Prev = pObject;
+    }
+    Transition_List = pObject;
+    pObject->Transition_Active = true;
+}
+
+/**
+ * @brief Start the transition of the Tracking_Value of an object for the
+ *  operation of its Color_Command, from the current Tracking_Value.
+ *  A ramp is a fade whose duration follows from its ramp-rate, and
+ *  the target-color-temperature is clamped to Min_Pres_Value and
+ *  Max_Pres_Value.
+ * @param pObject - object whose Color_Command was set
+ */
+static void Color_Temperature_Transition_Start(struct object_data *pObject)
+{
+    uint32_t target_value, rate;
+    int32_t delta;
+
+    Color_Temperature_Transition_Remove(pObject);
+    switch (pObject->Color_Command.operation) {
+        case BACNET_COLOR_OPERATION_FADE_TO_CCT:
+        case BACNET_COLOR_OPERATION_RAMP_TO_CCT:
+            target_value = pObject->Color_Command.target.color_temperature;
+            if (target_value > pObject->Present_Value_Maximum) {
+                target_value = pObject->Present_Value_Maximum;
+            }
+            if (target_value < pObject->Present_Value_Minimum) {
+                target_value = pObject->Present_Value_Minimum;
+            }
+            pObject->Transition_Start = (int32_t)pObject->Tracking_Value;
+            pObject->Transition_Target = (int32_t)target_value;
+            if (pObject->Color_Command.operation ==
+                BACNET_COLOR_OPERATION_FADE_TO_CCT) {
+                pObject->Transition_Duration =
+                    pObject->Color_Command.transit.fade_time;
+            } else {
+                delta = pObject->Transition_Target - pObject->Transition_Start;
+                if (delta < 0) {
+                    delta = -delta;
+                }
+                /* Kelvin per second, rounded up so that the ramp is not
+                   faster than its rate */
+                rate = pObject->Color_Command.transit.ramp_rate;
+                if (rate > 0) {
+                    pObject->Transition_Duration =
+                        (((uint32_t)delta * 1000UL) + rate - 1) / rate;
+                } else {
+                    pObject->Transition_Duration = 0;
+                }
+            }
+            pObject->Transition_Elapsed = 0;
+            Color_Temperature_Transition_Add(pObject);
+            break;
+        case BACNET_COLOR_OPERATION_STEP_UP_CCT:
+        case BACNET_COLOR_OPERATION_STEP_DOWN_CCT:
+            /* stepped at the next timer */
+            Color_Temperature_Transition_Add(pObject);
+            break;
+        case BACNET_COLOR_OPERATION_NONE:
+        case BACNET_COLOR_OPERATION_STOP:
+        default:
+            pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
+            break;
+    }
+}
+
 /**
  * For a given object instance-number, sets the present-value
  *
@@ -240,6 +357,7 @@ static bool Color_Temperature_Present_Value_Write(uint32_t object_instance,
                     BACNET_COLOR_OPERATION_FADE_TO_CCT;
             }
             pObject->Color_Command.target.color_temperature = value;
+            Color_Temperature_Transition_Start(pObject);
             status = true;
         } else {
             *error_class = ERROR_CLASS_PROPERTY;
@@ -418,6 +536,7 @@ bool Color_Temperature_Command_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && value) {
         color_command_copy(&pObject->Color_Command, value);
+        Color_Temperature_Transition_Start(pObject);
         status = true;
     }
 
@@ -1006,143 +1125,60 @@ bool Color_Temperature_Description_Set(uint32_t object_instance, char *new_name)
 }
 
 /**
- * Updates the color object tracking value while fading
+ * Updates the color object tracking value while fading or ramping
  *
  * The fade operation changes the output color temperature
  * from its current value to target-color-temperature, over
  * a period of time defined by fade-time. While the fade
  * operation is executing, In_Progress shall be set to FADE_ACTIVE,
  * and Tracking_Value shall be updated to reflect the current
- * progress of the fade. <target-color-temperature> shall be clamped
- * to Min_Pres_Value and Max_Pres_Value
+ * progress of the fade. The ramp operation changes the output color
+ * temperature at a particular Kelvin per second defined by ramp-rate,
+ * and sets In_Progress to RAMP_ACTIVE.
  *
- * @param  object_instance - object-instance number of the object
+ * @param pObject - object that is fading or ramping
  * @param milliseconds - number of milliseconds elapsed
  */
-static void Color_Temperature_Fade_To_CCT_Handler(
-    uint32_t object_instance, uint16_t milliseconds)
+static void Color_Temperature_Transition_Handler(
+    struct object_data *pObject, uint16_t milliseconds)
 {
-    uint32_t old_value, target_value, min_value, max_value;
-    struct object_data *pObject;
+    uint32_t old_value;
+    int64_t value;
 
-    pObject = Keylist_Data(Object_List, object_instance);
-    if (!pObject) {
-        return;
-    }
     old_value = pObject->Tracking_Value;
-    min_value = pObject->Present_Value_Minimum;
-    max_value = pObject->Present_Value_Maximum;
-    target_value = pObject->Color_Command.target.color_temperature;
-    /* clamp target within min/max, if needed */
-    if (target_value > max_value) {
-        target_value = max_value;
-    }
-    if (target_value < min_value) {
-        target_value = min_value;
-    }
-    if (milliseconds >= pObject->Color_Command.transit.fade_time) {
-        /* done fading */
-        pObject->Tracking_Value = target_value;
+    pObject->Transition_Elapsed += milliseconds;
+    if ((pObject->Transition_Elapsed >= pObject->Transition_Duration) ||
+        (pObject->Transition_Start == pObject->Transition_Target)) {
+        /* done fading or ramping */
+        pObject->Tracking_Value = (uint32_t)pObject->Transition_Target;
         pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
-        pObject->Color_Command.operation = BACNET_COLOR_OPERATION_STOP;
-        pObject->Color_Command.transit.fade_time = 0;
-    } else {
-        if (old_value == target_value) {
-            /* stop fading */
-            pObject->Tracking_Value = target_value;
-            pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
-            pObject->Color_Command.operation = BACNET_COLOR_OPERATION_STOP;
+        if (pObject->Color_Command.operation ==
+            BACNET_COLOR_OPERATION_FADE_TO_CCT) {
             pObject->Color_Command.transit.fade_time = 0;
-        } else {
-            /* fading */
-            pObject->Tracking_Value = linear_interpolate_int(0, milliseconds,
-                pObject->Color_Command.transit.fade_time, old_value,
-                target_value);
-            pObject->Color_Command.transit.fade_time -= milliseconds;
-            pObject->In_Progress =
-                BACNET_COLOR_OPERATION_IN_PROGRESS_FADE_ACTIVE;
         }
-    }
-    if (Color_Temperature_Write_Present_Value_Callback) {
-        Color_Temperature_Write_Present_Value_Callback(
-            object_instance, old_value, pObject->Tracking_Value);
-    }
-}
-
-/**
- * Updates the color object tracking value while ramping
- *
- * Commands Present_Value to ramp from the current Tracking_Value to the
- * target-color-temperature specified in the command. The ramp operation
- * changes the output color temperature from its current value to
- * target-color-temperature, at a particular Kelvin per second defined by
- * ramp-rate. While the ramp operation is executing, In_Progress shall be set
- * to RAMP_ACTIVE, and Tracking_Value shall be updated to reflect the current
- * progress of the fade. <target-color-temperature> shall be clamped to
- * Min_Pres_Value and Max_Pres_Value
- *
- * @param  object_instance - object-instance number of the object
- * @param milliseconds - number of milliseconds elapsed
- */
-static void Color_Temperature_Ramp_To_CCT_Handler(
-    uint32_t object_instance, uint16_t milliseconds)
-{
-    uint16_t old_value, target_value, min_value, max_value, step_value, steps;
-    struct object_data *pObject;
-
-    pObject = Keylist_Data(Object_List, object_instance);
-    if (!pObject) {
-        return;
-    }
-    old_value = pObject->Tracking_Value;
-    min_value = pObject->Present_Value_Minimum;
-    max_value = pObject->Present_Value_Maximum;
-    target_value = pObject->Color_Command.target.color_temperature;
-    /* clamp target within min/max, if needed */
-    if (target_value > max_value) {
-        target_value = max_value;
-    }
-    if (target_value < min_value) {
-        target_value = min_value;
-    }
-    /* determine the number of K steps */
-    if (milliseconds <= 1000) {
-        /* K per second */
-        steps = linear_interpolate_int(
-            0, milliseconds, 1000, 0, pObject->Color_Command.transit.ramp_rate);
-    } else {
-        steps =
-            (milliseconds * pObject->Color_Command.transit.ramp_rate) / 1000;
-    }
-    if (old_value == target_value) {
-        pObject->Tracking_Value = target_value;
-        pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
         pObject->Color_Command.operation = BACNET_COLOR_OPERATION_STOP;
+        Color_Temperature_Transition_Remove(pObject);
     } else {
-        if (old_value < target_value) {
-            step_value = old_value + steps;
-        } else if (old_value > target_value) {
-            if (steps > old_value) {
-                step_value = old_value - steps;
-            } else {
-                step_value = target_value;
-            }
+        value = (int64_t)pObject->Transition_Target -
+            pObject->Transition_Start;
+        value = (value * pObject->Transition_Elapsed) /
+            pObject->Transition_Duration;
+        value += pObject->Transition_Start;
+        pObject->Tracking_Value = (uint32_t)value;
+        if (pObject->Color_Command.operation ==
+            BACNET_COLOR_OPERATION_FADE_TO_CCT) {
+            pObject->Color_Command.transit.fade_time =
+                pObject->Transition_Duration - pObject->Transition_Elapsed;
+            pObject->In_Progress =
+                BACNET_COLOR_OPERATION_IN_PROGRESS_FADE_ACTIVE;
         } else {
-            step_value = target_value;
-        }
-        /* clamp target within min/max, if needed */
-        if (step_value > max_value) {
-            step_value = max_value;
-        }
-        if (step_value < min_value) {
-            step_value = min_value;
+            pObject->In_Progress =
+                BACNET_COLOR_OPERATION_IN_PROGRESS_RAMP_ACTIVE;
         }
-        pObject->Tracking_Value = step_value;
-        pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_FADE_ACTIVE;
     }
     if (Color_Temperature_Write_Present_Value_Callback) {
         Color_Temperature_Write_Present_Value_Callback(
-            object_instance, old_value, pObject->Tracking_Value);
+            pObject->Instance, old_value, pObject->Tracking_Value);
     }
 }
 
@@ -1228,6 +1264,35 @@ static void Color_Temperature_Step_Down_CCT_Handler(uint32_t object_instance)
     }
 }
 
+/**
+ * @brief Updates the tracking value of an object that is in the list of
+ *  active transitions
+ * @param pObject - object that is fading, ramping, or stepping
+ * @param milliseconds - number of milliseconds elapsed
+ */
+static void Color_Temperature_Transition_Timer(
+    struct object_data *pObject, uint16_t milliseconds)
+{
+    switch (pObject->Color_Command.operation) {
+        case BACNET_COLOR_OPERATION_FADE_TO_CCT:
+        case BACNET_COLOR_OPERATION_RAMP_TO_CCT:
+            Color_Temperature_Transition_Handler(pObject, milliseconds);
+            break;
+        case BACNET_COLOR_OPERATION_STEP_UP_CCT:
+            Color_Temperature_Step_Up_CCT_Handler(pObject->Instance);
+            Color_Temperature_Transition_Remove(pObject);
+            break;
+        case BACNET_COLOR_OPERATION_STEP_DOWN_CCT:
+            Color_Temperature_Step_Down_CCT_Handler(pObject->Instance);
+            Color_Temperature_Transition_Remove(pObject);
+            break;
+        default:
+            pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
+            Color_Temperature_Transition_Remove(pObject);
+            break;
+    }
+}
+
 /**
  * Updates the color temperature tracking value per ramp or fade
  *
@@ -1240,30 +1305,53 @@ void Color_Temperature_Timer(uint32_t object_instance, uint16_t milliseconds)
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        switch (pObject->Color_Command.operation) {
-            case BACNET_COLOR_OPERATION_FADE_TO_CCT:
-                Color_Temperature_Fade_To_CCT_Handler(
-                    object_instance, milliseconds);
-                break;
-            case BACNET_COLOR_OPERATION_RAMP_TO_CCT:
-                Color_Temperature_Ramp_To_CCT_Handler(
-                    object_instance, milliseconds);
-                break;
-            case BACNET_COLOR_OPERATION_STEP_UP_CCT:
-                Color_Temperature_Step_Up_CCT_Handler(object_instance);
-                break;
-            case BACNET_COLOR_OPERATION_STEP_DOWN_CCT:
-                Color_Temperature_Step_Down_CCT_Handler(object_instance);
-                break;
-            case BACNET_COLOR_OPERATION_NONE:
-            case BACNET_COLOR_OPERATION_STOP:
-            default:
-                pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
-                break;
+        if (pObject->Transition_Active) {
+            Color_Temperature_Transition_Timer(pObject, milliseconds);
+        } else {
+            pObject->In_Progress = BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE;
         }
     }
 }
 
+/**
+ * @brief Updates the tracking value of each color temperature object that
+ *  is fading, ramping, or stepping, in one pass of the transitions,
+ *  without looking at the idle objects. Use this instead of calling
+ *  Color_Temperature_Timer() for each object.
+ * @param milliseconds - number of milliseconds elapsed since previously
+ * called.  Suggest that this is called every 10 milliseconds.
+ */
+void Color_Temperature_Timer_Active(uint16_t milliseconds)
+{
+    struct object_data *pObject, *pNext;
+
+    pObject = Transition_List;
+    while (pObject) {
+        /* the object leaves the list at the end of its transition */
+        pNext = pObject->Transition_Next;
+        Color_Temperature_Transition_Timer(pObject, milliseconds);
+        pObject = pNext;
+    }
+}
+
+/**
+ * @brief Get the number of color temperature objects that are fading,
+ *  ramping, or stepping
+ * @return number of objects in an active transition
+ */
+unsigned Color_Temperature_Timer_Active_Count(void)
+{
+    struct object_data *pObject;
+    unsigned count = 0;
+
+    for (pObject = Transition_List; pObject;
+         pObject = pObject->Transition_Next) {
+        count++;
+    }
+
+    return count;
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -1568,7 +1656,7 @@ uint32_t Color_Temperature_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->Present_Value = 0;
@@ -1588,12 +1676,16 @@ uint32_t Color_Temperature_Create(uint32_t object_instance)
                 pObject->Default_Fade_Time;
             pObject->Color_Command.target.color_temperature =
                 pObject->Default_Color_Temperature;
+            pObject->Instance = object_instance;
+            pObject->Transition_Active = false;
+            Color_Temperature_Transition_Start(pObject);
             pObject->Changed = false;
             pObject->Write_Enabled = false;
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                Color_Temperature_Transition_Remove(pObject);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1604,6 +1696,30 @@ uint32_t Color_Temperature_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Color Temperature objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Color_Temperature_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Color_Temperature_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an Color object
  * @param object_instance - object-instance number of the object
@@ -1616,7 +1732,8 @@ bool Color_Temperature_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Color_Temperature_Transition_Remove(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1634,12 +1751,14 @@ void Color_Temperature_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
+    Transition_List = NULL;
 }
 
 /**
@@ -1649,5 +1768,6 @@ void Color_Temperature_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
@@ -140,10 +140,17 @@ void Color_Temperature_Write_Disable(uint32_t instance);
 
 BACNET_STACK_EXPORT
 void Color_Temperature_Timer(uint32_t object_instance, uint16_t milliseconds);
+BACNET_STACK_EXPORT
+void Color_Temperature_Timer_Active(uint16_t milliseconds);
+BACNET_STACK_EXPORT
+unsigned Color_Temperature_Timer_Active_Count(void);
 
 BACNET_STACK_EXPORT
 uint32_t Color_Temperature_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+unsigned Color_Temperature_Create_Bulk(
+    uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 bool Color_Temperature_Delete(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Color_Temperature_Cleanup(void);
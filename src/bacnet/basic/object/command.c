@@ -17,6 +17,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -322,6 +323,7 @@ int cl_decode_apdu(uint8_t *apdu,
 }
 
 COMMAND_DESCR Command_Descr[MAX_COMMANDS];
+static command_write_multiple_callback Command_Write_Multiple_Callback;
 
 /* These arrays are used by the ReadPropertyMultiple handler */
 static const int Command_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
@@ -369,6 +371,8 @@ void Command_Init(void)
         Command_Descr[i].Present_Value = 0;
         Command_Descr[i].In_Process = false;
         Command_Descr[i].All_Writes_Successful = true; /* Optimistic default */
+        Command_Descr[i].Quit = false;
+        memset(Command_Descr[i].Group, 0, sizeof(Command_Descr[i].Group));
     }
 }
 
@@ -434,6 +438,207 @@ unsigned Command_Instance_To_Index(uint32_t object_instance)
     return index;
 }
 
+/**
+ * @brief Get the device that an action is written to
+ * @param action - the action
+ * @return the device instance, or BACNET_MAX_INSTANCE + 1 for an action
+ *  without a Device_Id, which is written to this device
+ */
+static uint32_t command_action_device(const BACNET_ACTION_LIST *action)
+{
+    if (action->Device_Id.instance > BACNET_MAX_INSTANCE) {
+        return BACNET_MAX_INSTANCE + 1;
+    }
+
+    return action->Device_Id.instance;
+}
+
+/**
+ * @brief Determine if the actions of a device are being written
+ * @param pCommand - object that is in process
+ * @param device_instance - the device
+ * @return true if a write group holds the device
+ */
+static bool
+command_device_active(const COMMAND_DESCR *pCommand, uint32_t device_instance)
+{
+    unsigned i;
+
+    for (i = 0; i < COMMAND_WRITE_GROUPS_MAX; i++) {
+        if (pCommand->Group[i].Active &&
+            (pCommand->Group[i].Device_Instance == device_instance)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Record the outcome of the writes of a group. The writes stop at
+ *  the first failure, so the actions after it are written again with the
+ *  next request to the device, unless the failed action quits the list.
+ * @param pCommand - object that is in process
+ * @param group - the group of writes to one device
+ * @param successful - number of actions of the batch that were written
+ */
+static void command_write_result(
+    COMMAND_DESCR *pCommand, COMMAND_WRITE_GROUP *group, unsigned successful)
+{
+    BACNET_ACTION_LIST *action = NULL;
+    unsigned i;
+
+    for (i = 0; i < group->Batch_Count; i++) {
+        action = group->Batch[i];
+        if (i < successful) {
+            action->Write_Successful = true;
+        } else if (i == successful) {
+            action->Write_Successful = false;
+            if (action->Quit_On_Failure) {
+                pCommand->Quit = true;
+            }
+        } else {
+            action->Write_Attempted = false;
+        }
+    }
+    group->Delay = 0;
+    if (group->Batch_Count > 0) {
+        /* only the last action of a batch has a Post_Delay */
+        if (successful < group->Batch_Count) {
+            action = group->Batch[successful];
+        } else {
+            action = group->Batch[group->Batch_Count - 1];
+        }
+        if (action->Post_Delay != 0xFFFFFFFFU) {
+            group->Delay = action->Post_Delay;
+        }
+    }
+    group->Batch_Count = 0;
+    group->Pending = false;
+}
+
+/**
+ * @brief Request the next writes of a group, which are the actions of the
+ *  device, in order, up to and including an action with a Post_Delay
+ * @param pCommand - object that is in process
+ * @param object_instance - object-instance number of the object
+ * @param group - the group of writes to one device
+ */
+static void command_write_batch(COMMAND_DESCR *pCommand,
+    uint32_t object_instance,
+    COMMAND_WRITE_GROUP *group)
+{
+    BACNET_ACTION_LIST *action = &pCommand->Action[pCommand->Present_Value];
+
+    group->Batch_Count = 0;
+    for (; action != NULL; action = action->next) {
+        if (group->Batch_Count >= COMMAND_WRITE_BATCH_MAX) {
+            break;
+        }
+        if (action->Write_Attempted ||
+            (command_action_device(action) != group->Device_Instance)) {
+            continue;
+        }
+        action->Write_Attempted = true;
+        group->Batch[group->Batch_Count] = action;
+        group->Batch_Count++;
+        if ((action->Post_Delay != 0xFFFFFFFFU) && (action->Post_Delay > 0)) {
+            break;
+        }
+    }
+    if (group->Batch_Count == 0) {
+        group->Active = false;
+        return;
+    }
+    group->Pending = true;
+    if (!Command_Write_Multiple_Callback(object_instance,
+            group->Device_Instance, group->Batch, group->Batch_Count)) {
+        command_write_result(pCommand, group, 0);
+    }
+}
+
+/**
+ * @brief Request the next writes of each device of the action list, and
+ *  assign the free groups to the devices that are not started. Once all
+ *  of the writes are attempted, or an action quits the list, the
+ *  All_Writes_Successful property is set from the actions.
+ * @param pCommand - object that is in process
+ * @param object_instance - object-instance number of the object
+ */
+static void command_schedule(COMMAND_DESCR *pCommand, uint32_t object_instance)
+{
+    BACNET_ACTION_LIST *action = NULL;
+    COMMAND_WRITE_GROUP *group = NULL;
+    bool successful = true;
+    unsigned i;
+
+    for (i = 0; i < COMMAND_WRITE_GROUPS_MAX; i++) {
+        group = &pCommand->Group[i];
+        if (!group->Active || group->Pending) {
+            continue;
+        }
+        if (pCommand->Quit) {
+            group->Active = false;
+        } else if (group->Delay == 0) {
+            command_write_batch(pCommand, object_instance, group);
+        }
+    }
+    for (i = 0; (i < COMMAND_WRITE_GROUPS_MAX) && !pCommand->Quit; i++) {
+        group = &pCommand->Group[i];
+        if (group->Active) {
+            continue;
+        }
+        action = &pCommand->Action[pCommand->Present_Value];
+        for (; action != NULL; action = action->next) {
+            if (!action->Write_Attempted &&
+                !command_device_active(
+                    pCommand, command_action_device(action))) {
+                break;
+            }
+        }
+        if (action == NULL) {
+            break;
+        }
+        group->Active = true;
+        group->Device_Instance = command_action_device(action);
+        group->Delay = 0;
+        command_write_batch(pCommand, object_instance, group);
+    }
+    for (i = 0; i < COMMAND_WRITE_GROUPS_MAX; i++) {
+        if (pCommand->Group[i].Active) {
+            return;
+        }
+    }
+    action = &pCommand->Action[pCommand->Present_Value];
+    for (; action != NULL; action = action->next) {
+        if (!action->Write_Successful) {
+            successful = false;
+        }
+    }
+    pCommand->All_Writes_Successful = successful;
+    pCommand->In_Process = false;
+}
+
+/**
+ * @brief Start the action list of the present-value, where the actions
+ *  of different devices are written at the same time
+ * @param pCommand - object
+ * @param object_instance - object-instance number of the object
+ */
+static void command_start(COMMAND_DESCR *pCommand, uint32_t object_instance)
+{
+    BACNET_ACTION_LIST *action = &pCommand->Action[pCommand->Present_Value];
+
+    for (; action != NULL; action = action->next) {
+        action->Write_Successful = false;
+        action->Write_Attempted = false;
+    }
+    memset(pCommand->Group, 0, sizeof(pCommand->Group));
+    pCommand->Quit = false;
+    pCommand->In_Process = true;
+    command_schedule(pCommand, object_instance);
+}
+
 /**
  * For a given object instance-number, determines the present-value
  *
@@ -455,12 +660,14 @@ uint32_t Command_Present_Value(uint32_t object_instance)
 }
 
 /**
- * For a given object instance-number, sets the present-value
+ * For a given object instance-number, sets the present-value, which
+ * starts the writes of its action list when a write callback is set
  *
  * @param  object_instance - object-instance number of the object
  * @param  value - present-value to set
  *
- * @return  true if values are within range and present-value is set.
+ * @return  true if values are within range and present-value is set,
+ * or false if the object is in process.
  */
 bool Command_Present_Value_Set(uint32_t object_instance, uint32_t value)
 {
@@ -468,8 +675,12 @@ bool Command_Present_Value_Set(uint32_t object_instance, uint32_t value)
     unsigned int index;
 
     index = Command_Instance_To_Index(object_instance);
-    if (index < MAX_COMMANDS) {
+    if ((index < MAX_COMMANDS) && !Command_Descr[index].In_Process) {
         Command_Descr[index].Present_Value = value;
+        if ((value > 0) && (value < MAX_COMMAND_ACTIONS) &&
+            Command_Write_Multiple_Callback) {
+            command_start(&Command_Descr[index], object_instance);
+        }
         status = true;
     }
 
@@ -566,6 +777,105 @@ bool Command_All_Writes_Successful_Set(uint32_t object_instance, bool value)
     return status;
 }
 
+/**
+ * For a given object instance-number, sets an action list. The first
+ * action is copied, and the actions linked from it are owned by the caller.
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  action_index - the present-value that starts the action list
+ * @param  action - the first action of the list
+ *
+ * @return  true if values are within range and the action list is set.
+ */
+bool Command_Action_List_Set(uint32_t object_instance,
+    unsigned action_index,
+    BACNET_ACTION_LIST *action)
+{
+    bool status = false;
+    unsigned int index;
+
+    index = Command_Instance_To_Index(object_instance);
+    if ((index < MAX_COMMANDS) && (action_index < MAX_COMMAND_ACTIONS) &&
+        action && !Command_Descr[index].In_Process) {
+        Command_Descr[index].Action[action_index] = *action;
+        status = true;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Set the callback that writes the actions of one device
+ * @param cb - callback used to write the actions
+ */
+void Command_Write_Multiple_Callback_Set(command_write_multiple_callback cb)
+{
+    Command_Write_Multiple_Callback = cb;
+}
+
+/**
+ * For a given object instance-number, reports the outcome of the
+ * writes to a device. The next writes are requested from Command_Timer().
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  device_instance - the device that was written
+ * @param  successful - number of actions that were written, in order,
+ * before the first failure
+ *
+ * @return  true if the writes to the device were pending
+ */
+bool Command_Write_Multiple_Result(
+    uint32_t object_instance, uint32_t device_instance, unsigned successful)
+{
+    COMMAND_WRITE_GROUP *group = NULL;
+    unsigned int index;
+    unsigned i;
+
+    index = Command_Instance_To_Index(object_instance);
+    if (index >= MAX_COMMANDS) {
+        return false;
+    }
+    for (i = 0; i < COMMAND_WRITE_GROUPS_MAX; i++) {
+        group = &Command_Descr[index].Group[i];
+        if (group->Pending && (group->Device_Instance == device_instance)) {
+            command_write_result(&Command_Descr[index], group, successful);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Updates the Post_Delay of the writes of the object, and
+ *  requests the next writes of each device
+ * @param  object_instance - object-instance number of the object
+ * @param milliseconds - number of milliseconds elapsed since previously
+ *  called.  Suggest that this is called every 1000 milliseconds or less.
+ */
+void Command_Timer(uint32_t object_instance, uint16_t milliseconds)
+{
+    COMMAND_WRITE_GROUP *group = NULL;
+    unsigned int index;
+    unsigned i;
+
+    index = Command_Instance_To_Index(object_instance);
+    if ((index >= MAX_COMMANDS) || !Command_Descr[index].In_Process) {
+        return;
+    }
+    for (i = 0; i < COMMAND_WRITE_GROUPS_MAX; i++) {
+        group = &Command_Descr[index].Group[i];
+        if (group->Active && !group->Pending) {
+            if (group->Delay > milliseconds) {
+                group->Delay -= milliseconds;
+            } else {
+                group->Delay = 0;
+            }
+        }
+    }
+    command_schedule(&Command_Descr[index], object_instance);
+}
+
 /**
  * For a given object instance-number, loads the object-name into
  * a characterstring.
@@ -771,8 +1081,12 @@ bool Command_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
                     return false;
                 }
-                Command_Present_Value_Set(
-                    wp_data->object_instance, value.type.Unsigned_Int);
+                if (!Command_Present_Value_Set(
+                        wp_data->object_instance, value.type.Unsigned_Int)) {
+                    wp_data->error_class = ERROR_CLASS_OBJECT;
+                    wp_data->error_code = ERROR_CODE_BUSY;
+                    status = false;
+                }
             } else {
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
                 wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
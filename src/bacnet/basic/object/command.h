@@ -23,6 +23,16 @@
 #define MAX_COMMAND_ACTIONS 8
 #endif
 
+/* the devices that are written to at the same time by one Command */
+#ifndef COMMAND_WRITE_GROUPS_MAX
+#define COMMAND_WRITE_GROUPS_MAX 8
+#endif
+
+/* the actions that are written to a device with one request */
+#ifndef COMMAND_WRITE_BATCH_MAX
+#define COMMAND_WRITE_BATCH_MAX 16
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -37,9 +47,33 @@ extern "C" {
         uint32_t Post_Delay;    /* Optional */
         bool Quit_On_Failure;
         bool Write_Successful;
+        bool Write_Attempted;   /* Not encoded */
         struct bacnet_action_list *next;
     } BACNET_ACTION_LIST;
 
+    /**
+     * Callback to write some actions to one device, such as with a
+     * WritePropertyMultiple request. The device instance is greater
+     * than BACNET_MAX_INSTANCE for the actions without a Device_Id.
+     * The outcome is reported with Command_Write_Multiple_Result().
+     * @return true if the request was sent
+     */
+    typedef bool (*command_write_multiple_callback)(
+        uint32_t object_instance,
+        uint32_t device_instance,
+        BACNET_ACTION_LIST **actions,
+        unsigned count);
+
+    /* the writes to one device of an action list that is in process */
+    typedef struct command_write_group {
+        bool Active;
+        bool Pending;
+        uint32_t Device_Instance;
+        uint32_t Delay;
+        unsigned Batch_Count;
+        BACNET_ACTION_LIST *Batch[COMMAND_WRITE_BATCH_MAX];
+    } COMMAND_WRITE_GROUP;
+
     int cl_encode_apdu(
         uint8_t * apdu,
         BACNET_ACTION_LIST * bcl);
@@ -54,7 +88,9 @@ extern "C" {
         uint32_t Present_Value;
         bool In_Process;
         bool All_Writes_Successful;
+        bool Quit;
         BACNET_ACTION_LIST Action[MAX_COMMAND_ACTIONS];
+        COMMAND_WRITE_GROUP Group[COMMAND_WRITE_GROUPS_MAX];
     } COMMAND_DESCR;
 
     BACNET_STACK_EXPORT
@@ -127,6 +163,24 @@ extern "C" {
         uint32_t object_instance,
         bool value);
 
+    BACNET_STACK_EXPORT
+    bool Command_Action_List_Set(
+        uint32_t object_instance,
+        unsigned action_index,
+        BACNET_ACTION_LIST *action);
+    BACNET_STACK_EXPORT
+    void Command_Write_Multiple_Callback_Set(
+        command_write_multiple_callback cb);
+    BACNET_STACK_EXPORT
+    bool Command_Write_Multiple_Result(
+        uint32_t object_instance,
+        uint32_t device_instance,
+        unsigned successful);
+    BACNET_STACK_EXPORT
+    void Command_Timer(
+        uint32_t object_instance,
+        uint16_t milliseconds);
+
     BACNET_STACK_EXPORT
     bool Command_Change_Of_Value(
         uint32_t instance);
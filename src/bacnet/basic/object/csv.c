@@ -194,6 +194,10 @@ bool CharacterString_Value_Present_Value_Set(
     index = CharacterString_Value_Instance_To_Index(object_instance);
     if (index < MAX_CHARACTERSTRING_VALUES) {
         if (!characterstring_same(&Present_Value[index], object_name)) {
+            if (!Changed[index]) {
+                handler_cov_object_changed(
+                    OBJECT_CHARACTERSTRING_VALUE, object_instance);
+            }
             Changed[index] = true;
         }
         status = characterstring_copy(&Present_Value[index], object_name);
@@ -236,6 +240,10 @@ static void CharacterString_Value_Out_Of_Service_Set(
     index = CharacterString_Value_Instance_To_Index(object_instance);
     if (index < MAX_CHARACTERSTRING_VALUES) {
         if (Out_Of_Service[index] != value) {
+            if (!Changed[index]) {
+                handler_cov_object_changed(
+                    OBJECT_CHARACTERSTRING_VALUE, object_instance);
+            }
             Changed[index] = true;
         }
         Out_Of_Service[index] = value;
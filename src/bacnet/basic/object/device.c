@@ -8,6 +8,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -24,6 +25,9 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/key.h"
+#include "bacnet/basic/sys/memstats.h"
+#include "bacnet/basic/sys/static_pool.h"
 /* include the device object */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/object/acc.h"
@@ -35,6 +39,7 @@
 #include "bacnet/basic/object/bv.h"
 #include "bacnet/basic/object/calendar.h"
 #include "bacnet/basic/object/command.h"
+#include "bacnet/basic/object/event_log.h"
 #include "bacnet/basic/object/lc.h"
 #include "bacnet/basic/object/lsp.h"
 #include "bacnet/basic/object/lsz.h"
@@ -42,8 +47,10 @@
 #include "bacnet/basic/object/mso.h"
 #include "bacnet/basic/object/msv.h"
 #include "bacnet/basic/object/schedule.h"
+#include "bacnet/basic/object/snapshot.h"
 #include "bacnet/basic/object/structured_view.h"
 #include "bacnet/basic/object/trendlog.h"
+#include "bacnet/basic/object/trendlog_multiple.h"
 #if defined(INTRINSIC_REPORTING)
 #include "bacnet/basic/object/nc.h"
 #endif /* defined(INTRINSIC_REPORTING) */
@@ -80,6 +87,13 @@ extern bool Routed_Device_Write_Property_Local(
 
 /* may be overridden by outside table */
 static object_functions_t *Object_Table;
+/* the startup profile of Device_Init(), when it is set */
+static device_profile_clock_function Init_Profile_Clock;
+static device_profile_report_function Init_Profile_Report;
+/* Object_Table entry for each object type, as the entry index + 1,
+   or zero when the object type is not in the table.  Built by Device_Init()
+   so that finding the object functions does not walk the table. */
+static uint16_t Object_Table_Index[MAX_BACNET_OBJECT_TYPE];
 
 /* clang-format off */
 static object_functions_t My_Object_Table[] = {
@@ -91,7 +105,7 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Value_Lists */, NULL /* COV */, NULL /* COV Clear */,
         NULL /* Intrinsic Reporting */, NULL /* Add_List_Element */,
         NULL /* Remove_List_Element */, NULL /* Create */, NULL /* Delete */,
-        NULL /* Timer */ },
+        NULL /* Timer */, NULL /* Value_Get */, NULL /* Value_Set */ },
 #if (BACNET_PROTOCOL_REVISION >= 17)
     { OBJECT_NETWORK_PORT, Network_Port_Init, Network_Port_Count,
         Network_Port_Index_To_Instance, Network_Port_Valid_Instance,
@@ -100,7 +114,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #endif
     { OBJECT_ANALOG_INPUT, Analog_Input_Init, Analog_Input_Count,
         Analog_Input_Index_To_Instance, Analog_Input_Valid_Instance,
@@ -110,7 +125,8 @@ static object_functions_t My_Object_Table[] = {
         Analog_Input_Encode_Value_List, Analog_Input_Change_Of_Value,
         Analog_Input_Change_Of_Value_Clear, Analog_Input_Intrinsic_Reporting,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Analog_Input_Create, Analog_Input_Delete, NULL /* Timer */ },
+        Analog_Input_Create, Analog_Input_Delete, NULL /* Timer */,
+        Analog_Input_Property_Value, Analog_Input_Property_Value_Set },
     { OBJECT_ANALOG_OUTPUT, Analog_Output_Init, Analog_Output_Count,
         Analog_Output_Index_To_Instance, Analog_Output_Valid_Instance,
         Analog_Output_Object_Name, Analog_Output_Read_Property,
@@ -119,7 +135,8 @@ static object_functions_t My_Object_Table[] = {
         Analog_Output_Encode_Value_List, Analog_Output_Change_Of_Value,
         Analog_Output_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Analog_Output_Create, Analog_Output_Delete, NULL /* Timer */ },
+        Analog_Output_Create, Analog_Output_Delete, NULL /* Timer */,
+        Analog_Output_Property_Value, Analog_Output_Property_Value_Set },
     { OBJECT_ANALOG_VALUE, Analog_Value_Init, Analog_Value_Count,
         Analog_Value_Index_To_Instance, Analog_Value_Valid_Instance,
         Analog_Value_Object_Name, Analog_Value_Read_Property,
@@ -128,7 +145,8 @@ static object_functions_t My_Object_Table[] = {
         Analog_Value_Encode_Value_List, Analog_Value_Change_Of_Value,
         Analog_Value_Change_Of_Value_Clear, Analog_Value_Intrinsic_Reporting,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Analog_Value_Create, Analog_Value_Delete, NULL /* Timer */ },
+        Analog_Value_Create, Analog_Value_Delete, NULL /* Timer */,
+        Analog_Value_Property_Value, Analog_Value_Property_Value_Set },
     { OBJECT_BINARY_INPUT, Binary_Input_Init, Binary_Input_Count,
         Binary_Input_Index_To_Instance, Binary_Input_Valid_Instance,
         Binary_Input_Object_Name, Binary_Input_Read_Property,
@@ -137,7 +155,8 @@ static object_functions_t My_Object_Table[] = {
         Binary_Input_Encode_Value_List, Binary_Input_Change_Of_Value,
         Binary_Input_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Binary_Input_Create, Binary_Input_Delete, NULL /* Timer */ },
+        Binary_Input_Create, Binary_Input_Delete, NULL /* Timer */,
+        Binary_Input_Property_Value, Binary_Input_Property_Value_Set },
     { OBJECT_BINARY_OUTPUT, Binary_Output_Init, Binary_Output_Count,
         Binary_Output_Index_To_Instance, Binary_Output_Valid_Instance,
         Binary_Output_Object_Name, Binary_Output_Read_Property,
@@ -146,7 +165,8 @@ static object_functions_t My_Object_Table[] = {
         Binary_Output_Encode_Value_List, Binary_Output_Change_Of_Value,
         Binary_Output_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Binary_Output_Create, Binary_Output_Delete, NULL /* Timer */ },
+        Binary_Output_Create, Binary_Output_Delete, NULL /* Timer */,
+        Binary_Output_Property_Value, Binary_Output_Property_Value_Set },
     { OBJECT_BINARY_VALUE, Binary_Value_Init, Binary_Value_Count,
         Binary_Value_Index_To_Instance, Binary_Value_Valid_Instance,
         Binary_Value_Object_Name, Binary_Value_Read_Property,
@@ -155,15 +175,17 @@ static object_functions_t My_Object_Table[] = {
         Binary_Value_Encode_Value_List, Binary_Value_Change_Of_Value,
         Binary_Value_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Binary_Value_Create, Binary_Value_Delete, NULL /* Timer */ },
+        Binary_Value_Create, Binary_Value_Delete, NULL /* Timer */,
+        Binary_Value_Property_Value, Binary_Value_Property_Value_Set },
     { OBJECT_CALENDAR, Calendar_Init, Calendar_Count,
         Calendar_Index_To_Instance, Calendar_Valid_Instance,
         Calendar_Object_Name, Calendar_Read_Property,
         Calendar_Write_Property, Calendar_Property_Lists,
-        NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
+        Calendar_RR_Info, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #if (BACNET_PROTOCOL_REVISION >= 10)
     { OBJECT_BITSTRING_VALUE, BitString_Value_Init,
         BitString_Value_Count, BitString_Value_Index_To_Instance,
@@ -174,7 +196,7 @@ static object_functions_t My_Object_Table[] = {
         BitString_Value_Change_Of_Value, BitString_Value_Change_Of_Value_Clear,
         NULL /* Intrinsic Reporting */,  NULL /* Add_List_Element */,
         NULL /* Remove_List_Element */, NULL /* Create */, NULL /* Delete */,
-        NULL /* Timer */ },
+        NULL /* Timer */, NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_CHARACTERSTRING_VALUE, CharacterString_Value_Init,
         CharacterString_Value_Count, CharacterString_Value_Index_To_Instance,
         CharacterString_Value_Valid_Instance, CharacterString_Value_Object_Name,
@@ -186,7 +208,7 @@ static object_functions_t My_Object_Table[] = {
         CharacterString_Value_Change_Of_Value_Clear,
         NULL /* Intrinsic Reporting */, NULL /* Add_List_Element */,
         NULL /* Remove_List_Element */, NULL /* Create */, NULL /* Delete */,
-        NULL /* Timer */ },
+        NULL /* Timer */, NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_OCTETSTRING_VALUE, OctetString_Value_Init, OctetString_Value_Count,
         OctetString_Value_Index_To_Instance, OctetString_Value_Valid_Instance,
         OctetString_Value_Object_Name, OctetString_Value_Read_Property,
@@ -194,7 +216,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_POSITIVE_INTEGER_VALUE, PositiveInteger_Value_Init,
         PositiveInteger_Value_Count, PositiveInteger_Value_Index_To_Instance,
         PositiveInteger_Value_Valid_Instance, PositiveInteger_Value_Object_Name,
@@ -204,7 +227,9 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        PositiveInteger_Value_Property_Value,
+        PositiveInteger_Value_Property_Value_Set },
     { OBJECT_TIME_VALUE, Time_Value_Init, Time_Value_Count,
         Time_Value_Index_To_Instance, Time_Value_Valid_Instance,
         Time_Value_Object_Name, Time_Value_Read_Property,
@@ -212,7 +237,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #endif
     { OBJECT_COMMAND, Command_Init, Command_Count, Command_Index_To_Instance,
         Command_Valid_Instance, Command_Object_Name, Command_Read_Property,
@@ -220,7 +246,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_INTEGER_VALUE, Integer_Value_Init, Integer_Value_Count,
         Integer_Value_Index_To_Instance, Integer_Value_Valid_Instance,
         Integer_Value_Object_Name, Integer_Value_Read_Property,
@@ -228,7 +255,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #if defined(INTRINSIC_REPORTING)
     { OBJECT_NOTIFICATION_CLASS, Notification_Class_Init,
         Notification_Class_Count, Notification_Class_Index_To_Instance,
@@ -239,7 +267,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         Notification_Class_Add_List_Element,
         Notification_Class_Remove_List_Element, NULL /* Create */,
-        NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #endif
     { OBJECT_LIFE_SAFETY_POINT, Life_Safety_Point_Init, Life_Safety_Point_Count,
         Life_Safety_Point_Index_To_Instance, Life_Safety_Point_Valid_Instance,
@@ -248,7 +277,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Life_Safety_Point_Create, Life_Safety_Point_Delete, NULL /* Timer */ },
+        Life_Safety_Point_Create, Life_Safety_Point_Delete, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_LIFE_SAFETY_ZONE, Life_Safety_Zone_Init, Life_Safety_Zone_Count,
         Life_Safety_Zone_Index_To_Instance, Life_Safety_Zone_Valid_Instance,
         Life_Safety_Zone_Object_Name, Life_Safety_Zone_Read_Property,
@@ -256,7 +286,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Life_Safety_Zone_Create, Life_Safety_Zone_Delete, NULL /* Timer */ },
+        Life_Safety_Zone_Create, Life_Safety_Zone_Delete, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_LOAD_CONTROL, Load_Control_Init, Load_Control_Count,
         Load_Control_Index_To_Instance, Load_Control_Valid_Instance,
         Load_Control_Object_Name, Load_Control_Read_Property,
@@ -264,7 +295,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_MULTI_STATE_INPUT, Multistate_Input_Init, Multistate_Input_Count,
         Multistate_Input_Index_To_Instance, Multistate_Input_Valid_Instance,
         Multistate_Input_Object_Name, Multistate_Input_Read_Property,
@@ -273,7 +305,8 @@ static object_functions_t My_Object_Table[] = {
         Multistate_Input_Encode_Value_List, Multistate_Input_Change_Of_Value,
         Multistate_Input_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Multistate_Input_Create, Multistate_Input_Delete, NULL /* Timer */ },
+        Multistate_Input_Create, Multistate_Input_Delete, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_MULTI_STATE_OUTPUT, Multistate_Output_Init,
         Multistate_Output_Count, Multistate_Output_Index_To_Instance,
         Multistate_Output_Valid_Instance, Multistate_Output_Object_Name,
@@ -283,7 +316,8 @@ static object_functions_t My_Object_Table[] = {
         Multistate_Output_Encode_Value_List, Multistate_Output_Change_Of_Value,
         Multistate_Output_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Multistate_Output_Create, Multistate_Output_Delete, NULL /* Timer */ },
+        Multistate_Output_Create, Multistate_Output_Delete, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_MULTI_STATE_VALUE, Multistate_Value_Init, Multistate_Value_Count,
         Multistate_Value_Index_To_Instance, Multistate_Value_Valid_Instance,
         Multistate_Value_Object_Name, Multistate_Value_Read_Property,
@@ -292,7 +326,8 @@ static object_functions_t My_Object_Table[] = {
         Multistate_Value_Encode_Value_List, Multistate_Value_Change_Of_Value,
         Multistate_Value_Change_Of_Value_Clear, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Multistate_Value_Create, Multistate_Value_Delete, NULL /* Timer */ },
+        Multistate_Value_Create, Multistate_Value_Delete, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_TRENDLOG, Trend_Log_Init, Trend_Log_Count,
         Trend_Log_Index_To_Instance, Trend_Log_Valid_Instance,
         Trend_Log_Object_Name, Trend_Log_Read_Property,
@@ -300,7 +335,27 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
+    { OBJECT_EVENT_LOG, Event_Log_Init, Event_Log_Count,
+        Event_Log_Index_To_Instance, Event_Log_Valid_Instance,
+        Event_Log_Object_Name, Event_Log_Read_Property,
+        Event_Log_Write_Property, Event_Log_Property_Lists, Event_Log_RR_Info,
+        NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
+        NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
+    { OBJECT_TREND_LOG_MULTIPLE, Trend_Log_Multiple_Init,
+        Trend_Log_Multiple_Count, Trend_Log_Multiple_Index_To_Instance,
+        Trend_Log_Multiple_Valid_Instance, Trend_Log_Multiple_Object_Name,
+        Trend_Log_Multiple_Read_Property, Trend_Log_Multiple_Write_Property,
+        Trend_Log_Multiple_Property_Lists, Trend_Log_Multiple_RR_Info,
+        NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
+        NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
+        NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #if (BACNET_PROTOCOL_REVISION >= 14)
     { OBJECT_LIGHTING_OUTPUT, Lighting_Output_Init, Lighting_Output_Count,
         Lighting_Output_Index_To_Instance, Lighting_Output_Valid_Instance,
@@ -309,14 +364,16 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Lighting_Output_Create, Lighting_Output_Delete, Lighting_Output_Timer },
+        Lighting_Output_Create, Lighting_Output_Delete, Lighting_Output_Timer,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_CHANNEL, Channel_Init, Channel_Count, Channel_Index_To_Instance,
         Channel_Valid_Instance, Channel_Object_Name, Channel_Read_Property,
         Channel_Write_Property, Channel_Property_Lists,
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Channel_Create, Channel_Delete, NULL /* Timer */ },
+        Channel_Create, Channel_Delete, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #endif
 #if (BACNET_PROTOCOL_REVISION >= 16)
     { OBJECT_BINARY_LIGHTING_OUTPUT, Binary_Lighting_Output_Init,
@@ -330,7 +387,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
         Binary_Lighting_Output_Create, Binary_Lighting_Output_Delete,
-        Binary_Lighting_Output_Timer },
+        Binary_Lighting_Output_Timer,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #endif
 #if (BACNET_PROTOCOL_REVISION >= 24)
     { OBJECT_COLOR, Color_Init, Color_Count, Color_Index_To_Instance,
@@ -339,7 +397,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Iterator */, NULL /* Value_Lists */, NULL /* COV */,
         NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Color_Create, Color_Delete, Color_Timer },
+        Color_Create, Color_Delete, Color_Timer,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_COLOR_TEMPERATURE, Color_Temperature_Init, Color_Temperature_Count,
         Color_Temperature_Index_To_Instance, Color_Temperature_Valid_Instance,
         Color_Temperature_Object_Name, Color_Temperature_Read_Property,
@@ -348,7 +407,7 @@ static object_functions_t My_Object_Table[] = {
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
         Color_Temperature_Create, Color_Temperature_Delete,
-        Color_Temperature_Timer },
+        Color_Temperature_Timer, NULL /* Value_Get */, NULL /* Value_Set */ },
 #endif
 #if defined(BACFILE)
     { OBJECT_FILE, bacfile_init, bacfile_count, bacfile_index_to_instance,
@@ -357,7 +416,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        bacfile_create, bacfile_delete, NULL /* Timer */ },
+        bacfile_create, bacfile_delete, bacfile_timer,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 #endif
     { OBJECT_SCHEDULE, Schedule_Init, Schedule_Count,
         Schedule_Index_To_Instance, Schedule_Valid_Instance,
@@ -366,15 +426,16 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Value_Lists */, NULL /* COV */, NULL /* COV Clear */,
         NULL /* Intrinsic Reporting */, NULL /* Add_List_Element */,
         NULL /* Remove_List_Element */, NULL /* Create */, NULL /* Delete */,
-        NULL /* Timer */ },
+        Schedule_Timer, NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_STRUCTURED_VIEW, Structured_View_Init, Structured_View_Count,
         Structured_View_Index_To_Instance, Structured_View_Valid_Instance,
         Structured_View_Object_Name, Structured_View_Read_Property,
         NULL /* Write_Property */, Structured_View_Property_Lists,
-        NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
+        Structured_View_RR_Info, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */,  NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Structured_View_Create, Structured_View_Delete, NULL /* Timer */ },
+        Structured_View_Create, Structured_View_Delete, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { OBJECT_ACCUMULATOR, Accumulator_Init, Accumulator_Count,
         Accumulator_Index_To_Instance, Accumulator_Valid_Instance,
         Accumulator_Object_Name, Accumulator_Read_Property,
@@ -382,7 +443,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
     { MAX_BACNET_OBJECT_TYPE, NULL /* Init */, NULL /* Count */,
         NULL /* Index_To_Instance */, NULL /* Valid_Instance */,
         NULL /* Object_Name */, NULL /* Read_Property */,
@@ -390,7 +452,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        NULL /* Create */, NULL /* Delete */, NULL /* Timer */ },
+        NULL /* Create */, NULL /* Delete */, NULL /* Timer */,
+        NULL /* Value_Get */, NULL /* Value_Set */ },
 };
 /* clang-format on */
 
@@ -404,19 +467,37 @@ static object_functions_t My_Object_Table[] = {
  */
 static struct object_functions *Device_Objects_Find_Functions(
     BACNET_OBJECT_TYPE Object_Type)
+{
+    uint16_t index;
+
+    if (Object_Type >= MAX_BACNET_OBJECT_TYPE) {
+        return (NULL);
+    }
+    index = Object_Table_Index[Object_Type];
+    if (index == 0) {
+        return (NULL);
+    }
+
+    return (&Object_Table[index - 1]);
+}
+
+/** Build the lookup from object type to the entry in the Object_Table.
+ * The first entry for an object type is used, as when the table is walked.
+ */
+static void Device_Objects_Index_Init(void)
 {
     struct object_functions *pObject = NULL;
+    uint16_t index = 0;
 
+    memset(Object_Table_Index, 0, sizeof(Object_Table_Index));
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
-        /* handle each object type */
-        if (pObject->Object_Type == Object_Type) {
-            return (pObject);
+        index++;
+        if (Object_Table_Index[pObject->Object_Type] == 0) {
+            Object_Table_Index[pObject->Object_Type] = index;
         }
         pObject++;
     }
-
-    return (NULL);
 }
 
 /** Try to find a rr_info_function helper function for the requested object
@@ -510,11 +591,25 @@ static const int Device_Properties_Optional[] = {
 #if defined(BACNET_TIME_MASTER)
     PROP_TIME_SYNCHRONIZATION_RECIPIENTS, PROP_TIME_SYNCHRONIZATION_INTERVAL,
     PROP_ALIGN_INTERVALS, PROP_INTERVAL_OFFSET,
+#endif
+#if BACNET_SEGMENTATION_ENABLED
+    PROP_MAX_SEGMENTS_ACCEPTED, PROP_APDU_SEGMENT_TIMEOUT,
 #endif
     -1
 };
 
 static const int Device_Properties_Proprietary[] = {
+#if BACNET_APDU_STATS && BACNET_APDU_STATS_PROPERTIES
+    PROP_APDU_STATS_REQUESTS, PROP_APDU_STATS_OCTETS_IN,
+    PROP_APDU_STATS_OCTETS_OUT, PROP_APDU_STATS_ERRORS,
+    PROP_APDU_STATS_REJECTS, PROP_APDU_STATS_ABORTS,
+    PROP_APDU_STATS_LATENCY_AVERAGE, PROP_APDU_STATS_LATENCY_MAXIMUM,
+#endif
+#if BACNET_MEMSTATS && BACNET_MEMSTATS_PROPERTIES
+    PROP_MEMSTATS_CURRENT_BYTES, PROP_MEMSTATS_PEAK_BYTES,
+    PROP_MEMSTATS_ALLOCATIONS, PROP_MEMSTATS_FREES, PROP_MEMSTATS_FAILURES,
+    PROP_MEMSTATS_STATIC_BYTES,
+#endif
     -1
 };
 /* clang-format on */
@@ -554,7 +649,49 @@ static char Description[MAX_DEV_DESC_LEN + 1] = "server";
 /* static uint8_t Protocol_Revision = 4; - constant, not settable */
 /* Protocol_Services_Supported - dynamically generated */
 /* Protocol_Object_Types_Supported - in RP encoding */
-/* Object_List - dynamically generated */
+/* Object_List - dynamically generated, and cached as a flat array
+   of object identifiers, rebuilt after the database revision changes
+   or when the object count no longer matches */
+static BACNET_OBJECT_ID *Object_List_Cache;
+static uint32_t Object_List_Cache_Size;
+static uint32_t Object_List_Cache_Count;
+static uint32_t Object_List_Cache_Device_Instance;
+static bool Object_List_Cache_Valid;
+/* Object_Name index - a hash of the names of the objects in the cached
+   Object List, so that an object is found by name without reading the
+   name of every object.  It is rebuilt with the Object List, and the
+   entry of one object is updated after its Object_Name is written.
+   Setters which change an Object_Name outside of WriteProperty must call
+   Device_Object_Name_Index_Update(). */
+#define OBJECT_NAME_INDEX_NONE UINT32_MAX
+struct object_name_index_entry {
+    BACNET_OBJECT_TYPE type;
+    uint32_t instance;
+    uint32_t hash;
+    /* next entry with the same bucket, or OBJECT_NAME_INDEX_NONE */
+    uint32_t next;
+};
+static struct object_name_index_entry *Object_Name_Index;
+static uint32_t *Object_Name_Index_Bucket;
+static uint32_t Object_Name_Index_Size;
+static uint32_t Object_Name_Index_Buckets;
+static uint32_t Object_Name_Index_Count;
+static bool Object_Name_Index_Valid;
+#if BACNET_PROPERTY_CACHE_SIZE
+/* encoded values of properties that do not change while the object
+   exists, so that a full device read does not encode them again and
+   again.  An entry is dropped when its object is written or deleted, and
+   all of them when the database revision changes. */
+struct property_cache_entry {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    /* 0 when the entry is empty */
+    uint16_t length;
+    uint8_t data[BACNET_PROPERTY_CACHE_DATA_SIZE];
+};
+static struct property_cache_entry Property_Cache[BACNET_PROPERTY_CACHE_SIZE];
+#endif
 /* static BACNET_SEGMENTATION Segmentation_Supported = SEGMENTATION_NONE; */
 /* static uint8_t Max_Segments_Accepted = 0; */
 /* VT_Classes_Supported */
@@ -567,6 +704,11 @@ static BACNET_DATE Local_Date; /* rely on OS, if there is one */
    BACnet UTC offset is expressed in minutes. */
 static int16_t UTC_Offset = 5 * 60;
 static bool Daylight_Savings_Status = false; /* rely on OS */
+/* the local date and time are read from the OS once per Device_Timer(),
+   and the timestamps in between use the same reading */
+static bool Local_Time_Cached;
+/* milliseconds counted by Device_Timer(), which wrap around */
+static uint32_t Clock_Milliseconds;
 #if defined(BACNET_TIME_MASTER)
 static bool Align_Intervals;
 static uint32_t Interval_Minutes;
@@ -946,7 +1088,12 @@ uint8_t Device_Protocol_Revision(void)
 
 BACNET_SEGMENTATION Device_Segmentation_Supported(void)
 {
+#if BACNET_SEGMENTATION_ENABLED
+    /* segmented requests are not reassembled */
+    return SEGMENTATION_TRANSMIT;
+#else
     return SEGMENTATION_NONE;
+#endif
 }
 
 uint32_t Device_Database_Revision(void)
@@ -967,6 +1114,11 @@ void Device_Set_Database_Revision(uint32_t revision)
 void Device_Inc_Database_Revision(void)
 {
     Database_Revision++;
+    Object_List_Cache_Valid = false;
+    Object_Name_Index_Valid = false;
+    Device_Property_Cache_Clear();
+    Structured_View_Subordinate_Cache_Invalidate(
+        OBJECT_NONE, BACNET_MAX_INSTANCE);
 }
 
 /** Get the total count of objects supported by this Device Object.
@@ -978,6 +1130,14 @@ unsigned Device_Object_List_Count(void)
 {
     unsigned count = 0; /* number of objects */
     struct object_functions *pObject = NULL;
+#ifdef BAC_ROUTING
+    void *database = Routed_Device_Database();
+
+    if (database) {
+        /* the routed Device and the objects of its database */
+        return 1 + Routed_Device_Database_Object_Count(database);
+    }
+#endif
 
     /* initialize the default return values */
     pObject = Object_Table;
@@ -991,17 +1151,16 @@ unsigned Device_Object_List_Count(void)
     return count;
 }
 
-/** Lookup the Object at the given array index in the Device's Object List.
- * Even though we don't keep a single linear array of objects in the Device,
- * this method acts as though we do and works through a virtual, concatenated
- * array of all of our object type arrays.
+/** Lookup the Object at the given array index in the Device's Object List
+ * by working through a virtual, concatenated array of all of our object
+ * type arrays.
  *
  * @param array_index [in] The desired array index (1 to N)
  * @param object_type [out] The object's type, if found.
  * @param instance [out] The object's instance number, if found.
  * @return True if found, else false.
  */
-bool Device_Object_List_Identifier(
+static bool Device_Object_List_Walk(
     uint32_t array_index, BACNET_OBJECT_TYPE *object_type, uint32_t *instance)
 {
     bool status = false;
@@ -1050,6 +1209,125 @@ bool Device_Object_List_Identifier(
     return status;
 }
 
+/** Build the flat copy of the Object List, if it is stale.
+ *
+ * @return True if the cached Object List may be used.
+ */
+static bool Device_Object_List_Cache_Update(void)
+{
+    uint32_t count = 0;
+    uint32_t cache_index = 0;
+    uint32_t type_count = 0;
+    uint32_t type_index = 0;
+    uint32_t object_index = 0;
+    BACNET_OBJECT_ID *cache = NULL;
+    struct object_functions *pObject = NULL;
+
+    count = Device_Object_List_Count();
+    if (Object_List_Cache_Valid && (count == Object_List_Cache_Count) &&
+        (Object_List_Cache_Device_Instance ==
+            Device_Object_Instance_Number())) {
+        return true;
+    }
+    Object_List_Cache_Valid = false;
+    if (count > Object_List_Cache_Size) {
+        cache = bacnet_realloc(
+            Object_List_Cache, count * sizeof(BACNET_OBJECT_ID));
+        if (!cache) {
+            return false;
+        }
+        Object_List_Cache = cache;
+        Object_List_Cache_Size = count;
+    }
+    pObject = Object_Table;
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        if (pObject->Object_Count) {
+            type_count = pObject->Object_Count();
+            if (pObject->Object_Iterator) {
+                object_index = pObject->Object_Iterator(~(unsigned)0);
+            } else {
+                object_index = 0;
+            }
+            for (type_index = 0;
+                 (type_index < type_count) && (cache_index < count);
+                 type_index++) {
+                if (pObject->Object_Index_To_Instance) {
+                    Object_List_Cache[cache_index].type = pObject->Object_Type;
+                    Object_List_Cache[cache_index].instance =
+                        pObject->Object_Index_To_Instance(object_index);
+                } else {
+                    /* not found, as when walking the object types */
+                    Object_List_Cache[cache_index].type =
+                        MAX_BACNET_OBJECT_TYPE;
+                    Object_List_Cache[cache_index].instance =
+                        BACNET_MAX_INSTANCE;
+                }
+                cache_index++;
+                if (pObject->Object_Iterator) {
+                    object_index = pObject->Object_Iterator(object_index);
+                } else {
+                    object_index++;
+                }
+            }
+        }
+        pObject++;
+    }
+    Object_List_Cache_Count = count;
+    Object_List_Cache_Device_Instance = Device_Object_Instance_Number();
+    Object_List_Cache_Valid = true;
+
+    return true;
+}
+
+/** Lookup the Object at the given array index in the Device's Object List.
+ * Even though we don't keep a single linear array of objects in each object
+ * type, this method acts as though we do, using a cached copy of the
+ * concatenated array of all of our object type arrays.
+ *
+ * @param array_index [in] The desired array index (1 to N)
+ * @param object_type [out] The object's type, if found.
+ * @param instance [out] The object's instance number, if found.
+ * @return True if found, else false.
+ */
+bool Device_Object_List_Identifier(
+    uint32_t array_index, BACNET_OBJECT_TYPE *object_type, uint32_t *instance)
+{
+    BACNET_OBJECT_ID *object_id;
+#ifdef BAC_ROUTING
+    void *database = Routed_Device_Database();
+#endif
+
+    /* array index zero is length - so invalid */
+    if (array_index == 0) {
+        return false;
+    }
+#ifdef BAC_ROUTING
+    if (database) {
+        if (array_index == 1) {
+            *object_type = OBJECT_DEVICE;
+            *instance = Device_Object_Instance_Number();
+            return true;
+        }
+        return Routed_Device_Database_Object_List_Identifier(
+            database, array_index - 1, object_type, instance);
+    }
+#endif
+    if (!Device_Object_List_Cache_Update()) {
+        return Device_Object_List_Walk(array_index, object_type, instance);
+    }
+    if (array_index > Object_List_Cache_Count) {
+        return false;
+    }
+    object_id = &Object_List_Cache[array_index - 1];
+    if (object_id->type >= MAX_BACNET_OBJECT_TYPE) {
+        return false;
+    }
+    *object_type = object_id->type;
+    *instance = object_id->instance;
+
+    return true;
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -1083,6 +1361,170 @@ int Device_Object_List_Element_Encode(
     return apdu_len;
 }
 
+/** Hash an object name for the Object_Name index, FNV-1a
+ *
+ * @param object_name [in] the object name
+ * @return the hash of the encoding and characters of the name
+ */
+static uint32_t Object_Name_Hash(BACNET_CHARACTER_STRING *object_name)
+{
+    uint32_t hash = 2166136261UL;
+    const char *value;
+    size_t length, i;
+
+    hash = (hash ^ characterstring_encoding(object_name)) * 16777619UL;
+    value = characterstring_value(object_name);
+    length = characterstring_length(object_name);
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)value[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+/** Get the name of an object for the Object_Name index
+ *
+ * @param object_type [in] object type
+ * @param object_instance [in] object instance number
+ * @param object_name [out] the object name
+ * @return true if the object has a name
+ */
+static bool Object_Name_Index_Name(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_CHARACTER_STRING *object_name)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Objects_Find_Functions(object_type);
+    if ((pObject != NULL) && (pObject->Object_Name != NULL)) {
+        return pObject->Object_Name(object_instance, object_name);
+    }
+
+    return false;
+}
+
+/** Add an entry of the Object_Name index to the bucket of its name,
+ *  or to none if the object has no name
+ *
+ * @param index [in] entry of the Object_Name index
+ */
+static void Object_Name_Index_Link(uint32_t index)
+{
+    struct object_name_index_entry *entry = &Object_Name_Index[index];
+    BACNET_CHARACTER_STRING object_name;
+    uint32_t bucket;
+
+    entry->next = OBJECT_NAME_INDEX_NONE;
+    if (Object_Name_Index_Name(entry->type, entry->instance, &object_name)) {
+        entry->hash = Object_Name_Hash(&object_name);
+        bucket = entry->hash & (Object_Name_Index_Buckets - 1);
+        entry->next = Object_Name_Index_Bucket[bucket];
+        Object_Name_Index_Bucket[bucket] = index;
+    } else {
+        entry->hash = 0;
+    }
+}
+
+/** Build the Object_Name index, if it is stale.
+ *
+ * @return True if the Object_Name index may be used.
+ */
+static bool Device_Object_Name_Index_Update_All(void)
+{
+    struct object_name_index_entry *entries = NULL;
+    uint32_t *buckets = NULL;
+    uint32_t count, bucket_count, i;
+    bool rebuilt;
+
+    rebuilt = !Object_List_Cache_Valid;
+    if (!Device_Object_List_Cache_Update()) {
+        return false;
+    }
+    count = Object_List_Cache_Count;
+    if (Object_Name_Index_Valid && !rebuilt &&
+        (count == Object_Name_Index_Count)) {
+        return true;
+    }
+    Object_Name_Index_Valid = false;
+    if ((count > Object_Name_Index_Size) || !Object_Name_Index) {
+        entries = bacnet_realloc(Object_Name_Index,
+            (count ? count : 1) * sizeof(struct object_name_index_entry));
+        if (!entries) {
+            return false;
+        }
+        Object_Name_Index = entries;
+        Object_Name_Index_Size = count;
+    }
+    /* a power of two, with about one name for each bucket */
+    bucket_count = 16;
+    while ((bucket_count < count) && (bucket_count < (UINT32_MAX / 2))) {
+        bucket_count *= 2;
+    }
+    if (bucket_count != Object_Name_Index_Buckets) {
+        buckets = bacnet_realloc(
+            Object_Name_Index_Bucket, bucket_count * sizeof(uint32_t));
+        if (!buckets) {
+            return false;
+        }
+        Object_Name_Index_Bucket = buckets;
+        Object_Name_Index_Buckets = bucket_count;
+    }
+    for (i = 0; i < Object_Name_Index_Buckets; i++) {
+        Object_Name_Index_Bucket[i] = OBJECT_NAME_INDEX_NONE;
+    }
+    for (i = 0; i < count; i++) {
+        Object_Name_Index[i].type = Object_List_Cache[i].type;
+        Object_Name_Index[i].instance = Object_List_Cache[i].instance;
+        Object_Name_Index_Link(i);
+    }
+    Object_Name_Index_Count = count;
+    Object_Name_Index_Valid = true;
+
+    return true;
+}
+
+/** Update the entry of one object in the Object_Name index, after its
+ *  Object_Name has changed.  WriteProperty of Object_Name does this.
+ *
+ * @param object_type [in] object type
+ * @param object_instance [in] object instance number
+ */
+void Device_Object_Name_Index_Update(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    struct object_name_index_entry *entry = NULL;
+    uint32_t *link = NULL;
+    uint32_t i;
+
+    Structured_View_Subordinate_Cache_Invalidate(object_type, object_instance);
+    if (!Object_Name_Index_Valid) {
+        return;
+    }
+    for (i = 0; i < Object_Name_Index_Count; i++) {
+        entry = &Object_Name_Index[i];
+        if ((entry->type == object_type) &&
+            (entry->instance == object_instance)) {
+            break;
+        }
+    }
+    if (i == Object_Name_Index_Count) {
+        /* not in the index, so rebuild it when next used */
+        Object_Name_Index_Valid = false;
+        return;
+    }
+    /* take the entry out of the bucket of its old name */
+    link = &Object_Name_Index_Bucket[entry->hash &
+        (Object_Name_Index_Buckets - 1)];
+    while (*link != OBJECT_NAME_INDEX_NONE) {
+        if (*link == i) {
+            *link = entry->next;
+            break;
+        }
+        link = &Object_Name_Index[*link].next;
+    }
+    Object_Name_Index_Link(i);
+}
+
 /** Determine if we have an object with the given object_name.
  * If the object_type and object_instance pointers are not null,
  * and the lookup succeeds, they will be given the resulting values.
@@ -1103,7 +1545,30 @@ bool Device_Valid_Object_Name(BACNET_CHARACTER_STRING *object_name1,
     bool check_id = false;
     BACNET_CHARACTER_STRING object_name2;
     struct object_functions *pObject = NULL;
-
+    struct object_name_index_entry *entry = NULL;
+    uint32_t hash = 0;
+
+    if (object_name1 && Device_Object_Name_Index_Update_All()) {
+        hash = Object_Name_Hash(object_name1);
+        i = Object_Name_Index_Bucket[hash & (Object_Name_Index_Buckets - 1)];
+        while (i != OBJECT_NAME_INDEX_NONE) {
+            entry = &Object_Name_Index[i];
+            if ((entry->hash == hash) &&
+                Object_Name_Index_Name(
+                    entry->type, entry->instance, &object_name2) &&
+                characterstring_same(object_name1, &object_name2)) {
+                if (object_type) {
+                    *object_type = entry->type;
+                }
+                if (object_instance) {
+                    *object_instance = entry->instance;
+                }
+                return true;
+            }
+            i = entry->next;
+        }
+        return false;
+    }
     max_objects = Device_Object_List_Count();
     for (i = 1; i <= max_objects; i++) {
         check_id = Device_Object_List_Identifier(i, &type, &instance);
@@ -1137,6 +1602,17 @@ bool Device_Valid_Object_Id(
 {
     bool status = false; /* return value */
     struct object_functions *pObject = NULL;
+#ifdef BAC_ROUTING
+    void *database = NULL;
+
+    if (object_type != OBJECT_DEVICE) {
+        database = Routed_Device_Database();
+    }
+    if (database) {
+        return Routed_Device_Database_Valid_Object_Id(
+            database, object_type, object_instance);
+    }
+#endif
 
     pObject = Device_Objects_Find_Functions(object_type);
     if ((pObject != NULL) && (pObject->Object_Valid_Instance != NULL)) {
@@ -1167,15 +1643,60 @@ bool Device_Object_Name_Copy(BACNET_OBJECT_TYPE object_type,
     return found;
 }
 
+/** Get the Object_Name of a subordinate of a Structured View object,
+ *  if the subordinate is in this device.
+ *
+ * @param device_instance [in] device instance of the subordinate
+ * @param object_type [in] object type of the subordinate
+ * @param object_instance [in] object instance number of the subordinate
+ * @param object_name [out] the object name
+ * @return true if the subordinate is in this device, and has a name
+ */
+static bool Device_Subordinate_Object_Name(uint32_t device_instance,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_CHARACTER_STRING *object_name)
+{
+    if (device_instance != Device_Object_Instance_Number()) {
+        return false;
+    }
+
+    return Device_Object_Name_Copy(object_type, object_instance, object_name);
+}
+
 static void Update_Current_Time(void)
 {
     datetime_local(
         &Local_Date, &Local_Time, &UTC_Offset, &Daylight_Savings_Status);
 }
 
-void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
+/**
+ * @brief Read the local date and time from the OS into the clock of the
+ *  device, which is then used for the timestamps until the next update.
+ *  Device_Timer() updates the clock, and it can be called after the time
+ *  of the OS is set, or from a timer interrupt.
+ */
+void Device_Clock_Update(void)
 {
     Update_Current_Time();
+    Local_Time_Cached = true;
+}
+
+/**
+ * @brief Get the milliseconds of the clock of the device, counted by
+ *  Device_Timer(), such as to measure an interval without a clock read
+ * @return monotonic milliseconds, which wrap around
+ */
+uint32_t Device_Clock_Milliseconds(void)
+{
+    return Clock_Milliseconds;
+}
+
+void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
+{
+    if (!Local_Time_Cached) {
+        Update_Current_Time();
+    }
 
     DateTime->date = Local_Date;
     DateTime->time = Local_Time;
@@ -1183,7 +1704,9 @@ void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
 
 int32_t Device_UTC_Offset(void)
 {
-    Update_Current_Time();
+    if (!Local_Time_Cached) {
+        Update_Current_Time();
+    }
 
     return UTC_Offset;
 }
@@ -1278,7 +1801,6 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
 {
     int apdu_len = 0; /* return value */
     BACNET_BIT_STRING bit_string = { 0 };
-    BACNET_CHARACTER_STRING char_string = { 0 };
     uint32_t i = 0;
     uint32_t count = 0;
     uint8_t *apdu = NULL;
@@ -1304,41 +1826,34 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = encode_application_enumerated(&apdu[0], OBJECT_DEVICE);
             break;
         case PROP_DESCRIPTION:
-            characterstring_init_ansi(&char_string, Description);
             apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+                encode_application_character_string_ansi(&apdu[0], Description);
             break;
         case PROP_SYSTEM_STATUS:
             apdu_len = encode_application_enumerated(&apdu[0], System_Status);
             break;
         case PROP_VENDOR_NAME:
-            characterstring_init_ansi(&char_string, Vendor_Name);
             apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+                encode_application_character_string_ansi(&apdu[0], Vendor_Name);
             break;
         case PROP_VENDOR_IDENTIFIER:
             apdu_len = encode_application_unsigned(&apdu[0], Vendor_Identifier);
             break;
         case PROP_MODEL_NAME:
-            characterstring_init_ansi(&char_string, Model_Name);
             apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+                encode_application_character_string_ansi(&apdu[0], Model_Name);
             break;
         case PROP_FIRMWARE_REVISION:
-            characterstring_init_ansi(&char_string, BACnet_Version);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            apdu_len = encode_application_character_string_ansi(
+                &apdu[0], BACnet_Version);
             break;
         case PROP_APPLICATION_SOFTWARE_VERSION:
-            characterstring_init_ansi(
-                &char_string, Application_Software_Version);
-            apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+            apdu_len = encode_application_character_string_ansi(
+                &apdu[0], Application_Software_Version);
             break;
         case PROP_LOCATION:
-            characterstring_init_ansi(&char_string, Location);
             apdu_len =
-                encode_application_character_string(&apdu[0], &char_string);
+                encode_application_character_string_ansi(&apdu[0], Location);
             break;
         case PROP_LOCAL_TIME:
             Update_Current_Time();
@@ -1421,6 +1936,16 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
         case PROP_NUMBER_OF_APDU_RETRIES:
             apdu_len = encode_application_unsigned(&apdu[0], apdu_retries());
             break;
+#if BACNET_SEGMENTATION_ENABLED
+        case PROP_MAX_SEGMENTS_ACCEPTED:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], BACNET_MAX_SEGMENTS_ACCEPTED);
+            break;
+        case PROP_APDU_SEGMENT_TIMEOUT:
+            apdu_len =
+                encode_application_unsigned(&apdu[0], apdu_segment_timeout());
+            break;
+#endif
         case PROP_DEVICE_ADDRESS_BINDING:
             apdu_len = address_list_encode(&apdu[0], apdu_max);
             break;
@@ -1463,6 +1988,36 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             apdu_len = handler_cov_encode_subscriptions(&apdu[0], apdu_max);
             break;
         default:
+#if BACNET_APDU_STATS && BACNET_APDU_STATS_PROPERTIES
+            if (bacnet_apdu_stats_property(rpdata->object_property)) {
+                apdu_len = bacnet_apdu_stats_property_encode(
+                    rpdata->object_property, rpdata->array_index, apdu,
+                    apdu_max);
+                if (apdu_len == BACNET_STATUS_ABORT) {
+                    rpdata->error_code =
+                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                } else if (apdu_len == BACNET_STATUS_ERROR) {
+                    rpdata->error_class = ERROR_CLASS_PROPERTY;
+                    rpdata->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+                }
+                break;
+            }
+#endif
+#if BACNET_MEMSTATS && BACNET_MEMSTATS_PROPERTIES
+            if (bacnet_memstats_property(rpdata->object_property)) {
+                apdu_len = bacnet_memstats_property_encode(
+                    rpdata->object_property, rpdata->array_index, apdu,
+                    apdu_max);
+                if (apdu_len == BACNET_STATUS_ABORT) {
+                    rpdata->error_code =
+                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                } else if (apdu_len == BACNET_STATUS_ERROR) {
+                    rpdata->error_class = ERROR_CLASS_PROPERTY;
+                    rpdata->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+                }
+                break;
+            }
+#endif
             rpdata->error_class = ERROR_CLASS_PROPERTY;
             rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
             apdu_len = BACNET_STATUS_ERROR;
@@ -1470,6 +2025,12 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     }
     /*  only array properties can have array options */
     if ((apdu_len >= 0) && (rpdata->object_property != PROP_OBJECT_LIST) &&
+#if BACNET_APDU_STATS && BACNET_APDU_STATS_PROPERTIES
+        !bacnet_apdu_stats_property(rpdata->object_property) &&
+#endif
+#if BACNET_MEMSTATS && BACNET_MEMSTATS_PROPERTIES
+        !bacnet_memstats_property(rpdata->object_property) &&
+#endif
         (rpdata->array_index != BACNET_ARRAY_ALL)) {
         rpdata->error_class = ERROR_CLASS_PROPERTY;
         rpdata->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
@@ -1532,6 +2093,133 @@ static int Read_Property_Common(
     return apdu_len;
 }
 
+#if BACNET_PROPERTY_CACHE_SIZE
+/**
+ * @brief Determine if the encoded value of a property may be cached.
+ *  Object_Name, Description, Units and the like are not cached, because
+ *  the objects have setters that change them outside of WriteProperty.
+ * @param object_property [in] property identifier
+ * @return true if the property does not change while the object exists
+ */
+static bool Device_Property_Cacheable(BACNET_PROPERTY_ID object_property)
+{
+    switch (object_property) {
+        case PROP_OBJECT_TYPE:
+        case PROP_PROPERTY_LIST:
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Find the cache slot of an object property
+ * @param rpdata [in] ReadProperty data with object and property
+ * @return pointer to the slot, which may hold some other property
+ */
+static struct property_cache_entry *
+Device_Property_Cache_Slot(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    uint32_t hash;
+
+    hash = rpdata->object_instance * 2654435761UL;
+    hash ^= ((uint32_t)rpdata->object_type << 16) ^
+        ((uint32_t)rpdata->object_property * 40503UL);
+
+    return &Property_Cache[hash % BACNET_PROPERTY_CACHE_SIZE];
+}
+
+/**
+ * @brief Copy a cached encoded property value into the ReadProperty data
+ * @param rpdata [in,out] ReadProperty data
+ * @return length of the copied value, or 0 if it is not cached
+ */
+static int Device_Property_Cache_Read(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    struct property_cache_entry *entry;
+
+    if ((rpdata->array_index != BACNET_ARRAY_ALL) ||
+        !Device_Property_Cacheable(rpdata->object_property)) {
+        return 0;
+    }
+    entry = Device_Property_Cache_Slot(rpdata);
+    if ((entry->length == 0) ||
+        (entry->length > rpdata->application_data_len) ||
+        (entry->object_type != rpdata->object_type) ||
+        (entry->object_instance != rpdata->object_instance) ||
+        (entry->object_property != rpdata->object_property)) {
+        return 0;
+    }
+    memcpy(rpdata->application_data, entry->data, entry->length);
+
+    return entry->length;
+}
+
+/**
+ * @brief Keep an encoded property value for the next read
+ * @param rpdata [in] ReadProperty data holding the encoded value
+ * @param apdu_len [in] length of the encoded value
+ */
+static void
+Device_Property_Cache_Store(BACNET_READ_PROPERTY_DATA *rpdata, int apdu_len)
+{
+    struct property_cache_entry *entry;
+
+    if ((apdu_len <= 0) || (apdu_len > BACNET_PROPERTY_CACHE_DATA_SIZE) ||
+        (rpdata->array_index != BACNET_ARRAY_ALL) ||
+        !Device_Property_Cacheable(rpdata->object_property)) {
+        return;
+    }
+    entry = Device_Property_Cache_Slot(rpdata);
+    entry->object_type = rpdata->object_type;
+    entry->object_instance = rpdata->object_instance;
+    entry->object_property = rpdata->object_property;
+    memcpy(entry->data, rpdata->application_data, (size_t)apdu_len);
+    entry->length = (uint16_t)apdu_len;
+}
+#endif
+
+/**
+ * @brief Drop the cached encoded property values of one object.  Call this
+ *  after changing Object_Name, Description, Units or the Property_List of
+ *  an object other than by WriteProperty.
+ * @param object_type [in] object type
+ * @param object_instance [in] object instance number
+ */
+void Device_Property_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+#if BACNET_PROPERTY_CACHE_SIZE
+    unsigned i;
+
+    for (i = 0; i < BACNET_PROPERTY_CACHE_SIZE; i++) {
+        if ((Property_Cache[i].object_type == object_type) &&
+            (Property_Cache[i].object_instance == object_instance)) {
+            Property_Cache[i].length = 0;
+        }
+    }
+#else
+    (void)object_type;
+    (void)object_instance;
+#endif
+}
+
+/**
+ * @brief Drop all of the cached encoded property values
+ */
+void Device_Property_Cache_Clear(void)
+{
+#if BACNET_PROPERTY_CACHE_SIZE
+    unsigned i;
+
+    for (i = 0; i < BACNET_PROPERTY_CACHE_SIZE; i++) {
+        Property_Cache[i].length = 0;
+    }
+#endif
+}
+
 /** Looks up the requested Object and Property, and encodes its Value in an
  * APDU.
  * @ingroup ObjIntf
@@ -1545,6 +2233,17 @@ int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 {
     int apdu_len = BACNET_STATUS_ERROR;
     struct object_functions *pObject = NULL;
+#ifdef BAC_ROUTING
+    void *database = NULL;
+
+    /* objects of a routed Device are paged in from its database */
+    if (rpdata->object_type != OBJECT_DEVICE) {
+        database = Routed_Device_Database();
+    }
+    if (database) {
+        return Routed_Device_Database_Read_Property(database, rpdata);
+    }
+#endif
 
     /* initialize the default return values */
     rpdata->error_class = ERROR_CLASS_OBJECT;
@@ -1553,7 +2252,20 @@ int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     if (pObject != NULL) {
         if (pObject->Object_Valid_Instance &&
             pObject->Object_Valid_Instance(rpdata->object_instance)) {
+#if BACNET_PROPERTY_CACHE_SIZE
+            if ((rpdata->application_data == NULL) ||
+                (rpdata->application_data_len == 0)) {
+                return 0;
+            }
+            apdu_len = Device_Property_Cache_Read(rpdata);
+            if (apdu_len > 0) {
+                return apdu_len;
+            }
             apdu_len = Read_Property_Common(pObject, rpdata);
+            Device_Property_Cache_Store(rpdata, apdu_len);
+#else
+            apdu_len = Read_Property_Common(pObject, rpdata);
+#endif
         } else {
             rpdata->error_class = ERROR_CLASS_OBJECT;
             rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
@@ -1629,6 +2341,15 @@ bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 apdu_timeout_set((uint16_t)value.type.Unsigned_Int);
             }
             break;
+#if BACNET_SEGMENTATION_ENABLED
+        case PROP_APDU_SEGMENT_TIMEOUT:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                apdu_segment_timeout_set((uint16_t)value.type.Unsigned_Int);
+            }
+            break;
+#endif
         case PROP_VENDOR_IDENTIFIER:
             status = write_property_type_valid(
                 wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
@@ -1814,6 +2535,9 @@ bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
         case PROP_OBJECT_LIST:
         case PROP_MAX_APDU_LENGTH_ACCEPTED:
         case PROP_SEGMENTATION_SUPPORTED:
+#if BACNET_SEGMENTATION_ENABLED
+        case PROP_MAX_SEGMENTS_ACCEPTED:
+#endif
         case PROP_DEVICE_ADDRESS_BINDING:
         case PROP_DATABASE_REVISION:
         case PROP_ACTIVE_COV_SUBSCRIPTIONS:
@@ -1832,6 +2556,37 @@ bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
+/**
+ * @brief Handles a write of the Present_Value with a value of the native
+ *  type of the object, through the typed Value_Set function of the object
+ *  rather than its WriteProperty handler
+ * @param wp_data [in] WriteProperty data structure
+ * @param Object_Value_Set object specific function to set the value
+ * @return True if the value was set, else False to use the WriteProperty
+ *  handler of the object, which also gives the error
+ */
+static bool Device_Write_Property_Present_Value(
+    const BACNET_WRITE_PROPERTY_DATA *wp_data,
+    object_value_set_function Object_Value_Set)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+
+    if (!Object_Value_Set || (wp_data->application_data_len <= 0)) {
+        return false;
+    }
+    len = bacapp_decode_application_data(
+        (uint8_t *)wp_data->application_data,
+        (uint32_t)wp_data->application_data_len, &value);
+    if (len != wp_data->application_data_len) {
+        return false;
+    }
+
+    return Object_Value_Set(wp_data->object_instance,
+        wp_data->object_property, wp_data->array_index, &value,
+        wp_data->priority);
+}
+
 /**
  * @brief Handles the writing of the object name property
  * @param wp_data [in,out] WriteProperty data structure
@@ -1912,6 +2667,16 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
     bool status = false; /* Ever the pessimist! */
     struct object_functions *pObject = NULL;
+#ifdef BAC_ROUTING
+    void *database = NULL;
+
+    if (wp_data->object_type != OBJECT_DEVICE) {
+        database = Routed_Device_Database();
+    }
+    if (database) {
+        return Routed_Device_Database_Write_Property(database, wp_data);
+    }
+#endif
 
     /* initialize the default return values */
     wp_data->error_class = ERROR_CLASS_OBJECT;
@@ -1931,9 +2696,23 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                 if (wp_data->object_property == PROP_OBJECT_NAME) {
                     status = Device_Write_Property_Object_Name(
                         wp_data, pObject->Object_Write_Property);
+                } else if ((wp_data->object_property ==
+                               PROP_PRESENT_VALUE) &&
+                    Device_Write_Property_Present_Value(
+                        wp_data, pObject->Object_Value_Set)) {
+                    status = true;
                 } else {
                     status = pObject->Object_Write_Property(wp_data);
                 }
+                if (status) {
+                    Device_Property_Cache_Invalidate(
+                        wp_data->object_type, wp_data->object_instance);
+                    if (wp_data->object_property == PROP_OBJECT_NAME) {
+                        Device_Object_Name_Index_Update(
+                            wp_data->object_type, wp_data->object_instance);
+                    }
+                    snapshot_write_property(wp_data);
+                }
             } else {
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
                 wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
@@ -1950,6 +2729,151 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return (status);
 }
 
+/**
+ * @brief Find the typed value functions of an object type, unless the
+ *  object is in a routed device, which is read and written through
+ *  ReadProperty and WriteProperty
+ * @param object_type [in] object type
+ * @return the functions of the object type, or NULL
+ */
+static struct object_functions *Device_Objects_Value_Functions(
+    BACNET_OBJECT_TYPE object_type)
+{
+#ifdef BAC_ROUTING
+    if ((object_type != OBJECT_DEVICE) && Routed_Device_Database()) {
+        return NULL;
+    }
+#endif
+
+    return Device_Objects_Find_Functions(object_type);
+}
+
+/**
+ * @brief Get the value of a property of an object in this device, for
+ *  the consumers in this device such as the Trend Log.  Object types with
+ *  a Value_Get function copy the value without encoding it; the others
+ *  are read with ReadProperty and the first value is decoded.
+ * @param object_type [in] object type
+ * @param object_instance [in] object instance number
+ * @param object_property [in] property identifier
+ * @param array_index [in] array index, or BACNET_ARRAY_ALL
+ * @param value [out] the value, with the tag MAX_BACNET_APPLICATION_TAG
+ *  if it was read but is not an application value
+ * @param error_class [out] the error class, if the property was not read
+ * @param error_code [out] the error code, if the property was not read
+ * @return true if the property was read
+ */
+bool Device_Object_Property_Value(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    uint8_t apdu[MAX_APDU];
+    struct object_functions *pObject = NULL;
+    int len;
+
+    if (!value) {
+        return false;
+    }
+    pObject = Device_Objects_Value_Functions(object_type);
+    if (pObject && pObject->Object_Value_Get &&
+        pObject->Object_Value_Get(
+            object_instance, object_property, array_index, value)) {
+        return true;
+    }
+    rpdata.object_type = object_type;
+    rpdata.object_instance = object_instance;
+    rpdata.object_property = object_property;
+    rpdata.array_index = array_index;
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    len = Device_Read_Property(&rpdata);
+    if (len < 0) {
+        if (error_class) {
+            *error_class = rpdata.error_class;
+        }
+        if (error_code) {
+            *error_code = rpdata.error_code;
+        }
+        return false;
+    }
+    if (bacapp_decode_application_data(apdu, (uint32_t)len, value) <= 0) {
+        value->tag = MAX_BACNET_APPLICATION_TAG;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set the value of a property of an object in this device, for
+ *  the consumers in this device.  Object types with a Value_Set function
+ *  take the value without decoding it; the others are written with
+ *  WriteProperty.  As with the setters of the object types, the change
+ *  is not recorded in the snapshot.
+ * @param object_type [in] object type
+ * @param object_instance [in] object instance number
+ * @param object_property [in] property identifier
+ * @param array_index [in] array index, or BACNET_ARRAY_ALL
+ * @param value [in] the value
+ * @param priority [in] BACnet priority 1..16
+ * @param error_class [out] the error class, if the property was not set
+ * @param error_code [out] the error code, if the property was not set
+ * @return true if the property was set
+ */
+bool Device_Object_Property_Value_Set(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    struct object_functions *pObject = NULL;
+    bool status = false;
+    int len;
+
+    if (!value) {
+        return false;
+    }
+    pObject = Device_Objects_Value_Functions(object_type);
+    if (pObject && pObject->Object_Value_Set &&
+        pObject->Object_Value_Set(object_instance, object_property,
+            array_index, value, priority)) {
+        Device_Property_Cache_Invalidate(object_type, object_instance);
+        return true;
+    }
+    wp_data.object_type = object_type;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = object_property;
+    wp_data.array_index = array_index;
+    wp_data.priority = priority;
+    len = bacapp_encode_application_data(NULL, value);
+    if ((len > 0) && ((size_t)len <= sizeof(wp_data.application_data))) {
+        wp_data.application_data_len =
+            bacapp_encode_application_data(wp_data.application_data, value);
+        status = Device_Write_Property(&wp_data);
+    } else {
+        wp_data.error_class = ERROR_CLASS_PROPERTY;
+        wp_data.error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+    }
+    if (!status) {
+        if (error_class) {
+            *error_class = wp_data.error_class;
+        }
+        if (error_code) {
+            *error_code = wp_data.error_code;
+        }
+    }
+
+    return status;
+}
+
 /**
  * @brief AddListElement from an object list property
  * @param list_element [in] Pointer to the BACnet_List_Element_Data structure,
@@ -2091,6 +3015,80 @@ void Device_COV_Clear(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
     }
 }
 
+/**
+ * @brief Write the list of initial values of a CreateObject request to
+ *  the object that it created, as the values were encoded in the request.
+ *  The values are written without the updates of each WriteProperty of
+ *  the property cache and Object_Name index, since the single database
+ *  revision of the created object updates them all.
+ * @param pObject - the functions of the object type
+ * @param object_instance - the created object
+ * @param data - CreateObject data, with the first failed element and
+ *  its error if a value fails
+ * @param snapshot - true to only keep each value in the snapshot, after
+ *  all of the values were written
+ * @return true if all of the values were written
+ */
+static bool Device_Create_Object_Initial_Values(
+    struct object_functions *pObject,
+    uint32_t object_instance,
+    BACNET_CREATE_OBJECT_DATA *data,
+    bool snapshot)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_UNSIGNED_INTEGER element = 0;
+    int apdu_len = 0;
+    int len = 0;
+    bool status = true;
+
+    wp_data.object_type = data->object_type;
+    wp_data.object_instance = object_instance;
+    while (status && (apdu_len < data->application_data_len)) {
+        element++;
+        len = create_object_initial_value_decode(
+            &data->application_data[apdu_len],
+            (uint32_t)(data->application_data_len - apdu_len), &wp_data);
+        if (len <= 0) {
+            wp_data.error_class = ERROR_CLASS_PROPERTY;
+            wp_data.error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            status = false;
+            break;
+        }
+        apdu_len += len;
+        if (snapshot) {
+            snapshot_write_property(&wp_data);
+            continue;
+        }
+        if (!pObject->Object_Write_Property) {
+            wp_data.error_class = ERROR_CLASS_PROPERTY;
+            wp_data.error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+            status = false;
+#if (BACNET_PROTOCOL_REVISION >= 14)
+        } else if (wp_data.object_property == PROP_PROPERTY_LIST) {
+            wp_data.error_class = ERROR_CLASS_PROPERTY;
+            wp_data.error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+            status = false;
+#endif
+        } else if (wp_data.object_property == PROP_OBJECT_NAME) {
+            status = Device_Write_Property_Object_Name(
+                &wp_data, pObject->Object_Write_Property);
+        } else if ((wp_data.object_property == PROP_PRESENT_VALUE) &&
+            Device_Write_Property_Present_Value(
+                &wp_data, pObject->Object_Value_Set)) {
+            status = true;
+        } else {
+            status = pObject->Object_Write_Property(&wp_data);
+        }
+    }
+    if (!status) {
+        data->first_failed_element_number = element;
+        data->error_class = wp_data.error_class;
+        data->error_code = wp_data.error_code;
+    }
+
+    return status;
+}
+
 /**
  * @brief Creates a child object, if supported
  * @ingroup ObjHelpers
@@ -2117,11 +3115,13 @@ bool Device_Create_Object(BACNET_CREATE_OBJECT_DATA *data)
             data->error_class = ERROR_CLASS_OBJECT;
             data->error_code = ERROR_CODE_OBJECT_IDENTIFIER_ALREADY_EXISTS;
         } else {
-            if (data->list_of_initial_values) {
-                /* FIXME: add support for writing to list of initial values */
+            if ((data->list_of_initial_values && !data->application_data) ||
+                (data->application_data_len && !pObject->Object_Delete)) {
                 /*  A property specified by the Property_Identifier in the
                     List of Initial Values does not support initialization
-                    during the CreateObject service. */
+                    during the CreateObject service, since the values are
+                    not encoded, or the object could not be deleted if one
+                    of them fails. */
                 data->first_failed_element_number = 1;
                 data->error_class = ERROR_CLASS_PROPERTY;
                 data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
@@ -2133,10 +3133,17 @@ bool Device_Create_Object(BACNET_CREATE_OBJECT_DATA *data)
                     for the new object.*/
                     data->error_class = ERROR_CLASS_RESOURCES;
                     data->error_code = ERROR_CODE_NO_SPACE_FOR_OBJECT;
+                } else if (!Device_Create_Object_Initial_Values(
+                               pObject, object_instance, data, false)) {
+                    /* the object shall not be created */
+                    pObject->Object_Delete(object_instance);
                 } else {
                     /* required by ACK */
                     data->object_instance = object_instance;
                     Device_Inc_Database_Revision();
+                    snapshot_create_object(data->object_type, object_instance);
+                    Device_Create_Object_Initial_Values(
+                        pObject, object_instance, data, true);
                     status = true;
                 }
             }
@@ -2175,6 +3182,8 @@ bool Device_Delete_Object(BACNET_DELETE_OBJECT_DATA *data)
             status = pObject->Object_Delete(data->object_instance);
             if (status) {
                 Device_Inc_Database_Revision();
+                snapshot_delete_object(
+                    data->object_type, data->object_instance);
             } else {
                 /* The object exists but cannot be deleted. */
                 data->error_class = ERROR_CLASS_OBJECT;
@@ -2194,30 +3203,240 @@ bool Device_Delete_Object(BACNET_DELETE_OBJECT_DATA *data)
     return status;
 }
 
+/* objects being sorted by Device_Objects_Provision() */
+static const BACNET_OBJECT_SPEC *Provision_Spec;
+
+/**
+ * @brief Compare two objects of Device_Objects_Provision() by their
+ *  object type and instance
+ * @param a - index of the first object
+ * @param b - index of the second object
+ * @return negative, zero, or positive, as for qsort()
+ */
+static int Device_Objects_Provision_Compare(const void *a, const void *b)
+{
+    const BACNET_OBJECT_SPEC *spec_a = &Provision_Spec[*(const unsigned *)a];
+    const BACNET_OBJECT_SPEC *spec_b = &Provision_Spec[*(const unsigned *)b];
+
+    if (spec_a->object_type != spec_b->object_type) {
+        return (spec_a->object_type < spec_b->object_type) ? -1 : 1;
+    }
+    if (spec_a->object_instance != spec_b->object_instance) {
+        return (spec_a->object_instance < spec_b->object_instance) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Creates many objects at once, such as from a configuration at
+ *  start up.  The objects are created in the order of their object type
+ *  and instance, so that each one is appended to the list of its type,
+ *  and the Object_List and the Object_Name index are built once at the
+ *  end, with a single change of the Database_Revision.  An object that
+ *  already exists is set up again.
+ * @ingroup ObjHelpers
+ * @param spec - the objects to create
+ * @param count - number of objects
+ * @param setup - function that sets up each object, or NULL
+ * @return number of objects that were created and set up
+ */
+unsigned Device_Objects_Provision(const BACNET_OBJECT_SPEC *spec,
+    unsigned count,
+    object_provision_function setup)
+{
+    struct object_functions *pObject = NULL;
+    unsigned *order;
+    unsigned provisioned = 0;
+    unsigned i, n;
+    uint32_t object_instance;
+
+    if (!spec || (count == 0)) {
+        return 0;
+    }
+    order = bacnet_malloc(count * sizeof(unsigned));
+    if (order) {
+        for (i = 0; i < count; i++) {
+            order[i] = i;
+        }
+        Provision_Spec = spec;
+        qsort(order, count, sizeof(unsigned), Device_Objects_Provision_Compare);
+        Provision_Spec = NULL;
+    }
+    for (i = 0; i < count; i++) {
+        /* without the memory to sort, create them in the given order */
+        n = order ? order[i] : i;
+        if (!pObject || (pObject->Object_Type != spec[n].object_type)) {
+            pObject = Device_Objects_Find_Functions(spec[n].object_type);
+        }
+        if (!pObject) {
+            continue;
+        }
+        object_instance = spec[n].object_instance;
+        if (!pObject->Object_Valid_Instance ||
+            !pObject->Object_Valid_Instance(object_instance)) {
+            if (!pObject->Object_Create) {
+                continue;
+            }
+            object_instance = pObject->Object_Create(object_instance);
+            if (object_instance == BACNET_MAX_INSTANCE) {
+                continue;
+            }
+        }
+        if (!setup || setup(&spec[n], object_instance)) {
+            provisioned++;
+        }
+    }
+    bacnet_free(order);
+    Device_Inc_Database_Revision();
+    (void)Device_Object_Name_Index_Update_All();
+
+    return provisioned;
+}
+
 #if defined(INTRINSIC_REPORTING)
-void Device_local_reporting(void)
+#if BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED
+/* objects to evaluate in the next pass of Device_local_reporting() */
+static KEY Intrinsic_Reporting_Queue[BACNET_INTRINSIC_REPORTING_QUEUE_SIZE];
+static unsigned Intrinsic_Reporting_Queue_Count;
+/* an object did not fit into the queue */
+static bool Intrinsic_Reporting_Queue_Overflow;
+/* object types that request their evaluation, and are not polled */
+static uint8_t Intrinsic_Reporting_Types[(MAX_BACNET_OBJECT_TYPE + 7) / 8];
+
+/**
+ * @brief Puts an object into the queue of objects that are evaluated in
+ *  the next pass of Device_local_reporting().  Objects with intrinsic
+ *  reporting call this when their Present_Value or event properties
+ *  change, and each pass while a time delay is counting.  Once an object
+ *  type has requested an evaluation, the objects of that type are only
+ *  evaluated when requested.
+ * @note Call from the same thread as Device_local_reporting().
+ *  When the queue is full, every object is evaluated in the next pass.
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ */
+void Device_Intrinsic_Reporting_Request(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    KEY key;
+    unsigned i;
+
+    if (object_type >= MAX_BACNET_OBJECT_TYPE) {
+        return;
+    }
+    Intrinsic_Reporting_Types[object_type / 8] |= (1 << (object_type % 8));
+    key = KEY_ENCODE(object_type, object_instance);
+    for (i = 0; i < Intrinsic_Reporting_Queue_Count; i++) {
+        if (Intrinsic_Reporting_Queue[i] == key) {
+            /* evaluated once per pass, so that time delays count once */
+            return;
+        }
+    }
+    if (Intrinsic_Reporting_Queue_Count <
+        BACNET_INTRINSIC_REPORTING_QUEUE_SIZE) {
+        Intrinsic_Reporting_Queue[Intrinsic_Reporting_Queue_Count] = key;
+        Intrinsic_Reporting_Queue_Count++;
+    } else {
+        Intrinsic_Reporting_Queue_Overflow = true;
+    }
+}
+
+/**
+ * @brief Determine if an object type is polled by Device_local_reporting()
+ * @param object_type - type of the object
+ * @return true if the objects of the type do not request an evaluation
+ */
+static bool Device_Intrinsic_Reporting_Polled(BACNET_OBJECT_TYPE object_type)
+{
+    if (object_type >= MAX_BACNET_OBJECT_TYPE) {
+        return true;
+    }
+
+    return !(Intrinsic_Reporting_Types[object_type / 8] &
+        (1 << (object_type % 8)));
+}
+#endif
+
+/**
+ * @brief Runs the intrinsic reporting of an object
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ */
+static void Device_Intrinsic_Reporting_Object(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
 {
     struct object_functions *pObject = NULL;
+
+    pObject = Device_Objects_Find_Functions(object_type);
+    if (pObject != NULL) {
+        if (pObject->Object_Valid_Instance &&
+            pObject->Object_Valid_Instance(object_instance)) {
+            if (pObject->Object_Intrinsic_Reporting) {
+                pObject->Object_Intrinsic_Reporting(object_instance);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs the intrinsic reporting of the objects about once a second.
+ *  With BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED, the objects that
+ *  requested an evaluation are evaluated, and the objects of the other
+ *  types are polled.
+ */
+void Device_local_reporting(void)
+{
     uint32_t objects_count = 0;
     uint32_t object_instance = 0;
     BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
     uint32_t idx = 0;
+#if BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED
+    KEY queue[BACNET_INTRINSIC_REPORTING_QUEUE_SIZE];
+    unsigned queue_count = 0;
+    bool poll_all = false;
+    bool poll = false;
+    struct object_functions *pObject = NULL;
+
+    /* take the queue, so that objects may request the next pass */
+    queue_count = Intrinsic_Reporting_Queue_Count;
+    memcpy(queue, Intrinsic_Reporting_Queue, queue_count * sizeof(KEY));
+    Intrinsic_Reporting_Queue_Count = 0;
+    poll_all = Intrinsic_Reporting_Queue_Overflow;
+    Intrinsic_Reporting_Queue_Overflow = false;
+    if (!poll_all) {
+        for (idx = 0; idx < queue_count; idx++) {
+            Device_Intrinsic_Reporting_Object(
+                (BACNET_OBJECT_TYPE)KEY_DECODE_TYPE(queue[idx]),
+                KEY_DECODE_ID(queue[idx]));
+        }
+        /* skip the object list when every type requests its evaluation */
+        pObject = Object_Table;
+        while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+            if (pObject->Object_Intrinsic_Reporting &&
+                Device_Intrinsic_Reporting_Polled(pObject->Object_Type)) {
+                poll = true;
+                break;
+            }
+            pObject++;
+        }
+        if (!poll) {
+            return;
+        }
+    }
+#endif
 
     objects_count = Device_Object_List_Count();
 
     /* loop for all objects */
     for (idx = 1; idx <= objects_count; idx++) {
         Device_Object_List_Identifier(idx, &object_type, &object_instance);
-
-        pObject = Device_Objects_Find_Functions(object_type);
-        if (pObject != NULL) {
-            if (pObject->Object_Valid_Instance &&
-                pObject->Object_Valid_Instance(object_instance)) {
-                if (pObject->Object_Intrinsic_Reporting) {
-                    pObject->Object_Intrinsic_Reporting(object_instance);
-                }
-            }
+#if BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED
+        if (!poll_all && !Device_Intrinsic_Reporting_Polled(object_type)) {
+            continue;
         }
+#endif
+        Device_Intrinsic_Reporting_Object(object_type, object_instance);
     }
 }
 #endif
@@ -2242,6 +3461,19 @@ bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
     return (status);
 }
 
+/** Set the startup profile of Device_Init(), which reports the time that
+ *  the Init function of each object type takes, to find the object types
+ *  that slow the startup.
+ * @param clock [in] clock of the profile, or NULL for none
+ * @param report [in] called with the time of each object type, or NULL
+ */
+void Device_Init_Profile_Set(
+    device_profile_clock_function clock, device_profile_report_function report)
+{
+    Init_Profile_Clock = clock;
+    Init_Profile_Report = report;
+}
+
 /** Initialize the Device Object.
  Initialize the group of object helper functions for any supported Object.
  Initialize each of the Device Object child Object instances.
@@ -2253,6 +3485,12 @@ bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
 void Device_Init(object_functions_t *object_table)
 {
     struct object_functions *pObject = NULL;
+    unsigned long start = 0;
+    unsigned long begin = 0;
+
+    if (Init_Profile_Clock) {
+        start = Init_Profile_Clock();
+    }
     characterstring_init_ansi(&My_Object_Name, "SimpleServer");
     datetime_init();
     if (object_table) {
@@ -2260,16 +3498,35 @@ void Device_Init(object_functions_t *object_table)
     } else {
         Object_Table = &My_Object_Table[0];
     }
+    Device_Objects_Index_Init();
+    Object_List_Cache_Valid = false;
+    Object_Name_Index_Valid = false;
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Init) {
+            if (Init_Profile_Clock) {
+                begin = Init_Profile_Clock();
+            }
             pObject->Object_Init();
+            if (Init_Profile_Clock && Init_Profile_Report) {
+                Init_Profile_Report(
+                    pObject->Object_Type, Init_Profile_Clock() - begin);
+            }
         }
         pObject++;
     }
 #if (BACNET_PROTOCOL_REVISION >= 14)
     Channel_Write_Property_Internal_Callback_Set(Device_Write_Property);
 #endif
+    Structured_View_Subordinate_Name_Callback_Set(
+        Device_Subordinate_Object_Name);
+#if defined(INTRINSIC_REPORTING)
+    Notification_Class_Event_Callback_Set(Event_Log_Notification);
+#endif
+    if (Init_Profile_Clock && Init_Profile_Report) {
+        Init_Profile_Report(
+            MAX_BACNET_OBJECT_TYPE, Init_Profile_Clock() - start);
+    }
 }
 
 bool DeviceGetRRInfo(BACNET_READ_RANGE_DATA *pRequest, /* Info on the request */
@@ -2301,6 +3558,14 @@ bool DeviceGetRRInfo(BACNET_READ_RANGE_DATA *pRequest, /* Info on the request */
             status = true;
             break;
 
+        case PROP_OBJECT_LIST:
+            pInfo->RequestTypes = RR_BY_POSITION;
+            pInfo->Handler = NULL;
+            pInfo->Element_Encode = Device_Object_List_Element_Encode;
+            pInfo->Element_Count = Device_Object_List_Count();
+            status = true;
+            break;
+
         case PROP_ACTIVE_COV_SUBSCRIPTIONS:
             pInfo->RequestTypes = RR_BY_POSITION;
             pRequest->error_class = ERROR_CLASS_PROPERTY;
@@ -2333,6 +3598,8 @@ void Device_Timer(uint16_t milliseconds)
     unsigned count = 0;
     uint32_t instance;
 
+    Clock_Milliseconds += milliseconds;
+    Device_Clock_Update();
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Count) {
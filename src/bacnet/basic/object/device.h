@@ -130,6 +130,65 @@ typedef void (
     *object_timer_function) (
     uint32_t object_instance, uint16_t milliseconds);
 
+/** Gets the value of a property of an object of this type without
+ *  encoding it, for the consumers in this device.
+ * @ingroup ObjHelpers
+ * @param object_instance [in] The object instance number.
+ * @param object_property [in] The property identifier.
+ * @param array_index [in] The array index, or BACNET_ARRAY_ALL.
+ * @param value [out] The value of the property.
+ * @return True if the value was copied, or false if it is read with
+ *  ReadProperty instead.
+ */
+typedef bool (
+    *object_value_get_function) (
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value);
+
+/** Sets the value of a property of an object of this type without
+ *  decoding it, for the consumers in this device.
+ * @ingroup ObjHelpers
+ * @param object_instance [in] The object instance number.
+ * @param object_property [in] The property identifier.
+ * @param array_index [in] The array index, or BACNET_ARRAY_ALL.
+ * @param value [in] The value of the property.
+ * @param priority [in] The BACnet priority 1..16.
+ * @return True if the value was set, or false if it is written with
+ *  WriteProperty instead, which gives the error.
+ */
+typedef bool (
+    *object_value_set_function) (
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority);
+
+/** An object to be created by Device_Objects_Provision(), such as one
+ *  row of a configuration file.
+ * @ingroup ObjHelpers
+ */
+typedef struct bacnet_object_spec {
+    BACNET_OBJECT_TYPE object_type;
+    /* instance number, or BACNET_MAX_INSTANCE for the next free one */
+    uint32_t object_instance;
+    /* data of the configuration, which is given to the setup function */
+    const void *context;
+} BACNET_OBJECT_SPEC;
+
+/** Sets up an object made by Device_Objects_Provision(), such as its
+ *  Object_Name and other properties, with the setters of its object type.
+ * @ingroup ObjHelpers
+ * @param spec [in] the object that was created
+ * @param object_instance [in] instance number of the object
+ * @return true if the object was set up
+ */
+typedef bool (
+    *object_provision_function) (
+    const BACNET_OBJECT_SPEC *spec, uint32_t object_instance);
+
 /** Defines the group of object helper functions for any supported Object.
  * @ingroup ObjHelpers
  * Each Object must provide some implementation of each of these helpers
@@ -160,6 +219,8 @@ typedef struct object_functions {
     create_object_function Object_Create;
     delete_object_function Object_Delete;
     object_timer_function Object_Timer;
+    object_value_get_function Object_Value_Get;
+    object_value_set_function Object_Value_Set;
 } object_functions_t;
 
 /* String Lengths - excluding any nul terminator */
@@ -169,6 +230,20 @@ typedef struct object_functions {
 #define MAX_DEV_VER_LEN  16
 #define MAX_DEV_DESC_LEN 64
 
+/* Number of encoded property values kept by Device_Read_Property()
+   for the properties that do not change while the object exists, which
+   are Object_Type and Property_List. Properties such as Object_Name,
+   Description and Units are not cached, since the *_Set() functions of
+   the objects change them without telling the Device object.
+   0 disables the cache. */
+#ifndef BACNET_PROPERTY_CACHE_SIZE
+#define BACNET_PROPERTY_CACHE_SIZE 0
+#endif
+/* Largest encoded property value kept in the cache, in octets */
+#ifndef BACNET_PROPERTY_CACHE_DATA_SIZE
+#define BACNET_PROPERTY_CACHE_DATA_SIZE 64
+#endif
+
 /** Structure to define the Object Properties common to all Objects. */
 typedef struct commonBacObj_s {
 
@@ -212,6 +287,62 @@ typedef struct devObj_s {
     uint32_t Database_Revision;
 } DEVICE_OBJECT_DATA;
 
+/** Callbacks of the object database of each routed Device of a gateway,
+ *  other than the Device object itself, which a provider implements to
+ *  page the objects in from its backing store, such as the registers of
+ *  a Modbus device.  The database of a routed Device is created on the
+ *  first access to it, and is released when it is the least recently
+ *  used of the resident databases and another one is needed.
+ */
+typedef struct routed_device_database_provider {
+    /** Create the database of a Device, or return NULL if it has none */
+    void *(*Create)(uint32_t device_instance);
+    /** Release the database, such as writing it back to the store */
+    void (*Release)(void *database);
+    /** Number of objects in the database */
+    unsigned (*Object_Count)(void *database);
+    /** Object at the given array index of the Object_List, 1 to N */
+    bool (*Object_List_Identifier)(void *database,
+        uint32_t array_index,
+        BACNET_OBJECT_TYPE *object_type,
+        uint32_t *instance);
+    /** Determine if the database has the object */
+    bool (*Valid_Object_Id)(void *database,
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t instance);
+    /** ReadProperty of an object of the database */
+    int (*Read_Property)(void *database, BACNET_READ_PROPERTY_DATA *rpdata);
+    /** WriteProperty of an object of the database, or NULL if read-only */
+    bool (*Write_Property)(void *database,
+        BACNET_WRITE_PROPERTY_DATA *wp_data);
+} ROUTED_DEVICE_DATABASE_PROVIDER;
+
+/* number of routed Device databases that are resident at once */
+#ifndef ROUTED_DEVICE_DATABASE_MAX
+#define ROUTED_DEVICE_DATABASE_MAX 64
+#endif
+
+/** Reads a clock for the startup profile of Device_Init(), such as a
+ *  clock in microseconds.
+ * @ingroup ObjHelpers
+ * @return the time of the clock
+ */
+typedef unsigned long (
+    *device_profile_clock_function) (
+    void);
+
+/** Reports the time that the Init function of one object type took in
+ *  Device_Init(), in the units of the clock of the profile.
+ * @ingroup ObjHelpers
+ * @param object_type [in] the object type, or MAX_BACNET_OBJECT_TYPE for
+ *  the whole of Device_Init()
+ * @param elapsed [in] the time that the Init function took
+ */
+typedef void (
+    *device_profile_report_function) (
+    BACNET_OBJECT_TYPE object_type,
+    unsigned long elapsed);
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -220,6 +351,10 @@ extern "C" {
     BACNET_STACK_EXPORT
     void Device_Init(
         object_functions_t * object_table);
+    BACNET_STACK_EXPORT
+    void Device_Init_Profile_Set(
+        device_profile_clock_function clock,
+        device_profile_report_function report);
 
     BACNET_STACK_EXPORT
     void Device_Timer(
@@ -244,6 +379,10 @@ extern "C" {
     BACNET_STACK_EXPORT
     void Device_getCurrentDateTime(
         BACNET_DATE_TIME * DateTime);
+    BACNET_STACK_EXPORT
+    void Device_Clock_Update(void);
+    BACNET_STACK_EXPORT
+    uint32_t Device_Clock_Milliseconds(void);
 
     BACNET_STACK_EXPORT
     int32_t Device_UTC_Offset(void);
@@ -333,6 +472,30 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool Device_Delete_Object(
         BACNET_DELETE_OBJECT_DATA *data);
+    BACNET_STACK_EXPORT
+    bool Device_Object_Property_Value(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value,
+        BACNET_ERROR_CLASS *error_class,
+        BACNET_ERROR_CODE *error_code);
+    BACNET_STACK_EXPORT
+    bool Device_Object_Property_Value_Set(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority,
+        BACNET_ERROR_CLASS *error_class,
+        BACNET_ERROR_CODE *error_code);
+    BACNET_STACK_EXPORT
+    unsigned Device_Objects_Provision(
+        const BACNET_OBJECT_SPEC *spec,
+        unsigned count,
+        object_provision_function setup);
 
     BACNET_STACK_EXPORT
     unsigned Device_Count(
@@ -441,6 +604,10 @@ extern "C" {
         BACNET_OBJECT_TYPE *object_type,
         uint32_t * object_instance);
     BACNET_STACK_EXPORT
+    void Device_Object_Name_Index_Update(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
     bool Device_Valid_Object_Id(
         BACNET_OBJECT_TYPE object_type,
         uint32_t object_instance);
@@ -452,6 +619,14 @@ extern "C" {
     bool Device_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
 
+    BACNET_STACK_EXPORT
+    void Device_Property_Cache_Invalidate(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
+    void Device_Property_Cache_Clear(
+        void);
+
     BACNET_STACK_EXPORT
     int Device_Add_List_Element(
         BACNET_LIST_ELEMENT_DATA *list_element);
@@ -477,6 +652,15 @@ extern "C" {
     void Device_local_reporting(
         void);
 #endif
+#if defined(INTRINSIC_REPORTING) && BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED
+    BACNET_STACK_EXPORT
+    void Device_Intrinsic_Reporting_Request(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance);
+#else
+#define Device_Intrinsic_Reporting_Request(object_type, object_instance) \
+    ((void)0)
+#endif
 
 /* Prototypes for Routing functionality in the Device Object.
  * Enable by defining BAC_ROUTING in config.h and including gw_device.c
@@ -497,6 +681,24 @@ extern "C" {
     BACNET_STACK_EXPORT
     BACNET_ADDRESS *Get_Routed_Device_Address(
         int idx);
+    BACNET_STACK_EXPORT
+    bool Routed_Device_Address_Set(
+        int idx,
+        BACNET_ADDRESS * address);
+    BACNET_STACK_EXPORT
+    uint16_t Routed_Device_Count(
+        void);
+    BACNET_STACK_EXPORT
+    int Routed_Device_Find(
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
+    int Routed_Device_Name_Find(
+        BACNET_CHARACTER_STRING * object_name);
+    BACNET_STACK_EXPORT
+    int Routed_Device_Range_Next(
+        uint32_t low_limit,
+        uint32_t high_limit,
+        uint32_t * cursor);
 
     BACNET_STACK_EXPORT
     bool Routed_Device_Address_Lookup(
@@ -548,6 +750,44 @@ extern "C" {
         uint8_t * apdu_buff,
         uint8_t invoke_id);
 
+    BACNET_STACK_EXPORT
+    void Routed_Device_Database_Provider_Set(
+        const ROUTED_DEVICE_DATABASE_PROVIDER * provider);
+    BACNET_STACK_EXPORT
+    const ROUTED_DEVICE_DATABASE_PROVIDER *Routed_Device_Database_Provider(
+        void);
+    BACNET_STACK_EXPORT
+    void *Routed_Device_Database(
+        void);
+    BACNET_STACK_EXPORT
+    unsigned Routed_Device_Database_Resident(
+        void);
+    BACNET_STACK_EXPORT
+    void Routed_Device_Database_Release_All(
+        void);
+    BACNET_STACK_EXPORT
+    unsigned Routed_Device_Database_Object_Count(
+        void *database);
+    BACNET_STACK_EXPORT
+    bool Routed_Device_Database_Object_List_Identifier(
+        void *database,
+        uint32_t array_index,
+        BACNET_OBJECT_TYPE * object_type,
+        uint32_t * instance);
+    BACNET_STACK_EXPORT
+    bool Routed_Device_Database_Valid_Object_Id(
+        void *database,
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance);
+    BACNET_STACK_EXPORT
+    int Routed_Device_Database_Read_Property(
+        void *database,
+        BACNET_READ_PROPERTY_DATA * rpdata);
+    BACNET_STACK_EXPORT
+    bool Routed_Device_Database_Write_Property(
+        void *database,
+        BACNET_WRITE_PROPERTY_DATA * wp_data);
+
 
 
 #ifdef __cplusplus
@@ -0,0 +1,799 @@
+/**
+ * @file
+ * @brief A basic BACnet Event Log object implementation.
+ * @details The Event Log objects record the event notifications of this
+ *  device, as given by the Notification Class objects, in a circular
+ *  buffer of fixed size records. The buffer can be stored elsewhere, such
+ *  as in a memory mapped ring file, in the same way as the buffer of a
+ *  Trend Log, and the Log_Buffer is read with the ReadRange encoding of
+ *  the Trend Log objects, by position, by sequence number or by time.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <limits.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/datetime.h"
+#include "bacnet/event.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/event_log.h"
+
+/* Most octets of one encoded BACnetEventLogRecord: 12 for the timestamp,
+ * 4 for the context tags of the logDatum and the notification */
+#define EL_MAX_ENC (EL_NOTIFICATION_SIZE + 16)
+
+/* Structure containing config and status info for an Event Log */
+typedef struct el_log_info {
+    bool bEnable; /* Event log is active when this is true */
+    bool bStopWhenFull; /* Log halts when full if true */
+    uint32_t ulRecordCount; /* Count of items currently in the buffer */
+    uint32_t ulTotalRecordCount; /* Count of all items ever inserted */
+    uint32_t ulIndex; /* Current insertion point */
+    uint32_t ulOrderedCount; /* Count of newest records in time order */
+    EL_DATA_REC *pRecords; /* Circular buffer of records */
+    uint32_t ulBufferSize; /* Number of records in the buffer */
+    TL_LOG_RING *pRing; /* Optional stored copy of the buffer state */
+} EL_LOG_INFO;
+
+static EL_DATA_REC Event_Log_Records[MAX_EVENT_LOGS][EL_MAX_ENTRIES];
+static EL_LOG_INFO Event_Log_Info[MAX_EVENT_LOGS];
+
+/* These three arrays are used by the ReadPropertyMultiple handler */
+static const int Event_Log_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
+    PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_STATUS_FLAGS, PROP_EVENT_STATE,
+    PROP_ENABLE, PROP_STOP_WHEN_FULL, PROP_BUFFER_SIZE, PROP_LOG_BUFFER,
+    PROP_RECORD_COUNT, PROP_TOTAL_RECORD_COUNT, -1 };
+
+static const int Event_Log_Properties_Optional[] = { PROP_DESCRIPTION, -1 };
+
+static const int Event_Log_Properties_Proprietary[] = { -1 };
+
+/**
+ * @brief Returns the list of required, optional, and proprietary properties.
+ * @param pRequired - pointer to list of int terminated by -1, of
+ *  BACnet required properties for this object.
+ * @param pOptional - pointer to list of int terminated by -1, of
+ *  BACnet optional properties for this object.
+ * @param pProprietary - pointer to list of int terminated by -1, of
+ *  BACnet proprietary properties for this object.
+ */
+void Event_Log_Property_Lists(
+    const int **pRequired, const int **pOptional, const int **pProprietary)
+{
+    if (pRequired) {
+        *pRequired = Event_Log_Properties_Required;
+    }
+    if (pOptional) {
+        *pOptional = Event_Log_Properties_Optional;
+    }
+    if (pProprietary) {
+        *pProprietary = Event_Log_Properties_Proprietary;
+    }
+}
+
+/**
+ * @brief Determines if a given object instance is valid
+ * @param object_instance - object-instance number of the object
+ * @return true if the instance is valid, and false if not
+ */
+bool Event_Log_Valid_Instance(uint32_t object_instance)
+{
+    return (object_instance < MAX_EVENT_LOGS);
+}
+
+/**
+ * @brief Determines the number of objects
+ * @return Number of Event Log objects
+ */
+unsigned Event_Log_Count(void)
+{
+    return MAX_EVENT_LOGS;
+}
+
+/**
+ * @brief Determines the object instance-number for a given 0..N index
+ * @param index - 0..N value
+ * @return object instance-number for the given index
+ */
+uint32_t Event_Log_Index_To_Instance(unsigned index)
+{
+    return index;
+}
+
+/**
+ * @brief For a given object instance-number, determines a 0..N index
+ * @param object_instance - object-instance number of the object
+ * @return index for the given instance-number, or MAX_EVENT_LOGS
+ *  if not valid.
+ */
+unsigned Event_Log_Instance_To_Index(uint32_t object_instance)
+{
+    unsigned index = MAX_EVENT_LOGS;
+
+    if (object_instance < MAX_EVENT_LOGS) {
+        index = object_instance;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Get the current time from the Device object
+ * @return current time in epoch seconds
+ */
+static bacnet_time_t Event_Log_Epoch_Seconds_Now(void)
+{
+    BACNET_DATE_TIME bdatetime;
+
+    Device_getCurrentDateTime(&bdatetime);
+    return datetime_seconds_since_epoch(&bdatetime);
+}
+
+/**
+ * @brief Get a record of an event log from its position in the log
+ * @param CurrentLog [in] the event log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest record
+ * @return the record in the circular buffer
+ */
+static EL_DATA_REC *EL_Entry(const EL_LOG_INFO *CurrentLog, uint32_t uiEntry)
+{
+    uint32_t uiOldest = 0;
+
+    if (CurrentLog->ulRecordCount >= CurrentLog->ulBufferSize) {
+        uiOldest = CurrentLog->ulIndex;
+    }
+
+    return &CurrentLog->pRecords[(uiOldest + uiEntry - 1) %
+        CurrentLog->ulBufferSize];
+}
+
+/**
+ * @brief Count the newest records of an event log that are in time order,
+ *  such as after the records were recovered from storage
+ * @param CurrentLog [in] the event log
+ * @return number of records, from the newest back, in time order
+ */
+static uint32_t EL_Ordered_Count(const EL_LOG_INFO *CurrentLog)
+{
+    uint32_t uiEntry;
+    bacnet_time_t tTimeStamp;
+
+    if (CurrentLog->ulRecordCount == 0) {
+        return 0;
+    }
+    tTimeStamp = EL_Entry(CurrentLog, CurrentLog->ulRecordCount)->tTimeStamp;
+    for (uiEntry = CurrentLog->ulRecordCount; uiEntry > 1; uiEntry--) {
+        if (EL_Entry(CurrentLog, uiEntry - 1)->tTimeStamp > tTimeStamp) {
+            break;
+        }
+        tTimeStamp = EL_Entry(CurrentLog, uiEntry - 1)->tTimeStamp;
+    }
+
+    return CurrentLog->ulRecordCount - uiEntry + 1;
+}
+
+/**
+ * @brief Insert a record into the circular buffer of an event log, and
+ *  keep the stored copy of the buffer state up to date if it has one
+ * @param CurrentLog [in] the event log
+ * @param pRec [in] the record
+ */
+static void EL_Insert_Rec(EL_LOG_INFO *CurrentLog, const EL_DATA_REC *pRec)
+{
+    /* track the run of newest records in time order for ReadRange */
+    if ((CurrentLog->ulRecordCount == 0) ||
+        (pRec->tTimeStamp <
+            EL_Entry(CurrentLog, CurrentLog->ulRecordCount)->tTimeStamp)) {
+        CurrentLog->ulOrderedCount = 1;
+    } else {
+        CurrentLog->ulOrderedCount++;
+    }
+    CurrentLog->pRecords[CurrentLog->ulIndex++] = *pRec;
+    if (CurrentLog->ulIndex >= CurrentLog->ulBufferSize) {
+        CurrentLog->ulIndex = 0;
+    }
+    CurrentLog->ulTotalRecordCount++;
+    if (CurrentLog->ulRecordCount < CurrentLog->ulBufferSize) {
+        CurrentLog->ulRecordCount++;
+    }
+    if (CurrentLog->ulOrderedCount > CurrentLog->ulRecordCount) {
+        CurrentLog->ulOrderedCount = CurrentLog->ulRecordCount;
+    }
+    if (CurrentLog->pRing) {
+        /* the record is in place before the state which refers to it */
+        CurrentLog->pRing->ulIndex = CurrentLog->ulIndex;
+        CurrentLog->pRing->ulRecordCount = CurrentLog->ulRecordCount;
+        CurrentLog->pRing->ulTotalRecordCount =
+            CurrentLog->ulTotalRecordCount;
+    }
+}
+
+/**
+ * @brief Insert a status record into an event log. Status records go in
+ *  even when the log is disabled or full.
+ * @param CurrentLog [in] the event log
+ * @param eStatus [in] the log status that changed
+ * @param bState [in] the new state of the log status
+ */
+static void EL_Insert_Status_Rec(
+    EL_LOG_INFO *CurrentLog, BACNET_LOG_STATUS eStatus, bool bState)
+{
+    EL_DATA_REC TempRec = { 0 };
+
+    TempRec.tTimeStamp = Event_Log_Epoch_Seconds_Now();
+    TempRec.ucRecType = EL_TYPE_STATUS;
+    if (bState || (eStatus == LOG_STATUS_LOG_INTERRUPTED)) {
+        /* in the order of the bits of the BACnetLogStatus bit string */
+        TempRec.ucLogStatus = (uint8_t)(1 << eStatus);
+    }
+    EL_Insert_Rec(CurrentLog, &TempRec);
+}
+
+/**
+ * @brief Check if an event log has no room for another record without
+ *  losing the oldest records
+ * @param CurrentLog [in] the event log
+ * @return true if the log is full
+ */
+static bool EL_Is_Full(const EL_LOG_INFO *CurrentLog)
+{
+    return (CurrentLog->ulRecordCount == CurrentLog->ulBufferSize);
+}
+
+/**
+ * @brief Remove all the records from an event log
+ * @param CurrentLog [in] the event log
+ */
+static void EL_Clear(EL_LOG_INFO *CurrentLog)
+{
+    CurrentLog->ulRecordCount = 0;
+    CurrentLog->ulIndex = 0;
+    CurrentLog->ulOrderedCount = 0;
+    if (CurrentLog->pRing) {
+        CurrentLog->pRing->ulIndex = 0;
+        CurrentLog->pRing->ulRecordCount = 0;
+    }
+}
+
+/**
+ * @brief Initializes the Event Log objects, which start out enabled and
+ *  empty, in their RAM buffers
+ */
+void Event_Log_Init(void)
+{
+    unsigned i;
+
+    for (i = 0; i < MAX_EVENT_LOGS; i++) {
+        memset(&Event_Log_Info[i], 0, sizeof(Event_Log_Info[i]));
+        Event_Log_Info[i].bEnable = true;
+        Event_Log_Info[i].pRecords = &Event_Log_Records[i][0];
+        Event_Log_Info[i].ulBufferSize = EL_MAX_ENTRIES;
+    }
+}
+
+/**
+ * @brief Set the storage for the records of an event log, such as a
+ *  buffer in battery backed RAM or in a memory mapped file. When a stored
+ *  copy of the buffer state is given and is valid for the buffer, the log
+ *  carries on from that state after a log-interrupted record, otherwise
+ *  the log starts out empty. Call after Event_Log_Init().
+ * @param object_instance [in] BACnet object instance number
+ * @param pRecords [in] buffer of records, or NULL for the RAM buffer
+ * @param ulBufferSize [in] number of records in the buffer
+ * @param pRing [in] stored copy of the buffer state, or NULL
+ * @return true if the storage was set
+ */
+bool Event_Log_Buffer_Set(uint32_t object_instance,
+    EL_DATA_REC *pRecords,
+    uint32_t ulBufferSize,
+    TL_LOG_RING *pRing)
+{
+    EL_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        return false;
+    }
+    if (!pRecords) {
+        pRecords = &Event_Log_Records[log_index][0];
+        ulBufferSize = EL_MAX_ENTRIES;
+        pRing = NULL;
+    }
+    if ((ulBufferSize == 0) || (ulBufferSize > INT_MAX)) {
+        return false;
+    }
+    CurrentLog = &Event_Log_Info[log_index];
+    CurrentLog->pRecords = pRecords;
+    CurrentLog->ulBufferSize = ulBufferSize;
+    CurrentLog->pRing = pRing;
+    if (pRing && (pRing->ulIndex < ulBufferSize) &&
+        (pRing->ulRecordCount <= ulBufferSize) &&
+        (pRing->ulRecordCount <= pRing->ulTotalRecordCount) &&
+        ((pRing->ulRecordCount == ulBufferSize) ||
+            (pRing->ulIndex == pRing->ulRecordCount))) {
+        /* recover the log from the stored state */
+        CurrentLog->ulIndex = pRing->ulIndex;
+        CurrentLog->ulRecordCount = pRing->ulRecordCount;
+        CurrentLog->ulTotalRecordCount = pRing->ulTotalRecordCount;
+        CurrentLog->ulOrderedCount = EL_Ordered_Count(CurrentLog);
+        if (pRing->ulRecordCount > 0) {
+            /* events may have been missed while we were not running */
+            EL_Insert_Status_Rec(
+                CurrentLog, LOG_STATUS_LOG_INTERRUPTED, true);
+        }
+    } else {
+        CurrentLog->ulIndex = 0;
+        CurrentLog->ulRecordCount = 0;
+        CurrentLog->ulTotalRecordCount = 0;
+        CurrentLog->ulOrderedCount = 0;
+        if (pRing) {
+            pRing->ulIndex = 0;
+            pRing->ulRecordCount = 0;
+            pRing->ulTotalRecordCount = 0;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the number of records that the buffer of an event log holds
+ * @param object_instance [in] BACnet object instance number
+ * @return number of records, or 0 if the object instance is not valid
+ */
+uint32_t Event_Log_Buffer_Size(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        return 0;
+    }
+
+    return Event_Log_Info[log_index].ulBufferSize;
+}
+
+/**
+ * @brief Get the number of records in an event log
+ * @param object_instance [in] BACnet object instance number
+ * @return number of records, or 0 if the object instance is not valid
+ */
+uint32_t Event_Log_Record_Count(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        return 0;
+    }
+
+    return Event_Log_Info[log_index].ulRecordCount;
+}
+
+/**
+ * @brief Get the number of records ever inserted into an event log,
+ *  which is the sequence number of the newest record
+ * @param object_instance [in] BACnet object instance number
+ * @return number of records, or 0 if the object instance is not valid
+ */
+uint32_t Event_Log_Total_Record_Count(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        return 0;
+    }
+
+    return Event_Log_Info[log_index].ulTotalRecordCount;
+}
+
+/**
+ * @brief Get the Enable property of an event log
+ * @param object_instance [in] BACnet object instance number
+ * @return true if the log records events
+ */
+bool Event_Log_Enable(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        return false;
+    }
+
+    return Event_Log_Info[log_index].bEnable;
+}
+
+/**
+ * @brief Set the Enable property of an event log, and record the change
+ *  with a log-disabled status record
+ * @param object_instance [in] BACnet object instance number
+ * @param enable [in] true to record events
+ * @return true if the property was set, false if the instance is not
+ *  valid, or the log is full and stops when full
+ */
+bool Event_Log_Enable_Set(uint32_t object_instance, bool enable)
+{
+    EL_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        return false;
+    }
+    CurrentLog = &Event_Log_Info[log_index];
+    if (enable && !CurrentLog->bEnable && CurrentLog->bStopWhenFull &&
+        EL_Is_Full(CurrentLog)) {
+        /* a full log which stops when full can't be enabled */
+        return false;
+    }
+    if (CurrentLog->bEnable != enable) {
+        CurrentLog->bEnable = enable;
+        EL_Insert_Status_Rec(CurrentLog, LOG_STATUS_LOG_DISABLED, !enable);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Record an event notification of this device in each enabled
+ *  event log, such as from Notification_Class_common_reporting_function()
+ * @param event_data [in] the event notification
+ */
+void Event_Log_Notification(BACNET_EVENT_NOTIFICATION_DATA *event_data)
+{
+    BACNET_EVENT_NOTIFICATION_DATA data;
+    EL_DATA_REC TempRec = { 0 };
+    EL_LOG_INFO *CurrentLog;
+    size_t len;
+    unsigned i;
+
+    if (!event_data) {
+        return;
+    }
+    /* the record is not for one of the recipients */
+    data = *event_data;
+    data.processIdentifier = 0;
+    len = event_notification_service_request_encode(
+        TempRec.ucNotification, sizeof(TempRec.ucNotification), &data);
+    if ((len == 0) && data.messageText) {
+        /* the message text is optional */
+        data.messageText = NULL;
+        len = event_notification_service_request_encode(
+            TempRec.ucNotification, sizeof(TempRec.ucNotification), &data);
+    }
+    if (len == 0) {
+        return;
+    }
+    TempRec.tTimeStamp = Event_Log_Epoch_Seconds_Now();
+    TempRec.ucRecType = EL_TYPE_NOTIFICATION;
+    TempRec.usLength = (uint16_t)len;
+    for (i = 0; i < MAX_EVENT_LOGS; i++) {
+        CurrentLog = &Event_Log_Info[i];
+        if (!CurrentLog->bEnable) {
+            continue;
+        }
+        if (CurrentLog->bStopWhenFull && EL_Is_Full(CurrentLog)) {
+            CurrentLog->bEnable = false;
+            continue;
+        }
+        EL_Insert_Rec(CurrentLog, &TempRec);
+    }
+}
+
+/**
+ * @brief Get the object name of an event log
+ * @param object_instance [in] BACnet object instance number
+ * @param object_name [out] the object name
+ * @return true if the object name was set
+ */
+bool Event_Log_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
+{
+    char text[32] = "";
+    bool status = false;
+
+    if (object_instance < MAX_EVENT_LOGS) {
+        snprintf(text, sizeof(text), "Event Log %lu",
+            (unsigned long)object_instance);
+        status = characterstring_init_ansi(object_name, text);
+    }
+
+    return status;
+}
+
+/**
+ * @brief ReadProperty handler for this object. For the given ReadProperty
+ *  data, the application_data is loaded or the error flags are set.
+ * @param  rpdata - BACNET_READ_PROPERTY_DATA data, including
+ *  requested data and space for the reply, or error response.
+ * @return number of APDU bytes in the response, or
+ *  BACNET_STATUS_ERROR on error.
+ */
+int Event_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    int apdu_len = 0;
+    BACNET_BIT_STRING bit_string;
+    BACNET_CHARACTER_STRING char_string;
+    EL_LOG_INFO *CurrentLog;
+    unsigned log_index;
+    uint8_t *apdu = NULL;
+
+    if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
+        (rpdata->application_data_len == 0)) {
+        return 0;
+    }
+    log_index = Event_Log_Instance_To_Index(rpdata->object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    CurrentLog = &Event_Log_Info[log_index];
+    apdu = rpdata->application_data;
+    switch (rpdata->object_property) {
+        case PROP_OBJECT_IDENTIFIER:
+            apdu_len = encode_application_object_id(
+                &apdu[0], OBJECT_EVENT_LOG, rpdata->object_instance);
+            break;
+        case PROP_DESCRIPTION:
+        case PROP_OBJECT_NAME:
+            Event_Log_Object_Name(rpdata->object_instance, &char_string);
+            apdu_len =
+                encode_application_character_string(&apdu[0], &char_string);
+            break;
+        case PROP_OBJECT_TYPE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], OBJECT_EVENT_LOG);
+            break;
+        case PROP_STATUS_FLAGS:
+            bitstring_init(&bit_string);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, false);
+            apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
+            break;
+        case PROP_EVENT_STATE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], EVENT_STATE_NORMAL);
+            break;
+        case PROP_ENABLE:
+            apdu_len =
+                encode_application_boolean(&apdu[0], CurrentLog->bEnable);
+            break;
+        case PROP_STOP_WHEN_FULL:
+            apdu_len =
+                encode_application_boolean(&apdu[0], CurrentLog->bStopWhenFull);
+            break;
+        case PROP_BUFFER_SIZE:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulBufferSize);
+            break;
+        case PROP_LOG_BUFFER:
+            /* You can only read the buffer via the ReadRange service */
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_READ_ACCESS_DENIED;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+        case PROP_RECORD_COUNT:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulRecordCount);
+            break;
+        case PROP_TOTAL_RECORD_COUNT:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulTotalRecordCount);
+            break;
+        default:
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+    }
+    /*  only array properties can have array options */
+    if ((apdu_len >= 0) && (rpdata->array_index != BACNET_ARRAY_ALL)) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        apdu_len = BACNET_STATUS_ERROR;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief WriteProperty handler for this object. For the given WriteProperty
+ *  data, the application_data is loaded or the error flags are set.
+ * @param  wp_data - BACNET_WRITE_PROPERTY_DATA data, including
+ *  requested data and space for the reply, or error response.
+ * @return false if an error is loaded, true if no errors
+ */
+bool Event_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    bool status = false;
+    int len = 0;
+    BACNET_APPLICATION_DATA_VALUE value;
+    EL_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(wp_data->object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    CurrentLog = &Event_Log_Info[log_index];
+    len = bacapp_decode_application_data(
+        wp_data->application_data, wp_data->application_data_len, &value);
+    if (len < 0) {
+        /* error while decoding - a value larger than we can handle */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return false;
+    }
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        /*  only array properties can have array options */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return false;
+    }
+    switch (wp_data->object_property) {
+        case PROP_ENABLE:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status &&
+                !Event_Log_Enable_Set(
+                    wp_data->object_instance, value.type.Boolean)) {
+                status = false;
+                wp_data->error_class = ERROR_CLASS_OBJECT;
+                wp_data->error_code = ERROR_CODE_LOG_BUFFER_FULL;
+            }
+            break;
+        case PROP_STOP_WHEN_FULL:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status &&
+                (CurrentLog->bStopWhenFull != value.type.Boolean)) {
+                CurrentLog->bStopWhenFull = value.type.Boolean;
+                if (CurrentLog->bStopWhenFull && CurrentLog->bEnable &&
+                    EL_Is_Full(CurrentLog)) {
+                    /* a full log stops when it is switched to stop
+                       when full */
+                    CurrentLog->bEnable = false;
+                    EL_Insert_Status_Rec(
+                        CurrentLog, LOG_STATUS_LOG_DISABLED, true);
+                }
+            }
+            break;
+        case PROP_RECORD_COUNT:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                if (value.type.Unsigned_Int == 0) {
+                    EL_Clear(CurrentLog);
+                    EL_Insert_Status_Rec(
+                        CurrentLog, LOG_STATUS_BUFFER_PURGED, true);
+                } else {
+                    status = false;
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                }
+            }
+            break;
+        default:
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Get the timestamp of a record of an event log
+ * @param pLog [in] the event log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest record
+ * @return timestamp of the record
+ */
+static bacnet_time_t EL_Range_Time_Stamp(const void *pLog, uint32_t uiEntry)
+{
+    return EL_Entry((const EL_LOG_INFO *)pLog, uiEntry)->tTimeStamp;
+}
+
+/**
+ * @brief Encode a record of an event log as a BACnetEventLogRecord
+ * @param apdu [out] buffer for the record
+ * @param pLog [in] the event log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest record
+ * @return number of bytes encoded
+ */
+static int EL_Range_Encode_Entry(
+    uint8_t *apdu, const void *pLog, uint32_t uiEntry)
+{
+    const EL_DATA_REC *pSource;
+    BACNET_BIT_STRING TempBits;
+    BACNET_DATE_TIME TempTime;
+    int iLen = 0;
+
+    pSource = EL_Entry((const EL_LOG_INFO *)pLog, uiEntry);
+    TL_Local_Time_To_BAC(&TempTime, pSource->tTimeStamp);
+    iLen += bacapp_encode_context_datetime(&apdu[iLen], 0, &TempTime);
+    iLen += encode_opening_tag(&apdu[iLen], 1);
+    if (pSource->ucRecType == EL_TYPE_NOTIFICATION) {
+        iLen += encode_opening_tag(&apdu[iLen], EL_TYPE_NOTIFICATION);
+        memcpy(&apdu[iLen], pSource->ucNotification, pSource->usLength);
+        iLen += pSource->usLength;
+        iLen += encode_closing_tag(&apdu[iLen], EL_TYPE_NOTIFICATION);
+    } else {
+        /* Build bit string directly from the stored octet */
+        bitstring_init(&TempBits);
+        bitstring_set_bits_used(&TempBits, 1, 5);
+        bitstring_set_octet(&TempBits, 0, pSource->ucLogStatus);
+        iLen +=
+            encode_context_bitstring(&apdu[iLen], EL_TYPE_STATUS, &TempBits);
+    }
+    iLen += encode_closing_tag(&apdu[iLen], 1);
+
+    return iLen;
+}
+
+/**
+ * @brief Encode the Log_Buffer of an event log for a ReadRange request
+ * @param apdu [out] buffer for the list of records
+ * @param pRequest [in,out] the request, and the results of the response
+ * @return number of bytes encoded
+ */
+int Event_Log_Read_Range_Encode(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    const EL_LOG_INFO *CurrentLog;
+    TL_RANGE_LOG Range;
+    unsigned log_index;
+
+    log_index = Event_Log_Instance_To_Index(pRequest->object_instance);
+    if (log_index >= MAX_EVENT_LOGS) {
+        return 0;
+    }
+    CurrentLog = &Event_Log_Info[log_index];
+    Range.pLog = CurrentLog;
+    Range.ulRecordCount = CurrentLog->ulRecordCount;
+    Range.ulTotalRecordCount = CurrentLog->ulTotalRecordCount;
+    Range.ulOrderedCount = CurrentLog->ulOrderedCount;
+    Range.ulMaxEncoded = EL_MAX_ENC;
+    Range.Time_Stamp = EL_Range_Time_Stamp;
+    Range.Encode = EL_Range_Encode_Entry;
+
+    return TL_Range_Encode(apdu, pRequest, &Range);
+}
+
+/**
+ * @brief Get the ReadRange handler of a property of an event log
+ * @param pRequest [in,out] the request, or the error
+ * @param pInfo [out] the request types and the handler
+ * @return true if the property can be read with ReadRange
+ */
+bool Event_Log_RR_Info(BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo)
+{
+    if (!Event_Log_Valid_Instance(pRequest->object_instance)) {
+        pRequest->error_class = ERROR_CLASS_OBJECT;
+        pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+    } else if (pRequest->object_property == PROP_LOG_BUFFER) {
+        pInfo->RequestTypes = RR_BY_POSITION | RR_BY_TIME | RR_BY_SEQUENCE;
+        pInfo->Handler = Event_Log_Read_Range_Encode;
+        return true;
+    } else {
+        pRequest->error_class = ERROR_CLASS_SERVICES;
+        pRequest->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+    }
+
+    return false;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief API for a basic Event Log object implementation, which records
+ *  the event notifications of this device.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_EVENT_LOG_H
+#define BACNET_BASIC_OBJECT_EVENT_LOG_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datetime.h"
+#include "bacnet/event.h"
+#include "bacnet/readrange.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/object/trendlog.h"
+
+#ifndef MAX_EVENT_LOGS
+#define MAX_EVENT_LOGS 1
+#endif
+/* Entries per event log in the RAM buffer */
+#ifndef EL_MAX_ENTRIES
+#define EL_MAX_ENTRIES 64
+#endif
+/* Octets of an encoded event notification in a record. A notification
+ * that does not fit is recorded without its message text. */
+#ifndef EL_NOTIFICATION_SIZE
+#define EL_NOTIFICATION_SIZE 120
+#endif
+
+/* The logDatum choice of a BACnetEventLogRecord, which is also the
+ * context tag used when encoding it */
+#define EL_TYPE_STATUS 0
+#define EL_TYPE_NOTIFICATION 1
+#define EL_TYPE_TIME_CHANGE 2
+
+/* Storage structure for Event Log data. The event notification is kept
+ * as the encoded parameters of a ConfirmedEventNotification-Request, so
+ * that each record has the same size and can be stored in a ring file. */
+typedef struct el_data_record {
+    bacnet_time_t tTimeStamp; /* When the event was recorded */
+    uint8_t ucRecType; /* What type of record */
+    uint8_t ucLogStatus; /* Change of log state flags */
+    uint16_t usLength; /* Octets of the encoded notification */
+    uint8_t ucNotification[EL_NOTIFICATION_SIZE];
+} EL_DATA_REC;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Event_Log_Property_Lists(
+    const int **pRequired, const int **pOptional, const int **pProprietary);
+BACNET_STACK_EXPORT
+bool Event_Log_Valid_Instance(uint32_t object_instance);
+BACNET_STACK_EXPORT
+unsigned Event_Log_Count(void);
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Index_To_Instance(unsigned index);
+BACNET_STACK_EXPORT
+unsigned Event_Log_Instance_To_Index(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name);
+BACNET_STACK_EXPORT
+int Event_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool Event_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
+BACNET_STACK_EXPORT
+void Event_Log_Init(void);
+
+BACNET_STACK_EXPORT
+bool Event_Log_Buffer_Set(uint32_t object_instance,
+    EL_DATA_REC *pRecords,
+    uint32_t ulBufferSize,
+    TL_LOG_RING *pRing);
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Buffer_Size(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Record_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Event_Log_Total_Record_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Enable(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Event_Log_Enable_Set(uint32_t object_instance, bool enable);
+
+BACNET_STACK_EXPORT
+void Event_Log_Notification(BACNET_EVENT_NOTIFICATION_DATA *event_data);
+
+BACNET_STACK_EXPORT
+bool Event_Log_RR_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo);
+BACNET_STACK_EXPORT
+int Event_Log_Read_Range_Encode(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
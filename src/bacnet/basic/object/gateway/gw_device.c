@@ -9,6 +9,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -42,6 +43,7 @@
 #endif
 /* os specific includes */
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/static_pool.h"
 
 /* forward prototypes */
 int Routed_Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata);
@@ -63,12 +65,43 @@ bool Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
  * and extending the regular Device Object functionality.
  ****************************************************************************/
 
-/** Model the gateway as the main Device, with (two) remote
- * Devices that are reached via its routing capabilities.
+/** Model the gateway as the main Device, with remote Devices that are
+ * reached via its routing capabilities.  The first MAX_NUM_DEVICES are
+ * kept in a static table, which is moved to the heap and doubled in size
+ * each time that it is full.
  */
-DEVICE_OBJECT_DATA Devices[MAX_NUM_DEVICES];
+static DEVICE_OBJECT_DATA Devices_Table[MAX_NUM_DEVICES];
+DEVICE_OBJECT_DATA *Devices = Devices_Table;
+/** Number of entries in Devices[] */
+static uint16_t Devices_Capacity = MAX_NUM_DEVICES;
 /** Keep track of the number of managed devices, including the gateway */
 uint16_t Num_Managed_Devices = 0;
+
+/* the links of the Devices[] entries in the hash tables, where 0 is the
+   end of a chain and any other value is the entry index plus one */
+struct routed_device_link {
+    /* next entry in the chain of the object instance hash */
+    uint16_t instance_next;
+    /* next entry in the chain of the MAC address hash */
+    uint16_t address_next;
+    /* bucket of the MAC address hash plus one, or 0 when not hashed */
+    uint16_t address_bucket;
+    /* next entry in the chain of the Object_Name hash */
+    uint16_t name_next;
+    /* bucket of the Object_Name hash plus one, or 0 when not hashed */
+    uint16_t name_bucket;
+    /* slot of the resident object database plus one, or 0 when none */
+    uint16_t database_slot;
+};
+static struct routed_device_link Device_Link_Table[MAX_NUM_DEVICES];
+static uint16_t Instance_Hash_Table[MAX_NUM_DEVICES];
+static uint16_t Address_Hash_Table[MAX_NUM_DEVICES];
+static uint16_t Name_Hash_Table[MAX_NUM_DEVICES];
+static struct routed_device_link *Device_Link = Device_Link_Table;
+/* heads of the chains, with one bucket for each entry of Devices[] */
+static uint16_t *Instance_Hash = Instance_Hash_Table;
+static uint16_t *Address_Hash = Address_Hash_Table;
+static uint16_t *Name_Hash = Name_Hash_Table;
 /** Which Device entry are we currently managing.
  * Since we are not using actual class objects here, the best we can do is
  * keep this local variable which notes which of the Devices the current
@@ -76,12 +109,346 @@ uint16_t Num_Managed_Devices = 0;
  */
 uint16_t iCurrent_Device_Idx = 0;
 
+#if (ROUTED_DEVICE_DATABASE_MAX < 1) || \
+    (ROUTED_DEVICE_DATABASE_MAX >= UINT16_MAX)
+#error "ROUTED_DEVICE_DATABASE_MAX must be from 1 to 65534"
+#endif
+/* an object database of a routed Device, created by the provider */
+struct routed_device_database {
+    void *database;
+    /* index of the Device in Devices[] */
+    uint16_t device_idx;
+    /* when the database was last used, for the eviction */
+    uint32_t last_used;
+};
+/* the resident databases, of which the first Database_Resident are used */
+static struct routed_device_database
+    Database_Table[ROUTED_DEVICE_DATABASE_MAX];
+static unsigned Database_Resident;
+static uint32_t Database_Clock;
+static const ROUTED_DEVICE_DATABASE_PROVIDER *Database_Provider;
+
 /* void Routing_Device_Init(uint32_t first_object_instance) is
  * found in device.c
  */
 
+/**
+ * @brief Compute the hash bucket of a Device object instance
+ * @param instance - object instance number
+ * @return hash bucket
+ */
+static uint16_t routed_device_instance_hash(uint32_t instance)
+{
+    /* Knuth multiplicative hash spreads sequential instances */
+    return (uint16_t)(((instance * 2654435761UL) & 0xFFFFFFFFUL) %
+        Devices_Capacity);
+}
+
+/**
+ * @brief Compute the hash bucket of a MAC address on the virtual network
+ * @param len - number of octets of the MAC address
+ * @param adr - MAC address
+ * @return hash bucket
+ */
+static uint16_t routed_device_address_hash(uint8_t len, const uint8_t *adr)
+{
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
+
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ adr[i]) * 16777619UL;
+    }
+
+    return (uint16_t)((hash & 0xFFFFFFFFUL) % Devices_Capacity);
+}
+
+/**
+ * @brief Compute the hash bucket of a Device Object_Name
+ * @param length - number of octets of the name
+ * @param name - the name, which is UTF-8
+ * @return hash bucket
+ */
+static uint16_t routed_device_name_hash(size_t length, const char *name)
+{
+    uint32_t hash = 2166136261UL;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)name[i]) * 16777619UL;
+    }
+
+    return (uint16_t)((hash & 0xFFFFFFFFUL) % Devices_Capacity);
+}
+
+/**
+ * @brief Link an entry into the chain of its object instance
+ * @param idx - index of the entry in Devices[]
+ */
+static void routed_device_instance_link(uint16_t idx)
+{
+    uint16_t bucket;
+
+    bucket =
+        routed_device_instance_hash(Devices[idx].bacObj.Object_Instance_Number);
+    Device_Link[idx].instance_next = Instance_Hash[bucket];
+    Instance_Hash[bucket] = idx + 1;
+}
+
+/**
+ * @brief Unlink an entry from the chain of its object instance
+ * @param idx - index of the entry in Devices[]
+ */
+static void routed_device_instance_unlink(uint16_t idx)
+{
+    uint16_t *pLink;
+
+    pLink = &Instance_Hash[routed_device_instance_hash(
+        Devices[idx].bacObj.Object_Instance_Number)];
+    while (*pLink != 0) {
+        if (*pLink == (idx + 1)) {
+            *pLink = Device_Link[idx].instance_next;
+            break;
+        }
+        pLink = &Device_Link[*pLink - 1].instance_next;
+    }
+    Device_Link[idx].instance_next = 0;
+}
+
+/**
+ * @brief Link an entry into the chain of its MAC address, after it is
+ *  unlinked from the chain of any previous MAC address
+ * @param idx - index of the entry in Devices[]
+ */
+static void routed_device_address_link(uint16_t idx)
+{
+    uint16_t *pLink;
+    uint16_t bucket;
+
+    if (Device_Link[idx].address_bucket != 0) {
+        pLink = &Address_Hash[Device_Link[idx].address_bucket - 1];
+        while (*pLink != 0) {
+            if (*pLink == (idx + 1)) {
+                *pLink = Device_Link[idx].address_next;
+                break;
+            }
+            pLink = &Device_Link[*pLink - 1].address_next;
+        }
+    }
+    bucket = routed_device_address_hash(
+        Devices[idx].bacDevAddr.len, Devices[idx].bacDevAddr.adr);
+    Device_Link[idx].address_next = Address_Hash[bucket];
+    Device_Link[idx].address_bucket = bucket + 1;
+    Address_Hash[bucket] = idx + 1;
+}
+
+/**
+ * @brief Unlink an entry from the chain of its Object_Name, if hashed
+ * @param idx - index of the entry in Devices[]
+ */
+static void routed_device_name_unlink(uint16_t idx)
+{
+    uint16_t *pLink;
+
+    if (Device_Link[idx].name_bucket == 0) {
+        return;
+    }
+    pLink = &Name_Hash[Device_Link[idx].name_bucket - 1];
+    while (*pLink != 0) {
+        if (*pLink == (idx + 1)) {
+            *pLink = Device_Link[idx].name_next;
+            break;
+        }
+        pLink = &Device_Link[*pLink - 1].name_next;
+    }
+    Device_Link[idx].name_next = 0;
+    Device_Link[idx].name_bucket = 0;
+}
+
+/**
+ * @brief Link an entry into the chain of its Object_Name, after it is
+ *  unlinked from the chain of any previous name
+ * @param idx - index of the entry in Devices[]
+ */
+static void routed_device_name_link(uint16_t idx)
+{
+    const char *name = Devices[idx].bacObj.Object_Name;
+    uint16_t bucket;
+
+    routed_device_name_unlink(idx);
+    bucket = routed_device_name_hash(strlen(name), name);
+    Device_Link[idx].name_next = Name_Hash[bucket];
+    Device_Link[idx].name_bucket = bucket + 1;
+    Name_Hash[bucket] = idx + 1;
+}
+
+/**
+ * @brief Determine if the Object_Name of a Device matches the given one
+ * @param pDev - Device
+ * @param name - Object_Name
+ * @return true if the names are the same
+ */
+static bool routed_device_name_same(
+    const DEVICE_OBJECT_DATA *pDev, BACNET_CHARACTER_STRING *name)
+{
+    size_t length = characterstring_length(name);
+
+    return (characterstring_encoding(name) == CHARACTER_UTF8) &&
+        (strlen(pDev->bacObj.Object_Name) == length) &&
+        (memcmp(pDev->bacObj.Object_Name, characterstring_value(name),
+             length) == 0);
+}
+
+/**
+ * @brief Determine if the MAC address of a Device matches the given one
+ * @param pDev - Device
+ * @param dlen - number of octets of the MAC address
+ * @param dadr - MAC address
+ * @return true if the first dlen octets of the address of the Device match
+ */
+static bool routed_device_address_same(
+    const DEVICE_OBJECT_DATA *pDev, uint8_t dlen, const uint8_t *dadr)
+{
+    uint8_t i;
+
+    for (i = 0; i < dlen; i++) {
+        if (pDev->bacDevAddr.adr[i] != dadr[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find the routed Device with the given MAC address.  A Device
+ *  whose address was written without Routed_Device_Address_Set() is
+ *  found by a search, and then hashed for the next time.
+ * @param dlen - number of octets of the MAC address, more than 0
+ * @param dadr - MAC address
+ * @return index of the Device in Devices[], or 0 if not found
+ */
+static uint16_t routed_device_address_find(uint8_t dlen, const uint8_t *dadr)
+{
+    uint16_t link;
+    uint16_t idx;
+
+    link = Address_Hash[routed_device_address_hash(dlen, dadr)];
+    while (link != 0) {
+        idx = link - 1;
+        if ((idx > 0) && (idx < Num_Managed_Devices) &&
+            (Devices[idx].bacDevAddr.len == dlen) &&
+            routed_device_address_same(&Devices[idx], dlen, dadr)) {
+            return idx;
+        }
+        link = Device_Link[idx].address_next;
+    }
+    for (idx = 1; idx < Num_Managed_Devices; idx++) {
+        if (routed_device_address_same(&Devices[idx], dlen, dadr)) {
+            routed_device_address_link(idx);
+            return idx;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Double the size of Devices[] and of its hash tables
+ * @return true if the memory was allocated
+ */
+static bool routed_device_grow(void)
+{
+    DEVICE_OBJECT_DATA *devices;
+    struct routed_device_link *links;
+    uint16_t *hash;
+    uint32_t capacity;
+    uint16_t i;
+    bool hashed;
+
+    capacity = (uint32_t)Devices_Capacity * 2;
+    if (capacity >= UINT16_MAX) {
+        capacity = UINT16_MAX - 1;
+    }
+    if (capacity <= Devices_Capacity) {
+        return false;
+    }
+    devices = bacnet_calloc(capacity, sizeof(DEVICE_OBJECT_DATA));
+    links = bacnet_calloc(capacity, sizeof(struct routed_device_link));
+    hash = bacnet_calloc(capacity * 3, sizeof(uint16_t));
+    if (!devices || !links || !hash) {
+        bacnet_free(devices);
+        bacnet_free(links);
+        bacnet_free(hash);
+        return false;
+    }
+    memcpy(devices, Devices, Devices_Capacity * sizeof(DEVICE_OBJECT_DATA));
+    /* keep which of the addresses and names were hashed, and the
+       databases */
+    for (i = 0; i < Num_Managed_Devices; i++) {
+        links[i].address_bucket = Device_Link[i].address_bucket;
+        links[i].name_bucket = Device_Link[i].name_bucket;
+        links[i].database_slot = Device_Link[i].database_slot;
+    }
+    if (Devices != Devices_Table) {
+        bacnet_free(Devices);
+        bacnet_free(Device_Link);
+        bacnet_free(Instance_Hash);
+    }
+    Devices = devices;
+    Device_Link = links;
+    Instance_Hash = &hash[0];
+    Address_Hash = &hash[capacity];
+    Name_Hash = &hash[capacity * 2];
+    Devices_Capacity = (uint16_t)capacity;
+    for (i = 0; i < Num_Managed_Devices; i++) {
+        routed_device_instance_link(i);
+        hashed = (Device_Link[i].address_bucket != 0);
+        Device_Link[i].address_bucket = 0;
+        if (hashed) {
+            routed_device_address_link(i);
+        }
+        hashed = (Device_Link[i].name_bucket != 0);
+        Device_Link[i].name_bucket = 0;
+        if (hashed) {
+            routed_device_name_link(i);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Release a resident object database, and move the last resident
+ *  database into its slot
+ * @param slot - slot of Database_Table[]
+ */
+static void routed_device_database_release(unsigned slot)
+{
+    struct routed_device_database *entry;
+    struct routed_device_database *last;
+
+    if (slot >= Database_Resident) {
+        return;
+    }
+    entry = &Database_Table[slot];
+    Device_Link[entry->device_idx].database_slot = 0;
+    if (Database_Provider && Database_Provider->Release) {
+        Database_Provider->Release(entry->database);
+    }
+    Database_Resident--;
+    last = &Database_Table[Database_Resident];
+    if (entry != last) {
+        *entry = *last;
+        Device_Link[entry->device_idx].database_slot = (uint16_t)(slot + 1);
+    }
+    last->database = NULL;
+}
+
 /** Add a Device to our table of Devices[].
  * The first entry must be the gateway device.
+ * @note The table grows when it is full, which moves the Devices, so a
+ *  pointer from Get_Routed_Device_Object() is only valid until the next
+ *  Device is added.
  * @param Object_Instance [in] Set the new Device to this instance number.
  * @param sObject_Name [in] Use this Object Name for the Device.
  * @param sDescription [in] Set this Description for the Device.
@@ -93,12 +460,13 @@ uint16_t Add_Routed_Device(uint32_t Object_Instance,
     const char *sDescription)
 {
     int i = Num_Managed_Devices;
-    if (i < MAX_NUM_DEVICES) {
+    if ((i < Devices_Capacity) || routed_device_grow()) {
         DEVICE_OBJECT_DATA *pDev = &Devices[i];
         Num_Managed_Devices++;
         iCurrent_Device_Idx = i;
         pDev->bacObj.mObject_Type = OBJECT_DEVICE;
         pDev->bacObj.Object_Instance_Number = Object_Instance;
+        routed_device_instance_link((uint16_t)i);
         if (sObject_Name != NULL) {
             Routed_Device_Set_Object_Name(sObject_Name->encoding,
                 sObject_Name->value, sObject_Name->length);
@@ -118,6 +486,115 @@ uint16_t Add_Routed_Device(uint32_t Object_Instance,
     }
 }
 
+/** Get the number of Devices in our table of Devices[], including the
+ * gateway Device.
+ * @return number of Devices
+ */
+uint16_t Routed_Device_Count(void)
+{
+    return Num_Managed_Devices;
+}
+
+/** Find a Device in our table of Devices[] by its object instance.
+ * @param object_instance [in] instance number of the Device
+ * @return The index of the Device in the Devices[] array, or -1 if there
+ *         is no Device with this instance number.
+ */
+int Routed_Device_Find(uint32_t object_instance)
+{
+    uint16_t link;
+
+    link = Instance_Hash[routed_device_instance_hash(object_instance)];
+    while (link != 0) {
+        if (Devices[link - 1].bacObj.Object_Instance_Number ==
+            object_instance) {
+            return link - 1;
+        }
+        link = Device_Link[link - 1].instance_next;
+    }
+
+    return -1;
+}
+
+/** Find a Device in our table of Devices[] by its Object_Name, such as
+ * for a Who-Has.  A Device whose name was written without
+ * Routed_Device_Set_Object_Name() is found by a search, and then hashed
+ * for the next time.
+ * @param object_name [in] Object_Name of the Device
+ * @return The index of the Device in the Devices[] array, or -1 if there
+ *         is no Device with this name.
+ */
+int Routed_Device_Name_Find(BACNET_CHARACTER_STRING *object_name)
+{
+    uint16_t link;
+    uint16_t idx;
+
+    if (!object_name || (Num_Managed_Devices == 0)) {
+        return -1;
+    }
+    link = Name_Hash[routed_device_name_hash(characterstring_length(
+        object_name), characterstring_value(object_name))];
+    while (link != 0) {
+        idx = link - 1;
+        if ((idx < Num_Managed_Devices) &&
+            routed_device_name_same(&Devices[idx], object_name)) {
+            return idx;
+        }
+        link = Device_Link[idx].name_next;
+    }
+    for (idx = 0; idx < Num_Managed_Devices; idx++) {
+        if ((Device_Link[idx].name_bucket == 0) &&
+            routed_device_name_same(&Devices[idx], object_name)) {
+            routed_device_name_link(idx);
+            return idx;
+        }
+    }
+
+    return -1;
+}
+
+/** Find the next Device with an object instance in the given range, such
+ * as for the Devices that answer a Who-Is.  A narrow range is looked up
+ * by instance number, and a wide one by going through the Devices.
+ * @param low_limit [in] lowest instance number of the range
+ * @param high_limit [in] highest instance number of the range
+ * @param cursor [in,out] Set it to 0 to start with the first Device in
+ *        the range; on return, it is updated to find the next one.
+ * @return The index of the Device in the Devices[] array, or -1 if there
+ *         are no more Devices in the range.
+ */
+int Routed_Device_Range_Next(
+    uint32_t low_limit, uint32_t high_limit, uint32_t *cursor)
+{
+    uint32_t instance;
+    int idx;
+
+    if (!cursor || (low_limit > high_limit)) {
+        return -1;
+    }
+    if ((high_limit - low_limit) < Num_Managed_Devices) {
+        while (*cursor <= (high_limit - low_limit)) {
+            instance = low_limit + *cursor;
+            (*cursor)++;
+            idx = Routed_Device_Find(instance);
+            if (idx >= 0) {
+                return idx;
+            }
+        }
+    } else {
+        while (*cursor < Num_Managed_Devices) {
+            idx = (int)*cursor;
+            (*cursor)++;
+            instance = Devices[idx].bacObj.Object_Instance_Number;
+            if ((instance >= low_limit) && (instance <= high_limit)) {
+                return idx;
+            }
+        }
+    }
+
+    return -1;
+}
+
 /** Return the Device Object descriptive data for the indicated entry.
  * @param idx [in] Index into Devices[] array being requested.
  *                 0 is for the main, gateway Device entry.
@@ -131,7 +608,7 @@ DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
 {
     if (idx == -1) {
         return &Devices[iCurrent_Device_Idx];
-    } else if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
+    } else if ((idx >= 0) && (idx < Devices_Capacity)) {
         iCurrent_Device_Idx = idx;
         return &Devices[idx];
     } else {
@@ -152,7 +629,7 @@ BACNET_ADDRESS *Get_Routed_Device_Address(int idx)
 {
     if (idx == -1) {
         return &Devices[iCurrent_Device_Idx].bacDevAddr;
-    } else if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
+    } else if ((idx >= 0) && (idx < Devices_Capacity)) {
         iCurrent_Device_Idx = idx;
         return &Devices[idx].bacDevAddr;
     } else {
@@ -160,6 +637,25 @@ BACNET_ADDRESS *Get_Routed_Device_Address(int idx)
     }
 }
 
+/** Set the BACnet address of the indicated entry, so that it is found
+ * by its MAC address on the virtual network.
+ * @param idx [in] Index into Devices[] array being set.
+ * @param address [in] BACnet address of the Device.
+ * @return True if the address was set, or False if the idx is invalid.
+ */
+bool Routed_Device_Address_Set(int idx, BACNET_ADDRESS *address)
+{
+    if ((idx < 0) || (idx >= Num_Managed_Devices) || !address) {
+        return false;
+    }
+    bacnet_address_copy(&Devices[idx].bacDevAddr, address);
+    if (idx > 0) {
+        routed_device_address_link((uint16_t)idx);
+    }
+
+    return true;
+}
+
 /** Get the currently active BACnet address.
  * This is an implementation of the datalink_get_my_address() template for
  * devices with routing.
@@ -195,22 +691,15 @@ void routed_get_my_address(BACNET_ADDRESS *my_address)
 bool Routed_Device_Address_Lookup(int idx, uint8_t dlen, uint8_t *dadr)
 {
     bool result = false;
-    DEVICE_OBJECT_DATA *pDev;
-    int i;
 
-    if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
-        pDev = &Devices[idx];
+    if ((idx >= 0) && (idx < Devices_Capacity)) {
         if (dlen == 0) {
             /* Automatic match */
             iCurrent_Device_Idx = idx;
             result = true;
         } else if (dadr != NULL) {
-            for (i = 0; i < dlen; i++) {
-                if (pDev->bacDevAddr.adr[i] != dadr[i]) {
-                    break;
-                }
-            }
-            if (i == dlen) { /* Success! */
+            if (routed_device_address_same(&Devices[idx], dlen, dadr)) {
+                /* Success! */
                 iCurrent_Device_Idx = idx;
                 result = true;
             }
@@ -250,11 +739,12 @@ bool Routed_Device_GetNext(BACNET_ADDRESS *dest, int *DNET_list, int *cursor)
     int dnet = DNET_list[0]; /* Get the DNET of our virtual network */
     int idx = *cursor;
     bool bSuccess = false;
+    uint16_t found;
 
     /* First, see if the index is out of range.
      * Eg, last call to GetNext may have been the last successful one.
      */
-    if ((idx < 0) || (idx >= MAX_NUM_DEVICES)) {
+    if ((idx < 0) || (idx >= Num_Managed_Devices)) {
         idx = -1;
 
         /* Next, see if it's a BACnet broadcast.
@@ -284,18 +774,26 @@ bool Routed_Device_GetNext(BACNET_ADDRESS *dest, int *DNET_list, int *cursor)
         if (idx == 0) { /* Step over this case (starting point) */
             idx = 1;
         }
-        while (idx < MAX_NUM_DEVICES) {
-            bSuccess =
-                Routed_Device_Address_Lookup(idx++, dest->len, dest->adr);
-            if (bSuccess) {
-                break; /* We don't need to keep looking */
+        if (dest->len == 0) {
+            /* MAC broadcast: each of the routed Devices */
+            if (idx < Num_Managed_Devices) {
+                bSuccess = Routed_Device_Address_Lookup(idx++, 0, NULL);
+            }
+        } else {
+            /* only one Device has the MAC address */
+            found = routed_device_address_find(dest->len, dest->adr);
+            if (found > 0) {
+                iCurrent_Device_Idx = found;
+                bSuccess = true;
             }
+            idx = -1;
         }
     }
 
     if (!bSuccess) {
         *cursor = -1;
-    } else if (idx == MAX_NUM_DEVICES) { /* No more to GetNext */
+    } else if ((idx < 0) || (idx >= Num_Managed_Devices)) {
+        /* No more to GetNext */
         *cursor = -1;
     } else {
         *cursor = idx;
@@ -346,7 +844,7 @@ uint32_t Routed_Device_Index_To_Instance(unsigned index)
 
 /**
  * For a given object instance-number, determines a 1..N-1 index
- * of Device objects where N is MAX_NUM_DEVICES
+ * of Device objects where N is the number of Devices
  *
  * @param  object_instance - object-instance number of the object
  * @return  index for the given instance-number, or 0 if not valid.
@@ -355,11 +853,10 @@ static uint32_t Routed_Device_Instance_To_Index(uint32_t Instance_Number)
 {
     int i;
 
-    for (i = 0; i < MAX_NUM_DEVICES; i++) {
-        if (Devices[i].bacObj.Object_Instance_Number == Instance_Number) {
-            /* Found Instance, so return the Device Index Number */
-            return i;
-        }
+    i = Routed_Device_Find(Instance_Number);
+    if (i >= 0) {
+        /* Found Instance, so return the Device Index Number */
+        return (uint32_t)i;
     }
 
     /* We did not find instance... so simply return an Index of 0
@@ -519,7 +1016,20 @@ bool Routed_Device_Set_Object_Instance_Number(uint32_t object_id)
 
     if (object_id <= BACNET_MAX_INSTANCE) {
         /* Make the change and update the database revision */
-        Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number = object_id;
+        if (iCurrent_Device_Idx < Num_Managed_Devices) {
+            /* the database is created again for the new instance */
+            if (Device_Link[iCurrent_Device_Idx].database_slot) {
+                routed_device_database_release(
+                    Device_Link[iCurrent_Device_Idx].database_slot - 1);
+            }
+            routed_device_instance_unlink(iCurrent_Device_Idx);
+            Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number =
+                object_id;
+            routed_device_instance_link(iCurrent_Device_Idx);
+        } else {
+            Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number =
+                object_id;
+        }
         Routed_Device_Inc_Database_Revision();
     } else {
         status = false;
@@ -544,6 +1054,9 @@ bool Routed_Device_Set_Object_Name(
         /* Make the change and update the database revision */
         memmove(pDev->bacObj.Object_Name, value, length);
         pDev->bacObj.Object_Name[length] = 0;
+        if (iCurrent_Device_Idx < Num_Managed_Devices) {
+            routed_device_name_link(iCurrent_Device_Idx);
+        }
         Routed_Device_Inc_Database_Revision();
         status = true;
     }
@@ -627,3 +1140,195 @@ int Routed_Device_Service_Approval(BACNET_SERVICES_SUPPORTED service,
 
     return len;
 }
+
+/** Set the provider of the object databases of the routed Devices.
+ * The resident databases of a previous provider are released first.
+ * The gateway Device keeps the objects of the Object_Table in device.c.
+ * @param provider [in] callbacks, which are kept, or NULL for none so that
+ *  every Device uses the objects of the Object_Table.
+ */
+void Routed_Device_Database_Provider_Set(
+    const ROUTED_DEVICE_DATABASE_PROVIDER *provider)
+{
+    Routed_Device_Database_Release_All();
+    Database_Provider = provider;
+}
+
+/** Get the provider of the object databases of the routed Devices.
+ * @return the provider, or NULL when every Device uses the objects of
+ *  the Object_Table
+ */
+const ROUTED_DEVICE_DATABASE_PROVIDER *Routed_Device_Database_Provider(void)
+{
+    return Database_Provider;
+}
+
+/** Get the object database of the current routed Device, which is created
+ * by the provider on the first access, after releasing the least recently
+ * used database when ROUTED_DEVICE_DATABASE_MAX are already resident.
+ * @note The database is only valid until the next call, since the call for
+ *  another Device can release it.
+ * @return database of the current Device, or NULL when it is the gateway
+ *  Device, when there is no provider, or when the Device has no database.
+ */
+void *Routed_Device_Database(void)
+{
+    struct routed_device_database *entry;
+    uint16_t idx = iCurrent_Device_Idx;
+    unsigned slot, i;
+    void *database;
+
+    if (!Database_Provider || !Database_Provider->Create || (idx == 0) ||
+        (idx >= Num_Managed_Devices)) {
+        return NULL;
+    }
+    Database_Clock++;
+    slot = Device_Link[idx].database_slot;
+    if (slot) {
+        entry = &Database_Table[slot - 1];
+        entry->last_used = Database_Clock;
+        return entry->database;
+    }
+    if (Database_Resident >= ROUTED_DEVICE_DATABASE_MAX) {
+        slot = 0;
+        for (i = 1; i < Database_Resident; i++) {
+            if ((Database_Clock - Database_Table[i].last_used) >
+                (Database_Clock - Database_Table[slot].last_used)) {
+                slot = i;
+            }
+        }
+        routed_device_database_release(slot);
+    }
+    database =
+        Database_Provider->Create(Devices[idx].bacObj.Object_Instance_Number);
+    if (!database) {
+        return NULL;
+    }
+    slot = Database_Resident++;
+    entry = &Database_Table[slot];
+    entry->database = database;
+    entry->device_idx = idx;
+    entry->last_used = Database_Clock;
+    Device_Link[idx].database_slot = (uint16_t)(slot + 1);
+
+    return database;
+}
+
+/** Get the number of resident object databases of the routed Devices.
+ * @return number of resident databases
+ */
+unsigned Routed_Device_Database_Resident(void)
+{
+    return Database_Resident;
+}
+
+/** Release all of the resident object databases of the routed Devices,
+ * such as before the application exits.
+ */
+void Routed_Device_Database_Release_All(void)
+{
+    while (Database_Resident) {
+        routed_device_database_release(Database_Resident - 1);
+    }
+}
+
+/** Get the number of objects in an object database, which does not
+ * include the Device object itself.
+ * @param database [in] database from Routed_Device_Database()
+ * @return number of objects
+ */
+unsigned Routed_Device_Database_Object_Count(void *database)
+{
+    if (!database || !Database_Provider || !Database_Provider->Object_Count) {
+        return 0;
+    }
+
+    return Database_Provider->Object_Count(database);
+}
+
+/** Lookup an object of an object database by its index.
+ * @param database [in] database from Routed_Device_Database()
+ * @param array_index [in] index of the object, 1 to N
+ * @param object_type [out] The object's type, if found.
+ * @param instance [out] The object's instance number, if found.
+ * @return True if found, else false.
+ */
+bool Routed_Device_Database_Object_List_Identifier(void *database,
+    uint32_t array_index,
+    BACNET_OBJECT_TYPE *object_type,
+    uint32_t *instance)
+{
+    if (!database || (array_index == 0) || !Database_Provider ||
+        !Database_Provider->Object_List_Identifier) {
+        return false;
+    }
+
+    return Database_Provider->Object_List_Identifier(
+        database, array_index, object_type, instance);
+}
+
+/** Determine if an object database has an object.
+ * @param database [in] database from Routed_Device_Database()
+ * @param object_type [in] The desired BACNET_OBJECT_TYPE
+ * @param object_instance [in] The object instance number
+ * @return True if found, else False.
+ */
+bool Routed_Device_Database_Valid_Object_Id(void *database,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance)
+{
+    if (!database || !Database_Provider ||
+        !Database_Provider->Valid_Object_Id) {
+        return false;
+    }
+
+    return Database_Provider->Valid_Object_Id(
+        database, object_type, object_instance);
+}
+
+/** Manages the ReadProperty service for an object of an object database.
+ * @param database [in] database from Routed_Device_Database()
+ * @param rpdata [in] Structure which describes the property to be read.
+ * @return The length of the apdu encoded, or BACNET_STATUS_ERROR for error or
+ * BACNET_STATUS_ABORT for abort message.
+ */
+int Routed_Device_Database_Read_Property(
+    void *database, BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    rpdata->error_class = ERROR_CLASS_OBJECT;
+    rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+    if (!Routed_Device_Database_Valid_Object_Id(
+            database, rpdata->object_type, rpdata->object_instance) ||
+        !Database_Provider->Read_Property) {
+        return BACNET_STATUS_ERROR;
+    }
+    if ((rpdata->application_data == NULL) ||
+        (rpdata->application_data_len == 0)) {
+        return 0;
+    }
+
+    return Database_Provider->Read_Property(database, rpdata);
+}
+
+/** Manages the WriteProperty service for an object of an object database.
+ * @param database [in] database from Routed_Device_Database()
+ * @param wp_data [in] Structure which describes the property to be written.
+ * @return True on success, else False if there is an error.
+ */
+bool Routed_Device_Database_Write_Property(
+    void *database, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    wp_data->error_class = ERROR_CLASS_OBJECT;
+    wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+    if (!Routed_Device_Database_Valid_Object_Id(
+            database, wp_data->object_type, wp_data->object_instance)) {
+        return false;
+    }
+    if (!Database_Provider->Write_Property) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    }
+
+    return Database_Provider->Write_Property(database, wp_data);
+}
@@ -0,0 +1,521 @@
+/**
+ * @file
+ * @brief Import the values of the points of a field bus into the
+ *  Present_Value of the Analog Input, Analog Value and Binary Input
+ *  objects at each scan.
+ *
+ *  With BACNET_OBJECT_COLUMNS_ENABLED, the row of the object of each
+ *  point in the columns of its object type is found when the map is set,
+ *  and the points are kept in the order of their rows. A scan then
+ *  gathers the values into that order, and sets each run of consecutive
+ *  rows with one call, which detects the changes of value of the run
+ *  together and queues the changed objects for COV. There is no search
+ *  for the object of a point, and the memory of the objects is read in
+ *  order. Without the columns, a scan sets each point with the
+ *  Present_Value setter of its object.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/ai.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/bi.h"
+#include "bacnet/basic/sys/columns.h"
+#include "bacnet/basic/sys/static_pool.h"
+/* me! */
+#include "bacnet/basic/object/ioscan.h"
+
+/* the object types of a scan, in the order of the types of a map */
+static const BACNET_OBJECT_TYPE IOScan_Types[IOSCAN_TYPE_MAX] = {
+    OBJECT_ANALOG_INPUT, OBJECT_ANALOG_VALUE, OBJECT_BINARY_INPUT
+};
+
+/**
+ * @brief Find the type of a map of an object type
+ * @param map - map of the points
+ * @param object_type - type of the object of a point
+ * @return the type of the map, or NULL if the object type is not
+ *  set by a scan
+ */
+static BACNET_IOSCAN_TYPE *
+ioscan_type(BACNET_IOSCAN_MAP *map, BACNET_OBJECT_TYPE object_type)
+{
+    unsigned i;
+
+    for (i = 0; i < IOSCAN_TYPE_MAX; i++) {
+        if (map->type[i].object_type == object_type) {
+            return &map->type[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Convert the value of a point into a binary Present_Value
+ * @param value - value of the point, where non-zero is active
+ * @return BINARY_ACTIVE or BINARY_INACTIVE
+ */
+static BACNET_BINARY_PV ioscan_binary(float value)
+{
+    return islessgreater(value, 0.0f) ? BINARY_ACTIVE : BINARY_INACTIVE;
+}
+
+#if BACNET_OBJECT_COLUMNS_ENABLED
+/* an object-instance or a row, and the index of its point or row */
+struct ioscan_pair {
+    uint32_t key;
+    unsigned index;
+};
+
+/**
+ * @brief Compare two pairs for qsort(), by key and then by index
+ * @param a - first pair
+ * @param b - second pair
+ * @return negative, zero or positive
+ */
+static int ioscan_pair_compare(const void *a, const void *b)
+{
+    const struct ioscan_pair *pair_a = a;
+    const struct ioscan_pair *pair_b = b;
+
+    if (pair_a->key != pair_b->key) {
+        return (pair_a->key < pair_b->key) ? -1 : 1;
+    }
+    if (pair_a->index != pair_b->index) {
+        return (pair_a->index < pair_b->index) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the columns of the objects of a type
+ * @param object_type - type of the objects
+ * @return the columns, or NULL
+ */
+static const COLUMNS_STORE *ioscan_columns(BACNET_OBJECT_TYPE object_type)
+{
+    switch (object_type) {
+        case OBJECT_ANALOG_INPUT:
+            return Analog_Input_Columns();
+        case OBJECT_ANALOG_VALUE:
+            return Analog_Value_Columns();
+        case OBJECT_BINARY_INPUT:
+            return Binary_Input_Columns();
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the rows of the objects of the points of one type, and put
+ *  the points into the order of their rows
+ * @param map - map of the points
+ * @param type - points of one type
+ * @return true if there was memory to find the rows
+ */
+static bool
+ioscan_type_resolve(BACNET_IOSCAN_MAP *map, BACNET_IOSCAN_TYPE *type)
+{
+    const COLUMNS_STORE *columns;
+    struct ioscan_pair *points = NULL;
+    struct ioscan_pair *rows = NULL;
+    unsigned i, j, count;
+
+    type->count = 0;
+    columns = ioscan_columns(type->object_type);
+    if ((type->size == 0) || (columns_count(columns) == 0)) {
+        map->missing += type->size;
+        return true;
+    }
+    points = bacnet_malloc(type->size * sizeof(*points));
+    rows = bacnet_malloc(columns->count * sizeof(*rows));
+    if (!points || !rows) {
+        bacnet_free(points);
+        bacnet_free(rows);
+        return false;
+    }
+    count = 0;
+    for (i = 0; i < map->count; i++) {
+        if (map->point[i].object_type == type->object_type) {
+            points[count].key = map->point[i].object_instance;
+            points[count].index = i;
+            count++;
+        }
+    }
+    for (i = 0; i < columns->count; i++) {
+        rows[i].key = columns->instance[i];
+        rows[i].index = i;
+    }
+    qsort(points, count, sizeof(*points), ioscan_pair_compare);
+    qsort(rows, columns->count, sizeof(*rows), ioscan_pair_compare);
+    /* merge the sorted object-instances, and keep each point that has an
+       object as a pair of its row and its index */
+    for (i = 0, j = 0; i < count; i++) {
+        while ((j < columns->count) && (rows[j].key < points[i].key)) {
+            j++;
+        }
+        if ((j < columns->count) && (rows[j].key == points[i].key)) {
+            points[type->count].key = rows[j].index;
+            points[type->count].index = points[i].index;
+            type->count++;
+        } else {
+            map->missing++;
+        }
+    }
+    qsort(points, type->count, sizeof(*points), ioscan_pair_compare);
+    for (i = 0; i < type->count; i++) {
+        type->row[i] = points[i].key;
+        type->point[i] = points[i].index;
+    }
+    bacnet_free(points);
+    bacnet_free(rows);
+
+    return true;
+}
+
+/**
+ * @brief Determine if the rows of the points of one type are still the
+ *  rows of their objects, which move when objects are deleted
+ * @param map - map of the points
+ * @param type - points of one type
+ * @return true if the rows are valid
+ */
+static bool
+ioscan_type_valid(BACNET_IOSCAN_MAP *map, BACNET_IOSCAN_TYPE *type)
+{
+    const COLUMNS_STORE *columns;
+    unsigned i, row;
+
+    columns = ioscan_columns(type->object_type);
+    for (i = 0; i < type->count; i++) {
+        row = type->row[i];
+        if ((row >= columns->count) ||
+            (columns->instance[row] !=
+             map->point[type->point[i]].object_instance)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set the values of a run of points of consecutive rows
+ * @param type - points of one type
+ * @param first - index of the first point of the run in the type
+ * @param count - number of points of the run
+ * @return number of objects that changed
+ */
+static unsigned
+ioscan_type_rows_set(BACNET_IOSCAN_TYPE *type, unsigned first, unsigned count)
+{
+    unsigned row = type->row[first];
+
+    switch (type->object_type) {
+        case OBJECT_ANALOG_INPUT:
+            return Analog_Input_Present_Value_Rows_Set(
+                row, &type->value[first], count, type->changed);
+        case OBJECT_ANALOG_VALUE:
+            return Analog_Value_Present_Value_Rows_Set(
+                row, &type->value[first], count, type->changed);
+        case OBJECT_BINARY_INPUT:
+            return Binary_Input_Present_Value_Rows_Set(
+                row, &type->binary[first], count, type->changed);
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Set the values of all of the points of one type
+ * @param type - points of one type
+ * @param value - value of each point of the map
+ * @param changed - bitmap of the changed points of the map, or NULL
+ * @return number of objects that changed
+ */
+static unsigned ioscan_type_update(
+    BACNET_IOSCAN_TYPE *type, const float *value, uint32_t *changed)
+{
+    unsigned changes = 0;
+    unsigned i, j, n, point;
+
+    /* gather the values into the order of the rows */
+    if (type->binary) {
+        for (i = 0; i < type->count; i++) {
+            type->binary[i] = ioscan_binary(value[type->point[i]]);
+        }
+    } else {
+        for (i = 0; i < type->count; i++) {
+            type->value[i] = value[type->point[i]];
+        }
+    }
+    /* set each run of consecutive rows at once */
+    for (i = 0; i < type->count; i += n) {
+        n = 1;
+        while (((i + n) < type->count) &&
+               (type->row[i + n] == (type->row[i] + n))) {
+            n++;
+        }
+        if (ioscan_type_rows_set(type, i, n) == 0) {
+            continue;
+        }
+        for (j = 0; j < n; j++) {
+            if (type->changed[j / 32] & (1UL << (j % 32))) {
+                changes++;
+                if (changed) {
+                    point = type->point[i + j];
+                    changed[point / 32] |= 1UL << (point % 32);
+                }
+            }
+        }
+    }
+
+    return changes;
+}
+#else
+/**
+ * @brief Set the value of one point with the setter of its object
+ * @param point - point
+ * @param value - value of the point
+ * @return true if the change of value flag of the object was set
+ */
+static bool ioscan_point_set(const BACNET_IOSCAN_POINT *point, float value)
+{
+    uint32_t instance = point->object_instance;
+    bool changed = false;
+
+    switch (point->object_type) {
+        case OBJECT_ANALOG_INPUT:
+            changed = Analog_Input_Change_Of_Value(instance);
+            Analog_Input_Present_Value_Set(instance, value);
+            return !changed && Analog_Input_Change_Of_Value(instance);
+        case OBJECT_ANALOG_VALUE:
+            changed = Analog_Value_Change_Of_Value(instance);
+            Analog_Value_Present_Value_Set(
+                instance, value, BACNET_MAX_PRIORITY);
+            return !changed && Analog_Value_Change_Of_Value(instance);
+        case OBJECT_BINARY_INPUT:
+            changed = Binary_Input_Change_Of_Value(instance);
+            Binary_Input_Present_Value_Set(instance, ioscan_binary(value));
+            return !changed && Binary_Input_Change_Of_Value(instance);
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determine if the object of a point exists
+ * @param point - point
+ * @return true if the object exists
+ */
+static bool ioscan_point_valid(const BACNET_IOSCAN_POINT *point)
+{
+    switch (point->object_type) {
+        case OBJECT_ANALOG_INPUT:
+            return Analog_Input_Valid_Instance(point->object_instance);
+        case OBJECT_ANALOG_VALUE:
+            return Analog_Value_Valid_Instance(point->object_instance);
+        case OBJECT_BINARY_INPUT:
+            return Binary_Input_Valid_Instance(point->object_instance);
+        default:
+            break;
+    }
+
+    return false;
+}
+#endif
+
+/**
+ * @brief Set the map of the points of a scan, and find the objects of
+ *  the points. The objects should be created first; see
+ *  ioscan_map_resolve() for objects that are created later.
+ * @param map - map to be set
+ * @param point - object of each point, which must outlive the map
+ * @param count - number of points
+ * @return true if the map was set, false if there was no memory or
+ *  a point has an object type that is not set by a scan
+ */
+bool ioscan_map_init(
+    BACNET_IOSCAN_MAP *map, const BACNET_IOSCAN_POINT *point, unsigned count)
+{
+    BACNET_IOSCAN_TYPE *type;
+    unsigned i;
+
+    if (!map || (!point && count)) {
+        return false;
+    }
+    memset(map, 0, sizeof(*map));
+    map->point = point;
+    map->count = count;
+    for (i = 0; i < IOSCAN_TYPE_MAX; i++) {
+        map->type[i].object_type = IOScan_Types[i];
+    }
+    for (i = 0; i < count; i++) {
+        type = ioscan_type(map, point[i].object_type);
+        if (!type) {
+            return false;
+        }
+        type->size++;
+    }
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    for (i = 0; i < IOSCAN_TYPE_MAX; i++) {
+        type = &map->type[i];
+        if (type->size == 0) {
+            continue;
+        }
+        type->row = bacnet_malloc(type->size * sizeof(*type->row));
+        type->point = bacnet_malloc(type->size * sizeof(*type->point));
+        if (type->object_type == OBJECT_BINARY_INPUT) {
+            type->binary =
+                bacnet_malloc(type->size * sizeof(*type->binary));
+        } else {
+            type->value = bacnet_malloc(type->size * sizeof(*type->value));
+        }
+        type->changed = bacnet_malloc(
+            COLUMNS_BITMAP_WORDS(type->size) * sizeof(*type->changed));
+        if (!type->row || !type->point || !(type->binary || type->value) ||
+            !type->changed) {
+            ioscan_map_cleanup(map);
+            return false;
+        }
+    }
+#endif
+    if (!ioscan_map_resolve(map)) {
+        ioscan_map_cleanup(map);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Release the memory of a map
+ * @param map - map to be cleaned up
+ */
+void ioscan_map_cleanup(BACNET_IOSCAN_MAP *map)
+{
+    unsigned i;
+
+    if (!map) {
+        return;
+    }
+    for (i = 0; i < IOSCAN_TYPE_MAX; i++) {
+        bacnet_free(map->type[i].row);
+        bacnet_free(map->type[i].point);
+        bacnet_free(map->type[i].value);
+        bacnet_free(map->type[i].binary);
+        bacnet_free(map->type[i].changed);
+    }
+    memset(map, 0, sizeof(*map));
+}
+
+/**
+ * @brief Find the objects of the points of a map again, such as after
+ *  the objects of missing points were created. A scan does this by
+ *  itself when objects of the map were deleted.
+ * @param map - map of the points
+ * @return true if the objects were found, false if there was no memory
+ */
+bool ioscan_map_resolve(BACNET_IOSCAN_MAP *map)
+{
+    unsigned i;
+
+    if (!map) {
+        return false;
+    }
+    map->missing = 0;
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    for (i = 0; i < IOSCAN_TYPE_MAX; i++) {
+        if (!ioscan_type_resolve(map, &map->type[i])) {
+            return false;
+        }
+    }
+#else
+    for (i = 0; i < map->count; i++) {
+        if (!ioscan_point_valid(&map->point[i])) {
+            map->missing++;
+        }
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * @brief Get the number of points of a map without an object, whose
+ *  values are not set by a scan
+ * @param map - map of the points
+ * @return number of points without an object
+ */
+unsigned ioscan_map_missing(const BACNET_IOSCAN_MAP *map)
+{
+    return (map ? map->missing : 0);
+}
+
+/**
+ * @brief Set the Present_Value of the objects of all of the points of a
+ *  map from the values of one scan. The objects that changed by their
+ *  COV_Increment, or whose binary value changed, are put into the COV
+ *  change queue. Without BACNET_OBJECT_COLUMNS_ENABLED, a point only
+ *  counts as changed when it sets the change of value flag of its object.
+ * @param map - map of the points
+ * @param value - value of each point of the map, where a non-zero value
+ *  is active for a binary object
+ * @param changed - bitmap of IOSCAN_BITMAP_WORDS(count) words, where bit
+ *  (i % 32) of word (i / 32) is set if the object of point i changed,
+ *  or NULL
+ * @return number of objects that changed
+ */
+unsigned
+ioscan_update(BACNET_IOSCAN_MAP *map, const float *value, uint32_t *changed)
+{
+    unsigned changes = 0;
+    unsigned i;
+
+    if (!map || !value) {
+        return 0;
+    }
+    if (changed) {
+        memset(changed, 0, IOSCAN_BITMAP_WORDS(map->count) * sizeof(*changed));
+    }
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    for (i = 0; i < IOSCAN_TYPE_MAX; i++) {
+        if (!ioscan_type_valid(map, &map->type[i])) {
+            if (!ioscan_map_resolve(map)) {
+                return 0;
+            }
+            break;
+        }
+    }
+    for (i = 0; i < IOSCAN_TYPE_MAX; i++) {
+        changes += ioscan_type_update(&map->type[i], value, changed);
+    }
+#else
+    for (i = 0; i < map->count; i++) {
+        if (ioscan_point_set(&map->point[i], value[i])) {
+            changes++;
+            if (changed) {
+                changed[i / 32] |= 1UL << (i % 32);
+            }
+        }
+    }
+#endif
+
+    return changes;
+}
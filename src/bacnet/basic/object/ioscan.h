@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief API to import the values of the points of a field bus, such as
+ *  Modbus registers or OPC items, into the Present_Value of the Analog
+ *  Input, Analog Value and Binary Input objects at each scan. The objects
+ *  of the points are found once, when the map of the points is set, and
+ *  each scan then sets the values of all of the points together.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_IOSCAN_H
+#define BACNET_BASIC_OBJECT_IOSCAN_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* number of 32-bit words of a bitmap with one bit for each of count
+   points */
+#define IOSCAN_BITMAP_WORDS(count) (((count) + 31) / 32)
+
+/** The object of one point of a scan */
+typedef struct bacnet_ioscan_point {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+} BACNET_IOSCAN_POINT;
+
+/** The points of one object type, in the order of their rows of the
+    columns of the objects, so that consecutive rows are set at once */
+typedef struct bacnet_ioscan_type {
+    BACNET_OBJECT_TYPE object_type;
+    unsigned size; /* number of points of the type */
+    unsigned count; /* number of points of the type with an object */
+    unsigned *row; /* row of the object of each point */
+    unsigned *point; /* index of each point in the map */
+    float *value; /* values of a scan, in the order of the rows */
+    BACNET_BINARY_PV *binary; /* binary values of a scan */
+    uint32_t *changed; /* changed objects of a scan */
+} BACNET_IOSCAN_TYPE;
+
+/* number of object types that a scan can set */
+#define IOSCAN_TYPE_MAX 3
+
+/** The map of the points of a scan to the objects */
+typedef struct bacnet_ioscan_map {
+    const BACNET_IOSCAN_POINT *point; /* points, owned by the caller */
+    unsigned count; /* number of points */
+    unsigned missing; /* number of points without an object */
+    BACNET_IOSCAN_TYPE type[IOSCAN_TYPE_MAX];
+} BACNET_IOSCAN_MAP;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool ioscan_map_init(
+    BACNET_IOSCAN_MAP *map, const BACNET_IOSCAN_POINT *point, unsigned count);
+BACNET_STACK_EXPORT
+void ioscan_map_cleanup(BACNET_IOSCAN_MAP *map);
+BACNET_STACK_EXPORT
+bool ioscan_map_resolve(BACNET_IOSCAN_MAP *map);
+BACNET_STACK_EXPORT
+unsigned ioscan_map_missing(const BACNET_IOSCAN_MAP *map);
+BACNET_STACK_EXPORT
+unsigned
+ioscan_update(BACNET_IOSCAN_MAP *map, const float *value, uint32_t *changed);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
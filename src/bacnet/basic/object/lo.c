@@ -21,7 +21,7 @@
 #include "bacnet/lighting.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
-#include "bacnet/basic/sys/linear.h"
+#include "bacnet/basic/sys/pool.h"
 #include "bacnet/proplist.h"
 /* me! */
 #include "bacnet/basic/object/lo.h"
@@ -40,6 +40,8 @@ struct object_data {
     float Feedback_Value;
     float Priority_Array[BACNET_MAX_PRIORITY];
     uint16_t Priority_Active_Bits;
+    /* highest active priority 1..16, or 0 if all are relinquished */
+    uint8_t Active_Priority;
     float Relinquish_Default;
     float Power;
     float Instantaneous_Power;
@@ -55,9 +57,27 @@ struct object_data {
     bool Blink_Warn_Enable : 1;
     bool Egress_Active : 1;
     bool Color_Override : 1;
+    /* the object is in the list of active transitions */
+    bool Transition_Active : 1;
+    /* a fade or ramp of the Tracking_Value, in fixed point */
+    int32_t Transition_Start;
+    int32_t Transition_Target;
+    uint32_t Transition_Duration;
+    uint32_t Transition_Elapsed;
+    /* the list of active transitions */
+    uint32_t Instance;
+    struct object_data *Transition_Next;
+    struct object_data *Transition_Prev;
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+/* the objects that are fading, ramping, or stepping, so that the timer
+   only has work to do for them, and not for the idle objects */
+static struct object_data *Transition_List;
+/* levels of the transitions in fixed point, in 0.001% */
+#define LIGHTING_LEVEL_SCALE 1000L
 /* callback for present value writes */
 static lighting_output_write_present_value_callback
     Lighting_Output_Write_Present_Value_Callback;
@@ -188,6 +208,35 @@ unsigned Lighting_Output_Instance_To_Index(uint32_t object_instance)
     return Keylist_Index(Object_List, object_instance);
 }
 
+/**
+ * @brief Update the active priority of an object after a priority-array
+ *  slot was commanded or relinquished, so that the present-value is
+ *  found without a search of the priority-array
+ * @param  pObject - specific object with valid data
+ * @param  priority - priority-array index value 1..16 that changed
+ */
+static void
+Active_Priority_Update(struct object_data *pObject, unsigned priority)
+{
+    unsigned p;
+
+    if (BIT_CHECK(pObject->Priority_Active_Bits, priority - 1)) {
+        if ((pObject->Active_Priority == 0) ||
+            (priority < pObject->Active_Priority)) {
+            pObject->Active_Priority = priority;
+        }
+    } else if (priority == pObject->Active_Priority) {
+        /* the active priority was relinquished: find the next one */
+        pObject->Active_Priority = 0;
+        for (p = priority; p < BACNET_MAX_PRIORITY; p++) {
+            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
+                pObject->Active_Priority = p + 1;
+                break;
+            }
+        }
+    }
+}
+
 /**
  * For a given object instance-number, determines the present-value
  *
@@ -198,17 +247,14 @@ unsigned Lighting_Output_Instance_To_Index(uint32_t object_instance)
 float Lighting_Output_Present_Value(uint32_t object_instance)
 {
     float value = 0.0;
-    unsigned p = 0;
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        value = pObject->Relinquish_Default;
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-                value = pObject->Priority_Array[p];
-                break;
-            }
+        if (pObject->Active_Priority) {
+            value = pObject->Priority_Array[pObject->Active_Priority - 1];
+        } else {
+            value = pObject->Relinquish_Default;
         }
     }
 
@@ -323,17 +369,7 @@ static int Lighting_Output_Priority_Array_Encode(
  */
 static unsigned Present_Value_Priority(struct object_data *pObject)
 {
-    unsigned p = 0; /* loop counter */
-    unsigned priority = 0; /* return value */
-
-    for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-        if (BIT_CHECK(pObject->Priority_Active_Bits, p)) {
-            priority = p + 1;
-            break;
-        }
-    }
-
-    return priority;
+    return pObject->Active_Priority;
 }
 
 /**
@@ -355,6 +391,7 @@ Present_Value_Relinquish(struct object_data *pObject, unsigned priority)
         priority--;
         BIT_CLEAR(pObject->Priority_Active_Bits, priority);
         pObject->Priority_Array[priority] = 0.0;
+        Active_Priority_Update(pObject, priority + 1);
         status = true;
     }
 
@@ -381,6 +418,7 @@ Present_Value_Set(struct object_data *pObject, float value, unsigned priority)
         priority--;
         BIT_SET(pObject->Priority_Active_Bits, priority);
         pObject->Priority_Array[priority] = value;
+        Active_Priority_Update(pObject, priority + 1);
         status = true;
     }
 
@@ -430,6 +468,7 @@ bool Lighting_Output_Present_Value_Set(
             priority--;
             BIT_SET(pObject->Priority_Active_Bits, priority);
             pObject->Priority_Array[priority] = value;
+            Active_Priority_Update(pObject, priority + 1);
             status = true;
         }
     }
@@ -437,6 +476,131 @@ bool Lighting_Output_Present_Value_Set(
     return status;
 }
 
+/**
+ * @brief Convert a level in percent to the fixed point of the transitions
+ * @param value - level in percent
+ * @return level in 0.001%
+ */
+static int32_t Lighting_Level_Fixed(float value)
+{
+    if (isless(value, 0.0f)) {
+        return -(int32_t)((-value * LIGHTING_LEVEL_SCALE) + 0.5f);
+    }
+
+    return (int32_t)((value * LIGHTING_LEVEL_SCALE) + 0.5f);
+}
+
+/**
+ * @brief Remove an object from the list of active transitions
+ * @param pObject - object to remove
+ */
+static void Lighting_Output_Transition_Remove(struct object_data *pObject)
+{
+    if (!pObject->Transition_Active) {
+        return;
+    }
+    if (pObject->Transition_Prev) {
+        pObject->Transition_Prev->Transition_Next = pObject->Transition_Next;
+    } else {
+        Transition_List = pObject->Transition_Next;
+    }
+    if (pObject->Transition_Next) {
+        pObject->Transition_Next->Transition_Prev = pObject->Transition_Prev;
+    }
+    pObject->Transition_Next = NULL;
+    pObject->Transition_Prev = NULL;
+    pObject->Transition_Active = false;
+}
+
+/**
+ * @brief Add an object to the list of active transitions
+ * @param pObject - object to add
+ */
+static void Lighting_Output_Transition_Add(struct object_data *pObject)
+{
+    if (pObject->Transition_Active) {
+        return;
+    }
+    pObject->Transition_Prev = NULL;
+    pObject->Transition_Next = Transition_List;
+    if (Transition_List) {
+        Transition_List->Transition_Prev = pObject;
+    }
+    Transition_List = pObject;
+    pObject->Transition_Active = true;
+}
+
+/**
+ * @brief Start the transition of the Tracking_Value of an object for the
+ *  operation of its Lighting_Command, from the current Tracking_Value.
+ *  A ramp is a fade whose duration follows from its ramp-rate.
+ * @param pObject - object whose Lighting_Command was set
+ */
+static void Lighting_Output_Transition_Start(struct object_data *pObject)
+{
+    float target_value, rate;
+    int32_t delta;
+
+    switch (pObject->Lighting_Command.operation) {
+        case BACNET_LIGHTS_FADE_TO:
+            pObject->Transition_Start =
+                Lighting_Level_Fixed(pObject->Tracking_Value);
+            pObject->Transition_Target =
+                Lighting_Level_Fixed(pObject->Lighting_Command.target_level);
+            pObject->Transition_Duration = pObject->Lighting_Command.fade_time;
+            pObject->Transition_Elapsed = 0;
+            Lighting_Output_Transition_Add(pObject);
+            break;
+        case BACNET_LIGHTS_RAMP_TO:
+            target_value = pObject->Lighting_Command.target_level;
+            /* clamp target within min/max, if needed */
+            if (isgreater(target_value, pObject->Max_Actual_Value)) {
+                target_value = pObject->Max_Actual_Value;
+            }
+            if (isless(target_value, pObject->Min_Actual_Value)) {
+                target_value = pObject->Min_Actual_Value;
+            }
+            pObject->Transition_Start =
+                Lighting_Level_Fixed(pObject->Tracking_Value);
+            pObject->Transition_Target = Lighting_Level_Fixed(target_value);
+            delta = pObject->Transition_Target - pObject->Transition_Start;
+            if (delta < 0) {
+                delta = -delta;
+            }
+            /* percent per second is 0.001% per millisecond */
+            rate = pObject->Lighting_Command.ramp_rate;
+            if (isgreater(rate, 0.0f)) {
+                /* rounded up, so that the ramp is not faster than its rate */
+                pObject->Transition_Duration = (uint32_t)((float)delta / rate);
+                if (isless(
+                        (float)pObject->Transition_Duration * rate,
+                        (float)delta)) {
+                    pObject->Transition_Duration++;
+                }
+            } else {
+                pObject->Transition_Duration = 0;
+            }
+            pObject->Transition_Elapsed = 0;
+            Lighting_Output_Transition_Add(pObject);
+            break;
+        case BACNET_LIGHTS_STEP_UP:
+        case BACNET_LIGHTS_STEP_DOWN:
+        case BACNET_LIGHTS_STEP_ON:
+        case BACNET_LIGHTS_STEP_OFF:
+            /* stepped at the next timer */
+            Lighting_Output_Transition_Add(pObject);
+            break;
+        case BACNET_LIGHTS_NONE:
+        case BACNET_LIGHTS_STOP:
+            pObject->In_Progress = BACNET_LIGHTING_IDLE;
+            Lighting_Output_Transition_Remove(pObject);
+            break;
+        default:
+            Lighting_Output_Transition_Remove(pObject);
+            break;
+    }
+}
+
 /**
  * For a given object instance-number, writes the present-value
  *
@@ -568,6 +732,7 @@ static bool Lighting_Output_Present_Value_Write(
                             BACNET_LIGHTS_FADE_TO;
                     }
                     pObject->Lighting_Command.target_level = value;
+                    Lighting_Output_Transition_Start(pObject);
                 }
                 status = true;
             } else {
@@ -668,6 +833,7 @@ static bool Lighting_Output_Present_Value_Relinquish_Write(
                     pObject->Lighting_Command.operation = BACNET_LIGHTS_FADE_TO;
                 }
                 pObject->Lighting_Command.target_level = value;
+                Lighting_Output_Transition_Start(pObject);
             }
             status = true;
         } else {
@@ -801,7 +967,22 @@ bool Lighting_Output_Lighting_Command_Set(
     if (pObject) {
         /* FIXME: check lighting command member values */
         status = lighting_command_copy(&pObject->Lighting_Command, value);
-        /* FIXME: set all the other values, and get the light levels moving */
+        if (status) {
+            /* the optional values of the command that are not given */
+            if (!pObject->Lighting_Command.use_fade_time) {
+                pObject->Lighting_Command.fade_time =
+                    pObject->Default_Fade_Time;
+            }
+            if (!pObject->Lighting_Command.use_ramp_rate) {
+                pObject->Lighting_Command.ramp_rate =
+                    pObject->Default_Ramp_Rate;
+            }
+            if (!pObject->Lighting_Command.use_step_increment) {
+                pObject->Lighting_Command.step_increment =
+                    pObject->Default_Step_Increment;
+            }
+            Lighting_Output_Transition_Start(pObject);
+        }
     }
 
     return status;
@@ -1995,134 +2176,51 @@ bool Lighting_Output_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 }
 
 /**
- * Handles the timing for a single Lighting Output object Fade
+ * Updates the object tracking value while fading or ramping
  *
- * @param pLight - Lighting Output object
- * @param pCommand - BACNET_LIGHTING_COMMAND of the Lighting Output object
- * @param milliseconds - number of milliseconds elapsed since previously
- * called.  Works best when called about every 10 milliseconds.
+ * Commands the Tracking_Value to move from its value at the start of the
+ * transition to the target-level, in proportion to the elapsed time of
+ * the transition, in fixed point, so that the error of each step does not
+ * pile up over a long transition. While the transition is executing,
+ * In_Progress shall be set to FADE_ACTIVE or RAMP_ACTIVE.
+ *
+ * @param  pObject - object that is fading or ramping
+ * @param milliseconds - number of milliseconds elapsed
  */
-static void
-Lighting_Output_Fade_Handler(uint32_t object_instance, uint16_t milliseconds)
+static void Lighting_Output_Transition_Handler(
+    struct object_data *pObject, uint16_t milliseconds)
 {
-    struct object_data *pObject;
     float old_value;
-    float x1, x2, x3, y1, y3;
+    int64_t level;
 
-    pObject = Keylist_Data(Object_List, object_instance);
-    if (!pObject) {
-        return;
-    }
     old_value = pObject->Tracking_Value;
-    if (milliseconds >= pObject->Lighting_Command.fade_time) {
-        /* stop fading */
-        pObject->Tracking_Value = pObject->Lighting_Command.target_level;
+    pObject->Transition_Elapsed += milliseconds;
+    if (pObject->Transition_Elapsed >= pObject->Transition_Duration) {
+        /* stop the transition */
+        pObject->Tracking_Value =
+            (float)pObject->Transition_Target / LIGHTING_LEVEL_SCALE;
         pObject->In_Progress = BACNET_LIGHTING_IDLE;
         pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
         pObject->Lighting_Command.fade_time = 0;
+        Lighting_Output_Transition_Remove(pObject);
     } else {
-        if (!islessgreater(
-                pObject->Tracking_Value,
-                pObject->Lighting_Command.target_level)) {
-            /* stop fading */
-            pObject->Tracking_Value = pObject->Lighting_Command.target_level;
-            pObject->In_Progress = BACNET_LIGHTING_IDLE;
-            pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-            pObject->Lighting_Command.fade_time = 0;
-        } else {
-            /* fading */
-            x1 = 0.0f;
-            x2 = (float)milliseconds;
-            x3 = (float)pObject->Lighting_Command.fade_time;
-            y1 = old_value;
-            y3 = pObject->Lighting_Command.target_level;
-            pObject->Tracking_Value = linear_interpolate(x1, x2, x3, y1, y3);
-            pObject->Lighting_Command.fade_time -= milliseconds;
+        level = (int64_t)pObject->Transition_Target -
+            pObject->Transition_Start;
+        level = (level * pObject->Transition_Elapsed) /
+            pObject->Transition_Duration;
+        level += pObject->Transition_Start;
+        pObject->Tracking_Value = (float)level / LIGHTING_LEVEL_SCALE;
+        if (pObject->Lighting_Command.operation == BACNET_LIGHTS_FADE_TO) {
+            pObject->Lighting_Command.fade_time =
+                pObject->Transition_Duration - pObject->Transition_Elapsed;
             pObject->In_Progress = BACNET_LIGHTING_FADE_ACTIVE;
-        }
-    }
-    if (Lighting_Output_Write_Present_Value_Callback) {
-        Lighting_Output_Write_Present_Value_Callback(
-            object_instance, old_value, pObject->Tracking_Value);
-    }
-}
-
-/**
- * Updates the object tracking value while ramping
- *
- * Commands Present_Value to ramp from the current Tracking_Value to the
- * target-level specified in the command. The ramp operation
- * changes the output from its current value to target-level,
- * at a particular percent per second defined by ramp-rate.
- * While the ramp operation is executing, In_Progress shall be set
- * to RAMP_ACTIVE, and Tracking_Value shall be updated to reflect the current
- * progress of the ramp. <target-level> shall be clamped to
- * Min_Actual_Value and Max_Actual_Value.
- *
- * @param  object_instance - object-instance number of the object
- * @param milliseconds - number of milliseconds elapsed
- */
-static void
-Lighting_Output_Ramp_Handler(uint32_t object_instance, uint16_t milliseconds)
-{
-    float old_value, target_value, min_value, max_value, step_value, steps;
-    struct object_data *pObject;
-
-    pObject = Keylist_Data(Object_List, object_instance);
-    if (!pObject) {
-        return;
-    }
-    old_value = pObject->Tracking_Value;
-    min_value = pObject->Min_Actual_Value;
-    max_value = pObject->Max_Actual_Value;
-    target_value = pObject->Lighting_Command.target_level;
-    /* clamp target within min/max, if needed */
-    if (isgreater(target_value, max_value)) {
-        target_value = max_value;
-    }
-    if (isless(target_value, min_value)) {
-        target_value = min_value;
-    }
-    /* determine the number of steps */
-    if (milliseconds <= 1000) {
-        /* percent per second */
-        steps = linear_interpolate(
-            0.0f, (float)milliseconds, 1000.0f, 0.0f,
-            pObject->Lighting_Command.ramp_rate);
-    } else {
-        steps = ((float)milliseconds * pObject->Lighting_Command.ramp_rate) /
-            1000.0f;
-    }
-    if (!islessgreater(pObject->Tracking_Value, target_value)) {
-        /* stop ramping */
-        pObject->Tracking_Value = target_value;
-        pObject->In_Progress = BACNET_LIGHTING_IDLE;
-        pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-    } else {
-        if (isless(old_value, target_value)) {
-            step_value = old_value + steps;
-        } else if (isgreater(old_value, target_value)) {
-            if (isgreater(steps, old_value)) {
-                step_value = old_value - steps;
-            } else {
-                step_value = target_value;
-            }
         } else {
-            step_value = target_value;
-        }
-        /* clamp target within min/max, if needed */
-        if (isgreater(step_value, max_value)) {
-            step_value = max_value;
-        }
-        if (isless(step_value, min_value)) {
-            step_value = min_value;
+            pObject->In_Progress = BACNET_LIGHTING_RAMP_ACTIVE;
         }
-        pObject->Tracking_Value = step_value;
-        pObject->In_Progress = BACNET_LIGHTING_RAMP_ACTIVE;
     }
     if (Lighting_Output_Write_Present_Value_Callback) {
         Lighting_Output_Write_Present_Value_Callback(
-            object_instance, old_value, pObject->Tracking_Value);
+            pObject->Instance, old_value, pObject->Tracking_Value);
     }
 }
 
@@ -2298,6 +2396,42 @@ static void Lighting_Output_Step_Off_Handler(uint32_t object_instance)
     }
 }
 
+/**
+ * @brief Updates the tracking value of one lighting object that is in an
+ *  active transition
+ * @param pObject - the object in the list of active transitions
+ * @param milliseconds - number of milliseconds elapsed
+ */
+static void Lighting_Output_Transition_Timer(
+    struct object_data *pObject, uint16_t milliseconds)
+{
+    switch (pObject->Lighting_Command.operation) {
+        case BACNET_LIGHTS_FADE_TO:
+        case BACNET_LIGHTS_RAMP_TO:
+            Lighting_Output_Transition_Handler(pObject, milliseconds);
+            break;
+        case BACNET_LIGHTS_STEP_UP:
+            Lighting_Output_Step_Up_Handler(pObject->Instance);
+            Lighting_Output_Transition_Remove(pObject);
+            break;
+        case BACNET_LIGHTS_STEP_DOWN:
+            Lighting_Output_Step_Down_Handler(pObject->Instance);
+            Lighting_Output_Transition_Remove(pObject);
+            break;
+        case BACNET_LIGHTS_STEP_ON:
+            Lighting_Output_Step_On_Handler(pObject->Instance);
+            Lighting_Output_Transition_Remove(pObject);
+            break;
+        case BACNET_LIGHTS_STEP_OFF:
+            Lighting_Output_Step_Off_Handler(pObject->Instance);
+            Lighting_Output_Transition_Remove(pObject);
+            break;
+        default:
+            Lighting_Output_Transition_Remove(pObject);
+            break;
+    }
+}
+
 /**
  * @brief Updates the lighting object tracking value per ramp or fade or step
  * @param  object_instance - object-instance number of the object
@@ -2309,44 +2443,49 @@ void Lighting_Output_Timer(uint32_t object_instance, uint16_t milliseconds)
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if (pObject) {
-        switch (pObject->Lighting_Command.operation) {
-            case BACNET_LIGHTS_NONE:
-                pObject->In_Progress = BACNET_LIGHTING_IDLE;
-                break;
-            case BACNET_LIGHTS_FADE_TO:
-                Lighting_Output_Fade_Handler(object_instance, milliseconds);
-                break;
-            case BACNET_LIGHTS_RAMP_TO:
-                Lighting_Output_Ramp_Handler(object_instance, milliseconds);
-                break;
-            case BACNET_LIGHTS_STEP_UP:
-                Lighting_Output_Step_Up_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_STEP_DOWN:
-                Lighting_Output_Step_Down_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_STEP_ON:
-                Lighting_Output_Step_On_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_STEP_OFF:
-                Lighting_Output_Step_Off_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_WARN:
-                break;
-            case BACNET_LIGHTS_WARN_OFF:
-                break;
-            case BACNET_LIGHTS_WARN_RELINQUISH:
-                break;
-            case BACNET_LIGHTS_STOP:
-                pObject->In_Progress = BACNET_LIGHTING_IDLE;
-                break;
-            default:
-                break;
-        }
+    if (pObject && pObject->Transition_Active) {
+        Lighting_Output_Transition_Timer(pObject, milliseconds);
+    }
+}
+
+/**
+ * @brief Updates the tracking value of each lighting object that is
+ *  fading, ramping, or stepping, without looking at the idle objects.
+ *  Use this instead of calling Lighting_Output_Timer() for each object.
+ * @param milliseconds - number of milliseconds elapsed since previously
+ * called.  Suggest that this is called every 10 milliseconds.
+ */
+void Lighting_Output_Timer_Active(uint16_t milliseconds)
+{
+    struct object_data *pObject, *pNext;
+
+    pObject = Transition_List;
+    while (pObject) {
+        /* the object leaves the list at the end of its transition */
+        pNext = pObject->Transition_Next;
+        Lighting_Output_Transition_Timer(pObject, milliseconds);
+        pObject = pNext;
     }
 }
 
+/**
+ * @brief Get the number of lighting objects that are fading, ramping,
+ *  or stepping
+ * @return number of objects in an active transition
+ */
+unsigned Lighting_Output_Timer_Active_Count(void)
+{
+    struct object_data *pObject;
+    unsigned count = 0;
+
+    for (pObject = Transition_List; pObject;
+         pObject = pObject->Transition_Next) {
+        count++;
+    }
+
+    return count;
+}
+
 /**
  * @brief Sets a callback used when present-value is written from BACnet
  * @param cb - callback used to provide indications
@@ -2380,7 +2519,7 @@ uint32_t Lighting_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (!pObject) {
             return BACNET_MAX_INSTANCE;
         }
@@ -2409,6 +2548,7 @@ uint32_t Lighting_Output_Create(uint32_t object_instance)
             pObject->Priority_Array[p] = 0.0;
             BIT_CLEAR(pObject->Priority_Active_Bits, p);
         }
+        pObject->Active_Priority = 0;
         pObject->Relinquish_Default = 0.0;
         pObject->Power = 0.0;
         pObject->Instantaneous_Power = 0.0;
@@ -2420,10 +2560,14 @@ uint32_t Lighting_Output_Create(uint32_t object_instance)
         pObject->Color_Reference.instance = BACNET_MAX_INSTANCE;
         pObject->Override_Color_Reference.type = OBJECT_COLOR;
         pObject->Override_Color_Reference.instance = BACNET_MAX_INSTANCE;
+        pObject->Transition_Active = false;
+        pObject->Transition_Next = NULL;
+        pObject->Transition_Prev = NULL;
+        pObject->Instance = object_instance;
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
-            free(pObject);
+            pool_free(&Object_Pool, pObject);
             return BACNET_MAX_INSTANCE;
         }
     }
@@ -2431,6 +2575,30 @@ uint32_t Lighting_Output_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Lighting Output objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Lighting_Output_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Lighting_Output_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an object instance
  * @param object_instance - object-instance number of the object
@@ -2443,7 +2611,8 @@ bool Lighting_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Lighting_Output_Transition_Remove(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -2461,12 +2630,14 @@ void Lighting_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
+    Transition_List = NULL;
 }
 
 /**
@@ -2476,5 +2647,6 @@ void Lighting_Output_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
@@ -231,6 +231,11 @@ extern "C" {
     void Lighting_Output_Timer(
         uint32_t object_instance,
         uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    void Lighting_Output_Timer_Active(
+        uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    unsigned Lighting_Output_Timer_Active_Count(void);
 
     BACNET_STACK_EXPORT
     void Lighting_Output_Write_Present_Value_Callback_Set(
@@ -239,6 +244,9 @@ extern "C" {
     BACNET_STACK_EXPORT
     uint32_t Lighting_Output_Create(uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Lighting_Output_Create_Bulk(
+        uint32_t object_instance, unsigned count);
+    BACNET_STACK_EXPORT
     bool Lighting_Output_Delete(uint32_t object_instance);
     BACNET_STACK_EXPORT
     void Lighting_Output_Cleanup(void);
@@ -105,6 +105,9 @@ extern "C" {
     uint32_t Life_Safety_Point_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Life_Safety_Point_Create_Bulk(
+        uint32_t object_instance, unsigned count);
+    BACNET_STACK_EXPORT
     bool Life_Safety_Point_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
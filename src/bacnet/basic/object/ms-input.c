@@ -19,6 +19,7 @@
 #include "bacnet/rp.h"
 #include "bacnet/wp.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
 #include "bacnet/basic/services.h"
 /* me! */
 #include "bacnet/basic/object/ms-input.h"
@@ -36,6 +37,8 @@ struct object_data {
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_MULTI_STATE_INPUT;
 /* callback for present value writes */
@@ -311,14 +314,18 @@ uint32_t Multistate_Input_Present_Value(uint32_t object_instance)
 
 /**
  * @brief For a given object instance-number, checks the present-value for COV
+ * @param  object_instance - object-instance number of the object
  * @param  pObject - specific object with valid data
  * @param  value - floating point analog value
  */
 static void Multistate_Input_Present_Value_COV_Detect(
-    struct object_data *pObject, uint32_t value)
+    uint32_t object_instance, struct object_data *pObject, uint32_t value)
 {
     if (pObject) {
         if (pObject->Present_Value != value) {
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Change_Of_Value = true;
         }
     }
@@ -341,7 +348,8 @@ bool Multistate_Input_Present_Value_Set(
     if (pObject) {
         max_states = state_name_count(pObject->State_Text);
         if ((value >= 1) && (value <= max_states)) {
-            Multistate_Input_Present_Value_COV_Detect(pObject, value);
+            Multistate_Input_Present_Value_COV_Detect(
+                object_instance, pObject, value);
             pObject->Present_Value = value;
             status = true;
         }
@@ -374,7 +382,8 @@ static bool Multistate_Input_Present_Value_Write(
         if (value <= UINT32_MAX) {
             if (pObject->Write_Enabled) {
                 old_value = pObject->Present_Value;
-                Multistate_Input_Present_Value_COV_Detect(pObject, value);
+                Multistate_Input_Present_Value_COV_Detect(
+                    object_instance, pObject, value);
                 pObject->Present_Value = value;
                 if (pObject->Out_Of_Service) {
                     /* The physical point that the object represents
@@ -434,6 +443,9 @@ void Multistate_Input_Out_Of_Service_Set(uint32_t object_instance, bool value)
     pObject = Multistate_Input_Object(object_instance);
     if (pObject) {
             pObject->Out_Of_Service = value;
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Change_Of_Value = true;
     }
 
@@ -547,6 +559,9 @@ bool Multistate_Input_Reliability_Set(
             fault = Multistate_Input_Object_Fault(pObject);
             pObject->Reliability = value;
             if (fault != Multistate_Input_Object_Fault(pObject)) {
+                if (!pObject->Change_Of_Value) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Change_Of_Value = true;
             }
             status = true;
@@ -873,7 +888,7 @@ uint32_t Multistate_Input_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->State_Text = Default_State_Text;
@@ -884,7 +899,7 @@ uint32_t Multistate_Input_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -895,6 +910,30 @@ uint32_t Multistate_Input_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Multistate Input objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Multistate_Input_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Multistate_Input_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * @brief Delete an object and its data from the object list
  * @param  object_instance - object-instance number of the object
@@ -907,7 +946,7 @@ bool Multistate_Input_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -925,10 +964,11 @@ void Multistate_Input_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -940,5 +980,6 @@ void Multistate_Input_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
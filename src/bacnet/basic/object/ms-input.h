@@ -140,6 +140,9 @@ extern "C" {
     uint32_t Multistate_Input_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Multistate_Input_Create_Bulk(
+        uint32_t object_instance, unsigned count);
+    BACNET_STACK_EXPORT
     bool Multistate_Input_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
@@ -27,6 +27,7 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
 /* me! */
 #include "mso.h"
 
@@ -35,6 +36,8 @@ struct object_data {
     bool Changed : 1;
     bool Relinquished[BACNET_MAX_PRIORITY];
     uint8_t Priority_Array[BACNET_MAX_PRIORITY];
+    /* highest active priority 1..16, or 0 if all are relinquished */
+    uint8_t Active_Priority;
     uint8_t Relinquish_Default;
     uint8_t Reliability;
     const char *Object_Name;
@@ -44,6 +47,8 @@ struct object_data {
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 /* common object type */
 static const BACNET_OBJECT_TYPE Object_Type = OBJECT_MULTI_STATE_OUTPUT;
 /* callback for present value writes */
@@ -213,6 +218,35 @@ uint32_t Multistate_Output_Max_States(uint32_t object_instance)
     return count;
 }
 
+/**
+ * @brief Update the active priority of an object after a priority-array
+ *  slot was commanded or relinquished, so that the present-value is
+ *  found without a search of the priority-array
+ * @param  pObject - specific object with valid data
+ * @param  priority - priority-array index value 1..16 that changed
+ */
+static void
+Object_Active_Priority_Update(struct object_data *pObject, unsigned priority)
+{
+    unsigned p;
+
+    if (!pObject->Relinquished[priority - 1]) {
+        if ((pObject->Active_Priority == 0) ||
+            (priority < pObject->Active_Priority)) {
+            pObject->Active_Priority = priority;
+        }
+    } else if (priority == pObject->Active_Priority) {
+        /* the active priority was relinquished: find the next one */
+        pObject->Active_Priority = 0;
+        for (p = priority; p < BACNET_MAX_PRIORITY; p++) {
+            if (!pObject->Relinquished[p]) {
+                pObject->Active_Priority = p + 1;
+                break;
+            }
+        }
+    }
+}
+
 /**
  * @brief For a given object instance-number, determines the present-value
  * @param  object_instance - object-instance number of the object
@@ -221,15 +255,12 @@ uint32_t Multistate_Output_Max_States(uint32_t object_instance)
 static uint32_t Object_Present_Value(struct object_data *pObject)
 {
     uint32_t value = 1;
-    uint8_t priority = 0; /* loop counter */
 
     if (pObject) {
-        value = pObject->Relinquish_Default;
-        for (priority = 0; priority < BACNET_MAX_PRIORITY; priority++) {
-            if (!pObject->Relinquished[priority]) {
-                value = pObject->Priority_Array[priority];
-                break;
-            }
+        if (pObject->Active_Priority) {
+            value = pObject->Priority_Array[pObject->Active_Priority - 1];
+        } else {
+            value = pObject->Relinquish_Default;
         }
     }
 
@@ -289,18 +320,12 @@ static int Multistate_Output_Priority_Array_Encode(
  */
 unsigned Multistate_Output_Present_Value_Priority(uint32_t object_instance)
 {
-    unsigned p = 0; /* loop counter */
     unsigned priority = 0; /* return value */
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        for (p = 0; p < BACNET_MAX_PRIORITY; p++) {
-            if (!pObject->Relinquished[p]) {
-                priority = p + 1;
-                break;
-            }
-        }
+        priority = pObject->Active_Priority;
     }
 
     return priority;
@@ -370,8 +395,12 @@ bool Multistate_Output_Present_Value_Set(
             old_value = Object_Present_Value(pObject);
             pObject->Relinquished[priority - 1] = false;
             pObject->Priority_Array[priority - 1] = value;
+            Object_Active_Priority_Update(pObject, priority);
             new_value = Object_Present_Value(pObject);
             if (old_value != new_value) {
+                if (!pObject->Changed) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Changed = true;
             }
             status = true;
@@ -401,8 +430,12 @@ bool Multistate_Output_Present_Value_Relinquish(
             old_value = Object_Present_Value(pObject);
             pObject->Relinquished[priority - 1] = true;
             pObject->Priority_Array[priority - 1] = 0;
+            Object_Active_Priority_Update(pObject, priority);
             new_value = Object_Present_Value(pObject);
             if (old_value != new_value) {
+                if (!pObject->Changed) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Changed = true;
             }
             status = true;
@@ -556,6 +589,9 @@ void Multistate_Output_Out_Of_Service_Set(uint32_t object_instance, bool value)
     if (pObject) {
         if (pObject->Out_Of_Service != value) {
             pObject->Out_Of_Service = value;
+            if (!pObject->Changed) {
+                handler_cov_object_changed(Object_Type, object_instance);
+            }
             pObject->Changed = true;
         }
     }
@@ -755,6 +791,9 @@ bool Multistate_Output_Reliability_Set(
             fault = Multistate_Output_Object_Fault(pObject);
             pObject->Reliability = value;
             if (fault != Multistate_Output_Object_Fault(pObject)) {
+                if (!pObject->Changed) {
+                    handler_cov_object_changed(Object_Type, object_instance);
+                }
                 pObject->Changed = true;
             }
             status = true;
@@ -1127,7 +1166,7 @@ uint32_t Multistate_Output_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (pObject) {
             pObject->Object_Name = NULL;
             pObject->State_Text = Default_State_Text;
@@ -1138,11 +1177,12 @@ uint32_t Multistate_Output_Create(uint32_t object_instance)
                 pObject->Relinquished[priority] = true;
                 pObject->Priority_Array[priority] = 0;
             }
+            pObject->Active_Priority = 0;
             pObject->Relinquish_Default = 1;
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
                 return BACNET_MAX_INSTANCE;
             }
         } else {
@@ -1153,6 +1193,30 @@ uint32_t Multistate_Output_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Multistate Output objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Multistate_Output_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Multistate_Output_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * @brief Delete an object and its data from the object list
  * @param  object_instance - object-instance number of the object
@@ -1165,7 +1229,7 @@ bool Multistate_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -1183,10 +1247,11 @@ void Multistate_Output_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -1198,5 +1263,6 @@ void Multistate_Output_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
@@ -154,6 +154,9 @@ extern "C" {
     uint32_t Multistate_Output_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Multistate_Output_Create_Bulk(
+        uint32_t object_instance, unsigned count);
+    BACNET_STACK_EXPORT
     bool Multistate_Output_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
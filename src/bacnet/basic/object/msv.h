@@ -131,6 +131,9 @@ extern "C" {
     uint32_t Multistate_Value_Create(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
+    unsigned Multistate_Value_Create_Bulk(
+        uint32_t object_instance, unsigned count);
+    BACNET_STACK_EXPORT
     bool Multistate_Value_Delete(
         uint32_t object_instance);
     BACNET_STACK_EXPORT
@@ -17,7 +17,9 @@
 #include "bacnet/bacapp.h"
 #include "bacnet/bacdest.h"
 #include "bacnet/datetime.h"
+#include "bacnet/dcc.h"
 #include "bacnet/event.h"
+#include "bacnet/npdu.h"
 #include "bacnet/wp.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/object/nc.h"
@@ -38,6 +40,57 @@ static NOTIFICATION_CLASS_INFO NC_Info[MAX_NOTIFICATION_CLASSES];
 /* buffer for sending event messages */
 static uint8_t Event_Buffer[MAX_APDU];
 
+#if (NC_MAX_RECIPIENTS > 32)
+#error "NC_MAX_RECIPIENTS does not fit into the recipient bit masks"
+#endif
+/* The recipients that are in their valid days and times. They are kept
+   for the date on which they were found, until the next FromTime after
+   that, or until the first ToTime passes, so that each event does not
+   check the window of each recipient. */
+struct nc_recipient_cache {
+    bool Valid;
+    BACNET_DATE Date;
+    BACNET_TIME Next_From;
+    BACNET_TIME Next_To;
+    uint32_t Active;
+};
+static struct nc_recipient_cache NC_Recipient_Cache[MAX_NOTIFICATION_CLASSES];
+/* A hash table of the recipients of each Notification Class, so that
+   AddListElement and RemoveListElement find each element of a request
+   without comparing it with each recipient. Each bucket holds the
+   Recipient_List index plus one, or zero when it is empty, and is
+   probed linearly. */
+#if (NC_MAX_RECIPIENTS <= 8)
+#define NC_RECIPIENT_BUCKETS 16
+#elif (NC_MAX_RECIPIENTS <= 16)
+#define NC_RECIPIENT_BUCKETS 32
+#else
+#define NC_RECIPIENT_BUCKETS 64
+#endif
+struct nc_recipient_index {
+    bool Valid;
+    /* number of recipients that are not the wildcard device */
+    uint8_t Count;
+    uint8_t Bucket[NC_RECIPIENT_BUCKETS];
+};
+static struct nc_recipient_index NC_Recipient_Index[MAX_NOTIFICATION_CLASSES];
+/* called with each event notification, such as by an Event Log */
+static notification_class_event_callback NC_Event_Callback;
+
+#if NC_EVENT_QUEUE_SIZE
+/* an encoded event, without its processIdentifier, and the recipients
+   of its notification class that it has not been sent to yet */
+struct nc_event_queue_entry {
+    uint16_t NC_Index;
+    uint16_t Service_Len;
+    uint32_t Recipients;
+    uint8_t Service[NC_EVENT_QUEUE_APDU_SIZE];
+};
+static struct nc_event_queue_entry NC_Event_Queue[NC_EVENT_QUEUE_SIZE];
+static unsigned NC_Event_Queue_Head;
+static unsigned NC_Event_Queue_Count;
+#endif
+
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Notification_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_NOTIFICATION_CLASS, PROP_PRIORITY,
@@ -79,7 +132,13 @@ void Notification_Class_Init(void)
             destination = &NC_Info[NotifyIdx].Recipient_List[i];
             bacnet_destination_default_init(destination);
         }
+        NC_Recipient_Cache[NotifyIdx].Valid = false;
+        NC_Recipient_Index[NotifyIdx].Valid = false;
     }
+#if NC_EVENT_QUEUE_SIZE
+    NC_Event_Queue_Head = 0;
+    NC_Event_Queue_Count = 0;
+#endif
 
     return;
 }
@@ -422,6 +481,8 @@ bool Notification_Class_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     /* nothing to do - we have the address */
                 }
             }
+            NC_Recipient_Cache[CurrentNotify - NC_Info].Valid = false;
+            NC_Recipient_Index[CurrentNotify - NC_Info].Valid = false;
             status = true;
             break;
 
@@ -493,6 +554,8 @@ bool Notification_Class_Set_Recipient_List(
 
     for (i = 0; i < NC_MAX_RECIPIENTS; i++)
       CurrentNotify->Recipient_List[i] = pRecipientList[i];
+    NC_Recipient_Cache[object_index].Valid = false;
+    NC_Recipient_Index[object_index].Valid = false;
   } else {
     return false; /* unknown object */
   }
@@ -541,11 +604,9 @@ void Notification_Class_Set_Ack_Required(
 }
 
 
-static bool IsRecipientActive(
+static bool IsRecipientTransition(
     BACNET_DESTINATION *pBacDest, uint8_t EventToState)
 {
-    BACNET_DATE_TIME DateTime;
-
     /* valid Transitions */
     switch (EventToState) {
         case EVENT_STATE_OFFNORMAL:
@@ -573,26 +634,291 @@ static bool IsRecipientActive(
             return false; /* shouldn't happen */
     }
 
+    return true;
+}
+
+/**
+ * @brief Get the recipients of a notification class that are in their
+ *  valid days and times, finding them again only when the date changes,
+ *  when the time passes one of their FromTime or ToTime, or when the
+ *  Recipient_List changes.
+ * @param notify_index - index of the notification class
+ * @return bit mask of the active recipients, bit N for Recipient_List[N]
+ */
+static uint32_t Notification_Class_Recipients_Active(uint32_t notify_index)
+{
+    struct nc_recipient_cache *cache = &NC_Recipient_Cache[notify_index];
+    BACNET_DESTINATION *pBacDest;
+    BACNET_DATE_TIME DateTime;
+    unsigned index;
+
     /* get actual date and time */
     datetime_local(&DateTime.date, &DateTime.time, NULL, NULL);
+    if (cache->Valid &&
+        (datetime_compare_date(&cache->Date, &DateTime.date) == 0) &&
+        (datetime_compare_time(&DateTime.time, &cache->Next_From) < 0) &&
+        (datetime_compare_time(&DateTime.time, &cache->Next_To) <= 0)) {
+        return cache->Active;
+    }
+    cache->Active = 0;
+    /* later than any time of the day */
+    datetime_set_time(&cache->Next_From, 24, 0, 0, 0);
+    datetime_set_time(&cache->Next_To, 24, 0, 0, 0);
+    pBacDest = &NC_Info[notify_index].Recipient_List[0];
+    for (index = 0; index < NC_MAX_RECIPIENTS; index++, pBacDest++) {
+        if (bacnet_recipient_device_wildcard(&pBacDest->Recipient)) {
+            continue;
+        }
+        /* valid Days */
+        if (!(bitstring_bit(&pBacDest->ValidDays, (DateTime.date.wday - 1)))) {
+            continue;
+        }
+        /* valid FromTime */
+        if (datetime_compare_time(&DateTime.time, &pBacDest->FromTime) < 0) {
+            if (datetime_compare_time(
+                    &pBacDest->FromTime, &cache->Next_From) < 0) {
+                cache->Next_From = pBacDest->FromTime;
+            }
+            continue;
+        }
+        /* valid ToTime */
+        if (datetime_compare_time(&pBacDest->ToTime, &DateTime.time) < 0) {
+            continue;
+        }
+        if (datetime_compare_time(&pBacDest->ToTime, &cache->Next_To) < 0) {
+            cache->Next_To = pBacDest->ToTime;
+        }
+        cache->Active |= (1UL << index);
+    }
+    cache->Date = DateTime.date;
+    cache->Valid = true;
 
-    /* valid Days */
-    if (!(bitstring_bit(&pBacDest->ValidDays, (DateTime.date.wday - 1)))) {
-        return false;
+    return cache->Active;
+}
+
+/**
+ * @brief Send a notification to a recipient when the event is reported
+ * @param pBacDest - the recipient
+ * @param event_data - the event, with its processIdentifier
+ */
+static void Notification_Class_Event_Notify(
+    BACNET_DESTINATION *pBacDest, BACNET_EVENT_NOTIFICATION_DATA *event_data)
+{
+    BACNET_ADDRESS dest;
+    uint32_t device_id;
+    unsigned max_apdu;
+
+    /* send notification */
+    if (pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_DEVICE) {
+        /* send notification to the specified device */
+        device_id = pBacDest->Recipient.type.device.instance;
+        PRINTF("Notification Class[%u]: send notification to %u\n",
+            event_data->notificationClass, (unsigned)device_id);
+        if (pBacDest->ConfirmedNotify == true)
+            Send_CEvent_Notify(device_id, event_data);
+        else if (address_get_by_device(device_id, &max_apdu, &dest))
+            Send_UEvent_Notify(Event_Buffer, event_data, &dest);
+    } else if (pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_ADDRESS) {
+        PRINTF("Notification Class[%u]: send notification to ADDR\n",
+            event_data->notificationClass);
+        /* send notification to the address indicated */
+        if (pBacDest->ConfirmedNotify == true) {
+            if (address_get_device_id(&dest, &device_id))
+                Send_CEvent_Notify(device_id, event_data);
+        } else {
+            dest = pBacDest->Recipient.type.address;
+            Send_UEvent_Notify(Event_Buffer, event_data, &dest);
+        }
     }
-    /* valid FromTime */
-    if (datetime_compare_time(&DateTime.time, &pBacDest->FromTime) < 0) {
+}
+
+#if NC_EVENT_QUEUE_SIZE
+/**
+ * @brief Get an event in the queue
+ * @param index - 0 for the oldest event
+ * @return the queued event
+ */
+static struct nc_event_queue_entry *Notification_Class_Event_Queue_Entry(
+    unsigned index)
+{
+    return &NC_Event_Queue[(NC_Event_Queue_Head + index) % NC_EVENT_QUEUE_SIZE];
+}
+
+/**
+ * @brief Put an event into the queue, to be sent to its recipients
+ * @param notify_index - index of the notification class
+ * @param recipients - bit mask of the recipients to send the event to
+ * @param event_data - the event
+ * @return true if the event was queued, or false if the queue is full
+ *  or the event does not fit into a queue entry
+ */
+static bool Notification_Class_Event_Queue_Add(uint32_t notify_index,
+    uint32_t recipients,
+    BACNET_EVENT_NOTIFICATION_DATA *event_data)
+{
+    struct nc_event_queue_entry *entry;
+    int len, pid_len;
+
+    if (NC_Event_Queue_Count >= NC_EVENT_QUEUE_SIZE) {
         return false;
     }
-
-    /* valid ToTime */
-    if (datetime_compare_time(&pBacDest->ToTime, &DateTime.time) < 0) {
+    /* the processIdentifier of each recipient is encoded when sent */
+    event_data->processIdentifier = 0;
+    pid_len = encode_context_unsigned(NULL, 0, 0);
+    len = event_notify_encode_service_request(Event_Buffer, event_data);
+    if ((len <= pid_len) || ((len - pid_len) > NC_EVENT_QUEUE_APDU_SIZE)) {
         return false;
     }
+    entry = Notification_Class_Event_Queue_Entry(NC_Event_Queue_Count);
+    memcpy(entry->Service, &Event_Buffer[pid_len], len - pid_len);
+    entry->Service_Len = (uint16_t)(len - pid_len);
+    entry->NC_Index = (uint16_t)notify_index;
+    entry->Recipients = recipients;
+    NC_Event_Queue_Count++;
 
     return true;
 }
 
+/**
+ * @brief Send a queued event to a recipient
+ * @param pBacDest - the recipient
+ * @param entry - the queued event
+ * @return 1 if sent, 0 to try again later when a confirmed transaction
+ *  is free, or -1 if the event cannot be sent to the recipient
+ */
+static int Notification_Class_Event_Queue_Send(
+    BACNET_DESTINATION *pBacDest, struct nc_event_queue_entry *entry)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS my_address;
+    BACNET_NPDU_DATA npdu_data;
+    unsigned max_apdu = MAX_APDU;
+    uint8_t invoke_id = 0;
+    uint8_t *pdu = &Handler_Transmit_Buffer[0];
+    int pdu_len = 0;
+    int apdu_len = 0;
+    bool confirmed = pBacDest->ConfirmedNotify;
+
+    if (!dcc_communication_enabled()) {
+        return -1;
+    }
+    if (pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_DEVICE) {
+        if (!address_get_by_device(
+                pBacDest->Recipient.type.device.instance, &max_apdu, &dest)) {
+            return -1;
+        }
+    } else if (pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_ADDRESS) {
+        dest = pBacDest->Recipient.type.address;
+    } else {
+        return -1;
+    }
+    if (confirmed) {
+        invoke_id = tsm_next_free_invokeID();
+        if (!invoke_id) {
+            return 0;
+        }
+    }
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, confirmed, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(pdu, &dest, &my_address, &npdu_data);
+    if (confirmed) {
+        pdu[pdu_len] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        pdu[pdu_len + 1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        pdu[pdu_len + 2] = invoke_id;
+        pdu[pdu_len + 3] = SERVICE_CONFIRMED_EVENT_NOTIFICATION;
+        apdu_len = 4;
+    } else {
+        pdu[pdu_len] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        pdu[pdu_len + 1] = SERVICE_UNCONFIRMED_EVENT_NOTIFICATION;
+        apdu_len = 2;
+    }
+    apdu_len += encode_context_unsigned(
+        &pdu[pdu_len + apdu_len], 0, pBacDest->ProcessIdentifier);
+    if (((apdu_len + entry->Service_Len) > (int)max_apdu) ||
+        ((pdu_len + apdu_len + entry->Service_Len) > MAX_PDU)) {
+        if (invoke_id) {
+            tsm_free_invoke_id(invoke_id);
+        }
+        return -1;
+    }
+    memcpy(&pdu[pdu_len + apdu_len], entry->Service, entry->Service_Len);
+    pdu_len += apdu_len + entry->Service_Len;
+    if (confirmed) {
+        tsm_set_confirmed_unsegmented_transaction(
+            invoke_id, &dest, &npdu_data, pdu, (uint16_t)pdu_len);
+    }
+    datalink_send_pdu(&dest, &npdu_data, pdu, pdu_len);
+
+    return 1;
+}
+
+/**
+ * @brief Send the queued events to their recipients, at most
+ *  NC_EVENT_QUEUE_SEND_MAX notifications each call, and at most one to
+ *  each recipient, in the order in which the events were reported.
+ *  Call it often, such as with the TSM timer, so that a flood of alarms
+ *  is paced.
+ */
+void Notification_Class_Event_Queue_Task(void)
+{
+    uint32_t pending[NC_EVENT_QUEUE_SIZE];
+    struct nc_event_queue_entry *entry;
+    NOTIFICATION_CLASS_INFO *notification;
+    uint32_t blocked, bit;
+    unsigned sent = 0;
+    unsigned i, j, index;
+    int status;
+
+    for (i = 0; i < NC_Event_Queue_Count; i++) {
+        pending[i] = Notification_Class_Event_Queue_Entry(i)->Recipients;
+    }
+    for (i = 0; (i < NC_Event_Queue_Count) && (sent < NC_EVENT_QUEUE_SEND_MAX);
+         i++) {
+        entry = Notification_Class_Event_Queue_Entry(i);
+        /* recipients that have older events are sent those first */
+        blocked = 0;
+        for (j = 0; j < i; j++) {
+            if (Notification_Class_Event_Queue_Entry(j)->NC_Index ==
+                entry->NC_Index) {
+                blocked |= pending[j];
+            }
+        }
+        notification = &NC_Info[entry->NC_Index];
+        for (index = 0;
+             (index < NC_MAX_RECIPIENTS) && (sent < NC_EVENT_QUEUE_SEND_MAX);
+             index++) {
+            bit = 1UL << index;
+            if (!(entry->Recipients & bit) || (blocked & bit)) {
+                continue;
+            }
+            status = Notification_Class_Event_Queue_Send(
+                &notification->Recipient_List[index], entry);
+            if (status != 0) {
+                entry->Recipients &= ~bit;
+            }
+            if (status > 0) {
+                sent++;
+            }
+        }
+    }
+    while ((NC_Event_Queue_Count > 0) &&
+        (Notification_Class_Event_Queue_Entry(0)->Recipients == 0)) {
+        NC_Event_Queue_Head = (NC_Event_Queue_Head + 1) % NC_EVENT_QUEUE_SIZE;
+        NC_Event_Queue_Count--;
+    }
+}
+
+/**
+ * @brief Get the number of events in the queue that have not been sent
+ *  to all of their recipients
+ * @return number of queued events
+ */
+unsigned Notification_Class_Event_Queue_Count(void)
+{
+    return NC_Event_Queue_Count;
+}
+#endif
+
 void Notification_Class_common_reporting_function(
     BACNET_EVENT_NOTIFICATION_DATA *event_data)
 {
@@ -601,6 +927,8 @@ void Notification_Class_common_reporting_function(
     NOTIFICATION_CLASS_INFO *CurrentNotify;
     BACNET_DESTINATION *pBacDest;
     uint32_t notify_index;
+    uint32_t active;
+    uint32_t recipients = 0;
     uint8_t index;
 
     notify_index =
@@ -650,50 +978,51 @@ void Notification_Class_common_reporting_function(
             break;
     }
 
+    if (NC_Event_Callback) {
+        NC_Event_Callback(event_data);
+    }
     /* send notifications for active recipients */
     PRINTF("Notification Class[%u]: send notifications\n",
         event_data->notificationClass);
+    active = Notification_Class_Recipients_Active(notify_index);
     /* pointer to first recipient */
     pBacDest = &CurrentNotify->Recipient_List[0];
     for (index = 0; index < NC_MAX_RECIPIENTS; index++, pBacDest++) {
-        if (bacnet_recipient_device_wildcard(&pBacDest->Recipient)) {
+        if (!(active & (1UL << index))) {
             continue;
         }
-        if (IsRecipientActive(pBacDest, event_data->toState)) {
-            BACNET_ADDRESS dest;
-            uint32_t device_id;
-            unsigned max_apdu;
-
+        if (IsRecipientTransition(pBacDest, event_data->toState)) {
+            recipients |= (1UL << index);
+        }
+    }
+#if NC_EVENT_QUEUE_SIZE
+    if (!recipients ||
+        Notification_Class_Event_Queue_Add(
+            notify_index, recipients, event_data)) {
+        return;
+    }
+#endif
+    pBacDest = &CurrentNotify->Recipient_List[0];
+    for (index = 0; index < NC_MAX_RECIPIENTS; index++, pBacDest++) {
+        if (recipients & (1UL << index)) {
             /* Process Identifier */
             event_data->processIdentifier = pBacDest->ProcessIdentifier;
-
-            /* send notification */
-            if (pBacDest->Recipient.tag == BACNET_RECIPIENT_TAG_DEVICE) {
-                /* send notification to the specified device */
-                device_id = pBacDest->Recipient.type.device.instance;
-                PRINTF("Notification Class[%u]: send notification to %u\n",
-                    event_data->notificationClass, (unsigned)device_id);
-                if (pBacDest->ConfirmedNotify == true)
-                    Send_CEvent_Notify(device_id, event_data);
-                else if (address_get_by_device(device_id, &max_apdu, &dest))
-                    Send_UEvent_Notify(Event_Buffer, event_data, &dest);
-            } else if (pBacDest->Recipient.tag ==
-                BACNET_RECIPIENT_TAG_ADDRESS) {
-                PRINTF("Notification Class[%u]: send notification to ADDR\n",
-                    event_data->notificationClass);
-                /* send notification to the address indicated */
-                if (pBacDest->ConfirmedNotify == true) {
-                    if (address_get_device_id(&dest, &device_id))
-                        Send_CEvent_Notify(device_id, event_data);
-                } else {
-                    dest = pBacDest->Recipient.type.address;
-                    Send_UEvent_Notify(Event_Buffer, event_data, &dest);
-                }
-            }
+            Notification_Class_Event_Notify(pBacDest, event_data);
         }
     }
 }
 
+/**
+ * @brief Set the function that is called with each event notification,
+ *  before it is sent to the recipients
+ * @param callback - function, or NULL for none
+ */
+void Notification_Class_Event_Callback_Set(
+    notification_class_event_callback callback)
+{
+    NC_Event_Callback = callback;
+}
+
 /* This function tries to find the addresses of the defined devices. */
 /* It should be called periodically (example once per minute). */
 void Notification_Class_find_recipient(void)
@@ -723,6 +1052,178 @@ void Notification_Class_find_recipient(void)
     }
 }
 
+/**
+ * @brief Hash a recipient with the fields that bacnet_recipient_same()
+ *  compares, using FNV-1a
+ * @param recipient - BACnetRecipient
+ * @return the hash
+ */
+static uint32_t Notification_Class_Recipient_Hash(
+    const BACNET_RECIPIENT *recipient)
+{
+    const BACNET_ADDRESS *address;
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
+
+#define NC_HASH_OCTET(octet) hash = (hash ^ (uint8_t)(octet)) * 16777619UL
+    NC_HASH_OCTET(recipient->tag);
+    if (recipient->tag == BACNET_RECIPIENT_TAG_DEVICE) {
+        NC_HASH_OCTET(recipient->type.device.type);
+        NC_HASH_OCTET(recipient->type.device.instance);
+        NC_HASH_OCTET(recipient->type.device.instance >> 8);
+        NC_HASH_OCTET(recipient->type.device.instance >> 16);
+    } else if (recipient->tag == BACNET_RECIPIENT_TAG_ADDRESS) {
+        address = &recipient->type.address;
+        for (i = 0; (i < address->mac_len) && (i < MAX_MAC_LEN); i++) {
+            NC_HASH_OCTET(address->mac[i]);
+        }
+        NC_HASH_OCTET(address->net);
+        NC_HASH_OCTET(address->net >> 8);
+        if (address->net) {
+            for (i = 0; (i < address->len) && (i < MAX_MAC_LEN); i++) {
+                NC_HASH_OCTET(address->adr[i]);
+            }
+        }
+    }
+#undef NC_HASH_OCTET
+
+    return hash;
+}
+
+/**
+ * @brief Add a recipient of the Recipient_List to the hash table
+ * @param notify_index - index of the Notification Class
+ * @param slot - index of the recipient in the Recipient_List
+ */
+static void
+Notification_Class_Recipient_Index_Add(uint32_t notify_index, unsigned slot)
+{
+    struct nc_recipient_index *table = &NC_Recipient_Index[notify_index];
+    unsigned bucket;
+
+    bucket = Notification_Class_Recipient_Hash(
+                 &NC_Info[notify_index].Recipient_List[slot].Recipient) &
+        (NC_RECIPIENT_BUCKETS - 1);
+    while (table->Bucket[bucket]) {
+        bucket = (bucket + 1) & (NC_RECIPIENT_BUCKETS - 1);
+    }
+    table->Bucket[bucket] = (uint8_t)(slot + 1);
+    table->Count++;
+}
+
+/**
+ * @brief Build the hash table of the recipients of a Notification Class
+ *  when the Recipient_List was changed
+ * @param notify_index - index of the Notification Class
+ */
+static void Notification_Class_Recipient_Index_Build(uint32_t notify_index)
+{
+    struct nc_recipient_index *table = &NC_Recipient_Index[notify_index];
+    unsigned slot;
+
+    if (table->Valid) {
+        return;
+    }
+    memset(table, 0, sizeof(*table));
+    for (slot = 0; slot < NC_MAX_RECIPIENTS; slot++) {
+        if (!bacnet_recipient_device_wildcard(
+                &NC_Info[notify_index].Recipient_List[slot].Recipient)) {
+            Notification_Class_Recipient_Index_Add(notify_index, slot);
+        }
+    }
+    table->Valid = true;
+}
+
+/**
+ * @brief Find the bucket of a recipient in the hash table
+ * @param notify_index - index of the Notification Class
+ * @param recipient - BACnetRecipient to find
+ * @return the bucket, or NC_RECIPIENT_BUCKETS if it is not found
+ */
+static unsigned Notification_Class_Recipient_Bucket(
+    uint32_t notify_index, BACNET_RECIPIENT *recipient)
+{
+    const struct nc_recipient_index *table = &NC_Recipient_Index[notify_index];
+    BACNET_DESTINATION *destination;
+    unsigned bucket;
+
+    Notification_Class_Recipient_Index_Build(notify_index);
+    bucket = Notification_Class_Recipient_Hash(recipient) &
+        (NC_RECIPIENT_BUCKETS - 1);
+    while (table->Bucket[bucket]) {
+        destination =
+            &NC_Info[notify_index].Recipient_List[table->Bucket[bucket] - 1];
+        if (bacnet_recipient_same(recipient, &destination->Recipient)) {
+            return bucket;
+        }
+        bucket = (bucket + 1) & (NC_RECIPIENT_BUCKETS - 1);
+    }
+
+    return NC_RECIPIENT_BUCKETS;
+}
+
+/**
+ * @brief Find a recipient in the Recipient_List
+ * @param notify_index - index of the Notification Class
+ * @param recipient - BACnetRecipient to find
+ * @return the recipient, or NULL if it is not in the Recipient_List
+ */
+static BACNET_DESTINATION *Notification_Class_Recipient_Find(
+    uint32_t notify_index, BACNET_RECIPIENT *recipient)
+{
+    unsigned bucket, slot;
+
+    bucket = Notification_Class_Recipient_Bucket(notify_index, recipient);
+    if (bucket >= NC_RECIPIENT_BUCKETS) {
+        return NULL;
+    }
+    slot = NC_Recipient_Index[notify_index].Bucket[bucket] - 1;
+
+    return &NC_Info[notify_index].Recipient_List[slot];
+}
+
+/**
+ * @brief Remove a recipient from the Recipient_List and the hash table.
+ *  The buckets after it are moved back, so that the probes of the other
+ *  recipients still find them.
+ * @param notify_index - index of the Notification Class
+ * @param recipient - BACnetRecipient to remove
+ * @return true if the recipient was removed
+ */
+static bool Notification_Class_Recipient_Remove(
+    uint32_t notify_index, BACNET_RECIPIENT *recipient)
+{
+    struct nc_recipient_index *table = &NC_Recipient_Index[notify_index];
+    BACNET_DESTINATION *destination;
+    unsigned bucket, next, home;
+
+    bucket = Notification_Class_Recipient_Bucket(notify_index, recipient);
+    if (bucket >= NC_RECIPIENT_BUCKETS) {
+        return false;
+    }
+    bacnet_destination_default_init(
+        &NC_Info[notify_index].Recipient_List[table->Bucket[bucket] - 1]);
+    table->Bucket[bucket] = 0;
+    table->Count--;
+    next = (bucket + 1) & (NC_RECIPIENT_BUCKETS - 1);
+    while (table->Bucket[next]) {
+        destination =
+            &NC_Info[notify_index].Recipient_List[table->Bucket[next] - 1];
+        home = Notification_Class_Recipient_Hash(&destination->Recipient) &
+            (NC_RECIPIENT_BUCKETS - 1);
+        /* move it back unless its home is after the empty bucket */
+        if (((next - home) & (NC_RECIPIENT_BUCKETS - 1)) >=
+            ((next - bucket) & (NC_RECIPIENT_BUCKETS - 1))) {
+            table->Bucket[bucket] = table->Bucket[next];
+            table->Bucket[next] = 0;
+            bucket = next;
+        }
+        next = (next + 1) & (NC_RECIPIENT_BUCKETS - 1);
+    }
+
+    return true;
+}
+
 /**
  * @brief AddListElement from an object list property
  * @ingroup ObjHelpers
@@ -768,15 +1269,13 @@ void Notification_Class_find_recipient(void)
 int Notification_Class_Add_List_Element(BACNET_LIST_ELEMENT_DATA *list_element)
 {
     NOTIFICATION_CLASS_INFO *notification = NULL;
-    BACNET_DESTINATION recipient_list[NC_MAX_RECIPIENTS] = { 0 };
+    BACNET_DESTINATION recipient = { 0 };
+    BACNET_DESTINATION *destination = NULL;
     uint8_t *application_data = NULL;
     int application_data_len = 0, len = 0;
     uint32_t notify_index = 0;
-    unsigned index = 0;
-    unsigned element_count = 0, new_element_count = 0;
-    unsigned added_element_count = 0, same_element_count = 0;
-    bool same_element = false;
-    unsigned i = 0, j = 0;
+    unsigned element_count = 0, added_element_count = 0;
+    unsigned slot = 0;
 
     if (!list_element) {
         return BACNET_STATUS_ABORT;
@@ -800,100 +1299,67 @@ int Notification_Class_Add_List_Element(BACNET_LIST_ELEMENT_DATA *list_element)
         list_element->error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return BACNET_STATUS_ERROR;
     }
-    /* get the current size of all entry of Recipient_List */
-    for (index = 0; index < NC_MAX_RECIPIENTS; index++) {
-        BACNET_DESTINATION *d1;
-        BACNET_RECIPIENT *r1;
-        d1 = &notification->Recipient_List[index];
-        r1 = &d1->Recipient;
-        if (!bacnet_recipient_device_wildcard(r1)) {
-            element_count++;
-        }
-    }
-    /* decode the elements */
-    new_element_count = 0;
+    Notification_Class_Recipient_Index_Build(notify_index);
+    /* decode the elements, and determine the added recipient count */
     application_data = list_element->application_data;
     application_data_len = list_element->application_data_len;
     while (application_data_len > 0) {
         len = bacnet_destination_decode(
-            application_data, application_data_len, &recipient_list[index]);
-        if (len > 0) {
-            new_element_count++;
-            application_data_len -= len;
-        } else {
-            list_element->first_failed_element_number = new_element_count;
+            application_data, application_data_len, &recipient);
+        if (len <= 0) {
+            list_element->first_failed_element_number = 1 + element_count;
             list_element->error_class = ERROR_CLASS_PROPERTY;
             list_element->error_code = ERROR_CODE_INVALID_DATA_ENCODING;
             return BACNET_STATUS_ERROR;
         }
-    }
-    if (new_element_count == 0) {
-        return BACNET_STATUS_OK;
-    }
-    /* determine the same and added recipient counts */
-    same_element_count = 0;
-    added_element_count = 0;
-    for (i = 0; i < new_element_count; i++) {
-        BACNET_DESTINATION *d1;
-        BACNET_RECIPIENT *r1;
-        d1 = &recipient_list[i];
-        r1 = &d1->Recipient;
-        same_element = false;
-        for (j = 0; j < NC_MAX_RECIPIENTS; j++) {
-            BACNET_DESTINATION *d2;
-            BACNET_RECIPIENT *r2;
-            d2 = &notification->Recipient_List[j];
-            r2 = &d2->Recipient;
-            if (bacnet_recipient_same(r1, r2)) {
-                same_element = true;
-                break;
-            }
+        element_count++;
+        application_data += len;
+        application_data_len -= len;
+        if (bacnet_recipient_device_wildcard(&recipient.Recipient) ||
+            Notification_Class_Recipient_Find(
+                notify_index, &recipient.Recipient)) {
+            continue;
         }
-        if (same_element) {
-            same_element_count++;
-        } else {
-            added_element_count++;
-            if ((added_element_count + element_count) > NC_MAX_RECIPIENTS) {
-                list_element->first_failed_element_number = 1 + i;
-                list_element->error_class = ERROR_CLASS_RESOURCES;
-                list_element->error_code =
-                    ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
-                return BACNET_STATUS_ERROR;
-            }
+        added_element_count++;
+        if ((added_element_count + NC_Recipient_Index[notify_index].Count) >
+            NC_MAX_RECIPIENTS) {
+            list_element->first_failed_element_number = element_count;
+            list_element->error_class = ERROR_CLASS_RESOURCES;
+            list_element->error_code = ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
+            return BACNET_STATUS_ERROR;
         }
     }
+    if (element_count == 0) {
+        return BACNET_STATUS_OK;
+    }
     /* update existing and add new */
-    for (i = 0; i < new_element_count; i++) {
-        BACNET_DESTINATION *d1;
-        BACNET_RECIPIENT *r1;
-        d1 = &recipient_list[i];
-        r1 = &d1->Recipient;
-        same_element = false;
-        for (j = 0; j < NC_MAX_RECIPIENTS; j++) {
-            BACNET_DESTINATION *d2;
-            BACNET_RECIPIENT *r2;
-            d2 = &notification->Recipient_List[j];
-            r2 = &d2->Recipient;
-            if (bacnet_recipient_same(r1, r2)) {
-                /* update existing element */
-                same_element = true;
-                bacnet_destination_copy(d2, d1);
-            }
+    application_data = list_element->application_data;
+    application_data_len = list_element->application_data_len;
+    while (application_data_len > 0) {
+        len = bacnet_destination_decode(
+            application_data, application_data_len, &recipient);
+        application_data += len;
+        application_data_len -= len;
+        if (bacnet_recipient_device_wildcard(&recipient.Recipient)) {
+            continue;
         }
-        if (!same_element) {
-            /* add new element to next free slot */
-            for (j = 0; j < NC_MAX_RECIPIENTS; j++) {
-                BACNET_DESTINATION *d2;
-                BACNET_RECIPIENT *r2;
-                d2 = &notification->Recipient_List[j];
-                r2 = &d2->Recipient;
-                if (!bacnet_recipient_device_wildcard(r2)) {
-                    bacnet_destination_copy(d2, d1);
-                    break;
-                }
-            }
+        destination = Notification_Class_Recipient_Find(
+            notify_index, &recipient.Recipient);
+        if (destination) {
+            /* update existing element */
+            bacnet_destination_copy(destination, &recipient);
+            continue;
+        }
+        /* add new element to next free slot */
+        while (!bacnet_recipient_device_wildcard(
+            &notification->Recipient_List[slot].Recipient)) {
+            slot++;
         }
+        bacnet_destination_copy(
+            &notification->Recipient_List[slot], &recipient);
+        Notification_Class_Recipient_Index_Add(notify_index, slot);
     }
+    NC_Recipient_Cache[notify_index].Valid = false;
 
     return BACNET_STATUS_OK;
 }
@@ -924,16 +1390,11 @@ int Notification_Class_Add_List_Element(BACNET_LIST_ELEMENT_DATA *list_element)
 int Notification_Class_Remove_List_Element(
     BACNET_LIST_ELEMENT_DATA *list_element)
 {
-    NOTIFICATION_CLASS_INFO *notification = NULL;
+    BACNET_DESTINATION recipient = { 0 };
     uint32_t notify_index = 0;
-    unsigned index = 0;
-    BACNET_DESTINATION recipient_list[NC_MAX_RECIPIENTS] = { 0 };
     uint8_t *application_data = NULL;
     int application_data_len = 0, len = 0;
     unsigned element_count = 0;
-    unsigned remove_element_count = 0;
-    bool same_element = false;
-    unsigned i = 0, j = 0;
 
     if (!list_element) {
         return BACNET_STATUS_ABORT;
@@ -950,78 +1411,52 @@ int Notification_Class_Remove_List_Element(
     }
     notify_index =
         Notification_Class_Instance_To_Index(list_element->object_instance);
-    if (notify_index < MAX_NOTIFICATION_CLASSES) {
-        notification = &NC_Info[notify_index];
-    } else {
+    if (notify_index >= MAX_NOTIFICATION_CLASSES) {
         list_element->error_class = ERROR_CLASS_OBJECT;
         list_element->error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return BACNET_STATUS_ERROR;
     }
-    /* get the current size of all entry of Recipient_List */
-    for (index = 0; index < NC_MAX_RECIPIENTS; index++) {
-        BACNET_DESTINATION *d1;
-        BACNET_RECIPIENT *r1;
-        d1 = &notification->Recipient_List[index];
-        r1 = &d1->Recipient;
-        if (!bacnet_recipient_device_wildcard(r1)) {
-            element_count++;
-        }
-    }
-    /* decode the elements */
+    /* decode the elements, and determine if one or more does not exist */
     application_data = list_element->application_data;
     application_data_len = list_element->application_data_len;
     while (application_data_len > 0) {
         len = bacnet_destination_decode(
-            application_data, application_data_len, &recipient_list[index]);
-        if (len > 0) {
-            remove_element_count++;
-            application_data_len -= len;
-        } else {
-            list_element->first_failed_element_number = remove_element_count;
+            application_data, application_data_len, &recipient);
+        if (len <= 0) {
+            list_element->first_failed_element_number = 1 + element_count;
             list_element->error_class = ERROR_CLASS_PROPERTY;
             list_element->error_code = ERROR_CODE_INVALID_DATA_ENCODING;
             return BACNET_STATUS_ERROR;
         }
-    }
-    /* determine if one or more of the elements does not exist */
-    for (i = 0; i < remove_element_count; i++) {
-        BACNET_DESTINATION *d1;
-        BACNET_RECIPIENT *r1;
-        d1 = &recipient_list[i];
-        r1 = &d1->Recipient;
-        same_element = false;
-        for (j = 0; j < NC_MAX_RECIPIENTS; j++) {
-            BACNET_DESTINATION *d2;
-            BACNET_RECIPIENT *r2;
-            d2 = &notification->Recipient_List[j];
-            r2 = &d2->Recipient;
-            if (bacnet_recipient_same(r1, r2)) {
-                same_element = true;
-            }
-        }
-        if (!same_element) {
-            list_element->first_failed_element_number = 1 + i;
+        element_count++;
+        application_data += len;
+        application_data_len -= len;
+        if (!bacnet_recipient_device_wildcard(&recipient.Recipient) &&
+            !Notification_Class_Recipient_Find(
+                notify_index, &recipient.Recipient)) {
+            list_element->first_failed_element_number = element_count;
             list_element->error_class = ERROR_CLASS_SERVICES;
             list_element->error_code = ERROR_CODE_LIST_ELEMENT_NOT_FOUND;
             return BACNET_STATUS_ERROR;
         }
     }
-    /* remove any matching elements */
-    for (i = 0; i < remove_element_count; i++) {
-        BACNET_DESTINATION *d1;
-        BACNET_RECIPIENT *r1;
-        d1 = &recipient_list[i];
-        r1 = &d1->Recipient;
-        for (j = 0; j < NC_MAX_RECIPIENTS; j++) {
-            BACNET_DESTINATION *d2;
-            BACNET_RECIPIENT *r2;
-            d2 = &notification->Recipient_List[j];
-            r2 = &d2->Recipient;
-            if (bacnet_recipient_same(r1, r2)) {
-                bacnet_destination_default_init(d2);
-            }
+    /* remove the matching elements */
+    application_data = list_element->application_data;
+    application_data_len = list_element->application_data_len;
+    while (application_data_len > 0) {
+        len = bacnet_destination_decode(
+            application_data, application_data_len, &recipient);
+        application_data += len;
+        application_data_len -= len;
+        if (bacnet_recipient_device_wildcard(&recipient.Recipient)) {
+            continue;
+        }
+        /* a Recipient_List that was written may hold it more than once */
+        while (Notification_Class_Recipient_Remove(
+            notify_index, &recipient.Recipient)) {
         }
     }
+    NC_Recipient_Cache[notify_index].Valid = false;
 
     return BACNET_STATUS_OK;
 }
@@ -22,8 +22,26 @@ extern "C" {
 
 #define NC_RESCAN_RECIPIENTS_SECS 60
 
-/* max "length" of recipient_list */
+/* max "length" of recipient_list, at most 32 */
+#ifndef NC_MAX_RECIPIENTS
 #define NC_MAX_RECIPIENTS 10
+#endif
+
+/* number of events that are queued and sent to their recipients a few
+   at a time by Notification_Class_Event_Queue_Task(), or zero to send
+   each notification when the event is reported */
+#ifndef NC_EVENT_QUEUE_SIZE
+#define NC_EVENT_QUEUE_SIZE 0
+#endif
+/* size of an encoded event in the queue.  Larger events, and events
+   reported while the queue is full, are sent when they are reported. */
+#ifndef NC_EVENT_QUEUE_APDU_SIZE
+#define NC_EVENT_QUEUE_APDU_SIZE 256
+#endif
+/* number of notifications sent by each call of the task */
+#ifndef NC_EVENT_QUEUE_SEND_MAX
+#define NC_EVENT_QUEUE_SEND_MAX 4
+#endif
 
 #if defined(INTRINSIC_REPORTING)
 
@@ -42,6 +60,11 @@ typedef struct Acked_info {
     BACNET_DATE_TIME Time_Stamp; /* time stamp of when a alarm was generated */
 } ACKED_INFO;
 
+/* Called with each event notification of the Notification Class objects,
+   whether or not it has recipients, such as to record it in an Event Log */
+typedef void (*notification_class_event_callback)(
+    BACNET_EVENT_NOTIFICATION_DATA *event_data);
+
 /* Information needed to send AckNotification */
 typedef struct Ack_Notification {
     bool bSendAckNotify; /* true if need to send AckNotification */
@@ -109,6 +132,20 @@ void Notification_Class_common_reporting_function(
 
 BACNET_STACK_EXPORT
 void Notification_Class_find_recipient(void);
+
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Callback_Set(
+    notification_class_event_callback callback);
+
+#if NC_EVENT_QUEUE_SIZE
+BACNET_STACK_EXPORT
+void Notification_Class_Event_Queue_Task(void);
+BACNET_STACK_EXPORT
+unsigned Notification_Class_Event_Queue_Count(void);
+#else
+#define Notification_Class_Event_Queue_Task() ((void)0)
+#define Notification_Class_Event_Queue_Count() (0U)
+#endif
 #endif /* defined(INTRINSIC_REPORTING) */
 
 #ifdef __cplusplus
@@ -21,6 +21,7 @@
 #include "bacnet/npdu.h"
 #include "bacnet/apdu.h"
 #include "bacnet/datalink/datalink.h"
+#include "bacnet/datalink/dlstats.h"
 #include "bacnet/basic/binding/address.h"
 #include "bacnet/basic/object/device.h"
 /* me */
@@ -112,6 +113,10 @@ struct object_data {
 #define BACNET_NETWORK_PORTS_MAX 1
 #endif
 static struct object_data Object_List[BACNET_NETWORK_PORTS_MAX];
+/* the property membership of each port type, built when first used */
+#define NETWORK_PORT_PROPERTY_BITMAPS 4
+static struct property_list_bitmap_t
+    Property_Bitmap[NETWORK_PORT_PROPERTY_BITMAPS];
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Network_Port_Properties_Required[] = {
@@ -183,7 +188,20 @@ static const int BIP6_Port_Properties_Optional[] = {
     -1
 };
 
-static const int Network_Port_Properties_Proprietary[] = { -1 };
+static const int Network_Port_Properties_Proprietary[] = {
+#if BACNET_DATALINK_STATS && BACNET_DATALINK_STATS_PROPERTIES
+    PROP_DATALINK_STATS_RX_PACKETS,
+    PROP_DATALINK_STATS_RX_OCTETS,
+    PROP_DATALINK_STATS_TX_PACKETS,
+    PROP_DATALINK_STATS_TX_OCTETS,
+    PROP_DATALINK_STATS_RX_DROPPED,
+    PROP_DATALINK_STATS_TX_DROPPED,
+    PROP_DATALINK_STATS_CRC_ERRORS,
+    PROP_DATALINK_STATS_OVERSIZE_FRAMES,
+    PROP_DATALINK_STATS_BVLC_NAKS,
+#endif
+    -1
+};
 
 /**
  * Returns the list of required, optional, and proprietary properties.
@@ -261,22 +279,32 @@ void Network_Port_Property_Lists(
  */
 static bool Property_List_Member(uint32_t object_instance, int object_property)
 {
-    bool found = false;
     const int *pRequired = NULL;
     const int *pOptional = NULL;
     const int *pProprietary = NULL;
+    struct property_list_bitmap_t *bitmap;
+    unsigned i;
 
     Network_Port_Property_List(
         object_instance, &pRequired, &pOptional, &pProprietary);
-    found = property_list_member(pRequired, object_property);
-    if (!found) {
-        found = property_list_member(pOptional, object_property);
+    if (!pOptional) {
+        return false;
     }
-    if (!found) {
-        found = property_list_member(pProprietary, object_property);
+    for (i = 0; i < NETWORK_PORT_PROPERTY_BITMAPS; i++) {
+        bitmap = &Property_Bitmap[i];
+        if (!bitmap->pOptional) {
+            property_list_bitmap_init(
+                bitmap, pRequired, pOptional, pProprietary);
+        }
+        if ((bitmap->pRequired == pRequired) &&
+            (bitmap->pOptional == pOptional) &&
+            (bitmap->pProprietary == pProprietary)) {
+            return property_list_bitmap_member(bitmap, object_property);
+        }
     }
 
-    return found;
+    return property_lists_member(
+        pRequired, pOptional, pProprietary, object_property);
 }
 
 /**
@@ -3011,9 +3039,6 @@ int Network_Port_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     BACNET_IP6_ADDRESS ip6_address;
 #endif
     uint8_t *apdu = NULL;
-    const int *pRequired = NULL;
-    const int *pOptional = NULL;
-    const int *pProprietary = NULL;
 
     uint8_t network_type = PORT_TYPE_NON_BACNET;
     unsigned int index = 0;
@@ -3032,11 +3057,8 @@ int Network_Port_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
         network_type = Object_List[index].Network_Type;
     }
 
-    Network_Port_Property_List(
-        rpdata->object_instance, &pRequired, &pOptional, &pProprietary);
-    if ((!property_list_member(pRequired, rpdata->object_property)) &&
-        (!property_list_member(pOptional, rpdata->object_property)) &&
-        (!property_list_member(pProprietary, rpdata->object_property))) {
+    if (!Property_List_Member(
+            rpdata->object_instance, rpdata->object_property)) {
         rpdata->error_class = ERROR_CLASS_PROPERTY;
         rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
         return BACNET_STATUS_ERROR;
@@ -3340,6 +3362,14 @@ int Network_Port_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 encode_application_character_string(&apdu[0], &char_string);
             break;
         default:
+#if BACNET_DATALINK_STATS && BACNET_DATALINK_STATS_PROPERTIES
+            if (datalink_stats_property(rpdata->object_property)) {
+                apdu_len = datalink_stats_property_encode(
+                    (BACNET_PORT_TYPE)network_type, rpdata->object_property,
+                    &apdu[0]);
+                break;
+            }
+#endif
             rpdata->error_class = ERROR_CLASS_PROPERTY;
             rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
             apdu_len = BACNET_STATUS_ERROR;
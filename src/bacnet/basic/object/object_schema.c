@@ -0,0 +1,484 @@
+/**
+ * @file
+ * @brief The property schema of an object type: ReadProperty,
+ *  WriteProperty and the typed values of the properties that are stored
+ *  in the object data, from a table that declares them.
+ *
+ * The object type keeps the cases of its ReadProperty and WriteProperty
+ * handlers for the properties that are computed, such as the
+ * Object_Name and the Status_Flags, or that have side effects when
+ * written, such as a commanded Present_Value, and hands any other
+ * property to the schema.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/object/object_schema.h"
+
+/**
+ * @brief Find a property in a schema
+ * @param schema [in] the schema of an object type
+ * @param property [in] property identifier
+ * @return the property, or NULL if it is not in the schema
+ */
+const BACNET_OBJECT_SCHEMA_PROPERTY *object_schema_property(
+    const BACNET_OBJECT_SCHEMA *schema, BACNET_PROPERTY_ID property)
+{
+    unsigned low = 0;
+    unsigned high;
+    unsigned middle;
+
+    if (!schema || !schema->property) {
+        return NULL;
+    }
+    high = schema->count;
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (schema->property[middle].property == property) {
+            return &schema->property[middle];
+        }
+        if (schema->property[middle].property < property) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check that the size of each member fits its application tag
+ * @param tag [in] application tag of the property
+ * @param size [in] octets of the member
+ * @return true if the member can store the property
+ */
+static bool object_schema_size_valid(uint8_t tag, uint8_t size)
+{
+    switch (tag) {
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            return (size == sizeof(bool));
+        case BACNET_APPLICATION_TAG_REAL:
+            return (size == sizeof(float));
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            return (size == sizeof(double));
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            return (size == 1) || (size == 2) || (size == 4) || (size == 8);
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Check a schema, such as in a unit test of an object type: the
+ *  properties are sorted by property identifier and each member can
+ *  store its property.
+ * @param schema [in] the schema of an object type
+ * @return true if the schema is valid
+ */
+bool object_schema_valid(const BACNET_OBJECT_SCHEMA *schema)
+{
+    unsigned i;
+
+    if (!schema || (!schema->property && (schema->count > 0))) {
+        return false;
+    }
+    for (i = 0; i < schema->count; i++) {
+        if ((i > 0) &&
+            (schema->property[i - 1].property >=
+                schema->property[i].property)) {
+            return false;
+        }
+        if (!object_schema_size_valid(
+                schema->property[i].tag, schema->property[i].size)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Load an unsigned integer member of any width
+ * @param member [in] the member
+ * @param size [in] octets of the member
+ * @return the value of the member
+ */
+static uint64_t object_schema_unsigned(const uint8_t *member, uint8_t size)
+{
+    uint8_t value8;
+    uint16_t value16;
+    uint32_t value32;
+    uint64_t value64 = 0;
+
+    switch (size) {
+        case 1:
+            memcpy(&value8, member, sizeof(value8));
+            value64 = value8;
+            break;
+        case 2:
+            memcpy(&value16, member, sizeof(value16));
+            value64 = value16;
+            break;
+        case 4:
+            memcpy(&value32, member, sizeof(value32));
+            value64 = value32;
+            break;
+        case 8:
+            memcpy(&value64, member, sizeof(value64));
+            break;
+        default:
+            break;
+    }
+
+    return value64;
+}
+
+/**
+ * @brief Store an unsigned integer member of any width
+ * @param member [out] the member
+ * @param size [in] octets of the member
+ * @param value [in] the value, which must fit the member
+ * @return true if the value was stored
+ */
+static bool
+object_schema_unsigned_set(uint8_t *member, uint8_t size, uint64_t value)
+{
+    uint8_t value8;
+    uint16_t value16;
+    uint32_t value32;
+
+    switch (size) {
+        case 1:
+            if (value > UINT8_MAX) {
+                return false;
+            }
+            value8 = (uint8_t)value;
+            memcpy(member, &value8, sizeof(value8));
+            break;
+        case 2:
+            if (value > UINT16_MAX) {
+                return false;
+            }
+            value16 = (uint16_t)value;
+            memcpy(member, &value16, sizeof(value16));
+            break;
+        case 4:
+            if (value > UINT32_MAX) {
+                return false;
+            }
+            value32 = (uint32_t)value;
+            memcpy(member, &value32, sizeof(value32));
+            break;
+        case 8:
+            memcpy(member, &value, sizeof(value));
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Load a signed integer member of any width
+ * @param member [in] the member
+ * @param size [in] octets of the member
+ * @return the value of the member
+ */
+static int64_t object_schema_signed(const uint8_t *member, uint8_t size)
+{
+    int8_t value8;
+    int16_t value16;
+    int32_t value32;
+    int64_t value64 = 0;
+
+    switch (size) {
+        case 1:
+            memcpy(&value8, member, sizeof(value8));
+            value64 = value8;
+            break;
+        case 2:
+            memcpy(&value16, member, sizeof(value16));
+            value64 = value16;
+            break;
+        case 4:
+            memcpy(&value32, member, sizeof(value32));
+            value64 = value32;
+            break;
+        case 8:
+            memcpy(&value64, member, sizeof(value64));
+            break;
+        default:
+            break;
+    }
+
+    return value64;
+}
+
+/**
+ * @brief Store a signed integer member of any width
+ * @param member [out] the member
+ * @param size [in] octets of the member
+ * @param value [in] the value, which must fit the member
+ * @return true if the value was stored
+ */
+static bool
+object_schema_signed_set(uint8_t *member, uint8_t size, int64_t value)
+{
+    int8_t value8;
+    int16_t value16;
+    int32_t value32;
+
+    switch (size) {
+        case 1:
+            if ((value < INT8_MIN) || (value > INT8_MAX)) {
+                return false;
+            }
+            value8 = (int8_t)value;
+            memcpy(member, &value8, sizeof(value8));
+            break;
+        case 2:
+            if ((value < INT16_MIN) || (value > INT16_MAX)) {
+                return false;
+            }
+            value16 = (int16_t)value;
+            memcpy(member, &value16, sizeof(value16));
+            break;
+        case 4:
+            if ((value < INT32_MIN) || (value > INT32_MAX)) {
+                return false;
+            }
+            value32 = (int32_t)value;
+            memcpy(member, &value32, sizeof(value32));
+            break;
+        case 8:
+            memcpy(member, &value, sizeof(value));
+            break;
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the value of a property that is stored in the object data
+ * @param schema [in] the schema of the object type
+ * @param object [in] the object data
+ * @param property [in] property identifier
+ * @param value [out] the value of the property
+ * @return true if the property is in the schema
+ */
+bool object_schema_value(const BACNET_OBJECT_SCHEMA *schema,
+    const void *object,
+    BACNET_PROPERTY_ID property,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    const BACNET_OBJECT_SCHEMA_PROPERTY *pProperty;
+    const uint8_t *member;
+
+    pProperty = object_schema_property(schema, property);
+    if (!pProperty || !object || !value) {
+        return false;
+    }
+    member = (const uint8_t *)object + pProperty->offset;
+    value->tag = pProperty->tag;
+    value->context_specific = false;
+    value->next = NULL;
+    switch (pProperty->tag) {
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            memcpy(&value->type.Boolean, member, sizeof(bool));
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            value->type.Unsigned_Int = (BACNET_UNSIGNED_INTEGER)
+                object_schema_unsigned(member, pProperty->size);
+            break;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            value->type.Signed_Int =
+                (int32_t)object_schema_signed(member, pProperty->size);
+            break;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            memcpy(&value->type.Real, member, sizeof(float));
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            memcpy(&value->type.Double, member, sizeof(double));
+            break;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            value->type.Enumerated =
+                (uint32_t)object_schema_unsigned(member, pProperty->size);
+            break;
+#endif
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set the value of a property that is stored in the object data,
+ *  whether or not it is writable with WriteProperty
+ * @param schema [in] the schema of the object type
+ * @param object [in] the object data
+ * @param property [in] property identifier
+ * @param value [in] the value of the property
+ * @return true if the property is in the schema, and the value has its
+ *  type and fits its member
+ */
+bool object_schema_value_set(const BACNET_OBJECT_SCHEMA *schema,
+    void *object,
+    BACNET_PROPERTY_ID property,
+    const BACNET_APPLICATION_DATA_VALUE *value)
+{
+    const BACNET_OBJECT_SCHEMA_PROPERTY *pProperty;
+    uint8_t *member;
+
+    pProperty = object_schema_property(schema, property);
+    if (!pProperty || !object || !value || (value->tag != pProperty->tag)) {
+        return false;
+    }
+    member = (uint8_t *)object + pProperty->offset;
+    switch (pProperty->tag) {
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            memcpy(member, &value->type.Boolean, sizeof(bool));
+            break;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            return object_schema_unsigned_set(
+                member, pProperty->size, value->type.Unsigned_Int);
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            return object_schema_signed_set(
+                member, pProperty->size, value->type.Signed_Int);
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            memcpy(member, &value->type.Real, sizeof(float));
+            break;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            memcpy(member, &value->type.Double, sizeof(double));
+            break;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            return object_schema_unsigned_set(
+                member, pProperty->size, value->type.Enumerated);
+#endif
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief ReadProperty of a property that is stored in the object data
+ * @param schema [in] the schema of the object type
+ * @param object [in] the object data
+ * @param rpdata [in,out] ReadProperty data structure
+ * @return number of APDU bytes encoded, or BACNET_STATUS_ERROR or
+ *  BACNET_STATUS_ABORT with the error code set
+ */
+int object_schema_read_property(const BACNET_OBJECT_SCHEMA *schema,
+    const void *object,
+    BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int apdu_len;
+
+    if (!object_schema_value(
+            schema, object, rpdata->object_property, &value)) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+        return BACNET_STATUS_ERROR;
+    }
+    if (rpdata->array_index != BACNET_ARRAY_ALL) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len = bacapp_encode_application_data(NULL, &value);
+    if (apdu_len > rpdata->application_data_len) {
+        rpdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+        return BACNET_STATUS_ABORT;
+    }
+
+    return bacapp_encode_application_data(rpdata->application_data, &value);
+}
+
+/**
+ * @brief WriteProperty of a property that is stored in the object data
+ * @param schema [in] the schema of the object type
+ * @param object [in] the object data
+ * @param wp_data [in,out] WriteProperty data structure
+ * @param value [in] the value decoded from the WriteProperty data
+ * @return true if the property was written, else false with the error
+ *  class and code set
+ */
+bool object_schema_write_property(const BACNET_OBJECT_SCHEMA *schema,
+    void *object,
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    const BACNET_APPLICATION_DATA_VALUE *value)
+{
+    const BACNET_OBJECT_SCHEMA_PROPERTY *pProperty;
+
+    pProperty = object_schema_property(schema, wp_data->object_property);
+    if (!pProperty) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+        return false;
+    }
+    if (!(pProperty->flags & OBJECT_SCHEMA_WRITABLE)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    }
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return false;
+    }
+    if (value->tag != pProperty->tag) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return false;
+    }
+    if (!object_schema_value_set(
+            schema, object, wp_data->object_property, value)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return false;
+    }
+
+    return true;
+}
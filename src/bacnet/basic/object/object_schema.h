@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @brief API for the property schema of an object type, a table that
+ *  declares which properties are stored in the object data and how, so
+ *  that ReadProperty, WriteProperty and the typed values of those
+ *  properties are handled by common code rather than by a case of each
+ *  property in each object type.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_OBJECT_SCHEMA_H
+#define BACNET_BASIC_OBJECT_OBJECT_SCHEMA_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+
+/* the property is writable with WriteProperty */
+#define OBJECT_SCHEMA_WRITABLE 0x01
+
+/**
+ * A property that is stored in a member of the object data.  The
+ * member has the C type of the application tag: bool for BOOLEAN,
+ * float for REAL, double for DOUBLE, and an unsigned or signed integer
+ * of any width for UNSIGNED_INT, ENUMERATED and SIGNED_INT.
+ */
+typedef struct bacnet_object_schema_property {
+    BACNET_PROPERTY_ID property;
+    uint8_t tag;
+    uint8_t flags;
+    uint8_t size;
+    uint16_t offset;
+} BACNET_OBJECT_SCHEMA_PROPERTY;
+
+/**
+ * The schema of an object type, with its properties sorted by property
+ * identifier.
+ */
+typedef struct bacnet_object_schema {
+    const BACNET_OBJECT_SCHEMA_PROPERTY *property;
+    unsigned count;
+} BACNET_OBJECT_SCHEMA;
+
+/**
+ * Declare a property of a schema
+ * @param property - property identifier
+ * @param tag - application tag of the property
+ * @param type - type of the object data
+ * @param member - member of the object data that stores the property
+ * @param flags - OBJECT_SCHEMA_WRITABLE or 0
+ */
+#define OBJECT_SCHEMA_PROPERTY(property, tag, type, member, flags)   \
+    {                                                                \
+        (property), (tag), (flags), sizeof(((type *)0)->member),     \
+            offsetof(type, member)                                   \
+    }
+
+/**
+ * Declare a schema from an array of its properties
+ * @param properties - array of BACNET_OBJECT_SCHEMA_PROPERTY
+ */
+#define OBJECT_SCHEMA(properties) \
+    { (properties), sizeof(properties) / sizeof((properties)[0]) }
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+const BACNET_OBJECT_SCHEMA_PROPERTY *object_schema_property(
+    const BACNET_OBJECT_SCHEMA *schema, BACNET_PROPERTY_ID property);
+BACNET_STACK_EXPORT
+bool object_schema_valid(const BACNET_OBJECT_SCHEMA *schema);
+
+BACNET_STACK_EXPORT
+bool object_schema_value(const BACNET_OBJECT_SCHEMA *schema,
+    const void *object,
+    BACNET_PROPERTY_ID property,
+    BACNET_APPLICATION_DATA_VALUE *value);
+BACNET_STACK_EXPORT
+bool object_schema_value_set(const BACNET_OBJECT_SCHEMA *schema,
+    void *object,
+    BACNET_PROPERTY_ID property,
+    const BACNET_APPLICATION_DATA_VALUE *value);
+
+BACNET_STACK_EXPORT
+int object_schema_read_property(const BACNET_OBJECT_SCHEMA *schema,
+    const void *object,
+    BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool object_schema_write_property(const BACNET_OBJECT_SCHEMA *schema,
+    void *object,
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    const BACNET_APPLICATION_DATA_VALUE *value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/static_pool.h"
 #include "bacnet/basic/object/objects.h"
 
 /* list of devices */
@@ -58,7 +59,7 @@ OBJECT_DEVICE_T *objects_device_new(uint32_t device_instance)
         if (pDevice) {
             memset(pDevice, 0, sizeof(OBJECT_DEVICE_T));
         } else {
-            pDevice = calloc(1, sizeof(OBJECT_DEVICE_T));
+            pDevice = bacnet_calloc(1, sizeof(OBJECT_DEVICE_T));
             if (pDevice) {
                 pDevice->Object_Identifier.type = OBJECT_DEVICE;
                 pDevice->Object_Identifier.instance = device_instance;
@@ -88,12 +89,12 @@ bool objects_device_delete(int index)
                         Keylist_Data_Delete_By_Index(pDevice->Object_List, 0);
                     /* free any dynamic memory used */
                     if (pObject) {
-                        free(pObject);
+                        bacnet_free(pObject);
                     }
                 } while (pObject);
                 Keylist_Delete(pDevice->Object_List);
             }
-            free(pDevice);
+            bacnet_free(pDevice);
             result = true;
         }
     }
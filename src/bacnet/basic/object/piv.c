@@ -16,6 +16,7 @@
 #include "bacnet/bacapp.h"
 #include "bacnet/bactext.h"
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/object_schema.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/object/piv.h"
 
@@ -37,6 +38,21 @@ static const int PositiveInteger_Value_Properties_Optional[] = {
 
 static const int PositiveInteger_Value_Properties_Proprietary[] = { -1 };
 
+/* the properties that are stored in the object data, sorted by property */
+static const BACNET_OBJECT_SCHEMA_PROPERTY
+    PositiveInteger_Value_Properties[] = {
+    OBJECT_SCHEMA_PROPERTY(PROP_OUT_OF_SERVICE, BACNET_APPLICATION_TAG_BOOLEAN,
+        POSITIVEINTEGER_VALUE_DESCR, Out_Of_Service, OBJECT_SCHEMA_WRITABLE),
+    OBJECT_SCHEMA_PROPERTY(PROP_PRESENT_VALUE,
+        BACNET_APPLICATION_TAG_UNSIGNED_INT, POSITIVEINTEGER_VALUE_DESCR,
+        Present_Value, 0),
+    OBJECT_SCHEMA_PROPERTY(PROP_UNITS, BACNET_APPLICATION_TAG_ENUMERATED,
+        POSITIVEINTEGER_VALUE_DESCR, Units, 0),
+};
+
+static const BACNET_OBJECT_SCHEMA PositiveInteger_Value_Schema =
+    OBJECT_SCHEMA(PositiveInteger_Value_Properties);
+
 void PositiveInteger_Value_Property_Lists(
     const int **pRequired, const int **pOptional, const int **pProprietary)
 {
@@ -165,7 +181,6 @@ int PositiveInteger_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     BACNET_BIT_STRING bit_string;
     BACNET_CHARACTER_STRING char_string;
     unsigned object_index = 0;
-    bool state = false;
     uint8_t *apdu = NULL;
     POSITIVEINTEGER_VALUE_DESCR *CurrentAV;
 
@@ -202,11 +217,6 @@ int PositiveInteger_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 &apdu[0], OBJECT_POSITIVE_INTEGER_VALUE);
             break;
 
-        case PROP_PRESENT_VALUE:
-            apdu_len = encode_application_unsigned(&apdu[0],
-                PositiveInteger_Value_Present_Value(rpdata->object_instance));
-            break;
-
         case PROP_STATUS_FLAGS:
             bitstring_init(&bit_string);
             bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
@@ -217,28 +227,9 @@ int PositiveInteger_Value_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
 
             apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
             break;
-
-        case PROP_UNITS:
-            apdu_len =
-                encode_application_enumerated(&apdu[0], CurrentAV->Units);
-            break;
-            /* 	BACnet Testing Observed Incident oi00109
-                    Positive Integer Value / Units returned wrong datatype -
-               missing break. Revealed by BACnet Test Client v1.8.16 (
-               www.bac-test.com/bacnet-test-client-download ) BITS: BIT00031 BC
-               135.1: 9.20.1.7 BC 135.1: 9.20.1.9 Any discussions can be
-               directed to edward@bac-test.com Please feel free to remove this
-               comment when my changes have been reviewed by all interested
-               parties. Say 6 months -> September 2016 */
-
-        case PROP_OUT_OF_SERVICE:
-            state = CurrentAV->Out_Of_Service;
-            apdu_len = encode_application_boolean(&apdu[0], state);
-            break;
         default:
-            rpdata->error_class = ERROR_CLASS_PROPERTY;
-            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
-            apdu_len = BACNET_STATUS_ERROR;
+            apdu_len = object_schema_read_property(
+                &PositiveInteger_Value_Schema, CurrentAV, rpdata);
             break;
     }
     /*  only array properties can have array options */
@@ -313,31 +304,77 @@ bool PositiveInteger_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             }
             break;
 
-        case PROP_OUT_OF_SERVICE:
-            status = write_property_type_valid(
-                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
-            if (status) {
-                CurrentAV->Out_Of_Service = value.type.Boolean;
-            }
-            break;
-
         case PROP_OBJECT_IDENTIFIER:
         case PROP_OBJECT_NAME:
         case PROP_OBJECT_TYPE:
         case PROP_STATUS_FLAGS:
-        case PROP_UNITS:
             wp_data->error_class = ERROR_CLASS_PROPERTY;
             wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
             break;
         default:
-            wp_data->error_class = ERROR_CLASS_PROPERTY;
-            wp_data->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            status = object_schema_write_property(
+                &PositiveInteger_Value_Schema, CurrentAV, wp_data, &value);
             break;
     }
 
     return status;
 }
 
+/**
+ * @brief Get the value of a property of a Positive Integer Value object
+ *  without encoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @return true if the value was copied, or false if the property is
+ *  read with ReadProperty instead
+ */
+bool PositiveInteger_Value_Property_Value(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    unsigned object_index;
+
+    object_index = PositiveInteger_Value_Instance_To_Index(object_instance);
+    if ((object_index >= MAX_POSITIVEINTEGER_VALUES) ||
+        (array_index != BACNET_ARRAY_ALL)) {
+        return false;
+    }
+
+    return object_schema_value(&PositiveInteger_Value_Schema,
+        &PIV_Descr[object_index], object_property, value);
+}
+
+/**
+ * @brief Set the value of a property of a Positive Integer Value object
+ *  without decoding it, for the consumers in this device
+ * @param object_instance - object-instance number of the object
+ * @param object_property - property identifier
+ * @param array_index - array index, or BACNET_ARRAY_ALL
+ * @param value - the value of the property
+ * @param priority - BACnet priority 1..16
+ * @return true if the value was set, or false if the property is
+ *  written with WriteProperty instead, which gives the error
+ */
+bool PositiveInteger_Value_Property_Value_Set(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    const BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    if (!value || (object_property != PROP_PRESENT_VALUE) ||
+        (array_index != BACNET_ARRAY_ALL) ||
+        (value->tag != BACNET_APPLICATION_TAG_UNSIGNED_INT) ||
+        (value->type.Unsigned_Int > UINT32_MAX)) {
+        return false;
+    }
+
+    return PositiveInteger_Value_Present_Value_Set(
+        object_instance, (uint32_t)value->type.Unsigned_Int, priority);
+}
+
 void PositiveInteger_Value_Intrinsic_Reporting(uint32_t object_instance)
 {
     (void)object_instance;
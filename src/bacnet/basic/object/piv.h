@@ -21,7 +21,7 @@ extern "C" {
 #endif /* __cplusplus */
 
     typedef struct positiveinteger_value_descr {
-        bool Out_Of_Service:1;
+        bool Out_Of_Service;
         uint32_t Present_Value;
         uint16_t Units;
     } POSITIVEINTEGER_VALUE_DESCR;
@@ -50,6 +50,19 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool PositiveInteger_Value_Write_Property(BACNET_WRITE_PROPERTY_DATA *
         wp_data);
+    BACNET_STACK_EXPORT
+    bool PositiveInteger_Value_Property_Value(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        BACNET_APPLICATION_DATA_VALUE *value);
+    BACNET_STACK_EXPORT
+    bool PositiveInteger_Value_Property_Value_Set(
+        uint32_t object_instance,
+        BACNET_PROPERTY_ID object_property,
+        BACNET_ARRAY_INDEX array_index,
+        const BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority);
 
     BACNET_STACK_EXPORT
     bool PositiveInteger_Value_Present_Value_Set(uint32_t object_instance,
@@ -7,6 +7,8 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -24,6 +26,33 @@
 
 static SCHEDULE_DESCR Schedule_Descr[MAX_SCHEDULES];
 
+/* The schedules are kept in a binary heap ordered by the time of their
+   next transition, in seconds since the epoch, so that Schedule_Evaluate()
+   only looks at the schedules whose Present_Value may change. */
+static bacnet_time_t Schedule_Next_Transition[MAX_SCHEDULES];
+/* the heap of schedule indexes, and the position of each in the heap */
+static unsigned Schedule_Queue[MAX_SCHEDULES];
+static unsigned Schedule_Queue_Position[MAX_SCHEDULES];
+/* the time of the last evaluation, to notice a clock set backwards */
+static bacnet_time_t Schedule_Last_Evaluation;
+
+/* the writes of the Present_Value of a schedule to its referenced
+   properties of one device, which are outstanding */
+typedef struct schedule_write_request {
+    bool Active;
+    unsigned Index;
+    uint32_t Device_Instance;
+    unsigned Count;
+    uint8_t Reference[BACNET_SCHEDULE_OBJ_PROP_REF_SIZE];
+} SCHEDULE_WRITE_REQUEST;
+static SCHEDULE_WRITE_REQUEST
+    Schedule_Write_Request[SCHEDULE_WRITE_REQUESTS_MAX];
+static schedule_write_multiple_callback Schedule_Write_Multiple_Callback;
+/* the writes of a transition start after a random delay up to this */
+static uint32_t Schedule_Write_Jitter;
+/* the schedule whose writes are requested first, so each has a turn */
+static unsigned Schedule_Write_Next;
+
 static const int Schedule_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_PRESENT_VALUE,
     PROP_EFFECTIVE_PERIOD, PROP_SCHEDULE_DEFAULT,
@@ -56,25 +85,91 @@ void Schedule_Init(void)
 
     for (i = 0; i < MAX_SCHEDULES; i++, psched++) {
         /* whole year, change as necessary */
-        psched->Start_Date.year = 0xFF;
+        datetime_wildcard_year_set(&psched->Start_Date);
         psched->Start_Date.month = 1;
         psched->Start_Date.day = 1;
         psched->Start_Date.wday = 0xFF;
-        psched->End_Date.year = 0xFF;
+        datetime_wildcard_year_set(&psched->End_Date);
         psched->End_Date.month = 12;
         psched->End_Date.day = 31;
         psched->End_Date.wday = 0xFF;
-        for (j = 0; j < 7; j++) {
-            psched->Weekly_Schedule[j].TV_Count = 0;
-        }
-        memcpy(&psched->Present_Value, &psched->Schedule_Default,
-            sizeof(psched->Present_Value));
+        bacnet_weeklyschedule_list_init(&psched->Weekly_Schedule,
+            psched->Time_Values, BACNET_SCHEDULE_TIME_VALUES_SIZE);
         psched->Schedule_Default.context_specific = false;
         psched->Schedule_Default.tag = BACNET_APPLICATION_TAG_REAL;
         psched->Schedule_Default.type.Real = 21.0f; /* 21 C, room temperature */
+        memcpy(&psched->Present_Value, &psched->Schedule_Default,
+            sizeof(psched->Present_Value));
         psched->obj_prop_ref_cnt = 0; /* no references, add as needed */
+        for (j = 0; j < BACNET_SCHEDULE_OBJ_PROP_REF_SIZE; j++) {
+            psched->Write_Pending[j] = false;
+            psched->Write_Sent[j] = false;
+        }
+        psched->Write_Delay = 0;
         psched->Priority_For_Writing = 16; /* lowest priority */
         psched->Out_Of_Service = false;
+        /* evaluate each schedule at the first Schedule_Evaluate() */
+        Schedule_Next_Transition[i] = 0;
+        Schedule_Queue[i] = i;
+        Schedule_Queue_Position[i] = i;
+    }
+    Schedule_Last_Evaluation = 0;
+    for (i = 0; i < SCHEDULE_WRITE_REQUESTS_MAX; i++) {
+        Schedule_Write_Request[i].Active = false;
+    }
+    Schedule_Write_Next = 0;
+}
+
+/**
+ * @brief Swap two entries of the heap of schedules
+ * @param a - position in the heap
+ * @param b - position in the heap
+ */
+static void schedule_queue_swap(unsigned a, unsigned b)
+{
+    unsigned index = Schedule_Queue[a];
+
+    Schedule_Queue[a] = Schedule_Queue[b];
+    Schedule_Queue[b] = index;
+    Schedule_Queue_Position[Schedule_Queue[a]] = a;
+    Schedule_Queue_Position[Schedule_Queue[b]] = b;
+}
+
+/**
+ * @brief Move a schedule to its place in the heap after the time of its
+ *  next transition was changed
+ * @param index - schedule index
+ */
+static void schedule_queue_update(unsigned index)
+{
+    unsigned position = Schedule_Queue_Position[index];
+    unsigned parent, child;
+
+    while (position > 0) {
+        parent = (position - 1) / 2;
+        if (Schedule_Next_Transition[Schedule_Queue[parent]] <=
+            Schedule_Next_Transition[index]) {
+            break;
+        }
+        schedule_queue_swap(position, parent);
+        position = parent;
+    }
+    for (;;) {
+        child = (2 * position) + 1;
+        if (child >= MAX_SCHEDULES) {
+            break;
+        }
+        if (((child + 1) < MAX_SCHEDULES) &&
+            (Schedule_Next_Transition[Schedule_Queue[child + 1]] <
+                Schedule_Next_Transition[Schedule_Queue[child]])) {
+            child++;
+        }
+        if (Schedule_Next_Transition[Schedule_Queue[child]] >=
+            Schedule_Next_Transition[index]) {
+            break;
+        }
+        schedule_queue_swap(position, child);
+        position = child;
     }
 }
 
@@ -139,7 +234,426 @@ void Schedule_Out_Of_Service_Set(uint32_t object_instance, bool value)
     index = Schedule_Instance_To_Index(object_instance);
     if (index < MAX_SCHEDULES) {
         Schedule_Descr[index].Out_Of_Service = value;
+        Schedule_Recalculate_Request(object_instance);
+    }
+}
+
+/**
+ * @brief Set the daily schedule of one day of the Weekly_Schedule
+ * @param object_instance - object-instance number of the object
+ * @param wday - day of the week, 1=Monday..7=Sunday
+ * @param day - the time values of the day
+ * @return true if the daily schedule was set, or false if it does not
+ *  fit with the time values of the other days
+ */
+bool Schedule_Weekly_Schedule_Set(uint32_t object_instance,
+    BACNET_WEEKDAY wday,
+    const BACNET_OBJ_DAILY_SCHEDULE *day)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+
+    if ((index >= MAX_SCHEDULES) || !day || (wday < BACNET_WEEKDAY_MONDAY) ||
+        (wday > BACNET_WEEKDAY_SUNDAY) ||
+        (day->TV_Count > BACNET_WEEKLY_SCHEDULE_SIZE)) {
+        return false;
+    }
+    if (!bacnet_weeklyschedule_list_day_set(
+            &Schedule_Descr[index].Weekly_Schedule, wday - 1,
+            day->Time_Values, day->TV_Count)) {
+        return false;
+    }
+    Schedule_Recalculate_Request(object_instance);
+
+    return true;
+}
+
+/**
+ * @brief Set the Effective_Period of the schedule
+ * @param object_instance - object-instance number of the object
+ * @param start_date - first date of the period
+ * @param end_date - last date of the period
+ * @return true if the period was set
+ */
+bool Schedule_Effective_Period_Set(
+    uint32_t object_instance, BACNET_DATE *start_date, BACNET_DATE *end_date)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+
+    if ((index >= MAX_SCHEDULES) || !start_date || !end_date) {
+        return false;
+    }
+    datetime_copy_date(&Schedule_Descr[index].Start_Date, start_date);
+    datetime_copy_date(&Schedule_Descr[index].End_Date, end_date);
+    Schedule_Recalculate_Request(object_instance);
+
+    return true;
+}
+
+/**
+ * @brief Set the Schedule_Default of the schedule
+ * @param object_instance - object-instance number of the object
+ * @param value - the default value
+ * @return true if the value was set
+ */
+bool Schedule_Default_Set(
+    uint32_t object_instance, BACNET_APPLICATION_DATA_VALUE *value)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+
+    if ((index >= MAX_SCHEDULES) || !value) {
+        return false;
+    }
+    memcpy(&Schedule_Descr[index].Schedule_Default, value,
+        sizeof(BACNET_APPLICATION_DATA_VALUE));
+    Schedule_Recalculate_Request(object_instance);
+
+    return true;
+}
+
+/**
+ * @brief Get the Present_Value of the schedule
+ * @param object_instance - object-instance number of the object
+ * @param value - the Present_Value is copied here
+ * @return true if the object exists
+ */
+bool Schedule_Present_Value(
+    uint32_t object_instance, BACNET_APPLICATION_DATA_VALUE *value)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+
+    if ((index >= MAX_SCHEDULES) || !value) {
+        return false;
     }
+    memcpy(value, &Schedule_Descr[index].Present_Value,
+        sizeof(BACNET_APPLICATION_DATA_VALUE));
+
+    return true;
+}
+
+/**
+ * @brief Add a property to the List_Of_Object_Property_References, to
+ *  which the Present_Value is written when it changes
+ * @param object_instance - object-instance number of the object
+ * @param reference - the referenced property
+ * @return true if the reference was added
+ */
+bool Schedule_Object_Property_Reference_Add(uint32_t object_instance,
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+    SCHEDULE_DESCR *desc;
+
+    if ((index >= MAX_SCHEDULES) || !reference) {
+        return false;
+    }
+    desc = &Schedule_Descr[index];
+    if (desc->obj_prop_ref_cnt >= BACNET_SCHEDULE_OBJ_PROP_REF_SIZE) {
+        return false;
+    }
+    memcpy(&desc->Object_Property_References[desc->obj_prop_ref_cnt],
+        reference, sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE));
+    desc->Write_Pending[desc->obj_prop_ref_cnt] = false;
+    desc->Write_Sent[desc->obj_prop_ref_cnt] = false;
+    desc->obj_prop_ref_cnt++;
+
+    return true;
+}
+
+/**
+ * @brief Get the device of a referenced property
+ * @param reference - the referenced property
+ * @return the device instance, or BACNET_MAX_INSTANCE + 1 for a
+ *  reference without a device identifier, which is in this device
+ */
+static uint32_t schedule_reference_device(
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference)
+{
+    if ((reference->deviceIdentifier.type != OBJECT_DEVICE) ||
+        (reference->deviceIdentifier.instance > BACNET_MAX_INSTANCE)) {
+        return BACNET_MAX_INSTANCE + 1;
+    }
+
+    return reference->deviceIdentifier.instance;
+}
+
+/**
+ * @brief Find the outstanding writes of a schedule to a device
+ * @param index - schedule index
+ * @param device_instance - the device
+ * @return the write request, or NULL if none
+ */
+static SCHEDULE_WRITE_REQUEST *schedule_write_request_find(
+    unsigned index, uint32_t device_instance)
+{
+    unsigned i;
+
+    for (i = 0; i < SCHEDULE_WRITE_REQUESTS_MAX; i++) {
+        if (Schedule_Write_Request[i].Active &&
+            (Schedule_Write_Request[i].Index == index) &&
+            (Schedule_Write_Request[i].Device_Instance == device_instance)) {
+            return &Schedule_Write_Request[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find a write request that is not outstanding
+ * @return the write request, or NULL if all are outstanding
+ */
+static SCHEDULE_WRITE_REQUEST *schedule_write_request_free(void)
+{
+    unsigned i;
+
+    for (i = 0; i < SCHEDULE_WRITE_REQUESTS_MAX; i++) {
+        if (!Schedule_Write_Request[i].Active) {
+            return &Schedule_Write_Request[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Write the new Present_Value of a schedule to all of its
+ *  referenced properties, after the jitter delay
+ * @param index - schedule index
+ */
+static void schedule_write_start(unsigned index)
+{
+    SCHEDULE_DESCR *desc = &Schedule_Descr[index];
+    unsigned i;
+
+    if (!Schedule_Write_Multiple_Callback) {
+        return;
+    }
+    for (i = 0; i < desc->obj_prop_ref_cnt; i++) {
+        desc->Write_Pending[i] = true;
+    }
+    desc->Write_Delay = 0;
+    if (Schedule_Write_Jitter > 0) {
+        desc->Write_Delay = (uint32_t)rand() % Schedule_Write_Jitter;
+    }
+}
+
+/**
+ * @brief Request the writes of the pending references of a schedule to
+ *  one device
+ * @param index - schedule index
+ * @param device_instance - the device
+ * @param request - the write request to use
+ * @return true if the request was sent
+ */
+static bool schedule_write_send(unsigned index,
+    uint32_t device_instance,
+    SCHEDULE_WRITE_REQUEST *request)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE
+        *references[BACNET_SCHEDULE_OBJ_PROP_REF_SIZE];
+    SCHEDULE_DESCR *desc = &Schedule_Descr[index];
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference;
+    unsigned i;
+
+    request->Count = 0;
+    for (i = 0; i < desc->obj_prop_ref_cnt; i++) {
+        reference = &desc->Object_Property_References[i];
+        if (desc->Write_Pending[i] && !desc->Write_Sent[i] &&
+            (schedule_reference_device(reference) == device_instance)) {
+            references[request->Count] = reference;
+            request->Reference[request->Count] = (uint8_t)i;
+            request->Count++;
+            desc->Write_Pending[i] = false;
+            desc->Write_Sent[i] = true;
+        }
+    }
+    /* outstanding before the callback, which may report the result */
+    request->Active = true;
+    request->Index = index;
+    request->Device_Instance = device_instance;
+    if (Schedule_Write_Multiple_Callback(Schedule_Index_To_Instance(index),
+            device_instance, references, request->Count,
+            &desc->Present_Value, desc->Priority_For_Writing)) {
+        return true;
+    }
+    for (i = 0; i < request->Count; i++) {
+        desc->Write_Pending[request->Reference[i]] = true;
+        desc->Write_Sent[request->Reference[i]] = false;
+    }
+    request->Active = false;
+
+    return false;
+}
+
+/**
+ * @brief Request the pending writes of the schedules whose delay has
+ *  passed, grouped by device, while there are free write requests.
+ *  The schedules take turns, so that one busy schedule does not hold
+ *  up the others.
+ */
+static void schedule_write_dispatch(void)
+{
+    SCHEDULE_WRITE_REQUEST *request = NULL;
+    SCHEDULE_DESCR *desc = NULL;
+    uint32_t device_instance;
+    unsigned n, index, i;
+
+    if (!Schedule_Write_Multiple_Callback) {
+        return;
+    }
+    for (n = 0; n < MAX_SCHEDULES; n++) {
+        index = (Schedule_Write_Next + n) % MAX_SCHEDULES;
+        desc = &Schedule_Descr[index];
+        if (desc->Write_Delay > 0) {
+            continue;
+        }
+        for (i = 0; i < desc->obj_prop_ref_cnt; i++) {
+            if (!desc->Write_Pending[i] || desc->Write_Sent[i]) {
+                continue;
+            }
+            device_instance =
+                schedule_reference_device(&desc->Object_Property_References[i]);
+            if (schedule_write_request_find(index, device_instance)) {
+                continue;
+            }
+            request = schedule_write_request_free();
+            if (!request) {
+                /* this schedule goes first the next time */
+                Schedule_Write_Next = index;
+                return;
+            }
+            if (!schedule_write_send(index, device_instance, request)) {
+                /* deferred, and tried again at the next timer */
+                break;
+            }
+        }
+    }
+    if (MAX_SCHEDULES > 0) {
+        Schedule_Write_Next = (Schedule_Write_Next + 1) % MAX_SCHEDULES;
+    }
+}
+
+/**
+ * @brief Set the callback that writes the Present_Value to the
+ *  referenced properties of one device
+ * @param cb - callback used to write the referenced properties
+ */
+void Schedule_Write_Multiple_Callback_Set(schedule_write_multiple_callback cb)
+{
+    Schedule_Write_Multiple_Callback = cb;
+}
+
+/**
+ * @brief Set the largest random delay of the writes of a transition, so
+ *  that the writes of the schedules that change at the same time, such
+ *  as at the top of the hour, are spread out
+ * @param milliseconds - the largest delay, or 0 to write at once
+ */
+void Schedule_Write_Jitter_Set(uint32_t milliseconds)
+{
+    Schedule_Write_Jitter = milliseconds;
+}
+
+/**
+ * @brief Report the outcome of the writes of a schedule to a device.
+ *  The writes stop at the first failure, so the references after it are
+ *  written again with the next request; the failed one is written at
+ *  the next change of the Present_Value.
+ * @param object_instance - object-instance number of the object
+ * @param device_instance - the device that was written
+ * @param successful - number of references that were written, in order,
+ *  before the first failure
+ * @return true if the writes to the device were outstanding
+ */
+bool Schedule_Write_Multiple_Result(
+    uint32_t object_instance, uint32_t device_instance, unsigned successful)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+    SCHEDULE_WRITE_REQUEST *request;
+    SCHEDULE_DESCR *desc;
+    unsigned i;
+
+    if (index >= MAX_SCHEDULES) {
+        return false;
+    }
+    request = schedule_write_request_find(index, device_instance);
+    if (!request) {
+        return false;
+    }
+    desc = &Schedule_Descr[index];
+    for (i = 0; i < request->Count; i++) {
+        desc->Write_Sent[request->Reference[i]] = false;
+        if (i > successful) {
+            desc->Write_Pending[request->Reference[i]] = true;
+        }
+    }
+    request->Active = false;
+
+    return true;
+}
+
+/**
+ * @brief Count down the jitter delay of the writes of the object, and
+ *  request the pending writes of the schedules
+ * @param object_instance - object-instance number of the object
+ * @param milliseconds - number of milliseconds elapsed since previously
+ *  called.  Suggest that this is called every 1000 milliseconds or less.
+ */
+void Schedule_Timer(uint32_t object_instance, uint16_t milliseconds)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+    SCHEDULE_DESCR *desc;
+
+    if (index >= MAX_SCHEDULES) {
+        return;
+    }
+    desc = &Schedule_Descr[index];
+    if (desc->Write_Delay > milliseconds) {
+        desc->Write_Delay -= milliseconds;
+    } else {
+        desc->Write_Delay = 0;
+    }
+    schedule_write_dispatch();
+}
+
+/**
+ * @brief Evaluate the schedule at the next Schedule_Evaluate(), after
+ *  a change to its Weekly_Schedule, Effective_Period, Schedule_Default,
+ *  or anything else that its Present_Value depends on
+ * @param object_instance - object-instance number of the object
+ */
+void Schedule_Recalculate_Request(uint32_t object_instance)
+{
+    unsigned index = Schedule_Instance_To_Index(object_instance);
+
+    if (index < MAX_SCHEDULES) {
+        Schedule_Next_Transition[index] = 0;
+        schedule_queue_update(index);
+    }
+}
+
+/**
+ * @brief Encode one day of the Weekly_Schedule
+ * @param object_instance - object-instance number of the object
+ * @param index - the array index of the day, 0=Monday..6=Sunday
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @return the number of apdu bytes encoded
+ */
+static int Schedule_Weekly_Schedule_Encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu)
+{
+    unsigned object_index = Schedule_Instance_To_Index(object_instance);
+    int len = 0;
+
+    if (object_index < MAX_SCHEDULES) {
+        len = bacnet_weeklyschedule_list_day_encode(
+            apdu, &Schedule_Descr[object_index].Weekly_Schedule, index);
+        if (len < 0) {
+            len = 0;
+        }
+    }
+
+    return len;
 }
 
 int Schedule_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
@@ -197,32 +711,16 @@ int Schedule_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
                 encode_application_date(&apdu[apdu_len], &CurrentSC->End_Date);
             break;
         case PROP_WEEKLY_SCHEDULE:
-            if (rpdata->array_index == 0) { /* count, always 7 */
-                apdu_len = encode_application_unsigned(&apdu[0], 7);
-            } else if (rpdata->array_index ==
-                BACNET_ARRAY_ALL) { /* full array */
-                int day;
-                for (day = 0; day < 7; day++) {
-                    apdu_len += encode_opening_tag(&apdu[apdu_len], 0);
-                    for (i = 0; i < CurrentSC->Weekly_Schedule[day].TV_Count;
-                         i++) {
-                        apdu_len += bacnet_time_value_encode(&apdu[apdu_len],
-                            &CurrentSC->Weekly_Schedule[day].Time_Values[i]);
-                    }
-                    apdu_len += encode_closing_tag(&apdu[apdu_len], 0);
-                }
-            } else if (rpdata->array_index <= 7) { /* some array element */
-                int day = rpdata->array_index - 1;
-                apdu_len += encode_opening_tag(&apdu[apdu_len], 0);
-                for (i = 0; i < CurrentSC->Weekly_Schedule[day].TV_Count; i++) {
-                    apdu_len += bacnet_time_value_encode(&apdu[apdu_len],
-                        &CurrentSC->Weekly_Schedule[day].Time_Values[i]);
-                }
-                apdu_len += encode_closing_tag(&apdu[apdu_len], 0);
-            } else { /* out of bounds */
+            /* the days are encoded from the compact Weekly_Schedule */
+            apdu_len = bacnet_array_encode(rpdata->object_instance,
+                rpdata->array_index, Schedule_Weekly_Schedule_Encode, 7, apdu,
+                rpdata->application_data_len);
+            if (apdu_len == BACNET_STATUS_ABORT) {
+                rpdata->error_code =
+                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+            } else if (apdu_len == BACNET_STATUS_ERROR) {
                 rpdata->error_class = ERROR_CLASS_PROPERTY;
                 rpdata->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
-                apdu_len = BACNET_STATUS_ERROR;
             }
             break;
         case PROP_SCHEDULE_DEFAULT:
@@ -282,6 +780,53 @@ int Schedule_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     return apdu_len;
 }
 
+/**
+ * @brief Write the Weekly_Schedule, or one day of it, in place in the
+ *  compact Weekly_Schedule of the object
+ * @param wp_data - the write property data
+ * @return true if the Weekly_Schedule was written
+ */
+static bool Schedule_Weekly_Schedule_Write(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    unsigned object_index;
+    BACNET_WEEKLY_SCHEDULE_LIST *list;
+    int len;
+
+    object_index = Schedule_Instance_To_Index(wp_data->object_instance);
+    if (object_index >= MAX_SCHEDULES) {
+        return false;
+    }
+    list = &Schedule_Descr[object_index].Weekly_Schedule;
+    if (wp_data->array_index == BACNET_ARRAY_ALL) {
+        len = bacnet_weeklyschedule_list_decode(
+            wp_data->application_data, wp_data->application_data_len, list);
+    } else if (wp_data->array_index == 0) {
+        /* the size of the array is always 7 */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    } else if (wp_data->array_index <= 7) {
+        len = bacnet_weeklyschedule_list_day_decode(wp_data->application_data,
+            wp_data->application_data_len, list, wp_data->array_index - 1);
+    } else {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+        return false;
+    }
+    if (len == BACNET_STATUS_ABORT) {
+        wp_data->error_class = ERROR_CLASS_RESOURCES;
+        wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+        return false;
+    } else if (len < 0) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return false;
+    }
+    Schedule_Recalculate_Request(wp_data->object_instance);
+
+    return true;
+}
+
 bool Schedule_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
     /* Ed->Steve, I know that initializing stack values used to be 'safer', but
@@ -302,6 +847,10 @@ bool Schedule_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
        discussions can be directed to edward@bac-test.com Please feel free to
        remove this comment when my changes accepted after suitable time for
             review by all interested parties. Say 6 months -> September 2016 */
+    if (wp_data->object_property == PROP_WEEKLY_SCHEDULE) {
+        /* a BACnetARRAY[7] of BACnetDailySchedule, decoded in place */
+        return Schedule_Weekly_Schedule_Write(wp_data);
+    }
     /* decode the some of the request */
     len = bacapp_decode_application_data(
         wp_data->application_data, wp_data->application_data_len, &value);
@@ -369,7 +918,10 @@ bool Schedule_In_Effective_Period(SCHEDULE_DESCR *desc, BACNET_DATE *date)
 void Schedule_Recalculate_PV(
     SCHEDULE_DESCR *desc, BACNET_WEEKDAY wday, BACNET_TIME *time)
 {
-    int i;
+    BACNET_TIME_VALUE *time_values;
+    BACNET_TIME_VALUE *latest = NULL;
+    unsigned count, i;
+
     desc->Present_Value.tag = BACNET_APPLICATION_TAG_NULL;
 
     /* for future development, here should be the loop for Exception Schedule */
@@ -381,21 +933,156 @@ void Schedule_Recalculate_PV(
        this yourself, please ping us at info@connect-ex.com, we may be able to
        broker an early release on a case-by-case basis. */
 
-    for (i = 0; i < desc->Weekly_Schedule[wday - 1].TV_Count &&
-         desc->Present_Value.tag == BACNET_APPLICATION_TAG_NULL;
-         i++) {
-        int diff = datetime_wildcard_compare_time(
-            time, &desc->Weekly_Schedule[wday - 1].Time_Values[i].Time);
-        if (diff >= 0 &&
-            desc->Weekly_Schedule[wday - 1].Time_Values[i].Value.tag !=
-                BACNET_APPLICATION_TAG_NULL) {
-            bacnet_primitive_to_application_data_value(&desc->Present_Value,
-                &desc->Weekly_Schedule[wday - 1].Time_Values[i].Value);
+    /* the value is the one of the latest time value that has passed,
+       whatever the order of the list, and a NULL value relinquishes */
+    time_values =
+        bacnet_weeklyschedule_list_day(&desc->Weekly_Schedule, wday - 1);
+    count =
+        bacnet_weeklyschedule_list_day_count(&desc->Weekly_Schedule, wday - 1);
+    for (i = 0; i < count; i++) {
+        if ((datetime_wildcard_compare_time(time, &time_values[i].Time) >=
+                0) &&
+            (!latest ||
+                (datetime_wildcard_compare_time(
+                     &time_values[i].Time, &latest->Time) >= 0))) {
+            latest = &time_values[i];
         }
     }
+    if (latest && (latest->Value.tag != BACNET_APPLICATION_TAG_NULL)) {
+        bacnet_primitive_to_application_data_value(
+            &desc->Present_Value, &latest->Value);
+    }
 
     if (desc->Present_Value.tag == BACNET_APPLICATION_TAG_NULL) {
         memcpy(&desc->Present_Value, &desc->Schedule_Default,
             sizeof(desc->Present_Value));
     }
 }
+
+/**
+ * @brief Determine if any field of a time is a wildcard
+ * @param btime - time to check
+ * @return true if any field is a wildcard
+ */
+static bool schedule_time_wildcard(BACNET_TIME *btime)
+{
+    return datetime_wildcard_hour(btime) || datetime_wildcard_minute(btime) ||
+        datetime_wildcard_second(btime) || datetime_wildcard_hundredths(btime);
+}
+
+/**
+ * @brief Compute the time of the next transition of a schedule: the next
+ *  time value of the day, or else the start of the next day, when the
+ *  daily schedule and the Effective_Period may change.
+ * @param desc - the schedule
+ * @param bdatetime - the local date and time
+ * @param now - the local date and time in seconds since the epoch
+ * @return the time of the next transition, in seconds since the epoch
+ */
+static bacnet_time_t schedule_next_transition(
+    SCHEDULE_DESCR *desc, BACNET_DATE_TIME *bdatetime, bacnet_time_t now)
+{
+    BACNET_TIME_VALUE *time_values;
+    BACNET_TIME *btime;
+    bacnet_time_t midnight, next, transition;
+    unsigned day, count, i;
+
+    midnight = now - datetime_seconds_since_midnight(&bdatetime->time);
+    next = midnight + (24UL * 60UL * 60UL);
+    day = bdatetime->date.wday - 1;
+    time_values = bacnet_weeklyschedule_list_day(&desc->Weekly_Schedule, day);
+    count = bacnet_weeklyschedule_list_day_count(&desc->Weekly_Schedule, day);
+    for (i = 0; i < count; i++) {
+        btime = &time_values[i].Time;
+        if (schedule_time_wildcard(btime)) {
+            /* a time that repeats is looked at each minute */
+            transition = now + 60 - (now % 60);
+        } else if (datetime_compare_time(btime, &bdatetime->time) > 0) {
+            transition = midnight + datetime_seconds_since_midnight(btime);
+            if (btime->hundredths) {
+                /* the second in which the time value has passed */
+                transition++;
+            }
+        } else {
+            continue;
+        }
+        if (transition < next) {
+            next = transition;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Update the Present_Value of the schedules that have reached
+ *  their next transition, and compute their next transition. Call this
+ *  about once a second with the local date and time.
+ * @param bdatetime - the local date and time
+ * @return the number of schedules that were evaluated
+ */
+unsigned Schedule_Evaluate(BACNET_DATE_TIME *bdatetime)
+{
+    BACNET_APPLICATION_DATA_VALUE value;
+    SCHEDULE_DESCR *desc;
+    bacnet_time_t now;
+    unsigned index, i;
+    unsigned count = 0;
+
+    if (!bdatetime || (bdatetime->date.wday < BACNET_WEEKDAY_MONDAY) ||
+        (bdatetime->date.wday > BACNET_WEEKDAY_SUNDAY)) {
+        return 0;
+    }
+    now = datetime_seconds_since_epoch(bdatetime);
+    if (now < Schedule_Last_Evaluation) {
+        /* the clock was set backwards */
+        for (i = 0; i < MAX_SCHEDULES; i++) {
+            Schedule_Next_Transition[i] = 0;
+        }
+    }
+    Schedule_Last_Evaluation = now;
+    while (MAX_SCHEDULES > 0) {
+        index = Schedule_Queue[0];
+        if (Schedule_Next_Transition[index] > now) {
+            break;
+        }
+        desc = &Schedule_Descr[index];
+        memcpy(&value, &desc->Present_Value, sizeof(value));
+        if (desc->Out_Of_Service) {
+            /* the Present_Value is written while out of service */
+        } else if (Schedule_In_Effective_Period(desc, &bdatetime->date)) {
+            Schedule_Recalculate_PV(
+                desc, bdatetime->date.wday, &bdatetime->time);
+        } else {
+            memcpy(&desc->Present_Value, &desc->Schedule_Default,
+                sizeof(desc->Present_Value));
+        }
+        if (!bacapp_same_value(&value, &desc->Present_Value)) {
+            schedule_write_start(index);
+        }
+        Schedule_Next_Transition[index] =
+            schedule_next_transition(desc, bdatetime, now);
+        schedule_queue_update(index);
+        count++;
+    }
+    if (count > 0) {
+        schedule_write_dispatch();
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the time of the earliest next transition of the schedules,
+ *  so that the caller may sleep until then
+ * @return the time of the transition in seconds since the epoch, or 0
+ *  if a schedule is to be evaluated at the next Schedule_Evaluate()
+ */
+bacnet_time_t Schedule_Next_Evaluation(void)
+{
+    if (MAX_SCHEDULES == 0) {
+        return 0;
+    }
+
+    return Schedule_Next_Transition[Schedule_Queue[0]];
+}
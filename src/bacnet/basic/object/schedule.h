@@ -19,15 +19,27 @@
 #include "bacnet/rp.h"
 #include "bacnet/bacdevobjpropref.h"
 #include "bacnet/bactimevalue.h"
+#include "bacnet/weeklyschedule.h"
 
 #ifndef BACNET_WEEKLY_SCHEDULE_SIZE
 #define BACNET_WEEKLY_SCHEDULE_SIZE 8   /* maximum number of data points for each day */
 #endif
 
+/* the number of data points of the whole week, shared by the days */
+#ifndef BACNET_SCHEDULE_TIME_VALUES_SIZE
+#define BACNET_SCHEDULE_TIME_VALUES_SIZE 28
+#endif
+
 #ifndef BACNET_SCHEDULE_OBJ_PROP_REF_SIZE
 #define BACNET_SCHEDULE_OBJ_PROP_REF_SIZE 4     /* maximum number of obj prop references */
 #endif
 
+/* the write requests of all the schedules that are outstanding at the
+   same time */
+#ifndef SCHEDULE_WRITE_REQUESTS_MAX
+#define SCHEDULE_WRITE_REQUESTS_MAX 4
+#endif
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,19 +48,38 @@ extern "C" {
     /*
      * Note:
      * This is a different struct from BACNET_DAILY_SCHEDULE used in prop value encoding!
-     * The number of entries is different.
+     * The number of entries is different. It is only used to set one day;
+     * the object keeps the days in its compact Weekly_Schedule.
      */
     typedef struct bacnet_obj_daily_schedule {
         BACNET_TIME_VALUE Time_Values[BACNET_WEEKLY_SCHEDULE_SIZE];
         uint16_t TV_Count;      /* the number of time values actually used */
     } BACNET_OBJ_DAILY_SCHEDULE;
 
+    /**
+     * Callback to write the Present_Value of a schedule to some of its
+     * referenced properties of one device, such as with one
+     * WritePropertyMultiple request. The device instance is greater than
+     * BACNET_MAX_INSTANCE for the references without a device identifier.
+     * The outcome is reported with Schedule_Write_Multiple_Result().
+     * @return true if the request was sent, or false to try again later,
+     *  such as when the network of the device is busy
+     */
+    typedef bool (*schedule_write_multiple_callback)(
+        uint32_t object_instance,
+        uint32_t device_instance,
+        BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE **references,
+        unsigned count,
+        BACNET_APPLICATION_DATA_VALUE *value,
+        uint8_t priority);
+
     typedef struct schedule {
         /* Effective Period: Start and End Date */
         BACNET_DATE Start_Date;
         BACNET_DATE End_Date;
         /* Properties concerning Present Value */
-        BACNET_OBJ_DAILY_SCHEDULE Weekly_Schedule[7];
+        BACNET_TIME_VALUE Time_Values[BACNET_SCHEDULE_TIME_VALUES_SIZE];
+        BACNET_WEEKLY_SCHEDULE_LIST Weekly_Schedule;
         BACNET_APPLICATION_DATA_VALUE Schedule_Default;
         /*
          * Caution: This is a converted to BACNET_PRIMITIVE_APPLICATION_DATA_VALUE.
@@ -59,6 +90,10 @@ extern "C" {
         BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE
             Object_Property_References[BACNET_SCHEDULE_OBJ_PROP_REF_SIZE];
         uint8_t obj_prop_ref_cnt;       /* actual number of obj_prop references */
+        /* the references to be written, and the ones being written */
+        bool Write_Pending[BACNET_SCHEDULE_OBJ_PROP_REF_SIZE];
+        bool Write_Sent[BACNET_SCHEDULE_OBJ_PROP_REF_SIZE];
+        uint32_t Write_Delay;   /* milliseconds until the writes start */
         uint8_t Priority_For_Writing;   /* (1..16) */
         bool Out_Of_Service;
     } SCHEDULE_DESCR;
@@ -107,6 +142,46 @@ extern "C" {
         BACNET_WEEKDAY wday,
         BACNET_TIME * time);
 
+    BACNET_STACK_EXPORT
+    bool Schedule_Weekly_Schedule_Set(uint32_t object_instance,
+        BACNET_WEEKDAY wday,
+        const BACNET_OBJ_DAILY_SCHEDULE * day);
+    BACNET_STACK_EXPORT
+    bool Schedule_Effective_Period_Set(uint32_t object_instance,
+        BACNET_DATE * start_date,
+        BACNET_DATE * end_date);
+    BACNET_STACK_EXPORT
+    bool Schedule_Default_Set(uint32_t object_instance,
+        BACNET_APPLICATION_DATA_VALUE * value);
+    BACNET_STACK_EXPORT
+    bool Schedule_Present_Value(uint32_t object_instance,
+        BACNET_APPLICATION_DATA_VALUE * value);
+    BACNET_STACK_EXPORT
+    bool Schedule_Object_Property_Reference_Add(uint32_t object_instance,
+        BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE * reference);
+
+    /* the writes of the Present_Value to the referenced properties */
+    BACNET_STACK_EXPORT
+    void Schedule_Write_Multiple_Callback_Set(
+        schedule_write_multiple_callback cb);
+    BACNET_STACK_EXPORT
+    void Schedule_Write_Jitter_Set(uint32_t milliseconds);
+    BACNET_STACK_EXPORT
+    bool Schedule_Write_Multiple_Result(uint32_t object_instance,
+        uint32_t device_instance,
+        unsigned successful);
+    BACNET_STACK_EXPORT
+    void Schedule_Timer(uint32_t object_instance,
+        uint16_t milliseconds);
+
+    /* evaluation of the schedules at their next transition */
+    BACNET_STACK_EXPORT
+    void Schedule_Recalculate_Request(uint32_t object_instance);
+    BACNET_STACK_EXPORT
+    unsigned Schedule_Evaluate(BACNET_DATE_TIME * bdatetime);
+    BACNET_STACK_EXPORT
+    bacnet_time_t Schedule_Next_Evaluation(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
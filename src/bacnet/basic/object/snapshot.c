@@ -0,0 +1,1123 @@
+/**
+ * @file
+ * @brief A snapshot of the object database of this device, kept as a
+ *  journal of the changes made to it.
+ *
+ * The journal lives in a buffer that the application gives, which is RAM
+ * that the application saves, or a file that is mapped into memory, so
+ * that the journal is written back as it changes and there is nothing to
+ * load at start up.  Each WriteProperty, CreateObject and DeleteObject of
+ * a local object that succeeds, and each SubscribeCOV and
+ * SubscribeCOVProperty, is appended as a record.  A newer record for the
+ * same property and priority, or for the same subscription, replaces the
+ * older one, which is marked as dead.  The dead records are dropped when
+ * the buffer is compacted.
+ *
+ * After the objects are initialized, snapshot_restore() replays the live
+ * records in the order that they were made, through the same functions
+ * that made them, so no object needs to know about the snapshot.  The
+ * subscriptions are replayed last, once their objects exist.
+ *
+ * The numbers in the buffer are big endian, so that a snapshot may be
+ * moved between hosts.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacint.h"
+#include "bacnet/bacreal.h"
+#include "bacnet/create_object.h"
+#include "bacnet/delete_object.h"
+#include "bacnet/proplist.h"
+#include "bacnet/datalink/crc.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/service/h_cov.h"
+#include "bacnet/basic/object/snapshot.h"
+
+#if (SNAPSHOT_INDEX_SIZE & (SNAPSHOT_INDEX_SIZE - 1))
+#error SNAPSHOT_INDEX_SIZE must be a power of two
+#endif
+
+/* "BSNP" */
+#define SNAPSHOT_MAGIC 0x42534E50UL
+#define SNAPSHOT_VERSION 1
+/* a change could not be kept, so the snapshot is not to be restored */
+#define SNAPSHOT_FLAG_INCOMPLETE 0x0001
+
+/* the kinds of record */
+#define SNAPSHOT_RECORD_WRITE_PROPERTY 1
+#define SNAPSHOT_RECORD_CREATE_OBJECT 2
+#define SNAPSHOT_RECORD_DELETE_OBJECT 3
+#define SNAPSHOT_RECORD_SUBSCRIBE_COV 4
+/* the state of a record, which is not covered by the record check */
+#define SNAPSHOT_RECORD_DEAD 0x00
+#define SNAPSHOT_RECORD_LIVE 0x01
+/* Each record is the kind, the state, a CRC-16 of the rest of the
+   record, the key length, a reserved octet and the data length, then
+   the key and the data, padded to a multiple of four octets. */
+#define SNAPSHOT_RECORD_HEADER_SIZE 8
+
+/* object type and instance */
+#define SNAPSHOT_OBJECT_KEY_SIZE 6
+/* object, property, array index and priority */
+#define SNAPSHOT_WRITE_KEY_SIZE 15
+/* subscriber address, process identifier, object and property */
+#define SNAPSHOT_COV_KEY_SIZE_MAX (1 + MAX_MAC_LEN + 2 + 1 + MAX_MAC_LEN + 18)
+/* flags, lifetime and COV increment */
+#define SNAPSHOT_COV_DATA_SIZE 9
+/* the monitored property of a SubscribeCOV */
+#define SNAPSHOT_COV_NO_PROPERTY UINT32_MAX
+/* the flags of a subscription */
+#define SNAPSHOT_COV_CONFIRMED 0x01
+#define SNAPSHOT_COV_PROPERTY 0x02
+#define SNAPSHOT_COV_INCREMENT 0x04
+
+/* the slots of the index hold the offsets of keyed records */
+#define SNAPSHOT_SLOT_EMPTY 0
+#define SNAPSHOT_SLOT_DELETED UINT32_MAX
+/* the index is rebuilt when more of the slots than this are used */
+#define SNAPSHOT_SLOTS_MAX ((SNAPSHOT_INDEX_SIZE / 4) * 3)
+
+static uint8_t *Snapshot_Buffer;
+static size_t Snapshot_Size;
+/* octets of records after the header */
+static size_t Snapshot_Used;
+static uint16_t Snapshot_Flags;
+/* number of live records */
+static unsigned Snapshot_Records;
+/* offsets of the live keyed records, by the hash of their key */
+static uint32_t Snapshot_Index[SNAPSHOT_INDEX_SIZE];
+/* slots that are not empty, including the deleted ones */
+static unsigned Snapshot_Slots_Used;
+/* changes made by snapshot_restore() are not recorded again */
+static bool Snapshot_Restoring;
+/* octets that changed since the last call to snapshot_dirty() */
+static size_t Snapshot_Dirty_Start;
+static size_t Snapshot_Dirty_End;
+/* count of the times that the records were moved or removed */
+static unsigned Snapshot_Generation;
+
+/**
+ * @brief Add a range of the buffer to the range that changed
+ * @param offset [in] first octet that changed
+ * @param length [in] number of octets that changed
+ */
+static void snapshot_dirty_mark(size_t offset, size_t length)
+{
+    if (length == 0) {
+        return;
+    }
+    if (Snapshot_Dirty_End == 0) {
+        Snapshot_Dirty_Start = offset;
+        Snapshot_Dirty_End = offset + length;
+    } else {
+        if (offset < Snapshot_Dirty_Start) {
+            Snapshot_Dirty_Start = offset;
+        }
+        if ((offset + length) > Snapshot_Dirty_End) {
+            Snapshot_Dirty_End = offset + length;
+        }
+    }
+}
+
+/**
+ * @brief Write the header of the snapshot, which commits the records
+ *  that were appended before it
+ */
+static void snapshot_header_write(void)
+{
+    uint8_t *header = Snapshot_Buffer;
+
+    encode_unsigned32(&header[0], SNAPSHOT_MAGIC);
+    encode_unsigned16(&header[4], SNAPSHOT_VERSION);
+    encode_unsigned16(&header[6], Snapshot_Flags);
+    encode_unsigned32(&header[8], (uint32_t)Snapshot_Size);
+    encode_unsigned32(&header[12], (uint32_t)Snapshot_Used);
+    snapshot_dirty_mark(0, SNAPSHOT_HEADER_SIZE);
+}
+
+/**
+ * @brief Mark the snapshot as missing a change, so that it is not
+ *  restored
+ */
+static void snapshot_incomplete(void)
+{
+    if (!(Snapshot_Flags & SNAPSHOT_FLAG_INCOMPLETE)) {
+        Snapshot_Flags |= SNAPSHOT_FLAG_INCOMPLETE;
+        snapshot_header_write();
+    }
+}
+
+/**
+ * @brief Get the number of octets of a record with a key and data
+ * @param key_len [in] octets of the key
+ * @param data_len [in] octets of the data
+ * @return number of octets of the record, with its padding
+ */
+static size_t snapshot_record_length(uint8_t key_len, uint16_t data_len)
+{
+    size_t length;
+
+    length = SNAPSHOT_RECORD_HEADER_SIZE + key_len + data_len;
+
+    return (length + 3) & ~((size_t)3);
+}
+
+/**
+ * @brief Get the key length of a record
+ * @param record [in] the record
+ * @return octets of the key
+ */
+static uint8_t snapshot_record_key_len(const uint8_t *record)
+{
+    return record[4];
+}
+
+/**
+ * @brief Get the data length of a record
+ * @param record [in] the record
+ * @return octets of the data
+ */
+static uint16_t snapshot_record_data_len(const uint8_t *record)
+{
+    return (uint16_t)(((uint16_t)record[6] << 8) | record[7]);
+}
+
+/**
+ * @brief Get the key of a record
+ * @param record [in] the record
+ * @return the key
+ */
+static uint8_t *snapshot_record_key(uint8_t *record)
+{
+    return &record[SNAPSHOT_RECORD_HEADER_SIZE];
+}
+
+/**
+ * @brief Get the data of a record
+ * @param record [in] the record
+ * @return the data, which follows the key
+ */
+static uint8_t *snapshot_record_data(uint8_t *record)
+{
+    return &record[SNAPSHOT_RECORD_HEADER_SIZE + record[4]];
+}
+
+/**
+ * @brief Compute the check of a record, which covers all but its state,
+ *  so that a record may be marked as dead without changing its check
+ * @param record [in] the record
+ * @return CRC-16 of the record
+ */
+static uint16_t snapshot_record_check(const uint8_t *record)
+{
+    uint16_t crc;
+
+    crc = CRC_Calc_Data(record[0], 0xFFFF);
+    crc = CRC_Calc_Data_Buffer(&record[4],
+        4 + snapshot_record_key_len(record) + snapshot_record_data_len(record),
+        crc);
+
+    return crc;
+}
+
+/**
+ * @brief Determine if the records of a kind have a key in the index
+ * @param kind [in] the kind of record
+ * @return true if the records are found by their key
+ */
+static bool snapshot_record_keyed(uint8_t kind)
+{
+    return (kind == SNAPSHOT_RECORD_WRITE_PROPERTY) ||
+        (kind == SNAPSHOT_RECORD_SUBSCRIBE_COV);
+}
+
+/**
+ * @brief Hash the kind and key of a record, with FNV-1a
+ * @param kind [in] the kind of record
+ * @param key [in] the key
+ * @param key_len [in] octets of the key
+ * @return the hash
+ */
+static uint32_t
+snapshot_hash(uint8_t kind, const uint8_t *key, uint8_t key_len)
+{
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
+
+    hash = (hash ^ kind) * 16777619UL;
+    for (i = 0; i < key_len; i++) {
+        hash = (hash ^ key[i]) * 16777619UL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Find the slot of the index with a key, or the slot for it
+ * @param kind [in] the kind of record
+ * @param key [in] the key
+ * @param key_len [in] octets of the key
+ * @param found [out] true if the slot holds a record with the key
+ * @return the slot, or SNAPSHOT_INDEX_SIZE if the index is full
+ */
+static unsigned snapshot_slot_find(
+    uint8_t kind, const uint8_t *key, uint8_t key_len, bool *found)
+{
+    unsigned free_slot = SNAPSHOT_INDEX_SIZE;
+    unsigned slot;
+    unsigned i;
+    uint32_t offset;
+    uint8_t *record;
+
+    *found = false;
+    slot = snapshot_hash(kind, key, key_len) & (SNAPSHOT_INDEX_SIZE - 1);
+    for (i = 0; i < SNAPSHOT_INDEX_SIZE; i++) {
+        offset = Snapshot_Index[slot];
+        if (offset == SNAPSHOT_SLOT_EMPTY) {
+            if (free_slot == SNAPSHOT_INDEX_SIZE) {
+                free_slot = slot;
+            }
+            break;
+        }
+        if (offset == SNAPSHOT_SLOT_DELETED) {
+            if (free_slot == SNAPSHOT_INDEX_SIZE) {
+                free_slot = slot;
+            }
+        } else {
+            record = &Snapshot_Buffer[offset];
+            if ((record[0] == kind) &&
+                (snapshot_record_key_len(record) == key_len) &&
+                (memcmp(snapshot_record_key(record), key, key_len) == 0)) {
+                *found = true;
+                return slot;
+            }
+        }
+        slot = (slot + 1) & (SNAPSHOT_INDEX_SIZE - 1);
+    }
+
+    return free_slot;
+}
+
+/**
+ * @brief Mark a record as dead
+ * @param offset [in] offset of the record in the buffer
+ */
+static void snapshot_record_kill(size_t offset)
+{
+    Snapshot_Buffer[offset + 1] = SNAPSHOT_RECORD_DEAD;
+    snapshot_dirty_mark(offset + 1, 1);
+    if (Snapshot_Records > 0) {
+        Snapshot_Records--;
+    }
+}
+
+/**
+ * @brief Put a live keyed record into the index.  An older record with
+ *  the same key, which is left by a stop between the append of a record
+ *  and the kill of the record that it replaced, is killed.
+ * @param offset [in] offset of the record in the buffer
+ * @return true if the record is in the index
+ */
+static bool snapshot_index_add(size_t offset)
+{
+    uint8_t *record = &Snapshot_Buffer[offset];
+    unsigned slot;
+    bool found = false;
+
+    slot = snapshot_slot_find(record[0], snapshot_record_key(record),
+        snapshot_record_key_len(record), &found);
+    if (slot == SNAPSHOT_INDEX_SIZE) {
+        return false;
+    }
+    if (found) {
+        snapshot_record_kill(Snapshot_Index[slot]);
+    } else if (Snapshot_Index[slot] == SNAPSHOT_SLOT_EMPTY) {
+        Snapshot_Slots_Used++;
+    }
+    Snapshot_Index[slot] = (uint32_t)offset;
+
+    return true;
+}
+
+/**
+ * @brief Build the index and the count of the live records from the
+ *  records in the buffer
+ */
+static void snapshot_index_build(void)
+{
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    size_t end = SNAPSHOT_HEADER_SIZE + Snapshot_Used;
+    uint8_t *record;
+
+    memset(Snapshot_Index, 0, sizeof(Snapshot_Index));
+    Snapshot_Slots_Used = 0;
+    Snapshot_Records = 0;
+    while (offset < end) {
+        record = &Snapshot_Buffer[offset];
+        if (record[1] == SNAPSHOT_RECORD_LIVE) {
+            Snapshot_Records++;
+            if (snapshot_record_keyed(record[0]) &&
+                !snapshot_index_add(offset)) {
+                snapshot_record_kill(offset);
+                snapshot_incomplete();
+            }
+        }
+        offset += snapshot_record_length(snapshot_record_key_len(record),
+            snapshot_record_data_len(record));
+    }
+}
+
+/**
+ * @brief Drop the dead records, keeping the order of the live records
+ * @return true if the buffer was compacted
+ */
+bool snapshot_compact(void)
+{
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    size_t next = SNAPSHOT_HEADER_SIZE;
+    size_t end;
+    size_t length;
+    uint8_t *record;
+
+    if (!Snapshot_Buffer) {
+        return false;
+    }
+    end = SNAPSHOT_HEADER_SIZE + Snapshot_Used;
+    while (offset < end) {
+        record = &Snapshot_Buffer[offset];
+        length = snapshot_record_length(snapshot_record_key_len(record),
+            snapshot_record_data_len(record));
+        if (record[1] == SNAPSHOT_RECORD_LIVE) {
+            if (next != offset) {
+                memmove(&Snapshot_Buffer[next], record, length);
+            }
+            next += length;
+        }
+        offset += length;
+    }
+    if (next != end) {
+        snapshot_dirty_mark(SNAPSHOT_HEADER_SIZE, next - SNAPSHOT_HEADER_SIZE);
+        Snapshot_Used = next - SNAPSHOT_HEADER_SIZE;
+        Snapshot_Generation++;
+        snapshot_header_write();
+    }
+    snapshot_index_build();
+
+    return true;
+}
+
+/**
+ * @brief Check the records of the buffer, and keep those before the
+ *  first one that is not whole
+ * @return true if all of the records are whole
+ */
+static bool snapshot_scan(void)
+{
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    size_t end = SNAPSHOT_HEADER_SIZE + Snapshot_Used;
+    size_t length;
+    uint8_t *record;
+    uint16_t check;
+
+    while (offset < end) {
+        record = &Snapshot_Buffer[offset];
+        if ((end - offset) < SNAPSHOT_RECORD_HEADER_SIZE) {
+            break;
+        }
+        length = snapshot_record_length(snapshot_record_key_len(record),
+            snapshot_record_data_len(record));
+        if (length > (end - offset)) {
+            break;
+        }
+        decode_unsigned16(&record[2], &check);
+        if ((check != snapshot_record_check(record)) ||
+            ((record[1] != SNAPSHOT_RECORD_LIVE) &&
+                (record[1] != SNAPSHOT_RECORD_DEAD))) {
+            break;
+        }
+        offset += length;
+    }
+    if (offset != end) {
+        Snapshot_Used = offset - SNAPSHOT_HEADER_SIZE;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Use a buffer for the snapshot.  A snapshot that is already in
+ *  the buffer is kept, so that it can be restored.
+ * @param buffer [in] the buffer, such as a file mapped into memory, or
+ *  NULL to stop keeping a snapshot
+ * @param size [in] octets of the buffer
+ * @return true if the buffer holds a complete snapshot
+ */
+bool snapshot_init(uint8_t *buffer, size_t size)
+{
+    uint32_t magic = 0;
+    uint32_t used = 0;
+    uint16_t version = 0;
+    bool status = false;
+
+    Snapshot_Buffer = NULL;
+    Snapshot_Size = 0;
+    Snapshot_Used = 0;
+    Snapshot_Flags = 0;
+    Snapshot_Records = 0;
+    Snapshot_Slots_Used = 0;
+    Snapshot_Dirty_Start = 0;
+    Snapshot_Dirty_End = 0;
+    memset(Snapshot_Index, 0, sizeof(Snapshot_Index));
+    if (!buffer || (size <= SNAPSHOT_HEADER_SIZE) || (size > UINT32_MAX)) {
+        return false;
+    }
+    Snapshot_Buffer = buffer;
+    Snapshot_Size = size;
+    decode_unsigned32(&buffer[0], &magic);
+    decode_unsigned16(&buffer[4], &version);
+    decode_unsigned32(&buffer[12], &used);
+    if ((magic == SNAPSHOT_MAGIC) && (version == SNAPSHOT_VERSION) &&
+        (used <= (size - SNAPSHOT_HEADER_SIZE))) {
+        decode_unsigned16(&buffer[6], &Snapshot_Flags);
+        Snapshot_Used = used;
+        if (!snapshot_scan()) {
+            /* the changes after the damaged record are lost */
+            Snapshot_Flags |= SNAPSHOT_FLAG_INCOMPLETE;
+        }
+        snapshot_header_write();
+        snapshot_index_build();
+        status = !(Snapshot_Flags & SNAPSHOT_FLAG_INCOMPLETE);
+    } else {
+        snapshot_header_write();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Remove all of the records, such as after the application has
+ *  configured the device in full
+ */
+void snapshot_clear(void)
+{
+    if (!Snapshot_Buffer) {
+        return;
+    }
+    Snapshot_Used = 0;
+    Snapshot_Flags = 0;
+    Snapshot_Records = 0;
+    Snapshot_Slots_Used = 0;
+    Snapshot_Generation++;
+    memset(Snapshot_Index, 0, sizeof(Snapshot_Index));
+    snapshot_header_write();
+}
+
+/**
+ * @brief Determine if the snapshot holds all of the changes
+ * @return true if no change was lost for lack of room
+ */
+bool snapshot_complete(void)
+{
+    return Snapshot_Buffer && !(Snapshot_Flags & SNAPSHOT_FLAG_INCOMPLETE);
+}
+
+/**
+ * @brief Get the number of octets of the buffer in use
+ * @return octets of the header and the records
+ */
+size_t snapshot_used(void)
+{
+    if (!Snapshot_Buffer) {
+        return 0;
+    }
+
+    return SNAPSHOT_HEADER_SIZE + Snapshot_Used;
+}
+
+/**
+ * @brief Get the number of live records
+ * @return number of live records
+ */
+unsigned snapshot_record_count(void)
+{
+    return Snapshot_Records;
+}
+
+/**
+ * @brief Get the range of the buffer that changed since the last call,
+ *  so that an application that saves the buffer writes only that range
+ * @param offset [out] first octet that changed
+ * @param length [out] number of octets that changed
+ * @return true if some of the buffer changed
+ */
+bool snapshot_dirty(size_t *offset, size_t *length)
+{
+    if (Snapshot_Dirty_End == 0) {
+        return false;
+    }
+    if (offset) {
+        *offset = Snapshot_Dirty_Start;
+    }
+    if (length) {
+        *length = Snapshot_Dirty_End - Snapshot_Dirty_Start;
+    }
+    Snapshot_Dirty_Start = 0;
+    Snapshot_Dirty_End = 0;
+
+    return true;
+}
+
+/**
+ * @brief Get the generation of the records.  It changes when the
+ *  records are compacted or cleared, after which the records that were
+ *  saved before are no longer where they were, and the whole buffer
+ *  has to be saved again rather than only what was appended.
+ * @return generation of the records
+ */
+unsigned snapshot_generation(void)
+{
+    return Snapshot_Generation;
+}
+
+/**
+ * @brief Replay a WriteProperty record
+ * @param record [in] the record
+ * @return true if the property was written
+ */
+static bool snapshot_write_property_replay(uint8_t *record)
+{
+    static BACNET_WRITE_PROPERTY_DATA wp_data;
+    uint8_t *key = snapshot_record_key(record);
+    uint16_t object_type = 0;
+    uint32_t value = 0;
+
+    memset(&wp_data, 0, sizeof(wp_data));
+    decode_unsigned16(&key[0], &object_type);
+    wp_data.object_type = (BACNET_OBJECT_TYPE)object_type;
+    decode_unsigned32(&key[2], &wp_data.object_instance);
+    decode_unsigned32(&key[6], &value);
+    wp_data.object_property = (BACNET_PROPERTY_ID)value;
+    decode_unsigned32(&key[10], &wp_data.array_index);
+    wp_data.priority = key[14];
+    if (snapshot_record_data_len(record) >
+        sizeof(wp_data.application_data)) {
+        return false;
+    }
+    wp_data.application_data_len = snapshot_record_data_len(record);
+    memcpy(wp_data.application_data, snapshot_record_data(record),
+        wp_data.application_data_len);
+
+    return Device_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Replay a CreateObject or DeleteObject record
+ * @param record [in] the record
+ * @return true if the object was created or deleted
+ */
+static bool snapshot_object_replay(uint8_t *record)
+{
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    uint8_t *key = snapshot_record_key(record);
+    uint16_t object_type = 0;
+    uint32_t object_instance = 0;
+
+    decode_unsigned16(&key[0], &object_type);
+    decode_unsigned32(&key[2], &object_instance);
+    if (record[0] == SNAPSHOT_RECORD_CREATE_OBJECT) {
+        create_data.object_type = (BACNET_OBJECT_TYPE)object_type;
+        create_data.object_instance = object_instance;
+        return Device_Create_Object(&create_data);
+    }
+    delete_data.object_type = (BACNET_OBJECT_TYPE)object_type;
+    delete_data.object_instance = object_instance;
+
+    return Device_Delete_Object(&delete_data);
+}
+
+/**
+ * @brief Replay a subscription record
+ * @param record [in] the record
+ * @return true if the subscription was made
+ */
+static bool snapshot_cov_replay(uint8_t *record)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t *key = snapshot_record_key(record);
+    uint8_t *data = snapshot_record_data(record);
+    uint16_t object_type = 0;
+    uint32_t property = 0;
+    unsigned key_len = 0;
+
+    if (snapshot_record_data_len(record) < SNAPSHOT_COV_DATA_SIZE) {
+        return false;
+    }
+    src.mac_len = key[key_len++];
+    if (src.mac_len > MAX_MAC_LEN) {
+        return false;
+    }
+    memcpy(src.mac, &key[key_len], src.mac_len);
+    key_len += src.mac_len;
+    key_len += decode_unsigned16(&key[key_len], &src.net);
+    src.len = key[key_len++];
+    if (src.len > MAX_MAC_LEN) {
+        return false;
+    }
+    memcpy(src.adr, &key[key_len], src.len);
+    key_len += src.len;
+    key_len +=
+        decode_unsigned32(&key[key_len], &cov_data.subscriberProcessIdentifier);
+    key_len += decode_unsigned16(&key[key_len], &object_type);
+    cov_data.monitoredObjectIdentifier.type = object_type;
+    key_len += decode_unsigned32(
+        &key[key_len], &cov_data.monitoredObjectIdentifier.instance);
+    key_len += decode_unsigned32(&key[key_len], &property);
+    key_len += decode_unsigned32(
+        &key[key_len], &cov_data.monitoredProperty.propertyArrayIndex);
+    if (key_len != snapshot_record_key_len(record)) {
+        return false;
+    }
+    cov_data.monitoredProperty.propertyIdentifier =
+        (BACNET_PROPERTY_ID)property;
+    cov_data.issueConfirmedNotifications = data[0] & SNAPSHOT_COV_CONFIRMED;
+    cov_data.covSubscribeToProperty = data[0] & SNAPSHOT_COV_PROPERTY;
+    cov_data.covIncrementPresent = data[0] & SNAPSHOT_COV_INCREMENT;
+    decode_unsigned32(&data[1], &cov_data.lifetime);
+    decode_real(&data[5], &cov_data.covIncrement);
+
+    return handler_cov_subscription_restore(&src, &cov_data);
+}
+
+/**
+ * @brief Replay the changes in the snapshot, after the objects have been
+ *  initialized at start up or after a warm start.  The objects are
+ *  created, deleted and written first, in the order of the changes, and
+ *  then the COV subscriptions are made.  The changes made by the replay
+ *  are not recorded again.
+ * @return number of changes that were replayed, or -1 if there is no
+ *  complete snapshot
+ */
+int snapshot_restore(void)
+{
+    size_t offset;
+    size_t end;
+    uint8_t *record;
+    unsigned pass;
+    bool status;
+    int count = 0;
+
+    if (!snapshot_complete()) {
+        return -1;
+    }
+    Snapshot_Restoring = true;
+    end = SNAPSHOT_HEADER_SIZE + Snapshot_Used;
+    for (pass = 0; pass < 2; pass++) {
+        offset = SNAPSHOT_HEADER_SIZE;
+        while (offset < end) {
+            record = &Snapshot_Buffer[offset];
+            offset += snapshot_record_length(snapshot_record_key_len(record),
+                snapshot_record_data_len(record));
+            if (record[1] != SNAPSHOT_RECORD_LIVE) {
+                continue;
+            }
+            status = false;
+            if (record[0] == SNAPSHOT_RECORD_SUBSCRIBE_COV) {
+                if (pass == 1) {
+                    status = snapshot_cov_replay(record);
+                }
+            } else if (pass == 0) {
+                if (record[0] == SNAPSHOT_RECORD_WRITE_PROPERTY) {
+                    status = snapshot_write_property_replay(record);
+                } else {
+                    status = snapshot_object_replay(record);
+                }
+            }
+            if (status) {
+                count++;
+            }
+        }
+    }
+    Snapshot_Restoring = false;
+
+    return count;
+}
+
+#if BACNET_SNAPSHOT_ENABLED
+/**
+ * @brief Make room for a record, compacting the buffer if it is needed
+ * @param length [in] octets of the record
+ * @param keyed [in] true if the record takes a slot of the index
+ * @return true if there is room for the record
+ */
+static bool snapshot_reserve(size_t length, bool keyed)
+{
+    size_t room = Snapshot_Size - SNAPSHOT_HEADER_SIZE;
+
+    if (((Snapshot_Used + length) > room) ||
+        (keyed && (Snapshot_Slots_Used >= SNAPSHOT_SLOTS_MAX))) {
+        snapshot_compact();
+    }
+
+    return ((Snapshot_Used + length) <= room);
+}
+
+/**
+ * @brief Append a record, after room was made for it
+ * @param kind [in] the kind of record
+ * @param key [in] the key
+ * @param key_len [in] octets of the key
+ * @param data [in] the data, or NULL
+ * @param data_len [in] octets of the data
+ * @return offset of the record in the buffer
+ */
+static size_t snapshot_append(uint8_t kind,
+    const uint8_t *key,
+    uint8_t key_len,
+    const uint8_t *data,
+    uint16_t data_len)
+{
+    size_t offset = SNAPSHOT_HEADER_SIZE + Snapshot_Used;
+    size_t length;
+    uint8_t *record = &Snapshot_Buffer[offset];
+
+    length = snapshot_record_length(key_len, data_len);
+    memset(record, 0, length);
+    record[0] = kind;
+    record[1] = SNAPSHOT_RECORD_LIVE;
+    record[4] = key_len;
+    encode_unsigned16(&record[6], data_len);
+    memcpy(snapshot_record_key(record), key, key_len);
+    if (data_len > 0) {
+        memcpy(snapshot_record_data(record), data, data_len);
+    }
+    encode_unsigned16(&record[2], snapshot_record_check(record));
+    snapshot_dirty_mark(offset, length);
+    Snapshot_Used += length;
+    Snapshot_Records++;
+    /* the record is part of the snapshot once the header is written */
+    snapshot_header_write();
+
+    return offset;
+}
+
+/**
+ * @brief Set the data of a keyed record, replacing any older record
+ *  with the same key
+ * @param kind [in] the kind of record
+ * @param key [in] the key
+ * @param key_len [in] octets of the key
+ * @param data [in] the data
+ * @param data_len [in] octets of the data
+ */
+static void snapshot_set(uint8_t kind,
+    const uint8_t *key,
+    uint8_t key_len,
+    const uint8_t *data,
+    uint16_t data_len)
+{
+    uint8_t *record;
+    unsigned slot;
+    size_t offset;
+    bool found = false;
+
+    slot = snapshot_slot_find(kind, key, key_len, &found);
+    if (found) {
+        record = &Snapshot_Buffer[Snapshot_Index[slot]];
+        if ((snapshot_record_data_len(record) == data_len) &&
+            (memcmp(snapshot_record_data(record), data, data_len) == 0)) {
+            /* no change */
+            return;
+        }
+    }
+    if (!snapshot_reserve(snapshot_record_length(key_len, data_len), true)) {
+        snapshot_incomplete();
+        return;
+    }
+    /* the compaction moves the records and rebuilds the index */
+    slot = snapshot_slot_find(kind, key, key_len, &found);
+    if (slot == SNAPSHOT_INDEX_SIZE) {
+        snapshot_incomplete();
+        return;
+    }
+    offset = snapshot_append(kind, key, key_len, data, data_len);
+    if (found) {
+        snapshot_record_kill(Snapshot_Index[slot]);
+    } else if (Snapshot_Index[slot] == SNAPSHOT_SLOT_EMPTY) {
+        Snapshot_Slots_Used++;
+    }
+    Snapshot_Index[slot] = (uint32_t)offset;
+}
+
+/**
+ * @brief Remove the keyed record with a key, if there is one
+ * @param kind [in] the kind of record
+ * @param key [in] the key
+ * @param key_len [in] octets of the key
+ */
+static void
+snapshot_remove(uint8_t kind, const uint8_t *key, uint8_t key_len)
+{
+    unsigned slot;
+    bool found = false;
+
+    slot = snapshot_slot_find(kind, key, key_len, &found);
+    if (found) {
+        snapshot_record_kill(Snapshot_Index[slot]);
+        Snapshot_Index[slot] = SNAPSHOT_SLOT_DELETED;
+    }
+}
+
+/**
+ * @brief Encode the key of an object
+ * @param key [out] the key, SNAPSHOT_OBJECT_KEY_SIZE octets
+ * @param object_type [in] type of the object
+ * @param object_instance [in] instance of the object
+ * @return octets of the key
+ */
+static uint8_t snapshot_object_key(
+    uint8_t *key, BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    encode_unsigned16(&key[0], (uint16_t)object_type);
+    encode_unsigned32(&key[2], object_instance);
+
+    return SNAPSHOT_OBJECT_KEY_SIZE;
+}
+
+/**
+ * @brief Encode the key of a subscription
+ * @param key [out] the key, up to SNAPSHOT_COV_KEY_SIZE_MAX octets
+ * @param src [in] address of the subscriber
+ * @param cov_data [in] the subscription
+ * @return octets of the key
+ */
+static uint8_t snapshot_cov_key(uint8_t *key,
+    const BACNET_ADDRESS *src,
+    const BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    uint8_t mac_len = src->mac_len;
+    uint8_t len = src->len;
+    uint32_t property = SNAPSHOT_COV_NO_PROPERTY;
+    uint32_t array_index = BACNET_ARRAY_ALL;
+    uint8_t key_len = 0;
+
+    if (mac_len > MAX_MAC_LEN) {
+        mac_len = MAX_MAC_LEN;
+    }
+    if (len > MAX_MAC_LEN) {
+        len = MAX_MAC_LEN;
+    }
+    if (cov_data->covSubscribeToProperty) {
+        property = cov_data->monitoredProperty.propertyIdentifier;
+        array_index = cov_data->monitoredProperty.propertyArrayIndex;
+    }
+    key[key_len++] = mac_len;
+    memcpy(&key[key_len], src->mac, mac_len);
+    key_len += mac_len;
+    key_len += encode_unsigned16(&key[key_len], src->net);
+    key[key_len++] = len;
+    memcpy(&key[key_len], src->adr, len);
+    key_len += len;
+    key_len += encode_unsigned32(
+        &key[key_len], cov_data->subscriberProcessIdentifier);
+    key_len += snapshot_object_key(&key[key_len],
+        (BACNET_OBJECT_TYPE)cov_data->monitoredObjectIdentifier.type,
+        cov_data->monitoredObjectIdentifier.instance);
+    key_len += encode_unsigned32(&key[key_len], property);
+    key_len += encode_unsigned32(&key[key_len], array_index);
+
+    return key_len;
+}
+
+/**
+ * @brief Determine if a property is the commanded Present_Value of an
+ *  object with a Priority_Array
+ * @param object_type [in] type of the object
+ * @param object_instance [in] instance of the object
+ * @param object_property [in] the property
+ * @return true if the priority of a write is part of the change
+ */
+static bool snapshot_commandable(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    struct special_property_list_t property_list = { 0 };
+
+    if (object_property != PROP_PRESENT_VALUE) {
+        return false;
+    }
+    Device_Objects_Property_List(object_type, object_instance, &property_list);
+
+    return property_lists_member(property_list.Required.pList,
+        property_list.Optional.pList, property_list.Proprietary.pList,
+        PROP_PRIORITY_ARRAY);
+}
+
+/**
+ * @brief Record a WriteProperty of a local object that succeeded.  A
+ *  write of NULL to a commanded Present_Value relinquishes the priority,
+ *  and removes the write that it relinquished.
+ * @param wp_data [in] the WriteProperty data
+ */
+void snapshot_write_property(const BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    uint8_t key[SNAPSHOT_WRITE_KEY_SIZE];
+    uint8_t priority = BACNET_NO_PRIORITY;
+    BACNET_TAG tag = { 0 };
+    int len;
+
+    if (!Snapshot_Buffer || Snapshot_Restoring || !wp_data ||
+        (wp_data->application_data_len < 0) ||
+        (wp_data->application_data_len > UINT16_MAX)) {
+        return;
+    }
+    if (snapshot_commandable(wp_data->object_type, wp_data->object_instance,
+            wp_data->object_property)) {
+        priority = wp_data->priority;
+        if (priority == BACNET_NO_PRIORITY) {
+            priority = BACNET_MAX_PRIORITY;
+        }
+    }
+    snapshot_object_key(key, wp_data->object_type, wp_data->object_instance);
+    encode_unsigned32(&key[6], (uint32_t)wp_data->object_property);
+    encode_unsigned32(&key[10], wp_data->array_index);
+    key[14] = priority;
+    if (priority != BACNET_NO_PRIORITY) {
+        len = bacnet_tag_decode((uint8_t *)wp_data->application_data,
+            (uint32_t)wp_data->application_data_len, &tag);
+        if ((len > 0) && tag.application &&
+            (tag.number == BACNET_APPLICATION_TAG_NULL)) {
+            snapshot_remove(
+                SNAPSHOT_RECORD_WRITE_PROPERTY, key, sizeof(key));
+            return;
+        }
+    }
+    snapshot_set(SNAPSHOT_RECORD_WRITE_PROPERTY, key, sizeof(key),
+        wp_data->application_data, (uint16_t)wp_data->application_data_len);
+}
+
+/**
+ * @brief Record a CreateObject that succeeded
+ * @param object_type [in] type of the new object
+ * @param object_instance [in] instance of the new object
+ */
+void snapshot_create_object(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    uint8_t key[SNAPSHOT_OBJECT_KEY_SIZE];
+
+    if (!Snapshot_Buffer || Snapshot_Restoring) {
+        return;
+    }
+    snapshot_object_key(key, object_type, object_instance);
+    if (!snapshot_reserve(snapshot_record_length(sizeof(key), 0), false)) {
+        snapshot_incomplete();
+        return;
+    }
+    (void)snapshot_append(
+        SNAPSHOT_RECORD_CREATE_OBJECT, key, sizeof(key), NULL, 0);
+}
+
+/**
+ * @brief Record a DeleteObject that succeeded.  The writes to the object
+ *  are removed, and so is its CreateObject.  The deletion of an object
+ *  that was not created by CreateObject is recorded.
+ * @param object_type [in] type of the deleted object
+ * @param object_instance [in] instance of the deleted object
+ */
+void snapshot_delete_object(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    uint8_t key[SNAPSHOT_OBJECT_KEY_SIZE];
+    size_t offset = SNAPSHOT_HEADER_SIZE;
+    size_t end;
+    uint8_t *record;
+    unsigned slot;
+    bool created = false;
+    bool found = false;
+
+    if (!Snapshot_Buffer || Snapshot_Restoring) {
+        return;
+    }
+    snapshot_object_key(key, object_type, object_instance);
+    end = SNAPSHOT_HEADER_SIZE + Snapshot_Used;
+    while (offset < end) {
+        record = &Snapshot_Buffer[offset];
+        if ((record[1] == SNAPSHOT_RECORD_LIVE) &&
+            ((record[0] == SNAPSHOT_RECORD_WRITE_PROPERTY) ||
+                (record[0] == SNAPSHOT_RECORD_CREATE_OBJECT)) &&
+            (memcmp(snapshot_record_key(record), key, sizeof(key)) == 0)) {
+            if (record[0] == SNAPSHOT_RECORD_CREATE_OBJECT) {
+                created = true;
+                snapshot_record_kill(offset);
+            } else {
+                slot = snapshot_slot_find(record[0],
+                    snapshot_record_key(record),
+                    snapshot_record_key_len(record), &found);
+                snapshot_record_kill(offset);
+                if (found) {
+                    Snapshot_Index[slot] = SNAPSHOT_SLOT_DELETED;
+                }
+            }
+        }
+        offset += snapshot_record_length(snapshot_record_key_len(record),
+            snapshot_record_data_len(record));
+    }
+    if (created) {
+        return;
+    }
+    if (!snapshot_reserve(snapshot_record_length(sizeof(key), 0), false)) {
+        snapshot_incomplete();
+        return;
+    }
+    (void)snapshot_append(
+        SNAPSHOT_RECORD_DELETE_OBJECT, key, sizeof(key), NULL, 0);
+}
+
+/**
+ * @brief Record a SubscribeCOV or SubscribeCOVProperty that succeeded,
+ *  or the cancellation or expiry of a subscription
+ * @param src [in] address of the subscriber
+ * @param cov_data [in] the subscription
+ */
+void snapshot_subscribe_cov(
+    const BACNET_ADDRESS *src, const BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    uint8_t key[SNAPSHOT_COV_KEY_SIZE_MAX];
+    uint8_t data[SNAPSHOT_COV_DATA_SIZE];
+    uint8_t key_len;
+
+    if (!Snapshot_Buffer || Snapshot_Restoring || !src || !cov_data) {
+        return;
+    }
+    key_len = snapshot_cov_key(key, src, cov_data);
+    if (cov_data->cancellationRequest) {
+        snapshot_remove(SNAPSHOT_RECORD_SUBSCRIBE_COV, key, key_len);
+        return;
+    }
+    data[0] = 0;
+    if (cov_data->issueConfirmedNotifications) {
+        data[0] |= SNAPSHOT_COV_CONFIRMED;
+    }
+    if (cov_data->covSubscribeToProperty) {
+        data[0] |= SNAPSHOT_COV_PROPERTY;
+    }
+    if (cov_data->covIncrementPresent) {
+        data[0] |= SNAPSHOT_COV_INCREMENT;
+    }
+    encode_unsigned32(&data[1], cov_data->lifetime);
+    encode_bacnet_real(cov_data->covIncrement, &data[5]);
+    snapshot_set(
+        SNAPSHOT_RECORD_SUBSCRIBE_COV, key, key_len, data, sizeof(data));
+}
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @file
+ * @brief API for a snapshot of the object database of this device, kept
+ *  as a journal of the changes made to it, which is replayed after the
+ *  objects are initialized to restore their state.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_SNAPSHOT_H
+#define BACNET_BASIC_OBJECT_SNAPSHOT_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/cov.h"
+#include "bacnet/wp.h"
+
+/* octets of the header at the start of the snapshot buffer */
+#define SNAPSHOT_HEADER_SIZE 16
+
+/* number of slots of the index of the changed properties and COV
+   subscriptions - must be a power of two */
+#ifndef SNAPSHOT_INDEX_SIZE
+#define SNAPSHOT_INDEX_SIZE 1024
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool snapshot_init(uint8_t *buffer, size_t size);
+BACNET_STACK_EXPORT
+void snapshot_clear(void);
+BACNET_STACK_EXPORT
+int snapshot_restore(void);
+BACNET_STACK_EXPORT
+bool snapshot_complete(void);
+BACNET_STACK_EXPORT
+size_t snapshot_used(void);
+BACNET_STACK_EXPORT
+unsigned snapshot_record_count(void);
+BACNET_STACK_EXPORT
+bool snapshot_compact(void);
+BACNET_STACK_EXPORT
+bool snapshot_dirty(size_t *offset, size_t *length);
+BACNET_STACK_EXPORT
+unsigned snapshot_generation(void);
+
+#if BACNET_SNAPSHOT_ENABLED
+BACNET_STACK_EXPORT
+void snapshot_write_property(const BACNET_WRITE_PROPERTY_DATA *wp_data);
+BACNET_STACK_EXPORT
+void snapshot_create_object(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+void snapshot_delete_object(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+void snapshot_subscribe_cov(
+    const BACNET_ADDRESS *src, const BACNET_SUBSCRIBE_COV_DATA *cov_data);
+#else
+#define snapshot_write_property(wp_data) ((void)0)
+#define snapshot_create_object(object_type, object_instance) ((void)0)
+#define snapshot_delete_object(object_type, object_instance) ((void)0)
+#define snapshot_subscribe_cov(src, cov_data) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -29,6 +29,8 @@
 #include "bacnet/rp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
+#include "bacnet/basic/sys/static_pool.h"
 /* me! */
 #include "structured_view.h"
 
@@ -40,10 +42,32 @@ struct object_data {
     BACNET_SUBORDINATE_DATA *Subordinate_List;
     BACNET_RELATIONSHIP Default_Subordinate_Relationship;
     BACNET_DEVICE_OBJECT_REFERENCE Represents;
+    /* the Subordinate_List as an array, so that an element is found by
+       its index, with the encoded Object_Name of each subordinate that
+       is in this device */
+    struct subordinate_entry *Subordinate_Cache;
+    unsigned Subordinate_Cache_Size;
+    unsigned Subordinate_Count;
+    bool Subordinate_Cache_Valid;
+    uint8_t *Subordinate_Names;
+    size_t Subordinate_Names_Size;
+    bool Subordinate_Names_Valid;
+};
+
+/* the resolved data of one subordinate */
+struct subordinate_entry {
+    BACNET_SUBORDINATE_DATA *member;
+    /* encoded Object_Name, or a length of zero if it is not resolved */
+    size_t name_offset;
+    size_t name_length;
 };
 
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
+/* gets the Object_Name of a subordinate that is in this device */
+static structured_view_subordinate_name_function Subordinate_Name_Callback;
 
 /* clang-format off */
 /* These three arrays are used by the ReadPropertyMultiple handler */
@@ -368,6 +392,7 @@ void Structured_View_Subordinate_List_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Subordinate_List = subordinate_list;
+        pObject->Subordinate_Cache_Valid = false;
     }
 }
 
@@ -456,6 +481,175 @@ bool Structured_View_Represents_Set(
     return status;
 }
 
+/**
+ * @brief Build the array of the Subordinate_List of an object, if it is
+ *  stale
+ * @param pObject - object data
+ * @return true if the array of the Subordinate_List may be used
+ */
+static bool Subordinate_Cache_Update(struct object_data *pObject)
+{
+    struct subordinate_entry *entries;
+    BACNET_SUBORDINATE_DATA *member;
+    unsigned count = 0, i;
+
+    if (pObject->Subordinate_Cache_Valid) {
+        return true;
+    }
+    for (member = pObject->Subordinate_List; member; member = member->next) {
+        count++;
+    }
+    if (count > pObject->Subordinate_Cache_Size) {
+        entries = bacnet_realloc(
+            pObject->Subordinate_Cache, count * sizeof(*entries));
+        if (!entries) {
+            return false;
+        }
+        pObject->Subordinate_Cache = entries;
+        pObject->Subordinate_Cache_Size = count;
+    }
+    member = pObject->Subordinate_List;
+    for (i = 0; i < count; i++) {
+        pObject->Subordinate_Cache[i].member = member;
+        pObject->Subordinate_Cache[i].name_offset = 0;
+        pObject->Subordinate_Cache[i].name_length = 0;
+        member = member->next;
+    }
+    pObject->Subordinate_Count = count;
+    pObject->Subordinate_Cache_Valid = true;
+    pObject->Subordinate_Names_Valid = false;
+
+    return true;
+}
+
+/**
+ * @brief Encode the Object_Name of each subordinate of an object that is
+ *  in this device, if they are stale
+ * @param pObject - object data, with a valid array of the Subordinate_List
+ */
+static void Subordinate_Names_Update(struct object_data *pObject)
+{
+    BACNET_CHARACTER_STRING object_name;
+    struct subordinate_entry *entry;
+    BACNET_SUBORDINATE_DATA *member;
+    uint8_t *names;
+    size_t offset = 0, size;
+    unsigned i;
+    int len;
+    bool status = true;
+
+    if (pObject->Subordinate_Names_Valid) {
+        return;
+    }
+    for (i = 0; i < pObject->Subordinate_Count; i++) {
+        entry = &pObject->Subordinate_Cache[i];
+        member = entry->member;
+        entry->name_length = 0;
+        if (!Subordinate_Name_Callback ||
+            !Subordinate_Name_Callback(
+                member->Device_Instance, member->Object_Type,
+                member->Object_Instance, &object_name)) {
+            continue;
+        }
+        len = encode_application_character_string(NULL, &object_name);
+        if (len <= 0) {
+            continue;
+        }
+        if ((offset + len) > pObject->Subordinate_Names_Size) {
+            size = pObject->Subordinate_Names_Size * 2;
+            if (size < (offset + len)) {
+                size = offset + len;
+            }
+            names = bacnet_realloc(pObject->Subordinate_Names, size);
+            if (!names) {
+                /* try again at the next read */
+                status = false;
+                continue;
+            }
+            pObject->Subordinate_Names = names;
+            pObject->Subordinate_Names_Size = size;
+        }
+        len = encode_application_character_string(
+            &pObject->Subordinate_Names[offset], &object_name);
+        entry->name_offset = offset;
+        entry->name_length = (size_t)len;
+        offset += len;
+    }
+    pObject->Subordinate_Names_Valid = status;
+}
+
+/**
+ * @brief Free the array of the Subordinate_List of an object
+ * @param pObject - object data
+ */
+static void Subordinate_Cache_Cleanup(struct object_data *pObject)
+{
+    bacnet_free(pObject->Subordinate_Cache);
+    pObject->Subordinate_Cache = NULL;
+    pObject->Subordinate_Cache_Size = 0;
+    pObject->Subordinate_Count = 0;
+    pObject->Subordinate_Cache_Valid = false;
+    bacnet_free(pObject->Subordinate_Names);
+    pObject->Subordinate_Names = NULL;
+    pObject->Subordinate_Names_Size = 0;
+    pObject->Subordinate_Names_Valid = false;
+}
+
+/**
+ * @brief Drop the cached data of the subordinates that refer to an object,
+ *  after the Object_Name of the object has changed, so that it is read
+ *  again. Device_Object_Name_Index_Update() does this.
+ * @param object_type - object type of the object, or OBJECT_NONE for all
+ *  of the objects, such as after the database revision has changed
+ * @param object_instance - object-instance number of the object
+ */
+void Structured_View_Subordinate_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    struct object_data *pObject;
+    BACNET_SUBORDINATE_DATA *member;
+    int count, index;
+    unsigned i;
+
+    count = Keylist_Count(Object_List);
+    for (index = 0; index < count; index++) {
+        pObject = Keylist_Data_Index(Object_List, index);
+        if (!pObject) {
+            continue;
+        }
+        if (object_type == OBJECT_NONE) {
+            pObject->Subordinate_Cache_Valid = false;
+            continue;
+        }
+        if (!pObject->Subordinate_Cache_Valid ||
+            !pObject->Subordinate_Names_Valid) {
+            continue;
+        }
+        for (i = 0; i < pObject->Subordinate_Count; i++) {
+            member = pObject->Subordinate_Cache[i].member;
+            if ((member->Object_Type == object_type) &&
+                (member->Object_Instance == object_instance)) {
+                pObject->Subordinate_Names_Valid = false;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sets the callback that gets the Object_Name of a subordinate that
+ *  is in this device, which Subordinate_Annotations gives when the
+ *  subordinate has no annotation. Device_Init() sets it.
+ * @param cb - callback, or NULL to not give the names
+ */
+void Structured_View_Subordinate_Name_Callback_Set(
+    structured_view_subordinate_name_function cb)
+{
+    Subordinate_Name_Callback = cb;
+    Structured_View_Subordinate_Cache_Invalidate(
+        OBJECT_NONE, BACNET_MAX_INSTANCE);
+}
+
 /**
  * @brief For a given object instance-number, returns the number of
  * Subordinate_List elements
@@ -469,7 +663,9 @@ unsigned int Structured_View_Subordinate_List_Count(uint32_t object_instance)
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if (pObject) {
+    if (pObject && Subordinate_Cache_Update(pObject)) {
+        count = pObject->Subordinate_Count;
+    } else if (pObject) {
         subordinate_list = pObject->Subordinate_List;
         while (subordinate_list) {
             count++;
@@ -496,7 +692,11 @@ BACNET_SUBORDINATE_DATA *Structured_View_Subordinate_List_Member(
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if (pObject) {
+    if (pObject && Subordinate_Cache_Update(pObject)) {
+        if (array_index < pObject->Subordinate_Count) {
+            subordinate_list = pObject->Subordinate_Cache[array_index].member;
+        }
+    } else if (pObject) {
         subordinate_list = pObject->Subordinate_List;
         while (subordinate_list) {
             if (index == array_index) {
@@ -557,9 +757,27 @@ int Structured_View_Subordinate_Annotations_Element_Encode(
     int apdu_len = BACNET_STATUS_ERROR;
     BACNET_CHARACTER_STRING value = { 0 };
     BACNET_SUBORDINATE_DATA *subordinate_list = NULL;
+    struct subordinate_entry *entry;
+    struct object_data *pObject;
 
     subordinate_list =
         Structured_View_Subordinate_List_Member(object_instance, array_index);
+    if (subordinate_list && !subordinate_list->Annotations) {
+        /* the Object_Name of a subordinate in this device */
+        pObject = Keylist_Data(Object_List, object_instance);
+        if (pObject && pObject->Subordinate_Cache_Valid) {
+            Subordinate_Names_Update(pObject);
+            entry = &pObject->Subordinate_Cache[array_index];
+            if (entry->name_length > 0) {
+                if (apdu) {
+                    memcpy(
+                        apdu, &pObject->Subordinate_Names[entry->name_offset],
+                        entry->name_length);
+                }
+                return (int)entry->name_length;
+            }
+        }
+    }
     if (subordinate_list) {
         /* BACnetCharacterString */
         characterstring_init_ansi(&value, subordinate_list->Annotations);
@@ -623,6 +841,50 @@ int Structured_View_Subordinate_Relationships_Element_Encode(
     return apdu_len;
 }
 
+/**
+ * @brief Determine if a property can be read with ReadRange, so that the
+ *  subordinates of a large view are read in pages
+ * @param pRequest [in] the ReadRange request
+ * @param pInfo [out] the request types and the elements of the list
+ * @return true if the property can be read with ReadRange
+ */
+bool Structured_View_RR_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo)
+{
+    bacnet_array_property_element_encode_function encoder = NULL;
+
+    if (!Structured_View_Valid_Instance(pRequest->object_instance)) {
+        pRequest->error_class = ERROR_CLASS_OBJECT;
+        pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    switch (pRequest->object_property) {
+        case PROP_SUBORDINATE_LIST:
+            encoder = Structured_View_Subordinate_List_Element_Encode;
+            break;
+        case PROP_SUBORDINATE_ANNOTATIONS:
+            encoder = Structured_View_Subordinate_Annotations_Element_Encode;
+            break;
+        case PROP_SUBORDINATE_NODE_TYPES:
+            encoder = Structured_View_Subordinate_Node_Types_Element_Encode;
+            break;
+        case PROP_SUBORDINATE_RELATIONSHIPS:
+            encoder = Structured_View_Subordinate_Relationships_Element_Encode;
+            break;
+        default:
+            pRequest->error_class = ERROR_CLASS_SERVICES;
+            pRequest->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+            return false;
+    }
+    pInfo->RequestTypes = RR_BY_POSITION;
+    pInfo->Handler = NULL;
+    pInfo->Element_Encode = encoder;
+    pInfo->Element_Count =
+        Structured_View_Subordinate_List_Count(pRequest->object_instance);
+
+    return true;
+}
+
 /**
  * ReadProperty handler for this object.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -789,7 +1051,7 @@ uint32_t Structured_View_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (!pObject) {
             return BACNET_MAX_INSTANCE;
         }
@@ -806,7 +1068,7 @@ uint32_t Structured_View_Create(uint32_t object_instance)
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
-            free(pObject);
+            pool_free(&Object_Pool, pObject);
             return BACNET_MAX_INSTANCE;
         }
     }
@@ -814,6 +1076,30 @@ uint32_t Structured_View_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Structured View objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Structured_View_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Structured_View_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an Structured View object
  * @param object_instance - object-instance number of the object
@@ -826,7 +1112,8 @@ bool Structured_View_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        Subordinate_Cache_Cleanup(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -844,10 +1131,12 @@ void Structured_View_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                Subordinate_Cache_Cleanup(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -859,5 +1148,6 @@ void Structured_View_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
@@ -15,6 +15,7 @@
 #include "bacnet/bacerror.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/bacdevobjpropref.h"
+#include "bacnet/readrange.h"
 #include "bacnet/rp.h"
 
 struct BACnetSubordinateData;
@@ -29,6 +30,20 @@ typedef struct BACnetSubordinateData {
     struct BACnetSubordinateData *next;
 } BACNET_SUBORDINATE_DATA;
 
+/**
+ * @brief Callback to get the Object_Name of a subordinate
+ * @param device_instance - device instance of the subordinate
+ * @param object_type - object type of the subordinate
+ * @param object_instance - object-instance number of the subordinate
+ * @param object_name - the Object_Name of the subordinate
+ * @return true if the subordinate is in this device, and has a name
+ */
+typedef bool (*structured_view_subordinate_name_function)(
+    uint32_t device_instance,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_CHARACTER_STRING *object_name);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -53,6 +68,9 @@ bool Structured_View_Name_Set(uint32_t object_instance, char *new_name);
 
 BACNET_STACK_EXPORT
 int Structured_View_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool Structured_View_RR_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo);
 
 BACNET_STACK_EXPORT
 char *Structured_View_Description(uint32_t object_instance);
@@ -76,6 +94,17 @@ Structured_View_Subordinate_List(uint32_t object_instance);
 BACNET_STACK_EXPORT
 void Structured_View_Subordinate_List_Set(
     uint32_t object_instance, BACNET_SUBORDINATE_DATA *subordinate_list);
+BACNET_STACK_EXPORT
+unsigned int Structured_View_Subordinate_List_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+BACNET_SUBORDINATE_DATA *Structured_View_Subordinate_List_Member(
+    uint32_t object_instance, BACNET_ARRAY_INDEX array_index);
+BACNET_STACK_EXPORT
+void Structured_View_Subordinate_Name_Callback_Set(
+    structured_view_subordinate_name_function cb);
+BACNET_STACK_EXPORT
+void Structured_View_Subordinate_Cache_Invalidate(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
 
 BACNET_STACK_EXPORT
 BACNET_RELATIONSHIP
@@ -94,6 +123,8 @@ bool Structured_View_Represents_Set(
 BACNET_STACK_EXPORT
 uint32_t Structured_View_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+unsigned Structured_View_Create_Bulk(uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 bool Structured_View_Delete(uint32_t object_instance);
 
 BACNET_STACK_EXPORT
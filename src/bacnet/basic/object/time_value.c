@@ -30,6 +30,7 @@
 #include "bacnet/wp.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/pool.h"
 /* me! */
 #include "time_value.h"
 
@@ -44,6 +45,8 @@ struct object_data {
 
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* the memory of the objects, in slabs of many objects */
+static POOL_BUFFER Object_Pool;
 /* callback for present value writes */
 static time_value_write_present_value_callback
     Time_Value_Write_Present_Value_Callback;
@@ -175,14 +178,18 @@ bool Time_Value_Present_Value(uint32_t object_instance, BACNET_TIME *value)
 
 /**
  * @brief For a given object instance-number, checks the present-value for COV
+ * @param  object_instance - object-instance number of the object
  * @param  pObject - specific object with valid data
  * @param  value - floating point analog value
  */
 static void Time_Value_Present_Value_COV_Detect(
-    struct object_data *pObject, BACNET_TIME *value)
+    uint32_t object_instance, struct object_data *pObject, BACNET_TIME *value)
 {
     if (pObject && value) {
         if (datetime_compare_time(&pObject->Present_Value, value) != 0) {
+            if (!pObject->Change_Of_Value) {
+                handler_cov_object_changed(OBJECT_TIME_VALUE, object_instance);
+            }
             pObject->Change_Of_Value = true;
         }
     }
@@ -205,7 +212,8 @@ bool Time_Value_Present_Value_Set(uint32_t object_instance, BACNET_TIME *value)
     if (pObject) {
         if (!pObject->Out_Of_Service) {
             if (value) {
-                Time_Value_Present_Value_COV_Detect(pObject, value);
+                Time_Value_Present_Value_COV_Detect(
+                    object_instance, pObject, value);
                 datetime_copy_time(&pObject->Present_Value, value);
                 status = true;
             }
@@ -241,7 +249,8 @@ static bool Time_Value_Present_Value_Write(uint32_t object_instance,
         (void)priority;
         if (pObject->Write_Enabled) {
             datetime_copy_time(&old_value, &pObject->Present_Value);
-            Time_Value_Present_Value_COV_Detect(pObject, value);
+            Time_Value_Present_Value_COV_Detect(
+                object_instance, pObject, value);
             datetime_copy_time(&pObject->Present_Value, value);
             if (Time_Value_Write_Present_Value_Callback) {
                 Time_Value_Write_Present_Value_Callback(
@@ -743,7 +752,7 @@ uint32_t Time_Value_Create(uint32_t object_instance)
     }
     pObject = Keylist_Data(Object_List, object_instance);
     if (!pObject) {
-        pObject = calloc(1, sizeof(struct object_data));
+        pObject = pool_calloc(&Object_Pool);
         if (!pObject) {
             return BACNET_MAX_INSTANCE;
         }
@@ -755,7 +764,7 @@ uint32_t Time_Value_Create(uint32_t object_instance)
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
-            free(pObject);
+            pool_free(&Object_Pool, pObject);
             return BACNET_MAX_INSTANCE;
         }
     }
@@ -763,6 +772,30 @@ uint32_t Time_Value_Create(uint32_t object_instance)
     return object_instance;
 }
 
+/**
+ * @brief Creates a number of Time Value objects, with their memory
+ *  reserved at once, such as when provisioning many objects
+ * @param object_instance - object-instance number of the first object
+ * @param count - number of objects, with consecutive object-instances
+ * @return the number of objects that were created
+ */
+unsigned Time_Value_Create_Bulk(uint32_t object_instance, unsigned count)
+{
+    uint32_t instance;
+    unsigned i;
+
+    (void)pool_reserve(&Object_Pool, count);
+    for (i = 0; i < count; i++) {
+        instance = object_instance + i;
+        if ((instance >= BACNET_MAX_INSTANCE) ||
+            (Time_Value_Create(instance) != instance)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
 /**
  * Deletes an Time Value object
  * @param object_instance - object-instance number of the object
@@ -775,7 +808,7 @@ bool Time_Value_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
-        free(pObject);
+        pool_free(&Object_Pool, pObject);
         status = true;
     }
 
@@ -793,10 +826,11 @@ void Time_Value_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
-                free(pObject);
+                pool_free(&Object_Pool, pObject);
             }
         } while (pObject);
         Keylist_Delete(Object_List);
+        pool_cleanup(&Object_Pool);
         Object_List = NULL;
     }
 }
@@ -808,5 +842,6 @@ void Time_Value_Init(void)
 {
     if (!Object_List) {
         Object_List = Keylist_Create();
+        pool_init(&Object_Pool, sizeof(struct object_data), 0);
     }
 }
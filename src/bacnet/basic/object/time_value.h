@@ -97,6 +97,8 @@ void Time_Value_Change_Of_Value_Clear(
 BACNET_STACK_EXPORT
 uint32_t Time_Value_Create(uint32_t object_instance);
 BACNET_STACK_EXPORT
+unsigned Time_Value_Create_Bulk(uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 bool Time_Value_Delete(uint32_t object_instance);
 
 BACNET_STACK_EXPORT
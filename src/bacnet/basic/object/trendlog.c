@@ -7,6 +7,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <limits.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -22,6 +23,8 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/binding/address.h"
 #include "bacnet/basic/object/trendlog.h"
+#include "bacnet/basic/object/trendlog_block.h"
+#include "bacnet/basic/sys/memstats.h"
 #include "bacnet/datalink/datalink.h"
 #if defined(BACFILE)
 #include "bacnet/basic/object/bacfile.h" /* object list dependency */
@@ -34,6 +37,10 @@
 
 static TL_DATA_REC Logs[MAX_TREND_LOGS][TL_MAX_ENTRIES];
 static TL_LOG_INFO LogInfo[MAX_TREND_LOGS];
+/* logs with test records that are not filled in yet */
+static bool Logs_Pending[MAX_TREND_LOGS];
+
+static void TL_COV_Unsubscribe(int iLog);
 
 /* These three arrays are used by the ReadPropertyMultiple handler */
 static const int Trend_Log_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
@@ -133,6 +140,125 @@ static bacnet_time_t Trend_Log_Epoch_Seconds_Now(void)
     return datetime_seconds_since_epoch(&bdatetime);
 }
 
+/**
+ * @brief Fill the RAM buffer of a trend log with the records for testing.
+ *  The records are filled when the log is first used rather than in
+ *  Trend_Log_Init(), which keeps them out of the startup time.
+ * @param CurrentLog [in] the trend log
+ */
+static void TL_Records_Load(const TL_LOG_INFO *CurrentLog)
+{
+    unsigned iLog = (unsigned)(CurrentLog - &LogInfo[0]);
+    unsigned iEntry;
+    BACNET_DATE_TIME bdatetime = { 0 };
+    bacnet_time_t tClock;
+
+    if ((iLog >= MAX_TREND_LOGS) || !Logs_Pending[iLog]) {
+        return;
+    }
+    Logs_Pending[iLog] = false;
+    /* Different month for each log */
+    datetime_set_values(&bdatetime, 2009, iLog + 1, 1, 0, 0, 0, 0);
+    tClock = datetime_seconds_since_epoch(&bdatetime);
+    for (iEntry = 0; iEntry < TL_MAX_ENTRIES; iEntry++) {
+        Logs[iLog][iEntry].tTimeStamp = tClock;
+        Logs[iLog][iEntry].ucRecType = TL_TYPE_REAL;
+        Logs[iLog][iEntry].Datum.fReal =
+            (float)(iEntry + (iLog * TL_MAX_ENTRIES));
+        /* Put status flags with every second log */
+        if ((iLog & 1) == 0) {
+            Logs[iLog][iEntry].ucStatus = 128;
+        } else {
+            Logs[iLog][iEntry].ucStatus = 0;
+        }
+        /* advance 15 minutes, in seconds */
+        tClock += 900;
+    }
+}
+
+/**
+ * @brief Get a record of a trend log from its position in the log
+ * @param CurrentLog [in] the trend log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest record
+ * @return the record in the circular buffer
+ */
+static TL_DATA_REC *TL_Entry(const TL_LOG_INFO *CurrentLog, uint32_t uiEntry)
+{
+    uint32_t uiOldest = 0;
+
+    if (CurrentLog->pBlocks) {
+        return TL_Block_Entry(CurrentLog->pBlocks, uiEntry);
+    }
+    TL_Records_Load(CurrentLog);
+    if (CurrentLog->ulRecordCount >= CurrentLog->ulBufferSize) {
+        uiOldest = (uint32_t)CurrentLog->iIndex;
+    }
+
+    return &CurrentLog->pRecords[(uiOldest + uiEntry - 1) %
+        CurrentLog->ulBufferSize];
+}
+
+/**
+ * @brief Count the newest records of a trend log that are in time order,
+ *  such as after the records were recovered from storage
+ * @param CurrentLog [in] the trend log
+ * @return number of records, from the newest back, in time order
+ */
+static uint32_t TL_Ordered_Count(const TL_LOG_INFO *CurrentLog)
+{
+    uint32_t uiEntry;
+
+    bacnet_time_t tTimeStamp;
+
+    if (CurrentLog->ulRecordCount == 0) {
+        return 0;
+    }
+    tTimeStamp = TL_Entry(CurrentLog, CurrentLog->ulRecordCount)->tTimeStamp;
+    for (uiEntry = CurrentLog->ulRecordCount; uiEntry > 1; uiEntry--) {
+        if (TL_Entry(CurrentLog, uiEntry - 1)->tTimeStamp > tTimeStamp) {
+            break;
+        }
+        tTimeStamp = TL_Entry(CurrentLog, uiEntry - 1)->tTimeStamp;
+    }
+
+    return CurrentLog->ulRecordCount - uiEntry + 1;
+}
+
+/**
+ * @brief Check if a trend log has no room for another record without
+ *  losing the oldest records
+ * @param CurrentLog [in] the trend log
+ * @return true if the log is full
+ */
+static bool TL_Is_Full(const TL_LOG_INFO *CurrentLog)
+{
+    if (CurrentLog->pBlocks) {
+        return TL_Block_Full(CurrentLog->pBlocks);
+    }
+
+    return (CurrentLog->ulRecordCount == CurrentLog->ulBufferSize);
+}
+
+/**
+ * @brief Remove all the records from a trend log
+ * @param CurrentLog [in] the trend log
+ */
+static void TL_Clear(TL_LOG_INFO *CurrentLog)
+{
+    unsigned iLog = (unsigned)(CurrentLog - &LogInfo[0]);
+
+    if (iLog < MAX_TREND_LOGS) {
+        /* the test records are not needed any more */
+        Logs_Pending[iLog] = false;
+    }
+    CurrentLog->ulRecordCount = 0;
+    CurrentLog->iIndex = 0;
+    CurrentLog->ulOrderedCount = 0;
+    if (CurrentLog->pBlocks) {
+        TL_Block_Clear(CurrentLog->pBlocks);
+    }
+}
+
 /*
  * Things to do when starting up the stack for Trend Logs.
  * Should be called whenever we reset the device or power it up
@@ -141,13 +267,14 @@ void Trend_Log_Init(void)
 {
     static bool initialized = false;
     int iLog;
-    int iEntry;
     BACNET_DATE_TIME bdatetime = { 0 };
     bacnet_time_t tClock;
     uint8_t month;
 
     if (!initialized) {
         initialized = true;
+        bacnet_memstats_static(
+            MEMSTATS_TREND_LOG, sizeof(Logs) + sizeof(LogInfo));
 
         /* initialize all the values */
 
@@ -165,27 +292,20 @@ void Trend_Log_Init(void)
              */
 
             /* We will just fill the logs with some entries for testing
-             * purposes.
+             * purposes, when each log is first used.
              */
             /* Different month for each log */
             month = iLog + 1;
             datetime_set_values(&bdatetime, 2009, month, 1, 0, 0, 0, 0);
             tClock = datetime_seconds_since_epoch(&bdatetime);
-            for (iEntry = 0; iEntry < TL_MAX_ENTRIES; iEntry++) {
-                Logs[iLog][iEntry].tTimeStamp = tClock;
-                Logs[iLog][iEntry].ucRecType = TL_TYPE_REAL;
-                Logs[iLog][iEntry].Datum.fReal =
-                    (float)(iEntry + (iLog * TL_MAX_ENTRIES));
-                /* Put status flags with every second log */
-                if ((iLog & 1) == 0) {
-                    Logs[iLog][iEntry].ucStatus = 128;
-                } else {
-                    Logs[iLog][iEntry].ucStatus = 0;
-                }
-                /* advance 15 minutes, in seconds */
-                tClock += 900;
-            }
-
+            /* time of the last of the test records, 15 minutes apart */
+            tClock += (bacnet_time_t)900 * TL_MAX_ENTRIES;
+            Logs_Pending[iLog] = true;
+
+            LogInfo[iLog].pRecords = &Logs[iLog][0];
+            LogInfo[iLog].ulBufferSize = TL_MAX_ENTRIES;
+            LogInfo[iLog].pRing = NULL;
+            LogInfo[iLog].pBlocks = NULL;
             LogInfo[iLog].tLastDataTime = tClock - 900;
             LogInfo[iLog].bAlignIntervals = true;
             LogInfo[iLog].bEnable = true;
@@ -199,6 +319,7 @@ void Trend_Log_Init(void)
             LogInfo[iLog].ulLogInterval = 900;
             LogInfo[iLog].ulRecordCount = TL_MAX_ENTRIES;
             LogInfo[iLog].ulTotalRecordCount = 10000;
+            LogInfo[iLog].ulOrderedCount = TL_MAX_ENTRIES;
 
             LogInfo[iLog].Source.deviceIdentifier.instance =
                 Device_Object_Instance_Number();
@@ -222,6 +343,130 @@ void Trend_Log_Init(void)
     return;
 }
 
+/**
+ * @brief Set the storage for the records of a trend log, such as a buffer
+ *  in battery backed RAM or in a memory mapped file. When a stored copy of
+ *  the buffer state is given and is valid for the buffer, the log carries
+ *  on from that state after a log-interrupted record, otherwise the log
+ *  starts out empty. Call after Trend_Log_Init().
+ * @param object_instance [in] BACnet object instance number
+ * @param pRecords [in] buffer of records, or NULL for the RAM buffer
+ * @param ulBufferSize [in] number of records in the buffer
+ * @param pRing [in] stored copy of the buffer state, or NULL
+ * @return true if the storage was set
+ */
+bool Trend_Log_Buffer_Set(uint32_t object_instance,
+    TL_DATA_REC *pRecords,
+    uint32_t ulBufferSize,
+    TL_LOG_RING *pRing)
+{
+    TL_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOGS) {
+        return false;
+    }
+    if (!pRecords) {
+        pRecords = &Logs[log_index][0];
+        ulBufferSize = TL_MAX_ENTRIES;
+        pRing = NULL;
+    }
+    if ((ulBufferSize == 0) || (ulBufferSize > INT_MAX)) {
+        return false;
+    }
+    CurrentLog = &LogInfo[log_index];
+    /* the test records are not needed with the new storage */
+    Logs_Pending[log_index] = false;
+    CurrentLog->pRecords = pRecords;
+    CurrentLog->ulBufferSize = ulBufferSize;
+    CurrentLog->pRing = pRing;
+    CurrentLog->pBlocks = NULL;
+    if (pRing && (pRing->ulIndex < ulBufferSize) &&
+        (pRing->ulRecordCount <= ulBufferSize) &&
+        (pRing->ulRecordCount <= pRing->ulTotalRecordCount) &&
+        ((pRing->ulRecordCount == ulBufferSize) ||
+            (pRing->ulIndex == pRing->ulRecordCount))) {
+        /* recover the log from the stored state */
+        CurrentLog->iIndex = (int)pRing->ulIndex;
+        CurrentLog->ulRecordCount = pRing->ulRecordCount;
+        CurrentLog->ulTotalRecordCount = pRing->ulTotalRecordCount;
+        CurrentLog->ulOrderedCount = TL_Ordered_Count(CurrentLog);
+        if (pRing->ulRecordCount > 0) {
+            CurrentLog->tLastDataTime =
+                pRecords[(pRing->ulIndex + ulBufferSize - 1) % ulBufferSize]
+                    .tTimeStamp;
+            /* readings may have been missed while we were not running */
+            TL_Insert_Status_Rec(
+                (int)log_index, LOG_STATUS_LOG_INTERRUPTED, true);
+        }
+    } else {
+        CurrentLog->iIndex = 0;
+        CurrentLog->ulRecordCount = 0;
+        CurrentLog->ulTotalRecordCount = 0;
+        CurrentLog->ulOrderedCount = 0;
+        if (pRing) {
+            pRing->ulIndex = 0;
+            pRing->ulRecordCount = 0;
+            pRing->ulTotalRecordCount = 0;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Store the records of a trend log compressed in a ring of blocks,
+ *  which holds many more records for logs that are sampled at a fixed
+ *  interval and change slowly. The log starts out empty, and the oldest
+ *  block of records is dropped when the ring is full.
+ *  Call after Trend_Log_Init().
+ * @param object_instance [in] BACnet object instance number
+ * @param pBlocks [in] ring of blocks initialized by TL_Block_Init(),
+ *  or NULL for the RAM buffer
+ * @return true if the storage was set
+ */
+bool Trend_Log_Block_Buffer_Set(
+    uint32_t object_instance, struct tl_block_log *pBlocks)
+{
+    TL_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    if (!pBlocks) {
+        return Trend_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    }
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    if ((log_index >= MAX_TREND_LOGS) || (TL_Block_Size(pBlocks) == 0)) {
+        return false;
+    }
+    CurrentLog = &LogInfo[log_index];
+    CurrentLog->pRecords = &Logs[log_index][0];
+    CurrentLog->ulBufferSize = TL_Block_Size(pBlocks);
+    CurrentLog->pRing = NULL;
+    CurrentLog->pBlocks = pBlocks;
+    TL_Clear(CurrentLog);
+    CurrentLog->ulTotalRecordCount = 0;
+
+    return true;
+}
+
+/**
+ * @brief Get the number of records that the buffer of a trend log holds
+ * @param object_instance [in] BACnet object instance number
+ * @return number of records, or 0 if the object instance is not valid
+ */
+uint32_t Trend_Log_Buffer_Size(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOGS) {
+        return 0;
+    }
+
+    return LogInfo[log_index].ulBufferSize;
+}
+
 /*
  * Note: we use the instance number here and build the name based
  * on the assumption that there is a 1 to 1 correspondence. If there
@@ -288,7 +533,8 @@ int Trend_Log_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
             break;
 
         case PROP_BUFFER_SIZE:
-            apdu_len = encode_application_unsigned(&apdu[0], TL_MAX_ENTRIES);
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulBufferSize);
             break;
 
         case PROP_LOG_BUFFER:
@@ -448,7 +694,7 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                  * set */
                 if ((CurrentLog->bEnable == false) &&
                     (CurrentLog->bStopWhenFull == true) &&
-                    (CurrentLog->ulRecordCount == TL_MAX_ENTRIES) &&
+                    TL_Is_Full(CurrentLog) &&
                     (value.type.Boolean == true)) {
                     status = false;
                     wp_data->error_class = ERROR_CLASS_OBJECT;
@@ -491,7 +737,7 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     CurrentLog->bStopWhenFull = value.type.Boolean;
 
                     if ((value.type.Boolean == true) &&
-                        (CurrentLog->ulRecordCount == TL_MAX_ENTRIES) &&
+                        TL_Is_Full(CurrentLog) &&
                         (CurrentLog->bEnable == true)) {
                         /* When full log is switched from normal to stop when
                          * full disable the log and record the fact - see
@@ -520,8 +766,7 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             if (status) {
                 if (value.type.Unsigned_Int == 0) {
                     /* Time to clear down the log */
-                    CurrentLog->ulRecordCount = 0;
-                    CurrentLog->iIndex = 0;
+                    TL_Clear(CurrentLog);
                     TL_Insert_Status_Rec(
                         log_index, LOG_STATUS_BUFFER_PURGED, true);
                 }
@@ -530,12 +775,23 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 
         case PROP_LOGGING_TYPE:
             /* logic
-             * triggered and polled options.
+             * triggered, polled and COV options.
              */
             status = write_property_type_valid(
                 wp_data, &value, BACNET_APPLICATION_TAG_ENUMERATED);
             if (status) {
-                if (value.type.Enumerated != LOGGING_TYPE_COV) {
+                if ((value.type.Enumerated == LOGGING_TYPE_COV) &&
+                    !Device_Value_List_Supported(
+                        CurrentLog->Source.objectIdentifier.type)) {
+                    /* We only support COV for local objects that have it */
+                    status = false;
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code =
+                        ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+                } else {
+                    if (CurrentLog->LoggingType == LOGGING_TYPE_COV) {
+                        TL_COV_Unsubscribe(log_index);
+                    }
                     CurrentLog->LoggingType =
                         (BACNET_LOGGING_TYPE)value.type.Enumerated;
                     if (value.type.Enumerated == LOGGING_TYPE_POLLED) {
@@ -545,17 +801,12 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                             CurrentLog->ulLogInterval = 900;
                         }
                     }
-                    if (value.type.Enumerated == LOGGING_TYPE_TRIGGERED) {
-                        /* As per 12.25.27 0 the interval if triggered logging
-                         * selected */
+                    if ((value.type.Enumerated == LOGGING_TYPE_TRIGGERED) ||
+                        (value.type.Enumerated == LOGGING_TYPE_COV)) {
+                        /* As per 12.25.27 0 the interval if triggered or COV
+                         * logging selected */
                         CurrentLog->ulLogInterval = 0;
                     }
-                } else {
-                    /* We don't currently support COV */
-                    status = false;
-                    wp_data->error_class = ERROR_CLASS_PROPERTY;
-                    wp_data->error_code =
-                        ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
                 }
             }
             break;
@@ -685,8 +936,10 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             if (memcmp(&TempSource, &CurrentLog->Source,
                     sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE)) != 0) {
                 /* Clear buffer if property being logged is changed */
-                CurrentLog->ulRecordCount = 0;
-                CurrentLog->iIndex = 0;
+                if (CurrentLog->LoggingType == LOGGING_TYPE_COV) {
+                    TL_COV_Unsubscribe(log_index);
+                }
+                TL_Clear(CurrentLog);
                 TL_Insert_Status_Rec(log_index, LOG_STATUS_BUFFER_PURGED, true);
             }
             CurrentLog->Source = TempSource;
@@ -694,8 +947,10 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             break;
 
         case PROP_LOG_INTERVAL:
-            if (CurrentLog->LoggingType == LOGGING_TYPE_TRIGGERED) {
-                /* Read only if triggered log so flag error and bail out */
+            if ((CurrentLog->LoggingType == LOGGING_TYPE_TRIGGERED) ||
+                (CurrentLog->LoggingType == LOGGING_TYPE_COV)) {
+                /* Read only if triggered or COV log so flag error and bail
+                 * out */
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
                 wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
                 break;
@@ -705,9 +960,9 @@ bool Trend_Log_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             if (status) {
                 if ((CurrentLog->LoggingType == LOGGING_TYPE_POLLED) &&
                     (value.type.Unsigned_Int == 0)) {
-                    /* We don't support COV at the moment so don't allow
-                     * switching to it by clearing interval whilst in polling
-                     * mode */
+                    /* Don't allow switching to COV by clearing the interval
+                     * whilst in polling mode, COV is selected with the
+                     * Logging_Type */
                     wp_data->error_class = ERROR_CLASS_PROPERTY;
                     wp_data->error_code =
                         ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
@@ -794,6 +1049,54 @@ bool TrendLogGetRRInfo(
     return (false);
 }
 
+/*****************************************************************************
+ * Insert a record into the circular buffer of a trend log, and keep the     *
+ * stored copy of the buffer state up to date if the log has one.            *
+ *****************************************************************************/
+
+static void TL_Insert_Rec(TL_LOG_INFO *CurrentLog, TL_DATA_REC *pRec)
+{
+    /* track the run of newest records in time order for TL_encode_by_time */
+    if ((CurrentLog->ulRecordCount == 0) ||
+        (pRec->tTimeStamp <
+            TL_Entry(CurrentLog, CurrentLog->ulRecordCount)->tTimeStamp)) {
+        CurrentLog->ulOrderedCount = 1;
+    } else {
+        CurrentLog->ulOrderedCount++;
+    }
+    if (CurrentLog->pBlocks) {
+        (void)TL_Block_Insert(CurrentLog->pBlocks, pRec);
+        CurrentLog->ulTotalRecordCount++;
+        /* the oldest block of records is dropped when the ring is full */
+        CurrentLog->ulRecordCount = TL_Block_Count(CurrentLog->pBlocks);
+        if (CurrentLog->ulOrderedCount > CurrentLog->ulRecordCount) {
+            CurrentLog->ulOrderedCount = CurrentLog->ulRecordCount;
+        }
+        return;
+    }
+    TL_Records_Load(CurrentLog);
+    CurrentLog->pRecords[CurrentLog->iIndex++] = *pRec;
+    if ((uint32_t)CurrentLog->iIndex >= CurrentLog->ulBufferSize) {
+        CurrentLog->iIndex = 0;
+    }
+
+    CurrentLog->ulTotalRecordCount++;
+
+    if (CurrentLog->ulRecordCount < CurrentLog->ulBufferSize) {
+        CurrentLog->ulRecordCount++;
+    }
+    if (CurrentLog->ulOrderedCount > CurrentLog->ulRecordCount) {
+        CurrentLog->ulOrderedCount = CurrentLog->ulRecordCount;
+    }
+    if (CurrentLog->pRing) {
+        /* the record is in place before the state which refers to it */
+        CurrentLog->pRing->ulIndex = (uint32_t)CurrentLog->iIndex;
+        CurrentLog->pRing->ulRecordCount = CurrentLog->ulRecordCount;
+        CurrentLog->pRing->ulTotalRecordCount =
+            CurrentLog->ulTotalRecordCount;
+    }
+}
+
 /*****************************************************************************
  * Insert a status record into a trend log - does not check for enable/log   *
  * full, time slots and so on as these type of entries have to go in         *
@@ -832,16 +1135,7 @@ void TL_Insert_Status_Rec(int iLog, BACNET_LOG_STATUS eStatus, bool bState)
             break;
     }
 
-    Logs[iLog][CurrentLog->iIndex++] = TempRec;
-    if (CurrentLog->iIndex >= TL_MAX_ENTRIES) {
-        CurrentLog->iIndex = 0;
-    }
-
-    CurrentLog->ulTotalRecordCount++;
-
-    if (CurrentLog->ulRecordCount < TL_MAX_ENTRIES) {
-        CurrentLog->ulRecordCount++;
-    }
+    TL_Insert_Rec(CurrentLog, &TempRec);
 }
 
 /*****************************************************************************
@@ -945,7 +1239,82 @@ void TL_Local_Time_To_BAC(BACNET_DATE_TIME *bdatetime, bacnet_time_t seconds)
 
 #define TL_MAX_ENC 23 /* Maximum size of encoded log entry, see above */
 
+static int TL_Range_By_Position(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    const TL_RANGE_LOG *pRange);
+static int TL_Range_By_Sequence(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    const TL_RANGE_LOG *pRange);
+static int TL_Range_By_Time(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    const TL_RANGE_LOG *pRange);
+
+/**
+ * @brief Get the timestamp of a record of a trend log
+ * @param pLog [in] the trend log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest record
+ * @return timestamp of the record
+ */
+static bacnet_time_t TL_Range_Time_Stamp(const void *pLog, uint32_t uiEntry)
+{
+    return TL_Entry((const TL_LOG_INFO *)pLog, uiEntry)->tTimeStamp;
+}
+
+/**
+ * @brief Encode a record of a trend log as a BACnetLogRecord
+ * @param apdu [out] buffer for the record
+ * @param pLog [in] the trend log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest record
+ * @return number of bytes encoded
+ */
+static int TL_Range_Encode_Entry(
+    uint8_t *apdu, const void *pLog, uint32_t uiEntry)
+{
+    return TL_encode_entry(apdu,
+        (int)((const TL_LOG_INFO *)pLog - &LogInfo[0]), (int)uiEntry);
+}
+
+/**
+ * @brief Describe the records of a trend log for TL_Range_Encode()
+ * @param pRange [out] the records of the log
+ * @param object_instance [in] BACnet object instance number of the log
+ */
+static void TL_Range_Init(TL_RANGE_LOG *pRange, uint32_t object_instance)
+{
+    const TL_LOG_INFO *pInfo;
+
+    pInfo = &LogInfo[Trend_Log_Instance_To_Index(object_instance)];
+    pRange->pLog = pInfo;
+    pRange->ulRecordCount = pInfo->ulRecordCount;
+    pRange->ulTotalRecordCount = pInfo->ulTotalRecordCount;
+    pRange->ulOrderedCount = pInfo->ulOrderedCount;
+    pRange->ulMaxEncoded = TL_MAX_ENC;
+    pRange->Time_Stamp = TL_Range_Time_Stamp;
+    pRange->Encode = TL_Range_Encode_Entry;
+}
+
 int rr_trend_log_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    TL_RANGE_LOG Range;
+
+    TL_Range_Init(&Range, pRequest->object_instance);
+
+    return TL_Range_Encode(apdu, pRequest, &Range);
+}
+
+/**
+ * @brief Encode the records of a log for a ReadRange request by position,
+ *  by sequence number or by time, as many as fit into the APDU. This is
+ *  shared by the Trend Log and Event Log objects.
+ * @param apdu [out] buffer for the list of records
+ * @param pRequest [in,out] the request, and the result flags, item count
+ *  and first sequence number of the response
+ * @param pRange [in] the records of the log
+ * @return number of bytes encoded
+ */
+int TL_Range_Encode(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    const TL_RANGE_LOG *pRange)
 {
     /* Initialise result flags to all false */
     bitstring_init(&pRequest->ResultFlags);
@@ -955,19 +1324,18 @@ int rr_trend_log_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     pRequest->ItemCount = 0; /* Start out with nothing */
 
     /* Bail out now if nowt - should never happen for a Trend Log but ... */
-    if (LogInfo[Trend_Log_Instance_To_Index(pRequest->object_instance)]
-            .ulRecordCount == 0) {
+    if (pRange->ulRecordCount == 0) {
         return (0);
     }
 
     if ((pRequest->RequestType == RR_BY_POSITION) ||
         (pRequest->RequestType == RR_READ_ALL)) {
-        return (TL_encode_by_position(apdu, pRequest));
+        return (TL_Range_By_Position(apdu, pRequest, pRange));
     } else if (pRequest->RequestType == RR_BY_SEQUENCE) {
-        return (TL_encode_by_sequence(apdu, pRequest));
+        return (TL_Range_By_Sequence(apdu, pRequest, pRange));
     }
 
-    return (TL_encode_by_time(apdu, pRequest));
+    return (TL_Range_By_Time(apdu, pRequest, pRange));
 }
 
 /****************************************************************************
@@ -978,10 +1346,19 @@ int rr_trend_log_encode(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 
 int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 {
-    int log_index = 0;
+    TL_RANGE_LOG Range;
+
+    TL_Range_Init(&Range, pRequest->object_instance);
+
+    return TL_Range_By_Position(apdu, pRequest, &Range);
+}
+
+static int TL_Range_By_Position(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    const TL_RANGE_LOG *pRange)
+{
     int iLen = 0;
     int32_t iTemp = 0;
-    TL_LOG_INFO *CurrentLog = NULL;
 
     uint32_t uiIndex = 0; /* Current entry number */
     uint32_t uiFirst = 0; /* Entry number we started encoding from */
@@ -991,15 +1368,13 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 
     /* See how much space we have */
     uiRemaining = MAX_APDU - pRequest->Overhead;
-    log_index = Trend_Log_Instance_To_Index(pRequest->object_instance);
-    CurrentLog = &LogInfo[log_index];
     if (pRequest->RequestType == RR_READ_ALL) {
         /*
          * Read all the list or as much as will fit in the buffer by selecting
          * a range that covers the whole list and falling through to the next
          * section of code
          */
-        pRequest->Count = CurrentLog->ulRecordCount; /* Full list */
+        pRequest->Count = pRange->ulRecordCount; /* Full list */
         pRequest->Range.RefIndex = 1; /* Starting at the beginning */
     }
 
@@ -1034,7 +1409,7 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     /* From here on in we only have a starting point and a positive count */
 
     if (pRequest->Range.RefIndex >
-        CurrentLog->ulRecordCount) { /* Nothing to return as we are past the end
+        pRange->ulRecordCount) { /* Nothing to return as we are past the end
                                       of the list */
         return (0);
     }
@@ -1042,14 +1417,14 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     uiTarget = pRequest->Range.RefIndex + pRequest->Count -
         1; /* Index of last required entry */
     if (uiTarget >
-        CurrentLog->ulRecordCount) { /* Capped at end of list if necessary */
-        uiTarget = CurrentLog->ulRecordCount;
+        pRange->ulRecordCount) { /* Capped at end of list if necessary */
+        uiTarget = pRange->ulRecordCount;
     }
 
     uiIndex = pRequest->Range.RefIndex;
     uiFirst = uiIndex; /* Record where we started from */
     while (uiIndex <= uiTarget) {
-        if (uiRemaining < TL_MAX_ENC) {
+        if (uiRemaining < pRange->ulMaxEncoded) {
             /*
              * Can't fit any more in! We just set the result flag to say there
              * was more and drop out of the loop early
@@ -1059,7 +1434,7 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
             break;
         }
 
-        iTemp = TL_encode_entry(&apdu[iLen], log_index, uiIndex);
+        iTemp = pRange->Encode(&apdu[iLen], pRange->pLog, uiIndex);
 
         uiRemaining -= iTemp; /* Reduce the remaining space */
         iLen += iTemp; /* and increase the length consumed */
@@ -1073,7 +1448,7 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
     }
 
-    if (uiLast == CurrentLog->ulRecordCount) {
+    if (uiLast == pRange->ulRecordCount) {
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
     }
 
@@ -1089,10 +1464,19 @@ int TL_encode_by_position(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 
 int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 {
-    int log_index = 0;
+    TL_RANGE_LOG Range;
+
+    TL_Range_Init(&Range, pRequest->object_instance);
+
+    return TL_Range_By_Sequence(apdu, pRequest, &Range);
+}
+
+static int TL_Range_By_Sequence(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    const TL_RANGE_LOG *pRange)
+{
     int iLen = 0;
     int32_t iTemp = 0;
-    TL_LOG_INFO *CurrentLog = NULL;
 
     uint32_t uiIndex = 0; /* Current entry number */
     uint32_t uiFirst = 0; /* Entry number we started encoding from */
@@ -1110,12 +1494,13 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 
     /* See how much space we have */
     uiRemaining = MAX_APDU - pRequest->Overhead;
-    log_index = Trend_Log_Instance_To_Index(pRequest->object_instance);
-    CurrentLog = &LogInfo[log_index];
+    if (pRange->ulRecordCount == 0) {
+        return (0);
+    }
     /* Figure out the sequence number for the first record, last is
      * ulTotalRecordCount */
     uiFirstSeq =
-        CurrentLog->ulTotalRecordCount - (CurrentLog->ulRecordCount - 1);
+        pRange->ulTotalRecordCount - (pRange->ulRecordCount - 1);
 
     /* Calculate start and end sequence numbers from request */
     if (pRequest->Count < 0) {
@@ -1129,14 +1514,14 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     if (uiBegin > uiEnd) {
         bWrapReq = true;
     }
-    if (uiFirstSeq > CurrentLog->ulTotalRecordCount) {
+    if (uiFirstSeq > pRange->ulTotalRecordCount) {
         bWrapLog = true;
     }
 
     if ((bWrapReq == false) && (bWrapLog == false)) { /* Simple case no wraps */
         /* If no overlap between request range and buffer contents bail out */
         if ((uiEnd < uiFirstSeq) ||
-            (uiBegin > CurrentLog->ulTotalRecordCount)) {
+            (uiBegin > pRange->ulTotalRecordCount)) {
             return (0);
         }
 
@@ -1148,36 +1533,36 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
             uiBegin = uiFirstSeq;
         }
 
-        if (uiEnd > CurrentLog->ulTotalRecordCount) {
-            uiEnd = CurrentLog->ulTotalRecordCount;
+        if (uiEnd > pRange->ulTotalRecordCount) {
+            uiEnd = pRange->ulTotalRecordCount;
         }
     } else { /* There are wrap arounds to contend with */
         /* First check for non overlap condition as it is common to all */
-        if ((uiBegin > CurrentLog->ulTotalRecordCount) &&
+        if ((uiBegin > pRange->ulTotalRecordCount) &&
             (uiEnd < uiFirstSeq)) {
             return (0);
         }
 
         if (bWrapLog == false) { /* Only request range wraps */
             if (uiEnd < uiFirstSeq) {
-                uiEnd = CurrentLog->ulTotalRecordCount;
+                uiEnd = pRange->ulTotalRecordCount;
                 if (uiBegin < uiFirstSeq) {
                     uiBegin = uiFirstSeq;
                 }
             } else {
                 uiBegin = uiFirstSeq;
-                if (uiEnd > CurrentLog->ulTotalRecordCount) {
-                    uiEnd = CurrentLog->ulTotalRecordCount;
+                if (uiEnd > pRange->ulTotalRecordCount) {
+                    uiEnd = pRange->ulTotalRecordCount;
                 }
             }
         } else if (bWrapReq == false) { /* Only log wraps */
-            if (uiBegin > CurrentLog->ulTotalRecordCount) {
+            if (uiBegin > pRange->ulTotalRecordCount) {
                 if (uiBegin > uiFirstSeq) {
                     uiBegin = uiFirstSeq;
                 }
             } else {
-                if (uiEnd > CurrentLog->ulTotalRecordCount) {
-                    uiEnd = CurrentLog->ulTotalRecordCount;
+                if (uiEnd > pRange->ulTotalRecordCount) {
+                    uiEnd = pRange->ulTotalRecordCount;
                 }
             }
         } else { /* Both wrap */
@@ -1185,8 +1570,8 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
                 uiBegin = uiFirstSeq;
             }
 
-            if (uiEnd > CurrentLog->ulTotalRecordCount) {
-                uiEnd = CurrentLog->ulTotalRecordCount;
+            if (uiEnd > pRange->ulTotalRecordCount) {
+                uiEnd = pRange->ulTotalRecordCount;
             }
         }
     }
@@ -1198,7 +1583,7 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     uiSequence = uiBegin;
     uiFirst = uiIndex; /* Record where we started from */
     while (uiSequence != uiEnd + 1) {
-        if (uiRemaining < TL_MAX_ENC) {
+        if (uiRemaining < pRange->ulMaxEncoded) {
             /*
              * Can't fit any more in! We just set the result flag to say there
              * was more and drop out of the loop early
@@ -1208,7 +1593,7 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
             break;
         }
 
-        iTemp = TL_encode_entry(&apdu[iLen], log_index, uiIndex);
+        iTemp = pRange->Encode(&apdu[iLen], pRange->pLog, uiIndex);
 
         uiRemaining -= iTemp; /* Reduce the remaining space */
         iLen += iTemp; /* and increase the length consumed */
@@ -1223,7 +1608,7 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
     }
 
-    if (uiLast == CurrentLog->ulRecordCount) {
+    if (uiLast == pRange->ulRecordCount) {
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
     }
 
@@ -1232,6 +1617,85 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
     return (iLen);
 }
 
+/**
+ * @brief Find the oldest record of a trend log with a timestamp after a
+ *  reference time. The newest records which are in time order are searched
+ *  by bisection; older records, from before the clock was set back, are
+ *  checked one at a time first.
+ * @param pRange [in] the records of the log
+ * @param tRefTime [in] the reference time
+ * @return BACnet 1 based position of the record, or 0 if there is none
+ */
+static uint32_t TL_Entry_After(
+    const TL_RANGE_LOG *pRange, bacnet_time_t tRefTime)
+{
+    uint32_t uiSorted; /* first of the records in time order */
+    uint32_t uiLow;
+    uint32_t uiHigh;
+    uint32_t uiMid;
+
+    uiSorted = pRange->ulRecordCount - pRange->ulOrderedCount + 1;
+    for (uiLow = 1; uiLow < uiSorted; uiLow++) {
+        if (pRange->Time_Stamp(pRange->pLog, uiLow) > tRefTime) {
+            return uiLow;
+        }
+    }
+    uiHigh = pRange->ulRecordCount + 1;
+    while (uiLow < uiHigh) {
+        uiMid = uiLow + ((uiHigh - uiLow) / 2);
+        if (pRange->Time_Stamp(pRange->pLog, uiMid) > tRefTime) {
+            uiHigh = uiMid;
+        } else {
+            uiLow = uiMid + 1;
+        }
+    }
+    if (uiLow > pRange->ulRecordCount) {
+        return 0;
+    }
+
+    return uiLow;
+}
+
+/**
+ * @brief Find the newest record of a trend log with a timestamp before a
+ *  reference time. The newest records which are in time order are searched
+ *  by bisection; older records, from before the clock was set back, are
+ *  checked one at a time after.
+ * @param pRange [in] the records of the log
+ * @param tRefTime [in] the reference time
+ * @return BACnet 1 based position of the record, or 0 if there is none
+ */
+static uint32_t TL_Entry_Before(
+    const TL_RANGE_LOG *pRange, bacnet_time_t tRefTime)
+{
+    uint32_t uiSorted; /* first of the records in time order */
+    uint32_t uiLow;
+    uint32_t uiHigh;
+    uint32_t uiMid;
+
+    uiSorted = pRange->ulRecordCount - pRange->ulOrderedCount + 1;
+    uiLow = uiSorted;
+    uiHigh = pRange->ulRecordCount + 1;
+    while (uiLow < uiHigh) {
+        uiMid = uiLow + ((uiHigh - uiLow) / 2);
+        if (pRange->Time_Stamp(pRange->pLog, uiMid) < tRefTime) {
+            uiLow = uiMid + 1;
+        } else {
+            uiHigh = uiMid;
+        }
+    }
+    if (uiLow > uiSorted) {
+        return uiLow - 1;
+    }
+    for (uiLow = uiSorted - 1; uiLow > 0; uiLow--) {
+        if (pRange->Time_Stamp(pRange->pLog, uiLow) < tRefTime) {
+            return uiLow;
+        }
+    }
+
+    return 0;
+}
+
 /****************************************************************************
  * Handle encoding for the By Time option.                                  *
  * The fact that the buffer always has at least a single entry is used      *
@@ -1241,11 +1705,20 @@ int TL_encode_by_sequence(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 
 int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 {
-    int log_index = 0;
+    TL_RANGE_LOG Range;
+
+    TL_Range_Init(&Range, pRequest->object_instance);
+
+    return TL_Range_By_Time(apdu, pRequest, &Range);
+}
+
+static int TL_Range_By_Time(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    const TL_RANGE_LOG *pRange)
+{
     int iLen = 0;
     int32_t iTemp = 0;
     int iCount = 0;
-    TL_LOG_INFO *CurrentLog = NULL;
 
     uint32_t uiIndex = 0; /* Current entry number */
     uint32_t uiFirst = 0; /* Entry number we started encoding from */
@@ -1256,88 +1729,51 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 
     /* See how much space we have */
     uiRemaining = MAX_APDU - pRequest->Overhead;
-    log_index = Trend_Log_Instance_To_Index(pRequest->object_instance);
-    CurrentLog = &LogInfo[log_index];
 
     tRefTime = TL_BAC_Time_To_Local(&pRequest->Range.RefTime);
-    /* Find correct position for oldest entry in log */
-    if (CurrentLog->ulRecordCount < TL_MAX_ENTRIES) {
-        uiIndex = 0;
-    } else {
-        uiIndex = CurrentLog->iIndex;
-    }
-
     if (pRequest->Count < 0) {
-        /* Start at end of log and look for record which has
-         * timestamp greater than or equal to the reference.
+        /* Look back from the end of the log for the newest record which
+         * has a timestamp less than the reference.
          */
-        iCount = CurrentLog->ulRecordCount - 1;
-        /* Start out with the sequence number for the last record */
-        uiFirstSeq = CurrentLog->ulTotalRecordCount;
-        for (;;) {
-            if (Logs[pRequest->object_instance]
-                    [(uiIndex + iCount) % TL_MAX_ENTRIES]
-                        .tTimeStamp < tRefTime) {
-                break;
-            }
-
-            uiFirstSeq--;
-            iCount--;
-            if (iCount < 0) {
-                return (0);
-            }
+        uiIndex = TL_Entry_Before(pRange, tRefTime);
+        if (uiIndex == 0) {
+            return (0);
         }
 
-        /* We have an and point for our request,
+        /* We have an end point for our request,
          * now work backwards to find where we should start from
          */
-
-        pRequest->Count = -pRequest->Count; /* Conveert to +ve count */
+        pRequest->Count = -pRequest->Count; /* Convert to +ve count */
         /* If count would bring us back beyond the limits
          * Of the buffer then pin it to the start of the buffer
-         * otherwise adjust starting point and sequence number
-         * appropriately.
+         * otherwise adjust starting point appropriately.
          */
-        iTemp = pRequest->Count - 1;
-        if (iTemp > iCount) {
-            uiFirstSeq -= iCount;
-            pRequest->Count = iCount + 1;
-            iCount = 0;
+        if ((uint32_t)pRequest->Count > uiIndex) {
+            pRequest->Count = uiIndex;
+            uiIndex = 1;
         } else {
-            uiFirstSeq -= iTemp;
-            iCount -= iTemp;
+            uiIndex -= pRequest->Count - 1;
         }
     } else {
-        /* Start at beginning of log and look for 1st record which has
-         * timestamp greater than the reference time.
+        /* Look for the 1st record which has a timestamp greater than
+         * the reference time.
          */
-        iCount = 0;
-        /* Figure out the sequence number for the first record, last is
-         * ulTotalRecordCount */
-        uiFirstSeq =
-            CurrentLog->ulTotalRecordCount - (CurrentLog->ulRecordCount - 1);
-        for (;;) {
-            if (Logs[pRequest->object_instance]
-                    [(uiIndex + iCount) % TL_MAX_ENTRIES]
-                        .tTimeStamp > tRefTime) {
-                break;
-            }
-
-            uiFirstSeq++;
-            iCount++;
-            if ((uint32_t)iCount == CurrentLog->ulRecordCount) {
-                return (0);
-            }
+        uiIndex = TL_Entry_After(pRange, tRefTime);
+        if (uiIndex == 0) {
+            return (0);
         }
     }
+    /* Figure out the sequence number for the starting record, last is
+     * ulTotalRecordCount */
+    uiFirstSeq = pRange->ulTotalRecordCount -
+        (pRange->ulRecordCount - uiIndex);
 
     /* We now have a starting point for the operation and a +ve count */
 
-    uiIndex = iCount + 1; /* Convert to BACnet 1 based reference */
     uiFirst = uiIndex; /* Record where we started from */
     iCount = pRequest->Count;
     while (iCount != 0) {
-        if (uiRemaining < TL_MAX_ENC) {
+        if (uiRemaining < pRange->ulMaxEncoded) {
             /*
              * Can't fit any more in! We just set the result flag to say there
              * was more and drop out of the loop early
@@ -1347,7 +1783,7 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
             break;
         }
 
-        iTemp = TL_encode_entry(&apdu[iLen], log_index, uiIndex);
+        iTemp = pRange->Encode(&apdu[iLen], pRange->pLog, uiIndex);
 
         uiRemaining -= iTemp; /* Reduce the remaining space */
         iLen += iTemp; /* and increase the length consumed */
@@ -1356,9 +1792,8 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
         pRequest->ItemCount++; /* Chalk up another one for the response count */
         iCount--; /* And finally cross another one off the requested count */
 
-        if (uiIndex >
-            CurrentLog
-                ->ulRecordCount) { /* Finish up if we hit the end of the log */
+        if (uiIndex > pRange->ulRecordCount) {
+            /* Finish up if we hit the end of the log */
             break;
         }
     }
@@ -1368,7 +1803,7 @@ int TL_encode_by_time(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
     }
 
-    if (uiLast == CurrentLog->ulRecordCount) {
+    if (uiLast == pRange->ulRecordCount) {
         bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
     }
 
@@ -1387,13 +1822,7 @@ int TL_encode_entry(uint8_t *apdu, int iLog, int iEntry)
 
     /* Convert from BACnet 1 based to 0 based array index and then
      * handle wrap around of the circular buffer */
-
-    if (LogInfo[iLog].ulRecordCount < TL_MAX_ENTRIES) {
-        pSource = &Logs[iLog][(iEntry - 1) % TL_MAX_ENTRIES];
-    } else {
-        pSource =
-            &Logs[iLog][(LogInfo[iLog].iIndex + iEntry - 1) % TL_MAX_ENTRIES];
-    }
+    pSource = TL_Entry(&LogInfo[iLog], (uint32_t)iEntry);
 
     iLen = 0;
     /* First stick the time stamp in with tag [0] */
@@ -1496,45 +1925,159 @@ int TL_encode_entry(uint8_t *apdu, int iLog, int iEntry)
     return (iLen);
 }
 
-static int local_read_property(uint8_t *value,
-    uint8_t *status,
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source,
-    BACNET_ERROR_CLASS *error_class,
-    BACNET_ERROR_CODE *error_code)
+/**
+ * @brief Store a value of the logged property in a record
+ * @param pRec [out] record for the value
+ * @param value [in] decoded value of the logged property
+ */
+static void TL_Value_To_Rec(
+    TL_DATA_REC *pRec, BACNET_APPLICATION_DATA_VALUE *value)
 {
-    int len = 0;
-    BACNET_READ_PROPERTY_DATA rpdata;
-
-    if (value != NULL) {
-        /* configure our storage */
-        rpdata.application_data = value;
-        rpdata.application_data_len = MAX_APDU;
-        rpdata.object_type = Source->objectIdentifier.type;
-        rpdata.object_instance = Source->objectIdentifier.instance;
-        rpdata.object_property = Source->propertyIdentifier;
-        rpdata.array_index = Source->arrayIndex;
-        /* Try to fetch the required property */
-        len = Device_Read_Property(&rpdata);
-        if (len < 0) {
-            *error_class = rpdata.error_class;
-            *error_code = rpdata.error_code;
-        }
+#if defined(BACAPP_BIT_STRING)
+    uint8_t ucCount;
+    uint8_t ucBytes;
+#endif
+
+    switch (value->tag) {
+        case BACNET_APPLICATION_TAG_NULL:
+            pRec->ucRecType = TL_TYPE_NULL;
+            return;
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            pRec->ucRecType = TL_TYPE_BOOL;
+            pRec->Datum.ucBoolean = value->type.Boolean;
+            return;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            pRec->ucRecType = TL_TYPE_UNSIGN;
+            pRec->Datum.ulUValue = (uint32_t)value->type.Unsigned_Int;
+            return;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            pRec->ucRecType = TL_TYPE_SIGN;
+            pRec->Datum.lSValue = value->type.Signed_Int;
+            return;
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            pRec->ucRecType = TL_TYPE_REAL;
+            pRec->Datum.fReal = value->type.Real;
+            return;
+#endif
+#if defined(BACAPP_BIT_STRING)
+        case BACNET_APPLICATION_TAG_BIT_STRING:
+            pRec->ucRecType = TL_TYPE_BITS;
+            /* We truncate any bitstrings at 32 bits to conserve space */
+            if (bitstring_bits_used(&value->type.Bit_String) < 32) {
+                /* Store the bytes used and the bits free in the last byte */
+                ucBytes = bitstring_bytes_used(&value->type.Bit_String);
+                pRec->Datum.Bits.ucLen = ucBytes << 4;
+                pRec->Datum.Bits.ucLen |=
+                    (8 - (bitstring_bits_used(&value->type.Bit_String) % 8)) &
+                    7;
+            } else {
+                /* We will only use the first 4 octets to save space */
+                ucBytes = 4;
+                pRec->Datum.Bits.ucLen = 4 << 4;
+            }
+            if (ucBytes > sizeof(pRec->Datum.Bits.ucStore)) {
+                ucBytes = sizeof(pRec->Datum.Bits.ucStore);
+            }
+            /* Fetch the octets with the bits directly */
+            for (ucCount = 0; ucCount < ucBytes; ucCount++) {
+                pRec->Datum.Bits.ucStore[ucCount] =
+                    bitstring_octet(&value->type.Bit_String, ucCount);
+            }
+            return;
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            pRec->ucRecType = TL_TYPE_ENUM;
+            pRec->Datum.ulEnum = value->type.Enumerated;
+            return;
+#endif
+        default:
+            break;
     }
+    /* Fake an error response for any types we cannot handle */
+    pRec->Datum.Error.usClass = ERROR_CLASS_PROPERTY;
+    pRec->Datum.Error.usCode = ERROR_CODE_DATATYPE_NOT_SUPPORTED;
+    pRec->ucRecType = TL_TYPE_ERROR;
+}
+
+/**
+ * @brief Store the logged property and the status flags of an object in
+ *  a record, from the listOfValues of the object as used for COV
+ * @param pRec [out] record for the value
+ * @param Source [in] logged property
+ * @param value_list [in] values of the object
+ * @return true if the logged property was in the list
+ */
+bool TL_Value_List_To_Rec(TL_DATA_REC *pRec,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    bool bFound = false;
 
-    if ((len >= 0) && (status != NULL)) {
-        /* Fetch the status flags if required */
-        rpdata.application_data = status;
-        rpdata.application_data_len = MAX_APDU;
-        rpdata.object_property = PROP_STATUS_FLAGS;
-        rpdata.array_index = BACNET_ARRAY_ALL;
-        len = Device_Read_Property(&rpdata);
-        if (len < 0) {
-            *error_class = rpdata.error_class;
-            *error_code = rpdata.error_code;
+    if (Source->arrayIndex != BACNET_ARRAY_ALL) {
+        return false;
+    }
+    pRec->ucStatus = 0;
+    while (value_list) {
+        if (value_list->propertyIdentifier == Source->propertyIdentifier) {
+            TL_Value_To_Rec(pRec, &value_list->value);
+            bFound = true;
+        }
+#if defined(BACAPP_BIT_STRING)
+        if ((value_list->propertyIdentifier == PROP_STATUS_FLAGS) &&
+            (value_list->value.tag == BACNET_APPLICATION_TAG_BIT_STRING)) {
+            pRec->ucStatus =
+                128 | bitstring_octet(&value_list->value.type.Bit_String, 0);
         }
+#endif
+        value_list = value_list->next;
     }
 
-    return (len);
+    return bFound;
+}
+
+/**
+ * @brief Store the logged property and the status flags of a local object
+ *  in a record, as typed values from the object, or the error of the read
+ * @param pRec [out] record for the value
+ * @param Source [in] logged property
+ */
+void TL_Read_Property_To_Rec(
+    TL_DATA_REC *pRec, const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Source)
+{
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_OTHER;
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_APPLICATION_DATA_VALUE status = { 0 };
+
+    pRec->ucStatus = 0;
+    if (!Device_Object_Property_Value(Source->objectIdentifier.type,
+            Source->objectIdentifier.instance, Source->propertyIdentifier,
+            Source->arrayIndex, &value, &error_class, &error_code) ||
+        !Device_Object_Property_Value(Source->objectIdentifier.type,
+            Source->objectIdentifier.instance, PROP_STATUS_FLAGS,
+            BACNET_ARRAY_ALL, &status, &error_class, &error_code)) {
+        /* Insert error code into log */
+        pRec->Datum.Error.usClass = error_class;
+        pRec->Datum.Error.usCode = error_code;
+        pRec->ucRecType = TL_TYPE_ERROR;
+        return;
+    }
+    /* See if we can fit the value into the log */
+    TL_Value_To_Rec(pRec, &value);
+    /* Finally insert the status flags into the record */
+#if defined(BACAPP_BIT_STRING)
+    if (status.tag == BACNET_APPLICATION_TAG_BIT_STRING) {
+        pRec->ucStatus = 128 | bitstring_octet(&status.type.Bit_String, 0);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -1543,20 +2086,9 @@ static int local_read_property(uint8_t *value,
 
 static void TL_fetch_property(int iLog)
 {
-    uint8_t ValueBuf[MAX_APDU]; /* This is a big buffer in case someone selects
-                                   the device object list for example */
-    uint8_t StatusBuf[3]; /* Should be tag, bits unused in last octet and 1 byte
-                             of data */
-    BACNET_ERROR_CLASS error_class = ERROR_CLASS_SERVICES;
-    BACNET_ERROR_CODE error_code = ERROR_CODE_OTHER;
-    int iLen;
-    uint8_t ucCount;
     TL_LOG_INFO *CurrentLog;
     TL_DATA_REC TempRec;
-    uint8_t tag_number = 0;
-    uint32_t len_value_type = 0;
-    BACNET_BIT_STRING TempBits;
-    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    BACNET_PROPERTY_VALUE value_list[2];
 
     CurrentLog = &LogInfo[iLog];
 
@@ -1566,105 +2098,64 @@ static void TL_fetch_property(int iLog)
     CurrentLog->tLastDataTime = TempRec.tTimeStamp;
     TempRec.ucStatus = 0;
 
-    iLen = local_read_property(
-        ValueBuf, StatusBuf, &LogInfo[iLog].Source, &error_class, &error_code);
-    if (iLen < 0) {
-        /* Insert error code into log */
-        TempRec.Datum.Error.usClass = error_class;
-        TempRec.Datum.Error.usCode = error_code;
-        TempRec.ucRecType = TL_TYPE_ERROR;
-    } else {
-        /* Decode data returned and see if we can fit it into the log */
-        iLen =
-            decode_tag_number_and_value(ValueBuf, &tag_number, &len_value_type);
-        switch (tag_number) {
-            case BACNET_APPLICATION_TAG_NULL:
-                TempRec.ucRecType = TL_TYPE_NULL;
-                break;
-
-            case BACNET_APPLICATION_TAG_BOOLEAN:
-                TempRec.ucRecType = TL_TYPE_BOOL;
-                TempRec.Datum.ucBoolean = decode_boolean(len_value_type);
-                break;
-
-            case BACNET_APPLICATION_TAG_UNSIGNED_INT:
-                TempRec.ucRecType = TL_TYPE_UNSIGN;
-                decode_unsigned(
-                    &ValueBuf[iLen], len_value_type, &unsigned_value);
-                TempRec.Datum.ulUValue = unsigned_value;
-                break;
-
-            case BACNET_APPLICATION_TAG_SIGNED_INT:
-                TempRec.ucRecType = TL_TYPE_SIGN;
-                decode_signed(
-                    &ValueBuf[iLen], len_value_type, &TempRec.Datum.lSValue);
-                break;
-
-            case BACNET_APPLICATION_TAG_REAL:
-                TempRec.ucRecType = TL_TYPE_REAL;
-                decode_real_safe(
-                    &ValueBuf[iLen], len_value_type, &TempRec.Datum.fReal);
-                break;
+    /* Most logs are of the present value of a local object, which the
+     * object gives us directly without encoding and decoding it */
+    bacapp_property_value_list_init(&value_list[0], 2);
+    if (!Device_Encode_Value_List(CurrentLog->Source.objectIdentifier.type,
+            CurrentLog->Source.objectIdentifier.instance, &value_list[0]) ||
+        !TL_Value_List_To_Rec(&TempRec, &CurrentLog->Source, &value_list[0])) {
+        TL_Read_Property_To_Rec(&TempRec, &CurrentLog->Source);
+    }
 
-            case BACNET_APPLICATION_TAG_BIT_STRING:
-                TempRec.ucRecType = TL_TYPE_BITS;
-                decode_bitstring(&ValueBuf[iLen], len_value_type, &TempBits);
-                /* We truncate any bitstrings at 32 bits to conserve space */
-                if (bitstring_bits_used(&TempBits) < 32) {
-                    /* Store the bytes used and the bits free in the last byte
-                     */
-                    TempRec.Datum.Bits.ucLen = bitstring_bytes_used(&TempBits)
-                        << 4;
-                    TempRec.Datum.Bits.ucLen |=
-                        (8 - (bitstring_bits_used(&TempBits) % 8)) & 7;
-                    /* Fetch the octets with the bits directly */
-                    for (ucCount = 0; ucCount < bitstring_bytes_used(&TempBits);
-                         ucCount++) {
-                        TempRec.Datum.Bits.ucStore[ucCount] =
-                            bitstring_octet(&TempBits, ucCount);
-                    }
-                } else {
-                    /* We will only use the first 4 octets to save space */
-                    TempRec.Datum.Bits.ucLen = 4 << 4;
-                    for (ucCount = 0; ucCount < 4; ucCount++) {
-                        TempRec.Datum.Bits.ucStore[ucCount] =
-                            bitstring_octet(&TempBits, ucCount);
-                    }
-                }
-                break;
+    TL_Insert_Rec(CurrentLog, &TempRec);
+}
 
-            case BACNET_APPLICATION_TAG_ENUMERATED:
-                TempRec.ucRecType = TL_TYPE_ENUM;
-                decode_enumerated(
-                    &ValueBuf[iLen], len_value_type, &TempRec.Datum.ulEnum);
-                break;
+/**
+ * @brief Log the values of a changed object, for the COV trend logs
+ * @param subscriber_id [in] index of the trend log
+ * @param object_type [in] type of the changed object
+ * @param object_instance [in] instance of the changed object
+ * @param value_list [in] the changed values of the object
+ */
+static void TL_COV_Notification(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    TL_LOG_INFO *CurrentLog;
+    TL_DATA_REC TempRec;
 
-            default:
-                /* Fake an error response for any types we cannot handle */
-                TempRec.Datum.Error.usClass = ERROR_CLASS_PROPERTY;
-                TempRec.Datum.Error.usCode = ERROR_CODE_DATATYPE_NOT_SUPPORTED;
-                TempRec.ucRecType = TL_TYPE_ERROR;
-                break;
-        }
-        /* Finally insert the status flags into the record */
-        iLen = decode_tag_number_and_value(
-            StatusBuf, &tag_number, &len_value_type);
-        decode_bitstring(&StatusBuf[iLen], len_value_type, &TempBits);
-        TempRec.ucStatus = 128 | bitstring_octet(&TempBits, 0);
+    if (subscriber_id >= MAX_TREND_LOGS) {
+        return;
     }
-
-    Logs[iLog][CurrentLog->iIndex++] = TempRec;
-    if (CurrentLog->iIndex >= TL_MAX_ENTRIES) {
-        CurrentLog->iIndex = 0;
+    CurrentLog = &LogInfo[subscriber_id];
+    if ((CurrentLog->LoggingType != LOGGING_TYPE_COV) ||
+        (CurrentLog->Source.objectIdentifier.type != object_type) ||
+        (CurrentLog->Source.objectIdentifier.instance != object_instance) ||
+        !TL_Is_Enabled(subscriber_id)) {
+        return;
     }
-
-    CurrentLog->ulTotalRecordCount++;
-
-    if (CurrentLog->ulRecordCount < TL_MAX_ENTRIES) {
-        CurrentLog->ulRecordCount++;
+    TempRec.tTimeStamp = Trend_Log_Epoch_Seconds_Now();
+    if (TL_Value_List_To_Rec(&TempRec, &CurrentLog->Source, value_list)) {
+        CurrentLog->tLastDataTime = TempRec.tTimeStamp;
+        TL_Insert_Rec(CurrentLog, &TempRec);
+    } else {
+        /* some other property of the changed object is logged */
+        TL_fetch_property(subscriber_id);
     }
 }
 
+/**
+ * @brief Stop the COV notifications to a trend log from its source object
+ * @param iLog [in] index of the trend log
+ */
+static void TL_COV_Unsubscribe(int iLog)
+{
+    handler_cov_local_unsubscribe(iLog,
+        LogInfo[iLog].Source.objectIdentifier.type,
+        LogInfo[iLog].Source.objectIdentifier.instance, TL_COV_Notification);
+}
+
 /****************************************************************************
  * Check each log to see if any data needs to be recorded.                  *
  ****************************************************************************/
@@ -1731,7 +2222,18 @@ void trend_log_timer(uint16_t uSeconds)
                     TL_fetch_property(iCount);
                     CurrentLog->bTrigger = false;
                 }
+            } else if (CurrentLog->LoggingType == LOGGING_TYPE_COV) {
+                /* COV logs take a reading when the source object reports
+                 * a change, so only make sure that it will do so.
+                 * Subscribing again has no effect.
+                 */
+                (void)handler_cov_local_subscribe(iCount,
+                    CurrentLog->Source.objectIdentifier.type,
+                    CurrentLog->Source.objectIdentifier.instance,
+                    TL_COV_Notification);
             }
+        } else if (CurrentLog->LoggingType == LOGGING_TYPE_COV) {
+            TL_COV_Unsubscribe(iCount);
         }
     }
 }
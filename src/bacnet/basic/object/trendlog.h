@@ -65,7 +65,22 @@ extern "C" {
 #define TL_T_START_WILD 1       /* Start time is wild carded */
 #define TL_T_STOP_WILD  2       /* Stop Time is wild carded */
 
-#define TL_MAX_ENTRIES 1000     /* Entries per datalog */
+#ifndef TL_MAX_ENTRIES
+#define TL_MAX_ENTRIES 1000     /* Entries per datalog in the RAM buffer */
+#endif
+
+/* State of the circular buffer of a Trend Log, which is kept together
+ * with the records by a storage backend so that the log can be recovered
+ * after a restart without replaying it */
+
+    typedef struct tl_log_ring {
+        uint32_t ulIndex;       /* Current insertion point */
+        uint32_t ulRecordCount; /* Count of items currently in the buffer */
+        uint32_t ulTotalRecordCount;    /* Count of all items ever inserted */
+    } TL_LOG_RING;
+
+/* Compressed storage for the records of a Trend Log, see trendlog_block.h */
+    struct tl_block_log;
 
 /* Structure containing config and status info for a Trend Log */
 
@@ -87,8 +102,28 @@ extern "C" {
         bool bTrigger;  /* Set to 1 to cause a reading to be taken */
         int iIndex;     /* Current insertion point */
         bacnet_time_t tLastDataTime;
+        TL_DATA_REC *pRecords;  /* Circular buffer of records */
+        uint32_t ulBufferSize;  /* Number of records in the buffer */
+        TL_LOG_RING *pRing;     /* Optional stored copy of the buffer state */
+        uint32_t ulOrderedCount;        /* Count of newest records in time order */
+        struct tl_block_log *pBlocks;   /* Optional compressed storage used instead of pRecords */
     } TL_LOG_INFO;
 
+/* The records of a log in time order, such as a Trend Log or an Event Log,
+ * for the ReadRange encoding by position, by sequence number or by time */
+
+    typedef struct tl_range_log {
+        const void *pLog;       /* The log, given to the functions below */
+        uint32_t ulRecordCount; /* Count of items currently in the buffer */
+        uint32_t ulTotalRecordCount;    /* Count of all items ever inserted */
+        uint32_t ulOrderedCount;        /* Newest records in time order */
+        uint32_t ulMaxEncoded;  /* Most octets of one encoded record */
+        /* Time stamp of a record, 1 being the oldest */
+        bacnet_time_t (*Time_Stamp)(const void *pLog, uint32_t uiEntry);
+        /* Encode a record, 1 being the oldest, and return its length */
+        int (*Encode)(uint8_t * apdu, const void *pLog, uint32_t uiEntry);
+    } TL_RANGE_LOG;
+
 /*
  * Data types associated with a BACnet Log Record. We use these for managing the
  * log buffer but they are also the tag numbers to use when encoding/decoding
@@ -146,6 +181,20 @@ extern "C" {
     void Trend_Log_Init(
         void);
 
+    BACNET_STACK_EXPORT
+    bool Trend_Log_Buffer_Set(
+        uint32_t object_instance,
+        TL_DATA_REC * pRecords,
+        uint32_t ulBufferSize,
+        TL_LOG_RING * pRing);
+    BACNET_STACK_EXPORT
+    bool Trend_Log_Block_Buffer_Set(
+        uint32_t object_instance,
+        struct tl_block_log * pBlocks);
+    BACNET_STACK_EXPORT
+    uint32_t Trend_Log_Buffer_Size(
+        uint32_t object_instance);
+
     BACNET_STACK_EXPORT
     void TL_Insert_Status_Rec(
         int iLog,
@@ -186,6 +235,23 @@ extern "C" {
         uint8_t * apdu,
         BACNET_READ_RANGE_DATA * pRequest);
 
+    BACNET_STACK_EXPORT
+    int TL_Range_Encode(
+        uint8_t * apdu,
+        BACNET_READ_RANGE_DATA * pRequest,
+        const TL_RANGE_LOG * pRange);
+
+    BACNET_STACK_EXPORT
+    bool TL_Value_List_To_Rec(
+        TL_DATA_REC * pRec,
+        const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE * Source,
+        BACNET_PROPERTY_VALUE * value_list);
+
+    BACNET_STACK_EXPORT
+    void TL_Read_Property_To_Rec(
+        TL_DATA_REC * pRec,
+        const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE * Source);
+
     BACNET_STACK_EXPORT
     bool TrendLogGetRRInfo(
         BACNET_READ_RANGE_DATA * pRequest,      /* Info on the request */
@@ -0,0 +1,892 @@
+/**
+ * @file
+ * @brief Compressed storage for the records of a Trend Log.
+ *
+ * The records are kept in a ring of fixed size blocks. Each block starts
+ * with its record count, followed by the records as a stream of bits.
+ * The first record of a block is stored in full, so that any block can
+ * be decoded on its own. Each following timestamp is stored as the change
+ * in the interval since the record before, which takes a single bit for
+ * a log sampled at a fixed interval. The record type and status flags
+ * take a single bit when they are the same as the record before. A 32 bit
+ * value is stored as the exclusive or with the value before, which takes
+ * a single bit when the value is the same, and only the bits that differ
+ * otherwise. When the ring is full, the oldest block of records is
+ * dropped to make room for a new block.
+ *
+ * The records of a Trend Log Multiple are rows of values, one value for
+ * each column, that share one timestamp. The timestamp is stored once for
+ * each row, and each column keeps its own record type, status flags and
+ * last value, so that a value is compared with the value of the same
+ * column in the row before. A log status or time change in the first
+ * column is a row of its own, and the other columns are not stored.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/trendlog.h"
+#include "bacnet/basic/object/trendlog_block.h"
+
+#if (TL_BLOCK_SIZE < 32) || (TL_BLOCK_SIZE > 8192)
+#error "TL_BLOCK_SIZE must be between 32 and 8192 octets"
+#endif
+
+/* the record count of a block is kept in its first two octets */
+#define TL_BLOCK_HEADER_BITS 16
+#define TL_BLOCK_BITS ((uint32_t)TL_BLOCK_SIZE * 8)
+#define TL_TIME_BITS ((unsigned)sizeof(bacnet_time_t) * 8)
+/* largest timestamp of a record after the first one of a block */
+#define TL_TIME_BITS_MAX (4 + TL_TIME_BITS)
+/* largest value: type and status, and a new 32 bit value */
+#define TL_VALUE_BITS_MAX (1 + 4 + 8 + 2 + 5 + 5 + 32)
+/* largest first value of a block: type, status and a bit string */
+#define TL_VALUE_BITS_FIRST_MAX (4 + 8 + 40)
+/* smallest first value of a block: type and status */
+#define TL_VALUE_BITS_FIRST (4 + 8)
+/* smallest value: same type, status, and a NULL value */
+#define TL_VALUE_BITS_MIN 1
+
+/**
+ * @brief Write bits to a block
+ * @param pBlock [in] the block
+ * @param pulBit [in,out] the next bit of the block
+ * @param value [in] the bits to write, in the low order bits
+ * @param bits [in] number of bits to write
+ * @return true if the bits fit in the block
+ */
+static bool
+TL_Bits_Put(uint8_t *pBlock, uint32_t *pulBit, uint64_t value, unsigned bits)
+{
+    uint8_t mask;
+
+    if ((TL_BLOCK_BITS - *pulBit) < bits) {
+        return false;
+    }
+    while (bits > 0) {
+        bits--;
+        mask = (uint8_t)(0x80 >> (*pulBit & 7));
+        if ((value >> bits) & 1) {
+            pBlock[*pulBit >> 3] |= mask;
+        } else {
+            pBlock[*pulBit >> 3] &= (uint8_t)~mask;
+        }
+        (*pulBit)++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read bits from a block
+ * @param pBlock [in] the block
+ * @param pulBit [in,out] the next bit of the block
+ * @param bits [in] number of bits to read
+ * @return the bits, in the low order bits, or 0 past the end of the block
+ */
+static uint64_t
+TL_Bits_Get(const uint8_t *pBlock, uint32_t *pulBit, unsigned bits)
+{
+    uint64_t value = 0;
+
+    if ((TL_BLOCK_BITS - *pulBit) < bits) {
+        return 0;
+    }
+    while (bits > 0) {
+        bits--;
+        value <<= 1;
+        if (pBlock[*pulBit >> 3] & (0x80 >> (*pulBit & 7))) {
+            value |= 1;
+        }
+        (*pulBit)++;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Count the leading zero bits of a non-zero 32 bit value
+ * @param value [in] the value
+ * @return number of leading zero bits
+ */
+static uint8_t TL_Leading_Zeros(uint32_t value)
+{
+    uint8_t count = 0;
+
+    while (!(value & 0x80000000UL)) {
+        value <<= 1;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Count the trailing zero bits of a non-zero 32 bit value
+ * @param value [in] the value
+ * @return number of trailing zero bits
+ */
+static uint8_t TL_Trailing_Zeros(uint32_t value)
+{
+    uint8_t count = 0;
+
+    while (!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the time from one timestamp to the next, when it is small
+ *  enough to be stored as a change of interval
+ * @param tFrom [in] the earlier timestamp
+ * @param tTo [in] the later timestamp
+ * @param plDelta [out] the time from one to the other, in seconds
+ * @return true if the time is small enough
+ */
+static bool
+TL_Time_Delta(bacnet_time_t tFrom, bacnet_time_t tTo, int64_t *plDelta)
+{
+    if (tTo >= tFrom) {
+        if ((tTo - tFrom) > INT32_MAX) {
+            return false;
+        }
+        *plDelta = (int64_t)(tTo - tFrom);
+    } else {
+        if ((tFrom - tTo) > INT32_MAX) {
+            return false;
+        }
+        *plDelta = -(int64_t)(tFrom - tTo);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check if a record type holds a 32 bit value
+ * @param ucRecType [in] the record type
+ * @return true if the value is stored as an exclusive or
+ */
+static bool TL_Value_32(uint8_t ucRecType)
+{
+    switch (ucRecType) {
+        case TL_TYPE_REAL:
+        case TL_TYPE_ENUM:
+        case TL_TYPE_UNSIGN:
+        case TL_TYPE_SIGN:
+        case TL_TYPE_DELTA:
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Encode the timestamp of a record after the others in a block
+ * @param pBlock [in] the block
+ * @param pState [in,out] the encoder state after the record before
+ * @param tTimeStamp [in] the timestamp of the record
+ * @return true if the timestamp fits in the block
+ */
+static bool TL_Block_Encode_Time(
+    uint8_t *pBlock, TL_BLOCK_STATE *pState, bacnet_time_t tTimeStamp)
+{
+    uint32_t *pulBit = &pState->ulBit;
+    int64_t lDelta = 0;
+    int64_t lChange = 0;
+    bool ok = true;
+
+    if (pState->ulEntry == 0) {
+        ok = TL_Bits_Put(pBlock, pulBit, tTimeStamp, TL_TIME_BITS);
+    } else if (!TL_Time_Delta(pState->tTimeStamp, tTimeStamp, &lDelta)) {
+        /* the clock jumped: store the timestamp in full */
+        lDelta = 0;
+        ok = TL_Bits_Put(pBlock, pulBit, 0xF, 4) &&
+            TL_Bits_Put(pBlock, pulBit, tTimeStamp, TL_TIME_BITS);
+    } else {
+        lChange = lDelta - pState->lDelta;
+        if (lChange == 0) {
+            ok = TL_Bits_Put(pBlock, pulBit, 0, 1);
+        } else if ((lChange >= -63) && (lChange <= 64)) {
+            ok = TL_Bits_Put(pBlock, pulBit, 0x2, 2) &&
+                TL_Bits_Put(pBlock, pulBit, (uint64_t)(lChange + 63), 7);
+        } else if ((lChange >= -255) && (lChange <= 256)) {
+            ok = TL_Bits_Put(pBlock, pulBit, 0x6, 3) &&
+                TL_Bits_Put(pBlock, pulBit, (uint64_t)(lChange + 255), 9);
+        } else if ((lChange >= -2047) && (lChange <= 2048)) {
+            ok = TL_Bits_Put(pBlock, pulBit, 0xE, 4) &&
+                TL_Bits_Put(pBlock, pulBit, (uint64_t)(lChange + 2047), 12);
+        } else {
+            ok = TL_Bits_Put(pBlock, pulBit, 0xF, 4) &&
+                TL_Bits_Put(pBlock, pulBit, tTimeStamp, TL_TIME_BITS);
+        }
+    }
+    pState->tTimeStamp = tTimeStamp;
+    pState->lDelta = lDelta;
+
+    return ok;
+}
+
+/**
+ * @brief Encode the value of a record after the others of its column
+ *  in a block
+ * @param pBlock [in] the block
+ * @param pulBit [in,out] the next bit of the block
+ * @param pState [in,out] the encoder state of the column
+ * @param pRec [in] the record
+ * @return true if the value fits in the block
+ */
+static bool TL_Block_Encode_Value(uint8_t *pBlock,
+    uint32_t *pulBit,
+    TL_BLOCK_STATE *pState,
+    const TL_DATA_REC *pRec)
+{
+    uint32_t ulValue = 0;
+    uint32_t ulXor = 0;
+    uint8_t ucLeading;
+    uint8_t ucTrailing;
+    bool ok = true;
+
+    if (pState->ulEntry == 0) {
+        ok = TL_Bits_Put(pBlock, pulBit, pRec->ucRecType, 4) &&
+            TL_Bits_Put(pBlock, pulBit, pRec->ucStatus, 8);
+    } else if (
+        (pRec->ucRecType == pState->ucRecType) &&
+        (pRec->ucStatus == pState->ucStatus)) {
+        ok = TL_Bits_Put(pBlock, pulBit, 0, 1);
+    } else {
+        ok = TL_Bits_Put(pBlock, pulBit, 1, 1) &&
+            TL_Bits_Put(pBlock, pulBit, pRec->ucRecType, 4) &&
+            TL_Bits_Put(pBlock, pulBit, pRec->ucStatus, 8);
+    }
+    switch (pRec->ucRecType) {
+        case TL_TYPE_STATUS:
+            ok = ok &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.ucLogStatus, 8);
+            break;
+        case TL_TYPE_BOOL:
+            ok = ok && TL_Bits_Put(pBlock, pulBit, pRec->Datum.ucBoolean, 8);
+            break;
+        case TL_TYPE_REAL:
+            memcpy(&ulValue, &pRec->Datum.fReal, sizeof(ulValue));
+            break;
+        case TL_TYPE_DELTA:
+            memcpy(&ulValue, &pRec->Datum.fTime, sizeof(ulValue));
+            break;
+        case TL_TYPE_ENUM:
+            ulValue = pRec->Datum.ulEnum;
+            break;
+        case TL_TYPE_UNSIGN:
+            ulValue = pRec->Datum.ulUValue;
+            break;
+        case TL_TYPE_SIGN:
+            ulValue = (uint32_t)pRec->Datum.lSValue;
+            break;
+        case TL_TYPE_NULL:
+            break;
+        case TL_TYPE_ERROR:
+            ok = ok &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.Error.usClass, 16) &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.Error.usCode, 16);
+            break;
+        default:
+            ok = ok &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.Bits.ucLen, 8) &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.Bits.ucStore[0], 8) &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.Bits.ucStore[1], 8) &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.Bits.ucStore[2], 8) &&
+                TL_Bits_Put(pBlock, pulBit, pRec->Datum.Bits.ucStore[3], 8);
+            break;
+    }
+    if (TL_Value_32(pRec->ucRecType)) {
+        ulXor = ulValue ^ pState->ulValue;
+        if (pState->ulEntry == 0) {
+            ok = ok && TL_Bits_Put(pBlock, pulBit, ulValue, 32);
+        } else if (ulXor == 0) {
+            ok = ok && TL_Bits_Put(pBlock, pulBit, 0, 1);
+        } else {
+            ucLeading = TL_Leading_Zeros(ulXor);
+            ucTrailing = TL_Trailing_Zeros(ulXor);
+            if ((pState->ucLength > 0) && (ucLeading >= pState->ucLeading) &&
+                (ucTrailing >= (32 - pState->ucLeading - pState->ucLength))) {
+                /* the bits that differ fit in the window of the last one */
+                ok = ok && TL_Bits_Put(pBlock, pulBit, 0x2, 2) &&
+                    TL_Bits_Put(pBlock, pulBit,
+                        ulXor >> (32 - pState->ucLeading - pState->ucLength),
+                        pState->ucLength);
+            } else {
+                pState->ucLeading = ucLeading;
+                pState->ucLength = 32 - ucLeading - ucTrailing;
+                ok = ok && TL_Bits_Put(pBlock, pulBit, 0x3, 2) &&
+                    TL_Bits_Put(pBlock, pulBit, ucLeading, 5) &&
+                    TL_Bits_Put(pBlock, pulBit, pState->ucLength - 1, 5) &&
+                    TL_Bits_Put(pBlock, pulBit, ulXor >> ucTrailing,
+                        pState->ucLength);
+            }
+        }
+        pState->ulValue = ulValue;
+    }
+    pState->ucRecType = pRec->ucRecType;
+    pState->ucStatus = pRec->ucStatus;
+    pState->ulEntry++;
+
+    return ok;
+}
+
+/**
+ * @brief Check if a record in the first column is a row of its own
+ * @param ucRecType [in] the record type of the first column
+ * @return true for a log status or a time change
+ */
+static bool TL_Block_Row_Single(uint8_t ucRecType)
+{
+    return (ucRecType == TL_TYPE_STATUS) || (ucRecType == TL_TYPE_DELTA);
+}
+
+/**
+ * @brief Encode a row of records after the others in a block
+ * @param pBlock [in] the block
+ * @param pStates [in,out] the encoder state of each column
+ * @param ulColumns [in] number of columns
+ * @param pRow [in] the records of the row, one for each column, with
+ *  the timestamp of the row in the first record
+ * @return true if the row fits in the block
+ */
+static bool TL_Block_Encode(uint8_t *pBlock,
+    TL_BLOCK_STATE *pStates,
+    uint32_t ulColumns,
+    const TL_DATA_REC *pRow)
+{
+    uint32_t *pulBit = &pStates[0].ulBit;
+    uint32_t ulColumn;
+    bool ok;
+
+    ok = TL_Block_Encode_Time(pBlock, &pStates[0], pRow[0].tTimeStamp) &&
+        TL_Block_Encode_Value(pBlock, pulBit, &pStates[0], &pRow[0]);
+    if (!TL_Block_Row_Single(pRow[0].ucRecType)) {
+        for (ulColumn = 1; ok && (ulColumn < ulColumns); ulColumn++) {
+            ok = TL_Block_Encode_Value(
+                pBlock, pulBit, &pStates[ulColumn], &pRow[ulColumn]);
+        }
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Decode the timestamp of the next record of a block
+ * @param pBlock [in] the block
+ * @param pState [in,out] the decoder state after the record before
+ * @return the timestamp of the record
+ */
+static bacnet_time_t
+TL_Block_Decode_Time(const uint8_t *pBlock, TL_BLOCK_STATE *pState)
+{
+    uint32_t *pulBit = &pState->ulBit;
+    bacnet_time_t tTimeStamp;
+    int64_t lDelta = 0;
+    int64_t lChange = 0;
+    unsigned uiPrefix = 0;
+
+    if (pState->ulEntry == 0) {
+        tTimeStamp = (bacnet_time_t)TL_Bits_Get(pBlock, pulBit, TL_TIME_BITS);
+    } else {
+        /* the prefix is up to four one bits, ended by a zero bit */
+        while ((uiPrefix < 4) && TL_Bits_Get(pBlock, pulBit, 1)) {
+            uiPrefix++;
+        }
+        switch (uiPrefix) {
+            case 0:
+                break;
+            case 1:
+                lChange = (int64_t)TL_Bits_Get(pBlock, pulBit, 7) - 63;
+                break;
+            case 2:
+                lChange = (int64_t)TL_Bits_Get(pBlock, pulBit, 9) - 255;
+                break;
+            case 3:
+                lChange = (int64_t)TL_Bits_Get(pBlock, pulBit, 12) - 2047;
+                break;
+            default:
+                break;
+        }
+        if (uiPrefix < 4) {
+            lDelta = pState->lDelta + lChange;
+            if (lDelta >= 0) {
+                tTimeStamp = pState->tTimeStamp + (bacnet_time_t)lDelta;
+            } else {
+                tTimeStamp = pState->tTimeStamp - (bacnet_time_t)(-lDelta);
+            }
+        } else {
+            tTimeStamp =
+                (bacnet_time_t)TL_Bits_Get(pBlock, pulBit, TL_TIME_BITS);
+            if (!TL_Time_Delta(pState->tTimeStamp, tTimeStamp, &lDelta)) {
+                lDelta = 0;
+            }
+        }
+    }
+    pState->tTimeStamp = tTimeStamp;
+    pState->lDelta = lDelta;
+
+    return tTimeStamp;
+}
+
+/**
+ * @brief Decode the value of the next record of a column of a block
+ * @param pBlock [in] the block
+ * @param pulBit [in,out] the next bit of the block
+ * @param pState [in,out] the decoder state of the column
+ * @param pRec [in,out] the record, with its timestamp already decoded
+ */
+static void TL_Block_Decode_Value(const uint8_t *pBlock,
+    uint32_t *pulBit,
+    TL_BLOCK_STATE *pState,
+    TL_DATA_REC *pRec)
+{
+    uint32_t ulValue = 0;
+    uint32_t ulXor = 0;
+
+    if ((pState->ulEntry == 0) || TL_Bits_Get(pBlock, pulBit, 1)) {
+        pRec->ucRecType = (uint8_t)TL_Bits_Get(pBlock, pulBit, 4);
+        pRec->ucStatus = (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+    } else {
+        pRec->ucRecType = pState->ucRecType;
+        pRec->ucStatus = pState->ucStatus;
+    }
+    if (TL_Value_32(pRec->ucRecType)) {
+        if (pState->ulEntry == 0) {
+            ulValue = (uint32_t)TL_Bits_Get(pBlock, pulBit, 32);
+        } else {
+            if (TL_Bits_Get(pBlock, pulBit, 1)) {
+                if (TL_Bits_Get(pBlock, pulBit, 1)) {
+                    pState->ucLeading =
+                        (uint8_t)TL_Bits_Get(pBlock, pulBit, 5);
+                    pState->ucLength =
+                        (uint8_t)TL_Bits_Get(pBlock, pulBit, 5) + 1;
+                }
+                ulXor = (uint32_t)TL_Bits_Get(
+                    pBlock, pulBit, pState->ucLength);
+                ulXor <<= (32 - pState->ucLeading - pState->ucLength);
+            }
+            ulValue = pState->ulValue ^ ulXor;
+        }
+        pState->ulValue = ulValue;
+    }
+    switch (pRec->ucRecType) {
+        case TL_TYPE_STATUS:
+            pRec->Datum.ucLogStatus = (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+            break;
+        case TL_TYPE_BOOL:
+            pRec->Datum.ucBoolean = (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+            break;
+        case TL_TYPE_REAL:
+            memcpy(&pRec->Datum.fReal, &ulValue, sizeof(ulValue));
+            break;
+        case TL_TYPE_DELTA:
+            memcpy(&pRec->Datum.fTime, &ulValue, sizeof(ulValue));
+            break;
+        case TL_TYPE_ENUM:
+            pRec->Datum.ulEnum = ulValue;
+            break;
+        case TL_TYPE_UNSIGN:
+            pRec->Datum.ulUValue = ulValue;
+            break;
+        case TL_TYPE_SIGN:
+            pRec->Datum.lSValue = (int32_t)ulValue;
+            break;
+        case TL_TYPE_NULL:
+            break;
+        case TL_TYPE_ERROR:
+            pRec->Datum.Error.usClass =
+                (uint16_t)TL_Bits_Get(pBlock, pulBit, 16);
+            pRec->Datum.Error.usCode =
+                (uint16_t)TL_Bits_Get(pBlock, pulBit, 16);
+            break;
+        default:
+            pRec->Datum.Bits.ucLen = (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+            pRec->Datum.Bits.ucStore[0] =
+                (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+            pRec->Datum.Bits.ucStore[1] =
+                (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+            pRec->Datum.Bits.ucStore[2] =
+                (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+            pRec->Datum.Bits.ucStore[3] =
+                (uint8_t)TL_Bits_Get(pBlock, pulBit, 8);
+            break;
+    }
+    pState->ucRecType = pRec->ucRecType;
+    pState->ucStatus = pRec->ucStatus;
+    pState->ulEntry++;
+}
+
+/**
+ * @brief Decode the next row of records of a block
+ * @param pBlock [in] the block
+ * @param pStates [in,out] the decoder state of each column
+ * @param ulColumns [in] number of columns
+ * @param pRow [out] the records of the row, one for each column. Only the
+ *  first record is decoded for a log status or a time change.
+ */
+static void TL_Block_Decode(const uint8_t *pBlock,
+    TL_BLOCK_STATE *pStates,
+    uint32_t ulColumns,
+    TL_DATA_REC *pRow)
+{
+    uint32_t *pulBit = &pStates[0].ulBit;
+    bacnet_time_t tTimeStamp;
+    uint32_t ulColumn;
+
+    memset(pRow, 0, sizeof(*pRow) * ulColumns);
+    tTimeStamp = TL_Block_Decode_Time(pBlock, &pStates[0]);
+    pRow[0].tTimeStamp = tTimeStamp;
+    TL_Block_Decode_Value(pBlock, pulBit, &pStates[0], &pRow[0]);
+    if (!TL_Block_Row_Single(pRow[0].ucRecType)) {
+        for (ulColumn = 1; ulColumn < ulColumns; ulColumn++) {
+            pRow[ulColumn].tTimeStamp = tTimeStamp;
+            TL_Block_Decode_Value(
+                pBlock, pulBit, &pStates[ulColumn], &pRow[ulColumn]);
+        }
+    }
+}
+
+/**
+ * @brief Get a block of the ring
+ * @param pLog [in] the ring of blocks
+ * @param ulBlock [in] the block, 0 being the oldest
+ * @return the block
+ */
+static uint8_t *TL_Block_Address(const TL_BLOCK_LOG *pLog, uint32_t ulBlock)
+{
+    return &pLog->pBuffer
+                [((pLog->ulFirst + ulBlock) % pLog->ulBlocks) * TL_BLOCK_SIZE];
+}
+
+/**
+ * @brief Get the number of records in a block
+ * @param pBlock [in] the block
+ * @return number of records
+ */
+static uint16_t TL_Block_Records(const uint8_t *pBlock)
+{
+    return (uint16_t)((pBlock[0] << 8) | pBlock[1]);
+}
+
+/**
+ * @brief Set the number of records in a block
+ * @param pBlock [in] the block
+ * @param count [in] number of records
+ */
+static void TL_Block_Records_Set(uint8_t *pBlock, uint16_t count)
+{
+    pBlock[0] = (uint8_t)(count >> 8);
+    pBlock[1] = (uint8_t)(count & 0xFF);
+}
+
+/**
+ * @brief Get the most rows of records that one block can hold
+ * @param ulColumns [in] number of columns
+ * @return number of rows
+ */
+static uint32_t TL_Block_Records_Max(uint32_t ulColumns)
+{
+    uint32_t count;
+
+    /* the first row, then rows of the same interval and NULL values */
+    count = 1 +
+        ((TL_BLOCK_BITS - TL_BLOCK_HEADER_BITS - TL_TIME_BITS -
+          (ulColumns * TL_VALUE_BITS_FIRST)) /
+            (1 + (ulColumns * TL_VALUE_BITS_MIN)));
+    if (count > UINT16_MAX) {
+        count = UINT16_MAX;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Initialize a ring of blocks of compressed records
+ * @param pLog [out] the ring of blocks
+ * @param pBuffer [in] memory for the blocks
+ * @param size [in] number of octets of memory, for two blocks or more
+ * @return true if the ring was initialized
+ */
+bool TL_Block_Init(TL_BLOCK_LOG *pLog, uint8_t *pBuffer, size_t size)
+{
+    return TL_Block_Rows_Init(pLog, pBuffer, size, 1, NULL, NULL);
+}
+
+/**
+ * @brief Initialize a ring of blocks of compressed rows of records, each
+ *  row having one record for each column and sharing one timestamp
+ * @param pLog [out] the ring of blocks
+ * @param pBuffer [in] memory for the blocks
+ * @param size [in] number of octets of memory, for two blocks or more
+ * @param ulColumns [in] number of columns, which must fit in one block
+ * @param pStates [in] memory for three states for each column, or NULL
+ *  for a single column
+ * @param pRecords [in] memory for one record for each column, or NULL
+ *  for a single column
+ * @return true if the ring was initialized
+ */
+bool TL_Block_Rows_Init(TL_BLOCK_LOG *pLog,
+    uint8_t *pBuffer,
+    size_t size,
+    uint32_t ulColumns,
+    TL_BLOCK_STATE *pStates,
+    TL_DATA_REC *pRecords)
+{
+    size_t blocks;
+
+    if (!pLog || !pBuffer || (ulColumns == 0)) {
+        return false;
+    }
+    if ((ulColumns > 1) && (!pStates || !pRecords)) {
+        return false;
+    }
+    /* every first row of a block must fit */
+    if ((TL_BLOCK_HEADER_BITS + TL_TIME_BITS +
+         (ulColumns * TL_VALUE_BITS_FIRST_MAX)) > TL_BLOCK_BITS) {
+        return false;
+    }
+    blocks = size / TL_BLOCK_SIZE;
+    if (blocks < 2) {
+        return false;
+    }
+    /* the number of records must fit the Buffer_Size property */
+    if (blocks > (INT_MAX / TL_Block_Records_Max(ulColumns))) {
+        blocks = INT_MAX / TL_Block_Records_Max(ulColumns);
+    }
+    memset(pLog, 0, sizeof(*pLog));
+    pLog->pBuffer = pBuffer;
+    pLog->ulBlocks = (uint32_t)blocks;
+    pLog->ulColumns = ulColumns;
+    if (!pStates) {
+        pStates = &pLog->States[0];
+    }
+    if (!pRecords) {
+        pRecords = &pLog->Record;
+    }
+    pLog->pWriter = &pStates[0];
+    pLog->pScratch = &pStates[ulColumns];
+    pLog->pReader = &pStates[ulColumns * 2];
+    pLog->pRecord = pRecords;
+    TL_Block_Clear(pLog);
+
+    return true;
+}
+
+/**
+ * @brief Remove all the records from a ring of blocks
+ * @param pLog [in] the ring of blocks
+ */
+void TL_Block_Clear(TL_BLOCK_LOG *pLog)
+{
+    if (pLog && pLog->pWriter) {
+        pLog->ulFirst = 0;
+        pLog->ulUsed = 0;
+        pLog->ulRecordCount = 0;
+        memset(pLog->pWriter, 0, sizeof(TL_BLOCK_STATE) * pLog->ulColumns);
+        pLog->bCursor = false;
+    }
+}
+
+/**
+ * @brief Add a record after the newest record in a ring of blocks. When
+ *  the ring is full, the oldest block of records is dropped.
+ * @param pLog [in] the ring of blocks
+ * @param pRec [in] the record
+ * @return true if the record was added
+ */
+bool TL_Block_Insert(TL_BLOCK_LOG *pLog, const TL_DATA_REC *pRec)
+{
+    if (!pLog || (pLog->ulColumns != 1)) {
+        return false;
+    }
+
+    return TL_Block_Row_Insert(pLog, pRec);
+}
+
+/**
+ * @brief Add a row of records after the newest row in a ring of blocks.
+ *  When the ring is full, the oldest block of rows is dropped.
+ * @param pLog [in] the ring of blocks
+ * @param pRow [in] the records of the row, one for each column, with the
+ *  timestamp of the row in the first record. Only the first record is
+ *  used for a log status or a time change.
+ * @return true if the row was added
+ */
+bool TL_Block_Row_Insert(TL_BLOCK_LOG *pLog, const TL_DATA_REC *pRow)
+{
+    size_t states;
+    uint32_t ulColumn;
+    uint8_t *pBlock;
+    uint16_t count;
+
+    if (!pLog || !pLog->pWriter || !pRow || (pRow[0].ucRecType > 0xF)) {
+        return false;
+    }
+    if (!TL_Block_Row_Single(pRow[0].ucRecType)) {
+        for (ulColumn = 1; ulColumn < pLog->ulColumns; ulColumn++) {
+            if (pRow[ulColumn].ucRecType > 0xF) {
+                return false;
+            }
+        }
+    }
+    states = sizeof(TL_BLOCK_STATE) * pLog->ulColumns;
+    if (pLog->ulUsed > 0) {
+        pBlock = TL_Block_Address(pLog, pLog->ulUsed - 1);
+        count = TL_Block_Records(pBlock);
+        memcpy(pLog->pScratch, pLog->pWriter, states);
+        if ((count < UINT16_MAX) &&
+            TL_Block_Encode(pBlock, pLog->pScratch, pLog->ulColumns, pRow)) {
+            memcpy(pLog->pWriter, pLog->pScratch, states);
+            TL_Block_Records_Set(pBlock, count + 1);
+            pLog->ulRecordCount++;
+            return true;
+        }
+    }
+    if (pLog->ulUsed == pLog->ulBlocks) {
+        /* make room for a new block */
+        pBlock = TL_Block_Address(pLog, 0);
+        pLog->ulRecordCount -= TL_Block_Records(pBlock);
+        pLog->ulFirst = (pLog->ulFirst + 1) % pLog->ulBlocks;
+        pLog->ulUsed--;
+        pLog->bCursor = false;
+    }
+    pLog->ulUsed++;
+    pBlock = TL_Block_Address(pLog, pLog->ulUsed - 1);
+    memset(pLog->pWriter, 0, states);
+    pLog->pWriter[0].ulBit = TL_BLOCK_HEADER_BITS;
+    (void)TL_Block_Encode(pBlock, pLog->pWriter, pLog->ulColumns, pRow);
+    TL_Block_Records_Set(pBlock, 1);
+    pLog->ulRecordCount++;
+
+    return true;
+}
+
+/**
+ * @brief Get a record from a ring of blocks. Reading the records in order
+ *  decodes each record once.
+ * @param pLog [in] the ring of blocks
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest record
+ * @return the record, which is valid until the next call, or NULL
+ */
+TL_DATA_REC *TL_Block_Entry(TL_BLOCK_LOG *pLog, uint32_t uiEntry)
+{
+    return TL_Block_Row_Entry(pLog, uiEntry);
+}
+
+/**
+ * @brief Get a row of records from a ring of blocks. Reading the rows in
+ *  order decodes each row once.
+ * @param pLog [in] the ring of blocks
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest row
+ * @return the records of the row, one for each column, which are valid
+ *  until the next call, or NULL
+ */
+TL_DATA_REC *TL_Block_Row_Entry(TL_BLOCK_LOG *pLog, uint32_t uiEntry)
+{
+    TL_BLOCK_STATE *pReader;
+    const uint8_t *pBlock;
+    uint32_t ulBlock = 0;
+    uint32_t ulFirst = 1;
+    uint32_t ulCurrent;
+
+    if (!pLog || (uiEntry == 0) || (uiEntry > pLog->ulRecordCount)) {
+        return NULL;
+    }
+    pReader = pLog->pReader;
+    if (pLog->bCursor) {
+        pBlock = TL_Block_Address(pLog, pLog->ulCursorBlock);
+        ulCurrent = pLog->ulCursorFirst + pReader[0].ulEntry - 1;
+        if ((uiEntry >= ulCurrent) &&
+            (uiEntry < (pLog->ulCursorFirst + TL_Block_Records(pBlock)))) {
+            while (ulCurrent < uiEntry) {
+                TL_Block_Decode(
+                    pBlock, pReader, pLog->ulColumns, pLog->pRecord);
+                ulCurrent++;
+            }
+            return pLog->pRecord;
+        }
+        if (uiEntry >= pLog->ulCursorFirst) {
+            /* carry on from the block of the last record read */
+            ulBlock = pLog->ulCursorBlock;
+            ulFirst = pLog->ulCursorFirst;
+        }
+    }
+    pBlock = TL_Block_Address(pLog, ulBlock);
+    while (uiEntry >= (ulFirst + TL_Block_Records(pBlock))) {
+        ulFirst += TL_Block_Records(pBlock);
+        ulBlock++;
+        pBlock = TL_Block_Address(pLog, ulBlock);
+    }
+    pLog->bCursor = true;
+    pLog->ulCursorBlock = ulBlock;
+    pLog->ulCursorFirst = ulFirst;
+    memset(pReader, 0, sizeof(TL_BLOCK_STATE) * pLog->ulColumns);
+    pReader[0].ulBit = TL_BLOCK_HEADER_BITS;
+    for (ulCurrent = ulFirst; ulCurrent <= uiEntry; ulCurrent++) {
+        TL_Block_Decode(pBlock, pReader, pLog->ulColumns, pLog->pRecord);
+    }
+
+    return pLog->pRecord;
+}
+
+/**
+ * @brief Get the number of records in a ring of blocks
+ * @param pLog [in] the ring of blocks
+ * @return number of records
+ */
+uint32_t TL_Block_Count(const TL_BLOCK_LOG *pLog)
+{
+    if (!pLog) {
+        return 0;
+    }
+
+    return pLog->ulRecordCount;
+}
+
+/**
+ * @brief Get the most records that a ring of blocks can hold, which is
+ *  reached when the records repeat the same interval and value
+ * @param pLog [in] the ring of blocks
+ * @return number of records
+ */
+uint32_t TL_Block_Size(const TL_BLOCK_LOG *pLog)
+{
+    if (!pLog || (pLog->ulColumns == 0)) {
+        return 0;
+    }
+
+    return pLog->ulBlocks * TL_Block_Records_Max(pLog->ulColumns);
+}
+
+/**
+ * @brief Check if the next record could drop the oldest block of records
+ * @param pLog [in] the ring of blocks
+ * @return true if the ring of blocks is full
+ */
+bool TL_Block_Full(const TL_BLOCK_LOG *pLog)
+{
+    const uint8_t *pBlock;
+
+    if (!pLog || (pLog->ulUsed < pLog->ulBlocks)) {
+        return false;
+    }
+    pBlock = TL_Block_Address(pLog, pLog->ulUsed - 1);
+    if (TL_Block_Records(pBlock) == UINT16_MAX) {
+        return true;
+    }
+
+    return ((TL_BLOCK_BITS - pLog->pWriter[0].ulBit) <
+            (TL_TIME_BITS_MAX + (pLog->ulColumns * TL_VALUE_BITS_MAX)));
+}
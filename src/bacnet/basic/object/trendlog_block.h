@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief API for compressed storage of the records of a Trend Log, in
+ *  blocks of timestamps encoded as delta of deltas and of values encoded
+ *  as the exclusive or with the previous value. The records can be rows of
+ *  one record for each column that share one timestamp.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_TRENDLOG_BLOCK_H
+#define BACNET_BASIC_OBJECT_TRENDLOG_BLOCK_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/object/trendlog.h"
+
+/* number of octets in each block of records */
+#ifndef TL_BLOCK_SIZE
+#define TL_BLOCK_SIZE 256
+#endif
+
+/* State of the encoder or decoder after a record of a block */
+typedef struct tl_block_state {
+    uint32_t ulBit; /* next bit of the block */
+    uint32_t ulEntry; /* number of records before the next bit */
+    bacnet_time_t tTimeStamp; /* timestamp of the record */
+    int64_t lDelta; /* time since the record before */
+    uint32_t ulValue; /* last 32 bit value */
+    uint8_t ucLeading; /* leading zeros of the last exclusive or */
+    uint8_t ucLength; /* significant bits of the last exclusive or */
+    uint8_t ucRecType; /* type of the record */
+    uint8_t ucStatus; /* status flags of the record */
+} TL_BLOCK_STATE;
+
+/* A ring of blocks of compressed records */
+typedef struct tl_block_log {
+    uint8_t *pBuffer; /* the blocks */
+    uint32_t ulBlocks; /* number of blocks in the buffer */
+    uint32_t ulFirst; /* oldest block */
+    uint32_t ulUsed; /* number of blocks holding records */
+    uint32_t ulRecordCount; /* number of rows of records in the blocks */
+    uint32_t ulColumns; /* number of records in each row */
+    TL_BLOCK_STATE *pWriter; /* state of each column after the newest row */
+    TL_BLOCK_STATE *pScratch; /* state of each column while adding a row */
+    bool bCursor; /* true if the last row read is still valid */
+    uint32_t ulCursorBlock; /* block of the last row read, oldest is 0 */
+    uint32_t ulCursorFirst; /* position of the first row of the block */
+    TL_BLOCK_STATE *pReader; /* state of each column after the last read */
+    TL_DATA_REC *pRecord; /* the last row read */
+    TL_BLOCK_STATE States[3]; /* the states of a single column */
+    TL_DATA_REC Record; /* the last record read of a single column */
+} TL_BLOCK_LOG;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool TL_Block_Init(TL_BLOCK_LOG *pLog, uint8_t *pBuffer, size_t size);
+BACNET_STACK_EXPORT
+bool TL_Block_Rows_Init(TL_BLOCK_LOG *pLog,
+    uint8_t *pBuffer,
+    size_t size,
+    uint32_t ulColumns,
+    TL_BLOCK_STATE *pStates,
+    TL_DATA_REC *pRecords);
+BACNET_STACK_EXPORT
+void TL_Block_Clear(TL_BLOCK_LOG *pLog);
+BACNET_STACK_EXPORT
+bool TL_Block_Insert(TL_BLOCK_LOG *pLog, const TL_DATA_REC *pRec);
+BACNET_STACK_EXPORT
+TL_DATA_REC *TL_Block_Entry(TL_BLOCK_LOG *pLog, uint32_t uiEntry);
+BACNET_STACK_EXPORT
+bool TL_Block_Row_Insert(TL_BLOCK_LOG *pLog, const TL_DATA_REC *pRow);
+BACNET_STACK_EXPORT
+TL_DATA_REC *TL_Block_Row_Entry(TL_BLOCK_LOG *pLog, uint32_t uiEntry);
+BACNET_STACK_EXPORT
+uint32_t TL_Block_Count(const TL_BLOCK_LOG *pLog);
+BACNET_STACK_EXPORT
+uint32_t TL_Block_Size(const TL_BLOCK_LOG *pLog);
+BACNET_STACK_EXPORT
+bool TL_Block_Full(const TL_BLOCK_LOG *pLog);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,1171 @@
+/**
+ * @file
+ * @brief A basic BACnet Trend Log Multiple object implementation.
+ * @details The Trend Log Multiple objects sample each member of their
+ *  Log_DeviceObjectProperty array in one pass, through the value list of
+ *  the local object where it has one, and store the values as one row of
+ *  records that share a timestamp, in the compressed storage of a Trend
+ *  Log. The Log_Buffer is read with the ReadRange encoding of the Trend
+ *  Log objects, by position, by sequence number or by time, with all the
+ *  values of a row in one BACnetLogMultipleRecord.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <limits.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdevobjpropref.h"
+#include "bacnet/datetime.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/trendlog_multiple.h"
+
+/* every first row of a block holds a full value for each member */
+#if (16 + 64 + (TLM_MAX_MEMBERS * 52)) > (TL_BLOCK_SIZE * 8)
+#error "TL_BLOCK_SIZE is too small for TLM_MAX_MEMBERS"
+#endif
+
+/* Most octets of one encoded BACnetLogMultipleRecord: 12 for the
+ * timestamp, 4 for the context tags of the logData and its list, and 8
+ * for the largest value of each member, which is a failure */
+#define TLM_MAX_ENC(members) (16 + ((members) * 8))
+
+/* Structure containing config and status info for a Trend Log Multiple */
+typedef struct tlm_log_info {
+    bool bEnable; /* Trend log is active when this is true */
+    bool bStopWhenFull; /* Log halts when full if true */
+    BACNET_LOGGING_TYPE LoggingType; /* Polled or triggered */
+    uint32_t ulLogInterval; /* Time between entries in seconds */
+    bool bAlignIntervals; /* If true align to the clock */
+    uint32_t ulIntervalOffset; /* Offset from start of period in seconds */
+    bool bTrigger; /* Set to 1 to cause a reading to be taken */
+    bacnet_time_t tLastDataTime; /* When the last row was sampled */
+    uint32_t ulTotalRecordCount; /* Count of all rows ever inserted */
+    uint32_t ulOrderedCount; /* Count of newest rows in time order */
+    unsigned uiMembers; /* Number of members of the log */
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE Members[TLM_MAX_MEMBERS];
+    TL_BLOCK_LOG Blocks; /* Compressed rows of records */
+} TLM_LOG_INFO;
+
+static uint8_t TLM_Buffer[MAX_TREND_LOG_MULTIPLES][TLM_BLOCK_BUFFER_SIZE];
+static TL_BLOCK_STATE TLM_States[MAX_TREND_LOG_MULTIPLES]
+                                [3 * TLM_MAX_MEMBERS];
+static TL_DATA_REC TLM_Records[MAX_TREND_LOG_MULTIPLES][TLM_MAX_MEMBERS];
+static TLM_LOG_INFO TLM_Info[MAX_TREND_LOG_MULTIPLES];
+/* the row being sampled */
+static TL_DATA_REC TLM_Row[TLM_MAX_MEMBERS];
+
+/* These three arrays are used by the ReadPropertyMultiple handler */
+static const int Trend_Log_Multiple_Properties_Required[] = {
+    PROP_OBJECT_IDENTIFIER, PROP_OBJECT_NAME, PROP_OBJECT_TYPE,
+    PROP_STATUS_FLAGS, PROP_EVENT_STATE, PROP_ENABLE,
+    PROP_LOG_DEVICE_OBJECT_PROPERTY, PROP_LOGGING_TYPE, PROP_LOG_INTERVAL,
+    PROP_STOP_WHEN_FULL, PROP_BUFFER_SIZE, PROP_LOG_BUFFER,
+    PROP_RECORD_COUNT, PROP_TOTAL_RECORD_COUNT, -1
+};
+
+static const int Trend_Log_Multiple_Properties_Optional[] = {
+    PROP_DESCRIPTION, PROP_ALIGN_INTERVALS, PROP_INTERVAL_OFFSET,
+    PROP_TRIGGER, -1
+};
+
+static const int Trend_Log_Multiple_Properties_Proprietary[] = { -1 };
+
+/**
+ * @brief Returns the list of required, optional, and proprietary properties.
+ * @param pRequired - pointer to list of int terminated by -1, of
+ *  BACnet required properties for this object.
+ * @param pOptional - pointer to list of int terminated by -1, of
+ *  BACnet optional properties for this object.
+ * @param pProprietary - pointer to list of int terminated by -1, of
+ *  BACnet proprietary properties for this object.
+ */
+void Trend_Log_Multiple_Property_Lists(
+    const int **pRequired, const int **pOptional, const int **pProprietary)
+{
+    if (pRequired) {
+        *pRequired = Trend_Log_Multiple_Properties_Required;
+    }
+    if (pOptional) {
+        *pOptional = Trend_Log_Multiple_Properties_Optional;
+    }
+    if (pProprietary) {
+        *pProprietary = Trend_Log_Multiple_Properties_Proprietary;
+    }
+}
+
+/**
+ * @brief Determines if a given object instance is valid
+ * @param object_instance - object-instance number of the object
+ * @return true if the instance is valid, and false if not
+ */
+bool Trend_Log_Multiple_Valid_Instance(uint32_t object_instance)
+{
+    return (object_instance < MAX_TREND_LOG_MULTIPLES);
+}
+
+/**
+ * @brief Determines the number of objects
+ * @return Number of Trend Log Multiple objects
+ */
+unsigned Trend_Log_Multiple_Count(void)
+{
+    return MAX_TREND_LOG_MULTIPLES;
+}
+
+/**
+ * @brief Determines the object instance-number for a given 0..N index
+ * @param index - 0..N value
+ * @return object instance-number for the given index
+ */
+uint32_t Trend_Log_Multiple_Index_To_Instance(unsigned index)
+{
+    return index;
+}
+
+/**
+ * @brief For a given object instance-number, determines a 0..N index
+ * @param object_instance - object-instance number of the object
+ * @return index for the given instance-number, or MAX_TREND_LOG_MULTIPLES
+ *  if not valid.
+ */
+unsigned Trend_Log_Multiple_Instance_To_Index(uint32_t object_instance)
+{
+    unsigned index = MAX_TREND_LOG_MULTIPLES;
+
+    if (object_instance < MAX_TREND_LOG_MULTIPLES) {
+        index = object_instance;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Get the current time from the Device object
+ * @return current time in epoch seconds
+ */
+static bacnet_time_t Trend_Log_Multiple_Epoch_Seconds_Now(void)
+{
+    BACNET_DATE_TIME bdatetime;
+
+    Device_getCurrentDateTime(&bdatetime);
+    return datetime_seconds_since_epoch(&bdatetime);
+}
+
+/**
+ * @brief Get a row of a log from its position in the log
+ * @param CurrentLog [in] the log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest row
+ * @return the records of the row, one for each member
+ */
+static TL_DATA_REC *TLM_Entry(TLM_LOG_INFO *CurrentLog, uint32_t uiEntry)
+{
+    return TL_Block_Row_Entry(&CurrentLog->Blocks, uiEntry);
+}
+
+/**
+ * @brief Insert a row into a log
+ * @param CurrentLog [in] the log
+ * @param pRow [in] the records of the row, one for each member, or one
+ *  record for a log status or a time change
+ */
+static void TLM_Insert_Row(TLM_LOG_INFO *CurrentLog, const TL_DATA_REC *pRow)
+{
+    uint32_t ulRecordCount;
+
+    /* track the run of newest rows in time order for ReadRange */
+    ulRecordCount = TL_Block_Count(&CurrentLog->Blocks);
+    if ((ulRecordCount == 0) ||
+        (pRow[0].tTimeStamp <
+            TLM_Entry(CurrentLog, ulRecordCount)->tTimeStamp)) {
+        CurrentLog->ulOrderedCount = 1;
+    } else {
+        CurrentLog->ulOrderedCount++;
+    }
+    (void)TL_Block_Row_Insert(&CurrentLog->Blocks, pRow);
+    CurrentLog->ulTotalRecordCount++;
+    /* the oldest block of rows is dropped when the ring is full */
+    ulRecordCount = TL_Block_Count(&CurrentLog->Blocks);
+    if (CurrentLog->ulOrderedCount > ulRecordCount) {
+        CurrentLog->ulOrderedCount = ulRecordCount;
+    }
+}
+
+/**
+ * @brief Insert a status row into a log. Status rows go in even when the
+ *  log is disabled or full.
+ * @param CurrentLog [in] the log
+ * @param eStatus [in] the log status that changed
+ * @param bState [in] the new state of the log status
+ */
+static void TLM_Insert_Status_Rec(
+    TLM_LOG_INFO *CurrentLog, BACNET_LOG_STATUS eStatus, bool bState)
+{
+    TL_DATA_REC TempRec = { 0 };
+
+    TempRec.tTimeStamp = Trend_Log_Multiple_Epoch_Seconds_Now();
+    TempRec.ucRecType = TL_TYPE_STATUS;
+    if (bState || (eStatus == LOG_STATUS_LOG_INTERRUPTED)) {
+        /* in the order of the bits of the BACnetLogStatus bit string */
+        TempRec.Datum.ucLogStatus = (uint8_t)(1 << eStatus);
+    }
+    TLM_Insert_Row(CurrentLog, &TempRec);
+}
+
+/**
+ * @brief Make the storage of a log fit its members, which removes all
+ *  the rows of the log
+ * @param log_index [in] index of the log
+ */
+static void TLM_Blocks_Init(unsigned log_index)
+{
+    TLM_LOG_INFO *CurrentLog = &TLM_Info[log_index];
+    uint32_t ulColumns;
+
+    /* a log without members still records its log status */
+    ulColumns = CurrentLog->uiMembers;
+    if (ulColumns == 0) {
+        ulColumns = 1;
+    }
+    (void)TL_Block_Rows_Init(&CurrentLog->Blocks, &TLM_Buffer[log_index][0],
+        sizeof(TLM_Buffer[log_index]), ulColumns, &TLM_States[log_index][0],
+        &TLM_Records[log_index][0]);
+    CurrentLog->ulOrderedCount = 0;
+}
+
+/**
+ * @brief Initializes the Trend Log Multiple objects, which start out
+ *  enabled, empty and without members, polled every 15 minutes
+ */
+void Trend_Log_Multiple_Init(void)
+{
+    unsigned i;
+
+    for (i = 0; i < MAX_TREND_LOG_MULTIPLES; i++) {
+        memset(&TLM_Info[i], 0, sizeof(TLM_Info[i]));
+        TLM_Info[i].bEnable = true;
+        TLM_Info[i].LoggingType = LOGGING_TYPE_POLLED;
+        TLM_Info[i].ulLogInterval = 900;
+        TLM_Blocks_Init(i);
+    }
+}
+
+/**
+ * @brief Check if a member refers to a property of this device
+ * @param pMember [in] the member
+ * @return true if the member can be logged
+ */
+static bool
+TLM_Member_Valid(const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember)
+{
+    /* We only support references to objects in ourself for now */
+    if ((pMember->deviceIdentifier.type == OBJECT_DEVICE) &&
+        (pMember->deviceIdentifier.instance !=
+            Device_Object_Instance_Number())) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set the members of a log, which purges the log if they changed
+ * @param object_instance [in] BACnet object instance number
+ * @param pMembers [in] the properties to log
+ * @param count [in] number of members, up to TLM_MAX_MEMBERS
+ * @return true if the members were set
+ */
+bool Trend_Log_Multiple_Members_Set(uint32_t object_instance,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMembers,
+    unsigned count)
+{
+    TLM_LOG_INFO *CurrentLog;
+    unsigned log_index;
+    unsigned i;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if ((log_index >= MAX_TREND_LOG_MULTIPLES) || (count > TLM_MAX_MEMBERS) ||
+        (!pMembers && (count > 0))) {
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        if (!TLM_Member_Valid(&pMembers[i])) {
+            return false;
+        }
+    }
+    CurrentLog = &TLM_Info[log_index];
+    if (count == CurrentLog->uiMembers) {
+        for (i = 0; i < count; i++) {
+            if (!bacnet_device_object_property_reference_same(
+                    &pMembers[i], &CurrentLog->Members[i])) {
+                break;
+            }
+        }
+        if (i == count) {
+            return true;
+        }
+    }
+    /* Clear buffer if the properties being logged are changed */
+    if (count > 0) {
+        memcpy(CurrentLog->Members, pMembers, count * sizeof(pMembers[0]));
+    }
+    CurrentLog->uiMembers = count;
+    TLM_Blocks_Init(log_index);
+    TLM_Insert_Status_Rec(CurrentLog, LOG_STATUS_BUFFER_PURGED, true);
+
+    return true;
+}
+
+/**
+ * @brief Get the number of members of a log
+ * @param object_instance [in] BACnet object instance number
+ * @return number of members, or 0 if the object instance is not valid
+ */
+unsigned Trend_Log_Multiple_Member_Count(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return 0;
+    }
+
+    return TLM_Info[log_index].uiMembers;
+}
+
+/**
+ * @brief Get the most rows that the buffer of a log holds, which is
+ *  reached when the rows repeat the same interval and values
+ * @param object_instance [in] BACnet object instance number
+ * @return number of rows, or 0 if the object instance is not valid
+ */
+uint32_t Trend_Log_Multiple_Buffer_Size(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return 0;
+    }
+
+    return TL_Block_Size(&TLM_Info[log_index].Blocks);
+}
+
+/**
+ * @brief Get the number of rows in a log
+ * @param object_instance [in] BACnet object instance number
+ * @return number of rows, or 0 if the object instance is not valid
+ */
+uint32_t Trend_Log_Multiple_Record_Count(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return 0;
+    }
+
+    return TL_Block_Count(&TLM_Info[log_index].Blocks);
+}
+
+/**
+ * @brief Get the number of rows ever inserted into a log, which is the
+ *  sequence number of the newest row
+ * @param object_instance [in] BACnet object instance number
+ * @return number of rows, or 0 if the object instance is not valid
+ */
+uint32_t Trend_Log_Multiple_Total_Record_Count(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return 0;
+    }
+
+    return TLM_Info[log_index].ulTotalRecordCount;
+}
+
+/**
+ * @brief Get the Enable property of a log
+ * @param object_instance [in] BACnet object instance number
+ * @return true if the log records its members
+ */
+bool Trend_Log_Multiple_Enable(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return false;
+    }
+
+    return TLM_Info[log_index].bEnable;
+}
+
+/**
+ * @brief Set the Enable property of a log, and record the change with a
+ *  log-disabled status row
+ * @param object_instance [in] BACnet object instance number
+ * @param enable [in] true to record the members
+ * @return true if the property was set, false if the instance is not
+ *  valid, or the log is full and stops when full
+ */
+bool Trend_Log_Multiple_Enable_Set(uint32_t object_instance, bool enable)
+{
+    TLM_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return false;
+    }
+    CurrentLog = &TLM_Info[log_index];
+    if (enable && !CurrentLog->bEnable && CurrentLog->bStopWhenFull &&
+        TL_Block_Full(&CurrentLog->Blocks)) {
+        /* a full log which stops when full can't be enabled */
+        return false;
+    }
+    if (CurrentLog->bEnable != enable) {
+        CurrentLog->bEnable = enable;
+        TLM_Insert_Status_Rec(CurrentLog, LOG_STATUS_LOG_DISABLED, !enable);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Set the Log_Interval of a polled log
+ * @param object_instance [in] BACnet object instance number
+ * @param seconds [in] time between rows, which is not zero
+ * @return true if the interval was set
+ */
+bool Trend_Log_Multiple_Log_Interval_Set(
+    uint32_t object_instance, uint32_t seconds)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if ((log_index >= MAX_TREND_LOG_MULTIPLES) || (seconds == 0) ||
+        (TLM_Info[log_index].LoggingType != LOGGING_TYPE_POLLED)) {
+        return false;
+    }
+    TLM_Info[log_index].ulLogInterval = seconds;
+
+    return true;
+}
+
+/**
+ * @brief Ask a log to sample its members at the next timer call, as a
+ *  write of true to its Trigger property does
+ * @param object_instance [in] BACnet object instance number
+ * @return true if the trigger was set
+ */
+bool Trend_Log_Multiple_Trigger(uint32_t object_instance)
+{
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return false;
+    }
+    TLM_Info[log_index].bTrigger = true;
+
+    return true;
+}
+
+/**
+ * @brief Get the object name of a log
+ * @param object_instance [in] BACnet object instance number
+ * @param object_name [out] the object name
+ * @return true if the object name was set
+ */
+bool Trend_Log_Multiple_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
+{
+    char text[32] = "";
+    bool status = false;
+
+    if (object_instance < MAX_TREND_LOG_MULTIPLES) {
+        snprintf(text, sizeof(text), "Trend Log Multiple %lu",
+            (unsigned long)object_instance);
+        status = characterstring_init_ansi(object_name, text);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Encode a member of the Log_DeviceObjectProperty array
+ * @param object_instance [in] BACnet object instance number
+ * @param index [in] 0 based index of the member
+ * @param apdu [out] buffer for the member, or NULL for its length
+ * @return number of bytes encoded, or BACNET_STATUS_ERROR
+ */
+static int Trend_Log_Multiple_Member_Encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu)
+{
+    TLM_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return BACNET_STATUS_ERROR;
+    }
+    CurrentLog = &TLM_Info[log_index];
+    if (index >= CurrentLog->uiMembers) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return bacapp_encode_device_obj_property_ref(
+        apdu, &CurrentLog->Members[index]);
+}
+
+/**
+ * @brief ReadProperty handler for this object. For the given ReadProperty
+ *  data, the application_data is loaded or the error flags are set.
+ * @param  rpdata - BACNET_READ_PROPERTY_DATA data, including
+ *  requested data and space for the reply, or error response.
+ * @return number of APDU bytes in the response, or
+ *  BACNET_STATUS_ERROR on error.
+ */
+int Trend_Log_Multiple_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
+{
+    int apdu_len = 0;
+    BACNET_BIT_STRING bit_string;
+    BACNET_CHARACTER_STRING char_string;
+    TLM_LOG_INFO *CurrentLog;
+    unsigned log_index;
+    uint8_t *apdu = NULL;
+
+    if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
+        (rpdata->application_data_len == 0)) {
+        return 0;
+    }
+    log_index = Trend_Log_Multiple_Instance_To_Index(rpdata->object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        rpdata->error_class = ERROR_CLASS_OBJECT;
+        rpdata->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return BACNET_STATUS_ERROR;
+    }
+    CurrentLog = &TLM_Info[log_index];
+    apdu = rpdata->application_data;
+    switch (rpdata->object_property) {
+        case PROP_OBJECT_IDENTIFIER:
+            apdu_len = encode_application_object_id(
+                &apdu[0], OBJECT_TREND_LOG_MULTIPLE, rpdata->object_instance);
+            break;
+        case PROP_DESCRIPTION:
+        case PROP_OBJECT_NAME:
+            Trend_Log_Multiple_Object_Name(
+                rpdata->object_instance, &char_string);
+            apdu_len =
+                encode_application_character_string(&apdu[0], &char_string);
+            break;
+        case PROP_OBJECT_TYPE:
+            apdu_len = encode_application_enumerated(
+                &apdu[0], OBJECT_TREND_LOG_MULTIPLE);
+            break;
+        case PROP_STATUS_FLAGS:
+            bitstring_init(&bit_string);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
+            bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, false);
+            apdu_len = encode_application_bitstring(&apdu[0], &bit_string);
+            break;
+        case PROP_EVENT_STATE:
+            apdu_len =
+                encode_application_enumerated(&apdu[0], EVENT_STATE_NORMAL);
+            break;
+        case PROP_ENABLE:
+            apdu_len =
+                encode_application_boolean(&apdu[0], CurrentLog->bEnable);
+            break;
+        case PROP_LOG_DEVICE_OBJECT_PROPERTY:
+            apdu_len = bacnet_array_encode(rpdata->object_instance,
+                rpdata->array_index, Trend_Log_Multiple_Member_Encode,
+                CurrentLog->uiMembers, apdu, rpdata->application_data_len);
+            if (apdu_len == BACNET_STATUS_ABORT) {
+                rpdata->error_code =
+                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+            } else if (apdu_len == BACNET_STATUS_ERROR) {
+                rpdata->error_class = ERROR_CLASS_PROPERTY;
+                rpdata->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+            }
+            break;
+        case PROP_LOGGING_TYPE:
+            apdu_len = encode_application_enumerated(
+                &apdu[0], CurrentLog->LoggingType);
+            break;
+        case PROP_LOG_INTERVAL:
+            /* We only log to 1 sec accuracy so must multiply by 100 before
+             * passing it on */
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulLogInterval * 100);
+            break;
+        case PROP_STOP_WHEN_FULL:
+            apdu_len =
+                encode_application_boolean(&apdu[0], CurrentLog->bStopWhenFull);
+            break;
+        case PROP_BUFFER_SIZE:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], TL_Block_Size(&CurrentLog->Blocks));
+            break;
+        case PROP_LOG_BUFFER:
+            /* You can only read the buffer via the ReadRange service */
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_READ_ACCESS_DENIED;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+        case PROP_RECORD_COUNT:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], TL_Block_Count(&CurrentLog->Blocks));
+            break;
+        case PROP_TOTAL_RECORD_COUNT:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulTotalRecordCount);
+            break;
+        case PROP_ALIGN_INTERVALS:
+            apdu_len = encode_application_boolean(
+                &apdu[0], CurrentLog->bAlignIntervals);
+            break;
+        case PROP_INTERVAL_OFFSET:
+            apdu_len = encode_application_unsigned(
+                &apdu[0], CurrentLog->ulIntervalOffset * 100);
+            break;
+        case PROP_TRIGGER:
+            apdu_len =
+                encode_application_boolean(&apdu[0], CurrentLog->bTrigger);
+            break;
+        default:
+            rpdata->error_class = ERROR_CLASS_PROPERTY;
+            rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            apdu_len = BACNET_STATUS_ERROR;
+            break;
+    }
+    /*  only array properties can have array options */
+    if ((apdu_len >= 0) &&
+        (rpdata->object_property != PROP_LOG_DEVICE_OBJECT_PROPERTY) &&
+        (rpdata->array_index != BACNET_ARRAY_ALL)) {
+        rpdata->error_class = ERROR_CLASS_PROPERTY;
+        rpdata->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        apdu_len = BACNET_STATUS_ERROR;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Write the Log_DeviceObjectProperty array of a log, or one of
+ *  its members
+ * @param  wp_data - BACNET_WRITE_PROPERTY_DATA data, including
+ *  requested data and space for the reply, or error response.
+ * @return false if an error is loaded, true if no errors
+ */
+static bool Trend_Log_Multiple_Members_Write(
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE Members[TLM_MAX_MEMBERS];
+    TLM_LOG_INFO *CurrentLog;
+    unsigned count = 0;
+    int apdu_len = 0;
+    int len = 0;
+
+    CurrentLog = &TLM_Info[Trend_Log_Multiple_Instance_To_Index(
+        wp_data->object_instance)];
+    if (wp_data->array_index == 0) {
+        /* the size follows from the members that are written */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    }
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        if (wp_data->array_index > CurrentLog->uiMembers) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+            return false;
+        }
+        count = CurrentLog->uiMembers;
+        memcpy(Members, CurrentLog->Members, count * sizeof(Members[0]));
+        len = bacnet_device_object_property_reference_decode(
+            wp_data->application_data, wp_data->application_data_len,
+            &Members[wp_data->array_index - 1]);
+    } else {
+        while (apdu_len < wp_data->application_data_len) {
+            if (count >= TLM_MAX_MEMBERS) {
+                wp_data->error_class = ERROR_CLASS_RESOURCES;
+                wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+                return false;
+            }
+            len = bacnet_device_object_property_reference_decode(
+                &wp_data->application_data[apdu_len],
+                wp_data->application_data_len - apdu_len, &Members[count]);
+            if (len <= 0) {
+                break;
+            }
+            apdu_len += len;
+            count++;
+        }
+    }
+    if (len <= 0) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return false;
+    }
+    if (!Trend_Log_Multiple_Members_Set(
+            wp_data->object_instance, Members, count)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief WriteProperty handler for this object. For the given WriteProperty
+ *  data, the application_data is loaded or the error flags are set.
+ * @param  wp_data - BACNET_WRITE_PROPERTY_DATA data, including
+ *  requested data and space for the reply, or error response.
+ * @return false if an error is loaded, true if no errors
+ */
+bool Trend_Log_Multiple_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    bool status = false;
+    int len = 0;
+    BACNET_APPLICATION_DATA_VALUE value;
+    TLM_LOG_INFO *CurrentLog;
+    unsigned log_index;
+
+    log_index = Trend_Log_Multiple_Instance_To_Index(wp_data->object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    CurrentLog = &TLM_Info[log_index];
+    if (wp_data->object_property == PROP_LOG_DEVICE_OBJECT_PROPERTY) {
+        return Trend_Log_Multiple_Members_Write(wp_data);
+    }
+    len = bacapp_decode_application_data(
+        wp_data->application_data, wp_data->application_data_len, &value);
+    if (len < 0) {
+        /* error while decoding - a value larger than we can handle */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return false;
+    }
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        /*  only array properties can have array options */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
+        return false;
+    }
+    switch (wp_data->object_property) {
+        case PROP_ENABLE:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status &&
+                !Trend_Log_Multiple_Enable_Set(
+                    wp_data->object_instance, value.type.Boolean)) {
+                status = false;
+                wp_data->error_class = ERROR_CLASS_OBJECT;
+                wp_data->error_code = ERROR_CODE_LOG_BUFFER_FULL;
+            }
+            break;
+        case PROP_STOP_WHEN_FULL:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status &&
+                (CurrentLog->bStopWhenFull != value.type.Boolean)) {
+                CurrentLog->bStopWhenFull = value.type.Boolean;
+                if (CurrentLog->bStopWhenFull && CurrentLog->bEnable &&
+                    TL_Block_Full(&CurrentLog->Blocks)) {
+                    /* a full log stops when it is switched to stop
+                       when full */
+                    CurrentLog->bEnable = false;
+                    TLM_Insert_Status_Rec(
+                        CurrentLog, LOG_STATUS_LOG_DISABLED, true);
+                }
+            }
+            break;
+        case PROP_RECORD_COUNT:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                if (value.type.Unsigned_Int == 0) {
+                    TL_Block_Clear(&CurrentLog->Blocks);
+                    CurrentLog->ulOrderedCount = 0;
+                    TLM_Insert_Status_Rec(
+                        CurrentLog, LOG_STATUS_BUFFER_PURGED, true);
+                } else {
+                    status = false;
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                }
+            }
+            break;
+        case PROP_LOGGING_TYPE:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_ENUMERATED);
+            if (!status) {
+                break;
+            }
+            if (value.type.Enumerated == LOGGING_TYPE_POLLED) {
+                CurrentLog->LoggingType = LOGGING_TYPE_POLLED;
+                /* As per 12.25.27 pick a suitable default if interval
+                 * is 0 */
+                if (CurrentLog->ulLogInterval == 0) {
+                    CurrentLog->ulLogInterval = 900;
+                }
+            } else if (value.type.Enumerated == LOGGING_TYPE_TRIGGERED) {
+                CurrentLog->LoggingType = LOGGING_TYPE_TRIGGERED;
+                CurrentLog->ulLogInterval = 0;
+            } else {
+                /* COV logging of many members is not supported */
+                status = false;
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code =
+                    ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+            }
+            break;
+        case PROP_LOG_INTERVAL:
+            if (CurrentLog->LoggingType == LOGGING_TYPE_TRIGGERED) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+                break;
+            }
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                if (value.type.Unsigned_Int == 0) {
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code =
+                        ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
+                    status = false;
+                } else {
+                    /* We only log to 1 sec accuracy so must divide by 100
+                     * before passing it on */
+                    CurrentLog->ulLogInterval = value.type.Unsigned_Int / 100;
+                    if (CurrentLog->ulLogInterval == 0) {
+                        CurrentLog->ulLogInterval = 1;
+                    }
+                }
+            }
+            break;
+        case PROP_ALIGN_INTERVALS:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status) {
+                CurrentLog->bAlignIntervals = value.type.Boolean;
+            }
+            break;
+        case PROP_INTERVAL_OFFSET:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+            if (status) {
+                CurrentLog->ulIntervalOffset = value.type.Unsigned_Int / 100;
+            }
+            break;
+        case PROP_TRIGGER:
+            status = write_property_type_valid(
+                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+            if (status) {
+                /* aligned polled logs only sample on the clock */
+                if ((CurrentLog->LoggingType == LOGGING_TYPE_POLLED) &&
+                    CurrentLog->bAlignIntervals) {
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code =
+                        ERROR_CODE_NOT_CONFIGURED_FOR_TRIGGERED_LOGGING;
+                    status = false;
+                } else {
+                    CurrentLog->bTrigger = value.type.Boolean;
+                }
+            }
+            break;
+        default:
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+            break;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Sample every member of a log in one pass and insert the values
+ *  as one row. Members of the same object share one value list of that
+ *  object, and only the members that are not in it are read with
+ *  ReadProperty.
+ * @param log_index [in] index of the log
+ */
+static void TLM_Fetch_Row(unsigned log_index)
+{
+    TLM_LOG_INFO *CurrentLog = &TLM_Info[log_index];
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember;
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pListed = NULL;
+    BACNET_PROPERTY_VALUE value_list[2];
+    bool bListed = false;
+    bacnet_time_t tNow;
+    unsigned i;
+
+    tNow = Trend_Log_Multiple_Epoch_Seconds_Now();
+    CurrentLog->tLastDataTime = tNow;
+    if (CurrentLog->uiMembers == 0) {
+        return;
+    }
+    if (CurrentLog->bStopWhenFull && TL_Block_Full(&CurrentLog->Blocks)) {
+        CurrentLog->bEnable = false;
+        return;
+    }
+    for (i = 0; i < CurrentLog->uiMembers; i++) {
+        pMember = &CurrentLog->Members[i];
+        memset(&TLM_Row[i], 0, sizeof(TLM_Row[i]));
+        TLM_Row[i].tTimeStamp = tNow;
+        if (!pListed ||
+            (pListed->objectIdentifier.type !=
+                pMember->objectIdentifier.type) ||
+            (pListed->objectIdentifier.instance !=
+                pMember->objectIdentifier.instance)) {
+            pListed = pMember;
+            bacapp_property_value_list_init(&value_list[0], 2);
+            bListed = Device_Encode_Value_List(pMember->objectIdentifier.type,
+                pMember->objectIdentifier.instance, &value_list[0]);
+        }
+        if (!bListed ||
+            !TL_Value_List_To_Rec(&TLM_Row[i], pMember, &value_list[0])) {
+            TL_Read_Property_To_Rec(&TLM_Row[i], pMember);
+        }
+        /* the records of a log multiple have no status flags */
+        TLM_Row[i].ucStatus = 0;
+    }
+    TLM_Insert_Row(CurrentLog, &TLM_Row[0]);
+}
+
+/**
+ * @brief Get the timestamp of a row of a log
+ * @param pLog [in] the log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest row
+ * @return timestamp of the row
+ */
+static bacnet_time_t TLM_Range_Time_Stamp(const void *pLog, uint32_t uiEntry)
+{
+    return TLM_Entry((TLM_LOG_INFO *)pLog, uiEntry)->tTimeStamp;
+}
+
+/**
+ * @brief Encode a value of a row as the choice of a BACnetLogData
+ *  log-data list, whose context tags are one less than the record types
+ * @param apdu [out] buffer for the value
+ * @param pSource [in] the record of the value
+ * @return number of bytes encoded
+ */
+static int TLM_Encode_Value(uint8_t *apdu, const TL_DATA_REC *pSource)
+{
+    BACNET_BIT_STRING TempBits;
+    uint8_t ucTag = pSource->ucRecType - 1;
+    uint8_t ucCount;
+    int iLen = 0;
+
+    switch (pSource->ucRecType) {
+        case TL_TYPE_BOOL:
+            iLen = encode_context_boolean(
+                &apdu[0], ucTag, pSource->Datum.ucBoolean);
+            break;
+        case TL_TYPE_REAL:
+            iLen = encode_context_real(&apdu[0], ucTag, pSource->Datum.fReal);
+            break;
+        case TL_TYPE_ENUM:
+            iLen = encode_context_enumerated(
+                &apdu[0], ucTag, pSource->Datum.ulEnum);
+            break;
+        case TL_TYPE_UNSIGN:
+            iLen = encode_context_unsigned(
+                &apdu[0], ucTag, pSource->Datum.ulUValue);
+            break;
+        case TL_TYPE_SIGN:
+            iLen = encode_context_signed(
+                &apdu[0], ucTag, pSource->Datum.lSValue);
+            break;
+        case TL_TYPE_BITS:
+            bitstring_init(&TempBits);
+            bitstring_set_bits_used(&TempBits,
+                (pSource->Datum.Bits.ucLen >> 4) & 0x0F,
+                pSource->Datum.Bits.ucLen & 0x0F);
+            for (ucCount = pSource->Datum.Bits.ucLen >> 4; ucCount > 0;
+                 ucCount--) {
+                bitstring_set_octet(&TempBits, ucCount - 1,
+                    pSource->Datum.Bits.ucStore[ucCount - 1]);
+            }
+            iLen = encode_context_bitstring(&apdu[0], ucTag, &TempBits);
+            break;
+        case TL_TYPE_NULL:
+            iLen = encode_context_null(&apdu[0], ucTag);
+            break;
+        default:
+            /* a failure for errors, and for the types we cannot handle */
+            ucTag = TL_TYPE_ERROR - 1;
+            iLen = encode_opening_tag(&apdu[0], ucTag);
+            if (pSource->ucRecType == TL_TYPE_ERROR) {
+                iLen += encode_application_enumerated(
+                    &apdu[iLen], pSource->Datum.Error.usClass);
+                iLen += encode_application_enumerated(
+                    &apdu[iLen], pSource->Datum.Error.usCode);
+            } else {
+                iLen += encode_application_enumerated(
+                    &apdu[iLen], ERROR_CLASS_PROPERTY);
+                iLen += encode_application_enumerated(
+                    &apdu[iLen], ERROR_CODE_DATATYPE_NOT_SUPPORTED);
+            }
+            iLen += encode_closing_tag(&apdu[iLen], ucTag);
+            break;
+    }
+
+    return iLen;
+}
+
+/**
+ * @brief Encode a row of a log as a BACnetLogMultipleRecord
+ * @param apdu [out] buffer for the row
+ * @param pLog [in] the log
+ * @param uiEntry [in] BACnet 1 based position, 1 being the oldest row
+ * @return number of bytes encoded
+ */
+static int TLM_Range_Encode_Entry(
+    uint8_t *apdu, const void *pLog, uint32_t uiEntry)
+{
+    const TLM_LOG_INFO *CurrentLog = (const TLM_LOG_INFO *)pLog;
+    const TL_DATA_REC *pRow;
+    BACNET_BIT_STRING TempBits;
+    BACNET_DATE_TIME TempTime;
+    unsigned i;
+    int iLen = 0;
+
+    pRow = TLM_Entry((TLM_LOG_INFO *)pLog, uiEntry);
+    TL_Local_Time_To_BAC(&TempTime, pRow[0].tTimeStamp);
+    iLen += bacapp_encode_context_datetime(&apdu[iLen], 0, &TempTime);
+    iLen += encode_opening_tag(&apdu[iLen], 1);
+    if (pRow[0].ucRecType == TL_TYPE_STATUS) {
+        /* Build bit string directly from the stored octet */
+        bitstring_init(&TempBits);
+        bitstring_set_bits_used(&TempBits, 1, 5);
+        bitstring_set_octet(&TempBits, 0, pRow[0].Datum.ucLogStatus);
+        iLen += encode_context_bitstring(&apdu[iLen], 0, &TempBits);
+    } else if (pRow[0].ucRecType == TL_TYPE_DELTA) {
+        iLen += encode_context_real(&apdu[iLen], 2, pRow[0].Datum.fTime);
+    } else {
+        iLen += encode_opening_tag(&apdu[iLen], 1);
+        for (i = 0; i < CurrentLog->uiMembers; i++) {
+            iLen += TLM_Encode_Value(&apdu[iLen], &pRow[i]);
+        }
+        iLen += encode_closing_tag(&apdu[iLen], 1);
+    }
+    iLen += encode_closing_tag(&apdu[iLen], 1);
+
+    return iLen;
+}
+
+/**
+ * @brief Encode the Log_Buffer of a log for a ReadRange request, with
+ *  all the values of a row in each record
+ * @param apdu [out] buffer for the list of records
+ * @param pRequest [in,out] the request, and the results of the response
+ * @return number of bytes encoded
+ */
+int Trend_Log_Multiple_Read_Range_Encode(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    TLM_LOG_INFO *CurrentLog;
+    TL_RANGE_LOG Range;
+    unsigned log_index;
+
+    log_index =
+        Trend_Log_Multiple_Instance_To_Index(pRequest->object_instance);
+    if (log_index >= MAX_TREND_LOG_MULTIPLES) {
+        return 0;
+    }
+    CurrentLog = &TLM_Info[log_index];
+    Range.pLog = CurrentLog;
+    Range.ulRecordCount = TL_Block_Count(&CurrentLog->Blocks);
+    Range.ulTotalRecordCount = CurrentLog->ulTotalRecordCount;
+    Range.ulOrderedCount = CurrentLog->ulOrderedCount;
+    Range.ulMaxEncoded = TLM_MAX_ENC(CurrentLog->uiMembers);
+    Range.Time_Stamp = TLM_Range_Time_Stamp;
+    Range.Encode = TLM_Range_Encode_Entry;
+
+    return TL_Range_Encode(apdu, pRequest, &Range);
+}
+
+/**
+ * @brief Get the ReadRange handler of a property of a log
+ * @param pRequest [in,out] the request, or the error
+ * @param pInfo [out] the request types and the handler
+ * @return true if the property can be read with ReadRange
+ */
+bool Trend_Log_Multiple_RR_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo)
+{
+    if (!Trend_Log_Multiple_Valid_Instance(pRequest->object_instance)) {
+        pRequest->error_class = ERROR_CLASS_OBJECT;
+        pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+    } else if (pRequest->object_property == PROP_LOG_BUFFER) {
+        pInfo->RequestTypes = RR_BY_POSITION | RR_BY_TIME | RR_BY_SEQUENCE;
+        pInfo->Handler = Trend_Log_Multiple_Read_Range_Encode;
+        return true;
+    } else {
+        pRequest->error_class = ERROR_CLASS_SERVICES;
+        pRequest->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Sample the members of each log that is due, in the same way as
+ *  the Trend Log objects
+ * @param uSeconds [in] seconds since the last call, not used
+ */
+void trend_log_multiple_timer(uint16_t uSeconds)
+{
+    TLM_LOG_INFO *CurrentLog;
+    bacnet_time_t tNow;
+    unsigned i;
+
+    (void)uSeconds;
+    tNow = Trend_Log_Multiple_Epoch_Seconds_Now();
+    for (i = 0; i < MAX_TREND_LOG_MULTIPLES; i++) {
+        CurrentLog = &TLM_Info[i];
+        if (!CurrentLog->bEnable) {
+            continue;
+        }
+        if (CurrentLog->LoggingType == LOGGING_TYPE_POLLED) {
+            if (CurrentLog->bAlignIntervals) {
+                /* sample on the clock, or as soon as possible after a
+                 * period was missed */
+                if (((tNow % CurrentLog->ulLogInterval) ==
+                        (CurrentLog->ulIntervalOffset %
+                            CurrentLog->ulLogInterval)) ||
+                    ((tNow - CurrentLog->tLastDataTime) >
+                        CurrentLog->ulLogInterval)) {
+                    TLM_Fetch_Row(i);
+                }
+            } else if (((tNow - CurrentLog->tLastDataTime) >=
+                           CurrentLog->ulLogInterval) ||
+                CurrentLog->bTrigger) {
+                TLM_Fetch_Row(i);
+            }
+            CurrentLog->bTrigger = false;
+        } else if (CurrentLog->bTrigger) {
+            TLM_Fetch_Row(i);
+            CurrentLog->bTrigger = false;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @brief API for a basic Trend Log Multiple object implementation, which
+ *  records the values of a list of properties of this device in rows that
+ *  share one timestamp.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_TRENDLOG_MULTIPLE_H
+#define BACNET_BASIC_OBJECT_TRENDLOG_MULTIPLE_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdevobjpropref.h"
+#include "bacnet/readrange.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/object/trendlog.h"
+#include "bacnet/basic/object/trendlog_block.h"
+
+#ifndef MAX_TREND_LOG_MULTIPLES
+#define MAX_TREND_LOG_MULTIPLES 1
+#endif
+/* Most members of the Log_DeviceObjectProperty array of each log */
+#ifndef TLM_MAX_MEMBERS
+#define TLM_MAX_MEMBERS 32
+#endif
+/* Octets of compressed rows of records for each log */
+#ifndef TLM_BLOCK_BUFFER_SIZE
+#define TLM_BLOCK_BUFFER_SIZE (TL_BLOCK_SIZE * 16)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Property_Lists(
+    const int **pRequired, const int **pOptional, const int **pProprietary);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Valid_Instance(uint32_t object_instance);
+BACNET_STACK_EXPORT
+unsigned Trend_Log_Multiple_Count(void);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Index_To_Instance(unsigned index);
+BACNET_STACK_EXPORT
+unsigned Trend_Log_Multiple_Instance_To_Index(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Object_Name(
+    uint32_t object_instance, BACNET_CHARACTER_STRING *object_name);
+BACNET_STACK_EXPORT
+int Trend_Log_Multiple_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
+BACNET_STACK_EXPORT
+void Trend_Log_Multiple_Init(void);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Members_Set(uint32_t object_instance,
+    const BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMembers,
+    unsigned count);
+BACNET_STACK_EXPORT
+unsigned Trend_Log_Multiple_Member_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Buffer_Size(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Record_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t Trend_Log_Multiple_Total_Record_Count(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Enable(uint32_t object_instance);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Enable_Set(uint32_t object_instance, bool enable);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Log_Interval_Set(
+    uint32_t object_instance, uint32_t seconds);
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_Trigger(uint32_t object_instance);
+
+BACNET_STACK_EXPORT
+bool Trend_Log_Multiple_RR_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo);
+BACNET_STACK_EXPORT
+int Trend_Log_Multiple_Read_Range_Encode(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest);
+
+BACNET_STACK_EXPORT
+void trend_log_multiple_timer(uint16_t uSeconds);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
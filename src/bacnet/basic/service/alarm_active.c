@@ -0,0 +1,181 @@
+/**
+ * @file
+ * @brief The device set of the objects with an active alarm
+ * @details The objects with intrinsic reporting add themselves to the set
+ *  when their Event_State leaves NORMAL or a transition needs an
+ *  acknowledgment, and remove themselves when they are NORMAL and all
+ *  of the transitions are acknowledged. The set is sorted by object
+ *  type and then by instance, which is the order that GetEventInformation
+ *  reports the objects in, so the handlers walk it with a cursor.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/basic/sys/key.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/service/alarm_active.h"
+
+/* the objects with an active alarm, keyed by type and instance */
+static OS_Keylist Alarm_Active_List;
+/* the object types whose objects keep their entries in the set */
+static alarm_active_index_function Alarm_Active_Index[MAX_BACNET_OBJECT_TYPE];
+
+/**
+ * @brief Set the function that gets the index of an object instance for
+ *  an object type, which marks the objects of the type as keeping their
+ *  entries in the set with Alarm_Active_Set()
+ * @param object_type - type of the objects
+ * @param pFunction - index function, or NULL to stop using the set
+ */
+void Alarm_Active_Index_Set(
+    BACNET_OBJECT_TYPE object_type, alarm_active_index_function pFunction)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        Alarm_Active_Index[object_type] = pFunction;
+    }
+}
+
+/**
+ * @brief Determine if the objects of a type keep their entries in the set
+ * @param object_type - type of the objects
+ * @return true if the set holds every active alarm of the type
+ */
+bool Alarm_Active_Tracked(BACNET_OBJECT_TYPE object_type)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        return (Alarm_Active_Index[object_type] != NULL);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Add an object to the set, or remove it from the set
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @param active - true if the Event_State is not NORMAL or any of the
+ *  transitions is not acknowledged
+ * @return true if the object was added or removed, false if it was
+ *  already in or out of the set, or there was no memory
+ */
+bool Alarm_Active_Set(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool active)
+{
+    KEY key = KEY_ENCODE(object_type, object_instance);
+    int index;
+
+    if (!Alarm_Active_List) {
+        if (!active) {
+            return false;
+        }
+        Alarm_Active_List = Keylist_Create();
+        if (!Alarm_Active_List) {
+            return false;
+        }
+    }
+    index = Keylist_Index(Alarm_Active_List, key);
+    if (active) {
+        if (index >= 0) {
+            return false;
+        }
+        return (Keylist_Data_Add(Alarm_Active_List, key, NULL) >= 0);
+    }
+    if (index < 0) {
+        return false;
+    }
+    (void)Keylist_Data_Delete_By_Index(Alarm_Active_List, index);
+
+    return true;
+}
+
+/**
+ * @brief Determine if an object is in the set
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @return true if the object has an active alarm
+ */
+bool Alarm_Active(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return (Keylist_Index(Alarm_Active_List,
+                KEY_ENCODE(object_type, object_instance)) >= 0);
+}
+
+/**
+ * @brief Remove all of the objects of a type from the set, such as when
+ *  the objects are deleted
+ * @param object_type - type of the objects
+ */
+void Alarm_Active_Clear(BACNET_OBJECT_TYPE object_type)
+{
+    KEY key;
+    int index = 0;
+
+    while (Keylist_Index_Key(Alarm_Active_List, index, &key)) {
+        if (KEY_DECODE_TYPE(key) == (int)object_type) {
+            (void)Keylist_Data_Delete_By_Index(Alarm_Active_List, index);
+        } else {
+            index++;
+        }
+    }
+}
+
+/**
+ * @brief Get the number of objects in the set
+ * @return number of objects with an active alarm
+ */
+unsigned Alarm_Active_Count(void)
+{
+    int count = Keylist_Count(Alarm_Active_List);
+
+    return (count > 0) ? (unsigned)count : 0;
+}
+
+/**
+ * @brief Get the next object of a type in the set, for the handlers that
+ *  visit the types in increasing order with one cursor
+ * @param object_type - type of the objects
+ * @param cursor - position in the set, which starts at zero, and which
+ *  moves past the objects of this type and of the lower types
+ * @param index - the index of the object from the index function
+ * @return true if an object was found, false at the end of the type
+ */
+bool Alarm_Active_Next(
+    BACNET_OBJECT_TYPE object_type, unsigned *cursor, unsigned *index)
+{
+    KEY key;
+    int key_type;
+
+    if (!cursor || !index || !Alarm_Active_Tracked(object_type)) {
+        return false;
+    }
+    while (Keylist_Index_Key(Alarm_Active_List, (int)*cursor, &key)) {
+        key_type = KEY_DECODE_TYPE(key);
+        if (key_type > (int)object_type) {
+            break;
+        }
+        (*cursor)++;
+        if (key_type == (int)object_type) {
+            *index = Alarm_Active_Index[object_type](
+                (uint32_t)KEY_DECODE_ID(key));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Remove all of the objects from the set and free its memory
+ */
+void Alarm_Active_Cleanup(void)
+{
+    if (Alarm_Active_List) {
+        Keylist_Delete(Alarm_Active_List);
+        Alarm_Active_List = NULL;
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @brief API for the device set of the objects with an active alarm,
+ *  which is an Event_State that is not NORMAL or an Acked_Transitions
+ *  that is not all acknowledged, so that GetEventInformation and
+ *  GetAlarmSummary visit only the objects in the set rather than every
+ *  object of the device.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_ALARM_ACTIVE_H
+#define BACNET_BASIC_OBJECT_ALARM_ACTIVE_H
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* the index of an object instance, such as Analog_Input_Instance_To_Index,
+   which is used with the Event_Information and Alarm_Summary functions */
+typedef unsigned (*alarm_active_index_function)(uint32_t object_instance);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void Alarm_Active_Index_Set(
+    BACNET_OBJECT_TYPE object_type, alarm_active_index_function pFunction);
+BACNET_STACK_EXPORT
+bool Alarm_Active_Tracked(BACNET_OBJECT_TYPE object_type);
+BACNET_STACK_EXPORT
+bool Alarm_Active_Set(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, bool active);
+BACNET_STACK_EXPORT
+bool Alarm_Active(BACNET_OBJECT_TYPE object_type, uint32_t object_instance);
+BACNET_STACK_EXPORT
+void Alarm_Active_Clear(BACNET_OBJECT_TYPE object_type);
+BACNET_STACK_EXPORT
+unsigned Alarm_Active_Count(void);
+BACNET_STACK_EXPORT
+bool Alarm_Active_Next(
+    BACNET_OBJECT_TYPE object_type, unsigned *cursor, unsigned *index);
+BACNET_STACK_EXPORT
+void Alarm_Active_Cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -173,6 +173,7 @@ AA_ABORT:
 #endif
         datalink_send_pdu(
             src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr,
@@ -8,6 +8,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -20,11 +21,14 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/trace.h"
 
 /* APDU Timeout in Milliseconds */
 static uint16_t Timeout_Milliseconds = 3000;
 /* Number of APDU Retries */
 static uint8_t Number_Of_Retries = 3;
+/* APDU Segment Timeout in Milliseconds */
+static uint16_t Segment_Timeout_Milliseconds = 2000;
 static uint8_t Local_Network_Priority; /* Fixing test 10.1.2 Network priority */
 
 /* a simple table for crossing the services supported */
@@ -92,6 +96,49 @@ static BACNET_SERVICES_SUPPORTED
         SERVICE_SUPPORTED_YOU_ARE
     };
 
+/* the SERVICE_CONFIRMED_ or SERVICE_UNCONFIRMED_ index of each
+   SERVICE_SUPPORTED_ value, built from the tables above on first use */
+#define SERVICE_INDEX_NONE 0xFF
+#define SERVICE_INDEX_UNCONFIRMED 0x80
+static uint8_t Service_Supported_Index[MAX_BACNET_SERVICES_SUPPORTED];
+static bool Service_Supported_Index_Valid;
+
+/* the services processed in the current DCC state, one bit per service,
+   compiled again whenever the DCC state changes */
+static uint8_t DCC_Confirmed_Allowed[(MAX_BACNET_CONFIRMED_SERVICE + 7) / 8];
+static uint8_t
+    DCC_Unconfirmed_Allowed[(MAX_BACNET_UNCONFIRMED_SERVICE + 7) / 8];
+static BACNET_COMMUNICATION_ENABLE_DISABLE DCC_Allowed_Status;
+static bool DCC_Allowed_Valid;
+
+/**
+ * @brief Build the index of each SERVICE_SUPPORTED_ value, once
+ */
+static void apdu_service_supported_index_init(void)
+{
+    unsigned i = 0;
+
+    if (Service_Supported_Index_Valid) {
+        return;
+    }
+    memset(Service_Supported_Index, SERVICE_INDEX_NONE,
+        sizeof(Service_Supported_Index));
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        if (unconfirmed_service_supported[i] <
+            MAX_BACNET_SERVICES_SUPPORTED) {
+            Service_Supported_Index[unconfirmed_service_supported[i]] =
+                SERVICE_INDEX_UNCONFIRMED | i;
+        }
+    }
+    /* a confirmed service is found first, as with the tables */
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        if (confirmed_service_supported[i] < MAX_BACNET_SERVICES_SUPPORTED) {
+            Service_Supported_Index[confirmed_service_supported[i]] = i;
+        }
+    }
+    Service_Supported_Index_Valid = true;
+}
+
 /* Confirmed Function Handlers */
 /* If they are not set, they are handled by a reject message */
 static confirmed_function Confirmed_Function[MAX_BACNET_CONFIRMED_SERVICE];
@@ -152,43 +199,32 @@ void apdu_set_unconfirmed_handler(
  */
 bool apdu_service_supported(BACNET_SERVICES_SUPPORTED service_supported)
 {
-    int i = 0;
+    uint8_t index = SERVICE_INDEX_NONE;
     bool status = false;
-    bool found = false;
 
     if (service_supported < MAX_BACNET_SERVICES_SUPPORTED) {
-        /* is it a confirmed service? */
-        for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
-            if (confirmed_service_supported[i] == service_supported) {
-                found = true;
-                if (Confirmed_Function[i] != NULL) {
-#ifdef BAC_ROUTING
-                    /* Check to see if the current Device supports this service.
-                     */
-                    int len = Routed_Device_Service_Approval(
-                        confirmed_service_supported[i], 0, NULL, 0);
-                    if (len > 0)
-                        break; /* Not supported - return false */
-#endif
-
-                    status = true;
-                }
-                break;
-            }
+        apdu_service_supported_index_init();
+        index = Service_Supported_Index[service_supported];
+    }
+    if (index == SERVICE_INDEX_NONE) {
+        /* not a service */
+    } else if (index & SERVICE_INDEX_UNCONFIRMED) {
+        index &= ~SERVICE_INDEX_UNCONFIRMED;
+        if (Unconfirmed_Function[index] != NULL) {
+            status = true;
         }
-
-        if (!found) {
-            /* is it an unconfirmed service? */
-            for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
-                if (unconfirmed_service_supported[i] == service_supported) {
-                    if (Unconfirmed_Function[i] != NULL) {
-                        status = true;
-                    }
-                    break;
-                }
-            }
+    } else if (Confirmed_Function[index] != NULL) {
+        status = true;
+#ifdef BAC_ROUTING
+        /* Check to see if the current Device supports this service. */
+        if (Routed_Device_Service_Approval(
+                confirmed_service_supported[index], 0, NULL, 0) > 0) {
+            /* Not supported - return false */
+            status = false;
         }
+#endif
     }
+
     return status;
 }
 
@@ -207,30 +243,21 @@ bool apdu_service_supported_to_index(
     size_t *index,
     bool *bIsConfirmed)
 {
-    int i = 0;
+    uint8_t service_index = SERVICE_INDEX_NONE;
     bool found = false;
 
     *bIsConfirmed = false;
     if (service_supported < MAX_BACNET_SERVICES_SUPPORTED) {
-        /* is it a confirmed service? */
-        for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
-            if (confirmed_service_supported[i] == service_supported) {
-                found = true;
-                *index = (size_t)i;
-                *bIsConfirmed = true;
-                break;
-            }
-        }
-
-        if (!found) {
-            /* is it an unconfirmed service? */
-            for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
-                if (unconfirmed_service_supported[i] == service_supported) {
-                    found = true;
-                    *index = (size_t)i;
-                    break;
-                }
-            }
+        apdu_service_supported_index_init();
+        service_index = Service_Supported_Index[service_supported];
+    }
+    if (service_index != SERVICE_INDEX_NONE) {
+        found = true;
+        if (service_index & SERVICE_INDEX_UNCONFIRMED) {
+            *index = (size_t)(service_index & ~SERVICE_INDEX_UNCONFIRMED);
+        } else {
+            *index = (size_t)service_index;
+            *bIsConfirmed = true;
         }
     }
     return found;
@@ -395,6 +422,42 @@ void apdu_set_reject_handler(reject_function pFunction)
     Reject_Function = pFunction;
 }
 
+static peer_capability_function Peer_Capability_Function;
+
+/**
+ * @brief Set a handler function called with what is learned about a peer
+ *  from its APDUs, such as address_peer_capability_update() to keep it
+ *  in the address cache
+ * @param pFunction  Pointer to the function, or NULL for none
+ */
+void apdu_set_peer_capability_handler(peer_capability_function pFunction)
+{
+    Peer_Capability_Function = pFunction;
+}
+
+#if !BACNET_SVC_SERVER
+/**
+ * @brief Give the round trip time of a reply to one of our confirmed
+ *  requests to the peer capability handler, before the transaction ends
+ * @param src  BACnet address of the peer that replied
+ * @param invoke_id  invokeID of the reply
+ */
+static void apdu_peer_round_trip_time(BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+#if MAX_TSM_TRANSACTIONS
+    uint16_t milliseconds = 0;
+
+    if (Peer_Capability_Function &&
+        tsm_round_trip_time(invoke_id, src, &milliseconds)) {
+        Peer_Capability_Function(src, 0, 0, milliseconds);
+    }
+#else
+    (void)src;
+    (void)invoke_id;
+#endif
+}
+#endif
+
 /**
  * @brief Decode the given confirmed service request from the received data.
  *
@@ -479,6 +542,16 @@ void apdu_retries_set(uint8_t value)
     Number_Of_Retries = value;
 }
 
+uint16_t apdu_segment_timeout(void)
+{
+    return Segment_Timeout_Milliseconds;
+}
+
+void apdu_segment_timeout_set(uint16_t milliseconds)
+{
+    Segment_Timeout_Milliseconds = milliseconds;
+}
+
 /* When network communications are completely disabled,
    only DeviceCommunicationControl and ReinitializeDevice APDUs
    shall be processed and no messages shall be initiated.
@@ -539,6 +612,142 @@ static bool apdu_unconfirmed_dcc_disabled(uint8_t service_choice)
     return status;
 }
 
+/**
+ * @brief Compile the services processed in the current DCC state into
+ *  the allow masks, when the DCC state has changed since the last PDU
+ */
+static void apdu_dcc_allowed_update(void)
+{
+    BACNET_COMMUNICATION_ENABLE_DISABLE status = dcc_enable_status();
+    unsigned i = 0;
+
+    if (DCC_Allowed_Valid && (status == DCC_Allowed_Status)) {
+        return;
+    }
+    memset(DCC_Confirmed_Allowed, 0, sizeof(DCC_Confirmed_Allowed));
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        if (!apdu_confirmed_dcc_disabled(i)) {
+            DCC_Confirmed_Allowed[i / 8] |= (uint8_t)(1 << (i % 8));
+        }
+    }
+    memset(DCC_Unconfirmed_Allowed, 0, sizeof(DCC_Unconfirmed_Allowed));
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        if (!apdu_unconfirmed_dcc_disabled(i)) {
+            DCC_Unconfirmed_Allowed[i / 8] |= (uint8_t)(1 << (i % 8));
+        }
+    }
+    DCC_Allowed_Status = status;
+    DCC_Allowed_Valid = true;
+}
+
+/**
+ * @brief Determine if a confirmed service is processed in the DCC state
+ * @param service_choice  Service, like SERVICE_CONFIRMED_READ_PROPERTY
+ * @return true, if the service is processed.
+ */
+static bool apdu_confirmed_dcc_allowed(uint8_t service_choice)
+{
+    if (service_choice >= MAX_BACNET_CONFIRMED_SERVICE) {
+        /* unknown services are rejected unless communication is off */
+        return !apdu_confirmed_dcc_disabled(service_choice);
+    }
+    apdu_dcc_allowed_update();
+
+    return (DCC_Confirmed_Allowed[service_choice / 8] &
+               (1 << (service_choice % 8))) != 0;
+}
+
+/**
+ * @brief Determine if an unconfirmed service is processed in the DCC state
+ * @param service_choice  Service, like SERVICE_UNCONFIRMED_WHO_IS
+ * @return true, if the service is processed.
+ */
+static bool apdu_unconfirmed_dcc_allowed(uint8_t service_choice)
+{
+    if (service_choice >= MAX_BACNET_UNCONFIRMED_SERVICE) {
+        return !apdu_unconfirmed_dcc_disabled(service_choice);
+    }
+    apdu_dcc_allowed_update();
+
+    return (DCC_Unconfirmed_Allowed[service_choice / 8] &
+               (1 << (service_choice % 8))) != 0;
+}
+
+/**
+ * @brief Determine if a received NPDU is discarded in the DCC state, from
+ *  the bytes of its NPDU and APDU headers alone, so that it is dropped as
+ *  it is received, before it is decoded. Only the requests that
+ *  apdu_handler() would discard are discarded: network layer messages,
+ *  messages for a router, and the replies to our own requests are kept.
+ * @param npdu [in] The received NPDU, starting with the protocol version.
+ * @param npdu_len [in] The number of bytes of the NPDU.
+ * @return true if the NPDU is discarded.
+ */
+bool apdu_dcc_npdu_discard(const uint8_t *npdu, uint16_t npdu_len)
+{
+    uint8_t control;
+    uint16_t dnet;
+    uint32_t offset = 2;
+
+    if (dcc_communication_enabled()) {
+        return false;
+    }
+    if (!npdu || (npdu_len < 2) || (npdu[0] != BACNET_PROTOCOL_VERSION)) {
+        return false;
+    }
+    control = npdu[1];
+    if (control & BIT(7)) {
+        /* network layer message */
+        return false;
+    }
+    if (control & BIT(5)) {
+        /* DNET, DLEN and DADR */
+        if ((offset + 3) > npdu_len) {
+            return false;
+        }
+        dnet = ((uint16_t)npdu[offset] << 8) | npdu[offset + 1];
+        if (dnet != BACNET_BROADCAST_NETWORK) {
+            /* for a router */
+            return false;
+        }
+        offset += 3 + npdu[offset + 2];
+    }
+    if (control & BIT(3)) {
+        /* SNET, SLEN and SADR */
+        if ((offset + 3) > npdu_len) {
+            return false;
+        }
+        offset += 3 + npdu[offset + 2];
+    }
+    if (control & BIT(5)) {
+        /* hop count */
+        offset++;
+    }
+    if (offset >= npdu_len) {
+        return false;
+    }
+    switch (npdu[offset] & 0xF0) {
+        case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
+            /* the service choice follows the sequence number and the
+               window size of a segmented request */
+            offset += (npdu[offset] & BIT(3)) ? 5 : 3;
+            if (offset >= npdu_len) {
+                return false;
+            }
+            return !apdu_confirmed_dcc_allowed(npdu[offset]);
+        case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
+            offset++;
+            if (offset >= npdu_len) {
+                return false;
+            }
+            return !apdu_unconfirmed_dcc_allowed(npdu[offset]);
+        default:
+            break;
+    }
+
+    return false;
+}
+
 /** Process the APDU header and invoke the appropriate service handler
  * to manage the received request.
  * Almost all requests and ACKs invoke this function.
@@ -574,6 +783,7 @@ void apdu_handler(
     if (apdu_len == 0) {
         return;
     }
+    BACNET_TRACE(APDU_RX, apdu[0], apdu_len);
     pdu_type = apdu[0] & 0xF0;
     switch (pdu_type) {
         case PDU_TYPE_CONFIRMED_SERVICE_REQUEST:
@@ -584,13 +794,18 @@ void apdu_handler(
                 /* service data unable to be decoded - simply drop */
                 break;
             }
-            if (apdu_confirmed_dcc_disabled(service_choice)) {
+            if (!apdu_confirmed_dcc_allowed(service_choice)) {
                 /* When network communications are completely disabled,
                     only DeviceCommunicationControl and ReinitializeDevice
                     APDUs shall be processed and no messages shall be
                     initiated. */
                 break;
             }
+            if (Peer_Capability_Function) {
+                Peer_Capability_Function(src, (unsigned)service_data.max_resp,
+                    (unsigned)service_data.max_segs, 0);
+            }
+            bacnet_apdu_stats_request_begin(true, service_choice, apdu_len);
             if ((service_choice < MAX_BACNET_CONFIRMED_SERVICE) &&
                 (Confirmed_Function[service_choice])) {
                 Confirmed_Function[service_choice](
@@ -599,6 +814,7 @@ void apdu_handler(
                 Unrecognized_Service_Handler(
                     service_request, service_request_len, src, &service_data);
             }
+            bacnet_apdu_stats_request_end();
             break;
         case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
             if (apdu_len < 2) {
@@ -608,7 +824,7 @@ void apdu_handler(
             /* prepare the service request buffer and length */
             service_request_len = apdu_len - 2;
             service_request = &apdu[2];
-            if (apdu_unconfirmed_dcc_disabled(service_choice)) {
+            if (!apdu_unconfirmed_dcc_allowed(service_choice)) {
                 /* When network communications are disabled,
                     only DeviceCommunicationControl and
                     ReinitializeDevice APDUs shall be processed and no
@@ -619,11 +835,28 @@ void apdu_handler(
             }
             if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
                 if (Unconfirmed_Function[service_choice]) {
+                    bacnet_apdu_stats_request_begin(
+                        false, service_choice, apdu_len);
                     Unconfirmed_Function[service_choice](
                         service_request, service_request_len, src);
+                    bacnet_apdu_stats_request_end();
                 }
             }
             break;
+        case PDU_TYPE_SEGMENT_ACK:
+#if BACNET_SEGMENTATION_ENABLED
+            if (apdu_len < 4) {
+                break;
+            }
+            tsm_segment_ack_handler(src, apdu[1], apdu[2], apdu[3],
+                (apdu[0] & BIT(1)) ? true : false,
+                (apdu[0] & BIT(0)) ? true : false);
+#elif !BACNET_SVC_SERVER
+            /* FIXME: what about a denial of service attack here?
+                we could check src to see if that matched the tsm */
+            tsm_free_invoke_id(invoke_id);
+#endif
+            break;
 #if !BACNET_SVC_SERVER
         case PDU_TYPE_SIMPLE_ACK:
             if (apdu_len < 3) {
@@ -631,6 +864,7 @@ void apdu_handler(
             }
             invoke_id = apdu[1];
             service_choice = apdu[2];
+            apdu_peer_round_trip_time(src, invoke_id);
             if (apdu_confirmed_simple_ack_service(service_choice)) {
                 if (Confirmed_ACK_Function[service_choice].simple != NULL) {
                     Confirmed_ACK_Function[service_choice].simple(
@@ -659,6 +893,22 @@ void apdu_handler(
             /* prepare the service request buffer and length */
             service_request_len = apdu_len - (uint16_t)len;
             service_request = &apdu[len];
+            if (!service_ack_data.segmented_message) {
+                apdu_peer_round_trip_time(src, invoke_id);
+            }
+#if BACNET_SEGMENTATION_ENABLED
+            if (service_ack_data.segmented_message) {
+                if (!tsm_segmented_complex_ack_handler(src,
+                        &service_ack_data, service_request,
+                        service_request_len, &service_request,
+                        &service_request_len)) {
+                    break;
+                }
+                /* the reassembled reply is handled as one message */
+                service_ack_data.segmented_message = false;
+                service_ack_data.more_follows = false;
+            }
+#endif
             if (!apdu_confirmed_simple_ack_service(service_choice)) {
                 if (service_choice < MAX_BACNET_CONFIRMED_SERVICE) {
                     if (Confirmed_ACK_Function[service_choice].complex !=
@@ -671,17 +921,13 @@ void apdu_handler(
                 tsm_free_invoke_id(invoke_id);
             }
             break;
-        case PDU_TYPE_SEGMENT_ACK:
-            /* FIXME: what about a denial of service attack here?
-                we could check src to see if that matched the tsm */
-            tsm_free_invoke_id(invoke_id);
-            break;
         case PDU_TYPE_ERROR:
             if (apdu_len < 3) {
                 break;
             }
             invoke_id = apdu[1];
             service_choice = apdu[2];
+            apdu_peer_round_trip_time(src, invoke_id);
             /* prepare the service request buffer and length */
             service_request_len = apdu_len - 3;
             service_request = &apdu[3];
@@ -709,6 +955,7 @@ void apdu_handler(
             }
             invoke_id = apdu[1];
             reason = apdu[2];
+            apdu_peer_round_trip_time(src, invoke_id);
             if (Reject_Function) {
                 Reject_Function(src, invoke_id, reason);
             }
@@ -721,6 +968,12 @@ void apdu_handler(
             server = apdu[0] & 0x01;
             invoke_id = apdu[1];
             reason = apdu[2];
+#if BACNET_SEGMENTATION_ENABLED
+            if (!server) {
+                /* a client aborted our segmented response */
+                tsm_segmented_response_abort(src, invoke_id);
+            }
+#endif
             if (Abort_Function) {
                 Abort_Function(src, invoke_id, reason, server);
             }
@@ -99,6 +99,17 @@ extern "C" {
         uint8_t invoke_id,
         uint8_t reject_reason);
 
+/* what is learned about a peer from its APDUs: the maximum APDU and
+   segments that it accepts, from each confirmed request that it sends,
+   or the milliseconds that it took to reply to one of ours, where 0 is
+   not known */
+    typedef void (
+        *peer_capability_function) (
+        BACNET_ADDRESS * src,
+        unsigned max_apdu,
+        unsigned max_segments,
+        uint16_t round_trip_time);
+
     BACNET_STACK_EXPORT
     void apdu_set_confirmed_ack_handler(
         BACNET_CONFIRMED_SERVICE service_choice,
@@ -164,6 +175,10 @@ extern "C" {
     void apdu_set_reject_handler(
         reject_function pFunction);
 
+    BACNET_STACK_EXPORT
+    void apdu_set_peer_capability_handler(
+        peer_capability_function pFunction);
+
     BACNET_STACK_EXPORT
     uint16_t apdu_decode_confirmed_service_request(
         uint8_t * apdu, /* APDU data */
@@ -185,12 +200,22 @@ extern "C" {
     BACNET_STACK_EXPORT
     void apdu_retries_set(
         uint8_t value);
+    BACNET_STACK_EXPORT
+    uint16_t apdu_segment_timeout(
+        void);
+    BACNET_STACK_EXPORT
+    void apdu_segment_timeout_set(
+        uint16_t milliseconds);
 
     BACNET_STACK_EXPORT
     void apdu_handler(
         BACNET_ADDRESS * src,   /* source address */
         uint8_t * apdu, /* APDU data */
         uint16_t pdu_len);      /* for confirmed messages */
+    BACNET_STACK_EXPORT
+    bool apdu_dcc_npdu_discard(
+        const uint8_t * npdu,
+        uint16_t npdu_len);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,319 @@
+/**
+ * @file
+ * @brief Optional counters of the services handled by the basic APDU and
+ *  NPDU handlers: requests, octets in and out, replies that were errors,
+ *  rejects, or aborts, and a histogram of the handling time.
+ * @note The counters are not atomic. When several threads call the
+ *  handlers, as the server worker threads do, a counter may miss some
+ *  of the concurrent updates.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/platform.h"
+#include "bacnet/basic/service/h_apdu_stats.h"
+
+#if BACNET_APDU_STATS
+static BACNET_APDU_SERVICE_STATS Confirmed_Stats[MAX_BACNET_CONFIRMED_SERVICE];
+static BACNET_APDU_SERVICE_STATS
+    Unconfirmed_Stats[MAX_BACNET_UNCONFIRMED_SERVICE];
+static BACNET_NPDU_STATS NPDU_Stats;
+
+/* the request being handled, which each thread has its own of
+   when the handlers each have their own transmit buffer */
+struct apdu_stats_request {
+    BACNET_APDU_SERVICE_STATS *stats;
+    bool confirmed;
+    unsigned long start;
+};
+#if BACNET_HANDLER_TRANSMIT_BUFFER_THREAD_LOCAL
+static BACNET_STACK_THREAD_LOCAL struct apdu_stats_request Request;
+#else
+static struct apdu_stats_request Request;
+#endif
+
+/**
+ * @brief Clear all the counters
+ */
+void bacnet_apdu_stats_reset(void)
+{
+    memset(Confirmed_Stats, 0, sizeof(Confirmed_Stats));
+    memset(Unconfirmed_Stats, 0, sizeof(Unconfirmed_Stats));
+    memset(&NPDU_Stats, 0, sizeof(NPDU_Stats));
+}
+
+/**
+ * @brief Get the counters of a confirmed service
+ * @param service - the confirmed service
+ * @param stats - the counters are copied here
+ * @return true if the service is valid
+ */
+bool bacnet_apdu_stats_confirmed(
+    BACNET_CONFIRMED_SERVICE service, BACNET_APDU_SERVICE_STATS *stats)
+{
+    if ((service >= MAX_BACNET_CONFIRMED_SERVICE) || !stats) {
+        return false;
+    }
+    memcpy(stats, &Confirmed_Stats[service], sizeof(*stats));
+
+    return true;
+}
+
+/**
+ * @brief Get the counters of an unconfirmed service
+ * @param service - the unconfirmed service
+ * @param stats - the counters are copied here
+ * @return true if the service is valid
+ */
+bool bacnet_apdu_stats_unconfirmed(
+    BACNET_UNCONFIRMED_SERVICE service, BACNET_APDU_SERVICE_STATS *stats)
+{
+    if ((service >= MAX_BACNET_UNCONFIRMED_SERVICE) || !stats) {
+        return false;
+    }
+    memcpy(stats, &Unconfirmed_Stats[service], sizeof(*stats));
+
+    return true;
+}
+
+/**
+ * @brief Get the counters of the NPDU handler
+ * @param stats - the counters are copied here
+ */
+void bacnet_npdu_stats(BACNET_NPDU_STATS *stats)
+{
+    if (stats) {
+        memcpy(stats, &NPDU_Stats, sizeof(*stats));
+    }
+}
+
+/**
+ * @brief Get the histogram bin of a handling time
+ * @param milliseconds - the handling time
+ * @return bin number 0..BACNET_APDU_STATS_LATENCY_BINS-1
+ */
+unsigned bacnet_apdu_stats_latency_bin(uint32_t milliseconds)
+{
+    unsigned bin = 0;
+
+    while (milliseconds && (bin < (BACNET_APDU_STATS_LATENCY_BINS - 1))) {
+        milliseconds >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+/**
+ * @brief Note the start of the handling of a request
+ * @param confirmed - true for a confirmed service request
+ * @param service - the service choice of the request
+ * @param apdu_len - number of octets in the APDU of the request
+ */
+void bacnet_apdu_stats_request_begin(
+    bool confirmed, uint8_t service, uint16_t apdu_len)
+{
+    BACNET_APDU_SERVICE_STATS *stats = NULL;
+
+    if (confirmed) {
+        if (service < MAX_BACNET_CONFIRMED_SERVICE) {
+            stats = &Confirmed_Stats[service];
+        }
+    } else if (service < MAX_BACNET_UNCONFIRMED_SERVICE) {
+        stats = &Unconfirmed_Stats[service];
+    }
+    Request.stats = stats;
+    Request.confirmed = confirmed;
+    if (stats) {
+        stats->requests++;
+        stats->octets_in += apdu_len;
+        Request.start = mstimer_now();
+    }
+}
+
+/**
+ * @brief Note the end of the handling of a request
+ */
+void bacnet_apdu_stats_request_end(void)
+{
+    BACNET_APDU_SERVICE_STATS *stats = Request.stats;
+    uint32_t milliseconds;
+
+    if (stats) {
+        milliseconds = (uint32_t)(mstimer_now() - Request.start);
+        stats->latency_total += milliseconds;
+        if (milliseconds > stats->latency_maximum) {
+            stats->latency_maximum = milliseconds;
+        }
+        stats->latency_bins[bacnet_apdu_stats_latency_bin(milliseconds)]++;
+        Request.stats = NULL;
+    }
+}
+
+/**
+ * @brief Note the reply that a service handler sent for the request
+ *  that it is handling
+ * @param pdu - the NPDU and APDU of the reply
+ * @param pdu_len - number of octets in the reply
+ */
+void bacnet_apdu_stats_reply(const uint8_t *pdu, int pdu_len)
+{
+    BACNET_APDU_SERVICE_STATS *stats = Request.stats;
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int npdu_len;
+
+    if (!stats || !Request.confirmed || !pdu || (pdu_len <= 0)) {
+        return;
+    }
+    npdu_len = bacnet_npdu_decode(
+        (uint8_t *)pdu, (uint16_t)pdu_len, NULL, NULL, &npdu_data);
+    if ((npdu_len <= 0) || (npdu_len >= pdu_len)) {
+        return;
+    }
+    stats->replies++;
+    stats->octets_out += (uint32_t)(pdu_len - npdu_len);
+    switch (pdu[npdu_len] & 0xF0) {
+        case PDU_TYPE_ERROR:
+            stats->errors++;
+            break;
+        case PDU_TYPE_REJECT:
+            stats->rejects++;
+            break;
+        case PDU_TYPE_ABORT:
+            stats->aborts++;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Note a message received by the NPDU handler
+ * @param pdu_len - number of octets in the message
+ * @param network_message - true for a network layer message
+ * @param discarded - true if the message was not handled
+ */
+void bacnet_npdu_stats_received(
+    uint16_t pdu_len, bool network_message, bool discarded)
+{
+    NPDU_Stats.received++;
+    NPDU_Stats.octets_in += pdu_len;
+    if (network_message) {
+        NPDU_Stats.network_messages++;
+    }
+    if (discarded) {
+        NPDU_Stats.discarded++;
+    }
+}
+
+/**
+ * @brief Determine if a property is one of the proprietary Device object
+ *  properties of the counters
+ * @param property - property identifier
+ * @return true if the property shows a counter
+ */
+bool bacnet_apdu_stats_property(BACNET_PROPERTY_ID property)
+{
+    return ((property >= PROP_APDU_STATS_REQUESTS) &&
+        (property <= PROP_APDU_STATS_LATENCY_MAXIMUM));
+}
+
+/**
+ * @brief Get the value of one counter of a confirmed service
+ * @param property - property identifier of the counter
+ * @param stats - counters of the service
+ * @return the value of the counter
+ */
+static uint32_t apdu_stats_property_value(
+    uint32_t property, const BACNET_APDU_SERVICE_STATS *stats)
+{
+    uint32_t value = 0;
+
+    switch (property) {
+        case PROP_APDU_STATS_REQUESTS:
+            value = stats->requests;
+            break;
+        case PROP_APDU_STATS_OCTETS_IN:
+            value = stats->octets_in;
+            break;
+        case PROP_APDU_STATS_OCTETS_OUT:
+            value = stats->octets_out;
+            break;
+        case PROP_APDU_STATS_ERRORS:
+            value = stats->errors;
+            break;
+        case PROP_APDU_STATS_REJECTS:
+            value = stats->rejects;
+            break;
+        case PROP_APDU_STATS_ABORTS:
+            value = stats->aborts;
+            break;
+        case PROP_APDU_STATS_LATENCY_AVERAGE:
+            if (stats->requests) {
+                value = stats->latency_total / stats->requests;
+            }
+            break;
+        case PROP_APDU_STATS_LATENCY_MAXIMUM:
+            value = stats->latency_maximum;
+            break;
+        default:
+            break;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Encode one of the proprietary Device object properties of the
+ *  counters, which is a BACnetARRAY with an element for each confirmed
+ *  service.
+ * @param property - property identifier of the counter
+ * @param array_index - BACNET_ARRAY_ALL, 0 for the size, or 1..N
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @param apdu_max - size of the buffer
+ * @return number of octets encoded, BACNET_STATUS_ERROR for an invalid
+ *  array index, or BACNET_STATUS_ABORT if the buffer is too small
+ */
+int bacnet_apdu_stats_property_encode(BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int apdu_max)
+{
+    uint32_t value;
+    int apdu_len = 0, len;
+    unsigned i;
+
+    if (array_index == 0) {
+        return encode_application_unsigned(apdu, MAX_BACNET_CONFIRMED_SERVICE);
+    }
+    if (array_index == BACNET_ARRAY_ALL) {
+        for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+            value = apdu_stats_property_value(property, &Confirmed_Stats[i]);
+            len = encode_application_unsigned(NULL, value);
+            if ((apdu_len + len) > apdu_max) {
+                return BACNET_STATUS_ABORT;
+            }
+            if (apdu) {
+                len = encode_application_unsigned(&apdu[apdu_len], value);
+            }
+            apdu_len += len;
+        }
+        return apdu_len;
+    }
+    if (array_index > MAX_BACNET_CONFIRMED_SERVICE) {
+        return BACNET_STATUS_ERROR;
+    }
+    value = apdu_stats_property_value(
+        property, &Confirmed_Stats[array_index - 1]);
+
+    return encode_application_unsigned(apdu, value);
+}
+#endif
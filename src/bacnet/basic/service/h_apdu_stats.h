@@ -0,0 +1,128 @@
+/**
+ * @file
+ * @brief API for optional counters of the services handled by the basic
+ *  APDU and NPDU handlers: requests, octets in and out, replies that were
+ *  errors, rejects, or aborts, and a histogram of the handling time.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_SERVICE_APDU_STATS_H
+#define BACNET_BASIC_SERVICE_APDU_STATS_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* 1 to count the services handled by apdu_handler() and npdu_handler().
+   0 removes the counters and their calls from the handlers. */
+#ifndef BACNET_APDU_STATS
+#define BACNET_APDU_STATS 0
+#endif
+/* 1 to show the counters as proprietary properties of the Device object */
+#ifndef BACNET_APDU_STATS_PROPERTIES
+#define BACNET_APDU_STATS_PROPERTIES BACNET_APDU_STATS
+#endif
+/* number of bins in the histogram of handling time. Bin 0 counts times
+   below 1 millisecond, bin N counts times from 2^(N-1) to 2^N - 1
+   milliseconds, and the last bin counts all the longer times. */
+#ifndef BACNET_APDU_STATS_LATENCY_BINS
+#define BACNET_APDU_STATS_LATENCY_BINS 10
+#endif
+/* first of the proprietary Device object properties. Each property is
+   a BACnetARRAY of Unsigned with one element for each confirmed service,
+   where element N is the service with the BACNET_CONFIRMED_SERVICE
+   value of N - 1. */
+#ifndef BACNET_APDU_STATS_PROPERTY_BASE
+#define BACNET_APDU_STATS_PROPERTY_BASE 9000
+#endif
+#define PROP_APDU_STATS_REQUESTS (BACNET_APDU_STATS_PROPERTY_BASE + 0)
+#define PROP_APDU_STATS_OCTETS_IN (BACNET_APDU_STATS_PROPERTY_BASE + 1)
+#define PROP_APDU_STATS_OCTETS_OUT (BACNET_APDU_STATS_PROPERTY_BASE + 2)
+#define PROP_APDU_STATS_ERRORS (BACNET_APDU_STATS_PROPERTY_BASE + 3)
+#define PROP_APDU_STATS_REJECTS (BACNET_APDU_STATS_PROPERTY_BASE + 4)
+#define PROP_APDU_STATS_ABORTS (BACNET_APDU_STATS_PROPERTY_BASE + 5)
+#define PROP_APDU_STATS_LATENCY_AVERAGE (BACNET_APDU_STATS_PROPERTY_BASE + 6)
+#define PROP_APDU_STATS_LATENCY_MAXIMUM (BACNET_APDU_STATS_PROPERTY_BASE + 7)
+
+/* counters of one service */
+typedef struct bacnet_apdu_service_stats {
+    /* requests that were given to the service handler */
+    uint32_t requests;
+    /* APDU octets of the requests */
+    uint32_t octets_in;
+    /* replies sent by the service handler, and their APDU octets */
+    uint32_t replies;
+    uint32_t octets_out;
+    /* replies that were an Error, Reject, or Abort */
+    uint32_t errors;
+    uint32_t rejects;
+    uint32_t aborts;
+    /* handling time of the requests, in milliseconds */
+    uint32_t latency_total;
+    uint32_t latency_maximum;
+    uint32_t latency_bins[BACNET_APDU_STATS_LATENCY_BINS];
+} BACNET_APDU_SERVICE_STATS;
+
+/* counters of npdu_handler() */
+typedef struct bacnet_npdu_stats {
+    /* messages, and their octets */
+    uint32_t received;
+    uint32_t octets_in;
+    /* network layer messages */
+    uint32_t network_messages;
+    /* messages that were not for this device, or not understood */
+    uint32_t discarded;
+} BACNET_NPDU_STATS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if BACNET_APDU_STATS
+BACNET_STACK_EXPORT
+void bacnet_apdu_stats_reset(void);
+BACNET_STACK_EXPORT
+bool bacnet_apdu_stats_confirmed(
+    BACNET_CONFIRMED_SERVICE service, BACNET_APDU_SERVICE_STATS *stats);
+BACNET_STACK_EXPORT
+bool bacnet_apdu_stats_unconfirmed(
+    BACNET_UNCONFIRMED_SERVICE service, BACNET_APDU_SERVICE_STATS *stats);
+BACNET_STACK_EXPORT
+void bacnet_npdu_stats(BACNET_NPDU_STATS *stats);
+BACNET_STACK_EXPORT
+unsigned bacnet_apdu_stats_latency_bin(uint32_t milliseconds);
+
+BACNET_STACK_EXPORT
+bool bacnet_apdu_stats_property(BACNET_PROPERTY_ID property);
+BACNET_STACK_EXPORT
+int bacnet_apdu_stats_property_encode(BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int apdu_max);
+
+BACNET_STACK_EXPORT
+void bacnet_apdu_stats_request_begin(
+    bool confirmed, uint8_t service, uint16_t apdu_len);
+BACNET_STACK_EXPORT
+void bacnet_apdu_stats_request_end(void);
+BACNET_STACK_EXPORT
+void bacnet_apdu_stats_reply(const uint8_t *pdu, int pdu_len);
+BACNET_STACK_EXPORT
+void bacnet_npdu_stats_received(
+    uint16_t pdu_len, bool network_message, bool discarded);
+#else
+/* the handlers call these without checking BACNET_APDU_STATS */
+#define bacnet_apdu_stats_request_begin(confirmed, service, apdu_len) \
+    ((void)(confirmed), (void)(service), (void)(apdu_len))
+#define bacnet_apdu_stats_request_end() ((void)0)
+#define bacnet_apdu_stats_reply(pdu, pdu_len) ((void)(pdu), (void)(pdu_len))
+#define bacnet_npdu_stats_received(pdu_len, network_message, discarded) \
+    ((void)(pdu_len), (void)(network_message), (void)(discarded))
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -162,6 +162,7 @@ CCOV_ABORT:
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
         PRINTF("CCOV: Failed to send PDU (%s)!\n", strerror(errno));
     }
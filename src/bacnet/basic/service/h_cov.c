@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 /* BACnet Stack defines - first */
@@ -28,26 +29,44 @@
 /* basic objects, services, TSM, and datalink */
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/snapshot.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/key.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/memstats.h"
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/datalink/datalink.h"
 
 #ifndef MAX_COV_PROPERTIES
 #define MAX_COV_PROPERTIES 2
 #endif
-
 typedef struct BACnet_COV_Address {
     bool valid : 1;
+    unsigned ref_count; /* number of subscriptions using this address */
     BACNET_ADDRESS dest;
+    /* NPDU headers of the unconfirmed and confirmed notifications */
+    BACNET_NPDU_HEADER npdu_header[2];
 } BACNET_COV_ADDRESS;
 
 /* note: This COV service only monitors the properties
    of an object that have been specified in the standard.  */
 typedef struct BACnet_COV_Subscription_Flags {
-    bool valid : 1;
     bool issueConfirmedNotifications : 1; /* optional */
     bool send_requested : 1;
+    bool covIncrementPresent : 1; /* SubscribeCOVProperty, optional */
+    bool cov_reported : 1; /* the last values below are valid */
 } BACNET_COV_SUBSCRIPTION_FLAGS;
 
+/* a property of a monitored object with SubscribeCOVProperty
+   subscriptions, which is read once for all of them */
+typedef struct BACnet_COV_Property {
+    BACNET_PROPERTY_ID propertyIdentifier;
+    BACNET_ARRAY_INDEX propertyArrayIndex;
+    unsigned ref_count; /* number of subscriptions to this property */
+    struct BACnet_COV_Property *next;
+} BACNET_COV_PROPERTY;
+
 typedef struct BACnet_COV_Subscription {
     BACNET_COV_SUBSCRIPTION_FLAGS flag;
     unsigned dest_index;
@@ -55,17 +74,80 @@ typedef struct BACnet_COV_Subscription {
     uint32_t subscriberProcessIdentifier;
     uint32_t lifetime; /* optional */
     BACNET_OBJECT_ID monitoredObjectIdentifier;
+    /* local subscriber, called instead of sending a notification */
+    handler_cov_local_callback local_callback;
+    /* monitored property of a SubscribeCOVProperty, or NULL */
+    BACNET_COV_PROPERTY *cov_property;
+    float covIncrement; /* SubscribeCOVProperty, optional */
+    /* the value and Status_Flags of the last notification of the
+       monitored property, to compare with the increment */
+    float cov_value;
+    uint32_t cov_value_hash;
+    uint32_t cov_status_hash;
+    /* next subscription to the same monitored object */
+    struct BACnet_COV_Subscription *next;
 } BACNET_COV_SUBSCRIPTION;
 
+/* the subscriptions to one monitored object */
+typedef struct BACnet_COV_Object {
+    BACNET_OBJECT_ID objectIdentifier;
+    BACNET_COV_SUBSCRIPTION *subscriptions;
+    /* the properties of the SubscribeCOVProperty subscriptions */
+    BACNET_COV_PROPERTY *properties;
+    /* check the object, even if it is not polled */
+    bool poll_requested : 1;
+} BACNET_COV_OBJECT;
+
+/* limit on the number of subscriptions - they are allocated as needed */
 #ifndef MAX_COV_SUBCRIPTIONS
 #define MAX_COV_SUBCRIPTIONS 128
 #endif
-static BACNET_COV_SUBSCRIPTION COV_Subscriptions[MAX_COV_SUBCRIPTIONS];
+/* monitored objects, keyed by object identifier */
+static OS_Keylist COV_Object_List;
+static unsigned COV_Subscription_Count;
 #ifndef MAX_COV_ADDRESSES
 #define MAX_COV_ADDRESSES 16
 #endif
 static BACNET_COV_ADDRESS COV_Addresses[MAX_COV_ADDRESSES];
 
+/* states for transmitting */
+typedef enum {
+    COV_STATE_IDLE = 0,
+    COV_STATE_MARK,
+    COV_STATE_FREE,
+    COV_STATE_SEND
+} COV_TASK_STATE;
+static COV_TASK_STATE COV_Task_State = COV_STATE_IDLE;
+/* index of the monitored object that the task is working on */
+static int COV_Task_Index;
+/* next subscription that the task will send, in the current object */
+static BACNET_COV_SUBSCRIPTION *COV_Task_Subscription;
+/* listOfValues of the object being sent, encoded once for each batch */
+static uint8_t COV_Value_List_Buffer[MAX_APDU];
+/* listOfValues of a monitored property, encoded once for each batch */
+static uint8_t COV_Property_Value_Buffer[MAX_APDU];
+#if BACNET_COV_NOTIFICATION_MULTIPLE_ENABLED
+/* listOfValues of another object of a COVNotificationMultiple */
+static uint8_t COV_Multiple_Value_Buffer[MAX_APDU];
+#endif
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+/* a changed object in the queue, with the changes of the object */
+typedef struct BACnet_COV_Change {
+    KEY key;
+    uint8_t changes;
+} BACNET_COV_CHANGE;
+/* changed objects, put by the objects and taken by the task */
+static RING_BUFFER COV_Change_Queue;
+static volatile uint8_t COV_Change_Queue_Buffer
+    [BACNET_COV_CHANGE_QUEUE_SIZE * sizeof(BACNET_COV_CHANGE)];
+/* a changed object did not fit into the queue */
+static volatile bool COV_Change_Queue_Overflow;
+/* object types that report their changes, and are not polled */
+static volatile uint8_t COV_Change_Types[(MAX_BACNET_OBJECT_TYPE + 7) / 8];
+/* poll every monitored object in this task cycle */
+static bool COV_Change_Poll_All;
+#endif
+
 /**
  * Gets the address from the list of COV addresses
  *
@@ -88,34 +170,28 @@ static BACNET_ADDRESS *cov_address_get(unsigned index)
 }
 
 /**
- * Removes the address from the list of COV addresses, if it is not
- * used by other COV subscriptions
+ * Releases a COV subscription use of an address, and removes the address
+ * from the list of COV addresses when no other COV subscription uses it
+ *
+ * @param  index - offset into COV address list where address is stored
  */
-static void cov_address_remove_unused(void)
+static void cov_address_release(unsigned index)
 {
-    unsigned index = 0;
-    unsigned cov_index = 0;
-    bool found = false;
-
-    for (cov_index = 0; cov_index < MAX_COV_ADDRESSES; cov_index++) {
-        if (COV_Addresses[cov_index].valid) {
-            found = false;
-            for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-                if ((COV_Subscriptions[index].flag.valid) &&
-                    (COV_Subscriptions[index].dest_index == cov_index)) {
-                    found = true;
-                    break;
-                }
+    if (index < MAX_COV_ADDRESSES) {
+        if (COV_Addresses[index].valid) {
+            if (COV_Addresses[index].ref_count > 0) {
+                COV_Addresses[index].ref_count--;
             }
-            if (!found) {
-                COV_Addresses[cov_index].valid = false;
+            if (COV_Addresses[index].ref_count == 0) {
+                COV_Addresses[index].valid = false;
             }
         }
     }
 }
 
 /**
- * Adds the address to the list of COV addresses
+ * Adds the address to the list of COV addresses, or adds another use
+ * of the address when it is already in the list
  *
  * @param  dest - address to be added if there is room in the list
  *
@@ -137,6 +213,7 @@ static int cov_address_add(BACNET_ADDRESS *dest)
                 found = bacnet_address_same(dest, cov_dest);
                 if (found) {
                     index = i;
+                    COV_Addresses[i].ref_count++;
                     break;
                 }
             }
@@ -150,6 +227,9 @@ static int cov_address_add(BACNET_ADDRESS *dest)
                     cov_dest = &COV_Addresses[i].dest;
                     bacnet_address_copy(cov_dest, dest);
                     COV_Addresses[i].valid = true;
+                    COV_Addresses[i].ref_count = 1;
+                    npdu_header_reset(&COV_Addresses[i].npdu_header[0]);
+                    npdu_header_reset(&COV_Addresses[i].npdu_header[1]);
                     break;
                 }
             }
@@ -159,6 +239,283 @@ static int cov_address_add(BACNET_ADDRESS *dest)
     return index;
 }
 
+/**
+ * Encodes the NPDU portion of a notification to an address of the list
+ * of COV addresses, from the header built for its first notification
+ *
+ * @param  index - offset into COV address list where address is stored
+ * @param  data_expecting_reply - true for a confirmed notification
+ * @param  src - address of this device
+ * @param  npdu_data - the npdu_data of the header
+ *
+ * @return number of bytes encoded into the transmit buffer
+ */
+static int cov_address_npdu_encode(unsigned index,
+    bool data_expecting_reply,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu_data)
+{
+    BACNET_COV_ADDRESS *cov_address = &COV_Addresses[index];
+    BACNET_NPDU_HEADER *header;
+
+    npdu_encode_npdu_data(
+        npdu_data, data_expecting_reply, MESSAGE_PRIORITY_NORMAL);
+    if (src->net) {
+        /* the header of a routed source, such as one of the Devices
+           of a gateway, is not the same for each notification */
+        return npdu_encode_pdu(
+            &Handler_Transmit_Buffer[0], &cov_address->dest, src, npdu_data);
+    }
+    header = &cov_address->npdu_header[data_expecting_reply ? 1 : 0];
+    if (header->pdu_len == 0) {
+        npdu_header_init(header, &cov_address->dest, src, npdu_data);
+    }
+
+    return npdu_header_encode(
+        &Handler_Transmit_Buffer[0], sizeof(Handler_Transmit_Buffer), header);
+}
+
+/**
+ * Adjusts the task position after a monitored object was added to
+ * or removed from the list, so that the task does not skip or repeat
+ * an object.  During the send state, the task index is the object
+ * being sent.  Otherwise, it is the next object to be checked.
+ *
+ * @param  index - index of the monitored object that was added or removed
+ * @param  added - true if the object was added, false if removed
+ */
+static void cov_task_index_adjust(int index, bool added)
+{
+    if ((index < COV_Task_Index) ||
+        ((index == COV_Task_Index) && (COV_Task_State == COV_STATE_SEND))) {
+        if (added) {
+            COV_Task_Index++;
+        } else {
+            COV_Task_Index--;
+        }
+    }
+}
+
+/**
+ * Finds the subscriptions for a monitored object
+ *
+ * @param  object_type - type of the monitored object
+ * @param  object_instance - instance of the monitored object
+ *
+ * @return the monitored object, or NULL if it has no subscriptions
+ */
+static BACNET_COV_OBJECT *
+cov_object_find(BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    return Keylist_Data(
+        COV_Object_List, KEY_ENCODE(object_type, object_instance));
+}
+
+/**
+ * Finds a monitored property of a monitored object
+ *
+ * @param  cov_object - monitored object
+ * @param  property - the monitored property
+ * @param  array_index - array index of the monitored property
+ *
+ * @return the monitored property, or NULL if it has no subscriptions
+ */
+static BACNET_COV_PROPERTY *cov_property_find(BACNET_COV_OBJECT *cov_object,
+    BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    BACNET_COV_PROPERTY *cov_property = NULL;
+
+    if (cov_object) {
+        cov_property = cov_object->properties;
+    }
+    while (cov_property) {
+        if ((cov_property->propertyIdentifier == property) &&
+            (cov_property->propertyArrayIndex == array_index)) {
+            break;
+        }
+        cov_property = cov_property->next;
+    }
+
+    return cov_property;
+}
+
+/**
+ * Adds a reference to a monitored property of a monitored object,
+ * adding the property when it has no other subscriptions.
+ *
+ * @param  cov_object - monitored object
+ * @param  reference - the monitored property
+ *
+ * @return the monitored property, or NULL if out of resources
+ */
+static BACNET_COV_PROPERTY *cov_property_add(
+    BACNET_COV_OBJECT *cov_object, const BACNET_PROPERTY_REFERENCE *reference)
+{
+    BACNET_COV_PROPERTY *cov_property = NULL;
+
+    cov_property = cov_property_find(cov_object,
+        reference->propertyIdentifier, reference->propertyArrayIndex);
+    if (!cov_property) {
+        cov_property = bacnet_memstats_calloc(
+            MEMSTATS_COV, 1, sizeof(BACNET_COV_PROPERTY));
+        if (!cov_property) {
+            return NULL;
+        }
+        cov_property->propertyIdentifier = reference->propertyIdentifier;
+        cov_property->propertyArrayIndex = reference->propertyArrayIndex;
+        cov_property->next = cov_object->properties;
+        cov_object->properties = cov_property;
+    }
+    cov_property->ref_count++;
+
+    return cov_property;
+}
+
+/**
+ * Releases a reference to a monitored property of a monitored object,
+ * and frees the property when it has no other subscriptions.
+ *
+ * @param  cov_object - monitored object
+ * @param  cov_property - the monitored property
+ */
+static void cov_property_release(
+    BACNET_COV_OBJECT *cov_object, BACNET_COV_PROPERTY *cov_property)
+{
+    BACNET_COV_PROPERTY **link = NULL;
+
+    if (cov_property->ref_count > 1) {
+        cov_property->ref_count--;
+        return;
+    }
+    link = &cov_object->properties;
+    while (*link && (*link != cov_property)) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = cov_property->next;
+    }
+    bacnet_memstats_free(MEMSTATS_COV, cov_property, sizeof(*cov_property));
+}
+
+/**
+ * Adds a subscription to the subscriptions of its monitored object,
+ * adding the monitored object when it has no other subscriptions.
+ *
+ * @param  cov_subscription - subscription to be added
+ * @param  reference - monitored property of a SubscribeCOVProperty,
+ *  or NULL for a subscription to the object
+ *
+ * @return true if added, false if out of resources
+ */
+static bool cov_subscription_add(BACNET_COV_SUBSCRIPTION *cov_subscription,
+    const BACNET_PROPERTY_REFERENCE *reference)
+{
+    BACNET_COV_OBJECT *cov_object = NULL;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    int index = 0;
+
+    if (!COV_Object_List) {
+        COV_Object_List = Keylist_Create();
+        if (!COV_Object_List) {
+            return false;
+        }
+    }
+    object_type =
+        (BACNET_OBJECT_TYPE)cov_subscription->monitoredObjectIdentifier.type;
+    object_instance = cov_subscription->monitoredObjectIdentifier.instance;
+    cov_object = cov_object_find(object_type, object_instance);
+    if (!cov_object) {
+        cov_object = bacnet_memstats_calloc(
+            MEMSTATS_COV, 1, sizeof(BACNET_COV_OBJECT));
+        if (!cov_object) {
+            return false;
+        }
+        cov_object->objectIdentifier.type = object_type;
+        cov_object->objectIdentifier.instance = object_instance;
+        index = Keylist_Data_Add(COV_Object_List,
+            KEY_ENCODE(object_type, object_instance), cov_object);
+        if (index < 0) {
+            bacnet_memstats_free(MEMSTATS_COV, cov_object, sizeof(*cov_object));
+            return false;
+        }
+        cov_task_index_adjust(index, true);
+    }
+    if (reference) {
+        cov_subscription->cov_property =
+            cov_property_add(cov_object, reference);
+        if (!cov_subscription->cov_property) {
+            if (!cov_object->subscriptions && !cov_object->properties) {
+                index = Keylist_Index(COV_Object_List,
+                    KEY_ENCODE(object_type, object_instance));
+                Keylist_Data_Delete_By_Index(COV_Object_List, index);
+                cov_task_index_adjust(index, false);
+                bacnet_memstats_free(
+                    MEMSTATS_COV, cov_object, sizeof(*cov_object));
+            }
+            return false;
+        }
+    }
+    cov_subscription->next = cov_object->subscriptions;
+    cov_object->subscriptions = cov_subscription;
+    cov_object->poll_requested = true;
+    COV_Subscription_Count++;
+
+    return true;
+}
+
+/**
+ * Removes a subscription from the subscriptions of its monitored object,
+ * removing the monitored object when it has no other subscriptions,
+ * and frees the subscription.
+ *
+ * @param  cov_object - monitored object of the subscription
+ * @param  cov_subscription - subscription to be removed
+ *
+ * @return true if the monitored object was removed from the list
+ */
+static bool cov_subscription_remove(
+    BACNET_COV_OBJECT *cov_object, BACNET_COV_SUBSCRIPTION *cov_subscription)
+{
+    BACNET_COV_SUBSCRIPTION **link = NULL;
+    KEY key;
+    int index = 0;
+
+    link = &cov_object->subscriptions;
+    while (*link && (*link != cov_subscription)) {
+        link = &(*link)->next;
+    }
+    if (!*link) {
+        return false;
+    }
+    *link = cov_subscription->next;
+    if (COV_Task_Subscription == cov_subscription) {
+        COV_Task_Subscription = cov_subscription->next;
+    }
+    cov_address_release(cov_subscription->dest_index);
+    if (cov_subscription->invokeID) {
+        tsm_free_invoke_id(cov_subscription->invokeID);
+    }
+    if (cov_subscription->cov_property) {
+        cov_property_release(cov_object, cov_subscription->cov_property);
+    }
+    bacnet_memstats_free(
+        MEMSTATS_COV, cov_subscription, sizeof(*cov_subscription));
+    COV_Subscription_Count--;
+    if (cov_object->subscriptions) {
+        return false;
+    }
+    key = KEY_ENCODE(cov_object->objectIdentifier.type,
+        cov_object->objectIdentifier.instance);
+    index = Keylist_Index(COV_Object_List, key);
+    Keylist_Data_Delete_By_Index(COV_Object_List, index);
+    cov_task_index_adjust(index, false);
+    bacnet_memstats_free(MEMSTATS_COV, cov_object, sizeof(*cov_object));
+
+    return true;
+}
+
 /*
 BACnetCOVSubscription ::= SEQUENCE {
 Recipient [0] BACnetRecipientProcess,
@@ -246,9 +603,23 @@ static int cov_encode_subscription(
         cov_subscription->monitoredObjectIdentifier.instance);
     apdu_len += len;
     /* propertyIdentifier [1] */
-    /* FIXME: we are monitoring 2 properties! How to encode? */
-    len = encode_context_enumerated(&apdu[apdu_len], 1, PROP_PRESENT_VALUE);
-    apdu_len += len;
+    if (cov_subscription->cov_property) {
+        len = encode_context_enumerated(&apdu[apdu_len], 1,
+            cov_subscription->cov_property->propertyIdentifier);
+        apdu_len += len;
+        /* propertyArrayIndex [2] OPTIONAL */
+        if (cov_subscription->cov_property->propertyArrayIndex !=
+            BACNET_ARRAY_ALL) {
+            len = encode_context_unsigned(&apdu[apdu_len], 2,
+                cov_subscription->cov_property->propertyArrayIndex);
+            apdu_len += len;
+        }
+    } else {
+        /* FIXME: we are monitoring 2 properties! How to encode? */
+        len =
+            encode_context_enumerated(&apdu[apdu_len], 1, PROP_PRESENT_VALUE);
+        apdu_len += len;
+    }
     /* MonitoredPropertyReference [1] - closing */
     len = encode_closing_tag(&apdu[apdu_len], 1);
     apdu_len += len;
@@ -260,13 +631,19 @@ static int cov_encode_subscription(
     len =
         encode_context_unsigned(&apdu[apdu_len], 3, cov_subscription->lifetime);
     apdu_len += len;
+    /* COVIncrement [4] REAL OPTIONAL */
+    if (cov_subscription->flag.covIncrementPresent) {
+        len = encode_context_real(
+            &apdu[apdu_len], 4, cov_subscription->covIncrement);
+        apdu_len += len;
+    }
 
     return apdu_len;
 }
 
 /** Handle a request to list all the COV subscriptions.
  * @ingroup DSCOV
- *  Invoked by a request to read the Device object's
+ *  Invoked by the Device object's Read_Property handler for
  * PROP_ACTIVE_COV_SUBSCRIPTIONS. Loops through the list of COV Subscriptions,
  * and, for each valid one, adds its description to the APDU.
  *  @note This function needs some work to better handle buffer overruns.
@@ -279,18 +656,26 @@ int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu)
 {
     int len = 0;
     int apdu_len = 0;
-    unsigned index = 0;
+    int index = 0;
+    BACNET_COV_OBJECT *cov_object = NULL;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
 
     if (apdu) {
-        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-            if (COV_Subscriptions[index].flag.valid) {
-                len = cov_encode_subscription(&apdu[apdu_len],
-                    max_apdu - apdu_len, &COV_Subscriptions[index]);
+        for (index = 0; index < Keylist_Count(COV_Object_List); index++) {
+            cov_object = Keylist_Data_Index(COV_Object_List, index);
+            if (!cov_object) {
+                continue;
+            }
+            cov_subscription = cov_object->subscriptions;
+            while (cov_subscription) {
+                len = cov_encode_subscription(
+                    &apdu[apdu_len], max_apdu - apdu_len, cov_subscription);
                 apdu_len += len;
                 /* TODO: too late here to notice that we overran the buffer */
                 if (apdu_len > max_apdu) {
                     return -2;
                 }
+                cov_subscription = cov_subscription->next;
             }
         }
     }
@@ -298,29 +683,65 @@ int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu)
     return apdu_len;
 }
 
-/** Handler to initialize the COV list, clearing and disabling each entry.
+/** Handler to initialize the COV list, removing each entry.
  * @ingroup DSCOV
  */
 void handler_cov_init(void)
 {
     unsigned index = 0;
+    BACNET_COV_OBJECT *cov_object = NULL;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+    BACNET_COV_PROPERTY *cov_property = NULL;
+    size_t static_bytes;
 
-    for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-        /* initialize with invalid COV address */
-        COV_Subscriptions[index].flag.valid = false;
-        COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-        COV_Subscriptions[index].subscriberProcessIdentifier = 0;
-        COV_Subscriptions[index].monitoredObjectIdentifier.type =
-            OBJECT_ANALOG_INPUT;
-        COV_Subscriptions[index].monitoredObjectIdentifier.instance = 0;
-        COV_Subscriptions[index].flag.issueConfirmedNotifications = false;
-        COV_Subscriptions[index].invokeID = 0;
-        COV_Subscriptions[index].lifetime = 0;
-        COV_Subscriptions[index].flag.send_requested = false;
+    if (COV_Object_List) {
+        do {
+            cov_object = Keylist_Data_Pop(COV_Object_List);
+            if (cov_object) {
+                while (cov_object->subscriptions) {
+                    cov_subscription = cov_object->subscriptions;
+                    cov_object->subscriptions = cov_subscription->next;
+                    bacnet_memstats_free(MEMSTATS_COV, cov_subscription,
+                        sizeof(*cov_subscription));
+                }
+                while (cov_object->properties) {
+                    cov_property = cov_object->properties;
+                    cov_object->properties = cov_property->next;
+                    bacnet_memstats_free(
+                        MEMSTATS_COV, cov_property, sizeof(*cov_property));
+                }
+                bacnet_memstats_free(
+                    MEMSTATS_COV, cov_object, sizeof(*cov_object));
+            }
+        } while (cov_object);
+    } else {
+        COV_Object_List = Keylist_Create();
     }
+    COV_Subscription_Count = 0;
+    COV_Task_State = COV_STATE_IDLE;
+    COV_Task_Index = 0;
+    COV_Task_Subscription = NULL;
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+    Ringbuf_Init(&COV_Change_Queue, COV_Change_Queue_Buffer,
+        sizeof(BACNET_COV_CHANGE), BACNET_COV_CHANGE_QUEUE_SIZE);
+    COV_Change_Queue_Overflow = false;
+    COV_Change_Poll_All = false;
+#endif
     for (index = 0; index < MAX_COV_ADDRESSES; index++) {
         COV_Addresses[index].valid = false;
+        COV_Addresses[index].ref_count = 0;
+        npdu_header_reset(&COV_Addresses[index].npdu_header[0]);
+        npdu_header_reset(&COV_Addresses[index].npdu_header[1]);
     }
+    static_bytes = sizeof(COV_Addresses) + sizeof(COV_Value_List_Buffer) +
+        sizeof(COV_Property_Value_Buffer);
+#if BACNET_COV_NOTIFICATION_MULTIPLE_ENABLED
+    static_bytes += sizeof(COV_Multiple_Value_Buffer);
+#endif
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+    static_bytes += sizeof(COV_Change_Queue_Buffer);
+#endif
+    bacnet_memstats_static(MEMSTATS_COV, static_bytes);
 }
 
 static bool cov_list_subscribe(BACNET_ADDRESS *src,
@@ -328,96 +749,139 @@ static bool cov_list_subscribe(BACNET_ADDRESS *src,
     BACNET_ERROR_CLASS *error_class,
     BACNET_ERROR_CODE *error_code)
 {
-    bool existing_entry = false;
-    int index;
-    int first_invalid_index = -1;
     bool found = true;
     bool address_match = false;
     BACNET_ADDRESS *dest = NULL;
+    BACNET_COV_OBJECT *cov_object = NULL;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+    BACNET_COV_PROPERTY *cov_property = NULL;
 
     /* unable to subscribe - resources? */
     /* unable to cancel subscription - other? */
 
-    /* existing? - match Object ID and Process ID and address */
-    for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-        if (COV_Subscriptions[index].flag.valid) {
-            dest = cov_address_get(COV_Subscriptions[index].dest_index);
-            if (dest) {
-                address_match = bacnet_address_same(src, dest);
-            } else {
-                /* skip address matching - we don't have an address */
-                address_match = true;
-            }
-            if ((COV_Subscriptions[index].monitoredObjectIdentifier.type ==
-                    cov_data->monitoredObjectIdentifier.type) &&
-                (COV_Subscriptions[index].monitoredObjectIdentifier.instance ==
-                    cov_data->monitoredObjectIdentifier.instance) &&
-                (COV_Subscriptions[index].subscriberProcessIdentifier ==
-                    cov_data->subscriberProcessIdentifier) &&
-                address_match) {
-                existing_entry = true;
-                if (cov_data->cancellationRequest) {
-                    /* initialize with invalid COV address */
-                    COV_Subscriptions[index].flag.valid = false;
-                    COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-                    cov_address_remove_unused();
-                } else {
-                    COV_Subscriptions[index].dest_index = cov_address_add(src);
-                    COV_Subscriptions[index].flag.issueConfirmedNotifications =
-                        cov_data->issueConfirmedNotifications;
-                    COV_Subscriptions[index].lifetime = cov_data->lifetime;
-                    COV_Subscriptions[index].flag.send_requested = true;
-                }
-                if (COV_Subscriptions[index].invokeID) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
-                }
-                break;
+    /* existing? - match Object ID, Property, Process ID and address */
+    cov_object = cov_object_find(
+        (BACNET_OBJECT_TYPE)cov_data->monitoredObjectIdentifier.type,
+        cov_data->monitoredObjectIdentifier.instance);
+    if (cov_object) {
+        cov_subscription = cov_object->subscriptions;
+        if (cov_data->covSubscribeToProperty) {
+            cov_property = cov_property_find(cov_object,
+                cov_data->monitoredProperty.propertyIdentifier,
+                cov_data->monitoredProperty.propertyArrayIndex);
+            if (!cov_property) {
+                /* nobody is subscribed to this property */
+                cov_subscription = NULL;
             }
+        }
+    }
+    while (cov_subscription) {
+        if (cov_subscription->local_callback ||
+            (cov_subscription->cov_property != cov_property)) {
+            /* local subscriptions are not seen by remote subscribers,
+               and each property is a subscription of its own */
+            cov_subscription = cov_subscription->next;
+            continue;
+        }
+        dest = cov_address_get(cov_subscription->dest_index);
+        if (dest) {
+            address_match = bacnet_address_same(src, dest);
         } else {
-            if (first_invalid_index < 0) {
-                first_invalid_index = index;
-            }
+            /* skip address matching - we don't have an address */
+            address_match = true;
+        }
+        if ((cov_subscription->subscriberProcessIdentifier ==
+                cov_data->subscriberProcessIdentifier) &&
+            address_match) {
+            break;
         }
+        cov_subscription = cov_subscription->next;
     }
-    if (!existing_entry && (first_invalid_index >= 0) &&
-        (!cov_data->cancellationRequest)) {
-        index = first_invalid_index;
-        found = true;
-        COV_Subscriptions[index].flag.valid = true;
-        COV_Subscriptions[index].dest_index = cov_address_add(src);
-        COV_Subscriptions[index].monitoredObjectIdentifier.type =
-            cov_data->monitoredObjectIdentifier.type;
-        COV_Subscriptions[index].monitoredObjectIdentifier.instance =
-            cov_data->monitoredObjectIdentifier.instance;
-        COV_Subscriptions[index].subscriberProcessIdentifier =
-            cov_data->subscriberProcessIdentifier;
-        COV_Subscriptions[index].flag.issueConfirmedNotifications =
-            cov_data->issueConfirmedNotifications;
-        COV_Subscriptions[index].invokeID = 0;
-        COV_Subscriptions[index].lifetime = cov_data->lifetime;
-        COV_Subscriptions[index].flag.send_requested = true;
-    } else if (!existing_entry) {
-        if (first_invalid_index < 0) {
+    if (cov_subscription) {
+        if (cov_data->cancellationRequest) {
+            cov_subscription_remove(cov_object, cov_subscription);
+        } else {
+            if (!dest) {
+                cov_subscription->dest_index = cov_address_add(src);
+            }
+            cov_subscription->flag.issueConfirmedNotifications =
+                cov_data->issueConfirmedNotifications;
+            cov_subscription->lifetime = cov_data->lifetime;
+            if (cov_subscription->cov_property) {
+                cov_subscription->flag.covIncrementPresent =
+                    cov_data->covIncrementPresent;
+                cov_subscription->covIncrement = cov_data->covIncrement;
+            }
+            cov_subscription->flag.send_requested = true;
+            cov_object->poll_requested = true;
+            if (cov_subscription->invokeID) {
+                tsm_free_invoke_id(cov_subscription->invokeID);
+                cov_subscription->invokeID = 0;
+            }
+        }
+    } else if (!cov_data->cancellationRequest) {
+        if (COV_Subscription_Count < MAX_COV_SUBCRIPTIONS) {
+            cov_subscription = bacnet_memstats_calloc(
+                MEMSTATS_COV, 1, sizeof(BACNET_COV_SUBSCRIPTION));
+        }
+        if (cov_subscription) {
+            cov_subscription->monitoredObjectIdentifier.type =
+                cov_data->monitoredObjectIdentifier.type;
+            cov_subscription->monitoredObjectIdentifier.instance =
+                cov_data->monitoredObjectIdentifier.instance;
+            cov_subscription->subscriberProcessIdentifier =
+                cov_data->subscriberProcessIdentifier;
+            cov_subscription->flag.issueConfirmedNotifications =
+                cov_data->issueConfirmedNotifications;
+            cov_subscription->invokeID = 0;
+            cov_subscription->lifetime = cov_data->lifetime;
+            cov_subscription->flag.send_requested = true;
+            if (cov_data->covSubscribeToProperty) {
+                cov_subscription->flag.covIncrementPresent =
+                    cov_data->covIncrementPresent;
+                cov_subscription->covIncrement = cov_data->covIncrement;
+            }
+            if (cov_subscription_add(cov_subscription,
+                    cov_data->covSubscribeToProperty
+                        ? &cov_data->monitoredProperty
+                        : NULL)) {
+                cov_subscription->dest_index = cov_address_add(src);
+            } else {
+                bacnet_memstats_free(
+                    MEMSTATS_COV, cov_subscription, sizeof(*cov_subscription));
+                cov_subscription = NULL;
+            }
+        }
+        if (!cov_subscription) {
             /* Out of resources */
             *error_class = ERROR_CLASS_RESOURCES;
             *error_code = ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
             found = false;
-        } else {
-            /* cancellationRequest - valid object not subscribed */
-            /* From BACnet Standard 135-2010-13.14.2
-               ...Cancellations that are issued for which no matching COV
-               context can be found shall succeed as if a context had
-               existed, returning 'Result(+)'. */
-            found = true;
         }
+    } else {
+        /* cancellationRequest - valid object not subscribed */
+        /* From BACnet Standard 135-2010-13.14.2
+           ...Cancellations that are issued for which no matching COV
+           context can be found shall succeed as if a context had
+           existed, returning 'Result(+)'. */
+        found = true;
     }
 
     return found;
 }
 
+/**
+ * Sends a COV notification to a subscriber
+ *
+ * @param  cov_subscription - subscription to notify
+ * @param  value_list - encoded listOfValues of the monitored object
+ * @param  value_list_len - number of bytes in the encoded listOfValues
+ *
+ * @return true if the notification was sent
+ */
 static bool cov_send_request(BACNET_COV_SUBSCRIPTION *cov_subscription,
-    BACNET_PROPERTY_VALUE *value_list)
+    const uint8_t *value_list,
+    size_t value_list_len)
 {
     int len = 0;
     int pdu_len = 0;
@@ -446,9 +910,12 @@ static bool cov_send_request(BACNET_COV_SUBSCRIPTION *cov_subscription,
         return status;
     }
     datalink_get_my_address(&my_address);
-    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
-    pdu_len = npdu_encode_pdu(
-        &Handler_Transmit_Buffer[0], dest, &my_address, &npdu_data);
+    pdu_len = cov_address_npdu_encode(cov_subscription->dest_index,
+        cov_subscription->flag.issueConfirmedNotifications, &my_address,
+        &npdu_data);
+    if (pdu_len <= 0) {
+        return status;
+    }
     /* load the COV data structure for outgoing message */
     cov_data.subscriberProcessIdentifier =
         cov_subscription->subscriberProcessIdentifier;
@@ -458,21 +925,30 @@ static bool cov_send_request(BACNET_COV_SUBSCRIPTION *cov_subscription,
     cov_data.monitoredObjectIdentifier.instance =
         cov_subscription->monitoredObjectIdentifier.instance;
     cov_data.timeRemaining = cov_subscription->lifetime;
-    cov_data.listOfValues = value_list;
+    cov_data.listOfValues = NULL;
     if (cov_subscription->flag.issueConfirmedNotifications) {
-        npdu_data.data_expecting_reply = true;
         invoke_id = tsm_next_free_invokeID();
         if (invoke_id) {
-            cov_subscription->invokeID = invoke_id;
-            len = ccov_notify_encode_apdu(&Handler_Transmit_Buffer[pdu_len],
+            len = ccov_notify_values_encode_apdu(
+                &Handler_Transmit_Buffer[pdu_len],
                 sizeof(Handler_Transmit_Buffer) - pdu_len, invoke_id,
-                &cov_data);
+                &cov_data, value_list, value_list_len);
+            if (len <= 0) {
+                tsm_free_invoke_id(invoke_id);
+                goto COV_FAILED;
+            }
+            cov_subscription->invokeID = invoke_id;
         } else {
             goto COV_FAILED;
         }
     } else {
-        len = ucov_notify_encode_apdu(&Handler_Transmit_Buffer[pdu_len],
-            sizeof(Handler_Transmit_Buffer) - pdu_len, &cov_data);
+        len = ucov_notify_values_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len],
+            sizeof(Handler_Transmit_Buffer) - pdu_len, &cov_data, value_list,
+            value_list_len);
+        if (len <= 0) {
+            goto COV_FAILED;
+        }
     }
     pdu_len += len;
     if (cov_subscription->flag.issueConfirmedNotifications) {
@@ -483,6 +959,10 @@ static bool cov_send_request(BACNET_COV_SUBSCRIPTION *cov_subscription,
         dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent > 0) {
         status = true;
+        BACNET_TRACE(COV_SEND,
+            ((uint32_t)cov_data.monitoredObjectIdentifier.type << 22) |
+                cov_data.monitoredObjectIdentifier.instance,
+            cov_data.subscriberProcessIdentifier);
 #if PRINT_ENABLED
         fprintf(stderr, "COVnotification: Sent!\n");
 #endif
@@ -493,215 +973,1201 @@ COV_FAILED:
     return status;
 }
 
-static void cov_lifetime_expiration_handler(
-    unsigned index, uint32_t elapsed_seconds, uint32_t lifetime_seconds)
+#if BACNET_COV_BROADCAST_ENABLED
+/**
+ * Determines if a subscription is notified with the same broadcast as
+ * another: both are unconfirmed subscriptions to the whole object, with
+ * the same process identifier, from subscribers on the same network
+ *
+ * @param  cov_subscription - subscription that starts the group
+ * @param  member - subscription that may be notified with it
+ *
+ * @return true if the member is notified with the same broadcast
+ */
+static bool cov_broadcast_member(
+    const BACNET_COV_SUBSCRIPTION *cov_subscription,
+    const BACNET_COV_SUBSCRIPTION *member)
 {
-    if (index < MAX_COV_SUBCRIPTIONS) {
-        /* handle lifetime expiration */
-        if (lifetime_seconds >= elapsed_seconds) {
-            COV_Subscriptions[index].lifetime -= elapsed_seconds;
-#if 0
-            fprintf(stderr, "COVtimer: subscription[%d].lifetime=%lu\n", index,
-                (unsigned long) COV_Subscriptions[index].lifetime);
-#endif
-        } else {
-            COV_Subscriptions[index].lifetime = 0;
-        }
-        if (COV_Subscriptions[index].lifetime == 0) {
-            /* expire the subscription */
-#if PRINT_ENABLED
-            fprintf(stderr, "COVtimer: PID=%u ",
-                COV_Subscriptions[index].subscriberProcessIdentifier);
-            fprintf(stderr, "%s %u ",
-                bactext_object_type_name(
-                    COV_Subscriptions[index].monitoredObjectIdentifier.type),
-                COV_Subscriptions[index].monitoredObjectIdentifier.instance);
-            fprintf(stderr, "time remaining=%u seconds ",
-                COV_Subscriptions[index].lifetime);
-            fprintf(stderr, "\n");
-#endif
-            /* initialize with invalid COV address */
-            COV_Subscriptions[index].flag.valid = false;
-            COV_Subscriptions[index].dest_index = MAX_COV_ADDRESSES;
-            cov_address_remove_unused();
-            if (COV_Subscriptions[index].flag.issueConfirmedNotifications) {
-                if (COV_Subscriptions[index].invokeID) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
-                }
+    const BACNET_ADDRESS *dest;
+    const BACNET_ADDRESS *member_dest;
+
+    if (member->flag.issueConfirmedNotifications || member->local_callback ||
+        member->cov_property) {
+        return false;
+    }
+    if (cov_subscription->subscriberProcessIdentifier !=
+        member->subscriberProcessIdentifier) {
+        return false;
+    }
+    dest = cov_address_get(cov_subscription->dest_index);
+    member_dest = cov_address_get(member->dest_index);
+    if (!dest || !member_dest || (dest->net != member_dest->net)) {
+        return false;
+    }
+    if (dest->net == 0) {
+        return true;
+    }
+    /* a remote network is reached through the same router */
+    return (dest->mac_len == member_dest->mac_len) &&
+        (memcmp(dest->mac, member_dest->mac, dest->mac_len) == 0);
+}
+
+/**
+ * Sends one unconfirmed notification as a broadcast on the network of
+ * a subscriber, when at least BACNET_COV_BROADCAST_MIN of the requested
+ * subscriptions of the object are notified with it.  The subscribers
+ * filter the broadcast by their process identifier.
+ *
+ * @param  cov_subscription - the next subscription to notify
+ * @param  value_list - encoded listOfValues of the monitored object
+ * @param  value_list_len - number of bytes in the encoded listOfValues
+ *
+ * @return true if the broadcast was sent to the group.  Otherwise, each
+ *  subscription of the group is sent its own notification.
+ */
+static bool cov_broadcast_send(BACNET_COV_SUBSCRIPTION *cov_subscription,
+    const uint8_t *value_list,
+    size_t value_list_len)
+{
+    BACNET_COV_SUBSCRIPTION *member = NULL;
+    const BACNET_ADDRESS *cov_dest = NULL;
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS my_address;
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_COV_DATA cov_data;
+    uint32_t time_remaining = 0;
+    unsigned count = 0;
+    int pdu_len = 0;
+    int len = 0;
+
+    if (!cov_broadcast_member(cov_subscription, cov_subscription)) {
+        return false;
+    }
+    for (member = cov_subscription; member; member = member->next) {
+        if (member->flag.send_requested &&
+            cov_broadcast_member(cov_subscription, member)) {
+            count++;
+            /* the shortest definite lifetime, so that none expires
+               before its subscriber renews it */
+            if (member->lifetime &&
+                (!time_remaining || (member->lifetime < time_remaining))) {
+                time_remaining = member->lifetime;
             }
         }
     }
+    if ((count < BACNET_COV_BROADCAST_MIN) || !dcc_communication_enabled()) {
+        return false;
+    }
+    cov_dest = cov_address_get(cov_subscription->dest_index);
+    if (cov_dest->net) {
+        /* remote broadcast through the router of the subscribers */
+        dest = *cov_dest;
+        dest.len = 0;
+    } else {
+        /* local broadcast, which is a multicast on BACnet/IPv6 */
+        datalink_get_broadcast_address(&dest);
+        dest.net = 0;
+    }
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], &dest, &my_address, &npdu_data);
+    cov_data.subscriberProcessIdentifier =
+        cov_subscription->subscriberProcessIdentifier;
+    cov_data.initiatingDeviceIdentifier = Device_Object_Instance_Number();
+    cov_data.monitoredObjectIdentifier =
+        cov_subscription->monitoredObjectIdentifier;
+    cov_data.timeRemaining = time_remaining;
+    cov_data.listOfValues = NULL;
+    len = ucov_notify_values_encode_apdu(&Handler_Transmit_Buffer[pdu_len],
+        sizeof(Handler_Transmit_Buffer) - pdu_len, &cov_data, value_list,
+        value_list_len);
+    if (len <= 0) {
+        return false;
+    }
+    pdu_len += len;
+    if (datalink_send_pdu(
+            &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len) <= 0) {
+        return false;
+    }
+    BACNET_TRACE(COV_SEND,
+        ((uint32_t)cov_subscription->monitoredObjectIdentifier.type << 22) |
+            cov_subscription->monitoredObjectIdentifier.instance,
+        cov_subscription->subscriberProcessIdentifier);
+    for (member = cov_subscription; member; member = member->next) {
+        if (member->flag.send_requested &&
+            cov_broadcast_member(cov_subscription, member)) {
+            member->flag.send_requested = false;
+        }
+    }
+
+    return true;
 }
+#endif
 
-/** Handler to check the list of subscribed objects for any that have changed
- *  and so need to have notifications sent.
- * @ingroup DSCOV
- * This handler will be invoked by the main program every second or so.
- * This example only handles Binary Inputs, but can be easily extended to
- * support other types.
- * For each subscribed object,
- *  - See if the subscription has timed out
- *    - Remove it if it has timed out.
- *  - See if the subscribed object instance has changed
- *    (eg, check with Binary_Input_Change_Of_Value() )
- *  - If changed,
- *    - Clear the COV (eg, Binary_Input_Change_Of_Value_Clear() )
- *    - Send the notice with cov_send_request()
- *      - Will be confirmed or unconfirmed, as per the subscription.
+#if BACNET_COV_NOTIFICATION_MULTIPLE_ENABLED
+/**
+ * Determines if a subscription is notified with the same
+ * COVNotificationMultiple as another: both are requested subscriptions
+ * to the whole object, from the same subscriber with the same process
+ * identifier, with the same kind of notifications
  *
- * @note worst case tasking: MS/TP with the ability to send only
- *        one notification per task cycle.
+ * @param  cov_subscription - subscription that starts the group
+ * @param  member - subscription of another monitored object
  *
- * @param elapsed_seconds [in] How many seconds have elapsed since last called.
+ * @return true if the member is notified with the same notification
  */
-void handler_cov_timer_seconds(uint32_t elapsed_seconds)
+static bool cov_multiple_member(
+    const BACNET_COV_SUBSCRIPTION *cov_subscription,
+    const BACNET_COV_SUBSCRIPTION *member)
 {
-    unsigned index = 0;
-    uint32_t lifetime_seconds = 0;
+    if (!member->flag.send_requested || member->local_callback ||
+        member->cov_property) {
+        return false;
+    }
+    if (member->flag.issueConfirmedNotifications !=
+        cov_subscription->flag.issueConfirmedNotifications) {
+        return false;
+    }
+    if (member->flag.issueConfirmedNotifications && member->invokeID) {
+        /* already sending */
+        return false;
+    }
 
-    if (elapsed_seconds) {
-        /* handle the subscription timeouts */
-        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-            if (COV_Subscriptions[index].flag.valid) {
-                lifetime_seconds = COV_Subscriptions[index].lifetime;
-                if (lifetime_seconds) {
-                    /* only expire COV with definite lifetimes */
-                    cov_lifetime_expiration_handler(
-                        index, elapsed_seconds, lifetime_seconds);
-                }
+    return (member->dest_index == cov_subscription->dest_index) &&
+        (member->subscriberProcessIdentifier ==
+            cov_subscription->subscriberProcessIdentifier);
+}
+
+/**
+ * Finds the subscription of a monitored object that is notified with
+ * the same COVNotificationMultiple as another
+ *
+ * @param  cov_subscription - subscription that starts the group
+ * @param  index - index of another monitored object in the list
+ *
+ * @return the subscription of the object, or NULL if none
+ */
+static BACNET_COV_SUBSCRIPTION *
+cov_multiple_member_find(const BACNET_COV_SUBSCRIPTION *cov_subscription,
+    int index)
+{
+    BACNET_COV_OBJECT *cov_object = NULL;
+    BACNET_COV_SUBSCRIPTION *member = NULL;
+
+    cov_object = Keylist_Data_Index(COV_Object_List, index);
+    if (cov_object) {
+        for (member = cov_object->subscriptions; member;
+             member = member->next) {
+            if (cov_multiple_member(cov_subscription, member)) {
+                break;
             }
         }
     }
+
+    return member;
 }
 
-bool handler_cov_fsm(void)
-{
-    static int index = 0;
-    BACNET_OBJECT_TYPE object_type = MAX_BACNET_OBJECT_TYPE;
-    uint32_t object_instance = 0;
-    bool status = false;
-    bool send = false;
+/**
+ * Encodes the notification of one monitored object of a
+ * COVNotificationMultiple into the transmit buffer, leaving room for
+ * the end of the list of notifications
+ *
+ * @param  object_id - monitored object
+ * @param  value_list - encoded listOfValues of the monitored object
+ * @param  value_list_len - number of bytes in the encoded listOfValues
+ * @param  pdu_len - number of bytes already in the transmit buffer
+ * @param  pdu_size - number of bytes of the transmit buffer to use
+ *
+ * @return number of bytes encoded, or zero if the object did not fit
+ */
+static int cov_multiple_values_encode(const BACNET_OBJECT_ID *object_id,
+    const uint8_t *value_list,
+    size_t value_list_len,
+    int pdu_len,
+    int pdu_size)
+{
+    int len = 0;
+
+    len = cov_notify_multiple_object_encode(
+        NULL, object_id, value_list, value_list_len);
+    if ((len <= 0) ||
+        ((pdu_len + len + cov_notify_multiple_end_encode(NULL)) > pdu_size)) {
+        return 0;
+    }
+
+    return cov_notify_multiple_object_encode(
+        &Handler_Transmit_Buffer[pdu_len], object_id, value_list,
+        value_list_len);
+}
+
+/**
+ * Encodes the listOfValues of another monitored object of a
+ * COVNotificationMultiple into the transmit buffer
+ *
+ * @param  index - index of the monitored object in the list
+ * @param  pdu_len - number of bytes already in the transmit buffer
+ * @param  pdu_size - number of bytes of the transmit buffer to use
+ *
+ * @return number of bytes encoded, or zero if the object did not fit
+ */
+static int cov_multiple_object_encode(int index, int pdu_len, int pdu_size)
+{
+    BACNET_COV_OBJECT *cov_object = NULL;
     BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES];
-    /* states for transmitting */
-    static enum {
-        COV_STATE_IDLE = 0,
-        COV_STATE_MARK,
-        COV_STATE_CLEAR,
-        COV_STATE_FREE,
-        COV_STATE_SEND
-    } cov_task_state = COV_STATE_IDLE;
-
-    switch (cov_task_state) {
-        case COV_STATE_IDLE:
-            index = 0;
-            cov_task_state = COV_STATE_MARK;
+    int len = 0;
+
+    cov_object = Keylist_Data_Index(COV_Object_List, index);
+    if (!cov_object) {
+        return 0;
+    }
+    bacapp_property_value_list_init(&value_list[0], MAX_COV_PROPERTIES);
+    if (!Device_Encode_Value_List(
+            (BACNET_OBJECT_TYPE)cov_object->objectIdentifier.type,
+            cov_object->objectIdentifier.instance, &value_list[0])) {
+        return 0;
+    }
+    len = cov_notify_value_list_encode(NULL, &value_list[0]);
+    if ((len <= 0) || (len > (int)sizeof(COV_Multiple_Value_Buffer))) {
+        return 0;
+    }
+    len = cov_notify_value_list_encode(
+        &COV_Multiple_Value_Buffer[0], &value_list[0]);
+
+    return cov_multiple_values_encode(&cov_object->objectIdentifier,
+        &COV_Multiple_Value_Buffer[0], (size_t)len, pdu_len, pdu_size);
+}
+
+/**
+ * Sends one COVNotificationMultiple to a subscriber with the values of
+ * the monitored objects that changed in this task cycle, when the same
+ * subscriber and process identifier also has a requested notification
+ * of one or more of the objects that are sent after this one.  The
+ * objects that do not fit are sent with their own notification.
+ *
+ * @param  cov_subscription - the next subscription to notify
+ * @param  value_list - encoded listOfValues of the monitored object
+ * @param  value_list_len - number of bytes in the encoded listOfValues
+ *
+ * @return true if the notification was sent to the group.  Otherwise,
+ *  the subscription is sent its own notification.
+ */
+static bool cov_multiple_send(BACNET_COV_SUBSCRIPTION *cov_subscription,
+    const uint8_t *value_list,
+    size_t value_list_len)
+{
+    BACNET_COV_SUBSCRIPTION *member = NULL;
+    BACNET_ADDRESS *dest = NULL;
+    BACNET_ADDRESS my_address;
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_COV_DATA cov_data;
+    bool confirmed = cov_subscription->flag.issueConfirmedNotifications;
+    uint32_t time_remaining = cov_subscription->lifetime;
+    uint8_t invoke_id = 0;
+    int index = 0, last_index = 0, count = 0;
+    int pdu_len = 0, pdu_size = 0, len = 0;
+
+    if (cov_subscription->local_callback || cov_subscription->cov_property) {
+        return false;
+    }
+    count = Keylist_Count(COV_Object_List);
+    for (index = COV_Task_Index + 1; index < count; index++) {
+        member = cov_multiple_member_find(cov_subscription, index);
+        if (member) {
+            last_index = index;
+            /* the shortest definite lifetime, so that none expires
+               before its subscriber renews it */
+            if (member->lifetime &&
+                (!time_remaining || (member->lifetime < time_remaining))) {
+                time_remaining = member->lifetime;
+            }
+        }
+    }
+    if (!last_index || !dcc_communication_enabled()) {
+        return false;
+    }
+    dest = cov_address_get(cov_subscription->dest_index);
+    if (!dest) {
+        return false;
+    }
+    datalink_get_my_address(&my_address);
+    pdu_len = cov_address_npdu_encode(
+        cov_subscription->dest_index, confirmed, &my_address, &npdu_data);
+    if (pdu_len <= 0) {
+        return false;
+    }
+    pdu_size = (int)sizeof(Handler_Transmit_Buffer);
+    if ((pdu_size - pdu_len) > MAX_APDU) {
+        pdu_size = pdu_len + MAX_APDU;
+    }
+    if (confirmed) {
+        invoke_id = tsm_next_free_invokeID();
+        if (!invoke_id) {
+            return false;
+        }
+    }
+    cov_data.subscriberProcessIdentifier =
+        cov_subscription->subscriberProcessIdentifier;
+    cov_data.initiatingDeviceIdentifier = Device_Object_Instance_Number();
+    cov_data.monitoredObjectIdentifier =
+        cov_subscription->monitoredObjectIdentifier;
+    cov_data.timeRemaining = time_remaining;
+    cov_data.listOfValues = NULL;
+    len = cov_notify_multiple_header_encode(
+        NULL, confirmed, invoke_id, &cov_data);
+    if ((pdu_len + len) > pdu_size) {
+        goto COV_MULTIPLE_FAILED;
+    }
+    pdu_len += cov_notify_multiple_header_encode(
+        &Handler_Transmit_Buffer[pdu_len], confirmed, invoke_id, &cov_data);
+    len = cov_multiple_values_encode(
+        &cov_subscription->monitoredObjectIdentifier, value_list,
+        value_list_len, pdu_len, pdu_size);
+    if (len <= 0) {
+        goto COV_MULTIPLE_FAILED;
+    }
+    pdu_len += len;
+    count = last_index + 1;
+    last_index = 0;
+    for (index = COV_Task_Index + 1; index < count; index++) {
+        if (!cov_multiple_member_find(cov_subscription, index)) {
+            continue;
+        }
+        len = cov_multiple_object_encode(index, pdu_len, pdu_size);
+        if (len <= 0) {
             break;
-        case COV_STATE_MARK:
-            /* mark any subscriptions where the value has changed */
-            if (COV_Subscriptions[index].flag.valid) {
-                object_type = (BACNET_OBJECT_TYPE)COV_Subscriptions[index]
-                                  .monitoredObjectIdentifier.type;
-                object_instance =
-                    COV_Subscriptions[index].monitoredObjectIdentifier.instance;
-                status = Device_COV(object_type, object_instance);
-                if (status) {
-                    COV_Subscriptions[index].flag.send_requested = true;
+        }
+        pdu_len += len;
+        last_index = index;
+    }
+    if (!last_index) {
+        /* none of the other objects fit */
+        goto COV_MULTIPLE_FAILED;
+    }
+    pdu_len +=
+        cov_notify_multiple_end_encode(&Handler_Transmit_Buffer[pdu_len]);
+    if (confirmed) {
+        tsm_set_confirmed_unsegmented_transaction(invoke_id, dest, &npdu_data,
+            &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
+    }
+    if (datalink_send_pdu(
+            dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len) <= 0) {
+        goto COV_MULTIPLE_FAILED;
+    }
+    BACNET_TRACE(COV_SEND,
+        ((uint32_t)cov_subscription->monitoredObjectIdentifier.type << 22) |
+            cov_subscription->monitoredObjectIdentifier.instance,
+        cov_subscription->subscriberProcessIdentifier);
+    for (index = COV_Task_Index + 1; index <= last_index; index++) {
+        member = cov_multiple_member_find(cov_subscription, index);
+        if (member) {
+            member->flag.send_requested = false;
+            member->invokeID = invoke_id;
+        }
+    }
+    cov_subscription->flag.send_requested = false;
+    cov_subscription->invokeID = invoke_id;
+#if PRINT_ENABLED
+    fprintf(stderr, "COVnotification: Sent multiple!\n");
+#endif
+
+    return true;
+
+COV_MULTIPLE_FAILED:
+    if (invoke_id) {
+        tsm_free_invoke_id(invoke_id);
+    }
+
+    return false;
+}
+#endif
+
+/**
+ * Handles the lifetime of a subscription, and removes it when expired
+ *
+ * @param  cov_object - monitored object of the subscription
+ * @param  cov_subscription - subscription with a definite lifetime
+ * @param  elapsed_seconds - how many seconds have elapsed
+ *
+ * @return true if the monitored object was removed from the list
+ */
+#if BACNET_SNAPSHOT_ENABLED
+/**
+ * @brief Remove an expired subscription from the snapshot
+ * @param cov_subscription - the expired subscription
+ */
+static void cov_snapshot_expire(BACNET_COV_SUBSCRIPTION *cov_subscription)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_ADDRESS *dest;
+
+    dest = cov_address_get(cov_subscription->dest_index);
+    if (!dest || cov_subscription->local_callback) {
+        return;
+    }
+    cov_data.subscriberProcessIdentifier =
+        cov_subscription->subscriberProcessIdentifier;
+    cov_data.monitoredObjectIdentifier =
+        cov_subscription->monitoredObjectIdentifier;
+    cov_data.cancellationRequest = true;
+    if (cov_subscription->cov_property) {
+        cov_data.covSubscribeToProperty = true;
+        cov_data.monitoredProperty.propertyIdentifier =
+            cov_subscription->cov_property->propertyIdentifier;
+        cov_data.monitoredProperty.propertyArrayIndex =
+            cov_subscription->cov_property->propertyArrayIndex;
+    }
+    snapshot_subscribe_cov(dest, &cov_data);
+}
+#endif
+
+static bool cov_lifetime_expiration_handler(BACNET_COV_OBJECT *cov_object,
+    BACNET_COV_SUBSCRIPTION *cov_subscription,
+    uint32_t elapsed_seconds)
+{
+    /* handle lifetime expiration */
+    if (cov_subscription->lifetime >= elapsed_seconds) {
+        cov_subscription->lifetime -= elapsed_seconds;
+#if 0
+        fprintf(stderr, "COVtimer: subscription.lifetime=%lu\n",
+            (unsigned long) cov_subscription->lifetime);
+#endif
+    } else {
+        cov_subscription->lifetime = 0;
+    }
+    if (cov_subscription->lifetime == 0) {
+        /* expire the subscription */
 #if PRINT_ENABLED
-                    fprintf(stderr, "COVtask: Marking...\n");
+        fprintf(stderr, "COVtimer: PID=%u ",
+            cov_subscription->subscriberProcessIdentifier);
+        fprintf(stderr, "%s %u ",
+            bactext_object_type_name(
+                cov_subscription->monitoredObjectIdentifier.type),
+            cov_subscription->monitoredObjectIdentifier.instance);
+        fprintf(stderr, "time remaining=%u seconds ",
+            cov_subscription->lifetime);
+        fprintf(stderr, "\n");
+#endif
+#if BACNET_SNAPSHOT_ENABLED
+        cov_snapshot_expire(cov_subscription);
 #endif
+        return cov_subscription_remove(cov_object, cov_subscription);
+    }
+
+    return false;
+}
+
+/** Handler to check the list of subscribed objects for any that have changed
+ *  and so need to have notifications sent.
+ * @ingroup DSCOV
+ * This handler will be invoked by the main program every second or so.
+ * This example only handles Binary Inputs, but can be easily extended to
+ * support other types.
+ * For each subscribed object,
+ *  - See if the subscription has timed out
+ *    - Remove it if it has timed out.
+ *  - See if the subscribed object instance has changed
+ *    (eg, check with Binary_Input_Change_Of_Value() )
+ *  - If changed,
+ *    - Clear the COV (eg, Binary_Input_Change_Of_Value_Clear() )
+ *    - Send the notice with cov_send_request()
+ *      - Will be confirmed or unconfirmed, as per the subscription.
+ *
+ * @note worst case tasking: MS/TP with the ability to send only
+ *        one notification per task cycle.
+ *
+ * @param elapsed_seconds [in] How many seconds have elapsed since last called.
+ */
+void handler_cov_timer_seconds(uint32_t elapsed_seconds)
+{
+    int index = 0;
+    bool removed = false;
+    BACNET_COV_OBJECT *cov_object = NULL;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+    BACNET_COV_SUBSCRIPTION *next_subscription = NULL;
+
+    if (elapsed_seconds) {
+        /* handle the subscription timeouts */
+        while (index < Keylist_Count(COV_Object_List)) {
+            cov_object = Keylist_Data_Index(COV_Object_List, index);
+            removed = false;
+            cov_subscription = cov_object ? cov_object->subscriptions : NULL;
+            while (cov_subscription && !removed) {
+                next_subscription = cov_subscription->next;
+                if (cov_subscription->lifetime) {
+                    /* only expire COV with definite lifetimes */
+                    removed = cov_lifetime_expiration_handler(
+                        cov_object, cov_subscription, elapsed_seconds);
                 }
+                cov_subscription = next_subscription;
+            }
+            if (!removed) {
+                index++;
+            }
+        }
+    }
+}
+
+/**
+ * Reads a property of an object of this device
+ *
+ * @param  object_type - type of the object
+ * @param  object_instance - instance of the object
+ * @param  property - the property
+ * @param  array_index - array index of the property
+ * @param  buffer - buffer for the encoded value
+ * @param  buffer_size - size of the buffer
+ *
+ * @return number of bytes of the encoded value, or a negative value
+ *  if the property could not be read
+ */
+static int cov_property_read(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *buffer,
+    unsigned buffer_size)
+{
+    BACNET_READ_PROPERTY_DATA rpdata;
+
+    rpdata.object_type = object_type;
+    rpdata.object_instance = object_instance;
+    rpdata.object_property = property;
+    rpdata.array_index = array_index;
+    rpdata.application_data = buffer;
+    rpdata.application_data_len = buffer_size;
+    rpdata.error_class = ERROR_CLASS_PROPERTY;
+    rpdata.error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+
+    return Device_Read_Property(&rpdata);
+}
+
+/**
+ * Hashes an encoded value with FNV-1a, to notice when it changes
+ *
+ * @param  buffer - the encoded value
+ * @param  len - number of bytes of the encoded value
+ *
+ * @return hash of the value
+ */
+static uint32_t cov_value_hash(const uint8_t *buffer, int len)
+{
+    uint32_t hash = 2166136261UL;
+    int i;
+
+    for (i = 0; i < len; i++) {
+        hash ^= buffer[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+/**
+ * Gets a numeric value, which changes by a COV increment
+ *
+ * @param  buffer - the encoded value
+ * @param  len - number of bytes of the encoded value
+ * @param  number [out] the value
+ *
+ * @return true if the value is a number
+ */
+static bool cov_value_number(uint8_t *buffer, int len, float *number)
+{
+    BACNET_APPLICATION_DATA_VALUE value;
+
+    if ((len <= 0) ||
+        (bacapp_decode_application_data(buffer, (uint32_t)len, &value) <= 0)) {
+        return false;
+    }
+    switch (value.tag) {
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            *number = value.type.Real;
+            return true;
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            *number = (float)value.type.Double;
+            return true;
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            *number = (float)value.type.Unsigned_Int;
+            return true;
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            *number = (float)value.type.Signed_Int;
+            return true;
+#endif
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * Marks the SubscribeCOVProperty subscriptions of a monitored property
+ * when its value has changed by the COV increment of each subscription,
+ * or by the COV_Increment of the object without one, or when its
+ * Status_Flags have changed.  The property is read once for all of
+ * its subscriptions.  When the object has reported its change of value,
+ * the Present_Value has changed by the COV_Increment of the object.
+ *
+ * @param  cov_object - monitored object
+ * @param  cov_property - monitored property of the object
+ * @param  reported - true if the object has reported its change of value
+ */
+static void cov_property_mark(BACNET_COV_OBJECT *cov_object,
+    BACNET_COV_PROPERTY *cov_property,
+    bool reported)
+{
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+    uint8_t status_flags[8];
+    uint32_t value_hash, status_hash = 0;
+    float number = 0.0f, increment = 0.0f, object_increment = 0.0f;
+    float difference;
+    bool numeric, changed;
+    int len;
+
+    object_type = (BACNET_OBJECT_TYPE)cov_object->objectIdentifier.type;
+    object_instance = cov_object->objectIdentifier.instance;
+    len = cov_property_read(object_type, object_instance,
+        cov_property->propertyIdentifier, cov_property->propertyArrayIndex,
+        &COV_Value_List_Buffer[0], sizeof(COV_Value_List_Buffer));
+    if (len < 0) {
+        return;
+    }
+    value_hash = cov_value_hash(&COV_Value_List_Buffer[0], len);
+    numeric = cov_value_number(&COV_Value_List_Buffer[0], len, &number);
+    if (numeric && (cov_property->propertyIdentifier == PROP_PRESENT_VALUE)) {
+        len = cov_property_read(object_type, object_instance,
+            PROP_COV_INCREMENT, BACNET_ARRAY_ALL, &COV_Value_List_Buffer[0],
+            sizeof(COV_Value_List_Buffer));
+        if (!cov_value_number(&COV_Value_List_Buffer[0], len,
+                &object_increment)) {
+            object_increment = 0.0f;
+        }
+    }
+    len = cov_property_read(object_type, object_instance, PROP_STATUS_FLAGS,
+        BACNET_ARRAY_ALL, &status_flags[0], sizeof(status_flags));
+    if (len > 0) {
+        status_hash = cov_value_hash(&status_flags[0], len);
+    }
+    for (cov_subscription = cov_object->subscriptions; cov_subscription;
+         cov_subscription = cov_subscription->next) {
+        if (cov_subscription->cov_property != cov_property) {
+            continue;
+        }
+        changed = !cov_subscription->flag.cov_reported ||
+            (cov_subscription->cov_status_hash != status_hash);
+        if (!changed && reported &&
+            !cov_subscription->flag.covIncrementPresent &&
+            (cov_property->propertyIdentifier == PROP_PRESENT_VALUE)) {
+            changed = true;
+        } else if (!changed && numeric) {
+            increment = object_increment;
+            if (cov_subscription->flag.covIncrementPresent) {
+                increment = cov_subscription->covIncrement;
+            }
+            difference = number - cov_subscription->cov_value;
+            if (difference < 0.0f) {
+                difference = -difference;
+            }
+            if (increment > 0.0f) {
+                changed = (difference >= increment);
+            } else {
+                changed = (difference > 0.0f);
+            }
+        } else if (!changed) {
+            changed = (cov_subscription->cov_value_hash != value_hash);
+        }
+        if (changed) {
+            cov_subscription->flag.send_requested = true;
+            cov_subscription->flag.cov_reported = true;
+            cov_subscription->cov_value = number;
+            cov_subscription->cov_value_hash = value_hash;
+            cov_subscription->cov_status_hash = status_hash;
+        }
+    }
+}
+
+/**
+ * Encodes the listOfValues of a monitored property, which is the value
+ * of the property and the Status_Flags of the object, once for all of
+ * the notifications of the property.
+ *
+ * @param  object_type - type of the monitored object
+ * @param  object_instance - instance of the monitored object
+ * @param  cov_property - monitored property of the object
+ *
+ * @return number of bytes encoded in COV_Property_Value_Buffer, or 0
+ *  if the property could not be read or encoded
+ */
+static int cov_property_value_list_encode(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    const BACNET_COV_PROPERTY *cov_property)
+{
+    BACNET_PROPERTY_VALUE value_list[2];
+    int len = 0;
+
+    bacapp_property_value_list_init(&value_list[0], 2);
+    len = cov_property_read(object_type, object_instance,
+        cov_property->propertyIdentifier, cov_property->propertyArrayIndex,
+        &COV_Property_Value_Buffer[0], sizeof(COV_Property_Value_Buffer));
+    if ((len <= 0) ||
+        (bacapp_decode_application_data(&COV_Property_Value_Buffer[0],
+             (uint32_t)len, &value_list[0].value) <= 0)) {
+        return 0;
+    }
+    value_list[0].propertyIdentifier = cov_property->propertyIdentifier;
+    value_list[0].propertyArrayIndex = cov_property->propertyArrayIndex;
+    len = 0;
+    if (cov_property->propertyIdentifier != PROP_STATUS_FLAGS) {
+        len = cov_property_read(object_type, object_instance,
+            PROP_STATUS_FLAGS, BACNET_ARRAY_ALL, &COV_Property_Value_Buffer[0],
+            sizeof(COV_Property_Value_Buffer));
+    }
+    if ((len > 0) &&
+        (bacapp_decode_application_data(&COV_Property_Value_Buffer[0],
+             (uint32_t)len, &value_list[1].value) > 0)) {
+        value_list[1].propertyIdentifier = PROP_STATUS_FLAGS;
+    } else {
+        value_list[0].next = NULL;
+    }
+    len = cov_notify_value_list_encode(NULL, &value_list[0]);
+    if ((len <= 0) || (len > (int)sizeof(COV_Property_Value_Buffer))) {
+        return 0;
+    }
+
+    return cov_notify_value_list_encode(
+        &COV_Property_Value_Buffer[0], &value_list[0]);
+}
+
+/**
+ * Determines if a monitored property is affected by the changes of
+ * its object.  The Status_Flags are part of each notification of a
+ * monitored property, and the other properties are only known to have
+ * changed when the object is polled.
+ *
+ * @param  cov_property - monitored property of the object
+ * @param  changes - COV_CHANGE_ bits of the object
+ *
+ * @return true if the monitored property is compared
+ */
+static bool
+cov_property_changed(const BACNET_COV_PROPERTY *cov_property, uint8_t changes)
+{
+    if (changes == COV_CHANGE_ALL) {
+        return true;
+    }
+    if (cov_property->propertyArrayIndex != BACNET_ARRAY_ALL) {
+        return false;
+    }
+    if (changes & COV_CHANGE_STATUS_FLAGS) {
+        return (cov_property->propertyIdentifier == PROP_PRESENT_VALUE) ||
+            (cov_property->propertyIdentifier == PROP_STATUS_FLAGS);
+    }
+    if (changes & COV_CHANGE_PRESENT_VALUE) {
+        return (cov_property->propertyIdentifier == PROP_PRESENT_VALUE);
+    }
+
+    return false;
+}
+
+/**
+ * Marks the subscriptions of a monitored object when its value has changed,
+ * and clears the changed value flag of the object when any of its
+ * subscriptions need a notification.  The SubscribeCOVProperty
+ * subscriptions are marked by their monitored properties.  Only the
+ * checks of the changes that were recorded by the object are done.
+ *
+ * @param  cov_object - monitored object
+ * @param  changes - COV_CHANGE_ bits that the object reported, or
+ *  COV_CHANGE_ALL when the object is polled
+ */
+static void cov_object_mark(BACNET_COV_OBJECT *cov_object, uint8_t changes)
+{
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+    BACNET_COV_PROPERTY *cov_property = NULL;
+    bool send_requested = false;
+    bool reported;
+
+    cov_object->poll_requested = false;
+    object_type = (BACNET_OBJECT_TYPE)cov_object->objectIdentifier.type;
+    object_instance = cov_object->objectIdentifier.instance;
+    reported = (changes != COV_CHANGE_ALL) && (changes & COV_CHANGE_VALUE);
+    for (cov_property = cov_object->properties; cov_property;
+         cov_property = cov_property->next) {
+        if (cov_property_changed(cov_property, changes)) {
+            cov_property_mark(cov_object, cov_property, reported);
+        }
+    }
+    if ((changes & COV_CHANGE_VALUE) &&
+        Device_COV(object_type, object_instance)) {
+#if PRINT_ENABLED
+        fprintf(stderr, "COVtask: Marking...\n");
+#endif
+        for (cov_subscription = cov_object->subscriptions; cov_subscription;
+             cov_subscription = cov_subscription->next) {
+            if (!cov_subscription->cov_property) {
+                cov_subscription->flag.send_requested = true;
+            }
+        }
+        send_requested = true;
+    } else {
+        for (cov_subscription = cov_object->subscriptions; cov_subscription;
+             cov_subscription = cov_subscription->next) {
+            if (!cov_subscription->cov_property &&
+                cov_subscription->flag.send_requested) {
+                send_requested = true;
+                break;
+            }
+        }
+    }
+    if (send_requested) {
+        Device_COV_Clear(object_type, object_instance);
+    }
+}
+
+/**
+ * Determines if the task polls a monitored object for a changed value
+ *
+ * @param  cov_object - monitored object
+ *
+ * @return true if the object is polled
+ */
+static bool cov_object_polled(BACNET_COV_OBJECT *cov_object)
+{
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+    unsigned object_type = cov_object->objectIdentifier.type;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+
+    if (COV_Change_Poll_All || cov_object->poll_requested) {
+        return true;
+    }
+    for (cov_subscription = cov_object->subscriptions; cov_subscription;
+         cov_subscription = cov_subscription->next) {
+        if (!cov_subscription->cov_property) {
+            continue;
+        }
+        if (cov_subscription->flag.covIncrementPresent ||
+            !cov_property_changed(
+                cov_subscription->cov_property, COV_CHANGE_STATUS_FLAGS)) {
+            /* the monitored property is compared with its own
+               increment, or is another property, and its changes
+               are not reported by the object */
+            return true;
+        }
+    }
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        if (COV_Change_Types[object_type / 8] & (1 << (object_type % 8))) {
+            /* the object reports its changes into the queue */
+            return false;
+        }
+    }
+#else
+    (void)cov_object;
+#endif
+
+    return true;
+}
+
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+/**
+ * @brief Puts a changed object into the queue for the COV task.
+ *  Objects that report their own changes call this when their change
+ *  of value flag is set, with the changes that were detected when the
+ *  value was written, so that the task checks only the changed objects,
+ *  and only for those changes.  Once an object type has reported a
+ *  change of value, the objects of that type are no longer polled by
+ *  the task.
+ * @note The queue is lock-free for one caller and the COV task.
+ *  When the queue is full, the task polls every object for one cycle.
+ * @param object_type - type of the changed object
+ * @param object_instance - instance of the changed object
+ * @param changes - COV_CHANGE_ bits of the changed object
+ */
+void handler_cov_object_changes(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance, uint8_t changes)
+{
+    BACNET_COV_CHANGE change;
+
+    if ((object_type >= MAX_BACNET_OBJECT_TYPE) || !changes) {
+        return;
+    }
+    if (changes & COV_CHANGE_VALUE) {
+        COV_Change_Types[object_type / 8] |= (1 << (object_type % 8));
+    }
+    change.key = KEY_ENCODE(object_type, object_instance);
+    change.changes = changes;
+    if (!Ringbuf_Put(&COV_Change_Queue, (uint8_t *)&change)) {
+        COV_Change_Queue_Overflow = true;
+    }
+}
+
+/**
+ * Takes the changed objects from the queue, and marks the subscriptions
+ * of the changed objects that are monitored.
+ */
+static void cov_change_queue_mark(void)
+{
+    BACNET_COV_CHANGE change = { 0 };
+    unsigned count = 0;
+    BACNET_COV_OBJECT *cov_object = NULL;
+
+    COV_Change_Poll_All = false;
+    if (COV_Change_Queue_Overflow) {
+        COV_Change_Queue_Overflow = false;
+        COV_Change_Poll_All = true;
+    }
+    /* limit the work, in case the objects are changing while we work */
+    while ((count < BACNET_COV_CHANGE_QUEUE_SIZE) &&
+        Ringbuf_Pop(&COV_Change_Queue, (uint8_t *)&change)) {
+        cov_object = Keylist_Data(COV_Object_List, change.key);
+        if (cov_object) {
+            cov_object_mark(cov_object, change.changes);
+        }
+        count++;
+    }
+}
+#endif
+
+/**
+ * Confirmed notification house keeping for the subscriptions
+ * of a monitored object.
+ *
+ * @param  cov_object - monitored object
+ */
+static void cov_object_free(BACNET_COV_OBJECT *cov_object)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+
+    for (cov_subscription = cov_object->subscriptions; cov_subscription;
+         cov_subscription = cov_subscription->next) {
+        if ((cov_subscription->flag.issueConfirmedNotifications) &&
+            (cov_subscription->invokeID)) {
+            if (tsm_invoke_id_free(cov_subscription->invokeID)) {
+                cov_subscription->invokeID = 0;
+            } else if (tsm_invoke_id_failed(cov_subscription->invokeID)) {
+                tsm_free_invoke_id(cov_subscription->invokeID);
+                cov_subscription->invokeID = 0;
+            }
+        }
+    }
+}
+
+/**
+ * Sends the requested notifications to the subscriptions of a monitored
+ * object, as one batch.  The listOfValues of the object, and of each
+ * monitored property, is encoded once, and only the subscriber values
+ * are encoded for each notification.
+ *
+ * @param  cov_object - monitored object
+ *
+ * @return false if a notification failed to send.  The notifications that
+ *  were not sent remain requested for the next task cycle.
+ */
+static bool cov_object_send(BACNET_COV_OBJECT *cov_object)
+{
+    BACNET_OBJECT_TYPE object_type = MAX_BACNET_OBJECT_TYPE;
+    uint32_t object_instance = 0;
+    bool status = true;
+    bool send = false;
+    bool listed = false;
+    int len = 0;
+    int property_len = 0;
+    BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES];
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+    const BACNET_COV_PROPERTY *cov_property = NULL;
+
+    object_type = (BACNET_OBJECT_TYPE)cov_object->objectIdentifier.type;
+    object_instance = cov_object->objectIdentifier.instance;
+    while (COV_Task_Subscription) {
+        cov_subscription = COV_Task_Subscription;
+        COV_Task_Subscription = cov_subscription->next;
+        if (!cov_subscription->flag.send_requested) {
+            continue;
+        }
+        send = true;
+        if ((cov_subscription->flag.issueConfirmedNotifications) &&
+            (!cov_subscription->local_callback)) {
+            if (cov_subscription->invokeID != 0) {
+                /* already sending */
+                send = false;
+            }
+            if (!tsm_transaction_available()) {
+                /* no transactions available - can't send now */
+                send = false;
             }
-            index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
-                index = 0;
-                cov_task_state = COV_STATE_CLEAR;
+        }
+        if (!send) {
+            continue;
+        }
+        if (cov_subscription->cov_property) {
+            if (cov_property != cov_subscription->cov_property) {
+                cov_property = cov_subscription->cov_property;
+                property_len = cov_property_value_list_encode(
+                    object_type, object_instance, cov_property);
             }
+            if (property_len <= 0) {
+                /* the property is no longer readable */
+                cov_subscription->flag.send_requested = false;
+                continue;
+            }
+            if (cov_send_request(cov_subscription,
+                    &COV_Property_Value_Buffer[0], property_len)) {
+                cov_subscription->flag.send_requested = false;
+                continue;
+            }
+            status = false;
             break;
-        case COV_STATE_CLEAR:
-            /* clear the COV flag after checking all subscriptions */
-            if ((COV_Subscriptions[index].flag.valid) &&
-                (COV_Subscriptions[index].flag.send_requested)) {
-                object_type = (BACNET_OBJECT_TYPE)COV_Subscriptions[index]
-                                  .monitoredObjectIdentifier.type;
-                object_instance =
-                    COV_Subscriptions[index].monitoredObjectIdentifier.instance;
-                Device_COV_Clear(object_type, object_instance);
-            }
-            index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
-                index = 0;
-                cov_task_state = COV_STATE_FREE;
+        }
+        if (!listed) {
+            /* configure the linked list for the two properties */
+            bacapp_property_value_list_init(
+                &value_list[0], MAX_COV_PROPERTIES);
+            if (!Device_Encode_Value_List(
+                    object_type, object_instance, &value_list[0])) {
+                break;
+            }
+            listed = true;
+        }
+        if (cov_subscription->local_callback) {
+            /* local subscribers get the values without any encoding */
+            cov_subscription->flag.send_requested = false;
+            cov_subscription->local_callback(
+                cov_subscription->subscriberProcessIdentifier, object_type,
+                object_instance, &value_list[0]);
+            continue;
+        }
+        if (len == 0) {
+            len = cov_notify_value_list_encode(NULL, &value_list[0]);
+            if ((len <= 0) || (len > (int)sizeof(COV_Value_List_Buffer))) {
+                len = 0;
+                break;
+            }
+            len = cov_notify_value_list_encode(
+                &COV_Value_List_Buffer[0], &value_list[0]);
+        }
+#if PRINT_ENABLED
+        fprintf(stderr, "COVtask: Sending...\n");
+#endif
+#if BACNET_COV_BROADCAST_ENABLED
+        if (cov_broadcast_send(
+                cov_subscription, &COV_Value_List_Buffer[0], len)) {
+            continue;
+        }
+#endif
+#if BACNET_COV_NOTIFICATION_MULTIPLE_ENABLED
+        if (cov_multiple_send(
+                cov_subscription, &COV_Value_List_Buffer[0], len)) {
+            continue;
+        }
+#endif
+        if (cov_send_request(
+                cov_subscription, &COV_Value_List_Buffer[0], len)) {
+            cov_subscription->flag.send_requested = false;
+        } else {
+            status = false;
+            break;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * Handler to check each monitored object for a changed value, and to
+ * send the notifications to the subscriptions of the changed objects.
+ * Each call does a small step, so that it can be called often from
+ * the main loop.  A changed value of an object only touches the
+ * subscriptions of that object.
+ *
+ * @return true when the task has completed a cycle through the objects
+ */
+bool handler_cov_fsm(void)
+{
+    BACNET_COV_OBJECT *cov_object = NULL;
+
+    switch (COV_Task_State) {
+        case COV_STATE_IDLE:
+            COV_Task_Index = 0;
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+            cov_change_queue_mark();
+#endif
+            COV_Task_State = COV_STATE_MARK;
+            break;
+        case COV_STATE_MARK:
+            /* mark any subscriptions where the value has changed,
+               and clear the COV flag of the object */
+            cov_object = Keylist_Data_Index(COV_Object_List, COV_Task_Index);
+            while (cov_object && !cov_object_polled(cov_object)) {
+                /* skip the objects that report their changes */
+                COV_Task_Index++;
+                cov_object =
+                    Keylist_Data_Index(COV_Object_List, COV_Task_Index);
+            }
+            if (cov_object) {
+                cov_object_mark(cov_object, COV_CHANGE_ALL);
+            }
+            COV_Task_Index++;
+            if (COV_Task_Index >= Keylist_Count(COV_Object_List)) {
+                COV_Task_Index = 0;
+                COV_Task_State = COV_STATE_FREE;
             }
             break;
         case COV_STATE_FREE:
             /* confirmed notification house keeping */
-            if ((COV_Subscriptions[index].flag.valid) &&
-                (COV_Subscriptions[index].flag.issueConfirmedNotifications) &&
-                (COV_Subscriptions[index].invokeID)) {
-                if (tsm_invoke_id_free(COV_Subscriptions[index].invokeID)) {
-                    COV_Subscriptions[index].invokeID = 0;
-                } else if (tsm_invoke_id_failed(
-                               COV_Subscriptions[index].invokeID)) {
-                    tsm_free_invoke_id(COV_Subscriptions[index].invokeID);
-                    COV_Subscriptions[index].invokeID = 0;
-                }
+            cov_object = Keylist_Data_Index(COV_Object_List, COV_Task_Index);
+            if (cov_object) {
+                cov_object_free(cov_object);
             }
-            index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
-                index = 0;
-                cov_task_state = COV_STATE_SEND;
+            COV_Task_Index++;
+            if (COV_Task_Index >= Keylist_Count(COV_Object_List)) {
+                COV_Task_Index = 0;
+                COV_Task_State = COV_STATE_SEND;
+                cov_object = Keylist_Data_Index(COV_Object_List, 0);
+                if (cov_object) {
+                    COV_Task_Subscription = cov_object->subscriptions;
+                } else {
+                    COV_Task_Subscription = NULL;
+                }
             }
             break;
         case COV_STATE_SEND:
-            /* send any COVs that are requested */
-            if ((COV_Subscriptions[index].flag.valid) &&
-                (COV_Subscriptions[index].flag.send_requested)) {
-                send = true;
-                if (COV_Subscriptions[index].flag.issueConfirmedNotifications) {
-                    if (COV_Subscriptions[index].invokeID != 0) {
-                        /* already sending */
-                        send = false;
-                    }
-                    if (!tsm_transaction_available()) {
-                        /* no transactions available - can't send now */
-                        send = false;
-                    }
-                }
-                if (send) {
-                    object_type = (BACNET_OBJECT_TYPE)COV_Subscriptions[index]
-                                      .monitoredObjectIdentifier.type;
-                    object_instance = COV_Subscriptions[index]
-                                          .monitoredObjectIdentifier.instance;
-#if PRINT_ENABLED
-                    fprintf(stderr, "COVtask: Sending...\n");
-#endif
-                    /* configure the linked list for the two properties */
-                    bacapp_property_value_list_init(
-                        &value_list[0], MAX_COV_PROPERTIES);
-                    status = Device_Encode_Value_List(
-                        object_type, object_instance, &value_list[0]);
-                    if (status) {
-                        status = cov_send_request(
-                            &COV_Subscriptions[index], &value_list[0]);
-                    }
-                    if (status) {
-                        COV_Subscriptions[index].flag.send_requested = false;
-                    }
-                }
+            /* send the COVs that are requested for one object per call */
+            cov_object = Keylist_Data_Index(COV_Object_List, COV_Task_Index);
+            if (cov_object && !cov_object_send(cov_object)) {
+                /* unable to send now - continue with the next object */
+                COV_Task_Subscription = NULL;
             }
-            index++;
-            if (index >= MAX_COV_SUBCRIPTIONS) {
-                index = 0;
-                cov_task_state = COV_STATE_IDLE;
+            if (!COV_Task_Subscription) {
+                /* done with this object - move to the next object */
+                COV_Task_Index++;
+                cov_object =
+                    Keylist_Data_Index(COV_Object_List, COV_Task_Index);
+                if (cov_object) {
+                    COV_Task_Subscription = cov_object->subscriptions;
+                } else {
+                    COV_Task_Index = 0;
+                    COV_Task_State = COV_STATE_IDLE;
+                }
             }
             break;
         default:
-            index = 0;
-            cov_task_state = COV_STATE_IDLE;
+            COV_Task_Index = 0;
+            COV_Task_State = COV_STATE_IDLE;
             break;
     }
-    return (cov_task_state == COV_STATE_IDLE);
+
+    return (COV_Task_State == COV_STATE_IDLE);
 }
 
 void handler_cov_task(void)
@@ -722,7 +2188,17 @@ static bool cov_subscribe(BACNET_ADDRESS *src,
     object_instance = cov_data->monitoredObjectIdentifier.instance;
     status = Device_Valid_Object_Id(object_type, object_instance);
     if (status) {
-        status = Device_Value_List_Supported(object_type);
+        if (cov_data->covSubscribeToProperty) {
+            /* any property that can be read can be monitored */
+            status = cov_data->cancellationRequest ||
+                (cov_property_read(object_type, object_instance,
+                     cov_data->monitoredProperty.propertyIdentifier,
+                     cov_data->monitoredProperty.propertyArrayIndex,
+                     &COV_Property_Value_Buffer[0],
+                     sizeof(COV_Property_Value_Buffer)) >= 0);
+        } else {
+            status = Device_Value_List_Supported(object_type);
+        }
         if (status) {
             status = cov_list_subscribe(src, cov_data, error_class, error_code);
         } else if (cov_data->cancellationRequest) {
@@ -731,6 +2207,9 @@ static bool cov_subscribe(BACNET_ADDRESS *src,
                context can be found shall succeed as if a context had
                existed, returning 'Result(+)'. */
             status = true;
+        } else if (cov_data->covSubscribeToProperty) {
+            *error_class = ERROR_CLASS_PROPERTY;
+            *error_code = ERROR_CODE_NOT_COV_PROPERTY;
         } else {
             *error_class = ERROR_CLASS_OBJECT;
             *error_code = ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
@@ -745,31 +2224,158 @@ static bool cov_subscribe(BACNET_ADDRESS *src,
         *error_class = ERROR_CLASS_OBJECT;
         *error_code = ERROR_CODE_UNKNOWN_OBJECT;
     }
+    if (status) {
+        snapshot_subscribe_cov(src, cov_data);
+    }
 
     return status;
 }
 
-/** Handler for a COV Subscribe Service request.
- * @ingroup DSCOV
- * This handler will be invoked by apdu_handler() if it has been enabled
- * by a call to apdu_set_confirmed_handler().
- * This handler builds a response packet, which is
- * - an Abort if
- *   - the message is segmented
- *   - if decoding fails
- * - an ACK, if cov_subscribe() succeeds
- * - an Error if cov_subscribe() fails
+/**
+ * @brief Make a COV subscription of a remote subscriber again without a
+ *  request, such as from a snapshot after a restart
+ * @param src [in] address of the subscriber
+ * @param cov_data [in] the subscription
+ * @return true if the subscription was made
+ */
+bool handler_cov_subscription_restore(
+    BACNET_ADDRESS *src, BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_OBJECT;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_UNKNOWN_OBJECT;
+
+    if (!src || !cov_data) {
+        return false;
+    }
+
+    return cov_subscribe(src, cov_data, &error_class, &error_code);
+}
+
+/**
+ * @brief Find the local subscription of a subscriber to an object
+ * @param cov_object [in] monitored object
+ * @param subscriber_id [in] identifier of the local subscriber
+ * @param callback [in] function of the local subscriber
+ * @return the subscription, or NULL if not subscribed
+ */
+static BACNET_COV_SUBSCRIPTION *cov_local_subscription_find(
+    BACNET_COV_OBJECT *cov_object,
+    uint32_t subscriber_id,
+    handler_cov_local_callback callback)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+
+    if (cov_object) {
+        cov_subscription = cov_object->subscriptions;
+    }
+    while (cov_subscription) {
+        if ((cov_subscription->local_callback == callback) &&
+            (cov_subscription->subscriberProcessIdentifier ==
+                subscriber_id)) {
+            break;
+        }
+        cov_subscription = cov_subscription->next;
+    }
+
+    return cov_subscription;
+}
+
+/**
+ * @brief Subscribe a local consumer, such as a Trend Log, to the changes
+ *  of value of an object in this device.  The task calls the callback with
+ *  the listOfValues of the object, in place of sending a notification.
+ *  Local subscriptions have no lifetime, no address, and are not listed in
+ *  the Active_COV_Subscriptions of the device.  Subscribing again has no
+ *  effect.
+ * @param subscriber_id [in] identifier of the local subscriber
+ * @param object_type [in] type of the monitored object
+ * @param object_instance [in] instance of the monitored object
+ * @param callback [in] function called with the changed values
+ * @return true if subscribed, false if the object does not support COV,
+ *  or if out of resources
+ */
+bool handler_cov_local_subscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+
+    if (!callback) {
+        return false;
+    }
+    if (cov_local_subscription_find(
+            cov_object_find(object_type, object_instance), subscriber_id,
+            callback)) {
+        return true;
+    }
+    if (!Device_Valid_Object_Id(object_type, object_instance) ||
+        !Device_Value_List_Supported(object_type)) {
+        return false;
+    }
+    if (COV_Subscription_Count >= MAX_COV_SUBCRIPTIONS) {
+        return false;
+    }
+    cov_subscription = bacnet_memstats_calloc(
+        MEMSTATS_COV, 1, sizeof(BACNET_COV_SUBSCRIPTION));
+    if (!cov_subscription) {
+        return false;
+    }
+    cov_subscription->monitoredObjectIdentifier.type = object_type;
+    cov_subscription->monitoredObjectIdentifier.instance = object_instance;
+    cov_subscription->subscriberProcessIdentifier = subscriber_id;
+    cov_subscription->local_callback = callback;
+    cov_subscription->dest_index = MAX_COV_ADDRESSES;
+    cov_subscription->flag.send_requested = true;
+    if (!cov_subscription_add(cov_subscription, NULL)) {
+        bacnet_memstats_free(
+            MEMSTATS_COV, cov_subscription, sizeof(*cov_subscription));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Cancel the local subscription of a consumer to an object
+ * @param subscriber_id [in] identifier of the local subscriber
+ * @param object_type [in] type of the monitored object
+ * @param object_instance [in] instance of the monitored object
+ * @param callback [in] function of the local subscriber
+ */
+void handler_cov_local_unsubscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    BACNET_COV_OBJECT *cov_object = NULL;
+    BACNET_COV_SUBSCRIPTION *cov_subscription = NULL;
+
+    cov_object = cov_object_find(object_type, object_instance);
+    cov_subscription =
+        cov_local_subscription_find(cov_object, subscriber_id, callback);
+    if (cov_subscription) {
+        cov_subscription_remove(cov_object, cov_subscription);
+    }
+}
+
+/**
+ * Handles a SubscribeCOV or SubscribeCOVProperty request, and sends
+ * the response.
  *
  * @param service_request [in] The contents of the service request.
  * @param service_len [in] The length of the service_request.
  * @param src [in] BACNET_ADDRESS of the source of the message
  * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
  *                          decoded from the APDU header of this message.
+ * @param service [in] SERVICE_CONFIRMED_SUBSCRIBE_COV or
+ *  SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY
  */
-void handler_cov_subscribe(uint8_t *service_request,
+static void cov_subscribe_service(uint8_t *service_request,
     uint16_t service_len,
     BACNET_ADDRESS *src,
-    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    BACNET_CONFIRMED_SERVICE service)
 {
     BACNET_SUBSCRIBE_COV_DATA cov_data;
     int len = 0;
@@ -797,8 +2403,16 @@ void handler_cov_subscribe(uint8_t *service_request,
 #endif
         error = true;
     } else {
-        len = cov_subscribe_decode_service_request(
-            service_request, service_len, &cov_data);
+        cov_data.covSubscribeToProperty =
+            (service == SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY);
+        cov_data.covIncrementPresent = false;
+        if (cov_data.covSubscribeToProperty) {
+            len = cov_subscribe_property_decode_service_request(
+                service_request, service_len, &cov_data);
+        } else {
+            len = cov_subscribe_decode_service_request(
+                service_request, service_len, &cov_data);
+        }
 #if PRINT_ENABLED
         if (len <= 0)
             fprintf(stderr, "SubscribeCOV: Unable to decode Request!\n");
@@ -812,7 +2426,7 @@ void handler_cov_subscribe(uint8_t *service_request,
                 src, &cov_data, &cov_data.error_class, &cov_data.error_code);
             if (success) {
                 apdu_len = encode_simple_ack(&Handler_Transmit_Buffer[npdu_len],
-                    service_data->invoke_id, SERVICE_CONFIRMED_SUBSCRIBE_COV);
+                    service_data->invoke_id, service);
 #if PRINT_ENABLED
                 fprintf(stderr, "SubscribeCOV: Sending Simple Ack!\n");
 #endif
@@ -837,8 +2451,8 @@ void handler_cov_subscribe(uint8_t *service_request,
 #endif
         } else if (len == BACNET_STATUS_ERROR) {
             apdu_len = bacerror_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
-                service_data->invoke_id, SERVICE_CONFIRMED_SUBSCRIBE_COV,
-                cov_data.error_class, cov_data.error_code);
+                service_data->invoke_id, service, cov_data.error_class,
+                cov_data.error_code);
 #if PRINT_ENABLED
             fprintf(stderr, "SubscribeCOV: Sending Error!\n");
 #endif
@@ -854,6 +2468,7 @@ void handler_cov_subscribe(uint8_t *service_request,
     pdu_len = npdu_len + apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
 #if PRINT_ENABLED
         fprintf(stderr, "SubscribeCOV: Failed to send PDU (%s)!\n",
@@ -863,3 +2478,52 @@ void handler_cov_subscribe(uint8_t *service_request,
 
     return;
 }
+
+/** Handler for a COV Subscribe Service request.
+ * @ingroup DSCOV
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * by a call to apdu_set_confirmed_handler().
+ * This handler builds a response packet, which is
+ * - an Abort if
+ *   - the message is segmented
+ *   - if decoding fails
+ * - an ACK, if cov_subscribe() succeeds
+ * - an Error if cov_subscribe() fails
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_cov_subscribe(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    cov_subscribe_service(service_request, service_len, src, service_data,
+        SERVICE_CONFIRMED_SUBSCRIBE_COV);
+}
+
+/** Handler for a COV Subscribe Property Service request.
+ * @ingroup DSCOV
+ * The subscription monitors one property of the object, which is any
+ * property that can be read, with its own COV increment.  A numeric
+ * property without one uses the COV_Increment of the object for the
+ * Present_Value, or else notifies on any change.  The responses are
+ * the same as handler_cov_subscribe().
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_cov_subscribe_property(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    cov_subscribe_service(service_request, service_len, src, service_data,
+        SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY);
+}
@@ -16,6 +16,33 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/apdu.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
+
+/* the changes of a monitored object, recorded by the object when a
+   value is written, and given to the COV task with the changed object */
+/* the change of value flag of the object is set: a value changed by
+   the COV_Increment, or the Status_Flags changed */
+#define COV_CHANGE_VALUE 0x01
+/* the Present_Value changed */
+#define COV_CHANGE_PRESENT_VALUE 0x02
+/* the Status_Flags changed */
+#define COV_CHANGE_STATUS_FLAGS 0x04
+/* unknown changes, such as from a polled object */
+#define COV_CHANGE_ALL 0xFF
+
+/**
+ * @brief Callback of a local COV subscriber, called by the COV task
+ *  with the listOfValues of a changed object
+ * @param subscriber_id [in] identifier of the local subscriber
+ * @param object_type [in] type of the changed object
+ * @param object_instance [in] instance of the changed object
+ * @param value_list [in] the changed values, valid during the call
+ */
+typedef void (*handler_cov_local_callback)(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list);
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,6 +55,12 @@ extern "C" {
         BACNET_ADDRESS * src,
         BACNET_CONFIRMED_SERVICE_DATA * service_data);
     BACNET_STACK_EXPORT
+    void handler_cov_subscribe_property(
+        uint8_t * service_request,
+        uint16_t service_len,
+        BACNET_ADDRESS * src,
+        BACNET_CONFIRMED_SERVICE_DATA * service_data);
+    BACNET_STACK_EXPORT
     bool handler_cov_fsm(
         void);
     BACNET_STACK_EXPORT
@@ -43,6 +76,38 @@ extern "C" {
     int handler_cov_encode_subscriptions(
         uint8_t * apdu,
         int max_apdu);
+    BACNET_STACK_EXPORT
+    bool handler_cov_subscription_restore(
+        BACNET_ADDRESS * src,
+        BACNET_SUBSCRIBE_COV_DATA * cov_data);
+    BACNET_STACK_EXPORT
+    bool handler_cov_local_subscribe(
+        uint32_t subscriber_id,
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        handler_cov_local_callback callback);
+    BACNET_STACK_EXPORT
+    void handler_cov_local_unsubscribe(
+        uint32_t subscriber_id,
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        handler_cov_local_callback callback);
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+    BACNET_STACK_EXPORT
+    void handler_cov_object_changes(
+        BACNET_OBJECT_TYPE object_type,
+        uint32_t object_instance,
+        uint8_t changes);
+#else
+#define handler_cov_object_changes(object_type, object_instance, changes) \
+    ((void)0)
+#endif
+/* the change of value flag of an object covers its Present_Value
+   and its Status_Flags */
+#define handler_cov_object_changed(object_type, object_instance) \
+    handler_cov_object_changes((object_type), (object_instance), \
+        COV_CHANGE_VALUE | COV_CHANGE_PRESENT_VALUE | \
+            COV_CHANGE_STATUS_FLAGS)
 
 #ifdef __cplusplus
 }
@@ -180,6 +180,7 @@ DCC_ABORT:
     pdu_len += len;
     len = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     if (len <= 0) {
 #if PRINT_ENABLED
         fprintf(stderr,
@@ -108,6 +108,7 @@ void handler_delete_object(uint8_t *service_request,
         pdu_len += len;
         bytes_sent = datalink_send_pdu(
             src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+        bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     }
     if (bytes_sent <= 0) {
         debug_perror(
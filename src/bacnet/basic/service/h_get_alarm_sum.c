@@ -17,7 +17,8 @@
 #include "bacnet/apdu.h"
 #include "bacnet/npdu.h"
 #include "bacnet/abort.h"
-/* basic services, TSM, and datalink */
+/* basic objects, services, TSM, and datalink */
+#include "bacnet/basic/service/alarm_active.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/datalink/datalink.h"
@@ -44,6 +45,8 @@ void handler_get_alarm_summary(uint8_t *service_request,
     int alarm_value = 0;
     unsigned i = 0;
     unsigned j = 0;
+    unsigned index = 0, cursor = 0;
+    bool tracked = false;
     bool error = false;
     BACNET_ADDRESS my_address;
     BACNET_NPDU_DATA npdu_data;
@@ -73,8 +76,15 @@ void handler_get_alarm_summary(uint8_t *service_request,
 
     for (i = 0; i < MAX_BACNET_OBJECT_TYPE; i++) {
         if (Get_Alarm_Summary[i]) {
+            /* only the objects in the active alarm set have alarms */
+            tracked = Alarm_Active_Tracked(i);
             for (j = 0; j < 0xffff; j++) {
-                alarm_value = Get_Alarm_Summary[i](j, &getalarm_data);
+                if (!tracked) {
+                    index = j;
+                } else if (!Alarm_Active_Next(i, &cursor, &index)) {
+                    break;
+                }
+                alarm_value = Get_Alarm_Summary[i](index, &getalarm_data);
                 if (alarm_value > 0) {
                     len = get_alarm_summary_ack_encode_apdu_data(
                         &Handler_Transmit_Buffer[pdu_len + apdu_len],
@@ -85,7 +95,7 @@ void handler_get_alarm_summary(uint8_t *service_request,
                     } else {
                         apdu_len += len;
                     }
-                } else if (alarm_value < 0) {
+                } else if ((alarm_value < 0) && !tracked) {
                     break;
                 }
             }
@@ -121,6 +131,7 @@ GET_ALARM_SUMMARY_ABORT:
     pdu_len += apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
     if (bytes_sent <= 0) {
         /*fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno)); */
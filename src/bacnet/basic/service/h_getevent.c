@@ -21,6 +21,7 @@
 #include "bacnet/event.h"
 #include "bacnet/getevent.h"
 /* basic objects, services, TSM, and datalink */
+#include "bacnet/basic/service/alarm_active.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
@@ -75,6 +76,8 @@ void handler_get_event_information(uint8_t *service_request,
     BACNET_ADDRESS my_address;
     BACNET_OBJECT_ID object_id;
     unsigned i = 0, j = 0; /* counter */
+    unsigned index = 0, cursor = 0;
+    bool tracked = false;
     BACNET_GET_EVENT_INFORMATION_DATA getevent_data;
     int valid_event = 0;
 
@@ -120,8 +123,15 @@ void handler_get_event_information(uint8_t *service_request,
     apdu_len = len;
     for (i = 0; i < MAX_BACNET_OBJECT_TYPE; i++) {
         if (Get_Event_Info[i]) {
+            /* only the objects in the active alarm set have events */
+            tracked = Alarm_Active_Tracked(i);
             for (j = 0; j < 0xffff; j++) {
-                valid_event = Get_Event_Info[i](j, &getevent_data);
+                if (!tracked) {
+                    index = j;
+                } else if (!Alarm_Active_Next(i, &cursor, &index)) {
+                    break;
+                }
+                valid_event = Get_Event_Info[i](index, &getevent_data);
                 if (valid_event > 0) {
                     /* encode GetEvent_data only when type of object_id has max
                      * value */
@@ -165,7 +175,7 @@ void handler_get_event_information(uint8_t *service_request,
                     } else {
                         pdu_len += len;
                     }
-                } else if (valid_event < 0) {
+                } else if ((valid_event < 0) && !tracked) {
                     break;
                 }
             }
@@ -211,6 +221,7 @@ GET_EVENT_ABORT:
 #endif
         datalink_send_pdu(
             src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno));
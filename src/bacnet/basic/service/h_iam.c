@@ -46,6 +46,8 @@ void handler_i_am_add(
             src->mac[3], src->mac[4], src->mac[5]);
 #endif
         address_add(device_id, max_apdu, src);
+        address_segmentation_set(
+            device_id, (BACNET_SEGMENTATION)segmentation);
     } else {
 #if PRINT_ENABLED
         fprintf(stderr, ", but unable to decode it.\n");
@@ -55,6 +57,66 @@ void handler_i_am_add(
     return;
 }
 
+/* I-Am replies waiting to be added to the address cache */
+#ifndef I_AM_BATCH_SIZE
+#define I_AM_BATCH_SIZE 16
+#endif
+static BACNET_ADDRESS_BINDING_ADD I_Am_Batch[I_AM_BATCH_SIZE];
+static unsigned I_Am_Batch_Count;
+
+/** Add the I-Am replies waiting in the batch to the address cache.
+ * @ingroup DMDDB
+ */
+void handler_i_am_add_flush(void)
+{
+    address_add_list(&I_Am_Batch[0], I_Am_Batch_Count);
+    I_Am_Batch_Count = 0;
+}
+
+/** Handler for I-Am responses, which adds the responders to our cache in
+ * batches, for the flood of I-Am replies after a global Who-Is.  A device
+ * heard twice in the same batch is only added once.  The batch is added
+ * when it is full, or by calling handler_i_am_add_flush() from the main
+ * loop of the application.
+ * @ingroup DMDDB
+ * @param service_request [in] The received message to be handled.
+ * @param service_len [in] Length of the service_request message.
+ * @param src [in] The BACNET_ADDRESS of the message's source.
+ */
+void handler_i_am_add_batch(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    int len = 0;
+    uint32_t device_id = 0;
+    unsigned max_apdu = 0;
+    int segmentation = 0;
+    uint16_t vendor_id = 0;
+    unsigned i = 0;
+
+    (void)service_len;
+    len = iam_decode_service_request(
+        service_request, &device_id, &max_apdu, &segmentation, &vendor_id);
+    if (len <= 0) {
+        return;
+    }
+    for (i = 0; i < I_Am_Batch_Count; i++) {
+        if (I_Am_Batch[i].device_id == device_id) {
+            break;
+        }
+    }
+    if (i == I_Am_Batch_Count) {
+        if (I_Am_Batch_Count == I_AM_BATCH_SIZE) {
+            handler_i_am_add_flush();
+            i = 0;
+        }
+        I_Am_Batch_Count++;
+    }
+    I_Am_Batch[i].device_id = device_id;
+    I_Am_Batch[i].max_apdu = max_apdu;
+    I_Am_Batch[i].segmentation = (BACNET_SEGMENTATION)segmentation;
+    bacnet_address_copy(&I_Am_Batch[i].address, src);
+}
+
 /** Handler for I-Am responses (older binding-update-only version).
  * Will update the responder's binding, but if already in our cache.
  * @note This handler is deprecated, in favor of handler_i_am_add().
@@ -78,6 +140,8 @@ void handler_i_am_bind(
     if (len > 0) {
         /* only add address if requested to bind */
         address_add_binding(device_id, max_apdu, src);
+        address_segmentation_set(
+            device_id, (BACNET_SEGMENTATION)segmentation);
     }
 
     return;
@@ -26,6 +26,14 @@ extern "C" {
         uint16_t service_len,
         BACNET_ADDRESS * src);
 
+    BACNET_STACK_EXPORT
+    void handler_i_am_add_batch(
+        uint8_t * service_request,
+        uint16_t service_len,
+        BACNET_ADDRESS * src);
+    BACNET_STACK_EXPORT
+    void handler_i_am_add_flush(void);
+
     BACNET_STACK_EXPORT
     void handler_i_am_bind(
         uint8_t * service_request,
@@ -108,6 +108,7 @@ void handler_add_list_element(uint8_t *service_request,
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
         debug_perror(
             "AddListElement: Failed to send PDU (%s)!\n", strerror(errno));
@@ -199,6 +200,7 @@ void handler_remove_list_element(uint8_t *service_request,
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
         debug_perror(
             "RemoveListElement: Failed to send PDU (%s)!\n", strerror(errno));
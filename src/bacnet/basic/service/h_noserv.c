@@ -60,6 +60,7 @@ void handler_unrecognized_service(uint8_t *service_request,
     /* send the data */
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent > 0) {
 #if PRINT_ENABLED
         fprintf(stderr, "Sent Reject!\n");
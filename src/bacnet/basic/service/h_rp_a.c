@@ -22,6 +22,7 @@
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/static_pool.h"
 #include "bacnet/datalink/datalink.h"
 
 #define PRINTF debug_aprintf
@@ -160,7 +161,7 @@ int rp_ack_fully_decode_service_request(
          */
         read_access_data->object_type = rp1data.object_type;
         read_access_data->object_instance = rp1data.object_instance;
-        rp1_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+        rp1_property = bacnet_calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
         read_access_data->listOfProperties = rp1_property;
         if (rp1_property == NULL) {
             /* can't proceed if calloc failed. */
@@ -177,7 +178,7 @@ int rp_ack_fully_decode_service_request(
          more than one element to decode */
         vdata = rp1data.application_data;
         vlen = rp1data.application_data_len;
-        value = calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+        value = bacnet_calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
         rp1_property->value = value;
         while (value && vdata && (vlen > 0)) {
             if (IS_CONTEXT_SPECIFIC(*vdata)) {
@@ -192,9 +193,9 @@ int rp_ack_fully_decode_service_request(
                     /* free the linked list of values */
                     old_value = value;
                     value = value->next;
-                    free(old_value);
+                    bacnet_free(old_value);
                 }
-                free(rp1_property);
+                bacnet_free(rp1_property);
                 read_access_data->listOfProperties = NULL;
                 return len;
             }
@@ -214,16 +215,17 @@ int rp_ack_fully_decode_service_request(
                         /* free the linked list of values */
                         old_value = value;
                         value = value->next;
-                        free(old_value);
+                        bacnet_free(old_value);
                     }
-                    free(rp1_property);
+                    bacnet_free(rp1_property);
                     read_access_data->listOfProperties = NULL;
                     return BACNET_STATUS_ERROR;
                 }
                 if (vlen > 0) {
                     /* If more values */
                     old_value = value;
-                    value = calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                    value =
+                        bacnet_calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
                     old_value->next = value;
                 }
             }
@@ -34,7 +34,10 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/datalink/datalink.h"
 
-static uint8_t Temp_Buf[MAX_APDU] = { 0 };
+#if BACNET_SEGMENTATION_ENABLED
+/* a reply that is sent in segments is encoded here */
+static uint8_t Segmented_Buffer[BACNET_SEGMENTATION_BUFFER_SIZE];
+#endif
 
 /**
  * @brief Fetches the lists of properties (array of BACNET_PROPERTY_ID's) for
@@ -108,40 +111,58 @@ static unsigned RPM_Object_Property_Count(
     return count;
 }
 
-/** 
- * @brief Encode the RPM property returning the length of the encoding,
- * or 0 if there is no room to fit the encoding.
+/**
+ * @brief Encode the RPM property directly into the reply, returning the
+ * length of the encoding, or 0 if there is no room to fit the encoding.
+ *
+ * The property reference and any property access error have a known
+ * length, which is checked before they are encoded in place.  The value
+ * is read straight into the reply after its opening tag; if it turns out
+ * to be too large, the reply is rolled back to the property reference.
+ *
  * @param apdu [out] The buffer to encode the property into.
  * @param offset [in] The offset into the buffer to start encoding.
- * @param max_apdu [in] The maximum length of the buffer.
+ * @param max_apdu [in] The maximum length of the reply.
+ * @param apdu_size [in] The size of the buffer, which may be larger than
+ * the reply and bounds what the object may encode.
  * @param rpmdata [in] The RPM data to encode.
  * @return The length of the encoding, or 0 if there is no room to fit the
  * encoding.
  */
-static int RPM_Encode_Property(
-    uint8_t *apdu, uint16_t offset, uint16_t max_apdu, BACNET_RPM_DATA *rpmdata)
+static int RPM_Encode_Property(uint8_t *apdu,
+    uint16_t offset,
+    uint16_t max_apdu,
+    unsigned apdu_size,
+    BACNET_RPM_DATA *rpmdata)
 {
     int len = 0;
-    size_t copy_len = 0;
     int apdu_len = 0;
+    unsigned value_offset = 0;
     BACNET_READ_PROPERTY_DATA rpdata;
 
     len = rpm_ack_encode_apdu_object_property(
-        &Temp_Buf[0], rpmdata->object_property, rpmdata->array_index);
-    copy_len = memcopy(&apdu[0], &Temp_Buf[0], offset, len, max_apdu);
-    if (copy_len == 0) {
+        NULL, rpmdata->object_property, rpmdata->array_index);
+    if (!memcopylen(offset, max_apdu, len)) {
         rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         return BACNET_STATUS_ABORT;
     }
-    apdu_len += len;
+    apdu_len = rpm_ack_encode_apdu_object_property(
+        &apdu[offset], rpmdata->object_property, rpmdata->array_index);
+    /* the value goes after its opening tag, leaving room for the
+       closing tag */
+    value_offset = offset + apdu_len + 1;
     rpdata.error_class = ERROR_CLASS_OBJECT;
     rpdata.error_code = ERROR_CODE_UNKNOWN_OBJECT;
     rpdata.object_type = rpmdata->object_type;
     rpdata.object_instance = rpmdata->object_instance;
     rpdata.object_property = rpmdata->object_property;
     rpdata.array_index = rpmdata->array_index;
-    rpdata.application_data = &Temp_Buf[0];
-    rpdata.application_data_len = sizeof(Temp_Buf);
+    rpdata.application_data = &apdu[value_offset];
+    if ((value_offset + 1) < apdu_size) {
+        rpdata.application_data_len = apdu_size - value_offset - 1;
+    } else {
+        rpdata.application_data_len = 0;
+    }
 
     if ((rpmdata->object_property == PROP_ALL) ||
         (rpmdata->object_property == PROP_REQUIRED) ||
@@ -160,18 +181,18 @@ static int RPM_Encode_Property(
         }
         /* error was returned - encode that for the response */
         len = rpm_ack_encode_apdu_object_property_error(
-            &Temp_Buf[0], rpdata.error_class, rpdata.error_code);
-        copy_len =
-            memcopy(&apdu[0], &Temp_Buf[0], offset + apdu_len, len, max_apdu);
-
-        if (copy_len == 0) {
+            NULL, rpdata.error_class, rpdata.error_code);
+        if (!memcopylen(offset + apdu_len, max_apdu, len)) {
             rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
             return BACNET_STATUS_ABORT;
         }
+        len = rpm_ack_encode_apdu_object_property_error(
+            &apdu[offset + apdu_len], rpdata.error_class, rpdata.error_code);
     } else if ((offset + apdu_len + 1 + len + 1) < max_apdu) {
-        /* enough room to fit the property value and tags */
+        /* enough room to fit the property value and tags; the value
+           is already in place, so only the tags are added */
         len = rpm_ack_encode_apdu_object_property_value(
-            &apdu[offset + apdu_len], &Temp_Buf[0], len);
+            &apdu[offset + apdu_len], &apdu[value_offset], len);
     } else {
         /* not enough room - abort! */
         rpmdata->error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
@@ -218,6 +239,12 @@ void handler_read_property_multiple(uint8_t *service_request,
     int apdu_len = 0;
     int npdu_len = 0;
     int error = 0;
+    uint8_t *apdu = NULL;
+    unsigned apdu_max = MAX_APDU;
+    unsigned apdu_size = 0;
+#if BACNET_SEGMENTATION_ENABLED
+    unsigned segmented_max = 0;
+#endif
 
     if (service_data && (service_len > 0)) {
         /* jps_debug - see if we are utilizing all the buffer */
@@ -236,8 +263,26 @@ void handler_read_property_multiple(uint8_t *service_request,
         } else {
             /* decode apdu request & encode apdu reply
                encode complex ack, invoke id, service choice */
-            apdu_len = rpm_ack_encode_apdu_init(
-                &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id);
+            apdu = &Handler_Transmit_Buffer[npdu_len];
+            apdu_size = sizeof(Handler_Transmit_Buffer) - npdu_len;
+#if BACNET_SEGMENTATION_ENABLED
+            /* a reply too large for one APDU may be sent in segments */
+            segmented_max = tsm_segmented_response_max(src, service_data);
+            if (segmented_max > 0) {
+                apdu = &Segmented_Buffer[0];
+                apdu_max = segmented_max;
+                apdu_size = sizeof(Segmented_Buffer);
+            }
+#endif
+            if ((apdu == &Handler_Transmit_Buffer[npdu_len]) &&
+                (service_data->max_resp > 0) &&
+                (service_data->max_resp < apdu_max)) {
+                /* stop encoding once the reply is too large for the
+                   sender, instead of encoding all of it to abort */
+                apdu_max = service_data->max_resp;
+            }
+            apdu_len =
+                rpm_ack_encode_apdu_init(apdu, service_data->invoke_id);
 
             for (;;) {
                 /* Start by looking for an object ID */
@@ -276,9 +321,13 @@ void handler_read_property_multiple(uint8_t *service_request,
 #endif
 
                 /* Stick this object id into the reply - if it will fit */
-                len = rpm_ack_encode_apdu_object_begin(&Temp_Buf[0], &rpmdata);
-                copy_len = memcopy(&Handler_Transmit_Buffer[npdu_len],
-                    &Temp_Buf[0], apdu_len, len, MAX_APDU);
+                len = rpm_ack_encode_apdu_object_begin(NULL, &rpmdata);
+                if (memcopylen(apdu_len, apdu_max, len)) {
+                    copy_len = (uint16_t)rpm_ack_encode_apdu_object_begin(
+                        &apdu[apdu_len], &rpmdata);
+                } else {
+                    copy_len = 0;
+                }
                 if (copy_len == 0) {
                     debug_fprintf(stderr, "RPM: Response too big!\r\n");
                     rpmdata.error_code =
@@ -316,9 +365,8 @@ void handler_read_property_multiple(uint8_t *service_request,
 
                         if (!Device_Valid_Object_Id(rpmdata.object_type,
                                                     rpmdata.object_instance)) {
-                            len = RPM_Encode_Property(
-                                &Handler_Transmit_Buffer[npdu_len],
-                                (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                            len = RPM_Encode_Property(apdu, (uint16_t)apdu_len,
+                                (uint16_t)apdu_max, apdu_size, &rpmdata);
                             if (len > 0) {
                                 apdu_len += len;
                             } else {
@@ -335,13 +383,17 @@ void handler_read_property_multiple(uint8_t *service_request,
                             /* No array index options for this special property.
                                Encode error for this object property response */
                             len = rpm_ack_encode_apdu_object_property(
-                                &Temp_Buf[0], rpmdata.object_property,
+                                NULL, rpmdata.object_property,
                                 rpmdata.array_index);
-
-                            copy_len =
-                                memcopy(&Handler_Transmit_Buffer[npdu_len],
-                                    &Temp_Buf[0], apdu_len, len, MAX_APDU);
-
+                            if (memcopylen(apdu_len, apdu_max, len)) {
+                                copy_len = (uint16_t)
+                                    rpm_ack_encode_apdu_object_property(
+                                        &apdu[apdu_len],
+                                        rpmdata.object_property,
+                                        rpmdata.array_index);
+                            } else {
+                                copy_len = 0;
+                            }
                             if (copy_len == 0) {
                                 debug_fprintf(stderr,
                                     "RPM: Too full to encode property!\r\n");
@@ -355,13 +407,16 @@ void handler_read_property_multiple(uint8_t *service_request,
 
                             apdu_len += len;
                             len = rpm_ack_encode_apdu_object_property_error(
-                                &Temp_Buf[0], ERROR_CLASS_PROPERTY,
+                                NULL, ERROR_CLASS_PROPERTY,
                                 ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY);
-
-                            copy_len =
-                                memcopy(&Handler_Transmit_Buffer[npdu_len],
-                                    &Temp_Buf[0], apdu_len, len, MAX_APDU);
-
+                            if (memcopylen(apdu_len, apdu_max, len)) {
+                                copy_len = (uint16_t)
+                                    rpm_ack_encode_apdu_object_property_error(
+                                        &apdu[apdu_len], ERROR_CLASS_PROPERTY,
+                                        ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY);
+                            } else {
+                                copy_len = 0;
+                            }
                             if (copy_len == 0) {
                                 debug_fprintf(stderr,
                                     "RPM: Too full to encode error!\r\n");
@@ -391,9 +446,9 @@ void handler_read_property_multiple(uint8_t *service_request,
                                    object does not exist. */
                                 if (!Device_Valid_Object_Id(rpmdata.object_type,
                                   rpmdata.object_instance)) {
-                                    len = RPM_Encode_Property(
-                                        &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                                    len = RPM_Encode_Property(apdu,
+                                        (uint16_t)apdu_len, (uint16_t)apdu_max,
+                                        apdu_size, &rpmdata);
                                     if (len > 0) {
                                         apdu_len += len;
                                     } else {
@@ -412,9 +467,9 @@ void handler_read_property_multiple(uint8_t *service_request,
                                     rpmdata.object_property =
                                         RPM_Object_Property(&property_list,
                                             special_object_property, index);
-                                    len = RPM_Encode_Property(
-                                        &Handler_Transmit_Buffer[npdu_len],
-                                        (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                                    len = RPM_Encode_Property(apdu,
+                                        (uint16_t)apdu_len, (uint16_t)apdu_max,
+                                        apdu_size, &rpmdata);
                                     if (len > 0) {
                                         apdu_len += len;
                                     } else {
@@ -431,9 +486,8 @@ void handler_read_property_multiple(uint8_t *service_request,
                         }
                     } else {
                         /* handle an individual property */
-                        len = RPM_Encode_Property(
-                            &Handler_Transmit_Buffer[npdu_len],
-                            (uint16_t)apdu_len, MAX_APDU, &rpmdata);
+                        len = RPM_Encode_Property(apdu, (uint16_t)apdu_len,
+                            (uint16_t)apdu_max, apdu_size, &rpmdata);
                         if (len > 0) {
                             apdu_len += len;
                         } else {
@@ -451,9 +505,13 @@ void handler_read_property_multiple(uint8_t *service_request,
                         /* Reached end of property list so cap the result list
                          */
                         decode_len++;
-                        len = rpm_ack_encode_apdu_object_end(&Temp_Buf[0]);
-                        copy_len = memcopy(&Handler_Transmit_Buffer[npdu_len],
-                            &Temp_Buf[0], apdu_len, len, MAX_APDU);
+                        len = rpm_ack_encode_apdu_object_end(NULL);
+                        if (memcopylen(apdu_len, apdu_max, len)) {
+                            copy_len = (uint16_t)rpm_ack_encode_apdu_object_end(
+                                &apdu[apdu_len]);
+                        } else {
+                            copy_len = 0;
+                        }
                         if (copy_len == 0) {
                             debug_fprintf(stderr,
                                 "RPM: Too full to encode object end!\r\n");
@@ -481,14 +539,39 @@ void handler_read_property_multiple(uint8_t *service_request,
             /* If not having an error so far, check the remaining space. */
             if (!berror) {
                 if (apdu_len > service_data->max_resp) {
-                    /* too big for the sender - send an abort */
-                    rpmdata.error_code =
-                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
-                    error = BACNET_STATUS_ABORT;
+#if BACNET_SEGMENTATION_ENABLED
+                    if (apdu != &Handler_Transmit_Buffer[npdu_len]) {
+                        if (tsm_segmented_complex_ack_send(src, &npdu_data,
+                                service_data, apdu, (unsigned)apdu_len)) {
+                            /* the TSM sends the segments */
+                            return;
+                        }
+                        rpmdata.error_code = ERROR_CODE_ABORT_OUT_OF_RESOURCES;
+                        error = BACNET_STATUS_ABORT;
+                    }
+#endif
+                    if (!error) {
+                        /* too big for the sender - send an abort */
+                        rpmdata.error_code =
+                            ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+                        error = BACNET_STATUS_ABORT;
+                    }
                     debug_fprintf(
                         stderr, "RPM: Message too large.  Sending Abort!\n");
+                } else if (apdu != &Handler_Transmit_Buffer[npdu_len]) {
+                    memcpy(&Handler_Transmit_Buffer[npdu_len], apdu,
+                        (size_t)apdu_len);
                 }
             }
+#if BACNET_SEGMENTATION_ENABLED
+            if ((error == BACNET_STATUS_ABORT) &&
+                (apdu != &Handler_Transmit_Buffer[npdu_len]) &&
+                (rpmdata.error_code ==
+                    ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED)) {
+                /* did not fit into the segments */
+                rpmdata.error_code = ERROR_CODE_ABORT_BUFFER_OVERFLOW;
+            }
+#endif
         }
 
         /* Error fallback. */
@@ -515,6 +598,7 @@ void handler_read_property_multiple(uint8_t *service_request,
         pdu_len = apdu_len + npdu_len;
         bytes_sent = datalink_send_pdu(
             src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+        bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
         if (bytes_sent <= 0) {
             debug_fprintf(stderr, "RPM: Failed to send PDU (errno=%d)!\n", 
             errno);
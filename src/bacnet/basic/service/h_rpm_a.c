@@ -37,7 +37,9 @@
 /* some demo stuff needed */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/arena.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/static_pool.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 
@@ -46,17 +48,45 @@
 
 /** @file h_rpm_a.c  Handles Read Property Multiple Acknowledgments. */
 
-/** Decode the received RPM data and make a linked list of the results.
- * @ingroup DSRPM
- *
+/**
+ * @brief Allocate zeroed memory for the decoded RPM data
+ * @param arena [in] arena to allocate from, or NULL for the heap
+ * @param size [in] number of bytes
+ * @return the memory, or NULL if out of memory
+ */
+static void *rpm_ack_alloc(ARENA_BUFFER *arena, size_t size)
+{
+    if (arena) {
+        return arena_alloc(arena, size);
+    }
+
+    return bacnet_calloc(1, size);
+}
+
+/**
+ * @brief Free memory of the decoded RPM data
+ * @param arena [in] arena the memory came from, or NULL for the heap
+ * @param data [in] the memory
+ */
+static void rpm_ack_free(ARENA_BUFFER *arena, void *data)
+{
+    if (!arena) {
+        bacnet_free(data);
+    }
+}
+
+/**
+ * @brief Decode the received RPM data and make a linked list of the results
  * @param apdu [in] The received apdu data.
  * @param apdu_len [in] Total length of the apdu.
- * @param read_access_data [out] Pointer to the head of the linked list
- * 			where the RPM data is to be stored.
+ * @param read_access_data [out] head of the linked list
+ * @param arena [in] arena for the list, or NULL for the heap
  * @return The number of bytes decoded, or -1 on error
  */
-int rpm_ack_decode_service_request(
-    uint8_t *apdu, int apdu_len, BACNET_READ_ACCESS_DATA *read_access_data)
+static int rpm_ack_decode(uint8_t *apdu,
+    int apdu_len,
+    BACNET_READ_ACCESS_DATA *read_access_data,
+    ARENA_BUFFER *arena)
 {
     int decoded_len = 0; /* return value */
     uint32_t error_value = 0; /* decoded error value */
@@ -83,7 +113,7 @@ int rpm_ack_decode_service_request(
             old_rpm_object->next = NULL;
             if (rpm_object != read_access_data) {
                 /* don't free original */
-                free(rpm_object);
+                rpm_ack_free(arena, rpm_object);
                 rpm_object = NULL;
             }
             break;
@@ -91,7 +121,8 @@ int rpm_ack_decode_service_request(
         decoded_len += len;
         apdu_len -= len;
         apdu += len;
-        rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+        rpm_property =
+            rpm_ack_alloc(arena, sizeof(BACNET_PROPERTY_REFERENCE));
         rpm_object->listOfProperties = rpm_property;
         old_rpm_property = rpm_property;
         while (rpm_property && apdu_len) {
@@ -104,7 +135,7 @@ int rpm_ack_decode_service_request(
                     /* was this the only property in the list? */
                     rpm_object->listOfProperties = NULL;
                 }
-                free(rpm_property);
+                rpm_ack_free(arena, rpm_property);
                 rpm_property = NULL;
                 break;
             }
@@ -120,7 +151,8 @@ int rpm_ack_decode_service_request(
                 apdu++;
                 /* note: if this is an array, there will be
                    more than one element to decode */
-                value = calloc(1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                value = rpm_ack_alloc(
+                    arena, sizeof(BACNET_APPLICATION_DATA_VALUE));
                 rpm_property->value = value;
 
                 /* Special case for an empty array - we decode it as null */
@@ -162,8 +194,8 @@ int rpm_ack_decode_service_request(
                             break;
                         } else if (len > 0) {
                             old_value = value;
-                            value = calloc(
-                                1, sizeof(BACNET_APPLICATION_DATA_VALUE));
+                            value = rpm_ack_alloc(
+                    arena, sizeof(BACNET_APPLICATION_DATA_VALUE));
                             old_value->next = value;
                         } else {
                             PERROR("RPM Ack: decoded %s:%s len=%d\n",
@@ -212,7 +244,8 @@ int rpm_ack_decode_service_request(
                 }
             }
             old_rpm_property = rpm_property;
-            rpm_property = calloc(1, sizeof(BACNET_PROPERTY_REFERENCE));
+            rpm_property =
+                rpm_ack_alloc(arena, sizeof(BACNET_PROPERTY_REFERENCE));
             old_rpm_property->next = rpm_property;
         }
         len = rpm_decode_object_end(apdu, apdu_len);
@@ -223,7 +256,8 @@ int rpm_ack_decode_service_request(
         }
         if (apdu_len) {
             old_rpm_object = rpm_object;
-            rpm_object = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+            rpm_object =
+                rpm_ack_alloc(arena, sizeof(BACNET_READ_ACCESS_DATA));
             old_rpm_object->next = rpm_object;
         }
     }
@@ -231,6 +265,52 @@ int rpm_ack_decode_service_request(
     return decoded_len;
 }
 
+/** Decode the received RPM data and make a linked list of the results.
+ * @ingroup DSRPM
+ *
+ * @param apdu [in] The received apdu data.
+ * @param apdu_len [in] Total length of the apdu.
+ * @param read_access_data [out] Pointer to the head of the linked list
+ * 			where the RPM data is to be stored.
+ * @return The number of bytes decoded, or -1 on error
+ */
+int rpm_ack_decode_service_request(
+    uint8_t *apdu, int apdu_len, BACNET_READ_ACCESS_DATA *read_access_data)
+{
+    return rpm_ack_decode(apdu, apdu_len, read_access_data, NULL);
+}
+
+/** Decode the received RPM data and make a linked list of the results,
+ * with the list allocated from an arena instead of the heap.  The whole
+ * list is released with arena_reset(), and not with rpm_data_free().
+ * @ingroup DSRPM
+ *
+ * @param apdu [in] The received apdu data.
+ * @param apdu_len [in] Total length of the apdu.
+ * @param read_access_data [out] Pointer to the head of the linked list
+ * 			where the RPM data is to be stored.
+ * @param arena [in] arena for the objects, properties and values
+ * @return The number of bytes decoded, or -1 on error or when the
+ *  results did not fit in the arena since it was last reset
+ */
+int rpm_ack_decode_service_request_arena(uint8_t *apdu,
+    int apdu_len,
+    BACNET_READ_ACCESS_DATA *read_access_data,
+    ARENA_BUFFER *arena)
+{
+    int len;
+
+    if (!arena) {
+        return BACNET_STATUS_ERROR;
+    }
+    len = rpm_ack_decode(apdu, apdu_len, read_access_data, arena);
+    if (arena_overflow(arena)) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return len;
+}
+
 /* for debugging... */
 void rpm_ack_print_data(BACNET_READ_ACCESS_DATA *rpm_data)
 {
@@ -330,17 +410,17 @@ BACNET_READ_ACCESS_DATA *rpm_data_free(BACNET_READ_ACCESS_DATA *rpm_data)
             while (value) {
                 old_value = value;
                 value = value->next;
-                free(old_value);
+                bacnet_free(old_value);
                 old_value = NULL;
             }
             old_rpm_property = rpm_property;
             rpm_property = rpm_property->next;
-            free(old_rpm_property);
+            bacnet_free(old_rpm_property);
             old_rpm_property = NULL;
         }
         old_rpm_data = rpm_data;
         rpm_data = rpm_data->next;
-        free(old_rpm_data);
+        bacnet_free(old_rpm_data);
         old_rpm_data = NULL;
     }
 
@@ -369,7 +449,7 @@ void handler_read_property_multiple_ack(uint8_t *service_request,
     (void)src;
     (void)service_data; /* we could use these... */
 
-    rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+    rpm_data = bacnet_calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
     if (rpm_data) {
         len = rpm_ack_decode_service_request(
             service_request, service_len, rpm_data);
@@ -64,7 +64,7 @@ static int Encode_RR_payload(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
 {
     int apdu_len = -1;
     rr_info_function info_fn_ptr = NULL;
-    RR_PROP_INFO PropInfo;
+    RR_PROP_INFO PropInfo = { 0 };
 
     /* initialize the default return values */
     pRequest->error_class = ERROR_CLASS_SERVICES;
@@ -97,6 +97,9 @@ static int Encode_RR_payload(uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
                                      so... */
         } else if (PropInfo.Handler != NULL) {
             apdu_len = PropInfo.Handler(apdu, pRequest);
+        } else if (PropInfo.Element_Encode != NULL) {
+            apdu_len = read_range_element_list_encode(apdu, MAX_APDU,
+                pRequest, PropInfo.Element_Encode, PropInfo.Element_Count);
         }
     } else {
         /* Either we don't support RR for this property yet or it is not a list
@@ -175,6 +178,15 @@ void handler_read_range(uint8_t *service_request,
                 /* FIXME: probably need a length limitation sent with encode */
                 len = rr_ack_encode_apdu(&Handler_Transmit_Buffer[pdu_len],
                     service_data->invoke_id, &data);
+#if BACNET_SEGMENTATION_ENABLED
+                if ((len > service_data->max_resp) &&
+                    tsm_segmented_complex_ack_send(src, &npdu_data,
+                        service_data, &Handler_Transmit_Buffer[pdu_len],
+                        (unsigned)len)) {
+                    /* the TSM sends the segments */
+                    return;
+                }
+#endif
 #if PRINT_ENABLED
                 fprintf(stderr, "RR: Sending Ack!\n");
 #endif
@@ -209,6 +221,7 @@ void handler_read_range(uint8_t *service_request,
 #endif
         datalink_send_pdu(
             src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
 #if PRINT_ENABLED
     if (bytes_sent <= 0)
         fprintf(stderr, "Failed to send PDU (%s)!\n", strerror(errno));
@@ -25,6 +25,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 /* BACnet Stack defines - first */
@@ -68,6 +69,113 @@ void handler_who_is(
     return;
 }
 
+/* Deferred I-Am replies.  After a global Who-Is, every device answering
+   at once floods the network, so the reply is sent after a random delay
+   within the reply window, any Who-Is heard while a reply is waiting is
+   answered by that same reply, and the next reply waits at least one
+   window after the last one. */
+#ifndef WHO_IS_REPLY_WINDOW_MS
+#define WHO_IS_REPLY_WINDOW_MS 1000
+#endif
+static uint16_t Who_Is_Reply_Window = WHO_IS_REPLY_WINDOW_MS;
+static bool Who_Is_Reply_Pending;
+static uint32_t Who_Is_Reply_Delay;
+static uint32_t Who_Is_Reply_Holdoff;
+
+/** Set the window of the deferred I-Am replies.
+ * @ingroup DMDDB
+ * @param milliseconds [in] most time to wait before an I-Am reply, and
+ *  least time between I-Am replies.  Zero replies without delay.
+ */
+void handler_who_is_reply_window_set(uint16_t milliseconds)
+{
+    Who_Is_Reply_Window = milliseconds;
+}
+
+/** Get the window of the deferred I-Am replies.
+ * @ingroup DMDDB
+ * @return most time, in milliseconds, to wait before an I-Am reply
+ */
+uint16_t handler_who_is_reply_window(void)
+{
+    return Who_Is_Reply_Window;
+}
+
+/** Determine if a deferred I-Am reply is waiting to be sent.
+ * @ingroup DMDDB
+ * @return true if an I-Am reply is waiting
+ */
+bool handler_who_is_reply_pending(void)
+{
+    return Who_Is_Reply_Pending;
+}
+
+/** Send the deferred I-Am reply when its delay has passed.
+ * Call this periodically from the main loop of the application.
+ * @ingroup DMDDB
+ * @param milliseconds [in] time since the last call
+ */
+void handler_who_is_timer(uint16_t milliseconds)
+{
+    if (Who_Is_Reply_Holdoff > milliseconds) {
+        Who_Is_Reply_Holdoff -= milliseconds;
+    } else {
+        Who_Is_Reply_Holdoff = 0;
+    }
+    if (!Who_Is_Reply_Pending) {
+        return;
+    }
+    if (Who_Is_Reply_Delay > milliseconds) {
+        Who_Is_Reply_Delay -= milliseconds;
+        return;
+    }
+    Who_Is_Reply_Delay = 0;
+    Who_Is_Reply_Pending = false;
+    Who_Is_Reply_Holdoff = Who_Is_Reply_Window;
+    Send_I_Am(&Handler_Transmit_Buffer[0]);
+}
+
+/** Handler for Who-Is requests, with a deferred broadcast I-Am response
+ * that is sent by handler_who_is_timer().
+ * @ingroup DMDDB
+ * @param service_request [in] The received message to be handled.
+ * @param service_len [in] Length of the service_request message.
+ * @param src [in] The BACNET_ADDRESS of the message's source (ignored).
+ */
+void handler_who_is_deferred(
+    uint8_t *service_request, uint16_t service_len, BACNET_ADDRESS *src)
+{
+    int len = 0;
+    int32_t low_limit = 0;
+    int32_t high_limit = 0;
+
+    (void)src;
+    len = whois_decode_service_request(
+        service_request, service_len, &low_limit, &high_limit);
+    if (len == BACNET_STATUS_ERROR) {
+        return;
+    }
+    if (len != 0) {
+        /* is my device id within the limits? */
+        if ((Device_Object_Instance_Number() < (uint32_t)low_limit) ||
+            (Device_Object_Instance_Number() > (uint32_t)high_limit)) {
+            return;
+        }
+    }
+    if (Who_Is_Reply_Pending) {
+        /* answered by the reply that is waiting */
+        return;
+    }
+    Who_Is_Reply_Pending = true;
+    Who_Is_Reply_Delay = Who_Is_Reply_Holdoff;
+    if (Who_Is_Reply_Window > 0) {
+        Who_Is_Reply_Delay += (uint32_t)rand() % (Who_Is_Reply_Window + 1UL);
+    }
+    if (Who_Is_Reply_Delay == 0) {
+        handler_who_is_timer(0);
+    }
+}
+
 /** Handler for Who-Is requests, with Unicast I-Am response (per Addendum
  * 135-2004q).
  * @ingroup DMDDB
@@ -47,6 +47,22 @@ extern "C" {
         uint16_t service_len,
         BACNET_ADDRESS * src);
 
+    BACNET_STACK_EXPORT
+    void handler_who_is_deferred(
+        uint8_t * service_request,
+        uint16_t service_len,
+        BACNET_ADDRESS * src);
+    BACNET_STACK_EXPORT
+    void handler_who_is_timer(
+        uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    void handler_who_is_reply_window_set(
+        uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    uint16_t handler_who_is_reply_window(void);
+    BACNET_STACK_EXPORT
+    bool handler_who_is_reply_pending(void);
+
     BACNET_STACK_EXPORT
     void handler_who_is_unicast(
         uint8_t * service_request,
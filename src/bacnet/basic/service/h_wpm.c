@@ -48,12 +48,64 @@
 /** @file h_wpm.c  Handles Write Property Multiple requests. */
 #define PRINTF debug_perror
 
+/* number of decoded property writes kept from one request, so that
+   the request is decoded once.  Requests with more writes are decoded
+   a second time to write the properties. */
+#ifndef BACNET_WPM_WRITES_MAX
+#define BACNET_WPM_WRITES_MAX 32
+#endif
+
+/* a decoded property write of a request */
+struct wpm_write_record {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    BACNET_ARRAY_INDEX array_index;
+    uint8_t priority;
+    /* the encoded value, in WPM_Value */
+    uint16_t value_offset;
+    uint16_t value_len;
+};
+static struct wpm_write_record WPM_Write[BACNET_WPM_WRITES_MAX];
+/* the encoded values of the decoded property writes */
+static uint8_t WPM_Value[MAX_APDU];
+
+/**
+ * @brief Write one property with the device object, and convert the
+ *  error of a failed write for the WritePropertyMultiple-Error
+ * @param wp_data [in,out] The BACNET_WRITE_PROPERTY_DATA structure.
+ * @param device_write_property - Device object WriteProperty function
+ * @return true if the property was written
+ */
+static bool write_property_multiple_write(BACNET_WRITE_PROPERTY_DATA *wp_data,
+    write_property_function device_write_property)
+{
+    if (device_write_property(wp_data) == false) {
+        /* Workaround BTL Specified Test 9.23.2.X5 */
+        if ((wp_data->error_class == ERROR_CLASS_PROPERTY) &&
+            (wp_data->error_code == ERROR_CODE_INVALID_DATA_TYPE)) {
+            wp_data->error_class = ERROR_CLASS_SERVICES;
+            wp_data->error_code = ERROR_CODE_INVALID_TAG;
+        }
+        return false;
+    }
+
+    return true;
+}
+
 /** Decoding for an object property.
+ *
+ * The request is either decoded into the list of decoded property
+ * writes, or decoded and written with device_write_property.
  *
  * @param apdu [in] The contents of the APDU buffer.
  * @param apdu_len [in] The length of the APDU buffer.
  * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure.
  * @param device_write_property - Device object WriteProperty function
+ * @param count [out] number of decoded property writes that were kept,
+ *  or NULL to write each property as it is decoded
+ * @param indexed [out] false if some decoded property writes did not fit
+ *  in the list, when count is not NULL
  *
  * @return number of bytes decoded, or BACNET_STATUS_REJECT,
  *  or BACNET_STATUS_ERROR
@@ -61,11 +113,20 @@
 static int write_property_multiple_decode(uint8_t *apdu,
     uint16_t apdu_len,
     BACNET_WRITE_PROPERTY_DATA *wp_data,
-    write_property_function device_write_property)
+    write_property_function device_write_property,
+    unsigned *count,
+    bool *indexed)
 {
     int len = 0;
     int offset = 0;
     uint8_t tag_number = 0;
+    struct wpm_write_record *record;
+    uint16_t value_len = 0;
+
+    if (count) {
+        *count = 0;
+        *indexed = true;
+    }
 
     /* decode service request */
     do {
@@ -91,19 +152,33 @@ static int write_property_multiple_decode(uint8_t *apdu,
                             (unsigned long)wp_data->object_property,
                             (unsigned long)wp_data->priority,
                             (long)wp_data->array_index);
-                        if (device_write_property) {
-                            if (device_write_property(wp_data) == false) {
-                                /* Workaround BTL Specified Test 9.23.2.X5 */
-                                if ((wp_data->error_class ==
-                                        ERROR_CLASS_PROPERTY) &&
-                                    (wp_data->error_code ==
-                                        ERROR_CODE_INVALID_DATA_TYPE)) {
-                                    wp_data->error_class = ERROR_CLASS_SERVICES;
-                                    wp_data->error_code =
-                                        ERROR_CODE_INVALID_TAG;
-                                }
-                                return BACNET_STATUS_ERROR;
+                        if (count) {
+                            /* keep the write, while there is room */
+                            if ((*count < BACNET_WPM_WRITES_MAX) &&
+                                (wp_data->application_data_len <=
+                                    (int)(sizeof(WPM_Value) - value_len))) {
+                                record = &WPM_Write[*count];
+                                record->object_type = wp_data->object_type;
+                                record->object_instance =
+                                    wp_data->object_instance;
+                                record->object_property =
+                                    wp_data->object_property;
+                                record->array_index = wp_data->array_index;
+                                record->priority = wp_data->priority;
+                                record->value_offset = value_len;
+                                record->value_len =
+                                    (uint16_t)wp_data->application_data_len;
+                                memcpy(&WPM_Value[value_len],
+                                    wp_data->application_data,
+                                    record->value_len);
+                                value_len += record->value_len;
+                                (*count)++;
+                            } else {
+                                *indexed = false;
                             }
+                        } else if (!write_property_multiple_write(
+                                       wp_data, device_write_property)) {
+                            return BACNET_STATUS_ERROR;
                         }
                     } else {
                         PRINTF("WPM: Bad Encoding!\n");
@@ -129,6 +204,40 @@ static int write_property_multiple_decode(uint8_t *apdu,
     return len;
 }
 
+/**
+ * @brief Write the properties of the decoded property writes, in order,
+ *  stopping at the first write that fails
+ * @param count [in] number of decoded property writes
+ * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure, with the
+ *  first failed write and its error
+ * @param device_write_property - Device object WriteProperty function
+ * @return BACNET_STATUS_OK, or BACNET_STATUS_ERROR
+ */
+static int write_property_multiple_apply(unsigned count,
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    write_property_function device_write_property)
+{
+    struct wpm_write_record *record;
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        record = &WPM_Write[i];
+        wp_data->object_type = record->object_type;
+        wp_data->object_instance = record->object_instance;
+        wp_data->object_property = record->object_property;
+        wp_data->array_index = record->array_index;
+        wp_data->priority = record->priority;
+        memcpy(wp_data->application_data, &WPM_Value[record->value_offset],
+            record->value_len);
+        wp_data->application_data_len = record->value_len;
+        if (!write_property_multiple_write(wp_data, device_write_property)) {
+            return BACNET_STATUS_ERROR;
+        }
+    }
+
+    return BACNET_STATUS_OK;
+}
+
 /** Handler for a WriteProperty Service request.
  * @ingroup DSWP
  * This handler will be invoked by apdu_handler() if it has been enabled
@@ -159,18 +268,28 @@ void handler_write_property_multiple(uint8_t *service_request,
     BACNET_NPDU_DATA npdu_data;
     BACNET_ADDRESS my_address;
     int bytes_sent = 0;
+    unsigned count = 0;
+    bool indexed = false;
+    int status = 0;
 
     if (service_data->segmented_message) {
         wp_data.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         len = BACNET_STATUS_ABORT;
         PRINTF("WPM: Segmented message.  Sending Abort!\n");
     } else {
-        /* first time - detect malformed request before writing any data */
-        len = write_property_multiple_decode(
-            service_request, service_len, &wp_data, NULL);
-        if (len > 0) {
-            len = write_property_multiple_decode(
-                service_request, service_len, &wp_data, Device_Write_Property);
+        /* detect malformed request before writing any data */
+        len = write_property_multiple_decode(service_request, service_len,
+            &wp_data, NULL, &count, &indexed);
+        if ((len > 0) && indexed) {
+            status = write_property_multiple_apply(
+                count, &wp_data, Device_Write_Property);
+            if (status != BACNET_STATUS_OK) {
+                len = status;
+            }
+        } else if (len > 0) {
+            /* too many writes to keep - decode them again to write */
+            len = write_property_multiple_decode(service_request, service_len,
+                &wp_data, Device_Write_Property, NULL, NULL);
         }
     }
     /* encode the confirmed reply */
@@ -204,6 +323,7 @@ void handler_write_property_multiple(uint8_t *service_request,
     pdu_len = npdu_len + apdu_len;
     bytes_sent = datalink_send_pdu(
         src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    bacnet_apdu_stats_reply(&Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent <= 0) {
         PRINTF("Failed to send PDU (%s)!\n", strerror(errno));
     }
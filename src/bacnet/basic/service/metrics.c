@@ -0,0 +1,496 @@
+/**
+ * @file
+ * @brief A snapshot of the counters of the stack, published by the stack
+ *  thread with a sequence counter so that a reader in another thread,
+ *  such as a metrics endpoint, never blocks the stack, and serialized in
+ *  the Prometheus text exposition format.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bactext.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/basic/service/metrics.h"
+
+/* orders the copy of the snapshot with the sequence counter */
+#if defined(__GNUC__)
+#define METRICS_BARRIER() __sync_synchronize()
+#else
+#define METRICS_BARRIER() ((void)0)
+#endif
+
+/* the published snapshot, which is being written while the sequence
+   is odd, and has never been written while it is zero */
+static BACNET_METRICS_SNAPSHOT Metrics_Published;
+static volatile uint32_t Metrics_Sequence;
+
+/* the text being written, which is truncated when it does not fit */
+struct metrics_text {
+    char *buffer;
+    size_t size;
+    size_t length;
+    bool overflow;
+};
+
+/**
+ * @brief Copy the counters of the stack into a snapshot. Call this from
+ *  the stack thread.
+ * @param snapshot - the counters are copied here
+ * @param uptime - seconds since the stack was started
+ */
+void bacnet_metrics_snapshot(BACNET_METRICS_SNAPSHOT *snapshot,
+    uint32_t uptime)
+{
+    unsigned i;
+
+    if (!snapshot) {
+        return;
+    }
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->uptime = uptime;
+#if BACNET_APDU_STATS
+    for (i = 0; i < MAX_BACNET_CONFIRMED_SERVICE; i++) {
+        bacnet_apdu_stats_confirmed(
+            (BACNET_CONFIRMED_SERVICE)i, &snapshot->confirmed[i]);
+    }
+    for (i = 0; i < MAX_BACNET_UNCONFIRMED_SERVICE; i++) {
+        bacnet_apdu_stats_unconfirmed(
+            (BACNET_UNCONFIRMED_SERVICE)i, &snapshot->unconfirmed[i]);
+    }
+    bacnet_npdu_stats(&snapshot->npdu);
+#endif
+#if BACNET_DATALINK_STATS
+    for (i = 0; i < BACNET_METRICS_PORT_TYPES; i++) {
+        datalink_stats((BACNET_PORT_TYPE)i, &snapshot->datalink[i]);
+    }
+#endif
+#if BACNET_MEMSTATS
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        bacnet_memstats((BACNET_MEMSTATS_SUBSYSTEM)i, &snapshot->memory[i]);
+    }
+#endif
+#if (MAX_TSM_TRANSACTIONS)
+    snapshot->tsm_idle = tsm_transaction_idle_count();
+#endif
+    (void)i;
+}
+
+/**
+ * @brief Publish a snapshot of the counters for the readers. Call this
+ *  from the stack thread, such as once a second.
+ * @param uptime - seconds since the stack was started
+ */
+void bacnet_metrics_publish(uint32_t uptime)
+{
+    Metrics_Sequence++;
+    if (Metrics_Sequence == 0) {
+        /* zero is never published */
+        Metrics_Sequence++;
+    }
+    METRICS_BARRIER();
+    bacnet_metrics_snapshot(&Metrics_Published, uptime);
+    METRICS_BARRIER();
+    Metrics_Sequence++;
+}
+
+/**
+ * @brief Read the published snapshot, from any thread. The copy is tried
+ *  again when it was being published at the same time.
+ * @param snapshot - the published snapshot is copied here
+ * @return true if a whole snapshot was copied, or false if none was
+ *  published yet or it was being published each time
+ */
+bool bacnet_metrics_read(BACNET_METRICS_SNAPSHOT *snapshot)
+{
+    uint32_t sequence;
+    unsigned tries;
+
+    if (!snapshot) {
+        return false;
+    }
+    for (tries = 0; tries < BACNET_METRICS_READ_TRIES; tries++) {
+        sequence = Metrics_Sequence;
+        if (sequence == 0) {
+            return false;
+        }
+        if (sequence & 1) {
+            continue;
+        }
+        METRICS_BARRIER();
+        memcpy(snapshot, &Metrics_Published, sizeof(*snapshot));
+        METRICS_BARRIER();
+        if (sequence == Metrics_Sequence) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Append formatted text
+ * @param text - the text being written
+ * @param format - printf format of the text to append
+ */
+static void metrics_printf(struct metrics_text *text, const char *format, ...)
+{
+    va_list ap;
+    int len;
+
+    if (text->overflow) {
+        return;
+    }
+    va_start(ap, format);
+    len = vsnprintf(&text->buffer[text->length], text->size - text->length,
+        format, ap);
+    va_end(ap);
+    if ((len < 0) || ((size_t)len >= (text->size - text->length))) {
+        text->overflow = true;
+    } else {
+        text->length += (size_t)len;
+    }
+}
+
+/**
+ * @brief Append the HELP and TYPE lines of a metric family
+ * @param text - the text being written
+ * @param name - name of the metric
+ * @param type - counter, gauge, or histogram
+ * @param help - description of the metric
+ */
+static void metrics_family(struct metrics_text *text,
+    const char *name,
+    const char *type,
+    const char *help)
+{
+    metrics_printf(text, "# HELP %s %s\n# TYPE %s %s\n", name, help, name,
+        type);
+}
+
+#if BACNET_APDU_STATS || BACNET_DATALINK_STATS
+/**
+ * @brief Get a counter of a struct of counters
+ * @param stats - the struct of counters
+ * @param offset - the offset of the uint32_t counter in the struct
+ * @return the value of the counter
+ */
+static unsigned long metrics_counter(const void *stats, size_t offset)
+{
+    uint32_t value;
+
+    memcpy(&value, (const uint8_t *)stats + offset, sizeof(value));
+
+    return (unsigned long)value;
+}
+#endif
+
+#if BACNET_APDU_STATS
+/* the counters of a service, as metrics */
+static const struct metrics_service_counter {
+    const char *name;
+    const char *help;
+    size_t offset;
+} Metrics_Service_Counters[] = {
+    { "bacnet_service_requests_total",
+        "Requests given to the service handler.",
+        offsetof(BACNET_APDU_SERVICE_STATS, requests) },
+    { "bacnet_service_request_octets_total", "APDU octets of the requests.",
+        offsetof(BACNET_APDU_SERVICE_STATS, octets_in) },
+    { "bacnet_service_replies_total", "Replies sent by the service handler.",
+        offsetof(BACNET_APDU_SERVICE_STATS, replies) },
+    { "bacnet_service_reply_octets_total", "APDU octets of the replies.",
+        offsetof(BACNET_APDU_SERVICE_STATS, octets_out) },
+    { "bacnet_service_errors_total", "Replies that were an Error.",
+        offsetof(BACNET_APDU_SERVICE_STATS, errors) },
+    { "bacnet_service_rejects_total", "Replies that were a Reject.",
+        offsetof(BACNET_APDU_SERVICE_STATS, rejects) },
+    { "bacnet_service_aborts_total", "Replies that were an Abort.",
+        offsetof(BACNET_APDU_SERVICE_STATS, aborts) },
+};
+
+/**
+ * @brief Get the counters and the name of a service of the snapshot
+ * @param snapshot - the snapshot
+ * @param index - the confirmed services, then the unconfirmed services
+ * @param name - the name of the service is returned here
+ * @return the counters of the service, or NULL if it was not requested
+ */
+static const BACNET_APDU_SERVICE_STATS *metrics_service(
+    const BACNET_METRICS_SNAPSHOT *snapshot, unsigned index, const char **name)
+{
+    const BACNET_APDU_SERVICE_STATS *stats;
+
+    if (index < MAX_BACNET_CONFIRMED_SERVICE) {
+        stats = &snapshot->confirmed[index];
+        *name = bactext_confirmed_service_name(index);
+    } else {
+        index -= MAX_BACNET_CONFIRMED_SERVICE;
+        stats = &snapshot->unconfirmed[index];
+        *name = bactext_unconfirmed_service_name(index);
+    }
+    if (stats->requests == 0) {
+        return NULL;
+    }
+
+    return stats;
+}
+
+/**
+ * @brief Append the metrics of the services that were requested, with
+ *  the handling time as a histogram in milliseconds
+ * @param text - the text being written
+ * @param snapshot - the snapshot
+ */
+static void metrics_services(
+    struct metrics_text *text, const BACNET_METRICS_SNAPSHOT *snapshot)
+{
+    const unsigned services =
+        MAX_BACNET_CONFIRMED_SERVICE + MAX_BACNET_UNCONFIRMED_SERVICE;
+    const BACNET_APDU_SERVICE_STATS *stats;
+    const char *name = NULL;
+    unsigned i, s, bin;
+    uint32_t count;
+
+    for (i = 0; i < ARRAY_SIZE(Metrics_Service_Counters); i++) {
+        metrics_family(text, Metrics_Service_Counters[i].name, "counter",
+            Metrics_Service_Counters[i].help);
+        for (s = 0; s < services; s++) {
+            stats = metrics_service(snapshot, s, &name);
+            if (stats) {
+                metrics_printf(text, "%s{service=\"%s\"} %lu\n",
+                    Metrics_Service_Counters[i].name, name,
+                    metrics_counter(
+                        stats, Metrics_Service_Counters[i].offset));
+            }
+        }
+    }
+    metrics_family(text, "bacnet_service_latency_milliseconds", "histogram",
+        "Handling time of the requests.");
+    for (s = 0; s < services; s++) {
+        stats = metrics_service(snapshot, s, &name);
+        if (!stats) {
+            continue;
+        }
+        count = 0;
+        for (bin = 0; bin < (BACNET_APDU_STATS_LATENCY_BINS - 1); bin++) {
+            /* bin N counts the times below 2^N milliseconds */
+            count += stats->latency_bins[bin];
+            metrics_printf(text,
+                "bacnet_service_latency_milliseconds_bucket"
+                "{service=\"%s\",le=\"%lu\"} %lu\n",
+                name, (1UL << bin) - 1UL, (unsigned long)count);
+        }
+        metrics_printf(text,
+            "bacnet_service_latency_milliseconds_bucket"
+            "{service=\"%s\",le=\"+Inf\"} %lu\n",
+            name, (unsigned long)stats->requests);
+        metrics_printf(text,
+            "bacnet_service_latency_milliseconds_sum{service=\"%s\"} %lu\n",
+            name, (unsigned long)stats->latency_total);
+        metrics_printf(text,
+            "bacnet_service_latency_milliseconds_count{service=\"%s\"} %lu\n",
+            name, (unsigned long)stats->requests);
+    }
+    metrics_family(text, "bacnet_npdu_received_total", "counter",
+        "Messages given to the network layer.");
+    metrics_printf(text, "bacnet_npdu_received_total %lu\n",
+        (unsigned long)snapshot->npdu.received);
+    metrics_family(text, "bacnet_npdu_received_octets_total", "counter",
+        "Octets of the messages given to the network layer.");
+    metrics_printf(text, "bacnet_npdu_received_octets_total %lu\n",
+        (unsigned long)snapshot->npdu.octets_in);
+    metrics_family(text, "bacnet_npdu_network_messages_total", "counter",
+        "Network layer messages.");
+    metrics_printf(text, "bacnet_npdu_network_messages_total %lu\n",
+        (unsigned long)snapshot->npdu.network_messages);
+    metrics_family(text, "bacnet_npdu_discarded_total", "counter",
+        "Messages that were not for this device, or not understood.");
+    metrics_printf(text, "bacnet_npdu_discarded_total %lu\n",
+        (unsigned long)snapshot->npdu.discarded);
+}
+#endif
+
+#if BACNET_DATALINK_STATS
+/* the label of each port type */
+static const char *Metrics_Port_Names[BACNET_METRICS_PORT_TYPES] = {
+    "ethernet", "arcnet", "mstp", "ptp", "lontalk", "bip", "zigbee",
+    "virtual", "non-bacnet", "bip6", "serial", "bsc"
+};
+
+/* the counters of a datalink, as metrics */
+static const struct metrics_datalink_counter {
+    const char *name;
+    const char *help;
+    size_t offset;
+} Metrics_Datalink_Counters[] = {
+    { "bacnet_datalink_rx_packets_total", "Packets received.",
+        offsetof(BACNET_DATALINK_PORT_STATS, rx_packets) },
+    { "bacnet_datalink_rx_octets_total", "Octets of the packets received.",
+        offsetof(BACNET_DATALINK_PORT_STATS, rx_octets) },
+    { "bacnet_datalink_tx_packets_total", "Packets sent.",
+        offsetof(BACNET_DATALINK_PORT_STATS, tx_packets) },
+    { "bacnet_datalink_tx_octets_total", "Octets of the packets sent.",
+        offsetof(BACNET_DATALINK_PORT_STATS, tx_octets) },
+    { "bacnet_datalink_rx_dropped_total", "Received packets that were dropped.",
+        offsetof(BACNET_DATALINK_PORT_STATS, rx_dropped) },
+    { "bacnet_datalink_tx_dropped_total", "Packets that could not be sent.",
+        offsetof(BACNET_DATALINK_PORT_STATS, tx_dropped) },
+    { "bacnet_datalink_crc_errors_total", "Frames received with a bad CRC.",
+        offsetof(BACNET_DATALINK_PORT_STATS, crc_errors) },
+    { "bacnet_datalink_oversize_frames_total",
+        "Frames longer than the receive buffer.",
+        offsetof(BACNET_DATALINK_PORT_STATS, oversize_frames) },
+    { "bacnet_datalink_bvlc_naks_total", "BVLC-Result NAKs.",
+        offsetof(BACNET_DATALINK_PORT_STATS, bvlc_naks) },
+};
+
+/**
+ * @brief Append the metrics of the datalinks that were used
+ * @param text - the text being written
+ * @param snapshot - the snapshot
+ */
+static void metrics_datalinks(
+    struct metrics_text *text, const BACNET_METRICS_SNAPSHOT *snapshot)
+{
+    const BACNET_DATALINK_PORT_STATS *stats;
+    unsigned i, port;
+
+    for (i = 0; i < ARRAY_SIZE(Metrics_Datalink_Counters); i++) {
+        metrics_family(text, Metrics_Datalink_Counters[i].name, "counter",
+            Metrics_Datalink_Counters[i].help);
+        for (port = 0; port < BACNET_METRICS_PORT_TYPES; port++) {
+            stats = &snapshot->datalink[port];
+            if ((stats->rx_packets == 0) && (stats->tx_packets == 0)) {
+                continue;
+            }
+            metrics_printf(text, "%s{port=\"%s\"} %lu\n",
+                Metrics_Datalink_Counters[i].name, Metrics_Port_Names[port],
+                metrics_counter(stats, Metrics_Datalink_Counters[i].offset));
+        }
+    }
+}
+#endif
+
+#if BACNET_MEMSTATS
+/* the label of each subsystem */
+static const char *Metrics_Subsystem_Names[MEMSTATS_SUBSYSTEM_MAX] = {
+    "keylist", "object", "cov", "address", "tsm", "trend-log"
+};
+
+/**
+ * @brief Append the metrics of the memory of the subsystems
+ * @param text - the text being written
+ * @param snapshot - the snapshot
+ */
+static void metrics_memory(
+    struct metrics_text *text, const BACNET_METRICS_SNAPSHOT *snapshot)
+{
+    unsigned i;
+
+    metrics_family(text, "bacnet_memory_bytes", "gauge",
+        "Bytes allocated now.");
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        metrics_printf(text, "bacnet_memory_bytes{subsystem=\"%s\"} %lu\n",
+            Metrics_Subsystem_Names[i],
+            (unsigned long)snapshot->memory[i].current_bytes);
+    }
+    metrics_family(text, "bacnet_memory_peak_bytes", "gauge",
+        "The most bytes that were allocated at once.");
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        metrics_printf(text,
+            "bacnet_memory_peak_bytes{subsystem=\"%s\"} %lu\n",
+            Metrics_Subsystem_Names[i],
+            (unsigned long)snapshot->memory[i].peak_bytes);
+    }
+    metrics_family(text, "bacnet_memory_static_bytes", "gauge",
+        "Bytes of the tables that are sized at compile time.");
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        metrics_printf(text,
+            "bacnet_memory_static_bytes{subsystem=\"%s\"} %lu\n",
+            Metrics_Subsystem_Names[i],
+            (unsigned long)snapshot->memory[i].static_bytes);
+    }
+    metrics_family(text, "bacnet_memory_allocations_total", "counter",
+        "Allocations.");
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        metrics_printf(text,
+            "bacnet_memory_allocations_total{subsystem=\"%s\"} %lu\n",
+            Metrics_Subsystem_Names[i],
+            (unsigned long)snapshot->memory[i].allocations);
+    }
+    metrics_family(text, "bacnet_memory_frees_total", "counter", "Frees.");
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        metrics_printf(text,
+            "bacnet_memory_frees_total{subsystem=\"%s\"} %lu\n",
+            Metrics_Subsystem_Names[i],
+            (unsigned long)snapshot->memory[i].frees);
+    }
+    metrics_family(text, "bacnet_memory_failures_total", "counter",
+        "Allocations that failed.");
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        metrics_printf(text,
+            "bacnet_memory_failures_total{subsystem=\"%s\"} %lu\n",
+            Metrics_Subsystem_Names[i],
+            (unsigned long)snapshot->memory[i].failures);
+    }
+}
+#endif
+
+/**
+ * @brief Serialize the counters of a snapshot in the Prometheus text
+ *  exposition format. Only the counters that are compiled in are
+ *  serialized, and only the services and datalinks that were used.
+ * @param snapshot - the snapshot
+ * @param buffer - the text is written here, terminated with a NUL
+ * @param size - the size of the buffer
+ * @return the length of the text, or -1 if it does not fit the buffer
+ */
+int bacnet_metrics_text(
+    const BACNET_METRICS_SNAPSHOT *snapshot, char *buffer, size_t size)
+{
+    struct metrics_text text = { 0 };
+
+    if (!snapshot || !buffer || (size == 0)) {
+        return -1;
+    }
+    text.buffer = buffer;
+    text.size = size;
+    text.buffer[0] = 0;
+    metrics_family(&text, "bacnet_uptime_seconds", "counter",
+        "Seconds since the stack was started.");
+    metrics_printf(&text, "bacnet_uptime_seconds %lu\n",
+        (unsigned long)snapshot->uptime);
+#if BACNET_APDU_STATS
+    metrics_services(&text, snapshot);
+#endif
+#if BACNET_DATALINK_STATS
+    metrics_datalinks(&text, snapshot);
+#endif
+#if BACNET_MEMSTATS
+    metrics_memory(&text, snapshot);
+#endif
+#if (MAX_TSM_TRANSACTIONS)
+    metrics_family(&text, "bacnet_tsm_transactions", "gauge",
+        "Transactions of the TSM.");
+    metrics_printf(&text, "bacnet_tsm_transactions %u\n",
+        (unsigned)MAX_TSM_TRANSACTIONS);
+    metrics_family(&text, "bacnet_tsm_idle_transactions", "gauge",
+        "Transactions of the TSM that are free.");
+    metrics_printf(&text, "bacnet_tsm_idle_transactions %u\n",
+        snapshot->tsm_idle);
+#endif
+    if (text.overflow) {
+        buffer[0] = 0;
+        return -1;
+    }
+
+    return (int)text.length;
+}
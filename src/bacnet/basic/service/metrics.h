@@ -0,0 +1,69 @@
+/**
+ * @file
+ * @brief API for a snapshot of the counters of the stack, the service,
+ *  datalink, memory and transaction counters, and its serialization in
+ *  the Prometheus text exposition format. The stack thread publishes the
+ *  snapshot, and any other thread reads it without a lock.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_SERVICE_METRICS_H
+#define BACNET_BASIC_SERVICE_METRICS_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/datalink/dlstats.h"
+#include "bacnet/basic/service/h_apdu_stats.h"
+#include "bacnet/basic/sys/memstats.h"
+
+/* the port types whose datalink counters are in the snapshot */
+#define BACNET_METRICS_PORT_TYPES (PORT_TYPE_BSC + 1)
+
+/* the times a reader copies the snapshot while it is being published,
+   before it gives up */
+#ifndef BACNET_METRICS_READ_TRIES
+#define BACNET_METRICS_READ_TRIES 8
+#endif
+
+/* a copy of the counters of the stack at one time */
+typedef struct bacnet_metrics_snapshot {
+    /* seconds since the first snapshot */
+    uint32_t uptime;
+#if BACNET_APDU_STATS
+    BACNET_APDU_SERVICE_STATS confirmed[MAX_BACNET_CONFIRMED_SERVICE];
+    BACNET_APDU_SERVICE_STATS unconfirmed[MAX_BACNET_UNCONFIRMED_SERVICE];
+    BACNET_NPDU_STATS npdu;
+#endif
+#if BACNET_DATALINK_STATS
+    BACNET_DATALINK_PORT_STATS datalink[BACNET_METRICS_PORT_TYPES];
+#endif
+#if BACNET_MEMSTATS
+    BACNET_MEMORY_STATS memory[MEMSTATS_SUBSYSTEM_MAX];
+#endif
+    /* transactions of the TSM that are free */
+    unsigned tsm_idle;
+} BACNET_METRICS_SNAPSHOT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_metrics_snapshot(BACNET_METRICS_SNAPSHOT *snapshot,
+    uint32_t uptime);
+BACNET_STACK_EXPORT
+void bacnet_metrics_publish(uint32_t uptime);
+BACNET_STACK_EXPORT
+bool bacnet_metrics_read(BACNET_METRICS_SNAPSHOT *snapshot);
+BACNET_STACK_EXPORT
+int bacnet_metrics_text(
+    const BACNET_METRICS_SNAPSHOT *snapshot, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -43,6 +43,76 @@
 
 /** @file s_iam.c  Send an I-Am message. */
 
+#if BACNET_SEGMENTATION_ENABLED
+#define IAM_SEGMENTATION_SUPPORTED Device_Segmentation_Supported()
+#else
+#define IAM_SEGMENTATION_SUPPORTED SEGMENTATION_NONE
+#endif
+
+/* number of devices that keep their encoded I-Am, such as the virtual
+   devices of a gateway, or 0 to encode each I-Am */
+#ifndef BACNET_IAM_CACHE_SIZE
+#define BACNET_IAM_CACHE_SIZE MAX_NUM_DEVICES
+#endif
+
+#if BACNET_IAM_CACHE_SIZE
+/* the longest I-Am APDU, with a 32-bit max APDU and vendor ID */
+#define IAM_APDU_MAX 20
+
+/* the encoded I-Am of one device, and the values it was encoded from */
+struct iam_cache_entry {
+    uint32_t device_id;
+    unsigned max_apdu;
+    int segmentation;
+    uint16_t vendor_id;
+    uint8_t apdu_len;
+    uint8_t apdu[IAM_APDU_MAX];
+};
+static struct iam_cache_entry IAM_Cache[BACNET_IAM_CACHE_SIZE];
+#endif
+
+/**
+ * @brief Encode an I-Am APDU, or copy it from the cache when the device
+ *  was last encoded with the same values, so that a change of the
+ *  instance number or vendor is encoded again
+ * @param apdu [out] the I-Am APDU
+ * @param device_id [in] Device Instance 0 - 4194303
+ * @param max_apdu [in] Max APDU 0-65535
+ * @param segmentation [in] #BACNET_SEGMENTATION enumeration
+ * @param vendor_id [in] BACnet vendor ID 0-65535
+ * @return number of octets of the APDU
+ */
+static int iam_cache_encode_apdu(uint8_t *apdu,
+    uint32_t device_id,
+    unsigned int max_apdu,
+    int segmentation,
+    uint16_t vendor_id)
+{
+#if BACNET_IAM_CACHE_SIZE
+    struct iam_cache_entry *entry;
+    int len;
+
+    entry = &IAM_Cache[device_id % BACNET_IAM_CACHE_SIZE];
+    if ((entry->apdu_len == 0) || (entry->device_id != device_id) ||
+        (entry->max_apdu != max_apdu) ||
+        (entry->segmentation != segmentation) ||
+        (entry->vendor_id != vendor_id)) {
+        len = iam_encode_apdu(
+            entry->apdu, device_id, max_apdu, segmentation, vendor_id);
+        entry->device_id = device_id;
+        entry->max_apdu = max_apdu;
+        entry->segmentation = segmentation;
+        entry->vendor_id = vendor_id;
+        entry->apdu_len = (uint8_t)len;
+    }
+    memcpy(apdu, entry->apdu, entry->apdu_len);
+
+    return entry->apdu_len;
+#else
+    return iam_encode_apdu(apdu, device_id, max_apdu, segmentation, vendor_id);
+#endif
+}
+
 /** Send a I-Am request to a remote network for a specific device.
  * @param target_address [in] BACnet address of target router
  * @param device_id [in] Device Instance 0 - 4194303
@@ -69,8 +139,7 @@ void Send_I_Am_To_Network(BACNET_ADDRESS *target_address,
     pdu_len = npdu_encode_pdu(
         &Handler_Transmit_Buffer[0], target_address, &my_address, &npdu_data);
     /* encode the APDU portion of the packet */
-    /* encode the APDU portion of the packet */
-    len = iam_encode_apdu(&Handler_Transmit_Buffer[pdu_len], device_id,
+    len = iam_cache_encode_apdu(&Handler_Transmit_Buffer[pdu_len], device_id,
         max_apdu, segmentation, vendor_id);
     pdu_len += len;
     bytes_sent = datalink_send_pdu(
@@ -102,8 +171,9 @@ int iam_encode_pdu(
     pdu_len = npdu_encode_pdu(&buffer[0], dest, &my_address, npdu_data);
 
     /* encode the APDU portion of the packet */
-    len = iam_encode_apdu(&buffer[pdu_len], Device_Object_Instance_Number(),
-        MAX_APDU, SEGMENTATION_NONE, Device_Vendor_Identifier());
+    len = iam_cache_encode_apdu(&buffer[pdu_len],
+        Device_Object_Instance_Number(), MAX_APDU, IAM_SEGMENTATION_SUPPORTED,
+        Device_Vendor_Identifier());
     pdu_len += len;
 
     return pdu_len;
@@ -172,9 +242,9 @@ int iam_unicast_encode_pdu(uint8_t *buffer,
     npdu_encode_npdu_data(npdu_data, false, MESSAGE_PRIORITY_NORMAL);
     npdu_len = npdu_encode_pdu(&buffer[0], dest, &my_address, npdu_data);
     /* encode the APDU portion of the packet */
-    apdu_len =
-        iam_encode_apdu(&buffer[npdu_len], Device_Object_Instance_Number(),
-            MAX_APDU, SEGMENTATION_NONE, Device_Vendor_Identifier());
+    apdu_len = iam_cache_encode_apdu(&buffer[npdu_len],
+        Device_Object_Instance_Number(), MAX_APDU, IAM_SEGMENTATION_SUPPORTED,
+        Device_Vendor_Identifier());
     pdu_len = npdu_len + apdu_len;
 
     return pdu_len;
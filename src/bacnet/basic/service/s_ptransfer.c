@@ -0,0 +1,293 @@
+/**
+ * @file
+ * @brief Send a BACnet ConfirmedPrivateTransfer-Request, and send a large
+ *  block of data as a stream of requests with a window of outstanding
+ *  requests, which the receiver reassembles in any order.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/npdu.h"
+#include "bacnet/apdu.h"
+#include "bacnet/dcc.h"
+#include "bacnet/ptransfer.h"
+/* some demo stuff needed */
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/datalink/datalink.h"
+
+/* the serviceParameters of the block that is sent */
+static uint8_t Stream_Block_Buffer[MAX_APDU];
+
+/**
+ * @brief Send a ConfirmedPrivateTransfer-Request
+ * @param device_id - ID of the destination device
+ * @param private_data - vendor, service number and serviceParameters
+ * @return invoke id of outgoing message, or 0 on failure.
+ */
+uint8_t Send_ConfirmedPrivateTransfer(
+    uint32_t device_id, BACNET_PRIVATE_TRANSFER_DATA *private_data)
+{
+    BACNET_ADDRESS dest;
+    BACNET_ADDRESS my_address;
+    unsigned max_apdu = 0;
+    uint8_t invoke_id = 0;
+    bool status = false;
+    int len = 0;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+    BACNET_NPDU_DATA npdu_data;
+
+    if (!dcc_communication_enabled()) {
+        return 0;
+    }
+    /* the request header is at most 14 bytes */
+    if ((private_data->serviceParametersLen < 0) ||
+        (private_data->serviceParametersLen > (MAX_APDU - 14))) {
+        return 0;
+    }
+    /* is the device bound? */
+    status = address_get_by_device(device_id, &max_apdu, &dest);
+    /* is there a tsm available? */
+    if (status) {
+        invoke_id = tsm_next_free_invokeID();
+    }
+    if (invoke_id) {
+        /* encode the NPDU portion of the packet */
+        datalink_get_my_address(&my_address);
+        npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+        pdu_len = npdu_encode_pdu(
+            &Handler_Transmit_Buffer[0], &dest, &my_address, &npdu_data);
+        /* encode the APDU portion of the packet */
+        len = ptransfer_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], invoke_id, private_data);
+        pdu_len += len;
+        /* will it fit in the sender?
+           note: if there is a bottleneck router in between
+           us and the destination, we won't know unless
+           we have a way to check for that and update the
+           max_apdu in the address binding table. */
+        if ((unsigned)len <= max_apdu) {
+            tsm_set_confirmed_unsegmented_transaction(invoke_id, &dest,
+                &npdu_data, &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
+            bytes_sent = datalink_send_pdu(
+                &dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+            if (bytes_sent <= 0) {
+#if PRINT_ENABLED
+                fprintf(stderr,
+                    "Failed to Send ConfirmedPrivateTransfer Request (%s)!\n",
+                    strerror(errno));
+#endif
+            }
+        } else {
+            tsm_free_invoke_id(invoke_id);
+            invoke_id = 0;
+#if PRINT_ENABLED
+            fprintf(stderr,
+                "Failed to Send ConfirmedPrivateTransfer Request "
+                "(exceeds destination maximum APDU)!\n");
+#endif
+        }
+    }
+
+    return invoke_id;
+}
+
+/**
+ * @brief Initialize the send of a stream. The data is split into blocks
+ *  that fit in the maximum APDU of the device once it is bound.
+ * @param stream - the stream
+ * @param device_id - ID of the destination device
+ * @param vendor_id - vendor of the service
+ * @param service_number - service number of the requests
+ * @param data - the data to send, which is kept until the stream is done
+ * @param length - number of bytes of data
+ * @param window - number of requests that are outstanding at the same time
+ */
+void Send_Private_Transfer_Stream_Init(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream,
+    uint32_t device_id,
+    uint16_t vendor_id,
+    uint32_t service_number,
+    uint8_t *data,
+    uint32_t length,
+    uint8_t window)
+{
+    if (!stream) {
+        return;
+    }
+    memset(stream, 0, sizeof(BACNET_PRIVATE_TRANSFER_SEND_STREAM));
+    stream->device_id = device_id;
+    stream->vendor_id = vendor_id;
+    stream->service_number = service_number;
+    stream->data = data;
+    stream->length = length;
+    if (window == 0) {
+        window = 1;
+    } else if (window > PTRANSFER_STREAM_WINDOW_MAX) {
+        window = PTRANSFER_STREAM_WINDOW_MAX;
+    }
+    stream->window = window;
+}
+
+/**
+ * @brief Send one block of a stream
+ * @param stream - the stream
+ * @param block_number - the block to send
+ * @return invoke id of outgoing message, or 0 on failure.
+ */
+static uint8_t
+stream_block_send(BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream,
+    uint32_t block_number)
+{
+    BACNET_PRIVATE_TRANSFER_BLOCK block = { 0 };
+    BACNET_PRIVATE_TRANSFER_DATA private_data = { 0 };
+    uint32_t offset = block_number * stream->block_size;
+
+    block.stream_length = stream->length;
+    block.block_size = stream->block_size;
+    block.block_number = block_number;
+    block.data = &stream->data[offset];
+    if ((stream->length - offset) < stream->block_size) {
+        block.data_len = (uint16_t)(stream->length - offset);
+    } else {
+        block.data_len = stream->block_size;
+    }
+    private_data.vendorID = stream->vendor_id;
+    private_data.serviceNumber = stream->service_number;
+    private_data.serviceParameters = Stream_Block_Buffer;
+    private_data.serviceParametersLen =
+        ptransfer_block_encode(Stream_Block_Buffer, &block);
+
+    return Send_ConfirmedPrivateTransfer(stream->device_id, &private_data);
+}
+
+/**
+ * @brief Send the blocks of a stream while the window has room, and
+ *  detect the requests that completed without a result.
+ *  Call this periodically, such as from the main loop.
+ * @param stream - the stream
+ * @return true while the stream is in progress
+ */
+bool Send_Private_Transfer_Stream_Task(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream)
+{
+    BACNET_ADDRESS dest;
+    unsigned max_apdu = 0;
+    uint8_t invoke_id = 0;
+    unsigned i;
+
+    if (!stream || stream->failed) {
+        return false;
+    }
+    if (stream->block_size == 0) {
+        if (!address_get_by_device(stream->device_id, &max_apdu, &dest)) {
+            return true;
+        }
+        if (max_apdu > MAX_APDU) {
+            max_apdu = MAX_APDU;
+        }
+        stream->block_size = ptransfer_block_size(max_apdu);
+        if (stream->block_size == 0) {
+            stream->failed = true;
+            return false;
+        }
+        stream->block_count =
+            (stream->length + stream->block_size - 1) / stream->block_size;
+        if (stream->block_count > PTRANSFER_STREAM_BLOCKS_MAX) {
+            stream->failed = true;
+            return false;
+        }
+    }
+    for (i = 0; i < stream->window; i++) {
+        invoke_id = stream->invoke_id[i];
+        if (invoke_id == 0) {
+            continue;
+        }
+        if (tsm_invoke_id_failed(invoke_id)) {
+            /* the retries of the request are done */
+            tsm_free_invoke_id(invoke_id);
+            stream->failed = true;
+        } else if (tsm_invoke_id_free(invoke_id)) {
+            /* an abort or reject, without a result */
+            stream->failed = true;
+        }
+        if (stream->failed) {
+            return false;
+        }
+    }
+    for (i = 0; i < stream->window; i++) {
+        if (stream->next_block >= stream->block_count) {
+            break;
+        }
+        if (stream->invoke_id[i] != 0) {
+            continue;
+        }
+        invoke_id = stream_block_send(stream, stream->next_block);
+        if (invoke_id == 0) {
+            break;
+        }
+        stream->invoke_id[i] = invoke_id;
+        stream->block_number[i] = stream->next_block;
+        stream->next_block++;
+    }
+
+    return stream->blocks_acked < stream->block_count;
+}
+
+/**
+ * @brief Report the result of a request of a stream, from the
+ *  ConfirmedPrivateTransfer-ACK or Error handlers
+ * @param stream - the stream
+ * @param invoke_id - the invoke id of the result
+ * @param acknowledged - true for an ACK, false for an Error
+ * @return true if the invoke id belongs to the stream
+ */
+bool Send_Private_Transfer_Stream_Result(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream,
+    uint8_t invoke_id,
+    bool acknowledged)
+{
+    unsigned i;
+
+    if (!stream || (invoke_id == 0)) {
+        return false;
+    }
+    for (i = 0; i < stream->window; i++) {
+        if (stream->invoke_id[i] == invoke_id) {
+            stream->invoke_id[i] = 0;
+            if (acknowledged) {
+                stream->blocks_acked++;
+            } else {
+                stream->failed = true;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Determine if every block of a stream was acknowledged
+ * @param stream - the stream
+ * @return true if the stream is complete
+ */
+bool Send_Private_Transfer_Stream_Complete(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream)
+{
+    if (!stream || stream->failed || (stream->block_size == 0)) {
+        return false;
+    }
+
+    return stream->blocks_acked == stream->block_count;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief Header file for a basic ConfirmedPrivateTransfer service send,
+ *  and the send of a stream of blocks with a window of requests
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef SEND_CONFIRMED_PRIVATE_TRANSFER_H
+#define SEND_CONFIRMED_PRIVATE_TRANSFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/ptransfer.h"
+
+/* the requests of a stream that are outstanding at the same time */
+#ifndef PTRANSFER_STREAM_WINDOW_MAX
+#define PTRANSFER_STREAM_WINDOW_MAX 4
+#endif
+
+/**
+ * The send of a stream of data as blocks, where each block is one
+ * ConfirmedPrivateTransfer-Request
+ */
+typedef struct BACnet_Private_Transfer_Send_Stream {
+    uint32_t device_id;
+    uint16_t vendor_id;
+    uint32_t service_number;
+    uint8_t *data;
+    uint32_t length;
+    uint16_t block_size;
+    uint32_t block_count;
+    uint32_t next_block;
+    uint32_t blocks_acked;
+    uint8_t window;
+    uint8_t invoke_id[PTRANSFER_STREAM_WINDOW_MAX];
+    uint32_t block_number[PTRANSFER_STREAM_WINDOW_MAX];
+    bool failed;
+} BACNET_PRIVATE_TRANSFER_SEND_STREAM;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+uint8_t Send_ConfirmedPrivateTransfer(
+    uint32_t device_id, BACNET_PRIVATE_TRANSFER_DATA *private_data);
+
+BACNET_STACK_EXPORT
+void Send_Private_Transfer_Stream_Init(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream,
+    uint32_t device_id,
+    uint16_t vendor_id,
+    uint32_t service_number,
+    uint8_t *data,
+    uint32_t length,
+    uint8_t window);
+BACNET_STACK_EXPORT
+bool Send_Private_Transfer_Stream_Task(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream);
+BACNET_STACK_EXPORT
+bool Send_Private_Transfer_Stream_Result(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream,
+    uint8_t invoke_id,
+    bool acknowledged);
+BACNET_STACK_EXPORT
+bool Send_Private_Transfer_Stream_Complete(
+    BACNET_PRIVATE_TRANSFER_SEND_STREAM *stream);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -85,6 +85,10 @@ uint8_t Send_ReadRange_Request(uint32_t device_id, /* destination device */
             return 0;
         }
 
+#if BACNET_SEGMENTATION_ENABLED
+        /* accept a segmented reply when it can be reassembled */
+        tsm_segmented_response_accepted_encode(&Handler_Transmit_Buffer[pdu_len]);
+#endif
         pdu_len += len;
         /* is it small enough for the the destination to receive?
            note: if there is a bottleneck router in between
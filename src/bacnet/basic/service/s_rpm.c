@@ -92,6 +92,10 @@ uint8_t Send_Read_Property_Multiple_Request(uint8_t *pdu,
         if (len <= 0) {
             return 0;
         }
+#if BACNET_SEGMENTATION_ENABLED
+        /* accept a segmented reply when it can be reassembled */
+        tsm_segmented_response_accepted_encode(&pdu[pdu_len]);
+#endif
         pdu_len += len;
         /* is it small enough for the destination to receive?
            note: if there is a bottleneck router in between
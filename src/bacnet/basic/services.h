@@ -21,6 +21,7 @@
 /* application layer service handler */
 #include "bacnet/basic/service/h_alarm_ack.h"
 #include "bacnet/basic/service/h_apdu.h"
+#include "bacnet/basic/service/h_apdu_stats.h"
 #include "bacnet/basic/service/h_arf.h"
 #include "bacnet/basic/service/h_arf_a.h"
 #include "bacnet/basic/service/h_awf.h"
@@ -72,6 +73,7 @@
 #include "bacnet/basic/service/s_list_element.h"
 #include "bacnet/basic/service/s_lso.h"
 #include "bacnet/basic/service/s_rd.h"
+#include "bacnet/basic/service/s_ptransfer.h"
 #include "bacnet/basic/service/s_readrange.h"
 #include "bacnet/basic/service/s_rp.h"
 #include "bacnet/basic/service/s_rpm.h"
@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @brief An arena of memory, where the allocations are taken from a block
+ *  of memory one after another, and are all released at once.  This suits
+ *  the values decoded from one message, which are used together and then
+ *  dropped together, without the cost of an allocation and a free for each.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/arena.h"
+
+/* allocations are aligned for any of these types */
+union arena_align {
+    void *pointer;
+    double real;
+    uint64_t unsigned64;
+    long integer;
+};
+#define ARENA_ALIGNMENT sizeof(union arena_align)
+
+/**
+ * @brief Initialize an arena with a block of memory
+ * @param arena - arena to be initialized
+ * @param data - block of memory for the allocations
+ * @param size - size, in bytes, of the block of memory
+ */
+void arena_init(ARENA_BUFFER *arena, void *data, size_t size)
+{
+    if (arena) {
+        arena->data = data;
+        arena->size = data ? size : 0;
+        arena->count = 0;
+        arena->peak = 0;
+        arena->overflow = false;
+    }
+}
+
+/**
+ * @brief Allocate zeroed memory from an arena
+ * @param arena - arena to allocate from
+ * @param size - number of bytes to allocate
+ * @return the memory, or NULL if the arena does not have enough room
+ */
+void *arena_alloc(ARENA_BUFFER *arena, size_t size)
+{
+    size_t offset;
+    size_t padding;
+    void *data;
+
+    if (!arena || (size == 0)) {
+        return NULL;
+    }
+    if (!arena->data) {
+        arena->overflow = true;
+        return NULL;
+    }
+    offset = (size_t)((uintptr_t)&arena->data[arena->count] %
+        ARENA_ALIGNMENT);
+    padding = offset ? (ARENA_ALIGNMENT - offset) : 0;
+    if (((arena->size - arena->count) < padding) ||
+        ((arena->size - arena->count - padding) < size)) {
+        arena->overflow = true;
+        return NULL;
+    }
+    data = &arena->data[arena->count + padding];
+    arena->count += padding + size;
+    if (arena->count > arena->peak) {
+        arena->peak = arena->count;
+    }
+    memset(data, 0, size);
+
+    return data;
+}
+
+/**
+ * @brief Allocate a zeroed array from an arena, like calloc()
+ * @param arena - arena to allocate from
+ * @param nmemb - number of elements in the array
+ * @param size - size, in bytes, of each element
+ * @return the memory, or NULL if the arena does not have enough room
+ */
+void *arena_calloc(ARENA_BUFFER *arena, size_t nmemb, size_t size)
+{
+    if (arena && (size != 0) && (nmemb > (SIZE_MAX / size))) {
+        arena->overflow = true;
+        return NULL;
+    }
+
+    return arena_alloc(arena, nmemb * size);
+}
+
+/**
+ * @brief Release all of the allocations from an arena at once
+ * @param arena - arena to be reset
+ */
+void arena_reset(ARENA_BUFFER *arena)
+{
+    if (arena) {
+        arena->count = 0;
+        arena->overflow = false;
+    }
+}
+
+/**
+ * @brief Get the number of bytes in use in an arena
+ * @param arena - arena
+ * @return number of bytes in use, including alignment padding
+ */
+size_t arena_count(const ARENA_BUFFER *arena)
+{
+    return (arena ? arena->count : 0);
+}
+
+/**
+ * @brief Get the size of the block of memory of an arena
+ * @param arena - arena
+ * @return size, in bytes, of the block of memory
+ */
+size_t arena_size(const ARENA_BUFFER *arena)
+{
+    return (arena ? arena->size : 0);
+}
+
+/**
+ * @brief Get the most bytes in use in an arena since it was initialized,
+ *  such as to tune the size of the block of memory
+ * @param arena - arena
+ * @return most number of bytes in use
+ */
+size_t arena_peak(const ARENA_BUFFER *arena)
+{
+    return (arena ? arena->peak : 0);
+}
+
+/**
+ * @brief Determine if an allocation did not fit in an arena since it was
+ *  last reset, such as when a decoded list was cut short
+ * @param arena - arena
+ * @return true if an allocation did not fit
+ */
+bool arena_overflow(const ARENA_BUFFER *arena)
+{
+    return (arena ? arena->overflow : false);
+}
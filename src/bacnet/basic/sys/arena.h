@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @brief API for an arena of memory, where the allocations are taken from
+ *  a block of memory one after another, and are all released at once.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_ARENA_H
+#define BACNET_SYS_ARENA_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+struct arena_buffer_t {
+    uint8_t *data; /* block of memory */
+    size_t size; /* size, in bytes, of the block of memory */
+    size_t count; /* number of bytes in use */
+    size_t peak; /* most bytes in use since initialized */
+    bool overflow; /* an allocation did not fit since the last reset */
+};
+typedef struct arena_buffer_t ARENA_BUFFER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void arena_init(ARENA_BUFFER *arena, void *data, size_t size);
+BACNET_STACK_EXPORT
+void *arena_alloc(ARENA_BUFFER *arena, size_t size);
+BACNET_STACK_EXPORT
+void *arena_calloc(ARENA_BUFFER *arena, size_t nmemb, size_t size);
+BACNET_STACK_EXPORT
+void arena_reset(ARENA_BUFFER *arena);
+BACNET_STACK_EXPORT
+size_t arena_count(const ARENA_BUFFER *arena);
+BACNET_STACK_EXPORT
+size_t arena_size(const ARENA_BUFFER *arena);
+BACNET_STACK_EXPORT
+size_t arena_peak(const ARENA_BUFFER *arena);
+BACNET_STACK_EXPORT
+bool arena_overflow(const ARENA_BUFFER *arena);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
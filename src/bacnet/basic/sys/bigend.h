@@ -7,6 +7,10 @@
  */
 #ifndef BACNET_SYS_BIGEND_H
 #define BACNET_SYS_BIGEND_H
+#include <stdint.h>
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 
@@ -21,6 +25,46 @@ extern "C" {
             #else
                 #define BACNET_BIG_ENDIAN 0
             #endif
+        #elif defined(_MSC_VER)
+            /* Windows is little-endian on each of its processors */
+            #define BACNET_BIG_ENDIAN 0
+        #endif
+    #endif
+
+    /* byte swaps, which the compilers make into one instruction */
+    #if defined(__GNUC__) || defined(__clang__)
+        #define BACNET_BSWAP16(x) __builtin_bswap16(x)
+        #define BACNET_BSWAP32(x) __builtin_bswap32(x)
+        #define BACNET_BSWAP64(x) __builtin_bswap64(x)
+    #elif defined(_MSC_VER)
+        #define BACNET_BSWAP16(x) _byteswap_ushort(x)
+        #define BACNET_BSWAP32(x) _byteswap_ulong(x)
+        #define BACNET_BSWAP64(x) _byteswap_uint64(x)
+    #else
+        #define BACNET_BSWAP16(x) \
+            ((uint16_t)((((uint16_t)(x)) >> 8) | (((uint16_t)(x)) << 8)))
+        #define BACNET_BSWAP32(x) \
+            ((((uint32_t)(x) & 0xFF000000UL) >> 24) | \
+            (((uint32_t)(x) & 0x00FF0000UL) >> 8) | \
+            (((uint32_t)(x) & 0x0000FF00UL) << 8) | \
+            (((uint32_t)(x) & 0x000000FFUL) << 24))
+        #define BACNET_BSWAP64(x) \
+            ((((uint64_t)BACNET_BSWAP32((uint32_t)(x))) << 32) | \
+            ((uint64_t)BACNET_BSWAP32((uint32_t)((uint64_t)(x) >> 32))))
+    #endif
+
+    /* conversion between the host byte order and the network byte order
+       (big-endian) of BACnet, when the host byte order is known when
+       compiling.  The conversion is the same in both directions. */
+    #ifdef BACNET_BIG_ENDIAN
+        #if BACNET_BIG_ENDIAN
+            #define BACNET_NETWORK_ORDER16(x) ((uint16_t)(x))
+            #define BACNET_NETWORK_ORDER32(x) ((uint32_t)(x))
+            #define BACNET_NETWORK_ORDER64(x) ((uint64_t)(x))
+        #else
+            #define BACNET_NETWORK_ORDER16(x) BACNET_BSWAP16(x)
+            #define BACNET_NETWORK_ORDER32(x) BACNET_BSWAP32(x)
+            #define BACNET_NETWORK_ORDER64(x) BACNET_BSWAP64(x)
         #endif
     #endif
 
@@ -0,0 +1,505 @@
+/**
+ * @file
+ * @brief A store of object values in columns: the Present_Value, the
+ *  status flags and the COV flag of each object of one type, in arrays
+ *  with one row for each object. A scan of all of the objects, such as
+ *  to find the changed objects, then reads a few contiguous arrays
+ *  instead of following a pointer to each object.
+ * @details The values are written in a section where the sequence of the
+ *  store is odd, which the writer opens with a relaxed store and a
+ *  release fence, and closes with a release store. A reader takes the
+ *  sequence with an acquire load before reading the values, and an
+ *  acquire fence after, and the values are consistent if the sequence is
+ *  even and did not change. The readers do not write to the store, so
+ *  that any number of them read at once without a lock.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/basic/sys/columns.h"
+#include "bacnet/basic/sys/static_pool.h"
+
+#if COLUMNS_ATOMICS
+#define COLUMNS_LOAD(p) atomic_load_explicit((p), memory_order_relaxed)
+#define COLUMNS_ACQUIRE(p) atomic_load_explicit((p), memory_order_acquire)
+#define COLUMNS_PUT(p, v) \
+    atomic_store_explicit((p), (v), memory_order_relaxed)
+#define COLUMNS_RELEASE(p, v) \
+    atomic_store_explicit((p), (v), memory_order_release)
+#define COLUMNS_FENCE_ACQUIRE() atomic_thread_fence(memory_order_acquire)
+#define COLUMNS_FENCE_RELEASE() atomic_thread_fence(memory_order_release)
+#define COLUMNS_SET(p, v) atomic_init((p), (v))
+#elif defined(__GNUC__)
+#define COLUMNS_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define COLUMNS_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define COLUMNS_PUT(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define COLUMNS_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define COLUMNS_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define COLUMNS_FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define COLUMNS_SET(p, v) (*(p) = (v))
+#else
+/* volatile accesses are ordered only on a single core */
+#define COLUMNS_LOAD(p) (*(p))
+#define COLUMNS_ACQUIRE(p) (*(p))
+#define COLUMNS_PUT(p, v) (*(p) = (v))
+#define COLUMNS_RELEASE(p, v) (*(p) = (v))
+#define COLUMNS_FENCE_ACQUIRE() ((void)0)
+#define COLUMNS_FENCE_RELEASE() ((void)0)
+#define COLUMNS_SET(p, v) (*(p) = (v))
+#endif
+
+/**
+ * @brief Initialize a store without any rows
+ * @param store - store to be initialized
+ */
+void columns_init(COLUMNS_STORE *store)
+{
+    if (store) {
+        store->instance = NULL;
+        store->value = NULL;
+        store->flags = NULL;
+        store->prior = NULL;
+        store->increment = NULL;
+        store->data = NULL;
+        store->count = 0;
+        store->capacity = 0;
+        COLUMNS_SET(&store->sequence, 0);
+        store->writing = 0;
+    }
+}
+
+/**
+ * @brief Release the arrays of a store, and all of its rows
+ * @param store - store to be cleaned up
+ */
+void columns_cleanup(COLUMNS_STORE *store)
+{
+    if (store) {
+        bacnet_free(store->instance);
+        bacnet_free(store->value);
+        bacnet_free(store->flags);
+        bacnet_free(store->prior);
+        bacnet_free(store->increment);
+        bacnet_free(store->data);
+        columns_init(store);
+    }
+}
+
+/**
+ * @brief Start to write the values of a store. The writes may be nested,
+ *  such as the rows of a scan that are each set, and the readers see the
+ *  writes when the outer write ends.
+ * @param store - store to be written
+ */
+void columns_write_begin(COLUMNS_STORE *store)
+{
+    unsigned sequence;
+
+    if (store && (store->writing++ == 0)) {
+        sequence = COLUMNS_LOAD(&store->sequence);
+        COLUMNS_PUT(&store->sequence, sequence + 1);
+        COLUMNS_FENCE_RELEASE();
+    }
+}
+
+/**
+ * @brief End a write of the values of a store, that was started with
+ *  columns_write_begin()
+ * @param store - store that was written
+ */
+void columns_write_end(COLUMNS_STORE *store)
+{
+    unsigned sequence;
+
+    if (store && (store->writing > 0) && (--store->writing == 0)) {
+        sequence = COLUMNS_LOAD(&store->sequence);
+        COLUMNS_RELEASE(&store->sequence, sequence + 1);
+    }
+}
+
+/**
+ * @brief Start to read the values of a store, waiting while they are
+ *  written
+ * @param store - store to be read
+ * @return the sequence of the store, for columns_read_retry()
+ */
+unsigned columns_read_begin(const COLUMNS_STORE *store)
+{
+    unsigned sequence = 0;
+
+    if (store) {
+        do {
+            sequence = COLUMNS_ACQUIRE(&store->sequence);
+        } while (sequence & 1U);
+    }
+
+    return sequence;
+}
+
+/**
+ * @brief Determine if the values of a store that were read since
+ *  columns_read_begin() must be read again, because they were written
+ *  meanwhile
+ * @param store - store that was read
+ * @param sequence - the sequence from columns_read_begin()
+ * @return true if the values must be read again
+ */
+bool columns_read_retry(const COLUMNS_STORE *store, unsigned sequence)
+{
+    if (!store) {
+        return false;
+    }
+    COLUMNS_FENCE_ACQUIRE();
+
+    return (COLUMNS_LOAD(&store->sequence) != sequence);
+}
+
+/**
+ * @brief Read the value and the flags of a row, that were written together
+ * @param store - store of the row
+ * @param row - row to be read
+ * @param value - Present_Value of the object, or NULL
+ * @param flags - COLUMNS_FLAG bits of the object, or NULL
+ * @return true if the row exists
+ */
+bool columns_read(
+    const COLUMNS_STORE *store, unsigned row, float *value, uint8_t *flags)
+{
+    unsigned sequence;
+    float row_value;
+    uint8_t row_flags;
+
+    if (!store) {
+        return false;
+    }
+    do {
+        sequence = columns_read_begin(store);
+        if (row >= store->count) {
+            return false;
+        }
+        row_value = store->value[row];
+        row_flags = store->flags[row];
+    } while (columns_read_retry(store, sequence));
+    if (value) {
+        *value = row_value;
+    }
+    if (flags) {
+        *flags = row_flags;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Grow the arrays of a store
+ * @param store - store to grow
+ * @param capacity - number of rows of the arrays
+ * @return true if the arrays were grown
+ */
+static bool columns_grow(COLUMNS_STORE *store, unsigned capacity)
+{
+    uint32_t *instance;
+    float *value;
+    uint8_t *flags;
+    float *prior;
+    float *increment;
+    void **data;
+
+    /* each array keeps its contents if the next one fails to grow */
+    instance = bacnet_realloc(store->instance, capacity * sizeof(*instance));
+    if (!instance) {
+        return false;
+    }
+    store->instance = instance;
+    value = bacnet_realloc(store->value, capacity * sizeof(*value));
+    if (!value) {
+        return false;
+    }
+    store->value = value;
+    flags = bacnet_realloc(store->flags, capacity * sizeof(*flags));
+    if (!flags) {
+        return false;
+    }
+    store->flags = flags;
+    prior = bacnet_realloc(store->prior, capacity * sizeof(*prior));
+    if (!prior) {
+        return false;
+    }
+    store->prior = prior;
+    increment =
+        bacnet_realloc(store->increment, capacity * sizeof(*increment));
+    if (!increment) {
+        return false;
+    }
+    store->increment = increment;
+    data = bacnet_realloc(store->data, capacity * sizeof(*data));
+    if (!data) {
+        return false;
+    }
+    store->data = data;
+    store->capacity = capacity;
+
+    return true;
+}
+
+/**
+ * @brief Add a row for an object, with a zero value, no flags, a zero
+ *  COV increment and no object data
+ * @param store - store to add the row to
+ * @param object_instance - object-instance of the row
+ * @return the row, or -1 if there is no memory for it
+ */
+int columns_add(COLUMNS_STORE *store, uint32_t object_instance)
+{
+    unsigned capacity;
+    unsigned row;
+
+    if (!store) {
+        return -1;
+    }
+    if (store->count >= store->capacity) {
+        capacity =
+            store->capacity ? store->capacity * 2 : COLUMNS_ROWS_DEFAULT;
+        if ((capacity <= store->capacity) || (capacity > INT32_MAX) ||
+            !columns_grow(store, capacity)) {
+            return -1;
+        }
+    }
+    columns_write_begin(store);
+    row = store->count;
+    store->instance[row] = object_instance;
+    store->value[row] = 0.0f;
+    store->flags[row] = 0;
+    store->prior[row] = 0.0f;
+    store->increment[row] = 0.0f;
+    store->data[row] = NULL;
+    store->count++;
+    columns_write_end(store);
+
+    return (int)row;
+}
+
+/**
+ * @brief Remove a row. The last row is moved into the removed row, and
+ *  the object of the moved row must then be told of its new row.
+ * @param store - store to remove the row from
+ * @param row - row to be removed
+ * @return the object-instance of the row that was moved into the removed
+ *  row, or BACNET_MAX_INSTANCE if no row was moved
+ */
+uint32_t columns_remove(COLUMNS_STORE *store, unsigned row)
+{
+    unsigned last;
+
+    if (!store || (row >= store->count)) {
+        return BACNET_MAX_INSTANCE;
+    }
+    columns_write_begin(store);
+    store->count--;
+    last = store->count;
+    if (row == last) {
+        columns_write_end(store);
+        return BACNET_MAX_INSTANCE;
+    }
+    store->instance[row] = store->instance[last];
+    store->value[row] = store->value[last];
+    store->flags[row] = store->flags[last];
+    store->prior[row] = store->prior[last];
+    store->increment[row] = store->increment[last];
+    store->data[row] = store->data[last];
+    columns_write_end(store);
+
+    return store->instance[row];
+}
+
+/**
+ * @brief Set the value and flags of a row
+ * @param store - store of the row
+ * @param row - row to be set
+ * @param value - Present_Value of the object
+ * @param flags - COLUMNS_FLAG bits of the object
+ */
+void columns_set(COLUMNS_STORE *store, unsigned row, float value, uint8_t flags)
+{
+    if (store && (row < store->count)) {
+        columns_write_begin(store);
+        store->value[row] = value;
+        store->flags[row] = flags;
+        columns_write_end(store);
+    }
+}
+
+/**
+ * @brief Set the values of a row that detect a change of value
+ * @param store - store of the row
+ * @param row - row to be set
+ * @param prior - Present_Value at the last change of value of the object
+ * @param increment - COV_Increment of the object
+ */
+void columns_cov_set(
+    COLUMNS_STORE *store, unsigned row, float prior, float increment)
+{
+    if (store && (row < store->count)) {
+        columns_write_begin(store);
+        store->prior[row] = prior;
+        store->increment[row] = increment;
+        columns_write_end(store);
+    }
+}
+
+/**
+ * @brief Set the object data of a row, so that the object can be found
+ *  from its row without a search
+ * @param store - store of the row
+ * @param row - row to be set
+ * @param data - object data
+ */
+void columns_data_set(COLUMNS_STORE *store, unsigned row, void *data)
+{
+    if (store && (row < store->count)) {
+        store->data[row] = data;
+    }
+}
+
+/**
+ * @brief Compare values with their prior values, and take the values
+ *  that changed by their increment or more as their prior values
+ * @param value - values
+ * @param prior - prior values
+ * @param increment - increments
+ * @param flags - COLUMNS_FLAG bits, where changed values are flagged
+ * @param cov - set to 1 for each value that changed, else 0
+ * @param count - number of values
+ */
+static void columns_cov_detect(
+    const float *value,
+    float *prior,
+    const float *increment,
+    uint8_t *flags,
+    uint32_t *cov,
+    unsigned count)
+{
+    unsigned i;
+    float delta;
+
+    /* a loop without branches, that a compiler can vectorize */
+    for (i = 0; i < count; i++) {
+        delta = value[i] - prior[i];
+        delta = (delta < 0.0f) ? -delta : delta;
+        cov[i] = (delta >= increment[i]) ? 1 : 0;
+        prior[i] = cov[i] ? value[i] : prior[i];
+        flags[i] |= cov[i] ? COLUMNS_FLAG_CHANGED : 0;
+    }
+}
+
+/**
+ * @brief Set the values of consecutive rows, such as the samples of an
+ *  I/O scan, and find the rows whose value changed by their COV increment
+ *  or more since their prior value. The prior value of a changed row
+ *  becomes its value, and its COLUMNS_FLAG_CHANGED flag is set.
+ * @param store - store of the rows
+ * @param row - first row to be set
+ * @param value - value of each row, from the first row
+ * @param count - number of values
+ * @param changed - bitmap of COLUMNS_BITMAP_WORDS(count) words, where
+ *  bit (i % 32) of word (i / 32) is set if the row of value[i] changed
+ * @return number of rows that changed, of the rows that were set
+ */
+unsigned columns_cov_update(
+    COLUMNS_STORE *store,
+    unsigned row,
+    const float *value,
+    unsigned count,
+    uint32_t *changed)
+{
+    unsigned changes = 0;
+    unsigned i, j, n;
+    uint32_t bits;
+    uint32_t cov[32];
+
+    if (!store || !value || !changed || (row >= store->count)) {
+        return 0;
+    }
+    if (count > (store->count - row)) {
+        count = store->count - row;
+    }
+    columns_write_begin(store);
+    memcpy(&store->value[row], value, count * sizeof(*value));
+    for (i = 0; i < count; i += 32) {
+        n = count - i;
+        if (n > 32) {
+            n = 32;
+        }
+        columns_cov_detect(
+            &value[i], &store->prior[row + i], &store->increment[row + i],
+            &store->flags[row + i], cov, n);
+        bits = 0;
+        for (j = 0; j < n; j++) {
+            bits |= (uint32_t)cov[j] << j;
+            changes += cov[j];
+        }
+        changed[i / 32] = bits;
+    }
+    columns_write_end(store);
+
+    return changes;
+}
+
+/**
+ * @brief Get the number of rows of a store
+ * @param store - store
+ * @return number of rows
+ */
+unsigned columns_count(const COLUMNS_STORE *store)
+{
+    return (store ? store->count : 0);
+}
+
+/**
+ * @brief Count the rows that have any of the flags of a mask, such as
+ *  the changed objects, or the objects that are in fault
+ * @param store - store to scan
+ * @param mask - COLUMNS_FLAG bits
+ * @return number of rows with any of the flags
+ */
+unsigned columns_flags_count(const COLUMNS_STORE *store, uint8_t mask)
+{
+    unsigned count = 0;
+    unsigned row;
+
+    if (store) {
+        /* a loop without branches, that a compiler can vectorize */
+        for (row = 0; row < store->count; row++) {
+            count += (store->flags[row] & mask) ? 1 : 0;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Find the next row that has any of the flags of a mask
+ * @param store - store to scan
+ * @param mask - COLUMNS_FLAG bits
+ * @param row - first row to look at
+ * @return the row, or the number of rows if there is none
+ */
+unsigned
+columns_flags_next(const COLUMNS_STORE *store, uint8_t mask, unsigned row)
+{
+    if (!store) {
+        return 0;
+    }
+    while ((row < store->count) && !(store->flags[row] & mask)) {
+        row++;
+    }
+    if (row > store->count) {
+        row = store->count;
+    }
+
+    return row;
+}
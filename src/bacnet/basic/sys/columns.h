@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief API for a store of object values in columns, one contiguous
+ *  array for each value and one row for each object, so that a scan of
+ *  the values of many objects reads memory in order.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_COLUMNS_H
+#define BACNET_SYS_COLUMNS_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* the sequence of the writes uses C11 atomics when the compiler has them,
+   otherwise the GCC atomic builtins or volatile on a single core */
+#if !defined(__cplusplus) && defined(__STDC_VERSION__) && \
+    (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define COLUMNS_ATOMICS 1
+typedef atomic_uint columns_sequence_t;
+#else
+#define COLUMNS_ATOMICS 0
+typedef volatile unsigned columns_sequence_t;
+#endif
+
+/* the flags of a row - the status flags are in the order of the
+   bits of BACnetStatusFlags */
+#define COLUMNS_FLAG_IN_ALARM 0x01
+#define COLUMNS_FLAG_FAULT 0x02
+#define COLUMNS_FLAG_OVERRIDDEN 0x04
+#define COLUMNS_FLAG_OUT_OF_SERVICE 0x08
+#define COLUMNS_FLAG_STATUS 0x0F
+/* the Present_Value of a binary object is ACTIVE */
+#define COLUMNS_FLAG_ACTIVE 0x40
+/* the Present_Value or status flags changed since the COV flag of the
+   object was cleared */
+#define COLUMNS_FLAG_CHANGED 0x80
+
+/* number of 32-bit words of a bitmap with one bit for each of count rows */
+#define COLUMNS_BITMAP_WORDS(count) (((count) + 31) / 32)
+
+/* number of rows of the first allocation */
+#ifndef COLUMNS_ROWS_DEFAULT
+#define COLUMNS_ROWS_DEFAULT 16
+#endif
+
+/* The rows are in no order: a deleted row is replaced by the last row.
+   The arrays may be read directly, from row 0 to count - 1.
+
+   The values are guarded by a sequence lock, so that readers in other
+   threads, such as the encoders of ReadProperty and COV, never block the
+   writer of the values, such as an I/O scan, and are never blocked by it.
+   The sequence is odd while the values are written. A reader takes the
+   sequence with columns_read_begin(), reads the values, and reads them
+   again if columns_read_retry() says that they were written meanwhile.
+   There is one writer at a time: writes from several threads, and the
+   adding and removing of rows, which may move the arrays, are done
+   under the lock of the stack. */
+struct columns_store_t {
+    uint32_t *instance; /* object-instance of each row */
+    float *value; /* Present_Value of each row */
+    uint8_t *flags; /* COLUMNS_FLAG bits of each row */
+    float *prior; /* Present_Value at the last change of value of each row */
+    float *increment; /* COV_Increment of each row */
+    void **data; /* object data of each row, set by the object */
+    unsigned count; /* number of rows */
+    unsigned capacity; /* number of rows of the arrays */
+    columns_sequence_t sequence; /* odd while the values are written */
+    unsigned writing; /* depth of the nested writes, of the writer */
+};
+typedef struct columns_store_t COLUMNS_STORE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void columns_init(COLUMNS_STORE *store);
+BACNET_STACK_EXPORT
+void columns_cleanup(COLUMNS_STORE *store);
+BACNET_STACK_EXPORT
+int columns_add(COLUMNS_STORE *store, uint32_t object_instance);
+BACNET_STACK_EXPORT
+uint32_t columns_remove(COLUMNS_STORE *store, unsigned row);
+BACNET_STACK_EXPORT
+void columns_set(
+    COLUMNS_STORE *store, unsigned row, float value, uint8_t flags);
+BACNET_STACK_EXPORT
+void columns_cov_set(
+    COLUMNS_STORE *store, unsigned row, float prior, float increment);
+BACNET_STACK_EXPORT
+void columns_data_set(COLUMNS_STORE *store, unsigned row, void *data);
+BACNET_STACK_EXPORT
+unsigned columns_cov_update(
+    COLUMNS_STORE *store,
+    unsigned row,
+    const float *value,
+    unsigned count,
+    uint32_t *changed);
+BACNET_STACK_EXPORT
+void columns_write_begin(COLUMNS_STORE *store);
+BACNET_STACK_EXPORT
+void columns_write_end(COLUMNS_STORE *store);
+BACNET_STACK_EXPORT
+unsigned columns_read_begin(const COLUMNS_STORE *store);
+BACNET_STACK_EXPORT
+bool columns_read_retry(const COLUMNS_STORE *store, unsigned sequence);
+BACNET_STACK_EXPORT
+bool columns_read(
+    const COLUMNS_STORE *store, unsigned row, float *value, uint8_t *flags);
+BACNET_STACK_EXPORT
+unsigned columns_count(const COLUMNS_STORE *store);
+BACNET_STACK_EXPORT
+unsigned columns_flags_count(const COLUMNS_STORE *store, uint8_t mask);
+BACNET_STACK_EXPORT
+unsigned
+columns_flags_next(const COLUMNS_STORE *store, uint8_t mask, unsigned row);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
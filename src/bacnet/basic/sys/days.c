@@ -76,11 +76,18 @@ uint32_t days_per_year(uint16_t year)
  */
 uint16_t days_of_year(uint16_t year, uint8_t month, uint8_t day)
 {
+    /* days of the months before a month of a year that is not leap,
+       where a month after December counts the whole year */
+    static const uint16_t days_before_month[14] = { 0, 0, 31, 59, 90, 120,
+        151, 181, 212, 243, 273, 304, 334, 365 };
     uint16_t days = 0; /* return value */
-    uint8_t mm = 0; /* months counter */
 
-    for (mm = 1; mm < month; mm++) {
-        days += days_per_month(year, mm);
+    if (month > 13) {
+        month = 13;
+    }
+    days = days_before_month[month];
+    if ((month > 2) && days_is_leap_year(year)) {
+        days++;
     }
     days += day;
 
@@ -98,12 +105,8 @@ uint16_t days_of_year(uint16_t year, uint8_t month, uint8_t day)
 uint16_t days_of_year_remaining(uint16_t year, uint8_t month, uint8_t day)
 {
     uint16_t days = 0; /* return value */
-    uint8_t mm = 0; /* months counter */
 
-    days = days_per_month(year, month) - day;
-    for (mm = 12; mm > month; mm--) {
-        days += days_per_month(year, mm);
-    }
+    days = (uint16_t)days_per_year(year) - days_of_year(year, month, day);
 
     return days;
 }
@@ -153,40 +156,16 @@ uint32_t days_apart(uint16_t year1,
     uint8_t month2,
     uint8_t day2)
 {
-    uint32_t days = 0; /* return value */
     uint32_t days1 = 0;
     uint32_t days2 = 0;
-    uint16_t yy = 0; /* year */
-
-    if (year2 > year1) {
-        days = days_of_year_remaining(year1, month1, day1);
-        for (yy = year1 + 1; yy < year2; yy++) {
-            days += 365;
-            if (days_is_leap_year(yy)) {
-                days++;
-            }
-        }
-        days += days_of_year(year2, month2, day2);
-    } else if (year2 < year1) {
-        days = days_of_year_remaining(year2, month2, day2);
-        for (yy = year2 + 1; yy < year1; yy++) {
-            days += 365;
-            if (days_is_leap_year(yy)) {
-                days++;
-            }
-        }
-        days += days_of_year(year1, month1, day1);
-    } else {
-        days1 = days_of_year(year1, month1, day1);
-        days2 = days_of_year(year2, month2, day2);
-        if (days2 > days1) {
-            days = days2 - days1;
-        } else {
-            days = days1 - days2;
-        }
+
+    days1 = days_serial(year1, month1, day1);
+    days2 = days_serial(year2, month2, day2);
+    if (days2 > days1) {
+        return days2 - days1;
     }
 
-    return days;
+    return days1 - days2;
 }
 
 /**
@@ -201,24 +180,15 @@ uint32_t days_since_epoch(
     uint16_t epoch_year, uint16_t year, uint8_t month, uint8_t day)
 {
     uint32_t days = 0; /* return value */
-    uint16_t yy = 0; /* year */
-    uint8_t mm = 0; /* months counter */
     uint8_t monthdays = 0; /* days in a month */
 
     /* validate the date conforms to our range */
     monthdays = days_per_month(year, month);
     if ((year >= epoch_year) && (year <= 9999) && (monthdays > 0) &&
         (day >= 1) && (day <= monthdays)) {
-        for (yy = epoch_year; yy < year; yy++) {
-            days += 365;
-            if (days_is_leap_year(yy)) {
-                days++;
-            }
-        }
-        for (mm = 1; mm < month; mm++) {
-            days += days_per_month(year, mm);
-        }
-        days += day;
+        /* Jan 1 of the epoch year is day 1 */
+        days = days_serial(year, month, day) -
+            days_serial(epoch_year, 1, 1) + 1;
     }
 
     return (days);
@@ -244,15 +214,11 @@ void days_since_epoch_to_date(uint16_t epoch_year,
     uint16_t year;
 
     year = epoch_year;
-    while (days > days_per_year(year)) {
-        days -= days_per_year(year);
-        year++;
+    if (days > 0) {
+        /* Jan 1 of the epoch year is day 1 */
+        days_serial_to_date(
+            days_serial(epoch_year, 1, 1) + days - 1, &year, &month, &day);
     }
-    while (days > days_per_month(year, month)) {
-        days -= days_per_month(year, month);
-        month++;
-    }
-    day += days;
     /* load values into the pointers */
     if (pYear) {
         *pYear = year;
@@ -267,6 +233,79 @@ void days_since_epoch_to_date(uint16_t epoch_year,
     return;
 }
 
+/**
+ * Converts a date into a serial day number, in a constant time without
+ * loops over the years or months. The day number counts the days of the
+ * proleptic Gregorian calendar from March 1 of the year 400 BC, so that
+ * it is positive for all of the years 0..9999 AD. The number of days
+ * between two dates is the difference of their day numbers.
+ *
+ * @param year - years after Christ birth (0..9999 AD)
+ * @param month - months (1=Jan...12=Dec)
+ * @param day - day of month (1-31)
+ * @return serial day number
+ */
+uint32_t days_serial(uint16_t year, uint8_t month, uint8_t day)
+{
+    uint32_t y, era, yoe, moy, doy, doe;
+
+    /* a year starts with March so that the leap day is the last day,
+       and is counted from 400 BC so that it is never negative */
+    y = (uint32_t)year + 400;
+    if (month <= 2) {
+        y--;
+        moy = (uint32_t)month + 9;
+    } else {
+        moy = (uint32_t)month - 3;
+    }
+    era = y / 400;
+    yoe = y - (era * 400);
+    doy = (((153 * moy) + 2) / 5) + day - 1;
+    doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+
+    return (era * 146097) + doe;
+}
+
+/**
+ * Converts a serial day number into a date (year, month, day), in a
+ * constant time without loops over the years or months.
+ *
+ * @param days - serial day number, from days_serial()
+ * @param pYear - years after Christ birth (0..9999 AD)
+ * @param pMonth - months (1=Jan...12=Dec)
+ * @param pDay - day of month (1-31)
+ */
+void days_serial_to_date(
+    uint32_t days, uint16_t *pYear, uint8_t *pMonth, uint8_t *pDay)
+{
+    uint32_t era, doe, yoe, doy, moy, y;
+    uint8_t month;
+
+    /* 146097 days in 400 years, 36524 days in 100 years,
+       and 1460 days in 4 years */
+    era = days / 146097;
+    doe = days - (era * 146097);
+    yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+    doy = doe - ((yoe * 365) + (yoe / 4) - (yoe / 100));
+    moy = ((5 * doy) + 2) / 153;
+    y = yoe + (era * 400);
+    if (moy < 10) {
+        month = (uint8_t)(moy + 3);
+    } else {
+        month = (uint8_t)(moy - 9);
+        y++;
+    }
+    if (pYear) {
+        *pYear = (uint16_t)(y - 400);
+    }
+    if (pMonth) {
+        *pMonth = month;
+    }
+    if (pDay) {
+        *pDay = (uint8_t)(doy - (((153 * moy) + 2) / 5) + 1);
+    }
+}
+
 /**
  * Determines if a given date is valid
  *
@@ -48,6 +48,11 @@ void days_since_epoch_to_date(
     uint16_t * pYear,
     uint8_t * pMonth,
     uint8_t * pDay);
+BACNET_STACK_EXPORT
+uint32_t days_serial(uint16_t year, uint8_t month, uint8_t day);
+BACNET_STACK_EXPORT
+void days_serial_to_date(
+    uint32_t days, uint16_t *pYear, uint8_t *pMonth, uint8_t *pDay);
 
 BACNET_STACK_EXPORT
 bool days_date_is_valid(uint16_t year,
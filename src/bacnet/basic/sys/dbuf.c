@@ -0,0 +1,382 @@
+/**
+ * @file
+ * @brief A dynamic buffer of text that grows as text is appended, such as
+ *  to export many property values as text or JSON. The numbers are
+ *  formatted here, without a snprintf() call for each one.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bacnet/basic/sys/dbuf.h"
+#include "bacnet/basic/sys/static_pool.h"
+
+/* most decimals of a real value that fit the integer fraction */
+#define DBUF_REAL_DECIMALS_MAX 9
+/* real values up to this magnitude are formatted here, and larger ones,
+   or infinity or not-a-number, with snprintf() */
+#define DBUF_REAL_FAST_MAX 1e15
+
+/**
+ * @brief Initialize a buffer without any memory
+ * @param b - buffer to be initialized
+ */
+void dbuf_init(DYNAMIC_BUFFER *b)
+{
+    if (b) {
+        b->data = NULL;
+        b->size = 0;
+        b->count = 0;
+        b->error = false;
+    }
+}
+
+/**
+ * @brief Release the memory of a buffer, and all of its text
+ * @param b - buffer to be cleaned up
+ */
+void dbuf_cleanup(DYNAMIC_BUFFER *b)
+{
+    if (b) {
+        bacnet_free(b->data);
+        dbuf_init(b);
+    }
+}
+
+/**
+ * @brief Empty a buffer, keeping its memory to be used again, such as
+ *  after the text was written to a file
+ * @param b - buffer to be emptied
+ */
+void dbuf_reset(DYNAMIC_BUFFER *b)
+{
+    if (b) {
+        b->count = 0;
+        b->error = false;
+        if (b->data) {
+            b->data[0] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Make sure a number of bytes can be appended to a buffer without
+ *  another allocation
+ * @param b - buffer to grow
+ * @param len - number of bytes that will be appended
+ * @return true if the memory is available, false if there is no memory,
+ *  which also sets the error of the buffer
+ */
+bool dbuf_reserve(DYNAMIC_BUFFER *b, size_t len)
+{
+    size_t size;
+    char *data;
+
+    if (!b) {
+        return false;
+    }
+    /* room for the NULL byte after the text */
+    if (len >= (SIZE_MAX - b->count)) {
+        b->error = true;
+        return false;
+    }
+    if ((b->count + len) < b->size) {
+        return true;
+    }
+    size = b->size ? b->size : DBUF_SIZE_DEFAULT;
+    while (size <= (b->count + len)) {
+        if (size > (SIZE_MAX / 2)) {
+            size = b->count + len + 1;
+            break;
+        }
+        size *= 2;
+    }
+    data = bacnet_realloc(b->data, size);
+    if (!data) {
+        b->error = true;
+        return false;
+    }
+    b->data = data;
+    b->size = size;
+
+    return true;
+}
+
+/**
+ * @brief Append a number of bytes to a buffer, to be written by the caller
+ * @param b - buffer to extend
+ * @param len - number of bytes to append
+ * @return the first of the appended bytes, followed by room for a NULL
+ *  byte, or NULL if there is no memory
+ */
+char *dbuf_extend(DYNAMIC_BUFFER *b, size_t len)
+{
+    char *data;
+
+    if (!dbuf_reserve(b, len)) {
+        return NULL;
+    }
+    data = &b->data[b->count];
+    b->count += len;
+    b->data[b->count] = 0;
+
+    return data;
+}
+
+/**
+ * @brief Shorten the text of a buffer, such as to remove a trailing comma
+ * @param b - buffer to shorten
+ * @param count - new number of bytes of the text
+ * @return true if the text was shortened, false if it is shorter
+ */
+bool dbuf_truncate(DYNAMIC_BUFFER *b, size_t count)
+{
+    if (!b || (count > b->count)) {
+        return false;
+    }
+    b->count = count;
+    if (b->data) {
+        b->data[count] = 0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the text of a buffer
+ * @param b - buffer
+ * @return the NULL terminated text, which is empty for an empty buffer
+ */
+const char *dbuf_data(const DYNAMIC_BUFFER *b)
+{
+    if (b && b->data) {
+        return b->data;
+    }
+
+    return "";
+}
+
+/**
+ * @brief Get the number of bytes of the text of a buffer
+ * @param b - buffer
+ * @return number of bytes, without the NULL byte
+ */
+size_t dbuf_count(const DYNAMIC_BUFFER *b)
+{
+    return (b ? b->count : 0);
+}
+
+/**
+ * @brief Determine if an append to a buffer failed for lack of memory
+ *  since it was initialized or reset, so that the errors of many appends
+ *  are checked once
+ * @param b - buffer
+ * @return true if an append failed
+ */
+bool dbuf_error(const DYNAMIC_BUFFER *b)
+{
+    return (b ? b->error : true);
+}
+
+/**
+ * @brief Append bytes to a buffer
+ * @param b - buffer
+ * @param data - bytes to append
+ * @param len - number of bytes to append
+ * @return true if the bytes were appended
+ */
+bool dbuf_append(DYNAMIC_BUFFER *b, const char *data, size_t len)
+{
+    char *dest;
+
+    if (!data && len) {
+        return false;
+    }
+    dest = dbuf_extend(b, len);
+    if (!dest) {
+        return false;
+    }
+    if (len) {
+        memcpy(dest, data, len);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Append one character to a buffer
+ * @param b - buffer
+ * @param c - character to append
+ * @return true if the character was appended
+ */
+bool dbuf_append_char(DYNAMIC_BUFFER *b, char c)
+{
+    if (b && ((b->count + 1) < b->size)) {
+        b->data[b->count] = c;
+        b->count++;
+        b->data[b->count] = 0;
+        return true;
+    }
+
+    return dbuf_append(b, &c, 1);
+}
+
+/**
+ * @brief Append a NULL terminated string to a buffer
+ * @param b - buffer
+ * @param str - string to append
+ * @return true if the string was appended
+ */
+bool dbuf_append_string(DYNAMIC_BUFFER *b, const char *str)
+{
+    if (!str) {
+        return false;
+    }
+
+    return dbuf_append(b, str, strlen(str));
+}
+
+/**
+ * @brief Append the decimal digits of an unsigned value to a buffer
+ * @param b - buffer
+ * @param value - value to append
+ * @return true if the value was appended
+ */
+bool dbuf_append_unsigned(DYNAMIC_BUFFER *b, uint64_t value)
+{
+    char digits[20];
+    size_t len = 0;
+
+    do {
+        digits[sizeof(digits) - 1 - len] = (char)('0' + (value % 10));
+        value /= 10;
+        len++;
+    } while (value);
+
+    return dbuf_append(b, &digits[sizeof(digits) - len], len);
+}
+
+/**
+ * @brief Append the decimal digits of a signed value to a buffer
+ * @param b - buffer
+ * @param value - value to append
+ * @return true if the value was appended
+ */
+bool dbuf_append_signed(DYNAMIC_BUFFER *b, int64_t value)
+{
+    if (value < 0) {
+        if (!dbuf_append_char(b, '-')) {
+            return false;
+        }
+        /* the magnitude of the most negative value is not an int64_t */
+        return dbuf_append_unsigned(b, (uint64_t)(-(value + 1)) + 1);
+    }
+
+    return dbuf_append_unsigned(b, (uint64_t)value);
+}
+
+/**
+ * @brief Append bytes as pairs of upper case hexadecimal digits
+ * @param b - buffer
+ * @param data - bytes to append
+ * @param len - number of bytes to append
+ * @return true if the bytes were appended
+ */
+bool dbuf_append_hex(DYNAMIC_BUFFER *b, const uint8_t *data, size_t len)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char *dest;
+    size_t i;
+
+    if ((!data && len) || (len > (SIZE_MAX / 2))) {
+        return false;
+    }
+    dest = dbuf_extend(b, len * 2);
+    if (!dest) {
+        return false;
+    }
+    for (i = 0; i < len; i++) {
+        dest[i * 2] = hex[data[i] >> 4];
+        dest[(i * 2) + 1] = hex[data[i] & 0x0F];
+    }
+
+    return true;
+}
+
+/**
+ * @brief Append a real value with a number of decimals, in the form of
+ *  the %f conversion of printf(), where an exact half rounds to even.
+ *  The last decimal may differ from printf() where the scaled fraction
+ *  is within rounding of one half.
+ * @param b - buffer
+ * @param value - value to append
+ * @param decimals - number of decimals, up to 9, such as 6 for %f
+ * @return true if the value was appended
+ */
+bool dbuf_append_real(DYNAMIC_BUFFER *b, double value, unsigned decimals)
+{
+    uint64_t whole, fraction, scale = 1, last;
+    double part, rest;
+    unsigned i;
+    int len;
+    char *dest;
+
+    if (decimals > DBUF_REAL_DECIMALS_MAX) {
+        decimals = DBUF_REAL_DECIMALS_MAX;
+    }
+    if (!isfinite(value) || (fabs(value) >= DBUF_REAL_FAST_MAX)) {
+        len = snprintf(NULL, 0, "%.*f", (int)decimals, value);
+        if (len < 0) {
+            return false;
+        }
+        dest = dbuf_extend(b, (size_t)len);
+        if (!dest) {
+            return false;
+        }
+        snprintf(dest, (size_t)len + 1, "%.*f", (int)decimals, value);
+        return true;
+    }
+    if (signbit(value)) {
+        if (!dbuf_append_char(b, '-')) {
+            return false;
+        }
+        value = -value;
+    }
+    for (i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    whole = (uint64_t)value;
+    part = (value - (double)whole) * (double)scale;
+    fraction = (uint64_t)part;
+    rest = part - (double)fraction;
+    last = decimals ? fraction : whole;
+    /* an exact half, neither more nor less, rounds to even */
+    if ((rest > 0.5) || (!(rest < 0.5) && (last & 1))) {
+        fraction++;
+        if (fraction >= scale) {
+            fraction = 0;
+            whole++;
+        }
+    }
+    if (!dbuf_append_unsigned(b, whole)) {
+        return false;
+    }
+    if (decimals) {
+        dest = dbuf_extend(b, decimals + 1);
+        if (!dest) {
+            return false;
+        }
+        dest[0] = '.';
+        for (i = decimals; i > 0; i--) {
+            dest[i] = (char)('0' + (fraction % 10));
+            fraction /= 10;
+        }
+    }
+
+    return true;
+}
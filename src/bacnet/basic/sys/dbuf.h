@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @brief API for a dynamic buffer of text that grows as text is appended,
+ *  with number formatting that does not use snprintf() for each number.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_DBUF_H
+#define BACNET_SYS_DBUF_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* number of bytes of the first allocation */
+#ifndef DBUF_SIZE_DEFAULT
+#define DBUF_SIZE_DEFAULT 256
+#endif
+
+/* The text is always terminated by a NULL byte after the count. */
+struct dynamic_buffer_t {
+    char *data; /* block of memory, or NULL before the first append */
+    size_t size; /* size, in bytes, of the block of memory */
+    size_t count; /* number of bytes in use, without the NULL byte */
+    bool error; /* an append failed for lack of memory */
+};
+typedef struct dynamic_buffer_t DYNAMIC_BUFFER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void dbuf_init(DYNAMIC_BUFFER *b);
+BACNET_STACK_EXPORT
+void dbuf_cleanup(DYNAMIC_BUFFER *b);
+BACNET_STACK_EXPORT
+void dbuf_reset(DYNAMIC_BUFFER *b);
+BACNET_STACK_EXPORT
+bool dbuf_reserve(DYNAMIC_BUFFER *b, size_t len);
+BACNET_STACK_EXPORT
+char *dbuf_extend(DYNAMIC_BUFFER *b, size_t len);
+BACNET_STACK_EXPORT
+bool dbuf_truncate(DYNAMIC_BUFFER *b, size_t count);
+BACNET_STACK_EXPORT
+const char *dbuf_data(const DYNAMIC_BUFFER *b);
+BACNET_STACK_EXPORT
+size_t dbuf_count(const DYNAMIC_BUFFER *b);
+BACNET_STACK_EXPORT
+bool dbuf_error(const DYNAMIC_BUFFER *b);
+
+BACNET_STACK_EXPORT
+bool dbuf_append(DYNAMIC_BUFFER *b, const char *data, size_t len);
+BACNET_STACK_EXPORT
+bool dbuf_append_char(DYNAMIC_BUFFER *b, char c);
+BACNET_STACK_EXPORT
+bool dbuf_append_string(DYNAMIC_BUFFER *b, const char *str);
+BACNET_STACK_EXPORT
+bool dbuf_append_unsigned(DYNAMIC_BUFFER *b, uint64_t value);
+BACNET_STACK_EXPORT
+bool dbuf_append_signed(DYNAMIC_BUFFER *b, int64_t value);
+BACNET_STACK_EXPORT
+bool dbuf_append_hex(DYNAMIC_BUFFER *b, const uint8_t *data, size_t len);
+BACNET_STACK_EXPORT
+bool dbuf_append_real(DYNAMIC_BUFFER *b, double value, unsigned decimals);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
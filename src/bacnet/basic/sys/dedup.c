@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @brief A short-lived cache of the hashes of received messages, keyed by
+ *  a hash of their source address and their data, so that a broadcast
+ *  that arrives again through another path within the window is found
+ *  with a scan of the few hashes of the window.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/dedup.h"
+
+#define DEDUP_FNV_OFFSET_BASIS 2166136261UL
+#define DEDUP_FNV_PRIME 16777619UL
+
+/**
+ * @brief Initialize a cache, which is empty
+ * @param dedup - the cache
+ * @param entries - the entries of the cache
+ * @param size - number of entries, at least the number of messages that
+ *  are received within the window
+ * @param window_ms - milliseconds that a message is kept
+ */
+void bacnet_dedup_init(BACNET_DEDUP *dedup,
+    BACNET_DEDUP_ENTRY *entries,
+    unsigned size,
+    unsigned long window_ms)
+{
+    if (!dedup) {
+        return;
+    }
+    dedup->entries = entries;
+    dedup->size = entries ? size : 0;
+    dedup->next = 0;
+    dedup->window_ms = window_ms;
+    dedup->dropped = 0;
+    if (dedup->size) {
+        memset(entries, 0, size * sizeof(BACNET_DEDUP_ENTRY));
+    }
+}
+
+/**
+ * @brief Continue an FNV-1a hash with more data
+ * @param hash - the hash so far, or 0 to start one
+ * @param data - the data
+ * @param length - number of bytes of the data
+ * @return the hash
+ */
+uint32_t bacnet_dedup_hash(uint32_t hash, const uint8_t *data, size_t length)
+{
+    size_t i;
+
+    if (hash == 0) {
+        hash = DEDUP_FNV_OFFSET_BASIS;
+    }
+    for (i = 0; data && (i < length); i++) {
+        hash = (hash ^ data[i]) * DEDUP_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Check whether a message was received within the window, and
+ *  otherwise keep it
+ * @param dedup - the cache
+ * @param source - the source address of the message
+ * @param source_length - number of bytes of the source address
+ * @param data - the message
+ * @param length - number of bytes of the message
+ * @param now_ms - the millisecond timer
+ * @return true if the message is a repeat, which is dropped
+ */
+bool bacnet_dedup_check(BACNET_DEDUP *dedup,
+    const uint8_t *source,
+    size_t source_length,
+    const uint8_t *data,
+    size_t length,
+    unsigned long now_ms)
+{
+    BACNET_DEDUP_ENTRY *entry;
+    uint32_t hash;
+    unsigned i;
+
+    if (!dedup || (dedup->size == 0)) {
+        return false;
+    }
+    hash = bacnet_dedup_hash(0, source, source_length);
+    hash = bacnet_dedup_hash(hash, data, length);
+    /* zero marks an empty entry */
+    if (now_ms == 0) {
+        now_ms = 1;
+    }
+    for (i = 0; i < dedup->size; i++) {
+        entry = &dedup->entries[i];
+        if (entry->time_ms && (entry->hash == hash) &&
+            (entry->length == (uint16_t)length) &&
+            ((now_ms - entry->time_ms) < dedup->window_ms)) {
+            dedup->dropped++;
+            return true;
+        }
+    }
+    entry = &dedup->entries[dedup->next];
+    entry->hash = hash;
+    entry->length = (uint16_t)length;
+    entry->time_ms = now_ms;
+    dedup->next = (dedup->next + 1) % dedup->size;
+
+    return false;
+}
+
+/**
+ * @brief Get the number of messages that were dropped as repeats
+ * @param dedup - the cache
+ * @return number of messages
+ */
+unsigned long bacnet_dedup_dropped(const BACNET_DEDUP *dedup)
+{
+    return dedup ? dedup->dropped : 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief API for a short-lived cache of the hashes of received messages,
+ *  such as broadcasts that arrive more than once through different BBMDs
+ *  or routers, so that the repeats are dropped before they are decoded
+ *  and forwarded again.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_DEDUP_H
+#define BACNET_SYS_DEDUP_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* a message that was received */
+typedef struct bacnet_dedup_entry {
+    uint32_t hash;
+    uint16_t length;
+    /* millisecond when it was received, or 0 when the entry is empty */
+    unsigned long time_ms;
+} BACNET_DEDUP_ENTRY;
+
+/**
+ * A cache of the messages received in the last window of milliseconds,
+ * whose entries are declared by the module that uses it, such as
+ * statically, and replaced oldest first.
+ */
+typedef struct bacnet_dedup {
+    BACNET_DEDUP_ENTRY *entries;
+    unsigned size;
+    unsigned next;
+    unsigned long window_ms;
+    unsigned long dropped;
+} BACNET_DEDUP;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_dedup_init(BACNET_DEDUP *dedup,
+    BACNET_DEDUP_ENTRY *entries,
+    unsigned size,
+    unsigned long window_ms);
+BACNET_STACK_EXPORT
+uint32_t bacnet_dedup_hash(uint32_t hash, const uint8_t *data, size_t length);
+BACNET_STACK_EXPORT
+bool bacnet_dedup_check(BACNET_DEDUP *dedup,
+    const uint8_t *source,
+    size_t source_length,
+    const uint8_t *data,
+    size_t length,
+    unsigned long now_ms);
+BACNET_STACK_EXPORT
+unsigned long bacnet_dedup_dropped(const BACNET_DEDUP *dedup);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
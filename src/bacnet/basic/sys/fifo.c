@@ -61,8 +61,35 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/basic/sys/fifo.h"
 
+/**
+ * Copies bytes out of the FIFO data store, splitting the copy at the end
+ * of the data store
+ *
+ * @param b - pointer to FIFO_BUFFER structure
+ * @param tail - index of the first byte to copy
+ * @param buffer [out] - buffer to hold the bytes
+ * @param count - number of bytes to copy, no more than the FIFO holds
+ */
+static void FIFO_Copy_Out(
+    FIFO_BUFFER const *b, unsigned tail, uint8_t *buffer, unsigned count)
+{
+    unsigned index;
+    unsigned first;
+
+    index = tail % b->buffer_len;
+    first = b->buffer_len - index;
+    if (first > count) {
+        first = count;
+    }
+    memcpy(buffer, (const uint8_t *)&b->buffer[index], first);
+    if (count > first) {
+        memcpy(&buffer[first], (const uint8_t *)&b->buffer[0], count - first);
+    }
+}
+
 /**
  * Returns the number of bytes in the FIFO
  *
@@ -153,27 +180,72 @@ uint8_t FIFO_Peek(FIFO_BUFFER const *b)
 unsigned FIFO_Peek_Ahead(FIFO_BUFFER const *b, uint8_t* buffer, unsigned length)
 {
     unsigned count = 0;
-    unsigned index;
-    unsigned tail;
-    unsigned i;
 
-    if (b) {
+    if (b && buffer) {
         count = FIFO_Count(b);
         if (count > length) {
             /* adjust to limit the number of bytes peeked */
             count = length;
         }
-        tail = b->tail;
-        for(i = 0; i < count; i++) {
-            index = tail % b->buffer_len;
-            buffer[i] = b->buffer[index];
-            tail++;
+        if (count) {
+            FIFO_Copy_Out(b, b->tail, buffer, count);
         }
     }
 
     return count;
 }
 
+/**
+ * Peeks at a byte ahead of the front of the FIFO without removing any data,
+ * such as for a parser that looks ahead into a frame.
+ *
+ * @param b - pointer to FIFO_BUFFER structure
+ * @param offset [in] - number of bytes from the front of the FIFO
+ * @param data_byte [out] - the byte at the offset
+ * @return true if the FIFO holds a byte at the offset
+ */
+bool FIFO_Peek_At(FIFO_BUFFER const *b, unsigned offset, uint8_t *data_byte)
+{
+    if (!b || (offset >= FIFO_Count(b))) {
+        return false;
+    }
+    if (data_byte) {
+        *data_byte = b->buffer[(b->tail + offset) % b->buffer_len];
+    }
+
+    return true;
+}
+
+/**
+ * Gets the bytes at the front of the FIFO that are contiguous in the data
+ * store, without removing them, so that they can be used in place and then
+ * removed with FIFO_Pull() with no buffer.
+ *
+ * @param b - pointer to FIFO_BUFFER structure
+ * @param data [out] - pointer to the first byte in the data store
+ * @return number of contiguous bytes, which are less than FIFO_Count()
+ *  when the data wraps around the end of the data store
+ */
+unsigned FIFO_Peek_Contiguous(FIFO_BUFFER const *b, const uint8_t **data)
+{
+    unsigned count;
+    unsigned index;
+
+    count = FIFO_Count(b);
+    if (count == 0) {
+        return 0;
+    }
+    index = b->tail % b->buffer_len;
+    if (count > (b->buffer_len - index)) {
+        count = b->buffer_len - index;
+    }
+    if (data) {
+        *data = (const uint8_t *)&b->buffer[index];
+    }
+
+    return count;
+}
+
 /**
  * Gets a byte from the front of the FIFO, and removes it.
  * Use FIFO_Empty() or FIFO_Available() function to see if there is
@@ -211,30 +283,23 @@ uint8_t FIFO_Get(FIFO_BUFFER *b)
 unsigned FIFO_Pull(FIFO_BUFFER *b, uint8_t *buffer, unsigned length)
 {
     unsigned count;
-    uint8_t data_byte;
-    unsigned index;
+    unsigned tail;
 
     count = FIFO_Count(b);
     if (count > length) {
         /* adjust to limit the number of bytes pulled */
         count = length;
     }
-    if (length > count) {
-        /* adjust the return value */
-        length = count;
-    }
-    while (count) {
-        index = b->tail % b->buffer_len;
-        data_byte = b->buffer[index];
-        b->tail++;
+    if (count) {
+        tail = b->tail;
         if (buffer) {
-            *buffer = data_byte;
-            buffer++;
+            FIFO_Copy_Out(b, tail, buffer, count);
         }
-        count--;
+        /* remove the bytes after they are copied */
+        b->tail = tail + count;
     }
 
-    return length;
+    return count;
 }
 
 /**
@@ -275,17 +340,24 @@ bool FIFO_Put(FIFO_BUFFER *b, uint8_t data_byte)
 bool FIFO_Add(FIFO_BUFFER *b, uint8_t *buffer, unsigned count)
 {
     bool status = false; /* return value */
+    unsigned head;
     unsigned index;
+    unsigned first;
 
     /* limit the buffer to prevent overwriting */
     if (FIFO_Available(b, count) && buffer) {
-        while (count) {
-            index = b->head % b->buffer_len;
-            b->buffer[index] = *buffer;
-            b->head++;
-            buffer++;
-            count--;
+        head = b->head;
+        index = head % b->buffer_len;
+        first = b->buffer_len - index;
+        if (first > count) {
+            first = count;
+        }
+        memcpy((uint8_t *)&b->buffer[index], buffer, first);
+        if (count > first) {
+            memcpy((uint8_t *)&b->buffer[0], &buffer[first], count - first);
         }
+        /* add the bytes after they are copied */
+        b->head = head + count;
         status = true;
     }
 
@@ -84,6 +84,17 @@ extern "C" {
         uint8_t* data_bytes,
         unsigned length);
 
+    BACNET_STACK_EXPORT
+    bool FIFO_Peek_At(
+        FIFO_BUFFER const *b,
+        unsigned offset,
+        uint8_t *data_byte);
+
+    BACNET_STACK_EXPORT
+    unsigned FIFO_Peek_Contiguous(
+        FIFO_BUFFER const *b,
+        const uint8_t **data);
+
     BACNET_STACK_EXPORT
     uint8_t FIFO_Get(
         FIFO_BUFFER * b);
@@ -3,8 +3,10 @@
  * @brief Key List library
  * @details This is an enhanced array of pointers to data.
  * The list is sorted, indexed, and keyed. The array is much faster
- * than a linked list.  It stores a pointer to data, which you must
- * malloc and free on your own, or just use static data.
+ * than a linked list.  The nodes are stored in the array itself,
+ * with no memory allocated for each node.  It stores a pointer to
+ * data, which you must malloc and free on your own, or just use
+ * static data.
  * @author Steve Karg <skarg@users.sourceforge.net>
  * @date 2003
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
@@ -12,21 +14,16 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/sys/memstats.h"
 
 /******************************************************************** */
 /* Generic node routines */
 /******************************************************************** */
 
-/** Grab memory for a node (Keylist_Node).
- *
- * @return Pointer to the allocated memory or
- *         NULL under an Out Of Memory situation.
- */
-static struct Keylist_Node *NodeCreate(void)
-{
-    return calloc(1, sizeof(struct Keylist_Node));
-}
+/* minimum number of nodes to allocate memory for */
+#define KEYLIST_CHUNK 8
 
 /** Grab memory for a list (Keylist).
  *
@@ -35,63 +32,151 @@ static struct Keylist_Node *NodeCreate(void)
  */
 static struct Keylist *KeylistCreate(void)
 {
-    return calloc(1, sizeof(struct Keylist));
+    return bacnet_memstats_calloc(MEMSTATS_KEYLIST, 1, sizeof(struct Keylist));
 }
 
 /** Check to see if the array is big enough for an addition
  * or is too big when we are deleting and we can shrink.
+ * The array doubles as it grows, so that adding a node costs
+ * amortized constant time, and halves when it is a quarter full.
  *
  * @param list  Pointer to the list to be tested.
  *
- * @return Returns true if success, false if failed
+ * @return Returns true if there is room for another node, false if not
  */
 static bool CheckArraySize(OS_Keylist list)
 {
     int new_size = 0; /* set it up so that no size change is the default */
-    const int chunk = 8; /* minimum number of nodes to allocate memory for */
-    struct Keylist_Node **new_array = NULL; /* new array of nodes, if needed */
-    int i; /* counter */
+    struct Keylist_Node *new_array = NULL; /* new array of nodes, if needed */
+
     if (!list) {
         return false;
     }
-
     /* indicates the need for more memory allocation */
     if (list->count == list->size) {
-        new_size = list->size + chunk;
-
+        if (list->size < KEYLIST_CHUNK) {
+            new_size = KEYLIST_CHUNK;
+        } else {
+            new_size = list->size * 2;
+        }
         /* allow for shrinking memory */
-    } else if ((list->size > chunk) && (list->count < (list->size - chunk))) {
-        new_size = list->size - chunk;
+    } else if ((list->size > KEYLIST_CHUNK) &&
+        (list->count < (list->size / 4))) {
+        new_size = list->size / 2;
     }
     if (new_size > 0) {
-        /* Allocate more room for node pointer array */
-        new_array = calloc((size_t)new_size, sizeof(struct Keylist_Node *));
-
+        new_array = bacnet_memstats_realloc(MEMSTATS_KEYLIST, list->array,
+            (size_t)list->size * sizeof(*new_array),
+            (size_t)new_size * sizeof(*new_array));
         /* See if we got the memory we wanted */
-        if (!new_array) {
-            return true;
+        if (new_array) {
+            list->array = new_array;
+            list->size = new_size;
         }
+    }
 
-        /* copy the nodes from the old array to the new array */
-        if (list->array) {
-            for (i = 0; i < list->count; i++) {
-                new_array[i] = list->array[i];
-            }
-            free(list->array);
+    return (list->count < list->size);
+}
+
+/** Merge two sorted runs of nodes, keeping the order of equal keys.
+ *
+ * @param dest  Nodes to merge into, with room for both runs
+ * @param left  First run of nodes
+ * @param left_count  Number of nodes in the first run
+ * @param right  Second run of nodes
+ * @param right_count  Number of nodes in the second run
+ */
+static void KeylistMerge(struct Keylist_Node *dest,
+    const struct Keylist_Node *left,
+    int left_count,
+    const struct Keylist_Node *right,
+    int right_count)
+{
+    while ((left_count > 0) && (right_count > 0)) {
+        if (right->key < left->key) {
+            *dest++ = *right++;
+            right_count--;
+        } else {
+            *dest++ = *left++;
+            left_count--;
         }
-        list->array = new_array;
-        list->size = new_size;
     }
+    while (left_count > 0) {
+        *dest++ = *left++;
+        left_count--;
+    }
+    while (right_count > 0) {
+        *dest++ = *right++;
+        right_count--;
+    }
+}
 
-    return true;
+/** Sort the nodes that were bulk added out of order.
+ * A stable merge sort keeps nodes with equal keys in the order
+ * that they were added.  If there is no memory for the merge,
+ * an insertion sort is used instead.
+ *
+ * @param list  Pointer to the list
+ */
+static void KeylistSort(OS_Keylist list)
+{
+    struct Keylist_Node *buffer;
+    struct Keylist_Node *source;
+    struct Keylist_Node *dest;
+    struct Keylist_Node *swap;
+    struct Keylist_Node node;
+    int width, left, middle, right;
+    int i, j;
+
+    if (!list || !list->unsorted) {
+        return;
+    }
+    list->unsorted = false;
+    buffer = bacnet_memstats_malloc(
+        MEMSTATS_KEYLIST, (size_t)list->count * sizeof(*buffer));
+    if (!buffer) {
+        for (i = 1; i < list->count; i++) {
+            node = list->array[i];
+            for (j = i; (j > 0) && (node.key < list->array[j - 1].key); j--) {
+                list->array[j] = list->array[j - 1];
+            }
+            list->array[j] = node;
+        }
+        return;
+    }
+    source = list->array;
+    dest = buffer;
+    for (width = 1; width < list->count; width *= 2) {
+        for (left = 0; left < list->count; left += 2 * width) {
+            middle = left + width;
+            if (middle > list->count) {
+                middle = list->count;
+            }
+            right = middle + width;
+            if (right > list->count) {
+                right = list->count;
+            }
+            KeylistMerge(&dest[left], &source[left], middle - left,
+                &source[middle], right - middle);
+        }
+        swap = source;
+        source = dest;
+        dest = swap;
+    }
+    if (source != list->array) {
+        memcpy(list->array, source, (size_t)list->count * sizeof(*buffer));
+    }
+    bacnet_memstats_free(
+        MEMSTATS_KEYLIST, buffer, (size_t)list->count * sizeof(*buffer));
 }
 
 /** Find the index of the key that we are looking for.
  * Since it is sorted, we can optimize the search.
  * returns true if found, and false not found.
- * Returns the found key and the index where it was found in parameters.
- * If the key is not found, the nearest index from the bottom will be returned,
- * allowing the ability to find where an key should go into the list.
+ * Returns the index of the first node with the key in the parameters.
+ * If the key is not found, the index of the first node with a larger key
+ * will be returned, allowing the ability to find where a key should go
+ * into the list.
  *
  * @param list  Pointer to the list
  * @param key  Key to search for
@@ -102,59 +187,36 @@ static bool CheckArraySize(OS_Keylist list)
  */
 static bool FindIndex(OS_Keylist list, KEY key, int *pIndex)
 {
-    struct Keylist_Node *node; /* holds the new node */
     int left = 0; /* the left branch of tree, beginning of list */
     int right = 0; /* the right branch on the tree, end of list */
     int index = 0; /* our current search place in the array */
-    KEY current_key = 0; /* place holder for current node key */
-    bool status = false; /* return value */
 
-    if (!list) {
+    if (!list || !list->array || !list->count) {
         *pIndex = 0;
         return false;
     }
-    if (!list->array || !list->count) {
-        *pIndex = 0;
-        return false;
-    }
-    right = list->count - 1;
-    /* assume that the list is sorted */
-    do {
-        /* A binary search */
-        index = (left + right) / 2;
-        node = list->array[index];
-        if (!node) {
-            break;
-        }
-        current_key = node->key;
-        if (key < current_key) {
-            right = index - 1;
-
-        } else {
+    KeylistSort(list);
+    right = list->count;
+    /* A binary search for the first node that is not less than the key */
+    while (left < right) {
+        index = left + ((right - left) / 2);
+        if (list->array[index].key < key) {
             left = index + 1;
-        }
-    } while ((key != current_key) && (left <= right));
-
-    if (key == current_key) {
-        status = true;
-        *pIndex = index;
-
-    } else {
-        /* where the index should be */
-        if (key > current_key) {
-            *pIndex = index + 1;
-
         } else {
-            *pIndex = index;
+            right = index;
         }
     }
-    return status;
+    *pIndex = left;
+
+    return (left < list->count) && (list->array[left].key == key);
 }
 
 /******************************************************************** */
 /* list data functions */
 /******************************************************************** */
 /** Inserts a node into its sorted position.
+ * A node with a key after all the other keys is appended in
+ * constant time, so adding nodes in key order is fast.
  *
  * @param list  Pointer to the list
  * @param key  Key to be inserted
@@ -166,42 +228,53 @@ static bool FindIndex(OS_Keylist list, KEY key, int *pIndex)
  */
 int Keylist_Data_Add(OS_Keylist list, KEY key, void *data)
 {
-    struct Keylist_Node *node; /* holds the new node */
     int index = -1; /* return value */
-    int i; /* counts through the array */
 
     if (list && CheckArraySize(list)) {
+        KeylistSort(list);
         /* figure out where to put the new node */
-        if (list->count) {
+        if ((list->count == 0) || (list->array[list->count - 1].key < key)) {
+            /* Add to the end of the list */
+            index = list->count;
+        } else {
             (void)FindIndex(list, key, &index);
-            if (index < 0) {
-                /* Add to the beginning of the list */
-                index = 0;
-
-            } else if (index > list->count) {
-                /* Add to the end of the list */
-                index = list->count;
-            }
             /* Move all the items up to make room for the new one */
-            for (i = list->count; i > index; i--) {
-                list->array[i] = list->array[i - 1];
-            }
-        } else {
-            index = 0;
-        }
-
-        /* create and add the node */
-        node = NodeCreate();
-        if (node) {
-            list->count++;
-            node->key = key;
-            node->data = data;
-            list->array[index] = node;
+            memmove(&list->array[index + 1], &list->array[index],
+                (size_t)(list->count - index) * sizeof(struct Keylist_Node));
         }
+        list->array[index].key = key;
+        list->array[index].data = data;
+        list->count++;
     }
+
     return index;
 }
 
+/** Appends a node without sorting, for loading many nodes at once.
+ * The list is sorted once, when it is next used, rather than
+ * moving the nodes for every node added.
+ * Nodes with equal keys are kept in the order they were added.
+ *
+ * @param list  Pointer to the list
+ * @param key  Key to be added
+ * @param data  Pointer to the data hold by the key.
+ * @return true if the node was added
+ */
+bool Keylist_Data_Bulk_Add(OS_Keylist list, KEY key, void *data)
+{
+    if (!list || !CheckArraySize(list)) {
+        return false;
+    }
+    if ((list->count > 0) && (key < list->array[list->count - 1].key)) {
+        list->unsorted = true;
+    }
+    list->array[list->count].key = key;
+    list->array[list->count].data = data;
+    list->count++;
+
+    return true;
+}
+
 /** Deletes a node specified by its index
  * returns the data from the node
  *
@@ -212,39 +285,25 @@ int Keylist_Data_Add(OS_Keylist list, KEY key, void *data)
  */
 void *Keylist_Data_Delete_By_Index(OS_Keylist list, int index)
 {
-    struct Keylist_Node *node;
     void *data = NULL;
 
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
-            if (node) {
-                data = node->data;
-            }
+            KeylistSort(list);
+            data = list->array[index].data;
             /* move the nodes to account for the deleted one */
-            if (list->count == 1) {
-                /* There is no node shifting to do */
-            } else if (index == (list->count - 1)) {
-                /* We are the last one */
-                /* There is no node shifting to do */
-            } else {
-                /* Move all the nodes down one */
-                int i; /* counter */
-                int count = list->count - 1;
-                for (i = index; i < count; i++) {
-                    list->array[i] = list->array[i + 1];
-                }
-            }
             list->count--;
-            if (node) {
-                free(node);
+            if (index < list->count) {
+                memmove(&list->array[index], &list->array[index + 1],
+                    (size_t)(list->count - index) *
+                        sizeof(struct Keylist_Node));
             }
-
             /* potentially reduce the size of the array */
             (void)CheckArraySize(list);
         }
     }
+
     return (data);
 }
 
@@ -280,7 +339,7 @@ void Keylist_Data_Free(OS_Keylist list)
     void *data;
     while (Keylist_Count(list) > 0) {
         data = Keylist_Data_Pop(list);
-        free(data);
+        bacnet_free(data);
     }
 }
 
@@ -321,7 +380,7 @@ void *Keylist_Data(OS_Keylist list, KEY key)
     if (list) {
         if (list->array && list->count) {
             if (FindIndex(list, key, &index)) {
-                node = list->array[index];
+                node = &list->array[index];
             }
         }
     }
@@ -363,7 +422,8 @@ void *Keylist_Data_Index(OS_Keylist list, int index)
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
+            KeylistSort(list);
+            node = &list->array[index];
         }
     }
     return node ? node->data : NULL;
@@ -385,10 +445,9 @@ KEY Keylist_Key(OS_Keylist list, int index)
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
-            if (node) {
-                key = node->key;
-            }
+            KeylistSort(list);
+            node = &list->array[index];
+            key = node->key;
         }
     }
     return key;
@@ -410,12 +469,11 @@ bool Keylist_Index_Key(OS_Keylist list, int index, KEY *pKey)
     if (list) {
         if (list->array && list->count && (index >= 0) &&
             (index < list->count)) {
-            node = list->array[index];
-            if (node) {
-                status = true;
-                if (pKey) {
-                    *pKey = node->key;
-                }
+            KeylistSort(list);
+            node = &list->array[index];
+            status = true;
+            if (pKey) {
+                *pKey = node->key;
             }
         }
     }
@@ -435,11 +493,17 @@ KEY Keylist_Next_Empty_Key(OS_Keylist list, KEY key)
     int index;
 
     if (list) {
-        while (FindIndex(list, key, &index)) {
-            if (KEY_LAST(key)) {
-                break;
+        /* walk the sorted nodes from the key, rather than
+           searching again for each key that is used */
+        (void)FindIndex(list, key, &index);
+        while ((index < list->count) && (list->array[index].key <= key)) {
+            if (list->array[index].key == key) {
+                if (KEY_LAST(key)) {
+                    break;
+                }
+                key++;
             }
-            key++;
+            index++;
         }
     }
 
@@ -477,7 +541,7 @@ OS_Keylist Keylist_Create(void)
 
     list = KeylistCreate();
     if (list) {
-        CheckArraySize(list);
+        (void)CheckArraySize(list);
     }
 
     return list;
@@ -490,14 +554,11 @@ OS_Keylist Keylist_Create(void)
 void Keylist_Delete(OS_Keylist list)
 { /* list number to be deleted */
     if (list) {
-        /* clean out the list */
-        while (list->count) {
-            (void)Keylist_Data_Delete_By_Index(list, 0);
-        }
         if (list->array) {
-            free(list->array);
+            bacnet_memstats_free(MEMSTATS_KEYLIST, list->array,
+                (size_t)list->size * sizeof(*list->array));
         }
-        free(list);
+        bacnet_memstats_free(MEMSTATS_KEYLIST, list, sizeof(struct Keylist));
     }
 
     return;
@@ -23,9 +23,10 @@ struct Keylist_Node {
 };
 
 typedef struct Keylist {
-    struct Keylist_Node **array;        /* array of nodes */
+    struct Keylist_Node *array;        /* array of nodes, stored in place */
     int count;  /* number of nodes in this list - more efficient than loop */
     int size;   /* number of available nodes on this list - can grow or shrink */
+    bool unsorted; /* nodes were bulk added out of order, sort before use */
 } KEYLIST_TYPE;
 typedef KEYLIST_TYPE *OS_Keylist;
 
@@ -52,6 +53,14 @@ extern "C" {
         KEY key,
         void *data);
 
+/* appends a node without sorting, for loading many nodes at once */
+/* the list is sorted when it is next used */
+    BACNET_STACK_EXPORT
+    bool Keylist_Data_Bulk_Add(
+        OS_Keylist list,
+        KEY key,
+        void *data);
+
 /* deletes a node specified by its key */
     BACNET_STACK_EXPORT
 /* returns the data from the node */
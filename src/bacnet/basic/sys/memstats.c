@@ -0,0 +1,341 @@
+/**
+ * @file
+ * @brief Optional accounting of the memory used by the subsystems of the
+ *  stack: the bytes allocated now and at the peak, the number of
+ *  allocations, frees, and failed allocations, and the bytes of the
+ *  tables that are sized at compile time.
+ * @note The counters are not atomic. When several threads allocate for
+ *  the same subsystem, a counter may miss some of the concurrent updates.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/basic/sys/memstats.h"
+
+#if BACNET_MEMSTATS
+static BACNET_MEMORY_STATS Memstats[MEMSTATS_SUBSYSTEM_MAX];
+/* the peak of all the subsystems at once */
+static size_t Memstats_Peak_Bytes;
+
+/**
+ * @brief Get the counters of a subsystem
+ * @param subsystem - the subsystem
+ * @param stats - the counters are copied here
+ * @return true if the subsystem is valid
+ */
+bool bacnet_memstats(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, BACNET_MEMORY_STATS *stats)
+{
+    if ((subsystem >= MEMSTATS_SUBSYSTEM_MAX) || !stats) {
+        return false;
+    }
+    memcpy(stats, &Memstats[subsystem], sizeof(*stats));
+
+    return true;
+}
+
+/**
+ * @brief Get the counters of all the subsystems together, where the peak
+ *  is the most that all of them allocated at once
+ * @param stats - the counters are copied here
+ */
+void bacnet_memstats_total(BACNET_MEMORY_STATS *stats)
+{
+    unsigned i;
+
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        stats->current_bytes += Memstats[i].current_bytes;
+        stats->allocations += Memstats[i].allocations;
+        stats->frees += Memstats[i].frees;
+        stats->failures += Memstats[i].failures;
+        stats->static_bytes += Memstats[i].static_bytes;
+    }
+    stats->peak_bytes = Memstats_Peak_Bytes;
+}
+
+/**
+ * @brief Clear the counts of allocations, frees and failures, and start
+ *  the peaks again from the bytes allocated now
+ */
+void bacnet_memstats_reset(void)
+{
+    unsigned i;
+
+    Memstats_Peak_Bytes = 0;
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        Memstats[i].peak_bytes = Memstats[i].current_bytes;
+        Memstats[i].allocations = 0;
+        Memstats[i].frees = 0;
+        Memstats[i].failures = 0;
+        Memstats_Peak_Bytes += Memstats[i].current_bytes;
+    }
+}
+
+/**
+ * @brief Note memory allocated for a subsystem
+ * @param subsystem - the subsystem
+ * @param bytes - number of bytes allocated
+ */
+void bacnet_memstats_allocated(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t bytes)
+{
+    BACNET_MEMORY_STATS *stats;
+    size_t total = 0;
+    unsigned i;
+
+    if (subsystem >= MEMSTATS_SUBSYSTEM_MAX) {
+        return;
+    }
+    stats = &Memstats[subsystem];
+    stats->allocations++;
+    stats->current_bytes += bytes;
+    if (stats->current_bytes > stats->peak_bytes) {
+        stats->peak_bytes = stats->current_bytes;
+    }
+    for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+        total += Memstats[i].current_bytes;
+    }
+    if (total > Memstats_Peak_Bytes) {
+        Memstats_Peak_Bytes = total;
+    }
+}
+
+/**
+ * @brief Note memory of a subsystem that was freed
+ * @param subsystem - the subsystem
+ * @param bytes - number of bytes freed
+ */
+void bacnet_memstats_released(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t bytes)
+{
+    BACNET_MEMORY_STATS *stats;
+
+    if (subsystem >= MEMSTATS_SUBSYSTEM_MAX) {
+        return;
+    }
+    stats = &Memstats[subsystem];
+    stats->frees++;
+    if (stats->current_bytes > bytes) {
+        stats->current_bytes -= bytes;
+    } else {
+        stats->current_bytes = 0;
+    }
+}
+
+/**
+ * @brief Note an allocation for a subsystem that failed
+ * @param subsystem - the subsystem
+ */
+void bacnet_memstats_failed(BACNET_MEMSTATS_SUBSYSTEM subsystem)
+{
+    if (subsystem < MEMSTATS_SUBSYSTEM_MAX) {
+        Memstats[subsystem].failures++;
+    }
+}
+
+/**
+ * @brief Set the bytes of the tables of a subsystem that are sized at
+ *  compile time, such as its static arrays
+ * @param subsystem - the subsystem
+ * @param bytes - number of bytes of the tables
+ */
+void bacnet_memstats_static(BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t bytes)
+{
+    if (subsystem < MEMSTATS_SUBSYSTEM_MAX) {
+        Memstats[subsystem].static_bytes = bytes;
+    }
+}
+
+/**
+ * @brief Allocate memory for a subsystem, like malloc()
+ * @param subsystem - the subsystem
+ * @param size - number of bytes
+ * @return the memory, or NULL if there is none
+ */
+void *bacnet_memstats_malloc(BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t size)
+{
+    void *ptr;
+
+    ptr = bacnet_malloc(size);
+    if (ptr) {
+        bacnet_memstats_allocated(subsystem, size);
+    } else {
+        bacnet_memstats_failed(subsystem);
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief Allocate zeroed memory for a subsystem, like calloc()
+ * @param subsystem - the subsystem
+ * @param nmemb - number of elements
+ * @param size - number of bytes of each element
+ * @return the memory, or NULL if there is none
+ */
+void *bacnet_memstats_calloc(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t nmemb, size_t size)
+{
+    void *ptr;
+
+    ptr = bacnet_calloc(nmemb, size);
+    if (ptr) {
+        bacnet_memstats_allocated(subsystem, nmemb * size);
+    } else {
+        bacnet_memstats_failed(subsystem);
+    }
+
+    return ptr;
+}
+
+/**
+ * @brief Resize memory of a subsystem, like realloc(). A resize is
+ *  counted as an allocation of the new size and a free of the old size.
+ * @param subsystem - the subsystem
+ * @param ptr - the memory, or NULL
+ * @param old_size - number of bytes of the memory, or 0 if ptr is NULL
+ * @param size - number of bytes wanted
+ * @return the memory, or NULL if there is none and ptr is unchanged
+ */
+void *bacnet_memstats_realloc(BACNET_MEMSTATS_SUBSYSTEM subsystem,
+    void *ptr,
+    size_t old_size,
+    size_t size)
+{
+    void *new_ptr;
+
+    new_ptr = bacnet_realloc(ptr, size);
+    if (new_ptr) {
+        if (ptr) {
+            bacnet_memstats_released(subsystem, old_size);
+        }
+        bacnet_memstats_allocated(subsystem, size);
+    } else {
+        bacnet_memstats_failed(subsystem);
+    }
+
+    return new_ptr;
+}
+
+/**
+ * @brief Free memory of a subsystem, like free()
+ * @param subsystem - the subsystem
+ * @param ptr - the memory, or NULL
+ * @param size - number of bytes that were allocated
+ */
+void bacnet_memstats_free(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, void *ptr, size_t size)
+{
+    if (ptr) {
+        bacnet_free(ptr);
+        bacnet_memstats_released(subsystem, size);
+    }
+}
+
+#if BACNET_MEMSTATS_PROPERTIES
+/**
+ * @brief Determine if a property is one of the proprietary Device object
+ *  properties of the counters
+ * @param property - property identifier
+ * @return true if the property shows a counter
+ */
+bool bacnet_memstats_property(BACNET_PROPERTY_ID property)
+{
+    return ((property >= PROP_MEMSTATS_CURRENT_BYTES) &&
+        (property <= PROP_MEMSTATS_STATIC_BYTES));
+}
+
+/**
+ * @brief Get the value of one counter of a subsystem
+ * @param property - property identifier of the counter
+ * @param stats - counters of the subsystem
+ * @return the value of the counter
+ */
+static BACNET_UNSIGNED_INTEGER memstats_property_value(
+    uint32_t property, const BACNET_MEMORY_STATS *stats)
+{
+    BACNET_UNSIGNED_INTEGER value = 0;
+
+    switch (property) {
+        case PROP_MEMSTATS_CURRENT_BYTES:
+            value = stats->current_bytes;
+            break;
+        case PROP_MEMSTATS_PEAK_BYTES:
+            value = stats->peak_bytes;
+            break;
+        case PROP_MEMSTATS_ALLOCATIONS:
+            value = stats->allocations;
+            break;
+        case PROP_MEMSTATS_FREES:
+            value = stats->frees;
+            break;
+        case PROP_MEMSTATS_FAILURES:
+            value = stats->failures;
+            break;
+        case PROP_MEMSTATS_STATIC_BYTES:
+            value = stats->static_bytes;
+            break;
+        default:
+            break;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Encode one of the proprietary Device object properties of the
+ *  counters, which is a BACnetARRAY with an element for each subsystem.
+ * @param property - property identifier of the counter
+ * @param array_index - BACNET_ARRAY_ALL, 0 for the size, or 1..N
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @param apdu_max - size of the buffer
+ * @return number of octets encoded, BACNET_STATUS_ERROR for an invalid
+ *  array index, or BACNET_STATUS_ABORT if the buffer is too small
+ */
+int bacnet_memstats_property_encode(BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int apdu_max)
+{
+    BACNET_UNSIGNED_INTEGER value;
+    int apdu_len = 0, len;
+    unsigned i;
+
+    if (array_index == 0) {
+        return encode_application_unsigned(apdu, MEMSTATS_SUBSYSTEM_MAX);
+    }
+    if (array_index == BACNET_ARRAY_ALL) {
+        for (i = 0; i < MEMSTATS_SUBSYSTEM_MAX; i++) {
+            value = memstats_property_value(property, &Memstats[i]);
+            len = encode_application_unsigned(NULL, value);
+            if ((apdu_len + len) > apdu_max) {
+                return BACNET_STATUS_ABORT;
+            }
+            if (apdu) {
+                len = encode_application_unsigned(&apdu[apdu_len], value);
+            }
+            apdu_len += len;
+        }
+        return apdu_len;
+    }
+    if (array_index > MEMSTATS_SUBSYSTEM_MAX) {
+        return BACNET_STATUS_ERROR;
+    }
+    value = memstats_property_value(property, &Memstats[array_index - 1]);
+
+    return encode_application_unsigned(apdu, value);
+}
+#endif
+#endif
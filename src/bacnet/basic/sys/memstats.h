@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief API for optional accounting of the memory used by the subsystems
+ *  of the stack: the bytes allocated now and at the peak, the number of
+ *  allocations, frees, and failed allocations, and the bytes of the
+ *  tables that are sized at compile time.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_MEMSTATS_H
+#define BACNET_SYS_MEMSTATS_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/static_pool.h"
+
+/* 1 to account for the memory of each subsystem.
+   0 removes the counters, and the allocation calls are plain calls
+   to the allocator of the library. */
+#ifndef BACNET_MEMSTATS
+#define BACNET_MEMSTATS 0
+#endif
+/* 1 to show the counters as proprietary properties of the Device object */
+#ifndef BACNET_MEMSTATS_PROPERTIES
+#define BACNET_MEMSTATS_PROPERTIES BACNET_MEMSTATS
+#endif
+/* first of the proprietary Device object properties. Each property is
+   a BACnetARRAY of Unsigned with one element for each subsystem, where
+   element N is the subsystem with the BACNET_MEMSTATS_SUBSYSTEM value
+   of N - 1. */
+#ifndef BACNET_MEMSTATS_PROPERTY_BASE
+#define BACNET_MEMSTATS_PROPERTY_BASE 9200
+#endif
+#define PROP_MEMSTATS_CURRENT_BYTES (BACNET_MEMSTATS_PROPERTY_BASE + 0)
+#define PROP_MEMSTATS_PEAK_BYTES (BACNET_MEMSTATS_PROPERTY_BASE + 1)
+#define PROP_MEMSTATS_ALLOCATIONS (BACNET_MEMSTATS_PROPERTY_BASE + 2)
+#define PROP_MEMSTATS_FREES (BACNET_MEMSTATS_PROPERTY_BASE + 3)
+#define PROP_MEMSTATS_FAILURES (BACNET_MEMSTATS_PROPERTY_BASE + 4)
+#define PROP_MEMSTATS_STATIC_BYTES (BACNET_MEMSTATS_PROPERTY_BASE + 5)
+
+/* the subsystems whose memory is accounted */
+typedef enum bacnet_memstats_subsystem {
+    /* the lists and node arrays of the Keylist library */
+    MEMSTATS_KEYLIST = 0,
+    /* the object data of the basic objects, from their pools */
+    MEMSTATS_OBJECT = 1,
+    /* the COV subscriptions, and the objects and properties they watch */
+    MEMSTATS_COV = 2,
+    /* the address cache */
+    MEMSTATS_ADDRESS = 3,
+    /* the transaction state machine and its segmentation buffers */
+    MEMSTATS_TSM = 4,
+    /* the records of the Trend Log objects */
+    MEMSTATS_TREND_LOG = 5,
+    MEMSTATS_SUBSYSTEM_MAX = 6
+} BACNET_MEMSTATS_SUBSYSTEM;
+
+/* counters of one subsystem */
+typedef struct bacnet_memory_stats {
+    /* bytes allocated now, and the most that were allocated at once */
+    size_t current_bytes;
+    size_t peak_bytes;
+    /* allocations and frees, and the allocations that failed */
+    uint32_t allocations;
+    uint32_t frees;
+    uint32_t failures;
+    /* bytes of the tables that are sized at compile time */
+    size_t static_bytes;
+} BACNET_MEMORY_STATS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if BACNET_MEMSTATS
+BACNET_STACK_EXPORT
+bool bacnet_memstats(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, BACNET_MEMORY_STATS *stats);
+BACNET_STACK_EXPORT
+void bacnet_memstats_total(BACNET_MEMORY_STATS *stats);
+BACNET_STACK_EXPORT
+void bacnet_memstats_reset(void);
+
+BACNET_STACK_EXPORT
+void bacnet_memstats_allocated(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t bytes);
+BACNET_STACK_EXPORT
+void bacnet_memstats_released(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t bytes);
+BACNET_STACK_EXPORT
+void bacnet_memstats_failed(BACNET_MEMSTATS_SUBSYSTEM subsystem);
+BACNET_STACK_EXPORT
+void bacnet_memstats_static(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t bytes);
+
+BACNET_STACK_EXPORT
+void *bacnet_memstats_malloc(BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t size);
+BACNET_STACK_EXPORT
+void *bacnet_memstats_calloc(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, size_t nmemb, size_t size);
+BACNET_STACK_EXPORT
+void *bacnet_memstats_realloc(BACNET_MEMSTATS_SUBSYSTEM subsystem,
+    void *ptr,
+    size_t old_size,
+    size_t size);
+BACNET_STACK_EXPORT
+void bacnet_memstats_free(
+    BACNET_MEMSTATS_SUBSYSTEM subsystem, void *ptr, size_t size);
+
+#if BACNET_MEMSTATS_PROPERTIES
+BACNET_STACK_EXPORT
+bool bacnet_memstats_property(BACNET_PROPERTY_ID property);
+BACNET_STACK_EXPORT
+int bacnet_memstats_property_encode(BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int apdu_max);
+#endif
+#else
+/* the subsystems call these without checking BACNET_MEMSTATS */
+#define bacnet_memstats_allocated(subsystem, bytes) \
+    ((void)(subsystem), (void)(bytes))
+#define bacnet_memstats_released(subsystem, bytes) \
+    ((void)(subsystem), (void)(bytes))
+#define bacnet_memstats_failed(subsystem) ((void)(subsystem))
+#define bacnet_memstats_static(subsystem, bytes) \
+    ((void)(subsystem), (void)(bytes))
+#define bacnet_memstats_malloc(subsystem, size) \
+    ((void)(subsystem), bacnet_malloc(size))
+#define bacnet_memstats_calloc(subsystem, nmemb, size) \
+    ((void)(subsystem), bacnet_calloc((nmemb), (size)))
+#define bacnet_memstats_realloc(subsystem, ptr, old_size, size) \
+    ((void)(subsystem), (void)(old_size), bacnet_realloc((ptr), (size)))
+#define bacnet_memstats_free(subsystem, ptr, size) \
+    ((void)(subsystem), (void)(size), bacnet_free(ptr))
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -39,6 +39,15 @@
 #define BACNET_STACK_DEPRECATED(message)
 #endif
 
+/* storage that each thread has its own copy of */
+#if defined(_MSC_VER)
+#define BACNET_STACK_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define BACNET_STACK_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define BACNET_STACK_THREAD_LOCAL __thread
+#endif
+
 #if defined(_MSC_VER)
 #ifndef strcasecmp
 #define strcasecmp _stricmp
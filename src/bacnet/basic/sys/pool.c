@@ -0,0 +1,224 @@
+/**
+ * @file
+ * @brief A pool of fixed size elements, allocated from slabs of many
+ *  elements, and returned to the pool to be used again.  This suits the
+ *  objects that are created in number, such as thousands of objects of
+ *  one type provisioned at boot: a few allocations and contiguous memory
+ *  instead of an allocation for each object.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bacnet/basic/sys/memstats.h"
+#include "bacnet/basic/sys/pool.h"
+
+/* elements are aligned for any of these types */
+union pool_align {
+    void *pointer;
+    double real;
+    uint64_t unsigned64;
+    long integer;
+};
+#define POOL_ALIGNMENT sizeof(union pool_align)
+
+/* the start of each slab, before its elements */
+union pool_slab {
+    struct {
+        union pool_slab *next;
+        /* number of elements of the slab */
+        size_t count;
+    } header;
+    union pool_align align;
+};
+
+/* an element that is not in use */
+struct pool_element {
+    struct pool_element *next;
+};
+
+/**
+ * @brief Initialize a pool of elements, without any slabs
+ * @param pool - pool to be initialized
+ * @param element_size - size, in bytes, of one element
+ * @param slab_count - number of elements of the first slab, where each
+ *  further slab is as large as all of the slabs before it, up to
+ *  POOL_SLAB_COUNT_MAX. Zero uses POOL_SLAB_COUNT_DEFAULT.
+ */
+void pool_init(POOL_BUFFER *pool, size_t element_size, size_t slab_count)
+{
+    if (pool) {
+        if (element_size < sizeof(struct pool_element)) {
+            element_size = sizeof(struct pool_element);
+        }
+        /* round up, so that each element of a slab is aligned */
+        pool->element_size = ((element_size + POOL_ALIGNMENT - 1) /
+            POOL_ALIGNMENT) * POOL_ALIGNMENT;
+        pool->slab_count = slab_count ? slab_count : POOL_SLAB_COUNT_DEFAULT;
+        pool->slabs = NULL;
+        pool->free_list = NULL;
+        pool->count = 0;
+        pool->capacity = 0;
+    }
+}
+
+/**
+ * @brief Allocate a slab of elements, and add them to the free list
+ * @param pool - pool to grow
+ * @param count - number of elements of the slab
+ * @return true if the slab was allocated
+ */
+static bool pool_slab_add(POOL_BUFFER *pool, size_t count)
+{
+    union pool_slab *slab;
+    struct pool_element *element;
+    uint8_t *data;
+    size_t i;
+
+    if ((count == 0) ||
+        (count > ((SIZE_MAX - sizeof(union pool_slab)) / pool->element_size))) {
+        return false;
+    }
+    slab = bacnet_memstats_malloc(MEMSTATS_OBJECT,
+        sizeof(union pool_slab) + (count * pool->element_size));
+    if (!slab) {
+        return false;
+    }
+    slab->header.next = pool->slabs;
+    slab->header.count = count;
+    pool->slabs = slab;
+    data = (uint8_t *)(slab + 1);
+    /* the first element of the slab is the first to be allocated, so
+       that elements allocated one after another are next to each other */
+    i = count;
+    while (i > 0) {
+        i--;
+        element = (struct pool_element *)(void *)&data[i * pool->element_size];
+        element->next = pool->free_list;
+        pool->free_list = element;
+    }
+    pool->capacity += count;
+
+    return true;
+}
+
+/**
+ * @brief Allocate a zeroed element from a pool, like calloc()
+ * @param pool - pool to allocate from
+ * @return the element, or NULL if the pool was not initialized or there
+ *  is no memory for another slab
+ */
+void *pool_calloc(POOL_BUFFER *pool)
+{
+    struct pool_element *element;
+    size_t count;
+
+    if (!pool || (pool->element_size == 0)) {
+        return NULL;
+    }
+    if (!pool->free_list) {
+        count = pool->capacity ? pool->capacity : pool->slab_count;
+        if (count > POOL_SLAB_COUNT_MAX) {
+            count = POOL_SLAB_COUNT_MAX;
+        }
+        if (count < pool->slab_count) {
+            count = pool->slab_count;
+        }
+        if (!pool_slab_add(pool, count)) {
+            return NULL;
+        }
+    }
+    element = pool->free_list;
+    pool->free_list = element->next;
+    pool->count++;
+    memset(element, 0, pool->element_size);
+
+    return element;
+}
+
+/**
+ * @brief Return an element to a pool, like free()
+ * @param pool - pool the element was allocated from
+ * @param element - the element, or NULL
+ */
+void pool_free(POOL_BUFFER *pool, void *element)
+{
+    struct pool_element *free_element = element;
+
+    if (pool && free_element) {
+        free_element->next = pool->free_list;
+        pool->free_list = free_element;
+        if (pool->count) {
+            pool->count--;
+        }
+    }
+}
+
+/**
+ * @brief Make sure a number of elements can be allocated from a pool
+ *  without another allocation, such as before creating many objects, so
+ *  that they are taken from one contiguous slab
+ * @param pool - pool to grow
+ * @param count - number of elements that will be allocated
+ * @return true if the elements are available
+ */
+bool pool_reserve(POOL_BUFFER *pool, size_t count)
+{
+    size_t available;
+
+    if (!pool || (pool->element_size == 0)) {
+        return false;
+    }
+    available = pool->capacity - pool->count;
+    if (available >= count) {
+        return true;
+    }
+
+    return pool_slab_add(pool, count - available);
+}
+
+/**
+ * @brief Release all of the slabs of a pool, and all of its elements.
+ *  The pool keeps its element size, and can be used again.
+ * @param pool - pool to be cleaned up
+ */
+void pool_cleanup(POOL_BUFFER *pool)
+{
+    union pool_slab *slab;
+
+    if (pool) {
+        while (pool->slabs) {
+            slab = pool->slabs;
+            pool->slabs = slab->header.next;
+            bacnet_memstats_free(MEMSTATS_OBJECT, slab,
+                sizeof(union pool_slab) +
+                    (slab->header.count * pool->element_size));
+        }
+        pool->free_list = NULL;
+        pool->count = 0;
+        pool->capacity = 0;
+    }
+}
+
+/**
+ * @brief Get the number of elements in use in a pool
+ * @param pool - pool
+ * @return number of elements in use
+ */
+size_t pool_count(const POOL_BUFFER *pool)
+{
+    return (pool ? pool->count : 0);
+}
+
+/**
+ * @brief Get the number of elements of all of the slabs of a pool
+ * @param pool - pool
+ * @return number of elements in use and free
+ */
+size_t pool_capacity(const POOL_BUFFER *pool)
+{
+    return (pool ? pool->capacity : 0);
+}
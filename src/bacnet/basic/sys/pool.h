@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @brief API for a pool of fixed size elements, that are allocated from
+ *  slabs of many elements, and returned to the pool to be used again.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_POOL_H
+#define BACNET_SYS_POOL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* number of elements of the first slab, when not given to pool_init() */
+#ifndef POOL_SLAB_COUNT_DEFAULT
+#define POOL_SLAB_COUNT_DEFAULT 8
+#endif
+/* most elements of a slab that the pool grows by itself */
+#ifndef POOL_SLAB_COUNT_MAX
+#define POOL_SLAB_COUNT_MAX 1024
+#endif
+
+struct pool_buffer_t {
+    size_t element_size; /* size, in bytes, of one element */
+    size_t slab_count; /* number of elements of the next slab */
+    void *slabs; /* the slabs of memory, each linked to the next */
+    void *free_list; /* the elements that are not in use */
+    size_t count; /* number of elements in use */
+    size_t capacity; /* number of elements of all the slabs */
+};
+typedef struct pool_buffer_t POOL_BUFFER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void pool_init(POOL_BUFFER *pool, size_t element_size, size_t slab_count);
+BACNET_STACK_EXPORT
+void *pool_calloc(POOL_BUFFER *pool);
+BACNET_STACK_EXPORT
+void pool_free(POOL_BUFFER *pool, void *element);
+BACNET_STACK_EXPORT
+bool pool_reserve(POOL_BUFFER *pool, size_t count);
+BACNET_STACK_EXPORT
+void pool_cleanup(POOL_BUFFER *pool);
+BACNET_STACK_EXPORT
+size_t pool_count(const POOL_BUFFER *pool);
+BACNET_STACK_EXPORT
+size_t pool_capacity(const POOL_BUFFER *pool);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @file
+ * @brief A lock-free ring buffer of fixed size elements for one producer
+ *  and one consumer.
+ * @details The producer writes an element and then publishes it with a
+ *  release store of the head, and the consumer sees it with an acquire
+ *  load of the head before reading the element. In the same way, the
+ *  consumer releases an element with a release store of the tail, and
+ *  the producer reuses it after an acquire load of the tail. Each index
+ *  has one writer, so there is no read-modify-write and no lock.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/ringbuf_spsc.h"
+
+#if RINGBUF_SPSC_ATOMICS
+#define RINGBUF_SPSC_LOAD(p) atomic_load_explicit((p), memory_order_relaxed)
+#define RINGBUF_SPSC_ACQUIRE(p) atomic_load_explicit((p), memory_order_acquire)
+#define RINGBUF_SPSC_RELEASE(p, v) \
+    atomic_store_explicit((p), (v), memory_order_release)
+#define RINGBUF_SPSC_SET(p, v) atomic_init((p), (v))
+#elif defined(__GNUC__)
+#define RINGBUF_SPSC_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define RINGBUF_SPSC_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RINGBUF_SPSC_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define RINGBUF_SPSC_SET(p, v) (*(p) = (v))
+#else
+/* volatile accesses are ordered only on a single core */
+#define RINGBUF_SPSC_LOAD(p) (*(p))
+#define RINGBUF_SPSC_ACQUIRE(p) (*(p))
+#define RINGBUF_SPSC_RELEASE(p, v) (*(p) = (v))
+#define RINGBUF_SPSC_SET(p, v) (*(p) = (v))
+#endif
+
+/**
+ * @brief Get the address of an element
+ * @param b - ring buffer
+ * @param index - head or tail
+ * @return address of the element
+ */
+static uint8_t *ringbuf_spsc_element(const RINGBUF_SPSC *b, unsigned index)
+{
+    return &b->buffer[(index & (b->element_count - 1)) * b->element_size];
+}
+
+/**
+ * @brief Initialize the ring buffer, empty
+ * @param b - ring buffer
+ * @param buffer - memory of element_size * element_count bytes
+ * @param element_size - number of bytes of each element
+ * @param element_count - number of elements, a power of two
+ * @return true if the ring buffer was initialized
+ */
+bool Ringbuf_SPSC_Init(RINGBUF_SPSC *b,
+    uint8_t *buffer,
+    unsigned element_size,
+    unsigned element_count)
+{
+    if (!b || !buffer || (element_size == 0) || (element_count == 0)) {
+        return false;
+    }
+    if ((element_count & (element_count - 1)) != 0) {
+        /* not a power of two */
+        return false;
+    }
+    b->buffer = buffer;
+    b->element_size = element_size;
+    b->element_count = element_count;
+    RINGBUF_SPSC_SET(&b->head, 0);
+    RINGBUF_SPSC_SET(&b->tail, 0);
+
+    return true;
+}
+
+/**
+ * @brief Get the number of elements in the ring buffer, which is exact
+ *  for the producer and the consumer, and can be out of date for anyone
+ *  else
+ * @param b - ring buffer
+ * @return number of elements
+ */
+unsigned Ringbuf_SPSC_Count(RINGBUF_SPSC *b)
+{
+    unsigned head, tail;
+
+    if (!b) {
+        return 0;
+    }
+    tail = RINGBUF_SPSC_ACQUIRE(&b->tail);
+    head = RINGBUF_SPSC_ACQUIRE(&b->head);
+
+    return head - tail;
+}
+
+/**
+ * @brief Get the number of elements that fit in the ring buffer
+ * @param b - ring buffer
+ * @return number of elements
+ */
+unsigned Ringbuf_SPSC_Size(const RINGBUF_SPSC *b)
+{
+    return (b ? b->element_count : 0);
+}
+
+/**
+ * @brief Determine if the ring buffer is empty
+ * @param b - ring buffer
+ * @return true if empty
+ */
+bool Ringbuf_SPSC_Empty(RINGBUF_SPSC *b)
+{
+    return (Ringbuf_SPSC_Count(b) == 0);
+}
+
+/**
+ * @brief Determine if the ring buffer is full
+ * @param b - ring buffer
+ * @return true if full
+ */
+bool Ringbuf_SPSC_Full(RINGBUF_SPSC *b)
+{
+    return (b ? (Ringbuf_SPSC_Count(b) >= b->element_count) : true);
+}
+
+/**
+ * @brief Producer: get the head element to be written in place, which
+ *  is added with Ringbuf_SPSC_Data_Put()
+ * @param b - ring buffer
+ * @return address of the element, or NULL if the ring buffer is full
+ */
+void *Ringbuf_SPSC_Data_Peek(RINGBUF_SPSC *b)
+{
+    unsigned head, tail;
+
+    if (!b) {
+        return NULL;
+    }
+    head = RINGBUF_SPSC_LOAD(&b->head);
+    tail = RINGBUF_SPSC_ACQUIRE(&b->tail);
+    if ((head - tail) >= b->element_count) {
+        return NULL;
+    }
+
+    return ringbuf_spsc_element(b, head);
+}
+
+/**
+ * @brief Producer: add the head element that was written in place
+ * @param b - ring buffer
+ * @param data_element - the element from Ringbuf_SPSC_Data_Peek()
+ * @return true if the element was added
+ */
+bool Ringbuf_SPSC_Data_Put(RINGBUF_SPSC *b, const void *data_element)
+{
+    unsigned head;
+
+    if (!b || !data_element) {
+        return false;
+    }
+    head = RINGBUF_SPSC_LOAD(&b->head);
+    if (data_element != ringbuf_spsc_element(b, head)) {
+        return false;
+    }
+    RINGBUF_SPSC_RELEASE(&b->head, head + 1);
+
+    return true;
+}
+
+/**
+ * @brief Producer: copy an element into the ring buffer
+ * @param b - ring buffer
+ * @param data_element - element_size bytes of data
+ * @return true if the element was added, false if full
+ */
+bool Ringbuf_SPSC_Put(RINGBUF_SPSC *b, const uint8_t *data_element)
+{
+    void *element;
+
+    if (!data_element) {
+        return false;
+    }
+    element = Ringbuf_SPSC_Data_Peek(b);
+    if (!element) {
+        return false;
+    }
+    memcpy(element, data_element, b->element_size);
+
+    return Ringbuf_SPSC_Data_Put(b, element);
+}
+
+/**
+ * @brief Consumer: get the tail element to be read in place, which is
+ *  removed with Ringbuf_SPSC_Pop()
+ * @param b - ring buffer
+ * @return address of the element, or NULL if the ring buffer is empty
+ */
+void *Ringbuf_SPSC_Peek(RINGBUF_SPSC *b)
+{
+    unsigned head, tail;
+
+    if (!b) {
+        return NULL;
+    }
+    tail = RINGBUF_SPSC_LOAD(&b->tail);
+    head = RINGBUF_SPSC_ACQUIRE(&b->head);
+    if (head == tail) {
+        return NULL;
+    }
+
+    return ringbuf_spsc_element(b, tail);
+}
+
+/**
+ * @brief Consumer: remove the tail element
+ * @param b - ring buffer
+ * @param data_element - element_size bytes to copy the element into,
+ *  or NULL after the element was used in place
+ * @return true if an element was removed, false if empty
+ */
+bool Ringbuf_SPSC_Pop(RINGBUF_SPSC *b, uint8_t *data_element)
+{
+    unsigned tail;
+    void *element;
+
+    element = Ringbuf_SPSC_Peek(b);
+    if (!element) {
+        return false;
+    }
+    if (data_element) {
+        memcpy(data_element, element, b->element_size);
+    }
+    tail = RINGBUF_SPSC_LOAD(&b->tail);
+    RINGBUF_SPSC_RELEASE(&b->tail, tail + 1);
+
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief API for a lock-free ring buffer of fixed size elements for one
+ *  producer and one consumer, such as an interrupt and a task, or two
+ *  threads, that hand off data without disabling interrupts or taking
+ *  a mutex.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef RINGBUF_SPSC_H
+#define RINGBUF_SPSC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* the indexes use C11 atomics when the compiler has them, otherwise
+   the GCC atomic builtins or volatile on a single core */
+#if !defined(__cplusplus) && defined(__STDC_VERSION__) && \
+    (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define RINGBUF_SPSC_ATOMICS 1
+typedef atomic_uint ringbuf_spsc_index_t;
+#else
+#define RINGBUF_SPSC_ATOMICS 0
+typedef volatile unsigned ringbuf_spsc_index_t;
+#endif
+
+/**
+ * Ring buffer for one producer and one consumer. The head is written
+ * only by the producer, and the tail only by the consumer. Both count
+ * up and wrap around, and an element is indexed by the count modulo
+ * the element count.
+ */
+struct ringbuf_spsc_t {
+    /** block of memory or array of data */
+    uint8_t *buffer;
+    /** how many bytes for each chunk */
+    unsigned element_size;
+    /** number of chunks of data, a power of two */
+    unsigned element_count;
+    /** where the writes go */
+    ringbuf_spsc_index_t head;
+    /** where the reads come from */
+    ringbuf_spsc_index_t tail;
+};
+typedef struct ringbuf_spsc_t RINGBUF_SPSC;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool Ringbuf_SPSC_Init(RINGBUF_SPSC *b,
+    uint8_t *buffer,
+    unsigned element_size,
+    unsigned element_count);
+BACNET_STACK_EXPORT
+unsigned Ringbuf_SPSC_Count(RINGBUF_SPSC *b);
+BACNET_STACK_EXPORT
+unsigned Ringbuf_SPSC_Size(const RINGBUF_SPSC *b);
+BACNET_STACK_EXPORT
+bool Ringbuf_SPSC_Empty(RINGBUF_SPSC *b);
+BACNET_STACK_EXPORT
+bool Ringbuf_SPSC_Full(RINGBUF_SPSC *b);
+/* producer: claim the head element in place, then commit it */
+BACNET_STACK_EXPORT
+void *Ringbuf_SPSC_Data_Peek(RINGBUF_SPSC *b);
+BACNET_STACK_EXPORT
+bool Ringbuf_SPSC_Data_Put(RINGBUF_SPSC *b, const void *data_element);
+BACNET_STACK_EXPORT
+bool Ringbuf_SPSC_Put(RINGBUF_SPSC *b, const uint8_t *data_element);
+/* consumer: use the tail element in place, then release it */
+BACNET_STACK_EXPORT
+void *Ringbuf_SPSC_Peek(RINGBUF_SPSC *b);
+BACNET_STACK_EXPORT
+bool Ringbuf_SPSC_Pop(RINGBUF_SPSC *b, uint8_t *data_element);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
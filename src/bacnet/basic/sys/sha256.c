@@ -0,0 +1,258 @@
+/**
+ * @file
+ * @brief The SHA-256 hash of FIPS 180-4, and the HMAC-SHA256 message
+ *  signature of RFC 2104, in portable C.  A port with SHA instructions
+ *  replaces the hash of a block with bacnet_sha256_port_block().
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/sha256.h"
+
+#if !BACNET_SHA256_PORT_BLOCK
+static const uint32_t SHA256_K[64] = { 0x428a2f98UL, 0x71374491UL,
+    0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL,
+    0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL, 0x243185beUL, 0x550c7dc3UL,
+    0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL, 0xe49b69c1UL,
+    0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL,
+    0x5cb0a9dcUL, 0x76f988daUL, 0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL,
+    0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL,
+    0x27b70a85UL, 0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL, 0x650a7354UL,
+    0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL, 0xa2bfe8a1UL, 0xa81a664bUL,
+    0xc24b8b70UL, 0xc76c51a3UL, 0xd192e819UL, 0xd6990624UL, 0xf40e3585UL,
+    0x106aa070UL, 0x19a4c116UL, 0x1e376c08UL, 0x2748774cUL, 0x34b0bcb5UL,
+    0x391c0cb3UL, 0x4ed8aa4aUL, 0x5b9cca4fUL, 0x682e6ff3UL, 0x748f82eeUL,
+    0x78a5636fUL, 0x84c87814UL, 0x8cc70208UL, 0x90befffaUL, 0xa4506cebUL,
+    0xbef9a3f7UL, 0xc67178f2UL };
+
+#define SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+/**
+ * @brief Hash one block into the state
+ * @param state - the hash state
+ * @param block - the 64 octets of the block
+ */
+static void sha256_block(
+    uint32_t state[8], const uint8_t block[BACNET_SHA256_BLOCK_SIZE])
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t t1, t2;
+    unsigned i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[i * 4] << 24) |
+            ((uint32_t)block[i * 4 + 1] << 16) |
+            ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+    }
+    for (i = 16; i < 64; i++) {
+        t1 = SHA256_ROTR(w[i - 2], 17) ^ SHA256_ROTR(w[i - 2], 19) ^
+            (w[i - 2] >> 10);
+        t2 = SHA256_ROTR(w[i - 15], 7) ^ SHA256_ROTR(w[i - 15], 18) ^
+            (w[i - 15] >> 3);
+        w[i] = t1 + w[i - 7] + t2 + w[i - 16];
+    }
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
+    for (i = 0; i < 64; i++) {
+        t1 = h +
+            (SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25)) +
+            ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        t2 = (SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22)) +
+            ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+#else
+#define sha256_block bacnet_sha256_port_block
+#endif
+
+/**
+ * @brief Start a hash
+ * @param ctx - the hash
+ */
+void bacnet_sha256_init(BACNET_SHA256 *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    ctx->state[0] = 0x6a09e667UL;
+    ctx->state[1] = 0xbb67ae85UL;
+    ctx->state[2] = 0x3c6ef372UL;
+    ctx->state[3] = 0xa54ff53aUL;
+    ctx->state[4] = 0x510e527fUL;
+    ctx->state[5] = 0x9b05688cUL;
+    ctx->state[6] = 0x1f83d9abUL;
+    ctx->state[7] = 0x5be0cd19UL;
+    ctx->length = 0;
+    ctx->block_len = 0;
+}
+
+/**
+ * @brief Add data to a hash
+ * @param ctx - the hash
+ * @param data - the data
+ * @param length - number of octets of the data
+ */
+void bacnet_sha256_update(
+    BACNET_SHA256 *ctx, const uint8_t *data, size_t length)
+{
+    size_t count;
+
+    if (!ctx || !data) {
+        return;
+    }
+    ctx->length += length;
+    if (ctx->block_len > 0) {
+        count = BACNET_SHA256_BLOCK_SIZE - ctx->block_len;
+        if (count > length) {
+            count = length;
+        }
+        memcpy(&ctx->block[ctx->block_len], data, count);
+        ctx->block_len += (unsigned)count;
+        data += count;
+        length -= count;
+        if (ctx->block_len < BACNET_SHA256_BLOCK_SIZE) {
+            return;
+        }
+        sha256_block(ctx->state, ctx->block);
+        ctx->block_len = 0;
+    }
+    /* whole blocks are hashed where they are */
+    while (length >= BACNET_SHA256_BLOCK_SIZE) {
+        sha256_block(ctx->state, data);
+        data += BACNET_SHA256_BLOCK_SIZE;
+        length -= BACNET_SHA256_BLOCK_SIZE;
+    }
+    if (length > 0) {
+        memcpy(ctx->block, data, length);
+        ctx->block_len = (unsigned)length;
+    }
+}
+
+/**
+ * @brief End a hash
+ * @param ctx - the hash, which is started again to be used again
+ * @param digest - returns the 32 octets of the hash
+ */
+void bacnet_sha256_final(
+    BACNET_SHA256 *ctx, uint8_t digest[BACNET_SHA256_DIGEST_SIZE])
+{
+    uint64_t bits;
+    unsigned i;
+
+    if (!ctx || !digest) {
+        return;
+    }
+    bits = ctx->length * 8;
+    ctx->block[ctx->block_len++] = 0x80;
+    if (ctx->block_len > (BACNET_SHA256_BLOCK_SIZE - 8)) {
+        memset(&ctx->block[ctx->block_len], 0,
+            BACNET_SHA256_BLOCK_SIZE - ctx->block_len);
+        sha256_block(ctx->state, ctx->block);
+        ctx->block_len = 0;
+    }
+    memset(&ctx->block[ctx->block_len], 0,
+        (BACNET_SHA256_BLOCK_SIZE - 8) - ctx->block_len);
+    for (i = 0; i < 8; i++) {
+        ctx->block[BACNET_SHA256_BLOCK_SIZE - 1 - i] =
+            (uint8_t)(bits >> (i * 8));
+    }
+    sha256_block(ctx->state, ctx->block);
+    for (i = 0; i < 8; i++) {
+        digest[i * 4] = (uint8_t)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)ctx->state[i];
+    }
+    bacnet_sha256_init(ctx);
+}
+
+/**
+ * @brief Prepare the HMAC of a key, by hashing its padded inner and outer
+ *  keys once for all the messages that it signs
+ * @param hmac - the HMAC of the key
+ * @param key - the key
+ * @param key_length - number of octets of the key
+ */
+void bacnet_hmac_sha256_init(
+    BACNET_HMAC_SHA256 *hmac, const uint8_t *key, size_t key_length)
+{
+    uint8_t pad[BACNET_SHA256_BLOCK_SIZE] = { 0 };
+    unsigned i;
+
+    if (!hmac) {
+        return;
+    }
+    if (key && (key_length > BACNET_SHA256_BLOCK_SIZE)) {
+        bacnet_sha256_init(&hmac->inner);
+        bacnet_sha256_update(&hmac->inner, key, key_length);
+        bacnet_sha256_final(&hmac->inner, pad);
+    } else if (key) {
+        memcpy(pad, key, key_length);
+    }
+    for (i = 0; i < BACNET_SHA256_BLOCK_SIZE; i++) {
+        pad[i] ^= 0x36;
+    }
+    bacnet_sha256_init(&hmac->inner);
+    bacnet_sha256_update(&hmac->inner, pad, sizeof(pad));
+    for (i = 0; i < BACNET_SHA256_BLOCK_SIZE; i++) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    bacnet_sha256_init(&hmac->outer);
+    bacnet_sha256_update(&hmac->outer, pad, sizeof(pad));
+    memset(pad, 0, sizeof(pad));
+}
+
+/**
+ * @brief Sign a message with a prepared key
+ * @param hmac - the HMAC of the key
+ * @param data - the message
+ * @param length - number of octets of the message
+ * @param digest - returns the 32 octets of the signature
+ */
+void bacnet_hmac_sha256(const BACNET_HMAC_SHA256 *hmac,
+    const uint8_t *data,
+    size_t length,
+    uint8_t digest[BACNET_SHA256_DIGEST_SIZE])
+{
+    BACNET_SHA256 ctx;
+    uint8_t inner[BACNET_SHA256_DIGEST_SIZE];
+
+    if (!hmac || !digest) {
+        return;
+    }
+    ctx = hmac->inner;
+    bacnet_sha256_update(&ctx, data, length);
+    bacnet_sha256_final(&ctx, inner);
+    ctx = hmac->outer;
+    bacnet_sha256_update(&ctx, inner, sizeof(inner));
+    bacnet_sha256_final(&ctx, digest);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief API for the SHA-256 hash and the HMAC-SHA256 message signature,
+ *  such as for the signature of the BACnet security wrapper of Clause 24.
+ *  The HMAC of a key is prepared once, so that each message it signs
+ *  costs only the hash of the message.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_SHA256_H
+#define BACNET_SYS_SHA256_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+#define BACNET_SHA256_BLOCK_SIZE 64
+#define BACNET_SHA256_DIGEST_SIZE 32
+
+/* the ports module implements bacnet_sha256_port_block() to hash a block
+   with the SHA instructions of the processor, such as x86 SHA-NI or the
+   ARMv8 cryptography extensions */
+#ifndef BACNET_SHA256_PORT_BLOCK
+#define BACNET_SHA256_PORT_BLOCK 0
+#endif
+
+typedef struct bacnet_sha256 {
+    uint32_t state[8];
+    /* number of octets hashed */
+    uint64_t length;
+    uint8_t block[BACNET_SHA256_BLOCK_SIZE];
+    unsigned block_len;
+} BACNET_SHA256;
+
+/**
+ * The HMAC of one key: the hashes of the inner and outer padded keys,
+ * which are copied for each message that is signed.
+ */
+typedef struct bacnet_hmac_sha256 {
+    BACNET_SHA256 inner;
+    BACNET_SHA256 outer;
+} BACNET_HMAC_SHA256;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_sha256_init(BACNET_SHA256 *ctx);
+BACNET_STACK_EXPORT
+void bacnet_sha256_update(
+    BACNET_SHA256 *ctx, const uint8_t *data, size_t length);
+BACNET_STACK_EXPORT
+void bacnet_sha256_final(
+    BACNET_SHA256 *ctx, uint8_t digest[BACNET_SHA256_DIGEST_SIZE]);
+
+BACNET_STACK_EXPORT
+void bacnet_hmac_sha256_init(
+    BACNET_HMAC_SHA256 *hmac, const uint8_t *key, size_t key_length);
+BACNET_STACK_EXPORT
+void bacnet_hmac_sha256(const BACNET_HMAC_SHA256 *hmac,
+    const uint8_t *data,
+    size_t length,
+    uint8_t digest[BACNET_SHA256_DIGEST_SIZE]);
+
+#if BACNET_SHA256_PORT_BLOCK
+/* implement in ports module when BACNET_SHA256_PORT_BLOCK is set */
+void bacnet_sha256_port_block(
+    uint32_t state[8], const uint8_t block[BACNET_SHA256_BLOCK_SIZE]);
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,291 @@
+/**
+ * @file
+ * @brief The heap-free build, where the memory that the library allocates
+ *  is taken from static pools of fixed size blocks.  Each block size has
+ *  its own pool and free list, so that an allocation or a free takes a
+ *  bounded time, and the blocks of one size do not fragment the others.
+ * @note The pools are not protected from concurrent use. When several
+ *  threads allocate, the caller must serialize the calls.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/static_pool.h"
+
+#if BACNET_STATIC_POOLS
+/* blocks are aligned for any of these types */
+union static_pool_align {
+    void *pointer;
+    double real;
+    uint64_t unsigned64;
+    long integer;
+};
+
+/* a block that is not in use */
+struct static_pool_block {
+    struct static_pool_block *next;
+};
+
+/* the memory of the pool of one block size, with at least one block so
+   that the array is valid when the pool is configured with none */
+#define STATIC_POOL_BLOCKS(size) \
+    (BACNET_STATIC_POOL_BLOCKS_##size ? BACNET_STATIC_POOL_BLOCKS_##size : 1)
+#define STATIC_POOL_MEMORY(size)                      \
+    static union static_pool_align Static_Pool_##size \
+        [(STATIC_POOL_BLOCKS(size) * (size)) /        \
+            sizeof(union static_pool_align)]
+
+STATIC_POOL_MEMORY(32);
+STATIC_POOL_MEMORY(64);
+STATIC_POOL_MEMORY(128);
+STATIC_POOL_MEMORY(256);
+STATIC_POOL_MEMORY(1024);
+STATIC_POOL_MEMORY(4096);
+STATIC_POOL_MEMORY(16384);
+
+/* the pool of one block size */
+struct static_pool {
+    uint8_t *memory;
+    size_t block_size;
+    size_t capacity;
+    /* blocks that were freed, and the first block never used */
+    struct static_pool_block *free_list;
+    size_t unused;
+    size_t in_use;
+    size_t peak;
+    uint32_t failures;
+};
+#define STATIC_POOL(size)                                      \
+    {                                                          \
+        (uint8_t *)Static_Pool_##size, (size),                 \
+            BACNET_STATIC_POOL_BLOCKS_##size, NULL, 0, 0, 0, 0 \
+    }
+
+/* the pools, from the smallest block size to the largest */
+static struct static_pool Static_Pools[] = {
+    STATIC_POOL(32),   STATIC_POOL(64),   STATIC_POOL(128),
+    STATIC_POOL(256),  STATIC_POOL(1024), STATIC_POOL(4096),
+    STATIC_POOL(16384)
+};
+#define STATIC_POOL_COUNT (sizeof(Static_Pools) / sizeof(Static_Pools[0]))
+
+#if BACNET_STATIC_POOLS_REPORT
+#define STATIC_POOL_STRING(x) #x
+#define STATIC_POOL_VALUE(x) STATIC_POOL_STRING(x)
+#define STATIC_POOL_REPORT(size) \
+    " " STATIC_POOL_VALUE(BACNET_STATIC_POOL_BLOCKS_##size) " x " #size
+#pragma message("BACnet static pools, blocks x octets:"                   \
+    STATIC_POOL_REPORT(32) STATIC_POOL_REPORT(64) STATIC_POOL_REPORT(128) \
+    STATIC_POOL_REPORT(256) STATIC_POOL_REPORT(1024)                      \
+    STATIC_POOL_REPORT(4096) STATIC_POOL_REPORT(16384))
+#endif
+
+/**
+ * @brief Take a block from one pool
+ * @param pool - the pool
+ * @return the block, or NULL if the pool is empty
+ */
+static void *static_pool_take(struct static_pool *pool)
+{
+    struct static_pool_block *block = NULL;
+
+    if (pool->free_list) {
+        block = pool->free_list;
+        pool->free_list = block->next;
+    } else if (pool->unused < pool->capacity) {
+        block = (struct static_pool_block *)(void *)&pool
+                    ->memory[pool->unused * pool->block_size];
+        pool->unused++;
+    }
+    if (block) {
+        pool->in_use++;
+        if (pool->in_use > pool->peak) {
+            pool->peak = pool->in_use;
+        }
+    }
+
+    return block;
+}
+
+/**
+ * @brief Find the pool that a block was taken from
+ * @param ptr - the block
+ * @return the pool, or NULL if the block is not from any of the pools
+ */
+static struct static_pool *static_pool_find(const void *ptr)
+{
+    const uint8_t *block = ptr;
+    struct static_pool *pool;
+    unsigned i;
+
+    for (i = 0; i < STATIC_POOL_COUNT; i++) {
+        pool = &Static_Pools[i];
+        if ((block >= pool->memory) &&
+            (block < &pool->memory[pool->capacity * pool->block_size])) {
+            return pool;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Allocate a block, like malloc(), from the pool of the smallest
+ *  block size that holds the size, or a larger one when it is empty
+ * @param size - number of bytes
+ * @return the block, or NULL if there is no block
+ */
+void *static_pool_malloc(size_t size)
+{
+    struct static_pool *first = NULL;
+    void *block;
+    unsigned i;
+
+    for (i = 0; i < STATIC_POOL_COUNT; i++) {
+        if (size <= Static_Pools[i].block_size) {
+            if (!first) {
+                first = &Static_Pools[i];
+            }
+            block = static_pool_take(&Static_Pools[i]);
+            if (block) {
+                return block;
+            }
+        }
+    }
+    if (first) {
+        first->failures++;
+    } else {
+        Static_Pools[STATIC_POOL_COUNT - 1].failures++;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Allocate a zeroed block, like calloc()
+ * @param nmemb - number of elements
+ * @param size - number of bytes of each element
+ * @return the block, or NULL if there is no block
+ */
+void *static_pool_calloc(size_t nmemb, size_t size)
+{
+    void *block;
+
+    if (size && (nmemb > (SIZE_MAX / size))) {
+        return NULL;
+    }
+    block = static_pool_malloc(nmemb * size);
+    if (block) {
+        memset(block, 0, nmemb * size);
+    }
+
+    return block;
+}
+
+/**
+ * @brief Resize a block, like realloc(). The block is kept when it holds
+ *  the new size, and otherwise is copied to a block that does.
+ * @param ptr - the block, or NULL
+ * @param size - number of bytes wanted, or 0 to free the block
+ * @return the block, or NULL if there is no block and ptr is unchanged
+ */
+void *static_pool_realloc(void *ptr, size_t size)
+{
+    struct static_pool *pool;
+    void *block;
+
+    if (!ptr) {
+        return static_pool_malloc(size);
+    }
+    if (size == 0) {
+        static_pool_free(ptr);
+        return NULL;
+    }
+    pool = static_pool_find(ptr);
+    if (!pool) {
+        return NULL;
+    }
+    if (size <= pool->block_size) {
+        return ptr;
+    }
+    block = static_pool_malloc(size);
+    if (block) {
+        memcpy(block, ptr, pool->block_size);
+        static_pool_free(ptr);
+    }
+
+    return block;
+}
+
+/**
+ * @brief Return a block to its pool, like free()
+ * @param ptr - the block, or NULL
+ */
+void static_pool_free(void *ptr)
+{
+    struct static_pool *pool;
+    struct static_pool_block *block = ptr;
+
+    if (!ptr) {
+        return;
+    }
+    pool = static_pool_find(ptr);
+    if (pool) {
+        block->next = pool->free_list;
+        pool->free_list = block;
+        if (pool->in_use) {
+            pool->in_use--;
+        }
+    }
+}
+
+/**
+ * @brief Get the number of pools, one for each block size
+ * @return the number of pools
+ */
+unsigned static_pool_count(void)
+{
+    return STATIC_POOL_COUNT;
+}
+
+/**
+ * @brief Get the counters of one pool
+ * @param index - pool index, 0 for the smallest block size
+ * @param stats - the counters are copied here
+ * @return true if the index is valid
+ */
+bool static_pool_stats(unsigned index, BACNET_STATIC_POOL_STATS *stats)
+{
+    const struct static_pool *pool;
+
+    if ((index >= STATIC_POOL_COUNT) || !stats) {
+        return false;
+    }
+    pool = &Static_Pools[index];
+    stats->block_size = pool->block_size;
+    stats->capacity = pool->capacity;
+    stats->in_use = pool->in_use;
+    stats->peak = pool->peak;
+    stats->failures = pool->failures;
+
+    return true;
+}
+
+/**
+ * @brief Get the RAM of all of the pools
+ * @return number of bytes of the pools
+ */
+size_t static_pool_ram_size(void)
+{
+    return sizeof(Static_Pool_32) + sizeof(Static_Pool_64) +
+        sizeof(Static_Pool_128) + sizeof(Static_Pool_256) +
+        sizeof(Static_Pool_1024) + sizeof(Static_Pool_4096) +
+        sizeof(Static_Pool_16384);
+}
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @brief API for the heap-free build, where the memory that the library
+ *  allocates is taken from static pools of fixed size blocks, with the
+ *  number of blocks of each size configured in bacnet/config.h.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_STATIC_POOL_H
+#define BACNET_SYS_STATIC_POOL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* counters of the pool of one block size */
+typedef struct bacnet_static_pool_stats {
+    /* size of each block, and the number of blocks */
+    size_t block_size;
+    size_t capacity;
+    /* blocks in use now, and the most that were in use at once */
+    size_t in_use;
+    size_t peak;
+    /* requests of this size that found the pool empty */
+    uint32_t failures;
+} BACNET_STATIC_POOL_STATS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if BACNET_STATIC_POOLS
+BACNET_STACK_EXPORT
+void *static_pool_malloc(size_t size);
+BACNET_STACK_EXPORT
+void *static_pool_calloc(size_t nmemb, size_t size);
+BACNET_STACK_EXPORT
+void *static_pool_realloc(void *ptr, size_t size);
+BACNET_STACK_EXPORT
+void static_pool_free(void *ptr);
+
+BACNET_STACK_EXPORT
+unsigned static_pool_count(void);
+BACNET_STACK_EXPORT
+bool static_pool_stats(unsigned index, BACNET_STATIC_POOL_STATS *stats);
+BACNET_STACK_EXPORT
+size_t static_pool_ram_size(void);
+
+/* the library allocates with these, from the static pools */
+#define bacnet_malloc(size) static_pool_malloc(size)
+#define bacnet_calloc(nmemb, size) static_pool_calloc((nmemb), (size))
+#define bacnet_realloc(ptr, size) static_pool_realloc((ptr), (size))
+#define bacnet_free(ptr) static_pool_free(ptr)
+#else
+/* the library allocates with these, from the C library heap */
+#define bacnet_malloc(size) malloc(size)
+#define bacnet_calloc(nmemb, size) calloc((nmemb), (size))
+#define bacnet_realloc(ptr, size) realloc((ptr), (size))
+#define bacnet_free(ptr) free(ptr)
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
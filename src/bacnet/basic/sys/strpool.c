@@ -0,0 +1,259 @@
+/**
+ * @file
+ * @brief A pool of interned strings. The strings are packed into blocks
+ *  that are never moved, and are found with an open addressed table of
+ *  their hashes, so the pointer to an interned string is its handle:
+ *  it stays valid until the pool is cleaned up, and two interned
+ *  strings are equal only when their pointers are equal.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/static_pool.h"
+#include "bacnet/basic/sys/strpool.h"
+
+#define STRPOOL_FNV_OFFSET_BASIS 2166136261UL
+#define STRPOOL_FNV_PRIME 16777619UL
+/* the smallest table, which is a power of two */
+#define STRPOOL_TABLE_MIN 64
+
+/* a block of string storage, followed by its data */
+struct strpool_block {
+    struct strpool_block *next;
+    size_t size;
+    size_t count;
+};
+
+/* an entry of the table, where a NULL string is an empty entry */
+struct strpool_entry {
+    uint32_t hash;
+    const char *string;
+};
+
+static struct strpool_block *Block_List;
+static struct strpool_entry *Table;
+static size_t Table_Size;
+static unsigned String_Count;
+static size_t Block_Bytes;
+
+/**
+ * @brief Hash a string with FNV-1a
+ * @param s - the characters of the string
+ * @param length - number of characters
+ * @return the hash
+ */
+static uint32_t strpool_hash(const char *s, size_t length)
+{
+    uint32_t hash = STRPOOL_FNV_OFFSET_BASIS;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= (uint8_t)s[i];
+        hash *= STRPOOL_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Find the entry of a string, or the empty entry where it belongs
+ * @param hash - hash of the string
+ * @param s - the characters of the string
+ * @param length - number of characters
+ * @return the entry
+ */
+static struct strpool_entry *
+strpool_find(uint32_t hash, const char *s, size_t length)
+{
+    struct strpool_entry *entry;
+    size_t mask = Table_Size - 1;
+    size_t i = hash & mask;
+
+    for (;;) {
+        entry = &Table[i];
+        if (!entry->string) {
+            break;
+        }
+        if ((entry->hash == hash) && (strncmp(entry->string, s, length) == 0) &&
+            (entry->string[length] == 0)) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return entry;
+}
+
+/**
+ * @brief Double the size of the table, or make the first one
+ * @return true if the table has room for another string
+ */
+static bool strpool_table_grow(void)
+{
+    struct strpool_entry *old_table = Table;
+    size_t old_size = Table_Size;
+    size_t i;
+    size_t size;
+
+    size = old_size ? (old_size * 2) : STRPOOL_TABLE_MIN;
+    Table = bacnet_calloc(size, sizeof(struct strpool_entry));
+    if (!Table) {
+        Table = old_table;
+        return false;
+    }
+    Table_Size = size;
+    for (i = 0; i < old_size; i++) {
+        if (old_table[i].string) {
+            *strpool_find(old_table[i].hash, old_table[i].string,
+                strlen(old_table[i].string)) = old_table[i];
+        }
+    }
+    bacnet_free(old_table);
+
+    return true;
+}
+
+/**
+ * @brief Copy a string into the storage blocks
+ * @param s - the characters of the string
+ * @param length - number of characters
+ * @return the copy, which ends with a null character, or NULL
+ */
+static char *strpool_store(const char *s, size_t length)
+{
+    struct strpool_block *block = Block_List;
+    size_t size = length + 1;
+    char *p;
+
+    if (!block || ((block->size - block->count) < size)) {
+        if (size > BACNET_STRPOOL_BLOCK_SIZE) {
+            block = bacnet_malloc(sizeof(struct strpool_block) + size);
+            if (!block) {
+                return NULL;
+            }
+            block->size = size;
+            block->count = 0;
+            /* keep filling the block that has room */
+            if (Block_List) {
+                block->next = Block_List->next;
+                Block_List->next = block;
+            } else {
+                block->next = NULL;
+                Block_List = block;
+            }
+        } else {
+            block = bacnet_malloc(
+                sizeof(struct strpool_block) + BACNET_STRPOOL_BLOCK_SIZE);
+            if (!block) {
+                return NULL;
+            }
+            block->size = BACNET_STRPOOL_BLOCK_SIZE;
+            block->count = 0;
+            block->next = Block_List;
+            Block_List = block;
+        }
+        Block_Bytes += sizeof(struct strpool_block) + block->size;
+    }
+    p = (char *)(block + 1) + block->count;
+    memcpy(p, s, length);
+    p[length] = 0;
+    block->count += size;
+
+    return p;
+}
+
+/**
+ * @brief Intern the first characters of a string, which need not end
+ *  with a null character
+ * @param s - the characters of the string
+ * @param length - number of characters
+ * @return the interned string, which is not to be changed or freed,
+ *  or NULL if there is no memory for it
+ */
+const char *strpool_intern_length(const char *s, size_t length)
+{
+    struct strpool_entry *entry;
+    uint32_t hash;
+    char *p;
+
+    if (!s) {
+        return NULL;
+    }
+    /* keep the table at most three quarters full */
+    if (((String_Count + 1) * 4) > (Table_Size * 3)) {
+        if (!strpool_table_grow()) {
+            return NULL;
+        }
+    }
+    hash = strpool_hash(s, length);
+    entry = strpool_find(hash, s, length);
+    if (!entry->string) {
+        p = strpool_store(s, length);
+        if (!p) {
+            return NULL;
+        }
+        entry->hash = hash;
+        entry->string = p;
+        String_Count++;
+    }
+
+    return entry->string;
+}
+
+/**
+ * @brief Intern a string
+ * @param s - the string
+ * @return the interned string, which is not to be changed or freed,
+ *  or NULL if there is no memory for it, or if s is NULL
+ */
+const char *strpool_intern(const char *s)
+{
+    if (!s) {
+        return NULL;
+    }
+
+    return strpool_intern_length(s, strlen(s));
+}
+
+/**
+ * @brief Get the number of distinct strings that were interned
+ * @return the number of strings
+ */
+unsigned strpool_count(void)
+{
+    return String_Count;
+}
+
+/**
+ * @brief Get the bytes of memory that the pool holds
+ * @return the bytes of the storage blocks and of the table
+ */
+size_t strpool_ram_size(void)
+{
+    return Block_Bytes + (Table_Size * sizeof(struct strpool_entry));
+}
+
+/**
+ * @brief Free the pool, after which no interned string may be used
+ */
+void strpool_cleanup(void)
+{
+    struct strpool_block *block;
+
+    while (Block_List) {
+        block = Block_List;
+        Block_List = block->next;
+        bacnet_free(block);
+    }
+    bacnet_free(Table);
+    Table = NULL;
+    Table_Size = 0;
+    String_Count = 0;
+    Block_Bytes = 0;
+}
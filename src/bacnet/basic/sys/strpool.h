@@ -0,0 +1,41 @@
+/**
+ * @file
+ * @brief API for a pool of interned strings, where each distinct string
+ *  is stored once and is never changed or moved, so that many objects
+ *  can share a name or description and encode it without a copy.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_STRPOOL_H
+#define BACNET_SYS_STRPOOL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* bytes of each block of string storage, where a longer string
+   is given a block of its own */
+#ifndef BACNET_STRPOOL_BLOCK_SIZE
+#define BACNET_STRPOOL_BLOCK_SIZE 1024
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+const char *strpool_intern(const char *s);
+BACNET_STACK_EXPORT
+const char *strpool_intern_length(const char *s, size_t length);
+BACNET_STACK_EXPORT
+unsigned strpool_count(void);
+BACNET_STACK_EXPORT
+size_t strpool_ram_size(void);
+BACNET_STACK_EXPORT
+void strpool_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,327 @@
+/**
+ * @file
+ * @brief A hierarchical timer wheel of millisecond timers with callbacks.
+ * @details Each level of the wheel has slots of lists of timers. A timer
+ *  is linked into the slot of its deadline in the lowest level that
+ *  covers its delay, and moves down a level each time the level below
+ *  wraps around, so that setting, stopping and expiring a timer are each
+ *  a few list operations, whatever the number of timers. The clock is
+ *  mstimer_now(), and the wheel advances one millisecond at a time when
+ *  timer_wheel_task() is called, or jumps ahead when there are no timers.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/timer_wheel.h"
+
+#if ((TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS) > 30)
+#error "TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS must be 30 or less"
+#endif
+
+#define TIMER_WHEEL_SLOTS (1UL << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+/* delays that fit in the wheel; a longer delay waits in the top level */
+#define TIMER_WHEEL_RANGE (1UL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+/* slots of lists of timers, for each level */
+static struct timer_wheel_timer *Wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+/* timers that expired, with their callbacks still to be called */
+static struct timer_wheel_timer *Expired;
+/* the next millisecond to be processed */
+static uint32_t Current;
+/* number of linked timers */
+static unsigned Count;
+
+/**
+ * @brief Link a timer at the head of a list
+ * @param head - head of the list
+ * @param timer - timer to link
+ */
+static void timer_wheel_link(
+    struct timer_wheel_timer **head, struct timer_wheel_timer *timer)
+{
+    timer->next = *head;
+    if (timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+}
+
+/**
+ * @brief Unlink a timer from its list
+ * @param timer - timer to unlink
+ */
+static void timer_wheel_unlink(struct timer_wheel_timer *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/**
+ * @brief Link a timer into the slot of its deadline, in the lowest level
+ *  of the wheel that covers its delay
+ * @param timer - timer to link
+ */
+static void timer_wheel_insert(struct timer_wheel_timer *timer)
+{
+    uint32_t expires = timer->expires;
+    uint32_t delta = expires - Current;
+    unsigned level;
+
+    if ((int32_t)delta < 0) {
+        /* overdue: expire with the next millisecond */
+        delta = 0;
+        expires = Current;
+    } else if (delta >= TIMER_WHEEL_RANGE) {
+        /* wait in the top level, and be placed again when it cascades */
+        delta = TIMER_WHEEL_RANGE - 1;
+        expires = Current + delta;
+    }
+    for (level = 0; level < (TIMER_WHEEL_LEVELS - 1); level++) {
+        if (delta < (1UL << (TIMER_WHEEL_BITS * (level + 1)))) {
+            break;
+        }
+    }
+    timer_wheel_link(&Wheel[level][(expires >> (TIMER_WHEEL_BITS * level)) &
+                         TIMER_WHEEL_MASK],
+        timer);
+}
+
+/**
+ * @brief Move the timers of the current slot of a level into the levels
+ *  below it
+ * @param level - level of the wheel, 1 or more
+ */
+static void timer_wheel_cascade(unsigned level)
+{
+    struct timer_wheel_timer **head;
+    struct timer_wheel_timer *timer;
+
+    head = &Wheel[level]
+                 [(Current >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+    while (*head) {
+        timer = *head;
+        timer_wheel_unlink(timer);
+        timer_wheel_insert(timer);
+    }
+}
+
+/**
+ * @brief Process the current millisecond: cascade the levels that wrap
+ *  around, and call the callbacks of the timers that expire
+ * @return number of timers that expired
+ */
+static unsigned timer_wheel_step(void)
+{
+    struct timer_wheel_timer **head;
+    struct timer_wheel_timer *timer;
+    unsigned level;
+    unsigned expired = 0;
+
+    for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        if (Current & ((1UL << (TIMER_WHEEL_BITS * level)) - 1)) {
+            break;
+        }
+        timer_wheel_cascade(level);
+    }
+    head = &Wheel[0][Current & TIMER_WHEEL_MASK];
+    Expired = *head;
+    if (Expired) {
+        Expired->pprev = &Expired;
+    }
+    *head = NULL;
+    Current++;
+    /* a callback can set or stop any timer, including the expired ones */
+    while (Expired) {
+        timer = Expired;
+        timer_wheel_unlink(timer);
+        if (timer->interval) {
+            timer->expires += timer->interval;
+            timer_wheel_insert(timer);
+        } else {
+            Count--;
+        }
+        expired++;
+        if (timer->callback) {
+            timer->callback(timer->context);
+        }
+    }
+
+    return expired;
+}
+
+/**
+ * @brief Initialize the wheel, without any timers
+ */
+void timer_wheel_init(void)
+{
+    unsigned level, slot;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            Wheel[level][slot] = NULL;
+        }
+    }
+    Expired = NULL;
+    Count = 0;
+    Current = (uint32_t)mstimer_now();
+}
+
+/**
+ * @brief Set a timer, which is stopped first if it is active
+ * @param timer - timer, which is zero filled before its first use
+ * @param callback - function called when the timer expires
+ * @param context - given to the callback function
+ * @param milliseconds - delay until the first deadline, less than 2^31
+ * @param interval - milliseconds between the next deadlines of a
+ *  repeating timer, or 0 for a one-shot timer
+ */
+void timer_wheel_set(struct timer_wheel_timer *timer,
+    timer_wheel_callback_t callback,
+    void *context,
+    uint32_t milliseconds,
+    uint32_t interval)
+{
+    uint32_t now;
+
+    if (!timer) {
+        return;
+    }
+    timer_wheel_stop(timer);
+    now = (uint32_t)mstimer_now();
+    if (Count == 0) {
+        /* nothing to catch up with */
+        Current = now;
+    }
+    timer->callback = callback;
+    timer->context = context;
+    timer->expires = now + milliseconds;
+    timer->interval = interval;
+    timer_wheel_insert(timer);
+    Count++;
+}
+
+/**
+ * @brief Stop a timer
+ * @param timer - timer to stop
+ * @return true if the timer was active
+ */
+bool timer_wheel_stop(struct timer_wheel_timer *timer)
+{
+    if (!timer || !timer->pprev) {
+        return false;
+    }
+    timer_wheel_unlink(timer);
+    Count--;
+
+    return true;
+}
+
+/**
+ * @brief Determine if a timer is active, waiting for its deadline
+ * @param timer - timer
+ * @return true if the timer is active
+ */
+bool timer_wheel_active(const struct timer_wheel_timer *timer)
+{
+    return (timer && timer->pprev);
+}
+
+/**
+ * @brief Get the interval of a repeating timer, such as the milliseconds
+ *  that elapsed since the callback was last called
+ * @param timer - timer
+ * @return milliseconds between the deadlines, or 0 for a one-shot timer
+ */
+uint32_t timer_wheel_interval(const struct timer_wheel_timer *timer)
+{
+    return (timer ? timer->interval : 0);
+}
+
+/**
+ * @brief Get the number of active timers
+ * @return number of active timers
+ */
+unsigned timer_wheel_count(void)
+{
+    return Count;
+}
+
+/**
+ * @brief Get the number of milliseconds until timer_wheel_task() has a
+ *  timer to expire or a level to cascade, such as how long an
+ *  application loop can sleep or wait for a packet
+ * @return milliseconds until the next deadline, or TIMER_WHEEL_IDLE
+ *  when there are no timers
+ */
+uint32_t timer_wheel_next(void)
+{
+    uint32_t ticks = TIMER_WHEEL_IDLE;
+    uint32_t base, low, wait, now;
+    unsigned level, shift, j, start;
+
+    if (Count == 0) {
+        return TIMER_WHEEL_IDLE;
+    }
+    if (Expired) {
+        return 0;
+    }
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        shift = TIMER_WHEEL_BITS * level;
+        base = Current >> shift;
+        low = Current & ((1UL << shift) - 1);
+        /* the current slot of a level that has moved on is a full
+           revolution away */
+        start = low ? 1 : 0;
+        for (j = start; j < (start + TIMER_WHEEL_SLOTS); j++) {
+            if (Wheel[level][(base + j) & TIMER_WHEEL_MASK]) {
+                wait = ((base + j) << shift) - Current;
+                if (wait < ticks) {
+                    ticks = wait;
+                }
+                break;
+            }
+        }
+    }
+    if (ticks == TIMER_WHEEL_IDLE) {
+        return TIMER_WHEEL_IDLE;
+    }
+    /* ticks from the next millisecond to be processed */
+    now = (uint32_t)mstimer_now();
+    wait = (Current + ticks) - now;
+    if ((int32_t)wait < 0) {
+        return 0;
+    }
+
+    return wait;
+}
+
+/**
+ * @brief Process the milliseconds up to now, calling the callbacks of
+ *  the timers that expire
+ * @return number of timers that expired
+ */
+unsigned timer_wheel_task(void)
+{
+    uint32_t now;
+    unsigned expired = 0;
+
+    now = (uint32_t)mstimer_now();
+    while ((int32_t)(now - Current) >= 0) {
+        if (Count == 0) {
+            Current = now + 1;
+            break;
+        }
+        expired += timer_wheel_step();
+    }
+
+    return expired;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file
+ * @brief API for a hierarchical timer wheel, a shared service of one-shot
+ *  and repeating millisecond timers with callbacks, where the cost of the
+ *  timers scales with the expiring timers, and where an application loop
+ *  can sleep until the next deadline.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_TIMER_WHEEL_H
+#define BACNET_SYS_TIMER_WHEEL_H
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* number of bits of the slots of each level of the wheel */
+#ifndef TIMER_WHEEL_BITS
+#define TIMER_WHEEL_BITS 6
+#endif
+/* number of levels of the wheel, each covering the whole of the level
+   below it in one slot, so that 4 levels of 6 bits cover 2^24 ms */
+#ifndef TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_LEVELS 4
+#endif
+/* number of milliseconds until the next deadline when there is none */
+#define TIMER_WHEEL_IDLE UINT32_MAX
+
+/* callback function of a timer, with the context given when it was set */
+typedef void (*timer_wheel_callback_t)(void *context);
+
+/**
+ * A timer of the wheel, which is declared by the module that uses it,
+ * such as statically, and set with timer_wheel_set() to be linked into
+ * a slot of the wheel until it expires or is stopped.
+ */
+struct timer_wheel_timer {
+    struct timer_wheel_timer *next;
+    /* the pointer that points to this timer, or NULL when not linked */
+    struct timer_wheel_timer **pprev;
+    /* millisecond of the deadline */
+    uint32_t expires;
+    /* milliseconds between the deadlines, or 0 for a one-shot timer */
+    uint32_t interval;
+    timer_wheel_callback_t callback;
+    void *context;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void timer_wheel_init(void);
+BACNET_STACK_EXPORT
+void timer_wheel_set(struct timer_wheel_timer *timer,
+    timer_wheel_callback_t callback,
+    void *context,
+    uint32_t milliseconds,
+    uint32_t interval);
+BACNET_STACK_EXPORT
+bool timer_wheel_stop(struct timer_wheel_timer *timer);
+BACNET_STACK_EXPORT
+bool timer_wheel_active(const struct timer_wheel_timer *timer);
+BACNET_STACK_EXPORT
+uint32_t timer_wheel_interval(const struct timer_wheel_timer *timer);
+BACNET_STACK_EXPORT
+unsigned timer_wheel_count(void);
+BACNET_STACK_EXPORT
+uint32_t timer_wheel_next(void);
+BACNET_STACK_EXPORT
+unsigned timer_wheel_task(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief A binary ring in memory of the static tracepoints of the stack,
+ *  for targets without USDT probes.
+ * @details Each tracepoint writes one fixed size record into the next
+ *  slot of the ring, overwriting the oldest record when the ring is full,
+ *  so that the last BACNET_TRACE_RING_SIZE events can be read out later,
+ *  such as with a debugger or over a console.  Nothing is formatted or
+ *  written to a stream when the event happens.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/basic/sys/trace.h"
+
+#if BACNET_TRACE_ENABLED && !BACNET_TRACE_USDT
+static BACNET_TRACE_RECORD Trace_Ring[BACNET_TRACE_RING_SIZE];
+/* number of records that were ever written */
+static uint32_t Trace_Sequence;
+static uint32_t (*Trace_Clock)(void);
+
+/**
+ * @brief Write a record of an event into the trace ring
+ * @note This is not safe to call from an interrupt and a task at once;
+ *  a record could get mixed up, but the ring stays usable.
+ * @param event - the tracepoint
+ * @param arg1 - first argument of the tracepoint
+ * @param arg2 - second argument of the tracepoint
+ */
+void bacnet_trace_event(
+    BACNET_TRACE_EVENT event, uint32_t arg1, uint32_t arg2)
+{
+    BACNET_TRACE_RECORD *record;
+    uint32_t sequence = Trace_Sequence++;
+
+    record = &Trace_Ring[sequence & (BACNET_TRACE_RING_SIZE - 1)];
+    record->sequence = sequence;
+    record->timestamp = Trace_Clock ? Trace_Clock() : 0;
+    record->arg1 = arg1;
+    record->arg2 = arg2;
+    record->event = (uint8_t)event;
+}
+
+/**
+ * @brief Get the number of records in the trace ring
+ * @return number of records, up to BACNET_TRACE_RING_SIZE
+ */
+unsigned bacnet_trace_count(void)
+{
+    if (Trace_Sequence < BACNET_TRACE_RING_SIZE) {
+        return (unsigned)Trace_Sequence;
+    }
+
+    return BACNET_TRACE_RING_SIZE;
+}
+
+/**
+ * @brief Get a record of the trace ring
+ * @param index - 0 for the oldest record, up to bacnet_trace_count() - 1
+ *  for the newest one
+ * @param record - the record, copied
+ * @return true if there is a record with this index
+ */
+bool bacnet_trace_record(unsigned index, BACNET_TRACE_RECORD *record)
+{
+    uint32_t sequence;
+
+    if (!record || (index >= bacnet_trace_count())) {
+        return false;
+    }
+    sequence = Trace_Sequence - bacnet_trace_count() + index;
+    *record = Trace_Ring[sequence & (BACNET_TRACE_RING_SIZE - 1)];
+
+    return true;
+}
+
+/**
+ * @brief Remove all of the records from the trace ring
+ */
+void bacnet_trace_clear(void)
+{
+    memset(Trace_Ring, 0, sizeof(Trace_Ring));
+    Trace_Sequence = 0;
+}
+
+/**
+ * @brief Set the clock of the timestamps of the records, such as
+ *  mstimer_now() or a free running hardware timer
+ * @param clock - function that returns the time, or NULL for none
+ */
+void bacnet_trace_clock_set(uint32_t (*clock)(void))
+{
+    Trace_Clock = clock;
+}
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file
+ * @brief API for static tracepoints in the hot paths of the stack: NPDU
+ *  receive and send, APDU dispatch, TSM state changes, COV notifications
+ *  and MS/TP token events.  On Linux with <sys/sdt.h> each tracepoint is
+ *  a USDT probe for DTrace, SystemTap or eBPF, which is a no-op until a
+ *  tracer attaches, and elsewhere it is a record in a binary ring in
+ *  memory.  Without BACNET_TRACE_ENABLED the tracepoints compile to
+ *  nothing.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_TRACE_H
+#define BACNET_SYS_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* 1 to compile the tracepoints into the stack.
+   0 removes them, and the calls of them. */
+#ifndef BACNET_TRACE_ENABLED
+#define BACNET_TRACE_ENABLED 0
+#endif
+/* 1 for USDT probes from <sys/sdt.h>, which is used by default on Linux
+   when it is installed (systemtap-sdt-dev), 0 for the trace ring */
+#ifndef BACNET_TRACE_USDT
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define BACNET_TRACE_USDT 1
+#endif
+#endif
+#endif
+#ifndef BACNET_TRACE_USDT
+#define BACNET_TRACE_USDT 0
+#endif
+/* number of records in the trace ring, which is a power of two */
+#ifndef BACNET_TRACE_RING_SIZE
+#define BACNET_TRACE_RING_SIZE 64
+#endif
+#if (BACNET_TRACE_RING_SIZE & (BACNET_TRACE_RING_SIZE - 1)) != 0
+#error "BACNET_TRACE_RING_SIZE must be a power of two"
+#endif
+
+/* the tracepoints, where the probe name is the name after BACNET_TRACE_
+   and the two arguments are given for each one */
+typedef enum bacnet_trace_event {
+    /* NPDU received: source network, length of the PDU */
+    BACNET_TRACE_NPDU_RX = 0,
+    /* NPDU sent by a datalink: destination network, length of the PDU */
+    BACNET_TRACE_NPDU_TX = 1,
+    /* APDU dispatched: first octet of the APDU, which is the PDU type
+       and its flags, length of the APDU */
+    BACNET_TRACE_APDU_RX = 2,
+    /* TSM state change: invoke ID, new BACNET_TSM_STATE */
+    BACNET_TRACE_TSM_STATE = 3,
+    /* COV notification sent: monitored object as (type << 22) | instance,
+       subscriber process identifier */
+    BACNET_TRACE_COV_SEND = 4,
+    /* MS/TP token received: source station, this station */
+    BACNET_TRACE_MSTP_TOKEN_RX = 5,
+    /* MS/TP token passed: next station, token count */
+    BACNET_TRACE_MSTP_TOKEN_TX = 6,
+    /* MS/TP token lost: this station, 0 */
+    BACNET_TRACE_MSTP_TOKEN_LOST = 7,
+    /* MS/TP Poll-For-Master sent: polled station, this station */
+    BACNET_TRACE_MSTP_POLL_FOR_MASTER = 8,
+    BACNET_TRACE_EVENT_MAX = 9
+} BACNET_TRACE_EVENT;
+
+/* one record of the trace ring */
+typedef struct bacnet_trace_record {
+    /* counts every record, so that a gap shows overwritten records */
+    uint32_t sequence;
+    /* from the clock of bacnet_trace_clock_set(), or 0 */
+    uint32_t timestamp;
+    uint32_t arg1;
+    uint32_t arg2;
+    uint8_t event;
+} BACNET_TRACE_RECORD;
+
+/**
+ * Trace an event with two arguments, such as
+ * BACNET_TRACE(NPDU_RX, src->net, pdu_len).
+ * @param name - name of the event, without the BACNET_TRACE_ prefix
+ * @param arg1 - first argument, an integer
+ * @param arg2 - second argument, an integer
+ */
+#if BACNET_TRACE_ENABLED && BACNET_TRACE_USDT
+#include <sys/sdt.h>
+#define BACNET_TRACE(name, arg1, arg2) \
+    DTRACE_PROBE2(bacnet, name, (uint32_t)(arg1), (uint32_t)(arg2))
+#elif BACNET_TRACE_ENABLED
+#define BACNET_TRACE(name, arg1, arg2)                           \
+    bacnet_trace_event(                                          \
+        BACNET_TRACE_##name, (uint32_t)(arg1), (uint32_t)(arg2))
+#else
+#define BACNET_TRACE(name, arg1, arg2) ((void)0)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if BACNET_TRACE_ENABLED && !BACNET_TRACE_USDT
+BACNET_STACK_EXPORT
+void bacnet_trace_event(
+    BACNET_TRACE_EVENT event, uint32_t arg1, uint32_t arg2);
+BACNET_STACK_EXPORT
+unsigned bacnet_trace_count(void);
+BACNET_STACK_EXPORT
+bool bacnet_trace_record(unsigned index, BACNET_TRACE_RECORD *record);
+BACNET_STACK_EXPORT
+void bacnet_trace_clear(void);
+BACNET_STACK_EXPORT
+void bacnet_trace_clock_set(uint32_t (*clock)(void));
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -35,20 +35,28 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/abort.h"
 #include "bacnet/apdu.h"
 #include "bacnet/bacaddr.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/basic/tsm/tsm.h"
+#include "bacnet/basic/sys/memstats.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/binding/address.h"
 
 /** @file tsm.c  BACnet Transaction State Machine operations  */
 /* FIXME: modify basic service handlers to use TSM rather than this buffer! */
+#if BACNET_HANDLER_TRANSMIT_BUFFER_THREAD_LOCAL
+BACNET_STACK_THREAD_LOCAL uint8_t Handler_Transmit_Buffer[MAX_PDU];
+#else
 uint8_t Handler_Transmit_Buffer[MAX_PDU];
+#endif
 
 #if (MAX_TSM_TRANSACTIONS)
 /* Really only needed for segmented messages */
@@ -56,12 +64,49 @@ uint8_t Handler_Transmit_Buffer[MAX_PDU];
 /* If we are only a server and only initiate broadcasts, */
 /* then we don't need a TSM layer. */
 
-/* FIXME: not coded for segmentation */
-
 /* declare space for the TSM transactions, and set it up in the init. */
 /* table rules: an Invoke ID = 0 is an unused spot in the table */
 static BACNET_TSM_DATA TSM_List[MAX_TSM_TRANSACTIONS];
 
+/* Slot numbers are one-based: TSM_List index + 1, and zero is no slot,
+   so that the zero-initialized tables below are valid and empty. */
+typedef uint8_t TSM_SLOT;
+#define TSM_SLOT_NONE 0
+#define TSM_SLOT_DATA(n) (&TSM_List[(n)-1])
+
+/* direct map from invoke ID to the slot that holds it */
+static TSM_SLOT TSM_Invoke_Slot[256];
+/* stack of released slots, and the count of slots ever used */
+static TSM_SLOT TSM_Free_Slot[MAX_TSM_TRANSACTIONS];
+static uint8_t TSM_Free_Count;
+static uint8_t TSM_Used_Count;
+
+/* Hashed timer wheel for the request timers.  Each bucket holds the
+   transactions that expire during one tick of the wheel, and only the
+   buckets for elapsed ticks are visited by tsm_timer_milliseconds().
+   One level is enough: a timer is armed with the APDU timeout or the
+   segment timeout, which are 16-bit milliseconds, so it waits at most
+   65535 ms, or 64 turns of the default wheel of 64 x 16 ms.  A waiting
+   timer is only compared once per turn, at most 64 times before it
+   expires, and a second level would save no more than those compares
+   at the cost of moving its timers down to this level at each turn. */
+#if !defined(TSM_TIMER_WHEEL_SIZE)
+#define TSM_TIMER_WHEEL_SIZE 64
+#endif
+#if !defined(TSM_TIMER_TICK_MS)
+#define TSM_TIMER_TICK_MS 16
+#endif
+static struct tsm_timer_node {
+    TSM_SLOT next;
+    TSM_SLOT prev;
+    bool armed;
+    uint32_t expiry;
+} TSM_Timer[MAX_TSM_TRANSACTIONS];
+static TSM_SLOT TSM_Timer_Wheel[TSM_TIMER_WHEEL_SIZE];
+/* milliseconds elapsed, and the last wheel tick that was visited */
+static uint32_t TSM_Timer_Clock;
+static uint32_t TSM_Timer_Tick;
+
 /* invoke ID for incrementing between subsequent calls. */
 static uint8_t Current_Invoke_ID = 1;
 
@@ -72,6 +117,36 @@ void tsm_set_timeout_handler(tsm_timeout_function pFunction)
     Timeout_Function = pFunction;
 }
 
+/* returns the APDU timeout for a peer, such as from its round trip time */
+static tsm_peer_timeout_function Peer_Timeout_Function;
+
+void tsm_set_peer_timeout_handler(tsm_peer_timeout_function pFunction)
+{
+    Peer_Timeout_Function = pFunction;
+}
+
+/** Get the milliseconds to wait for the reply to a confirmed request,
+ *  which are from the peer timeout handler when it knows the peer,
+ *  or else the APDU timeout.
+ *
+ * @param dest  The address that the request is sent to.
+ * @param retry_count  Number of times the request was sent again.
+ * @return milliseconds to wait for the reply
+ */
+static uint16_t tsm_request_timeout(BACNET_ADDRESS *dest, uint8_t retry_count)
+{
+    uint16_t milliseconds = 0;
+
+    if (Peer_Timeout_Function) {
+        milliseconds = Peer_Timeout_Function(dest, retry_count);
+    }
+    if (milliseconds == 0) {
+        milliseconds = apdu_timeout();
+    }
+
+    return milliseconds;
+}
+
 /** Find the given Invoke-Id in the list and
  *  return the index.
  *
@@ -82,41 +157,96 @@ void tsm_set_timeout_handler(tsm_timeout_function pFunction)
  */
 static uint8_t tsm_find_invokeID_index(uint8_t invokeID)
 {
-    unsigned i = 0; /* counter */
-    uint8_t index = MAX_TSM_TRANSACTIONS; /* return value */
+    TSM_SLOT slot;
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+    if (invokeID == 0) {
+        return MAX_TSM_TRANSACTIONS;
+    }
+    slot = TSM_Invoke_Slot[invokeID];
+    if (slot == TSM_SLOT_NONE) {
+        return MAX_TSM_TRANSACTIONS;
+    }
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->InvokeID == invokeID) {
-            index = (uint8_t)i;
-            break;
-        }
+    return (uint8_t)(slot - 1);
+}
+
+/** Take a free slot from the TSM table.
+ *
+ * @return Slot number, or TSM_SLOT_NONE if no entry is free.
+ */
+static TSM_SLOT tsm_slot_alloc(void)
+{
+    TSM_SLOT slot = TSM_SLOT_NONE;
+
+    if (TSM_Free_Count > 0) {
+        TSM_Free_Count--;
+        slot = TSM_Free_Slot[TSM_Free_Count];
+    } else if (TSM_Used_Count < MAX_TSM_TRANSACTIONS) {
+        TSM_Used_Count++;
+        slot = TSM_Used_Count;
     }
 
-    return index;
+    return slot;
 }
 
-/** Find the first free index in the TSM table.
+/** Return a slot to the pool of free slots.
  *
- * @return Index of the id or MAX_TSM_TRANSACTIONS
- *         if no entry is free.
+ * @param slot  Slot number
  */
-static uint8_t tsm_find_first_free_index(void)
+static void tsm_slot_release(TSM_SLOT slot)
 {
-    unsigned i = 0; /* counter */
-    uint8_t index = MAX_TSM_TRANSACTIONS; /* return value */
+    if (TSM_Free_Count < MAX_TSM_TRANSACTIONS) {
+        TSM_Free_Slot[TSM_Free_Count] = slot;
+        TSM_Free_Count++;
+    }
+}
 
-    const BACNET_TSM_DATA *plist = TSM_List;
+/** Remove a transaction from the timer wheel.
+ *
+ * @param slot  Slot number
+ */
+static void tsm_timer_stop(TSM_SLOT slot)
+{
+    struct tsm_timer_node *node = &TSM_Timer[slot - 1];
+    unsigned bucket;
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->InvokeID == 0) {
-            index = (uint8_t)i;
-            break;
-        }
+    if (!node->armed) {
+        return;
+    }
+    if (node->prev != TSM_SLOT_NONE) {
+        TSM_Timer[node->prev - 1].next = node->next;
+    } else {
+        bucket = (node->expiry / TSM_TIMER_TICK_MS) % TSM_TIMER_WHEEL_SIZE;
+        TSM_Timer_Wheel[bucket] = node->next;
     }
+    if (node->next != TSM_SLOT_NONE) {
+        TSM_Timer[node->next - 1].prev = node->prev;
+    }
+    node->next = TSM_SLOT_NONE;
+    node->prev = TSM_SLOT_NONE;
+    node->armed = false;
+}
 
-    return index;
+/** Place a transaction on the timer wheel to expire after a time.
+ *
+ * @param slot  Slot number
+ * @param milliseconds  Time until expiry
+ */
+static void tsm_timer_start(TSM_SLOT slot, uint16_t milliseconds)
+{
+    struct tsm_timer_node *node = &TSM_Timer[slot - 1];
+    unsigned bucket;
+
+    tsm_timer_stop(slot);
+    node->expiry = TSM_Timer_Clock + milliseconds;
+    bucket = (node->expiry / TSM_TIMER_TICK_MS) % TSM_TIMER_WHEEL_SIZE;
+    node->prev = TSM_SLOT_NONE;
+    node->next = TSM_Timer_Wheel[bucket];
+    if (node->next != TSM_SLOT_NONE) {
+        TSM_Timer[node->next - 1].prev = slot;
+    }
+    TSM_Timer_Wheel[bucket] = slot;
+    node->armed = true;
 }
 
 /** Check if space for transactions is available.
@@ -125,20 +255,7 @@ static uint8_t tsm_find_first_free_index(void)
  */
 bool tsm_transaction_available(void)
 {
-    bool status = false; /* return value */
-    unsigned i = 0; /* counter */
-
-    const BACNET_TSM_DATA *plist = TSM_List;
-
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->InvokeID == 0) {
-            /* one is available! */
-            status = true;
-            break;
-        }
-    }
-
-    return status;
+    return (TSM_Free_Count > 0) || (TSM_Used_Count < MAX_TSM_TRANSACTIONS);
 }
 
 /** Return the count of idle transaction.
@@ -147,19 +264,7 @@ bool tsm_transaction_available(void)
  */
 uint8_t tsm_transaction_idle_count(void)
 {
-    uint8_t count = 0; /* return value */
-    unsigned i = 0; /* counter */
-
-    const BACNET_TSM_DATA *plist = TSM_List;
-
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if ((plist->InvokeID == 0) && (plist->state == TSM_STATE_IDLE)) {
-            /* one is available! */
-            count++;
-        }
-    }
-
-    return count;
+    return (uint8_t)((MAX_TSM_TRANSACTIONS - TSM_Used_Count) + TSM_Free_Count);
 }
 
 /**
@@ -183,7 +288,7 @@ void tsm_invokeID_set(uint8_t invokeID)
  */
 uint8_t tsm_next_free_invokeID(void)
 {
-    uint8_t index = 0;
+    TSM_SLOT slot;
     uint8_t invokeID = 0;
     bool found = false;
     BACNET_TSM_DATA *plist = NULL;
@@ -191,17 +296,18 @@ uint8_t tsm_next_free_invokeID(void)
     /* Is there even space available? */
     if (tsm_transaction_available()) {
         while (!found) {
-            index = tsm_find_invokeID_index(Current_Invoke_ID);
-            if (index == MAX_TSM_TRANSACTIONS) {
+            if (TSM_Invoke_Slot[Current_Invoke_ID] == TSM_SLOT_NONE) {
                 /* Not found, so this invokeID is not used */
                 found = true;
                 /* set this id into the table */
-                index = tsm_find_first_free_index();
-                if (index != MAX_TSM_TRANSACTIONS) {
-                    plist = &TSM_List[index];
+                slot = tsm_slot_alloc();
+                if (slot != TSM_SLOT_NONE) {
+                    plist = TSM_SLOT_DATA(slot);
                     plist->InvokeID = invokeID = Current_Invoke_ID;
                     plist->state = TSM_STATE_IDLE;
+                    BACNET_TRACE(TSM_STATE, plist->InvokeID, plist->state);
                     plist->RequestTimer = apdu_timeout();
+                    TSM_Invoke_Slot[invokeID] = slot;
                     /* update for the next call or check */
                     Current_Invoke_ID++;
                     /* skip zero - we treat that internally as invalid or no
@@ -250,9 +356,11 @@ void tsm_set_confirmed_unsegmented_transaction(uint8_t invokeID,
             plist = &TSM_List[index];
             /* SendConfirmedUnsegmented */
             plist->state = TSM_STATE_AWAIT_CONFIRMATION;
+            BACNET_TRACE(TSM_STATE, plist->InvokeID, plist->state);
             plist->RetryCount = 0;
             /* start the timer */
-            plist->RequestTimer = apdu_timeout();
+            plist->RequestTimer = tsm_request_timeout(dest, 0);
+            tsm_timer_start(index + 1, plist->RequestTimer);
             /* copy the data */
             for (j = 0; j < apdu_len; j++) {
                 plist->apdu[j] = apdu[j];
@@ -313,6 +421,668 @@ bool tsm_get_transaction_pdu(uint8_t invokeID,
     return found;
 }
 
+#if BACNET_SEGMENTATION_ENABLED
+/* Segmented ComplexACK: PDU type, invoke ID, sequence number,
+   proposed window size, and service choice */
+#define TSM_SEGMENT_HEADER_LEN 5
+/* Unsegmented ComplexACK: PDU type, invoke ID, and service choice */
+#define TSM_COMPLEX_ACK_HEADER_LEN 3
+
+/* Segmented ComplexACK responses that we are sending (Clause 5.4.5) */
+static struct tsm_segmented_response {
+    bool in_use;
+    BACNET_ADDRESS dest;
+    BACNET_NPDU_DATA npdu_data;
+    uint8_t invoke_id;
+    uint8_t service_choice;
+    /* service data of the ComplexACK, without the APDU header */
+    uint8_t data[BACNET_SEGMENTATION_BUFFER_SIZE];
+    unsigned data_len;
+    unsigned segment_size;
+    unsigned segment_count;
+    /* first segment of the window that is not acknowledged yet */
+    unsigned initial_segment;
+    uint8_t actual_window_size;
+    uint8_t retry_count;
+    /* countdown in milliseconds - zero when stopped */
+    uint16_t segment_timer;
+} TSM_Segmented_Response[MAX_TSM_SEGMENTED_RESPONSES];
+/* the segments are sent from here, so that a handler that is
+   still using the Handler_Transmit_Buffer is not disturbed */
+static uint8_t TSM_Segment_PDU[MAX_PDU];
+
+/* Reassembly of a segmented ComplexACK that we are receiving
+   (Clause 5.4.4) - one at a time, in a buffer provided by the client */
+static uint8_t *TSM_Reassembly_Buffer;
+static uint16_t TSM_Reassembly_Size;
+static uint16_t TSM_Reassembly_Len;
+static TSM_SLOT TSM_Reassembly_Slot;
+
+/**
+ * @brief Determine the largest APDU that the peer is able to accept
+ * @param dest - address of the peer
+ * @param service_data - confirmed request data from the peer
+ * @return the size of the largest APDU, in octets
+ */
+static unsigned tsm_segment_apdu_max(
+    BACNET_ADDRESS *dest, BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    unsigned max_apdu = MAX_APDU;
+    unsigned device_max_apdu = 0;
+    uint32_t device_id = 0;
+    BACNET_ADDRESS device_address = { 0 };
+
+    if ((service_data->max_resp > 0) &&
+        ((unsigned)service_data->max_resp < max_apdu)) {
+        max_apdu = (unsigned)service_data->max_resp;
+    }
+    if (address_get_device_id(dest, &device_id) &&
+        address_get_by_device(device_id, &device_max_apdu, &device_address)) {
+        /* an APDU is never smaller than 50 octets */
+        if ((device_max_apdu >= 50) && (device_max_apdu < max_apdu)) {
+            max_apdu = device_max_apdu;
+        }
+    }
+
+    return max_apdu;
+}
+
+/**
+ * @brief Determine the size of the largest ComplexACK that can be sent
+ *  in segments to the peer that sent a confirmed request.
+ * @param dest - address of the peer
+ * @param service_data - confirmed request data from the peer
+ * @return the size of the largest ComplexACK APDU, in octets, which
+ *  is never larger than BACNET_SEGMENTATION_BUFFER_SIZE, or zero
+ *  if the peer does not accept a segmented response.
+ */
+unsigned tsm_segmented_response_max(
+    BACNET_ADDRESS *dest, BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    unsigned segment_size;
+    unsigned segment_count;
+    unsigned segment_max;
+    unsigned apdu_max;
+
+    if (!dest || !service_data ||
+        !service_data->segmented_response_accepted) {
+        return 0;
+    }
+    segment_size =
+        tsm_segment_apdu_max(dest, service_data) - TSM_SEGMENT_HEADER_LEN;
+    segment_max = BACNET_SEGMENTATION_BUFFER_SIZE / segment_size;
+    if (segment_max > 255) {
+        segment_max = 255;
+    }
+    /* zero is an unspecified number of segments,
+       and 65 is more than 64 segments */
+    segment_count = (unsigned)service_data->max_segs;
+    if ((segment_count == 0) || (segment_count > segment_max)) {
+        segment_count = segment_max;
+    }
+    apdu_max = TSM_COMPLEX_ACK_HEADER_LEN + (segment_size * segment_count);
+    if (apdu_max > BACNET_SEGMENTATION_BUFFER_SIZE) {
+        apdu_max = BACNET_SEGMENTATION_BUFFER_SIZE;
+    }
+
+    return apdu_max;
+}
+
+/**
+ * @brief Send one segment of a segmented ComplexACK
+ * @param response - segmented response
+ * @param segment - zero based segment number
+ */
+static void tsm_segment_send(
+    struct tsm_segmented_response *response, unsigned segment)
+{
+    BACNET_ADDRESS my_address;
+    unsigned offset;
+    unsigned len;
+    int pdu_len;
+    uint8_t *apdu;
+
+    offset = segment * response->segment_size;
+    len = response->data_len - offset;
+    if (len > response->segment_size) {
+        len = response->segment_size;
+    }
+    datalink_get_my_address(&my_address);
+    pdu_len = npdu_encode_pdu(&TSM_Segment_PDU[0], &response->dest,
+        &my_address, &response->npdu_data);
+    apdu = &TSM_Segment_PDU[pdu_len];
+    apdu[0] = PDU_TYPE_COMPLEX_ACK | BIT(3);
+    if ((segment + 1) < response->segment_count) {
+        apdu[0] |= BIT(2);
+    }
+    apdu[1] = response->invoke_id;
+    apdu[2] = (uint8_t)segment;
+    apdu[3] = BACNET_SEGMENTATION_WINDOW_SIZE;
+    apdu[4] = response->service_choice;
+    memcpy(&apdu[TSM_SEGMENT_HEADER_LEN], &response->data[offset], len);
+    pdu_len += TSM_SEGMENT_HEADER_LEN + len;
+    datalink_send_pdu(
+        &response->dest, &response->npdu_data, &TSM_Segment_PDU[0], pdu_len);
+}
+
+/**
+ * @brief Send the segments of the current window and start the
+ *  segment timer (FillWindow)
+ * @param response - segmented response
+ */
+static void tsm_segment_window_send(struct tsm_segmented_response *response)
+{
+    unsigned segment;
+
+    for (segment = response->initial_segment;
+         (segment < response->segment_count) &&
+         ((segment - response->initial_segment) <
+             response->actual_window_size);
+         segment++) {
+        tsm_segment_send(response, segment);
+    }
+    response->segment_timer = apdu_segment_timeout();
+}
+
+/**
+ * @brief Find the segmented response for a peer and an invoke ID
+ * @param src - address of the peer
+ * @param invokeID - invoke ID of the confirmed request
+ * @return the segmented response, or NULL if not found
+ */
+static struct tsm_segmented_response *tsm_segmented_response_find(
+    BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    unsigned i;
+    struct tsm_segmented_response *response;
+
+    for (i = 0; i < MAX_TSM_SEGMENTED_RESPONSES; i++) {
+        response = &TSM_Segmented_Response[i];
+        if (response->in_use && (response->invoke_id == invokeID) &&
+            bacnet_address_same(&response->dest, src)) {
+            return response;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Send a ComplexACK that is too large for the peer in segments.
+ *  The first segment is sent now, and the rest are sent as the peer
+ *  acknowledges them with a SegmentACK.
+ * @param dest - address of the peer
+ * @param npdu_data - NPDU data for the segments
+ * @param service_data - confirmed request data from the peer
+ * @param apdu - the complete, unsegmented ComplexACK APDU
+ * @param apdu_len - number of octets in the ComplexACK APDU
+ * @return true if the segmented response was started, or false if
+ *  the response is too large for the peer or no space is available.
+ */
+bool tsm_segmented_complex_ack_send(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data,
+    uint8_t *apdu,
+    unsigned apdu_len)
+{
+    struct tsm_segmented_response *response;
+    unsigned i;
+
+    if (!dest || !npdu_data || !service_data || !apdu ||
+        (apdu_len <= TSM_COMPLEX_ACK_HEADER_LEN)) {
+        return false;
+    }
+    if (apdu_len > tsm_segmented_response_max(dest, service_data)) {
+        return false;
+    }
+    /* a repeated request restarts the response */
+    response = tsm_segmented_response_find(dest, service_data->invoke_id);
+    for (i = 0; !response && (i < MAX_TSM_SEGMENTED_RESPONSES); i++) {
+        if (!TSM_Segmented_Response[i].in_use) {
+            response = &TSM_Segmented_Response[i];
+        }
+    }
+    if (!response) {
+        return false;
+    }
+    response->in_use = true;
+    bacnet_address_copy(&response->dest, dest);
+    npdu_copy_data(&response->npdu_data, npdu_data);
+    response->invoke_id = service_data->invoke_id;
+    response->service_choice = apdu[2];
+    response->data_len = apdu_len - TSM_COMPLEX_ACK_HEADER_LEN;
+    memcpy(&response->data[0], &apdu[TSM_COMPLEX_ACK_HEADER_LEN],
+        response->data_len);
+    response->segment_size =
+        tsm_segment_apdu_max(dest, service_data) - TSM_SEGMENT_HEADER_LEN;
+    response->segment_count =
+        (response->data_len + response->segment_size - 1) /
+        response->segment_size;
+    response->initial_segment = 0;
+    /* the first segment is sent alone, and the peer
+       sets the window size in its SegmentACK */
+    response->actual_window_size = 1;
+    response->retry_count = 0;
+    tsm_segment_window_send(response);
+
+    return true;
+}
+
+/**
+ * @brief Handle a SegmentACK for a segmented response that we are sending
+ * @param src - address of the peer
+ * @param invokeID - invoke ID of the segmented message
+ * @param sequence_number - sequence number of the acknowledged segment
+ * @param actual_window_size - window size requested by the peer
+ * @param nak - true if a segment was received out of order
+ * @param server - true if the SegmentACK was sent by a server
+ */
+void tsm_segment_ack_handler(BACNET_ADDRESS *src,
+    uint8_t invokeID,
+    uint8_t sequence_number,
+    uint8_t actual_window_size,
+    bool nak,
+    bool server)
+{
+    struct tsm_segmented_response *response;
+    uint8_t window_offset;
+    unsigned next_segment;
+
+    (void)nak;
+    if (!src || server) {
+        /* we do not send segmented requests */
+        return;
+    }
+    response = tsm_segmented_response_find(src, invokeID);
+    if (!response) {
+        return;
+    }
+    window_offset =
+        (uint8_t)(sequence_number - (uint8_t)response->initial_segment);
+    if (window_offset >= response->actual_window_size) {
+        /* duplicate SegmentACK */
+        response->segment_timer = apdu_segment_timeout();
+        return;
+    }
+    /* a negative SegmentACK resends from the segment after the
+       last one received in order, the same as a positive one */
+    next_segment = response->initial_segment + window_offset + 1;
+    if (next_segment >= response->segment_count) {
+        /* final acknowledgement */
+        response->in_use = false;
+        return;
+    }
+    if ((actual_window_size == 0) || (actual_window_size > 127)) {
+        actual_window_size = 1;
+    }
+    response->initial_segment = next_segment;
+    response->actual_window_size = actual_window_size;
+    response->retry_count = 0;
+    tsm_segment_window_send(response);
+}
+
+/**
+ * @brief Stop sending a segmented response when the peer aborts it
+ * @param src - address of the peer
+ * @param invokeID - invoke ID of the segmented message
+ */
+void tsm_segmented_response_abort(BACNET_ADDRESS *src, uint8_t invokeID)
+{
+    struct tsm_segmented_response *response;
+
+    if (src) {
+        response = tsm_segmented_response_find(src, invokeID);
+        if (response) {
+            response->in_use = false;
+        }
+    }
+}
+
+/**
+ * @brief Count down the segment timers of the segmented responses,
+ *  and send the window again or give up when a timer expires.
+ * @param milliseconds - Count of milliseconds passed, since the last call.
+ */
+static void tsm_segmented_response_timer(uint16_t milliseconds)
+{
+    unsigned i;
+    struct tsm_segmented_response *response;
+
+    for (i = 0; i < MAX_TSM_SEGMENTED_RESPONSES; i++) {
+        response = &TSM_Segmented_Response[i];
+        if (!response->in_use || (response->segment_timer == 0)) {
+            continue;
+        }
+        if (response->segment_timer > milliseconds) {
+            response->segment_timer -= milliseconds;
+        } else if (response->retry_count < apdu_retries()) {
+            response->retry_count++;
+            tsm_segment_window_send(response);
+        } else {
+            response->in_use = false;
+        }
+    }
+}
+
+/**
+ * @brief Set the buffer used to reassemble a segmented ComplexACK.
+ *  Segmented replies are only accepted once a buffer is set.
+ * @param buffer - buffer for the service data of the reply, or NULL
+ * @param size - size of the buffer, in octets
+ */
+void tsm_reassembly_buffer_set(uint8_t *buffer, uint16_t size)
+{
+    TSM_Reassembly_Buffer = buffer;
+    TSM_Reassembly_Size = buffer ? size : 0;
+    TSM_Reassembly_Len = 0;
+    TSM_Reassembly_Slot = TSM_SLOT_NONE;
+}
+
+/**
+ * @brief Get the size of the buffer used to reassemble a segmented ComplexACK
+ * @return size of the buffer, in octets, or 0 if no buffer is set
+ */
+uint16_t tsm_reassembly_buffer_size(void)
+{
+    return TSM_Reassembly_Size;
+}
+
+/**
+ * @brief Mark an encoded confirmed request to accept a segmented reply,
+ *  if a reassembly buffer has been set. Call before the request is
+ *  given to the TSM.
+ * @param apdu - the encoded confirmed request APDU
+ * @return true if the request accepts a segmented reply
+ */
+bool tsm_segmented_response_accepted_encode(uint8_t *apdu)
+{
+    if (!apdu || !TSM_Reassembly_Buffer ||
+        ((apdu[0] & 0xF0) != PDU_TYPE_CONFIRMED_SERVICE_REQUEST)) {
+        return false;
+    }
+    apdu[0] |= BIT(1);
+    apdu[1] = encode_max_segs_max_apdu(BACNET_MAX_SEGMENTS_ACCEPTED, MAX_APDU);
+
+    return true;
+}
+
+/**
+ * @brief Release the reassembly buffer held by a transaction
+ * @param slot - slot number of the transaction
+ */
+static void tsm_reassembly_release(TSM_SLOT slot)
+{
+    if (TSM_Reassembly_Slot == slot) {
+        TSM_Reassembly_Slot = TSM_SLOT_NONE;
+        TSM_Reassembly_Len = 0;
+    }
+}
+
+/**
+ * @brief Send a SegmentACK for a segmented ComplexACK that we are receiving
+ * @param dest - address of the server
+ * @param plist - transaction
+ * @param nak - true if a segment was received out of order
+ */
+static void tsm_segment_ack_send(
+    BACNET_ADDRESS *dest, BACNET_TSM_DATA *plist, bool nak)
+{
+    BACNET_ADDRESS my_address;
+    BACNET_NPDU_DATA npdu_data;
+    int pdu_len;
+    uint8_t *apdu;
+
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, plist->npdu_data.priority);
+    pdu_len = npdu_encode_pdu(
+        &TSM_Segment_PDU[0], dest, &my_address, &npdu_data);
+    apdu = &TSM_Segment_PDU[pdu_len];
+    apdu[0] = PDU_TYPE_SEGMENT_ACK;
+    if (nak) {
+        apdu[0] |= BIT(1);
+    }
+    apdu[1] = plist->InvokeID;
+    apdu[2] = plist->LastSequenceNumber;
+    apdu[3] = plist->ActualWindowSize;
+    pdu_len += 4;
+    datalink_send_pdu(dest, &npdu_data, &TSM_Segment_PDU[0], pdu_len);
+}
+
+/**
+ * @brief Abort a segmented ComplexACK that we are receiving. The
+ *  transaction is left IDLE with a valid invoke ID, which marks it
+ *  as failed.
+ * @param dest - address of the server
+ * @param slot - slot number of the transaction
+ * @param reason - abort reason
+ */
+static void tsm_reassembly_abort(
+    BACNET_ADDRESS *dest, TSM_SLOT slot, BACNET_ABORT_REASON reason)
+{
+    BACNET_TSM_DATA *plist = TSM_SLOT_DATA(slot);
+    BACNET_ADDRESS my_address;
+    BACNET_NPDU_DATA npdu_data;
+    int pdu_len;
+
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, plist->npdu_data.priority);
+    pdu_len = npdu_encode_pdu(
+        &TSM_Segment_PDU[0], dest, &my_address, &npdu_data);
+    pdu_len += abort_encode_apdu(
+        &TSM_Segment_PDU[pdu_len], plist->InvokeID, reason, false);
+    datalink_send_pdu(dest, &npdu_data, &TSM_Segment_PDU[0], pdu_len);
+    tsm_timer_stop(slot);
+    tsm_reassembly_release(slot);
+    plist->state = TSM_STATE_IDLE;
+    BACNET_TRACE(TSM_STATE, plist->InvokeID, plist->state);
+    if (Timeout_Function) {
+        Timeout_Function(plist->InvokeID);
+    }
+}
+
+/**
+ * @brief Append a segment to the reassembly buffer
+ * @param service_data - service data of the segment
+ * @param service_len - number of octets of service data
+ * @return true if the segment fits into the reassembly buffer
+ */
+static bool tsm_reassembly_append(uint8_t *service_data, uint16_t service_len)
+{
+    if (service_len > (TSM_Reassembly_Size - TSM_Reassembly_Len)) {
+        return false;
+    }
+    memcpy(&TSM_Reassembly_Buffer[TSM_Reassembly_Len], service_data,
+        service_len);
+    TSM_Reassembly_Len += service_len;
+
+    return true;
+}
+
+/**
+ * @brief Handle a segment of a ComplexACK, for a confirmed request that
+ *  we sent, and acknowledge the segments as each window is filled.
+ * @param src - address of the server, which must be the peer that the
+ *  request was sent to
+ * @param ack_data - decoded header of the segment
+ * @param service_data - service data of the segment
+ * @param service_len - number of octets of service data
+ * @param assembled_data - set to the reassembled service data
+ *  when the last segment is received
+ * @param assembled_len - set to the number of octets of reassembled
+ *  service data when the last segment is received
+ * @return true when the whole ComplexACK has been reassembled, and
+ *  the transaction may be handled and freed by the caller.
+ */
+bool tsm_segmented_complex_ack_handler(BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_ACK_DATA *ack_data,
+    uint8_t *service_data,
+    uint16_t service_len,
+    uint8_t **assembled_data,
+    uint16_t *assembled_len)
+{
+    uint8_t index;
+    TSM_SLOT slot;
+    BACNET_TSM_DATA *plist;
+    uint8_t window_size;
+    uint32_t segment_wait;
+
+    if (!src || !ack_data || !assembled_data || !assembled_len) {
+        return false;
+    }
+    index = tsm_find_invokeID_index(ack_data->invoke_id);
+    if (index >= MAX_TSM_TRANSACTIONS) {
+        return false;
+    }
+    slot = index + 1;
+    plist = &TSM_List[index];
+    if (!bacnet_address_same(&plist->dest, src)) {
+        /* not from the peer that the request was sent to */
+        return false;
+    }
+    window_size = ack_data->proposed_window_number;
+    if ((window_size == 0) || (window_size > 127)) {
+        tsm_reassembly_abort(src, slot, ABORT_REASON_WINDOW_SIZE_OUT_OF_RANGE);
+        return false;
+    }
+    if (window_size > BACNET_SEGMENTATION_WINDOW_SIZE) {
+        window_size = BACNET_SEGMENTATION_WINDOW_SIZE;
+    }
+    if (plist->state == TSM_STATE_AWAIT_CONFIRMATION) {
+        if (ack_data->sequence_number != 0) {
+            /* not the first segment - ignore it */
+            return false;
+        }
+        if (!TSM_Reassembly_Buffer ||
+            (TSM_Reassembly_Slot != TSM_SLOT_NONE)) {
+            tsm_reassembly_abort(src, slot, ABORT_REASON_OUT_OF_RESOURCES);
+            return false;
+        }
+        TSM_Reassembly_Slot = slot;
+        TSM_Reassembly_Len = 0;
+        if (!tsm_reassembly_append(service_data, service_len)) {
+            tsm_reassembly_abort(src, slot, ABORT_REASON_BUFFER_OVERFLOW);
+            return false;
+        }
+        plist->state = TSM_STATE_SEGMENTED_CONFIRMATION;
+        BACNET_TRACE(TSM_STATE, plist->InvokeID, plist->state);
+        plist->InitialSequenceNumber = 0;
+        plist->LastSequenceNumber = 0;
+        plist->ActualWindowSize = window_size;
+        tsm_segment_ack_send(src, plist, false);
+    } else if ((plist->state == TSM_STATE_SEGMENTED_CONFIRMATION) &&
+        (TSM_Reassembly_Slot == slot)) {
+        if (ack_data->sequence_number ==
+            (uint8_t)(plist->LastSequenceNumber + 1)) {
+            if (!tsm_reassembly_append(service_data, service_len)) {
+                tsm_reassembly_abort(src, slot, ABORT_REASON_BUFFER_OVERFLOW);
+                return false;
+            }
+            plist->LastSequenceNumber = ack_data->sequence_number;
+            if (!ack_data->more_follows) {
+                tsm_segment_ack_send(src, plist, false);
+            } else if (ack_data->sequence_number ==
+                (uint8_t)(plist->InitialSequenceNumber +
+                    plist->ActualWindowSize)) {
+                /* the window is filled */
+                plist->InitialSequenceNumber = ack_data->sequence_number;
+                plist->ActualWindowSize = window_size;
+                tsm_segment_ack_send(src, plist, false);
+            }
+        } else {
+            /* segment received out of order */
+            plist->InitialSequenceNumber = plist->LastSequenceNumber;
+            tsm_segment_ack_send(src, plist, true);
+        }
+    } else {
+        return false;
+    }
+    if (!ack_data->more_follows) {
+        tsm_timer_stop(slot);
+        *assembled_data = TSM_Reassembly_Buffer;
+        *assembled_len = TSM_Reassembly_Len;
+        return true;
+    }
+    /* wait for the next segment */
+    segment_wait = (uint32_t)apdu_segment_timeout() * 4;
+    if (segment_wait > UINT16_MAX) {
+        segment_wait = UINT16_MAX;
+    }
+    tsm_timer_start(slot, (uint16_t)segment_wait);
+
+    return false;
+}
+#endif
+
+/** Handle the expiry of a request timer: the request is sent again
+ *  until the retries are used up, and then the timeout handler is called.
+ *
+ * @param slot  Slot number of the expired transaction
+ */
+static void tsm_transaction_timeout(TSM_SLOT slot)
+{
+    BACNET_TSM_DATA *plist = TSM_SLOT_DATA(slot);
+
+#if BACNET_SEGMENTATION_ENABLED
+    if (plist->state == TSM_STATE_SEGMENTED_CONFIRMATION) {
+        /* the next segment of the reply did not arrive */
+        tsm_reassembly_release(slot);
+        plist->state = TSM_STATE_IDLE;
+        BACNET_TRACE(TSM_STATE, plist->InvokeID, plist->state);
+        if (Timeout_Function) {
+            Timeout_Function(plist->InvokeID);
+        }
+        return;
+    }
+#endif
+    if (plist->state != TSM_STATE_AWAIT_CONFIRMATION) {
+        return;
+    }
+    if (plist->RetryCount < apdu_retries()) {
+        plist->RetryCount++;
+        plist->RequestTimer =
+            tsm_request_timeout(&plist->dest, plist->RetryCount);
+        tsm_timer_start(slot, plist->RequestTimer);
+        datalink_send_pdu(
+            &plist->dest, &plist->npdu_data, &plist->apdu[0], plist->apdu_len);
+    } else {
+        /* note: the invoke id has not been cleared yet
+           and this indicates a failed message:
+           IDLE and a valid invoke id */
+        plist->RequestTimer = 0;
+        plist->state = TSM_STATE_IDLE;
+        BACNET_TRACE(TSM_STATE, plist->InvokeID, plist->state);
+        if (plist->InvokeID != 0) {
+            if (Timeout_Function) {
+                Timeout_Function(plist->InvokeID);
+            }
+        }
+    }
+}
+
+/** Expire the transactions in one bucket of the timer wheel.
+ *  The bucket is scanned again from the start after each expiry
+ *  since the timeout handler may start or free other transactions.
+ *
+ * @param bucket  Timer wheel bucket
+ */
+static void tsm_timer_bucket_expire(unsigned bucket)
+{
+    TSM_SLOT slot;
+    struct tsm_timer_node *node;
+
+    slot = TSM_Timer_Wheel[bucket];
+    while (slot != TSM_SLOT_NONE) {
+        node = &TSM_Timer[slot - 1];
+        if ((int32_t)(TSM_Timer_Clock - node->expiry) >= 0) {
+            tsm_timer_stop(slot);
+            tsm_transaction_timeout(slot);
+            slot = TSM_Timer_Wheel[bucket];
+        } else {
+            slot = node->next;
+        }
+    }
+}
+
 /** Called once a millisecond or slower.
  *  This function calls the handler for a
  *  timeout 'Timeout_Function', if necessary.
@@ -321,38 +1091,41 @@ bool tsm_get_transaction_pdu(uint8_t invokeID,
  */
 void tsm_timer_milliseconds(uint16_t milliseconds)
 {
-    unsigned i = 0; /* counter */
+    uint32_t tick;
+    uint32_t count;
+#if BACNET_MEMSTATS
+    static bool memstats_noted;
+    size_t static_bytes;
 
-    BACNET_TSM_DATA *plist = &TSM_List[0];
+    if (!memstats_noted) {
+        memstats_noted = true;
+        static_bytes = sizeof(TSM_List) + sizeof(TSM_Invoke_Slot) +
+            sizeof(TSM_Free_Slot) + sizeof(TSM_Timer) +
+            sizeof(TSM_Timer_Wheel);
+#if BACNET_SEGMENTATION_ENABLED
+        static_bytes +=
+            sizeof(TSM_Segmented_Response) + sizeof(TSM_Segment_PDU);
+#endif
+        bacnet_memstats_static(MEMSTATS_TSM, static_bytes);
+    }
+#endif
 
-    for (i = 0; i < MAX_TSM_TRANSACTIONS; i++, plist++) {
-        if (plist->state == TSM_STATE_AWAIT_CONFIRMATION) {
-            if (plist->RequestTimer > milliseconds) {
-                plist->RequestTimer -= milliseconds;
-            } else {
-                plist->RequestTimer = 0;
-            }
-            /* AWAIT_CONFIRMATION */
-            if (plist->RequestTimer == 0) {
-                if (plist->RetryCount < apdu_retries()) {
-                    plist->RequestTimer = apdu_timeout();
-                    plist->RetryCount++;
-                    datalink_send_pdu(&plist->dest, &plist->npdu_data,
-                        &plist->apdu[0], plist->apdu_len);
-                } else {
-                    /* note: the invoke id has not been cleared yet
-                       and this indicates a failed message:
-                       IDLE and a valid invoke id */
-                    plist->state = TSM_STATE_IDLE;
-                    if (plist->InvokeID != 0) {
-                        if (Timeout_Function) {
-                            Timeout_Function(plist->InvokeID);
-                        }
-                    }
-                }
-            }
-        }
+    TSM_Timer_Clock += milliseconds;
+    tick = TSM_Timer_Clock / TSM_TIMER_TICK_MS;
+    /* visit the bucket of the last tick again, since it may hold
+       timers that expire later in that tick, and each elapsed tick */
+    count = tick - TSM_Timer_Tick;
+    if (count >= TSM_TIMER_WHEEL_SIZE) {
+        count = TSM_TIMER_WHEEL_SIZE - 1;
+    }
+    for (TSM_Timer_Tick = tick - count; TSM_Timer_Tick != tick;
+         TSM_Timer_Tick++) {
+        tsm_timer_bucket_expire(TSM_Timer_Tick % TSM_TIMER_WHEEL_SIZE);
     }
+    tsm_timer_bucket_expire(tick % TSM_TIMER_WHEEL_SIZE);
+#if BACNET_SEGMENTATION_ENABLED
+    tsm_segmented_response_timer(milliseconds);
+#endif
 }
 
 /** Frees the invokeID and sets its state to IDLE
@@ -367,8 +1140,15 @@ void tsm_free_invoke_id(uint8_t invokeID)
     index = tsm_find_invokeID_index(invokeID);
     if (index < MAX_TSM_TRANSACTIONS) {
         plist = &TSM_List[index];
+        tsm_timer_stop(index + 1);
+#if BACNET_SEGMENTATION_ENABLED
+        tsm_reassembly_release(index + 1);
+#endif
         plist->state = TSM_STATE_IDLE;
+        BACNET_TRACE(TSM_STATE, plist->InvokeID, plist->state);
         plist->InvokeID = 0;
+        TSM_Invoke_Slot[invokeID] = TSM_SLOT_NONE;
+        tsm_slot_release(index + 1);
     }
 }
 
@@ -413,5 +1193,43 @@ bool tsm_invoke_id_failed(uint8_t invokeID)
 
     return status;
 }
+
+/** Get the milliseconds since a confirmed request was sent, when a reply
+ *  to it is received from its destination.  Only a request that was sent
+ *  once is timed, since a reply to a retry could be to any of the sends.
+ * @param invokeID [in] The invokeID of the reply.
+ * @param src [in] The address that the reply came from.
+ * @param milliseconds [out] The round trip time of the request.
+ * @return True if the round trip time is known.
+ */
+bool tsm_round_trip_time(
+    uint8_t invokeID, BACNET_ADDRESS *src, uint16_t *milliseconds)
+{
+    BACNET_TSM_DATA *plist;
+    struct tsm_timer_node *node;
+    uint32_t remaining;
+    uint8_t index;
+
+    index = tsm_find_invokeID_index(invokeID);
+    if ((index >= MAX_TSM_TRANSACTIONS) || !milliseconds) {
+        return false;
+    }
+    plist = &TSM_List[index];
+    node = &TSM_Timer[index];
+    if ((plist->state != TSM_STATE_AWAIT_CONFIRMATION) ||
+        (plist->RetryCount != 0) || !node->armed ||
+        !bacnet_address_same(&plist->dest, src)) {
+        return false;
+    }
+    remaining = node->expiry - TSM_Timer_Clock;
+    if ((int32_t)remaining < 0) {
+        remaining = 0;
+    } else if (remaining > plist->RequestTimer) {
+        remaining = plist->RequestTimer;
+    }
+    *milliseconds = (uint16_t)(plist->RequestTimer - remaining);
+
+    return true;
+}
 #endif
 
@@ -30,6 +30,7 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/apdu.h"
 #include "bacnet/npdu.h"
 
 /* note: TSM functionality is optional - only needed if we are
@@ -40,8 +41,16 @@ extern "C" {
 #endif /* __cplusplus */
 
     /* FIXME: modify basic service handlers to use TSM rather than this buffer! */
+#if BACNET_HANDLER_TRANSMIT_BUFFER_THREAD_LOCAL
+#if !defined(BACNET_STACK_THREAD_LOCAL)
+#error "Thread local storage is not supported by this compiler"
+#endif
+    extern BACNET_STACK_THREAD_LOCAL
+    uint8_t Handler_Transmit_Buffer[MAX_PDU];
+#else
     BACNET_STACK_EXPORT extern 
     uint8_t Handler_Transmit_Buffer[MAX_PDU];
+#endif
 
 #ifdef __cplusplus
 }
@@ -69,19 +78,21 @@ typedef struct BACnet_TSM_Data {
     /*uint8_t SegmentRetryCount;  */
     /* used to control APDU retries and the acceptance of server replies */
     /*bool SentAllSegments;  */
+#if BACNET_SEGMENTATION_ENABLED
     /* stores the sequence number of the last segment received in order */
-    /*uint8_t LastSequenceNumber; */
+    uint8_t LastSequenceNumber;
     /* stores the sequence number of the first segment of */
     /* a sequence of segments that fill a window */
-    /*uint8_t InitialSequenceNumber; */
+    uint8_t InitialSequenceNumber;
     /* stores the current window size */
-    /*uint8_t ActualWindowSize; */
+    uint8_t ActualWindowSize;
+#endif
     /* stores the window size proposed by the segment sender */
     /*uint8_t ProposedWindowSize;  */
     /*  used to perform timeout on PDU segments */
     /*uint8_t SegmentTimer; */
     /* used to perform timeout on Confirmed Requests */
-    /* in milliseconds */
+    /* in milliseconds - the countdown is kept by the TSM timer wheel */
     uint16_t RequestTimer;
     /* unique id */
     uint8_t InvokeID;
@@ -100,6 +111,14 @@ typedef void (
     *tsm_timeout_function) (
     uint8_t invoke_id);
 
+/* returns the milliseconds to wait for a reply from a peer, for the
+   given number of times that the request was sent again, or 0 to use
+   the APDU timeout */
+typedef uint16_t (
+    *tsm_peer_timeout_function) (
+    BACNET_ADDRESS * dest,
+    uint8_t retry_count);
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -108,6 +127,9 @@ extern "C" {
     BACNET_STACK_EXPORT
     void tsm_set_timeout_handler(
         tsm_timeout_function pFunction);
+    BACNET_STACK_EXPORT
+    void tsm_set_peer_timeout_handler(
+        tsm_peer_timeout_function pFunction);
 
     BACNET_STACK_EXPORT
     bool tsm_transaction_available(
@@ -152,6 +174,55 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool tsm_invoke_id_failed(
         uint8_t invokeID);
+    BACNET_STACK_EXPORT
+    bool tsm_round_trip_time(
+        uint8_t invokeID,
+        BACNET_ADDRESS * src,
+        uint16_t * milliseconds);
+
+#if BACNET_SEGMENTATION_ENABLED
+    BACNET_STACK_EXPORT
+    unsigned tsm_segmented_response_max(
+        BACNET_ADDRESS * dest,
+        BACNET_CONFIRMED_SERVICE_DATA * service_data);
+    BACNET_STACK_EXPORT
+    bool tsm_segmented_complex_ack_send(
+        BACNET_ADDRESS * dest,
+        BACNET_NPDU_DATA * npdu_data,
+        BACNET_CONFIRMED_SERVICE_DATA * service_data,
+        uint8_t * apdu,
+        unsigned apdu_len);
+    BACNET_STACK_EXPORT
+    void tsm_segment_ack_handler(
+        BACNET_ADDRESS * src,
+        uint8_t invokeID,
+        uint8_t sequence_number,
+        uint8_t actual_window_size,
+        bool nak,
+        bool server);
+    BACNET_STACK_EXPORT
+    void tsm_segmented_response_abort(
+        BACNET_ADDRESS * src,
+        uint8_t invokeID);
+    BACNET_STACK_EXPORT
+    void tsm_reassembly_buffer_set(
+        uint8_t * buffer,
+        uint16_t size);
+    BACNET_STACK_EXPORT
+    uint16_t tsm_reassembly_buffer_size(
+        void);
+    BACNET_STACK_EXPORT
+    bool tsm_segmented_response_accepted_encode(
+        uint8_t * apdu);
+    BACNET_STACK_EXPORT
+    bool tsm_segmented_complex_ack_handler(
+        BACNET_ADDRESS * src,
+        BACNET_CONFIRMED_SERVICE_ACK_DATA * ack_data,
+        uint8_t * service_data,
+        uint16_t service_len,
+        uint8_t ** assembled_data,
+        uint16_t * assembled_len);
+#endif
 
 #ifdef __cplusplus
 }
@@ -26,7 +26,7 @@
 #if !(defined(BACDL_ETHERNET) || defined(BACDL_ARCNET) || \
     defined(BACDL_MSTP) || defined(BACDL_BIP) || defined(BACDL_BIP6) || \
     defined(BACDL_TEST) || defined(BACDL_ALL) || defined(BACDL_NONE) || \
-    defined(BACDL_CUSTOM))
+    defined(BACDL_CUSTOM) || defined(BACDL_LOOPBACK))
 #define BACDL_BIP
 #endif
 
@@ -114,6 +114,141 @@
 #if !defined(MAX_TSM_TRANSACTIONS)
 #define MAX_TSM_TRANSACTIONS 255
 #endif
+/* Segmentation of ComplexACK responses, and reassembly of segmented
+   ComplexACK replies to confirmed requests.
+   Configure to zero for unsegmented messages only. */
+#if !defined(BACNET_SEGMENTATION_ENABLED)
+#define BACNET_SEGMENTATION_ENABLED 0
+#endif
+#if BACNET_SEGMENTATION_ENABLED && !MAX_TSM_TRANSACTIONS
+/* segmentation is done by the TSM */
+#undef BACNET_SEGMENTATION_ENABLED
+#define BACNET_SEGMENTATION_ENABLED 0
+#endif
+#if BACNET_SEGMENTATION_ENABLED
+/* number of segments that we send or accept in one message */
+#if !defined(BACNET_MAX_SEGMENTS_ACCEPTED)
+#define BACNET_MAX_SEGMENTS_ACCEPTED 16
+#endif
+/* size of the largest segmented APDU that we will send */
+#if !defined(BACNET_SEGMENTATION_BUFFER_SIZE)
+#define BACNET_SEGMENTATION_BUFFER_SIZE (MAX_APDU * BACNET_MAX_SEGMENTS_ACCEPTED)
+#endif
+/* number of segments we propose to send or receive before a SegmentACK */
+#if !defined(BACNET_SEGMENTATION_WINDOW_SIZE)
+#define BACNET_SEGMENTATION_WINDOW_SIZE 4
+#endif
+/* number of segmented responses that can be sent at the same time */
+#if !defined(MAX_TSM_SEGMENTED_RESPONSES)
+#define MAX_TSM_SEGMENTED_RESPONSES 2
+#endif
+#endif
+/* Objects that report their own changes of value put the changed object
+   into a queue, so that the COV task checks only the changed objects
+   rather than polling each subscribed object.
+   Configure to zero to poll each subscribed object. */
+#if !defined(BACNET_COV_CHANGE_QUEUE_ENABLED)
+#define BACNET_COV_CHANGE_QUEUE_ENABLED 0
+#endif
+#if BACNET_COV_CHANGE_QUEUE_ENABLED
+/* number of changed objects in the queue - must be a power of two */
+#if !defined(BACNET_COV_CHANGE_QUEUE_SIZE)
+#define BACNET_COV_CHANGE_QUEUE_SIZE 64
+#endif
+#endif
+/* An unconfirmed COV notification of an object to several subscribers
+   on the same network, with the same process identifier, is sent once
+   as a broadcast on that network, and the subscribers filter it by the
+   process identifier.  Configure to zero to notify each subscriber. */
+#if !defined(BACNET_COV_BROADCAST_ENABLED)
+#define BACNET_COV_BROADCAST_ENABLED 0
+#endif
+#if BACNET_COV_BROADCAST_ENABLED
+/* number of subscribers that are notified with one broadcast, at least */
+#if !defined(BACNET_COV_BROADCAST_MIN)
+#define BACNET_COV_BROADCAST_MIN 2
+#endif
+#endif
+/* The COV notifications of the objects that changed in the same COV task
+   cycle, for the same subscriber and process identifier, are sent as one
+   COVNotificationMultiple, so that a change of many objects, such as a
+   change of mode, does not send a notification for each object.  The
+   subscribers must execute the COVNotificationMultiple service.
+   Configure to zero to send a notification for each object. */
+#if !defined(BACNET_COV_NOTIFICATION_MULTIPLE_ENABLED)
+#define BACNET_COV_NOTIFICATION_MULTIPLE_ENABLED 0
+#endif
+/* Objects with intrinsic reporting put themselves into a queue when their
+   Present_Value or their event properties change, or while a time delay
+   is counting, so that Device_local_reporting() evaluates only those
+   objects rather than every object each second.
+   Configure to zero to evaluate every object. */
+#if !defined(BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED)
+#define BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED 0
+#endif
+#if BACNET_INTRINSIC_REPORTING_QUEUE_ENABLED
+/* number of objects in the queue */
+#if !defined(BACNET_INTRINSIC_REPORTING_QUEUE_SIZE)
+#define BACNET_INTRINSIC_REPORTING_QUEUE_SIZE 64
+#endif
+#endif
+/* The analog and binary input, output and value objects also keep their
+   Present_Value, status flags and COV flag in columns, one array for
+   each, so that a scan of all of the objects reads contiguous memory.
+   Configure to one to keep the columns. */
+#if !defined(BACNET_OBJECT_COLUMNS_ENABLED)
+#define BACNET_OBJECT_COLUMNS_ENABLED 0
+#endif
+/* The changes made to the object database by WriteProperty,
+   CreateObject, DeleteObject and the COV subscriptions are kept in a
+   snapshot journal, which is replayed at start up to restore them.
+   Configure to one to keep the journal. */
+#if !defined(BACNET_SNAPSHOT_ENABLED)
+#define BACNET_SNAPSHOT_ENABLED 0
+#endif
+/* Enable to give each thread its own Handler_Transmit_Buffer, so that
+   several threads may each run npdu_handler() and encode a reply.
+   The object database and the TSM are still shared, and the caller
+   must serialize access to them. */
+#if !defined(BACNET_HANDLER_TRANSMIT_BUFFER_THREAD_LOCAL)
+#define BACNET_HANDLER_TRANSMIT_BUFFER_THREAD_LOCAL 0
+#endif
+/* Heap-free build: the memory that the library allocates is taken from
+   static pools of fixed size blocks, one pool for each block size, rather
+   than from malloc().  A request is given a block of the smallest size
+   that holds it, and fails when that pool and the larger ones are empty.
+   Configure to one for the static pools, and configure the number of
+   blocks of each size for the product. */
+#if !defined(BACNET_STATIC_POOLS)
+#define BACNET_STATIC_POOLS 0
+#endif
+#if BACNET_STATIC_POOLS
+#if !defined(BACNET_STATIC_POOL_BLOCKS_32)
+#define BACNET_STATIC_POOL_BLOCKS_32 256
+#endif
+#if !defined(BACNET_STATIC_POOL_BLOCKS_64)
+#define BACNET_STATIC_POOL_BLOCKS_64 128
+#endif
+#if !defined(BACNET_STATIC_POOL_BLOCKS_128)
+#define BACNET_STATIC_POOL_BLOCKS_128 64
+#endif
+#if !defined(BACNET_STATIC_POOL_BLOCKS_256)
+#define BACNET_STATIC_POOL_BLOCKS_256 32
+#endif
+#if !defined(BACNET_STATIC_POOL_BLOCKS_1024)
+#define BACNET_STATIC_POOL_BLOCKS_1024 16
+#endif
+#if !defined(BACNET_STATIC_POOL_BLOCKS_4096)
+#define BACNET_STATIC_POOL_BLOCKS_4096 4
+#endif
+#if !defined(BACNET_STATIC_POOL_BLOCKS_16384)
+#define BACNET_STATIC_POOL_BLOCKS_16384 2
+#endif
+/* 1 for the compiler to show the capacity and RAM of the pools */
+#if !defined(BACNET_STATIC_POOLS_REPORT)
+#define BACNET_STATIC_POOLS_REPORT 1
+#endif
+#endif
 /* The address cache is used for binding to BACnet devices */
 /* The number of entries corresponds to the number of */
 /* devices that might respond to an I-Am on the network. */
@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -19,23 +20,21 @@ COV Subscribe
 COV Subscribe Property
 COV Notification
 Unconfirmed COV Notification
+COV Notification Multiple
 */
 
 /**
- * @brief Encode APDU for COV Notification.
+ * @brief Encode the COV Notification values that are the same for
+ *  each subscriber, except the listOfValues.
  * @param apdu  Pointer to the buffer, or NULL for length
  * @param data  Pointer to the data to encode.
- * @return number of bytes encoded, or zero on error.
+ * @return number of bytes encoded
  */
-int cov_notify_encode_apdu(uint8_t *apdu, BACNET_COV_DATA *data)
+static int cov_notify_header_encode(uint8_t *apdu, BACNET_COV_DATA *data)
 {
     int len = 0; /* length of each encoding */
     int apdu_len = 0; /* total length of the apdu, return value */
-    BACNET_PROPERTY_VALUE *value = NULL; /* value in list */
 
-    if (!data) {
-        return 0;
-    }
     /* tag 0 - subscriberProcessIdentifier */
     len =
         encode_context_unsigned(apdu, 0, data->subscriberProcessIdentifier);
@@ -61,9 +60,25 @@ int cov_notify_encode_apdu(uint8_t *apdu, BACNET_COV_DATA *data)
     /* tag 3 - timeRemaining */
     len = encode_context_unsigned(apdu, 3, data->timeRemaining);
     apdu_len += len;
-    if (apdu) {
-        apdu += len;
-    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the listOfValues of a COV Notification.
+ *  The encoded values can be used for each subscriber of an object
+ *  with cov_notify_service_request_values_encode().
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param value_list  Pointer to the first value of the list of values
+ * @return number of bytes encoded
+ */
+int cov_notify_value_list_encode(
+    uint8_t *apdu, BACNET_PROPERTY_VALUE *value_list)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+    BACNET_PROPERTY_VALUE *value = NULL; /* value in list */
+
     /* tag 4 - listOfValues */
     len = encode_opening_tag(apdu, 4);
     apdu_len += len;
@@ -71,7 +86,7 @@ int cov_notify_encode_apdu(uint8_t *apdu, BACNET_COV_DATA *data)
         apdu += len;
     }
     /* the first value includes a pointer to the next value, etc */
-    value = data->listOfValues;
+    value = value_list;
     while (value != NULL) {
         len = bacapp_property_value_encode(apdu, value);
         apdu_len += len;
@@ -87,6 +102,31 @@ int cov_notify_encode_apdu(uint8_t *apdu, BACNET_COV_DATA *data)
     return apdu_len;
 }
 
+/**
+ * @brief Encode APDU for COV Notification.
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param data  Pointer to the data to encode.
+ * @return number of bytes encoded, or zero on error.
+ */
+int cov_notify_encode_apdu(uint8_t *apdu, BACNET_COV_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data) {
+        return 0;
+    }
+    len = cov_notify_header_encode(apdu, data);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_value_list_encode(apdu, data->listOfValues);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
 /**
  * @brief Encode the COVNotification service request
  * @param apdu  Pointer to the buffer for encoding into
@@ -109,6 +149,41 @@ size_t cov_notify_service_request_encode(
     return apdu_len;
 }
 
+/**
+ * @brief Encode the COVNotification service request using a listOfValues
+ *  that was encoded by cov_notify_value_list_encode(), so that the values
+ *  of an object are encoded once for all of its subscribers.
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param data  Pointer to the service data used for encoding values.
+ *  The listOfValues of the data is not used.
+ * @param value_list  Pointer to the encoded listOfValues
+ * @param value_list_len  Number of bytes in the encoded listOfValues
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+size_t cov_notify_service_request_values_encode(uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_COV_DATA *data,
+    const uint8_t *value_list,
+    size_t value_list_len)
+{
+    size_t apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data || !value_list) {
+        return 0;
+    }
+    apdu_len = cov_notify_header_encode(NULL, data) + value_list_len;
+    if (apdu_len > apdu_size) {
+        apdu_len = 0;
+    } else if (apdu) {
+        apdu_len = cov_notify_header_encode(apdu, data);
+        memcpy(&apdu[apdu_len], value_list, value_list_len);
+        apdu_len += value_list_len;
+    }
+
+    return apdu_len;
+}
+
 /**
  * Encode APDU for confirmed notification.
  *
@@ -149,6 +224,50 @@ int ccov_notify_encode_apdu(uint8_t *apdu,
     return apdu_len;
 }
 
+/**
+ * Encode APDU for confirmed notification, using an encoded listOfValues.
+ *
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param invoke_id  ID to invoke for notification
+ * @param data  Pointer to the data to encode.
+ * @param value_list  Pointer to the encoded listOfValues
+ * @param value_list_len  Number of bytes in the encoded listOfValues
+ *
+ * @return bytes encoded or zero on error.
+ */
+int ccov_notify_values_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    BACNET_COV_DATA *data,
+    const uint8_t *value_list,
+    size_t value_list_len)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu && (apdu_size > 4)) {
+        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        apdu[2] = invoke_id;
+        apdu[3] = SERVICE_CONFIRMED_COV_NOTIFICATION;
+    }
+    len = 4;
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_service_request_values_encode(
+        apdu, apdu_size - apdu_len, data, value_list, value_list_len);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
 /**
  * @brief Encode APDU for unconfirmed notification.
  * @param apdu  Pointer to the buffer for encoding into, or NULL for length
@@ -182,6 +301,284 @@ int ucov_notify_encode_apdu(
     return apdu_len;
 }
 
+/**
+ * @brief Encode APDU for unconfirmed notification, using an encoded
+ *  listOfValues.
+ * @param apdu  Pointer to the buffer for encoding into, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param data  Pointer to the service data used for encoding values
+ * @param value_list  Pointer to the encoded listOfValues
+ * @param value_list_len  Number of bytes in the encoded listOfValues
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+int ucov_notify_values_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    BACNET_COV_DATA *data,
+    const uint8_t *value_list,
+    size_t value_list_len)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu && (apdu_size > 2)) {
+        apdu[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        apdu[1] = SERVICE_UNCONFIRMED_COV_NOTIFICATION;
+    }
+    len = 2;
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_service_request_values_encode(
+        apdu, apdu_size - apdu_len, data, value_list, value_list_len);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
+/*
+ConfirmedCOVNotificationMultiple-Request ::= SEQUENCE {
+    subscriber-process-identifier [0] Unsigned32,
+    initiating-device-identifier [1] BACnetObjectIdentifier,
+    time-remaining [2] Unsigned,
+    timestamp [3] BACnetDateTime OPTIONAL,
+    list-of-cov-notifications [4] SEQUENCE OF SEQUENCE {
+        monitored-object-identifier [0] BACnetObjectIdentifier,
+        list-of-values [1] SEQUENCE OF SEQUENCE {
+            property-identifier [0] BACnetPropertyIdentifier,
+            property-array-index [1] Unsigned OPTIONAL,
+            value [2] ABSTRACT-SYNTAX.&Type,
+            time-of-change [3] Time OPTIONAL
+        }
+    }
+}
+*/
+
+/**
+ * @brief Encode the APDU header and the values for each object of a
+ *  COVNotificationMultiple, up to the list-of-cov-notifications, which
+ *  is followed by the notification of each object encoded with
+ *  cov_notify_multiple_object_encode() and closed with
+ *  cov_notify_multiple_end_encode().
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param confirmed  true for the confirmed service
+ * @param invoke_id  ID to invoke for the confirmed service
+ * @param data  Pointer to the data to encode.  The monitored object
+ *  and the listOfValues of the data are not used.
+ * @return number of bytes encoded
+ */
+int cov_notify_multiple_header_encode(uint8_t *apdu,
+    bool confirmed,
+    uint8_t invoke_id,
+    const BACNET_COV_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    if (confirmed) {
+        if (apdu) {
+            apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+            apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+            apdu[2] = invoke_id;
+            apdu[3] = SERVICE_CONFIRMED_COV_NOTIFICATION_MULTIPLE;
+        }
+        len = 4;
+    } else {
+        if (apdu) {
+            apdu[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+            apdu[1] = SERVICE_UNCONFIRMED_COV_NOTIFICATION_MULTIPLE;
+        }
+        len = 2;
+    }
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 0 - subscriberProcessIdentifier */
+    len =
+        encode_context_unsigned(apdu, 0, data->subscriberProcessIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 1 - initiatingDeviceIdentifier */
+    len = encode_context_object_id(
+        apdu, 1, OBJECT_DEVICE, data->initiatingDeviceIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 2 - timeRemaining */
+    len = encode_context_unsigned(apdu, 2, data->timeRemaining);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 4 - listOfCOVNotifications */
+    len = encode_opening_tag(apdu, 4);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the notification of one object of a COVNotificationMultiple
+ *  using a listOfValues that was encoded by cov_notify_value_list_encode()
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param object_id  Pointer to the monitored object identifier
+ * @param value_list  Pointer to the encoded listOfValues
+ * @param value_list_len  Number of bytes in the encoded listOfValues
+ * @return number of bytes encoded, or zero if the listOfValues is invalid
+ */
+int cov_notify_multiple_object_encode(uint8_t *apdu,
+    const BACNET_OBJECT_ID *object_id,
+    const uint8_t *value_list,
+    size_t value_list_len)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+    int tag_len = 0;
+
+    /* the values between the tag 4 of the listOfValues */
+    if (!object_id || !value_list ||
+        !bacnet_is_opening_tag_number((uint8_t *)value_list,
+            (uint32_t)value_list_len, 4, &tag_len) ||
+        (value_list_len < (size_t)(2 * tag_len))) {
+        return 0;
+    }
+    value_list += tag_len;
+    value_list_len -= (size_t)(2 * tag_len);
+    /* tag 0 - monitoredObjectIdentifier */
+    len = encode_context_object_id(
+        apdu, 0, object_id->type, object_id->instance);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 1 - listOfValues */
+    len = encode_opening_tag(apdu, 1);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+        memcpy(apdu, value_list, value_list_len);
+        apdu += value_list_len;
+    }
+    apdu_len += (int)value_list_len;
+    len = encode_closing_tag(apdu, 1);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the end of the list-of-cov-notifications of a
+ *  COVNotificationMultiple
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @return number of bytes encoded
+ */
+int cov_notify_multiple_end_encode(uint8_t *apdu)
+{
+    return encode_closing_tag(apdu, 4);
+}
+
+/**
+ * @brief Decode the COVNotificationMultiple service request, with the
+ *  notification of each object decoded into one of the data, which
+ *  all get the subscriber, device and time remaining values.
+ * @note Confirmed and unconfirmed are the same.  The timestamp is skipped.
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size  Number of valid bytes in the buffer.
+ * @param data  Array of data to store the decoded values, each with
+ *  its listOfValues linked to the values to decode into.
+ * @param data_count  Number of data in the array
+ * @return number of object notifications decoded, or BACNET_STATUS_ERROR
+ *  on error, or when the notifications or values did not fit.
+ */
+int cov_notify_multiple_decode_service_request(uint8_t *apdu,
+    unsigned apdu_size,
+    BACNET_COV_DATA *data,
+    unsigned data_count)
+{
+    BACNET_DECODE_CURSOR cursor = { 0 };
+    BACNET_UNSIGNED_INTEGER process_identifier = 0;
+    BACNET_UNSIGNED_INTEGER time_remaining = 0;
+    BACNET_OBJECT_TYPE decoded_type = OBJECT_NONE;
+    uint32_t device_instance = 0;
+    BACNET_PROPERTY_VALUE *value = NULL;
+    uint8_t *values = NULL;
+    uint32_t values_len = 0;
+    uint32_t offset = 0;
+    unsigned count = 0;
+    int len = 0;
+
+    bacnet_cursor_init(&cursor, apdu, apdu_size);
+    /* subscriber-process-identifier [0] Unsigned32 */
+    bacnet_cursor_unsigned_context(&cursor, 0, &process_identifier);
+    /* initiating-device-identifier [1] BACnetObjectIdentifier */
+    bacnet_cursor_object_id_context(
+        &cursor, 1, &decoded_type, &device_instance);
+    if (decoded_type != OBJECT_DEVICE) {
+        bacnet_cursor_error_set(&cursor);
+    }
+    /* time-remaining [2] Unsigned */
+    bacnet_cursor_unsigned_context(&cursor, 2, &time_remaining);
+    /* timestamp [3] BACnetDateTime OPTIONAL */
+    if (bacnet_cursor_is_opening_tag(&cursor, 3)) {
+        bacnet_cursor_enclosed_data(&cursor, 3, NULL, NULL);
+    }
+    /* list-of-cov-notifications [4] */
+    bacnet_cursor_opening_tag(&cursor, 4);
+    while (!bacnet_cursor_error(&cursor) &&
+        !bacnet_is_closing_tag_number(bacnet_cursor_apdu(&cursor),
+            bacnet_cursor_remaining(&cursor), 4, NULL)) {
+        if (!data || (count >= data_count)) {
+            return BACNET_STATUS_ERROR;
+        }
+        /* monitored-object-identifier [0] BACnetObjectIdentifier */
+        bacnet_cursor_object_id_context(&cursor, 0, &decoded_type,
+            &data[count].monitoredObjectIdentifier.instance);
+        data[count].monitoredObjectIdentifier.type = decoded_type;
+        /* list-of-values [1] */
+        if (!bacnet_cursor_enclosed_data(&cursor, 1, &values, &values_len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        data[count].subscriberProcessIdentifier =
+            (uint32_t)process_identifier;
+        data[count].initiatingDeviceIdentifier = device_instance;
+        data[count].timeRemaining = (uint32_t)time_remaining;
+        /* the first value includes a pointer to the next value, etc */
+        value = data[count].listOfValues;
+        offset = 0;
+        while (offset < values_len) {
+            if (!value) {
+                /* out of room to store next value */
+                return BACNET_STATUS_ERROR;
+            }
+            len = bacapp_property_value_decode(
+                &values[offset], values_len - offset, value);
+            if (len <= 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            offset += (uint32_t)len;
+            if (offset >= values_len) {
+                value->next = NULL;
+            }
+            value = value->next;
+        }
+        count++;
+    }
+    bacnet_cursor_closing_tag(&cursor, 4);
+    if (bacnet_cursor_error(&cursor)) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return (int)count;
+}
+
 /**
  * @brief Decode the COV-service request only.
  *
@@ -200,71 +597,57 @@ int ucov_notify_encode_apdu(
  *
  * @return Bytes decoded or BACNET_STATUS_ERROR on error.
  */
-int cov_notify_decode_service_request(
-    uint8_t *apdu, unsigned apdu_size, BACNET_COV_DATA *data)
+static int cov_notify_decode(uint8_t *apdu,
+    unsigned apdu_size,
+    BACNET_COV_DATA *data,
+    ARENA_BUFFER *arena)
 {
     int len = 0; /* return value */
     int value_len = 0, tag_len = 0;
+    BACNET_DECODE_CURSOR cursor = { 0 };
+    BACNET_UNSIGNED_INTEGER process_identifier = 0;
     BACNET_UNSIGNED_INTEGER decoded_value = 0;
     BACNET_OBJECT_TYPE decoded_type = OBJECT_NONE;
+    uint32_t device_instance = 0;
     uint32_t decoded_instance = 0;
     BACNET_PROPERTY_ID property_identifier = PROP_ALL;
     BACNET_PROPERTY_VALUE *value = NULL;
 
+    bacnet_cursor_init(&cursor, apdu, apdu_size);
     /* subscriber-process-identifier [0] Unsigned32 */
-    value_len = bacnet_unsigned_context_decode(
-        &apdu[len], apdu_size - len, 0, &decoded_value);
-    if (value_len > 0) {
-        if (data) {
-            data->subscriberProcessIdentifier = decoded_value;
-        }
-        len += value_len;
-    } else {
-        return BACNET_STATUS_ERROR;
-    }
+    bacnet_cursor_unsigned_context(&cursor, 0, &process_identifier);
     /* initiating-device-identifier [1] BACnetObjectIdentifier */
-    value_len = bacnet_object_id_context_decode(
-        &apdu[len], apdu_size - len, 1, &decoded_type, &decoded_instance);
-    if (value_len > 0) {
-        if (decoded_type != OBJECT_DEVICE) {
-            return BACNET_STATUS_ERROR;
-        }
-        if (data) {
-            data->initiatingDeviceIdentifier = decoded_instance;
-        }
-        len += value_len;
-    } else {
-        return BACNET_STATUS_ERROR;
+    bacnet_cursor_object_id_context(
+        &cursor, 1, &decoded_type, &device_instance);
+    if (decoded_type != OBJECT_DEVICE) {
+        bacnet_cursor_error_set(&cursor);
     }
     /* monitored-object-identifier [2] BACnetObjectIdentifier */
-    value_len = bacnet_object_id_context_decode(
-        &apdu[len], apdu_size - len, 2, &decoded_type, &decoded_instance);
-    if (value_len > 0) {
-        if (data) {
-            data->monitoredObjectIdentifier.type = decoded_type;
-            data->monitoredObjectIdentifier.instance = decoded_instance;
-        }
-        len += value_len;
-    } else {
-        return BACNET_STATUS_ERROR;
-    }
+    bacnet_cursor_object_id_context(
+        &cursor, 2, &decoded_type, &decoded_instance);
     /* time-remaining [3] Unsigned */
-    value_len = bacnet_unsigned_context_decode(
-        &apdu[len], apdu_size - len, 3, &decoded_value);
-    if (value_len > 0) {
-        if (data) {
-            data->timeRemaining = decoded_value;
-        }
-        len += value_len;
-    } else {
+    bacnet_cursor_unsigned_context(&cursor, 3, &decoded_value);
+    if (bacnet_cursor_error(&cursor)) {
         return BACNET_STATUS_ERROR;
     }
+    if (data) {
+        data->subscriberProcessIdentifier = process_identifier;
+        data->initiatingDeviceIdentifier = device_instance;
+        data->monitoredObjectIdentifier.type = decoded_type;
+        data->monitoredObjectIdentifier.instance = decoded_instance;
+        data->timeRemaining = decoded_value;
+    }
+    len = bacnet_cursor_len(&cursor);
     /* list-of-values [4] SEQUENCE OF BACnetPropertyValue */
     if (bacnet_is_opening_tag_number(
             &apdu[len], apdu_size - len, 4, &tag_len)) {
         if (data) {
             len += tag_len;
             /* the first value includes a pointer to the next value, etc */
+            if (!data->listOfValues && arena) {
+                data->listOfValues =
+                    arena_alloc(arena, sizeof(BACNET_PROPERTY_VALUE));
+            }
             value = data->listOfValues;
             while (value != NULL) {
                 value_len = bacapp_property_value_decode(
@@ -282,6 +665,10 @@ int cov_notify_decode_service_request(
                     break;
                 }
                 /* is there another one to decode? */
+                if (!value->next && arena) {
+                    value->next =
+                        arena_alloc(arena, sizeof(BACNET_PROPERTY_VALUE));
+                }
                 value = value->next;
                 if (value == NULL) {
                     /* out of room to store next value */
@@ -303,6 +690,51 @@ int cov_notify_decode_service_request(
     return len;
 }
 
+/**
+ * @brief Decode the COV-service request only.
+ * @note: COV and Unconfirmed COV are the same.
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size  Number of valid bytes in the buffer.
+ * @param data  Pointer to the data to store the decoded values, or NULL
+ *
+ * @return Bytes decoded or BACNET_STATUS_ERROR on error.
+ */
+int cov_notify_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_COV_DATA *data)
+{
+    return cov_notify_decode(apdu, apdu_size, data, NULL);
+}
+
+/**
+ * @brief Decode the COV-service request only, with the list-of-values
+ *  extended from an arena when it runs out of caller provided values.
+ *  The values taken from the arena are released with arena_reset().
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size  Number of valid bytes in the buffer.
+ * @param data  Pointer to the data to store the decoded values
+ * @param arena  arena for the values beyond those linked in the data
+ *
+ * @return Bytes decoded or BACNET_STATUS_ERROR on error, or when the
+ *  values did not fit in the arena since it was last reset.
+ */
+int cov_notify_decode_service_request_arena(uint8_t *apdu,
+    unsigned apdu_size,
+    BACNET_COV_DATA *data,
+    ARENA_BUFFER *arena)
+{
+    int len;
+
+    if (!data || !arena) {
+        return BACNET_STATUS_ERROR;
+    }
+    len = cov_notify_decode(apdu, apdu_size, data, arena);
+    if (arena_overflow(arena)) {
+        return BACNET_STATUS_ERROR;
+    }
+
+    return len;
+}
+
 /*
 12.11.38Active_COV_Subscriptions
 The Active_COV_Subscriptions property is a List of BACnetCOVSubscription,
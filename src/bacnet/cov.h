@@ -14,6 +14,7 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bacapp.h"
+#include "bacnet/basic/sys/arena.h"
 
 typedef struct BACnet_COV_Data {
     uint32_t subscriberProcessIdentifier;
@@ -59,6 +60,24 @@ size_t cov_notify_service_request_encode(
 BACNET_STACK_EXPORT
 int cov_notify_encode_apdu(uint8_t *apdu, BACNET_COV_DATA *data);
 
+BACNET_STACK_EXPORT
+int cov_notify_value_list_encode(
+    uint8_t *apdu, BACNET_PROPERTY_VALUE *value_list);
+
+BACNET_STACK_EXPORT
+size_t cov_notify_service_request_values_encode(uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_COV_DATA *data,
+    const uint8_t *value_list,
+    size_t value_list_len);
+
+BACNET_STACK_EXPORT
+int ucov_notify_values_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    BACNET_COV_DATA *data,
+    const uint8_t *value_list,
+    size_t value_list_len);
+
 BACNET_STACK_EXPORT
 int ucov_notify_encode_apdu(
     uint8_t *apdu, unsigned max_apdu_len, BACNET_COV_DATA *data);
@@ -77,16 +96,47 @@ int ccov_notify_encode_apdu(uint8_t *apdu,
     uint8_t invoke_id,
     BACNET_COV_DATA *data);
 
+BACNET_STACK_EXPORT
+int ccov_notify_values_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    BACNET_COV_DATA *data,
+    const uint8_t *value_list,
+    size_t value_list_len);
+
 BACNET_STACK_EXPORT
 int ccov_notify_decode_apdu(uint8_t *apdu,
     unsigned apdu_len,
     uint8_t *invoke_id,
     BACNET_COV_DATA *data);
 
+BACNET_STACK_EXPORT
+int cov_notify_multiple_header_encode(uint8_t *apdu,
+    bool confirmed,
+    uint8_t invoke_id,
+    const BACNET_COV_DATA *data);
+BACNET_STACK_EXPORT
+int cov_notify_multiple_object_encode(uint8_t *apdu,
+    const BACNET_OBJECT_ID *object_id,
+    const uint8_t *value_list,
+    size_t value_list_len);
+BACNET_STACK_EXPORT
+int cov_notify_multiple_end_encode(uint8_t *apdu);
+BACNET_STACK_EXPORT
+int cov_notify_multiple_decode_service_request(uint8_t *apdu,
+    unsigned apdu_len,
+    BACNET_COV_DATA *data,
+    unsigned data_count);
+
 /* common for both confirmed and unconfirmed */
 BACNET_STACK_EXPORT
 int cov_notify_decode_service_request(
     uint8_t *apdu, unsigned apdu_len, BACNET_COV_DATA *data);
+BACNET_STACK_EXPORT
+int cov_notify_decode_service_request_arena(uint8_t *apdu,
+    unsigned apdu_len,
+    BACNET_COV_DATA *data,
+    ARENA_BUFFER *arena);
 
 BACNET_STACK_EXPORT
 int cov_subscribe_property_decode_service_request(
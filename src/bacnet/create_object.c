@@ -7,6 +7,7 @@
  */
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -141,7 +142,9 @@ int create_object_decode_service_request(
     BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
     uint32_t object_instance = 0;
     uint32_t enumerated_value = 0;
-    BACNET_PROPERTY_VALUE *list_of_initial_values = NULL;
+    BACNET_PROPERTY_VALUE *value = NULL;
+    uint8_t *application_data = NULL;
+    int application_data_len = 0;
 
     /* object-specifier [0] CHOICE */
     if (!bacnet_is_opening_tag_number(
@@ -202,27 +205,127 @@ int create_object_decode_service_request(
     apdu_len += len;
     /* list-of-initial-values [1] SEQUENCE OF BACnetPropertyValue OPTIONAL */
     if (bacnet_is_opening_tag_number(
-            &apdu[apdu_len], apdu_size - apdu_len, 0, &len)) {
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len)) {
         apdu_len += len;
+        application_data = &apdu[apdu_len];
         if (data) {
-            list_of_initial_values = data->list_of_initial_values;
+            value = data->list_of_initial_values;
         }
-        len = bacapp_property_value_decode(
-            &apdu[apdu_len], apdu_size - apdu_len, list_of_initial_values);
-        if (len <= 0) {
-            if (data) {
-                data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+        /* the values are decoded into the list while it has room,
+           and are kept encoded for create_object_initial_value_decode() */
+        while (!bacnet_is_closing_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len)) {
+            len = bacapp_property_value_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, value);
+            if (len <= 0) {
+                if (data) {
+                    data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+                }
+                return BACNET_STATUS_REJECT;
+            }
+            apdu_len += len;
+            application_data_len += len;
+            if (value) {
+                value = value->next;
             }
-            return BACNET_STATUS_REJECT;
         }
         apdu_len += len;
-        if (!bacnet_is_closing_tag_number(
-                &apdu[apdu_len], apdu_size - apdu_len, 0, &len)) {
-            if (data) {
-                data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
-            }
-            return BACNET_STATUS_REJECT;
+    }
+    if (data) {
+        data->application_data = application_data;
+        data->application_data_len = application_data_len;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode one of the encoded list-of-initial-values of a decoded
+ *  CreateObject request into the data of a WriteProperty, so that the
+ *  value is written as it was encoded in the request
+ *
+ *  BACnetPropertyValue ::= SEQUENCE {
+ *      property-identifier [0] BACnetPropertyIdentifier,
+ *      property-array-index [1] Unsigned OPTIONAL,
+ *      property-value [2] ABSTRACT-SYNTAX.&Type,
+ *      priority [3] Unsigned (1..16) OPTIONAL
+ *  }
+ *
+ * @param apdu  Pointer to the encoded values, from application_data
+ * @param apdu_size  Count of the encoded octets that remain
+ * @param wp_data  The property, array index, value, and priority are
+ *  stored here, and the object is left unchanged
+ * @return Bytes decoded, or BACNET_STATUS_ERROR if the value is invalid
+ *  or too long for a WriteProperty
+ */
+int create_object_initial_value_decode(
+    uint8_t *apdu, uint32_t apdu_size, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    int len = 0;
+    int apdu_len = 0;
+    int value_len = 0;
+    uint32_t enumerated_value = 0;
+    uint32_t len_value_type = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+
+    if (!apdu || !wp_data) {
+        return BACNET_STATUS_ERROR;
+    }
+    /* property-identifier [0] BACnetPropertyIdentifier */
+    len = bacnet_enumerated_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 0, &enumerated_value);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    wp_data->object_property = (BACNET_PROPERTY_ID)enumerated_value;
+    apdu_len += len;
+    /* property-array-index [1] Unsigned OPTIONAL */
+    wp_data->array_index = BACNET_ARRAY_ALL;
+    if (bacnet_is_context_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &len, &len_value_type)) {
+        apdu_len += len;
+        len = bacnet_unsigned_decode(&apdu[apdu_len], apdu_size - apdu_len,
+            len_value_type, &unsigned_value);
+        if ((len <= 0) || (unsigned_value > UINT32_MAX)) {
+            return BACNET_STATUS_ERROR;
+        }
+        wp_data->array_index = (BACNET_ARRAY_INDEX)unsigned_value;
+        apdu_len += len;
+    }
+    /* property-value [2] ABSTRACT-SYNTAX.&Type */
+    if (!bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 2, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    value_len = bacapp_data_len(&apdu[apdu_len], apdu_size - apdu_len,
+        wp_data->object_property);
+    apdu_len += len;
+    if ((value_len < 0) ||
+        ((size_t)value_len > sizeof(wp_data->application_data)) ||
+        ((uint32_t)value_len > (apdu_size - apdu_len))) {
+        return BACNET_STATUS_ERROR;
+    }
+    memcpy(wp_data->application_data, &apdu[apdu_len], value_len);
+    wp_data->application_data_len = value_len;
+    apdu_len += value_len;
+    if (!bacnet_is_closing_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 2, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    /* priority [3] Unsigned (1..16) OPTIONAL */
+    /* assumed MAX priority if not explicitly set, as for WriteProperty */
+    wp_data->priority = BACNET_MAX_PRIORITY;
+    if (bacnet_is_context_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 3, &len, &len_value_type)) {
+        apdu_len += len;
+        len = bacnet_unsigned_decode(&apdu[apdu_len], apdu_size - apdu_len,
+            len_value_type, &unsigned_value);
+        if ((len <= 0) || (unsigned_value < BACNET_MIN_PRIORITY) ||
+            (unsigned_value > BACNET_MAX_PRIORITY)) {
+            return BACNET_STATUS_ERROR;
         }
+        wp_data->priority = (uint8_t)unsigned_value;
         apdu_len += len;
     }
 
@@ -15,6 +15,7 @@
 /* BACnet Stack API */
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/wp.h"
 
 /**
  *  CreateObject-Request ::= SEQUENCE {
@@ -31,6 +32,9 @@ typedef struct BACnet_Create_Object_Data {
     BACNET_OBJECT_TYPE object_type;
     /* simple linked list of values */
     BACNET_PROPERTY_VALUE *list_of_initial_values;
+    /* the list-of-initial-values of a decoded request, still encoded */
+    uint8_t *application_data;
+    int application_data_len;
     BACNET_ERROR_CLASS error_class;
     BACNET_ERROR_CODE error_code;
     BACNET_UNSIGNED_INTEGER first_failed_element_number;
@@ -61,6 +65,9 @@ int create_object_encode_service_ack_encode(
 BACNET_STACK_EXPORT
 int create_object_decode_service_request(
     uint8_t *apdu, uint32_t apdu_size, BACNET_CREATE_OBJECT_DATA *data);
+BACNET_STACK_EXPORT
+int create_object_initial_value_decode(
+    uint8_t *apdu, uint32_t apdu_size, BACNET_WRITE_PROPERTY_DATA *wp_data);
 
 BACNET_STACK_EXPORT
 int create_object_ack_service_encode(
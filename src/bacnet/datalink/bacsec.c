@@ -11,6 +11,10 @@
 #include "bacnet/bacdcode.h"
 #include "bacnet/datalink/bacsec.h"
 
+/* the peers whose signature keys are prepared, replaced in turn */
+static BACNET_SECURITY_SESSION Security_Sessions[BACNET_SECURITY_SESSIONS];
+static unsigned Security_Session_Next;
+
 BACNET_KEY_IDENTIFIER_ALGORITHM key_algorithm(uint16_t id)
 {
     return (BACNET_KEY_IDENTIFIER_ALGORITHM)((id >> 8) & 0xFF);
@@ -21,6 +25,124 @@ BACNET_KEY_IDENTIFIER_KEY_NUMBER key_number(uint16_t id)
     return (BACNET_KEY_IDENTIFIER_KEY_NUMBER)(id & 0xFF);
 }
 
+/**
+ * @brief Find the prepared signature key of a peer, or prepare it.
+ *  An AES and SHA-256 key is the 16 octets of the AES key followed by
+ *  the 32 octets of the HMAC-SHA256 key.  A key that was updated with
+ *  the same identifier is found by comparing its octets.
+ * @param device_instance - the device instance of the peer
+ * @param key - the key of the message
+ * @return the session, or NULL if the key is not an AES and SHA-256 key
+ */
+static BACNET_SECURITY_SESSION *bacnet_security_session(
+    uint32_t device_instance, BACNET_KEY_ENTRY *key)
+{
+    BACNET_SECURITY_SESSION *session = NULL;
+    uint8_t *sign_key = NULL;
+    unsigned i = 0;
+
+    if (!key || (key_algorithm(key->key_identifier) != KIA_AES_SHA256) ||
+        (key->key_len < (AES_KEY_SIZE + SHA256_KEY_SIZE))) {
+        return NULL;
+    }
+    sign_key = &key->key[AES_KEY_SIZE];
+    for (i = 0; i < BACNET_SECURITY_SESSIONS; i++) {
+        session = &Security_Sessions[i];
+        if (session->valid && (session->device_instance == device_instance) &&
+            (session->key_identifier == key->key_identifier) &&
+            (memcmp(session->key, sign_key, SHA256_KEY_SIZE) == 0)) {
+            return session;
+        }
+    }
+    session = &Security_Sessions[Security_Session_Next];
+    Security_Session_Next =
+        (Security_Session_Next + 1) % BACNET_SECURITY_SESSIONS;
+    session->device_instance = device_instance;
+    session->key_identifier = key->key_identifier;
+    memcpy(session->key, sign_key, SHA256_KEY_SIZE);
+    bacnet_hmac_sha256_init(&session->hmac, sign_key, SHA256_KEY_SIZE);
+    session->valid = true;
+
+    return session;
+}
+
+/**
+ * @brief Sign a secured message in place: the signature, the first
+ *  16 octets of its HMAC-SHA256, is added after the message.
+ * @param device_instance - the device instance of the peer
+ * @param key - the key of the message
+ * @param pdu - the message, from the control octet to the padding
+ * @param pdu_len - number of octets of the message
+ * @param pdu_size - size of the message buffer
+ * @return number of octets of the signed message, or 0 if the key is not
+ *  supported or the signature does not fit
+ */
+int bacnet_security_sign(uint32_t device_instance,
+    BACNET_KEY_ENTRY *key,
+    uint8_t *pdu,
+    uint16_t pdu_len,
+    uint16_t pdu_size)
+{
+    BACNET_SECURITY_SESSION *session = NULL;
+    uint8_t digest[BACNET_SHA256_DIGEST_SIZE];
+
+    if (!pdu || ((uint32_t)pdu_len + SIGNATURE_LEN > pdu_size)) {
+        return 0;
+    }
+    session = bacnet_security_session(device_instance, key);
+    if (!session) {
+        return 0;
+    }
+    bacnet_hmac_sha256(&session->hmac, pdu, pdu_len, digest);
+    memcpy(&pdu[pdu_len], digest, SIGNATURE_LEN);
+
+    return pdu_len + SIGNATURE_LEN;
+}
+
+/**
+ * @brief Verify the signature of a secured message in place
+ * @param device_instance - the device instance of the peer
+ * @param key - the key of the message
+ * @param pdu - the message, followed by its signature
+ * @param pdu_len - number of octets of the message and signature
+ * @return true if the signature is the one of the message
+ */
+bool bacnet_security_verify(uint32_t device_instance,
+    BACNET_KEY_ENTRY *key,
+    uint8_t *pdu,
+    uint16_t pdu_len)
+{
+    BACNET_SECURITY_SESSION *session = NULL;
+    uint8_t digest[BACNET_SHA256_DIGEST_SIZE];
+    uint8_t difference = 0;
+    unsigned i = 0;
+
+    if (!pdu || (pdu_len < SIGNATURE_LEN)) {
+        return false;
+    }
+    session = bacnet_security_session(device_instance, key);
+    if (!session) {
+        return false;
+    }
+    pdu_len -= SIGNATURE_LEN;
+    bacnet_hmac_sha256(&session->hmac, pdu, pdu_len, digest);
+    /* every octet is compared, whichever differs */
+    for (i = 0; i < SIGNATURE_LEN; i++) {
+        difference |= (uint8_t)(digest[i] ^ pdu[pdu_len + i]);
+    }
+
+    return (difference == 0);
+}
+
+/**
+ * @brief Forget the prepared keys, such as when the keys are updated
+ */
+void bacnet_security_sessions_clear(void)
+{
+    memset(Security_Sessions, 0, sizeof(Security_Sessions));
+    Security_Session_Next = 0;
+}
+
 #if 0
 /* FIXME: please fix? */
 int encode_security_wrapper(
@@ -18,11 +18,16 @@
 #define MAX_SUPPORTED_ALGORITHMS 255
 #define MAX_PAD_LEN 16
 #define SIGNATURE_LEN 16
+/* number of peers whose signature keys are kept prepared */
+#ifndef BACNET_SECURITY_SESSIONS
+#define BACNET_SECURITY_SESSIONS 8
+#endif
 
 #include <stdbool.h>
 #include <stdint.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
+#include "bacnet/basic/sys/sha256.h"
 
 typedef struct BACnet_Security_Wrapper {
     bool payload_net_or_bvll_flag;      /* true if NPDU or BVLL */
@@ -170,6 +175,15 @@ typedef struct Set_Master_Key {
     BACNET_KEY_ENTRY key;
 } BACNET_SET_MASTER_KEY;
 
+/* the signature key of a peer, prepared for the HMAC of each message */
+typedef struct Security_Session {
+    bool valid;
+    uint32_t device_instance;
+    uint16_t key_identifier;
+    uint8_t key[SHA256_KEY_SIZE];
+    BACNET_HMAC_SHA256 hmac;
+} BACNET_SECURITY_SESSION;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -221,6 +235,21 @@ extern "C" {
         uint16_t * padding_len,
         uint8_t * padding);
 
+/* signature of a message in place, with the prepared key of each peer */
+    BACNET_STACK_EXPORT
+    int bacnet_security_sign(uint32_t device_instance,
+        BACNET_KEY_ENTRY * key,
+        uint8_t * pdu,
+        uint16_t pdu_len,
+        uint16_t pdu_size);
+    BACNET_STACK_EXPORT
+    bool bacnet_security_verify(uint32_t device_instance,
+        BACNET_KEY_ENTRY * key,
+        uint8_t * pdu,
+        uint16_t pdu_len);
+    BACNET_STACK_EXPORT
+    void bacnet_security_sessions_clear(void);
+
 /* encoders */
     /* BACNET_STACK_EXPORT */
     /* int encode_security_wrapper(int bytes_before, */
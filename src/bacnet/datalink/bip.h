@@ -21,6 +21,16 @@
 /* specific defines for BACnet/IP over Ethernet */
 #define BIP_HEADER_MAX (1 + 1 + 2)
 #define BIP_MPDU_MAX (BIP_HEADER_MAX + MAX_PDU)
+/* the ports module implements bip_send_mpdu_list() to send
+   the same MPDU to many destinations with fewer system calls */
+#ifndef BACNET_IP_SEND_MPDU_LIST
+#define BACNET_IP_SEND_MPDU_LIST 0
+#endif
+/* the ports module implements bip_receive_buffer() to return the NPDU
+   in place in its own receive buffer, without copying it */
+#ifndef BACNET_IP_RECEIVE_BUFFER
+#define BACNET_IP_RECEIVE_BUFFER 0
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -58,12 +68,25 @@ extern "C" {
     BACNET_STACK_EXPORT
     int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len);
 
+    /* implement in ports module when BACNET_IP_SEND_MPDU_LIST is set */
+    BACNET_STACK_EXPORT
+    int bip_send_mpdu_list(BACNET_IP_ADDRESS *dest,
+        unsigned dest_count,
+        uint8_t *mtu,
+        uint16_t mtu_len);
+
     BACNET_STACK_EXPORT
     uint16_t bip_receive(BACNET_ADDRESS *src,
         uint8_t *pdu,
         uint16_t max_pdu,
         unsigned timeout);
 
+    /* implement in ports module when BACNET_IP_RECEIVE_BUFFER is set */
+    BACNET_STACK_EXPORT
+    uint16_t bip_receive_buffer(BACNET_ADDRESS *src,
+        uint8_t **pdu,
+        unsigned timeout);
+
     /* use host byte order for setting UDP port */
     BACNET_STACK_EXPORT
     void bip_set_port(uint16_t port);
@@ -112,6 +135,37 @@ extern "C" {
     int bip_set_broadcast_binding(
         const char *ip4_broadcast);
 
+#if defined(__linux__)
+    /* unicast sockets that share the port with SO_REUSEPORT */
+    BACNET_STACK_EXPORT
+    bool bip_set_socket_shards(unsigned count);
+
+    BACNET_STACK_EXPORT
+    unsigned bip_socket_shards(void);
+
+    BACNET_STACK_EXPORT
+    uint16_t bip_receive_shard(unsigned shard,
+        BACNET_ADDRESS *src,
+        uint8_t *pdu,
+        uint16_t max_pdu,
+        unsigned timeout);
+#endif
+
+#if defined(_WIN32)
+    /* handles a completion of an application handle on the I/O
+       completion port of bip_receive() */
+    typedef void (*bip_completion_handler_t)(uintptr_t key,
+        uint32_t bytes,
+        void *overlapped,
+        bool success);
+
+    BACNET_STACK_EXPORT
+    void *bip_get_completion_port(void);
+
+    BACNET_STACK_EXPORT
+    void bip_set_completion_handler(bip_completion_handler_t handler);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -26,6 +26,16 @@
 /* specific defines for BACnet/IP over Ethernet */
 #define BIP6_HEADER_MAX (1 + 1 + 2)
 #define BIP6_MPDU_MAX (BIP6_HEADER_MAX+MAX_PDU)
+/* the ports module implements bip6_send_mpdu_list() to send
+   the same MPDU to many destinations with fewer system calls */
+#ifndef BACNET_IP6_SEND_MPDU_LIST
+#define BACNET_IP6_SEND_MPDU_LIST 0
+#endif
+/* the ports module implements bip6_receive_buffer() to return the NPDU
+   in place in its own receive buffer, without copying it */
+#ifndef BACNET_IP6_RECEIVE_BUFFER
+#define BACNET_IP6_RECEIVE_BUFFER 0
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -59,6 +69,13 @@ extern "C" {
         uint16_t max_pdu,
         unsigned timeout);
 
+    /* implement in ports module when BACNET_IP6_RECEIVE_BUFFER is set */
+    BACNET_STACK_EXPORT
+    uint16_t bip6_receive_buffer(
+        BACNET_ADDRESS * src,
+        uint8_t ** pdu,
+        unsigned timeout);
+
     /* functions that are custom per port */
     BACNET_STACK_EXPORT
     void bip6_set_interface(
@@ -81,6 +98,9 @@ extern "C" {
     BACNET_STACK_EXPORT
     uint16_t bip6_get_port(
         void);
+    BACNET_STACK_EXPORT
+    int bip6_get_socket(
+        void);
 
     BACNET_STACK_EXPORT
     bool bip6_set_broadcast_addr(
@@ -95,6 +115,13 @@ extern "C" {
         BACNET_IP6_ADDRESS *addr,
         uint8_t * mtu,
         uint16_t mtu_len);
+    /* implement in ports module when BACNET_IP6_SEND_MPDU_LIST is set */
+    BACNET_STACK_EXPORT
+    int bip6_send_mpdu_list(
+        BACNET_IP6_ADDRESS *dest,
+        unsigned dest_count,
+        uint8_t * mtu,
+        uint16_t mtu_len);
     BACNET_STACK_EXPORT
     bool bip6_send_pdu_queue_empty(
         void);
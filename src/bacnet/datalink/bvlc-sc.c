@@ -0,0 +1,484 @@
+/**
+ * @file
+ * @brief BACnet/SC virtual link control (BVLC-SC) encode and decode of
+ *  Annex AB, and the batching of the messages as WebSocket binary frames.
+ *  Each BVLC-SC message is one WebSocket binary frame (AB.7.5), and the
+ *  frames of a batch are written to the WebSocket connection of the hub
+ *  at once, such as one TLS record, instead of one record per message.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DLBSC
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bacnet/bacint.h"
+#include "bacnet/datalink/bvlc-sc.h"
+
+/* WebSocket FIN and binary frame opcode, and the masked payload bit */
+#define BVLC_SC_WEBSOCKET_BINARY 0x82
+#define BVLC_SC_WEBSOCKET_MASKED 0x80
+
+/**
+ * @brief Encode the BVLC-SC header, without header options
+ *
+ * @param pdu - buffer to store the encoding
+ * @param pdu_size - size of the buffer to store encoding
+ * @param function - BVLC-SC message
+ * @param message_id - the message identifier
+ * @param originating_vmac - the 6-octet originating VMAC, or NULL
+ * @param destination_vmac - the 6-octet destination VMAC, or NULL
+ *
+ * @return number of bytes encoded, or 0 if it does not fit
+ */
+int bvlc_sc_encode_header(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t function,
+    uint16_t message_id,
+    const uint8_t *originating_vmac,
+    const uint8_t *destination_vmac)
+{
+    uint16_t len = BVLC_SC_HEADER_MIN;
+
+    if (originating_vmac) {
+        len += BVLC_SC_VMAC_SIZE;
+    }
+    if (destination_vmac) {
+        len += BVLC_SC_VMAC_SIZE;
+    }
+    if (!pdu || (pdu_size < len)) {
+        return 0;
+    }
+    pdu[0] = function;
+    pdu[1] = 0;
+    encode_unsigned16(&pdu[2], message_id);
+    len = BVLC_SC_HEADER_MIN;
+    if (originating_vmac) {
+        pdu[1] |= BVLC_SC_CONTROL_ORIGINATING_VMAC;
+        memcpy(&pdu[len], originating_vmac, BVLC_SC_VMAC_SIZE);
+        len += BVLC_SC_VMAC_SIZE;
+    }
+    if (destination_vmac) {
+        pdu[1] |= BVLC_SC_CONTROL_DESTINATION_VMAC;
+        memcpy(&pdu[len], destination_vmac, BVLC_SC_VMAC_SIZE);
+        len += BVLC_SC_VMAC_SIZE;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Encode an Encapsulated-NPDU message
+ *
+ * @param pdu - buffer to store the encoding
+ * @param pdu_size - size of the buffer to store encoding
+ * @param message_id - the message identifier
+ * @param originating_vmac - the originating VMAC, or NULL from a node
+ * @param destination_vmac - the destination VMAC, or NULL to the hub
+ * @param npdu - the NPDU
+ * @param npdu_len - number of bytes of the NPDU
+ *
+ * @return number of bytes encoded, or 0 if it does not fit
+ */
+int bvlc_sc_encode_encapsulated_npdu(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint16_t message_id,
+    const uint8_t *originating_vmac,
+    const uint8_t *destination_vmac,
+    const uint8_t *npdu,
+    uint16_t npdu_len)
+{
+    int len = 0;
+
+    len = bvlc_sc_encode_header(pdu, pdu_size, BVLC_SC_ENCAPSULATED_NPDU,
+        message_id, originating_vmac, destination_vmac);
+    if ((len == 0) || !npdu || ((uint32_t)len + npdu_len > pdu_size)) {
+        return 0;
+    }
+    memmove(&pdu[len], npdu, npdu_len);
+
+    return len + npdu_len;
+}
+
+/**
+ * @brief Encode a Connect-Request or Connect-Accept message
+ *
+ * @param pdu - buffer to store the encoding
+ * @param pdu_size - size of the buffer to store encoding
+ * @param function - BVLC_SC_CONNECT_REQUEST or BVLC_SC_CONNECT_ACCEPT
+ * @param message_id - the message identifier
+ * @param vmac - the 6-octet VMAC of the sender
+ * @param uuid - the 16-octet device UUID of the sender
+ * @param max_bvlc_len - the largest BVLC-SC message that is received
+ * @param max_npdu_len - the largest NPDU that is received
+ *
+ * @return number of bytes encoded, or 0 if it does not fit
+ */
+int bvlc_sc_encode_connect(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t function,
+    uint16_t message_id,
+    const uint8_t *vmac,
+    const uint8_t *uuid,
+    uint16_t max_bvlc_len,
+    uint16_t max_npdu_len)
+{
+    int len = 0;
+
+    if (!vmac || !uuid) {
+        return 0;
+    }
+    len = bvlc_sc_encode_header(pdu, pdu_size, function, message_id, NULL,
+        NULL);
+    if ((len == 0) ||
+        ((len + BVLC_SC_VMAC_SIZE + BVLC_SC_UUID_SIZE + 4) > pdu_size)) {
+        return 0;
+    }
+    memcpy(&pdu[len], vmac, BVLC_SC_VMAC_SIZE);
+    len += BVLC_SC_VMAC_SIZE;
+    memcpy(&pdu[len], uuid, BVLC_SC_UUID_SIZE);
+    len += BVLC_SC_UUID_SIZE;
+    len += encode_unsigned16(&pdu[len], max_bvlc_len);
+    len += encode_unsigned16(&pdu[len], max_npdu_len);
+
+    return len;
+}
+
+/**
+ * @brief Encode a message without a payload or addresses, such as
+ *  Disconnect-Request, Disconnect-ACK, Heartbeat-Request, Heartbeat-ACK
+ *  or Advertisement-Solicitation
+ *
+ * @param pdu - buffer to store the encoding
+ * @param pdu_size - size of the buffer to store encoding
+ * @param function - BVLC-SC message
+ * @param message_id - the message identifier
+ *
+ * @return number of bytes encoded, or 0 if it does not fit
+ */
+int bvlc_sc_encode_control(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t function,
+    uint16_t message_id)
+{
+    return bvlc_sc_encode_header(pdu, pdu_size, function, message_id, NULL,
+        NULL);
+}
+
+/**
+ * @brief Encode a BVLC-Result message, an ACK, or a NAK without
+ *  error details
+ *
+ * @param pdu - buffer to store the encoding
+ * @param pdu_size - size of the buffer to store encoding
+ * @param message_id - the message identifier of the request
+ * @param destination_vmac - the VMAC of the requester, or NULL
+ * @param result_function - the BVLC-SC message of the request
+ * @param nak - true for a NAK
+ * @param error_class - the error class of a NAK
+ * @param error_code - the error code of a NAK
+ *
+ * @return number of bytes encoded, or 0 if it does not fit
+ */
+int bvlc_sc_encode_result(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint16_t message_id,
+    const uint8_t *destination_vmac,
+    uint8_t result_function,
+    bool nak,
+    uint16_t error_class,
+    uint16_t error_code)
+{
+    int len = 0;
+
+    len = bvlc_sc_encode_header(pdu, pdu_size, BVLC_SC_RESULT, message_id,
+        NULL, destination_vmac);
+    if ((len == 0) || ((len + (nak ? 7 : 2)) > pdu_size)) {
+        return 0;
+    }
+    pdu[len++] = result_function;
+    pdu[len++] = nak ? 1 : 0;
+    if (nak) {
+        /* the error is not about a header option */
+        pdu[len++] = 0;
+        len += encode_unsigned16(&pdu[len], error_class);
+        len += encode_unsigned16(&pdu[len], error_code);
+    }
+
+    return len;
+}
+
+/**
+ * @brief Find the end of a list of header options
+ * @param pdu - the options
+ * @param pdu_len - number of bytes after the start of the options
+ * @return number of bytes of the options, or 0 if malformed
+ */
+static uint16_t bvlc_sc_options_length(uint8_t *pdu, uint16_t pdu_len)
+{
+    uint16_t offset = 0;
+    uint16_t data_len = 0;
+    uint8_t marker = 0;
+
+    do {
+        if (offset >= pdu_len) {
+            return 0;
+        }
+        marker = pdu[offset++];
+        if (marker & BVLC_SC_OPTION_HEADER_DATA) {
+            if ((offset + 2) > pdu_len) {
+                return 0;
+            }
+            decode_unsigned16(&pdu[offset], &data_len);
+            offset += 2;
+            if ((uint32_t)offset + data_len > pdu_len) {
+                return 0;
+            }
+            offset += data_len;
+        }
+    } while (marker & BVLC_SC_OPTION_MORE);
+
+    return offset;
+}
+
+/**
+ * @brief Decode a BVLC-SC message in place: the options and payload
+ *  point into the received buffer
+ *
+ * @param pdu - the received message
+ * @param pdu_len - number of bytes of the message
+ * @param message - returns the decoded message
+ *
+ * @return number of bytes before the payload, or 0 if malformed
+ */
+int bvlc_sc_decode_message(
+    uint8_t *pdu, uint16_t pdu_len, BVLC_SC_MESSAGE *message)
+{
+    uint16_t offset = BVLC_SC_HEADER_MIN;
+    uint16_t len = 0;
+    uint8_t control = 0;
+
+    if (!pdu || !message || (pdu_len < BVLC_SC_HEADER_MIN)) {
+        return 0;
+    }
+    memset(message, 0, sizeof(*message));
+    message->function = pdu[0];
+    control = pdu[1];
+    decode_unsigned16(&pdu[2], &message->message_id);
+    if (control & BVLC_SC_CONTROL_ORIGINATING_VMAC) {
+        if ((offset + BVLC_SC_VMAC_SIZE) > pdu_len) {
+            return 0;
+        }
+        message->originating_present = true;
+        memcpy(message->originating_vmac, &pdu[offset], BVLC_SC_VMAC_SIZE);
+        offset += BVLC_SC_VMAC_SIZE;
+    }
+    if (control & BVLC_SC_CONTROL_DESTINATION_VMAC) {
+        if ((offset + BVLC_SC_VMAC_SIZE) > pdu_len) {
+            return 0;
+        }
+        message->destination_present = true;
+        memcpy(message->destination_vmac, &pdu[offset], BVLC_SC_VMAC_SIZE);
+        offset += BVLC_SC_VMAC_SIZE;
+    }
+    if (control & BVLC_SC_CONTROL_DESTINATION_OPTIONS) {
+        len = bvlc_sc_options_length(&pdu[offset], pdu_len - offset);
+        if (len == 0) {
+            return 0;
+        }
+        message->destination_options = &pdu[offset];
+        message->destination_options_len = len;
+        offset += len;
+    }
+    if (control & BVLC_SC_CONTROL_DATA_OPTIONS) {
+        len = bvlc_sc_options_length(&pdu[offset], pdu_len - offset);
+        if (len == 0) {
+            return 0;
+        }
+        message->data_options = &pdu[offset];
+        message->data_options_len = len;
+        offset += len;
+    }
+    message->payload = &pdu[offset];
+    message->payload_len = pdu_len - offset;
+
+    return offset;
+}
+
+/**
+ * @brief Decode the payload of a Connect-Request or Connect-Accept
+ *
+ * @param payload - the payload of the message
+ * @param payload_len - number of bytes of the payload
+ * @param vmac - returns the 6-octet VMAC of the sender, or NULL
+ * @param uuid - returns the 16-octet device UUID of the sender, or NULL
+ * @param max_bvlc_len - returns the largest BVLC-SC message, or NULL
+ * @param max_npdu_len - returns the largest NPDU, or NULL
+ *
+ * @return number of bytes decoded, or 0 if malformed
+ */
+int bvlc_sc_decode_connect(uint8_t *payload,
+    uint16_t payload_len,
+    uint8_t *vmac,
+    uint8_t *uuid,
+    uint16_t *max_bvlc_len,
+    uint16_t *max_npdu_len)
+{
+    int len = 0;
+
+    if (!payload ||
+        (payload_len < (BVLC_SC_VMAC_SIZE + BVLC_SC_UUID_SIZE + 4))) {
+        return 0;
+    }
+    if (vmac) {
+        memcpy(vmac, &payload[len], BVLC_SC_VMAC_SIZE);
+    }
+    len += BVLC_SC_VMAC_SIZE;
+    if (uuid) {
+        memcpy(uuid, &payload[len], BVLC_SC_UUID_SIZE);
+    }
+    len += BVLC_SC_UUID_SIZE;
+    if (max_bvlc_len) {
+        decode_unsigned16(&payload[len], max_bvlc_len);
+    }
+    len += 2;
+    if (max_npdu_len) {
+        decode_unsigned16(&payload[len], max_npdu_len);
+    }
+    len += 2;
+
+    return len;
+}
+
+/**
+ * @brief Decode the payload of a BVLC-Result
+ *
+ * @param payload - the payload of the message
+ * @param payload_len - number of bytes of the payload
+ * @param result_function - returns the BVLC-SC message of the request
+ * @param nak - returns true for a NAK
+ * @param error_class - returns the error class of a NAK
+ * @param error_code - returns the error code of a NAK
+ *
+ * @return number of bytes decoded, without any error details,
+ *  or 0 if malformed
+ */
+int bvlc_sc_decode_result(uint8_t *payload,
+    uint16_t payload_len,
+    uint8_t *result_function,
+    bool *nak,
+    uint16_t *error_class,
+    uint16_t *error_code)
+{
+    uint16_t value = 0;
+
+    if (!payload || (payload_len < 2) || (payload[1] > 1)) {
+        return 0;
+    }
+    if (result_function) {
+        *result_function = payload[0];
+    }
+    if (nak) {
+        *nak = payload[1] ? true : false;
+    }
+    if (payload[1] == 0) {
+        return 2;
+    }
+    if (payload_len < 7) {
+        return 0;
+    }
+    decode_unsigned16(&payload[3], &value);
+    if (error_class) {
+        *error_class = value;
+    }
+    decode_unsigned16(&payload[5], &value);
+    if (error_code) {
+        *error_code = value;
+    }
+
+    return 7;
+}
+
+/**
+ * @brief Start an empty batch of WebSocket frames
+ * @param batch - the batch
+ * @param buffer - buffer of the frames, such as the TLS record buffer
+ * @param size - size of the buffer
+ */
+void bvlc_sc_batch_init(BVLC_SC_BATCH *batch, uint8_t *buffer, uint16_t size)
+{
+    if (!batch) {
+        return;
+    }
+    batch->buffer = buffer;
+    batch->size = buffer ? size : 0;
+    batch->length = 0;
+    batch->count = 0;
+}
+
+/**
+ * @brief Add a BVLC-SC message to a batch as a WebSocket binary frame.
+ *  A node masks the frames to the hub, and a hub does not mask its
+ *  frames to the nodes.
+ * @param batch - the batch
+ * @param pdu - the BVLC-SC message
+ * @param pdu_len - number of bytes of the message
+ * @param mask - the 4-octet masking key of the frame, or NULL
+ * @return true if the frame was added, false if the batch is full and is
+ *  to be written before the message is added again
+ */
+bool bvlc_sc_batch_add(BVLC_SC_BATCH *batch,
+    const uint8_t *pdu,
+    uint16_t pdu_len,
+    const uint8_t *mask)
+{
+    uint8_t *frame = NULL;
+    uint16_t len = 2;
+    uint16_t i = 0;
+
+    if (!batch || !batch->buffer || !pdu) {
+        return false;
+    }
+    if (pdu_len > 125) {
+        len += 2;
+    }
+    if (mask) {
+        len += 4;
+    }
+    if (((uint32_t)batch->length + len + pdu_len) > batch->size) {
+        return false;
+    }
+    frame = &batch->buffer[batch->length];
+    frame[0] = BVLC_SC_WEBSOCKET_BINARY;
+    if (pdu_len > 125) {
+        frame[1] = 126;
+        encode_unsigned16(&frame[2], pdu_len);
+    } else {
+        frame[1] = (uint8_t)pdu_len;
+    }
+    if (mask) {
+        frame[1] |= BVLC_SC_WEBSOCKET_MASKED;
+        memcpy(&frame[len - 4], mask, 4);
+        for (i = 0; i < pdu_len; i++) {
+            frame[len + i] = pdu[i] ^ mask[i % 4];
+        }
+    } else {
+        memcpy(&frame[len], pdu, pdu_len);
+    }
+    batch->length += len + pdu_len;
+    batch->count++;
+
+    return true;
+}
+
+/**
+ * @brief Empty a batch after it was written
+ * @param batch - the batch
+ */
+void bvlc_sc_batch_clear(BVLC_SC_BATCH *batch)
+{
+    if (batch) {
+        batch->length = 0;
+        batch->count = 0;
+    }
+}
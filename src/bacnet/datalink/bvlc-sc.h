@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief BACnet/SC virtual link control (BVLC-SC) messages of Annex AB,
+ *  and the batching of the messages as WebSocket binary frames, so that
+ *  many messages to the hub are written with one TLS record
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @defgroup DLBSC BACnet/SC DataLink Network Layer
+ * @ingroup DataLink
+ */
+#ifndef BACNET_BVLC_SC_H
+#define BACNET_BVLC_SC_H
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+#define BVLC_SC_VMAC_SIZE 6
+#define BVLC_SC_UUID_SIZE 16
+
+/**
+ * BVLC-SC Messages
+ * @{
+ */
+#define BVLC_SC_RESULT 0x00
+#define BVLC_SC_ENCAPSULATED_NPDU 0x01
+#define BVLC_SC_ADDRESS_RESOLUTION 0x02
+#define BVLC_SC_ADDRESS_RESOLUTION_ACK 0x03
+#define BVLC_SC_ADVERTISEMENT 0x04
+#define BVLC_SC_ADVERTISEMENT_SOLICITATION 0x05
+#define BVLC_SC_CONNECT_REQUEST 0x06
+#define BVLC_SC_CONNECT_ACCEPT 0x07
+#define BVLC_SC_DISCONNECT_REQUEST 0x08
+#define BVLC_SC_DISCONNECT_ACK 0x09
+#define BVLC_SC_HEARTBEAT_REQUEST 0x0A
+#define BVLC_SC_HEARTBEAT_ACK 0x0B
+#define BVLC_SC_PROPRIETARY_MESSAGE 0x0C
+/** @} */
+
+/**
+ * BVLC-SC Control Flags
+ * @{
+ */
+#define BVLC_SC_CONTROL_ORIGINATING_VMAC 0x08
+#define BVLC_SC_CONTROL_DESTINATION_VMAC 0x04
+#define BVLC_SC_CONTROL_DESTINATION_OPTIONS 0x02
+#define BVLC_SC_CONTROL_DATA_OPTIONS 0x01
+/** @} */
+
+/**
+ * BVLC-SC Header Option Marker
+ * @{
+ */
+#define BVLC_SC_OPTION_MORE 0x80
+#define BVLC_SC_OPTION_MUST_UNDERSTAND 0x40
+#define BVLC_SC_OPTION_HEADER_DATA 0x20
+#define BVLC_SC_OPTION_TYPE_MASK 0x1F
+/** @} */
+
+/* the fixed part of a header, without addresses or options */
+#define BVLC_SC_HEADER_MIN 4
+/* the WebSocket frame header with a 16-bit length and a masking key */
+#define BVLC_SC_WEBSOCKET_HEADER_MAX (2 + 2 + 4)
+
+/**
+ * A decoded BVLC-SC message, whose options and payload are in the
+ * received buffer
+ */
+typedef struct bvlc_sc_message {
+    uint8_t function;
+    uint16_t message_id;
+    bool originating_present;
+    uint8_t originating_vmac[BVLC_SC_VMAC_SIZE];
+    bool destination_present;
+    uint8_t destination_vmac[BVLC_SC_VMAC_SIZE];
+    uint8_t *destination_options;
+    uint16_t destination_options_len;
+    uint8_t *data_options;
+    uint16_t data_options_len;
+    uint8_t *payload;
+    uint16_t payload_len;
+} BVLC_SC_MESSAGE;
+
+/**
+ * The WebSocket frames of the messages to be written to one connection
+ * together, such as with one TLS record
+ */
+typedef struct bvlc_sc_batch {
+    uint8_t *buffer;
+    uint16_t size;
+    uint16_t length;
+    unsigned count;
+} BVLC_SC_BATCH;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+int bvlc_sc_encode_header(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t function,
+    uint16_t message_id,
+    const uint8_t *originating_vmac,
+    const uint8_t *destination_vmac);
+BACNET_STACK_EXPORT
+int bvlc_sc_encode_encapsulated_npdu(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint16_t message_id,
+    const uint8_t *originating_vmac,
+    const uint8_t *destination_vmac,
+    const uint8_t *npdu,
+    uint16_t npdu_len);
+BACNET_STACK_EXPORT
+int bvlc_sc_encode_connect(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t function,
+    uint16_t message_id,
+    const uint8_t *vmac,
+    const uint8_t *uuid,
+    uint16_t max_bvlc_len,
+    uint16_t max_npdu_len);
+BACNET_STACK_EXPORT
+int bvlc_sc_encode_control(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint8_t function,
+    uint16_t message_id);
+BACNET_STACK_EXPORT
+int bvlc_sc_encode_result(uint8_t *pdu,
+    uint16_t pdu_size,
+    uint16_t message_id,
+    const uint8_t *destination_vmac,
+    uint8_t result_function,
+    bool nak,
+    uint16_t error_class,
+    uint16_t error_code);
+
+BACNET_STACK_EXPORT
+int bvlc_sc_decode_message(
+    uint8_t *pdu, uint16_t pdu_len, BVLC_SC_MESSAGE *message);
+BACNET_STACK_EXPORT
+int bvlc_sc_decode_connect(uint8_t *payload,
+    uint16_t payload_len,
+    uint8_t *vmac,
+    uint8_t *uuid,
+    uint16_t *max_bvlc_len,
+    uint16_t *max_npdu_len);
+BACNET_STACK_EXPORT
+int bvlc_sc_decode_result(uint8_t *payload,
+    uint16_t payload_len,
+    uint8_t *result_function,
+    bool *nak,
+    uint16_t *error_class,
+    uint16_t *error_code);
+
+BACNET_STACK_EXPORT
+void bvlc_sc_batch_init(BVLC_SC_BATCH *batch, uint8_t *buffer, uint16_t size);
+BACNET_STACK_EXPORT
+bool bvlc_sc_batch_add(BVLC_SC_BATCH *batch,
+    const uint8_t *pdu,
+    uint16_t pdu_len,
+    const uint8_t *mask);
+BACNET_STACK_EXPORT
+void bvlc_sc_batch_clear(BVLC_SC_BATCH *batch);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
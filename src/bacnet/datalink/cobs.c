@@ -9,9 +9,66 @@
  */
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/datalink/mstpdef.h"
 #include "bacnet/datalink/cobs.h"
 
+#if defined(CRC_USE_TABLE)
+/* CRC-32K of each octet value, for one octet per step */
+static const uint32_t CRC32K_Table[256] = {
+    0x00000000, 0x9695c4ca, 0xfb4839c9, 0x6dddfd03, 0x20f3c3cf, 0xb6660705,
+    0xdbbbfa06, 0x4d2e3ecc, 0x41e7879e, 0xd7724354, 0xbaafbe57, 0x2c3a7a9d,
+    0x61144451, 0xf781809b, 0x9a5c7d98, 0x0cc9b952, 0x83cf0f3c, 0x155acbf6,
+    0x788736f5, 0xee12f23f, 0xa33cccf3, 0x35a90839, 0x5874f53a, 0xcee131f0,
+    0xc22888a2, 0x54bd4c68, 0x3960b16b, 0xaff575a1, 0xe2db4b6d, 0x744e8fa7,
+    0x199372a4, 0x8f06b66e, 0xd1fdae25, 0x47686aef, 0x2ab597ec, 0xbc205326,
+    0xf10e6dea, 0x679ba920, 0x0a465423, 0x9cd390e9, 0x901a29bb, 0x068fed71,
+    0x6b521072, 0xfdc7d4b8, 0xb0e9ea74, 0x267c2ebe, 0x4ba1d3bd, 0xdd341777,
+    0x5232a119, 0xc4a765d3, 0xa97a98d0, 0x3fef5c1a, 0x72c162d6, 0xe454a61c,
+    0x89895b1f, 0x1f1c9fd5, 0x13d52687, 0x8540e24d, 0xe89d1f4e, 0x7e08db84,
+    0x3326e548, 0xa5b32182, 0xc86edc81, 0x5efb184b, 0x7598ec17, 0xe30d28dd,
+    0x8ed0d5de, 0x18451114, 0x556b2fd8, 0xc3feeb12, 0xae231611, 0x38b6d2db,
+    0x347f6b89, 0xa2eaaf43, 0xcf375240, 0x59a2968a, 0x148ca846, 0x82196c8c,
+    0xefc4918f, 0x79515545, 0xf657e32b, 0x60c227e1, 0x0d1fdae2, 0x9b8a1e28,
+    0xd6a420e4, 0x4031e42e, 0x2dec192d, 0xbb79dde7, 0xb7b064b5, 0x2125a07f,
+    0x4cf85d7c, 0xda6d99b6, 0x9743a77a, 0x01d663b0, 0x6c0b9eb3, 0xfa9e5a79,
+    0xa4654232, 0x32f086f8, 0x5f2d7bfb, 0xc9b8bf31, 0x849681fd, 0x12034537,
+    0x7fdeb834, 0xe94b7cfe, 0xe582c5ac, 0x73170166, 0x1ecafc65, 0x885f38af,
+    0xc5710663, 0x53e4c2a9, 0x3e393faa, 0xa8acfb60, 0x27aa4d0e, 0xb13f89c4,
+    0xdce274c7, 0x4a77b00d, 0x07598ec1, 0x91cc4a0b, 0xfc11b708, 0x6a8473c2,
+    0x664dca90, 0xf0d80e5a, 0x9d05f359, 0x0b903793, 0x46be095f, 0xd02bcd95,
+    0xbdf63096, 0x2b63f45c, 0xeb31d82e, 0x7da41ce4, 0x1079e1e7, 0x86ec252d,
+    0xcbc21be1, 0x5d57df2b, 0x308a2228, 0xa61fe6e2, 0xaad65fb0, 0x3c439b7a,
+    0x519e6679, 0xc70ba2b3, 0x8a259c7f, 0x1cb058b5, 0x716da5b6, 0xe7f8617c,
+    0x68fed712, 0xfe6b13d8, 0x93b6eedb, 0x05232a11, 0x480d14dd, 0xde98d017,
+    0xb3452d14, 0x25d0e9de, 0x2919508c, 0xbf8c9446, 0xd2516945, 0x44c4ad8f,
+    0x09ea9343, 0x9f7f5789, 0xf2a2aa8a, 0x64376e40, 0x3acc760b, 0xac59b2c1,
+    0xc1844fc2, 0x57118b08, 0x1a3fb5c4, 0x8caa710e, 0xe1778c0d, 0x77e248c7,
+    0x7b2bf195, 0xedbe355f, 0x8063c85c, 0x16f60c96, 0x5bd8325a, 0xcd4df690,
+    0xa0900b93, 0x3605cf59, 0xb9037937, 0x2f96bdfd, 0x424b40fe, 0xd4de8434,
+    0x99f0baf8, 0x0f657e32, 0x62b88331, 0xf42d47fb, 0xf8e4fea9, 0x6e713a63,
+    0x03acc760, 0x953903aa, 0xd8173d66, 0x4e82f9ac, 0x235f04af, 0xb5cac065,
+    0x9ea93439, 0x083cf0f3, 0x65e10df0, 0xf374c93a, 0xbe5af7f6, 0x28cf333c,
+    0x4512ce3f, 0xd3870af5, 0xdf4eb3a7, 0x49db776d, 0x24068a6e, 0xb2934ea4,
+    0xffbd7068, 0x6928b4a2, 0x04f549a1, 0x92608d6b, 0x1d663b05, 0x8bf3ffcf,
+    0xe62e02cc, 0x70bbc606, 0x3d95f8ca, 0xab003c00, 0xc6ddc103, 0x504805c9,
+    0x5c81bc9b, 0xca147851, 0xa7c98552, 0x315c4198, 0x7c727f54, 0xeae7bb9e,
+    0x873a469d, 0x11af8257, 0x4f549a1c, 0xd9c15ed6, 0xb41ca3d5, 0x2289671f,
+    0x6fa759d3, 0xf9329d19, 0x94ef601a, 0x027aa4d0, 0x0eb31d82, 0x9826d948,
+    0xf5fb244b, 0x636ee081, 0x2e40de4d, 0xb8d51a87, 0xd508e784, 0x439d234e,
+    0xcc9b9520, 0x5a0e51ea, 0x37d3ace9, 0xa1466823, 0xec6856ef, 0x7afd9225,
+    0x17206f26, 0x81b5abec, 0x8d7c12be, 0x1be9d674, 0x76342b77, 0xe0a1efbd,
+    0xad8fd171, 0x3b1a15bb, 0x56c7e8b8, 0xc0522c72
+};
+#else
+/* CRC-32K of each nibble value, for one nibble per step */
+static const uint32_t CRC32K_Table[16] = {
+    0x00000000, 0x83cf0f3c, 0xd1fdae25, 0x5232a119, 0x7598ec17, 0xf657e32b,
+    0xa4654232, 0x27aa4d0e, 0xeb31d82e, 0x68fed712, 0x3acc760b, 0xb9037937,
+    0x9ea93439, 0x1d663b05, 0x4f549a1c, 0xcc9b9520
+};
+#endif
+
 /**
  * @brief Encode the CRC32K as little-endian byte order
  * @param buffer - encoded buffer
@@ -61,6 +118,34 @@ uint32_t cobs_crc32k(uint8_t dataValue, uint32_t crc32kValue)
     return crc; /* Return updated crc value */
 }
 
+/**
+ * @brief Accumulate a buffer of octets into the CRC-32K. With
+ *  CRC_USE_TABLE, one octet is accumulated per table lookup, otherwise
+ *  one nibble is accumulated per lookup of a smaller table.
+ * @param buffer - octets to accumulate
+ * @param length - number of octets in the buffer
+ * @param crc32kValue - CRC value to accumulate into
+ * @return value is updated CRC.
+ */
+uint32_t cobs_crc32k_buffer(
+    const uint8_t *buffer, size_t length, uint32_t crc32kValue)
+{
+    uint32_t crc = crc32kValue;
+
+    while (length > 0) {
+#if defined(CRC_USE_TABLE)
+        crc = (crc >> 8) ^ CRC32K_Table[(crc ^ *buffer) & 0xFF];
+#else
+        crc = (crc >> 4) ^ CRC32K_Table[(crc ^ *buffer) & 0x0F];
+        crc = (crc >> 4) ^ CRC32K_Table[(crc ^ (*buffer >> 4)) & 0x0F];
+#endif
+        buffer++;
+        length--;
+    }
+
+    return crc;
+}
+
 /**
  * @brief Encodes 'length' octets of data located at 'from' and
  * writes one or more COBS code blocks at 'buffer', removing
@@ -70,7 +155,7 @@ uint32_t cobs_crc32k(uint8_t dataValue, uint32_t crc32kValue)
  * @param from - buffer to encode
  * @param length - number of bytes in the buffer to encode
  * @return the length of the encoded data, or 0 if error
- * @note This function is copied mostly from the BACnet standard.
+ * @note The encoding is that of the BACnet standard, copied a run at a time.
  */
 size_t cobs_encode(uint8_t *buffer,
     size_t buffer_size,
@@ -78,66 +163,53 @@ size_t cobs_encode(uint8_t *buffer,
     size_t length,
     uint8_t mask)
 {
-    size_t code_index = 0;
     size_t read_index = 0;
-    size_t write_index = 1;
-    uint8_t code = 1;
-    uint8_t data = 0;
-    uint8_t last_code = 0;
+    size_t write_index = 0;
+    size_t run, i;
+    const uint8_t *zero = NULL;
 
     if ((buffer_size < 1) || (length < 1)) {
         /* error - buffer too small */
         return 0;
     }
-    while (read_index < length) {
-        data = from[read_index++];
+    do {
         /*
-         * In the case of encountering a non-zero octet in the data,
-         * simply copy input to output and increment the code octet.
+         * Each code block holds the run of up to 254 non-zero octets
+         * that precede the next zero, so find the run length first and
+         * then copy the whole run.
          */
-        if (data != 0) {
-            if (write_index == buffer_size) {
-                /* error - buffer too small */
-                return 0;
-            }
-            buffer[write_index++] = data ^ mask;
-            code++;
-            if (code != 255) {
-                continue;
-            }
+        run = length - read_index;
+        if (run > 254) {
+            run = 254;
         }
-        /*
-         * In the case of encountering a zero in the data or having
-         * copied the maximum number (254) of non-zero octets, store
-         * the code octet and reset the encoder state variables.
-         */
-        last_code = code;
-        if (code_index == buffer_size) {
-            /* error - buffer too small */
-            return 0;
+        zero = memchr(&from[read_index], 0, run);
+        if (zero) {
+            run = (size_t)(zero - &from[read_index]);
         }
-        buffer[code_index] = code ^ mask;
-        code_index = write_index++;
-        code = 1;
-    }
-    /*
-     * If the last chunk contains exactly 254 non-zero octets, then
-     * this exception is handled above (and returned length must be
-     * adjusted). Otherwise, encode the last chunk normally, as if
-     * a "phantom zero" is appended to the data.
-     */
-    if ((last_code == 255) && (code == 1)) {
-        write_index--;
-    } else {
-        if (code_index == buffer_size) {
+        if ((buffer_size - write_index) < (run + 1)) {
             /* error - buffer too small */
             return 0;
         }
-        buffer[code_index] = code ^ mask;
-    }
+        buffer[write_index++] = (uint8_t)(run + 1) ^ mask;
+        for (i = 0; i < run; i++) {
+            buffer[write_index + i] = from[read_index + i] ^ mask;
+        }
+        write_index += run;
+        read_index += run;
+        if (zero) {
+            /* the zero is implied by the code block */
+            read_index++;
+        }
+        /*
+         * A zero at the end of the data is followed by an empty block.
+         * A block of exactly 254 non-zero octets has no implied zero,
+         * so no block follows it at the end of the data.
+         */
+    } while (zero || (read_index < length));
 
     return write_index;
 }
+
 /**
  * @brief Encodes 'length' octets of client data located at 'from' and writes
  * the COBS-encoded Encoded Data and Encoded CRC-32K fields at 'buffer'.
@@ -154,7 +226,6 @@ size_t cobs_frame_encode(
     size_t cobs_data_len, cobs_crc_len;
     uint32_t crc32K;
     uint8_t crc_buffer[4];
-    int i;
 
     /*
      * Prepare the Encoded Data field for transmission.
@@ -168,10 +239,8 @@ size_t cobs_frame_encode(
      * Calculate CRC-32K over the Encoded Data field.
      * NOTE: May be done as each octet is transmitted to reduce latency.
      */
-    crc32K = CRC32K_INITIAL_VALUE;
-    for (i = 0; i < cobs_data_len; i++) {
-        crc32K = cobs_crc32k(buffer[i], crc32K); /* See Clause G.3.1 */
-    }
+    crc32K = cobs_crc32k_buffer(
+        buffer, cobs_data_len, CRC32K_INITIAL_VALUE); /* See Clause G.3.1 */
     /*
      * Prepare the Encoded CRC-32K field for transmission.
      */
@@ -199,7 +268,8 @@ size_t cobs_frame_encode(
  * @param from - buffer to decode
  * @param length - number of bytes in the buffer to decode
  * @return the length of the decoded buffer, or 0 if error
- * @note This function is copied directly from the BACnet standard.
+ * @note The decoding is that of the BACnet standard, copied a run at a time.
+ * @note Safe to call with 'buffer' <= 'from' (decodes in place).
  */
 size_t cobs_decode(uint8_t *buffer,
     size_t buffer_size,
@@ -209,36 +279,36 @@ size_t cobs_decode(uint8_t *buffer,
 {
     size_t read_index = 0;
     size_t write_index = 0;
-    uint8_t code, last_code;
+    size_t run, i;
+    uint8_t code;
 
     while (read_index < length) {
         code = from[read_index] ^ mask;
-        last_code = code;
         /*
-         * Sanity check the encoding to prevent the while() loop below
-         * from overrunning the output buffer.
+         * Sanity check the encoding to prevent the copy below
+         * from overrunning the input or output buffer.
          */
         if ((code == 0) || ((read_index + code) > length)) {
             return 0;
         }
         read_index++;
-        while (--code > 0) {
-            if (write_index == buffer_size) {
-                /* error - destination buffer too small */
-                return 0;
-            }
-            if (read_index == length) {
-                /* error - source buffer too small */
-                return 0;
-            }
-            buffer[write_index++] = from[read_index++] ^ mask;
+        run = code - 1;
+        if ((buffer_size - write_index) < run) {
+            /* error - destination buffer too small */
+            return 0;
+        }
+        /* copy forward, so that decoding in place is safe */
+        for (i = 0; i < run; i++) {
+            buffer[write_index + i] = from[read_index + i] ^ mask;
         }
+        write_index += run;
+        read_index += run;
         /*
          * Restore the implicit zero at the end of each decoded block
          * except when it contains exactly 254 non-zero octets or the
          * end of data has been reached.
          */
-        if ((last_code != 255) && (read_index < length)) {
+        if ((code != 255) && (read_index < length)) {
             if (write_index == buffer_size) {
                 /* error - destination buffer too small */
                 return 0;
@@ -269,7 +339,6 @@ size_t cobs_frame_decode(
     size_t data_len, crc_len;
     uint32_t crc32K;
     uint8_t crc_buffer[4];
-    int i;
 
     if (length < COBS_ENCODED_CRC_SIZE) {
         /* error during decode */
@@ -280,11 +349,8 @@ size_t cobs_frame_decode(
      * NOTE: Adjust 'length' by removing size of Encoded CRC-32K field.
      */
     data_len = length - COBS_ENCODED_CRC_SIZE;
-    crc32K = CRC32K_INITIAL_VALUE;
-    for (i = 0; i < data_len; i++) {
-        /* See Clause G.3.1 */
-        crc32K = cobs_crc32k(from[i], crc32K);
-    }
+    /* See Clause G.3.1 */
+    crc32K = cobs_crc32k_buffer(from, data_len, CRC32K_INITIAL_VALUE);
     data_len =
         cobs_decode(buffer, buffer_size, from, data_len, MSTP_PREAMBLE_X55);
     if (data_len == 0) {
@@ -306,9 +372,7 @@ size_t cobs_frame_decode(
     /*
      * Continue to verify CRC32K of incoming frame.
      */
-    for (i = 0; i < crc_len; i++) {
-        crc32K = cobs_crc32k(crc_buffer[i], crc32K);
-    }
+    crc32K = cobs_crc32k_buffer(crc_buffer, crc_len, crc32K);
     if (crc32K == CRC32K_RESIDUE) {
         return data_len;
     }
@@ -91,6 +91,12 @@ uint32_t cobs_crc32k(
     uint8_t dataValue,
     uint32_t crc);
 
+BACNET_STACK_EXPORT
+uint32_t cobs_crc32k_buffer(
+    const uint8_t *buffer,
+    size_t length,
+    uint32_t crc);
+
 BACNET_STACK_EXPORT
 size_t cobs_crc32k_encode(
     uint8_t *buffer,
@@ -8,70 +8,45 @@
  * @ingroup DataLink
  */
 #include "bacnet/datalink/datalink.h"
-
-#if defined(BACDL_ALL) || defined FOR_DOXYGEN
-#include "bacnet/datalink/ethernet.h"
+#if defined(BACDL_ALL)
 #include "bacnet/datalink/bip.h"
-#include "bacnet/datalink/bvlc.h"
-#include "bacnet/basic/bbmd/h_bbmd.h"
+#elif defined(BACDL_ETHERNET) || defined(BACDL_ARCNET) || defined(BACDL_MSTP)
+/* datalink_receive() uses this datalink, which has no descriptor */
+#elif defined(BACDL_BIP)
+#include "bacnet/datalink/bip.h"
+#define DATALINK_SOCKETS_BIP
+#elif defined(BACDL_BIP6)
 #include "bacnet/datalink/bip6.h"
-#include "bacnet/datalink/bvlc6.h"
-#include "bacnet/basic/bbmd6/h_bbmd6.h"
-#include "bacnet/datalink/arcnet.h"
-#include "bacnet/datalink/dlmstp.h"
-#include <strings.h> /* for strcasecmp() */
-
-static enum {
-    DATALINK_NONE = 0,
-    DATALINK_ARCNET,
-    DATALINK_ETHERNET,
-    DATALINK_BIP,
-    DATALINK_BIP6,
-    DATALINK_MSTP
-} Datalink_Transport;
+#define DATALINK_SOCKETS_BIP6
+#endif
+
+#if defined(BACDL_ALL) || defined FOR_DOXYGEN
+#include "bacnet/bacstr.h"
+#include "bacnet/datalink/dlport.h"
+
+/* the datalink chosen by datalink_set(), or NULL for none */
+static const BACNET_DATALINK_OPS *Datalink_Transport;
 
 void datalink_set(char *datalink_string)
 {
-    if (strcasecmp("bip", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_BIP;
-    } else if (strcasecmp("bip6", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_BIP6;
-    } else if (strcasecmp("ethernet", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_ETHERNET;
-    } else if (strcasecmp("arcnet", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_ARCNET;
-    } else if (strcasecmp("mstp", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_MSTP;
-    } else if (strcasecmp("none", datalink_string) == 0) {
-        Datalink_Transport = DATALINK_NONE;
+    const BACNET_DATALINK_OPS *ops;
+
+    if (bacnet_stricmp("none", datalink_string) == 0) {
+        Datalink_Transport = NULL;
+    } else {
+        ops = datalink_ops_find(datalink_string);
+        if (ops) {
+            Datalink_Transport = ops;
+        }
     }
 }
 
 bool datalink_init(char *ifname)
 {
-    bool status = false;
-
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            status = true;
-            break;
-        case DATALINK_ARCNET:
-            status = arcnet_init(ifname);
-            break;
-        case DATALINK_ETHERNET:
-            status = ethernet_init(ifname);
-            break;
-        case DATALINK_BIP:
-            status = bip_init(ifname);
-            break;
-        case DATALINK_BIP6:
-            status = bip6_init(ifname);
-            break;
-        case DATALINK_MSTP:
-            status = dlmstp_init(ifname);
-            break;
-        default:
-            break;
+    bool status = true;
+
+    if (Datalink_Transport && Datalink_Transport->init) {
+        status = Datalink_Transport->init(ifname);
     }
 
     return status;
@@ -82,29 +57,10 @@ int datalink_send_pdu(BACNET_ADDRESS *dest,
     uint8_t *pdu,
     unsigned pdu_len)
 {
-    int bytes = 0;
-
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            bytes = pdu_len;
-            break;
-        case DATALINK_ARCNET:
-            bytes = arcnet_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_ETHERNET:
-            bytes = ethernet_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_BIP:
-            bytes = bip_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_BIP6:
-            bytes = bip6_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        case DATALINK_MSTP:
-            bytes = dlmstp_send_pdu(dest, npdu_data, pdu, pdu_len);
-            break;
-        default:
-            break;
+    int bytes = pdu_len;
+
+    if (Datalink_Transport && Datalink_Transport->send_pdu) {
+        bytes = Datalink_Transport->send_pdu(dest, npdu_data, pdu, pdu_len);
     }
 
     return bytes;
@@ -115,26 +71,8 @@ uint16_t datalink_receive(
 {
     uint16_t bytes = 0;
 
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            bytes = arcnet_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_ETHERNET:
-            bytes = ethernet_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_BIP:
-            bytes = bip_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_BIP6:
-            bytes = bip6_receive(src, pdu, max_pdu, timeout);
-            break;
-        case DATALINK_MSTP:
-            bytes = dlmstp_receive(src, pdu, max_pdu, timeout);
-            break;
-        default:
-            break;
+    if (Datalink_Transport && Datalink_Transport->receive) {
+        bytes = Datalink_Transport->receive(src, pdu, max_pdu, timeout);
     }
 
     return bytes;
@@ -142,124 +80,34 @@ uint16_t datalink_receive(
 
 void datalink_cleanup(void)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            arcnet_cleanup();
-            break;
-        case DATALINK_ETHERNET:
-            ethernet_cleanup();
-            break;
-        case DATALINK_BIP:
-            bip_cleanup();
-            break;
-        case DATALINK_BIP6:
-            bip6_cleanup();
-            break;
-        case DATALINK_MSTP:
-            dlmstp_cleanup();
-            break;
-        default:
-            break;
+    if (Datalink_Transport && Datalink_Transport->cleanup) {
+        Datalink_Transport->cleanup();
     }
 }
 
 void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            arcnet_get_broadcast_address(dest);
-            break;
-        case DATALINK_ETHERNET:
-            ethernet_get_broadcast_address(dest);
-            break;
-        case DATALINK_BIP:
-            bip_get_broadcast_address(dest);
-            break;
-        case DATALINK_BIP6:
-            bip6_get_broadcast_address(dest);
-            break;
-        case DATALINK_MSTP:
-            dlmstp_get_broadcast_address(dest);
-            break;
-        default:
-            break;
+    if (Datalink_Transport && Datalink_Transport->get_broadcast_address) {
+        Datalink_Transport->get_broadcast_address(dest);
     }
 }
 
 void datalink_get_my_address(BACNET_ADDRESS *my_address)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            arcnet_get_my_address(my_address);
-            break;
-        case DATALINK_ETHERNET:
-            ethernet_get_my_address(my_address);
-            break;
-        case DATALINK_BIP:
-            bip_get_my_address(my_address);
-            break;
-        case DATALINK_BIP6:
-            bip6_get_my_address(my_address);
-            break;
-        case DATALINK_MSTP:
-            dlmstp_get_my_address(my_address);
-            break;
-        default:
-            break;
+    if (Datalink_Transport && Datalink_Transport->get_my_address) {
+        Datalink_Transport->get_my_address(my_address);
     }
 }
 
 void datalink_set_interface(char *ifname)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            (void)ifname;
-            break;
-        case DATALINK_ARCNET:
-            (void)ifname;
-            break;
-        case DATALINK_ETHERNET:
-            (void)ifname;
-            break;
-        case DATALINK_BIP:
-            (void)ifname;
-            break;
-        case DATALINK_BIP6:
-            (void)ifname;
-            break;
-        case DATALINK_MSTP:
-            (void)ifname;
-            break;
-        default:
-            break;
-    }
+    (void)ifname;
 }
 
 void datalink_maintenance_timer(uint16_t seconds)
 {
-    switch (Datalink_Transport) {
-        case DATALINK_NONE:
-            break;
-        case DATALINK_ARCNET:
-            break;
-        case DATALINK_ETHERNET:
-            break;
-        case DATALINK_BIP:
-            bvlc_maintenance_timer(seconds);
-            break;
-        case DATALINK_BIP6:
-            bvlc6_maintenance_timer(seconds);
-            break;
-        case DATALINK_MSTP:
-            break;
-        default:
-            break;
+    if (Datalink_Transport && Datalink_Transport->maintenance_timer) {
+        Datalink_Transport->maintenance_timer(seconds);
     }
 }
 #endif
@@ -325,3 +173,79 @@ void datalink_maintenance_timer(uint16_t seconds)
     (void)seconds;
 }
 #endif
+
+#if defined(BACDL_ALL) || defined(DATALINK_SOCKETS_BIP) || \
+    defined(DATALINK_SOCKETS_BIP6)
+/**
+ * @brief Add a descriptor to a list, unless it is not valid or is in
+ *  the list already
+ * @param sockets - list of descriptors
+ * @param size - number of descriptors that fit in the list
+ * @param count - number of descriptors in the list
+ * @param sock - descriptor to add
+ * @return number of descriptors in the list
+ */
+static unsigned
+datalink_socket_add(int *sockets, unsigned size, unsigned count, int sock)
+{
+    unsigned i;
+
+    if ((sock < 0) || (count >= size)) {
+        return count;
+    }
+    for (i = 0; i < count; i++) {
+        if (sockets[i] == sock) {
+            return count;
+        }
+    }
+    sockets[count] = sock;
+
+    return count + 1;
+}
+#endif
+
+/**
+ * @brief Get the descriptors of the datalink, which become readable when
+ *  a packet has been received, so that an event loop of the application,
+ *  such as with poll() or epoll, can wait on them along with its own
+ *  descriptors, until the next deadline of its timers.
+ * @note A received packet may already be buffered by the datalink, so
+ *  after a descriptor is readable, call datalink_receive() with a timeout
+ *  of 0 until it returns 0 before waiting again.
+ * @param sockets - list of descriptors to fill
+ * @param size - number of descriptors that fit in the list, such as
+ *  BACNET_DATALINK_SOCKETS_MAX
+ * @return number of descriptors, or 0 if the datalink has none to wait on
+ */
+unsigned datalink_sockets(int *sockets, unsigned size)
+{
+    unsigned count = 0;
+
+    if (!sockets) {
+        return 0;
+    }
+#if defined(BACDL_ALL)
+    if (Datalink_Transport) {
+        if (Datalink_Transport->port_type == PORT_TYPE_BIP) {
+            /* bip_receive() also waits on the broadcast socket */
+            count = datalink_socket_add(sockets, size, count, bip_get_socket());
+            count = datalink_socket_add(
+                sockets, size, count, bip_get_broadcast_socket());
+        } else if (Datalink_Transport->socket) {
+            count = datalink_socket_add(
+                sockets, size, count, Datalink_Transport->socket());
+        }
+    }
+#elif defined(DATALINK_SOCKETS_BIP)
+    count = datalink_socket_add(sockets, size, count, bip_get_socket());
+    count =
+        datalink_socket_add(sockets, size, count, bip_get_broadcast_socket());
+#elif defined(DATALINK_SOCKETS_BIP6)
+    count = datalink_socket_add(sockets, size, count, bip6_get_socket());
+#else
+    /* MS/TP, Ethernet and ARCNET have no descriptor to wait on */
+    (void)size;
+#endif
+
+    return count;
+}
@@ -57,6 +57,9 @@
 #define datalink_init bip_init
 #define datalink_send_pdu bip_send_pdu
 #define datalink_receive bip_receive
+#if BACNET_IP_RECEIVE_BUFFER
+#define datalink_receive_buffer bip_receive_buffer
+#endif
 #define datalink_cleanup bip_cleanup
 #define datalink_get_broadcast_address bip_get_broadcast_address
 #ifdef BAC_ROUTING
@@ -84,11 +87,26 @@ void routed_get_my_address(
 #define datalink_init bip6_init
 #define datalink_send_pdu bip6_send_pdu
 #define datalink_receive bip6_receive
+#if BACNET_IP6_RECEIVE_BUFFER
+#define datalink_receive_buffer bip6_receive_buffer
+#endif
 #define datalink_cleanup bip6_cleanup
 #define datalink_get_broadcast_address bip6_get_broadcast_address
 #define datalink_get_my_address bip6_get_my_address
 #define datalink_maintenance_timer(s) bvlc6_maintenance_timer(s)
 
+#elif defined(BACDL_LOOPBACK)
+#include "bacnet/datalink/loopback.h"
+#define MAX_MPDU LOOPBACK_MPDU_MAX
+
+#define datalink_init loopback_init
+#define datalink_send_pdu loopback_send_pdu
+#define datalink_receive loopback_receive
+#define datalink_cleanup loopback_cleanup
+#define datalink_get_broadcast_address loopback_get_broadcast_address
+#define datalink_get_my_address loopback_get_my_address
+#define datalink_maintenance_timer(s)
+
 #elif defined(BACDL_ALL) || defined(BACDL_NONE) || defined(BACDL_CUSTOM)
 #include "bacnet/npdu.h"
 
@@ -143,6 +161,22 @@ extern "C" {
 }
 #endif /* __cplusplus */
 #endif
+
+/* number of descriptors of the datalink given by datalink_sockets() */
+#ifndef BACNET_DATALINK_SOCKETS_MAX
+#define BACNET_DATALINK_SOCKETS_MAX 2
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+    BACNET_STACK_EXPORT
+    unsigned datalink_sockets(int *sockets, unsigned size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
 /** @defgroup DataLink The BACnet Network (DataLink) Layer
  * <b>6 THE NETWORK LAYER </b><br>
  * The purpose of the BACnet network layer is to provide the means by which
@@ -161,6 +195,7 @@ extern "C" {
  * - BACDL_MSTP     -- for Clause 9 MASTER-SLAVE/TOKEN PASSING (MS/TP) LAN
  * - BACDL_BIP      -- for ANNEX J - BACnet/IPv4
  * - BACDL_BIP6     -- for ANNEX U - BACnet/IPv6
+ * - BACDL_LOOPBACK -- for virtual nodes in one process, for testing
  * - BACDL_ALL      -- Unspecified for the build, so the transport can be
  *                     chosen at runtime from among these choices.
  * - BACDL_NONE      -- Unspecified for the build for unit testing
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -36,6 +37,10 @@ static uint16_t BBMD_TTL_Seconds = 60000;
 /* BBMD variables */
 static BACNET_IP_ADDRESS BBMD_Address;
 static bool BBMD_Address_Valid;
+/* the BBMDs to register with, in the order of their priority, starting
+   with BBMD_Address */
+static BACNET_IP_ADDRESS BBMD_Address_List[MAX_REMOTE_BBMD_ENTRIES];
+static unsigned BBMD_Address_Count;
 static uint16_t BBMD_Result = 0;
 #if BBMD_ENABLED
 static BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY BBMD_Table_Entry;
@@ -75,6 +80,8 @@ void bip_dl_debug_disable(void)
 void dlenv_bbmd_address_set(BACNET_IP_ADDRESS *address)
 {
     bvlc_address_copy(&BBMD_Address, address);
+    bvlc_address_copy(&BBMD_Address_List[0], address);
+    BBMD_Address_Count = 1;
     BBMD_Address_Valid = true;
 }
 
@@ -116,7 +123,8 @@ int dlenv_bbmd_result(void)
  * The Environment Variables depend on define of BACDL_BIP:
  *     - BACNET_BBMD_PORT - 0..65534, defaults to 47808
  *     - BACNET_BBMD_TIMETOLIVE - 0..65535 seconds, defaults to 60000
- *     - BACNET_BBMD_ADDRESS - dotted IPv4 address
+ *     - BACNET_BBMD_ADDRESS - dotted IPv4 address or host name, or a comma
+ *       separated list of them, in the order of their priority
  * @return Positive number (of bytes sent) on success,
  *         0 if no registration request is sent, or
  *         -1 if registration fails.
@@ -129,6 +137,8 @@ static int bbmd_register_as_foreign_device(void)
     char *pEnv = NULL;
     unsigned a[4] = { 0 };
     char bbmd_env[32] = "";
+    char bbmd_name[128] = "";
+    BACNET_IP_ADDRESS *address = NULL;
     unsigned entry_number = 0;
     long long_value = 0;
     int c;
@@ -153,19 +163,44 @@ static int bbmd_register_as_foreign_device(void)
     }
     pEnv = getenv("BACNET_BBMD_ADDRESS");
     if (pEnv) {
-        BBMD_Address_Valid = bip_get_addr_by_name(pEnv, &BBMD_Address);
+        BBMD_Address_Count = 0;
+        while (*pEnv && (BBMD_Address_Count < MAX_REMOTE_BBMD_ENTRIES)) {
+            c = (int)strcspn(pEnv, ",");
+            if ((c > 0) && (c < (int)sizeof(bbmd_name))) {
+                memcpy(bbmd_name, pEnv, c);
+                bbmd_name[c] = 0;
+                address = &BBMD_Address_List[BBMD_Address_Count];
+                if (bip_get_addr_by_name(bbmd_name, address)) {
+                    address->port = BBMD_Address.port;
+                    BBMD_Address_Count++;
+                }
+            }
+            pEnv += c;
+            if (*pEnv == ',') {
+                pEnv++;
+            }
+        }
+        BBMD_Address_Valid = (BBMD_Address_Count > 0);
+        if (BBMD_Address_Valid) {
+            bvlc_address_copy(&BBMD_Address, &BBMD_Address_List[0]);
+        }
     }
     if (BBMD_Address_Valid) {
         if (BIP_DL_Debug) {
-            fprintf(stderr,
-                "Registering with BBMD at %u.%u.%u.%u:%u for %u seconds\n",
-                (unsigned)BBMD_Address.address[0],
-                (unsigned)BBMD_Address.address[1],
-                (unsigned)BBMD_Address.address[2],
-                (unsigned)BBMD_Address.address[3], (unsigned)BBMD_Address.port,
-                (unsigned)BBMD_TTL_Seconds);
+            for (entry_number = 0; entry_number < BBMD_Address_Count;
+                 entry_number++) {
+                address = &BBMD_Address_List[entry_number];
+                fprintf(stderr,
+                    "Registering with BBMD at %u.%u.%u.%u:%u for %u seconds\n",
+                    (unsigned)address->address[0],
+                    (unsigned)address->address[1],
+                    (unsigned)address->address[2],
+                    (unsigned)address->address[3], (unsigned)address->port,
+                    (unsigned)BBMD_TTL_Seconds);
+            }
         }
-        retval = bvlc_register_with_bbmd(&BBMD_Address, BBMD_TTL_Seconds);
+        retval = bvlc_register_with_bbmds(
+            BBMD_Address_List, BBMD_Address_Count, BBMD_TTL_Seconds);
         if (retval < 0) {
             fprintf(stderr, "FAILED to Register with BBMD at %u.%u.%u.%u:%u\n",
                 (unsigned)BBMD_Address.address[0],
@@ -531,6 +566,8 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
  *       entry 1..128 (optional)
  *   - BACNET_IP_NAT_ADDR - dotted IPv4 address of the public facing router
  *   - BACNET_IP_BROADCAST_BIND_ADDR - dotted IPv4 address to bind broadcasts
+ *   - BACNET_IP_SOCKET_SHARDS - number of unicast sockets that share the
+ *       port, each of which can be received on its own thread (Linux)
  * - BACDL_MSTP: (BACnet MS/TP)
  *   - BACNET_MAX_INFO_FRAMES
  *   - BACNET_MAX_MASTER
@@ -603,6 +640,12 @@ void dlenv_init(void)
     if (pEnv) {
         bip_set_broadcast_binding(pEnv);
     }
+#if defined(__linux__)
+    pEnv = getenv("BACNET_IP_SOCKET_SHARDS");
+    if (pEnv) {
+        bip_set_socket_shards((unsigned)strtoul(pEnv, NULL, 0));
+    }
+#endif
     pEnv = getenv("BACNET_IP_NAT_ADDR");
     if (pEnv) {
         if (bip_get_addr_by_name(pEnv, &addr)) {
@@ -16,6 +16,7 @@
 /* BACnet Stack API */
 #include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/trace.h"
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstp.h"
 #include "bacnet/datalink/dlmstp.h"
@@ -26,6 +27,45 @@
 /* the current MSTP port that the datalink is using */
 static struct mstp_port_struct_t *MSTP_Port;
 
+/**
+ * @brief Get the queued PDU that is sent next: the oldest PDU of the
+ *  highest network priority that has any
+ * @param user - user data of the MSTP port
+ * @param priority [out] the network priority of the PDU
+ * @return the PDU, or NULL if none are queued
+ */
+static struct dlmstp_packet *
+dlmstp_queue_peek(struct dlmstp_user_data_t *user, unsigned *priority)
+{
+    volatile uint8_t *index;
+    unsigned i;
+
+    for (i = DLMSTP_PRIORITY_QUEUES; i > 0; i--) {
+        index = Ringbuf_Peek(&user->PDU_Queue[i - 1]);
+        if (index) {
+            *priority = i - 1;
+            return &user->PDU_Buffer[*index];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Remove the oldest PDU from the queue of a network priority, and
+ *  return its packet to the free queue
+ * @param user - user data of the MSTP port
+ * @param priority - the network priority of the PDU
+ */
+static void dlmstp_queue_pop(struct dlmstp_user_data_t *user, unsigned priority)
+{
+    uint8_t index;
+
+    if (Ringbuf_Pop(&user->PDU_Queue[priority], &index)) {
+        (void)Ringbuf_Put(&user->PDU_Free, &index);
+    }
+}
+
 /**
  * @brief send an PDU via MSTP
  * @param dest - BACnet destination address
@@ -42,7 +82,10 @@ int dlmstp_send_pdu(BACNET_ADDRESS *dest,
     int bytes_sent = 0;
     unsigned i = 0; /* loop counter */
     struct dlmstp_user_data_t *user = NULL;
-    struct dlmstp_packet *pkt;
+    struct dlmstp_packet *pkt = NULL;
+    volatile uint8_t *free_index;
+    uint8_t index;
+    unsigned priority;
 
     if (!MSTP_Port) {
         return 0;
@@ -51,7 +94,10 @@ int dlmstp_send_pdu(BACNET_ADDRESS *dest,
         return 0;
     }
     user = MSTP_Port->UserData;
-    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Data_Peek(&user->PDU_Queue);
+    free_index = Ringbuf_Peek(&user->PDU_Free);
+    if (free_index) {
+        pkt = &user->PDU_Buffer[*free_index];
+    }
     if (pkt && (pdu_len <= DLMSTP_MPDU_MAX)) {
         if (npdu_data->data_expecting_reply) {
             pkt->frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
@@ -71,8 +117,12 @@ int dlmstp_send_pdu(BACNET_ADDRESS *dest,
             pkt->address.mac[0] = MSTP_BROADCAST_ADDRESS;
             pkt->address.len = 0;
         }
-        if (Ringbuf_Data_Put(&user->PDU_Queue, (uint8_t *)pkt)) {
+        /* life safety and alarm messages are not sent after the others */
+        priority = npdu_data->priority % DLMSTP_PRIORITY_QUEUES;
+        (void)Ringbuf_Pop(&user->PDU_Free, &index);
+        if (Ringbuf_Put(&user->PDU_Queue[priority], &index)) {
             bytes_sent = pdu_len;
+            BACNET_TRACE(NPDU_TX, dest ? dest->net : 0, pdu_len);
         }
     }
 
@@ -91,6 +141,7 @@ uint16_t MSTP_Get_Send(
     uint16_t pdu_len = 0;
     struct dlmstp_packet *pkt;
     struct dlmstp_user_data_t *user;
+    unsigned priority = 0;
 
     if (!mstp_port) {
         return 0;
@@ -99,17 +150,17 @@ uint16_t MSTP_Get_Send(
     if (!user) {
         return 0;
     }
-    if (Ringbuf_Empty(&user->PDU_Queue)) {
+    /* look at next PDU in queue without removing it */
+    pkt = dlmstp_queue_peek(user, &priority);
+    if (!pkt) {
         return 0;
     }
-    /* look at next PDU in queue without removing it */
-    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(&user->PDU_Queue);
     /* convert the PDU into the MSTP Frame */
     pdu_len = MSTP_Create_Frame(&mstp_port->OutputBuffer[0],
         mstp_port->OutputBufferSize, pkt->frame_type, pkt->address.mac[0],
         mstp_port->This_Station, &pkt->pdu[0], pkt->pdu_len);
     user->Statistics.transmit_pdu_counter++;
-    (void)Ringbuf_Pop(&user->PDU_Queue, NULL);
+    dlmstp_queue_pop(user, priority);
 
     return pdu_len;
 }
@@ -247,7 +298,9 @@ uint16_t MSTP_Get_Reply(
     uint16_t pdu_len = 0;
     bool matched = false;
     struct dlmstp_user_data_t *user = NULL;
-    struct dlmstp_packet *pkt;
+    struct dlmstp_packet *pkt = NULL;
+    volatile uint8_t *index;
+    unsigned priority;
 
     if (!mstp_port) {
         return 0;
@@ -256,14 +309,20 @@ uint16_t MSTP_Get_Reply(
     if (!user) {
         return 0;
     }
-    if (Ringbuf_Empty(&user->PDU_Queue)) {
-        return 0;
+    /* look at the next PDU of each queue without removing it, since the
+       reply may be queued behind a PDU of a higher priority */
+    for (priority = DLMSTP_PRIORITY_QUEUES; priority > 0; priority--) {
+        index = Ringbuf_Peek(&user->PDU_Queue[priority - 1]);
+        if (index) {
+            pkt = &user->PDU_Buffer[*index];
+            /* is this the reply to the DER? */
+            matched = MSTP_Compare_Data_Expecting_Reply(
+                mstp_port, pkt->pdu, pkt->pdu_len, &pkt->address);
+            if (matched) {
+                break;
+            }
+        }
     }
-    /* look at next PDU in queue without removing it */
-    pkt = (struct dlmstp_packet *)(void *)Ringbuf_Peek(&user->PDU_Queue);
-    /* is this the reply to the DER? */
-    matched = MSTP_Compare_Data_Expecting_Reply(
-        mstp_port, pkt->pdu, pkt->pdu_len, &pkt->address);
     if (!matched) {
         return 0;
     }
@@ -272,7 +331,7 @@ uint16_t MSTP_Get_Reply(
         mstp_port->OutputBufferSize, pkt->frame_type, pkt->address.mac[0],
         mstp_port->This_Station, &pkt->pdu[0], pkt->pdu_len);
     user->Statistics.transmit_pdu_counter++;
-    (void)Ringbuf_Pop(&user->PDU_Queue, NULL);
+    dlmstp_queue_pop(user, priority - 1);
 
     return pdu_len;
 }
@@ -338,6 +397,9 @@ uint16_t dlmstp_receive(
 {
     uint16_t pdu_len = 0;
     uint8_t data_register = 0;
+    const uint8_t *data = NULL;
+    uint16_t length = 0;
+    uint16_t consumed = 0;
     struct dlmstp_user_data_t *user;
     struct dlmstp_rs485_driver *driver;
     uint16_t i;
@@ -365,16 +427,32 @@ uint16_t dlmstp_receive(
         return 0;
     }
     /* only do receive state machine while we don't have a frame */
-    while ((MSTP_Port->ReceivedValidFrame == false) &&
-        (MSTP_Port->ReceivedInvalidFrame == false)) {
-        MSTP_Port->DataAvailable = driver->read(&data_register);
-        if (MSTP_Port->DataAvailable) {
-            MSTP_Port->DataRegister = data_register;
+    if (driver->read_block && driver->read_block_release) {
+        /* process the received bytes a block at a time */
+        while ((MSTP_Port->ReceivedValidFrame == false) &&
+            (MSTP_Port->ReceivedInvalidFrame == false)) {
+            length = driver->read_block(&data);
+            consumed = MSTP_Receive_Frame_FSM_Block(MSTP_Port, data, length);
+            if (consumed) {
+                driver->read_block_release(consumed);
+            }
+            if ((length == 0) || (consumed < length)) {
+                /* no more bytes, or a frame ended within the block */
+                break;
+            }
         }
-        MSTP_Receive_Frame_FSM(MSTP_Port);
-        /* process another byte, if available */
-        if (!driver->read(NULL)) {
-            break;
+    } else {
+        while ((MSTP_Port->ReceivedValidFrame == false) &&
+            (MSTP_Port->ReceivedInvalidFrame == false)) {
+            MSTP_Port->DataAvailable = driver->read(&data_register);
+            if (MSTP_Port->DataAvailable) {
+                MSTP_Port->DataRegister = data_register;
+            }
+            MSTP_Receive_Frame_FSM(MSTP_Port);
+            /* process another byte, if available */
+            if (!driver->read(NULL)) {
+                break;
+            }
         }
     }
     if (MSTP_Port->ReceivedValidFrame || MSTP_Port->ReceivedInvalidFrame) {
@@ -565,6 +643,20 @@ uint8_t dlmstp_max_master(void)
     return value;
 }
 
+/**
+ * @brief Send the Reply Postponed frame at once for a Data Expecting Reply
+ *  frame that is routed to another network, whose reply is not available
+ *  within Treply_delay, such as in a router
+ * @param enable - true to postpone the routed requests at once
+ */
+void dlmstp_set_reply_postpone_routed(bool enable)
+{
+    if (MSTP_Port) {
+        MSTP_Port->Reply_Postpone =
+            enable ? MSTP_Reply_Postpone_Routed : NULL;
+    }
+}
+
 /**
  * @brief Initialize the data link broadcast address
  * @param my_address - address to be filled with unicast designator
@@ -619,7 +711,8 @@ bool dlmstp_send_pdu_queue_empty(void)
     if (MSTP_Port) {
         user = MSTP_Port->UserData;
         if (user) {
-            status = Ringbuf_Empty(&user->PDU_Queue);
+            status = (Ringbuf_Count(&user->PDU_Free) ==
+                DLMSTP_MAX_INFO_FRAMES);
         }
     }
 
@@ -638,7 +731,7 @@ bool dlmstp_send_pdu_queue_full(void)
     if (MSTP_Port) {
         user = MSTP_Port->UserData;
         if (user) {
-            status = Ringbuf_Full(&user->PDU_Queue);
+            status = Ringbuf_Empty(&user->PDU_Free);
         }
     }
 
@@ -796,15 +889,27 @@ void dlmstp_silence_reset(void *arg)
 bool dlmstp_init(char *ifname)
 {
     struct dlmstp_user_data_t *user;
+    uint8_t index;
+    unsigned i;
+
     MSTP_Port = (struct mstp_port_struct_t *)ifname;
     if (MSTP_Port) {
         MSTP_Port->SilenceTimer = dlmstp_silence_milliseconds;
         MSTP_Port->SilenceTimerReset = dlmstp_silence_reset;
         user = (struct dlmstp_user_data_t *)MSTP_Port->UserData;
         if (user && !user->Initialized) {
-            Ringbuf_Init(&user->PDU_Queue,
-                (volatile uint8_t *)user->PDU_Buffer,
-                sizeof(user->PDU_Buffer), DLMSTP_MAX_INFO_FRAMES);
+            for (i = 0; i < DLMSTP_PRIORITY_QUEUES; i++) {
+                Ringbuf_Init(&user->PDU_Queue[i],
+                    (volatile uint8_t *)user->PDU_Queue_Index[i],
+                    sizeof(user->PDU_Queue_Index[i][0]),
+                    DLMSTP_MAX_INFO_FRAMES);
+            }
+            Ringbuf_Init(&user->PDU_Free,
+                (volatile uint8_t *)user->PDU_Free_Index,
+                sizeof(user->PDU_Free_Index[0]), DLMSTP_MAX_INFO_FRAMES);
+            for (index = 0; index < DLMSTP_MAX_INFO_FRAMES; index++) {
+                (void)Ringbuf_Put(&user->PDU_Free, &index);
+            }
             MSTP_Init(MSTP_Port);
             user->Initialized = true;
         }
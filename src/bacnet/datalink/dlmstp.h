@@ -46,6 +46,8 @@ typedef struct dlmstp_statistics {
 #ifndef DLMSTP_MAX_INFO_FRAMES
 #define DLMSTP_MAX_INFO_FRAMES DEFAULT_MAX_INFO_FRAMES
 #endif
+/* one transmit queue for each network priority of the NPDU */
+#define DLMSTP_PRIORITY_QUEUES 4
 #ifndef DLMSTP_MAX_MASTER
 #define DLMSTP_MAX_MASTER DEFAULT_MAX_MASTER
 #endif
@@ -80,6 +82,14 @@ struct dlmstp_rs485_driver {
 
     /** Reset the silence time */
     void (*silence_reset)(void);
+
+    /** Optional: get the received bytes that are contiguous in the
+        receive buffer of the driver, such as a DMA buffer, without
+        removing them, and return the number of bytes */
+    uint16_t (*read_block)(const uint8_t **data);
+
+    /** Optional, with read_block: remove the processed bytes */
+    void (*read_block_release)(uint16_t length);
 };
 
 /**
@@ -88,8 +98,13 @@ struct dlmstp_rs485_driver {
 struct dlmstp_user_data_t {
     struct dlmstp_statistics Statistics;
     struct dlmstp_rs485_driver *RS485_Driver;
-    /* the PDU Queue is made of Nmax_info_frames x dlmstp_packet's */
-    RING_BUFFER PDU_Queue;
+    /* the PDU Queue is made of Nmax_info_frames x dlmstp_packet's,
+       which are taken from the free queue and are sent from the queue of
+       their network priority, highest priority first */
+    RING_BUFFER PDU_Queue[DLMSTP_PRIORITY_QUEUES];
+    uint8_t PDU_Queue_Index[DLMSTP_PRIORITY_QUEUES][DLMSTP_MAX_INFO_FRAMES];
+    RING_BUFFER PDU_Free;
+    uint8_t PDU_Free_Index[DLMSTP_MAX_INFO_FRAMES];
     struct dlmstp_packet PDU_Buffer[DLMSTP_MAX_INFO_FRAMES];
     bool Initialized;
     bool ReceivePacketPending;
@@ -163,6 +178,13 @@ extern "C" {
     uint8_t dlmstp_max_master(
         void);
 
+    /* send Reply Postponed at once for a request routed to another
+       network, such as in a router, whose reply is not available
+       within Treply_delay */
+    BACNET_STACK_EXPORT
+    void dlmstp_set_reply_postpone_routed(
+        bool enable);
+
     /* MAC address 0-127 */
     BACNET_STACK_EXPORT
     void dlmstp_set_mac_address(
@@ -0,0 +1,374 @@
+/**
+ * @file
+ * @brief Datalink ports chosen at run-time: a table of the functions of
+ *  each type of datalink, and a list of the ports of a process that are
+ *  sent to and received from in one loop, such as in a device that is
+ *  also a router between its ports.
+ * @note The datalinks keep their state in their own modules, so each
+ *  type of datalink is added as one port at most.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DataLink
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacstr.h"
+#include "bacnet/datalink/dlport.h"
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+#include "bacnet/datalink/arcnet.h"
+#endif
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+#include "bacnet/datalink/ethernet.h"
+#endif
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+#include "bacnet/datalink/bip.h"
+#include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/bbmd/h_bbmd.h"
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+#include "bacnet/datalink/bip6.h"
+#include "bacnet/datalink/bvlc6.h"
+#include "bacnet/basic/bbmd6/h_bbmd6.h"
+#endif
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+#include "bacnet/datalink/dlmstp.h"
+#endif
+#if defined(BACDL_LOOPBACK) || defined(BACDL_ALL)
+#include "bacnet/datalink/loopback.h"
+#endif
+
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+const BACNET_DATALINK_OPS Datalink_ARCNET_Ops = {
+    "arcnet", PORT_TYPE_ARCNET, ARCNET_MPDU_MAX, arcnet_init,
+    arcnet_send_pdu, arcnet_receive, arcnet_cleanup,
+    arcnet_get_broadcast_address, arcnet_get_my_address, NULL, NULL
+};
+#endif
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+const BACNET_DATALINK_OPS Datalink_Ethernet_Ops = {
+    "ethernet", PORT_TYPE_ETHERNET, ETHERNET_MPDU_MAX, ethernet_init,
+    ethernet_send_pdu, ethernet_receive, ethernet_cleanup,
+    ethernet_get_broadcast_address, ethernet_get_my_address, NULL, NULL
+};
+#endif
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+/* no socket: bip_receive() may wait on a broadcast socket as well */
+const BACNET_DATALINK_OPS Datalink_BIP_Ops = {
+    "bip", PORT_TYPE_BIP, BIP_MPDU_MAX, bip_init, bip_send_pdu,
+    bip_receive, bip_cleanup, bip_get_broadcast_address,
+    bip_get_my_address, bvlc_maintenance_timer, NULL
+};
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+const BACNET_DATALINK_OPS Datalink_BIP6_Ops = {
+    "bip6", PORT_TYPE_BIP6, BIP6_MPDU_MAX, bip6_init, bip6_send_pdu,
+    bip6_receive, bip6_cleanup, bip6_get_broadcast_address,
+    bip6_get_my_address, bvlc6_maintenance_timer, bip6_get_socket
+};
+#endif
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+const BACNET_DATALINK_OPS Datalink_MSTP_Ops = {
+    "mstp", PORT_TYPE_MSTP, DLMSTP_MPDU_MAX, dlmstp_init, dlmstp_send_pdu,
+    dlmstp_receive, dlmstp_cleanup, dlmstp_get_broadcast_address,
+    dlmstp_get_my_address, NULL, NULL
+};
+#endif
+#if defined(BACDL_LOOPBACK) || defined(BACDL_ALL)
+const BACNET_DATALINK_OPS Datalink_Loopback_Ops = {
+    "loopback", PORT_TYPE_VIRTUAL, LOOPBACK_MPDU_MAX, loopback_init,
+    loopback_send_pdu, loopback_receive, loopback_cleanup,
+    loopback_get_broadcast_address, loopback_get_my_address, NULL, NULL
+};
+#endif
+
+/* the datalinks found by datalink_ops_find() */
+static const BACNET_DATALINK_OPS *const Datalink_Ops_List[] = {
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+    &Datalink_ARCNET_Ops,
+#endif
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+    &Datalink_Ethernet_Ops,
+#endif
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+    &Datalink_BIP_Ops,
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+    &Datalink_BIP6_Ops,
+#endif
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+    &Datalink_MSTP_Ops,
+#endif
+#if defined(BACDL_LOOPBACK) || defined(BACDL_ALL)
+    &Datalink_Loopback_Ops,
+#endif
+    NULL
+};
+
+/* the ports that were added, and the next one to receive from */
+static const BACNET_DATALINK_OPS *Datalink_Ports[BACNET_DATALINK_PORTS_MAX];
+static unsigned Datalink_Port_Count;
+static unsigned Datalink_Port_Next;
+
+/**
+ * @brief Find a datalink that is built into the library by its name
+ * @param name - name of the datalink, such as "bip" or "mstp"
+ * @return the functions of the datalink, or NULL if not found
+ */
+const BACNET_DATALINK_OPS *datalink_ops_find(const char *name)
+{
+    unsigned i = 0;
+
+    if (!name) {
+        return NULL;
+    }
+    while (Datalink_Ops_List[i]) {
+        if (bacnet_stricmp(Datalink_Ops_List[i]->name, name) == 0) {
+            return Datalink_Ops_List[i];
+        }
+        i++;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Initialize a datalink and add it to the ports of the process
+ * @param ops - the functions of the datalink
+ * @param ifname - interface name given to the init function
+ * @return the port number 0..N-1, or -1 if the datalink was already
+ *  added, there is no room, or the datalink failed to initialize
+ */
+int datalink_port_add(const BACNET_DATALINK_OPS *ops, char *ifname)
+{
+    unsigned i;
+
+    if (!ops || (Datalink_Port_Count >= BACNET_DATALINK_PORTS_MAX)) {
+        return -1;
+    }
+    for (i = 0; i < Datalink_Port_Count; i++) {
+        if (Datalink_Ports[i] == ops) {
+            return -1;
+        }
+    }
+    if (ops->init && !ops->init(ifname)) {
+        return -1;
+    }
+    Datalink_Ports[Datalink_Port_Count] = ops;
+    Datalink_Port_Count++;
+
+    return (int)(Datalink_Port_Count - 1);
+}
+
+/**
+ * @brief Get the number of ports that were added
+ * @return number of ports
+ */
+unsigned datalink_port_count(void)
+{
+    return Datalink_Port_Count;
+}
+
+/**
+ * @brief Get the functions of the datalink of a port
+ * @param port - port number 0..N-1
+ * @return the functions of the datalink, or NULL for an invalid port
+ */
+const BACNET_DATALINK_OPS *datalink_port_ops(unsigned port)
+{
+    if (port >= Datalink_Port_Count) {
+        return NULL;
+    }
+
+    return Datalink_Ports[port];
+}
+
+/**
+ * @brief Send a PDU out of one port
+ * @param port - port number 0..N-1
+ * @param dest - destination address on the network of the port
+ * @param npdu_data - network information of the PDU
+ * @param pdu - the bytes of data to send
+ * @param pdu_len - the number of bytes of data to send
+ * @return number of bytes sent, or -1 on failure
+ */
+int datalink_port_send_pdu(unsigned port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    const BACNET_DATALINK_OPS *ops = datalink_port_ops(port);
+
+    if (!ops || !ops->send_pdu) {
+        return -1;
+    }
+
+    return ops->send_pdu(dest, npdu_data, pdu, pdu_len);
+}
+
+/**
+ * @brief Receive a PDU from any of the ports. The ports are asked in
+ *  turn, starting after the port of the last PDU, first without waiting
+ *  so that a waiting PDU is returned at once, and then each waiting for
+ *  its share of the timeout.
+ * @param port - the port number of the PDU is returned here
+ * @param src - source address of the PDU is returned here
+ * @param pdu - buffer for the PDU
+ * @param max_pdu - size of the buffer, which fits the largest MPDU of
+ *  the ports
+ * @param timeout - number of milliseconds to wait for a PDU
+ * @return number of bytes received, or 0 if none
+ */
+uint16_t datalink_port_receive(unsigned *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout)
+{
+    const BACNET_DATALINK_OPS *ops;
+    unsigned share = 0;
+    unsigned wait = 0;
+    unsigned pass, i, index;
+    uint16_t pdu_len;
+
+    if (Datalink_Port_Count == 0) {
+        return 0;
+    }
+    if (timeout) {
+        share = timeout / Datalink_Port_Count;
+        if (share == 0) {
+            share = 1;
+        }
+    }
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < Datalink_Port_Count; i++) {
+            index = (Datalink_Port_Next + i) % Datalink_Port_Count;
+            ops = Datalink_Ports[index];
+            if (!ops->receive) {
+                continue;
+            }
+            pdu_len = ops->receive(src, pdu, max_pdu, wait);
+            if (pdu_len) {
+                Datalink_Port_Next = (index + 1) % Datalink_Port_Count;
+                if (port) {
+                    *port = index;
+                }
+                return pdu_len;
+            }
+        }
+        if (share == 0) {
+            break;
+        }
+        wait = share;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the broadcast address of the network of a port
+ * @param port - port number 0..N-1
+ * @param dest - the broadcast address is returned here
+ * @return true if the port is valid
+ */
+bool datalink_port_get_broadcast_address(unsigned port, BACNET_ADDRESS *dest)
+{
+    const BACNET_DATALINK_OPS *ops = datalink_port_ops(port);
+
+    if (!ops || !ops->get_broadcast_address) {
+        return false;
+    }
+    ops->get_broadcast_address(dest);
+
+    return true;
+}
+
+/**
+ * @brief Get my address on the network of a port
+ * @param port - port number 0..N-1
+ * @param my_address - my address is returned here
+ * @return true if the port is valid
+ */
+bool datalink_port_get_my_address(unsigned port, BACNET_ADDRESS *my_address)
+{
+    const BACNET_DATALINK_OPS *ops = datalink_port_ops(port);
+
+    if (!ops || !ops->get_my_address) {
+        return false;
+    }
+    ops->get_my_address(my_address);
+
+    return true;
+}
+
+/**
+ * @brief Get the descriptor that an event loop of the application waits
+ *  on for a port
+ * @param port - port number 0..N-1
+ * @return the descriptor, or -1 if the port has none
+ */
+int datalink_port_socket(unsigned port)
+{
+    const BACNET_DATALINK_OPS *ops = datalink_port_ops(port);
+
+    if (!ops || !ops->socket) {
+        return -1;
+    }
+
+    return ops->socket();
+}
+
+/**
+ * @brief Call the timer function of each port about once a second
+ * @param seconds - number of elapsed seconds since the last call
+ */
+void datalink_port_maintenance_timer(uint16_t seconds)
+{
+    unsigned i;
+
+    for (i = 0; i < Datalink_Port_Count; i++) {
+        if (Datalink_Ports[i]->maintenance_timer) {
+            Datalink_Ports[i]->maintenance_timer(seconds);
+        }
+    }
+}
+
+/**
+ * @brief Clean up each port, and remove all of the ports
+ */
+void datalink_port_cleanup(void)
+{
+    unsigned i;
+
+    for (i = 0; i < Datalink_Port_Count; i++) {
+        if (Datalink_Ports[i]->cleanup) {
+            Datalink_Ports[i]->cleanup();
+        }
+        Datalink_Ports[i] = NULL;
+    }
+    Datalink_Port_Count = 0;
+    Datalink_Port_Next = 0;
+}
+
+#if BACNET_DATALINK_STATS
+/**
+ * @brief Get the counters of the datalink of a port
+ * @param port - port number 0..N-1
+ * @param stats - the counters are copied here
+ * @return true if the port is valid
+ */
+bool datalink_port_stats(unsigned port, BACNET_DATALINK_PORT_STATS *stats)
+{
+    const BACNET_DATALINK_OPS *ops = datalink_port_ops(port);
+
+    if (!ops) {
+        return false;
+    }
+
+    return datalink_stats(ops->port_type, stats);
+}
+#endif
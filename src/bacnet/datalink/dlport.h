@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @brief API for datalink ports chosen at run-time: a table of the
+ *  functions of each type of datalink, and a list of the ports of a
+ *  process that are sent to and received from in one loop.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DataLink
+ */
+#ifndef BACNET_DATALINK_PORT_H
+#define BACNET_DATALINK_PORT_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/npdu.h"
+#include "bacnet/datalink/dlstats.h"
+
+/* number of ports that can be added with datalink_port_add() */
+#ifndef BACNET_DATALINK_PORTS_MAX
+#define BACNET_DATALINK_PORTS_MAX 4
+#endif
+
+/* the functions of one type of datalink. Any function may be NULL
+   when the datalink has nothing to do for it. */
+typedef struct bacnet_datalink_ops {
+    /* name used by datalink_set(), such as "bip" */
+    const char *name;
+    /* Network_Type of the datalink, which also selects its counters */
+    BACNET_PORT_TYPE port_type;
+    /* size of the largest MPDU of the datalink */
+    uint16_t mpdu_max;
+    bool (*init)(char *ifname);
+    int (*send_pdu)(BACNET_ADDRESS *dest,
+        BACNET_NPDU_DATA *npdu_data,
+        uint8_t *pdu,
+        unsigned pdu_len);
+    uint16_t (*receive)(BACNET_ADDRESS *src,
+        uint8_t *pdu,
+        uint16_t max_pdu,
+        unsigned timeout);
+    void (*cleanup)(void);
+    void (*get_broadcast_address)(BACNET_ADDRESS *dest);
+    void (*get_my_address)(BACNET_ADDRESS *my_address);
+    void (*maintenance_timer)(uint16_t seconds);
+    /* a descriptor that is readable when a packet has been received,
+       for an event loop of the application, or -1 */
+    int (*socket)(void);
+} BACNET_DATALINK_OPS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* the datalinks that are built into the library */
+#if defined(BACDL_ARCNET) || defined(BACDL_ALL)
+extern const BACNET_DATALINK_OPS Datalink_ARCNET_Ops;
+#endif
+#if defined(BACDL_ETHERNET) || defined(BACDL_ALL)
+extern const BACNET_DATALINK_OPS Datalink_Ethernet_Ops;
+#endif
+#if defined(BACDL_BIP) || defined(BACDL_ALL)
+extern const BACNET_DATALINK_OPS Datalink_BIP_Ops;
+#endif
+#if defined(BACDL_BIP6) || defined(BACDL_ALL)
+extern const BACNET_DATALINK_OPS Datalink_BIP6_Ops;
+#endif
+#if defined(BACDL_MSTP) || defined(BACDL_ALL)
+extern const BACNET_DATALINK_OPS Datalink_MSTP_Ops;
+#endif
+#if defined(BACDL_LOOPBACK) || defined(BACDL_ALL)
+extern const BACNET_DATALINK_OPS Datalink_Loopback_Ops;
+#endif
+
+BACNET_STACK_EXPORT
+const BACNET_DATALINK_OPS *datalink_ops_find(const char *name);
+
+BACNET_STACK_EXPORT
+int datalink_port_add(const BACNET_DATALINK_OPS *ops, char *ifname);
+BACNET_STACK_EXPORT
+unsigned datalink_port_count(void);
+BACNET_STACK_EXPORT
+const BACNET_DATALINK_OPS *datalink_port_ops(unsigned port);
+
+BACNET_STACK_EXPORT
+int datalink_port_send_pdu(unsigned port,
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+BACNET_STACK_EXPORT
+uint16_t datalink_port_receive(unsigned *port,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout);
+BACNET_STACK_EXPORT
+bool datalink_port_get_broadcast_address(unsigned port, BACNET_ADDRESS *dest);
+BACNET_STACK_EXPORT
+bool datalink_port_get_my_address(unsigned port, BACNET_ADDRESS *my_address);
+BACNET_STACK_EXPORT
+int datalink_port_socket(unsigned port);
+BACNET_STACK_EXPORT
+void datalink_port_maintenance_timer(uint16_t seconds);
+BACNET_STACK_EXPORT
+void datalink_port_cleanup(void);
+#if BACNET_DATALINK_STATS
+BACNET_STACK_EXPORT
+bool datalink_port_stats(unsigned port, BACNET_DATALINK_PORT_STATS *stats);
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
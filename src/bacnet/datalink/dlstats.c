@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Optional counters of the datalink layers: packets and octets
+ *  received and sent, packets dropped, CRC errors, oversize frames,
+ *  and BVLC NAKs, kept for each type of network port.
+ * @note The counters are not atomic. When a datalink receives in one
+ *  thread and sends in another, a counter may miss some of the
+ *  concurrent updates.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DataLink
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/datalink/dlstats.h"
+
+#if BACNET_DATALINK_STATS
+/* one set of counters for each of the standard port types */
+#define DATALINK_STATS_PORT_TYPES (PORT_TYPE_BSC + 1)
+static BACNET_DATALINK_PORT_STATS Datalink_Stats[DATALINK_STATS_PORT_TYPES];
+
+/**
+ * @brief Get the counters of a type of datalink
+ * @param port_type - the network port type of the datalink
+ * @param stats - the counters are copied here
+ * @return true if the port type is valid
+ */
+bool datalink_stats(
+    BACNET_PORT_TYPE port_type, BACNET_DATALINK_PORT_STATS *stats)
+{
+    if ((port_type >= DATALINK_STATS_PORT_TYPES) || !stats) {
+        return false;
+    }
+    memcpy(stats, &Datalink_Stats[port_type], sizeof(*stats));
+
+    return true;
+}
+
+/**
+ * @brief Clear the counters of a type of datalink
+ * @param port_type - the network port type of the datalink,
+ *  or PORT_TYPE_MAX for all of them
+ */
+void datalink_stats_reset(BACNET_PORT_TYPE port_type)
+{
+    if (port_type == PORT_TYPE_MAX) {
+        memset(Datalink_Stats, 0, sizeof(Datalink_Stats));
+    } else if (port_type < DATALINK_STATS_PORT_TYPES) {
+        memset(&Datalink_Stats[port_type], 0, sizeof(Datalink_Stats[0]));
+    }
+}
+
+/**
+ * @brief Note a packet received by a datalink
+ * @param port_type - the network port type of the datalink
+ * @param octets - number of octets in the packet
+ */
+void datalink_stats_received(BACNET_PORT_TYPE port_type, uint32_t octets)
+{
+    if (port_type < DATALINK_STATS_PORT_TYPES) {
+        Datalink_Stats[port_type].rx_packets++;
+        Datalink_Stats[port_type].rx_octets += octets;
+    }
+}
+
+/**
+ * @brief Note a packet sent by a datalink
+ * @param port_type - the network port type of the datalink
+ * @param octets - number of octets in the packet
+ */
+void datalink_stats_sent(BACNET_PORT_TYPE port_type, uint32_t octets)
+{
+    if (port_type < DATALINK_STATS_PORT_TYPES) {
+        Datalink_Stats[port_type].tx_packets++;
+        Datalink_Stats[port_type].tx_octets += octets;
+    }
+}
+
+/**
+ * @brief Note an error of a datalink
+ * @param port_type - the network port type of the datalink
+ * @param error - the kind of error
+ */
+void datalink_stats_error(
+    BACNET_PORT_TYPE port_type, BACNET_DATALINK_STATS_ERROR error)
+{
+    BACNET_DATALINK_PORT_STATS *stats;
+
+    if (port_type >= DATALINK_STATS_PORT_TYPES) {
+        return;
+    }
+    stats = &Datalink_Stats[port_type];
+    switch (error) {
+        case DATALINK_STATS_RX_DROPPED:
+            stats->rx_dropped++;
+            break;
+        case DATALINK_STATS_TX_DROPPED:
+            stats->tx_dropped++;
+            break;
+        case DATALINK_STATS_CRC_ERROR:
+            stats->crc_errors++;
+            break;
+        case DATALINK_STATS_OVERSIZE_FRAME:
+            stats->oversize_frames++;
+            break;
+        case DATALINK_STATS_BVLC_NAK:
+            stats->bvlc_naks++;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Determine if a property is one of the proprietary Network Port
+ *  object properties of the counters
+ * @param property - property identifier
+ * @return true if the property shows a counter
+ */
+bool datalink_stats_property(uint32_t property)
+{
+    return ((property >= PROP_DATALINK_STATS_RX_PACKETS) &&
+        (property <= PROP_DATALINK_STATS_BVLC_NAKS));
+}
+
+/**
+ * @brief Encode one of the proprietary Network Port object properties
+ *  of the counters
+ * @param port_type - the Network_Type of the Network Port object
+ * @param property - property identifier of the counter
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @return number of octets encoded
+ */
+int datalink_stats_property_encode(
+    BACNET_PORT_TYPE port_type, uint32_t property, uint8_t *apdu)
+{
+    BACNET_DATALINK_PORT_STATS stats = { 0 };
+    uint32_t value = 0;
+
+    (void)datalink_stats(port_type, &stats);
+    switch (property) {
+        case PROP_DATALINK_STATS_RX_PACKETS:
+            value = stats.rx_packets;
+            break;
+        case PROP_DATALINK_STATS_RX_OCTETS:
+            value = stats.rx_octets;
+            break;
+        case PROP_DATALINK_STATS_TX_PACKETS:
+            value = stats.tx_packets;
+            break;
+        case PROP_DATALINK_STATS_TX_OCTETS:
+            value = stats.tx_octets;
+            break;
+        case PROP_DATALINK_STATS_RX_DROPPED:
+            value = stats.rx_dropped;
+            break;
+        case PROP_DATALINK_STATS_TX_DROPPED:
+            value = stats.tx_dropped;
+            break;
+        case PROP_DATALINK_STATS_CRC_ERRORS:
+            value = stats.crc_errors;
+            break;
+        case PROP_DATALINK_STATS_OVERSIZE_FRAMES:
+            value = stats.oversize_frames;
+            break;
+        case PROP_DATALINK_STATS_BVLC_NAKS:
+            value = stats.bvlc_naks;
+            break;
+        default:
+            break;
+    }
+
+    return encode_application_unsigned(apdu, value);
+}
+#endif
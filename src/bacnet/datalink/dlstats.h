@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief API for optional counters of the datalink layers: packets and
+ *  octets received and sent, packets dropped, CRC errors, oversize frames,
+ *  and BVLC NAKs, kept for each type of network port.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DataLink
+ */
+#ifndef BACNET_DATALINK_STATS_H
+#define BACNET_DATALINK_STATS_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+
+/* 1 to count the packets of the datalink layers.
+   0 removes the counters and their calls from the datalink layers. */
+#ifndef BACNET_DATALINK_STATS
+#define BACNET_DATALINK_STATS 0
+#endif
+/* 1 to show the counters as proprietary properties of the Network Port
+   object, using the counters of the Network_Type of the object */
+#ifndef BACNET_DATALINK_STATS_PROPERTIES
+#define BACNET_DATALINK_STATS_PROPERTIES BACNET_DATALINK_STATS
+#endif
+/* first of the proprietary Network Port object properties, each of which
+   is an Unsigned with the value of one counter */
+#ifndef BACNET_DATALINK_STATS_PROPERTY_BASE
+#define BACNET_DATALINK_STATS_PROPERTY_BASE 9100
+#endif
+#define PROP_DATALINK_STATS_RX_PACKETS (BACNET_DATALINK_STATS_PROPERTY_BASE + 0)
+#define PROP_DATALINK_STATS_RX_OCTETS (BACNET_DATALINK_STATS_PROPERTY_BASE + 1)
+#define PROP_DATALINK_STATS_TX_PACKETS (BACNET_DATALINK_STATS_PROPERTY_BASE + 2)
+#define PROP_DATALINK_STATS_TX_OCTETS (BACNET_DATALINK_STATS_PROPERTY_BASE + 3)
+#define PROP_DATALINK_STATS_RX_DROPPED (BACNET_DATALINK_STATS_PROPERTY_BASE + 4)
+#define PROP_DATALINK_STATS_TX_DROPPED (BACNET_DATALINK_STATS_PROPERTY_BASE + 5)
+#define PROP_DATALINK_STATS_CRC_ERRORS (BACNET_DATALINK_STATS_PROPERTY_BASE + 6)
+#define PROP_DATALINK_STATS_OVERSIZE_FRAMES \
+    (BACNET_DATALINK_STATS_PROPERTY_BASE + 7)
+#define PROP_DATALINK_STATS_BVLC_NAKS (BACNET_DATALINK_STATS_PROPERTY_BASE + 8)
+
+/* the kinds of errors counted by datalink_stats_error() */
+typedef enum bacnet_datalink_stats_error {
+    /* a received packet that was not passed up, such as one that was
+       not for BACnet or did not fit in a full receive queue */
+    DATALINK_STATS_RX_DROPPED = 0,
+    /* a packet that could not be sent, or did not fit in a full
+       transmit queue */
+    DATALINK_STATS_TX_DROPPED = 1,
+    /* a received frame with a bad header or data CRC */
+    DATALINK_STATS_CRC_ERROR = 2,
+    /* a received frame longer than the receive buffer */
+    DATALINK_STATS_OVERSIZE_FRAME = 3,
+    /* a BVLC-Result with a NAK result code, received or sent */
+    DATALINK_STATS_BVLC_NAK = 4
+} BACNET_DATALINK_STATS_ERROR;
+
+/* counters of one type of datalink */
+typedef struct bacnet_datalink_port_stats {
+    /* packets received and sent, and their octets */
+    uint32_t rx_packets;
+    uint32_t rx_octets;
+    uint32_t tx_packets;
+    uint32_t tx_octets;
+    /* packets that were dropped */
+    uint32_t rx_dropped;
+    uint32_t tx_dropped;
+    /* frames received with errors */
+    uint32_t crc_errors;
+    uint32_t oversize_frames;
+    /* BVLC-Result NAKs */
+    uint32_t bvlc_naks;
+} BACNET_DATALINK_PORT_STATS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if BACNET_DATALINK_STATS
+BACNET_STACK_EXPORT
+bool datalink_stats(
+    BACNET_PORT_TYPE port_type, BACNET_DATALINK_PORT_STATS *stats);
+BACNET_STACK_EXPORT
+void datalink_stats_reset(BACNET_PORT_TYPE port_type);
+
+BACNET_STACK_EXPORT
+bool datalink_stats_property(uint32_t property);
+BACNET_STACK_EXPORT
+int datalink_stats_property_encode(
+    BACNET_PORT_TYPE port_type, uint32_t property, uint8_t *apdu);
+
+BACNET_STACK_EXPORT
+void datalink_stats_received(BACNET_PORT_TYPE port_type, uint32_t octets);
+BACNET_STACK_EXPORT
+void datalink_stats_sent(BACNET_PORT_TYPE port_type, uint32_t octets);
+BACNET_STACK_EXPORT
+void datalink_stats_error(
+    BACNET_PORT_TYPE port_type, BACNET_DATALINK_STATS_ERROR error);
+#else
+/* the datalink layers call these without checking BACNET_DATALINK_STATS */
+#define datalink_stats_received(port_type, octets) \
+    ((void)(port_type), (void)(octets))
+#define datalink_stats_sent(port_type, octets) \
+    ((void)(port_type), (void)(octets))
+#define datalink_stats_error(port_type, error) \
+    ((void)(port_type), (void)(error))
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
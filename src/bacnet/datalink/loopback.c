@@ -0,0 +1,354 @@
+/**
+ * @file
+ * @brief BACnet in-memory loopback datalink: a network of virtual nodes
+ *  in one process, each with a ring buffer of the packets sent to it
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @ingroup DLLoopback
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacenum.h"
+#include "bacnet/basic/sys/ringbuf.h"
+#include "bacnet/datalink/dlstats.h"
+#include "bacnet/basic/sys/trace.h"
+#include "bacnet/datalink/loopback.h"
+
+/* one packet in the queue of a node */
+struct loopback_packet {
+    uint8_t src_mac;
+    uint16_t pdu_len;
+    uint8_t pdu[LOOPBACK_MPDU_MAX];
+};
+
+/* one virtual node on the loopback network */
+struct loopback_node {
+    bool attached;
+    uint8_t mac;
+    RING_BUFFER queue;
+    struct loopback_packet packets[LOOPBACK_QUEUE_SIZE];
+};
+
+static struct loopback_node Loopback_Nodes[LOOPBACK_NODES_MAX];
+/* the node that sends and receives, or NULL before loopback_init() */
+static struct loopback_node *Loopback_Node;
+static LOOPBACK_STATS Loopback_Stats;
+
+/**
+ * @brief Find an attached node by its MAC address
+ * @param mac - MAC address of the node
+ * @return the node, or NULL if not found
+ */
+static struct loopback_node *loopback_node_find(uint8_t mac)
+{
+    unsigned i;
+
+    for (i = 0; i < LOOPBACK_NODES_MAX; i++) {
+        if (Loopback_Nodes[i].attached && (Loopback_Nodes[i].mac == mac)) {
+            return &Loopback_Nodes[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Attach a node to the loopback network, with an empty queue
+ * @param mac - MAC address of the node
+ * @return the node, or NULL if all of the nodes are attached
+ */
+static struct loopback_node *loopback_node_attach(uint8_t mac)
+{
+    struct loopback_node *node;
+    unsigned i;
+
+    for (i = 0; i < LOOPBACK_NODES_MAX; i++) {
+        node = &Loopback_Nodes[i];
+        if (!node->attached) {
+            node->attached = true;
+            node->mac = mac;
+            Ringbuf_Init(&node->queue, (volatile uint8_t *)node->packets,
+                sizeof(node->packets[0]), LOOPBACK_QUEUE_SIZE);
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Choose the node that sends and receives, and attach it to the
+ *  loopback network if it was not attached
+ * @param mac - MAC address of the node, 0..254
+ * @return true if the node was chosen, or false if the MAC address is
+ *  the broadcast address or all of the nodes are attached
+ */
+bool loopback_node_set(uint8_t mac)
+{
+    struct loopback_node *node;
+
+    if (mac == LOOPBACK_BROADCAST_ADDRESS) {
+        return false;
+    }
+    node = loopback_node_find(mac);
+    if (!node) {
+        node = loopback_node_attach(mac);
+        if (!node) {
+            return false;
+        }
+    }
+    Loopback_Node = node;
+
+    return true;
+}
+
+/**
+ * @brief Get the MAC address of the node that sends and receives
+ * @return MAC address, or LOOPBACK_BROADCAST_ADDRESS if there is none
+ */
+uint8_t loopback_node(void)
+{
+    if (Loopback_Node) {
+        return Loopback_Node->mac;
+    }
+
+    return LOOPBACK_BROADCAST_ADDRESS;
+}
+
+/**
+ * @brief Get the number of nodes attached to the loopback network
+ * @return number of nodes
+ */
+unsigned loopback_node_count(void)
+{
+    unsigned i, count = 0;
+
+    for (i = 0; i < LOOPBACK_NODES_MAX; i++) {
+        if (Loopback_Nodes[i].attached) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the number of packets waiting in the queue of a node
+ * @param mac - MAC address of the node
+ * @return number of packets, or 0 if the node is not attached
+ */
+unsigned loopback_pending(uint8_t mac)
+{
+    struct loopback_node *node;
+
+    node = loopback_node_find(mac);
+    if (node) {
+        return Ringbuf_Count(&node->queue);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Initialize the loopback datalink, and choose the node that
+ *  sends and receives
+ * @param ifname - MAC address of the node as a decimal number such as
+ *  "5", or NULL for LOOPBACK_MAC_DEFAULT
+ * @return true if the node was chosen
+ */
+bool loopback_init(char *ifname)
+{
+    unsigned long mac = LOOPBACK_MAC_DEFAULT;
+    char *end = NULL;
+
+    if (ifname && ifname[0]) {
+        mac = strtoul(ifname, &end, 0);
+        if ((end == ifname) || (*end != 0) ||
+            (mac >= LOOPBACK_BROADCAST_ADDRESS)) {
+            return false;
+        }
+    }
+
+    return loopback_node_set((uint8_t)mac);
+}
+
+/**
+ * @brief Detach all of the nodes, and drop the packets in their queues
+ */
+void loopback_cleanup(void)
+{
+    memset(Loopback_Nodes, 0, sizeof(Loopback_Nodes));
+    Loopback_Node = NULL;
+}
+
+/**
+ * @brief Put a copy of a packet in the queue of a node
+ * @param node - node that receives the packet
+ * @param src_mac - MAC address of the node that sent the packet
+ * @param pdu - the packet
+ * @param pdu_len - number of octets of the packet
+ */
+static void loopback_deliver(struct loopback_node *node,
+    uint8_t src_mac,
+    const uint8_t *pdu,
+    uint16_t pdu_len)
+{
+    struct loopback_packet *packet;
+
+    packet = (struct loopback_packet *)(void *)Ringbuf_Data_Peek(&node->queue);
+    if (!packet) {
+        Loopback_Stats.dropped++;
+        datalink_stats_error(PORT_TYPE_VIRTUAL, DATALINK_STATS_TX_DROPPED);
+        return;
+    }
+    packet->src_mac = src_mac;
+    packet->pdu_len = pdu_len;
+    memcpy(packet->pdu, pdu, pdu_len);
+    (void)Ringbuf_Data_Put(&node->queue, (volatile uint8_t *)packet);
+    Loopback_Stats.delivered++;
+}
+
+/**
+ * @brief Send a packet from the chosen node. A packet for a MAC address
+ *  of a node that is not attached is lost, as it would be on a wire.
+ * @param dest - destination address, where a MAC length of zero or the
+ *  LOOPBACK_BROADCAST_ADDRESS sends to all of the other nodes
+ * @param npdu_data - network information, unused
+ * @param pdu - the packet
+ * @param pdu_len - number of octets of the packet
+ * @return number of octets sent, or -1 if no node was chosen or the
+ *  packet is too large
+ */
+int loopback_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    struct loopback_node *node;
+    unsigned i;
+
+    (void)npdu_data;
+    if (!Loopback_Node || !dest || !pdu || (pdu_len > LOOPBACK_MPDU_MAX)) {
+        Loopback_Stats.dropped++;
+        datalink_stats_error(PORT_TYPE_VIRTUAL, DATALINK_STATS_TX_DROPPED);
+        return -1;
+    }
+    Loopback_Stats.sent++;
+    datalink_stats_sent(PORT_TYPE_VIRTUAL, pdu_len);
+    BACNET_TRACE(NPDU_TX, dest->net, pdu_len);
+    if ((dest->mac_len == 0) || (dest->mac[0] == LOOPBACK_BROADCAST_ADDRESS)) {
+        for (i = 0; i < LOOPBACK_NODES_MAX; i++) {
+            node = &Loopback_Nodes[i];
+            if (node->attached && (node != Loopback_Node)) {
+                loopback_deliver(
+                    node, Loopback_Node->mac, pdu, (uint16_t)pdu_len);
+            }
+        }
+    } else {
+        node = loopback_node_find(dest->mac[0]);
+        if (node) {
+            loopback_deliver(node, Loopback_Node->mac, pdu, (uint16_t)pdu_len);
+        }
+    }
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Take the next packet from the queue of the chosen node
+ * @param src - source address of the packet
+ * @param pdu - buffer for the packet
+ * @param max_pdu - size of the buffer
+ * @param timeout - unused: no packet can arrive while this thread waits,
+ *  so the queue is only checked
+ * @return number of octets of the packet, or 0 if there is none
+ */
+uint16_t loopback_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    struct loopback_packet *packet;
+    uint16_t pdu_len = 0;
+
+    (void)timeout;
+    if (!Loopback_Node) {
+        return 0;
+    }
+    packet = (struct loopback_packet *)(void *)Ringbuf_Peek(
+        &Loopback_Node->queue);
+    if (!packet) {
+        return 0;
+    }
+    if (packet->pdu_len > max_pdu) {
+        Loopback_Stats.dropped++;
+        datalink_stats_error(PORT_TYPE_VIRTUAL, DATALINK_STATS_OVERSIZE_FRAME);
+    } else {
+        pdu_len = packet->pdu_len;
+        memcpy(pdu, packet->pdu, pdu_len);
+        if (src) {
+            memset(src, 0, sizeof(*src));
+            src->mac_len = 1;
+            src->mac[0] = packet->src_mac;
+        }
+        Loopback_Stats.received++;
+        datalink_stats_received(PORT_TYPE_VIRTUAL, pdu_len);
+    }
+    (void)Ringbuf_Pop(&Loopback_Node->queue, NULL);
+
+    return pdu_len;
+}
+
+/**
+ * @brief Get the address of the chosen node
+ * @param my_address - the address, with a MAC length of zero if no node
+ *  was chosen
+ */
+void loopback_get_my_address(BACNET_ADDRESS *my_address)
+{
+    if (!my_address) {
+        return;
+    }
+    memset(my_address, 0, sizeof(*my_address));
+    if (Loopback_Node) {
+        my_address->mac_len = 1;
+        my_address->mac[0] = Loopback_Node->mac;
+    }
+}
+
+/**
+ * @brief Get the broadcast address of the loopback network
+ * @param dest - the broadcast address
+ */
+void loopback_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    if (!dest) {
+        return;
+    }
+    memset(dest, 0, sizeof(*dest));
+    dest->mac_len = 1;
+    dest->mac[0] = LOOPBACK_BROADCAST_ADDRESS;
+    dest->net = BACNET_BROADCAST_NETWORK;
+}
+
+/**
+ * @brief Get the counters of the loopback network
+ * @param stats - the counters
+ */
+void loopback_stats(LOOPBACK_STATS *stats)
+{
+    if (stats) {
+        memcpy(stats, &Loopback_Stats, sizeof(*stats));
+    }
+}
+
+/**
+ * @brief Set the counters of the loopback network to zero
+ */
+void loopback_stats_reset(void)
+{
+    memset(&Loopback_Stats, 0, sizeof(Loopback_Stats));
+}
@@ -0,0 +1,97 @@
+/**
+ * @file
+ * @brief BACnet in-memory loopback datalink interface and defines
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @defgroup DLLoopback BACnet Loopback DataLink Network Layer
+ * @ingroup DataLink
+ *
+ * The loopback datalink is a network of virtual nodes in one process.
+ * Each node has a one octet MAC address, 0..254, and a queue of the
+ * packets that were sent to it. The node that sends and receives is chosen with
+ * loopback_node_set(), so that a client and one or more server loops
+ * can take turns in one thread, at the speed of the stack alone.
+ */
+#ifndef BACNET_LOOPBACK_H
+#define BACNET_LOOPBACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/npdu.h"
+
+/* number of virtual nodes on the loopback network */
+#ifndef LOOPBACK_NODES_MAX
+#define LOOPBACK_NODES_MAX 8
+#endif
+/* number of packets queued for each node - must be a power of two */
+#ifndef LOOPBACK_QUEUE_SIZE
+#define LOOPBACK_QUEUE_SIZE 16
+#endif
+/* MAC address of the node chosen by loopback_init() without a name */
+#ifndef LOOPBACK_MAC_DEFAULT
+#define LOOPBACK_MAC_DEFAULT 1
+#endif
+
+/* MAC address that sends to all of the other nodes */
+#define LOOPBACK_BROADCAST_ADDRESS 0xFF
+/* there is no framing: the MPDU is the NPDU */
+#define LOOPBACK_MPDU_MAX (MAX_PDU)
+
+/* counters of the loopback network */
+typedef struct loopback_stats {
+    /* packets given to loopback_send_pdu() */
+    uint32_t sent;
+    /* packets put in the queue of a node, once for each node of a
+       broadcast */
+    uint32_t delivered;
+    /* packets taken from a queue by loopback_receive() */
+    uint32_t received;
+    /* packets that did not fit in a full queue, or were too large */
+    uint32_t dropped;
+} LOOPBACK_STATS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+bool loopback_init(char *ifname);
+BACNET_STACK_EXPORT
+void loopback_cleanup(void);
+
+BACNET_STACK_EXPORT
+bool loopback_node_set(uint8_t mac);
+BACNET_STACK_EXPORT
+uint8_t loopback_node(void);
+BACNET_STACK_EXPORT
+unsigned loopback_node_count(void);
+BACNET_STACK_EXPORT
+unsigned loopback_pending(uint8_t mac);
+
+BACNET_STACK_EXPORT
+int loopback_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len);
+BACNET_STACK_EXPORT
+uint16_t loopback_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout);
+
+BACNET_STACK_EXPORT
+void loopback_get_my_address(BACNET_ADDRESS *my_address);
+BACNET_STACK_EXPORT
+void loopback_get_broadcast_address(BACNET_ADDRESS *dest);
+
+BACNET_STACK_EXPORT
+void loopback_stats(LOOPBACK_STATS *stats);
+BACNET_STACK_EXPORT
+void loopback_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
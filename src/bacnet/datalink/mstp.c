@@ -30,9 +30,11 @@
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstp.h"
 #include "bacnet/datalink/crc.h"
+#include "bacnet/datalink/dlstats.h"
 #include "bacnet/datalink/mstptext.h"
 #include "bacnet/npdu.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/trace.h"
 
 #if PRINT_ENABLED
 #undef PRINT_ENABLED_RECEIVE
@@ -107,6 +109,35 @@ bool MSTP_Line_Active(struct mstp_port_struct_t *mstp_port)
     return (mstp_port->EventCount > Nmin_octets);
 }
 
+/**
+ * @brief A policy for the Reply_Postpone function of a port: the reply to
+ *  a Data Expecting Reply frame whose NPDU is routed to another network,
+ *  by a router, is not available within Treply_delay, so that the Reply
+ *  Postponed frame is sent at once rather than after Treply_delay.
+ * @param mstp_port - port specific data, with the received frame
+ * @return true if the NPDU of the received frame has a DNET
+ */
+bool MSTP_Reply_Postpone_Routed(struct mstp_port_struct_t *mstp_port)
+{
+    if (!mstp_port || !mstp_port->InputBuffer) {
+        return false;
+    }
+    if ((mstp_port->FrameType != FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY) &&
+        (mstp_port->FrameType !=
+            FRAME_TYPE_BACNET_EXTENDED_DATA_EXPECTING_REPLY)) {
+        return false;
+    }
+    if (mstp_port->DataLength < 2) {
+        return false;
+    }
+    if (mstp_port->InputBuffer[0] != BACNET_PROTOCOL_VERSION) {
+        return false;
+    }
+
+    /* the control octet has the DNET, DLEN, DADR, and hop count */
+    return (mstp_port->InputBuffer[1] & BIT(5)) ? true : false;
+}
+
 void MSTP_Fill_BACnet_Address(BACNET_ADDRESS *src, uint8_t mstp_address)
 {
     int i = 0;
@@ -189,7 +220,11 @@ uint16_t MSTP_Create_Frame(uint8_t *buffer,
             /* I'm sorry, Dave, I'm afraid I can't do that. */
             return 0;
         }
-        cobs_len = cobs_frame_encode(&buffer[8], buffer_size-8, data,
+        if (!data || (buffer_size < 8)) {
+            return 0;
+        }
+        /* encode directly into the data field of the frame */
+        cobs_len = cobs_frame_encode(&buffer[8], buffer_size - 8, data,
             data_len);
         /* check the results of COBs encoding for validity */
         if (cobs_bacnet_frame) {
@@ -217,10 +252,9 @@ uint16_t MSTP_Create_Frame(uint8_t *buffer,
         if ((8 + data_len + 2) > buffer_size) {
              return 0;
         }
-        for (index = 8; index < (data_len + 8); index++, data++) {
-            buffer[index] = *data;
-            crc16 = CRC_Calc_Data(buffer[index], crc16);
-        }
+        memmove(&buffer[8], data, data_len);
+        crc16 = CRC_Calc_Data_Buffer(&buffer[8], data_len, crc16);
+        index = 8 + data_len;
         crc16 = ~crc16;
         buffer[index] = crc16 & 0xFF; /* LSB first */
         buffer[index+1] = crc16 >> 8;
@@ -228,15 +262,11 @@ uint16_t MSTP_Create_Frame(uint8_t *buffer,
     buffer[0] = 0x55;
     buffer[1] = 0xFF;
     buffer[2] = frame_type;
-    crc8 = CRC_Calc_Header(buffer[2], crc8);
     buffer[3] = destination;
-    crc8 = CRC_Calc_Header(buffer[3], crc8);
     buffer[4] = source;
-    crc8 = CRC_Calc_Header(buffer[4], crc8);
     buffer[5] = data_len >> 8; /* MSB first */
-    crc8 = CRC_Calc_Header(buffer[5], crc8);
     buffer[6] = data_len & 0xFF;
-    crc8 = CRC_Calc_Header(buffer[6], crc8);
+    crc8 = CRC_Calc_Header_Buffer(&buffer[2], 5, crc8);
     buffer[7] = ~crc8;
     index = 8;
     if (data_len > 0) {
@@ -267,6 +297,11 @@ void MSTP_Create_And_Send_Frame(struct mstp_port_struct_t *mstp_port,
     len =
         MSTP_Create_Frame(mstp_port->OutputBuffer, mstp_port->OutputBufferSize,
             frame_type, destination, source, data, data_len);
+    if (frame_type == FRAME_TYPE_TOKEN) {
+        BACNET_TRACE(MSTP_TOKEN_TX, destination, mstp_port->TokenCount);
+    } else if (frame_type == FRAME_TYPE_POLL_FOR_MASTER) {
+        BACNET_TRACE(MSTP_POLL_FOR_MASTER, destination, source);
+    }
 
     MSTP_Send_Frame(mstp_port, (uint8_t *)&mstp_port->OutputBuffer[0], len);
     /* FIXME: be sure to reset SilenceTimer() after each octet is sent! */
@@ -420,6 +455,8 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                         mstp_port->ReceivedInvalidFrame = true;
                         printf_receive_error("MSTP: Rx Header: BadCRC [%02X]\n",
                             mstp_port->DataRegister);
+                        datalink_stats_error(
+                            PORT_TYPE_MSTP, DATALINK_STATS_CRC_ERROR);
                         /* wait for the start of the next frame. */
                         mstp_port->receive_state = MSTP_RECEIVE_STATE_IDLE;
                     } else {
@@ -458,6 +495,8 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                                     printf_receive_error(
                                         "MSTP: Rx Header: FrameTooLong %u\n",
                                         (unsigned)mstp_port->DataLength);
+                                    datalink_stats_error(PORT_TYPE_MSTP,
+                                        DATALINK_STATS_OVERSIZE_FRAME);
                                     mstp_port->receive_state =
                                         MSTP_RECEIVE_STATE_SKIP_DATA;
                                 }
@@ -546,17 +585,21 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                     mstp_port->DataCRCActualLSB = mstp_port->DataRegister;
                     printf_receive_data("%s",
                         mstptext_frame_type((unsigned)mstp_port->FrameType));
-                    if (((mstp_port->Index + 1) < mstp_port->InputBufferSize) &&
+                    if ((mstp_port->Index < mstp_port->InputBufferSize) &&
                         (mstp_port->FrameType >= Nmin_COBS_type) &&
                         (mstp_port->FrameType <= Nmax_COBS_type)) {
+                        /* decode in place, so that the client data
+                           starts at the front of the input buffer */
                         mstp_port->DataLength = cobs_frame_decode(
-                            &mstp_port->InputBuffer[mstp_port->Index + 1],
+                            mstp_port->InputBuffer,
                             mstp_port->InputBufferSize,
                             mstp_port->InputBuffer, mstp_port->Index + 1);
                         if (mstp_port->DataLength > 0) {
                             mstp_port->ReceivedValidFrame = true;
                         } else {
                             mstp_port->ReceivedInvalidFrame = true;
+                            datalink_stats_error(
+                                PORT_TYPE_MSTP, DATALINK_STATS_CRC_ERROR);
                         }
                     } else {
                         /* STATE DATA CRC - no need for new state */
@@ -569,6 +612,8 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
                             printf_receive_error(
                                 "MSTP: Rx Data: BadCRC [%02X]\n",
                                 mstp_port->DataRegister);
+                            datalink_stats_error(
+                                PORT_TYPE_MSTP, DATALINK_STATS_CRC_ERROR);
                         }
                     }
                     mstp_port->receive_state = MSTP_RECEIVE_STATE_IDLE;
@@ -593,6 +638,169 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
     return;
 }
 
+/**
+ * @brief Finite State Machine for receiving an MSTP frame from a block of
+ *  received octets, such as from the DMA buffer of a UART, which stops
+ *  at the end of a frame so that the node state machines can run.
+ *  The octets of the data portion of a frame are consumed as one run,
+ *  without the state dispatch for each octet.
+ * @param mstp_port MSTP port context data
+ * @param data - the received octets
+ * @param length - number of received octets, which can be 0 to process
+ *  the timeouts of the receive state machine
+ * @return number of octets consumed
+ */
+uint16_t MSTP_Receive_Frame_FSM_Block(
+    struct mstp_port_struct_t *mstp_port, const uint8_t *data, uint16_t length)
+{
+    uint16_t count = 0;
+    uint16_t run = 0;
+    uint16_t copy = 0;
+    uint16_t crc = 0;
+    uint16_t i = 0;
+
+    if (!data || (length == 0)) {
+        MSTP_Receive_Frame_FSM(mstp_port);
+        return 0;
+    }
+    while ((count < length) && !mstp_port->ReceivedValidFrame &&
+        !mstp_port->ReceivedInvalidFrame) {
+        if (((mstp_port->receive_state == MSTP_RECEIVE_STATE_DATA) ||
+                (mstp_port->receive_state == MSTP_RECEIVE_STATE_SKIP_DATA)) &&
+            (mstp_port->Index < mstp_port->DataLength) &&
+            !mstp_port->ReceiveError &&
+            (mstp_port->SilenceTimer((void *)mstp_port) <=
+                mstp_port->Tframe_abort)) {
+            /* DataOctet, for a run of octets */
+            run = mstp_port->DataLength - mstp_port->Index;
+            if (run > (length - count)) {
+                run = length - count;
+            }
+            crc = mstp_port->DataCRC;
+            for (i = 0; i < run; i++) {
+                crc = CRC_Calc_Data(data[count + i], crc);
+            }
+            mstp_port->DataCRC = crc;
+            if ((mstp_port->receive_state == MSTP_RECEIVE_STATE_DATA) &&
+                (mstp_port->Index < mstp_port->InputBufferSize)) {
+                copy = mstp_port->InputBufferSize - mstp_port->Index;
+                if (copy > run) {
+                    copy = run;
+                }
+                memcpy(&mstp_port->InputBuffer[mstp_port->Index],
+                    &data[count], copy);
+            }
+            mstp_port->Index += run;
+            count += run;
+            mstp_port->SilenceTimerReset((void *)mstp_port);
+        } else {
+            mstp_port->DataRegister = data[count];
+            mstp_port->DataAvailable = true;
+            MSTP_Receive_Frame_FSM(mstp_port);
+            if (mstp_port->DataAvailable) {
+                /* a timeout or error came first: the octet is given
+                   again to the next state */
+                mstp_port->DataAvailable = false;
+            } else {
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the number of information frames this node may send
+ *  during the current token hold
+ * @param mstp_port MSTP port context data
+ * @return the adaptive window when enabled, otherwise Nmax_info_frames
+ */
+static uint8_t MSTP_Info_Frames_Max(const struct mstp_port_struct_t *mstp_port)
+{
+    if ((mstp_port->Nmax_info_frames_limit > mstp_port->Nmax_info_frames) &&
+        (mstp_port->Info_Frames_Window > mstp_port->Nmax_info_frames)) {
+        return mstp_port->Info_Frames_Window;
+    }
+
+    return mstp_port->Nmax_info_frames;
+}
+
+/**
+ * @brief Size the adaptive information frame window for a new token hold.
+ *  The window doubles while the node fills it on every token hold, and
+ *  falls back to Nmax_info_frames once the node runs out of frames.
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Info_Frames_Adapt(struct mstp_port_struct_t *mstp_port)
+{
+    unsigned window;
+
+    if (mstp_port->Nmax_info_frames_limit <= mstp_port->Nmax_info_frames) {
+        mstp_port->Info_Frames_Window = mstp_port->Nmax_info_frames;
+    } else if (mstp_port->Info_Frames_Backlog) {
+        window = MSTP_Info_Frames_Max(mstp_port);
+        if (window == 0) {
+            window = 1;
+        }
+        window *= 2;
+        if (window > mstp_port->Nmax_info_frames_limit) {
+            window = mstp_port->Nmax_info_frames_limit;
+        }
+        mstp_port->Info_Frames_Window = (uint8_t)window;
+    } else {
+        mstp_port->Info_Frames_Window = mstp_port->Nmax_info_frames;
+    }
+    mstp_port->Info_Frames_Backlog = false;
+}
+
+/**
+ * @brief Record whether a master station answered its Poll For Master
+ * @param mstp_port MSTP port context data
+ * @param station MAC address of the station
+ * @param absent true if the station did not reply
+ */
+static void MSTP_Poll_Absent_Set(
+    struct mstp_port_struct_t *mstp_port, uint8_t station, bool absent)
+{
+    if (station <= DEFAULT_MAX_MASTER) {
+        if (absent) {
+            mstp_port->Poll_Absent[station / 8] |=
+                (uint8_t)(1 << (station % 8));
+        } else {
+            mstp_port->Poll_Absent[station / 8] &=
+                (uint8_t)~(1 << (station % 8));
+        }
+    }
+}
+
+/**
+ * @brief Get the next station for the maintenance Poll For Master.
+ *  When skipping is enabled, the stations that did not reply to their
+ *  last poll are skipped except on every Npoll_absent-th cycle.
+ *  The search never passes Next_Station or This_Station.
+ * @param mstp_port MSTP port context data
+ * @return MAC address of the next station to poll
+ */
+static uint8_t MSTP_Poll_Station_Next(
+    const struct mstp_port_struct_t *mstp_port)
+{
+    uint8_t station;
+    bool skip;
+
+    station = (mstp_port->Poll_Station + 1) % (mstp_port->Nmax_master + 1);
+    skip = (mstp_port->Npoll_absent > 1) &&
+        ((mstp_port->Poll_Absent_Cycle % mstp_port->Npoll_absent) != 0);
+    while (skip && (station != mstp_port->Next_Station) &&
+        (station != mstp_port->This_Station) &&
+        (station <= DEFAULT_MAX_MASTER) &&
+        (mstp_port->Poll_Absent[station / 8] & (1 << (station % 8)))) {
+        station = (station + 1) % (mstp_port->Nmax_master + 1);
+    }
+
+    return station;
+}
+
 /**
  * @brief Finite State Machine for receiving an MSTP frame
  * @param mstp_port MSTP port context data
@@ -665,6 +873,8 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     mstp_port->DataLength, mstp_port->FrameCount,
                     mstp_port->SilenceTimer((void *)mstp_port),
                     mstptext_frame_type((unsigned)mstp_port->FrameType));
+                MSTP_Poll_Absent_Set(
+                    mstp_port, mstp_port->SourceAddress, false);
                 if (mstp_port->SourceAddress == mstp_port->This_Station) {
                     /* DuplicateNode */
                     if (mstp_port->ZeroConfigEnabled) {
@@ -684,8 +894,12 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                                 MSTP_BROADCAST_ADDRESS) {
                                 break;
                             }
+                            BACNET_TRACE(MSTP_TOKEN_RX,
+                                mstp_port->SourceAddress,
+                                mstp_port->This_Station);
                             mstp_port->ReceivedValidFrame = false;
                             mstp_port->FrameCount = 0;
+                            MSTP_Info_Frames_Adapt(mstp_port);
                             mstp_port->SoleMaster = false;
                             mstp_port->master_state =
                                 MSTP_MASTER_STATE_USE_TOKEN;
@@ -754,6 +968,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 Tno_token) {
                 /* LostToken */
                 /* assume that the token has been lost */
+                BACNET_TRACE(MSTP_TOKEN_LOST, mstp_port->This_Station, 0);
                 mstp_port->EventCount = 0; /* Addendum 135-2004d-8 */
                 mstp_port->master_state = MSTP_MASTER_STATE_NO_TOKEN;
                 /* set the receive frame flags to false in case we received
@@ -771,7 +986,8 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             length = (unsigned)MSTP_Get_Send(mstp_port, 0);
             if (length < 1) {
                 /* NothingToSend */
-                mstp_port->FrameCount = mstp_port->Nmax_info_frames;
+                mstp_port->FrameCount = MSTP_Info_Frames_Max(mstp_port);
+                mstp_port->Info_Frames_Backlog = false;
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 transition_now = true;
             } else {
@@ -780,6 +996,10 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 MSTP_Send_Frame(mstp_port,
                     (uint8_t *)&mstp_port->OutputBuffer[0], (uint16_t)length);
                 mstp_port->FrameCount++;
+                if (mstp_port->FrameCount >= MSTP_Info_Frames_Max(mstp_port)) {
+                    /* the window was used up with frames still queued */
+                    mstp_port->Info_Frames_Backlog = true;
+                }
                 switch (frame_type) {
                     case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
                         if (destination == MSTP_BROADCAST_ADDRESS) {
@@ -814,7 +1034,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 mstp_port->Treply_timeout) {
                 /* ReplyTimeout */
                 /* assume that the request has failed */
-                mstp_port->FrameCount = mstp_port->Nmax_info_frames;
+                mstp_port->FrameCount = MSTP_Info_Frames_Max(mstp_port);
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 /* Any retry of the data frame shall await the next entry */
                 /* to the USE_TOKEN state. (Because of the length of the
@@ -876,8 +1096,10 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
         case MSTP_MASTER_STATE_DONE_WITH_TOKEN:
             /* The DONE_WITH_TOKEN state either sends another data frame,  */
             /* passes the token, or initiates a Poll For Master cycle. */
+            /* the maintenance poll may skip over stations known absent */
+            next_poll_station = MSTP_Poll_Station_Next(mstp_port);
             /* SendAnotherFrame */
-            if (mstp_port->FrameCount < mstp_port->Nmax_info_frames) {
+            if (mstp_port->FrameCount < MSTP_Info_Frames_Max(mstp_port)) {
                 /* then this node may send another information frame  */
                 /* before passing the token.  */
                 mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
@@ -902,6 +1124,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     /* which the token may be sent (true master-slave
                      * operation).  */
                     mstp_port->FrameCount = 0;
+                    MSTP_Info_Frames_Adapt(mstp_port);
                     mstp_port->TokenCount++;
                     mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
                     transition_now = true;
@@ -926,6 +1149,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             } else if (next_poll_station == mstp_port->Next_Station) {
                 if (mstp_port->SoleMaster == true) {
                     /* SoleMasterRestartMaintenancePFM */
+                    mstp_port->Poll_Absent_Cycle++;
                     mstp_port->Poll_Station = next_next_station;
                     MSTP_Create_And_Send_Frame(mstp_port,
                         FRAME_TYPE_POLL_FOR_MASTER, mstp_port->Poll_Station,
@@ -941,6 +1165,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     mstp_port->master_state = MSTP_MASTER_STATE_POLL_FOR_MASTER;
                 } else {
                     /* ResetMaintenancePFM */
+                    mstp_port->Poll_Absent_Cycle++;
                     mstp_port->Poll_Station = mstp_port->This_Station;
                     /* transmit a Token frame to NS */
                     MSTP_Create_And_Send_Frame(mstp_port, FRAME_TYPE_TOKEN,
@@ -1071,6 +1296,8 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     (mstp_port->FrameType ==
                         FRAME_TYPE_REPLY_TO_POLL_FOR_MASTER)) {
                     /* ReceivedReplyToPFM */
+                    MSTP_Poll_Absent_Set(
+                        mstp_port, mstp_port->SourceAddress, false);
                     mstp_port->SoleMaster = false;
                     mstp_port->Next_Station = mstp_port->SourceAddress;
                     mstp_port->EventCount = 0;
@@ -1095,6 +1322,11 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             } else if ((mstp_port->SilenceTimer((void *)mstp_port) >
                            mstp_port->Tusage_timeout) ||
                 (mstp_port->ReceivedInvalidFrame == true)) {
+                if (mstp_port->ReceivedInvalidFrame == false) {
+                    /* nothing at all was heard from the polled station */
+                    MSTP_Poll_Absent_Set(
+                        mstp_port, mstp_port->Poll_Station, true);
+                }
                 if (mstp_port->SoleMaster == true) {
                     /* SoleMaster */
                     /* There was no valid reply to the periodic poll  */
@@ -1145,9 +1377,9 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             /* The ANSWER_DATA_REQUEST state is entered when a  */
             /* BACnet Data Expecting Reply, a Test_Request, or  */
             /* a proprietary frame that expects a reply is received. */
-            /* FIXME: MSTP_Get_Reply waits for a matching reply, but
-               if the next queued message doesn't match, then we
-               sit here for Treply_delay doing nothing */
+            /* MSTP_Get_Reply is polled for a matching reply until
+               Treply_delay, unless the port knows that the reply
+               will come later, such as for a routed request */
             length = (unsigned)MSTP_Get_Reply(mstp_port, 0);
             if (length > 0) {
                 /* Reply */
@@ -1163,8 +1395,10 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 mstp_port->master_state = MSTP_MASTER_STATE_IDLE;
                 /* clear our flag we were holding for comparison */
                 mstp_port->ReceivedValidFrame = false;
-            } else if (mstp_port->SilenceTimer((void *)mstp_port) >
-                mstp_port->Treply_delay) {
+            } else if ((mstp_port->Reply_Postpone &&
+                           mstp_port->Reply_Postpone(mstp_port)) ||
+                (mstp_port->SilenceTimer((void *)mstp_port) >
+                    mstp_port->Treply_delay)) {
                 /* DeferredReply */
                 /* If no reply will be available from the higher layers */
                 /* within Treply_delay after the reception of the */
@@ -1346,6 +1580,70 @@ unsigned MSTP_Zero_Config_Station_Increment(unsigned station)
     return next_station;
 }
 
+/**
+ * @brief Mark a station address in a zero-configuration bit map
+ * @param map the bit map of 128 station addresses
+ * @param station the station address, ignored when above 127
+ */
+static void MSTP_Zero_Config_Map_Set(uint8_t *map, uint8_t station)
+{
+    if (station <= Nmax_master_station) {
+        map[station / 8] |= (uint8_t)BIT(station % 8);
+    }
+}
+
+/**
+ * @brief Test a station address in a zero-configuration bit map
+ * @param map the bit map of 128 station addresses
+ * @param station the station address
+ * @return true if the station address is marked
+ */
+static bool MSTP_Zero_Config_Map_Test(const uint8_t *map, uint8_t station)
+{
+    if (station <= Nmax_master_station) {
+        return (map[station / 8] & BIT(station % 8)) ? true : false;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Choose the next Zero Configuration Station address using the
+ *  addresses seen on the network.  An address that was polled for master
+ *  and never seen as a source is not in-use, so it is chosen ahead of
+ *  the next address in sequence.  The search starts at an offset from
+ *  the UUID so that nodes starting together choose different addresses.
+ * @param mstp_port the context of the MSTP port
+ * @return the next station address
+ */
+static uint8_t MSTP_Zero_Config_Station_Next(
+    struct mstp_port_struct_t *mstp_port)
+{
+    const unsigned range = (Nmax_poll_station - Nmin_poll_station) + 1;
+    unsigned offset, i;
+    uint8_t station;
+
+    offset = mstp_port->UUID[1] % range;
+    for (i = 0; i < range; i++) {
+        station = Nmin_poll_station + ((offset + i) % range);
+        if (MSTP_Zero_Config_Map_Test(mstp_port->Zero_Config_Polled,
+                station) &&
+            !MSTP_Zero_Config_Map_Test(mstp_port->Zero_Config_Used, station)) {
+            return station;
+        }
+    }
+    /* nothing known to be free: skip the addresses known to be in-use */
+    station = mstp_port->Zero_Config_Station;
+    for (i = 0; i < range; i++) {
+        station = MSTP_Zero_Config_Station_Increment(station);
+        if (!MSTP_Zero_Config_Map_Test(mstp_port->Zero_Config_Used, station)) {
+            return station;
+        }
+    }
+
+    return MSTP_Zero_Config_Station_Increment(mstp_port->Zero_Config_Station);
+}
+
 /**
  * @brief The ZERO_CONFIGURATION_INIT state is entered when
  *  ZeroConfigurationMode is TRUE
@@ -1367,6 +1665,10 @@ static void MSTP_Zero_Config_State_Init(struct mstp_port_struct_t *mstp_port)
     slots = 128 + mstp_port->Npoll_slot;
     mstp_port->Zero_Config_Silence = Tno_token + Tslot * slots;
     mstp_port->Zero_Config_Max_Master = 0;
+    memset(mstp_port->Zero_Config_Used, 0, sizeof(mstp_port->Zero_Config_Used));
+    memset(
+        mstp_port->Zero_Config_Polled, 0,
+        sizeof(mstp_port->Zero_Config_Polled));
     mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_IDLE;
 }
 
@@ -1425,19 +1727,28 @@ static void MSTP_Zero_Config_State_Lurk(struct mstp_port_struct_t *mstp_port)
         dst = mstp_port->DestinationAddress;
         src = mstp_port->SourceAddress;
         frame = mstp_port->FrameType;
+        MSTP_Zero_Config_Map_Set(mstp_port->Zero_Config_Used, src);
         if (frame == FRAME_TYPE_POLL_FOR_MASTER) {
             if ((dst > mstp_port->Zero_Config_Max_Master) &&
                 (dst <= DEFAULT_MAX_MASTER)) {
                 /* LearnMaxMaster */
                 mstp_port->Zero_Config_Max_Master = dst;
             }
+            MSTP_Zero_Config_Map_Set(mstp_port->Zero_Config_Polled, dst);
+            if ((mstp_port->Poll_Count == 0) &&
+                !MSTP_Zero_Config_Map_Test(
+                    mstp_port->Zero_Config_Polled,
+                    mstp_port->Zero_Config_Station)) {
+                /* not yet counting: move to an address known to be free */
+                mstp_port->Zero_Config_Station =
+                    MSTP_Zero_Config_Station_Next(mstp_port);
+            }
         }
         if (src == mstp_port->Zero_Config_Station) {
             /* AddressInUse */
             /* monitor PFM from the next address */
             mstp_port->Zero_Config_Station =
-                MSTP_Zero_Config_Station_Increment(
-                    mstp_port->Zero_Config_Station);
+                MSTP_Zero_Config_Station_Next(mstp_port);
             mstp_port->Poll_Count = 0;
         } else if ((frame == FRAME_TYPE_POLL_FOR_MASTER) &&
             (dst == mstp_port->Zero_Config_Station)) {
@@ -1488,9 +1799,9 @@ static void MSTP_Zero_Config_State_Claim(struct mstp_port_struct_t *mstp_port)
         if (src == mstp_port->Zero_Config_Station) {
             /* ClaimAddressInUse */
             /* monitor PFM from the next address */
+            MSTP_Zero_Config_Map_Set(mstp_port->Zero_Config_Used, src);
             mstp_port->Zero_Config_Station =
-                MSTP_Zero_Config_Station_Increment(
-                    mstp_port->Zero_Config_Station);
+                MSTP_Zero_Config_Station_Next(mstp_port);
             mstp_port->Poll_Count = 0;
             mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_LURK;
         } else if (frame == FRAME_TYPE_TOKEN) {
@@ -1557,9 +1868,9 @@ static void MSTP_Zero_Config_State_Confirm(struct mstp_port_struct_t *mstp_port)
         } else if (src == mstp_port->Zero_Config_Station) {
             /* ConfirmationAddressInUse */
             /* monitor PFM from the next address */
+            MSTP_Zero_Config_Map_Set(mstp_port->Zero_Config_Used, src);
             mstp_port->Zero_Config_Station =
-                MSTP_Zero_Config_Station_Increment(
-                    mstp_port->Zero_Config_Station);
+                MSTP_Zero_Config_Station_Next(mstp_port);
             mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_LURK;
         }
     } else if (mstp_port->ReceivedInvalidFrame) {
@@ -1678,6 +1989,11 @@ void MSTP_Init(struct mstp_port_struct_t *mstp_port)
         mstp_port->SoleMaster = false;
         mstp_port->SourceAddress = 0;
         mstp_port->TokenCount = 0;
+        /* adaptive token passing */
+        mstp_port->Info_Frames_Backlog = false;
+        mstp_port->Info_Frames_Window = mstp_port->Nmax_info_frames;
+        mstp_port->Poll_Absent_Cycle = 0;
+        memset(mstp_port->Poll_Absent, 0, sizeof(mstp_port->Poll_Absent));
         /* zero config */
         mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_INIT;
     }
@@ -51,6 +51,9 @@ struct mstp_port_struct_t {
     unsigned SlaveNodeEnabled : 1;
    /* A Boolean flag set to TRUE if this node is using a ZeroConfig address */
     unsigned ZeroConfigEnabled : 1;
+    /* A Boolean flag set to TRUE by the master machine if the last token
+       hold used every information frame of its window */
+    unsigned Info_Frames_Backlog : 1;
     /* stores the latest received data */
     uint8_t DataRegister;
     /* Used to accumulate the CRC on the data field of a frame. */
@@ -150,6 +153,27 @@ struct mstp_port_struct_t {
        its value shall be 127. */
     uint8_t Nmax_master;
 
+    /* Optional upper limit of an adaptive information frame window.
+       When greater than Nmax_info_frames, a node that used its whole
+       window in a token hold doubles its window for the next token hold,
+       up to this limit, and falls back to Nmax_info_frames once it has
+       nothing left to send.  Zero disables the adaptive window, which
+       keeps the fixed Max_Info_Frames behavior of the standard. */
+    uint8_t Nmax_info_frames_limit;
+    /* the current number of information frames allowed per token hold */
+    uint8_t Info_Frames_Window;
+
+    /* Optional Poll For Master skipping. When greater than 1, the
+       maintenance Poll For Master skips the stations that did not reply
+       to their last poll on all but every Npoll_absent-th polling cycle.
+       Zero or one polls every station on every cycle. */
+    uint8_t Npoll_absent;
+    /* number of completed maintenance polling cycles */
+    uint8_t Poll_Absent_Cycle;
+    /* one bit per master address, set when the station did not reply
+       to a Poll For Master, and cleared when a frame is received from it */
+    uint8_t Poll_Absent[(DEFAULT_MAX_MASTER + 1) / 8];
+
     /* An array of octets, used to store octets for transmitting
        OutputBuffer is indexed from 0 to OutputBufferSize-1.
        FIXME: assign this to an actual array of bytes!
@@ -178,6 +202,11 @@ struct mstp_port_struct_t {
        The value of this parameter shall be less than or equal to 127.
        In the absence of other fixed address nodes, this value shall be 127. */
     uint8_t Zero_Config_Max_Master;
+    /* bit map of the station addresses seen as the source of a frame */
+    uint8_t Zero_Config_Used[(Nmax_master_station + 1) / 8];
+    /* bit map of the station addresses seen as the destination of
+       a Poll For Master frame, which are the addresses not in-use */
+    uint8_t Zero_Config_Polled[(Nmax_master_station + 1) / 8];
 
     /* The minimum time without a DataAvailable or ReceiveError event within
        a frame before a receiving node may discard the frame: 60 bit times.
@@ -191,6 +220,13 @@ struct mstp_port_struct_t {
        Reply Postponed frame: 250 milliseconds. */
     uint8_t Treply_delay;
 
+    /* Optional: returns true when the reply to the Data Expecting Reply
+       frame in the InputBuffer will not be available within Treply_delay,
+       such as a request routed to another network, so that the Reply
+       Postponed frame is sent at once.  When NULL, the node waits for
+       the reply until Treply_delay. See MSTP_Reply_Postpone_Routed() */
+    bool (*Reply_Postpone)(struct mstp_port_struct_t *mstp_port);
+
     /* The minimum time without a DataAvailable or ReceiveError event
        that a node must wait for a station to begin replying to a
        confirmed request: 255 milliseconds. (Implementations may use
@@ -224,6 +260,9 @@ void MSTP_Init(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
+uint16_t MSTP_Receive_Frame_FSM_Block(
+    struct mstp_port_struct_t *mstp_port, const uint8_t *data, uint16_t length);
+BACNET_STACK_EXPORT
 bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 void MSTP_Slave_Node_FSM(struct mstp_port_struct_t *mstp_port);
@@ -232,6 +271,9 @@ void MSTP_Slave_Node_FSM(struct mstp_port_struct_t *mstp_port);
 BACNET_STACK_EXPORT
 bool MSTP_Line_Active(struct mstp_port_struct_t *mstp_port);
 
+BACNET_STACK_EXPORT
+bool MSTP_Reply_Postpone_Routed(struct mstp_port_struct_t *mstp_port);
+
 BACNET_STACK_EXPORT
 uint16_t MSTP_Create_Frame(uint8_t *buffer, 
     uint16_t buffer_len,
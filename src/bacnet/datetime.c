@@ -83,13 +83,9 @@ bool datetime_date_is_valid(BACNET_DATE *bdate)
 uint32_t datetime_ymd_day_of_year(uint16_t year, uint8_t month, uint8_t day)
 {
     uint32_t days = 0; /* return value */
-    uint8_t months = 0; /* loop counter for months */
 
     if (datetime_ymd_is_valid(year, month, day)) {
-        for (months = 1; months < month; months++) {
-            days += days_per_month(year, months);
-        }
-        days += day;
+        days = days_of_year(year, month, day);
     }
 
     return (days);
@@ -141,18 +137,10 @@ uint32_t datetime_ymd_to_days_since_epoch(
     uint16_t year, uint8_t month, uint8_t day)
 {
     uint32_t days = 0; /* return value */
-    uint16_t years = 0; /* loop counter for years */
 
     if (datetime_ymd_is_valid(year, month, day)) {
-        for (years = BACNET_DATE_YEAR_EPOCH; years < year; years++) {
-            days += 365;
-            if (days_is_leap_year(years)) {
-                days++;
-            }
-        }
-        days += datetime_ymd_day_of_year(year, month, day);
-        /* 'days since' is one less */
-        days -= 1;
+        days = days_serial(year, month, day) -
+            days_serial(BACNET_DATE_YEAR_EPOCH, 1, 1);
     }
 
     return (days);
@@ -191,23 +179,8 @@ void datetime_ymd_from_days_since_epoch(
     uint8_t month = 1;
     uint8_t day = 1;
 
-    while (days >= 365) {
-        if ((days_is_leap_year(year)) && (days == 365)) {
-            break;
-        }
-        days -= 365;
-        if (days_is_leap_year(year)) {
-            --days;
-        }
-        year++;
-    }
-
-    while (days >= (uint32_t)days_per_month(year, month)) {
-        days -= days_per_month(year, month);
-        month++;
-    }
-
-    day = (uint8_t)(day + days);
+    days_serial_to_date(days_serial(BACNET_DATE_YEAR_EPOCH, 1, 1) + days,
+        &year, &month, &day);
 
     if (pYear) {
         *pYear = year;
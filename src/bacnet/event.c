@@ -713,6 +713,9 @@ int event_notify_decode_service_request(
 {
     int len = 0; /* return value */
     int section_length = 0;
+    BACNET_DECODE_CURSOR cursor = { 0 };
+    BACNET_UNSIGNED_INTEGER process_identifier = 0;
+    BACNET_UNSIGNED_INTEGER notification_class = 0;
     BACNET_UNSIGNED_INTEGER unsigned_value = 0;
     uint32_t enum_value = 0;
     uint32_t len_value = 0;
@@ -720,76 +723,46 @@ int event_notify_decode_service_request(
     bool is_complex_event_type = false;
 
     if (apdu_len && data) {
+        bacnet_cursor_init(&cursor, apdu, apdu_len);
         /* tag 0 - processIdentifier */
-        section_length = bacnet_unsigned_context_decode(
-            &apdu[len], apdu_len - len, 0, &unsigned_value);
-        if (section_length > 0) {
-            len += section_length;
-            if (unsigned_value <= UINT32_MAX) {
-                data->processIdentifier = (uint32_t)unsigned_value;
-            } else {
-                return BACNET_STATUS_ERROR;
-            }
-        } else {
-            return BACNET_STATUS_ERROR;
+        bacnet_cursor_unsigned_context(&cursor, 0, &process_identifier);
+        if (process_identifier > UINT32_MAX) {
+            bacnet_cursor_error_set(&cursor);
         }
         /* tag 1 - initiatingObjectIdentifier */
-        if ((section_length = decode_context_object_id(&apdu[len], 1,
-                 &data->initiatingObjectIdentifier.type,
-                 &data->initiatingObjectIdentifier.instance)) == -1) {
-            return -1;
-        } else {
-            len += section_length;
-        }
+        bacnet_cursor_object_id_context(&cursor, 1,
+            &data->initiatingObjectIdentifier.type,
+            &data->initiatingObjectIdentifier.instance);
         /* tag 2 - eventObjectIdentifier */
-        if ((section_length = decode_context_object_id(&apdu[len], 2,
-                 &data->eventObjectIdentifier.type,
-                 &data->eventObjectIdentifier.instance)) == -1) {
-            return -1;
-        } else {
-            len += section_length;
-        }
+        bacnet_cursor_object_id_context(&cursor, 2,
+            &data->eventObjectIdentifier.type,
+            &data->eventObjectIdentifier.instance);
         /* tag 3 - timeStamp */
-        if ((section_length = bacapp_decode_context_timestamp(
-                 &apdu[len], 3, &data->timeStamp)) == -1) {
-            return -1;
-        } else {
-            len += section_length;
+        if (bacnet_cursor_apdu(&cursor)) {
+            bacnet_cursor_skip(&cursor,
+                bacapp_decode_context_timestamp(
+                    bacnet_cursor_apdu(&cursor), 3, &data->timeStamp));
         }
         /* tag 4 - noticicationClass */
-        section_length = bacnet_unsigned_context_decode(
-            &apdu[len], apdu_len - len, 4, &unsigned_value);
-        if (section_length > 0) {
-            len += section_length;
-            if (unsigned_value <= UINT32_MAX) {
-                data->notificationClass = (uint32_t)unsigned_value;
-            } else {
-                return BACNET_STATUS_ERROR;
-            }
-        } else {
-            return BACNET_STATUS_ERROR;
+        bacnet_cursor_unsigned_context(&cursor, 4, &notification_class);
+        if (notification_class > UINT32_MAX) {
+            bacnet_cursor_error_set(&cursor);
         }
         /* tag 5 - priority */
-        section_length = bacnet_unsigned_context_decode(
-            &apdu[len], apdu_len - len, 5, &unsigned_value);
-        if (section_length > 0) {
-            len += section_length;
-            if (unsigned_value <= UINT8_MAX) {
-                data->priority = (uint8_t)unsigned_value;
-            } else {
-                return BACNET_STATUS_ERROR;
-            }
-        } else {
-            return BACNET_STATUS_ERROR;
+        bacnet_cursor_unsigned_context(&cursor, 5, &unsigned_value);
+        if (unsigned_value > UINT8_MAX) {
+            bacnet_cursor_error_set(&cursor);
         }
         /* tag 6 - eventType */
-        if ((section_length = decode_context_enumerated(
-                 &apdu[len], 6, &enum_value)) == -1) {
-            return -1;
-        } else {
-            data->eventType = (BACNET_EVENT_TYPE)enum_value;
-            len += section_length;
+        bacnet_cursor_enumerated_context(&cursor, 6, &enum_value);
+        if (bacnet_cursor_error(&cursor)) {
+            return BACNET_STATUS_ERROR;
         }
+        data->processIdentifier = (uint32_t)process_identifier;
+        data->notificationClass = (uint32_t)notification_class;
+        data->priority = (uint8_t)unsigned_value;
+        data->eventType = (BACNET_EVENT_TYPE)enum_value;
+        len = bacnet_cursor_len(&cursor);
         /* tag 7 - messageText */
 
         if (decode_is_context_tag(&apdu[len], 7)) {
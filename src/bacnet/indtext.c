@@ -6,6 +6,8 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
 #include <string.h>
 #include "bacnet/bacstr.h"
 #include "bacnet/indtext.h"
@@ -187,3 +189,105 @@ unsigned indtext_count(INDTEXT_DATA *data_list)
     }
     return count;
 }
+
+/**
+ * @brief Case insensitive FNV-1a hash of a string
+ * @param name - string to hash
+ * @return hash value of the string
+ */
+static uint32_t indtext_ihash(const char *name)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned char c;
+
+    while (*name) {
+        c = (unsigned char)tolower((unsigned char)*name);
+        hash ^= c;
+        hash *= 16777619UL;
+        name++;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Build the hash table of the strings of a list, for a case
+ *  insensitive search. Where the same string is in the list more than
+ *  once, the first one is found, as with indtext_by_istring().
+ * @param hash - hash table to be built
+ * @param data_list - list of strings and indices
+ * @param slots - array of slots of the hash table
+ * @param size - number of slots, a power of two larger than the list
+ * @return true if the hash table was built
+ */
+bool indtext_hash_init(
+    INDTEXT_HASH *hash, INDTEXT_DATA *data_list, uint16_t *slots, unsigned size)
+{
+    unsigned position = 0;
+    unsigned slot;
+
+    if (!hash) {
+        return false;
+    }
+    hash->data_list = data_list;
+    hash->slots = slots;
+    hash->size = size;
+    hash->ready = false;
+    if (!data_list || !slots || (size == 0) || (size & (size - 1)) ||
+        (size > UINT16_MAX) || (indtext_count(data_list) >= size)) {
+        return false;
+    }
+    memset(slots, 0, size * sizeof(*slots));
+    while (data_list[position].pString) {
+        slot = indtext_ihash(data_list[position].pString) & (size - 1);
+        while (slots[slot] &&
+            (bacnet_stricmp(data_list[slots[slot] - 1].pString,
+                 data_list[position].pString) != 0)) {
+            slot = (slot + 1) & (size - 1);
+        }
+        if (!slots[slot]) {
+            slots[slot] = (uint16_t)(position + 1);
+        }
+        position++;
+    }
+    hash->ready = true;
+
+    return true;
+}
+
+/**
+ * @brief Search a list of strings to find a matching string, case
+ *  insensitive, using its hash table. The hash table is built on first
+ *  use, and if it cannot be built, the list is searched instead.
+ * @param hash - hash table of the list, with its list, slots and size
+ * @param search_name - string to search for
+ * @param found_index - index of the string found
+ * @return true if the string is found
+ */
+bool indtext_hash_by_istring(
+    INDTEXT_HASH *hash, const char *search_name, unsigned *found_index)
+{
+    INDTEXT_DATA *data;
+    unsigned slot;
+
+    if (!hash || !search_name) {
+        return false;
+    }
+    if (!hash->ready &&
+        !indtext_hash_init(hash, hash->data_list, hash->slots, hash->size)) {
+        return indtext_by_istring(hash->data_list, search_name, found_index);
+    }
+    slot = indtext_ihash(search_name) & (hash->size - 1);
+    while (hash->slots[slot]) {
+        data = &hash->data_list[hash->slots[slot] - 1];
+        if (bacnet_stricmp(data->pString, search_name) == 0) {
+            if (found_index) {
+                *found_index = data->index;
+            }
+            return true;
+        }
+        slot = (slot + 1) & (hash->size - 1);
+    }
+
+    return false;
+}
@@ -20,6 +20,17 @@ typedef const struct {
     const char *pString;        /* text pair - use NULL to end the list */
 } INDTEXT_DATA;
 
+/* a hash table of the strings of an index and text list, for a case
+   insensitive search that does not compare each string of the list */
+typedef struct indtext_hash {
+    INDTEXT_DATA *data_list;
+    /* the list position + 1 of each string, or 0 for an empty slot */
+    uint16_t *slots;
+    /* number of slots - a power of two, larger than the list */
+    unsigned size;
+    bool ready;
+} INDTEXT_HASH;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -83,6 +94,21 @@ extern "C" {
     unsigned indtext_count(
         INDTEXT_DATA * data_list);
 
+/* builds the hash table of a list, in slots given by the caller */
+    BACNET_STACK_EXPORT
+    bool indtext_hash_init(
+        INDTEXT_HASH * hash,
+        INDTEXT_DATA * data_list,
+        uint16_t * slots,
+        unsigned size);
+/* case insensitive version of indtext_by_string() using a hash table,
+   which is built on first use */
+    BACNET_STACK_EXPORT
+    bool indtext_hash_by_istring(
+        INDTEXT_HASH * hash,
+        const char *search_name,
+        unsigned *found_index);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -7,6 +7,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -277,6 +278,82 @@ int bacnet_npdu_encode_pdu(uint8_t *pdu,
     return pdu_len;
 }
 
+/**
+ * @brief Build an NPDU header template, which is the NPDU portion of each
+ *  message that is sent to the same destination, from the same source,
+ *  and with the same npdu_data, so that it is encoded only once.
+ * @param header [out] The header template to build
+ * @param dest [in] The routing destination information, as for
+ *  npdu_encode_pdu()
+ * @param src [in] The routing source information, as for npdu_encode_pdu()
+ * @param npdu_data [in] The structure which describes how the NCPI and other
+ *  NPDU bytes should be encoded, which is kept in the template.
+ * @return the number of bytes of the encoded NPDU header, or 0 if there
+ *  were problems with the data or encoding.
+ */
+int npdu_header_init(BACNET_NPDU_HEADER *header,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu_data)
+{
+    int len = 0;
+
+    if (!header) {
+        return 0;
+    }
+    header->pdu_len = 0;
+    if (!npdu_data) {
+        return 0;
+    }
+    len = bacnet_npdu_encode_pdu(
+        header->pdu, sizeof(header->pdu), dest, src, npdu_data);
+    if ((len <= 0) || (len > (int)sizeof(header->pdu))) {
+        return 0;
+    }
+    npdu_copy_data(&header->npdu_data, npdu_data);
+    header->pdu_len = (uint8_t)len;
+
+    return len;
+}
+
+/**
+ * @brief Reset an NPDU header template, such as when its destination
+ *  changes, so that it is built again
+ * @param header [out] The header template to reset
+ */
+void npdu_header_reset(BACNET_NPDU_HEADER *header)
+{
+    if (header) {
+        header->pdu_len = 0;
+    }
+}
+
+/**
+ * @brief Encode the NPDU portion of a message from a header template
+ * @param pdu [out] Buffer which will hold the encoded NPDU header bytes.
+ *  If pdu is NULL, the number of bytes the buffer would have held
+ *  is returned.
+ * @param pdu_size Number of bytes in the buffer to hold the encoded data.
+ * @param header [in] The header template, from npdu_header_init()
+ * @return the number of bytes of the NPDU header, or 0 if the template
+ *  is not built or does not fit in the buffer.
+ */
+int npdu_header_encode(
+    uint8_t *pdu, uint16_t pdu_size, const BACNET_NPDU_HEADER *header)
+{
+    if (!header || (header->pdu_len == 0)) {
+        return 0;
+    }
+    if (pdu) {
+        if (header->pdu_len > pdu_size) {
+            return 0;
+        }
+        memcpy(pdu, header->pdu, header->pdu_len);
+    }
+
+    return header->pdu_len;
+}
+
 /* Configure the NPDU portion of the packet for an APDU */
 /* This function does not handle the network messages, just APDUs. */
 /* From BACnet 5.1:
@@ -31,6 +31,16 @@ typedef struct bacnet_npdu_data_t {
     uint8_t hop_count;
 } BACNET_NPDU_DATA;
 
+/* an NPDU header that is encoded once for a destination, source and
+   npdu_data, and then copied in front of each APDU sent with them */
+typedef struct bacnet_npdu_header_t {
+    /* the npdu_data that the header was encoded with */
+    BACNET_NPDU_DATA npdu_data;
+    uint8_t pdu[MAX_NPDU];
+    /* number of encoded octets, or 0 when the header is not built */
+    uint8_t pdu_len;
+} BACNET_NPDU_HEADER;
+
 struct router_port_t;
 /** The info[] string has no agreed-upon purpose, hence it is useless.
  * Keeping it short here. This size could be 0-255. */
@@ -71,6 +81,21 @@ extern "C" {
         BACNET_ADDRESS * src,
         BACNET_NPDU_DATA * npdu_data);
 
+    BACNET_STACK_EXPORT
+    int npdu_header_init(
+        BACNET_NPDU_HEADER * header,
+        BACNET_ADDRESS * dest,
+        BACNET_ADDRESS * src,
+        BACNET_NPDU_DATA * npdu_data);
+    BACNET_STACK_EXPORT
+    void npdu_header_reset(
+        BACNET_NPDU_HEADER * header);
+    BACNET_STACK_EXPORT
+    int npdu_header_encode(
+        uint8_t * pdu,
+        uint16_t pdu_size,
+        const BACNET_NPDU_HEADER * header);
+
     BACNET_STACK_EXPORT
     void npdu_encode_npdu_data(
         BACNET_NPDU_DATA * npdu,
@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -86,6 +87,74 @@ bool property_lists_member(
     return found;
 }
 
+/**
+ * @brief Set the bits of the properties of a list that are in the
+ *  standard range
+ * @param bitmap - bitmap to be set
+ * @param pList - array of type 'int' that is a list of BACnet properties
+ */
+static void property_list_bitmap_set(
+    struct property_list_bitmap_t *bitmap, const int *pList)
+{
+    if (pList) {
+        while ((*pList) != -1) {
+            if ((*pList >= 0) && (*pList <= PROP_RESERVED_RANGE_MAX)) {
+                bitmap->bits[*pList / 8] |= (uint8_t)(1 << (*pList % 8));
+            }
+            pList++;
+        }
+    }
+}
+
+/**
+ * @brief Build the membership bitmap of the property lists of an object,
+ *  so that a property is found in the lists without a search of them.
+ *  The lists are kept by the bitmap, and must not change while it is used.
+ * @param bitmap - bitmap to be built
+ * @param pRequired - array of type 'int' that is a list of BACnet properties
+ * @param pOptional - array of type 'int' that is a list of BACnet properties
+ * @param pProprietary - array of type 'int' that is a list of BACnet properties
+ */
+void property_list_bitmap_init(
+    struct property_list_bitmap_t *bitmap,
+    const int *pRequired,
+    const int *pOptional,
+    const int *pProprietary)
+{
+    if (bitmap) {
+        memset(bitmap->bits, 0, sizeof(bitmap->bits));
+        property_list_bitmap_set(bitmap, pRequired);
+        property_list_bitmap_set(bitmap, pOptional);
+        property_list_bitmap_set(bitmap, pProprietary);
+        bitmap->pRequired = pRequired;
+        bitmap->pOptional = pOptional;
+        bitmap->pProprietary = pProprietary;
+    }
+}
+
+/**
+ * @brief Determine if the object property is a member of any of the lists
+ *  of a membership bitmap
+ * @param bitmap - bitmap built by property_list_bitmap_init()
+ * @param object_property - object-property to be checked
+ * @return true if the property is a member of any of the lists
+ */
+bool property_list_bitmap_member(
+    const struct property_list_bitmap_t *bitmap, int object_property)
+{
+    if (!bitmap) {
+        return false;
+    }
+    if ((object_property >= 0) &&
+        (object_property <= PROP_RESERVED_RANGE_MAX)) {
+        return (bitmap->bits[object_property / 8] &
+                   (1 << (object_property % 8))) != 0;
+    }
+
+    return property_lists_member(bitmap->pRequired, bitmap->pOptional,
+        bitmap->pProprietary, object_property);
+}
+
 /**
  * ReadProperty handler for this property.  For the given ReadProperty
  * data, the application_data is loaded or the error flags are set.
@@ -26,6 +26,19 @@ struct special_property_list_t {
     struct property_list_t Proprietary;
 };
 
+/* one bit for each property of the standard range */
+#define PROPERTY_LIST_BITMAP_SIZE ((PROP_RESERVED_RANGE_MAX + 1) / 8)
+
+/* the membership of the properties of the lists of an object, which is
+   found without a search of the lists */
+struct property_list_bitmap_t {
+    uint8_t bits[PROPERTY_LIST_BITMAP_SIZE];
+    /* the lists, for the properties outside of the standard range */
+    const int *pRequired;
+    const int *pOptional;
+    const int *pProprietary;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -44,6 +57,16 @@ extern "C" {
         const int *pProprietary,
         int object_property);
     BACNET_STACK_EXPORT
+    void property_list_bitmap_init(
+        struct property_list_bitmap_t *bitmap,
+        const int *pRequired,
+        const int *pOptional,
+        const int *pProprietary);
+    BACNET_STACK_EXPORT
+    bool property_list_bitmap_member(
+        const struct property_list_bitmap_t *bitmap,
+        int object_property);
+    BACNET_STACK_EXPORT
     int property_list_encode(
         BACNET_READ_PROPERTY_DATA * rpdata,
         const int *pListRequired,
@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -305,3 +306,205 @@ int ptransfer_ack_encode_apdu(uint8_t *apdu,
 
 /* ptransfer_ack_decode_service_request() is the same as
        ptransfer_decode_service_request */
+
+/**
+ * @brief Determine the data of a block that fits in one request
+ * @param max_apdu - the maximum APDU of the destination
+ * @return number of data bytes of each block, or zero if none fit
+ */
+uint16_t ptransfer_block_size(unsigned max_apdu)
+{
+    if (max_apdu <= PTRANSFER_BLOCK_OVERHEAD) {
+        return 0;
+    }
+    if ((max_apdu - PTRANSFER_BLOCK_OVERHEAD) > UINT16_MAX) {
+        return UINT16_MAX;
+    }
+
+    return (uint16_t)(max_apdu - PTRANSFER_BLOCK_OVERHEAD);
+}
+
+/**
+ * @brief Encode one block of a stream as serviceParameters
+ *
+ *  Block ::= SEQUENCE {
+ *      streamLength Unsigned,
+ *      blockSize    Unsigned,
+ *      blockNumber  Unsigned,
+ *      blockData    OCTET STRING
+ *  }
+ *
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @param block - the block to encode
+ * @return number of bytes encoded
+ */
+int ptransfer_block_encode(uint8_t *apdu, BACNET_PRIVATE_TRANSFER_BLOCK *block)
+{
+    int len = 0;
+    int apdu_len = 0;
+    uint8_t *apdu_offset = NULL;
+
+    if (!block) {
+        return 0;
+    }
+    len = encode_application_unsigned(apdu, block->stream_length);
+    apdu_len += len;
+    if (apdu) {
+        apdu_offset = &apdu[apdu_len];
+    }
+    len = encode_application_unsigned(apdu_offset, block->block_size);
+    apdu_len += len;
+    if (apdu) {
+        apdu_offset = &apdu[apdu_len];
+    }
+    len = encode_application_unsigned(apdu_offset, block->block_number);
+    apdu_len += len;
+    if (apdu) {
+        apdu_offset = &apdu[apdu_len];
+    }
+    len = encode_tag(apdu_offset, BACNET_APPLICATION_TAG_OCTET_STRING, false,
+        block->data_len);
+    apdu_len += len;
+    if (apdu && block->data_len) {
+        memcpy(&apdu[apdu_len], block->data, block->data_len);
+    }
+    apdu_len += block->data_len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode one block of a stream from serviceParameters. The data
+ *  of the block is not copied, and points into the buffer.
+ * @param apdu - buffer of the serviceParameters
+ * @param apdu_len - number of bytes in the buffer
+ * @param block - the decoded block
+ * @return number of bytes decoded, or BACNET_STATUS_ERROR
+ */
+int ptransfer_block_decode(
+    uint8_t *apdu, unsigned apdu_len, BACNET_PRIVATE_TRANSFER_BLOCK *block)
+{
+    BACNET_UNSIGNED_INTEGER value[3] = { 0 };
+    BACNET_TAG tag = { 0 };
+    int len = 0;
+    unsigned i;
+    unsigned offset = 0;
+
+    if (!apdu || !block) {
+        return BACNET_STATUS_ERROR;
+    }
+    for (i = 0; i < 3; i++) {
+        len = bacnet_unsigned_application_decode(
+            &apdu[offset], apdu_len - offset, &value[i]);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        offset += len;
+    }
+    if ((value[0] > UINT32_MAX) || (value[1] > UINT16_MAX) ||
+        (value[2] > UINT32_MAX)) {
+        return BACNET_STATUS_ERROR;
+    }
+    len = bacnet_tag_decode(&apdu[offset], apdu_len - offset, &tag);
+    if ((len <= 0) || !tag.application ||
+        (tag.number != BACNET_APPLICATION_TAG_OCTET_STRING) ||
+        (tag.len_value_type > UINT16_MAX)) {
+        return BACNET_STATUS_ERROR;
+    }
+    offset += len;
+    if (tag.len_value_type > (apdu_len - offset)) {
+        return BACNET_STATUS_ERROR;
+    }
+    block->stream_length = (uint32_t)value[0];
+    block->block_size = (uint16_t)value[1];
+    block->block_number = (uint32_t)value[2];
+    block->data = &apdu[offset];
+    block->data_len = (uint16_t)tag.len_value_type;
+    offset += tag.len_value_type;
+
+    return (int)offset;
+}
+
+/**
+ * @brief Initialize the reassembly of a stream
+ * @param stream - the stream
+ * @param buffer - storage for the data of the stream
+ * @param size - number of bytes of storage
+ */
+void ptransfer_stream_init(
+    BACNET_PRIVATE_TRANSFER_STREAM *stream, uint8_t *buffer, uint32_t size)
+{
+    if (stream) {
+        memset(stream, 0, sizeof(BACNET_PRIVATE_TRANSFER_STREAM));
+        stream->buffer = buffer;
+        stream->size = size;
+    }
+}
+
+/**
+ * @brief Store a block of a stream, in any order. A block that was
+ *  already stored, such as from a retried request, is accepted again.
+ * @param stream - the stream
+ * @param block - the decoded block
+ * @return true if the block belongs to the stream
+ */
+bool ptransfer_stream_block_add(BACNET_PRIVATE_TRANSFER_STREAM *stream,
+    BACNET_PRIVATE_TRANSFER_BLOCK *block)
+{
+    uint32_t offset = 0;
+    uint32_t data_len = 0;
+    uint8_t mask = 0;
+
+    if (!stream || !block || (block->block_size == 0)) {
+        return false;
+    }
+    if (stream->block_size == 0) {
+        if ((block->stream_length > stream->size) ||
+            (block->stream_length >
+                ((uint32_t)block->block_size * PTRANSFER_STREAM_BLOCKS_MAX))) {
+            return false;
+        }
+        stream->length = block->stream_length;
+        stream->block_size = block->block_size;
+    } else if ((stream->length != block->stream_length) ||
+        (stream->block_size != block->block_size)) {
+        return false;
+    }
+    if (block->block_number >= PTRANSFER_STREAM_BLOCKS_MAX) {
+        return false;
+    }
+    offset = block->block_number * stream->block_size;
+    if (offset >= stream->length) {
+        return false;
+    }
+    data_len = stream->length - offset;
+    if (data_len > stream->block_size) {
+        data_len = stream->block_size;
+    }
+    if (block->data_len != data_len) {
+        return false;
+    }
+    mask = (uint8_t)(1 << (block->block_number % 8));
+    if (stream->blocks[block->block_number / 8] & mask) {
+        return true;
+    }
+    memcpy(&stream->buffer[offset], block->data, data_len);
+    stream->blocks[block->block_number / 8] |= mask;
+    stream->received += data_len;
+
+    return true;
+}
+
+/**
+ * @brief Determine if all of the blocks of a stream are stored
+ * @param stream - the stream
+ * @return true if the stream is complete
+ */
+bool ptransfer_stream_complete(BACNET_PRIVATE_TRANSFER_STREAM *stream)
+{
+    if (!stream || (stream->block_size == 0)) {
+        return false;
+    }
+
+    return stream->received == stream->length;
+}
@@ -20,6 +20,39 @@ typedef struct BACnet_Private_Transfer_Data {
     int serviceParametersLen;
 } BACNET_PRIVATE_TRANSFER_DATA;
 
+/* the blocks of a stream that are reassembled by the receiver */
+#ifndef PTRANSFER_STREAM_BLOCKS_MAX
+#define PTRANSFER_STREAM_BLOCKS_MAX 256
+#endif
+
+/* the ConfirmedPrivateTransfer-Request and block encoding, without data */
+#define PTRANSFER_BLOCK_OVERHEAD 33
+
+/**
+ * One block of a stream, encoded as the serviceParameters. Every block
+ * except the last has block_size bytes of data.
+ */
+typedef struct BACnet_Private_Transfer_Block {
+    uint32_t stream_length;
+    uint16_t block_size;
+    uint32_t block_number;
+    uint8_t *data;
+    uint16_t data_len;
+} BACNET_PRIVATE_TRANSFER_BLOCK;
+
+/**
+ * The reassembly of a stream from blocks that arrive in any order,
+ * such as from a window of outstanding requests
+ */
+typedef struct BACnet_Private_Transfer_Stream {
+    uint8_t *buffer;
+    uint32_t size;
+    uint32_t length;
+    uint16_t block_size;
+    uint32_t received;
+    uint8_t blocks[(PTRANSFER_STREAM_BLOCKS_MAX + 7) / 8];
+} BACNET_PRIVATE_TRANSFER_STREAM;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -62,6 +95,32 @@ extern "C" {
 /* ptransfer_ack_decode_service_request() is the same as
        ptransfer_decode_service_request */
 
+    BACNET_STACK_EXPORT
+    uint16_t ptransfer_block_size(
+        unsigned max_apdu);
+    BACNET_STACK_EXPORT
+    int ptransfer_block_encode(
+        uint8_t * apdu,
+        BACNET_PRIVATE_TRANSFER_BLOCK * block);
+    BACNET_STACK_EXPORT
+    int ptransfer_block_decode(
+        uint8_t * apdu,
+        unsigned apdu_len,
+        BACNET_PRIVATE_TRANSFER_BLOCK * block);
+
+    BACNET_STACK_EXPORT
+    void ptransfer_stream_init(
+        BACNET_PRIVATE_TRANSFER_STREAM * stream,
+        uint8_t * buffer,
+        uint32_t size);
+    BACNET_STACK_EXPORT
+    bool ptransfer_stream_block_add(
+        BACNET_PRIVATE_TRANSFER_STREAM * stream,
+        BACNET_PRIVATE_TRANSFER_BLOCK * block);
+    BACNET_STACK_EXPORT
+    bool ptransfer_stream_complete(
+        BACNET_PRIVATE_TRANSFER_STREAM * stream);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -607,3 +607,118 @@ int rr_ack_decode_service_request(uint8_t *apdu,
 
     return len;
 }
+
+/**
+ * @brief Encode the items of a ReadRange-ACK from a list or array whose
+ *  elements are encoded by index. The positions of the items are 1..N,
+ *  and are also used as the sequence numbers of a By Sequence request.
+ *  Each element is sized before it is encoded, so that a page of a large
+ *  list stops at the first item that does not fit.
+ * @param apdu - buffer for the itemData, or NULL for the length
+ * @param apdu_size - number of bytes of the ReadRange-ACK, including the
+ *  pRequest->Overhead
+ * @param pRequest - the request, whose ResultFlags, ItemCount and
+ *  FirstSequence are set
+ * @param encoder - function to encode the element at an index 0..N-1
+ * @param element_count - number of elements of the list or array
+ * @return number of bytes encoded, or BACNET_STATUS_ABORT when none of
+ *  the requested items fit, or BACNET_STATUS_ERROR on an element error
+ */
+int read_range_element_list_encode(uint8_t *apdu,
+    size_t apdu_size,
+    BACNET_READ_RANGE_DATA *pRequest,
+    bacnet_array_property_element_encode_function encoder,
+    uint32_t element_count)
+{
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t index = 0;
+    int64_t start = 0;
+    size_t available = 0;
+    int apdu_len = 0;
+    int len = 0;
+
+    if (!pRequest || !encoder) {
+        return BACNET_STATUS_ERROR;
+    }
+    bitstring_init(&pRequest->ResultFlags);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, false);
+    pRequest->ItemCount = 0;
+    pRequest->FirstSequence = 0;
+    if ((pRequest->Overhead < 0) || (apdu_size <= (size_t)pRequest->Overhead)) {
+        return BACNET_STATUS_ABORT;
+    }
+    available = apdu_size - (size_t)pRequest->Overhead;
+    if (element_count == 0) {
+        return 0;
+    }
+    if (pRequest->RequestType == RR_READ_ALL) {
+        first = 1;
+        last = element_count;
+    } else {
+        if (pRequest->RequestType == RR_BY_SEQUENCE) {
+            start = pRequest->Range.RefSeqNum;
+        } else {
+            start = pRequest->Range.RefIndex;
+        }
+        if (pRequest->Count < 0) {
+            /* the items up to and including the reference */
+            if (start > element_count) {
+                start = element_count;
+            }
+            last = (uint32_t)start;
+            start += (int64_t)pRequest->Count + 1;
+            if (start < 1) {
+                start = 1;
+            }
+            first = (uint32_t)start;
+        } else {
+            if (start > element_count) {
+                return 0;
+            }
+            if (start < 1) {
+                start = 1;
+            }
+            first = (uint32_t)start;
+            start += (int64_t)pRequest->Count - 1;
+            if (start > element_count) {
+                start = element_count;
+            }
+            last = (uint32_t)start;
+        }
+        if ((first == 0) || (first > last)) {
+            return 0;
+        }
+    }
+    for (index = first; index <= last; index++) {
+        len = encoder(pRequest->object_instance, index - 1, NULL);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        if ((size_t)(apdu_len + len) > available) {
+            bitstring_set_bit(
+                &pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
+            break;
+        }
+        if (apdu) {
+            len = encoder(
+                pRequest->object_instance, index - 1, &apdu[apdu_len]);
+        }
+        apdu_len += len;
+        pRequest->ItemCount++;
+    }
+    if (pRequest->ItemCount == 0) {
+        return BACNET_STATUS_ABORT;
+    }
+    pRequest->FirstSequence = first;
+    if (first == 1) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
+    }
+    if ((first + pRequest->ItemCount - 1) == element_count) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
+    }
+
+    return apdu_len;
+}
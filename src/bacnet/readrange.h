@@ -11,6 +11,7 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/bacdcode.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/datetime.h"
 
@@ -101,9 +102,14 @@ extern "C" {
 /** Structure to return the type of requests a given object property can
  * accept and the address of the function to handle the request */
 
+    /* For a list or array whose elements are encoded by index, the
+       Handler is NULL and the elements are encoded by the generic
+       read_range_element_list_encode() */
     typedef struct rrpropertyinfo {
         int RequestTypes;
         rr_handler_function Handler;
+        bacnet_array_property_element_encode_function Element_Encode;
+        uint32_t Element_Count;
     } RR_PROP_INFO;
 
 /** Function template for ReadRange information retrieval function.
@@ -146,6 +152,14 @@ extern "C" {
         uint8_t invoke_id,
         BACNET_READ_RANGE_DATA * rrdata);
 
+    BACNET_STACK_EXPORT
+    int read_range_element_list_encode(
+        uint8_t * apdu,
+        size_t apdu_size,
+        BACNET_READ_RANGE_DATA * pRequest,
+        bacnet_array_property_element_encode_function encoder,
+        uint32_t element_count);
+
     BACNET_STACK_EXPORT
     int rr_ack_decode_service_request(
         uint8_t * apdu,
@@ -11,6 +11,7 @@
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bacdcode.h"
+#include "bacnet/bacint.h"
 #include "bacnet/rp.h"
 
 #if BACNET_SVC_RP_A
@@ -129,12 +130,52 @@ int rp_decode_service_request(
     uint8_t *apdu, unsigned apdu_len, BACNET_READ_PROPERTY_DATA *rpdata)
 {
     unsigned len = 0;
-    uint8_t tag_number = 0;
-    uint32_t len_value_type = 0;
+    BACNET_DECODE_CURSOR cursor = { 0 };
     BACNET_OBJECT_TYPE type = OBJECT_NONE; /* for decoding */
     uint32_t property = 0; /* for decoding */
     BACNET_UNSIGNED_INTEGER unsigned_value = 0; /* for decoding */
+    uint32_t object_id = 0; /* for decoding */
+    unsigned property_len = 0, index_len = 0;
 
+    /* fast path for the usual encoding, where every tag is one octet:
+       validate the whole request once, then extract the fields */
+    if (rpdata && (apdu_len >= 7) && (apdu[0] == 0x0C) &&
+        IS_CONTEXT_TAG_SHORT(apdu[5], 1)) {
+        property_len = apdu[5] & 0x07;
+        len = 6 + property_len;
+        if (len < apdu_len) {
+            if (IS_CONTEXT_TAG_SHORT(apdu[len], 2)) {
+                index_len = apdu[len] & 0x07;
+            }
+            if ((index_len == 0) || ((len + 1 + index_len) != apdu_len)) {
+                /* let the general decoder find what is wrong */
+                index_len = 0;
+                len = 0;
+            }
+        } else if (len > apdu_len) {
+            /* truncated: let the general decoder reject it */
+            len = 0;
+        }
+        if (len) {
+            (void)decode_unsigned32(&apdu[1], &object_id);
+            rpdata->object_type =
+                (BACNET_OBJECT_TYPE)((object_id >> BACNET_INSTANCE_BITS) &
+                    BACNET_MAX_OBJECT);
+            rpdata->object_instance = object_id & BACNET_MAX_INSTANCE;
+            (void)bacnet_enumerated_decode(
+                &apdu[6], property_len, property_len, &property);
+            rpdata->object_property = (BACNET_PROPERTY_ID)property;
+            if (index_len) {
+                (void)bacnet_unsigned_decode(
+                    &apdu[len + 1], index_len, index_len, &unsigned_value);
+                rpdata->array_index = (BACNET_ARRAY_INDEX)unsigned_value;
+                len += 1 + index_len;
+            } else {
+                rpdata->array_index = BACNET_ARRAY_ALL;
+            }
+            return (int)len;
+        }
+    }
     /* check for value pointers */
     if (rpdata) {
         /* Must have at least 2 tags, an object id and a property identifier
@@ -144,37 +185,25 @@ int rp_decode_service_request(
             return BACNET_STATUS_REJECT;
         }
 
+        bacnet_cursor_init(&cursor, apdu, apdu_len);
         /* Tag 0: Object ID          */
-        if (!decode_is_context_tag(&apdu[len++], 0)) {
-            rpdata->error_code = ERROR_CODE_REJECT_INVALID_TAG;
-            return BACNET_STATUS_REJECT;
-        }
-        len += decode_object_id(&apdu[len], &type, &rpdata->object_instance);
+        bacnet_cursor_object_id_context(
+            &cursor, 0, &type, &rpdata->object_instance);
         rpdata->object_type = type;
         /* Tag 1: Property ID */
-        len += decode_tag_number_and_value(
-            &apdu[len], &tag_number, &len_value_type);
-        if (tag_number != 1) {
-            rpdata->error_code = ERROR_CODE_REJECT_INVALID_TAG;
-            return BACNET_STATUS_REJECT;
-        }
-        len += decode_enumerated(&apdu[len], len_value_type, &property);
+        bacnet_cursor_enumerated_context(&cursor, 1, &property);
         rpdata->object_property = (BACNET_PROPERTY_ID)property;
         /* Tag 2: Optional Array Index */
-        if (len < apdu_len) {
-            len += decode_tag_number_and_value(
-                &apdu[len], &tag_number, &len_value_type);
-            if ((tag_number == 2) && (len < apdu_len)) {
-                len += decode_unsigned(
-                    &apdu[len], len_value_type, &unsigned_value);
-                rpdata->array_index = (BACNET_ARRAY_INDEX)unsigned_value;
-            } else {
-                rpdata->error_code = ERROR_CODE_REJECT_INVALID_TAG;
-                return BACNET_STATUS_REJECT;
-            }
-        } else {
-            rpdata->array_index = BACNET_ARRAY_ALL;
+        rpdata->array_index = BACNET_ARRAY_ALL;
+        if (bacnet_cursor_remaining(&cursor) > 0) {
+            bacnet_cursor_unsigned_context(&cursor, 2, &unsigned_value);
+            rpdata->array_index = (BACNET_ARRAY_INDEX)unsigned_value;
+        }
+        if (bacnet_cursor_error(&cursor)) {
+            rpdata->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+            return BACNET_STATUS_REJECT;
         }
+        len = (unsigned)bacnet_cursor_len(&cursor);
     }
 
     if (len < apdu_len) {
@@ -14,6 +14,7 @@
 #include "bacnet/bacerror.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/bacint.h"
 #include "bacnet/memcopy.h"
 #include "bacnet/rpm.h"
 
@@ -239,27 +240,39 @@ int rpm_decode_object_id(
     uint8_t *apdu, unsigned apdu_len, BACNET_RPM_DATA *rpmdata)
 {
     int len = 0;
+    BACNET_DECODE_CURSOR cursor = { 0 };
     BACNET_OBJECT_TYPE type = OBJECT_NONE; /* for decoding */
-
+    uint32_t object_id = 0; /* for decoding */
+
+    /* fast path for the usual encoding: one octet context tag,
+       four octet object identifier and the opening tag */
+    if (apdu && rpmdata && (apdu_len >= 6) && (apdu[0] == 0x0C) &&
+        (apdu[5] == 0x1E)) {
+        (void)decode_unsigned32(&apdu[1], &object_id);
+        rpmdata->object_type =
+            (BACNET_OBJECT_TYPE)((object_id >> BACNET_INSTANCE_BITS) &
+                BACNET_MAX_OBJECT);
+        rpmdata->object_instance = object_id & BACNET_MAX_INSTANCE;
+        return 6;
+    }
     /* check for value pointers */
     if (apdu && apdu_len && rpmdata) {
         if (apdu_len < 5) { /* Must be at least 2 tags and an object id */
             rpmdata->error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
             return BACNET_STATUS_REJECT;
         }
+        bacnet_cursor_init(&cursor, apdu, apdu_len);
         /* Tag 0: Object ID */
-        if (!decode_is_context_tag(&apdu[len++], 0)) {
-            rpmdata->error_code = ERROR_CODE_REJECT_INVALID_TAG;
-            return BACNET_STATUS_REJECT;
-        }
-        len += decode_object_id(&apdu[len], &type, &rpmdata->object_instance);
+        bacnet_cursor_object_id_context(
+            &cursor, 0, &type, &rpmdata->object_instance);
         rpmdata->object_type = type;
         /* Tag 1: sequence of ReadAccessSpecification */
-        if (!decode_is_opening_tag_number(&apdu[len], 1)) {
+        bacnet_cursor_opening_tag(&cursor, 1);
+        if (bacnet_cursor_error(&cursor)) {
             rpmdata->error_code = ERROR_CODE_REJECT_INVALID_TAG;
             return BACNET_STATUS_REJECT;
         }
-        len++; /* opening tag is only one octet */
+        len = bacnet_cursor_len(&cursor);
     }
 
     return len;
@@ -308,7 +321,41 @@ int rpm_decode_object_property(
     uint32_t len_value_type = 0;
     uint32_t property = 0; /* for decoding */
     BACNET_UNSIGNED_INTEGER unsigned_value = 0; /* for decoding */
-
+    unsigned property_len = 0, index_len = 0;
+
+    /* fast path for the usual encoding, where every tag is one octet:
+       validate the property reference once, then extract the fields */
+    if (apdu && rpmdata && (apdu_len >= 2) &&
+        IS_CONTEXT_TAG_SHORT(apdu[0], 0)) {
+        property_len = apdu[0] & 0x07;
+        len = 1 + property_len;
+        if ((unsigned)len >= apdu_len) {
+            len = 0;
+        } else if (IS_CONTEXT_TAG_SHORT(apdu[len], 1)) {
+            index_len = apdu[len] & 0x07;
+            if ((unsigned)(len + 1 + index_len) >= apdu_len) {
+                len = 0;
+            }
+        } else if (
+            IS_CONTEXT_SPECIFIC(apdu[len]) && !IS_CLOSING_TAG(apdu[len])) {
+            /* some other context tag: let the general decoder handle it */
+            len = 0;
+        }
+        if (len) {
+            (void)bacnet_enumerated_decode(
+                &apdu[1], property_len, property_len, &property);
+            rpmdata->object_property = (BACNET_PROPERTY_ID)property;
+            if (index_len) {
+                (void)bacnet_unsigned_decode(
+                    &apdu[len + 1], index_len, index_len, &unsigned_value);
+                rpmdata->array_index = (BACNET_ARRAY_INDEX)unsigned_value;
+                len += 1 + index_len;
+            } else {
+                rpmdata->array_index = BACNET_ARRAY_ALL;
+            }
+            return len;
+        }
+    }
     /* check for valid pointers */
     if (apdu && apdu_len && rpmdata) {
         /* Tag 0: propertyIdentifier */
@@ -681,6 +728,10 @@ void rpm_ack_object_property_process(
         apdu_len -= len;
         apdu += len;
         while (apdu_len) {
+            if (bacnet_is_closing_tag_number(apdu, apdu_len, 1, &len)) {
+                /* end of the list of results of this object */
+                break;
+            }
             len = rpm_ack_decode_object_property(
                 apdu, apdu_len, &rp_data->object_property,
                 &rp_data->array_index);
@@ -7,6 +7,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/weeklyschedule.h"
 #include "bacnet/bacdcode.h"
 #include "bacapp.h"
@@ -202,3 +203,323 @@ bool bacnet_weeklyschedule_same(
 
     return true;
 }
+
+/**
+ * @brief Initialize a compact weekly schedule with no time values
+ * @param list - the weekly schedule
+ * @param time_values - the storage of the time values of all the days
+ * @param size - the number of time values of the storage
+ */
+void bacnet_weeklyschedule_list_init(
+    BACNET_WEEKLY_SCHEDULE_LIST *list,
+    BACNET_TIME_VALUE *time_values,
+    uint16_t size)
+{
+    unsigned i;
+
+    if (list) {
+        list->Time_Values = time_values;
+        list->Size = time_values ? size : 0;
+        for (i = 0; i < 8; i++) {
+            list->Day_Start[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Get the number of time values of one day of a weekly schedule
+ * @param list - the weekly schedule
+ * @param day - the day, 0=Monday..6=Sunday
+ * @return the number of time values of the day
+ */
+unsigned bacnet_weeklyschedule_list_day_count(
+    BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day)
+{
+    if (!list || (day >= 7)) {
+        return 0;
+    }
+
+    return list->Day_Start[day + 1] - list->Day_Start[day];
+}
+
+/**
+ * @brief Get the time values of one day of a weekly schedule
+ * @param list - the weekly schedule
+ * @param day - the day, 0=Monday..6=Sunday
+ * @return the first time value of the day, valid until the schedule
+ *  is changed, or NULL if the day is not valid
+ */
+BACNET_TIME_VALUE *bacnet_weeklyschedule_list_day(
+    BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day)
+{
+    if (!list || !list->Time_Values || (day >= 7)) {
+        return NULL;
+    }
+
+    return &list->Time_Values[list->Day_Start[day]];
+}
+
+/**
+ * @brief Determine if one day of a weekly schedule may have a number of
+ *  time values
+ * @param list - the weekly schedule
+ * @param day - the day, 0=Monday..6=Sunday
+ * @param count - the number of time values of the day
+ * @return true if the time values fit the storage
+ */
+static bool weeklyschedule_list_day_fits(
+    BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day, unsigned count)
+{
+    unsigned used;
+
+    used = list->Day_Start[7] - bacnet_weeklyschedule_list_day_count(list, day);
+
+    return (used + count) <= list->Size;
+}
+
+/**
+ * @brief Change the number of time values of one day of a weekly schedule,
+ *  moving the time values of the days that follow
+ * @param list - the weekly schedule
+ * @param day - the day, 0=Monday..6=Sunday
+ * @param count - the number of time values of the day, which fit
+ */
+static void weeklyschedule_list_day_resize(
+    BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day, unsigned count)
+{
+    unsigned start = list->Day_Start[day];
+    unsigned end = list->Day_Start[day + 1];
+    unsigned used = list->Day_Start[7];
+    unsigned i;
+
+    if ((used > end) && ((start + count) != end)) {
+        memmove(&list->Time_Values[start + count], &list->Time_Values[end],
+            (used - end) * sizeof(BACNET_TIME_VALUE));
+    }
+    for (i = day + 1; i < 8; i++) {
+        list->Day_Start[i] =
+            (uint16_t)(list->Day_Start[i] - end + start + count);
+    }
+}
+
+/**
+ * @brief Set the time values of one day of a weekly schedule
+ * @param list - the weekly schedule
+ * @param day - the day, 0=Monday..6=Sunday
+ * @param time_values - the time values of the day, which are copied
+ * @param count - the number of time values
+ * @return true if the time values were set, or false if the day is not
+ *  valid or the time values do not fit the storage
+ */
+bool bacnet_weeklyschedule_list_day_set(
+    BACNET_WEEKLY_SCHEDULE_LIST *list,
+    unsigned day,
+    const BACNET_TIME_VALUE *time_values,
+    unsigned count)
+{
+    if (!list || (day >= 7) || (count && !time_values)) {
+        return false;
+    }
+    if (!weeklyschedule_list_day_fits(list, day, count)) {
+        return false;
+    }
+    weeklyschedule_list_day_resize(list, day, count);
+    if (count) {
+        memcpy(&list->Time_Values[list->Day_Start[day]], time_values,
+            count * sizeof(BACNET_TIME_VALUE));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Encode one day of a weekly schedule as a BACnetDailySchedule
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param list - the weekly schedule
+ * @param day - the day, 0=Monday..6=Sunday
+ * @return the number of apdu bytes encoded, or BACNET_STATUS_ERROR if
+ *  a time value was inconsistent
+ */
+int bacnet_weeklyschedule_list_day_encode(
+    uint8_t *apdu, BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day)
+{
+    BACNET_TIME_VALUE *time_values;
+    unsigned count, i;
+    int apdu_len = 0;
+    int len;
+
+    time_values = bacnet_weeklyschedule_list_day(list, day);
+    if (!time_values) {
+        return BACNET_STATUS_ERROR;
+    }
+    count = bacnet_weeklyschedule_list_day_count(list, day);
+    len = encode_opening_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    for (i = 0; i < count; i++) {
+        len = bacnet_time_value_encode(apdu, &time_values[i]);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    len = encode_closing_tag(apdu, 0);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the seven days of a weekly schedule
+ * @param apdu - buffer of data to be encoded, or NULL for length
+ * @param list - the weekly schedule
+ * @return the number of apdu bytes encoded, or BACNET_STATUS_ERROR if
+ *  a time value was inconsistent
+ */
+int bacnet_weeklyschedule_list_encode(
+    uint8_t *apdu, BACNET_WEEKLY_SCHEDULE_LIST *list)
+{
+    int apdu_len = 0;
+    int len;
+    unsigned day;
+
+    for (day = 0; day < 7; day++) {
+        len = bacnet_weeklyschedule_list_day_encode(apdu, list, day);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode a BACnetDailySchedule, and either count its time values
+ *  or store them
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param time_values - where the time values are stored, or NULL to
+ *  only count them
+ * @param count - the number of time values is returned here
+ * @return number of bytes decoded, or BACNET_STATUS_ERROR if an error occurs
+ */
+static int weeklyschedule_day_decode(uint8_t *apdu,
+    int apdu_size,
+    BACNET_TIME_VALUE *time_values,
+    unsigned *count)
+{
+    BACNET_TIME_VALUE value;
+    unsigned n = 0;
+    int apdu_len = 0;
+    int len = 0;
+
+    if (!bacnet_is_opening_tag_number(apdu, apdu_size, 0, &len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    while (!bacnet_is_closing_tag_number(
+        &apdu[apdu_len], apdu_size - apdu_len, 0, &len)) {
+        len = bacnet_time_value_decode(&apdu[apdu_len], apdu_size - apdu_len,
+            time_values ? &time_values[n] : &value);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        n++;
+    }
+    apdu_len += len;
+    *count = n;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode a BACnetDailySchedule into one day of a weekly schedule,
+ *  in place in its storage. The weekly schedule is not changed when the
+ *  data is not valid or does not fit.
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param list - the weekly schedule
+ * @param day - the day, 0=Monday..6=Sunday
+ * @return number of bytes decoded, BACNET_STATUS_ERROR if an error occurs,
+ *  or BACNET_STATUS_ABORT if the time values do not fit the storage
+ */
+int bacnet_weeklyschedule_list_day_decode(
+    uint8_t *apdu,
+    int apdu_size,
+    BACNET_WEEKLY_SCHEDULE_LIST *list,
+    unsigned day)
+{
+    unsigned count = 0;
+    int len;
+
+    if (!apdu || (apdu_size <= 0) || !list || (day >= 7)) {
+        return BACNET_STATUS_ERROR;
+    }
+    len = weeklyschedule_day_decode(apdu, apdu_size, NULL, &count);
+    if (len < 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    if (!weeklyschedule_list_day_fits(list, day, count)) {
+        return BACNET_STATUS_ABORT;
+    }
+    weeklyschedule_list_day_resize(list, day, count);
+
+    return weeklyschedule_day_decode(
+        apdu, apdu_size, &list->Time_Values[list->Day_Start[day]], &count);
+}
+
+/**
+ * @brief Decode the seven BACnetDailySchedule of a BACnetARRAY[7] into
+ *  a weekly schedule, in place in its storage. The weekly schedule is not
+ *  changed when the data is not valid or does not fit.
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param list - the weekly schedule
+ * @return number of bytes decoded, BACNET_STATUS_ERROR if an error occurs,
+ *  or BACNET_STATUS_ABORT if the time values do not fit the storage
+ */
+int bacnet_weeklyschedule_list_decode(
+    uint8_t *apdu, int apdu_size, BACNET_WEEKLY_SCHEDULE_LIST *list)
+{
+    unsigned count[7] = { 0 };
+    unsigned total = 0;
+    unsigned day;
+    int apdu_len = 0;
+    int len;
+
+    if (!apdu || (apdu_size <= 0) || !list) {
+        return BACNET_STATUS_ERROR;
+    }
+    for (day = 0; day < 7; day++) {
+        len = weeklyschedule_day_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, NULL, &count[day]);
+        if (len < 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        total += count[day];
+    }
+    if (total > list->Size) {
+        return BACNET_STATUS_ABORT;
+    }
+    apdu_len = 0;
+    for (day = 0; day < 7; day++) {
+        list->Day_Start[day + 1] =
+            (uint16_t)(list->Day_Start[day] + count[day]);
+        apdu_len += weeklyschedule_day_decode(&apdu[apdu_len],
+            apdu_size - apdu_len, &list->Time_Values[list->Day_Start[day]],
+            &count[day]);
+    }
+
+    return apdu_len;
+}
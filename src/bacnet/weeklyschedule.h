@@ -25,6 +25,19 @@ extern "C" {
         bool singleDay;
     } BACNET_WEEKLY_SCHEDULE;
 
+    /**
+     * A compact BACnetARRAY[7] of BACnetDailySchedule: the time values
+     * of the days are kept one day after the other in one storage, so
+     * that each day uses only as many time values as it has.
+     */
+    typedef struct BACnet_Weekly_Schedule_List {
+        BACNET_TIME_VALUE *Time_Values; /* the storage of all the days */
+        uint16_t Size;  /* the number of time values of the storage */
+        /* the index of the first time value of each day, 0=Monday,
+           and [7] the number of time values actually used */
+        uint16_t Day_Start[8];
+    } BACNET_WEEKLY_SCHEDULE_LIST;
+
     /** Decode WeeklySchedule */
     BACNET_STACK_EXPORT
     int bacnet_weeklyschedule_decode(
@@ -51,6 +64,39 @@ extern "C" {
     bool bacnet_weeklyschedule_same(
         BACNET_WEEKLY_SCHEDULE *value1, BACNET_WEEKLY_SCHEDULE *value2);
 
+    BACNET_STACK_EXPORT
+    void bacnet_weeklyschedule_list_init(
+        BACNET_WEEKLY_SCHEDULE_LIST *list,
+        BACNET_TIME_VALUE *time_values,
+        uint16_t size);
+    BACNET_STACK_EXPORT
+    unsigned bacnet_weeklyschedule_list_day_count(
+        BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day);
+    BACNET_STACK_EXPORT
+    BACNET_TIME_VALUE *bacnet_weeklyschedule_list_day(
+        BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day);
+    BACNET_STACK_EXPORT
+    bool bacnet_weeklyschedule_list_day_set(
+        BACNET_WEEKLY_SCHEDULE_LIST *list,
+        unsigned day,
+        const BACNET_TIME_VALUE *time_values,
+        unsigned count);
+    BACNET_STACK_EXPORT
+    int bacnet_weeklyschedule_list_day_encode(
+        uint8_t *apdu, BACNET_WEEKLY_SCHEDULE_LIST *list, unsigned day);
+    BACNET_STACK_EXPORT
+    int bacnet_weeklyschedule_list_encode(
+        uint8_t *apdu, BACNET_WEEKLY_SCHEDULE_LIST *list);
+    BACNET_STACK_EXPORT
+    int bacnet_weeklyschedule_list_day_decode(
+        uint8_t *apdu,
+        int apdu_size,
+        BACNET_WEEKLY_SCHEDULE_LIST *list,
+        unsigned day);
+    BACNET_STACK_EXPORT
+    int bacnet_weeklyschedule_list_decode(
+        uint8_t *apdu, int apdu_size, BACNET_WEEKLY_SCHEDULE_LIST *list);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
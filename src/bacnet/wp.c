@@ -7,6 +7,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -186,114 +187,58 @@ int wp_encode_apdu(
 int wp_decode_service_request(
     uint8_t *apdu, unsigned apdu_size, BACNET_WRITE_PROPERTY_DATA *wpdata)
 {
-    int len = 0;
-    int apdu_len = 0;
+    BACNET_DECODE_CURSOR cursor = { 0 };
     uint32_t instance = 0;
     BACNET_OBJECT_TYPE type = OBJECT_NONE; /* for decoding */
     uint32_t property = 0; /* for decoding */
-    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
-    int i = 0; /* loop counter */
-    int imax = 0; /* max application data length */
+    BACNET_UNSIGNED_INTEGER array_index = BACNET_ARRAY_ALL;
+    BACNET_UNSIGNED_INTEGER priority = BACNET_MAX_PRIORITY;
+    uint8_t *application_data = NULL;
+    uint32_t application_data_len = 0;
 
-    /* check for value pointers */
-    if (!apdu) {
-        return BACNET_STATUS_ERROR;
-    }
+    bacnet_cursor_init(&cursor, apdu, apdu_size);
     /* object-identifier [0] BACnetObjectIdentifier */
-    len = bacnet_object_id_context_decode(
-        &apdu[apdu_len], apdu_size - apdu_len, 0, &type, &instance);
-    if (len > 0) {
-        if (instance > BACNET_MAX_INSTANCE) {
-            return BACNET_STATUS_ERROR;
-        }
-        apdu_len += len;
-        if (wpdata) {
-            wpdata->object_type = type;
-            wpdata->object_instance = instance;
-        }
-    } else {
-        return BACNET_STATUS_ERROR;
+    bacnet_cursor_object_id_context(&cursor, 0, &type, &instance);
+    if (instance > BACNET_MAX_INSTANCE) {
+        bacnet_cursor_error_set(&cursor);
     }
     /* property-identifier [1] BACnetPropertyIdentifier */
-    len = bacnet_enumerated_context_decode(
-        &apdu[apdu_len], apdu_size - apdu_len, 1, &property);
-    if (len > 0) {
-        apdu_len += len;
-        if (wpdata) {
-            wpdata->object_property = (BACNET_PROPERTY_ID)property;
-        }
-    } else {
-        return BACNET_STATUS_ERROR;
-    }
+    bacnet_cursor_enumerated_context(&cursor, 1, &property);
     /* property-array-index [2] Unsigned OPTIONAL */
-    len = bacnet_unsigned_context_decode(
-        &apdu[apdu_len], apdu_size - apdu_len, 2, &unsigned_value);
-    if (len > 0) {
-        apdu_len += len;
-        if (wpdata) {
-            wpdata->array_index = unsigned_value;
-        }
-    } else {
-        /* wrong tag - skip apdu_len increment and go to next field */
-        if (wpdata) {
-            wpdata->array_index = BACNET_ARRAY_ALL;
-        }
+    if (bacnet_cursor_is_context_tag(&cursor, 2)) {
+        bacnet_cursor_unsigned_context(&cursor, 2, &array_index);
     }
     /* property-value [3] ABSTRACT-SYNTAX.&Type */
-    if (!bacnet_is_opening_tag_number(
-            &apdu[apdu_len], apdu_size - apdu_len, 3, &len)) {
-        return BACNET_STATUS_ERROR;
-    }
-    /* determine the length of the data blob */
-    imax = bacapp_data_len(
-        &apdu[apdu_len], apdu_size - apdu_len, (BACNET_PROPERTY_ID)property);
-    if (imax == BACNET_STATUS_ERROR) {
-        return BACNET_STATUS_ERROR;
-    }
-    /* count the opening tag number length */
-    apdu_len += len;
-    /* copy the data from the APDU */
-    if (imax > MAX_APDU) {
+    bacnet_cursor_enclosed_data(
+        &cursor, 3, &application_data, &application_data_len);
+    if (application_data_len > MAX_APDU) {
         /* not enough size in application_data to store the data chunk */
-        return BACNET_STATUS_ERROR;
-    } else if (wpdata) {
-        for (i = 0; i < imax; i++) {
-            wpdata->application_data[i] = apdu[apdu_len + i];
+        bacnet_cursor_error_set(&cursor);
+    }
+    /* priority [4] Unsigned (1..16) OPTIONAL */
+    /* assumed MAX priority if not explicitly set */
+    if (bacnet_cursor_remaining(&cursor) > 0) {
+        bacnet_cursor_unsigned_context(&cursor, 4, &priority);
+        if ((priority < BACNET_MIN_PRIORITY) ||
+            (priority > BACNET_MAX_PRIORITY)) {
+            bacnet_cursor_error_set(&cursor);
         }
-        wpdata->application_data_len = imax;
     }
-    /* add on the data length */
-    apdu_len += imax;
-    if (!bacnet_is_closing_tag_number(
-            &apdu[apdu_len], apdu_size - apdu_len, 3, &len)) {
+    if (bacnet_cursor_error(&cursor)) {
         return BACNET_STATUS_ERROR;
     }
-    /* count the closing tag number length */
-    apdu_len += len;
-    /* priority [4] Unsigned (1..16) OPTIONAL */
-    /* assumed MAX priority if not explicitly set */
     if (wpdata) {
-        wpdata->priority = BACNET_MAX_PRIORITY;
-    }
-    if ((unsigned)apdu_len < apdu_size) {
-        len = bacnet_unsigned_context_decode(
-            &apdu[apdu_len], apdu_len - apdu_size, 4, &unsigned_value);
-        if (len > 0) {
-            apdu_len += len;
-            if ((unsigned_value >= BACNET_MIN_PRIORITY) &&
-                (unsigned_value <= BACNET_MAX_PRIORITY)) {
-                if (wpdata) {
-                    wpdata->priority = (uint8_t)unsigned_value;
-                }
-            } else {
-                return BACNET_STATUS_ERROR;
-            }
-        } else {
-            return BACNET_STATUS_ERROR;
-        }
+        wpdata->object_type = type;
+        wpdata->object_instance = instance;
+        wpdata->object_property = (BACNET_PROPERTY_ID)property;
+        wpdata->array_index = array_index;
+        memcpy(wpdata->application_data, application_data,
+            application_data_len);
+        wpdata->application_data_len = (int)application_data_len;
+        wpdata->priority = (uint8_t)priority;
     }
 
-    return apdu_len;
+    return bacnet_cursor_len(&cursor);
 }
 
 /**
@@ -8,6 +8,7 @@
  * @brief test BACnet integer encode/decode APIs
  */
 
+#include <math.h>
 #include <stdint.h>
 #include <string.h>
 #include <zephyr/ztest.h>
@@ -388,6 +389,136 @@ static void test_bacapp_property_value_list(void)
     }
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacapp_tests, test_bacapp_value_ref)
+#else
+static void test_bacapp_value_ref(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value[8] = { { 0 } };
+    BACNET_APPLICATION_DATA_VALUE test_value = { 0 };
+    BACNET_APPLICATION_DATA_VALUE_REF ref = { 0 };
+    BACNET_PROPERTY_VALUE property = { 0 };
+    BACNET_PROPERTY_VALUE test_property = { 0 };
+    BACNET_PROPERTY_VALUE_REF property_ref[2] = { { 0 } };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t octets[4] = { 1, 2, 3, 4 };
+    int len, test_len;
+    unsigned i;
+    bool status;
+
+    value[0].tag = BACNET_APPLICATION_TAG_NULL;
+    value[1].tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value[1].type.Boolean = true;
+    value[2].tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value[2].type.Unsigned_Int = 12345;
+    value[3].tag = BACNET_APPLICATION_TAG_REAL;
+    value[3].type.Real = 3.14159f;
+    value[4].tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value[4].type.Enumerated = 42;
+    value[5].tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(&value[5].type.Character_String, "Hello World");
+    value[6].tag = BACNET_APPLICATION_TAG_OCTET_STRING;
+    octetstring_init(&value[6].type.Octet_String, octets, sizeof(octets));
+    value[7].tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value[7].type.Bit_String);
+    bitstring_set_bit(&value[7].type.Bit_String, 0, true);
+    bitstring_set_bit(&value[7].type.Bit_String, 3, true);
+    for (i = 0; i < ARRAY_SIZE(value); i++) {
+        len = bacapp_encode_application_data(apdu, &value[i]);
+        zassert_true(len > 0, NULL);
+        test_len = bacapp_decode_application_data_ref(apdu, len, &ref);
+        zassert_equal(len, test_len, "len=%d test_len=%d", len, test_len);
+        zassert_equal(ref.tag, value[i].tag, NULL);
+        zassert_equal(ref.apdu, apdu, NULL);
+        zassert_equal(ref.apdu_len, len, NULL);
+        zassert_is_null(ref.next, NULL);
+        zassert_true(bacapp_same_value_ref(&ref, &value[i]), NULL);
+        status = bacapp_value_ref_materialize(&ref, &test_value);
+        zassert_true(status, NULL);
+        zassert_true(bacapp_same_value(&value[i], &test_value), NULL);
+        if (i > 0) {
+            zassert_false(bacapp_same_value_ref(&ref, &value[i - 1]), NULL);
+        }
+        if (len > 1) {
+            /* too short */
+            test_len = bacapp_decode_application_data_ref(apdu, len - 1, &ref);
+            zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+        }
+    }
+    /* the payload stays in the buffer */
+    len = bacapp_encode_application_data(apdu, &value[5]);
+    test_len = bacapp_decode_application_data_ref(apdu, len, &ref);
+    zassert_equal(len, test_len, NULL);
+    zassert_true(ref.type.Payload.value > apdu, NULL);
+    zassert_true(ref.type.Payload.value < &apdu[len], NULL);
+    zassert_equal(ref.type.Payload.length, 11, NULL);
+    zassert_equal(ref.type.Payload.prefix, CHARACTER_ANSI_X34, NULL);
+    characterstring_init_ansi(&test_value.type.Character_String, "Hello There");
+    test_value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    zassert_false(bacapp_same_value_ref(&ref, &test_value), NULL);
+    /* bad args and context tags */
+    zassert_equal(bacapp_decode_application_data_ref(apdu, len, NULL), 0, NULL);
+    zassert_false(bacapp_same_value_ref(NULL, &value[0]), NULL);
+    zassert_false(bacapp_same_value_ref(&ref, NULL), NULL);
+    zassert_false(bacapp_value_ref_materialize(NULL, &test_value), NULL);
+    len = encode_context_unsigned(apdu, 1, 1);
+    test_len = bacapp_decode_application_data_ref(apdu, len, &ref);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+
+    /* BACnetPropertyValue with a list of values */
+    bacapp_property_value_list_init(&property, 1);
+    property.propertyIdentifier = PROP_DESCRIPTION;
+    property.propertyArrayIndex = 2;
+    property.priority = 8;
+    property.value = value[5];
+    property.value.next = &value[6];
+    value[6].next = NULL;
+    len = bacapp_property_value_encode(apdu, &property);
+    zassert_true(len > 0, NULL);
+    bacapp_property_value_ref_list_init(NULL, 1);
+    bacapp_property_value_ref_list_init(property_ref, ARRAY_SIZE(property_ref));
+    zassert_equal(property_ref[0].next, &property_ref[1], NULL);
+    zassert_is_null(property_ref[1].next, NULL);
+    test_len = bacapp_property_value_ref_decode(apdu, len, &property_ref[0]);
+    zassert_equal(len, test_len, "len=%d test_len=%d", len, test_len);
+    test_len = bacapp_property_value_ref_decode(apdu, len, NULL);
+    zassert_equal(len, test_len, "len=%d test_len=%d", len, test_len);
+    zassert_equal(
+        property_ref[0].propertyIdentifier, property.propertyIdentifier, NULL);
+    zassert_equal(
+        property_ref[0].propertyArrayIndex, property.propertyArrayIndex, NULL);
+    zassert_equal(property_ref[0].priority, property.priority, NULL);
+    zassert_true(
+        bacapp_same_value_ref(&property_ref[0].value, &value[5]), NULL);
+    zassert_true(property_ref[0].application_data_len > 0, NULL);
+    /* the second value is only in the application data */
+    len = bacapp_decode_application_data_ref(
+        property_ref[0].application_data + property_ref[0].value.apdu_len,
+        property_ref[0].application_data_len - property_ref[0].value.apdu_len,
+        &ref);
+    zassert_true(len > 0, NULL);
+    zassert_true(bacapp_same_value_ref(&ref, &value[6]), NULL);
+    /* copy both values into full values */
+    bacapp_property_value_list_init(&test_property, 1);
+    test_property.value.next = &test_value;
+    status =
+        bacapp_property_value_ref_materialize(&property_ref[0], &test_property);
+    zassert_true(status, NULL);
+    zassert_equal(
+        test_property.propertyIdentifier, property.propertyIdentifier, NULL);
+    zassert_equal(
+        test_property.propertyArrayIndex, property.propertyArrayIndex, NULL);
+    zassert_equal(test_property.priority, property.priority, NULL);
+    zassert_true(bacapp_same_value(&test_property.value, &value[5]), NULL);
+    zassert_true(bacapp_same_value(&test_value, &value[6]), NULL);
+    /* not enough values to hold the list */
+    test_property.value.next = NULL;
+    status =
+        bacapp_property_value_ref_materialize(&property_ref[0], &test_property);
+    zassert_false(status, NULL);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(bacapp_tests, test_bacapp_same_value)
 #else
@@ -1282,6 +1413,70 @@ static void test_bacapp_sprintf_data(void)
     }
 }
 
+/**
+ * @brief Test the parse of a column of values
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacapp_tests, test_bacapp_parse_application_data_array)
+#else
+static void test_bacapp_parse_application_data_array(void)
+#endif
+{
+    char row_0[] = "12.5";
+    char row_1[] = "-3";
+    char row_2[] = "not a number";
+    char row_3[] = "1e3";
+    char *rows[] = { row_0, row_1, row_2, NULL, row_3 };
+    BACNET_APPLICATION_DATA_VALUE value[5] = { 0 };
+    bool row_status[5] = { 0 };
+    char schedule_0[] = "(1; Mon: [07:00:00.00 active, 18:00:00.00 FALSE]; "
+                        "Tue: [])";
+    char schedule_1[] = "(4; [06:30:00.00 21.5])";
+    char *schedules[] = { schedule_0, schedule_1 };
+    BACNET_APPLICATION_DATA_VALUE schedule_value[2] = { 0 };
+    BACNET_WEEKLY_SCHEDULE *weekly;
+    size_t count;
+
+    count = bacapp_parse_application_data_array(
+        BACNET_APPLICATION_TAG_REAL, rows, 5, value, row_status);
+    zassert_equal(count, 3, NULL);
+    zassert_true(row_status[0], NULL);
+    zassert_true(row_status[1], NULL);
+    zassert_false(row_status[2], NULL);
+    zassert_false(row_status[3], NULL);
+    zassert_true(row_status[4], NULL);
+    zassert_equal(value[0].tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    zassert_false(islessgreater(value[0].type.Real, 12.5f), NULL);
+    zassert_false(islessgreater(value[1].type.Real, -3.0f), NULL);
+    zassert_false(islessgreater(value[4].type.Real, 1000.0f), NULL);
+    zassert_is_null(value[0].next, NULL);
+    zassert_is_null(value[4].next, NULL);
+    count = bacapp_parse_application_data_array(
+        BACNET_APPLICATION_TAG_NULL, rows, 4, value, NULL);
+    zassert_equal(count, 4, NULL);
+    zassert_equal(
+        bacapp_parse_application_data_array(
+            BACNET_APPLICATION_TAG_REAL, NULL, 5, value, row_status),
+        0, NULL);
+    /* the weekly schedules are split in place, one after the other */
+    count = bacapp_parse_application_data_array(
+        BACNET_APPLICATION_TAG_WEEKLY_SCHEDULE, schedules, 2, schedule_value,
+        row_status);
+    zassert_equal(count, 2, NULL);
+    weekly = &schedule_value[0].type.Weekly_Schedule;
+    zassert_false(weekly->singleDay, NULL);
+    zassert_equal(weekly->weeklySchedule[0].TV_Count, 2, NULL);
+    zassert_equal(weekly->weeklySchedule[0].Time_Values[0].Time.hour, 7, NULL);
+    zassert_equal(
+        weekly->weeklySchedule[0].Time_Values[1].Time.hour, 18, NULL);
+    zassert_equal(weekly->weeklySchedule[1].TV_Count, 0, NULL);
+    weekly = &schedule_value[1].type.Weekly_Schedule;
+    zassert_true(weekly->singleDay, NULL);
+    zassert_equal(weekly->weeklySchedule[0].TV_Count, 1, NULL);
+    zassert_equal(
+        weekly->weeklySchedule[0].Time_Values[0].Time.min, 30, NULL);
+}
+
 /**
  * @}
  */
@@ -1298,11 +1493,13 @@ void test_main(void)
         ztest_unit_test(test_bacapp_value_list_init),
         ztest_unit_test(test_bacapp_property_value_list),
         ztest_unit_test(test_bacapp_same_value),
+        ztest_unit_test(test_bacapp_value_ref),
         ztest_unit_test(testBACnetApplicationData),
         ztest_unit_test(testBACnetApplicationDataLength),
         ztest_unit_test(testBACnetApplicationData_Safe),
         ztest_unit_test(test_bacapp_context_data),
-        ztest_unit_test(test_bacapp_sprintf_data));
+        ztest_unit_test(test_bacapp_sprintf_data),
+        ztest_unit_test(test_bacapp_parse_application_data_array));
 
     ztest_run_test_suite(bacapp_tests);
 }
@@ -2010,6 +2010,276 @@ static void test_bacnet_array_encode(void)
     zassert_true(apdu_len == BACNET_STATUS_ABORT, NULL);
 }
 
+/**
+ * @brief Test the length of the data between an opening and closing tag
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_enclosed_data_length)
+#else
+static void test_bacnet_enclosed_data_length(void)
+#endif
+{
+    uint8_t apdu[400] = { 0 };
+    int apdu_len = 0, len = 0, test_len = 0;
+
+    /* [3] { REAL, [0] { [1] BOOLEAN, [40] Unsigned, OCTET STRING } } */
+    len = encode_opening_tag(&apdu[0], 3);
+    apdu_len = len;
+    len = encode_application_real(&apdu[apdu_len], 1.0f);
+    apdu_len += len;
+    len = encode_opening_tag(&apdu[apdu_len], 0);
+    apdu_len += len;
+    len = encode_context_boolean(&apdu[apdu_len], 1, true);
+    apdu_len += len;
+    len = encode_context_unsigned(&apdu[apdu_len], 40, 12345);
+    apdu_len += len;
+    /* a long octet string, with an extended length */
+    len = encode_tag(
+        &apdu[apdu_len], BACNET_APPLICATION_TAG_OCTET_STRING, false, 300);
+    apdu_len += len + 300;
+    len = encode_closing_tag(&apdu[apdu_len], 0);
+    apdu_len += len;
+    len = encode_closing_tag(&apdu[apdu_len], 3);
+    apdu_len += len;
+    /* data after the closing tag is not included */
+    len = encode_application_boolean(&apdu[apdu_len], true);
+    test_len = bacnet_enclosed_data_length(apdu, apdu_len + len);
+    zassert_equal(test_len, apdu_len - 2, "len=%d", test_len);
+    test_len = bacnet_enclosed_data_length(apdu, apdu_len);
+    zassert_equal(test_len, apdu_len - 2, "len=%d", test_len);
+    /* the closing tag is missing */
+    test_len = bacnet_enclosed_data_length(apdu, apdu_len - 1);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    /* the octet string is truncated */
+    test_len = bacnet_enclosed_data_length(apdu, 20);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    /* the data does not start with an opening tag */
+    test_len = bacnet_enclosed_data_length(&apdu[1], apdu_len - 1);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    test_len = bacnet_enclosed_data_length(NULL, apdu_len);
+    zassert_equal(test_len, BACNET_STATUS_ERROR, NULL);
+    /* empty data with an extended tag number */
+    len = encode_opening_tag(&apdu[0], 200);
+    len += encode_closing_tag(&apdu[len], 200);
+    test_len = bacnet_enclosed_data_length(apdu, len);
+    zassert_equal(test_len, 0, "len=%d", test_len);
+}
+
+/**
+ * @brief Test the fixed width encoders against the general tag encoding
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_fixed_width_encode)
+#else
+static void test_bacnet_fixed_width_encode(void)
+#endif
+{
+    uint8_t apdu[16] = { 0 };
+    uint8_t test_apdu[16] = { 0 };
+    const uint32_t values[] = { 0, 1, 255, 256, 65535, 65536, UINT32_MAX };
+    const uint8_t tag_numbers[] = { 0, 14, 15, 254 };
+    int len, test_len, null_len;
+    unsigned i, t;
+    uint8_t tag_number;
+
+    for (t = 0; t < ARRAY_SIZE(tag_numbers); t++) {
+        tag_number = tag_numbers[t];
+        for (i = 0; i < ARRAY_SIZE(values); i++) {
+            /* enumerated */
+            test_len = encode_tag(&test_apdu[0], tag_number, true,
+                bacnet_unsigned_length(values[i]));
+            test_len += encode_bacnet_enumerated(
+                &test_apdu[test_len], values[i]);
+            null_len = encode_context_enumerated(NULL, tag_number, values[i]);
+            len = encode_context_enumerated(&apdu[0], tag_number, values[i]);
+            zassert_equal(len, test_len, NULL);
+            zassert_equal(null_len, test_len, NULL);
+            zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+            /* unsigned */
+            null_len = encode_context_unsigned(NULL, tag_number, values[i]);
+            len = encode_context_unsigned(&apdu[0], tag_number, values[i]);
+            zassert_equal(len, test_len, NULL);
+            zassert_equal(null_len, test_len, NULL);
+            zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+        }
+        /* real */
+        test_len = encode_tag(&test_apdu[0], tag_number, true, 4);
+        test_len += encode_bacnet_real(-1.5f, &test_apdu[test_len]);
+        null_len = encode_context_real(NULL, tag_number, -1.5f);
+        len = encode_context_real(&apdu[0], tag_number, -1.5f);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(null_len, test_len, NULL);
+        zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+        /* object identifier */
+        test_len = encode_tag(&test_apdu[0], tag_number, true, 4);
+        test_len += encode_bacnet_object_id(
+            &test_apdu[test_len], OBJECT_ANALOG_INPUT, BACNET_MAX_INSTANCE);
+        null_len = encode_context_object_id(
+            NULL, tag_number, OBJECT_ANALOG_INPUT, BACNET_MAX_INSTANCE);
+        len = encode_context_object_id(
+            &apdu[0], tag_number, OBJECT_ANALOG_INPUT, BACNET_MAX_INSTANCE);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(null_len, test_len, NULL);
+        zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+    }
+    for (i = 0; i < ARRAY_SIZE(values); i++) {
+        test_len = encode_tag(&test_apdu[0], BACNET_APPLICATION_TAG_ENUMERATED,
+            false, bacnet_unsigned_length(values[i]));
+        test_len += encode_bacnet_enumerated(&test_apdu[test_len], values[i]);
+        len = encode_application_enumerated(&apdu[0], values[i]);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(encode_application_enumerated(NULL, values[i]),
+            test_len, NULL);
+        zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+        test_apdu[0] = (test_apdu[0] & 0x0F) |
+            (BACNET_APPLICATION_TAG_UNSIGNED_INT << 4);
+        len = encode_application_unsigned(&apdu[0], values[i]);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(encode_application_unsigned(NULL, values[i]),
+            test_len, NULL);
+        zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+    }
+    test_len = encode_tag(&test_apdu[0], BACNET_APPLICATION_TAG_REAL, false, 4);
+    test_len += encode_bacnet_real(21.0f, &test_apdu[test_len]);
+    len = encode_application_real(&apdu[0], 21.0f);
+    zassert_equal(len, test_len, NULL);
+    zassert_equal(encode_application_real(NULL, 21.0f), test_len, NULL);
+    zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+    test_len = encode_tag(
+        &test_apdu[0], BACNET_APPLICATION_TAG_OBJECT_ID, false, 4);
+    test_len += encode_bacnet_object_id(
+        &test_apdu[test_len], OBJECT_DEVICE, 1234);
+    len = encode_application_object_id(&apdu[0], OBJECT_DEVICE, 1234);
+    zassert_equal(len, test_len, NULL);
+    zassert_equal(encode_application_object_id(NULL, OBJECT_DEVICE, 1234),
+        test_len, NULL);
+    zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+}
+
+/**
+ * @brief Test the decoding of fields with a cursor
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_decode_cursor)
+#else
+static void test_bacnet_decode_cursor(void)
+#endif
+{
+    uint8_t apdu[64] = { 0 };
+    BACNET_DECODE_CURSOR cursor = { 0 };
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t instance = 0, enum_value = 0, data_len = 0;
+    uint8_t *data = NULL;
+    bool boolean_value = false;
+    int len = 0, apdu_len = 0;
+
+    apdu_len = encode_context_unsigned(&apdu[0], 0, 1234);
+    apdu_len += encode_context_object_id(
+        &apdu[apdu_len], 1, OBJECT_ANALOG_VALUE, 42);
+    apdu_len += encode_context_enumerated(&apdu[apdu_len], 2, 85);
+    apdu_len += encode_context_boolean(&apdu[apdu_len], 3, true);
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 4);
+    len = encode_application_real(&apdu[apdu_len], 1.0f);
+    apdu_len += len;
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 4);
+    bacnet_cursor_init(&cursor, apdu, apdu_len);
+    zassert_false(bacnet_cursor_error(&cursor), NULL);
+    zassert_true(bacnet_cursor_unsigned_context(&cursor, 0, &unsigned_value),
+        NULL);
+    zassert_equal(unsigned_value, 1234, NULL);
+    zassert_false(bacnet_cursor_is_context_tag(&cursor, 0), NULL);
+    zassert_true(bacnet_cursor_is_context_tag(&cursor, 1), NULL);
+    zassert_true(bacnet_cursor_object_id_context(
+                     &cursor, 1, &object_type, &instance),
+        NULL);
+    zassert_equal(object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(instance, 42, NULL);
+    zassert_true(
+        bacnet_cursor_enumerated_context(&cursor, 2, &enum_value), NULL);
+    zassert_equal(enum_value, 85, NULL);
+    zassert_true(
+        bacnet_cursor_boolean_context(&cursor, 3, &boolean_value), NULL);
+    zassert_true(boolean_value, NULL);
+    zassert_true(bacnet_cursor_is_opening_tag(&cursor, 4), NULL);
+    zassert_true(
+        bacnet_cursor_enclosed_data(&cursor, 4, &data, &data_len), NULL);
+    zassert_equal(data_len, len, NULL);
+    zassert_equal(data, &apdu[apdu_len - len - 1], NULL);
+    zassert_equal(bacnet_cursor_remaining(&cursor), 0, NULL);
+    zassert_equal(bacnet_cursor_len(&cursor), apdu_len, NULL);
+    /* a wrong tag fails the decoding, and the fields after it */
+    bacnet_cursor_init(&cursor, apdu, apdu_len);
+    zassert_false(bacnet_cursor_unsigned_context(&cursor, 1, &unsigned_value),
+        NULL);
+    zassert_true(bacnet_cursor_error(&cursor), NULL);
+    zassert_false(bacnet_cursor_unsigned_context(&cursor, 0, &unsigned_value),
+        NULL);
+    zassert_equal(bacnet_cursor_len(&cursor), BACNET_STATUS_ERROR, NULL);
+    zassert_equal(bacnet_cursor_remaining(&cursor), 0, NULL);
+    zassert_is_null(bacnet_cursor_apdu(&cursor), NULL);
+    /* a field cut short by the end of the buffer */
+    bacnet_cursor_init(&cursor, apdu, 2);
+    zassert_false(bacnet_cursor_unsigned_context(&cursor, 0, &unsigned_value),
+        NULL);
+    zassert_true(bacnet_cursor_error(&cursor), NULL);
+    bacnet_cursor_init(&cursor, apdu, apdu_len - 1);
+    zassert_true(bacnet_cursor_skip(&cursor, apdu_len - len - 3), NULL);
+    zassert_false(
+        bacnet_cursor_enclosed_data(&cursor, 4, &data, &data_len), NULL);
+    zassert_true(bacnet_cursor_error(&cursor), NULL);
+    /* skip beyond the end */
+    bacnet_cursor_init(&cursor, apdu, apdu_len);
+    zassert_false(bacnet_cursor_skip(&cursor, apdu_len + 1), NULL);
+    zassert_true(bacnet_cursor_error(&cursor), NULL);
+    bacnet_cursor_init(&cursor, apdu, apdu_len);
+    zassert_false(bacnet_cursor_skip(&cursor, BACNET_STATUS_ERROR), NULL);
+    zassert_true(bacnet_cursor_error(&cursor), NULL);
+    /* a value out of range */
+    bacnet_cursor_init(&cursor, apdu, apdu_len);
+    bacnet_cursor_error_set(&cursor);
+    zassert_equal(bacnet_cursor_len(&cursor), BACNET_STATUS_ERROR, NULL);
+    /* no buffer */
+    bacnet_cursor_init(&cursor, NULL, apdu_len);
+    zassert_true(bacnet_cursor_error(&cursor), NULL);
+    zassert_false(bacnet_cursor_unsigned_context(&cursor, 0, &unsigned_value),
+        NULL);
+}
+
+/**
+ * @brief Test the encoding of a C string as a BACnet Character String
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_character_string_ansi_encode)
+#else
+static void test_bacnet_character_string_ansi_encode(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    const char *values[] = { "", "Joshua", NULL };
+    int len, test_len;
+    unsigned i;
+
+    for (i = 0; i < ARRAY_SIZE(values); i++) {
+        characterstring_init_ansi(&char_string, values[i]);
+        test_len =
+            encode_application_character_string(&test_apdu[0], &char_string);
+        len = encode_application_character_string_ansi(&apdu[0], values[i]);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(
+            encode_application_character_string_ansi(NULL, values[i]), len,
+            NULL);
+        zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+        test_len =
+            encode_context_character_string(&test_apdu[0], 3, &char_string);
+        len = encode_context_character_string_ansi(&apdu[0], 3, values[i]);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(memcmp(apdu, test_apdu, len), 0, NULL);
+    }
+}
+
 /**
  * @}
  */
@@ -2049,7 +2319,11 @@ void test_main(void)
         ztest_unit_test(testDateRangeContextDecodes),
         ztest_unit_test(testOctetStringContextDecodes),
         ztest_unit_test(testBACDCodeDouble),
-        ztest_unit_test(test_bacnet_array_encode));
+        ztest_unit_test(test_bacnet_array_encode),
+        ztest_unit_test(test_bacnet_enclosed_data_length),
+        ztest_unit_test(test_bacnet_fixed_width_encode),
+        ztest_unit_test(test_bacnet_decode_cursor),
+        ztest_unit_test(test_bacnet_character_string_ansi_encode));
 
     ztest_run_test_suite(bacdcode_tests);
 }
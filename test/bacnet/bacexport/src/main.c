@@ -0,0 +1,273 @@
+/**
+ * @file
+ * @brief test of the export of property values as text and JSON
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacexport.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Set up an object property value for the tests
+ * @param object_value - object property value to set up
+ * @param value - value of the property
+ */
+static void test_object_value_init(
+    BACNET_OBJECT_PROPERTY_VALUE *object_value,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    object_value->object_type = OBJECT_ANALOG_INPUT;
+    object_value->object_instance = 1;
+    object_value->object_property = PROP_PRESENT_VALUE;
+    object_value->array_index = BACNET_ARRAY_ALL;
+    object_value->value = value;
+    value->next = NULL;
+}
+
+/**
+ * @brief Check that the text of a value is the text of
+ *  bacapp_snprintf_value()
+ * @param value - value to check
+ */
+static void test_text_value(BACNET_APPLICATION_DATA_VALUE *value)
+{
+    BACNET_OBJECT_PROPERTY_VALUE object_value;
+    DYNAMIC_BUFFER b;
+    char text[256];
+    int len;
+
+    test_object_value_init(&object_value, value);
+    len = bacapp_snprintf_value(text, sizeof(text), &object_value);
+    zassert_true(len > 0, NULL);
+    dbuf_init(&b);
+    zassert_true(dbuf_append_string(&b, "x="), NULL);
+    zassert_true(bacexport_text_value(&b, &object_value), NULL);
+    zassert_equal(dbuf_count(&b), 2 + len, NULL);
+    zassert_equal(strcmp(dbuf_data(&b) + 2, text), 0, "%s is not %s",
+        dbuf_data(&b) + 2, text);
+    dbuf_cleanup(&b);
+}
+
+/**
+ * @brief Check the JSON of a value
+ * @param value - value to check
+ * @param json - expected JSON
+ */
+static void
+test_json_value(BACNET_APPLICATION_DATA_VALUE *value, const char *json)
+{
+    BACNET_OBJECT_PROPERTY_VALUE object_value;
+    DYNAMIC_BUFFER b;
+
+    test_object_value_init(&object_value, value);
+    dbuf_init(&b);
+    zassert_true(bacexport_json_value(&b, &object_value), NULL);
+    zassert_equal(strcmp(dbuf_data(&b), json), 0, "%s is not %s",
+        dbuf_data(&b), json);
+    dbuf_cleanup(&b);
+}
+
+/**
+ * @brief Test the text of values, which is the same as
+ *  bacapp_snprintf_value()
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacexport_tests, testExportText)
+#else
+static void testExportText(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    static const struct {
+        BACNET_APPLICATION_TAG tag;
+        char *text;
+    } values[] = { { BACNET_APPLICATION_TAG_BOOLEAN, "1" },
+        { BACNET_APPLICATION_TAG_UNSIGNED_INT, "0" },
+        { BACNET_APPLICATION_TAG_UNSIGNED_INT, "4294967295" },
+        { BACNET_APPLICATION_TAG_SIGNED_INT, "-2147483648" },
+        { BACNET_APPLICATION_TAG_SIGNED_INT, "-1" },
+        { BACNET_APPLICATION_TAG_REAL, "21.5" },
+        { BACNET_APPLICATION_TAG_REAL, "-0.0078125" },
+        { BACNET_APPLICATION_TAG_REAL, "1e20" },
+        { BACNET_APPLICATION_TAG_DOUBLE, "0.125" },
+        { BACNET_APPLICATION_TAG_DOUBLE, "-123456.789" },
+        { BACNET_APPLICATION_TAG_OCTET_STRING, "01A5FF" },
+        { BACNET_APPLICATION_TAG_CHARACTER_STRING, "Hello, World!" },
+        { BACNET_APPLICATION_TAG_ENUMERATED, "42" },
+        { BACNET_APPLICATION_TAG_OBJECT_ID, "8:4194303" },
+        { BACNET_APPLICATION_TAG_OBJECT_ID, "0:12" },
+        { BACNET_APPLICATION_TAG_DATE, "2026/10/14" },
+        { BACNET_APPLICATION_TAG_TIME, "12:34:56.78" } };
+    unsigned i;
+    bool status;
+
+    for (i = 0; i < (sizeof(values) / sizeof(values[0])); i++) {
+        memset(&value, 0, sizeof(value));
+        status = bacapp_parse_application_data(
+            values[i].tag, values[i].text, &value);
+        zassert_true(status, "%s", values[i].text);
+        test_text_value(&value);
+    }
+    value.tag = BACNET_APPLICATION_TAG_NULL;
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = true;
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 123456;
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_SIGNED_INT;
+    value.type.Signed_Int = -123456;
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 72.4f;
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_DOUBLE;
+    value.type.Double = -1.0 / 3.0;
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(&value.type.Character_String, "Zone 1");
+    test_text_value(&value);
+    characterstring_init_ansi(&value.type.Character_String, "Tab\there");
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_OCTET_STRING;
+    octetstring_init(&value.type.Octet_String, (uint8_t *)"\x12\xAB", 2);
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value.type.Bit_String);
+    bitstring_set_bit(&value.type.Bit_String, 0, true);
+    bitstring_set_bit(&value.type.Bit_String, 3, false);
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_OBJECT_ID;
+    value.type.Object_Id.type = OBJECT_DEVICE;
+    value.type.Object_Id.instance = 260001;
+    test_text_value(&value);
+    value.type.Object_Id.type = 1000;
+    test_text_value(&value);
+    value.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value.type.Enumerated = 1;
+    test_text_value(&value);
+}
+
+/**
+ * @brief Test the JSON of values and of properties
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacexport_tests, testExportJSON)
+#else
+static void testExportJSON(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 }, value2 = { 0 };
+    BACNET_OBJECT_PROPERTY_VALUE object_value;
+    DYNAMIC_BUFFER b;
+
+    value.tag = BACNET_APPLICATION_TAG_NULL;
+    test_json_value(&value, "null");
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = false;
+    test_json_value(&value, "false");
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 42;
+    test_json_value(&value, "42");
+    value.tag = BACNET_APPLICATION_TAG_SIGNED_INT;
+    value.type.Signed_Int = -42;
+    test_json_value(&value, "-42");
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 21.5f;
+    test_json_value(&value, "21.500000");
+    value.type.Real = 1.0f / 0.0f;
+    test_json_value(&value, "null");
+    value.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value.type.Enumerated = 3;
+    test_json_value(&value, "3");
+    value.tag = BACNET_APPLICATION_TAG_OCTET_STRING;
+    octetstring_init(&value.type.Octet_String, (uint8_t *)"\x12\xAB", 2);
+    test_json_value(&value, "\"12AB\"");
+    value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(
+        &value.type.Character_String, "say \"hi\"\\\n\x01");
+    test_json_value(&value, "\"say \\\"hi\\\"\\\\\\u000a\\u0001\"");
+    characterstring_init(&value.type.Character_String, CHARACTER_ISO8859,
+        "\xB0" "C", 2);
+    test_json_value(&value, "\"\xC2\xB0" "C\"");
+    value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value.type.Bit_String);
+    bitstring_set_bit(&value.type.Bit_String, 1, true);
+    test_json_value(&value, "[false,true]");
+    value.tag = BACNET_APPLICATION_TAG_OBJECT_ID;
+    value.type.Object_Id.type = OBJECT_DEVICE;
+    value.type.Object_Id.instance = 260001;
+    test_json_value(
+        &value, "{\"object-type\":\"device\",\"object-instance\":260001}");
+    value.type.Object_Id.type = 1000;
+    test_json_value(
+        &value, "{\"object-type\":1000,\"object-instance\":260001}");
+    /* properties */
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 72.25f;
+    test_object_value_init(&object_value, &value);
+    dbuf_init(&b);
+    zassert_true(bacexport_json_property(&b, &object_value), NULL);
+    zassert_equal(
+        strcmp(dbuf_data(&b),
+            "{\"object-type\":\"analog-input\",\"object-instance\":1,"
+            "\"property\":\"present-value\",\"value\":72.250000}"),
+        0, "%s", dbuf_data(&b));
+    dbuf_reset(&b);
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 1;
+    value2.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value2.type.Unsigned_Int = 2;
+    value.next = &value2;
+    object_value.object_property = PROP_PRIORITY;
+    zassert_true(bacexport_json_property(&b, &object_value), NULL);
+    zassert_equal(
+        strcmp(dbuf_data(&b),
+            "{\"object-type\":\"analog-input\",\"object-instance\":1,"
+            "\"property\":\"priority\",\"value\":[1,2]}"),
+        0, "%s", dbuf_data(&b));
+    dbuf_reset(&b);
+    value.next = NULL;
+    object_value.array_index = 2;
+    object_value.object_property = 9999;
+    zassert_true(bacexport_json_property(&b, &object_value), NULL);
+    zassert_equal(
+        strcmp(dbuf_data(&b),
+            "{\"object-type\":\"analog-input\",\"object-instance\":1,"
+            "\"property\":9999,\"array-index\":2,\"value\":1}"),
+        0, "%s", dbuf_data(&b));
+    dbuf_reset(&b);
+    object_value.value = NULL;
+    zassert_true(bacexport_json_property(&b, &object_value), NULL);
+    zassert_equal(
+        strcmp(dbuf_data(&b),
+            "{\"object-type\":\"analog-input\",\"object-instance\":1,"
+            "\"property\":9999,\"array-index\":2,\"value\":null}"),
+        0, "%s", dbuf_data(&b));
+    zassert_false(bacexport_json_value(&b, &object_value), NULL);
+    zassert_false(bacexport_json_property(NULL, &object_value), NULL);
+    dbuf_cleanup(&b);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bacexport_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bacexport_tests, ztest_unit_test(testExportText),
+        ztest_unit_test(testExportJSON));
+
+    ztest_run_test_suite(bacexport_tests);
+}
+#endif
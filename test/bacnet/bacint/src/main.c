@@ -457,6 +457,45 @@ static void testBACnetSigned32(void)
         zassert_equal(value, test_value, NULL);
     }
 }
+/**
+ * @brief Test the byte order of the encoded integers, which is big-endian
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacint_tests, testBACnetUnsignedByteOrder)
+#else
+static void testBACnetUnsignedByteOrder(void)
+#endif
+{
+    uint8_t apdu[8] = { 0 };
+    const uint8_t test_apdu[8] = { 0x12, 0x34, 0x56, 0x78, 0xAA, 0xAA, 0xAA,
+        0xAA };
+    uint16_t value16 = 0;
+    uint32_t value32 = 0;
+
+    memset(apdu, 0xAA, sizeof(apdu));
+    encode_unsigned16(&apdu[0], 0x1234);
+    zassert_mem_equal(apdu, test_apdu, 2, NULL);
+    zassert_equal(apdu[2], 0xAA, NULL);
+    decode_unsigned16(&apdu[0], &value16);
+    zassert_equal(value16, 0x1234, NULL);
+    memset(apdu, 0xAA, sizeof(apdu));
+    encode_unsigned24(&apdu[0], 0x123456);
+    zassert_mem_equal(apdu, test_apdu, 3, NULL);
+    zassert_equal(apdu[3], 0xAA, NULL);
+    decode_unsigned24(&apdu[0], &value32);
+    zassert_equal(value32, 0x123456, NULL);
+    memset(apdu, 0xAA, sizeof(apdu));
+    encode_unsigned32(&apdu[0], 0x12345678);
+    zassert_mem_equal(apdu, test_apdu, sizeof(apdu), NULL);
+    decode_unsigned32(&apdu[0], &value32);
+    zassert_equal(value32, 0x12345678, NULL);
+    /* unaligned */
+    memset(apdu, 0xAA, sizeof(apdu));
+    encode_unsigned32(&apdu[1], 0x12345678);
+    zassert_mem_equal(&apdu[1], test_apdu, 4, NULL);
+    decode_unsigned32(&apdu[1], &value32);
+    zassert_equal(value32, 0x12345678, NULL);
+}
 /**
  * @}
  */
@@ -477,7 +516,8 @@ void test_main(void)
         ztest_unit_test(testBACnetUnsignedLength),
         ztest_unit_test(testBACnetSigned8), ztest_unit_test(testBACnetSigned16),
         ztest_unit_test(testBACnetSigned24),
-        ztest_unit_test(testBACnetSigned32));
+        ztest_unit_test(testBACnetSigned32),
+        ztest_unit_test(testBACnetUnsignedByteOrder));
 
     ztest_run_test_suite(bacint_tests);
 }
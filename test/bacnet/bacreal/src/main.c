@@ -56,6 +56,32 @@ static void testBACdouble(void)
     zassert_equal(test_len, len, NULL);
     zassert_false(islessgreater(test_double_value, double_value), NULL);
 }
+/**
+ * @brief Test the byte order of the encoded real and double values,
+ *  which is the big-endian IEEE-754 format
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacreal_tests, testBACrealByteOrder)
+#else
+static void testBACrealByteOrder(void)
+#endif
+{
+    uint8_t apdu[9] = { 0 };
+    const uint8_t test_real[4] = { 0x3F, 0x80, 0x00, 0x00 };
+    const uint8_t test_double[8] = { 0xC0, 0x04, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00 };
+    float real_value = 0.0f;
+    double double_value = 0.0;
+
+    encode_bacnet_real(1.0f, &apdu[1]);
+    zassert_mem_equal(&apdu[1], test_real, sizeof(test_real), NULL);
+    decode_real(&apdu[1], &real_value);
+    zassert_false(islessgreater(real_value, 1.0f), NULL);
+    encode_bacnet_double(-2.5, &apdu[1]);
+    zassert_mem_equal(&apdu[1], test_double, sizeof(test_double), NULL);
+    decode_double(&apdu[1], &double_value);
+    zassert_false(islessgreater(double_value, -2.5), NULL);
+}
 /**
  * @}
  */
@@ -67,7 +93,8 @@ void test_main(void)
 {
     ztest_test_suite(
         bacreal_tests, ztest_unit_test(testBACreal),
-        ztest_unit_test(testBACdouble));
+        ztest_unit_test(testBACdouble),
+        ztest_unit_test(testBACrealByteOrder));
 
     ztest_run_test_suite(bacreal_tests);
 }
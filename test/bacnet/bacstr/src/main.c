@@ -303,6 +303,64 @@ static void testOctetString(void)
     status = octetstring_init_ascii_hex(NULL, NULL);
     zassert_false(status, NULL);
 }
+
+/**
+ * @brief Test the UTF-8 validation and printable checks of long strings,
+ *  with the character to be found at each position of a word
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacstr_tests, testCharacterStringScan)
+#else
+static void testCharacterStringScan(void)
+#endif
+{
+    BACNET_CHARACTER_STRING bacnet_string;
+    char text[40];
+    const char euro[] = "\xE2\x82\xAC";
+    size_t i;
+    bool status;
+
+    memset(text, 'A', sizeof(text));
+    zassert_true(utf8_isvalid(text, sizeof(text)), NULL);
+    status = characterstring_init(
+        &bacnet_string, CHARACTER_ANSI_X34, text, sizeof(text));
+    zassert_true(status, NULL);
+    zassert_true(characterstring_printable(&bacnet_string), NULL);
+    for (i = 0; i < 24; i++) {
+        /* a multibyte character after a run of ASCII characters */
+        memset(text, 'A', sizeof(text));
+        memcpy(&text[i], euro, 3);
+        zassert_true(utf8_isvalid(text, sizeof(text)), "i=%u", (unsigned)i);
+        characterstring_init(
+            &bacnet_string, CHARACTER_ANSI_X34, text, sizeof(text));
+        zassert_false(characterstring_printable(&bacnet_string), NULL);
+        /* a truncated multibyte character at the end */
+        zassert_false(utf8_isvalid(text, i + 2), "i=%u", (unsigned)i);
+        /* a null in the middle */
+        memset(text, 'A', sizeof(text));
+        text[i] = 0;
+        zassert_false(utf8_isvalid(text, sizeof(text)), "i=%u", (unsigned)i);
+        characterstring_init(
+            &bacnet_string, CHARACTER_ANSI_X34, text, sizeof(text));
+        zassert_false(characterstring_printable(&bacnet_string), NULL);
+        /* a control character, and the delete character */
+        text[i] = 0x1F;
+        characterstring_init(
+            &bacnet_string, CHARACTER_ANSI_X34, text, sizeof(text));
+        zassert_false(characterstring_printable(&bacnet_string), NULL);
+        text[i] = 0x7F;
+        characterstring_init(
+            &bacnet_string, CHARACTER_ANSI_X34, text, sizeof(text));
+        zassert_false(characterstring_printable(&bacnet_string), NULL);
+        text[i] = 0x7E;
+        characterstring_init(
+            &bacnet_string, CHARACTER_ANSI_X34, text, sizeof(text));
+        zassert_true(characterstring_printable(&bacnet_string), NULL);
+        /* a lone continuation byte */
+        text[i] = (char)0x80;
+        zassert_false(utf8_isvalid(text, sizeof(text)), "i=%u", (unsigned)i);
+    }
+}
 /**
  * @}
  */
@@ -314,7 +372,8 @@ void test_main(void)
 {
     ztest_test_suite(
         bacstr_tests, ztest_unit_test(testBitString),
-        ztest_unit_test(testCharacterString), ztest_unit_test(testOctetString));
+        ztest_unit_test(testCharacterString), ztest_unit_test(testOctetString),
+        ztest_unit_test(testCharacterStringScan));
 
     ztest_run_test_suite(bacstr_tests);
 }
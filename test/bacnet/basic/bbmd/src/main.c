@@ -18,6 +18,7 @@
 #include "bacnet/datalink/bip.h"
 #include "bacnet/datalink/bvlc.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 
@@ -36,6 +37,9 @@ static uint8_t Test_Sent_Message_Length;
 static uint8_t Test_Sent_Message_Buffer[MAX_APDU];
 static uint16_t Test_Sent_Message_Buffer_Length;
 static BACNET_IP_ADDRESS Test_Sent_Message_Dest;
+static unsigned Test_Sent_Message_Count;
+/* the time of the stub of the millisecond timer */
+static unsigned long Test_Milliseconds;
 
 /* network stub functions */
 /**
@@ -76,6 +80,7 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
     Test_Sent_Message_Type = message_type;
     Test_Sent_Message_Length = message_length;
     bvlc_address_copy(&Test_Sent_Message_Dest, dest);
+    Test_Sent_Message_Count++;
     if ((header_len == 4) && (mtu_len >= 4)) {
         memcpy(&Test_Sent_Message_Buffer[0], &mtu[4], mtu_len - 4);
         Test_Sent_Message_Buffer_Length = mtu_len - 4;
@@ -86,6 +91,15 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
     return 0;
 }
 
+/**
+ * @brief Stub of the time of the millisecond timer
+ * @return milliseconds
+ */
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
 /** Return the Object Instance number for our (single) Device Object.
  * This is a key function, widely invoked by the handler code, since
  * it provides "our" (ie, local) address.
@@ -221,11 +235,334 @@ static void test_BBMD_Result(void)
     }
 }
 
+/**
+ * @brief Test forwarding an Original-Broadcast-NPDU to the BDT and FDT
+ */
+static void test_Forward_Original_Broadcast_NPDU(void)
+{
+    BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY bdt_entry = { 0 };
+    BACNET_IP_BROADCAST_DISTRIBUTION_MASK mask = { 0 };
+    BACNET_IP_ADDRESS bdt_addr[2] = { 0 };
+    BACNET_IP_ADDRESS fd_addr[2] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t pdu[MAX_APDU] = { 0 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    int pdu_len = 0;
+    int mtu_len = 0;
+    uint16_t result_code = 0;
+    unsigned i = 0;
+
+    test_setup();
+    bvlc_bdt_list_clear();
+    /* BDT with the IUT and two peer BBMDs */
+    bvlc_broadcast_distribution_mask_from_host(&mask, 0xFFFFFFFFL);
+    bvlc_broadcast_distribution_table_entry_set(
+        &bdt_entry, &IUT.BIP_Addr, &mask);
+    assert(bvlc_broadcast_distribution_table_entry_append(
+        bvlc_bdt_list(), &bdt_entry));
+    bvlc_address_set(&bdt_addr[0], 192, 168, 2, 1);
+    bvlc_address_set(&bdt_addr[1], 192, 168, 3, 1);
+    for (i = 0; i < 2; i++) {
+        bvlc_broadcast_distribution_table_entry_set(
+            &bdt_entry, &bdt_addr[i], &mask);
+        assert(bvlc_broadcast_distribution_table_entry_append(
+            bvlc_bdt_list(), &bdt_entry));
+    }
+    /* two registered foreign devices */
+    bvlc_address_set(&fd_addr[0], 10, 0, 0, 1);
+    bvlc_address_set(&fd_addr[1], 10, 0, 0, 2);
+    for (i = 0; i < 2; i++) {
+        mtu_len = bvlc_encode_register_foreign_device(mtu, sizeof(mtu), 60);
+        (void)bvlc_bbmd_enabled_handler(&fd_addr[i], &src, mtu, mtu_len);
+        assert(Test_Sent_Message_Type == BVLC_RESULT);
+        assert(bvlc_decode_result(Test_Sent_Message_Buffer,
+            Test_Sent_Message_Buffer_Length, &result_code));
+        assert(result_code == BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    }
+    /* an unconfirmed broadcast from the TD */
+    dest.net = BACNET_BROADCAST_NETWORK;
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(&pdu[0], &dest, &TD.BACnet_Address, &npdu_data);
+    pdu_len += iam_encode_apdu(&pdu[pdu_len], TD.Device_ID, MAX_APDU,
+        SEGMENTATION_NONE, BACNET_VENDOR_ID);
+    /* forwarded to each FDT and BDT entry except the IUT */
+    mtu_len = bvlc_encode_original_broadcast(mtu, sizeof(mtu), pdu, pdu_len);
+    Test_Sent_Message_Count = 0;
+    assert(bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) > 0);
+    assert(Test_Sent_Message_Count == 4);
+    assert(Test_Sent_Message_Type == BVLC_FORWARDED_NPDU);
+    /* a repeat within the window is dropped, and not forwarded again */
+    mtu_len = bvlc_encode_original_broadcast(mtu, sizeof(mtu), pdu, pdu_len);
+    Test_Sent_Message_Count = 0;
+    assert(bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) == 0);
+    assert(Test_Sent_Message_Count == 0);
+    assert(bvlc_broadcast_repeated_count() == 1);
+    /* not forwarded back to the origin */
+    mtu_len = bvlc_encode_original_broadcast(mtu, sizeof(mtu), pdu, pdu_len);
+    Test_Sent_Message_Count = 0;
+    assert(bvlc_bbmd_enabled_handler(&fd_addr[0], &src, mtu, mtu_len) > 0);
+    assert(Test_Sent_Message_Count == 3);
+    /* a deleted foreign device is no longer forwarded to */
+    mtu_len =
+        bvlc_encode_delete_foreign_device(mtu, sizeof(mtu), &fd_addr[1]);
+    (void)bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len);
+    assert(Test_Sent_Message_Type == BVLC_RESULT);
+    assert(bvlc_decode_result(Test_Sent_Message_Buffer,
+        Test_Sent_Message_Buffer_Length, &result_code));
+    assert(result_code == BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    /* the same broadcast is processed again after the window */
+    Test_Milliseconds += 2000;
+    mtu_len = bvlc_encode_original_broadcast(mtu, sizeof(mtu), pdu, pdu_len);
+    Test_Sent_Message_Count = 0;
+    assert(bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) > 0);
+    assert(Test_Sent_Message_Count == 3);
+    assert(bvlc_address_different(&Test_Sent_Message_Dest, &fd_addr[1]));
+    /* a cleared BDT is no longer forwarded to */
+    bvlc_bdt_list_clear();
+    /* the same broadcast is processed again after the window */
+    Test_Milliseconds += 2000;
+    mtu_len = bvlc_encode_original_broadcast(mtu, sizeof(mtu), pdu, pdu_len);
+    Test_Sent_Message_Count = 0;
+    assert(bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) > 0);
+    assert(Test_Sent_Message_Count == 1);
+    assert(!bvlc_address_different(&Test_Sent_Message_Dest, &fd_addr[0]));
+    test_cleanup();
+}
+
+/**
+ * @brief Register a foreign device with the IUT
+ * @param addr - B/IPv4 address of the foreign device
+ * @param ttl_seconds - Time-to-Live T, in seconds
+ * @return result code sent by the IUT
+ */
+static uint16_t test_register_foreign_device(
+    BACNET_IP_ADDRESS *addr, uint16_t ttl_seconds)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    int mtu_len = 0;
+    uint16_t result_code = 0;
+
+    mtu_len =
+        bvlc_encode_register_foreign_device(mtu, sizeof(mtu), ttl_seconds);
+    (void)bvlc_bbmd_enabled_handler(addr, &src, mtu, mtu_len);
+    assert(Test_Sent_Message_Type == BVLC_RESULT);
+    assert(bvlc_decode_result(Test_Sent_Message_Buffer,
+        Test_Sent_Message_Buffer_Length, &result_code));
+
+    return result_code;
+}
+
+/**
+ * @brief Test Foreign-Device-Table registration, renewal, and expiry
+ */
+static void test_Foreign_Device_Table(void)
+{
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_list = NULL;
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry = NULL;
+    BACNET_IP_ADDRESS fd_addr[2] = { 0 };
+    BACNET_IP_ADDRESS addr = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    int mtu_len = 0;
+    unsigned count = 0;
+    unsigned i = 0;
+
+    test_setup();
+    /* expire entries from other tests */
+    bvlc_maintenance_timer(UINT16_MAX);
+    assert(bvlc_foreign_device_table_valid_count(bvlc_fdt_list()) == 0);
+    bvlc_address_set(&fd_addr[0], 10, 0, 1, 1);
+    bvlc_address_set(&fd_addr[1], 10, 0, 1, 2);
+    assert(test_register_foreign_device(&fd_addr[0], 10) ==
+        BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    assert(test_register_foreign_device(&fd_addr[1], 100) ==
+        BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    assert(bvlc_foreign_device_table_valid_count(bvlc_fdt_list()) == 2);
+    /* the grace period of 30 seconds is added to the TTL */
+    bvlc_maintenance_timer(39);
+    assert(bvlc_foreign_device_table_valid_count(bvlc_fdt_list()) == 2);
+    /* re-registration restarts the timer */
+    assert(test_register_foreign_device(&fd_addr[0], 10) ==
+        BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    bvlc_maintenance_timer(39);
+    fdt_list = bvlc_fdt_list();
+    assert(bvlc_foreign_device_table_valid_count(fdt_list) == 2);
+    for (fdt_entry = fdt_list; fdt_entry; fdt_entry = fdt_entry->next) {
+        if (!fdt_entry->valid) {
+            continue;
+        }
+        if (!bvlc_address_different(&fdt_entry->dest_address, &fd_addr[0])) {
+            assert(fdt_entry->ttl_seconds_remaining == 1);
+        } else {
+            assert(fdt_entry->ttl_seconds_remaining == 52);
+        }
+    }
+    bvlc_maintenance_timer(1);
+    assert(bvlc_foreign_device_table_valid_count(bvlc_fdt_list()) == 1);
+    /* many seconds at once */
+    bvlc_maintenance_timer(60);
+    assert(bvlc_foreign_device_table_valid_count(bvlc_fdt_list()) == 0);
+    /* fill the table */
+    for (i = 0; i < 1000; i++) {
+        bvlc_address_set(&addr, 10, 1, i / 256, i % 256);
+        if (test_register_foreign_device(&addr, 60) !=
+            BVLC_RESULT_SUCCESSFUL_COMPLETION) {
+            break;
+        }
+        count++;
+    }
+    assert(count > 0);
+    assert(count < 1000);
+    assert(bvlc_foreign_device_table_valid_count(bvlc_fdt_list()) == count);
+    /* a deleted entry makes room for another foreign device */
+    bvlc_address_set(&addr, 10, 1, 0, 0);
+    mtu_len = bvlc_encode_delete_foreign_device(mtu, sizeof(mtu), &addr);
+    (void)bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len);
+    assert(test_register_foreign_device(&fd_addr[0], 60) ==
+        BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    assert(test_register_foreign_device(&fd_addr[1], 60) ==
+        BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK);
+    bvlc_maintenance_timer(UINT16_MAX);
+    assert(bvlc_foreign_device_table_valid_count(bvlc_fdt_list()) == 0);
+    test_cleanup();
+}
+
+/**
+ * @brief Send a BVLC-Result from a BBMD to the IUT
+ * @param addr - B/IPv4 address of the BBMD
+ * @param result_code - the BVLC-Result code
+ */
+static void test_bbmd_result(BACNET_IP_ADDRESS *addr, uint16_t result_code)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    int mtu_len = 0;
+
+    mtu_len = bvlc_encode_result(mtu, sizeof(mtu), result_code);
+    (void)bvlc_bbmd_disabled_handler(addr, &src, mtu, mtu_len);
+}
+
+/**
+ * @brief Test foreign device registration with a list of BBMDs, and
+ *  the choice of the BBMD for Distribute-Broadcast-To-Network
+ */
+static void test_Remote_BBMD_List(void)
+{
+    BACNET_IP_ADDRESS bbmd[3] = { 0 };
+    BACNET_IP_ADDRESS addr = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t pdu[8] = { 0 };
+    uint16_t latency_ms = 0;
+    bool registered = false;
+
+    test_setup();
+    bvlc_address_port_from_ascii(&bbmd[0], "10.0.2.1", "0xBAC0");
+    bvlc_address_port_from_ascii(&bbmd[1], "10.0.2.2", "0xBAC0");
+    bvlc_address_port_from_ascii(&bbmd[2], "10.0.2.3", "0xBAC0");
+    Test_Sent_Message_Count = 0;
+    assert(bvlc_register_with_bbmds(bbmd, 3, 600) >= 0);
+    assert(Test_Sent_Message_Count == 3);
+    assert(Test_Sent_Message_Type == BVLC_REGISTER_FOREIGN_DEVICE);
+    assert(bvlc_remote_bbmd_count() == 3);
+    /* the first is used until any of them answers */
+    bvlc_remote_bbmd_address(&addr);
+    assert(!bvlc_address_different(&addr, &bbmd[0]));
+    /* the one that answers is used */
+    Test_Milliseconds += 50;
+    test_bbmd_result(&bbmd[1], BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    bvlc_remote_bbmd_address(&addr);
+    assert(!bvlc_address_different(&addr, &bbmd[1]));
+    assert(bvlc_remote_bbmd_health(1, NULL, &registered, &latency_ms));
+    assert(registered);
+    assert(latency_ms == 50);
+    assert(!bvlc_remote_bbmd_health(3, NULL, NULL, NULL));
+    /* a slower one of a higher priority is used */
+    Test_Milliseconds += 10;
+    test_bbmd_result(&bbmd[0], BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    bvlc_remote_bbmd_address(&addr);
+    assert(!bvlc_address_different(&addr, &bbmd[0]));
+    /* one that does not answer in time is not used */
+    bvlc_maintenance_timer(3);
+    assert(bvlc_remote_bbmd_health(2, NULL, &registered, NULL));
+    assert(!registered);
+    /* the broadcasts go to the healthiest */
+    dest.net = BACNET_BROADCAST_NETWORK;
+    assert(bvlc_send_pdu(&dest, &npdu_data, pdu, sizeof(pdu)) == 0);
+    assert(Test_Sent_Message_Type == BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK);
+    assert(!bvlc_address_different(&Test_Sent_Message_Dest, &bbmd[0]));
+    /* and to the next one when it refuses them */
+    test_bbmd_result(
+        &bbmd[0], BVLC_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK);
+    assert(bvlc_send_pdu(&dest, &npdu_data, pdu, sizeof(pdu)) == 0);
+    assert(!bvlc_address_different(&Test_Sent_Message_Dest, &bbmd[1]));
+    /* each of them is checked again */
+    Test_Sent_Message_Count = 0;
+    bvlc_maintenance_timer(30);
+    assert(Test_Sent_Message_Count == 3);
+    Test_Milliseconds += 5;
+    test_bbmd_result(&bbmd[0], BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    bvlc_remote_bbmd_address(&addr);
+    assert(!bvlc_address_different(&addr, &bbmd[0]));
+    /* registering with one BBMD replaces the list */
+    assert(bvlc_register_with_bbmd(&bbmd[2], 600) >= 0);
+    assert(bvlc_remote_bbmd_count() == 1);
+    bvlc_remote_bbmd_address(&addr);
+    assert(!bvlc_address_different(&addr, &bbmd[2]));
+    test_cleanup();
+}
+
+/**
+ * @brief Test the Original-Unicast-NPDU and Forwarded-NPDU taken by the
+ *  fast path, and the messages left to the full handlers
+ */
+static void test_Receive_NPDU_Fast_Path(void)
+{
+    BACNET_IP_ADDRESS fwd_addr = { 0 };
+    BACNET_IP_ADDRESS addr = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[8] = { 0x01, 0x04, 0x00, 0x05, 0x01, 0x0C, 0x0C, 0x00 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    int mtu_len = 0;
+
+    test_setup();
+    mtu_len = bvlc_encode_original_unicast(mtu, sizeof(mtu), pdu, sizeof(pdu));
+    assert(bvlc_bbmd_disabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) == 4);
+    assert(bvlc_get_function_code() == BVLC_ORIGINAL_UNICAST_NPDU);
+    assert(bvlc_ip_address_from_bacnet_local(&addr, &src));
+    assert(!bvlc_address_different(&addr, &TD.BIP_Addr));
+    assert(bvlc_bbmd_enabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) == 4);
+    /* from my own address, dropped by the full handler */
+    assert(bvlc_bbmd_disabled_handler(&IUT.BIP_Addr, &src, mtu, mtu_len) == 0);
+    /* a BVLC length that differs is decoded by the full handler */
+    mtu[mtu_len] = 0;
+    assert(bvlc_bbmd_disabled_handler(
+               &TD.BIP_Addr, &src, mtu, mtu_len + 1) == 4);
+    /* a Forwarded-NPDU, then its repeat */
+    bvlc_address_set(&fwd_addr, 192, 168, 4, 20);
+    mtu_len = bvlc_encode_forwarded_npdu(
+        mtu, sizeof(mtu), &fwd_addr, pdu, sizeof(pdu));
+    assert(bvlc_bbmd_disabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) ==
+        (4 + BIP_ADDRESS_MAX));
+    assert(bvlc_get_function_code() == BVLC_FORWARDED_NPDU);
+    assert(bvlc_ip_address_from_bacnet_local(&addr, &src));
+    assert(!bvlc_address_different(&addr, &fwd_addr));
+    assert(bvlc_bbmd_disabled_handler(&TD.BIP_Addr, &src, mtu, mtu_len) == 0);
+    test_cleanup();
+}
+
 int main(void)
 {
     /* individual tests */
     test_BBMD_Result();
     test_Initiate_Original_Broadcast_NPDU();
+    test_Forward_Original_Broadcast_NPDU();
+    test_Foreign_Device_Table();
+    test_Remote_BBMD_List();
+    test_Receive_NPDU_Fast_Path();
 
     return 0;
 }
@@ -300,8 +300,129 @@ static void test_BBMD_Result(void)
     }
 }
 
+/**
+ * @brief Test finding the VMAC entries by device ID and by address
+ */
+static void test_VMAC_Index(void)
+{
+    struct vmac_data vmac = { 0 };
+    struct vmac_data *pVMAC = NULL;
+    uint32_t device_id = 0;
+    uint32_t i = 0;
+    const uint32_t count = 3000;
+
+    VMAC_Init();
+    for (i = 0; i < count; i++) {
+        vmac.mac_len = 18;
+        memset(vmac.mac, 0, sizeof(vmac.mac));
+        vmac.mac[0] = 0x20;
+        vmac.mac[1] = 0x01;
+        encode_unsigned32(&vmac.mac[12], i);
+        vmac.mac[16] = 0xBA;
+        vmac.mac[17] = 0xC0;
+        assert(VMAC_Add(i * 7, &vmac));
+    }
+    assert(VMAC_Count() == count);
+    /* an entry is only added once for its device ID */
+    assert(!VMAC_Add(0, &vmac));
+    for (i = 0; i < count; i++) {
+        pVMAC = VMAC_Find_By_Key(i * 7);
+        assert(pVMAC != NULL);
+        assert(pVMAC->mac_len == 18);
+        assert(VMAC_Find_By_Data(pVMAC, &device_id));
+        assert(device_id == (i * 7));
+    }
+    assert(VMAC_Find_By_Key(1) == NULL);
+    /* the same address with a different port is not found */
+    vmac.mac[17] = 0xC1;
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    vmac.mac[17] = 0xC0;
+    assert(VMAC_Find_By_Data(&vmac, &device_id));
+    assert(device_id == ((count - 1) * 7));
+    assert(VMAC_Delete(device_id));
+    assert(!VMAC_Delete(device_id));
+    assert(VMAC_Find_By_Key(device_id) == NULL);
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    assert(VMAC_Count() == (count - 1));
+    VMAC_Cleanup();
+    assert(VMAC_Count() == 0);
+    assert(VMAC_Find_By_Key(0) == NULL);
+}
+
+/**
+ * @brief Test the resolution of the VMAC of a unicast destination
+ */
+static void test_Address_Resolution_Cache(void)
+{
+    uint8_t pdu[MAX_MPDU] = { 0 };
+    uint8_t mtu[MAX_MPDU] = { 0 };
+    uint16_t mtu_len = 0;
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_IP6_ADDRESS fwd_address = { 0 };
+    uint32_t test_vmac_src = 0;
+    uint32_t test_vmac_dst = 0;
+    int function_len = 0;
+    int result = 0;
+
+    test_setup();
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    /* an unknown destination is asked for, and the message dropped */
+    Test_Sent_Message_Type = 0;
+    result = bvlc6_send_pdu(&TD.BACnet_Address, &npdu_data, pdu, 10);
+    assert(result < 0);
+    assert(Test_Sent_Message_Type == BVLC6_ADDRESS_RESOLUTION);
+    assert(!bvlc6_address_different(
+        &IUT.BIP6_Broadcast_Addr, &Test_Sent_Message_Dest));
+    function_len = bvlc6_decode_address_resolution(
+        Test_Sent_Message_Buffer, Test_Sent_Message_Buffer_Length,
+        &test_vmac_src, &test_vmac_dst);
+    assert(function_len > 0);
+    assert(test_vmac_src == IUT.Device_ID);
+    assert(test_vmac_dst == TD.Device_ID);
+    /* it is not asked for again until the negative entry expires */
+    Test_Sent_Message_Type = 0;
+    result = bvlc6_send_pdu(&TD.BACnet_Address, &npdu_data, pdu, 10);
+    assert(result < 0);
+    assert(Test_Sent_Message_Type == 0);
+    bvlc6_maintenance_timer(BBMD6_RESOLUTION_NEGATIVE_TTL_SECONDS);
+    result = bvlc6_send_pdu(&TD.BACnet_Address, &npdu_data, pdu, 10);
+    assert(result < 0);
+    assert(Test_Sent_Message_Type == BVLC6_ADDRESS_RESOLUTION);
+    /* the answer fills the cache, and the message is sent */
+    mtu_len = bvlc6_encode_address_resolution_ack(
+        mtu, sizeof(mtu), TD.Device_ID, IUT.Device_ID);
+    result = bvlc6_bbmd_disabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, mtu, mtu_len);
+    assert(result == 0);
+    assert(VMAC_Find_By_Key(TD.Device_ID) != NULL);
+    result = bvlc6_send_pdu(&TD.BACnet_Address, &npdu_data, pdu, 10);
+    assert(result >= 0);
+    assert(Test_Sent_Message_Type == BVLC6_ORIGINAL_UNICAST_NPDU);
+    assert(!bvlc6_address_different(&TD.BIP6_Addr, &Test_Sent_Message_Dest));
+    /* the VMAC expires when the device is not heard from */
+    bvlc6_maintenance_timer(BBMD6_VMAC_TTL_SECONDS - 1);
+    assert(VMAC_Find_By_Key(TD.Device_ID) != NULL);
+    bvlc6_maintenance_timer(1);
+    assert(VMAC_Find_By_Key(TD.Device_ID) == NULL);
+    /* a Forwarded-Address-Resolution for me is answered to its origin */
+    bvlc6_address_set(
+        &fwd_address, 0x2001, 0x0DBB, 0xAC10, 0xFE02, 0, 0, 7,
+        BIP6_MULTICAST_GROUP_ID);
+    mtu_len = bvlc6_encode_forwarded_address_resolution(
+        mtu, sizeof(mtu), TD.Device_ID, IUT.Device_ID, &fwd_address);
+    result = bvlc6_bbmd_disabled_handler(
+        &TD.BIP6_Addr, &TD.BACnet_Address, mtu, mtu_len);
+    assert(result == 0);
+    assert(Test_Sent_Message_Type == BVLC6_ADDRESS_RESOLUTION_ACK);
+    assert(!bvlc6_address_different(&fwd_address, &Test_Sent_Message_Dest));
+    assert(VMAC_Find_By_Key(TD.Device_ID) != NULL);
+    test_cleanup();
+}
+
 int main(void)
 {
+    test_VMAC_Index();
+    test_Address_Resolution_Cache();
     test_BBMD_Result();
     test_Execute_Virtual_Address_Resolution();
     test_Initiate_Original_Broadcast_NPDU();
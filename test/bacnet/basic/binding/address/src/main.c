@@ -197,6 +197,329 @@ static void testAddress(void)
         zassert_equal(count, (MAX_ADDRESS_CACHE - i - 1), NULL);
     }
 }
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressEviction)
+#else
+static void testAddressEviction(void)
+#endif
+{
+    unsigned i;
+    BACNET_ADDRESS src;
+    BACNET_ADDRESS test_address;
+    unsigned max_apdu = 480;
+    unsigned test_max_apdu = 0;
+    uint32_t test_device_id = 0;
+
+    address_init();
+    for (i = 0; i < MAX_ADDRESS_CACHE; i++) {
+        set_address(i, &src);
+        address_add(i + 1, max_apdu, &src);
+    }
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE, NULL);
+    /* use the first device, so the second device is least recently used */
+    zassert_true(
+        address_get_by_device(1, &test_max_apdu, &test_address), NULL);
+    set_address(MAX_ADDRESS_CACHE, &src);
+    address_add(MAX_ADDRESS_CACHE + 1, max_apdu, &src);
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE, NULL);
+    zassert_true(
+        address_get_by_device(1, &test_max_apdu, &test_address), NULL);
+    zassert_false(
+        address_get_by_device(2, &test_max_apdu, &test_address), NULL);
+    zassert_true(address_get_by_device(
+                     MAX_ADDRESS_CACHE + 1, &test_max_apdu, &test_address),
+        NULL);
+    /* the evicted address no longer resolves, the new one does */
+    set_address(1, &src);
+    zassert_false(address_get_device_id(&src, &test_device_id), NULL);
+    set_address(MAX_ADDRESS_CACHE, &src);
+    zassert_true(address_get_device_id(&src, &test_device_id), NULL);
+    zassert_equal(test_device_id, MAX_ADDRESS_CACHE + 1, NULL);
+    /* a changed address is found by the new address only */
+    set_address(1, &src);
+    address_add(1, max_apdu, &src);
+    zassert_true(address_get_device_id(&src, &test_device_id), NULL);
+    zassert_equal(test_device_id, 1, NULL);
+    set_address(0, &src);
+    zassert_false(address_get_device_id(&src, &test_device_id), NULL);
+    /* expired entries return to the free list */
+    address_cache_timer(UINT16_MAX);
+    address_cache_timer(UINT16_MAX);
+    zassert_equal(address_count(), 0, NULL);
+    zassert_false(address_get_device_id(&src, &test_device_id), NULL);
+    /* a bind request is completed by the binding from an I-Am */
+    zassert_false(
+        address_bind_request(7, &test_max_apdu, &test_address), NULL);
+    zassert_false(
+        address_bind_request(8, &test_max_apdu, &test_address), NULL);
+    set_address(7, &src);
+    address_add_binding(7, 1476, &src);
+    zassert_true(
+        address_bind_request(7, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_max_apdu, 1476, NULL);
+    zassert_true(bacnet_address_same(&test_address, &src), NULL);
+    zassert_false(
+        address_bind_request(8, &test_max_apdu, &test_address), NULL);
+    /* a full cache evicts the least recently used bound entries,
+       and keeps the outstanding bind request */
+    for (i = 0; i < MAX_ADDRESS_CACHE; i++) {
+        set_address(i, &src);
+        address_add(i + 100, max_apdu, &src);
+    }
+    zassert_equal(address_count(), MAX_ADDRESS_CACHE - 1, NULL);
+    zassert_false(address_get_by_device(7, NULL, NULL), NULL);
+    zassert_false(address_get_by_device(100, NULL, NULL), NULL);
+    zassert_true(
+        address_get_by_device(MAX_ADDRESS_CACHE + 99, NULL, NULL), NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressAddList)
+#else
+static void testAddressAddList(void)
+#endif
+{
+    BACNET_ADDRESS_BINDING_ADD list[4] = { 0 };
+    BACNET_ADDRESS test_address;
+    BACNET_SEGMENTATION segmentation = SEGMENTATION_NONE;
+    unsigned test_max_apdu = 0;
+    unsigned i;
+
+    address_init();
+    for (i = 0; i < 4; i++) {
+        list[i].device_id = i + 10;
+        list[i].max_apdu = 480 + i;
+        list[i].segmentation = SEGMENTATION_BOTH;
+        set_address(i, &list[i].address);
+    }
+    address_add_list(list, 4);
+    zassert_equal(address_count(), 4, NULL);
+    for (i = 0; i < 4; i++) {
+        zassert_true(address_get_by_device(
+                         i + 10, &test_max_apdu, &test_address),
+            NULL);
+        zassert_equal(test_max_apdu, 480 + i, NULL);
+        zassert_true(
+            bacnet_address_same(&test_address, &list[i].address), NULL);
+        zassert_true(address_segmentation(i + 10, &segmentation), NULL);
+        zassert_equal(segmentation, SEGMENTATION_BOTH, NULL);
+    }
+    /* devices already in the cache are updated */
+    list[0].max_apdu = 1476;
+    list[0].segmentation = SEGMENTATION_NONE;
+    address_add_list(list, 1);
+    zassert_equal(address_count(), 4, NULL);
+    zassert_true(
+        address_get_by_device(10, &test_max_apdu, &test_address), NULL);
+    zassert_equal(test_max_apdu, 1476, NULL);
+    zassert_true(address_segmentation(10, &segmentation), NULL);
+    zassert_equal(segmentation, SEGMENTATION_NONE, NULL);
+    address_add_list(NULL, 4);
+    zassert_equal(address_count(), 4, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressCapability)
+#else
+static void testAddressCapability(void)
+#endif
+{
+    BACNET_ADDRESS_BINDING_ADD list[1] = { 0 };
+    BACNET_ADDRESS_CAPABILITY capability = { 0 };
+    BACNET_ADDRESS unknown_address;
+
+    address_init();
+    list[0].device_id = 10;
+    list[0].max_apdu = 1476;
+    list[0].segmentation = SEGMENTATION_TRANSMIT;
+    set_address(0, &list[0].address);
+    address_add_list(list, 1);
+    zassert_true(address_capability(10, &capability), NULL);
+    zassert_equal(capability.max_apdu, 1476, NULL);
+    zassert_equal(capability.segmentation, SEGMENTATION_TRANSMIT, NULL);
+    zassert_equal(capability.max_segments, 0, NULL);
+    zassert_equal(capability.round_trip_time, 0, NULL);
+    zassert_false(address_capability(11, &capability), NULL);
+    /* the APDU timeout is used until the round trip time is known */
+    zassert_equal(address_apdu_timeout(&list[0].address, 0), 0, NULL);
+    /* a request narrows the max-APDU, and never widens it */
+    address_peer_capability_update(&list[0].address, 480, 4, 0);
+    address_peer_capability_update(&list[0].address, 1024, 0, 0);
+    zassert_true(address_capability(10, &capability), NULL);
+    zassert_equal(capability.max_apdu, 480, NULL);
+    zassert_equal(capability.max_segments, 4, NULL);
+    /* the first round trip time is taken, and later ones are smoothed */
+    address_peer_capability_update(&list[0].address, 0, 0, 800);
+    zassert_true(address_capability(10, &capability), NULL);
+    zassert_equal(capability.round_trip_time, 800, NULL);
+    zassert_equal(capability.round_trip_variance, 400, NULL);
+    address_peer_capability_update(&list[0].address, 0, 0, 160);
+    zassert_true(address_capability(10, &capability), NULL);
+    zassert_equal(capability.round_trip_time, 800 - 100 + 20, NULL);
+    zassert_equal(capability.round_trip_variance, 400 - 100 + 160, NULL);
+    zassert_equal(capability.max_apdu, 480, NULL);
+    /* the timeout is doubled for each retry, and stays doubled until
+       a request that is sent once is answered */
+    zassert_equal(
+        address_apdu_timeout(&list[0].address, 0), 720 + (4 * 460), NULL);
+    zassert_equal(address_apdu_timeout(&list[0].address, 1),
+        2 * (720 + (4 * 460)), NULL);
+    zassert_equal(address_apdu_timeout(&list[0].address, 0),
+        2 * (720 + (4 * 460)), NULL);
+    zassert_equal(address_apdu_timeout(&list[0].address, 255),
+        16 * (720 + (4 * 460)), NULL);
+    address_peer_capability_update(&list[0].address, 0, 0, 720);
+    zassert_equal(
+        address_apdu_timeout(&list[0].address, 0), 720 + (4 * 345), NULL);
+    /* a fast device has a lower bound */
+    address_init();
+    address_add_list(list, 1);
+    address_peer_capability_update(&list[0].address, 0, 0, 4);
+    zassert_equal(address_apdu_timeout(&list[0].address, 0), 500, NULL);
+    zassert_equal(address_apdu_timeout(&list[0].address, 2), 2000, NULL);
+    /* devices that are not in the cache are ignored */
+    set_address(1, &unknown_address);
+    address_peer_capability_update(&unknown_address, 50, 2, 10);
+    address_peer_capability_update(NULL, 50, 2, 10);
+    zassert_equal(address_count(), 1, NULL);
+    zassert_true(address_capability(10, NULL), NULL);
+    zassert_equal(address_apdu_timeout(&unknown_address, 0), 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressSnapshot)
+#else
+static void testAddressSnapshot(void)
+#endif
+{
+    BACNET_ADDRESS_BINDING_ADD list[3] = { 0 };
+    BACNET_ADDRESS_CAPABILITY capability = { 0 };
+    BACNET_ADDRESS test_address = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    unsigned test_max_apdu = 0;
+    uint8_t buffer[256] = { 0 };
+    size_t len = 0;
+    unsigned i;
+
+    address_init();
+    for (i = 0; i < 3; i++) {
+        list[i].device_id = 100 + i;
+        list[i].max_apdu = 1476;
+        list[i].segmentation = SEGMENTATION_BOTH;
+        set_address(i, &list[i].address);
+    }
+    address_add_list(list, 3);
+    address_peer_capability_update(&list[1].address, 480, 8, 300);
+    /* static and unbound entries are not kept */
+    set_address(9, &src);
+    address_add(200, 50, &src);
+    address_set_device_TTL(200, 0, true);
+    (void)address_bind_request(300, NULL, NULL);
+    zassert_equal(address_count(), 4, NULL);
+    len = address_snapshot_size();
+    zassert_true(len <= sizeof(buffer), NULL);
+    zassert_equal(address_snapshot_encode(buffer, len - 1), 0, NULL);
+    zassert_equal(address_snapshot_encode(buffer, sizeof(buffer)), len, NULL);
+    address_init();
+    zassert_equal(address_count(), 0, NULL);
+    zassert_equal(address_snapshot_decode(buffer, len), 3, NULL);
+    zassert_equal(address_count(), 3, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_true(address_get_by_device(
+                         list[i].device_id, &test_max_apdu, &test_address),
+            NULL);
+        zassert_true(
+            bacnet_address_same(&test_address, &list[i].address), NULL);
+    }
+    zassert_true(address_capability(101, &capability), NULL);
+    zassert_equal(capability.max_apdu, 480, NULL);
+    zassert_equal(capability.segmentation, SEGMENTATION_BOTH, NULL);
+    zassert_equal(capability.max_segments, 8, NULL);
+    zassert_equal(capability.round_trip_time, 300, NULL);
+    zassert_false(address_get_by_device(200, &test_max_apdu, &test_address),
+        NULL);
+    /* devices in the cache keep their entries */
+    zassert_equal(address_snapshot_decode(buffer, len), 0, NULL);
+    zassert_equal(address_count(), 3, NULL);
+    /* a truncated snapshot, or another format */
+    address_init();
+    zassert_equal(address_snapshot_decode(buffer, len - 1), 2, NULL);
+    buffer[4]++;
+    address_init();
+    zassert_equal(address_snapshot_decode(buffer, len), 0, NULL);
+    zassert_equal(address_count(), 0, NULL);
+}
+
+static unsigned Refresh_Count;
+static BACNET_ADDRESS Refresh_Dest;
+static uint32_t Refresh_Low;
+static uint32_t Refresh_High;
+
+static void test_refresh_callback(
+    BACNET_ADDRESS *dest, uint32_t low_limit, uint32_t high_limit)
+{
+    Refresh_Count++;
+    bacnet_address_copy(&Refresh_Dest, dest);
+    Refresh_Low = low_limit;
+    Refresh_High = high_limit;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressRefresh)
+#else
+static void testAddressRefresh(void)
+#endif
+{
+    BACNET_ADDRESS_BINDING_ADD list[3] = { 0 };
+    uint32_t device_ttl = 0;
+    unsigned i;
+
+    address_init();
+    address_refresh_callback_set(test_refresh_callback);
+    list[0].device_id = 100;
+    list[1].device_id = 103;
+    list[2].device_id = 200;
+    for (i = 0; i < 3; i++) {
+        list[i].max_apdu = 1476;
+        set_address(i, &list[i].address);
+        list[i].address.net = 5;
+    }
+    address_add_list(list, 3);
+    for (i = 0; i < 3; i++) {
+        address_set_device_TTL(list[i].device_id, 3600, false);
+    }
+    Refresh_Count = 0;
+    address_cache_timer(60);
+    zassert_equal(Refresh_Count, 0, NULL);
+    /* the two close device-ids are asked with a range to the network */
+    address_set_device_TTL(100, 300, false);
+    address_set_device_TTL(103, 300, false);
+    address_cache_timer(1);
+    zassert_equal(Refresh_Count, 1, NULL);
+    zassert_equal(Refresh_Low, 100, NULL);
+    zassert_equal(Refresh_High, 103, NULL);
+    zassert_equal(Refresh_Dest.net, 5, NULL);
+    zassert_equal(Refresh_Dest.len, 0, NULL);
+    /* asked once */
+    address_cache_timer(1);
+    zassert_equal(Refresh_Count, 1, NULL);
+    /* the I-Am renews an entry, and one alone is asked at its address */
+    address_add(100, 1476, &list[0].address);
+    zassert_true(address_device_bind_request(100, &device_ttl, NULL, NULL),
+        NULL);
+    zassert_true(device_ttl > 600, NULL);
+    address_set_device_TTL(200, 10, false);
+    address_cache_timer(1);
+    zassert_equal(Refresh_Count, 2, NULL);
+    zassert_equal(Refresh_Low, 200, NULL);
+    zassert_equal(Refresh_High, 200, NULL);
+    zassert_true(bacnet_address_same(&Refresh_Dest, &list[2].address), NULL);
+    /* an entry that is not renewed expires */
+    address_cache_timer(10);
+    zassert_false(address_device_bind_request(200, NULL, NULL, NULL), NULL);
+    address_refresh_callback_set(NULL);
+}
 /**
  * @}
  */
@@ -209,11 +532,20 @@ void test_main(void)
 #ifdef BACNET_ADDRESS_CACHE_FILE
     ztest_test_suite(
         address_tests, ztest_unit_test(testAddressFile),
-        ztest_unit_test(testAddress));
+        ztest_unit_test(testAddress), ztest_unit_test(testAddressEviction),
+        ztest_unit_test(testAddressAddList),
+        ztest_unit_test(testAddressCapability),
+        ztest_unit_test(testAddressSnapshot),
+        ztest_unit_test(testAddressRefresh));
 
     ztest_run_test_suite(address_tests);
 #else
-    ztest_test_suite(address_tests, ztest_unit_test(testAddress));
+    ztest_test_suite(address_tests, ztest_unit_test(testAddress),
+        ztest_unit_test(testAddressEviction),
+        ztest_unit_test(testAddressAddList),
+        ztest_unit_test(testAddressCapability),
+        ztest_unit_test(testAddressSnapshot),
+        ztest_unit_test(testAddressRefresh));
 
     ztest_run_test_suite(address_tests);
 #endif
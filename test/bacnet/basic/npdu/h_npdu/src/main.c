@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @brief test of the NPDU handler, and how it drops the requests that are
+ *  disabled by DeviceCommunicationControl before they are decoded
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/dcc.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/service/h_apdu_stats.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/datalink/bip.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* number of times each confirmed service handler was called */
+static unsigned Read_Property_Count;
+static unsigned Device_Control_Count;
+static unsigned Reinitialize_Count;
+
+/**
+ * @brief Count the ReadProperty requests
+ */
+static void Test_Read_Property_Handler(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Read_Property_Count++;
+}
+
+/**
+ * @brief Count the DeviceCommunicationControl requests
+ */
+static void Test_Device_Control_Handler(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Device_Control_Count++;
+}
+
+/**
+ * @brief Count the ReinitializeDevice requests
+ */
+static void Test_Reinitialize_Handler(
+    uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    (void)service_request;
+    (void)service_len;
+    (void)src;
+    (void)service_data;
+    Reinitialize_Count++;
+}
+
+/**
+ * @brief Stubs of the datalink to send a reply
+ */
+int bip_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+
+    return (int)pdu_len;
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(*my_address));
+}
+
+void bip_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    memset(dest, 0, sizeof(*dest));
+}
+
+/**
+ * @brief Stub of the timer of the handling time of the requests
+ */
+unsigned long mstimer_now(void)
+{
+    return 0;
+}
+
+/**
+ * @brief Test that a confirmed request that is disabled by
+ *  DeviceCommunicationControl is dropped by the NPDU handler before the
+ *  NPDU is decoded, and that DeviceCommunicationControl and
+ *  ReinitializeDevice requests still get through
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_npdu_tests, testNPDUHandlerDCC)
+#else
+static void testNPDUHandlerDCC(void)
+#endif
+{
+    /* ReadProperty of device 1 object-identifier */
+    uint8_t read_property[] = { 0x01, 0x04, 0x00, 0x05, 0x01, 0x0C, 0x0C,
+        0x02, 0x00, 0x00, 0x01, 0x19, 0x4B };
+    /* segmented ReadProperty, with the sequence number and window size */
+    uint8_t segmented[] = { 0x01, 0x04, 0x08, 0x05, 0x01, 0x00, 0x01, 0x0C,
+        0x0C, 0x02, 0x00, 0x00, 0x01, 0x19, 0x4B };
+    /* ReadProperty with a global broadcast DNET and a source address */
+    uint8_t routed[] = { 0x01, 0x2C, 0xFF, 0xFF, 0x00, 0x00, 0x05, 0x01,
+        0x7F, 0xFF, 0x00, 0x05, 0x01, 0x0C, 0x0C, 0x02, 0x00, 0x00, 0x01,
+        0x19, 0x4B };
+    /* DeviceCommunicationControl enable */
+    uint8_t device_control[] = { 0x01, 0x04, 0x00, 0x05, 0x02, 0x11, 0x19,
+        0x00 };
+    /* ReinitializeDevice coldstart */
+    uint8_t reinitialize[] = { 0x01, 0x04, 0x00, 0x05, 0x03, 0x14, 0x09,
+        0x00 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_STATS npdu_stats = { 0 };
+    BACNET_APDU_SERVICE_STATS stats = { 0 };
+
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, Test_Read_Property_Handler);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL,
+        Test_Device_Control_Handler);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_REINITIALIZE_DEVICE, Test_Reinitialize_Handler);
+    bacnet_apdu_stats_reset();
+    /* communication is enabled: nothing is dropped */
+    zassert_true(dcc_communication_enabled(), NULL);
+    zassert_false(
+        apdu_dcc_npdu_discard(read_property, sizeof(read_property)), NULL);
+    npdu_handler(&src, read_property, sizeof(read_property));
+    zassert_equal(Read_Property_Count, 1, NULL);
+    bacnet_npdu_stats(&npdu_stats);
+    zassert_equal(npdu_stats.received, 1, NULL);
+    zassert_equal(npdu_stats.discarded, 0, NULL);
+    /* communication is disabled */
+    zassert_true(dcc_set_status_duration(COMMUNICATION_DISABLE, 0), NULL);
+    zassert_true(
+        apdu_dcc_npdu_discard(read_property, sizeof(read_property)), NULL);
+    zassert_true(apdu_dcc_npdu_discard(segmented, sizeof(segmented)), NULL);
+    zassert_true(apdu_dcc_npdu_discard(routed, sizeof(routed)), NULL);
+    zassert_false(
+        apdu_dcc_npdu_discard(device_control, sizeof(device_control)), NULL);
+    zassert_false(
+        apdu_dcc_npdu_discard(reinitialize, sizeof(reinitialize)), NULL);
+    /* a truncated header is left for the decoder */
+    zassert_false(apdu_dcc_npdu_discard(read_property, 5), NULL);
+    /* the request is dropped before it gets to the APDU handler */
+    npdu_handler(&src, read_property, sizeof(read_property));
+    zassert_equal(Read_Property_Count, 1, NULL);
+    bacnet_npdu_stats(&npdu_stats);
+    zassert_equal(npdu_stats.received, 2, NULL);
+    zassert_equal(npdu_stats.discarded, 1, NULL);
+    zassert_true(
+        bacnet_apdu_stats_confirmed(SERVICE_CONFIRMED_READ_PROPERTY, &stats),
+        NULL);
+    zassert_equal(stats.requests, 1, NULL);
+    /* these requests still get through */
+    npdu_handler(&src, reinitialize, sizeof(reinitialize));
+    zassert_equal(Reinitialize_Count, 1, NULL);
+    npdu_handler(&src, device_control, sizeof(device_control));
+    zassert_equal(Device_Control_Count, 1, NULL);
+    bacnet_npdu_stats(&npdu_stats);
+    zassert_equal(npdu_stats.received, 4, NULL);
+    zassert_equal(npdu_stats.discarded, 1, NULL);
+    /* communication is enabled again */
+    zassert_true(dcc_set_status_duration(COMMUNICATION_ENABLE, 0), NULL);
+    npdu_handler(&src, read_property, sizeof(read_property));
+    zassert_equal(Read_Property_Count, 2, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_npdu_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(h_npdu_tests, ztest_unit_test(testNPDUHandlerDCC));
+
+    ztest_run_test_suite(h_npdu_tests);
+}
+#endif
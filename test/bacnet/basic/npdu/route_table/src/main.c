@@ -0,0 +1,108 @@
+/**
+ * @file
+ * @brief test of the routing table of a BACnet router
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/npdu/route_table.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static BACNET_ROUTE_ENTRY Test_Entries[64];
+
+/**
+ * @brief Test that the routes are added, found, and removed, including
+ *  routes that follow a removed route
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(route_table_tests, testRouteTable)
+#else
+static void testRouteTable(void)
+#endif
+{
+    BACNET_ROUTE_TABLE table = { 0 };
+    BACNET_ROUTE_ENTRY *entry = NULL;
+    uint8_t mac[3] = { 1, 2, 3 };
+    int port_a = 0, port_b = 0;
+    unsigned count = 0;
+    unsigned net = 0;
+
+    bacnet_route_table_init(&table, Test_Entries, 64);
+    zassert_equal(table.size, 64, NULL);
+    zassert_equal(bacnet_route_count(&table), 0, NULL);
+    zassert_is_null(bacnet_route_find(&table, 1), NULL);
+    /* not a network that is routed */
+    zassert_is_null(bacnet_route_add(&table, 0, &port_a, NULL, 0), NULL);
+    zassert_is_null(
+        bacnet_route_add(&table, BACNET_BROADCAST_NETWORK, &port_a, NULL, 0),
+        NULL);
+    entry = bacnet_route_add(&table, 1, &port_a, NULL, 0);
+    zassert_not_null(entry, NULL);
+    zassert_equal(entry->flags, BACNET_ROUTE_REACHABLE, NULL);
+    zassert_equal(entry->mac_len, 0, NULL);
+    zassert_equal(bacnet_route_add(&table, 1, &port_b, mac, 3), entry, NULL);
+    zassert_equal(entry->port, &port_a, NULL);
+    /* fill the table to three quarters */
+    for (net = 2; net <= 48; net++) {
+        entry = bacnet_route_add(&table, net * 64, &port_b, mac, 3);
+        zassert_not_null(entry, NULL);
+        zassert_equal(entry->mac_len, 3, NULL);
+    }
+    zassert_equal(bacnet_route_count(&table), 48, NULL);
+    zassert_is_null(bacnet_route_add(&table, 49 * 64, &port_b, NULL, 0), NULL);
+    for (net = 2; net <= 48; net++) {
+        entry = bacnet_route_find(&table, net * 64);
+        zassert_not_null(entry, NULL);
+        zassert_equal(entry->net, net * 64, NULL);
+    }
+    count = 0;
+    entry = NULL;
+    while ((entry = bacnet_route_next(&table, entry)) != NULL) {
+        count++;
+    }
+    zassert_equal(count, 48, NULL);
+    zassert_equal(
+        bacnet_route_port_flags_set(&table, &port_b, BACNET_ROUTE_BUSY, true),
+        47, NULL);
+    zassert_equal(bacnet_route_find(&table, 1)->flags,
+        BACNET_ROUTE_REACHABLE, NULL);
+    zassert_true(
+        bacnet_route_find(&table, 128)->flags & BACNET_ROUTE_BUSY, NULL);
+    /* remove every other route, and the rest are still found */
+    for (net = 2; net <= 48; net += 2) {
+        zassert_true(bacnet_route_remove(&table, net * 64), NULL);
+        zassert_false(bacnet_route_remove(&table, net * 64), NULL);
+    }
+    for (net = 2; net <= 48; net++) {
+        entry = bacnet_route_find(&table, net * 64);
+        if (net % 2) {
+            zassert_not_null(entry, NULL);
+            zassert_equal(entry->net, net * 64, NULL);
+            zassert_equal(entry->port, &port_b, NULL);
+        } else {
+            zassert_is_null(entry, NULL);
+        }
+    }
+    zassert_equal(bacnet_route_count(&table), 24, NULL);
+    zassert_not_null(bacnet_route_find(&table, 1), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(route_table_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(route_table_tests, ztest_unit_test(testRouteTable));
+
+    ztest_run_test_suite(route_table_tests);
+}
+#endif
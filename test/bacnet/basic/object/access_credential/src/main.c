@@ -73,6 +73,93 @@ static void testAccessCredential(void)
 
     return;
 }
+
+/**
+ * @brief Test that a card read finds its credential by the index, and is
+ *  authorized by the resolved access rights
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(access_credential_tests, testAccessCredentialAuthorize)
+#else
+static void testAccessCredentialAuthorize(void)
+#endif
+{
+    BACNET_CREDENTIAL_AUTHENTICATION_FACTOR factor = { 0 };
+    BACNET_ASSIGNED_ACCESS_RIGHTS rights = { 0 };
+    BACNET_AUTHENTICATION_FACTOR card = { 0 };
+    uint8_t value[4] = { 0 };
+    uint32_t instance = 0;
+    unsigned index = 0;
+    unsigned i = 0, j = 0;
+
+    Access_Credential_Init();
+    factor.authentication_factor.format_type =
+        AUTHENTICATION_FACTOR_SIMPLE_NUMBER32;
+    for (i = 0; i < MAX_ACCESS_CREDENTIALS; i++) {
+        for (j = 0; j < 2; j++) {
+            value[0] = (uint8_t)i;
+            value[1] = (uint8_t)j;
+            octetstring_init(
+                &factor.authentication_factor.value, value, sizeof(value));
+            zassert_true(Access_Credential_Authentication_Factor_Set(
+                             i, j, &factor), NULL);
+        }
+    }
+    /* only the next factor can be added */
+    zassert_false(
+        Access_Credential_Authentication_Factor_Set(0, 3, &factor), NULL);
+    card.format_type = AUTHENTICATION_FACTOR_SIMPLE_NUMBER32;
+    value[0] = 2;
+    value[1] = 1;
+    octetstring_init(&card.value, value, sizeof(value));
+    zassert_equal(
+        Access_Credential_Authentication_Factor_Lookup(&card, &index), 2,
+        NULL);
+    zassert_equal(index, 1, NULL);
+    /* another format, or an unknown card */
+    card.format_class = 1;
+    zassert_equal(Access_Credential_Authentication_Factor_Lookup(&card, NULL),
+        BACNET_MAX_INSTANCE, NULL);
+    card.format_class = 0;
+    /* a replaced factor is no longer found, and the others still are */
+    value[1] = 9;
+    octetstring_init(&factor.authentication_factor.value, value, sizeof(value));
+    zassert_true(
+        Access_Credential_Authentication_Factor_Set(2, 1, &factor), NULL);
+    value[1] = 1;
+    octetstring_init(&card.value, value, sizeof(value));
+    zassert_equal(Access_Credential_Authentication_Factor_Lookup(&card, NULL),
+        BACNET_MAX_INSTANCE, NULL);
+    for (i = 0; i < MAX_ACCESS_CREDENTIALS; i++) {
+        value[0] = (uint8_t)i;
+        value[1] = 0;
+        octetstring_init(&card.value, value, sizeof(value));
+        zassert_equal(
+            Access_Credential_Authentication_Factor_Lookup(&card, NULL), i,
+            NULL);
+    }
+    /* authorized only when active, and assigned the access rights */
+    value[0] = 1;
+    octetstring_init(&card.value, value, sizeof(value));
+    zassert_false(Access_Credential_Authorize(&card, 7, &instance), NULL);
+    zassert_equal(instance, 1, NULL);
+    zassert_true(Access_Credential_Status_Set(1, true), NULL);
+    zassert_false(Access_Credential_Authorize(&card, 7, NULL), NULL);
+    rights.assigned_access_rights.objectIdentifier.type =
+        OBJECT_ACCESS_RIGHTS;
+    rights.assigned_access_rights.objectIdentifier.instance = 7;
+    rights.enable = false;
+    zassert_true(
+        Access_Credential_Assigned_Access_Rights_Set(1, 0, &rights), NULL);
+    zassert_false(Access_Credential_Authorize(&card, 7, NULL), NULL);
+    rights.enable = true;
+    zassert_true(
+        Access_Credential_Assigned_Access_Rights_Set(1, 0, &rights), NULL);
+    zassert_true(Access_Credential_Authorize(&card, 7, NULL), NULL);
+    zassert_false(Access_Credential_Authorize(&card, 8, NULL), NULL);
+    zassert_true(Access_Credential_Status_Set(1, false), NULL);
+    zassert_false(Access_Credential_Authorize(&card, 7, NULL), NULL);
+}
 /**
  * @}
  */
@@ -83,7 +170,8 @@ ZTEST_SUITE(access_credential_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(
-        access_credential_tests, ztest_unit_test(testAccessCredential));
+        access_credential_tests, ztest_unit_test(testAccessCredential),
+        ztest_unit_test(testAccessCredentialAuthorize));
 
     ztest_run_test_suite(access_credential_tests);
 }
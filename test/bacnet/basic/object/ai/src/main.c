@@ -7,10 +7,15 @@
  *
  * SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/ai.h>
+#include <bacnet/bacdcode.h>
 #include <property_test.h>
 
+/* counted by the Device_Intrinsic_Reporting_Request() stub */
+extern unsigned Test_Intrinsic_Reporting_Requests;
+
 /**
  * @addtogroup bacnet_tests
  * @{
@@ -43,6 +48,178 @@ static void testAnalogInput(void)
     status = Analog_Input_Delete(object_instance);
     zassert_true(status, NULL);
 }
+
+/**
+ * @brief Write a property of an Analog Input object
+ */
+static bool test_write_property(
+    uint32_t object_instance, BACNET_PROPERTY_ID property, int len,
+    const uint8_t *apdu)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+
+    wp_data.object_type = OBJECT_ANALOG_INPUT;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = property;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    memcpy(wp_data.application_data, apdu, len);
+    wp_data.application_data_len = len;
+
+    return Analog_Input_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Test that the objects request their intrinsic reporting only
+ *  when a value changes, or while a time delay is counting
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ai_tests, testAnalogInputReportingRequests)
+#else
+static void testAnalogInputReportingRequests(void)
+#endif
+{
+    uint32_t object_instance = 1;
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_BIT_STRING bit_string = { 0 };
+    int len = 0;
+
+    Analog_Input_Init();
+    Test_Intrinsic_Reporting_Requests = 0;
+    zassert_equal(Analog_Input_Create(object_instance), object_instance, NULL);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 1, NULL);
+    len = encode_application_unsigned(apdu, 2);
+    zassert_true(
+        test_write_property(object_instance, PROP_TIME_DELAY, len, apdu),
+        NULL);
+    len = encode_application_real(apdu, 50.0f);
+    zassert_true(
+        test_write_property(object_instance, PROP_HIGH_LIMIT, len, apdu),
+        NULL);
+    bitstring_init(&bit_string);
+    /* lowLimitEnable, highLimitEnable */
+    bitstring_set_bit(&bit_string, 0, false);
+    bitstring_set_bit(&bit_string, 1, true);
+    len = encode_application_bitstring(apdu, &bit_string);
+    zassert_true(
+        test_write_property(object_instance, PROP_LIMIT_ENABLE, len, apdu),
+        NULL);
+    bitstring_init(&bit_string);
+    bitstring_set_bit(&bit_string, TRANSITION_TO_OFFNORMAL, true);
+    bitstring_set_bit(&bit_string, TRANSITION_TO_FAULT, true);
+    bitstring_set_bit(&bit_string, TRANSITION_TO_NORMAL, true);
+    len = encode_application_bitstring(apdu, &bit_string);
+    zassert_true(
+        test_write_property(object_instance, PROP_EVENT_ENABLE, len, apdu),
+        NULL);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 5, NULL);
+    /* nothing to count in the normal state */
+    Test_Intrinsic_Reporting_Requests = 0;
+    Analog_Input_Intrinsic_Reporting(object_instance);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 0, NULL);
+    /* above the high limit: requested each pass of the time delay */
+    Analog_Input_Present_Value_Set(object_instance, 60.0f);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 1, NULL);
+    Analog_Input_Intrinsic_Reporting(object_instance);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 2, NULL);
+    Analog_Input_Intrinsic_Reporting(object_instance);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 3, NULL);
+    zassert_equal(
+        Analog_Input_Event_State(object_instance), EVENT_STATE_NORMAL, NULL);
+    Analog_Input_Intrinsic_Reporting(object_instance);
+    zassert_equal(
+        Analog_Input_Event_State(object_instance), EVENT_STATE_HIGH_LIMIT,
+        NULL);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 4, NULL);
+    /* the time delay is reset, and then nothing to count */
+    Analog_Input_Intrinsic_Reporting(object_instance);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 4, NULL);
+    Analog_Input_Intrinsic_Reporting(object_instance);
+    zassert_equal(Test_Intrinsic_Reporting_Requests, 4, NULL);
+    zassert_true(Analog_Input_Delete(object_instance), NULL);
+}
+/**
+ * @brief Test that the columns follow the values of the objects
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ai_tests, testAnalogInputColumns)
+#else
+static void testAnalogInputColumns(void)
+#endif
+{
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    const COLUMNS_STORE *columns;
+    float values[9] = { 0.0f };
+    uint32_t changed[COLUMNS_BITMAP_WORDS(9)] = { 0 };
+    unsigned changes;
+    unsigned row;
+
+    Analog_Input_Init();
+    columns = Analog_Input_Columns();
+    zassert_equal(Analog_Input_Create_Bulk(1, 10), 10, NULL);
+    zassert_equal(columns_count(columns), 10, NULL);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_CHANGED), 0, NULL);
+    Analog_Input_Present_Value_Set(5, 42.0f);
+    Analog_Input_Out_Of_Service_Set(7, true);
+    Analog_Input_Reliability_Set(9, RELIABILITY_OVER_RANGE);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_CHANGED), 2, NULL);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_STATUS), 2, NULL);
+    row = columns_flags_next(columns, COLUMNS_FLAG_CHANGED, 0);
+    zassert_equal(columns->instance[row], 5, NULL);
+    zassert_false(islessgreater(columns->value[row], 42.0f), NULL);
+    row = columns_flags_next(columns, COLUMNS_FLAG_CHANGED, row + 1);
+    zassert_equal(columns->instance[row], 7, NULL);
+    zassert_equal(columns->flags[row] & COLUMNS_FLAG_STATUS,
+        COLUMNS_FLAG_OUT_OF_SERVICE, NULL);
+    row = columns_flags_next(columns, COLUMNS_FLAG_CHANGED, row + 1);
+    zassert_equal(row, columns_count(columns), NULL);
+    row = columns_flags_next(columns, COLUMNS_FLAG_FAULT, 0);
+    zassert_equal(columns->instance[row], 9, NULL);
+    Analog_Input_Change_Of_Value_Clear(5);
+    Analog_Input_Change_Of_Value_Clear(7);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_CHANGED), 0, NULL);
+    /* the last row moves into the row of a deleted object */
+    zassert_true(Analog_Input_Delete(2), NULL);
+    zassert_equal(columns_count(columns), 9, NULL);
+    zassert_equal(columns->instance[1], 10, NULL);
+    Analog_Input_Present_Value_Set(10, 10.0f);
+    zassert_false(islessgreater(columns->value[1], 10.0f), NULL);
+    zassert_equal(columns->flags[1], COLUMNS_FLAG_CHANGED, NULL);
+    /* set the Present_Value of all of the rows at once */
+    Analog_Input_Change_Of_Value_Clear(10);
+    Analog_Input_COV_Increment_Set(10, 5.0f);
+    zassert_false(Analog_Input_Change_Of_Value(10), NULL);
+    for (row = 0; row < columns_count(columns); row++) {
+        values[row] = columns->value[row] + 0.5f;
+    }
+    values[0] += 1.0f;
+    values[1] = 12.0f;
+    changes = Analog_Input_Present_Value_Rows_Set(
+        0, values, ARRAY_SIZE(values), changed);
+    zassert_equal(changes, 1, NULL);
+    zassert_equal(changed[0], 0x1, NULL);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_CHANGED), 1, NULL);
+    zassert_true(Analog_Input_Change_Of_Value(columns->instance[0]), NULL);
+    zassert_false(
+        islessgreater(
+            Analog_Input_Present_Value(columns->instance[0]), values[0]),
+        NULL);
+    zassert_false(Analog_Input_Change_Of_Value(10), NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(10), 12.0f), NULL);
+    zassert_false(islessgreater(columns->value[1], 12.0f), NULL);
+    /* the change is from the prior value, not the last value */
+    values[1] = 15.0f;
+    changes = Analog_Input_Present_Value_Rows_Set(1, &values[1], 1, changed);
+    zassert_equal(changes, 1, NULL);
+    zassert_true(Analog_Input_Change_Of_Value(10), NULL);
+    /* rows past the last row are not set */
+    changes = Analog_Input_Present_Value_Rows_Set(
+        columns_count(columns), values, 1, changed);
+    zassert_equal(changes, 0, NULL);
+    Analog_Input_Cleanup();
+    zassert_equal(columns_count(columns), 0, NULL);
+#endif
+}
 /**
  * @}
  */
@@ -52,7 +229,10 @@ ZTEST_SUITE(ai_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(ai_tests, ztest_unit_test(testAnalogInput));
+    ztest_test_suite(
+        ai_tests, ztest_unit_test(testAnalogInput),
+        ztest_unit_test(testAnalogInputReportingRequests),
+        ztest_unit_test(testAnalogInputColumns));
 
     ztest_run_test_suite(ai_tests);
 }
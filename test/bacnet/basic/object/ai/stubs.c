@@ -17,6 +17,18 @@
 #include "bacnet/getevent.h"
 #include "bacnet/get_alarm_sum.h"
 #include "bacnet/npdu.h"
+#include "bacnet/basic/object/device.h"
+
+/* number of calls of Device_Intrinsic_Reporting_Request() */
+unsigned Test_Intrinsic_Reporting_Requests;
+
+void Device_Intrinsic_Reporting_Request(
+    BACNET_OBJECT_TYPE object_type, uint32_t object_instance)
+{
+    (void)object_type;
+    (void)object_instance;
+    Test_Intrinsic_Reporting_Requests++;
+}
 
 bool datetime_local(
     BACNET_DATE *bdate,
@@ -67,6 +67,87 @@ static void test_BACnet_File_Object(void)
 
     return;
 }
+
+/**
+ * @brief Test the stream access through the open file of the object
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacfile_tests, test_BACnet_File_Stream)
+#else
+static void test_BACnet_File_Stream(void)
+#endif
+{
+    BACNET_ATOMIC_READ_FILE_DATA read_data = { 0 };
+    BACNET_ATOMIC_WRITE_FILE_DATA write_data = { 0 };
+    const char *pathname = "test_bacfile_stream.bin";
+    const uint8_t contents[] = "0123456789";
+    uint8_t patch[] = "AB";
+    const uint32_t instance = 2;
+    FILE *pFile = NULL;
+    bool status = false;
+
+    pFile = fopen(pathname, "wb");
+    zassert_not_null(pFile, NULL);
+    fwrite(contents, sizeof(contents) - 1, 1, pFile);
+    fclose(pFile);
+    bacfile_init();
+    bacfile_create(instance);
+    bacfile_pathname_set(instance, pathname);
+    zassert_equal(bacfile_file_size(instance), 10, NULL);
+    /* read within the file */
+    read_data.object_type = OBJECT_FILE;
+    read_data.object_instance = instance;
+    read_data.access = FILE_STREAM_ACCESS;
+    read_data.type.stream.fileStartPosition = 2;
+    read_data.type.stream.requestedOctetCount = 4;
+    status = bacfile_read_stream_data(&read_data);
+    zassert_true(status, NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 4, NULL);
+    zassert_mem_equal(
+        octetstring_value(&read_data.fileData[0]), "2345", 4, NULL);
+    zassert_false(read_data.endOfFile, NULL);
+    /* read up to the end of the file */
+    read_data.type.stream.fileStartPosition = 8;
+    status = bacfile_read_stream_data(&read_data);
+    zassert_true(status, NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 2, NULL);
+    zassert_true(read_data.endOfFile, NULL);
+    /* read past the end of the file */
+    read_data.type.stream.fileStartPosition = 20;
+    status = bacfile_read_stream_data(&read_data);
+    zassert_true(status, NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 0, NULL);
+    zassert_true(read_data.endOfFile, NULL);
+    /* write into the open file, and past its end */
+    write_data.object_type = OBJECT_FILE;
+    write_data.object_instance = instance;
+    write_data.access = FILE_STREAM_ACCESS;
+    write_data.type.stream.fileStartPosition = 4;
+    octetstring_init(&write_data.fileData[0], patch, sizeof(patch) - 1);
+    status = bacfile_write_stream_data(&write_data);
+    zassert_true(status, NULL);
+    zassert_equal(bacfile_file_size(instance), 10, NULL);
+    write_data.type.stream.fileStartPosition = 10;
+    status = bacfile_write_stream_data(&write_data);
+    zassert_true(status, NULL);
+    zassert_equal(bacfile_file_size(instance), 12, NULL);
+    read_data.type.stream.fileStartPosition = 3;
+    read_data.type.stream.requestedOctetCount = 4;
+    status = bacfile_read_stream_data(&read_data);
+    zassert_true(status, NULL);
+    zassert_mem_equal(
+        octetstring_value(&read_data.fileData[0]), "3AB6", 4, NULL);
+    /* the idle file is closed, and opened again when read */
+    bacfile_timer(instance, 10000);
+    read_data.type.stream.fileStartPosition = 10;
+    status = bacfile_read_stream_data(&read_data);
+    zassert_true(status, NULL);
+    zassert_equal(octetstring_length(&read_data.fileData[0]), 2, NULL);
+    zassert_mem_equal(
+        octetstring_value(&read_data.fileData[0]), "AB", 2, NULL);
+    bacfile_cleanup();
+    remove(pathname);
+}
 /**
  * @}
  */
@@ -76,7 +157,9 @@ ZTEST_SUITE(bacfile_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(bacfile_tests, ztest_unit_test(test_BACnet_File_Object));
+    ztest_test_suite(
+        bacfile_tests, ztest_unit_test(test_BACnet_File_Object),
+        ztest_unit_test(test_BACnet_File_Stream));
 
     ztest_run_test_suite(bacfile_tests);
 }
@@ -7,6 +7,7 @@
  *
  * SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/bo.h>
 #include <property_test.h>
@@ -43,6 +44,43 @@ static void testBinaryOutput(void)
     status = Binary_Output_Delete(object_instance);
     zassert_true(status, NULL);
 }
+/**
+ * @brief Test that the columns follow the commanded values of the objects
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bo_tests, testBinaryOutputColumns)
+#else
+static void testBinaryOutputColumns(void)
+#endif
+{
+#if BACNET_OBJECT_COLUMNS_ENABLED
+    const COLUMNS_STORE *columns;
+
+    Binary_Output_Init();
+    columns = Binary_Output_Columns();
+    zassert_equal(Binary_Output_Create_Bulk(1, 4), 4, NULL);
+    zassert_equal(columns_count(columns), 4, NULL);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_ACTIVE), 0, NULL);
+    zassert_true(Binary_Output_Present_Value_Set(3, BINARY_ACTIVE, 8), NULL);
+    zassert_true(Binary_Output_Relinquish_Default_Set(4, BINARY_ACTIVE), NULL);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_ACTIVE), 2, NULL);
+    zassert_equal(
+        columns->instance[columns_flags_next(columns, COLUMNS_FLAG_ACTIVE, 0)],
+        3, NULL);
+    zassert_false(islessgreater(columns->value[2], 1.0f), NULL);
+    /* a lower priority does not change the present value */
+    zassert_true(Binary_Output_Present_Value_Set(3, BINARY_INACTIVE, 16), NULL);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_ACTIVE), 2, NULL);
+    zassert_true(Binary_Output_Present_Value_Relinquish(3, 8), NULL);
+    zassert_equal(columns_flags_count(columns, COLUMNS_FLAG_ACTIVE), 1, NULL);
+    zassert_false(islessgreater(columns->value[2], 0.0f), NULL);
+    Binary_Output_Out_Of_Service_Set(1, true);
+    zassert_equal(columns->flags[0],
+        COLUMNS_FLAG_OUT_OF_SERVICE | COLUMNS_FLAG_CHANGED, NULL);
+    Binary_Output_Cleanup();
+    zassert_equal(columns_count(columns), 0, NULL);
+#endif
+}
 /**
  * @}
  */
@@ -52,7 +90,9 @@ ZTEST_SUITE(bo_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(bo_tests, ztest_unit_test(testBinaryOutput));
+    ztest_test_suite(
+        bo_tests, ztest_unit_test(testBinaryOutput),
+        ztest_unit_test(testBinaryOutputColumns));
 
     ztest_run_test_suite(bo_tests);
 }
@@ -233,6 +233,20 @@ static void testPresentValue(void)
 
     Calendar_Date_List_Delete_All(instance);
     zassert_equal(0, Calendar_Date_List_Count(instance), NULL);
+    zassert_false(Calendar_Present_Value(instance), NULL);
+
+    /* the value kept for one date is not used for another date */
+    entry.tag = BACNET_CALENDAR_DATE;
+    entry.type.Date = date;
+    Calendar_Date_List_Add(instance, &entry);
+    zassert_true(Calendar_Present_Value_On_Date(instance, &date), NULL);
+    zassert_true(Calendar_Present_Value_On_Date(instance, &date), NULL);
+    entry.type.Date.day = (date.day % 28) + 1;
+    zassert_false(
+        Calendar_Present_Value_On_Date(instance, &entry.type.Date), NULL);
+    zassert_true(Calendar_Present_Value_On_Date(instance, &date), NULL);
+    Calendar_Date_List_Delete_All(instance);
+    zassert_false(Calendar_Present_Value_On_Date(instance, &date), NULL);
 
     zassert_true(Calendar_Delete(instance), NULL);
 }
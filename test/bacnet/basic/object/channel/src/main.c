@@ -135,13 +135,114 @@ static void test_Channel_ReadProperty(void)
     status = Channel_Delete(instance);
     zassert_true(status, NULL);
 }
+
+/* the requests sent by the remote callback */
+static unsigned Test_Remote_Requests;
+static unsigned Test_Remote_Writes;
+static uint32_t Test_Remote_Device_ID;
+static bool Test_Remote_Status;
+
+static bool test_write_members_remote(uint32_t object_instance,
+    uint32_t device_id,
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    unsigned count)
+{
+    (void)object_instance;
+    zassert_not_null(wp_data, NULL);
+    zassert_equal(wp_data[0].object_type, OBJECT_LIGHTING_OUTPUT, NULL);
+    Test_Remote_Requests++;
+    Test_Remote_Writes += count;
+    Test_Remote_Device_ID = device_id;
+
+    return Test_Remote_Status;
+}
+
+/**
+ * @brief Test the writes of members that are in remote devices
+ */
+static void test_Channel_Write_Members_Remote(void)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wpdata = { 0 };
+    const uint32_t instance = 1;
+    bool status = false;
+
+    Channel_Init();
+    Channel_Create(instance);
+    member.objectIdentifier.type = OBJECT_LIGHTING_OUTPUT;
+    member.propertyIdentifier = PROP_PRESENT_VALUE;
+    member.arrayIndex = BACNET_ARRAY_ALL;
+    member.deviceIdentifier.type = OBJECT_DEVICE;
+    /* two members in device 100, one in device 200 */
+    member.objectIdentifier.instance = 1;
+    member.deviceIdentifier.instance = 100;
+    zassert_equal(
+        Channel_Reference_List_Member_Element_Add(instance, &member), 1, NULL);
+    member.objectIdentifier.instance = 2;
+    member.deviceIdentifier.instance = 200;
+    zassert_equal(
+        Channel_Reference_List_Member_Element_Add(instance, &member), 2, NULL);
+    member.objectIdentifier.instance = 3;
+    member.deviceIdentifier.instance = 100;
+    zassert_equal(
+        Channel_Reference_List_Member_Element_Add(instance, &member), 3, NULL);
+    Channel_Write_Members_Remote_Callback_Set(test_write_members_remote);
+    Test_Remote_Status = true;
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 50.0f;
+    wpdata.object_type = OBJECT_CHANNEL;
+    wpdata.object_instance = instance;
+    wpdata.priority = 8;
+    status = Channel_Present_Value_Set(&wpdata, &value);
+    zassert_true(status, NULL);
+    /* one request for each device */
+    zassert_equal(Test_Remote_Requests, 2, NULL);
+    zassert_equal(Test_Remote_Writes, 3, NULL);
+    zassert_equal(
+        Channel_Write_Status(instance), BACNET_WRITE_STATUS_IN_PROGRESS, NULL);
+    zassert_equal(
+        Channel_Write_Member_Status(instance, 2),
+        BACNET_WRITE_STATUS_IN_PROGRESS, NULL);
+    /* the results of each device */
+    zassert_equal(
+        Channel_Write_Members_Device_Status_Set(
+            instance, 100, BACNET_WRITE_STATUS_SUCCESSFUL),
+        2, NULL);
+    zassert_equal(
+        Channel_Write_Status(instance), BACNET_WRITE_STATUS_IN_PROGRESS, NULL);
+    zassert_equal(
+        Channel_Write_Members_Device_Status_Set(
+            instance, 200, BACNET_WRITE_STATUS_FAILED),
+        1, NULL);
+    zassert_equal(
+        Channel_Write_Status(instance), BACNET_WRITE_STATUS_FAILED, NULL);
+    zassert_equal(
+        Channel_Write_Member_Status(instance, 1),
+        BACNET_WRITE_STATUS_SUCCESSFUL, NULL);
+    zassert_equal(
+        Channel_Write_Member_Status(instance, 2), BACNET_WRITE_STATUS_FAILED,
+        NULL);
+    /* a request that is not sent fails its members */
+    Test_Remote_Status = false;
+    status = Channel_Present_Value_Set(&wpdata, &value);
+    zassert_true(status, NULL);
+    zassert_equal(
+        Channel_Write_Status(instance), BACNET_WRITE_STATUS_FAILED, NULL);
+    zassert_equal(
+        Channel_Write_Member_Status(instance, 3), BACNET_WRITE_STATUS_FAILED,
+        NULL);
+    Channel_Write_Members_Remote_Callback_Set(NULL);
+    zassert_true(Channel_Delete(instance), NULL);
+}
 /**
  * @}
  */
 
 void test_main(void)
 {
-    ztest_test_suite(channel_tests, ztest_unit_test(test_Channel_ReadProperty));
+    ztest_test_suite(channel_tests, ztest_unit_test(test_Channel_ReadProperty),
+        ztest_unit_test(test_Channel_Write_Members_Remote));
 
     ztest_run_test_suite(channel_tests);
 }
@@ -6,6 +6,7 @@
  *
  * SPDX-License-Identifier: MIT
  */
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/bactext.h>
 #include <bacnet/basic/object/color_object.h>
@@ -130,6 +131,58 @@ static void testColorObject(void)
 
     return;
 }
+
+/**
+ * @brief Test that only the fading objects are updated by the timer of
+ *  the active transitions, and that they reach their target color
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(color_object_tests, testColorTimerActive)
+#else
+static void testColorTimerActive(void)
+#endif
+{
+    BACNET_COLOR_COMMAND command = { 0 };
+    BACNET_XY_COLOR color = { 0 };
+    unsigned i = 0;
+
+    Color_Init();
+    zassert_equal(Color_Create_Bulk(1, 10), 10, NULL);
+    /* every object fades to its default color at power up */
+    zassert_equal(Color_Timer_Active_Count(), 10, NULL);
+    for (i = 0; i < 10; i++) {
+        Color_Timer_Active(100);
+    }
+    zassert_equal(Color_Timer_Active_Count(), 0, NULL);
+    zassert_true(Color_Tracking_Value(1, &color), NULL);
+    zassert_true(isgreaterequal(color.x_coordinate, 1.0f), NULL);
+    /* fade one object half way */
+    command.operation = BACNET_COLOR_OPERATION_FADE_TO_COLOR;
+    command.transit.fade_time = 1000;
+    xy_color_set(&command.target.color, 0.0f, 0.5f);
+    zassert_true(Color_Command_Set(5, &command), NULL);
+    zassert_equal(Color_Timer_Active_Count(), 1, NULL);
+    Color_Timer_Active(500);
+    zassert_true(Color_Tracking_Value(5, &color), NULL);
+    zassert_true(isless(fabsf(color.x_coordinate - 0.5f), 0.001f), NULL);
+    zassert_true(isless(fabsf(color.y_coordinate - 0.75f), 0.001f), NULL);
+    zassert_equal(Color_In_Progress(5),
+        BACNET_COLOR_OPERATION_IN_PROGRESS_FADE_ACTIVE, NULL);
+    zassert_true(Color_Command(5, &command), NULL);
+    zassert_equal(command.transit.fade_time, 500, NULL);
+    Color_Timer_Active(500);
+    zassert_true(Color_Tracking_Value(5, &color), NULL);
+    zassert_true(isless(fabsf(color.y_coordinate - 0.5f), 0.001f), NULL);
+    zassert_equal(Color_In_Progress(5),
+        BACNET_COLOR_OPERATION_IN_PROGRESS_IDLE, NULL);
+    zassert_equal(Color_Timer_Active_Count(), 0, NULL);
+    /* a deleted object leaves the list */
+    command.transit.fade_time = 1000;
+    zassert_true(Color_Command_Set(6, &command), NULL);
+    zassert_true(Color_Delete(6), NULL);
+    zassert_equal(Color_Timer_Active_Count(), 0, NULL);
+    Color_Cleanup();
+}
 /**
  * @}
  */
@@ -139,7 +192,8 @@ ZTEST_SUITE(color_object_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(color_object_tests, ztest_unit_test(testColorObject));
+    ztest_test_suite(color_object_tests, ztest_unit_test(testColorObject),
+        ztest_unit_test(testColorTimerActive));
 
     ztest_run_test_suite(color_object_tests);
 }
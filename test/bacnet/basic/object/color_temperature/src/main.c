@@ -125,6 +125,58 @@ static void testColorTemperature(void)
 
     return;
 }
+
+/**
+ * @brief Test that only the fading, ramping, or stepping objects are
+ *  updated by the timer of the active transitions
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(color_temperature_tests, testColorTemperatureTimerActive)
+#else
+static void testColorTemperatureTimerActive(void)
+#endif
+{
+    BACNET_COLOR_COMMAND command = { 0 };
+
+    Color_Temperature_Init();
+    zassert_equal(Color_Temperature_Create_Bulk(1, 10), 10, NULL);
+    zassert_equal(Color_Temperature_Timer_Active_Count(), 10, NULL);
+    Color_Temperature_Timer_Active(BACNET_COLOR_FADE_TIME_MIN);
+    zassert_equal(Color_Temperature_Timer_Active_Count(), 0, NULL);
+    zassert_equal(Color_Temperature_Tracking_Value(1), 5000, NULL);
+    /* fade */
+    command.operation = BACNET_COLOR_OPERATION_FADE_TO_CCT;
+    command.transit.fade_time = 1000;
+    command.target.color_temperature = 3000;
+    zassert_true(Color_Temperature_Command_Set(2, &command), NULL);
+    Color_Temperature_Timer_Active(250);
+    zassert_equal(Color_Temperature_Tracking_Value(2), 4500, NULL);
+    zassert_equal(Color_Temperature_In_Progress(2),
+        BACNET_COLOR_OPERATION_IN_PROGRESS_FADE_ACTIVE, NULL);
+    /* ramp at 1000K per second */
+    command.operation = BACNET_COLOR_OPERATION_RAMP_TO_CCT;
+    command.transit.ramp_rate = 1000;
+    command.target.color_temperature = 6000;
+    zassert_true(Color_Temperature_Command_Set(3, &command), NULL);
+    zassert_equal(Color_Temperature_Timer_Active_Count(), 2, NULL);
+    Color_Temperature_Timer_Active(500);
+    zassert_equal(Color_Temperature_Tracking_Value(3), 5500, NULL);
+    zassert_equal(Color_Temperature_In_Progress(3),
+        BACNET_COLOR_OPERATION_IN_PROGRESS_RAMP_ACTIVE, NULL);
+    Color_Temperature_Timer_Active(500);
+    zassert_equal(Color_Temperature_Tracking_Value(2), 3000, NULL);
+    zassert_equal(Color_Temperature_Tracking_Value(3), 6000, NULL);
+    zassert_equal(Color_Temperature_Timer_Active_Count(), 0, NULL);
+    /* one step */
+    command.operation = BACNET_COLOR_OPERATION_STEP_UP_CCT;
+    command.transit.step_increment = 100;
+    zassert_true(Color_Temperature_Command_Set(3, &command), NULL);
+    Color_Temperature_Timer_Active(10);
+    Color_Temperature_Timer_Active(10);
+    zassert_equal(Color_Temperature_Tracking_Value(3), 6100, NULL);
+    zassert_equal(Color_Temperature_Timer_Active_Count(), 0, NULL);
+    Color_Temperature_Cleanup();
+}
 /**
  * @}
  */
@@ -135,7 +187,8 @@ ZTEST_SUITE(color_temperature_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(
-        color_temperature_tests, ztest_unit_test(testColorTemperature));
+        color_temperature_tests, ztest_unit_test(testColorTemperature),
+        ztest_unit_test(testColorTemperatureTimerActive));
 
     ztest_run_test_suite(color_temperature_tests);
 }
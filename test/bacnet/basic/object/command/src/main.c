@@ -37,6 +37,106 @@ static void test_object_command(void)
         OBJECT_COMMAND, object_instance, Command_Property_Lists,
         Command_Read_Property, Command_Write_Property, skip_fail_property_list);
 }
+
+static unsigned Test_Write_Count;
+static uint32_t Test_Write_Device;
+static unsigned Test_Write_Actions;
+
+static bool test_write_multiple(uint32_t object_instance,
+    uint32_t device_instance,
+    BACNET_ACTION_LIST **actions,
+    unsigned count)
+{
+    (void)object_instance;
+    (void)actions;
+    Test_Write_Count++;
+    Test_Write_Device = device_instance;
+    Test_Write_Actions = count;
+
+    return true;
+}
+
+/**
+ * @brief Test that the actions of each device are written together, at
+ *  the same time as the other devices, with the Post_Delay and
+ *  Quit_On_Failure of the actions
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tests_object_command, test_object_command_writes)
+#else
+static void test_object_command_writes(void)
+#endif
+{
+    BACNET_ACTION_LIST action[5] = { 0 };
+    const uint32_t device[5] = { 1, 1, 1, 2, 3 };
+    unsigned i;
+
+    Command_Init();
+    for (i = 0; i < 5; i++) {
+        action[i].Device_Id.type = OBJECT_DEVICE;
+        action[i].Device_Id.instance = device[i];
+        action[i].Object_Id.type = OBJECT_ANALOG_VALUE;
+        action[i].Object_Id.instance = i;
+        action[i].Property_Identifier = PROP_PRESENT_VALUE;
+        action[i].Property_Array_Index = BACNET_ARRAY_ALL;
+        action[i].Priority = BACNET_NO_PRIORITY;
+        action[i].Post_Delay = 0xFFFFFFFFU;
+        if (i < 4) {
+            action[i].next = &action[i + 1];
+        }
+    }
+    action[1].Post_Delay = 1000;
+    action[4].Quit_On_Failure = true;
+    zassert_true(Command_Action_List_Set(0, 1, &action[0]), NULL);
+    zassert_false(Command_Action_List_Set(0, MAX_COMMAND_ACTIONS, &action[0]),
+        NULL);
+    Command_Write_Multiple_Callback_Set(test_write_multiple);
+    zassert_true(Command_Present_Value_Set(0, 1), NULL);
+    zassert_true(Command_In_Process(0), NULL);
+    zassert_false(Command_Present_Value_Set(0, 2), NULL);
+    /* one request to each device, up to the Post_Delay */
+    zassert_equal(Test_Write_Count, 3, NULL);
+    zassert_equal(Test_Write_Device, 3, NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 1, 2), NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 2, 1), NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 3, 1), NULL);
+    zassert_false(Command_Write_Multiple_Result(0, 3, 1), NULL);
+    Command_Timer(0, 500);
+    zassert_equal(Test_Write_Count, 3, NULL);
+    zassert_true(Command_In_Process(0), NULL);
+    Command_Timer(0, 500);
+    zassert_equal(Test_Write_Count, 4, NULL);
+    zassert_equal(Test_Write_Device, 1, NULL);
+    zassert_equal(Test_Write_Actions, 1, NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 1, 1), NULL);
+    Command_Timer(0, 100);
+    zassert_false(Command_In_Process(0), NULL);
+    zassert_true(Command_All_Writes_Successful(0), NULL);
+    /* a failure that quits the list */
+    Test_Write_Count = 0;
+    zassert_true(Command_Present_Value_Set(0, 1), NULL);
+    zassert_equal(Test_Write_Count, 3, NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 3, 0), NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 2, 1), NULL);
+    Command_Timer(0, 100);
+    zassert_true(Command_In_Process(0), NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 1, 2), NULL);
+    Command_Timer(0, 1000);
+    zassert_equal(Test_Write_Count, 3, NULL);
+    zassert_false(Command_In_Process(0), NULL);
+    zassert_false(Command_All_Writes_Successful(0), NULL);
+    zassert_false(action[2].Write_Attempted, NULL);
+    /* a failure that does not quit, and the rest are written again */
+    action[4].Quit_On_Failure = false;
+    Test_Write_Count = 0;
+    zassert_true(Command_Present_Value_Set(0, 1), NULL);
+    zassert_true(Command_Write_Multiple_Result(0, 1, 0), NULL);
+    Command_Timer(0, 100);
+    zassert_equal(Test_Write_Count, 4, NULL);
+    zassert_equal(Test_Write_Device, 1, NULL);
+    zassert_equal(Test_Write_Actions, 1, NULL);
+    Command_Write_Multiple_Callback_Set(NULL);
+}
 /**
  * @}
  */
@@ -47,7 +147,8 @@ ZTEST_SUITE(tests_object_command, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(
-        tests_object_command, ztest_unit_test(test_object_command));
+        tests_object_command, ztest_unit_test(test_object_command),
+        ztest_unit_test(test_object_command_writes));
 
     ztest_run_test_suite(tests_object_command);
 }
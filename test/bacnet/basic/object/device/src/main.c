@@ -8,9 +8,13 @@
  * @brief test BACnet integer encode/decode APIs
  */
 
+#include <math.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/av.h>
+#include <bacnet/basic/service/h_cov.h>
 #include <bacnet/bactext.h>
+#include <bacnet/cov.h>
 
 /**
  * @addtogroup bacnet_tests
@@ -227,10 +231,743 @@ static void testDevice(void)
 
     return;
 }
+/**
+ * @brief Test the Object_List as objects are created and deleted
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceObjectList)
+#else
+static void testDeviceObjectList(void)
+#endif
+{
+    bool status = false;
+    unsigned count = 0;
+    unsigned i = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+
+    Device_Init(NULL);
+    count = Device_Object_List_Count();
+    zassert_true(count > 0, NULL);
+    for (i = 1; i <= count; i++) {
+        status =
+            Device_Object_List_Identifier(i, &object_type, &object_instance);
+        zassert_true(status, NULL);
+        zassert_true(Device_Valid_Object_Id(object_type, object_instance),
+            "object=%u-%u", (unsigned)object_type, (unsigned)object_instance);
+    }
+    zassert_false(
+        Device_Object_List_Identifier(0, &object_type, &object_instance),
+        NULL);
+    zassert_false(Device_Object_List_Identifier(
+                      count + 1, &object_type, &object_instance),
+        NULL);
+    /* the device object follows its instance number */
+    status = Device_Set_Object_Instance_Number(1234);
+    zassert_true(status, NULL);
+    status = false;
+    for (i = 1; i <= count; i++) {
+        Device_Object_List_Identifier(i, &object_type, &object_instance);
+        if (object_type == OBJECT_DEVICE) {
+            zassert_equal(object_instance, 1234, NULL);
+            status = true;
+        }
+    }
+    zassert_true(status, NULL);
+    /* a created object is listed */
+    create_data.object_type = OBJECT_ANALOG_VALUE;
+    create_data.object_instance = 4321;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Object_List_Count(), count + 1, NULL);
+    status = false;
+    for (i = 1; i <= (count + 1); i++) {
+        Device_Object_List_Identifier(i, &object_type, &object_instance);
+        if ((object_type == OBJECT_ANALOG_VALUE) &&
+            (object_instance == 4321)) {
+            status = true;
+        }
+    }
+    zassert_true(status, NULL);
+    /* a deleted object is not listed */
+    delete_data.object_type = OBJECT_ANALOG_VALUE;
+    delete_data.object_instance = 4321;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Object_List_Count(), count, NULL);
+    for (i = 1; i <= count; i++) {
+        Device_Object_List_Identifier(i, &object_type, &object_instance);
+        zassert_false((object_type == OBJECT_ANALOG_VALUE) &&
+                (object_instance == 4321),
+            NULL);
+    }
+}
+
+/**
+ * @brief Test creating objects with a List_Of_Initial_Values
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceCreateObjectInitialValues)
+#else
+static void testDeviceCreateObjectInitialValues(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_CREATE_OBJECT_DATA test_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    BACNET_PROPERTY_VALUE values[2] = { 0 };
+    uint32_t revision = 0;
+    int apdu_len = 0, test_len = 0;
+    bool status = false;
+
+    Device_Init(NULL);
+    bacapp_property_value_list_init(values, 2);
+    values[0].propertyIdentifier = PROP_UNITS;
+    values[0].value.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    values[0].value.type.Enumerated = UNITS_DEGREES_CELSIUS;
+    values[1].propertyIdentifier = PROP_PRESENT_VALUE;
+    values[1].value.tag = BACNET_APPLICATION_TAG_REAL;
+    values[1].value.type.Real = 42.0f;
+    create_data.object_type = OBJECT_ANALOG_VALUE;
+    create_data.object_instance = 4400;
+    create_data.list_of_initial_values = &values[0];
+    apdu_len = create_object_encode_service_request(apdu, &create_data);
+    zassert_true(apdu_len > 0, NULL);
+    test_len = create_object_decode_service_request(apdu, apdu_len, &test_data);
+    zassert_equal(test_len, apdu_len, NULL);
+    zassert_true(test_data.application_data_len > 0, NULL);
+    /* all of the values are written, with one database revision */
+    revision = Device_Database_Revision();
+    status = Device_Create_Object(&test_data);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Database_Revision(), revision + 1, NULL);
+    zassert_true(Analog_Value_Valid_Instance(4400), NULL);
+    zassert_equal(Analog_Value_Units(4400), UNITS_DEGREES_CELSIUS, NULL);
+    zassert_false(
+        islessgreater(Analog_Value_Present_Value(4400), 42.0f), NULL);
+    /* a value that fails is reported, and the object is not created */
+    values[1].value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(
+        &values[1].value.type.Character_String, "not a real");
+    create_data.object_instance = 4401;
+    apdu_len = create_object_encode_service_request(apdu, &create_data);
+    memset(&test_data, 0, sizeof(test_data));
+    test_len = create_object_decode_service_request(apdu, apdu_len, &test_data);
+    zassert_equal(test_len, apdu_len, NULL);
+    revision = Device_Database_Revision();
+    status = Device_Create_Object(&test_data);
+    zassert_false(status, NULL);
+    zassert_equal(test_data.first_failed_element_number, 2, NULL);
+    zassert_equal(test_data.error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_false(Analog_Value_Valid_Instance(4401), NULL);
+    zassert_equal(Device_Database_Revision(), revision, NULL);
+    /* a property that can not be written */
+    values[0].propertyIdentifier = PROP_OBJECT_IDENTIFIER;
+    values[0].value.tag = BACNET_APPLICATION_TAG_OBJECT_ID;
+    values[0].value.type.Object_Id.type = OBJECT_ANALOG_VALUE;
+    values[0].value.type.Object_Id.instance = 4401;
+    values[0].next = NULL;
+    apdu_len = create_object_encode_service_request(apdu, &create_data);
+    memset(&test_data, 0, sizeof(test_data));
+    create_object_decode_service_request(apdu, apdu_len, &test_data);
+    status = Device_Create_Object(&test_data);
+    zassert_false(status, NULL);
+    zassert_equal(test_data.first_failed_element_number, 1, NULL);
+    zassert_false(Analog_Value_Valid_Instance(4401), NULL);
+    delete_data.object_type = OBJECT_ANALOG_VALUE;
+    delete_data.object_instance = 4400;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDevicePropertyCache)
+#else
+static void testDevicePropertyCache(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wpdata = { 0 };
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    int len = 0, test_len = 0;
+    bool status = false;
+
+    Device_Init(NULL);
+    rpdata.application_data = &apdu[0];
+    rpdata.application_data_len = sizeof(apdu);
+    rpdata.object_type = OBJECT_DEVICE;
+    rpdata.object_instance = Device_Object_Instance_Number();
+    rpdata.object_property = PROP_DESCRIPTION;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    status = Device_Set_Description("first", 5);
+    zassert_true(status, NULL);
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    /* Description is not cached, so the same value is read again */
+    rpdata.application_data = &test_apdu[0];
+    test_len = Device_Read_Property(&rpdata);
+    zassert_equal(len, test_len, NULL);
+    zassert_mem_equal(apdu, test_apdu, len, NULL);
+    /* and the setter change is seen at once */
+    status = Device_Set_Description("second value", 12);
+    zassert_true(status, NULL);
+    test_len = Device_Read_Property(&rpdata);
+    zassert_equal(test_len, len + 7, "test_len=%d", test_len);
+    /* and so is the WriteProperty change */
+    characterstring_init_ansi(&char_string, "third");
+    wpdata.object_type = OBJECT_DEVICE;
+    wpdata.object_instance = Device_Object_Instance_Number();
+    wpdata.object_property = PROP_DESCRIPTION;
+    wpdata.array_index = BACNET_ARRAY_ALL;
+    wpdata.priority = BACNET_NO_PRIORITY;
+    wpdata.application_data_len = encode_application_character_string(
+        &wpdata.application_data[0], &char_string);
+    status = Device_Write_Property(&wpdata);
+    zassert_true(status, NULL);
+    test_len = Device_Read_Property(&rpdata);
+    zassert_equal(test_len, len, "test_len=%d", test_len);
+    zassert_mem_equal(wpdata.application_data, test_apdu, test_len, NULL);
+    /* Property_List is cached, and its array elements are not */
+    rpdata.object_property = PROP_PROPERTY_LIST;
+    rpdata.array_index = 0;
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    test_len = Device_Read_Property(&rpdata);
+    zassert_equal(len, test_len, NULL);
+}
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceObjectNameIndex)
+#else
+static void testDeviceObjectNameIndex(void)
+#endif
+{
+    BACNET_CHARACTER_STRING object_name = { 0 };
+    BACNET_CHARACTER_STRING old_name = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    BACNET_OBJECT_TYPE test_type = OBJECT_NONE;
+    uint32_t test_instance = 0;
+    unsigned count = 0;
+    unsigned i = 0;
+    bool status = false;
+
+    Device_Init(NULL);
+    count = Device_Object_List_Count();
+    for (i = 1; i <= count; i++) {
+        status =
+            Device_Object_List_Identifier(i, &object_type, &object_instance);
+        zassert_true(status, NULL);
+        if (!Device_Object_Name_Copy(
+                object_type, object_instance, &object_name)) {
+            continue;
+        }
+        status = Device_Valid_Object_Name(
+            &object_name, &test_type, &test_instance);
+        zassert_true(status, NULL);
+        /* names are not required to be unique in this table */
+        status = Device_Object_Name_Copy(test_type, test_instance, &old_name);
+        zassert_true(status, NULL);
+        zassert_true(characterstring_same(&object_name, &old_name), NULL);
+    }
+    characterstring_init_ansi(&object_name, "no object has this name");
+    status = Device_Valid_Object_Name(&object_name, NULL, NULL);
+    zassert_false(status, NULL);
+    /* a new name replaces the old name */
+    status = Device_Object_Name_Copy(
+        OBJECT_DEVICE, Device_Object_Instance_Number(), &old_name);
+    zassert_true(status, NULL);
+    characterstring_init_ansi(&object_name, "renamed device");
+    status = Device_Set_Object_Name(&object_name);
+    zassert_true(status, NULL);
+    status =
+        Device_Valid_Object_Name(&object_name, &test_type, &test_instance);
+    zassert_true(status, NULL);
+    zassert_equal(test_type, OBJECT_DEVICE, NULL);
+    zassert_equal(test_instance, Device_Object_Instance_Number(), NULL);
+    status = Device_Valid_Object_Name(&old_name, NULL, NULL);
+    zassert_false(status, NULL);
+}
+
+static unsigned Test_Provision_Setup_Count;
+
+static bool test_Device_Provision_Setup(
+    const BACNET_OBJECT_SPEC *spec, uint32_t object_instance)
+{
+    Test_Provision_Setup_Count++;
+    zassert_equal(spec->object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(spec->object_instance, object_instance, NULL);
+
+    return Analog_Value_Name_Set(object_instance, (char *)spec->context);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceProvision)
+#else
+static void testDeviceProvision(void)
+#endif
+{
+    const BACNET_OBJECT_SPEC spec[] = {
+        { OBJECT_ANALOG_VALUE, 102, "AV-102" },
+        { OBJECT_ANALOG_VALUE, 100, "AV-100" },
+        { OBJECT_EVENT_ENROLLMENT, 1, "not supported" },
+        { OBJECT_ANALOG_VALUE, 101, "AV-101" },
+    };
+    BACNET_CHARACTER_STRING object_name = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    uint32_t revision;
+    unsigned count;
+    bool status;
+
+    Device_Init(NULL);
+    count = Device_Object_List_Count();
+    revision = Device_Database_Revision();
+    Test_Provision_Setup_Count = 0;
+    zassert_equal(
+        Device_Objects_Provision(
+            spec, ARRAY_SIZE(spec), test_Device_Provision_Setup),
+        3, NULL);
+    zassert_equal(Test_Provision_Setup_Count, 3, NULL);
+    zassert_equal(Device_Database_Revision(), revision + 1, NULL);
+    zassert_equal(Device_Object_List_Count(), count + 3, NULL);
+    characterstring_init_ansi(&object_name, "AV-101");
+    status =
+        Device_Valid_Object_Name(&object_name, &object_type, &object_instance);
+    zassert_true(status, NULL);
+    zassert_equal(object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(object_instance, 101, NULL);
+    /* the objects that exist are set up again */
+    zassert_equal(Device_Objects_Provision(spec, 2, NULL), 2, NULL);
+    zassert_equal(Device_Object_List_Count(), count + 3, NULL);
+    Analog_Value_Delete(100);
+    Analog_Value_Delete(101);
+    Analog_Value_Delete(102);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceObjectPropertyValue)
+#else
+static void testDeviceObjectPropertyValue(void)
+#endif
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_ERROR_CLASS error_class = ERROR_CLASS_DEVICE;
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+    uint32_t object_instance = 123;
+    bool status;
+
+    Device_Init(NULL);
+    Analog_Value_Create(object_instance);
+    /* typed values, without encoding them */
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 42.0f;
+    status = Device_Object_Property_Value_Set(OBJECT_ANALOG_VALUE,
+        object_instance, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, &value, 16,
+        &error_class, &error_code);
+    zassert_true(status, NULL);
+    zassert_false(
+        islessgreater(Analog_Value_Present_Value(object_instance), 42.0f),
+        NULL);
+    value.type.Real = 0.0f;
+    status = Device_Object_Property_Value(OBJECT_ANALOG_VALUE,
+        object_instance, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, &value,
+        &error_class, &error_code);
+    zassert_true(status, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    zassert_false(islessgreater(value.type.Real, 42.0f), NULL);
+    status = Device_Object_Property_Value(OBJECT_ANALOG_VALUE,
+        object_instance, PROP_STATUS_FLAGS, BACNET_ARRAY_ALL, &value,
+        &error_class, &error_code);
+    zassert_true(status, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_BIT_STRING, NULL);
+    zassert_false(bitstring_bit(&value.type.Bit_String, STATUS_FLAG_FAULT),
+        NULL);
+    /* the other properties are read with ReadProperty */
+    status = Device_Object_Property_Value(OBJECT_ANALOG_VALUE,
+        object_instance, PROP_UNITS, BACNET_ARRAY_ALL, &value, &error_class,
+        &error_code);
+    zassert_true(status, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_ENUMERATED, NULL);
+    zassert_equal(value.type.Enumerated,
+        Analog_Value_Units(object_instance), NULL);
+    /* and written with WriteProperty, which gives the error */
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = true;
+    status = Device_Object_Property_Value_Set(OBJECT_ANALOG_VALUE,
+        object_instance, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, &value, 16,
+        &error_class, &error_code);
+    zassert_false(status, NULL);
+    zassert_equal(error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_equal(error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
+    status = Device_Object_Property_Value(OBJECT_ANALOG_VALUE,
+        object_instance + 1, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, &value,
+        &error_class, &error_code);
+    zassert_false(status, NULL);
+    zassert_equal(error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    Analog_Value_Delete(object_instance);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceWritePresentValue)
+#else
+static void testDeviceWritePresentValue(void)
+#endif
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint32_t object_instance = 123;
+    bool status;
+
+    Device_Init(NULL);
+    Analog_Value_Create(object_instance);
+    wp_data.object_type = OBJECT_ANALOG_VALUE;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = 8;
+    /* the native type is set without the WriteProperty handler */
+    wp_data.application_data_len =
+        encode_application_real(wp_data.application_data, 12.5f);
+    status = Device_Write_Property(&wp_data);
+    zassert_true(status, NULL);
+    zassert_false(
+        islessgreater(Analog_Value_Present_Value(object_instance), 12.5f),
+        NULL);
+    /* the other writes give the error of the WriteProperty handler */
+    wp_data.priority = 6;
+    status = Device_Write_Property(&wp_data);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    wp_data.priority = 8;
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 1);
+    status = Device_Write_Property(&wp_data);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_false(
+        islessgreater(Analog_Value_Present_Value(object_instance), 12.5f),
+        NULL);
+    Analog_Value_Delete(object_instance);
+}
+
+/* number of reads of the clock of the OS, in the stubs */
+extern unsigned Datetime_Local_Count;
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceClock)
+#else
+static void testDeviceClock(void)
+#endif
+{
+    BACNET_DATE_TIME bdatetime = { 0 };
+    uint32_t milliseconds;
+    unsigned count;
+    unsigned i;
+
+    Device_Init(NULL);
+    milliseconds = Device_Clock_Milliseconds();
+    Device_Timer(100);
+    Device_Timer(150);
+    zassert_equal(Device_Clock_Milliseconds() - milliseconds, 250, NULL);
+    /* timestamps between the timer ticks share one clock read */
+    count = Datetime_Local_Count;
+    for (i = 0; i < 10; i++) {
+        Device_getCurrentDateTime(&bdatetime);
+        (void)Device_UTC_Offset();
+    }
+    zassert_equal(Datetime_Local_Count, count, NULL);
+    Device_Clock_Update();
+    zassert_equal(Datetime_Local_Count, count + 1, NULL);
+}
 /**
  * @}
  */
 
+/* number of PDUs sent by the stubs */
+extern unsigned Bip_Send_Count;
+/* number of local broadcasts sent by the stubs */
+extern unsigned Bip_Broadcast_Count;
+/* the last PDU sent by the stubs */
+extern uint8_t Bip_Send_PDU[MAX_PDU];
+extern unsigned Bip_Send_PDU_Len;
+
+/**
+ * @brief Send a SubscribeCOVProperty request to the handler
+ * @param process_id - subscriber process identifier
+ * @param increment - COV increment, or 0 for none
+ * @param cancel - true for a cancellation
+ */
+static void test_Device_COV_Property_Subscribe(
+    uint32_t process_id, float increment, bool cancel)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    int len = 0;
+
+    src.mac_len = 1;
+    src.mac[0] = 1;
+    cov_data.subscriberProcessIdentifier = process_id;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+    cov_data.monitoredObjectIdentifier.instance = 1;
+    cov_data.cancellationRequest = cancel;
+    cov_data.issueConfirmedNotifications = false;
+    cov_data.lifetime = 300;
+    cov_data.covSubscribeToProperty = true;
+    cov_data.monitoredProperty.propertyIdentifier = PROP_PRESENT_VALUE;
+    cov_data.monitoredProperty.propertyArrayIndex = BACNET_ARRAY_ALL;
+    cov_data.covIncrementPresent = (increment > 0.0f);
+    cov_data.covIncrement = increment;
+    len = cov_subscribe_property_service_request_encode(
+        apdu, sizeof(apdu), &cov_data);
+    zassert_true(len > 0, NULL);
+    service_data.invoke_id = 1;
+    handler_cov_subscribe_property(apdu, (uint16_t)len, &src, &service_data);
+}
+
+/**
+ * @brief Run the COV task through one cycle of the monitored objects
+ * @return number of PDUs sent during the cycle
+ */
+static unsigned test_Device_COV_Cycle(void)
+{
+    unsigned count = Bip_Send_Count;
+    unsigned i;
+
+    for (i = 0; i < 100; i++) {
+        if (handler_cov_fsm()) {
+            break;
+        }
+    }
+
+    return Bip_Send_Count - count;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceCOVProperty)
+#else
+static void testDeviceCOVProperty(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    unsigned count = 0;
+
+    Device_Init(NULL);
+    handler_cov_init();
+    zassert_equal(Analog_Value_Create(1), 1, NULL);
+    Analog_Value_Present_Value_Set(1, 0.0f, BACNET_MAX_PRIORITY);
+    /* two subscriptions to the same property, with their own increments */
+    count = Bip_Send_Count;
+    test_Device_COV_Property_Subscribe(1, 5.0f, false);
+    test_Device_COV_Property_Subscribe(2, 1.0f, false);
+    zassert_equal(Bip_Send_Count - count, 2, NULL);
+    zassert_true(handler_cov_encode_subscriptions(apdu, sizeof(apdu)) > 0,
+        NULL);
+    /* the first notification of each subscription */
+    zassert_equal(test_Device_COV_Cycle(), 2, NULL);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    /* only the subscription with the smaller increment */
+    Analog_Value_Present_Value_Set(1, 2.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 1, NULL);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    /* both, compared with their own last values */
+    Analog_Value_Present_Value_Set(1, 6.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 2, NULL);
+    /* cancel both, which leaves no subscriptions */
+    count = Bip_Send_Count;
+    test_Device_COV_Property_Subscribe(1, 0.0f, true);
+    test_Device_COV_Property_Subscribe(2, 0.0f, true);
+    zassert_equal(Bip_Send_Count - count, 2, NULL);
+    zassert_equal(handler_cov_encode_subscriptions(apdu, sizeof(apdu)), 0,
+        NULL);
+    Analog_Value_Present_Value_Set(1, 20.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    Analog_Value_Delete(1);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceCOVChangeQueue)
+#else
+static void testDeviceCOVChangeQueue(void)
+#endif
+{
+    Device_Init(NULL);
+    handler_cov_init();
+    zassert_equal(Analog_Value_Create(1), 1, NULL);
+    Analog_Value_COV_Increment_Set(1, 1.0f);
+    Analog_Value_Present_Value_Set(1, 1.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    Analog_Value_Present_Value_Set(1, 1.5f, BACNET_MAX_PRIORITY);
+    /* the increment of the object, which reports its changes */
+    test_Device_COV_Property_Subscribe(1, 0.0f, false);
+    zassert_equal(test_Device_COV_Cycle(), 1, NULL);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    Analog_Value_Present_Value_Set(1, 1.8f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    /* the change of value of the object, from its prior value */
+    Analog_Value_Present_Value_Set(1, 2.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 1, NULL);
+    Analog_Value_Present_Value_Set(1, 2.5f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    Analog_Value_Present_Value_Set(1, 3.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 1, NULL);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    /* the Status_Flags are part of the notification */
+    Analog_Value_Out_Of_Service_Set(1, true);
+    zassert_equal(test_Device_COV_Cycle(), 1, NULL);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    test_Device_COV_Property_Subscribe(1, 0.0f, true);
+    Analog_Value_Delete(1);
+}
+
+/**
+ * @brief Send an unconfirmed SubscribeCOV request to the handler
+ * @param process_id - subscriber process identifier
+ * @param mac - MAC address of the subscriber on the local network
+ * @param object_instance - instance of the monitored Analog Value
+ */
+static void test_Device_COV_Subscribe(
+    uint32_t process_id, uint8_t mac, uint32_t object_instance)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    int len = 0;
+
+    src.mac_len = 1;
+    src.mac[0] = mac;
+    cov_data.subscriberProcessIdentifier = process_id;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+    cov_data.monitoredObjectIdentifier.instance = object_instance;
+    cov_data.issueConfirmedNotifications = false;
+    cov_data.lifetime = 300;
+    len = cov_subscribe_service_request_encode(apdu, sizeof(apdu), &cov_data);
+    zassert_true(len > 0, NULL);
+    service_data.invoke_id = 1;
+    handler_cov_subscribe(apdu, (uint16_t)len, &src, &service_data);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceCOVBroadcast)
+#else
+static void testDeviceCOVBroadcast(void)
+#endif
+{
+    unsigned count = 0;
+
+    Device_Init(NULL);
+    handler_cov_init();
+    zassert_equal(Analog_Value_Create(1), 1, NULL);
+    Analog_Value_Present_Value_Set(1, 0.0f, BACNET_MAX_PRIORITY);
+    /* three subscribers with the same process identifier, and one other */
+    test_Device_COV_Subscribe(1, 1, 1);
+    test_Device_COV_Subscribe(1, 2, 1);
+    test_Device_COV_Subscribe(1, 3, 1);
+    test_Device_COV_Subscribe(2, 4, 1);
+    /* one broadcast for the group, and one notification for the other */
+    count = Bip_Broadcast_Count;
+    zassert_equal(test_Device_COV_Cycle(), 2, NULL);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    zassert_equal(Bip_Broadcast_Count - count, 1, NULL);
+    Analog_Value_Present_Value_Set(1, 10.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 2, NULL);
+    zassert_equal(Bip_Broadcast_Count - count, 2, NULL);
+    /* the other process identifier becomes a group of two */
+    test_Device_COV_Subscribe(2, 5, 1);
+    Analog_Value_Present_Value_Set(1, 20.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 2, NULL);
+    zassert_equal(Bip_Broadcast_Count - count, 4, NULL);
+    Analog_Value_Delete(1);
+}
+
+/**
+ * @brief Decode the last notification sent by the stubs
+ * @param service - the unconfirmed service of the notification
+ * @return number of object notifications, or -1 if not the service
+ */
+static int test_Device_COV_Notification_Decode(uint8_t service)
+{
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_COV_DATA cov_data[4] = { 0 };
+    BACNET_PROPERTY_VALUE value_list[4][2] = { { { 0 } } };
+    uint8_t *apdu = NULL;
+    unsigned i;
+    int len;
+
+    len = bacnet_npdu_decode(
+        Bip_Send_PDU, Bip_Send_PDU_Len, &dest, &src, &npdu_data);
+    if ((len <= 0) || ((unsigned)len + 2 > Bip_Send_PDU_Len)) {
+        return -1;
+    }
+    apdu = &Bip_Send_PDU[len];
+    if ((apdu[0] != PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) ||
+        (apdu[1] != service)) {
+        return -1;
+    }
+    if (service == SERVICE_UNCONFIRMED_COV_NOTIFICATION) {
+        return 1;
+    }
+    for (i = 0; i < ARRAY_SIZE(cov_data); i++) {
+        cov_data_value_list_link(&cov_data[i], &value_list[i][0], 2);
+    }
+
+    return cov_notify_multiple_decode_service_request(&apdu[2],
+        Bip_Send_PDU_Len - len - 2, &cov_data[0], ARRAY_SIZE(cov_data));
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, testDeviceCOVNotificationMultiple)
+#else
+static void testDeviceCOVNotificationMultiple(void)
+#endif
+{
+    uint32_t instance;
+
+    Device_Init(NULL);
+    handler_cov_init();
+    for (instance = 1; instance <= 3; instance++) {
+        zassert_equal(Analog_Value_Create(instance), instance, NULL);
+        Analog_Value_Present_Value_Set(instance, 0.0f, BACNET_MAX_PRIORITY);
+        test_Device_COV_Subscribe(1, 1, instance);
+    }
+    /* another subscriber of one of the objects */
+    test_Device_COV_Subscribe(2, 2, 2);
+    /* one notification for the objects of each subscriber */
+    zassert_equal(test_Device_COV_Cycle(), 2, NULL);
+    zassert_equal(test_Device_COV_Cycle(), 0, NULL);
+    for (instance = 1; instance <= 3; instance++) {
+        Analog_Value_Present_Value_Set(instance, 10.0f, BACNET_MAX_PRIORITY);
+    }
+    zassert_equal(test_Device_COV_Cycle(), 2, NULL);
+    /* the objects of the first subscriber are in one notification */
+    Analog_Value_Present_Value_Set(1, 20.0f, BACNET_MAX_PRIORITY);
+    Analog_Value_Present_Value_Set(3, 20.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 1, NULL);
+    zassert_equal(test_Device_COV_Notification_Decode(
+                      SERVICE_UNCONFIRMED_COV_NOTIFICATION_MULTIPLE),
+        2, NULL);
+    /* a single changed object has its own notification */
+    Analog_Value_Present_Value_Set(3, 30.0f, BACNET_MAX_PRIORITY);
+    zassert_equal(test_Device_COV_Cycle(), 1, NULL);
+    zassert_equal(test_Device_COV_Notification_Decode(
+                      SERVICE_UNCONFIRMED_COV_NOTIFICATION),
+        1, NULL);
+    for (instance = 1; instance <= 3; instance++) {
+        Analog_Value_Delete(instance);
+    }
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST_SUITE(device_tests, NULL, NULL, NULL, NULL, NULL);
 #else
@@ -238,7 +975,19 @@ void test_main(void)
 {
     ztest_test_suite(
         device_tests, ztest_unit_test(testDevice),
-        ztest_unit_test(test_Device_Data_Sharing));
+        ztest_unit_test(test_Device_Data_Sharing),
+        ztest_unit_test(testDeviceObjectList),
+        ztest_unit_test(testDeviceCreateObjectInitialValues),
+        ztest_unit_test(testDevicePropertyCache),
+        ztest_unit_test(testDeviceObjectNameIndex),
+        ztest_unit_test(testDeviceProvision),
+        ztest_unit_test(testDeviceObjectPropertyValue),
+        ztest_unit_test(testDeviceWritePresentValue),
+        ztest_unit_test(testDeviceClock),
+        ztest_unit_test(testDeviceCOVProperty),
+        ztest_unit_test(testDeviceCOVChangeQueue),
+        ztest_unit_test(testDeviceCOVBroadcast),
+        ztest_unit_test(testDeviceCOVNotificationMultiple));
 
     ztest_run_test_suite(device_tests);
 }
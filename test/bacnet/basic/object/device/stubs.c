@@ -27,6 +27,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/datetime.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/npdu.h"
@@ -35,12 +36,16 @@ void datetime_init(void)
 {
 }
 
+/* number of reads of the clock of the OS */
+unsigned Datetime_Local_Count;
+
 bool datetime_local(
     BACNET_DATE *bdate,
     BACNET_TIME *btime,
     int16_t *utc_offset_minutes,
     bool *dst_active)
 {
+    Datetime_Local_Count++;
     return true;
 }
 
@@ -48,11 +53,37 @@ void bip_get_my_address(BACNET_ADDRESS *my_address)
 {
 }
 
+void bip_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    if (dest) {
+        dest->mac_len = 1;
+        dest->mac[0] = 0xFF;
+        dest->net = BACNET_BROADCAST_NETWORK;
+        dest->len = 0;
+    }
+}
+
+/* number of PDUs sent, such as COV notifications */
+unsigned Bip_Send_Count;
+/* number of PDUs sent to the broadcast address */
+unsigned Bip_Broadcast_Count;
+/* the last PDU that was sent */
+uint8_t Bip_Send_PDU[MAX_PDU];
+unsigned Bip_Send_PDU_Len;
+
 int bip_send_pdu(
     BACNET_ADDRESS *dest,
     BACNET_NPDU_DATA *npdu_data,
     uint8_t *pdu,
     unsigned pdu_len)
 {
-    return 0;
+    Bip_Send_Count++;
+    if (pdu_len <= sizeof(Bip_Send_PDU)) {
+        memcpy(Bip_Send_PDU, pdu, pdu_len);
+        Bip_Send_PDU_Len = pdu_len;
+    }
+    if ((dest->mac_len == 1) && (dest->mac[0] == 0xFF) && (dest->net == 0)) {
+        Bip_Broadcast_Count++;
+    }
+    return (int)pdu_len;
 }
@@ -0,0 +1,410 @@
+/**
+ * @file
+ * @brief Unit test for the Event Log object
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/event_log.h>
+#include <bacnet/basic/service/h_cov.h>
+#include <property_test.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+bool handler_cov_local_subscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    (void)subscriber_id;
+    (void)object_type;
+    (void)object_instance;
+    (void)callback;
+    return false;
+}
+
+void handler_cov_local_unsubscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    (void)subscriber_id;
+    (void)object_type;
+    (void)object_instance;
+    (void)callback;
+}
+
+bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
+{
+    (void)object_type;
+    return false;
+}
+
+bool Device_Encode_Value_List(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)value_list;
+    return false;
+}
+
+/**
+ * @brief Make an event notification of an analog input
+ */
+static void test_Event_Log_Event_Data(
+    BACNET_EVENT_NOTIFICATION_DATA *data, uint32_t instance)
+{
+    memset(data, 0, sizeof(*data));
+    data->processIdentifier = 1234;
+    data->initiatingObjectIdentifier.type = OBJECT_DEVICE;
+    data->initiatingObjectIdentifier.instance = 100;
+    data->eventObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    data->eventObjectIdentifier.instance = instance;
+    data->timeStamp.tag = TIME_STAMP_SEQUENCE;
+    data->timeStamp.value.sequenceNum = (uint16_t)instance;
+    data->notificationClass = 1;
+    data->priority = 100;
+    data->eventType = EVENT_OUT_OF_RANGE;
+    data->notifyType = NOTIFY_ALARM;
+    data->ackRequired = true;
+    data->fromState = EVENT_STATE_NORMAL;
+    data->toState = EVENT_STATE_HIGH_LIMIT;
+    data->notificationParams.outOfRange.exceedingValue = 99.0f;
+    bitstring_init(&data->notificationParams.outOfRange.statusFlags);
+    bitstring_set_bit(&data->notificationParams.outOfRange.statusFlags,
+        STATUS_FLAG_IN_ALARM, true);
+    bitstring_set_bit(&data->notificationParams.outOfRange.statusFlags,
+        STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(&data->notificationParams.outOfRange.statusFlags,
+        STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(&data->notificationParams.outOfRange.statusFlags,
+        STATUS_FLAG_OUT_OF_SERVICE, false);
+    data->notificationParams.outOfRange.deadband = 1.0f;
+    data->notificationParams.outOfRange.exceededLimit = 90.0f;
+}
+
+/**
+ * @brief Read a range of records from an event log
+ */
+static int test_Event_Log_Read_Range(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    int request_type,
+    uint32_t ref,
+    int32_t count)
+{
+    memset(pRequest, 0, sizeof(*pRequest));
+    pRequest->object_type = OBJECT_EVENT_LOG;
+    pRequest->object_instance = Event_Log_Index_To_Instance(0);
+    pRequest->object_property = PROP_LOG_BUFFER;
+    pRequest->array_index = BACNET_ARRAY_ALL;
+    pRequest->RequestType = request_type;
+    pRequest->Count = count;
+    bitstring_init(&pRequest->ResultFlags);
+    if (request_type == RR_BY_POSITION) {
+        pRequest->Range.RefIndex = ref;
+    } else if (request_type == RR_BY_SEQUENCE) {
+        pRequest->Range.RefSeqNum = ref;
+    } else {
+        TL_Local_Time_To_BAC(&pRequest->Range.RefTime, ref);
+    }
+
+    return Event_Log_Read_Range_Encode(apdu, pRequest);
+}
+
+/**
+ * @brief Write a property of an event log
+ */
+static bool test_Event_Log_Write(BACNET_PROPERTY_ID object_property,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    bool status;
+
+    wp_data.object_type = OBJECT_EVENT_LOG;
+    wp_data.object_instance = Event_Log_Index_To_Instance(0);
+    wp_data.object_property = object_property;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    wp_data.application_data_len =
+        bacapp_encode_application_data(wp_data.application_data, value);
+    status = Event_Log_Write_Property(&wp_data);
+    if (error_code) {
+        *error_code = wp_data.error_code;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Test the properties of an event log
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(event_log_tests, test_Event_Log_ReadProperty)
+#else
+static void test_Event_Log_ReadProperty(void)
+#endif
+{
+    unsigned count = 0;
+    uint32_t object_instance = 0;
+    bool status = false;
+    const int known_fail_property_list[] = { -1 };
+
+    Event_Log_Init();
+    count = Event_Log_Count();
+    zassert_true(count > 0, NULL);
+    object_instance = Event_Log_Index_To_Instance(0);
+    status = Event_Log_Valid_Instance(object_instance);
+    zassert_true(status, NULL);
+    zassert_false(Event_Log_Valid_Instance(MAX_EVENT_LOGS), NULL);
+    bacnet_object_properties_read_write_test(OBJECT_EVENT_LOG,
+        object_instance, Event_Log_Property_Lists, Event_Log_Read_Property,
+        Event_Log_Write_Property, known_fail_property_list);
+}
+
+/**
+ * @brief Test the recording of event notifications, and reading them
+ *  back with ReadRange
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(event_log_tests, test_Event_Log_Notification)
+#else
+static void test_Event_Log_Notification(void)
+#endif
+{
+    static uint8_t apdu[MAX_APDU];
+    BACNET_EVENT_NOTIFICATION_DATA data = { 0 };
+    BACNET_EVENT_NOTIFICATION_DATA data2 = { 0 };
+    BACNET_CHARACTER_STRING message = { 0 };
+    BACNET_CHARACTER_STRING message2 = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    uint32_t object_instance = 0;
+    int len = 0;
+    int offset = 0;
+
+    Event_Log_Init();
+    object_instance = Event_Log_Index_To_Instance(0);
+    zassert_true(Event_Log_Enable(object_instance), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 0, NULL);
+    test_Event_Log_Event_Data(&data, 7);
+    characterstring_init_ansi(&message, "High Limit");
+    data.messageText = &message;
+    Event_Log_Notification(&data);
+    zassert_equal(Event_Log_Record_Count(object_instance), 1, NULL);
+    zassert_equal(Event_Log_Total_Record_Count(object_instance), 1, NULL);
+    len = test_Event_Log_Read_Range(apdu, &request, RR_BY_POSITION, 1, 1);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 1, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    /* timestamp [0], then logDatum [1] with the notification [1] */
+    zassert_true(decode_is_opening_tag_number(&apdu[0], 0), NULL);
+    offset = 12;
+    zassert_true(decode_is_opening_tag_number(&apdu[offset], 1), NULL);
+    offset++;
+    zassert_true(
+        decode_is_opening_tag_number(&apdu[offset], EL_TYPE_NOTIFICATION),
+        NULL);
+    offset++;
+    zassert_true(decode_is_closing_tag_number(&apdu[len - 1], 1), NULL);
+    zassert_true(decode_is_closing_tag_number(
+                     &apdu[len - 2], EL_TYPE_NOTIFICATION),
+        NULL);
+    data2.messageText = &message2;
+    zassert_true(event_notify_decode_service_request(
+                     &apdu[offset], len - offset - 2, &data2) > 0,
+        NULL);
+    zassert_equal(data2.processIdentifier, 0, NULL);
+    zassert_equal(data2.eventObjectIdentifier.type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(data2.eventObjectIdentifier.instance, 7, NULL);
+    zassert_equal(data2.toState, EVENT_STATE_HIGH_LIMIT, NULL);
+    zassert_true(characterstring_same(&message, &message2), NULL);
+    /* a disabled log records the change, and no events */
+    zassert_true(Event_Log_Enable_Set(object_instance, false), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 2, NULL);
+    Event_Log_Notification(&data);
+    zassert_equal(Event_Log_Record_Count(object_instance), 2, NULL);
+    zassert_true(Event_Log_Enable_Set(object_instance, true), NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 3, NULL);
+    /* the last two records are status records */
+    len = test_Event_Log_Read_Range(apdu, &request, RR_BY_SEQUENCE, 2, 2);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 2, NULL);
+    zassert_equal(request.FirstSequence, 2, NULL);
+    zassert_true(decode_is_context_tag(&apdu[13], EL_TYPE_STATUS), NULL);
+    Event_Log_Notification(NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 3, NULL);
+}
+
+/**
+ * @brief Test an event log that stops when full, and the purge of it
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(event_log_tests, test_Event_Log_Stop_When_Full)
+#else
+static void test_Event_Log_Stop_When_Full(void)
+#endif
+{
+    static EL_DATA_REC records[4];
+    BACNET_EVENT_NOTIFICATION_DATA data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+    uint32_t object_instance = 0;
+    bool status = false;
+    unsigned i;
+
+    Event_Log_Init();
+    object_instance = Event_Log_Index_To_Instance(0);
+    status = Event_Log_Buffer_Set(object_instance, records, 4, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(Event_Log_Buffer_Size(object_instance), 4, NULL);
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = true;
+    status = test_Event_Log_Write(PROP_STOP_WHEN_FULL, &value, NULL);
+    zassert_true(status, NULL);
+    test_Event_Log_Event_Data(&data, 1);
+    for (i = 0; i < 6; i++) {
+        Event_Log_Notification(&data);
+    }
+    zassert_equal(Event_Log_Record_Count(object_instance), 4, NULL);
+    zassert_equal(Event_Log_Total_Record_Count(object_instance), 4, NULL);
+    zassert_false(Event_Log_Enable(object_instance), NULL);
+    /* a full log that stops when full can not be enabled */
+    status = test_Event_Log_Write(PROP_ENABLE, &value, &error_code);
+    zassert_false(status, NULL);
+    zassert_equal(error_code, ERROR_CODE_LOG_BUFFER_FULL, NULL);
+    /* only a record count of zero can be written */
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 1;
+    status = test_Event_Log_Write(PROP_RECORD_COUNT, &value, &error_code);
+    zassert_false(status, NULL);
+    zassert_equal(error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
+    value.type.Unsigned_Int = 0;
+    status = test_Event_Log_Write(PROP_RECORD_COUNT, &value, NULL);
+    zassert_true(status, NULL);
+    /* the purge is recorded */
+    zassert_equal(Event_Log_Record_Count(object_instance), 1, NULL);
+    zassert_equal(records[0].ucRecType, EL_TYPE_STATUS, NULL);
+    zassert_equal(
+        records[0].ucLogStatus, 1 << LOG_STATUS_BUFFER_PURGED, NULL);
+    zassert_true(Event_Log_Enable_Set(object_instance, true), NULL);
+    Event_Log_Notification(&data);
+    zassert_equal(records[2].ucRecType, EL_TYPE_NOTIFICATION, NULL);
+    zassert_true(records[2].usLength > 0, NULL);
+    status = Event_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(
+        Event_Log_Buffer_Size(object_instance), EL_MAX_ENTRIES, NULL);
+}
+
+/**
+ * @brief Test the recovery of an event log from a stored buffer, and
+ *  ReadRange by time on the wrapped buffer
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(event_log_tests, test_Event_Log_Buffer)
+#else
+static void test_Event_Log_Buffer(void)
+#endif
+{
+    static uint8_t apdu[MAX_APDU];
+    static EL_DATA_REC records[8];
+    BACNET_EVENT_NOTIFICATION_DATA data = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    TL_LOG_RING ring = { 0 };
+    uint32_t object_instance = 0;
+    bacnet_time_t tBase = 1000000;
+    bool status = false;
+    int len = 0;
+    unsigned k;
+
+    Event_Log_Init();
+    object_instance = Event_Log_Index_To_Instance(0);
+    status = Event_Log_Buffer_Set(object_instance, records, 8, &ring);
+    zassert_true(status, NULL);
+    test_Event_Log_Event_Data(&data, 1);
+    for (k = 0; k < 11; k++) {
+        Event_Log_Notification(&data);
+    }
+    zassert_equal(ring.ulIndex, 3, NULL);
+    zassert_equal(ring.ulRecordCount, 8, NULL);
+    zassert_equal(ring.ulTotalRecordCount, 11, NULL);
+    /* the oldest record is at index 3 */
+    for (k = 0; k < 8; k++) {
+        records[(3 + k) % 8].tTimeStamp = tBase + (900 * k);
+    }
+    /* recover the log, after a log-interrupted record that replaces the
+       oldest record */
+    status = Event_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    zassert_true(status, NULL);
+    status = Event_Log_Buffer_Set(object_instance, records, 8, &ring);
+    zassert_true(status, NULL);
+    zassert_equal(ring.ulIndex, 4, NULL);
+    zassert_equal(ring.ulTotalRecordCount, 12, NULL);
+    zassert_equal(records[3].ucRecType, EL_TYPE_STATUS, NULL);
+    zassert_equal(
+        records[3].ucLogStatus, 1 << LOG_STATUS_LOG_INTERRUPTED, NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 8, NULL);
+    /* records after the reference time */
+    len = test_Event_Log_Read_Range(
+        apdu, &request, RR_BY_TIME, tBase + (900 * 2), 3);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 7, NULL);
+    /* records before the reference time */
+    len = test_Event_Log_Read_Range(
+        apdu, &request, RR_BY_TIME, tBase + (900 * 5), -2);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 2, NULL);
+    zassert_equal(request.FirstSequence, 7, NULL);
+    /* by position, from the newest record */
+    len = test_Event_Log_Read_Range(apdu, &request, RR_BY_POSITION, 8, -8);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 8, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    /* a stored state that does not fit the buffer is discarded */
+    ring.ulIndex = 8;
+    status = Event_Log_Buffer_Set(object_instance, records, 8, &ring);
+    zassert_true(status, NULL);
+    zassert_equal(ring.ulRecordCount, 0, NULL);
+    zassert_equal(Event_Log_Record_Count(object_instance), 0, NULL);
+    /* invalid buffers and instances */
+    zassert_false(
+        Event_Log_Buffer_Set(object_instance, records, 0, NULL), NULL);
+    zassert_false(
+        Event_Log_Buffer_Set(BACNET_MAX_INSTANCE, records, 8, NULL), NULL);
+    zassert_equal(Event_Log_Buffer_Size(BACNET_MAX_INSTANCE), 0, NULL);
+    status = Event_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    zassert_true(status, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(event_log_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(event_log_tests,
+        ztest_unit_test(test_Event_Log_ReadProperty),
+        ztest_unit_test(test_Event_Log_Notification),
+        ztest_unit_test(test_Event_Log_Stop_When_Full),
+        ztest_unit_test(test_Event_Log_Buffer));
+
+    ztest_run_test_suite(event_log_tests);
+}
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @brief Unit test of the I/O scan of the Present_Value of many objects
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/object/ai.h>
+#include <bacnet/basic/object/av.h>
+#include <bacnet/basic/object/bi.h>
+#include <bacnet/basic/object/ioscan.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* points that are not in the order of the objects */
+static const BACNET_IOSCAN_POINT Points[] = {
+    { OBJECT_ANALOG_INPUT, 4 },  { OBJECT_ANALOG_INPUT, 3 },
+    { OBJECT_ANALOG_INPUT, 2 },  { OBJECT_ANALOG_INPUT, 1 },
+    { OBJECT_BINARY_INPUT, 1 },  { OBJECT_BINARY_INPUT, 2 },
+    { OBJECT_ANALOG_VALUE, 3 },  { OBJECT_ANALOG_INPUT, 99 },
+    { OBJECT_ANALOG_INPUT, 10 },
+};
+
+/**
+ * @brief Test the map of the points, and the scans
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ioscan_tests, testIOScan)
+#else
+static void testIOScan(void)
+#endif
+{
+    static const BACNET_IOSCAN_POINT unsupported[] = {
+        { OBJECT_MULTI_STATE_INPUT, 1 },
+    };
+    BACNET_IOSCAN_MAP map = { 0 };
+    float values[ARRAY_SIZE(Points)] = { 0.0f };
+    uint32_t changed[IOSCAN_BITMAP_WORDS(ARRAY_SIZE(Points))] = { 0 };
+    unsigned changes;
+    bool status;
+
+    Analog_Input_Init();
+    Analog_Value_Init();
+    Binary_Input_Init();
+    zassert_equal(Analog_Input_Create_Bulk(1, 10), 10, NULL);
+    zassert_equal(Analog_Value_Create_Bulk(1, 4), 4, NULL);
+    zassert_equal(Binary_Input_Create_Bulk(1, 4), 4, NULL);
+    status = ioscan_map_init(&map, unsupported, ARRAY_SIZE(unsupported));
+    zassert_false(status, NULL);
+    status = ioscan_map_init(&map, Points, ARRAY_SIZE(Points));
+    zassert_true(status, NULL);
+    zassert_equal(ioscan_map_missing(&map), 1, NULL);
+    /* the first scan has the values of the objects */
+    changes = ioscan_update(&map, values, changed);
+    zassert_equal(changes, 0, NULL);
+    zassert_equal(changed[0], 0, NULL);
+    /* changes by the COV_Increment, and of binary values */
+    values[1] = 2.0f;
+    values[2] = 0.5f;
+    values[5] = 1.0f;
+    values[6] = 10.0f;
+    changes = ioscan_update(&map, values, changed);
+    zassert_equal(changes, 3, NULL);
+    zassert_equal(changed[0], (1UL << 1) | (1UL << 5) | (1UL << 6), NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(3), 2.0f), NULL);
+    zassert_true(Analog_Input_Change_Of_Value(3), NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(2), 0.5f), NULL);
+    zassert_false(Analog_Input_Change_Of_Value(2), NULL);
+    zassert_equal(Binary_Input_Present_Value(2), BINARY_ACTIVE, NULL);
+    zassert_true(Binary_Input_Change_Of_Value(2), NULL);
+    zassert_false(islessgreater(Analog_Value_Present_Value(3), 10.0f), NULL);
+    zassert_true(Analog_Value_Change_Of_Value(3), NULL);
+    /* the same values again are not changes */
+    changes = ioscan_update(&map, values, NULL);
+    zassert_equal(changes, 0, NULL);
+    /* a deleted object moves the rows of the others */
+    zassert_true(Analog_Input_Delete(1), NULL);
+    values[8] = 5.0f;
+    changes = ioscan_update(&map, values, changed);
+    zassert_equal(changes, 1, NULL);
+    zassert_equal(changed[0], 1UL << 8, NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(10), 5.0f), NULL);
+    zassert_equal(ioscan_map_missing(&map), 2, NULL);
+    /* an object created later */
+    zassert_equal(Analog_Input_Create(99), 99, NULL);
+    zassert_true(ioscan_map_resolve(&map), NULL);
+    zassert_equal(ioscan_map_missing(&map), 1, NULL);
+    values[7] = 7.0f;
+    changes = ioscan_update(&map, values, changed);
+    zassert_equal(changes, 1, NULL);
+    zassert_false(islessgreater(Analog_Input_Present_Value(99), 7.0f), NULL);
+    ioscan_map_cleanup(&map);
+    zassert_equal(ioscan_update(&map, values, changed), 0, NULL);
+    zassert_equal(ioscan_update(NULL, values, changed), 0, NULL);
+    Analog_Input_Cleanup();
+    Analog_Value_Cleanup();
+    Binary_Input_Cleanup();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(ioscan_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(ioscan_tests, ztest_unit_test(testIOScan));
+
+    ztest_run_test_suite(ioscan_tests);
+}
+#endif
@@ -137,6 +137,101 @@ static void testLightingOutput(void)
 
     return;
 }
+
+/**
+ * @brief Test the fades, ramps and steps of the active objects
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(lo_tests, testLightingOutputTransitions)
+#else
+static void testLightingOutputTransitions(void)
+#endif
+{
+    BACNET_LIGHTING_COMMAND command = { 0 };
+    const uint32_t fade_instance = 1;
+    const uint32_t ramp_instance = 2;
+    const uint32_t idle_instance = 3;
+    unsigned i;
+
+    Lighting_Output_Init();
+    Lighting_Output_Create(fade_instance);
+    Lighting_Output_Create(ramp_instance);
+    Lighting_Output_Create(idle_instance);
+    zassert_equal(Lighting_Output_Timer_Active_Count(), 0, NULL);
+    /* fade to 80% in 1 second */
+    command.operation = BACNET_LIGHTS_FADE_TO;
+    command.use_target_level = true;
+    command.target_level = 80.0f;
+    command.use_fade_time = true;
+    command.fade_time = 1000;
+    zassert_true(
+        Lighting_Output_Lighting_Command_Set(fade_instance, &command), NULL);
+    /* ramp to 50% at 100% per second */
+    command.operation = BACNET_LIGHTS_RAMP_TO;
+    command.target_level = 50.0f;
+    command.use_fade_time = false;
+    command.use_ramp_rate = true;
+    command.ramp_rate = 100.0f;
+    zassert_true(
+        Lighting_Output_Lighting_Command_Set(ramp_instance, &command), NULL);
+    zassert_equal(Lighting_Output_Timer_Active_Count(), 2, NULL);
+    /* the levels are in proportion to the elapsed time */
+    for (i = 0; i < 25; i++) {
+        Lighting_Output_Timer_Active(10);
+    }
+    zassert_false(
+        islessgreater(Lighting_Output_Tracking_Value(fade_instance), 20.0f),
+        NULL);
+    zassert_equal(
+        Lighting_Output_In_Progress(fade_instance),
+        BACNET_LIGHTING_FADE_ACTIVE, NULL);
+    zassert_false(
+        islessgreater(Lighting_Output_Tracking_Value(ramp_instance), 25.0f),
+        NULL);
+    zassert_equal(
+        Lighting_Output_In_Progress(ramp_instance),
+        BACNET_LIGHTING_RAMP_ACTIVE, NULL);
+    /* the ramp ends after 500ms, the fade after 1000ms */
+    for (i = 0; i < 25; i++) {
+        Lighting_Output_Timer_Active(10);
+    }
+    zassert_false(
+        islessgreater(Lighting_Output_Tracking_Value(ramp_instance), 50.0f),
+        NULL);
+    zassert_equal(
+        Lighting_Output_In_Progress(ramp_instance), BACNET_LIGHTING_IDLE,
+        NULL);
+    zassert_equal(Lighting_Output_Timer_Active_Count(), 1, NULL);
+    for (i = 0; i < 50; i++) {
+        Lighting_Output_Timer(fade_instance, 10);
+    }
+    zassert_false(
+        islessgreater(Lighting_Output_Tracking_Value(fade_instance), 80.0f),
+        NULL);
+    zassert_equal(Lighting_Output_Timer_Active_Count(), 0, NULL);
+    /* a step is done at the next timer */
+    command.operation = BACNET_LIGHTS_STEP_DOWN;
+    command.use_step_increment = true;
+    command.step_increment = 10.0f;
+    zassert_true(
+        Lighting_Output_Lighting_Command_Set(fade_instance, &command), NULL);
+    zassert_equal(Lighting_Output_Timer_Active_Count(), 1, NULL);
+    Lighting_Output_Timer_Active(10);
+    zassert_false(
+        islessgreater(Lighting_Output_Tracking_Value(fade_instance), 70.0f),
+        NULL);
+    zassert_equal(Lighting_Output_Timer_Active_Count(), 0, NULL);
+    /* a deleted object leaves the list of active transitions */
+    command.operation = BACNET_LIGHTS_FADE_TO;
+    zassert_true(
+        Lighting_Output_Lighting_Command_Set(fade_instance, &command), NULL);
+    zassert_true(Lighting_Output_Delete(fade_instance), NULL);
+    zassert_equal(Lighting_Output_Timer_Active_Count(), 0, NULL);
+    zassert_equal(
+        Lighting_Output_In_Progress(idle_instance), BACNET_LIGHTING_IDLE,
+        NULL);
+    Lighting_Output_Cleanup();
+}
 /**
  * @}
  */
@@ -146,7 +241,8 @@ ZTEST_SUITE(lo_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(lo_tests, ztest_unit_test(testLightingOutput));
+    ztest_test_suite(lo_tests, ztest_unit_test(testLightingOutput),
+        ztest_unit_test(testLightingOutputTransitions));
 
     ztest_run_test_suite(lo_tests);
 }
@@ -38,7 +38,7 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 
 void Device_getCurrentDateTime(BACNET_DATE_TIME *DateTime)
 {
-    (void)DateTime;
+    datetime_set_values(DateTime, 2026, 1, 1, 0, 0, 0, 0);
 }
 
 int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
@@ -46,3 +46,41 @@ int Device_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     (void)rpdata;
     return 0;
 }
+
+bool Device_Object_Property_Value(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+    (void)array_index;
+    (void)error_class;
+    (void)error_code;
+    value->tag = MAX_BACNET_APPLICATION_TAG;
+    return true;
+}
+
+bool Device_Object_Property_Value_Set(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+    (void)array_index;
+    (void)value;
+    (void)priority;
+    (void)error_class;
+    (void)error_code;
+    return false;
+}
@@ -40,6 +40,38 @@ static void testMultistateOutput(void)
         OBJECT_MULTI_STATE_OUTPUT, object_instance,
         Multistate_Output_Property_Lists, Multistate_Output_Read_Property,
         Multistate_Output_Write_Property, skip_fail_property_list);
+    /* the highest priority that is commanded is the present-value */
+    status = Multistate_Output_Relinquish_Default_Set(object_instance, 1);
+    zassert_true(status, NULL);
+    zassert_equal(Multistate_Output_Present_Value_Priority(object_instance),
+        0, NULL);
+    zassert_equal(Multistate_Output_Present_Value(object_instance), 1, NULL);
+    status = Multistate_Output_Present_Value_Set(object_instance, 2, 8);
+    zassert_true(status, NULL);
+    status = Multistate_Output_Present_Value_Set(object_instance, 3, 4);
+    zassert_true(status, NULL);
+    status = Multistate_Output_Present_Value_Set(object_instance, 2, 12);
+    zassert_true(status, NULL);
+    zassert_equal(Multistate_Output_Present_Value_Priority(object_instance),
+        4, NULL);
+    zassert_equal(Multistate_Output_Present_Value(object_instance), 3, NULL);
+    status = Multistate_Output_Present_Value_Relinquish(object_instance, 8);
+    zassert_true(status, NULL);
+    zassert_equal(Multistate_Output_Present_Value_Priority(object_instance),
+        4, NULL);
+    status = Multistate_Output_Present_Value_Relinquish(object_instance, 4);
+    zassert_true(status, NULL);
+    zassert_equal(Multistate_Output_Present_Value_Priority(object_instance),
+        12, NULL);
+    zassert_equal(Multistate_Output_Present_Value(object_instance), 2, NULL);
+    status = Multistate_Output_Present_Value_Relinquish(object_instance, 12);
+    zassert_true(status, NULL);
+    zassert_equal(Multistate_Output_Present_Value_Priority(object_instance),
+        0, NULL);
+    zassert_equal(Multistate_Output_Present_Value(object_instance), 1, NULL);
+    status = Multistate_Output_Relinquish_Default_Set(object_instance, 3);
+    zassert_true(status, NULL);
+    zassert_equal(Multistate_Output_Present_Value(object_instance), 3, NULL);
     status = Multistate_Output_Delete(object_instance);
     zassert_true(status, NULL);
 }
@@ -12,6 +12,10 @@
 #include <bacnet/wp.h>
 #include <bacnet/basic/object/nc.h>
 
+/* set and counted by the stubs */
+extern BACNET_DATE_TIME Test_Date_Time;
+extern unsigned Test_UEvent_Count;
+
 /**
  * @addtogroup bacnet_tests
  * @{
@@ -132,6 +136,179 @@ static void test_Notification_Class(void)
 
     return;
 }
+
+/**
+ * @brief Report an event, and count the notifications sent for it
+ */
+static unsigned test_event_notifications(
+    uint32_t instance, uint8_t hour, uint8_t minute, uint8_t second)
+{
+    BACNET_EVENT_NOTIFICATION_DATA event_data = { 0 };
+
+    datetime_set_time(&Test_Date_Time.time, hour, minute, second, 0);
+    event_data.notificationClass = instance;
+    event_data.toState = EVENT_STATE_HIGH_LIMIT;
+    Test_UEvent_Count = 0;
+    Notification_Class_common_reporting_function(&event_data);
+
+    return Test_UEvent_Count;
+}
+
+/**
+ * @brief Test the recipients that are active in their valid times
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(notification_class_tests, test_Notification_Class_Recipients)
+#else
+static void test_Notification_Class_Recipients(void)
+#endif
+{
+    BACNET_DESTINATION recipient_list[NC_MAX_RECIPIENTS] = { 0 };
+    BACNET_DESTINATION *destination;
+    const uint32_t instance = 1;
+    unsigned i;
+
+    Notification_Class_Init();
+    for (i = 0; i < NC_MAX_RECIPIENTS; i++) {
+        bacnet_destination_default_init(&recipient_list[i]);
+    }
+    destination = &recipient_list[0];
+    destination->Recipient.tag = BACNET_RECIPIENT_TAG_ADDRESS;
+    destination->Recipient.type.address.mac_len = 1;
+    destination->Recipient.type.address.mac[0] = 1;
+    datetime_set_time(&destination->FromTime, 8, 0, 0, 0);
+    datetime_set_time(&destination->ToTime, 17, 0, 0, 0);
+    bitstring_set_bit(&destination->Transitions, TRANSITION_TO_OFFNORMAL, true);
+    zassert_true(
+        Notification_Class_Set_Recipient_List(instance, recipient_list), NULL);
+    datetime_set_date(&Test_Date_Time.date, 2026, 10, 14);
+    zassert_equal(test_event_notifications(instance, 7, 59, 59), 0, NULL);
+    zassert_equal(test_event_notifications(instance, 8, 0, 0), 1, NULL);
+    zassert_equal(test_event_notifications(instance, 17, 0, 0), 1, NULL);
+    zassert_equal(test_event_notifications(instance, 17, 0, 1), 0, NULL);
+    /* the window is found again when the recipients change */
+    datetime_set_time(&destination->ToTime, 18, 0, 0, 0);
+    zassert_true(
+        Notification_Class_Set_Recipient_List(instance, recipient_list), NULL);
+    zassert_equal(test_event_notifications(instance, 17, 30, 0), 1, NULL);
+    /* and on the next day */
+    datetime_set_date(&Test_Date_Time.date, 2026, 10, 15);
+    zassert_equal(test_event_notifications(instance, 7, 0, 0), 0, NULL);
+    zassert_equal(test_event_notifications(instance, 9, 0, 0), 1, NULL);
+    /* not on a day that is not valid */
+    bitstring_set_bit(
+        &destination->ValidDays, Test_Date_Time.date.wday - 1, false);
+    zassert_true(
+        Notification_Class_Set_Recipient_List(instance, recipient_list), NULL);
+    zassert_equal(test_event_notifications(instance, 9, 0, 0), 0, NULL);
+}
+
+/**
+ * @brief Encode recipients with the address of a MAC for a list element
+ * @param apdu - buffer for the elements
+ * @param first - MAC of the first recipient
+ * @param count - number of recipients
+ * @return number of bytes encoded
+ */
+static int
+test_list_element_encode(uint8_t *apdu, uint8_t first, unsigned count)
+{
+    BACNET_DESTINATION destination = { 0 };
+    int apdu_len = 0;
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        bacnet_destination_default_init(&destination);
+        destination.Recipient.tag = BACNET_RECIPIENT_TAG_ADDRESS;
+        destination.Recipient.type.address.mac_len = 1;
+        destination.Recipient.type.address.mac[0] = first + i;
+        destination.ProcessIdentifier = first + i;
+        apdu_len += bacnet_destination_encode(&apdu[apdu_len], &destination);
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Test adding and removing elements of the Recipient_List
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(notification_class_tests, test_Notification_Class_List_Element)
+#else
+static void test_Notification_Class_List_Element(void)
+#endif
+{
+    BACNET_DESTINATION recipient_list[NC_MAX_RECIPIENTS] = { 0 };
+    BACNET_LIST_ELEMENT_DATA list_element = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    const uint32_t instance = 1;
+    unsigned i, count;
+    int status, len;
+
+    Notification_Class_Init();
+    list_element.object_type = OBJECT_NOTIFICATION_CLASS;
+    list_element.object_instance = instance;
+    list_element.object_property = PROP_RECIPIENT_LIST;
+    list_element.array_index = BACNET_ARRAY_ALL;
+    list_element.application_data = apdu;
+    list_element.application_data_len = test_list_element_encode(apdu, 1, 4);
+    status = Notification_Class_Add_List_Element(&list_element);
+    zassert_equal(status, BACNET_STATUS_OK, NULL);
+    /* the elements that exist are updated, and the others are added */
+    list_element.application_data_len = test_list_element_encode(apdu, 3, 4);
+    status = Notification_Class_Add_List_Element(&list_element);
+    zassert_equal(status, BACNET_STATUS_OK, NULL);
+    Notification_Class_Get_Recipient_List(instance, recipient_list);
+    count = 0;
+    for (i = 0; i < NC_MAX_RECIPIENTS; i++) {
+        if (!bacnet_recipient_device_wildcard(&recipient_list[i].Recipient)) {
+            zassert_equal(recipient_list[i].ProcessIdentifier,
+                recipient_list[i].Recipient.type.address.mac[0], NULL);
+            count++;
+        }
+    }
+    zassert_equal(count, 6, NULL);
+    /* none are added when there is no space for all of them */
+    list_element.application_data_len =
+        test_list_element_encode(apdu, 7, NC_MAX_RECIPIENTS);
+    status = Notification_Class_Add_List_Element(&list_element);
+    zassert_equal(status, BACNET_STATUS_ERROR, NULL);
+    zassert_equal(list_element.error_code,
+        ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT, NULL);
+    zassert_equal(list_element.first_failed_element_number,
+        NC_MAX_RECIPIENTS - 5, NULL);
+    /* none are removed when one of them does not exist */
+    list_element.application_data_len = test_list_element_encode(apdu, 5, 3);
+    status = Notification_Class_Remove_List_Element(&list_element);
+    zassert_equal(status, BACNET_STATUS_ERROR, NULL);
+    zassert_equal(
+        list_element.error_code, ERROR_CODE_LIST_ELEMENT_NOT_FOUND, NULL);
+    zassert_equal(list_element.first_failed_element_number, 3, NULL);
+    list_element.application_data_len = test_list_element_encode(apdu, 2, 4);
+    status = Notification_Class_Remove_List_Element(&list_element);
+    zassert_equal(status, BACNET_STATUS_OK, NULL);
+    /* the recipients left are found after the others were removed */
+    len = test_list_element_encode(apdu, 1, 1);
+    len += test_list_element_encode(&apdu[len], 6, 1);
+    list_element.application_data_len = len;
+    status = Notification_Class_Remove_List_Element(&list_element);
+    zassert_equal(status, BACNET_STATUS_OK, NULL);
+    Notification_Class_Get_Recipient_List(instance, recipient_list);
+    for (i = 0; i < NC_MAX_RECIPIENTS; i++) {
+        zassert_true(
+            bacnet_recipient_device_wildcard(&recipient_list[i].Recipient),
+            NULL);
+    }
+    /* a truncated element is not decoded */
+    list_element.application_data_len = test_list_element_encode(apdu, 1, 2);
+    list_element.application_data_len =
+        test_list_element_encode(apdu, 1, 1) + 3;
+    status = Notification_Class_Add_List_Element(&list_element);
+    zassert_equal(status, BACNET_STATUS_ERROR, NULL);
+    zassert_equal(
+        list_element.error_code, ERROR_CODE_INVALID_DATA_ENCODING, NULL);
+    zassert_equal(list_element.first_failed_element_number, 2, NULL);
+}
 /**
  * @}
  */
@@ -142,7 +319,9 @@ ZTEST_SUITE(notification_class_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(
-        notification_class_tests, ztest_unit_test(test_Notification_Class));
+        notification_class_tests, ztest_unit_test(test_Notification_Class),
+        ztest_unit_test(test_Notification_Class_Recipients),
+        ztest_unit_test(test_Notification_Class_List_Element));
 
     ztest_run_test_suite(notification_class_tests);
 }
@@ -13,6 +13,10 @@
 #include "bacnet/npdu.h"
 #include "bacnet/basic/object/nc.h"
 
+/* the local date and time, and the number of unconfirmed notifications */
+BACNET_DATE_TIME Test_Date_Time;
+unsigned Test_UEvent_Count;
+
 uint32_t Device_Object_Instance_Number(void)
 {
     return 0;
@@ -24,6 +28,7 @@ int Send_UEvent_Notify(
     (void)buffer;
     (void)data;
     (void)dest;
+    Test_UEvent_Count++;
     return 0;
 }
 
@@ -47,9 +52,13 @@ bool datetime_local(
     int16_t *utc_offset_minutes,
     bool *dst_active)
 {
-    (void)bdate;
-    (void)btime;
     (void)utc_offset_minutes;
     (void)dst_active;
+    if (bdate) {
+        *bdate = Test_Date_Time.date;
+    }
+    if (btime) {
+        *btime = Test_Date_Time.time;
+    }
     return true;
 }
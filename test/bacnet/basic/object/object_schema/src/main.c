@@ -0,0 +1,207 @@
+/**
+ * @file
+ * @brief Unit test for the property schema of an object type
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/object/object_schema.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+struct test_object {
+    bool Out_Of_Service;
+    float Present_Value;
+    uint8_t Priority;
+    int16_t Offset;
+    uint16_t Units;
+};
+
+static const BACNET_OBJECT_SCHEMA_PROPERTY Test_Properties[] = {
+    OBJECT_SCHEMA_PROPERTY(PROP_OUT_OF_SERVICE, BACNET_APPLICATION_TAG_BOOLEAN,
+        struct test_object, Out_Of_Service, OBJECT_SCHEMA_WRITABLE),
+    OBJECT_SCHEMA_PROPERTY(PROP_PRESENT_VALUE, BACNET_APPLICATION_TAG_REAL,
+        struct test_object, Present_Value, OBJECT_SCHEMA_WRITABLE),
+    OBJECT_SCHEMA_PROPERTY(PROP_PRIORITY, BACNET_APPLICATION_TAG_UNSIGNED_INT,
+        struct test_object, Priority, OBJECT_SCHEMA_WRITABLE),
+    OBJECT_SCHEMA_PROPERTY(PROP_PROPORTIONAL_CONSTANT,
+        BACNET_APPLICATION_TAG_SIGNED_INT, struct test_object, Offset,
+        OBJECT_SCHEMA_WRITABLE),
+    OBJECT_SCHEMA_PROPERTY(PROP_UNITS, BACNET_APPLICATION_TAG_ENUMERATED,
+        struct test_object, Units, 0),
+};
+
+static const BACNET_OBJECT_SCHEMA Test_Schema = OBJECT_SCHEMA(Test_Properties);
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(object_schema_tests, test_object_schema_value)
+#else
+static void test_object_schema_value(void)
+#endif
+{
+    struct test_object object = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    const BACNET_OBJECT_SCHEMA_PROPERTY unsorted[] = {
+        OBJECT_SCHEMA_PROPERTY(PROP_UNITS, BACNET_APPLICATION_TAG_ENUMERATED,
+            struct test_object, Units, 0),
+        OBJECT_SCHEMA_PROPERTY(PROP_PRESENT_VALUE, BACNET_APPLICATION_TAG_REAL,
+            struct test_object, Present_Value, 0),
+    };
+    const BACNET_OBJECT_SCHEMA_PROPERTY mismatched[] = {
+        OBJECT_SCHEMA_PROPERTY(PROP_PRESENT_VALUE, BACNET_APPLICATION_TAG_REAL,
+            struct test_object, Units, 0),
+    };
+    BACNET_OBJECT_SCHEMA schema = OBJECT_SCHEMA(unsorted);
+    bool status;
+
+    zassert_true(object_schema_valid(&Test_Schema), NULL);
+    zassert_false(object_schema_valid(&schema), NULL);
+    schema.property = mismatched;
+    schema.count = 1;
+    zassert_false(object_schema_valid(&schema), NULL);
+    zassert_not_null(object_schema_property(&Test_Schema, PROP_UNITS), NULL);
+    zassert_is_null(
+        object_schema_property(&Test_Schema, PROP_OBJECT_NAME), NULL);
+    object.Present_Value = 1.5f;
+    object.Units = UNITS_DEGREES_CELSIUS;
+    object.Offset = -5;
+    status =
+        object_schema_value(&Test_Schema, &object, PROP_PRESENT_VALUE, &value);
+    zassert_true(status, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    zassert_false(islessgreater(value.type.Real, 1.5f), NULL);
+    status = object_schema_value(&Test_Schema, &object, PROP_UNITS, &value);
+    zassert_true(status, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_ENUMERATED, NULL);
+    zassert_equal(value.type.Enumerated, UNITS_DEGREES_CELSIUS, NULL);
+    status = object_schema_value(
+        &Test_Schema, &object, PROP_PROPORTIONAL_CONSTANT, &value);
+    zassert_true(status, NULL);
+    zassert_equal(value.type.Signed_Int, -5, NULL);
+    status =
+        object_schema_value(&Test_Schema, &object, PROP_OBJECT_NAME, &value);
+    zassert_false(status, NULL);
+    /* values that fit the member */
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 255;
+    status =
+        object_schema_value_set(&Test_Schema, &object, PROP_PRIORITY, &value);
+    zassert_true(status, NULL);
+    zassert_equal(object.Priority, 255, NULL);
+    value.type.Unsigned_Int = 256;
+    status =
+        object_schema_value_set(&Test_Schema, &object, PROP_PRIORITY, &value);
+    zassert_false(status, NULL);
+    zassert_equal(object.Priority, 255, NULL);
+    value.tag = BACNET_APPLICATION_TAG_SIGNED_INT;
+    value.type.Signed_Int = -40000;
+    status = object_schema_value_set(
+        &Test_Schema, &object, PROP_PROPORTIONAL_CONSTANT, &value);
+    zassert_false(status, NULL);
+    value.type.Signed_Int = -32768;
+    status = object_schema_value_set(
+        &Test_Schema, &object, PROP_PROPORTIONAL_CONSTANT, &value);
+    zassert_true(status, NULL);
+    zassert_equal(object.Offset, -32768, NULL);
+    /* the value has the type of the property */
+    status =
+        object_schema_value_set(&Test_Schema, &object, PROP_PRIORITY, &value);
+    zassert_false(status, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(object_schema_tests, test_object_schema_read_write)
+#else
+static void test_object_schema_read_write(void)
+#endif
+{
+    struct test_object object = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+    bool status;
+
+    object.Units = UNITS_PERCENT;
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    rpdata.object_property = PROP_UNITS;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len = object_schema_read_property(&Test_Schema, &object, &rpdata);
+    zassert_true(len > 0, NULL);
+    zassert_equal(len, encode_application_enumerated(NULL, UNITS_PERCENT),
+        NULL);
+    len = bacapp_decode_application_data(apdu, len, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(value.type.Enumerated, UNITS_PERCENT, NULL);
+    rpdata.application_data_len = 1;
+    len = object_schema_read_property(&Test_Schema, &object, &rpdata);
+    zassert_equal(len, BACNET_STATUS_ABORT, NULL);
+    rpdata.application_data_len = sizeof(apdu);
+    rpdata.array_index = 1;
+    len = object_schema_read_property(&Test_Schema, &object, &rpdata);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    zassert_equal(rpdata.error_code, ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY, NULL);
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    rpdata.object_property = PROP_DESCRIPTION;
+    len = object_schema_read_property(&Test_Schema, &object, &rpdata);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    zassert_equal(rpdata.error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+    /* writes */
+    wp_data.object_property = PROP_OUT_OF_SERVICE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    value.tag = BACNET_APPLICATION_TAG_BOOLEAN;
+    value.type.Boolean = true;
+    status = object_schema_write_property(
+        &Test_Schema, &object, &wp_data, &value);
+    zassert_true(status, NULL);
+    zassert_true(object.Out_Of_Service, NULL);
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 2.0f;
+    status = object_schema_write_property(
+        &Test_Schema, &object, &wp_data, &value);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_INVALID_DATA_TYPE, NULL);
+    wp_data.object_property = PROP_UNITS;
+    value.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    value.type.Enumerated = UNITS_NO_UNITS;
+    status = object_schema_write_property(
+        &Test_Schema, &object, &wp_data, &value);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    zassert_equal(object.Units, UNITS_PERCENT, NULL);
+    wp_data.object_property = PROP_PRIORITY;
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 1000;
+    status = object_schema_write_property(
+        &Test_Schema, &object, &wp_data, &value);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
+    wp_data.object_property = PROP_DESCRIPTION;
+    status = object_schema_write_property(
+        &Test_Schema, &object, &wp_data, &value);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(object_schema_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(object_schema_tests,
+        ztest_unit_test(test_object_schema_value),
+        ztest_unit_test(test_object_schema_read_write));
+
+    ztest_run_test_suite(object_schema_tests);
+}
+#endif
@@ -62,6 +62,60 @@ static void testPositiveInteger_Value(void)
         required_property++;
     }
 }
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(piv_tests, testPositiveInteger_Value_Write)
+#else
+static void testPositiveInteger_Value_Write(void)
+#endif
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    const uint32_t instance = 1;
+    bool status;
+
+    PositiveInteger_Value_Init();
+    wp_data.object_type = OBJECT_POSITIVE_INTEGER_VALUE;
+    wp_data.object_instance = instance;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_MAX_PRIORITY;
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.application_data_len =
+        encode_application_unsigned(wp_data.application_data, 123);
+    status = PositiveInteger_Value_Write_Property(&wp_data);
+    zassert_true(status, NULL);
+    zassert_equal(PositiveInteger_Value_Present_Value(instance), 123, NULL);
+    wp_data.object_property = PROP_OUT_OF_SERVICE;
+    wp_data.application_data_len =
+        encode_application_boolean(wp_data.application_data, true);
+    status = PositiveInteger_Value_Write_Property(&wp_data);
+    zassert_true(status, NULL);
+    status = PositiveInteger_Value_Property_Value(
+        instance, PROP_OUT_OF_SERVICE, BACNET_ARRAY_ALL, &value);
+    zassert_true(status, NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_BOOLEAN, NULL);
+    zassert_true(value.type.Boolean, NULL);
+    wp_data.object_property = PROP_UNITS;
+    wp_data.application_data_len =
+        encode_application_enumerated(wp_data.application_data, UNITS_PERCENT);
+    status = PositiveInteger_Value_Write_Property(&wp_data);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    wp_data.object_property = PROP_DESCRIPTION;
+    status = PositiveInteger_Value_Write_Property(&wp_data);
+    zassert_false(status, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+    /* typed values */
+    value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+    value.type.Unsigned_Int = 456;
+    status = PositiveInteger_Value_Property_Value_Set(
+        instance, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, &value, 16);
+    zassert_true(status, NULL);
+    status = PositiveInteger_Value_Property_Value(
+        instance, PROP_PRESENT_VALUE, BACNET_ARRAY_ALL, &value);
+    zassert_true(status, NULL);
+    zassert_equal(value.type.Unsigned_Int, 456, NULL);
+}
 /**
  * @}
  */
@@ -71,7 +125,8 @@ ZTEST_SUITE(piv_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(piv_tests, ztest_unit_test(testPositiveInteger_Value));
+    ztest_test_suite(piv_tests, ztest_unit_test(testPositiveInteger_Value),
+        ztest_unit_test(testPositiveInteger_Value_Write));
 
     ztest_run_test_suite(piv_tests);
 }
@@ -8,6 +8,7 @@
  */
 
 #include <zephyr/ztest.h>
+#include <bacnet/datetime.h>
 #include <bacnet/basic/object/schedule.h>
 #include <property_test.h>
 
@@ -40,6 +41,282 @@ static void testSchedule(void)
         Schedule_Read_Property, Schedule_Write_Property,
         skip_fail_property_list);
 }
+
+/**
+ * @brief Test the evaluation of the schedules at their next transition
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleEvaluate)
+#else
+static void testScheduleEvaluate(void)
+#endif
+{
+    BACNET_OBJ_DAILY_SCHEDULE day = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    BACNET_DATE start_date = { 0 }, end_date = { 0 };
+    bacnet_time_t next = 0;
+    uint32_t object_instance = 0;
+    unsigned count = 0;
+
+    Schedule_Init();
+    count = Schedule_Count();
+    object_instance = Schedule_Index_To_Instance(0);
+    /* 08:00 on, 17:00 off, given out of order */
+    day.TV_Count = 2;
+    datetime_set_time(&day.Time_Values[0].Time, 17, 0, 0, 0);
+    day.Time_Values[0].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    day.Time_Values[0].Value.type.Real = 16.0f;
+    datetime_set_time(&day.Time_Values[1].Time, 8, 0, 0, 0);
+    day.Time_Values[1].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    day.Time_Values[1].Value.type.Real = 22.0f;
+    zassert_false(
+        Schedule_Weekly_Schedule_Set(object_instance, 0, &day), NULL);
+    zassert_true(Schedule_Weekly_Schedule_Set(
+                     object_instance, BACNET_WEEKDAY_MONDAY, &day),
+        NULL);
+    /* Monday, 2024-01-15 at 07:00: every schedule is evaluated at first */
+    datetime_set_values(&bdatetime, 2024, 1, 15, 7, 0, 0, 0);
+    zassert_equal(bdatetime.date.wday, BACNET_WEEKDAY_MONDAY, NULL);
+    zassert_equal(Schedule_Evaluate(&bdatetime), count, NULL);
+    zassert_true(Schedule_Present_Value(object_instance, &value), NULL);
+    zassert_equal(value.tag, BACNET_APPLICATION_TAG_REAL, NULL);
+    zassert_false(islessgreater(value.type.Real, 21.0f), NULL);
+    /* nothing to do until the 08:00 transition */
+    next = Schedule_Next_Evaluation();
+    zassert_equal(
+        next, datetime_seconds_since_epoch(&bdatetime) + 3600, NULL);
+    datetime_set_values(&bdatetime, 2024, 1, 15, 7, 59, 59, 0);
+    zassert_equal(Schedule_Evaluate(&bdatetime), 0, NULL);
+    datetime_set_values(&bdatetime, 2024, 1, 15, 8, 0, 0, 0);
+    zassert_equal(Schedule_Evaluate(&bdatetime), 1, NULL);
+    zassert_true(Schedule_Present_Value(object_instance, &value), NULL);
+    zassert_false(islessgreater(value.type.Real, 22.0f), NULL);
+    /* the latest time value that has passed is used */
+    datetime_set_values(&bdatetime, 2024, 1, 15, 17, 0, 0, 0);
+    zassert_equal(Schedule_Evaluate(&bdatetime), 1, NULL);
+    zassert_true(Schedule_Present_Value(object_instance, &value), NULL);
+    zassert_false(islessgreater(value.type.Real, 16.0f), NULL);
+    /* a change to the schedule is evaluated at once */
+    day.Time_Values[0].Value.type.Real = 18.0f;
+    zassert_true(Schedule_Weekly_Schedule_Set(
+                     object_instance, BACNET_WEEKDAY_MONDAY, &day),
+        NULL);
+    zassert_equal(Schedule_Next_Evaluation(), 0, NULL);
+    datetime_set_values(&bdatetime, 2024, 1, 15, 17, 0, 1, 0);
+    zassert_equal(Schedule_Evaluate(&bdatetime), 1, NULL);
+    zassert_true(Schedule_Present_Value(object_instance, &value), NULL);
+    zassert_false(islessgreater(value.type.Real, 18.0f), NULL);
+    /* outside of the Effective_Period is the Schedule_Default */
+    datetime_set_date(&start_date, 2024, 2, 1);
+    datetime_set_date(&end_date, 2024, 2, 29);
+    zassert_true(Schedule_Effective_Period_Set(
+                     object_instance, &start_date, &end_date),
+        NULL);
+    zassert_equal(Schedule_Evaluate(&bdatetime), 1, NULL);
+    zassert_true(Schedule_Present_Value(object_instance, &value), NULL);
+    zassert_false(islessgreater(value.type.Real, 21.0f), NULL);
+    /* the clock set backwards evaluates every schedule */
+    datetime_set_values(&bdatetime, 2024, 1, 15, 9, 0, 0, 0);
+    zassert_equal(Schedule_Evaluate(&bdatetime), count, NULL);
+}
+static unsigned Test_Write_Count;
+static uint32_t Test_Write_Device;
+static unsigned Test_Write_References;
+static bool Test_Write_Busy;
+
+static bool test_write_multiple(uint32_t object_instance,
+    uint32_t device_instance,
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE **references,
+    unsigned count,
+    BACNET_APPLICATION_DATA_VALUE *value,
+    uint8_t priority)
+{
+    (void)object_instance;
+    (void)references;
+    (void)priority;
+    if (Test_Write_Busy || !value) {
+        return false;
+    }
+    Test_Write_Count++;
+    Test_Write_Device = device_instance;
+    Test_Write_References = count;
+
+    return true;
+}
+
+/**
+ * @brief Test that a change of the Present_Value is written to the
+ *  referenced properties of each device together, after the jitter
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleWrites)
+#else
+static void testScheduleWrites(void)
+#endif
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE reference = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    uint32_t object_instance = 0;
+
+    Schedule_Init();
+    Schedule_Write_Multiple_Callback_Set(test_write_multiple);
+    Schedule_Write_Jitter_Set(0);
+    object_instance = Schedule_Index_To_Instance(0);
+    reference.objectIdentifier.type = OBJECT_ANALOG_OUTPUT;
+    reference.propertyIdentifier = PROP_PRESENT_VALUE;
+    reference.arrayIndex = BACNET_ARRAY_ALL;
+    reference.deviceIdentifier.type = OBJECT_DEVICE;
+    reference.deviceIdentifier.instance = 100;
+    zassert_true(
+        Schedule_Object_Property_Reference_Add(object_instance, &reference),
+        NULL);
+    reference.objectIdentifier.instance = 1;
+    zassert_true(
+        Schedule_Object_Property_Reference_Add(object_instance, &reference),
+        NULL);
+    reference.deviceIdentifier.instance = 200;
+    zassert_true(
+        Schedule_Object_Property_Reference_Add(object_instance, &reference),
+        NULL);
+    /* a new Schedule_Default changes the Present_Value */
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 18.0f;
+    zassert_true(Schedule_Default_Set(object_instance, &value), NULL);
+    datetime_set_values(&bdatetime, 2024, 1, 15, 7, 0, 0, 0);
+    Test_Write_Count = 0;
+    Schedule_Evaluate(&bdatetime);
+    zassert_equal(Test_Write_Count, 2, NULL);
+    zassert_equal(Test_Write_Device, 200, NULL);
+    zassert_equal(Test_Write_References, 1, NULL);
+    zassert_true(Schedule_Write_Multiple_Result(object_instance, 200, 1),
+        NULL);
+    zassert_false(Schedule_Write_Multiple_Result(object_instance, 200, 1),
+        NULL);
+    /* the first write to device 100 failed, the second was not done */
+    zassert_true(Schedule_Write_Multiple_Result(object_instance, 100, 0),
+        NULL);
+    Test_Write_Count = 0;
+    Schedule_Timer(object_instance, 1000);
+    zassert_equal(Test_Write_Count, 1, NULL);
+    zassert_equal(Test_Write_Device, 100, NULL);
+    zassert_equal(Test_Write_References, 1, NULL);
+    zassert_true(Schedule_Write_Multiple_Result(object_instance, 100, 1),
+        NULL);
+    /* a busy network defers the writes, and a jitter delays them */
+    value.type.Real = 10.0f;
+    zassert_true(Schedule_Default_Set(object_instance, &value), NULL);
+    Schedule_Write_Jitter_Set(60000);
+    Test_Write_Busy = true;
+    Test_Write_Count = 0;
+    Schedule_Evaluate(&bdatetime);
+    Schedule_Timer(object_instance, 60000);
+    zassert_equal(Test_Write_Count, 0, NULL);
+    Test_Write_Busy = false;
+    Schedule_Timer(object_instance, 1000);
+    zassert_equal(Test_Write_Count, 2, NULL);
+    Schedule_Write_Jitter_Set(0);
+    /* no change, no writes */
+    zassert_true(Schedule_Write_Multiple_Result(object_instance, 100, 2),
+        NULL);
+    zassert_true(Schedule_Write_Multiple_Result(object_instance, 200, 1),
+        NULL);
+    Schedule_Recalculate_Request(object_instance);
+    Test_Write_Count = 0;
+    Schedule_Evaluate(&bdatetime);
+    Schedule_Timer(object_instance, 1000);
+    zassert_equal(Test_Write_Count, 0, NULL);
+    Schedule_Write_Multiple_Callback_Set(NULL);
+}
+
+/**
+ * @brief Test that the Weekly_Schedule is written in place, one day or
+ *  the whole week, and read back
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleWeeklyScheduleWrite)
+#else
+static void testScheduleWeeklyScheduleWrite(void)
+#endif
+{
+    BACNET_OBJ_DAILY_SCHEDULE day = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_WEEKLY_SCHEDULE_LIST list = { 0 };
+    BACNET_TIME_VALUE storage[BACNET_SCHEDULE_TIME_VALUES_SIZE] = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    unsigned i;
+    int len;
+
+    Schedule_Init();
+    day.TV_Count = 1;
+    datetime_set_time(&day.Time_Values[0].Time, 6, 30, 0, 0);
+    day.Time_Values[0].Value.tag = BACNET_APPLICATION_TAG_REAL;
+    day.Time_Values[0].Value.type.Real = 20.0f;
+    bacnet_weeklyschedule_list_init(
+        &list, storage, BACNET_SCHEDULE_TIME_VALUES_SIZE);
+    zassert_true(bacnet_weeklyschedule_list_day_set(
+                     &list, 4, day.Time_Values, day.TV_Count),
+        NULL);
+    /* write Friday */
+    wp_data.object_type = OBJECT_SCHEDULE;
+    wp_data.object_instance = Schedule_Index_To_Instance(0);
+    wp_data.object_property = PROP_WEEKLY_SCHEDULE;
+    wp_data.array_index = BACNET_WEEKDAY_FRIDAY;
+    wp_data.application_data_len = bacnet_weeklyschedule_list_day_encode(
+        wp_data.application_data, &list, 4);
+    zassert_true(Schedule_Write_Property(&wp_data), NULL);
+    zassert_equal(Schedule_Next_Evaluation(), 0, NULL);
+    rp_data.object_type = OBJECT_SCHEDULE;
+    rp_data.object_instance = wp_data.object_instance;
+    rp_data.object_property = PROP_WEEKLY_SCHEDULE;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = apdu;
+    rp_data.application_data_len = sizeof(apdu);
+    len = Schedule_Read_Property(&rp_data);
+    zassert_equal(len, bacnet_weeklyschedule_list_encode(NULL, &list), NULL);
+    /* the whole week, as read */
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.application_data_len = len;
+    memcpy(wp_data.application_data, apdu, len);
+    zassert_true(Schedule_Write_Property(&wp_data), NULL);
+    /* the array size, or a day that is not in the array */
+    wp_data.array_index = 0;
+    zassert_false(Schedule_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    wp_data.array_index = 8;
+    zassert_false(Schedule_Write_Property(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_INVALID_ARRAY_INDEX, NULL);
+    /* the days share the time values of the object */
+    day.TV_Count = BACNET_SCHEDULE_TIME_VALUES_SIZE / 7;
+    for (i = 1; i < day.TV_Count; i++) {
+        day.Time_Values[i] = day.Time_Values[0];
+    }
+    zassert_true(bacnet_weeklyschedule_list_day_set(
+                     &list, 0, day.Time_Values, day.TV_Count),
+        NULL);
+    wp_data.application_data_len = bacnet_weeklyschedule_list_day_encode(
+        wp_data.application_data, &list, 0);
+    for (i = 0; i < 7; i++) {
+        wp_data.array_index = i + 1;
+        zassert_true(Schedule_Write_Property(&wp_data), NULL);
+    }
+    day.TV_Count++;
+    zassert_false(Schedule_Weekly_Schedule_Set(
+                      wp_data.object_instance, BACNET_WEEKDAY_MONDAY, &day),
+        NULL);
+    zassert_true(bacnet_weeklyschedule_list_day_set(
+                     &list, 0, day.Time_Values, day.TV_Count),
+        NULL);
+    wp_data.application_data_len = bacnet_weeklyschedule_list_day_encode(
+        wp_data.application_data, &list, 0);
+    wp_data.array_index = BACNET_WEEKDAY_MONDAY;
+    zassert_false(Schedule_Write_Property(&wp_data), NULL);
+    zassert_equal(
+        wp_data.error_code, ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY, NULL);
+}
+
 /**
  * @}
  */
@@ -49,7 +326,10 @@ ZTEST_SUITE(schedule_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(schedule_tests, ztest_unit_test(testSchedule));
+    ztest_test_suite(schedule_tests, ztest_unit_test(testSchedule),
+        ztest_unit_test(testScheduleEvaluate),
+        ztest_unit_test(testScheduleWeeklyScheduleWrite),
+        ztest_unit_test(testScheduleWrites));
 
     ztest_run_test_suite(schedule_tests);
 }
@@ -0,0 +1,335 @@
+/**
+ * @file
+ * @brief Unit test for the snapshot of the object database
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/create_object.h>
+#include <bacnet/delete_object.h>
+#include <bacnet/proplist.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/snapshot.h>
+#include <bacnet/basic/service/h_cov.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* a change that was replayed */
+struct test_replay {
+    char kind;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    uint8_t priority;
+    float value;
+    uint32_t lifetime;
+};
+static struct test_replay Test_Replay[16];
+static unsigned Test_Replay_Count;
+static uint8_t Test_Buffer[4096];
+static const int Test_Commandable_Properties[] = { PROP_PRESENT_VALUE,
+    PROP_PRIORITY_ARRAY, PROP_RELINQUISH_DEFAULT, -1 };
+
+static struct test_replay *test_replay_add(char kind)
+{
+    struct test_replay *replay = &Test_Replay[Test_Replay_Count];
+
+    memset(replay, 0, sizeof(*replay));
+    replay->kind = kind;
+    if (Test_Replay_Count < (ARRAY_SIZE(Test_Replay) - 1)) {
+        Test_Replay_Count++;
+    }
+
+    return replay;
+}
+
+void Device_Objects_Property_List(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    struct special_property_list_t *pPropertyList)
+{
+    (void)object_instance;
+    memset(pPropertyList, 0, sizeof(*pPropertyList));
+    if (object_type == OBJECT_ANALOG_OUTPUT) {
+        pPropertyList->Required.pList = Test_Commandable_Properties;
+        pPropertyList->Required.count =
+            property_list_count(Test_Commandable_Properties);
+    }
+}
+
+bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    struct test_replay *replay = test_replay_add('W');
+
+    replay->object_type = wp_data->object_type;
+    replay->object_instance = wp_data->object_instance;
+    replay->object_property = wp_data->object_property;
+    replay->priority = wp_data->priority;
+    (void)bacnet_real_application_decode(wp_data->application_data,
+        wp_data->application_data_len, &replay->value);
+    /* as the device does, which the replay must not record again */
+    snapshot_write_property(wp_data);
+
+    return true;
+}
+
+bool Device_Create_Object(BACNET_CREATE_OBJECT_DATA *data)
+{
+    struct test_replay *replay = test_replay_add('C');
+
+    replay->object_type = data->object_type;
+    replay->object_instance = data->object_instance;
+    snapshot_create_object(data->object_type, data->object_instance);
+
+    return true;
+}
+
+bool Device_Delete_Object(BACNET_DELETE_OBJECT_DATA *data)
+{
+    struct test_replay *replay = test_replay_add('D');
+
+    replay->object_type = data->object_type;
+    replay->object_instance = data->object_instance;
+    snapshot_delete_object(data->object_type, data->object_instance);
+
+    return true;
+}
+
+bool handler_cov_subscription_restore(
+    BACNET_ADDRESS *src, BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    struct test_replay *replay = test_replay_add('S');
+
+    replay->object_type =
+        (BACNET_OBJECT_TYPE)cov_data->monitoredObjectIdentifier.type;
+    replay->object_instance = cov_data->monitoredObjectIdentifier.instance;
+    replay->lifetime = cov_data->lifetime;
+    zassert_equal(src->mac_len, 6, NULL);
+    zassert_equal(src->mac[5], 0xC0, NULL);
+
+    return true;
+}
+
+/**
+ * @brief Record a write of a REAL, or of NULL, to a property
+ */
+static void test_write(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint8_t priority,
+    bool null,
+    float value)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+
+    wp_data.object_type = object_type;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = object_property;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = priority;
+    if (null) {
+        wp_data.application_data_len =
+            encode_application_null(wp_data.application_data);
+    } else {
+        wp_data.application_data_len =
+            encode_application_real(wp_data.application_data, value);
+    }
+    snapshot_write_property(&wp_data);
+}
+
+/**
+ * @brief Record a SubscribeCOV, or its cancellation
+ */
+static void test_subscribe(
+    uint32_t process_identifier, uint32_t lifetime, bool cancel)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    const uint8_t mac[6] = { 192, 168, 0, 1, 0xBA, 0xC0 };
+
+    src.mac_len = sizeof(mac);
+    memcpy(src.mac, mac, sizeof(mac));
+    cov_data.subscriberProcessIdentifier = process_identifier;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_OUTPUT;
+    cov_data.monitoredObjectIdentifier.instance = 0;
+    cov_data.cancellationRequest = cancel;
+    cov_data.issueConfirmedNotifications = true;
+    cov_data.lifetime = lifetime;
+    snapshot_subscribe_cov(&src, &cov_data);
+}
+
+/**
+ * @brief Test the journal of changes, and their replay after a restart
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(snapshot_tests, test_snapshot_journal)
+#else
+static void test_snapshot_journal(void)
+#endif
+{
+    int count;
+
+    memset(Test_Buffer, 0, sizeof(Test_Buffer));
+    zassert_false(snapshot_init(Test_Buffer, sizeof(Test_Buffer)), NULL);
+    zassert_true(snapshot_complete(), NULL);
+    zassert_equal(snapshot_record_count(), 0, NULL);
+    zassert_equal(snapshot_used(), SNAPSHOT_HEADER_SIZE, NULL);
+    /* a newer write to the same priority replaces the older one */
+    test_write(OBJECT_ANALOG_OUTPUT, 0, PROP_PRESENT_VALUE, 8, false, 1.0f);
+    test_write(OBJECT_ANALOG_OUTPUT, 0, PROP_PRESENT_VALUE, 8, false, 2.0f);
+    zassert_equal(snapshot_record_count(), 1, NULL);
+    /* a relinquish removes the write to its priority */
+    test_write(OBJECT_ANALOG_OUTPUT, 0, PROP_PRESENT_VALUE, 10, false, 3.0f);
+    zassert_equal(snapshot_record_count(), 2, NULL);
+    test_write(OBJECT_ANALOG_OUTPUT, 0, PROP_PRESENT_VALUE, 10, true, 0.0f);
+    zassert_equal(snapshot_record_count(), 1, NULL);
+    /* the priority has no part in writes to other objects */
+    test_write(OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 0, false, 4.0f);
+    test_write(OBJECT_ANALOG_VALUE, 1, PROP_PRESENT_VALUE, 8, false, 5.0f);
+    zassert_equal(snapshot_record_count(), 2, NULL);
+    /* an object that is created and deleted leaves nothing */
+    snapshot_create_object(OBJECT_ANALOG_VALUE, 7);
+    test_write(OBJECT_ANALOG_VALUE, 7, PROP_PRESENT_VALUE, 0, false, 6.0f);
+    zassert_equal(snapshot_record_count(), 4, NULL);
+    snapshot_delete_object(OBJECT_ANALOG_VALUE, 7);
+    zassert_equal(snapshot_record_count(), 2, NULL);
+    /* the deletion of an object that was not created is kept */
+    snapshot_delete_object(OBJECT_ANALOG_INPUT, 3);
+    zassert_equal(snapshot_record_count(), 3, NULL);
+    /* a renewed subscription replaces the older one */
+    test_subscribe(1, 300, false);
+    test_subscribe(1, 600, false);
+    test_subscribe(2, 300, false);
+    zassert_equal(snapshot_record_count(), 5, NULL);
+    test_subscribe(2, 0, true);
+    zassert_equal(snapshot_record_count(), 4, NULL);
+    zassert_true(snapshot_complete(), NULL);
+    /* restart with the same buffer */
+    zassert_true(snapshot_init(Test_Buffer, sizeof(Test_Buffer)), NULL);
+    zassert_equal(snapshot_record_count(), 4, NULL);
+    Test_Replay_Count = 0;
+    count = snapshot_restore();
+    zassert_equal(count, 4, NULL);
+    zassert_equal(Test_Replay_Count, 4, NULL);
+    zassert_equal(Test_Replay[0].kind, 'W', NULL);
+    zassert_equal(Test_Replay[0].object_type, OBJECT_ANALOG_OUTPUT, NULL);
+    zassert_equal(Test_Replay[0].priority, 8, NULL);
+    zassert_false(islessgreater(Test_Replay[0].value, 2.0f), NULL);
+    zassert_equal(Test_Replay[1].kind, 'W', NULL);
+    zassert_equal(Test_Replay[1].object_type, OBJECT_ANALOG_VALUE, NULL);
+    zassert_equal(Test_Replay[1].priority, BACNET_NO_PRIORITY, NULL);
+    zassert_false(islessgreater(Test_Replay[1].value, 5.0f), NULL);
+    zassert_equal(Test_Replay[2].kind, 'D', NULL);
+    zassert_equal(Test_Replay[2].object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(Test_Replay[2].object_instance, 3, NULL);
+    /* the subscriptions are made after the objects */
+    zassert_equal(Test_Replay[3].kind, 'S', NULL);
+    zassert_equal(Test_Replay[3].lifetime, 600, NULL);
+    /* the replay is not recorded again */
+    zassert_equal(snapshot_record_count(), 4, NULL);
+}
+
+/**
+ * @brief Test the compaction of the buffer, and a buffer that is full
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(snapshot_tests, test_snapshot_compact)
+#else
+static void test_snapshot_compact(void)
+#endif
+{
+    size_t offset = 0;
+    size_t length = 0;
+    unsigned i;
+    unsigned generation;
+
+    memset(Test_Buffer, 0, sizeof(Test_Buffer));
+    zassert_false(snapshot_init(Test_Buffer, 256), NULL);
+    zassert_true(snapshot_dirty(&offset, &length), NULL);
+    zassert_equal(offset, 0, NULL);
+    zassert_equal(length, SNAPSHOT_HEADER_SIZE, NULL);
+    zassert_false(snapshot_dirty(&offset, &length), NULL);
+    generation = snapshot_generation();
+    for (i = 0; i < 1000; i++) {
+        test_write(
+            OBJECT_ANALOG_OUTPUT, 0, PROP_PRESENT_VALUE, 8, false, (float)i);
+    }
+    zassert_true(snapshot_complete(), NULL);
+    zassert_equal(snapshot_record_count(), 1, NULL);
+    zassert_true(snapshot_used() <= 256, NULL);
+    /* the records were moved by the compaction */
+    zassert_not_equal(snapshot_generation(), generation, NULL);
+    zassert_true(snapshot_dirty(&offset, &length), NULL);
+    zassert_true((offset + length) <= 256, NULL);
+    /* the same value again is no change */
+    test_write(OBJECT_ANALOG_OUTPUT, 0, PROP_PRESENT_VALUE, 8, false, 999.0f);
+    zassert_false(snapshot_dirty(&offset, &length), NULL);
+    /* more changes than fit */
+    for (i = 0; i < 100; i++) {
+        test_write(OBJECT_ANALOG_VALUE, i, PROP_PRESENT_VALUE, 0, false, 1.0f);
+    }
+    zassert_false(snapshot_complete(), NULL);
+    zassert_equal(snapshot_restore(), -1, NULL);
+    zassert_false(snapshot_init(Test_Buffer, 256), NULL);
+    generation = snapshot_generation();
+    snapshot_clear();
+    zassert_not_equal(snapshot_generation(), generation, NULL);
+    zassert_true(snapshot_complete(), NULL);
+    zassert_equal(snapshot_record_count(), 0, NULL);
+    zassert_equal(snapshot_restore(), 0, NULL);
+}
+
+/**
+ * @brief Test a buffer with a damaged record
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(snapshot_tests, test_snapshot_damaged)
+#else
+static void test_snapshot_damaged(void)
+#endif
+{
+    size_t used;
+
+    memset(Test_Buffer, 0, sizeof(Test_Buffer));
+    zassert_false(snapshot_init(Test_Buffer, sizeof(Test_Buffer)), NULL);
+    test_write(OBJECT_ANALOG_OUTPUT, 0, PROP_PRESENT_VALUE, 8, false, 1.0f);
+    used = snapshot_used();
+    test_write(OBJECT_ANALOG_OUTPUT, 1, PROP_PRESENT_VALUE, 8, false, 2.0f);
+    test_write(OBJECT_ANALOG_OUTPUT, 2, PROP_PRESENT_VALUE, 8, false, 3.0f);
+    zassert_equal(snapshot_record_count(), 3, NULL);
+    /* damage the key of the second record */
+    Test_Buffer[used + 10] ^= 0x55;
+    zassert_false(snapshot_init(Test_Buffer, sizeof(Test_Buffer)), NULL);
+    zassert_false(snapshot_complete(), NULL);
+    zassert_equal(snapshot_record_count(), 1, NULL);
+    zassert_equal(snapshot_used(), used, NULL);
+    zassert_equal(snapshot_restore(), -1, NULL);
+    /* a buffer that is not a snapshot */
+    memset(Test_Buffer, 0xFF, sizeof(Test_Buffer));
+    zassert_false(snapshot_init(Test_Buffer, sizeof(Test_Buffer)), NULL);
+    zassert_true(snapshot_complete(), NULL);
+    zassert_equal(snapshot_record_count(), 0, NULL);
+    zassert_false(snapshot_init(NULL, 0), NULL);
+    zassert_false(snapshot_complete(), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(snapshot_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(snapshot_tests, ztest_unit_test(test_snapshot_journal),
+        ztest_unit_test(test_snapshot_compact),
+        ztest_unit_test(test_snapshot_damaged));
+
+    ztest_run_test_suite(snapshot_tests);
+}
+#endif
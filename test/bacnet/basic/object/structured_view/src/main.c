@@ -6,7 +6,9 @@
  *
  * SPDX-License-Identifier: MIT
  */
+#include <string.h>
 #include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
 #include <bacnet/basic/object/structured_view.h>
 #include <property_test.h>
 
@@ -15,6 +17,26 @@
  * @{
  */
 
+/* the Object_Name of the local subordinates of the test */
+static char Subordinate_Name[16] = "light";
+
+/**
+ * @brief Get the Object_Name of a subordinate in device 1
+ */
+static bool test_subordinate_name(
+    uint32_t device_instance,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_CHARACTER_STRING *object_name)
+{
+    (void)object_instance;
+    if ((device_instance != 1) || (object_type != OBJECT_LIGHTING_OUTPUT)) {
+        return false;
+    }
+
+    return characterstring_init_ansi(object_name, Subordinate_Name);
+}
+
 /**
  * @brief Test
  */
@@ -40,6 +62,95 @@ static void test_object_structured_view(void)
     bacnet_object_properties_read_write_test(
         OBJECT_STRUCTURED_VIEW, instance, Structured_View_Property_Lists,
         Structured_View_Read_Property, NULL, skip_fail_property_list);
+    Structured_View_Cleanup();
+}
+
+/**
+ * @brief Test the ReadRange of the subordinates, with the names of the
+ *  local subordinates
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tests_object_structured_view, test_object_structured_view_subordinates)
+#else
+static void test_object_structured_view_subordinates(void)
+#endif
+{
+    BACNET_SUBORDINATE_DATA subordinate[3] = {
+        { 1, OBJECT_LIGHTING_OUTPUT, 1, NULL, BACNET_NODE_ROOM,
+          BACNET_RELATIONSHIP_CONTAINS, &subordinate[1] },
+        { 1, OBJECT_LIGHTING_OUTPUT, 2, "lamp", BACNET_NODE_ROOM,
+          BACNET_RELATIONSHIP_CONTAINS, &subordinate[2] },
+        { 2, OBJECT_LIGHTING_OUTPUT, 3, NULL, BACNET_NODE_ROOM,
+          BACNET_RELATIONSHIP_CONTAINS, NULL },
+    };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    RR_PROP_INFO info = { 0 };
+    BACNET_CHARACTER_STRING value = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    const uint32_t instance = 123;
+    int len;
+    bool status;
+
+    Structured_View_Init();
+    Structured_View_Create(instance);
+    Structured_View_Subordinate_List_Set(instance, subordinate);
+    zassert_equal(Structured_View_Subordinate_List_Count(instance), 3, NULL);
+    zassert_equal(
+        Structured_View_Subordinate_List_Member(instance, 2), &subordinate[2],
+        NULL);
+    zassert_is_null(Structured_View_Subordinate_List_Member(instance, 3), NULL);
+    request.object_type = OBJECT_STRUCTURED_VIEW;
+    request.object_instance = instance;
+    request.object_property = PROP_OBJECT_NAME;
+    status = Structured_View_RR_Info(&request, &info);
+    zassert_false(status, NULL);
+    zassert_equal(request.error_code, ERROR_CODE_PROPERTY_IS_NOT_A_LIST, NULL);
+    request.object_property = PROP_SUBORDINATE_ANNOTATIONS;
+    status = Structured_View_RR_Info(&request, &info);
+    zassert_true(status, NULL);
+    zassert_equal(info.Element_Count, 3, NULL);
+    zassert_not_null(info.Element_Encode, NULL);
+    /* without the callback, a subordinate without annotation is empty */
+    len = info.Element_Encode(instance, 0, apdu);
+    zassert_true(len > 0, NULL);
+    len = bacnet_character_string_application_decode(apdu, len, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(characterstring_length(&value), 0, NULL);
+    /* the name of a local subordinate without annotation */
+    Structured_View_Subordinate_Name_Callback_Set(test_subordinate_name);
+    len = info.Element_Encode(instance, 0, NULL);
+    zassert_equal(len, info.Element_Encode(instance, 0, apdu), NULL);
+    len = bacnet_character_string_application_decode(apdu, len, &value);
+    zassert_true(len > 0, NULL);
+    zassert_true(characterstring_ansi_same(&value, "light"), NULL);
+    len = info.Element_Encode(instance, 1, apdu);
+    len = bacnet_character_string_application_decode(apdu, len, &value);
+    zassert_true(characterstring_ansi_same(&value, "lamp"), NULL);
+    len = info.Element_Encode(instance, 2, apdu);
+    characterstring_init_ansi(&value, NULL);
+    len = bacnet_character_string_application_decode(apdu, len, &value);
+    zassert_true(len > 0, NULL);
+    zassert_equal(characterstring_length(&value), 0, NULL);
+    /* a renamed subordinate */
+    strcpy(Subordinate_Name, "kitchen");
+    len = info.Element_Encode(instance, 0, apdu);
+    len = bacnet_character_string_application_decode(apdu, len, &value);
+    zassert_true(characterstring_ansi_same(&value, "light"), NULL);
+    Structured_View_Subordinate_Cache_Invalidate(OBJECT_LIGHTING_OUTPUT, 1);
+    len = info.Element_Encode(instance, 0, apdu);
+    len = bacnet_character_string_application_decode(apdu, len, &value);
+    zassert_true(characterstring_ansi_same(&value, "kitchen"), NULL);
+    /* a shorter list */
+    subordinate[0].next = NULL;
+    Structured_View_Subordinate_List_Set(instance, subordinate);
+    zassert_equal(Structured_View_Subordinate_List_Count(instance), 1, NULL);
+    zassert_is_null(Structured_View_Subordinate_List_Member(instance, 1), NULL);
+    request.object_instance = instance + 1;
+    status = Structured_View_RR_Info(&request, &info);
+    zassert_false(status, NULL);
+    zassert_equal(request.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    Structured_View_Subordinate_Name_Callback_Set(NULL);
+    Structured_View_Cleanup();
 }
 /**
  * @}
@@ -52,7 +163,8 @@ void test_main(void)
 {
     ztest_test_suite(
         tests_object_structured_view, 
-        ztest_unit_test(test_object_structured_view));
+        ztest_unit_test(test_object_structured_view),
+        ztest_unit_test(test_object_structured_view_subordinates));
 
     ztest_run_test_suite(tests_object_structured_view);
 }
@@ -7,8 +7,13 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <math.h>
+#include <string.h>
 #include <zephyr/ztest.h>
+#include <bacnet/basic/object/device.h>
 #include <bacnet/basic/object/trendlog.h>
+#include <bacnet/basic/object/trendlog_block.h>
+#include <bacnet/basic/service/h_cov.h>
 #include <property_test.h>
 
 /**
@@ -16,6 +21,70 @@
  * @{
  */
 
+/* the local COV subscription of the trend log under test */
+static handler_cov_local_callback Test_COV_Callback;
+static uint32_t Test_COV_Subscriber;
+static bool Test_COV_Subscribed;
+/* the present value of the logged object */
+static float Test_Present_Value;
+
+bool handler_cov_local_subscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    (void)object_type;
+    (void)object_instance;
+    Test_COV_Callback = callback;
+    Test_COV_Subscriber = subscriber_id;
+    Test_COV_Subscribed = true;
+    return true;
+}
+
+void handler_cov_local_unsubscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    (void)subscriber_id;
+    (void)object_type;
+    (void)object_instance;
+    (void)callback;
+    Test_COV_Subscribed = false;
+}
+
+bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
+{
+    return (object_type == OBJECT_ANALOG_INPUT);
+}
+
+bool Device_Encode_Value_List(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    if ((object_type != OBJECT_ANALOG_INPUT) || (object_instance != 0)) {
+        return false;
+    }
+    value_list->propertyIdentifier = PROP_PRESENT_VALUE;
+    value_list->value.tag = BACNET_APPLICATION_TAG_REAL;
+    value_list->value.type.Real = Test_Present_Value;
+    value_list = value_list->next;
+    value_list->propertyIdentifier = PROP_STATUS_FLAGS;
+    value_list->value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value_list->value.type.Bit_String);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_IN_ALARM, true);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_OUT_OF_SERVICE,
+        false);
+
+    return true;
+}
+
 /**
  * @brief Test
  */
@@ -37,14 +106,588 @@ static void test_Trend_Log_ReadProperty(void)
         Trend_Log_Read_Property, Trend_Log_Write_Property,
         known_fail_property_list);
 }
+/**
+ * @brief Read an unsigned property of a trend log
+ */
+static BACNET_UNSIGNED_INTEGER test_Trend_Log_Unsigned(
+    uint32_t object_instance, BACNET_PROPERTY_ID object_property)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_UNSIGNED_INTEGER value = 0;
+    int len = 0;
+
+    rpdata.application_data = apdu;
+    rpdata.application_data_len = sizeof(apdu);
+    rpdata.object_type = OBJECT_TRENDLOG;
+    rpdata.object_instance = object_instance;
+    rpdata.object_property = object_property;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len = Trend_Log_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    len = bacnet_unsigned_application_decode(apdu, len, &value);
+    zassert_true(len > 0, NULL);
+
+    return value;
+}
+
+/**
+ * @brief Test the storage of the records of a trend log
+ */
+static void test_Trend_Log_Buffer(void)
+{
+    static TL_DATA_REC records[4];
+    TL_LOG_RING ring = { 0 };
+    uint32_t object_instance = 0;
+    bool status = false;
+    int i;
+
+    Trend_Log_Init();
+    object_instance = Trend_Log_Index_To_Instance(0);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), TL_MAX_ENTRIES, NULL);
+    status = Trend_Log_Buffer_Set(object_instance, records, 4, &ring);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), 4, NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_BUFFER_SIZE), 4, NULL);
+    /* a new buffer starts out empty */
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_RECORD_COUNT), 0, NULL);
+    for (i = 0; i < 6; i++) {
+        TL_Insert_Status_Rec(0, LOG_STATUS_BUFFER_PURGED, true);
+    }
+    zassert_equal(ring.ulIndex, 2, NULL);
+    zassert_equal(ring.ulRecordCount, 4, NULL);
+    zassert_equal(ring.ulTotalRecordCount, 6, NULL);
+    /* back to the RAM buffer */
+    status = Trend_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), TL_MAX_ENTRIES, NULL);
+    /* recover the log from the stored state, after a restart record */
+    status = Trend_Log_Buffer_Set(object_instance, records, 4, &ring);
+    zassert_true(status, NULL);
+    zassert_equal(ring.ulIndex, 3, NULL);
+    zassert_equal(ring.ulRecordCount, 4, NULL);
+    zassert_equal(ring.ulTotalRecordCount, 7, NULL);
+    zassert_equal(records[2].ucRecType, TL_TYPE_STATUS, NULL);
+    zassert_equal(
+        records[2].Datum.ucLogStatus, 1 << LOG_STATUS_LOG_INTERRUPTED, NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_RECORD_COUNT), 4, NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_TOTAL_RECORD_COUNT), 7,
+        NULL);
+    /* a stored state that does not fit the buffer is discarded */
+    ring.ulIndex = 4;
+    status = Trend_Log_Buffer_Set(object_instance, records, 4, &ring);
+    zassert_true(status, NULL);
+    zassert_equal(ring.ulIndex, 0, NULL);
+    zassert_equal(ring.ulRecordCount, 0, NULL);
+    zassert_equal(ring.ulTotalRecordCount, 0, NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_RECORD_COUNT), 0, NULL);
+    /* invalid buffers and instances */
+    status = Trend_Log_Buffer_Set(object_instance, records, 0, NULL);
+    zassert_false(status, NULL);
+    status = Trend_Log_Buffer_Set(BACNET_MAX_INSTANCE, records, 4, NULL);
+    zassert_false(status, NULL);
+    zassert_equal(Trend_Log_Buffer_Size(BACNET_MAX_INSTANCE), 0, NULL);
+    status = Trend_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    zassert_true(status, NULL);
+}
+
+/**
+ * @brief Read a range of records by time from a trend log
+ */
+static int test_Trend_Log_By_Time(
+    BACNET_READ_RANGE_DATA *pRequest, bacnet_time_t tRefTime, int32_t count)
+{
+    static uint8_t apdu[MAX_APDU];
+
+    memset(pRequest, 0, sizeof(*pRequest));
+    pRequest->object_type = OBJECT_TRENDLOG;
+    pRequest->object_instance = Trend_Log_Index_To_Instance(0);
+    pRequest->object_property = PROP_LOG_BUFFER;
+    pRequest->array_index = BACNET_ARRAY_ALL;
+    pRequest->RequestType = RR_BY_TIME;
+    pRequest->Count = count;
+    bitstring_init(&pRequest->ResultFlags);
+    TL_Local_Time_To_BAC(&pRequest->Range.RefTime, tRefTime);
+
+    return TL_encode_by_time(apdu, pRequest);
+}
+
+/**
+ * @brief Test ReadRange by time on a wrapped trend log buffer
+ */
+static void test_Trend_Log_Read_Range_Time(void)
+{
+    static TL_DATA_REC records[8];
+    TL_LOG_RING ring = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    uint32_t object_instance = 0;
+    bacnet_time_t tBase = 0;
+    bool status = false;
+    int len = 0;
+    int k;
+
+    Trend_Log_Init();
+    object_instance = Trend_Log_Index_To_Instance(0);
+    Device_getCurrentDateTime(&bdatetime);
+    tBase = TL_BAC_Time_To_Local(&bdatetime) - 86400;
+    /* a full log that has wrapped, with the oldest record at index 3 */
+    for (k = 0; k < 8; k++) {
+        records[(3 + k) % 8].tTimeStamp = tBase + (900 * k);
+        records[(3 + k) % 8].ucRecType = TL_TYPE_UNSIGN;
+        records[(3 + k) % 8].Datum.ulUValue = k;
+    }
+    ring.ulIndex = 3;
+    ring.ulRecordCount = 8;
+    ring.ulTotalRecordCount = 20;
+    /* the restart record replaces the oldest record: entry 1 is k=1 */
+    status = Trend_Log_Buffer_Set(object_instance, records, 8, &ring);
+    zassert_true(status, NULL);
+    zassert_equal(ring.ulTotalRecordCount, 21, NULL);
+    /* records after the reference time */
+    len = test_Trend_Log_By_Time(&request, tBase + (900 * 2), 3);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 16, NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    /* records before the reference time */
+    len = test_Trend_Log_By_Time(&request, tBase + (900 * 5), -2);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 2, NULL);
+    zassert_equal(request.FirstSequence, 16, NULL);
+    /* a count past the start of the log is pinned to the first record */
+    len = test_Trend_Log_By_Time(&request, tBase + (900 * 2), -10);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 1, NULL);
+    zassert_equal(request.FirstSequence, 14, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    /* the newest records up to the end of the log */
+    len = test_Trend_Log_By_Time(&request, tBase + (900 * 6), 10);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 2, NULL);
+    zassert_equal(request.FirstSequence, 20, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    /* nothing before the oldest or after the newest record */
+    len = test_Trend_Log_By_Time(&request, tBase, -5);
+    zassert_equal(len, 0, NULL);
+    len = test_Trend_Log_By_Time(&request, tBase + 86400, 5);
+    zassert_equal(len, 0, NULL);
+    /* the clock was set back: the record at entry 5 is older */
+    records[(3 + 5) % 8].tTimeStamp = tBase;
+    ring.ulIndex = 3;
+    ring.ulRecordCount = 8;
+    ring.ulTotalRecordCount = 20;
+    status = Trend_Log_Buffer_Set(object_instance, records, 8, &ring);
+    zassert_true(status, NULL);
+    len = test_Trend_Log_By_Time(&request, tBase + 950, -1);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 1, NULL);
+    zassert_equal(request.FirstSequence, 18, NULL);
+    len = test_Trend_Log_By_Time(&request, tBase + 100, 1);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.FirstSequence, 14, NULL);
+    status = Trend_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    zassert_true(status, NULL);
+}
+
+/**
+ * @brief Make a record for the compressed storage tests
+ */
+static void test_Trend_Log_Block_Record(TL_DATA_REC *pRec, unsigned i)
+{
+    memset(pRec, 0, sizeof(*pRec));
+    /* a fixed interval, with a late sample now and then */
+    pRec->tTimeStamp = 1000000 + (60 * i) + ((i % 13) == 0 ? 2 : 0);
+    pRec->ucRecType = TL_TYPE_REAL;
+    pRec->ucStatus = 0;
+    if ((i % 100) == 0) {
+        pRec->ucRecType = TL_TYPE_STATUS;
+        pRec->Datum.ucLogStatus = 1 << LOG_STATUS_LOG_INTERRUPTED;
+    } else if ((i % 250) == 1) {
+        pRec->ucStatus = 128 | 1;
+        pRec->Datum.fReal = 20.5f;
+    } else if ((i % 97) == 0) {
+        /* the clock was set back, or forward a long way */
+        pRec->tTimeStamp = ((i % 2) == 0) ? 5 : 0x7FFFFFF0UL;
+        pRec->Datum.fReal = -1.0e10f;
+    } else if ((i % 41) == 0) {
+        pRec->ucRecType = TL_TYPE_UNSIGN;
+        pRec->Datum.ulUValue = i * 1000;
+    } else if ((i % 43) == 0) {
+        pRec->ucRecType = TL_TYPE_SIGN;
+        pRec->Datum.lSValue = -(int32_t)i;
+    } else if ((i % 47) == 0) {
+        pRec->ucRecType = TL_TYPE_ENUM;
+        pRec->Datum.ulEnum = i % 3;
+    } else if ((i % 53) == 0) {
+        pRec->ucRecType = TL_TYPE_BOOL;
+        pRec->Datum.ucBoolean = 1;
+    } else if ((i % 59) == 0) {
+        pRec->ucRecType = TL_TYPE_ERROR;
+        pRec->Datum.Error.usClass = ERROR_CLASS_PROPERTY;
+        pRec->Datum.Error.usCode = (uint16_t)i;
+    } else if ((i % 61) == 0) {
+        pRec->ucRecType = TL_TYPE_BITS;
+        pRec->Datum.Bits.ucLen = 0x24;
+        pRec->Datum.Bits.ucStore[0] = (uint8_t)i;
+        pRec->Datum.Bits.ucStore[3] = 0xA5;
+    } else if ((i % 67) == 0) {
+        pRec->ucRecType = TL_TYPE_NULL;
+    } else if ((i % 71) == 0) {
+        pRec->ucRecType = TL_TYPE_DELTA;
+        pRec->Datum.fTime = 60.5f;
+    } else {
+        /* a slowly changing value */
+        pRec->Datum.fReal = 20.0f + (float)((i / 10) % 8) * 0.5f;
+    }
+}
+
+/**
+ * @brief Test the compressed storage of trend log records
+ */
+static void test_Trend_Log_Block(void)
+{
+    static uint8_t buffer[TL_BLOCK_SIZE * 3];
+    static TL_BLOCK_LOG blocks;
+    TL_DATA_REC record = { 0 };
+    TL_DATA_REC *pRec = NULL;
+    uint32_t count = 0;
+    uint32_t entry = 0;
+    unsigned total = 5000;
+    unsigned full_count = 0;
+    unsigned i;
+    bool full = false;
+    bool status = false;
+
+    status = TL_Block_Init(&blocks, buffer, TL_BLOCK_SIZE);
+    zassert_false(status, NULL);
+    status = TL_Block_Init(&blocks, buffer, sizeof(buffer));
+    zassert_true(status, NULL);
+    zassert_equal(TL_Block_Count(&blocks), 0, NULL);
+    zassert_true(TL_Block_Size(&blocks) > 0, NULL);
+    zassert_false(TL_Block_Full(&blocks), NULL);
+    zassert_is_null(TL_Block_Entry(&blocks, 1), NULL);
+    for (i = 0; i < total; i++) {
+        test_Trend_Log_Block_Record(&record, i);
+        count = TL_Block_Count(&blocks);
+        full = TL_Block_Full(&blocks);
+        if (full) {
+            full_count++;
+        }
+        status = TL_Block_Insert(&blocks, &record);
+        zassert_true(status, NULL);
+        /* records are only dropped from a full ring */
+        if (!full) {
+            zassert_equal(TL_Block_Count(&blocks), count + 1, NULL);
+        }
+    }
+    zassert_true(full_count > 0, NULL);
+    count = TL_Block_Count(&blocks);
+    zassert_true(count > 0, NULL);
+    zassert_true(count < total, NULL);
+    zassert_true(count <= TL_Block_Size(&blocks), NULL);
+    /* much more history than the same memory holds uncompressed */
+    zassert_true(count > (4 * sizeof(buffer) / sizeof(TL_DATA_REC)), NULL);
+    /* the newest records are kept, in order and unchanged */
+    for (entry = 1; entry <= count; entry++) {
+        test_Trend_Log_Block_Record(&record, total - count + entry - 1);
+        pRec = TL_Block_Entry(&blocks, entry);
+        zassert_not_null(pRec, NULL);
+        zassert_equal(pRec->tTimeStamp, record.tTimeStamp, NULL);
+        zassert_equal(pRec->ucRecType, record.ucRecType, NULL);
+        zassert_equal(pRec->ucStatus, record.ucStatus, NULL);
+        zassert_mem_equal(
+            &pRec->Datum, &record.Datum, sizeof(record.Datum), NULL);
+    }
+    /* and in any order */
+    for (entry = count; entry > 0; entry -= 7) {
+        test_Trend_Log_Block_Record(&record, total - count + entry - 1);
+        pRec = TL_Block_Entry(&blocks, entry);
+        zassert_not_null(pRec, NULL);
+        zassert_equal(pRec->tTimeStamp, record.tTimeStamp, NULL);
+        zassert_mem_equal(
+            &pRec->Datum, &record.Datum, sizeof(record.Datum), NULL);
+        if (entry <= 7) {
+            break;
+        }
+    }
+    zassert_is_null(TL_Block_Entry(&blocks, count + 1), NULL);
+    TL_Block_Clear(&blocks);
+    zassert_equal(TL_Block_Count(&blocks), 0, NULL);
+    zassert_false(TL_Block_Full(&blocks), NULL);
+}
+
+/**
+ * @brief Make a row of records for the compressed storage tests
+ */
+static void
+test_Trend_Log_Block_Row(TL_DATA_REC *pRow, unsigned columns, unsigned i)
+{
+    unsigned column;
+
+    test_Trend_Log_Block_Record(&pRow[0], i);
+    for (column = 1; column < columns; column++) {
+        test_Trend_Log_Block_Record(&pRow[column], i + (column * 7));
+        if ((pRow[column].ucRecType == TL_TYPE_STATUS) ||
+            (pRow[column].ucRecType == TL_TYPE_DELTA)) {
+            pRow[column].ucRecType = TL_TYPE_NULL;
+            memset(&pRow[column].Datum, 0, sizeof(pRow[column].Datum));
+        }
+        pRow[column].tTimeStamp = pRow[0].tTimeStamp;
+    }
+}
+
+/**
+ * @brief Test the compressed storage of rows of trend log records
+ */
+static void test_Trend_Log_Block_Rows(void)
+{
+    static uint8_t buffer[TL_BLOCK_SIZE * 8];
+    static TL_BLOCK_LOG blocks;
+    static TL_BLOCK_STATE states[3 * 4];
+    static TL_DATA_REC records[4];
+    TL_DATA_REC row[4] = { 0 };
+    TL_DATA_REC *pRow = NULL;
+    unsigned columns = 4;
+    unsigned total = 3000;
+    unsigned column;
+    unsigned i;
+    uint32_t count = 0;
+    uint32_t entry = 0;
+    bool full = false;
+    bool status = false;
+
+    status = TL_Block_Rows_Init(&blocks, buffer, sizeof(buffer), columns,
+        NULL, NULL);
+    zassert_false(status, NULL);
+    status = TL_Block_Rows_Init(&blocks, buffer, sizeof(buffer), columns,
+        states, records);
+    zassert_true(status, NULL);
+    zassert_true(TL_Block_Size(&blocks) > 0, NULL);
+    /* a single record is not a row of this log */
+    status = TL_Block_Insert(&blocks, &row[0]);
+    zassert_false(status, NULL);
+    for (i = 0; i < total; i++) {
+        test_Trend_Log_Block_Row(row, columns, i);
+        count = TL_Block_Count(&blocks);
+        full = TL_Block_Full(&blocks);
+        status = TL_Block_Row_Insert(&blocks, row);
+        zassert_true(status, NULL);
+        if (!full) {
+            zassert_equal(TL_Block_Count(&blocks), count + 1, NULL);
+        }
+    }
+    count = TL_Block_Count(&blocks);
+    zassert_true(count > 0, NULL);
+    zassert_true(count < total, NULL);
+    zassert_true(count <= TL_Block_Size(&blocks), NULL);
+    /* the newest rows are kept, in order and unchanged */
+    for (entry = 1; entry <= count; entry++) {
+        test_Trend_Log_Block_Row(row, columns, total - count + entry - 1);
+        pRow = TL_Block_Row_Entry(&blocks, entry);
+        zassert_not_null(pRow, NULL);
+        zassert_equal(pRow[0].tTimeStamp, row[0].tTimeStamp, NULL);
+        zassert_equal(pRow[0].ucRecType, row[0].ucRecType, NULL);
+        zassert_mem_equal(
+            &pRow[0].Datum, &row[0].Datum, sizeof(row[0].Datum), NULL);
+        if ((row[0].ucRecType == TL_TYPE_STATUS) ||
+            (row[0].ucRecType == TL_TYPE_DELTA)) {
+            continue;
+        }
+        for (column = 1; column < columns; column++) {
+            zassert_equal(
+                pRow[column].tTimeStamp, row[0].tTimeStamp, NULL);
+            zassert_equal(
+                pRow[column].ucRecType, row[column].ucRecType, NULL);
+            zassert_equal(
+                pRow[column].ucStatus, row[column].ucStatus, NULL);
+            zassert_mem_equal(&pRow[column].Datum, &row[column].Datum,
+                sizeof(row[column].Datum), NULL);
+        }
+    }
+    zassert_is_null(TL_Block_Row_Entry(&blocks, count + 1), NULL);
+}
+
+/**
+ * @brief Test a trend log with compressed storage
+ */
+static void test_Trend_Log_Block_Buffer(void)
+{
+    static uint8_t buffer[TL_BLOCK_SIZE * 2];
+    static TL_BLOCK_LOG blocks;
+    BACNET_READ_RANGE_DATA request = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint32_t object_instance = 0;
+    bool status = false;
+    int len = 0;
+    int i;
+
+    Trend_Log_Init();
+    object_instance = Trend_Log_Index_To_Instance(0);
+    status = TL_Block_Init(&blocks, buffer, sizeof(buffer));
+    zassert_true(status, NULL);
+    status = Trend_Log_Block_Buffer_Set(object_instance, &blocks);
+    zassert_true(status, NULL);
+    zassert_equal(
+        Trend_Log_Buffer_Size(object_instance), TL_Block_Size(&blocks), NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_RECORD_COUNT), 0, NULL);
+    for (i = 0; i < 5; i++) {
+        TL_Insert_Status_Rec(0, LOG_STATUS_BUFFER_PURGED, true);
+    }
+    zassert_equal(TL_Block_Count(&blocks), 5, NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_RECORD_COUNT), 5, NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_TOTAL_RECORD_COUNT), 5,
+        NULL);
+    request.object_type = OBJECT_TRENDLOG;
+    request.object_instance = object_instance;
+    request.object_property = PROP_LOG_BUFFER;
+    request.array_index = BACNET_ARRAY_ALL;
+    request.RequestType = RR_READ_ALL;
+    bitstring_init(&request.ResultFlags);
+    len = TL_encode_by_position(apdu, &request);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    /* back to the RAM buffer */
+    status = Trend_Log_Block_Buffer_Set(object_instance, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Buffer_Size(object_instance), TL_MAX_ENTRIES, NULL);
+}
+
+/**
+ * @brief Write a property of a trend log
+ */
+static bool test_Trend_Log_Write(uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint8_t *apdu,
+    int apdu_len)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+
+    wp_data.object_type = OBJECT_TRENDLOG;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = object_property;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    memcpy(wp_data.application_data, apdu, apdu_len);
+    wp_data.application_data_len = apdu_len;
+
+    return Trend_Log_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Test a trend log that logs the changes of value of its source
+ */
+static void test_Trend_Log_COV(void)
+{
+    static TL_DATA_REC records[8];
+    TL_LOG_RING ring = { 0 };
+    BACNET_DATE_TIME bdatetime = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2];
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint32_t object_instance = 0;
+    uint32_t count = 0;
+    bool status = false;
+    int len = 0;
+
+    Trend_Log_Init();
+    object_instance = Trend_Log_Index_To_Instance(0);
+    status = Trend_Log_Buffer_Set(object_instance, records, 8, &ring);
+    zassert_true(status, NULL);
+    /* log from now on */
+    datetime_wildcard_set(&bdatetime);
+    len = encode_application_date(&apdu[0], &bdatetime.date);
+    len += encode_application_time(&apdu[len], &bdatetime.time);
+    status = test_Trend_Log_Write(object_instance, PROP_STOP_TIME, apdu, len);
+    zassert_true(status, NULL);
+    zassert_true(TL_Is_Enabled(0), NULL);
+    len = encode_application_enumerated(&apdu[0], LOGGING_TYPE_COV);
+    status =
+        test_Trend_Log_Write(object_instance, PROP_LOGGING_TYPE, apdu, len);
+    zassert_true(status, NULL);
+    zassert_equal(
+        test_Trend_Log_Unsigned(object_instance, PROP_LOG_INTERVAL), 0, NULL);
+    len = encode_application_unsigned(&apdu[0], 6000);
+    status =
+        test_Trend_Log_Write(object_instance, PROP_LOG_INTERVAL, apdu, len);
+    zassert_false(status, NULL);
+    /* the timer subscribes the log to its source */
+    trend_log_timer(1);
+    zassert_true(Test_COV_Subscribed, NULL);
+    zassert_not_null(Test_COV_Callback, NULL);
+    /* each notification is a record */
+    count = ring.ulRecordCount;
+    Test_Present_Value = 21.5f;
+    bacapp_property_value_list_init(&value_list[0], 2);
+    Device_Encode_Value_List(OBJECT_ANALOG_INPUT, 0, &value_list[0]);
+    Test_COV_Callback(
+        Test_COV_Subscriber, OBJECT_ANALOG_INPUT, 0, &value_list[0]);
+    zassert_equal(ring.ulRecordCount, count + 1, NULL);
+    zassert_equal(records[ring.ulIndex - 1].ucRecType, TL_TYPE_REAL, NULL);
+    zassert_false(
+        islessgreater(
+            records[ring.ulIndex - 1].Datum.fReal, Test_Present_Value),
+        NULL);
+    zassert_equal(records[ring.ulIndex - 1].ucStatus, 128 | 1, NULL);
+    /* notifications of other objects are not logged */
+    Test_COV_Callback(
+        Test_COV_Subscriber, OBJECT_ANALOG_INPUT, 1, &value_list[0]);
+    zassert_equal(ring.ulRecordCount, count + 1, NULL);
+    /* leaving COV logging cancels the subscription */
+    len = encode_application_enumerated(&apdu[0], LOGGING_TYPE_TRIGGERED);
+    status =
+        test_Trend_Log_Write(object_instance, PROP_LOGGING_TYPE, apdu, len);
+    zassert_true(status, NULL);
+    zassert_false(Test_COV_Subscribed, NULL);
+    Test_COV_Callback(
+        Test_COV_Subscriber, OBJECT_ANALOG_INPUT, 0, &value_list[0]);
+    zassert_equal(ring.ulRecordCount, count + 1, NULL);
+    /* a triggered reading takes the value directly from the object */
+    Test_Present_Value = 22.25f;
+    len = encode_application_boolean(&apdu[0], true);
+    status = test_Trend_Log_Write(object_instance, PROP_TRIGGER, apdu, len);
+    zassert_true(status, NULL);
+    trend_log_timer(1);
+    zassert_equal(ring.ulRecordCount, count + 2, NULL);
+    zassert_equal(records[ring.ulIndex - 1].ucRecType, TL_TYPE_REAL, NULL);
+    zassert_false(
+        islessgreater(
+            records[ring.ulIndex - 1].Datum.fReal, Test_Present_Value),
+        NULL);
+    zassert_equal(records[ring.ulIndex - 1].ucStatus, 128 | 1, NULL);
+    len = encode_application_enumerated(&apdu[0], LOGGING_TYPE_POLLED);
+    status =
+        test_Trend_Log_Write(object_instance, PROP_LOGGING_TYPE, apdu, len);
+    zassert_true(status, NULL);
+    status = Trend_Log_Buffer_Set(object_instance, NULL, 0, NULL);
+    zassert_true(status, NULL);
+}
 /**
  * @}
  */
 
 void test_main(void)
 {
-    ztest_test_suite(
-        trendlog_tests, ztest_unit_test(test_Trend_Log_ReadProperty));
+    ztest_test_suite(trendlog_tests,
+        ztest_unit_test(test_Trend_Log_ReadProperty),
+        ztest_unit_test(test_Trend_Log_Buffer),
+        ztest_unit_test(test_Trend_Log_Read_Range_Time),
+        ztest_unit_test(test_Trend_Log_Block),
+        ztest_unit_test(test_Trend_Log_Block_Rows),
+        ztest_unit_test(test_Trend_Log_Block_Buffer),
+        ztest_unit_test(test_Trend_Log_COV));
 
     ztest_run_test_suite(trendlog_tests);
 }
@@ -0,0 +1,319 @@
+/**
+ * @file
+ * @brief Unit test for the Trend Log Multiple object
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/trendlog_multiple.h>
+#include <bacnet/basic/service/h_cov.h>
+#include <property_test.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the present values of the logged analog inputs */
+static float Test_Present_Value[2];
+/* number of value lists given to the objects under test */
+static unsigned Test_Value_List_Count;
+
+bool handler_cov_local_subscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    (void)subscriber_id;
+    (void)object_type;
+    (void)object_instance;
+    (void)callback;
+    return false;
+}
+
+void handler_cov_local_unsubscribe(uint32_t subscriber_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    handler_cov_local_callback callback)
+{
+    (void)subscriber_id;
+    (void)object_type;
+    (void)object_instance;
+    (void)callback;
+}
+
+bool Device_Value_List_Supported(BACNET_OBJECT_TYPE object_type)
+{
+    return (object_type == OBJECT_ANALOG_INPUT);
+}
+
+bool Device_Encode_Value_List(BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_VALUE *value_list)
+{
+    if ((object_type != OBJECT_ANALOG_INPUT) || (object_instance > 1)) {
+        return false;
+    }
+    Test_Value_List_Count++;
+    value_list->propertyIdentifier = PROP_PRESENT_VALUE;
+    value_list->value.tag = BACNET_APPLICATION_TAG_REAL;
+    value_list->value.type.Real = Test_Present_Value[object_instance];
+    value_list = value_list->next;
+    value_list->propertyIdentifier = PROP_STATUS_FLAGS;
+    value_list->value.tag = BACNET_APPLICATION_TAG_BIT_STRING;
+    bitstring_init(&value_list->value.type.Bit_String);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_IN_ALARM, true);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(
+        &value_list->value.type.Bit_String, STATUS_FLAG_OUT_OF_SERVICE,
+        false);
+
+    return true;
+}
+
+/**
+ * @brief Make a member that refers to a property of an analog input
+ */
+static void test_Trend_Log_Multiple_Member(
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember,
+    uint32_t instance,
+    BACNET_PROPERTY_ID property)
+{
+    memset(pMember, 0, sizeof(*pMember));
+    pMember->objectIdentifier.type = OBJECT_ANALOG_INPUT;
+    pMember->objectIdentifier.instance = instance;
+    pMember->propertyIdentifier = property;
+    pMember->arrayIndex = BACNET_ARRAY_ALL;
+    pMember->deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    pMember->deviceIdentifier.instance = BACNET_NO_DEV_ID;
+}
+
+/**
+ * @brief Write a property of a trend log multiple
+ */
+static bool test_Trend_Log_Multiple_Write(BACNET_PROPERTY_ID object_property,
+    uint8_t *apdu,
+    int apdu_len,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    bool status;
+
+    wp_data.object_type = OBJECT_TREND_LOG_MULTIPLE;
+    wp_data.object_instance = Trend_Log_Multiple_Index_To_Instance(0);
+    wp_data.object_property = object_property;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    memcpy(wp_data.application_data, apdu, apdu_len);
+    wp_data.application_data_len = apdu_len;
+    status = Trend_Log_Multiple_Write_Property(&wp_data);
+    if (error_code) {
+        *error_code = wp_data.error_code;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Read a range of rows from a trend log multiple
+ */
+static int test_Trend_Log_Multiple_Read_Range(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    uint32_t ref,
+    int32_t count)
+{
+    memset(pRequest, 0, sizeof(*pRequest));
+    pRequest->object_type = OBJECT_TREND_LOG_MULTIPLE;
+    pRequest->object_instance = Trend_Log_Multiple_Index_To_Instance(0);
+    pRequest->object_property = PROP_LOG_BUFFER;
+    pRequest->array_index = BACNET_ARRAY_ALL;
+    pRequest->RequestType = RR_BY_POSITION;
+    pRequest->Count = count;
+    pRequest->Range.RefIndex = ref;
+    bitstring_init(&pRequest->ResultFlags);
+
+    return Trend_Log_Multiple_Read_Range_Encode(apdu, pRequest);
+}
+
+/**
+ * @brief Test the properties of the object
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(trendlog_multiple_tests, test_Trend_Log_Multiple_ReadProperty)
+#else
+static void test_Trend_Log_Multiple_ReadProperty(void)
+#endif
+{
+    unsigned count = 0;
+    uint32_t object_instance = 0;
+    bool status = false;
+    const int known_fail_property_list[] = { -1 };
+
+    Trend_Log_Multiple_Init();
+    count = Trend_Log_Multiple_Count();
+    zassert_true(count > 0, NULL);
+    object_instance = Trend_Log_Multiple_Index_To_Instance(0);
+    status = Trend_Log_Multiple_Valid_Instance(object_instance);
+    zassert_true(status, NULL);
+    zassert_false(
+        Trend_Log_Multiple_Valid_Instance(BACNET_MAX_INSTANCE), NULL);
+    bacnet_object_properties_read_write_test(OBJECT_TREND_LOG_MULTIPLE,
+        object_instance, Trend_Log_Multiple_Property_Lists,
+        Trend_Log_Multiple_Read_Property, Trend_Log_Multiple_Write_Property,
+        known_fail_property_list);
+}
+
+/**
+ * @brief Test the sampling of the members into rows, and the ReadRange
+ *  encoding of the rows
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(trendlog_multiple_tests, test_Trend_Log_Multiple_Rows)
+#else
+static void test_Trend_Log_Multiple_Rows(void)
+#endif
+{
+    static uint8_t apdu[MAX_APDU];
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE members[3];
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_BIT_STRING bits = { 0 };
+    BACNET_DATE_TIME timestamp = { 0 };
+    BACNET_ERROR_CODE error_code = ERROR_CODE_SUCCESS;
+    uint32_t object_instance = 0;
+    float value = 0.0f;
+    bool status = false;
+    int apdu_len = 0;
+    int len = 0;
+    unsigned i;
+
+    Trend_Log_Multiple_Init();
+    object_instance = Trend_Log_Multiple_Index_To_Instance(0);
+    /* two members of one object share its value list */
+    test_Trend_Log_Multiple_Member(&members[0], 0, PROP_PRESENT_VALUE);
+    test_Trend_Log_Multiple_Member(&members[1], 0, PROP_STATUS_FLAGS);
+    test_Trend_Log_Multiple_Member(&members[2], 1, PROP_PRESENT_VALUE);
+    for (i = 0; i < 3; i++) {
+        apdu_len +=
+            bacapp_encode_device_obj_property_ref(&apdu[apdu_len], &members[i]);
+    }
+    status = test_Trend_Log_Multiple_Write(
+        PROP_LOG_DEVICE_OBJECT_PROPERTY, apdu, apdu_len, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Multiple_Member_Count(object_instance), 3, NULL);
+    /* the change of members purged the log */
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 1, NULL);
+    zassert_true(Trend_Log_Multiple_Buffer_Size(object_instance) > 0, NULL);
+    /* the first row is due at once */
+    Test_Present_Value[0] = 21.5f;
+    Test_Present_Value[1] = -3.0f;
+    Test_Value_List_Count = 0;
+    trend_log_multiple_timer(1);
+    zassert_equal(Test_Value_List_Count, 2, NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 2, NULL);
+    /* the next row is due after the interval, or when triggered */
+    trend_log_multiple_timer(1);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 2, NULL);
+    Test_Present_Value[1] = 4.25f;
+    status = Trend_Log_Multiple_Trigger(object_instance);
+    zassert_true(status, NULL);
+    trend_log_multiple_timer(1);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 3, NULL);
+    zassert_equal(
+        Trend_Log_Multiple_Total_Record_Count(object_instance), 3, NULL);
+    /* all the rows, the purge status row first */
+    len = test_Trend_Log_Multiple_Read_Range(apdu, &request, 1, 3);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 3, NULL);
+    /* the newest row holds all of the members */
+    len = test_Trend_Log_Multiple_Read_Range(apdu, &request, 3, 1);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 1, NULL);
+    apdu_len = len;
+    len = bacnet_datetime_context_decode(apdu, apdu_len, 0, &timestamp);
+    zassert_true(len > 0, NULL);
+    zassert_true(
+        bacnet_is_opening_tag_number(&apdu[len], apdu_len - len, 1, NULL),
+        NULL);
+    len++;
+    zassert_true(
+        bacnet_is_opening_tag_number(&apdu[len], apdu_len - len, 1, NULL),
+        NULL);
+    len++;
+    len += bacnet_real_context_decode(&apdu[len], apdu_len - len, 1, &value);
+    zassert_false(islessgreater(value, 21.5f), NULL);
+    len +=
+        bacnet_bitstring_context_decode(&apdu[len], apdu_len - len, 5, &bits);
+    zassert_true(bitstring_bit(&bits, STATUS_FLAG_IN_ALARM), NULL);
+    zassert_false(bitstring_bit(&bits, STATUS_FLAG_FAULT), NULL);
+    len += bacnet_real_context_decode(&apdu[len], apdu_len - len, 1, &value);
+    zassert_false(islessgreater(value, 4.25f), NULL);
+    zassert_true(
+        bacnet_is_closing_tag_number(&apdu[len], apdu_len - len, 1, NULL),
+        NULL);
+    len++;
+    zassert_true(
+        bacnet_is_closing_tag_number(&apdu[len], apdu_len - len, 1, NULL),
+        NULL);
+    len++;
+    zassert_equal(len, apdu_len, NULL);
+    /* COV logging of many members is not supported */
+    apdu_len = encode_application_enumerated(apdu, LOGGING_TYPE_COV);
+    status = test_Trend_Log_Multiple_Write(
+        PROP_LOGGING_TYPE, apdu, apdu_len, &error_code);
+    zassert_false(status, NULL);
+    zassert_equal(
+        error_code, ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED, NULL);
+    /* members in other devices are not supported */
+    members[2].deviceIdentifier.type = OBJECT_DEVICE;
+    members[2].deviceIdentifier.instance = 1234;
+    status =
+        Trend_Log_Multiple_Members_Set(object_instance, &members[0], 3);
+    zassert_false(status, NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 3, NULL);
+    /* the same members keep the rows */
+    members[2].deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    members[2].deviceIdentifier.instance = BACNET_NO_DEV_ID;
+    status =
+        Trend_Log_Multiple_Members_Set(object_instance, &members[0], 3);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 3, NULL);
+    /* writing a Record_Count of zero purges the log */
+    apdu_len = encode_application_unsigned(apdu, 0);
+    status = test_Trend_Log_Multiple_Write(
+        PROP_RECORD_COUNT, apdu, apdu_len, NULL);
+    zassert_true(status, NULL);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 1, NULL);
+    zassert_equal(
+        Trend_Log_Multiple_Total_Record_Count(object_instance), 4, NULL);
+    /* a disabled log does not sample */
+    status = Trend_Log_Multiple_Enable_Set(object_instance, false);
+    zassert_true(status, NULL);
+    status = Trend_Log_Multiple_Trigger(object_instance);
+    zassert_true(status, NULL);
+    trend_log_multiple_timer(1);
+    zassert_equal(Trend_Log_Multiple_Record_Count(object_instance), 2, NULL);
+    zassert_false(Trend_Log_Multiple_Enable(object_instance), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(trendlog_multiple_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(trendlog_multiple_tests,
+        ztest_unit_test(test_Trend_Log_Multiple_ReadProperty),
+        ztest_unit_test(test_Trend_Log_Multiple_Rows));
+
+    ztest_run_test_suite(trendlog_multiple_tests);
+}
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief test of the device set of the objects with an active alarm
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/service/alarm_active.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief index function of the test objects
+ */
+static unsigned test_instance_to_index(uint32_t object_instance)
+{
+    return object_instance + 100;
+}
+
+/**
+ * @brief Test the set with a cursor across the object types
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(alarm_active_tests, testAlarmActive)
+#else
+static void testAlarmActive(void)
+#endif
+{
+    unsigned cursor = 0, index = 0;
+
+    zassert_equal(Alarm_Active_Count(), 0, NULL);
+    zassert_false(Alarm_Active_Set(OBJECT_ANALOG_INPUT, 5, false), NULL);
+    zassert_false(Alarm_Active_Tracked(OBJECT_ANALOG_INPUT), NULL);
+    zassert_false(
+        Alarm_Active_Next(OBJECT_ANALOG_INPUT, &cursor, &index), NULL);
+    Alarm_Active_Index_Set(OBJECT_ANALOG_INPUT, test_instance_to_index);
+    Alarm_Active_Index_Set(OBJECT_BINARY_VALUE, test_instance_to_index);
+    zassert_true(Alarm_Active_Tracked(OBJECT_ANALOG_INPUT), NULL);
+    zassert_false(Alarm_Active_Tracked(OBJECT_ANALOG_VALUE), NULL);
+    /* added in any order */
+    zassert_true(Alarm_Active_Set(OBJECT_BINARY_VALUE, 3, true), NULL);
+    zassert_true(Alarm_Active_Set(OBJECT_ANALOG_INPUT, 5, true), NULL);
+    zassert_true(Alarm_Active_Set(OBJECT_ANALOG_VALUE, 7, true), NULL);
+    zassert_true(Alarm_Active_Set(OBJECT_ANALOG_INPUT, 2, true), NULL);
+    zassert_false(Alarm_Active_Set(OBJECT_ANALOG_INPUT, 5, true), NULL);
+    zassert_equal(Alarm_Active_Count(), 4, NULL);
+    zassert_true(Alarm_Active(OBJECT_ANALOG_INPUT, 5), NULL);
+    zassert_false(Alarm_Active(OBJECT_ANALOG_INPUT, 3), NULL);
+    /* visited in order of type and instance */
+    zassert_true(Alarm_Active_Next(OBJECT_ANALOG_INPUT, &cursor, &index), NULL);
+    zassert_equal(index, 102, NULL);
+    zassert_true(Alarm_Active_Next(OBJECT_ANALOG_INPUT, &cursor, &index), NULL);
+    zassert_equal(index, 105, NULL);
+    zassert_false(
+        Alarm_Active_Next(OBJECT_ANALOG_INPUT, &cursor, &index), NULL);
+    /* the types without an index function are not visited */
+    zassert_false(
+        Alarm_Active_Next(OBJECT_ANALOG_VALUE, &cursor, &index), NULL);
+    zassert_true(Alarm_Active_Next(OBJECT_BINARY_VALUE, &cursor, &index), NULL);
+    zassert_equal(index, 103, NULL);
+    zassert_false(
+        Alarm_Active_Next(OBJECT_BINARY_VALUE, &cursor, &index), NULL);
+    zassert_equal(cursor, 4, NULL);
+    /* removed */
+    zassert_true(Alarm_Active_Set(OBJECT_ANALOG_INPUT, 2, false), NULL);
+    zassert_false(Alarm_Active_Set(OBJECT_ANALOG_INPUT, 2, false), NULL);
+    zassert_false(Alarm_Active(OBJECT_ANALOG_INPUT, 2), NULL);
+    zassert_equal(Alarm_Active_Count(), 3, NULL);
+    cursor = 0;
+    zassert_true(Alarm_Active_Next(OBJECT_ANALOG_INPUT, &cursor, &index), NULL);
+    zassert_equal(index, 105, NULL);
+    Alarm_Active_Clear(OBJECT_ANALOG_INPUT);
+    zassert_equal(Alarm_Active_Count(), 2, NULL);
+    zassert_false(Alarm_Active(OBJECT_ANALOG_INPUT, 5), NULL);
+    zassert_true(Alarm_Active(OBJECT_BINARY_VALUE, 3), NULL);
+    Alarm_Active_Cleanup();
+    zassert_equal(Alarm_Active_Count(), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(alarm_active_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(alarm_active_tests, ztest_unit_test(testAlarmActive));
+
+    ztest_run_test_suite(alarm_active_tests);
+}
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief test of the snapshot of the counters of the stack, and its
+ *  text in the Prometheus format
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/service/metrics.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static char Test_Text[4096];
+
+/**
+ * @brief Test that a snapshot is read only after it was published, and
+ *  that it has the counters at the time it was published
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, testMetricsPublish)
+#else
+static void testMetricsPublish(void)
+#endif
+{
+    BACNET_METRICS_SNAPSHOT snapshot = { 0 };
+
+    zassert_false(bacnet_metrics_read(NULL), NULL);
+    zassert_false(bacnet_metrics_read(&snapshot), NULL);
+    bacnet_memstats_reset();
+    bacnet_memstats_allocated(MEMSTATS_COV, 100);
+    bacnet_metrics_publish(5);
+    /* later counts are not in the published snapshot */
+    bacnet_memstats_allocated(MEMSTATS_COV, 50);
+    zassert_true(bacnet_metrics_read(&snapshot), NULL);
+    zassert_equal(snapshot.uptime, 5, NULL);
+    zassert_equal(snapshot.memory[MEMSTATS_COV].current_bytes, 100, NULL);
+    zassert_equal(snapshot.memory[MEMSTATS_COV].allocations, 1, NULL);
+    bacnet_metrics_publish(6);
+    zassert_true(bacnet_metrics_read(&snapshot), NULL);
+    zassert_equal(snapshot.uptime, 6, NULL);
+    zassert_equal(snapshot.memory[MEMSTATS_COV].current_bytes, 150, NULL);
+    zassert_equal(snapshot.memory[MEMSTATS_COV].peak_bytes, 150, NULL);
+}
+
+/**
+ * @brief Test the text of a snapshot, and that a text which does not fit
+ *  the buffer is not truncated
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, testMetricsText)
+#else
+static void testMetricsText(void)
+#endif
+{
+    BACNET_METRICS_SNAPSHOT snapshot = { 0 };
+    int len = 0;
+
+    bacnet_memstats_reset();
+    bacnet_memstats_allocated(MEMSTATS_ADDRESS, 24);
+    bacnet_memstats_allocated(MEMSTATS_ADDRESS, 24);
+    bacnet_memstats_released(MEMSTATS_ADDRESS, 24);
+    bacnet_memstats_failed(MEMSTATS_ADDRESS);
+    bacnet_metrics_snapshot(&snapshot, 42);
+    len = bacnet_metrics_text(&snapshot, Test_Text, sizeof(Test_Text));
+    zassert_true(len > 0, NULL);
+    zassert_equal(strlen(Test_Text), (size_t)len, NULL);
+    zassert_not_null(strstr(Test_Text,
+                         "# TYPE bacnet_uptime_seconds counter\n"
+                         "bacnet_uptime_seconds 42\n"),
+        NULL);
+    zassert_not_null(
+        strstr(Test_Text, "# TYPE bacnet_memory_bytes gauge\n"), NULL);
+    zassert_not_null(
+        strstr(Test_Text, "bacnet_memory_bytes{subsystem=\"address\"} 24\n"),
+        NULL);
+    zassert_not_null(strstr(Test_Text,
+                         "bacnet_memory_peak_bytes{subsystem=\"address\"} "
+                         "48\n"),
+        NULL);
+    zassert_not_null(strstr(Test_Text,
+                         "bacnet_memory_allocations_total"
+                         "{subsystem=\"address\"} 2\n"),
+        NULL);
+    zassert_not_null(strstr(Test_Text,
+                         "bacnet_memory_frees_total{subsystem=\"address\"} "
+                         "1\n"),
+        NULL);
+    zassert_not_null(strstr(Test_Text,
+                         "bacnet_memory_failures_total"
+                         "{subsystem=\"address\"} 1\n"),
+        NULL);
+    zassert_not_null(strstr(Test_Text,
+                         "bacnet_memory_bytes{subsystem=\"trend-log\"} 0\n"),
+        NULL);
+    /* the whole text, or nothing */
+    zassert_equal(
+        bacnet_metrics_text(&snapshot, Test_Text, (size_t)len + 1), len, NULL);
+    zassert_equal(
+        bacnet_metrics_text(&snapshot, Test_Text, (size_t)len), -1, NULL);
+    zassert_equal(Test_Text[0], 0, NULL);
+    zassert_equal(bacnet_metrics_text(NULL, Test_Text, sizeof(Test_Text)),
+        -1, NULL);
+    zassert_equal(bacnet_metrics_text(&snapshot, Test_Text, 0), -1, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(metrics_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(metrics_tests, ztest_unit_test(testMetricsPublish),
+        ztest_unit_test(testMetricsText));
+
+    ztest_run_test_suite(metrics_tests);
+}
+#endif
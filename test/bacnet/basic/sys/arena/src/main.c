@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief test of the arena memory allocator API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/arena.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the arena allocations, alignment, overflow and reset
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(arena_tests, testArena)
+#else
+static void testArena(void)
+#endif
+{
+    ARENA_BUFFER arena;
+    union {
+        double align;
+        uint8_t data[128];
+    } buffer;
+    uint8_t *data1, *data2;
+    double *real;
+    size_t count;
+
+    /* no memory */
+    arena_init(&arena, NULL, sizeof(buffer.data));
+    zassert_equal(arena_size(&arena), 0, NULL);
+    zassert_is_null(arena_alloc(&arena, 1), NULL);
+    zassert_true(arena_overflow(&arena), NULL);
+    zassert_is_null(arena_alloc(NULL, 1), NULL);
+    zassert_equal(arena_count(NULL), 0, NULL);
+    zassert_false(arena_overflow(NULL), NULL);
+
+    memset(buffer.data, 0xAA, sizeof(buffer.data));
+    arena_init(&arena, buffer.data, sizeof(buffer.data));
+    zassert_equal(arena_size(&arena), sizeof(buffer.data), NULL);
+    zassert_equal(arena_count(&arena), 0, NULL);
+    zassert_false(arena_overflow(&arena), NULL);
+    zassert_is_null(arena_alloc(&arena, 0), NULL);
+    /* allocations are zeroed and one after another */
+    data1 = arena_alloc(&arena, 3);
+    zassert_not_null(data1, NULL);
+    zassert_equal(data1[0], 0, NULL);
+    zassert_equal(data1[2], 0, NULL);
+    zassert_equal(arena_count(&arena), 3, NULL);
+    /* allocations are aligned */
+    real = arena_alloc(&arena, sizeof(double));
+    zassert_not_null(real, NULL);
+    zassert_equal((uintptr_t)real % sizeof(double), 0, NULL);
+    zassert_true((uint8_t *)real > data1, NULL);
+    *real = 3.14159;
+    count = arena_count(&arena);
+    zassert_true(count >= (3 + sizeof(double)), NULL);
+    /* too big does not change the arena, except for the overflow */
+    zassert_is_null(arena_alloc(&arena, sizeof(buffer.data)), NULL);
+    zassert_true(arena_overflow(&arena), NULL);
+    zassert_equal(arena_count(&arena), count, NULL);
+    /* calloc overflow of the multiplication */
+    zassert_is_null(arena_calloc(&arena, SIZE_MAX, 2), NULL);
+    zassert_equal(arena_count(&arena), count, NULL);
+    /* reset releases it all at once */
+    arena_reset(&arena);
+    zassert_equal(arena_count(&arena), 0, NULL);
+    zassert_false(arena_overflow(&arena), NULL);
+    zassert_equal(arena_peak(&arena), count, NULL);
+    data2 = arena_calloc(&arena, 4, 2);
+    zassert_equal(data2, data1, NULL);
+    zassert_equal(arena_count(&arena), 8, NULL);
+    /* fill it up exactly */
+    zassert_not_null(
+        arena_alloc(&arena, sizeof(buffer.data) - arena_count(&arena)),
+        NULL);
+    zassert_equal(arena_count(&arena), sizeof(buffer.data), NULL);
+    zassert_equal(arena_peak(&arena), sizeof(buffer.data), NULL);
+    zassert_false(arena_overflow(&arena), NULL);
+    zassert_is_null(arena_alloc(&arena, 1), NULL);
+    zassert_true(arena_overflow(&arena), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(arena_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(arena_tests, ztest_unit_test(testArena));
+
+    ztest_run_test_suite(arena_tests);
+}
+#endif
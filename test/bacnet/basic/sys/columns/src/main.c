@@ -0,0 +1,199 @@
+/**
+ * @file
+ * @brief test of the columns store API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <math.h>
+#include <stdint.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/columns.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the rows, growth, removal and scans of a store
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(columns_tests, testColumns)
+#else
+static void testColumns(void)
+#endif
+{
+    COLUMNS_STORE store;
+    float values[40];
+    uint32_t changed[COLUMNS_BITMAP_WORDS(40)];
+    unsigned changes;
+    unsigned i, row;
+    int index;
+
+    /* no store */
+    zassert_equal(columns_add(NULL, 1), -1, NULL);
+    zassert_equal(columns_remove(NULL, 0), BACNET_MAX_INSTANCE, NULL);
+    zassert_equal(columns_count(NULL), 0, NULL);
+    zassert_equal(columns_flags_count(NULL, COLUMNS_FLAG_CHANGED), 0, NULL);
+    zassert_equal(columns_flags_next(NULL, COLUMNS_FLAG_CHANGED, 0), 0, NULL);
+    columns_set(NULL, 0, 1.0f, 0);
+    columns_cleanup(NULL);
+    /* empty store */
+    columns_init(&store);
+    zassert_equal(columns_count(&store), 0, NULL);
+    zassert_equal(columns_remove(&store, 0), BACNET_MAX_INSTANCE, NULL);
+    zassert_equal(columns_flags_next(&store, 0xFF, 0), 0, NULL);
+    /* grow past the first allocation */
+    for (i = 0; i < (COLUMNS_ROWS_DEFAULT * 2) + 1; i++) {
+        index = columns_add(&store, 100 + i);
+        zassert_equal(index, (int)i, NULL);
+        zassert_equal(store.instance[i], 100 + i, NULL);
+        zassert_false(islessgreater(store.value[i], 0.0f), NULL);
+        zassert_equal(store.flags[i], 0, NULL);
+    }
+    zassert_equal(columns_count(&store), (COLUMNS_ROWS_DEFAULT * 2) + 1, NULL);
+    zassert_true(store.capacity >= store.count, NULL);
+    /* set, and scan */
+    columns_set(&store, 3, 3.5f, COLUMNS_FLAG_CHANGED);
+    columns_set(&store, 5, 5.5f, COLUMNS_FLAG_FAULT | COLUMNS_FLAG_CHANGED);
+    columns_set(&store, 9, 9.5f, COLUMNS_FLAG_OUT_OF_SERVICE);
+    columns_set(&store, store.count, 1.0f, COLUMNS_FLAG_CHANGED);
+    zassert_false(islessgreater(store.value[3], 3.5f), NULL);
+    zassert_equal(columns_flags_count(&store, COLUMNS_FLAG_CHANGED), 2, NULL);
+    zassert_equal(columns_flags_count(&store, COLUMNS_FLAG_STATUS), 2, NULL);
+    zassert_equal(columns_flags_count(&store, COLUMNS_FLAG_ACTIVE), 0, NULL);
+    row = columns_flags_next(&store, COLUMNS_FLAG_CHANGED, 0);
+    zassert_equal(row, 3, NULL);
+    row = columns_flags_next(&store, COLUMNS_FLAG_CHANGED, row + 1);
+    zassert_equal(row, 5, NULL);
+    row = columns_flags_next(&store, COLUMNS_FLAG_CHANGED, row + 1);
+    zassert_equal(row, store.count, NULL);
+    row = columns_flags_next(&store, COLUMNS_FLAG_CHANGED, store.count + 10);
+    zassert_equal(row, store.count, NULL);
+    /* remove: the last row is moved into the removed row */
+    i = 100 + (COLUMNS_ROWS_DEFAULT * 2);
+    zassert_equal(store.instance[store.count - 1], i, NULL);
+    zassert_equal(columns_remove(&store, 5), i, NULL);
+    zassert_equal(store.instance[5], i, NULL);
+    zassert_false(islessgreater(store.value[5], 0.0f), NULL);
+    zassert_equal(columns_flags_count(&store, COLUMNS_FLAG_CHANGED), 1, NULL);
+    /* remove the last row: nothing is moved */
+    row = store.count - 1;
+    zassert_equal(columns_remove(&store, row), BACNET_MAX_INSTANCE, NULL);
+    zassert_equal(columns_count(&store), row, NULL);
+    zassert_equal(columns_remove(&store, row), BACNET_MAX_INSTANCE, NULL);
+    /* change of value detection of consecutive rows */
+    while (store.count < ARRAY_SIZE(values)) {
+        zassert_true(columns_add(&store, 200 + store.count) > 0, NULL);
+    }
+    for (i = 0; i < store.count; i++) {
+        columns_set(&store, i, 0.0f, 0);
+        columns_cov_set(&store, i, 10.0f, 1.0f);
+        columns_data_set(&store, i, &store);
+    }
+    zassert_true(store.data[0] == &store, NULL);
+    for (i = 0; i < ARRAY_SIZE(values); i++) {
+        values[i] = 10.5f;
+    }
+    /* a change in the first, the last, and past the first word */
+    values[0] = 9.0f;
+    values[33] = 11.0f;
+    values[ARRAY_SIZE(values) - 1] = 12.0f;
+    changes = columns_cov_update(
+        &store, 0, values, ARRAY_SIZE(values), changed);
+    zassert_equal(changes, 3, NULL);
+    zassert_equal(changed[0], 0x00000001UL, NULL);
+    zassert_equal(changed[1], 0x00000082UL, NULL);
+    zassert_false(islessgreater(store.value[1], 10.5f), NULL);
+    zassert_false(islessgreater(store.prior[0], 9.0f), NULL);
+    zassert_false(islessgreater(store.prior[1], 10.0f), NULL);
+    zassert_false(islessgreater(store.prior[33], 11.0f), NULL);
+    zassert_equal(columns_flags_count(&store, COLUMNS_FLAG_CHANGED), 3, NULL);
+    /* the rows past the last row are not set */
+    changes = columns_cov_update(&store, store.count - 1, values, 4, changed);
+    zassert_equal(changes, 1, NULL);
+    zassert_equal(changed[0], 0x00000001UL, NULL);
+    changes = columns_cov_update(&store, store.count, values, 1, changed);
+    zassert_equal(changes, 0, NULL);
+    zassert_equal(columns_cov_update(NULL, 0, values, 1, changed), 0, NULL);
+    /* cleanup, and use again */
+    columns_cleanup(&store);
+    zassert_equal(columns_count(&store), 0, NULL);
+    zassert_equal(columns_add(&store, 1), 0, NULL);
+    columns_cleanup(&store);
+}
+
+/**
+ * @brief Test the sequence of the writes, that the readers check
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(columns_tests, testColumnsSequence)
+#else
+static void testColumnsSequence(void)
+#endif
+{
+    COLUMNS_STORE store;
+    float values[2] = { 1.0f, 2.0f };
+    uint32_t changed[1];
+    unsigned sequence;
+    float value = 0.0f;
+    uint8_t flags = 0;
+
+    zassert_equal(columns_read_begin(NULL), 0, NULL);
+    zassert_false(columns_read_retry(NULL, 0), NULL);
+    zassert_false(columns_read(NULL, 0, &value, &flags), NULL);
+    columns_write_begin(NULL);
+    columns_write_end(NULL);
+    columns_init(&store);
+    zassert_false(columns_read(&store, 0, &value, &flags), NULL);
+    zassert_equal(columns_add(&store, 1), 0, NULL);
+    zassert_equal(columns_add(&store, 2), 1, NULL);
+    /* a read without a write meanwhile */
+    sequence = columns_read_begin(&store);
+    zassert_equal(sequence & 1U, 0, NULL);
+    zassert_false(columns_read_retry(&store, sequence), NULL);
+    /* a read with a write meanwhile */
+    columns_set(&store, 1, 2.5f, COLUMNS_FLAG_FAULT);
+    zassert_true(columns_read_retry(&store, sequence), NULL);
+    zassert_true(columns_read(&store, 1, &value, &flags), NULL);
+    zassert_false(islessgreater(value, 2.5f), NULL);
+    zassert_equal(flags, COLUMNS_FLAG_FAULT, NULL);
+    zassert_true(columns_read(&store, 0, NULL, NULL), NULL);
+    zassert_false(columns_read(&store, 2, &value, &flags), NULL);
+    /* nested writes are seen by the readers when the outer write ends */
+    sequence = columns_read_begin(&store);
+    columns_write_begin(&store);
+    zassert_equal(store.writing, 1, NULL);
+    columns_set(&store, 0, 0.5f, 0);
+    (void)columns_cov_update(&store, 0, values, 2, changed);
+    zassert_equal(store.writing, 1, NULL);
+    columns_write_end(&store);
+    zassert_equal(store.writing, 0, NULL);
+    zassert_equal(columns_read_begin(&store), sequence + 2, NULL);
+    /* an extra end is ignored */
+    columns_write_end(&store);
+    zassert_equal(columns_read_begin(&store), sequence + 2, NULL);
+    /* the rows that are added or removed */
+    sequence = columns_read_begin(&store);
+    zassert_equal(columns_remove(&store, 0), 2, NULL);
+    zassert_true(columns_read_retry(&store, sequence), NULL);
+    zassert_true(columns_read(&store, 0, &value, NULL), NULL);
+    zassert_false(islessgreater(value, 2.0f), NULL);
+    columns_cleanup(&store);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(columns_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        columns_tests, ztest_unit_test(testColumns),
+        ztest_unit_test(testColumnsSequence));
+
+    ztest_run_test_suite(columns_tests);
+}
+#endif
@@ -151,6 +151,50 @@ static void test_days_apart(void)
     zassert_equal(days_apart(2001, 1, 1, 2000, 1, 1), 366, NULL);
 }
 
+/**
+ * Unit Test for the serial day numbers, checking every date of 0..9999 AD
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(days_tests, test_days_serial)
+#else
+static void test_days_serial(void)
+#endif
+{
+    uint32_t days, test_days;
+    uint16_t year, test_year;
+    uint8_t month, day, test_month, test_day;
+    uint16_t day_of_year;
+
+    test_days = days_serial(0, 1, 1);
+    for (year = 0; year <= 9999; year++) {
+        day_of_year = 0;
+        for (month = 1; month <= 12; month++) {
+            for (day = 1; day <= days_per_month(year, month); day++) {
+                days = days_serial(year, month, day);
+                zassert_equal(days, test_days, "%u/%u/%u", year, month, day);
+                days_serial_to_date(days, &test_year, &test_month, &test_day);
+                zassert_equal(year, test_year, NULL);
+                zassert_equal(month, test_month, NULL);
+                zassert_equal(day, test_day, NULL);
+                day_of_year++;
+                zassert_equal(
+                    days_of_year(year, month, day), day_of_year, NULL);
+                zassert_equal(days_of_year_remaining(year, month, day),
+                    days_per_year(year) - day_of_year, NULL);
+                test_days++;
+            }
+        }
+    }
+    /* the BACnet and the Unix epoch */
+    zassert_equal(
+        days_serial(1970, 1, 1) - days_serial(1900, 1, 1), 25567, NULL);
+    zassert_equal(days_since_epoch(1900, 1970, 1, 1), 25568, NULL);
+    days_since_epoch_to_date(1900, 0, &year, &month, &day);
+    zassert_equal(year, 1900, NULL);
+    zassert_equal(month, 1, NULL);
+    zassert_equal(day, 0, NULL);
+}
+
 /**
  * @}
  */
@@ -164,7 +208,8 @@ void test_main(void)
         days_tests, ztest_unit_test(test_days_epoch_conversion),
         ztest_unit_test(test_days_of_year_to_md),
         ztest_unit_test(test_days_date_is_valid),
-        ztest_unit_test(test_days_apart));
+        ztest_unit_test(test_days_apart),
+        ztest_unit_test(test_days_serial));
 
     ztest_run_test_suite(days_tests);
 }
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief test of the dynamic buffer API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/dbuf.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the appends, growth, truncate, reset and cleanup
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dbuf_tests, testDynamicBuffer)
+#else
+static void testDynamicBuffer(void)
+#endif
+{
+    DYNAMIC_BUFFER b;
+    const uint8_t octets[] = { 0x00, 0x1F, 0xA5, 0xFF };
+    char text[64];
+    size_t i;
+
+    dbuf_init(&b);
+    zassert_equal(dbuf_count(&b), 0, NULL);
+    zassert_equal(strcmp(dbuf_data(&b), ""), 0, NULL);
+    zassert_false(dbuf_error(&b), NULL);
+    zassert_true(dbuf_error(NULL), NULL);
+    zassert_false(dbuf_append(NULL, "a", 1), NULL);
+    zassert_false(dbuf_append(&b, NULL, 1), NULL);
+    zassert_false(dbuf_append_string(&b, NULL), NULL);
+    zassert_true(dbuf_append(&b, NULL, 0), NULL);
+    zassert_true(dbuf_append_string(&b, "Hello"), NULL);
+    zassert_true(dbuf_append_char(&b, ','), NULL);
+    zassert_true(dbuf_append(&b, " World!!", 7), NULL);
+    zassert_equal(strcmp(dbuf_data(&b), "Hello, World!"), 0, NULL);
+    zassert_equal(dbuf_count(&b), 13, NULL);
+    zassert_false(dbuf_truncate(&b, 14), NULL);
+    zassert_true(dbuf_truncate(&b, 5), NULL);
+    zassert_equal(strcmp(dbuf_data(&b), "Hello"), 0, NULL);
+    /* growth keeps the text */
+    for (i = 0; i < (DBUF_SIZE_DEFAULT * 4); i++) {
+        zassert_true(dbuf_append_char(&b, (char)('a' + (i % 26))), NULL);
+    }
+    zassert_equal(dbuf_count(&b), 5 + (DBUF_SIZE_DEFAULT * 4), NULL);
+    zassert_true(b.size > dbuf_count(&b), NULL);
+    zassert_equal(memcmp(dbuf_data(&b), "Helloabc", 8), 0, NULL);
+    zassert_equal(dbuf_data(&b)[dbuf_count(&b)], 0, NULL);
+    zassert_true(dbuf_reserve(&b, DBUF_SIZE_DEFAULT * 8), NULL);
+    zassert_true(b.size > (dbuf_count(&b) + (DBUF_SIZE_DEFAULT * 8)), NULL);
+    /* reset keeps the memory */
+    i = b.size;
+    dbuf_reset(&b);
+    zassert_equal(dbuf_count(&b), 0, NULL);
+    zassert_equal(b.size, i, NULL);
+    zassert_equal(strcmp(dbuf_data(&b), ""), 0, NULL);
+    /* numbers */
+    zassert_true(dbuf_append_unsigned(&b, 0), NULL);
+    zassert_true(dbuf_append_char(&b, ' '), NULL);
+    zassert_true(dbuf_append_unsigned(&b, UINT64_MAX), NULL);
+    zassert_true(dbuf_append_char(&b, ' '), NULL);
+    zassert_true(dbuf_append_signed(&b, INT64_MIN), NULL);
+    zassert_true(dbuf_append_char(&b, ' '), NULL);
+    zassert_true(dbuf_append_signed(&b, -42), NULL);
+    zassert_true(dbuf_append_char(&b, ' '), NULL);
+    zassert_true(dbuf_append_hex(&b, octets, sizeof(octets)), NULL);
+    zassert_equal(
+        strcmp(dbuf_data(&b),
+            "0 18446744073709551615 -9223372036854775808 -42 001FA5FF"),
+        0, NULL);
+    /* extend for the text of the caller */
+    dbuf_reset(&b);
+    memcpy(dbuf_extend(&b, 3), "abc", 3);
+    zassert_equal(strcmp(dbuf_data(&b), "abc"), 0, NULL);
+    snprintf(text, sizeof(text), "%s", dbuf_data(&b));
+    zassert_equal(strcmp(text, "abc"), 0, NULL);
+    dbuf_cleanup(&b);
+    zassert_equal(dbuf_count(&b), 0, NULL);
+    zassert_is_null(b.data, NULL);
+    dbuf_cleanup(NULL);
+}
+
+/**
+ * @brief Test the real values, which are the same as with printf()
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dbuf_tests, testDynamicBufferReal)
+#else
+static void testDynamicBufferReal(void)
+#endif
+{
+    static const double values[] = { 0.0, -0.0, 1.0, -1.0, 0.1, 0.5, 1.5,
+        2.5, 21.5, -3.25, 0.0078125, 1234.5678, 99.9999995, 0.000001,
+        -0.0000001, 123456789.125, 3.14159265358979, 1e14, 1e15, -2e20,
+        1.0 / 3.0, 72.4f, 1e-7 };
+    static const unsigned decimals[] = { 0, 1, 2, 6, 9 };
+    DYNAMIC_BUFFER b;
+    char text[64];
+    unsigned i, j;
+
+    dbuf_init(&b);
+    for (i = 0; i < (sizeof(values) / sizeof(values[0])); i++) {
+        for (j = 0; j < (sizeof(decimals) / sizeof(decimals[0])); j++) {
+            dbuf_reset(&b);
+            zassert_true(dbuf_append_real(&b, values[i], decimals[j]), NULL);
+            snprintf(text, sizeof(text), "%.*f", (int)decimals[j], values[i]);
+            zassert_equal(strcmp(dbuf_data(&b), text), 0, "%s is not %s",
+                dbuf_data(&b), text);
+        }
+    }
+    /* not finite */
+    dbuf_reset(&b);
+    zassert_true(dbuf_append_real(&b, 1.0 / 0.0, 6), NULL);
+    snprintf(text, sizeof(text), "%f", 1.0 / 0.0);
+    zassert_equal(strcmp(dbuf_data(&b), text), 0, NULL);
+    /* more decimals than fit */
+    dbuf_reset(&b);
+    zassert_true(dbuf_append_real(&b, 0.5, 12), NULL);
+    zassert_equal(strcmp(dbuf_data(&b), "0.500000000"), 0, NULL);
+    dbuf_cleanup(&b);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(dbuf_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(dbuf_tests, ztest_unit_test(testDynamicBuffer),
+        ztest_unit_test(testDynamicBufferReal));
+
+    ztest_run_test_suite(dbuf_tests);
+}
+#endif
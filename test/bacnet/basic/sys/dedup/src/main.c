@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @brief test of the cache of the hashes of received messages
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/dedup.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test that repeats are found within the window, and only then
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dedup_tests, testDedupWindow)
+#else
+static void testDedupWindow(void)
+#endif
+{
+    BACNET_DEDUP_ENTRY entries[4];
+    BACNET_DEDUP dedup;
+    const uint8_t source_a[] = { 192, 168, 0, 1, 0xBA, 0xC0 };
+    const uint8_t source_b[] = { 192, 168, 0, 2, 0xBA, 0xC0 };
+    const uint8_t who_is[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10,
+        0x08 };
+    const uint8_t i_am[] = { 0x01, 0x20, 0xFF, 0xFF, 0x00, 0xFF, 0x10,
+        0x00 };
+    bool status;
+
+    bacnet_dedup_init(&dedup, entries, 4, 1000);
+    status = bacnet_dedup_check(&dedup, source_a, sizeof(source_a), who_is,
+        sizeof(who_is), 0);
+    zassert_false(status, NULL);
+    status = bacnet_dedup_check(&dedup, source_a, sizeof(source_a), who_is,
+        sizeof(who_is), 500);
+    zassert_true(status, NULL);
+    /* the same message from another source is not a repeat */
+    status = bacnet_dedup_check(&dedup, source_b, sizeof(source_b), who_is,
+        sizeof(who_is), 500);
+    zassert_false(status, NULL);
+    status = bacnet_dedup_check(
+        &dedup, source_a, sizeof(source_a), i_am, sizeof(i_am), 500);
+    zassert_false(status, NULL);
+    zassert_equal(bacnet_dedup_dropped(&dedup), 1, NULL);
+    /* after the window, the message is processed again */
+    status = bacnet_dedup_check(&dedup, source_a, sizeof(source_a), who_is,
+        sizeof(who_is), 1001);
+    zassert_false(status, NULL);
+    status = bacnet_dedup_check(&dedup, source_a, sizeof(source_a), who_is,
+        sizeof(who_is), 1500);
+    zassert_true(status, NULL);
+    zassert_equal(bacnet_dedup_dropped(&dedup), 2, NULL);
+}
+
+/**
+ * @brief Test that the oldest entries are replaced, and the empty cache
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dedup_tests, testDedupReplace)
+#else
+static void testDedupReplace(void)
+#endif
+{
+    BACNET_DEDUP_ENTRY entries[2];
+    BACNET_DEDUP dedup;
+    const uint8_t source[] = { 10, 0, 0, 1, 0xBA, 0xC0 };
+    uint8_t data[3] = { 1, 2, 3 };
+    uint8_t i;
+    bool status;
+
+    bacnet_dedup_init(&dedup, entries, 2, 1000);
+    for (i = 0; i < 3; i++) {
+        data[0] = i;
+        status = bacnet_dedup_check(
+            &dedup, source, sizeof(source), data, sizeof(data), 10);
+        zassert_false(status, NULL);
+    }
+    /* the first message was replaced by the third */
+    data[0] = 0;
+    status = bacnet_dedup_check(
+        &dedup, source, sizeof(source), data, sizeof(data), 20);
+    zassert_false(status, NULL);
+    data[0] = 2;
+    status = bacnet_dedup_check(
+        &dedup, source, sizeof(source), data, sizeof(data), 20);
+    zassert_true(status, NULL);
+    zassert_not_equal(bacnet_dedup_hash(0, data, sizeof(data)),
+        bacnet_dedup_hash(0, source, sizeof(source)), NULL);
+    /* a cache without entries finds no repeats */
+    bacnet_dedup_init(&dedup, NULL, 2, 1000);
+    status = bacnet_dedup_check(
+        &dedup, source, sizeof(source), data, sizeof(data), 20);
+    zassert_false(status, NULL);
+    status = bacnet_dedup_check(
+        &dedup, source, sizeof(source), data, sizeof(data), 20);
+    zassert_false(status, NULL);
+    zassert_false(bacnet_dedup_check(NULL, source, sizeof(source), data,
+                      sizeof(data), 20),
+        NULL);
+    zassert_equal(bacnet_dedup_dropped(NULL), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(dedup_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(dedup_tests, ztest_unit_test(testDedupWindow),
+        ztest_unit_test(testDedupReplace));
+
+    ztest_run_test_suite(dedup_tests);
+}
+#endif
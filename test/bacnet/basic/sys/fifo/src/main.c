@@ -9,6 +9,7 @@
  */
 
 #include <limits.h>
+#include <string.h>
 #include <zephyr/ztest.h>
 #include <bacnet/basic/sys/fifo.h>
 
@@ -146,6 +147,78 @@ static void testFIFOBuffer(void)
 
     return;
 }
+
+/**
+ * @brief Unit Test for the block transfers that wrap around the end of the
+ *  FIFO data store, and for the contiguous and look ahead accessors
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(fifo_tests, testFIFOBufferWrap)
+#else
+static void testFIFOBufferWrap(void)
+#endif
+{
+    FIFO_BUFFER test_buffer = { 0 };
+    volatile uint8_t data_store[16] = { 0 };
+    uint8_t add_data[16] = { 0 };
+    uint8_t test_data[16] = { 0 };
+    const uint8_t *data = NULL;
+    unsigned start, length, count, index;
+    uint8_t value = 0;
+
+    for (index = 0; index < sizeof(add_data); index++) {
+        add_data[index] = (uint8_t)(0xA0 + index);
+    }
+    FIFO_Init(&test_buffer, data_store, sizeof(data_store));
+    /* every start position and every length, with and without a wrap */
+    for (start = 0; start < sizeof(data_store); start++) {
+        for (length = 1; length <= sizeof(data_store); length++) {
+            FIFO_Init(&test_buffer, data_store, sizeof(data_store));
+            zassert_true(FIFO_Add(&test_buffer, add_data, start), NULL);
+            zassert_equal(FIFO_Pull(&test_buffer, NULL, start), start, NULL);
+            zassert_true(FIFO_Empty(&test_buffer), NULL);
+            zassert_true(FIFO_Add(&test_buffer, add_data, length), NULL);
+            zassert_equal(FIFO_Count(&test_buffer), length, NULL);
+            zassert_false(FIFO_Add(&test_buffer, add_data,
+                              sizeof(data_store) - length + 1),
+                NULL);
+            /* look ahead */
+            zassert_true(
+                FIFO_Peek_At(&test_buffer, length - 1, &value), NULL);
+            zassert_equal(value, add_data[length - 1], NULL);
+            zassert_false(FIFO_Peek_At(&test_buffer, length, &value), NULL);
+            memset(test_data, 0, sizeof(test_data));
+            count = FIFO_Peek_Ahead(&test_buffer, test_data, length);
+            zassert_equal(count, length, NULL);
+            zassert_mem_equal(test_data, add_data, length, NULL);
+            /* the contiguous bytes end at the end of the data store */
+            count = FIFO_Peek_Contiguous(&test_buffer, &data);
+            if ((start + length) > sizeof(data_store)) {
+                zassert_equal(count, sizeof(data_store) - start, NULL);
+            } else {
+                zassert_equal(count, length, NULL);
+            }
+            zassert_mem_equal(data, add_data, count, NULL);
+            /* use the bytes in place, then the rest after the wrap */
+            zassert_equal(FIFO_Pull(&test_buffer, NULL, count), count, NULL);
+            if (count < length) {
+                zassert_equal(FIFO_Peek_Contiguous(&test_buffer, &data),
+                    length - count, NULL);
+                zassert_mem_equal(
+                    data, &add_data[count], length - count, NULL);
+            }
+            zassert_equal(FIFO_Pull(&test_buffer, test_data,
+                              sizeof(test_data)),
+                length - count, NULL);
+            zassert_mem_equal(
+                test_data, &add_data[count], length - count, NULL);
+            zassert_true(FIFO_Empty(&test_buffer), NULL);
+            zassert_equal(FIFO_Peek_Contiguous(&test_buffer, &data), 0, NULL);
+        }
+    }
+    zassert_false(FIFO_Peek_At(NULL, 0, &value), NULL);
+    zassert_equal(FIFO_Peek_Contiguous(NULL, &data), 0, NULL);
+}
 /**
  * @}
  */
@@ -155,7 +228,8 @@ ZTEST_SUITE(fifo_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(fifo_tests, ztest_unit_test(testFIFOBuffer));
+    ztest_test_suite(fifo_tests, ztest_unit_test(testFIFOBuffer),
+        ztest_unit_test(testFIFOBufferWrap));
 
     ztest_run_test_suite(fifo_tests);
 }
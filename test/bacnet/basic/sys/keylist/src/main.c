@@ -313,6 +313,57 @@ static void testKeyListLarge(void)
     return;
 }
 
+/* test loading a lot of entries out of order */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(keylist_tests, testKeyListBulk)
+#else
+static void testKeyListBulk(void)
+#endif
+{
+    bool status = false;
+    static int data_list[1024 * 16] = { 0 };
+    int *data;
+    OS_Keylist list;
+    KEY key;
+    KEY test_key;
+    int index;
+    const unsigned num_keys = 1024 * 16;
+
+    list = Keylist_Create();
+    zassert_not_null(list, NULL);
+    /* every odd key, from the largest down */
+    for (key = 0; key < num_keys; key++) {
+        data_list[key] = 42 + key;
+        if (key & 1) {
+            status = Keylist_Data_Bulk_Add(
+                list, num_keys - key, &data_list[num_keys - key]);
+            zassert_true(status, NULL);
+        }
+    }
+    zassert_equal(Keylist_Count(list), num_keys / 2, NULL);
+    for (index = 0; index < Keylist_Count(list); index++) {
+        status = Keylist_Index_Key(list, index, &test_key);
+        zassert_true(status, NULL);
+        zassert_equal(test_key, (KEY)(index * 2) + 1, NULL);
+        data = Keylist_Data_Index(list, index);
+        zassert_equal(*data, data_list[test_key], NULL);
+    }
+    /* the gaps are the even keys */
+    zassert_equal(Keylist_Next_Empty_Key(list, 1), 2, NULL);
+    zassert_equal(Keylist_Next_Empty_Key(list, 4), 4, NULL);
+    index = Keylist_Data_Add(list, 2, &data_list[2]);
+    zassert_equal(index, 1, NULL);
+    zassert_equal(Keylist_Next_Empty_Key(list, 1), 4, NULL);
+    data = Keylist_Data(list, 2);
+    zassert_equal(*data, data_list[2], NULL);
+    data = Keylist_Data_Delete(list, 2);
+    zassert_equal(*data, data_list[2], NULL);
+    zassert_equal(Keylist_Index(list, 3), 1, NULL);
+    Keylist_Delete(list);
+
+    return;
+}
+
 /* test the encode and decode macros */
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(keylist_tests, testKeySample)
@@ -358,7 +409,8 @@ void test_main(void)
         keylist_tests, ztest_unit_test(testKeyListFIFO),
         ztest_unit_test(testKeyListFILO), ztest_unit_test(testKeyListDataKey),
         ztest_unit_test(testKeyListDataIndex),
-        ztest_unit_test(testKeyListLarge), ztest_unit_test(testKeySample));
+        ztest_unit_test(testKeyListLarge), ztest_unit_test(testKeyListBulk),
+        ztest_unit_test(testKeySample));
 
     ztest_run_test_suite(keylist_tests);
 }
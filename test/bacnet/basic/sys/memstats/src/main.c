@@ -0,0 +1,158 @@
+/**
+ * @file
+ * @brief test of the memory accounting of the subsystems
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/keylist.h>
+#include <bacnet/basic/sys/memstats.h>
+#include <bacnet/basic/sys/pool.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the counters of the allocation calls of a subsystem
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(memstats_tests, testMemstatsCounters)
+#else
+static void testMemstatsCounters(void)
+#endif
+{
+    BACNET_MEMORY_STATS stats = { 0 }, total = { 0 };
+    uint8_t *data, *more;
+    bool status;
+
+    bacnet_memstats_reset();
+    status = bacnet_memstats(MEMSTATS_SUBSYSTEM_MAX, &stats);
+    zassert_false(status, NULL);
+    status = bacnet_memstats(MEMSTATS_COV, NULL);
+    zassert_false(status, NULL);
+    data = bacnet_memstats_calloc(MEMSTATS_COV, 4, 25);
+    zassert_not_null(data, NULL);
+    status = bacnet_memstats(MEMSTATS_COV, &stats);
+    zassert_true(status, NULL);
+    zassert_equal(stats.current_bytes, 100, NULL);
+    zassert_equal(stats.peak_bytes, 100, NULL);
+    zassert_equal(stats.allocations, 1, NULL);
+    zassert_equal(stats.frees, 0, NULL);
+    /* a resize is a free of the old size and an allocation of the new */
+    more = bacnet_memstats_realloc(MEMSTATS_COV, data, 100, 300);
+    zassert_not_null(more, NULL);
+    data = more;
+    bacnet_memstats(MEMSTATS_COV, &stats);
+    zassert_equal(stats.current_bytes, 300, NULL);
+    zassert_equal(stats.peak_bytes, 300, NULL);
+    zassert_equal(stats.allocations, 2, NULL);
+    zassert_equal(stats.frees, 1, NULL);
+    more = bacnet_memstats_realloc(MEMSTATS_COV, data, 300, 50);
+    zassert_not_null(more, NULL);
+    data = more;
+    bacnet_memstats(MEMSTATS_COV, &stats);
+    zassert_equal(stats.current_bytes, 50, NULL);
+    zassert_equal(stats.peak_bytes, 300, NULL);
+    more = bacnet_memstats_malloc(MEMSTATS_ADDRESS, 10);
+    zassert_not_null(more, NULL);
+    bacnet_memstats_total(&total);
+    zassert_equal(total.current_bytes, 60, NULL);
+    zassert_equal(total.peak_bytes, 300, NULL);
+    zassert_equal(total.allocations, 4, NULL);
+    /* the peak starts again from the bytes allocated now */
+    bacnet_memstats_reset();
+    bacnet_memstats(MEMSTATS_COV, &stats);
+    zassert_equal(stats.current_bytes, 50, NULL);
+    zassert_equal(stats.peak_bytes, 50, NULL);
+    zassert_equal(stats.allocations, 0, NULL);
+    bacnet_memstats_free(MEMSTATS_COV, data, 50);
+    bacnet_memstats_free(MEMSTATS_ADDRESS, more, 10);
+    bacnet_memstats_free(MEMSTATS_ADDRESS, NULL, 10);
+    bacnet_memstats(MEMSTATS_COV, &stats);
+    zassert_equal(stats.current_bytes, 0, NULL);
+    zassert_equal(stats.frees, 1, NULL);
+    bacnet_memstats(MEMSTATS_ADDRESS, &stats);
+    zassert_equal(stats.current_bytes, 0, NULL);
+    zassert_equal(stats.frees, 1, NULL);
+    bacnet_memstats_total(&total);
+    zassert_equal(total.current_bytes, 0, NULL);
+    zassert_equal(total.peak_bytes, 60, NULL);
+    /* failures, and the tables that are sized at compile time */
+    bacnet_memstats_failed(MEMSTATS_TSM);
+    bacnet_memstats_static(MEMSTATS_TSM, 1234);
+    bacnet_memstats_static(MEMSTATS_TSM, 1000);
+    bacnet_memstats_static(MEMSTATS_TREND_LOG, 24);
+    bacnet_memstats(MEMSTATS_TSM, &stats);
+    zassert_equal(stats.failures, 1, NULL);
+    zassert_equal(stats.static_bytes, 1000, NULL);
+    zassert_equal(stats.current_bytes, 0, NULL);
+    bacnet_memstats_total(&total);
+    zassert_equal(total.static_bytes, 1024, NULL);
+    zassert_equal(total.failures, 1, NULL);
+}
+
+/**
+ * @brief Test the accounting of the Keylist library and of the pools
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(memstats_tests, testMemstatsSubsystems)
+#else
+static void testMemstatsSubsystems(void)
+#endif
+{
+    BACNET_MEMORY_STATS stats = { 0 };
+    static int values[100];
+    POOL_BUFFER pool = { 0 };
+    OS_Keylist list;
+    size_t peak;
+    int i;
+
+    list = Keylist_Create();
+    zassert_not_null(list, NULL);
+    for (i = 0; i < 100; i++) {
+        Keylist_Data_Add(list, i, &values[i]);
+    }
+    bacnet_memstats(MEMSTATS_KEYLIST, &stats);
+    zassert_true(stats.current_bytes > (100 * sizeof(KEY)), NULL);
+    peak = stats.peak_bytes;
+    for (i = 0; i < 100; i++) {
+        (void)Keylist_Data_Delete(list, i);
+    }
+    bacnet_memstats(MEMSTATS_KEYLIST, &stats);
+    zassert_true(stats.current_bytes < peak, NULL);
+    zassert_equal(stats.peak_bytes, peak, NULL);
+    Keylist_Delete(list);
+    bacnet_memstats(MEMSTATS_KEYLIST, &stats);
+    zassert_equal(stats.current_bytes, 0, NULL);
+    zassert_equal(stats.allocations, stats.frees, NULL);
+    /* the slabs of the pools */
+    pool_init(&pool, 24, 4);
+    zassert_not_null(pool_calloc(&pool), NULL);
+    zassert_true(pool_reserve(&pool, 100), NULL);
+    bacnet_memstats(MEMSTATS_OBJECT, &stats);
+    zassert_equal(stats.allocations, 2, NULL);
+    zassert_true(stats.current_bytes >= (100 * 24), NULL);
+    pool_cleanup(&pool);
+    bacnet_memstats(MEMSTATS_OBJECT, &stats);
+    zassert_equal(stats.current_bytes, 0, NULL);
+    zassert_equal(stats.frees, 2, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(memstats_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(memstats_tests, ztest_unit_test(testMemstatsCounters),
+        ztest_unit_test(testMemstatsSubsystems));
+
+    ztest_run_test_suite(memstats_tests);
+}
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief test of the pool memory allocator API
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/pool.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+struct pool_test_object {
+    uint32_t instance;
+    double value;
+    char name[13];
+};
+
+/**
+ * @brief Test the pool allocations, reuse, growth and cleanup
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(pool_tests, testPool)
+#else
+static void testPool(void)
+#endif
+{
+    POOL_BUFFER pool = { 0 };
+    struct pool_test_object *object1, *object2, *object3;
+    struct pool_test_object *objects[20];
+    uint8_t *data;
+    size_t i;
+
+    /* not initialized */
+    zassert_is_null(pool_calloc(&pool), NULL);
+    zassert_is_null(pool_calloc(NULL), NULL);
+    zassert_false(pool_reserve(&pool, 1), NULL);
+    zassert_false(pool_reserve(NULL, 1), NULL);
+    pool_free(NULL, NULL);
+    zassert_equal(pool_count(NULL), 0, NULL);
+    zassert_equal(pool_capacity(NULL), 0, NULL);
+    /* first slab */
+    pool_init(&pool, sizeof(struct pool_test_object), 4);
+    zassert_true(pool.element_size >= sizeof(struct pool_test_object), NULL);
+    zassert_equal(pool_capacity(&pool), 0, NULL);
+    object1 = pool_calloc(&pool);
+    zassert_not_null(object1, NULL);
+    zassert_equal(pool_count(&pool), 1, NULL);
+    zassert_equal(pool_capacity(&pool), 4, NULL);
+    zassert_equal(((uintptr_t)object1) % sizeof(double), 0, NULL);
+    object1->instance = 1;
+    object1->value = 1.0;
+    object2 = pool_calloc(&pool);
+    zassert_not_null(object2, NULL);
+    zassert_equal(
+        (uint8_t *)object2 - (uint8_t *)object1, pool.element_size, NULL);
+    zassert_equal(object2->instance, 0, NULL);
+    zassert_equal(object1->instance, 1, NULL);
+    /* reuse of a freed element, which is zeroed again */
+    object2->instance = 2;
+    pool_free(&pool, object2);
+    zassert_equal(pool_count(&pool), 1, NULL);
+    object3 = pool_calloc(&pool);
+    zassert_equal(object3, object2, NULL);
+    zassert_equal(object3->instance, 0, NULL);
+    pool_free(&pool, NULL);
+    zassert_equal(pool_count(&pool), 2, NULL);
+    /* growth: each slab is as large as the slabs before it */
+    for (i = 0; i < 3; i++) {
+        objects[i] = pool_calloc(&pool);
+        zassert_not_null(objects[i], NULL);
+    }
+    zassert_equal(pool_count(&pool), 5, NULL);
+    zassert_equal(pool_capacity(&pool), 8, NULL);
+    /* reserve: the elements are available, and contiguous */
+    zassert_true(pool_reserve(&pool, 3), NULL);
+    zassert_equal(pool_capacity(&pool), 8, NULL);
+    zassert_true(pool_reserve(&pool, 20), NULL);
+    zassert_equal(pool_capacity(&pool), 25, NULL);
+    for (i = 0; i < 20; i++) {
+        objects[i] = pool_calloc(&pool);
+        zassert_not_null(objects[i], NULL);
+    }
+    zassert_equal(pool_count(&pool), 25, NULL);
+    zassert_equal(pool_capacity(&pool), 25, NULL);
+    /* the reserved slab is the first to be used */
+    data = (uint8_t *)objects[0];
+    for (i = 1; i < 17; i++) {
+        data += pool.element_size;
+        zassert_equal((uint8_t *)objects[i], data, NULL);
+    }
+    /* cleanup, and use again */
+    pool_cleanup(&pool);
+    zassert_equal(pool_count(&pool), 0, NULL);
+    zassert_equal(pool_capacity(&pool), 0, NULL);
+    object1 = pool_calloc(&pool);
+    zassert_not_null(object1, NULL);
+    zassert_equal(pool_capacity(&pool), 4, NULL);
+    pool_cleanup(&pool);
+    pool_cleanup(NULL);
+    /* elements smaller than a pointer */
+    pool_init(&pool, 1, 0);
+    zassert_true(pool.element_size >= sizeof(void *), NULL);
+    zassert_not_null(pool_calloc(&pool), NULL);
+    zassert_equal(pool_capacity(&pool), POOL_SLAB_COUNT_DEFAULT, NULL);
+    pool_cleanup(&pool);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(pool_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(pool_tests, ztest_unit_test(testPool));
+
+    ztest_run_test_suite(pool_tests);
+}
+#endif
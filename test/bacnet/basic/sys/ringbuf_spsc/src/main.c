@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @brief test of the lock-free single producer, single consumer ring buffer
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/ringbuf_spsc.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the copy API around the ring many times
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ringbuf_spsc_tests, testRingbufSPSC)
+#else
+static void testRingbufSPSC(void)
+#endif
+{
+    RINGBUF_SPSC b;
+    uint8_t store[8 * 3];
+    uint8_t element[3], value[3];
+    unsigned i, j, count = 0, popped = 0;
+
+    zassert_false(Ringbuf_SPSC_Init(&b, store, 3, 6), NULL);
+    zassert_false(Ringbuf_SPSC_Init(&b, NULL, 3, 8), NULL);
+    zassert_false(Ringbuf_SPSC_Init(NULL, store, 3, 8), NULL);
+    zassert_true(Ringbuf_SPSC_Init(&b, store, 3, 8), NULL);
+    zassert_equal(Ringbuf_SPSC_Size(&b), 8, NULL);
+    zassert_true(Ringbuf_SPSC_Empty(&b), NULL);
+    zassert_false(Ringbuf_SPSC_Full(&b), NULL);
+    zassert_is_null(Ringbuf_SPSC_Peek(&b), NULL);
+    zassert_false(Ringbuf_SPSC_Pop(&b, element), NULL);
+    /* fill it */
+    for (i = 0; i < 8; i++) {
+        memset(element, (int)i, sizeof(element));
+        zassert_true(Ringbuf_SPSC_Put(&b, element), NULL);
+        zassert_equal(Ringbuf_SPSC_Count(&b), i + 1, NULL);
+    }
+    zassert_true(Ringbuf_SPSC_Full(&b), NULL);
+    zassert_false(Ringbuf_SPSC_Put(&b, element), NULL);
+    zassert_is_null(Ringbuf_SPSC_Data_Peek(&b), NULL);
+    for (i = 0; i < 8; i++) {
+        zassert_true(Ringbuf_SPSC_Pop(&b, element), NULL);
+        memset(value, (int)i, sizeof(value));
+        zassert_mem_equal(element, value, sizeof(value), NULL);
+    }
+    zassert_true(Ringbuf_SPSC_Empty(&b), NULL);
+    /* uneven puts and pops, many times around the ring */
+    for (i = 0; i < 1000; i++) {
+        for (j = 0; j < ((i % 5) + 1); j++) {
+            memset(element, (int)(count & 0xFF), sizeof(element));
+            if (Ringbuf_SPSC_Put(&b, element)) {
+                count++;
+            }
+        }
+        for (j = 0; j < ((i % 3) + 1); j++) {
+            if (Ringbuf_SPSC_Pop(&b, element)) {
+                memset(value, (int)(popped & 0xFF), sizeof(value));
+                zassert_mem_equal(element, value, sizeof(value), NULL);
+                popped++;
+            }
+        }
+        zassert_equal(Ringbuf_SPSC_Count(&b), count - popped, NULL);
+        zassert_true(Ringbuf_SPSC_Count(&b) <= 8, NULL);
+    }
+}
+
+/**
+ * @brief Test the claim and commit of elements in place, with the head
+ *  and tail wrapping around the range of the indexes
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ringbuf_spsc_tests, testRingbufSPSCInPlace)
+#else
+static void testRingbufSPSCInPlace(void)
+#endif
+{
+    struct test_packet {
+        uint16_t length;
+        uint8_t data[30];
+    } store[4], *packet, other;
+    RINGBUF_SPSC b;
+    unsigned i;
+
+    zassert_true(
+        Ringbuf_SPSC_Init(&b, (uint8_t *)store, sizeof(store[0]), 4), NULL);
+    /* start near the wrap of the indexes */
+    b.head = UINT32_MAX - 2;
+    b.tail = UINT32_MAX - 2;
+    for (i = 0; i < 20; i++) {
+        packet = Ringbuf_SPSC_Data_Peek(&b);
+        zassert_not_null(packet, NULL);
+        /* nothing is visible to the consumer before the commit */
+        zassert_is_null(Ringbuf_SPSC_Peek(&b), NULL);
+        packet->length = (uint16_t)i;
+        memset(packet->data, (int)i, sizeof(packet->data));
+        /* only the claimed element can be committed */
+        zassert_false(Ringbuf_SPSC_Data_Put(&b, &other), NULL);
+        zassert_true(Ringbuf_SPSC_Data_Put(&b, packet), NULL);
+        zassert_equal(Ringbuf_SPSC_Count(&b), 1, NULL);
+        packet = Ringbuf_SPSC_Peek(&b);
+        zassert_not_null(packet, NULL);
+        zassert_equal(packet->length, i, NULL);
+        zassert_equal(packet->data[29], (uint8_t)i, NULL);
+        zassert_true(Ringbuf_SPSC_Pop(&b, NULL), NULL);
+        zassert_true(Ringbuf_SPSC_Empty(&b), NULL);
+    }
+    zassert_true(b.head < 20, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(ringbuf_spsc_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(ringbuf_spsc_tests, ztest_unit_test(testRingbufSPSC),
+        ztest_unit_test(testRingbufSPSCInPlace));
+
+    ztest_run_test_suite(ringbuf_spsc_tests);
+}
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @brief test of the SHA-256 hash and the HMAC-SHA256 signature
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/sha256.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the hash of the FIPS 180-4 examples, in one or many parts
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(sha256_tests, testSHA256)
+#else
+static void testSHA256(void)
+#endif
+{
+    const uint8_t abc_digest[BACNET_SHA256_DIGEST_SIZE] = { 0xba, 0x78, 0x16,
+        0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae,
+        0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4,
+        0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad };
+    const uint8_t two_block_digest[BACNET_SHA256_DIGEST_SIZE] = { 0x24, 0x8d,
+        0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c,
+        0x3e, 0x60, 0x39, 0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67,
+        0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 };
+    const uint8_t a_digest[BACNET_SHA256_DIGEST_SIZE] = { 0x41, 0xed, 0xec,
+        0xe4, 0x2d, 0x63, 0xe8, 0xd9, 0xbf, 0x51, 0x5a, 0x9b, 0xa6, 0x93,
+        0x2e, 0x1c, 0x20, 0xcb, 0xc9, 0xf5, 0xa5, 0xd1, 0x34, 0x64, 0x5a,
+        0xdb, 0x5d, 0xb1, 0xb9, 0x73, 0x7e, 0xa3 };
+    const char *two_block =
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    uint8_t data[1000];
+    uint8_t digest[BACNET_SHA256_DIGEST_SIZE];
+    BACNET_SHA256 ctx;
+    unsigned i;
+
+    bacnet_sha256_init(&ctx);
+    bacnet_sha256_update(&ctx, (const uint8_t *)"abc", 3);
+    bacnet_sha256_final(&ctx, digest);
+    zassert_mem_equal(digest, abc_digest, sizeof(digest), NULL);
+    bacnet_sha256_update(
+        &ctx, (const uint8_t *)two_block, strlen(two_block));
+    bacnet_sha256_final(&ctx, digest);
+    zassert_mem_equal(digest, two_block_digest, sizeof(digest), NULL);
+    /* parts that do not end on a block */
+    memset(data, 'a', sizeof(data));
+    for (i = 0; i < sizeof(data); i += 100) {
+        bacnet_sha256_update(&ctx, &data[i], 100);
+    }
+    bacnet_sha256_final(&ctx, digest);
+    zassert_mem_equal(digest, a_digest, sizeof(digest), NULL);
+    bacnet_sha256_update(&ctx, data, sizeof(data));
+    bacnet_sha256_final(&ctx, digest);
+    zassert_mem_equal(digest, a_digest, sizeof(digest), NULL);
+}
+
+/**
+ * @brief Test the HMAC of the RFC 4231 examples, with a prepared key
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(sha256_tests, testHMAC_SHA256)
+#else
+static void testHMAC_SHA256(void)
+#endif
+{
+    const uint8_t jefe_digest[BACNET_SHA256_DIGEST_SIZE] = { 0x5b, 0xdc, 0xc1,
+        0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95,
+        0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d,
+        0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43 };
+    const uint8_t large_digest[BACNET_SHA256_DIGEST_SIZE] = { 0x60, 0xe4,
+        0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f, 0x0d, 0x8a, 0x26, 0xaa, 0xcb,
+        0xf5, 0xb7, 0x7f, 0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28, 0xc5, 0x14,
+        0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54 };
+    const char *jefe_data = "what do ya want for nothing?";
+    const char *large_data =
+        "Test Using Larger Than Block-Size Key - Hash Key First";
+    uint8_t large_key[131];
+    uint8_t digest[BACNET_SHA256_DIGEST_SIZE];
+    BACNET_HMAC_SHA256 hmac;
+
+    bacnet_hmac_sha256_init(&hmac, (const uint8_t *)"Jefe", 4);
+    bacnet_hmac_sha256(
+        &hmac, (const uint8_t *)jefe_data, strlen(jefe_data), digest);
+    zassert_mem_equal(digest, jefe_digest, sizeof(digest), NULL);
+    /* the prepared key signs again */
+    memset(digest, 0, sizeof(digest));
+    bacnet_hmac_sha256(
+        &hmac, (const uint8_t *)jefe_data, strlen(jefe_data), digest);
+    zassert_mem_equal(digest, jefe_digest, sizeof(digest), NULL);
+    memset(large_key, 0xaa, sizeof(large_key));
+    bacnet_hmac_sha256_init(&hmac, large_key, sizeof(large_key));
+    bacnet_hmac_sha256(
+        &hmac, (const uint8_t *)large_data, strlen(large_data), digest);
+    zassert_mem_equal(digest, large_digest, sizeof(digest), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(sha256_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(sha256_tests, ztest_unit_test(testSHA256),
+        ztest_unit_test(testHMAC_SHA256));
+
+    ztest_run_test_suite(sha256_tests);
+}
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief test of the static pools of fixed size blocks
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/static_pool.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test taking and returning blocks, and the counters of the pools
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(static_pool_tests, testStaticPoolAlloc)
+#else
+static void testStaticPoolAlloc(void)
+#endif
+{
+    BACNET_STATIC_POOL_STATS stats = { 0 };
+    uint8_t *block[8] = { NULL };
+    uint8_t *data;
+    unsigned i;
+    bool status;
+
+    zassert_equal(static_pool_count(), 7, NULL);
+    zassert_true(static_pool_ram_size() >= ((4 * 32) + (2 * 64) + 128 + 1024),
+        NULL);
+    status = static_pool_stats(static_pool_count(), &stats);
+    zassert_false(status, NULL);
+    status = static_pool_stats(0, NULL);
+    zassert_false(status, NULL);
+    for (i = 0; i < 4; i++) {
+        block[i] = bacnet_malloc(20);
+        zassert_not_null(block[i], NULL);
+        memset(block[i], 0xA5, 20);
+    }
+    status = static_pool_stats(0, &stats);
+    zassert_true(status, NULL);
+    zassert_equal(stats.block_size, 32, NULL);
+    zassert_equal(stats.capacity, 4, NULL);
+    zassert_equal(stats.in_use, 4, NULL);
+    zassert_equal(stats.peak, 4, NULL);
+    /* an empty pool falls through to the pools of larger blocks */
+    block[4] = bacnet_malloc(20);
+    block[5] = bacnet_malloc(20);
+    block[6] = bacnet_malloc(20);
+    zassert_not_null(block[4], NULL);
+    zassert_not_null(block[5], NULL);
+    zassert_not_null(block[6], NULL);
+    static_pool_stats(1, &stats);
+    zassert_equal(stats.in_use, 2, NULL);
+    static_pool_stats(2, &stats);
+    zassert_equal(stats.in_use, 1, NULL);
+    /* the pool of 256 has no blocks, so this is from the pool of 1024 */
+    block[7] = bacnet_malloc(200);
+    zassert_not_null(block[7], NULL);
+    zassert_is_null(bacnet_malloc(200), NULL);
+    zassert_is_null(bacnet_malloc(20000), NULL);
+    static_pool_stats(3, &stats);
+    zassert_equal(stats.failures, 1, NULL);
+    static_pool_stats(6, &stats);
+    zassert_equal(stats.failures, 1, NULL);
+    /* a freed block is the next one taken */
+    bacnet_free(block[2]);
+    static_pool_stats(0, &stats);
+    zassert_equal(stats.in_use, 3, NULL);
+    zassert_equal(stats.peak, 4, NULL);
+    data = bacnet_calloc(4, 8);
+    zassert_equal(data, block[2], NULL);
+    for (i = 0; i < 32; i++) {
+        zassert_equal(data[i], 0, NULL);
+    }
+    zassert_is_null(bacnet_calloc(SIZE_MAX, 2), NULL);
+    for (i = 0; i < 8; i++) {
+        bacnet_free(block[i]);
+    }
+    bacnet_free(NULL);
+    for (i = 0; i < static_pool_count(); i++) {
+        static_pool_stats(i, &stats);
+        zassert_equal(stats.in_use, 0, NULL);
+    }
+}
+
+/**
+ * @brief Test resizing blocks
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(static_pool_tests, testStaticPoolRealloc)
+#else
+static void testStaticPoolRealloc(void)
+#endif
+{
+    BACNET_STATIC_POOL_STATS stats = { 0 };
+    uint8_t *data, *more;
+    unsigned i;
+
+    data = bacnet_realloc(NULL, 10);
+    zassert_not_null(data, NULL);
+    for (i = 0; i < 10; i++) {
+        data[i] = i;
+    }
+    /* the block is kept while it holds the size */
+    more = bacnet_realloc(data, 32);
+    zassert_equal(more, data, NULL);
+    /* and otherwise is copied to a larger block */
+    more = bacnet_realloc(data, 100);
+    zassert_not_null(more, NULL);
+    zassert_not_equal(more, data, NULL);
+    for (i = 0; i < 10; i++) {
+        zassert_equal(more[i], i, NULL);
+    }
+    static_pool_stats(0, &stats);
+    zassert_equal(stats.in_use, 0, NULL);
+    static_pool_stats(2, &stats);
+    zassert_equal(stats.in_use, 1, NULL);
+    /* the block is unchanged when there is no larger block */
+    data = bacnet_realloc(more, 5000);
+    zassert_is_null(data, NULL);
+    zassert_is_null(bacnet_realloc(&stats, 10), NULL);
+    zassert_is_null(bacnet_realloc(more, 0), NULL);
+    static_pool_stats(2, &stats);
+    zassert_equal(stats.in_use, 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(static_pool_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(static_pool_tests, ztest_unit_test(testStaticPoolAlloc),
+        ztest_unit_test(testStaticPoolRealloc));
+
+    ztest_run_test_suite(static_pool_tests);
+}
+#endif
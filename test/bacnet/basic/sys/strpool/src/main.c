@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @brief test of the pool of interned strings
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/strpool.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test that each distinct string is stored once, and that the
+ *  interned strings stay in place as the pool grows
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(strpool_tests, testStringPool)
+#else
+static void testStringPool(void)
+#endif
+{
+    const char *first = NULL;
+    const char *test_string = NULL;
+    const char *names[500] = { 0 };
+    char long_text[BACNET_STRPOOL_BLOCK_SIZE + 10];
+    char text[32];
+    unsigned i;
+
+    zassert_equal(strpool_count(), 0, NULL);
+    zassert_is_null(strpool_intern(NULL), NULL);
+    first = strpool_intern("Zone Temperature");
+    zassert_not_null(first, NULL);
+    zassert_true(strcmp(first, "Zone Temperature") == 0, NULL);
+    strcpy(text, "Zone Temperature");
+    zassert_equal_ptr(strpool_intern(text), first, NULL);
+    zassert_equal(strpool_count(), 1, NULL);
+    /* a prefix is a different string */
+    test_string = strpool_intern_length("Zone Temperature", 4);
+    zassert_true(strcmp(test_string, "Zone") == 0, NULL);
+    zassert_not_equal(test_string, first, NULL);
+    zassert_equal_ptr(strpool_intern("Zone"), test_string, NULL);
+    zassert_equal(strpool_count(), 2, NULL);
+    test_string = strpool_intern("");
+    zassert_not_null(test_string, NULL);
+    zassert_equal(test_string[0], 0, NULL);
+    /* grow the table and the blocks */
+    for (i = 0; i < 500; i++) {
+        snprintf(text, sizeof(text), "ANALOG VALUE %u", i);
+        names[i] = strpool_intern(text);
+        zassert_not_null(names[i], NULL);
+    }
+    zassert_equal(strpool_count(), 503, NULL);
+    memset(long_text, 'x', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = 0;
+    test_string = strpool_intern(long_text);
+    zassert_not_null(test_string, NULL);
+    zassert_equal(strlen(test_string), sizeof(long_text) - 1, NULL);
+    for (i = 0; i < 500; i++) {
+        snprintf(text, sizeof(text), "ANALOG VALUE %u", i);
+        zassert_equal_ptr(strpool_intern(text), names[i], NULL);
+        zassert_true(strcmp(names[i], text) == 0, NULL);
+    }
+    zassert_equal_ptr(strpool_intern("Zone Temperature"), first, NULL);
+    zassert_equal(strpool_count(), 504, NULL);
+    zassert_true(strpool_ram_size() > sizeof(long_text), NULL);
+    strpool_cleanup();
+    zassert_equal(strpool_count(), 0, NULL);
+    zassert_equal(strpool_ram_size(), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(strpool_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(strpool_tests, ztest_unit_test(testStringPool));
+
+    ztest_run_test_suite(strpool_tests);
+}
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief test of the hierarchical timer wheel
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/basic/sys/timer_wheel.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* clock of the test */
+static unsigned long Milliseconds;
+
+unsigned long mstimer_now(void)
+{
+    return Milliseconds;
+}
+
+/* a timer of the test, with the milliseconds when it expired */
+struct test_timer {
+    struct timer_wheel_timer timer;
+    unsigned count;
+    unsigned long expired;
+    bool stop;
+};
+
+static void test_callback(void *context)
+{
+    struct test_timer *test = context;
+
+    test->count++;
+    test->expired = Milliseconds;
+    if (test->stop) {
+        timer_wheel_stop(&test->timer);
+    }
+}
+
+/**
+ * @brief Advance the clock of the test one millisecond at a time
+ * @param milliseconds - number of milliseconds
+ * @return number of timers that expired
+ */
+static unsigned test_advance(unsigned long milliseconds)
+{
+    unsigned expired = 0;
+
+    while (milliseconds) {
+        Milliseconds++;
+        milliseconds--;
+        expired += timer_wheel_task();
+    }
+
+    return expired;
+}
+
+/**
+ * @brief Test one-shot timers at each level of the wheel
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(timer_wheel_tests, testTimerWheelOneShot)
+#else
+static void testTimerWheelOneShot(void)
+#endif
+{
+    static const uint32_t delays[] = { 0, 1, 2, 63, 64, 65, 100, 4095, 4096,
+        4097, 70000, 262144, 300001, (1UL << 24) + 5 };
+    struct test_timer test[sizeof(delays) / sizeof(delays[0])];
+    unsigned i, count;
+    uint32_t next;
+
+    for (count = 0; count < 3; count++) {
+        /* start at a different phase of the wheel each time */
+        Milliseconds = 12345 + (count * 7777);
+        timer_wheel_init();
+        memset(test, 0, sizeof(test));
+        for (i = 0; i < (sizeof(delays) / sizeof(delays[0])); i++) {
+            timer_wheel_set(
+                &test[i].timer, test_callback, &test[i], delays[i], 0);
+            zassert_true(timer_wheel_active(&test[i].timer), NULL);
+        }
+        zassert_equal(timer_wheel_count(), i, NULL);
+        zassert_equal(timer_wheel_next(), 0, NULL);
+        zassert_equal(timer_wheel_task(), 1, NULL);
+        /* sleep until each next deadline, as an application loop would */
+        while (timer_wheel_count()) {
+            next = timer_wheel_next();
+            zassert_not_equal(next, TIMER_WHEEL_IDLE, NULL);
+            Milliseconds += next;
+            timer_wheel_task();
+        }
+        for (i = 0; i < (sizeof(delays) / sizeof(delays[0])); i++) {
+            zassert_equal(test[i].count, 1, "delay=%lu",
+                (unsigned long)delays[i]);
+            zassert_equal(test[i].expired,
+                12345 + (count * 7777) + delays[i], "delay=%lu",
+                (unsigned long)delays[i]);
+            zassert_false(timer_wheel_active(&test[i].timer), NULL);
+        }
+        zassert_equal(timer_wheel_next(), TIMER_WHEEL_IDLE, NULL);
+    }
+}
+
+/**
+ * @brief Test repeating timers, and stopping a timer from its callback
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(timer_wheel_tests, testTimerWheelRepeat)
+#else
+static void testTimerWheelRepeat(void)
+#endif
+{
+    struct test_timer fast = { 0 }, slow = { 0 }, once = { 0 };
+
+    Milliseconds = UINT32_MAX - 500;
+    timer_wheel_init();
+    timer_wheel_set(&fast.timer, test_callback, &fast, 50, 50);
+    timer_wheel_set(&slow.timer, test_callback, &slow, 1000, 1000);
+    timer_wheel_set(&once.timer, test_callback, &once, 10, 0);
+    zassert_equal(timer_wheel_next(), 10, NULL);
+    /* across the wrap of the clock */
+    zassert_equal(test_advance(2000), 40 + 2 + 1, NULL);
+    zassert_equal(fast.count, 40, NULL);
+    zassert_equal(slow.count, 2, NULL);
+    zassert_equal(once.count, 1, NULL);
+    zassert_equal(timer_wheel_count(), 2, NULL);
+    /* a late task catches up with the missed deadlines */
+    Milliseconds += 500;
+    zassert_equal(timer_wheel_task(), 10, NULL);
+    zassert_equal(fast.count, 50, NULL);
+    /* a timer is set again or stopped, also from a callback */
+    timer_wheel_set(&slow.timer, test_callback, &slow, 5, 0);
+    zassert_equal(timer_wheel_count(), 2, NULL);
+    fast.stop = true;
+    zassert_equal(test_advance(50), 2, NULL);
+    zassert_false(timer_wheel_active(&fast.timer), NULL);
+    zassert_false(timer_wheel_active(&slow.timer), NULL);
+    zassert_equal(timer_wheel_count(), 0, NULL);
+    zassert_false(timer_wheel_stop(&fast.timer), NULL);
+    zassert_false(timer_wheel_stop(NULL), NULL);
+    /* idle for a long time */
+    Milliseconds += 1000000;
+    zassert_equal(timer_wheel_task(), 0, NULL);
+    timer_wheel_set(&once.timer, test_callback, &once, 1, 0);
+    zassert_equal(timer_wheel_next(), 1, NULL);
+    zassert_equal(test_advance(1), 1, NULL);
+    zassert_equal(once.count, 2, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(timer_wheel_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(timer_wheel_tests,
+        ztest_unit_test(testTimerWheelOneShot),
+        ztest_unit_test(testTimerWheelRepeat));
+
+    ztest_run_test_suite(timer_wheel_tests);
+}
+#endif
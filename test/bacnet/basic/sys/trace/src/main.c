@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief test of the trace ring of the tracepoints
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/trace.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* clock of the test */
+static uint32_t Test_Clock;
+
+static uint32_t test_clock(void)
+{
+    return Test_Clock;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(trace_tests, test_trace_ring)
+#else
+static void test_trace_ring(void)
+#endif
+{
+    BACNET_TRACE_RECORD record = { 0 };
+    unsigned i;
+
+    bacnet_trace_clear();
+    zassert_equal(bacnet_trace_count(), 0, NULL);
+    zassert_false(bacnet_trace_record(0, &record), NULL);
+    bacnet_trace_clock_set(test_clock);
+    Test_Clock = 1000;
+    BACNET_TRACE(NPDU_RX, 5, 100);
+    Test_Clock = 1001;
+    BACNET_TRACE(TSM_STATE, 3, 2);
+    zassert_equal(bacnet_trace_count(), 2, NULL);
+    zassert_true(bacnet_trace_record(0, &record), NULL);
+    zassert_equal(record.event, BACNET_TRACE_NPDU_RX, NULL);
+    zassert_equal(record.sequence, 0, NULL);
+    zassert_equal(record.timestamp, 1000, NULL);
+    zassert_equal(record.arg1, 5, NULL);
+    zassert_equal(record.arg2, 100, NULL);
+    zassert_true(bacnet_trace_record(1, &record), NULL);
+    zassert_equal(record.event, BACNET_TRACE_TSM_STATE, NULL);
+    zassert_equal(record.timestamp, 1001, NULL);
+    zassert_false(bacnet_trace_record(2, &record), NULL);
+    zassert_false(bacnet_trace_record(0, NULL), NULL);
+    /* the oldest records are overwritten */
+    bacnet_trace_clock_set(NULL);
+    for (i = 0; i < 10; i++) {
+        BACNET_TRACE(APDU_RX, i, 0);
+    }
+    zassert_equal(bacnet_trace_count(), 8, NULL);
+    zassert_true(bacnet_trace_record(0, &record), NULL);
+    zassert_equal(record.sequence, 4, NULL);
+    zassert_equal(record.event, BACNET_TRACE_APDU_RX, NULL);
+    zassert_equal(record.arg1, 2, NULL);
+    zassert_equal(record.timestamp, 0, NULL);
+    zassert_true(bacnet_trace_record(7, &record), NULL);
+    zassert_equal(record.sequence, 11, NULL);
+    zassert_equal(record.arg1, 9, NULL);
+    bacnet_trace_clear();
+    zassert_equal(bacnet_trace_count(), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(trace_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(trace_tests, ztest_unit_test(test_trace_ring));
+
+    ztest_run_test_suite(trace_tests);
+}
+#endif
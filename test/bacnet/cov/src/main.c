@@ -173,6 +173,9 @@ static void testCOVNotifyData(BACNET_COV_DATA *data, BACNET_COV_DATA *test_data)
 static void testUCOVNotifyData(BACNET_COV_DATA *data)
 {
     uint8_t apdu[480] = { 0 };
+    uint8_t test_apdu[480] = { 0 };
+    uint8_t value_list_apdu[480] = { 0 };
+    int value_list_len = 0;
     int len = 0, null_len = 0, apdu_len = 0;
     BACNET_COV_DATA test_data = { 0 };
     BACNET_PROPERTY_VALUE value_list[5] = { { 0 } };
@@ -182,6 +185,19 @@ static void testUCOVNotifyData(BACNET_COV_DATA *data)
     zassert_true(len > 0, NULL);
     zassert_equal(len, null_len, NULL);
     apdu_len = len;
+    /* the same notification, from an encoded list of values */
+    value_list_len = cov_notify_value_list_encode(NULL, data->listOfValues);
+    zassert_true(value_list_len <= sizeof(value_list_apdu), NULL);
+    len = cov_notify_value_list_encode(
+        &value_list_apdu[0], data->listOfValues);
+    zassert_equal(len, value_list_len, NULL);
+    len = ucov_notify_values_encode_apdu(&test_apdu[0], sizeof(test_apdu),
+        data, &value_list_apdu[0], value_list_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_equal(memcmp(&apdu[0], &test_apdu[0], apdu_len), 0, NULL);
+    len = ucov_notify_values_encode_apdu(&test_apdu[0], apdu_len - 1,
+        data, &value_list_apdu[0], value_list_len);
+    zassert_equal(len, 0, NULL);
 
     cov_data_value_list_link(
         &test_data, &value_list[0], ARRAY_SIZE(value_list));
@@ -193,6 +209,9 @@ static void testUCOVNotifyData(BACNET_COV_DATA *data)
 static void testCCOVNotifyData(uint8_t invoke_id, BACNET_COV_DATA *data)
 {
     uint8_t apdu[480] = { 0 };
+    uint8_t test_apdu[480] = { 0 };
+    uint8_t value_list_apdu[480] = { 0 };
+    int value_list_len = 0;
     int len = 0, null_len = 0, apdu_len = 0;
     BACNET_COV_DATA test_data = { 0 };
     BACNET_PROPERTY_VALUE value_list[2] = { { 0 } };
@@ -203,6 +222,13 @@ static void testCCOVNotifyData(uint8_t invoke_id, BACNET_COV_DATA *data)
     zassert_not_equal(len, 0, NULL);
     zassert_equal(len, null_len, NULL);
     apdu_len = len;
+    /* the same notification, from an encoded list of values */
+    value_list_len = cov_notify_value_list_encode(
+        &value_list_apdu[0], data->listOfValues);
+    len = ccov_notify_values_encode_apdu(&test_apdu[0], sizeof(test_apdu),
+        invoke_id, data, &value_list_apdu[0], value_list_len);
+    zassert_equal(len, apdu_len, NULL);
+    zassert_equal(memcmp(&apdu[0], &test_apdu[0], apdu_len), 0, NULL);
 
     cov_data_value_list_link(&test_data, &value_list[0], 2);
     len = ccov_notify_decode_apdu(
@@ -212,6 +238,116 @@ static void testCCOVNotifyData(uint8_t invoke_id, BACNET_COV_DATA *data)
     testCOVNotifyData(data, &test_data);
 }
 
+static void testCOVNotifyArenaData(BACNET_COV_DATA *data)
+{
+    uint8_t apdu[480] = { 0 };
+    int len = 0, apdu_len = 0;
+    BACNET_COV_DATA test_data = { 0 };
+    BACNET_PROPERTY_VALUE value_list[1] = { { 0 } };
+    BACNET_PROPERTY_VALUE buffer[4] = { { 0 } };
+    ARENA_BUFFER arena = { 0 };
+
+    apdu_len = ucov_notify_encode_apdu(&apdu[0], sizeof(apdu), data);
+    zassert_true(apdu_len > 2, NULL);
+    /* the second value comes from the arena */
+    arena_init(&arena, buffer, sizeof(buffer));
+    cov_data_value_list_link(
+        &test_data, &value_list[0], ARRAY_SIZE(value_list));
+    len = cov_notify_decode_service_request_arena(
+        &apdu[2], apdu_len - 2, &test_data, &arena);
+    zassert_equal(len, apdu_len - 2, NULL);
+    zassert_equal(arena_count(&arena), sizeof(BACNET_PROPERTY_VALUE), NULL);
+    testCOVNotifyData(data, &test_data);
+    /* all of the values come from the arena */
+    arena_reset(&arena);
+    test_data.listOfValues = NULL;
+    len = cov_notify_decode_service_request_arena(
+        &apdu[2], apdu_len - 2, &test_data, &arena);
+    zassert_equal(len, apdu_len - 2, NULL);
+    zassert_not_null(test_data.listOfValues, NULL);
+    zassert_equal(
+        arena_count(&arena), 2 * sizeof(BACNET_PROPERTY_VALUE), NULL);
+    testCOVNotifyData(data, &test_data);
+    /* the values do not fit in the arena */
+    arena_init(&arena, buffer, sizeof(BACNET_PROPERTY_VALUE));
+    test_data.listOfValues = NULL;
+    len = cov_notify_decode_service_request_arena(
+        &apdu[2], apdu_len - 2, &test_data, &arena);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    zassert_true(arena_overflow(&arena), NULL);
+    len = cov_notify_decode_service_request_arena(
+        &apdu[2], apdu_len - 2, &test_data, NULL);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+}
+
+static void testCOVNotifyMultipleData(bool confirmed, BACNET_COV_DATA *data)
+{
+    uint8_t apdu[480] = { 0 };
+    uint8_t value_list_apdu[480] = { 0 };
+    int value_list_len = 0;
+    int len = 0, null_len = 0, apdu_len = 0, header_len = 0;
+    BACNET_COV_DATA test_data[3] = { 0 };
+    BACNET_PROPERTY_VALUE value_list[3][2] = { { { 0 } } };
+    BACNET_OBJECT_ID object_id = data->monitoredObjectIdentifier;
+    unsigned i;
+
+    value_list_len = cov_notify_value_list_encode(
+        &value_list_apdu[0], data->listOfValues);
+    null_len = cov_notify_multiple_header_encode(NULL, confirmed, 1, data);
+    len = cov_notify_multiple_header_encode(&apdu[0], confirmed, 1, data);
+    zassert_equal(len, null_len, NULL);
+    if (confirmed) {
+        zassert_equal(apdu[0], PDU_TYPE_CONFIRMED_SERVICE_REQUEST, NULL);
+        zassert_equal(apdu[3], SERVICE_CONFIRMED_COV_NOTIFICATION_MULTIPLE,
+            NULL);
+        header_len = 4;
+    } else {
+        zassert_equal(apdu[0], PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST, NULL);
+        zassert_equal(apdu[1], SERVICE_UNCONFIRMED_COV_NOTIFICATION_MULTIPLE,
+            NULL);
+        header_len = 2;
+    }
+    apdu_len = len;
+    /* the same values for two objects */
+    for (i = 0; i < 2; i++) {
+        object_id.instance = data->monitoredObjectIdentifier.instance + i;
+        null_len = cov_notify_multiple_object_encode(
+            NULL, &object_id, &value_list_apdu[0], value_list_len);
+        len = cov_notify_multiple_object_encode(&apdu[apdu_len], &object_id,
+            &value_list_apdu[0], value_list_len);
+        zassert_true(len > 0, NULL);
+        zassert_equal(len, null_len, NULL);
+        apdu_len += len;
+    }
+    apdu_len += cov_notify_multiple_end_encode(&apdu[apdu_len]);
+    for (i = 0; i < ARRAY_SIZE(test_data); i++) {
+        cov_data_value_list_link(&test_data[i], &value_list[i][0], 2);
+    }
+    len = cov_notify_multiple_decode_service_request(&apdu[header_len],
+        apdu_len - header_len, &test_data[0], ARRAY_SIZE(test_data));
+    zassert_equal(len, 2, NULL);
+    for (i = 0; i < 2; i++) {
+        object_id.instance = data->monitoredObjectIdentifier.instance + i;
+        zassert_equal(test_data[i].monitoredObjectIdentifier.instance,
+            object_id.instance, NULL);
+        test_data[i].monitoredObjectIdentifier =
+            data->monitoredObjectIdentifier;
+        testCOVNotifyData(data, &test_data[i]);
+    }
+    /* not enough data for the notifications */
+    len = cov_notify_multiple_decode_service_request(
+        &apdu[header_len], apdu_len - header_len, &test_data[0], 1);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    /* truncated */
+    len = cov_notify_multiple_decode_service_request(&apdu[header_len],
+        apdu_len - header_len - 1, &test_data[0], ARRAY_SIZE(test_data));
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    /* not an encoded listOfValues */
+    len = cov_notify_multiple_object_encode(
+        NULL, &object_id, &value_list_apdu[1], value_list_len - 1);
+    zassert_equal(len, 0, NULL);
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(cov_tests, testCOVNotify)
 #else
@@ -244,6 +380,9 @@ static void testCOVNotify(void)
 
     testUCOVNotifyData(&data);
     testCCOVNotifyData(invoke_id, &data);
+    testCOVNotifyArenaData(&data);
+    testCOVNotifyMultipleData(false, &data);
+    testCOVNotifyMultipleData(true, &data);
 }
 
 static void testCOVSubscribeData(
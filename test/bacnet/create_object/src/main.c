@@ -48,6 +48,79 @@ static void test_CreateObject(void)
     test_CreateObjectCodec(&data);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(create_object_tests, test_CreateObjectInitialValues)
+#else
+static void test_CreateObjectInitialValues(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_CREATE_OBJECT_DATA data = { 0 }, test_data = { 0 };
+    BACNET_PROPERTY_VALUE values[3] = { 0 }, test_values[2] = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    int len = 0, apdu_len = 0, test_len = 0, value_len = 0;
+
+    bacapp_property_value_list_init(values, 3);
+    values[0].propertyIdentifier = PROP_PRESENT_VALUE;
+    values[0].value.tag = BACNET_APPLICATION_TAG_REAL;
+    values[0].value.type.Real = 1.0f;
+    values[0].priority = 8;
+    values[1].propertyIdentifier = PROP_DESCRIPTION;
+    values[1].value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(&values[1].value.type.Character_String, "x");
+    values[2].propertyIdentifier = PROP_PRIORITY_ARRAY;
+    values[2].propertyArrayIndex = 3;
+    values[2].value.tag = BACNET_APPLICATION_TAG_NULL;
+    data.object_type = OBJECT_ANALOG_VALUE;
+    data.object_instance = 1;
+    data.list_of_initial_values = &values[0];
+    apdu_len = create_object_encode_service_request(apdu, &data);
+    zassert_true(apdu_len > 0, NULL);
+    /* all of the values are kept encoded */
+    test_len = create_object_decode_service_request(apdu, apdu_len, &test_data);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_not_null(test_data.application_data, NULL);
+    len = create_object_initial_value_decode(test_data.application_data,
+        test_data.application_data_len, &wp_data);
+    zassert_true(len > 0, NULL);
+    zassert_equal(wp_data.object_property, PROP_PRESENT_VALUE, NULL);
+    zassert_equal(wp_data.array_index, BACNET_ARRAY_ALL, NULL);
+    zassert_equal(wp_data.priority, 8, NULL);
+    zassert_equal(wp_data.application_data_len, 5, NULL);
+    value_len += len;
+    len = create_object_initial_value_decode(
+        &test_data.application_data[value_len],
+        test_data.application_data_len - value_len, &wp_data);
+    zassert_true(len > 0, NULL);
+    zassert_equal(wp_data.object_property, PROP_DESCRIPTION, NULL);
+    zassert_equal(wp_data.priority, BACNET_MAX_PRIORITY, NULL);
+    value_len += len;
+    len = create_object_initial_value_decode(
+        &test_data.application_data[value_len],
+        test_data.application_data_len - value_len, &wp_data);
+    zassert_true(len > 0, NULL);
+    zassert_equal(wp_data.object_property, PROP_PRIORITY_ARRAY, NULL);
+    zassert_equal(wp_data.array_index, 3, NULL);
+    zassert_equal(wp_data.application_data_len, 1, NULL);
+    value_len += len;
+    zassert_equal(value_len, test_data.application_data_len, NULL);
+    len = create_object_initial_value_decode(
+        test_data.application_data, 3, &wp_data);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    /* the values are decoded while the list has room */
+    bacapp_property_value_list_init(test_values, 2);
+    memset(&test_data, 0, sizeof(test_data));
+    test_data.list_of_initial_values = &test_values[0];
+    test_len = create_object_decode_service_request(apdu, apdu_len, &test_data);
+    zassert_equal(apdu_len, test_len, NULL);
+    zassert_equal(test_values[0].propertyIdentifier, PROP_PRESENT_VALUE, NULL);
+    zassert_equal(test_values[1].propertyIdentifier, PROP_DESCRIPTION, NULL);
+    /* a list that is not closed */
+    test_len =
+        create_object_decode_service_request(apdu, apdu_len - 1, &test_data);
+    zassert_equal(test_len, BACNET_STATUS_REJECT, NULL);
+}
+
 static void test_CreateObjectAckCodec(BACNET_CREATE_OBJECT_DATA *data)
 {
     uint8_t apdu[MAX_APDU] = { 0 };
@@ -135,6 +208,7 @@ void test_main(void)
 {
     ztest_test_suite(
         create_object_tests, ztest_unit_test(test_CreateObject),
+        ztest_unit_test(test_CreateObjectInitialValues),
         ztest_unit_test(test_CreateObjectACK),
         ztest_unit_test(test_CreateObjectError));
 
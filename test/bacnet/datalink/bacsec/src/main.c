@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief test of the signature of the BACnet security wrapper
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/datalink/bacsec.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static void test_key_init(BACNET_KEY_ENTRY *key, uint8_t seed)
+{
+    unsigned i;
+
+    key->key_identifier = (KIA_AES_SHA256 << 8) | KIKN_DEVICE_MASTER;
+    key->key_len = AES_KEY_SIZE + SHA256_KEY_SIZE;
+    for (i = 0; i < key->key_len; i++) {
+        key->key[i] = (uint8_t)(seed + i);
+    }
+}
+
+/**
+ * @brief Test that a message signed in place is verified, and only when
+ *  the message, signature and key are the same
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacsec_tests, testSecuritySign)
+#else
+static void testSecuritySign(void)
+#endif
+{
+    BACNET_KEY_ENTRY key = { 0 };
+    BACNET_KEY_ENTRY other_key = { 0 };
+    uint8_t pdu[64] = { 0 };
+    uint8_t signature[SIGNATURE_LEN];
+    int len;
+    unsigned i;
+
+    bacnet_security_sessions_clear();
+    test_key_init(&key, 1);
+    for (i = 0; i < 40; i++) {
+        pdu[i] = (uint8_t)i;
+    }
+    len = bacnet_security_sign(1234, &key, pdu, 40, sizeof(pdu));
+    zassert_equal(len, 40 + SIGNATURE_LEN, NULL);
+    zassert_true(bacnet_security_verify(1234, &key, pdu, len), NULL);
+    /* the same signature with the prepared key of another peer */
+    memcpy(signature, &pdu[40], sizeof(signature));
+    len = bacnet_security_sign(5678, &key, pdu, 40, sizeof(pdu));
+    zassert_mem_equal(signature, &pdu[40], sizeof(signature), NULL);
+    zassert_true(bacnet_security_verify(5678, &key, pdu, len), NULL);
+    /* a changed message or signature */
+    pdu[3] ^= 0x01;
+    zassert_false(bacnet_security_verify(1234, &key, pdu, len), NULL);
+    pdu[3] ^= 0x01;
+    pdu[len - 1] ^= 0x80;
+    zassert_false(bacnet_security_verify(1234, &key, pdu, len), NULL);
+    pdu[len - 1] ^= 0x80;
+    /* a key updated with the same identifier */
+    test_key_init(&other_key, 2);
+    zassert_false(bacnet_security_verify(1234, &other_key, pdu, len), NULL);
+    zassert_true(bacnet_security_verify(1234, &key, pdu, len), NULL);
+    /* the signature does not fit, or the key is not supported */
+    zassert_equal(bacnet_security_sign(1234, &key, pdu, 60, sizeof(pdu)), 0,
+        NULL);
+    other_key.key_identifier = (KIA_AES_MD5 << 8) | KIKN_DEVICE_MASTER;
+    zassert_equal(
+        bacnet_security_sign(1234, &other_key, pdu, 40, sizeof(pdu)), 0, NULL);
+    zassert_false(bacnet_security_verify(1234, &key, pdu, 8), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bacsec_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bacsec_tests, ztest_unit_test(testSecuritySign));
+
+    ztest_run_test_suite(bacsec_tests);
+}
+#endif
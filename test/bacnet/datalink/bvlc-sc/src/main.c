@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @brief test of the BACnet/SC virtual link control messages
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/datalink/bvlc-sc.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test the encode and decode of the BVLC-SC messages
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bvlc_sc_tests, testBVLC_SC_Messages)
+#else
+static void testBVLC_SC_Messages(void)
+#endif
+{
+    const uint8_t origin[BVLC_SC_VMAC_SIZE] = { 1, 2, 3, 4, 5, 6 };
+    const uint8_t destination[BVLC_SC_VMAC_SIZE] = { 6, 5, 4, 3, 2, 1 };
+    uint8_t uuid[BVLC_SC_UUID_SIZE] = { 0 };
+    uint8_t test_vmac[BVLC_SC_VMAC_SIZE] = { 0 };
+    uint8_t test_uuid[BVLC_SC_UUID_SIZE] = { 0 };
+    const uint8_t npdu[] = { 0x01, 0x00, 0x10, 0x08 };
+    uint8_t pdu[64] = { 0 };
+    BVLC_SC_MESSAGE message = { 0 };
+    uint16_t max_bvlc_len = 0;
+    uint16_t max_npdu_len = 0;
+    uint16_t error_class = 0;
+    uint16_t error_code = 0;
+    uint8_t function = 0;
+    bool nak = false;
+    int len = 0;
+
+    len = bvlc_sc_encode_encapsulated_npdu(
+        pdu, sizeof(pdu), 0x1234, origin, destination, npdu, sizeof(npdu));
+    zassert_equal(len, 4 + 6 + 6 + sizeof(npdu), NULL);
+    zassert_equal(bvlc_sc_decode_message(pdu, len, &message), 16, NULL);
+    zassert_equal(message.function, BVLC_SC_ENCAPSULATED_NPDU, NULL);
+    zassert_equal(message.message_id, 0x1234, NULL);
+    zassert_true(message.originating_present, NULL);
+    zassert_mem_equal(message.originating_vmac, origin, 6, NULL);
+    zassert_true(message.destination_present, NULL);
+    zassert_mem_equal(message.destination_vmac, destination, 6, NULL);
+    zassert_equal(message.payload_len, sizeof(npdu), NULL);
+    zassert_mem_equal(message.payload, npdu, sizeof(npdu), NULL);
+    /* truncated addresses */
+    zassert_equal(bvlc_sc_decode_message(pdu, 12, &message), 0, NULL);
+    /* too small a buffer */
+    zassert_equal(bvlc_sc_encode_encapsulated_npdu(
+                      pdu, 16, 1, origin, destination, npdu, sizeof(npdu)),
+        0, NULL);
+    /* header options: one with data, then one without */
+    pdu[0] = BVLC_SC_ENCAPSULATED_NPDU;
+    pdu[1] = BVLC_SC_CONTROL_DESTINATION_OPTIONS;
+    pdu[2] = 0x00;
+    pdu[3] = 0x09;
+    pdu[4] = BVLC_SC_OPTION_MORE | BVLC_SC_OPTION_HEADER_DATA | 0x01;
+    pdu[5] = 0x00;
+    pdu[6] = 0x02;
+    pdu[7] = 0xAB;
+    pdu[8] = 0xCD;
+    pdu[9] = 0x02;
+    memcpy(&pdu[10], npdu, sizeof(npdu));
+    zassert_equal(bvlc_sc_decode_message(pdu, 14, &message), 10, NULL);
+    zassert_equal(message.destination_options_len, 6, NULL);
+    zassert_equal(message.payload_len, sizeof(npdu), NULL);
+    /* the option data does not fit */
+    zassert_equal(bvlc_sc_decode_message(pdu, 8, &message), 0, NULL);
+    memset(uuid, 0x5A, sizeof(uuid));
+    len = bvlc_sc_encode_connect(pdu, sizeof(pdu), BVLC_SC_CONNECT_REQUEST,
+        7, origin, uuid, 1600, 1497);
+    zassert_equal(len, 4 + 6 + 16 + 4, NULL);
+    zassert_equal(bvlc_sc_decode_message(pdu, len, &message), 4, NULL);
+    zassert_equal(message.function, BVLC_SC_CONNECT_REQUEST, NULL);
+    zassert_equal(bvlc_sc_decode_connect(message.payload,
+                      message.payload_len, test_vmac, test_uuid,
+                      &max_bvlc_len, &max_npdu_len),
+        26, NULL);
+    zassert_mem_equal(test_vmac, origin, sizeof(test_vmac), NULL);
+    zassert_mem_equal(test_uuid, uuid, sizeof(test_uuid), NULL);
+    zassert_equal(max_bvlc_len, 1600, NULL);
+    zassert_equal(max_npdu_len, 1497, NULL);
+    len = bvlc_sc_encode_control(
+        pdu, sizeof(pdu), BVLC_SC_HEARTBEAT_REQUEST, 8);
+    zassert_equal(len, 4, NULL);
+    len = bvlc_sc_encode_result(pdu, sizeof(pdu), 7, destination,
+        BVLC_SC_CONNECT_REQUEST, true, 7, 9);
+    zassert_equal(bvlc_sc_decode_message(pdu, len, &message), 10, NULL);
+    zassert_equal(bvlc_sc_decode_result(message.payload, message.payload_len,
+                      &function, &nak, &error_class, &error_code),
+        7, NULL);
+    zassert_equal(function, BVLC_SC_CONNECT_REQUEST, NULL);
+    zassert_true(nak, NULL);
+    zassert_equal(error_class, 7, NULL);
+    zassert_equal(error_code, 9, NULL);
+}
+
+/**
+ * @brief Test that the messages of a batch are framed, masked, and that
+ *  a full batch is reported
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bvlc_sc_tests, testBVLC_SC_Batch)
+#else
+static void testBVLC_SC_Batch(void)
+#endif
+{
+    const uint8_t mask[4] = { 0x11, 0x22, 0x33, 0x44 };
+    uint8_t pdu[200] = { 0 };
+    uint8_t buffer[256] = { 0 };
+    BVLC_SC_BATCH batch = { 0 };
+    unsigned i = 0;
+
+    for (i = 0; i < sizeof(pdu); i++) {
+        pdu[i] = (uint8_t)i;
+    }
+    bvlc_sc_batch_init(&batch, buffer, sizeof(buffer));
+    zassert_true(bvlc_sc_batch_add(&batch, pdu, 4, NULL), NULL);
+    zassert_equal(batch.length, 2 + 4, NULL);
+    zassert_equal(buffer[0], 0x82, NULL);
+    zassert_equal(buffer[1], 4, NULL);
+    zassert_mem_equal(&buffer[2], pdu, 4, NULL);
+    zassert_true(bvlc_sc_batch_add(&batch, pdu, 4, mask), NULL);
+    zassert_equal(buffer[7], 0x80 | 4, NULL);
+    zassert_mem_equal(&buffer[8], mask, 4, NULL);
+    for (i = 0; i < 4; i++) {
+        zassert_equal(buffer[12 + i], pdu[i] ^ mask[i], NULL);
+    }
+    zassert_true(bvlc_sc_batch_add(&batch, pdu, 200, mask), NULL);
+    zassert_equal(buffer[17], 0x80 | 126, NULL);
+    zassert_equal(buffer[18], 0, NULL);
+    zassert_equal(buffer[19], 200, NULL);
+    zassert_equal(batch.count, 3, NULL);
+    zassert_equal(batch.length, 6 + 10 + 8 + 200, NULL);
+    /* full */
+    zassert_false(bvlc_sc_batch_add(&batch, pdu, 40, NULL), NULL);
+    bvlc_sc_batch_clear(&batch);
+    zassert_equal(batch.length, 0, NULL);
+    zassert_true(bvlc_sc_batch_add(&batch, pdu, 40, NULL), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bvlc_sc_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bvlc_sc_tests, ztest_unit_test(testBVLC_SC_Messages),
+        ztest_unit_test(testBVLC_SC_Batch));
+
+    ztest_run_test_suite(bvlc_sc_tests);
+}
+#endif
@@ -10,7 +10,9 @@
 
 #include <zephyr/ztest.h>
 #include <stdlib.h>
+#include <string.h>
 #include <bacnet/datalink/cobs.h>
+#include <bacnet/datalink/mstpdef.h>
 #include <bacnet/basic/sys/bytes.h>
 
 /**
@@ -52,6 +54,146 @@ static void test_COBS_Encode_Decode(void)
     zassert_true(
         test_buffer_length == sizeof(buffer), "COBS encode/decode length fail");
 }
+
+/**
+ * @brief Test the block CRC-32K against the octet at a time CRC-32K
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, test_COBS_CRC32K_Buffer)
+#else
+static void test_COBS_CRC32K_Buffer(void)
+#endif
+{
+    uint8_t buffer[300] = { 0 };
+    uint32_t crc32K, crc32K_buffer;
+    unsigned i;
+
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)((i * 7) + 3);
+    }
+    crc32K = CRC32K_INITIAL_VALUE;
+    for (i = 0; i < sizeof(buffer); i++) {
+        crc32K = cobs_crc32k(buffer[i], crc32K);
+    }
+    crc32K_buffer =
+        cobs_crc32k_buffer(buffer, sizeof(buffer), CRC32K_INITIAL_VALUE);
+    zassert_equal(crc32K, crc32K_buffer, NULL);
+    /* accumulating in pieces gives the same result */
+    crc32K_buffer = cobs_crc32k_buffer(buffer, 5, CRC32K_INITIAL_VALUE);
+    crc32K_buffer =
+        cobs_crc32k_buffer(&buffer[5], sizeof(buffer) - 5, crc32K_buffer);
+    zassert_equal(crc32K, crc32K_buffer, NULL);
+    crc32K_buffer = cobs_crc32k_buffer(buffer, 0, CRC32K_INITIAL_VALUE);
+    zassert_equal(crc32K_buffer, CRC32K_INITIAL_VALUE, NULL);
+}
+
+/**
+ * @brief Test the COBS code blocks at the 254 octet run boundaries
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, test_COBS_Encode_Runs)
+#else
+static void test_COBS_Encode_Runs(void)
+#endif
+{
+    uint8_t buffer[600] = { 0 };
+    uint8_t encoded_buffer[COBS_ENCODED_SIZE(600) + 1] = { 0 };
+    uint8_t test_buffer[600] = { 0 };
+    size_t encoded_len, test_len, length;
+    unsigned i;
+
+    /* a single zero is two empty blocks */
+    encoded_len = cobs_encode(
+        encoded_buffer, sizeof(encoded_buffer), buffer, 1, 0);
+    zassert_equal(encoded_len, 2, NULL);
+    zassert_equal(encoded_buffer[0], 1, NULL);
+    zassert_equal(encoded_buffer[1], 1, NULL);
+    /* exactly 254 non-zero octets need no trailing block */
+    memset(buffer, 0xAA, sizeof(buffer));
+    encoded_len = cobs_encode(
+        encoded_buffer, sizeof(encoded_buffer), buffer, 254, 0);
+    zassert_equal(encoded_len, 255, NULL);
+    zassert_equal(encoded_buffer[0], 255, NULL);
+    /* the encoded data fits exactly, or not at all */
+    encoded_len = cobs_encode(encoded_buffer, 255, buffer, 254, 0);
+    zassert_equal(encoded_len, 255, NULL);
+    encoded_len = cobs_encode(encoded_buffer, 254, buffer, 254, 0);
+    zassert_equal(encoded_len, 0, NULL);
+    /* 255 non-zero octets are two blocks */
+    encoded_len = cobs_encode(
+        encoded_buffer, sizeof(encoded_buffer), buffer, 255, 0);
+    zassert_equal(encoded_len, 257, NULL);
+    zassert_equal(encoded_buffer[255], 2, NULL);
+    /* no mask octet remains in the encoded data */
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (i % 5) ? 0x55 : 0;
+    }
+    encoded_len = cobs_encode(encoded_buffer, sizeof(encoded_buffer), buffer,
+        sizeof(buffer), 0x55);
+    zassert_true(encoded_len > 0, NULL);
+    zassert_is_null(memchr(encoded_buffer, 0x55, encoded_len), NULL);
+    /* round trip with runs ending at and around each block boundary */
+    for (length = 1; length <= sizeof(buffer); length++) {
+        for (i = 0; i < length; i++) {
+            buffer[i] = (uint8_t)(i + 1);
+        }
+        if (length > 3) {
+            buffer[length - 3] = 0;
+        }
+        encoded_len = cobs_encode(encoded_buffer, sizeof(encoded_buffer),
+            buffer, length, 0x55);
+        zassert_true(encoded_len > 0, NULL);
+        zassert_true(encoded_len <= COBS_ENCODED_SIZE(length), NULL);
+        test_len = cobs_decode(test_buffer, sizeof(test_buffer),
+            encoded_buffer, encoded_len, 0x55);
+        zassert_equal(test_len, length, NULL);
+        zassert_mem_equal(test_buffer, buffer, length, NULL);
+        /* decoding in place gives the same data */
+        test_len = cobs_decode(encoded_buffer, sizeof(encoded_buffer),
+            encoded_buffer, encoded_len, 0x55);
+        zassert_equal(test_len, length, NULL);
+        zassert_mem_equal(encoded_buffer, buffer, length, NULL);
+    }
+    /* a code block that runs past the end of the data is an error */
+    encoded_buffer[0] = 5 ^ 0x55;
+    test_len = cobs_decode(
+        test_buffer, sizeof(test_buffer), encoded_buffer, 3, 0x55);
+    zassert_equal(test_len, 0, NULL);
+}
+
+/**
+ * @brief Test the frame decode in place, as done by the MS/TP receiver
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cobs_tests, test_COBS_Frame_Decode_In_Place)
+#else
+static void test_COBS_Frame_Decode_In_Place(void)
+#endif
+{
+    uint8_t buffer[1476] = { 0 };
+    uint8_t encoded_buffer[COBS_ENCODED_SIZE(1476) + COBS_ENCODED_CRC_SIZE] =
+        { 0 };
+    size_t encoded_len, test_len;
+    unsigned i;
+
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)(i % 0x7F);
+    }
+    encoded_len = cobs_frame_encode(
+        encoded_buffer, sizeof(encoded_buffer), buffer, sizeof(buffer));
+    zassert_true(encoded_len > 0, NULL);
+    test_len = cobs_frame_decode(encoded_buffer, sizeof(encoded_buffer),
+        encoded_buffer, encoded_len);
+    zassert_equal(test_len, sizeof(buffer), NULL);
+    zassert_mem_equal(encoded_buffer, buffer, sizeof(buffer), NULL);
+    /* a corrupted frame fails the CRC-32K */
+    encoded_len = cobs_frame_encode(
+        encoded_buffer, sizeof(encoded_buffer), buffer, sizeof(buffer));
+    encoded_buffer[100] ^= 0x01;
+    test_len = cobs_frame_decode(encoded_buffer, sizeof(encoded_buffer),
+        encoded_buffer, encoded_len);
+    zassert_equal(test_len, 0, NULL);
+}
 /**
  * @}
  */
@@ -61,7 +203,10 @@ ZTEST_SUITE(cobs_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(cobs_tests, ztest_unit_test(test_COBS_Encode_Decode));
+    ztest_test_suite(cobs_tests, ztest_unit_test(test_COBS_Encode_Decode),
+        ztest_unit_test(test_COBS_CRC32K_Buffer),
+        ztest_unit_test(test_COBS_Encode_Runs),
+        ztest_unit_test(test_COBS_Frame_Decode_In_Place));
 
     ztest_run_test_suite(cobs_tests);
 }
@@ -76,6 +76,53 @@ static void testCRC16(void)
     zassert_equal(crc, 0xF0B8, NULL);
 }
 
+/**
+ * @brief Test the buffer CRC against the octet by octet CRC
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(crc_tests, testCRCBuffer)
+#else
+static void testCRCBuffer(void)
+#endif
+{
+    uint8_t header[5] = { 0x00, 0x10, 0x05, 0x00, 0x00 };
+    uint8_t buffer[501] = { 0 };
+    uint16_t crc16, test_crc16;
+    uint8_t crc8;
+    size_t length, offset, i;
+
+    /* Annex G examples */
+    crc8 = CRC_Calc_Header_Buffer(header, sizeof(header), 0xFF);
+    zassert_equal(crc8, 0x73, NULL);
+    crc16 = CRC_Calc_Data_Buffer(header, 0, 0xFFFF);
+    zassert_equal(crc16, 0xFFFF, NULL);
+    buffer[0] = 0x01;
+    buffer[1] = 0x22;
+    buffer[2] = 0x30;
+    crc16 = CRC_Calc_Data_Buffer(buffer, 3, 0xFFFF);
+    zassert_equal(crc16, 0x42EF, NULL);
+    /* every length and alignment, the same as one octet at a time */
+    for (i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = (uint8_t)((i * 7) ^ (i >> 3));
+    }
+    for (offset = 0; offset < 8; offset++) {
+        for (length = 0; length <= (sizeof(buffer) - offset); length++) {
+            test_crc16 = 0xFFFF;
+            for (i = 0; i < length; i++) {
+                test_crc16 = CRC_Calc_Data(buffer[offset + i], test_crc16);
+            }
+            crc16 = CRC_Calc_Data_Buffer(&buffer[offset], length, 0xFFFF);
+            zassert_equal(crc16, test_crc16, NULL);
+        }
+    }
+    /* the complement of the CRC, appended, gives the residue */
+    crc16 = ~CRC_Calc_Data_Buffer(buffer, 100, 0xFFFF);
+    buffer[100] = LO_BYTE(crc16);
+    buffer[101] = HI_BYTE(crc16);
+    crc16 = CRC_Calc_Data_Buffer(buffer, 102, 0xFFFF);
+    zassert_equal(crc16, 0xF0B8, NULL);
+}
+
 /**
  * @brief "Test" to create/log generated CRC8 table
  */
@@ -142,7 +189,7 @@ void test_main(void)
 {
     ztest_test_suite(
         crc_tests, ztest_unit_test(testCRC8), ztest_unit_test(testCRC16),
-        ztest_unit_test(testCRC8CreateTable),
+        ztest_unit_test(testCRCBuffer), ztest_unit_test(testCRC8CreateTable),
         ztest_unit_test(testCRC16CreateTable));
 
     ztest_run_test_suite(crc_tests);
@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @brief test the datalink ports chosen at run-time
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <bacnet/datalink/dlport.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the state of two fake datalinks */
+struct test_datalink {
+    bool init_status;
+    unsigned init_count;
+    unsigned cleanup_count;
+    unsigned sent_len;
+    uint16_t receive_len;
+    unsigned receive_count;
+    unsigned receive_timeout;
+    uint16_t maintenance_seconds;
+};
+static struct test_datalink Test_A;
+static struct test_datalink Test_B;
+
+static bool test_init_a(char *ifname)
+{
+    (void)ifname;
+    Test_A.init_count++;
+    return Test_A.init_status;
+}
+
+static bool test_init_b(char *ifname)
+{
+    (void)ifname;
+    Test_B.init_count++;
+    return Test_B.init_status;
+}
+
+static int test_send_a(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+    Test_A.sent_len = pdu_len;
+    return (int)pdu_len;
+}
+
+static uint16_t test_receive(struct test_datalink *test,
+    uint8_t value,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout)
+{
+    test->receive_count++;
+    test->receive_timeout = timeout;
+    if (test->receive_len && (test->receive_len <= max_pdu)) {
+        memset(pdu, value, test->receive_len);
+        return test->receive_len;
+    }
+    return 0;
+}
+
+static uint16_t test_receive_a(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    (void)src;
+    return test_receive(&Test_A, 0xAA, pdu, max_pdu, timeout);
+}
+
+static uint16_t test_receive_b(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    (void)src;
+    return test_receive(&Test_B, 0xBB, pdu, max_pdu, timeout);
+}
+
+static void test_cleanup_a(void)
+{
+    Test_A.cleanup_count++;
+}
+
+static void test_cleanup_b(void)
+{
+    Test_B.cleanup_count++;
+}
+
+static void test_timer_b(uint16_t seconds)
+{
+    Test_B.maintenance_seconds += seconds;
+}
+
+static const BACNET_DATALINK_OPS Test_A_Ops = { "a", PORT_TYPE_BIP, 100,
+    test_init_a, test_send_a, test_receive_a, test_cleanup_a, NULL, NULL,
+    NULL, NULL };
+static const BACNET_DATALINK_OPS Test_B_Ops = { "b", PORT_TYPE_MSTP, 100,
+    test_init_b, NULL, test_receive_b, test_cleanup_b, NULL, NULL,
+    test_timer_b, NULL };
+
+/**
+ * @brief Test adding ports, and sending to and receiving from them
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(dlport_tests, test_datalink_ports)
+#else
+static void test_datalink_ports(void)
+#endif
+{
+    BACNET_ADDRESS addr = { 0 };
+    uint8_t pdu[100] = { 0 };
+    unsigned port = 0;
+    uint16_t pdu_len = 0;
+
+    memset(&Test_A, 0, sizeof(Test_A));
+    memset(&Test_B, 0, sizeof(Test_B));
+    /* no datalinks are built in without a BACDL_ choice */
+    zassert_is_null(datalink_ops_find("bip"), NULL);
+    zassert_equal(datalink_port_count(), 0, NULL);
+    zassert_equal(
+        datalink_port_receive(&port, &addr, pdu, sizeof(pdu), 10), 0, NULL);
+    /* a port that fails to initialize is not added */
+    Test_A.init_status = false;
+    zassert_equal(datalink_port_add(&Test_A_Ops, "a0"), -1, NULL);
+    zassert_equal(datalink_port_count(), 0, NULL);
+    Test_A.init_status = true;
+    Test_B.init_status = true;
+    zassert_equal(datalink_port_add(&Test_A_Ops, "a0"), 0, NULL);
+    zassert_equal(datalink_port_add(&Test_B_Ops, "b0"), 1, NULL);
+    /* each datalink is one port at most */
+    zassert_equal(datalink_port_add(&Test_A_Ops, "a1"), -1, NULL);
+    zassert_equal(Test_A.init_count, 2, NULL);
+    zassert_equal(datalink_port_count(), 2, NULL);
+    zassert_equal(datalink_port_ops(1), &Test_B_Ops, NULL);
+    zassert_is_null(datalink_port_ops(2), NULL);
+    /* send */
+    zassert_equal(datalink_port_send_pdu(0, &addr, NULL, pdu, 7), 7, NULL);
+    zassert_equal(Test_A.sent_len, 7, NULL);
+    zassert_equal(datalink_port_send_pdu(1, &addr, NULL, pdu, 7), -1, NULL);
+    zassert_equal(datalink_port_send_pdu(2, &addr, NULL, pdu, 7), -1, NULL);
+    zassert_equal(datalink_port_socket(0), -1, NULL);
+    /* nothing received: each port waits for its share of the timeout */
+    pdu_len = datalink_port_receive(&port, &addr, pdu, sizeof(pdu), 10);
+    zassert_equal(pdu_len, 0, NULL);
+    zassert_equal(Test_A.receive_count, 2, NULL);
+    zassert_equal(Test_A.receive_timeout, 5, NULL);
+    zassert_equal(Test_B.receive_timeout, 5, NULL);
+    /* a waiting PDU is returned without waiting, and the ports take
+       turns when both have PDUs */
+    Test_A.receive_len = 3;
+    Test_B.receive_len = 4;
+    pdu_len = datalink_port_receive(&port, &addr, pdu, sizeof(pdu), 10);
+    zassert_equal(pdu_len, 3, NULL);
+    zassert_equal(port, 0, NULL);
+    zassert_equal(pdu[0], 0xAA, NULL);
+    zassert_equal(Test_A.receive_timeout, 0, NULL);
+    pdu_len = datalink_port_receive(&port, &addr, pdu, sizeof(pdu), 10);
+    zassert_equal(pdu_len, 4, NULL);
+    zassert_equal(port, 1, NULL);
+    zassert_equal(pdu[0], 0xBB, NULL);
+    pdu_len = datalink_port_receive(&port, &addr, pdu, sizeof(pdu), 10);
+    zassert_equal(port, 0, NULL);
+    /* timers and cleanup */
+    datalink_port_maintenance_timer(2);
+    zassert_equal(Test_B.maintenance_seconds, 2, NULL);
+    datalink_port_cleanup();
+    zassert_equal(Test_A.cleanup_count, 1, NULL);
+    zassert_equal(Test_B.cleanup_count, 1, NULL);
+    zassert_equal(datalink_port_count(), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(dlport_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(dlport_tests, ztest_unit_test(test_datalink_ports));
+
+    ztest_run_test_suite(dlport_tests);
+}
+#endif
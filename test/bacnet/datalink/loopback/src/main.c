@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief test the in-memory loopback datalink
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <bacnet/datalink/loopback.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test unicast and broadcast between the nodes
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(loopback_tests, test_loopback_send_receive)
+#else
+static void test_loopback_send_receive(void)
+#endif
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    LOOPBACK_STATS stats = { 0 };
+    uint8_t pdu[LOOPBACK_MPDU_MAX] = { 0 };
+    uint8_t rx_pdu[LOOPBACK_MPDU_MAX] = { 0 };
+    uint16_t pdu_len;
+    int len;
+
+    loopback_cleanup();
+    loopback_stats_reset();
+    /* nothing is sent or received before a node is chosen */
+    zassert_equal(loopback_node(), LOOPBACK_BROADCAST_ADDRESS, NULL);
+    len = loopback_send_pdu(&dest, NULL, pdu, 4);
+    zassert_equal(len, -1, NULL);
+    pdu_len = loopback_receive(&src, rx_pdu, sizeof(rx_pdu), 0);
+    zassert_equal(pdu_len, 0, NULL);
+    /* the interface name is the MAC address */
+    zassert_true(loopback_init(NULL), NULL);
+    zassert_equal(loopback_node(), LOOPBACK_MAC_DEFAULT, NULL);
+    zassert_true(loopback_init("2"), NULL);
+    zassert_equal(loopback_node(), 2, NULL);
+    zassert_false(loopback_init("255"), NULL);
+    zassert_false(loopback_init("eth0"), NULL);
+    zassert_equal(loopback_node(), 2, NULL);
+    zassert_true(loopback_node_set(3), NULL);
+    zassert_equal(loopback_node_count(), 3, NULL);
+    loopback_get_my_address(&src);
+    zassert_equal(src.mac_len, 1, NULL);
+    zassert_equal(src.mac[0], 3, NULL);
+    /* unicast from node 3 to node 1 */
+    dest.mac_len = 1;
+    dest.mac[0] = 1;
+    pdu[0] = 0x01;
+    pdu[1] = 0x04;
+    pdu[2] = 0xAA;
+    len = loopback_send_pdu(&dest, NULL, pdu, 3);
+    zassert_equal(len, 3, NULL);
+    zassert_equal(loopback_pending(1), 1, NULL);
+    zassert_equal(loopback_pending(2), 0, NULL);
+    zassert_equal(loopback_pending(3), 0, NULL);
+    /* a node that is not attached loses the packet */
+    dest.mac[0] = 9;
+    len = loopback_send_pdu(&dest, NULL, pdu, 3);
+    zassert_equal(len, 3, NULL);
+    zassert_equal(loopback_pending(9), 0, NULL);
+    zassert_true(loopback_node_set(1), NULL);
+    pdu_len = loopback_receive(&src, rx_pdu, sizeof(rx_pdu), 0);
+    zassert_equal(pdu_len, 3, NULL);
+    zassert_equal(memcmp(rx_pdu, pdu, 3), 0, NULL);
+    zassert_equal(src.mac_len, 1, NULL);
+    zassert_equal(src.mac[0], 3, NULL);
+    zassert_equal(src.net, 0, NULL);
+    pdu_len = loopback_receive(&src, rx_pdu, sizeof(rx_pdu), 0);
+    zassert_equal(pdu_len, 0, NULL);
+    /* broadcast from node 1 to the others */
+    loopback_get_broadcast_address(&dest);
+    zassert_equal(dest.mac_len, 1, NULL);
+    zassert_equal(dest.mac[0], LOOPBACK_BROADCAST_ADDRESS, NULL);
+    zassert_equal(dest.net, BACNET_BROADCAST_NETWORK, NULL);
+    len = loopback_send_pdu(&dest, NULL, pdu, 3);
+    zassert_equal(len, 3, NULL);
+    zassert_equal(loopback_pending(1), 0, NULL);
+    zassert_equal(loopback_pending(2), 1, NULL);
+    zassert_equal(loopback_pending(3), 1, NULL);
+    /* a reply that does not fit is dropped */
+    zassert_true(loopback_node_set(2), NULL);
+    pdu_len = loopback_receive(&src, rx_pdu, 2, 0);
+    zassert_equal(pdu_len, 0, NULL);
+    zassert_equal(loopback_pending(2), 0, NULL);
+    /* too large to send */
+    len = loopback_send_pdu(&dest, NULL, pdu, LOOPBACK_MPDU_MAX + 1);
+    zassert_equal(len, -1, NULL);
+    loopback_stats(&stats);
+    zassert_equal(stats.sent, 3, NULL);
+    zassert_equal(stats.delivered, 3, NULL);
+    zassert_equal(stats.received, 1, NULL);
+    zassert_equal(stats.dropped, 3, NULL);
+    loopback_cleanup();
+    zassert_equal(loopback_node_count(), 0, NULL);
+    zassert_equal(loopback_pending(3), 0, NULL);
+}
+
+/**
+ * @brief Test a full queue, and a full network
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(loopback_tests, test_loopback_limits)
+#else
+static void test_loopback_limits(void)
+#endif
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[8] = { 0 };
+    uint16_t pdu_len;
+    unsigned i;
+    int len;
+
+    loopback_cleanup();
+    zassert_true(loopback_node_set(10), NULL);
+    zassert_true(loopback_node_set(20), NULL);
+    dest.mac_len = 1;
+    dest.mac[0] = 10;
+    for (i = 0; i < LOOPBACK_QUEUE_SIZE + 2; i++) {
+        pdu[0] = (uint8_t)i;
+        len = loopback_send_pdu(&dest, NULL, pdu, sizeof(pdu));
+        zassert_equal(len, sizeof(pdu), NULL);
+    }
+    zassert_equal(loopback_pending(10), LOOPBACK_QUEUE_SIZE, NULL);
+    /* the packets that fit are received in the order they were sent */
+    zassert_true(loopback_node_set(10), NULL);
+    for (i = 0; i < LOOPBACK_QUEUE_SIZE; i++) {
+        pdu_len = loopback_receive(&src, pdu, sizeof(pdu), 0);
+        zassert_equal(pdu_len, sizeof(pdu), NULL);
+        zassert_equal(pdu[0], i, NULL);
+        zassert_equal(src.mac[0], 20, NULL);
+    }
+    pdu_len = loopback_receive(&src, pdu, sizeof(pdu), 0);
+    zassert_equal(pdu_len, 0, NULL);
+    /* the network is full */
+    for (i = 2; i < LOOPBACK_NODES_MAX; i++) {
+        zassert_true(loopback_node_set((uint8_t)(30 + i)), NULL);
+    }
+    zassert_equal(loopback_node_count(), LOOPBACK_NODES_MAX, NULL);
+    zassert_false(loopback_node_set(99), NULL);
+    zassert_false(loopback_node_set(LOOPBACK_BROADCAST_ADDRESS), NULL);
+    zassert_true(loopback_node_set(10), NULL);
+    loopback_cleanup();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(loopback_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(loopback_tests,
+        ztest_unit_test(test_loopback_send_receive),
+        ztest_unit_test(test_loopback_limits));
+
+    ztest_run_test_suite(loopback_tests);
+}
+#endif
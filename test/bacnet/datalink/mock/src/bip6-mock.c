@@ -86,6 +86,11 @@ uint16_t bip6_get_port(void)
     return ztest_get_return_value();
 }
 
+int bip6_get_socket(void)
+{
+    return -1;
+}
+
 void bip6_get_broadcast_address(BACNET_ADDRESS *my_address)
 {
     ztest_copy_return_data(my_address, sizeof(BACNET_ADDRESS));
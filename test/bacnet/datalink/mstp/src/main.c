@@ -540,7 +540,9 @@ static void testReceiveNodeFSM(void)
     /* Extended-Data-Not-Expecting-Reply */
     mstp_port.ReceivedInvalidFrame = false;
     mstp_port.ReceivedValidFrame = false;
-    memset(data, 0, sizeof(data));
+    for (i = 0; i < Nmin_COBS_length_BACnet; i++) {
+        data[i] = (uint8_t)(i % 0x7F);
+    }
     len = MSTP_Create_Frame(
         buffer, sizeof(buffer),
         FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY, my_mac, my_mac,
@@ -561,6 +563,91 @@ static void testReceiveNodeFSM(void)
         mstp_port.FrameType ==
             FRAME_TYPE_BACNET_EXTENDED_DATA_NOT_EXPECTING_REPLY,
         NULL);
+    /* the client data is decoded to the front of the input buffer */
+    zassert_mem_equal(
+        mstp_port.InputBuffer, data, Nmin_COBS_length_BACnet, NULL);
+}
+
+static void testReceiveNodeFSM_Block(void)
+{
+    struct mstp_port_struct_t mstp_port = { 0 }; /* port data */
+    uint8_t my_mac = 0x05; /* local MAC address */
+    uint8_t buffer[MAX_MPDU] = { 0 };
+    uint8_t data[128] = { 0 };
+    uint8_t token[8] = { 0 };
+    unsigned len, token_len, count, offset;
+    uint16_t consumed;
+    size_t i;
+
+    mstp_port.InputBuffer = &RxBuffer[0];
+    mstp_port.InputBufferSize = sizeof(RxBuffer);
+    mstp_port.OutputBuffer = &TxBuffer[0];
+    mstp_port.OutputBufferSize = sizeof(TxBuffer);
+    mstp_port.SilenceTimer = Timer_Silence;
+    mstp_port.SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port.This_Station = my_mac;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    mstp_port.Tframe_abort = DEFAULT_Tframe_abort;
+    MSTP_Init(&mstp_port);
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+    /* a data frame followed by a token, in blocks of each size */
+    len = MSTP_Create_Frame(buffer, sizeof(buffer),
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, my_mac, 0x01, data,
+        sizeof(data));
+    token_len = MSTP_Create_Frame(
+        token, sizeof(token), FRAME_TYPE_TOKEN, my_mac, 0x01, NULL, 0);
+    memcpy(&buffer[len], token, token_len);
+    for (count = 1; count <= (len + token_len); count++) {
+        mstp_port.ReceivedValidFrame = false;
+        mstp_port.ReceivedInvalidFrame = false;
+        offset = 0;
+        while (!mstp_port.ReceivedValidFrame) {
+            zassert_true(offset < len, "count=%u", count);
+            consumed = MSTP_Receive_Frame_FSM_Block(&mstp_port,
+                &buffer[offset],
+                (offset + count) < len ? count : (len - offset) + token_len);
+            offset += consumed;
+        }
+        /* the block stops at the end of the frame */
+        zassert_equal(offset, len, "count=%u", count);
+        zassert_false(mstp_port.ReceivedInvalidFrame, NULL);
+        zassert_equal(mstp_port.DataLength, sizeof(data), NULL);
+        zassert_mem_equal(mstp_port.InputBuffer, data, sizeof(data), NULL);
+        zassert_equal(
+            mstp_port.FrameType, FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY,
+            NULL);
+        mstp_port.ReceivedValidFrame = false;
+        consumed = MSTP_Receive_Frame_FSM_Block(
+            &mstp_port, &buffer[offset], token_len);
+        zassert_equal(consumed, token_len, NULL);
+        zassert_true(mstp_port.ReceivedValidFrame, NULL);
+        zassert_equal(mstp_port.FrameType, FRAME_TYPE_TOKEN, NULL);
+        zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_IDLE, NULL);
+    }
+    /* a bad data CRC */
+    mstp_port.ReceivedValidFrame = false;
+    buffer[len - 1] ^= 0xFF;
+    consumed = MSTP_Receive_Frame_FSM_Block(&mstp_port, buffer, len);
+    zassert_equal(consumed, len, NULL);
+    zassert_true(mstp_port.ReceivedInvalidFrame, NULL);
+    zassert_false(mstp_port.ReceivedValidFrame, NULL);
+    /* a timeout within the data, with the octet given to the IDLE state */
+    mstp_port.ReceivedInvalidFrame = false;
+    consumed = MSTP_Receive_Frame_FSM_Block(&mstp_port, buffer, 20);
+    zassert_equal(consumed, 20, NULL);
+    zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_DATA, NULL);
+    SilenceTime = DEFAULT_Tframe_abort + 1;
+    consumed = MSTP_Receive_Frame_FSM_Block(&mstp_port, &buffer[20], 10);
+    zassert_equal(consumed, 0, NULL);
+    zassert_true(mstp_port.ReceivedInvalidFrame, NULL);
+    zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_IDLE, NULL);
+    /* no octets: only the timeouts */
+    mstp_port.ReceivedInvalidFrame = false;
+    zassert_equal(MSTP_Receive_Frame_FSM_Block(&mstp_port, NULL, 0), 0, NULL);
+    zassert_equal(mstp_port.receive_state, MSTP_RECEIVE_STATE_IDLE, NULL);
 }
 
 static void testMasterNodeFSM(void)
@@ -590,6 +677,141 @@ static void testMasterNodeFSM(void)
     /* FIXME: write a unit test for the Master Node State Machine */
 }
 
+static void testMasterNodeFSM_Adaptive(void)
+{
+    struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
+    uint8_t my_mac = 0x05; /* local MAC address */
+    uint8_t station;
+
+    MSTP_Port.InputBuffer = &RxBuffer[0];
+    MSTP_Port.InputBufferSize = sizeof(RxBuffer);
+    MSTP_Port.OutputBuffer = &TxBuffer[0];
+    MSTP_Port.OutputBufferSize = sizeof(TxBuffer);
+    MSTP_Port.Nmax_info_frames = 1;
+    MSTP_Port.Nmax_master = 127;
+    MSTP_Port.Nmax_info_frames_limit = 8;
+    MSTP_Port.Npoll_absent = 4;
+    MSTP_Port.SilenceTimer = Timer_Silence;
+    MSTP_Port.SilenceTimerReset = Timer_Silence_Reset;
+    MSTP_Port.This_Station = my_mac;
+    MSTP_Init(&MSTP_Port);
+    zassert_equal(MSTP_Port.Info_Frames_Window, 1, NULL);
+    /* a token hold that used up its window doubles the next window */
+    MSTP_Port.master_state = MSTP_MASTER_STATE_IDLE;
+    MSTP_Port.Info_Frames_Backlog = true;
+    MSTP_Port.ReceivedValidFrame = true;
+    MSTP_Port.FrameType = FRAME_TYPE_TOKEN;
+    MSTP_Port.DestinationAddress = my_mac;
+    MSTP_Port.SourceAddress = 0x0A;
+    SilenceTime = 0;
+    zassert_true(MSTP_Master_Node_FSM(&MSTP_Port), NULL);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_USE_TOKEN, NULL);
+    zassert_equal(MSTP_Port.Info_Frames_Window, 2, NULL);
+    /* nothing to send ends the hold and falls back on the next token */
+    zassert_true(MSTP_Master_Node_FSM(&MSTP_Port), NULL);
+    zassert_equal(
+        MSTP_Port.master_state, MSTP_MASTER_STATE_DONE_WITH_TOKEN, NULL);
+    zassert_equal(MSTP_Port.FrameCount, 2, NULL);
+    zassert_false(MSTP_Port.Info_Frames_Backlog, NULL);
+    MSTP_Port.master_state = MSTP_MASTER_STATE_IDLE;
+    MSTP_Port.ReceivedValidFrame = true;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(MSTP_Port.Info_Frames_Window, 1, NULL);
+    /* the window never grows past the limit */
+    MSTP_Port.Info_Frames_Window = 6;
+    MSTP_Port.Info_Frames_Backlog = true;
+    MSTP_Port.master_state = MSTP_MASTER_STATE_IDLE;
+    MSTP_Port.ReceivedValidFrame = true;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(MSTP_Port.Info_Frames_Window, 8, NULL);
+
+    /* a station that does not reply to its poll is learned as absent */
+    MSTP_Port.Next_Station = 0x0A;
+    MSTP_Port.Poll_Station = 0x06;
+    MSTP_Port.master_state = MSTP_MASTER_STATE_POLL_FOR_MASTER;
+    SilenceTime = MSTP_Port.Tusage_timeout + 1;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+    zassert_true(MSTP_Port.Poll_Absent[0] & (1 << 6), NULL);
+    for (station = 7; station < 10; station++) {
+        MSTP_Port.Poll_Absent[station / 8] |= (1 << (station % 8));
+    }
+    /* the maintenance poll skips the absent stations 6, 7 and 9 */
+    MSTP_Port.master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
+    MSTP_Port.FrameCount = MSTP_Port.Nmax_info_frames_limit;
+    MSTP_Port.TokenCount = Npoll;
+    MSTP_Port.Poll_Station = my_mac;
+    MSTP_Port.Poll_Absent_Cycle = 1;
+    MSTP_Port.Poll_Absent[1] &= ~(1 << 0);
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(
+        MSTP_Port.master_state, MSTP_MASTER_STATE_POLL_FOR_MASTER, NULL);
+    zassert_equal(MSTP_Port.Poll_Station, 8, NULL);
+    /* once all stations up to NS are absent, the cycle is restarted */
+    MSTP_Port.master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+    zassert_equal(MSTP_Port.Poll_Station, my_mac, NULL);
+    zassert_equal(MSTP_Port.Poll_Absent_Cycle, 2, NULL);
+    /* every Npoll_absent-th cycle polls the absent stations too */
+    MSTP_Port.master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
+    MSTP_Port.TokenCount = Npoll;
+    MSTP_Port.Poll_Absent_Cycle = 4;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(MSTP_Port.Poll_Station, 6, NULL);
+    /* any frame from a station marks it present again */
+    MSTP_Port.master_state = MSTP_MASTER_STATE_IDLE;
+    MSTP_Port.ReceivedValidFrame = true;
+    MSTP_Port.FrameType = FRAME_TYPE_TEST_RESPONSE;
+    MSTP_Port.SourceAddress = 7;
+    SilenceTime = 0;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_false(MSTP_Port.Poll_Absent[0] & (1 << 7), NULL);
+}
+
+static void testMasterNodeFSM_Reply_Postpone(void)
+{
+    struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
+    uint8_t my_mac = 0x05; /* local MAC address */
+    /* NPCI with a DNET of 2, DLEN of 0, and a hop count */
+    uint8_t routed_npdu[] = { 0x01, 0x24, 0x00, 0x02, 0x00, 0xFF };
+    uint8_t local_npdu[] = { 0x01, 0x04 };
+
+    MSTP_Port.InputBuffer = &RxBuffer[0];
+    MSTP_Port.InputBufferSize = sizeof(RxBuffer);
+    MSTP_Port.OutputBuffer = &TxBuffer[0];
+    MSTP_Port.OutputBufferSize = sizeof(TxBuffer);
+    MSTP_Port.Nmax_info_frames = 1;
+    MSTP_Port.Nmax_master = 127;
+    MSTP_Port.SilenceTimer = Timer_Silence;
+    MSTP_Port.SilenceTimerReset = Timer_Silence_Reset;
+    MSTP_Port.This_Station = my_mac;
+    MSTP_Init(&MSTP_Port);
+    MSTP_Port.FrameType = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+    MSTP_Port.SourceAddress = 0x0A;
+    memcpy(RxBuffer, local_npdu, sizeof(local_npdu));
+    MSTP_Port.DataLength = sizeof(local_npdu);
+    zassert_false(MSTP_Reply_Postpone_Routed(&MSTP_Port), NULL);
+    memcpy(RxBuffer, routed_npdu, sizeof(routed_npdu));
+    MSTP_Port.DataLength = sizeof(routed_npdu);
+    zassert_true(MSTP_Reply_Postpone_Routed(&MSTP_Port), NULL);
+    zassert_false(MSTP_Reply_Postpone_Routed(NULL), NULL);
+    /* without the policy, the reply is waited for until Treply_delay */
+    MSTP_Port.master_state = MSTP_MASTER_STATE_ANSWER_DATA_REQUEST;
+    MSTP_Port.ReceivedValidFrame = true;
+    SilenceTime = 0;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(MSTP_Port.master_state,
+        MSTP_MASTER_STATE_ANSWER_DATA_REQUEST, NULL);
+    /* with it, the routed request is postponed at once */
+    MSTP_Port.Reply_Postpone = MSTP_Reply_Postpone_Routed;
+    (void)MSTP_Master_Node_FSM(&MSTP_Port);
+    zassert_equal(MSTP_Port.master_state, MSTP_MASTER_STATE_IDLE, NULL);
+    zassert_false(MSTP_Port.ReceivedValidFrame, NULL);
+    zassert_equal(TxBuffer[2], FRAME_TYPE_REPLY_POSTPONED, NULL);
+    zassert_equal(TxBuffer[3], 0x0A, NULL);
+}
+
 static void testSlaveNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
@@ -1023,6 +1245,56 @@ static void testZeroConfigNode_Test_LURK_ClaimAddressInUse(
     zassert_equal(mstp_port->Zero_Config_Station, station + 1, NULL);
 }
 
+static void testZeroConfigNode_Test_LURK_Frame(
+    struct mstp_port_struct_t *mstp_port,
+    uint8_t frame,
+    uint8_t src,
+    uint8_t dst)
+{
+    bool transition_now;
+
+    mstp_port->FrameType = frame;
+    mstp_port->SourceAddress = src;
+    mstp_port->DestinationAddress = dst;
+    mstp_port->ReceivedValidFrame = true;
+    transition_now = MSTP_Master_Node_FSM(mstp_port);
+    zassert_false(transition_now, NULL);
+    zassert_true(mstp_port->ReceivedValidFrame == false, NULL);
+    zassert_equal(
+        mstp_port->Zero_Config_State, MSTP_ZERO_CONFIG_STATE_LURK, NULL);
+}
+
+static void
+testZeroConfigNode_Test_LURK_StationMap(struct mstp_port_struct_t *mstp_port)
+{
+    uint8_t station;
+
+    /* the frame from IDLE state */
+    SilenceTime = 0;
+    testZeroConfigNode_Test_LURK_Frame(mstp_port, FRAME_TYPE_TOKEN, 0, 1);
+    zassert_equal(mstp_port->Zero_Config_Station, Nmin_poll_station, NULL);
+    /* a polled address is not in-use, and is chosen before counting */
+    testZeroConfigNode_Test_LURK_Frame(
+        mstp_port, FRAME_TYPE_POLL_FOR_MASTER, Nmin_poll_station, 100);
+    zassert_equal(mstp_port->Zero_Config_Station, 100, NULL);
+    zassert_equal(mstp_port->Poll_Count, 1, NULL);
+    /* once counting, the address is kept */
+    testZeroConfigNode_Test_LURK_Frame(
+        mstp_port, FRAME_TYPE_POLL_FOR_MASTER, Nmin_poll_station, 70);
+    zassert_equal(mstp_port->Zero_Config_Station, 100, NULL);
+    /* the address became in-use: move to the other polled address */
+    testZeroConfigNode_Test_LURK_Frame(mstp_port, FRAME_TYPE_TOKEN, 100, 0);
+    zassert_equal(mstp_port->Zero_Config_Station, 70, NULL);
+    zassert_equal(mstp_port->Poll_Count, 0, NULL);
+    /* nothing polled is free: skip the addresses known to be in-use */
+    testZeroConfigNode_Test_LURK_Frame(mstp_port, FRAME_TYPE_TOKEN, 71, 0);
+    testZeroConfigNode_Test_LURK_Frame(mstp_port, FRAME_TYPE_TOKEN, 70, 0);
+    zassert_equal(mstp_port->Zero_Config_Station, 72, NULL);
+    station = mstp_port->Zero_Config_Station;
+    testZeroConfigNode_Test_LURK_Frame(mstp_port, FRAME_TYPE_TOKEN, 0, 1);
+    zassert_equal(mstp_port->Zero_Config_Station, station, NULL);
+}
+
 static void testZeroConfigNode_Test_LURK_ClaimInvalidFrame(
     struct mstp_port_struct_t *mstp_port)
 {
@@ -1076,6 +1348,10 @@ static void testZeroConfigNodeFSM(void)
     testZeroConfigNode_Init(&MSTP_Port);
     testZeroConfigNode_Test_IDLE_ValidFrame(&MSTP_Port);
     testZeroConfigNode_Test_LURK_LearnMaxMaster(&MSTP_Port);
+    /* test case: valid frame event LURK: station address map */
+    testZeroConfigNode_Init(&MSTP_Port);
+    testZeroConfigNode_Test_IDLE_ValidFrame(&MSTP_Port);
+    testZeroConfigNode_Test_LURK_StationMap(&MSTP_Port);
     /* test case: valid frame event LURK PFMs: ClaimAddress
        ConfirmationSuccessful */
     testZeroConfigNode_Init(&MSTP_Port);
@@ -1150,7 +1426,11 @@ void test_main(void)
 {
     ztest_test_suite(
         crc_tests, ztest_unit_test(testReceiveNodeFSM),
-        ztest_unit_test(testMasterNodeFSM), ztest_unit_test(testSlaveNodeFSM),
+        ztest_unit_test(testReceiveNodeFSM_Block),
+        ztest_unit_test(testMasterNodeFSM),
+        ztest_unit_test(testMasterNodeFSM_Adaptive),
+        ztest_unit_test(testMasterNodeFSM_Reply_Postpone),
+        ztest_unit_test(testSlaveNodeFSM),
         ztest_unit_test(testZeroConfigNodeFSM));
 
     ztest_run_test_suite(crc_tests);
@@ -61,6 +61,56 @@ static void testIndexText(void)
     zassert_equal(
         index, indtext_by_istring_default(data_list, "ANNA", index), NULL);
 }
+
+/**
+ * @brief Test the hash table search, which finds what the list search finds
+ */
+static INDTEXT_DATA hash_list[] = { { 1, "Joshua" }, { 2, "Mary" },
+    { 3, "Anna" }, { 4, "Christopher" }, { 5, "Patricia" }, { 6, "ANNA" },
+    { 0, NULL } };
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(indtext_tests, testIndexTextHash)
+#else
+static void testIndexTextHash(void)
+#endif
+{
+    uint16_t slots[8] = { 0 };
+    uint16_t small_slots[4] = { 0 };
+    INDTEXT_HASH hash = { hash_list, slots, 8, false };
+    unsigned i;
+    unsigned index = 0, list_index = 0;
+    bool valid;
+
+    /* built on first use */
+    valid = indtext_hash_by_istring(&hash, "mary", &index);
+    zassert_true(valid, NULL);
+    zassert_true(hash.ready, NULL);
+    zassert_equal(index, 2, NULL);
+    for (i = 0; hash_list[i].pString; i++) {
+        valid = indtext_hash_by_istring(&hash, hash_list[i].pString, &index);
+        zassert_true(valid, NULL);
+        valid =
+            indtext_by_istring(hash_list, hash_list[i].pString, &list_index);
+        zassert_true(valid, NULL);
+        zassert_equal(index, list_index, NULL);
+    }
+    /* the first of the same strings is found */
+    zassert_true(indtext_hash_by_istring(&hash, "anna", &index), NULL);
+    zassert_equal(index, 3, NULL);
+    zassert_false(indtext_hash_by_istring(&hash, "Harry", &index), NULL);
+    zassert_false(indtext_hash_by_istring(&hash, "", &index), NULL);
+    zassert_false(indtext_hash_by_istring(&hash, NULL, &index), NULL);
+    zassert_false(indtext_hash_by_istring(NULL, "Mary", &index), NULL);
+    /* too few slots, or not a power of two: the list is searched */
+    zassert_false(indtext_hash_init(&hash, hash_list, small_slots, 4), NULL);
+    zassert_false(indtext_hash_init(&hash, hash_list, slots, 7), NULL);
+    zassert_false(hash.ready, NULL);
+    zassert_true(indtext_hash_by_istring(&hash, "CHRISTOPHER", &index), NULL);
+    zassert_equal(index, 4, NULL);
+    zassert_true(indtext_hash_init(&hash, hash_list, slots, 8), NULL);
+    zassert_true(indtext_hash_by_istring(&hash, "patricia", NULL), NULL);
+}
 /**
  * @}
  */
@@ -70,7 +120,8 @@ ZTEST_SUITE(indtext_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(indtext_tests, ztest_unit_test(testIndexText));
+    ztest_test_suite(indtext_tests, ztest_unit_test(testIndexText),
+        ztest_unit_test(testIndexTextHash));
 
     ztest_run_test_suite(indtext_tests);
 }
@@ -8,6 +8,7 @@
  * @brief test BACnet integer encode/decode APIs
  */
 
+#include <string.h>
 #include <zephyr/ztest.h>
 #include <bacnet/npdu.h>
 
@@ -202,6 +203,48 @@ static void testNPDU1(void)
     zassert_equal(npdu_dest.mac_len, src.mac_len, NULL);
     zassert_equal(npdu_src.mac_len, dest.mac_len, NULL);
 }
+/**
+ * @brief Test the NPDU header templates
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(npdu_tests, testNPDUHeader)
+#else
+static void testNPDUHeader(void)
+#endif
+{
+    uint8_t pdu[MAX_NPDU] = { 0 };
+    uint8_t test_pdu[MAX_NPDU] = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_NPDU_HEADER header = { 0 };
+    int len = 0, test_len = 0;
+
+    zassert_equal(npdu_header_encode(pdu, sizeof(pdu), &header), 0, NULL);
+    zassert_equal(npdu_header_init(NULL, &dest, &src, &npdu_data), 0, NULL);
+    zassert_equal(npdu_header_init(&header, &dest, &src, NULL), 0, NULL);
+    dest.net = 2709;
+    dest.len = 3;
+    dest.adr[0] = 1;
+    dest.adr[1] = 2;
+    dest.adr[2] = 3;
+    src.net = 1;
+    src.len = 1;
+    src.adr[0] = 99;
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_URGENT);
+    len = npdu_encode_pdu(test_pdu, &dest, &src, &npdu_data);
+    test_len = npdu_header_init(&header, &dest, &src, &npdu_data);
+    zassert_equal(len, test_len, NULL);
+    zassert_true(header.npdu_data.data_expecting_reply, NULL);
+    zassert_equal(header.npdu_data.priority, MESSAGE_PRIORITY_URGENT, NULL);
+    zassert_equal(npdu_header_encode(NULL, 0, &header), len, NULL);
+    zassert_equal(npdu_header_encode(pdu, len - 1, &header), 0, NULL);
+    test_len = npdu_header_encode(pdu, sizeof(pdu), &header);
+    zassert_equal(len, test_len, NULL);
+    zassert_equal(memcmp(pdu, test_pdu, len), 0, NULL);
+    npdu_header_reset(&header);
+    zassert_equal(npdu_header_encode(pdu, sizeof(pdu), &header), 0, NULL);
+}
 /**
  * @}
  */
@@ -213,7 +256,7 @@ void test_main(void)
 {
     ztest_test_suite(
         npdu_tests, ztest_unit_test(testNPDU1), ztest_unit_test(testNPDU2),
-        ztest_unit_test(test_NPDU_Network));
+        ztest_unit_test(test_NPDU_Network), ztest_unit_test(testNPDUHeader));
 
     ztest_run_test_suite(npdu_tests);
 }
@@ -85,6 +85,39 @@ void testPropList(void)
     zassert_true(count > 0, NULL);
 }
 
+/**
+ * @brief Test the property membership bitmap against the lists
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(property_tests, testPropListBitmap)
+#else
+void testPropListBitmap(void)
+#endif
+{
+    static const int proprietary[] = { 512, 4194304, -1 };
+    struct special_property_list_t property_list = { 0 };
+    struct property_list_bitmap_t bitmap = { 0 };
+    unsigned i = 0;
+    int property = 0;
+    bool status = false;
+
+    zassert_false(property_list_bitmap_member(NULL, PROP_OBJECT_NAME), NULL);
+    for (i = 0; i < OBJECT_PROPRIETARY_MIN; i++) {
+        property_list_special((BACNET_OBJECT_TYPE)i, &property_list);
+        property_list_bitmap_init(&bitmap, property_list.Required.pList,
+            property_list.Optional.pList, proprietary);
+        for (property = -1; property <= PROP_PROPRIETARY_RANGE_MIN;
+             property++) {
+            status = property_lists_member(property_list.Required.pList,
+                property_list.Optional.pList, proprietary, property);
+            zassert_equal(property_list_bitmap_member(&bitmap, property),
+                status, NULL);
+        }
+        zassert_true(property_list_bitmap_member(&bitmap, 4194304), NULL);
+        zassert_false(property_list_bitmap_member(&bitmap, 4194305), NULL);
+    }
+}
+
 /**
  * @}
  */
@@ -94,7 +127,8 @@ ZTEST_SUITE(property_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(property_tests, ztest_unit_test(testPropList));
+    ztest_test_suite(property_tests, ztest_unit_test(testPropList),
+        ztest_unit_test(testPropListBitmap));
 
     ztest_run_test_suite(property_tests);
 }
@@ -341,6 +341,84 @@ static void test_Unconfirmed_Private_Transfer_Request(void)
 
     return;
 }
+
+/**
+ * @brief Test that the blocks of a stream fit in the maximum APDU, and
+ *  are reassembled in any order, including a repeated block
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(ptransfer_tests, test_Private_Transfer_Stream)
+#else
+static void test_Private_Transfer_Stream(void)
+#endif
+{
+    uint8_t data[1000] = { 0 };
+    uint8_t test_data[1000] = { 0 };
+    uint8_t apdu[480] = { 0 };
+    uint8_t service_parameters[480] = { 0 };
+    const uint32_t order[3] = { 2, 0, 1 };
+    BACNET_PRIVATE_TRANSFER_DATA private_data = { 0 };
+    BACNET_PRIVATE_TRANSFER_DATA test_private_data = { 0 };
+    BACNET_PRIVATE_TRANSFER_BLOCK block = { 0 };
+    BACNET_PRIVATE_TRANSFER_BLOCK test_block = { 0 };
+    BACNET_PRIVATE_TRANSFER_STREAM stream = { 0 };
+    uint8_t invoke_id = 0;
+    uint16_t block_size = 0;
+    unsigned i;
+    int len = 0;
+
+    for (i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7);
+    }
+    zassert_equal(ptransfer_block_size(PTRANSFER_BLOCK_OVERHEAD), 0, NULL);
+    block_size = ptransfer_block_size(sizeof(apdu));
+    zassert_equal(block_size, sizeof(apdu) - PTRANSFER_BLOCK_OVERHEAD, NULL);
+    ptransfer_stream_init(&stream, test_data, sizeof(test_data));
+    zassert_false(ptransfer_stream_complete(&stream), NULL);
+    for (i = 0; i < 4; i++) {
+        block.stream_length = sizeof(data);
+        block.block_size = block_size;
+        block.block_number = order[i % 3];
+        block.data = &data[block.block_number * block_size];
+        block.data_len = block_size;
+        if (block.block_number == 2) {
+            block.data_len = sizeof(data) - (2 * block_size);
+        }
+        private_data.vendorID = UINT16_MAX;
+        private_data.serviceNumber = UINT32_MAX;
+        private_data.serviceParameters = service_parameters;
+        private_data.serviceParametersLen =
+            ptransfer_block_encode(service_parameters, &block);
+        zassert_equal(private_data.serviceParametersLen,
+            ptransfer_block_encode(NULL, &block), NULL);
+        len = ptransfer_encode_apdu(apdu, 1, &private_data);
+        zassert_true(len <= (int)sizeof(apdu), NULL);
+        len = ptransfer_decode_apdu(apdu, len, &invoke_id, &test_private_data);
+        zassert_true(len > 0, NULL);
+        len = ptransfer_block_decode(test_private_data.serviceParameters,
+            test_private_data.serviceParametersLen, &test_block);
+        zassert_equal(len, private_data.serviceParametersLen, NULL);
+        zassert_equal(test_block.block_number, block.block_number, NULL);
+        zassert_equal(test_block.data_len, block.data_len, NULL);
+        zassert_true(ptransfer_stream_block_add(&stream, &test_block), NULL);
+        zassert_equal(ptransfer_stream_complete(&stream), (i >= 2), NULL);
+    }
+    zassert_mem_equal(test_data, data, sizeof(data), NULL);
+    zassert_equal(stream.received, sizeof(data), NULL);
+    /* a block of another stream, or past the end */
+    test_block.block_size--;
+    zassert_false(ptransfer_stream_block_add(&stream, &test_block), NULL);
+    test_block.block_size++;
+    test_block.block_number = 3;
+    zassert_false(ptransfer_stream_block_add(&stream, &test_block), NULL);
+    /* a truncated block */
+    zassert_equal(ptransfer_block_decode(service_parameters,
+                      private_data.serviceParametersLen - 1, &test_block),
+        BACNET_STATUS_ERROR, NULL);
+    /* a stream that does not fit */
+    ptransfer_stream_init(&stream, test_data, 100);
+    zassert_false(ptransfer_stream_block_add(&stream, &block), NULL);
+}
 /**
  * @}
  */
@@ -354,7 +432,8 @@ void test_main(void)
         ptransfer_tests, ztest_unit_test(test_Private_Transfer_Request),
         ztest_unit_test(test_Private_Transfer_Ack),
         ztest_unit_test(test_Private_Transfer_Error),
-        ztest_unit_test(test_Unconfirmed_Private_Transfer_Request));
+        ztest_unit_test(test_Unconfirmed_Private_Transfer_Request),
+        ztest_unit_test(test_Private_Transfer_Stream));
 
     ztest_run_test_suite(ptransfer_tests);
 }
@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief test of the generic ReadRange encoding of a list of elements
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/readrange.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_ELEMENTS 100
+
+static int test_element_encode(
+    uint32_t object_instance, BACNET_ARRAY_INDEX index, uint8_t *apdu)
+{
+    (void)object_instance;
+    if (index >= TEST_ELEMENTS) {
+        return BACNET_STATUS_ERROR;
+    }
+    /* elements of 2, 3 and 5 bytes */
+    return encode_application_unsigned(apdu, (index % 3) * 300 * index);
+}
+
+static void test_request_init(
+    BACNET_READ_RANGE_DATA *request, int type, uint32_t index, int32_t count)
+{
+    memset(request, 0, sizeof(BACNET_READ_RANGE_DATA));
+    request->RequestType = type;
+    request->Range.RefIndex = index;
+    request->Count = count;
+    request->Overhead = RR_OVERHEAD;
+}
+
+/**
+ * @brief Test the pages of a list by position and by sequence number,
+ *  and the result flags of each page
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(readrange_tests, testReadRangeElementList)
+#else
+static void testReadRangeElementList(void)
+#endif
+{
+    BACNET_READ_RANGE_DATA request = { 0 };
+    BACNET_UNSIGNED_INTEGER value = 0;
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint32_t next = 1;
+    unsigned pages = 0;
+    int len = 0;
+
+    /* the middle of the list */
+    test_request_init(&request, RR_BY_POSITION, 10, 5);
+    len = read_range_element_list_encode(
+        apdu, MAX_APDU, &request, test_element_encode, TEST_ELEMENTS);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_equal(request.FirstSequence, 10, NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    zassert_true(bacnet_unsigned_application_decode(apdu, len, &value) > 0,
+        NULL);
+    zassert_equal(value, 0, NULL);
+    /* the items before the reference, from the first item */
+    test_request_init(&request, RR_BY_SEQUENCE, 3, -10);
+    len = read_range_element_list_encode(
+        apdu, MAX_APDU, &request, test_element_encode, TEST_ELEMENTS);
+    zassert_equal(request.ItemCount, 3, NULL);
+    zassert_equal(request.FirstSequence, 1, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    /* past the end */
+    test_request_init(&request, RR_BY_POSITION, TEST_ELEMENTS + 1, 5);
+    len = read_range_element_list_encode(
+        apdu, MAX_APDU, &request, test_element_encode, TEST_ELEMENTS);
+    zassert_equal(len, 0, NULL);
+    zassert_equal(request.ItemCount, 0, NULL);
+    /* page through the whole list in small ACKs */
+    do {
+        test_request_init(&request, RR_BY_POSITION, next, TEST_ELEMENTS);
+        len = read_range_element_list_encode(
+            apdu, RR_OVERHEAD + 50, &request, test_element_encode,
+            TEST_ELEMENTS);
+        zassert_true(len > 0, NULL);
+        zassert_true(len <= 50, NULL);
+        zassert_equal(request.FirstSequence, next, NULL);
+        zassert_equal(
+            bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM),
+            (next == 1), NULL);
+        next += request.ItemCount;
+        pages++;
+    } while (bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS));
+    zassert_equal(next, TEST_ELEMENTS + 1, NULL);
+    zassert_true(pages > 1, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    /* all of the list, or nothing fits */
+    test_request_init(&request, RR_READ_ALL, 0, 0);
+    len = read_range_element_list_encode(
+        NULL, MAX_APDU, &request, test_element_encode, TEST_ELEMENTS);
+    zassert_true(len > 0, NULL);
+    zassert_equal(request.ItemCount, TEST_ELEMENTS, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    len = read_range_element_list_encode(
+        apdu, RR_OVERHEAD + 1, &request, test_element_encode, TEST_ELEMENTS);
+    zassert_equal(len, BACNET_STATUS_ABORT, NULL);
+    len = read_range_element_list_encode(
+        apdu, MAX_APDU, &request, test_element_encode, TEST_ELEMENTS + 1);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(readrange_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(
+        readrange_tests, ztest_unit_test(testReadRangeElementList));
+
+    ztest_run_test_suite(readrange_tests);
+}
+#endif
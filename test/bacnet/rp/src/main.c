@@ -202,6 +202,107 @@ static void testReadProperty(void)
 
     return;
 }
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(rp_tests, testReadPropertyDecodeVectors)
+#else
+static void testReadPropertyDecodeVectors(void)
+#endif
+{
+    struct rp_decode_vector {
+        uint8_t apdu[12];
+        unsigned apdu_len;
+        int len;
+        BACNET_OBJECT_TYPE object_type;
+        uint32_t object_instance;
+        BACNET_PROPERTY_ID object_property;
+        BACNET_ARRAY_INDEX array_index;
+    } vectors[] = {
+        /* canonical, no array index */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x19, 0x4B }, 7, 7, OBJECT_DEVICE,
+            1, PROP_OBJECT_IDENTIFIER, BACNET_ARRAY_ALL },
+        /* canonical with array index */
+        { { 0x0C, 0x00, 0x00, 0x00, 0x05, 0x19, 0x55, 0x29, 0x03 }, 9, 9,
+            OBJECT_ANALOG_INPUT, 5, PROP_PRESENT_VALUE, 3 },
+        /* two octet property and array index */
+        { { 0x0C, 0x02, 0x3F, 0xFF, 0xFF, 0x1A, 0x01, 0x00, 0x2A, 0x01,
+              0x00 },
+            11, 11, OBJECT_DEVICE, BACNET_MAX_INSTANCE, 256, 256 },
+        /* extended length property tag */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x1D, 0x01, 0x4B }, 8, 8,
+            OBJECT_DEVICE, 1, PROP_OBJECT_IDENTIFIER, BACNET_ARRAY_ALL },
+        /* trailing octet after the property */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x19, 0x4B, 0x00 }, 8,
+            BACNET_STATUS_REJECT, OBJECT_NONE, 0, MAX_BACNET_PROPERTY_ID,
+            BACNET_ARRAY_ALL },
+        /* trailing octet after the array index */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x19, 0x4B, 0x29, 0x03, 0xFF }, 10,
+            BACNET_STATUS_REJECT, OBJECT_NONE, 0, MAX_BACNET_PROPERTY_ID,
+            BACNET_ARRAY_ALL },
+        /* truncated array index */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x19, 0x4B, 0x2A, 0x01 }, 9,
+            BACNET_STATUS_REJECT, OBJECT_NONE, 0, MAX_BACNET_PROPERTY_ID,
+            BACNET_ARRAY_ALL },
+        /* truncated property identifier */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x1C, 0x4B }, 7,
+            BACNET_STATUS_REJECT, OBJECT_NONE, 0, MAX_BACNET_PROPERTY_ID,
+            BACNET_ARRAY_ALL },
+        /* wrong object identifier tag */
+        { { 0x1C, 0x02, 0x00, 0x00, 0x01, 0x19, 0x4B }, 7,
+            BACNET_STATUS_REJECT, OBJECT_NONE, 0, MAX_BACNET_PROPERTY_ID,
+            BACNET_ARRAY_ALL },
+        /* wrong property identifier tag */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x29, 0x4B }, 7,
+            BACNET_STATUS_REJECT, OBJECT_NONE, 0, MAX_BACNET_PROPERTY_ID,
+            BACNET_ARRAY_ALL },
+        /* too short */
+        { { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x19 }, 6, BACNET_STATUS_REJECT,
+            OBJECT_NONE, 0, MAX_BACNET_PROPERTY_ID, BACNET_ARRAY_ALL },
+    };
+    BACNET_READ_PROPERTY_DATA test_data = { 0 };
+    unsigned i;
+    int len;
+
+    for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        len = rp_decode_service_request(
+            vectors[i].apdu, vectors[i].apdu_len, &test_data);
+        zassert_equal(len, vectors[i].len, "vector=%u len=%d", i, len);
+        if (len > 0) {
+            zassert_equal(
+                test_data.object_type, vectors[i].object_type, "vector=%u", i);
+            zassert_equal(
+                test_data.object_instance, vectors[i].object_instance,
+                "vector=%u", i);
+            zassert_equal(
+                test_data.object_property, vectors[i].object_property,
+                "vector=%u", i);
+            zassert_equal(
+                test_data.array_index, vectors[i].array_index, "vector=%u", i);
+        }
+    }
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(rp_tests, testReadPropertyDecodeInstances)
+#else
+static void testReadPropertyDecodeInstances(void)
+#endif
+{
+    uint8_t apdu[] = { 0x0C, 0x00, 0x00, 0x00, 0x05, 0x19, 0x55, 0x29, 0x03 };
+    BACNET_READ_PROPERTY_DATA test_data = { 0 };
+    unsigned i;
+    int len;
+
+    /* the same request buffer decoded again for each object instance */
+    for (i = 0; i < 256; i++) {
+        apdu[4] = (uint8_t)i;
+        len = rp_decode_service_request(apdu, sizeof(apdu), &test_data);
+        zassert_equal(len, sizeof(apdu), "instance=%u", i);
+        zassert_equal(test_data.object_type, OBJECT_ANALOG_INPUT, NULL);
+        zassert_equal(test_data.object_instance, i, NULL);
+        zassert_equal(test_data.object_property, PROP_PRESENT_VALUE, NULL);
+        zassert_equal(test_data.array_index, 3, NULL);
+    }
+}
 /**
  * @}
  */
@@ -213,7 +314,9 @@ void test_main(void)
 {
     ztest_test_suite(
         rp_tests, ztest_unit_test(testReadProperty),
-        ztest_unit_test(testReadPropertyAck));
+        ztest_unit_test(testReadPropertyAck),
+        ztest_unit_test(testReadPropertyDecodeVectors),
+        ztest_unit_test(testReadPropertyDecodeInstances));
 
     ztest_run_test_suite(rp_tests);
 }
@@ -194,6 +194,15 @@ static void testReadPropertyMultiple(void)
     zassert_equal(len, service_request_len, NULL);
 }
 
+static unsigned Property_Process_Count;
+static void testPropertyProcess(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    zassert_equal(device_id, 123, NULL);
+    zassert_not_null(rp_data, NULL);
+    Property_Process_Count++;
+}
+
 #if defined(CONFIG_ZTEST_NEW_API)
 ZTEST(rpm_tests, testReadPropertyMultipleAck)
 #else
@@ -219,6 +228,7 @@ static void testReadPropertyMultipleAck(void)
     BACNET_ERROR_CLASS error_class;
     BACNET_ERROR_CODE error_code;
     BACNET_RPM_DATA rpmdata;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
 
     /* build the RPM - try to make it easy for the
        Application Layer development */
@@ -421,6 +431,130 @@ static void testReadPropertyMultipleAck(void)
         &object_instance);
     zassert_equal(test_len, 0, NULL);
     zassert_equal(len, service_request_len, NULL);
+    /* process every result of every object */
+    Property_Process_Count = 0;
+    rpm_ack_object_property_process(service_request, service_request_len,
+        123, &rp_data, testPropertyProcess);
+    zassert_equal(Property_Process_Count, 4, NULL);
+    zassert_equal(rp_data.object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(rp_data.object_instance, 33, NULL);
+    zassert_equal(rp_data.object_property, PROP_DEADBAND, NULL);
+    zassert_equal(rp_data.error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+}
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(rpm_tests, testReadPropertyMultipleDecodeVectors)
+#else
+static void testReadPropertyMultipleDecodeVectors(void)
+#endif
+{
+    struct rpm_decode_vector {
+        uint8_t apdu[8];
+        unsigned apdu_len;
+        int len;
+        BACNET_PROPERTY_ID object_property;
+        BACNET_ARRAY_INDEX array_index;
+    } vectors[] = {
+        /* canonical, no array index, before the closing tag */
+        { { 0x09, 0x4B, 0x1F }, 3, 2, PROP_OBJECT_IDENTIFIER,
+            BACNET_ARRAY_ALL },
+        /* canonical, followed by another property */
+        { { 0x09, 0x4B, 0x09, 0x55 }, 4, 2, PROP_OBJECT_IDENTIFIER,
+            BACNET_ARRAY_ALL },
+        /* canonical with array index */
+        { { 0x09, 0x55, 0x19, 0x03, 0x1F }, 5, 4, PROP_PRESENT_VALUE, 3 },
+        /* two octet property and array index */
+        { { 0x0A, 0x01, 0x00, 0x1A, 0x01, 0x00, 0x1F }, 7, 6, 256, 256 },
+        /* extended length property tag */
+        { { 0x0D, 0x01, 0x4B, 0x1F }, 4, 3, PROP_OBJECT_IDENTIFIER,
+            BACNET_ARRAY_ALL },
+        /* some other context tag is not an array index */
+        { { 0x09, 0x4B, 0x29, 0x02, 0x1F }, 5, 2, PROP_OBJECT_IDENTIFIER,
+            BACNET_ARRAY_ALL },
+        /* missing closing tag after the property */
+        { { 0x09, 0x4B }, 2, BACNET_STATUS_REJECT, MAX_BACNET_PROPERTY_ID,
+            BACNET_ARRAY_ALL },
+        /* missing closing tag after the array index */
+        { { 0x09, 0x55, 0x19, 0x03 }, 4, BACNET_STATUS_REJECT,
+            MAX_BACNET_PROPERTY_ID, BACNET_ARRAY_ALL },
+        /* wrong property identifier tag */
+        { { 0x19, 0x4B, 0x1F }, 3, BACNET_STATUS_REJECT,
+            MAX_BACNET_PROPERTY_ID, BACNET_ARRAY_ALL },
+        /* application tag */
+        { { 0x91, 0x4B, 0x1F }, 3, BACNET_STATUS_REJECT,
+            MAX_BACNET_PROPERTY_ID, BACNET_ARRAY_ALL },
+    };
+    uint8_t object_apdu[] = { 0x0C, 0x02, 0x00, 0x00, 0x01, 0x1E, 0x09 };
+    BACNET_RPM_DATA test_data = { 0 };
+    unsigned i;
+    int len;
+
+    for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        len = rpm_decode_object_property(
+            vectors[i].apdu, vectors[i].apdu_len, &test_data);
+        zassert_equal(len, vectors[i].len, "vector=%u len=%d", i, len);
+        if (len > 0) {
+            zassert_equal(
+                test_data.object_property, vectors[i].object_property,
+                "vector=%u", i);
+            zassert_equal(
+                test_data.array_index, vectors[i].array_index, "vector=%u", i);
+        }
+    }
+    len = rpm_decode_object_id(object_apdu, sizeof(object_apdu), &test_data);
+    zassert_equal(len, 6, NULL);
+    zassert_equal(test_data.object_type, OBJECT_DEVICE, NULL);
+    zassert_equal(test_data.object_instance, 1, NULL);
+    /* wrong opening tag */
+    object_apdu[5] = 0x2E;
+    len = rpm_decode_object_id(object_apdu, sizeof(object_apdu), &test_data);
+    zassert_equal(len, BACNET_STATUS_REJECT, NULL);
+    /* wrong object identifier tag */
+    object_apdu[5] = 0x1E;
+    object_apdu[0] = 0x1C;
+    len = rpm_decode_object_id(object_apdu, sizeof(object_apdu), &test_data);
+    zassert_equal(len, BACNET_STATUS_REJECT, NULL);
+    /* too short */
+    len = rpm_decode_object_id(object_apdu, 4, &test_data);
+    zassert_equal(len, BACNET_STATUS_REJECT, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(rpm_tests, testReadPropertyMultipleDecodeList)
+#else
+static void testReadPropertyMultipleDecodeList(void)
+#endif
+{
+    /* one object with four properties, one of them with an array index */
+    uint8_t apdu[] = { 0x0C, 0x00, 0x00, 0x00, 0x05, 0x1E, 0x09, 0x55,
+        0x09, 0x4D, 0x09, 0x6F, 0x09, 0x57, 0x19, 0x10, 0x1F };
+    static const BACNET_PROPERTY_ID properties[] = { PROP_PRESENT_VALUE,
+        PROP_OBJECT_NAME, PROP_STATUS_FLAGS, PROP_PRIORITY_ARRAY };
+    static const BACNET_ARRAY_INDEX array_index[] = { BACNET_ARRAY_ALL,
+        BACNET_ARRAY_ALL, BACNET_ARRAY_ALL, 16 };
+    BACNET_RPM_DATA test_data = { 0 };
+    unsigned offset;
+    unsigned i;
+    int len;
+
+    len = rpm_decode_object_id(apdu, sizeof(apdu), &test_data);
+    zassert_equal(len, 6, NULL);
+    zassert_equal(test_data.object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(test_data.object_instance, 5, NULL);
+    offset = len;
+    for (i = 0; i < ARRAY_SIZE(properties); i++) {
+        zassert_equal(
+            rpm_decode_object_end(&apdu[offset], sizeof(apdu) - offset), 0,
+            NULL);
+        len = rpm_decode_object_property(
+            &apdu[offset], sizeof(apdu) - offset, &test_data);
+        zassert_true(len > 0, "property=%u", i);
+        zassert_equal(test_data.object_property, properties[i], NULL);
+        zassert_equal(test_data.array_index, array_index[i], NULL);
+        offset += len;
+    }
+    zassert_equal(
+        rpm_decode_object_end(&apdu[offset], sizeof(apdu) - offset), 1, NULL);
+    zassert_equal(offset + 1, sizeof(apdu), NULL);
 }
 /**
  * @}
@@ -433,7 +567,9 @@ void test_main(void)
 {
     ztest_test_suite(
         rpm_tests, ztest_unit_test(testReadPropertyMultiple),
-        ztest_unit_test(testReadPropertyMultipleAck));
+        ztest_unit_test(testReadPropertyMultipleAck),
+        ztest_unit_test(testReadPropertyMultipleDecodeVectors),
+        ztest_unit_test(testReadPropertyMultipleDecodeList));
 
     ztest_run_test_suite(rpm_tests);
 }
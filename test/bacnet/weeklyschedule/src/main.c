@@ -93,6 +93,95 @@ static void test_BACnetWeeklySchedule(void)
     zassert_true(apdu_len < 0, NULL);
 }
 
+/**
+ * @brief Test the compact weekly schedule, which is encoded the same as
+ *  the BACnetWeeklySchedule and decoded in place
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(BACnetWeeklySchedule_tests, test_BACnetWeeklySchedule_List)
+#else
+static void test_BACnetWeeklySchedule_List(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t test_apdu[MAX_APDU] = { 0 };
+    BACNET_TIME_VALUE storage[4] = { 0 };
+    BACNET_TIME_VALUE time_values[3] = { 0 };
+    BACNET_WEEKLY_SCHEDULE_LIST list = { 0 };
+    BACNET_WEEKLY_SCHEDULE value = { 0 };
+    BACNET_TIME_VALUE *day = NULL;
+    unsigned i;
+    int len, test_len;
+
+    for (i = 0; i < 3; i++) {
+        datetime_set_time(&time_values[i].Time, 8 + i, 0, 0, 0);
+        time_values[i].Value.tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+        time_values[i].Value.type.Unsigned_Int = i + 1;
+    }
+    bacnet_weeklyschedule_list_init(&list, storage, 4);
+    for (i = 0; i < 7; i++) {
+        zassert_equal(bacnet_weeklyschedule_list_day_count(&list, i), 0, NULL);
+    }
+    zassert_true(
+        bacnet_weeklyschedule_list_day_set(&list, 6, time_values, 1), NULL);
+    zassert_true(
+        bacnet_weeklyschedule_list_day_set(&list, 2, time_values, 3), NULL);
+    zassert_equal(list.Day_Start[7], 4, NULL);
+    /* the storage is shared by the days */
+    zassert_false(
+        bacnet_weeklyschedule_list_day_set(&list, 0, time_values, 1), NULL);
+    zassert_false(
+        bacnet_weeklyschedule_list_day_set(&list, 7, time_values, 1), NULL);
+    day = bacnet_weeklyschedule_list_day(&list, 6);
+    zassert_equal(day->Value.type.Unsigned_Int, 1, NULL);
+    /* same as the BACnetWeeklySchedule encoding */
+    value.weeklySchedule[2].TV_Count = 3;
+    memcpy(value.weeklySchedule[2].Time_Values, time_values,
+        sizeof(time_values));
+    value.weeklySchedule[6].TV_Count = 1;
+    memcpy(value.weeklySchedule[6].Time_Values, time_values,
+        sizeof(BACNET_TIME_VALUE));
+    len = bacnet_weeklyschedule_encode(apdu, &value);
+    zassert_equal(bacnet_weeklyschedule_list_encode(NULL, &list), len, NULL);
+    test_len = bacnet_weeklyschedule_list_encode(test_apdu, &list);
+    zassert_equal(test_len, len, NULL);
+    zassert_mem_equal(test_apdu, apdu, len, NULL);
+    /* a smaller day moves the days that follow */
+    zassert_true(
+        bacnet_weeklyschedule_list_day_set(&list, 2, &time_values[1], 1), NULL);
+    zassert_equal(bacnet_weeklyschedule_list_day_count(&list, 2), 1, NULL);
+    day = bacnet_weeklyschedule_list_day(&list, 2);
+    zassert_equal(day->Value.type.Unsigned_Int, 2, NULL);
+    day = bacnet_weeklyschedule_list_day(&list, 6);
+    zassert_equal(day->Value.type.Unsigned_Int, 1, NULL);
+    /* decode the whole week in place */
+    test_len = bacnet_weeklyschedule_list_decode(apdu, len, &list);
+    zassert_equal(test_len, len, NULL);
+    zassert_equal(bacnet_weeklyschedule_list_day_count(&list, 2), 3, NULL);
+    zassert_equal(bacnet_weeklyschedule_list_day_count(&list, 6), 1, NULL);
+    test_len = bacnet_weeklyschedule_list_encode(test_apdu, &list);
+    zassert_mem_equal(test_apdu, apdu, len, NULL);
+    /* decode one day in place */
+    len = bacnet_weeklyschedule_list_day_encode(apdu, &list, 6);
+    zassert_equal(
+        bacnet_weeklyschedule_list_day_decode(apdu, len, &list, 2), len, NULL);
+    zassert_equal(bacnet_weeklyschedule_list_day_count(&list, 2), 1, NULL);
+    zassert_equal(
+        bacnet_weeklyschedule_list_day_decode(apdu, len, &list, 0), len, NULL);
+    zassert_equal(bacnet_weeklyschedule_list_day_count(&list, 0), 1, NULL);
+    zassert_equal(list.Day_Start[7], 3, NULL);
+    /* the day does not fit, or is not valid, and nothing is changed */
+    len = bacnet_dailyschedule_context_encode(
+        apdu, 0, &value.weeklySchedule[2]);
+    zassert_equal(bacnet_weeklyschedule_list_day_decode(apdu, len, &list, 1),
+        BACNET_STATUS_ABORT, NULL);
+    zassert_equal(
+        bacnet_weeklyschedule_list_day_decode(apdu, len - 1, &list, 0),
+        BACNET_STATUS_ERROR, NULL);
+    zassert_equal(bacnet_weeklyschedule_list_day_count(&list, 0), 1, NULL);
+    zassert_equal(list.Day_Start[7], 3, NULL);
+}
+
 /**
  * @}
  */
@@ -103,7 +192,8 @@ ZTEST_SUITE(BACnetWeeklySchedule_tests, NULL, NULL, NULL, NULL, NULL);
 void test_main(void)
 {
     ztest_test_suite(
-        BACnetWeeklySchedule_tests, ztest_unit_test(test_BACnetWeeklySchedule));
+        BACnetWeeklySchedule_tests, ztest_unit_test(test_BACnetWeeklySchedule),
+        ztest_unit_test(test_BACnetWeeklySchedule_List));
 
     ztest_run_test_suite(BACnetWeeklySchedule_tests);
 }
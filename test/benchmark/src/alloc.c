@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief Count the heap allocations of the benchmarks. The allocation
+ *  functions are wrapped by the linker (--wrap=malloc and so on) when
+ *  BENCH_ALLOC_COUNT is defined, and are not counted otherwise.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "bench.h"
+
+static unsigned long Alloc_Count;
+
+#if defined(BENCH_ALLOC_COUNT)
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    Alloc_Count++;
+
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    Alloc_Count++;
+
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    Alloc_Count++;
+
+    return __real_realloc(ptr, size);
+}
+#endif
+
+/**
+ * @brief Determine if the heap allocations are counted
+ * @return true if they are counted
+ */
+bool bench_alloc_counted(void)
+{
+#if defined(BENCH_ALLOC_COUNT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Get the number of heap allocations so far
+ * @return number of calls to malloc, calloc and realloc
+ */
+unsigned long bench_alloc_count(void)
+{
+    return Alloc_Count;
+}
@@ -0,0 +1,308 @@
+/**
+ * @file
+ * @brief Benchmarks of the encoding and decoding of primitives,
+ *  application data, NPDU and BVLC
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bacstr.h"
+#include "bacnet/npdu.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#if defined(BENCH_BVLC)
+#include "bacnet/datalink/bvlc.h"
+#endif
+#include "bench.h"
+
+static uint8_t Bench_Buffer[MAX_APDU];
+
+unsigned long bench_unsigned_encode(unsigned long count)
+{
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        sum += (unsigned long)encode_application_unsigned(
+            Bench_Buffer, (BACNET_UNSIGNED_INTEGER)i * 2654435761UL);
+    }
+
+    return sum;
+}
+
+unsigned long bench_unsigned_decode(unsigned long count)
+{
+    BACNET_UNSIGNED_INTEGER value = 0;
+    unsigned long i, sum = 0;
+    int len;
+
+    len = encode_application_unsigned(Bench_Buffer, 0x12345678UL);
+    for (i = 0; i < count; i++) {
+        if (bacnet_unsigned_application_decode(
+                Bench_Buffer, (uint32_t)len, &value) > 0) {
+            sum += (unsigned long)value;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_real_encode(unsigned long count)
+{
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        sum += (unsigned long)encode_application_real(
+            Bench_Buffer, (float)i * 0.5f);
+    }
+
+    return sum;
+}
+
+unsigned long bench_real_decode(unsigned long count)
+{
+    float value = 0.0f;
+    unsigned long i, sum = 0;
+    int len;
+
+    len = encode_application_real(Bench_Buffer, 72.5f);
+    for (i = 0; i < count; i++) {
+        if (bacnet_real_application_decode(
+                Bench_Buffer, (uint32_t)len, &value) > 0) {
+            sum += (unsigned long)value;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_character_string_encode(unsigned long count)
+{
+    BACNET_CHARACTER_STRING value;
+    unsigned long i, sum = 0;
+
+    characterstring_init_ansi(&value, "Analog Value 1 - Zone Temperature");
+    for (i = 0; i < count; i++) {
+        sum += (unsigned long)encode_application_character_string(
+            Bench_Buffer, &value);
+    }
+
+    return sum;
+}
+
+unsigned long bench_character_string_decode(unsigned long count)
+{
+    BACNET_CHARACTER_STRING value;
+    unsigned long i, sum = 0;
+    int len;
+
+    characterstring_init_ansi(&value, "Analog Value 1 - Zone Temperature");
+    len = encode_application_character_string(Bench_Buffer, &value);
+    for (i = 0; i < count; i++) {
+        if (bacnet_character_string_application_decode(
+                Bench_Buffer, (uint32_t)len, &value) > 0) {
+            sum += characterstring_length(&value);
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_object_id_encode(unsigned long count)
+{
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        sum += (unsigned long)encode_application_object_id(Bench_Buffer,
+            OBJECT_ANALOG_VALUE, (uint32_t)(i & BACNET_MAX_INSTANCE));
+    }
+
+    return sum;
+}
+
+unsigned long bench_object_id_decode(unsigned long count)
+{
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    unsigned long i, sum = 0;
+    int len;
+
+    len = encode_application_object_id(Bench_Buffer, OBJECT_DEVICE, 260001);
+    for (i = 0; i < count; i++) {
+        if (bacnet_object_id_application_decode(Bench_Buffer, (uint32_t)len,
+                &object_type, &object_instance) > 0) {
+            sum += object_instance;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_bacapp_encode(unsigned long count)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    unsigned long i, sum = 0;
+
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    for (i = 0; i < count; i++) {
+        value.type.Real = (float)i;
+        sum += (unsigned long)bacapp_encode_application_data(
+            Bench_Buffer, &value);
+    }
+
+    return sum;
+}
+
+unsigned long bench_bacapp_decode(unsigned long count)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    unsigned long i, sum = 0;
+    int len;
+
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 72.5f;
+    len = bacapp_encode_application_data(Bench_Buffer, &value);
+    for (i = 0; i < count; i++) {
+        if (bacapp_decode_application_data(
+                Bench_Buffer, (uint32_t)len, &value) > 0) {
+            sum += value.tag;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_npdu_encode(unsigned long count)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned long i, sum = 0;
+
+    dest.net = 2001;
+    dest.len = 1;
+    dest.adr[0] = 0x7F;
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    for (i = 0; i < count; i++) {
+        dest.adr[0] = (uint8_t)i;
+        sum += (unsigned long)npdu_encode_pdu(
+            Bench_Buffer, &dest, NULL, &npdu_data);
+    }
+
+    return sum;
+}
+
+unsigned long bench_npdu_decode(unsigned long count)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    unsigned long i, sum = 0;
+    int len;
+
+    dest.net = 2001;
+    dest.len = 1;
+    dest.adr[0] = 0x7F;
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(Bench_Buffer, &dest, NULL, &npdu_data);
+    for (i = 0; i < count; i++) {
+        if (bacnet_npdu_decode(Bench_Buffer, (uint16_t)len, &dest, &src,
+                &npdu_data) > 0) {
+            sum += dest.net;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_rp_decode(unsigned long count)
+{
+    uint8_t apdu[] = { 0x0C, 0x00, 0x00, 0x00, 0x05, 0x19, 0x55, 0x29, 0x03 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        apdu[4] = (uint8_t)i;
+        if (rp_decode_service_request(apdu, sizeof(apdu), &rpdata) > 0) {
+            sum += rpdata.object_instance;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_rpm_decode(unsigned long count)
+{
+    /* one object with four properties, one of them with an array index */
+    uint8_t apdu[] = { 0x0C, 0x00, 0x00, 0x00, 0x05, 0x1E, 0x09, 0x55,
+        0x09, 0x4D, 0x09, 0x6F, 0x09, 0x57, 0x19, 0x10, 0x1F };
+    BACNET_RPM_DATA rpmdata = { 0 };
+    unsigned long i, sum = 0;
+    unsigned offset;
+    int len;
+
+    for (i = 0; i < count; i++) {
+        apdu[4] = (uint8_t)i;
+        len = rpm_decode_object_id(apdu, sizeof(apdu), &rpmdata);
+        if (len <= 0) {
+            break;
+        }
+        offset = (unsigned)len;
+        sum += rpmdata.object_instance;
+        while (rpm_decode_object_end(&apdu[offset], sizeof(apdu) - offset) ==
+            0) {
+            len = rpm_decode_object_property(
+                &apdu[offset], sizeof(apdu) - offset, &rpmdata);
+            if (len <= 0) {
+                break;
+            }
+            offset += (unsigned)len;
+            sum += rpmdata.object_property;
+        }
+    }
+
+    return sum;
+}
+
+#if defined(BENCH_BVLC)
+unsigned long bench_bvlc_encode(unsigned long count)
+{
+    static uint8_t npdu[MAX_APDU - 4];
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        sum += (unsigned long)bvlc_encode_original_unicast(Bench_Buffer,
+            sizeof(Bench_Buffer), npdu, sizeof(npdu));
+    }
+
+    return sum;
+}
+
+unsigned long bench_bvlc_decode(unsigned long count)
+{
+    static uint8_t npdu[MAX_APDU - 4];
+    uint8_t message_type = 0;
+    uint16_t length = 0;
+    uint16_t npdu_len = 0;
+    unsigned long i, sum = 0;
+    int len;
+
+    len = bvlc_encode_original_unicast(
+        Bench_Buffer, sizeof(Bench_Buffer), npdu, sizeof(npdu));
+    for (i = 0; i < count; i++) {
+        if (bvlc_decode_header(Bench_Buffer, (uint16_t)len, &message_type,
+                &length) > 0) {
+            (void)bvlc_decode_original_unicast(&Bench_Buffer[4],
+                (uint16_t)(length - 4), npdu, sizeof(npdu), &npdu_len);
+            sum += npdu_len;
+        }
+    }
+
+    return sum;
+}
+#endif
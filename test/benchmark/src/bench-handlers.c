@@ -0,0 +1,302 @@
+/**
+ * @file
+ * @brief Benchmarks of the service handlers: a request is given to the
+ *  NPDU handler, and the reply is taken from the queue of the client on
+ *  the loopback datalink and decoded, which is one round trip.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
+#include "bacnet/npdu.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "bacnet/wpm.h"
+#include "bacnet/datalink/datalink.h"
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/services.h"
+#include "bench.h"
+
+/* the number of subscribers of the COV fan-out */
+#ifndef BENCH_COV_SUBSCRIBERS
+#define BENCH_COV_SUBSCRIBERS 16
+#endif
+
+#define BENCH_DEVICE_INSTANCE 260001
+#define BENCH_OBJECT_INSTANCE 1
+/* MAC addresses of the nodes on the loopback network. The subscribers
+   of the COV fan-out are 1..BENCH_COV_SUBSCRIBERS, which are not
+   attached, so their notifications are sent and lost. */
+#define BENCH_SERVER_MAC 0x80
+#define BENCH_CLIENT_MAC 0xFE
+
+static uint8_t RP_Request[MAX_PDU];
+static uint16_t RP_Request_Len;
+static uint8_t RPM_Request[MAX_PDU];
+static uint16_t RPM_Request_Len;
+static uint8_t WPM_Request[MAX_PDU];
+static uint16_t WPM_Request_Len;
+static BACNET_ADDRESS Client_Address;
+static BACNET_ADDRESS Server_Address;
+static uint8_t Reply_PDU[MAX_PDU];
+static uint8_t Server_PDU[MAX_PDU];
+
+/**
+ * @brief Encode the NPDU of a confirmed request
+ * @param pdu [out] buffer of the request
+ * @return number of octets encoded
+ */
+static int bench_npdu_request_encode(uint8_t *pdu)
+{
+    BACNET_NPDU_DATA npdu_data;
+
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+
+    return npdu_encode_pdu(pdu, NULL, NULL, &npdu_data);
+}
+
+/**
+ * @brief Take the reply from the queue of the client on the loopback
+ *  datalink, and get its APDU
+ * @param apdu_len [out] number of octets of the APDU
+ * @return the APDU, or NULL if there is no reply
+ */
+static uint8_t *bench_reply_apdu(uint16_t *apdu_len)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint16_t pdu_len;
+    int len;
+
+    (void)loopback_node_set(BENCH_CLIENT_MAC);
+    pdu_len = loopback_receive(&src, Reply_PDU, sizeof(Reply_PDU), 0);
+    (void)loopback_node_set(BENCH_SERVER_MAC);
+    if (pdu_len == 0) {
+        return NULL;
+    }
+    len = bacnet_npdu_decode(Reply_PDU, pdu_len, &dest, &src, &npdu_data);
+    if ((len <= 0) || (len >= pdu_len)) {
+        return NULL;
+    }
+    *apdu_len = (uint16_t)(pdu_len - len);
+
+    return &Reply_PDU[len];
+}
+
+/**
+ * @brief Encode a SubscribeCOV request and give it to the handler
+ * @param subscriber - the subscriber, which is also its address
+ */
+static void bench_cov_subscribe(uint8_t subscriber)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[MAX_PDU];
+    int len;
+
+    cov_data.subscriberProcessIdentifier = subscriber;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+    cov_data.monitoredObjectIdentifier.instance = BENCH_OBJECT_INSTANCE;
+    cov_data.issueConfirmedNotifications = false;
+    cov_data.lifetime = 0;
+    len = bench_npdu_request_encode(pdu);
+    len += cov_subscribe_encode_apdu(
+        &pdu[len], sizeof(pdu) - len, subscriber, &cov_data);
+    src.mac_len = 1;
+    src.mac[0] = subscriber;
+    npdu_handler(&src, pdu, (uint16_t)len);
+}
+
+/**
+ * @brief Set up the nodes of the loopback network, the Device and an
+ *  Analog Value object, the handlers, the requests of the round trips,
+ *  and the subscriptions of the COV fan-out
+ */
+void bench_handlers_init(void)
+{
+    static BACNET_PROPERTY_REFERENCE rpm_property[4];
+    static const BACNET_PROPERTY_ID rpm_property_id[4] = { PROP_PRESENT_VALUE,
+        PROP_STATUS_FLAGS, PROP_OBJECT_NAME, PROP_UNITS };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_READ_ACCESS_DATA rpm_data = { 0 };
+    BACNET_WRITE_ACCESS_DATA wpm_data = { 0 };
+    BACNET_PROPERTY_VALUE wpm_value = { 0 };
+    unsigned i;
+    int len;
+
+    (void)loopback_node_set(BENCH_CLIENT_MAC);
+    loopback_get_my_address(&Client_Address);
+    (void)loopback_node_set(BENCH_SERVER_MAC);
+    loopback_get_my_address(&Server_Address);
+    Device_Init(NULL);
+    Device_Set_Object_Instance_Number(BENCH_DEVICE_INSTANCE);
+    Analog_Value_Create(BENCH_OBJECT_INSTANCE);
+    apdu_set_unrecognized_service_handler_handler(handler_unrecognized_service);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, handler_read_property_multiple);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, handler_write_property_multiple);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
+    handler_cov_init();
+    /* ReadProperty of the Present_Value */
+    rpdata.object_type = OBJECT_ANALOG_VALUE;
+    rpdata.object_instance = BENCH_OBJECT_INSTANCE;
+    rpdata.object_property = PROP_PRESENT_VALUE;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    len = bench_npdu_request_encode(RP_Request);
+    len += rp_encode_apdu(&RP_Request[len], 1, &rpdata);
+    RP_Request_Len = (uint16_t)len;
+    /* ReadPropertyMultiple of four properties */
+    for (i = 0; i < 4; i++) {
+        rpm_property[i].propertyIdentifier = rpm_property_id[i];
+        rpm_property[i].propertyArrayIndex = BACNET_ARRAY_ALL;
+        rpm_property[i].next = (i < 3) ? &rpm_property[i + 1] : NULL;
+    }
+    rpm_data.object_type = OBJECT_ANALOG_VALUE;
+    rpm_data.object_instance = BENCH_OBJECT_INSTANCE;
+    rpm_data.listOfProperties = &rpm_property[0];
+    len = bench_npdu_request_encode(RPM_Request);
+    len += rpm_encode_apdu(
+        &RPM_Request[len], sizeof(RPM_Request) - len, 2, &rpm_data);
+    RPM_Request_Len = (uint16_t)len;
+    /* WritePropertyMultiple of the Present_Value */
+    wpm_value.propertyIdentifier = PROP_PRESENT_VALUE;
+    wpm_value.propertyArrayIndex = BACNET_ARRAY_ALL;
+    wpm_value.value.tag = BACNET_APPLICATION_TAG_REAL;
+    wpm_value.value.type.Real = 21.5f;
+    wpm_value.priority = 8;
+    wpm_data.object_type = OBJECT_ANALOG_VALUE;
+    wpm_data.object_instance = BENCH_OBJECT_INSTANCE;
+    wpm_data.listOfProperties = &wpm_value;
+    len = bench_npdu_request_encode(WPM_Request);
+    len += wpm_encode_apdu(
+        &WPM_Request[len], sizeof(WPM_Request) - len, 3, &wpm_data);
+    WPM_Request_Len = (uint16_t)len;
+    /* subscriptions of the COV fan-out */
+    for (i = 0; i < BENCH_COV_SUBSCRIBERS; i++) {
+        bench_cov_subscribe((uint8_t)(i + 1));
+    }
+}
+
+unsigned long bench_rp_round_trip(unsigned long count)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    uint8_t *apdu;
+    uint16_t apdu_len = 0;
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        npdu_handler(&Client_Address, RP_Request, RP_Request_Len);
+        apdu = bench_reply_apdu(&apdu_len);
+        if (apdu && (apdu_len > 3) && (apdu[0] == PDU_TYPE_COMPLEX_ACK) &&
+            (rp_ack_decode_service_request(&apdu[3], apdu_len - 3, &rpdata) >
+                0)) {
+            sum += rpdata.application_data_len;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_rpm_round_trip(unsigned long count)
+{
+    uint8_t *apdu;
+    uint16_t apdu_len = 0;
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        npdu_handler(&Client_Address, RPM_Request, RPM_Request_Len);
+        apdu = bench_reply_apdu(&apdu_len);
+        if (apdu && (apdu[0] == PDU_TYPE_COMPLEX_ACK)) {
+            sum += apdu_len;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_wpm_round_trip(unsigned long count)
+{
+    uint8_t *apdu;
+    uint16_t apdu_len = 0;
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        npdu_handler(&Client_Address, WPM_Request, WPM_Request_Len);
+        apdu = bench_reply_apdu(&apdu_len);
+        if (apdu && (apdu[0] == PDU_TYPE_SIMPLE_ACK)) {
+            sum += apdu_len;
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Send a ReadProperty request from the client node, and run one
+ *  pass of the receive loop of a server on the server node, as in
+ *  apps/server, before the client takes the reply
+ */
+unsigned long bench_rp_server_loop(unsigned long count)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t *apdu;
+    uint16_t apdu_len = 0;
+    uint16_t pdu_len;
+    unsigned long i, sum = 0;
+
+    for (i = 0; i < count; i++) {
+        (void)loopback_node_set(BENCH_CLIENT_MAC);
+        (void)datalink_send_pdu(
+            &Server_Address, NULL, RP_Request, RP_Request_Len);
+        (void)loopback_node_set(BENCH_SERVER_MAC);
+        pdu_len = datalink_receive(&src, Server_PDU, sizeof(Server_PDU), 0);
+        if (pdu_len) {
+            npdu_handler(&src, Server_PDU, pdu_len);
+        }
+        apdu = bench_reply_apdu(&apdu_len);
+        if (apdu && (apdu_len > 3) && (apdu[0] == PDU_TYPE_COMPLEX_ACK) &&
+            (rp_ack_decode_service_request(&apdu[3], apdu_len - 3, &rpdata) >
+                0)) {
+            sum += rpdata.application_data_len;
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Change the Present_Value of the monitored object, and run the
+ *  COV task until the notifications of each subscriber were sent
+ */
+unsigned long bench_cov_fan_out(unsigned long count)
+{
+    LOOPBACK_STATS stats = { 0 };
+    unsigned long i, sum = 0;
+
+    loopback_stats_reset();
+    for (i = 0; i < count; i++) {
+        Analog_Value_Present_Value_Set(
+            BENCH_OBJECT_INSTANCE, (i & 1) ? 10.0f : 20.0f, 16);
+        while (!handler_cov_fsm()) {
+            /* keep going until the end of a cycle */
+        }
+    }
+    loopback_stats(&stats);
+    sum = stats.sent;
+
+    return sum;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file
+ * @brief Benchmarks of the address cache, the TSM, and the Keylist
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/npdu.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bacnet/basic/tsm/tsm.h"
+#include "bench.h"
+
+/* the number of devices in the address cache */
+#ifndef BENCH_ADDRESS_DEVICES
+#define BENCH_ADDRESS_DEVICES 128
+#endif
+/* the number of nodes in the Keylist */
+#ifndef BENCH_KEYLIST_NODES
+#define BENCH_KEYLIST_NODES 1024
+#endif
+
+static bool Address_Filled;
+static OS_Keylist Bench_Keylist;
+static uint32_t Bench_Keylist_Data[BENCH_KEYLIST_NODES];
+
+static void bench_keylist_fill(void);
+
+/**
+ * @brief Fill the address cache with devices 1..BENCH_ADDRESS_DEVICES,
+ *  once, so that the operations are timed without the setup
+ */
+static void bench_address_fill(void)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint32_t device_id;
+
+    if (Address_Filled) {
+        return;
+    }
+    Address_Filled = true;
+    address_init();
+    src.mac_len = 1;
+    for (device_id = 1; device_id <= BENCH_ADDRESS_DEVICES; device_id++) {
+        src.mac[0] = (uint8_t)device_id;
+        address_add(device_id, MAX_APDU, &src);
+    }
+}
+
+/**
+ * @brief Set up the address cache and the Keylist of the benchmarks
+ */
+void bench_sys_init(void)
+{
+    bench_address_fill();
+    bench_keylist_fill();
+}
+
+unsigned long bench_address_lookup(unsigned long count)
+{
+    BACNET_ADDRESS src = { 0 };
+    unsigned max_apdu = 0;
+    unsigned long i, sum = 0;
+
+    bench_address_fill();
+    for (i = 0; i < count; i++) {
+        if (address_get_by_device(
+                (uint32_t)(i % BENCH_ADDRESS_DEVICES) + 1, &max_apdu, &src)) {
+            sum += src.mac[0];
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_address_add(unsigned long count)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint32_t device_id;
+    unsigned long i, sum = 0;
+
+    bench_address_fill();
+    src.mac_len = 1;
+    for (i = 0; i < count; i++) {
+        /* replace a binding with one of a device that is not cached */
+        device_id = (uint32_t)(i % BENCH_ADDRESS_DEVICES) + 1;
+        address_remove_device(device_id);
+        src.mac[0] = (uint8_t)i;
+        address_add(device_id, MAX_APDU, &src);
+        sum += src.mac[0];
+    }
+
+    return sum;
+}
+
+unsigned long bench_tsm_transaction(unsigned long count)
+{
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t apdu[32] = { 0 };
+    uint8_t invoke_id;
+    unsigned long i, sum = 0;
+
+    dest.mac_len = 1;
+    dest.mac[0] = 0x7F;
+    npdu_encode_npdu_data(&npdu_data, true, MESSAGE_PRIORITY_NORMAL);
+    for (i = 0; i < count; i++) {
+        invoke_id = tsm_next_free_invokeID();
+        if (invoke_id) {
+            tsm_set_confirmed_unsegmented_transaction(
+                invoke_id, &dest, &npdu_data, apdu, sizeof(apdu));
+            tsm_free_invoke_id(invoke_id);
+            sum += invoke_id;
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Fill the Keylist with every 7th key, once
+ */
+static void bench_keylist_fill(void)
+{
+    unsigned i;
+
+    if (Bench_Keylist) {
+        return;
+    }
+    Bench_Keylist = Keylist_Create();
+    for (i = 0; i < BENCH_KEYLIST_NODES; i++) {
+        Bench_Keylist_Data[i] = (uint32_t)i;
+        Keylist_Data_Add(Bench_Keylist, (KEY)(i * 7), &Bench_Keylist_Data[i]);
+    }
+}
+
+unsigned long bench_keylist_lookup(unsigned long count)
+{
+    uint32_t *value;
+    unsigned long i, sum = 0;
+
+    bench_keylist_fill();
+    for (i = 0; i < count; i++) {
+        value =
+            Keylist_Data(Bench_Keylist, (KEY)((i % BENCH_KEYLIST_NODES) * 7));
+        if (value) {
+            sum += *value;
+        }
+    }
+
+    return sum;
+}
+
+unsigned long bench_keylist_add_delete(unsigned long count)
+{
+    KEY key;
+    unsigned long i, sum = 0;
+
+    bench_keylist_fill();
+    for (i = 0; i < count; i++) {
+        /* a key between the others, so the nodes after it are moved */
+        key = (KEY)((i % BENCH_KEYLIST_NODES) * 7) + 3;
+        if (Keylist_Data_Add(Bench_Keylist, key, &Bench_Keylist_Data[0]) >=
+            0) {
+            sum++;
+        }
+        (void)Keylist_Data_Delete(Bench_Keylist, key);
+    }
+
+    return sum;
+}
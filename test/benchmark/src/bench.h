@@ -0,0 +1,63 @@
+/**
+ * @file
+ * @brief API of the micro-benchmarks of the BACnet stack
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BENCHMARK_H
+#define BACNET_BENCHMARK_H
+#include <stdbool.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/**
+ * A benchmark runs its operation a number of times, and returns a value
+ * computed from the results so that the work is not optimized away.
+ *
+ * @param count [in] number of operations to run
+ * @return a checksum of the results
+ */
+typedef unsigned long (*bench_function_t)(unsigned long count);
+
+/* codec of primitives, application data, NPDU and BVLC */
+unsigned long bench_unsigned_encode(unsigned long count);
+unsigned long bench_unsigned_decode(unsigned long count);
+unsigned long bench_real_encode(unsigned long count);
+unsigned long bench_real_decode(unsigned long count);
+unsigned long bench_character_string_encode(unsigned long count);
+unsigned long bench_character_string_decode(unsigned long count);
+unsigned long bench_object_id_encode(unsigned long count);
+unsigned long bench_object_id_decode(unsigned long count);
+unsigned long bench_bacapp_encode(unsigned long count);
+unsigned long bench_bacapp_decode(unsigned long count);
+unsigned long bench_npdu_encode(unsigned long count);
+unsigned long bench_npdu_decode(unsigned long count);
+unsigned long bench_rp_decode(unsigned long count);
+unsigned long bench_rpm_decode(unsigned long count);
+#if defined(BENCH_BVLC)
+unsigned long bench_bvlc_encode(unsigned long count);
+unsigned long bench_bvlc_decode(unsigned long count);
+#endif
+
+/* service handlers over the loopback datalink */
+void bench_handlers_init(void);
+unsigned long bench_rp_round_trip(unsigned long count);
+unsigned long bench_rpm_round_trip(unsigned long count);
+unsigned long bench_wpm_round_trip(unsigned long count);
+unsigned long bench_rp_server_loop(unsigned long count);
+unsigned long bench_cov_fan_out(unsigned long count);
+
+/* address cache, TSM and Keylist */
+void bench_sys_init(void);
+unsigned long bench_address_lookup(unsigned long count);
+unsigned long bench_address_add(unsigned long count);
+unsigned long bench_tsm_transaction(unsigned long count);
+unsigned long bench_keylist_lookup(unsigned long count);
+unsigned long bench_keylist_add_delete(unsigned long count);
+
+/* heap allocations, when they are counted */
+bool bench_alloc_counted(void);
+unsigned long bench_alloc_count(void);
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file
+ * @brief Micro-benchmarks of the BACnet stack: codec, service handlers
+ *  over the loopback datalink, COV fan-out, address cache, TSM, and
+ *  Keylist. Each benchmark prints the time and heap allocations of
+ *  one operation.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/version.h"
+#include "bench.h"
+
+/* one benchmark, and its number of operations for a multiplier of 1 */
+struct bench_case {
+    const char *name;
+    bench_function_t function;
+    unsigned long count;
+};
+
+static const struct bench_case Bench_Cases[] = {
+    { "unsigned-encode", bench_unsigned_encode, 10000000UL },
+    { "unsigned-decode", bench_unsigned_decode, 10000000UL },
+    { "real-encode", bench_real_encode, 10000000UL },
+    { "real-decode", bench_real_decode, 10000000UL },
+    { "character-string-encode", bench_character_string_encode, 2000000UL },
+    { "character-string-decode", bench_character_string_decode, 2000000UL },
+    { "object-id-encode", bench_object_id_encode, 10000000UL },
+    { "object-id-decode", bench_object_id_decode, 10000000UL },
+    { "bacapp-encode", bench_bacapp_encode, 5000000UL },
+    { "bacapp-decode", bench_bacapp_decode, 5000000UL },
+    { "npdu-encode", bench_npdu_encode, 10000000UL },
+    { "npdu-decode", bench_npdu_decode, 10000000UL },
+    { "rp-decode", bench_rp_decode, 10000000UL },
+    { "rpm-decode", bench_rpm_decode, 2000000UL },
+#if defined(BENCH_BVLC)
+    { "bvlc-encode", bench_bvlc_encode, 5000000UL },
+    { "bvlc-decode", bench_bvlc_decode, 5000000UL },
+#endif
+    { "rp-round-trip", bench_rp_round_trip, 500000UL },
+    { "rpm-round-trip", bench_rpm_round_trip, 200000UL },
+    { "wpm-round-trip", bench_wpm_round_trip, 200000UL },
+    { "rp-server-loop", bench_rp_server_loop, 500000UL },
+    { "cov-fan-out", bench_cov_fan_out, 20000UL },
+    { "address-lookup", bench_address_lookup, 2000000UL },
+    { "address-add", bench_address_add, 500000UL },
+    { "tsm-transaction", bench_tsm_transaction, 2000000UL },
+    { "keylist-lookup", bench_keylist_lookup, 5000000UL },
+    { "keylist-add-delete", bench_keylist_add_delete, 500000UL },
+};
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--scale N][--list][--version][--help] [name...]\n",
+        filename);
+}
+
+static void print_help(void)
+{
+    printf("Run the micro-benchmarks of the BACnet stack, and print the\n"
+           "nanoseconds and heap allocations of each operation.\n"
+           "\n"
+           "--scale N:\n"
+           "Divide the number of operations of each benchmark by N,\n"
+           "for a quicker run. The default is 1.\n"
+           "\n"
+           "--list:\n"
+           "Print the names of the benchmarks.\n"
+           "\n"
+           "name:\n"
+           "Run only the benchmarks whose names contain one of the names,\n"
+           "such as rp or keylist.\n");
+}
+
+/**
+ * @brief Determine if a benchmark was chosen on the command line
+ * @param name - name of the benchmark
+ * @param argc - number of arguments
+ * @param argv - the arguments, where NULL was put in place of options
+ * @return true if no names were given, or one of them is in the name
+ */
+static bool bench_chosen(const char *name, int argc, char *argv[])
+{
+    bool names = false;
+    int argi;
+
+    for (argi = 1; argi < argc; argi++) {
+        if (argv[argi]) {
+            names = true;
+            if (strstr(name, argv[argi])) {
+                return true;
+            }
+        }
+    }
+
+    return !names;
+}
+
+/**
+ * @brief Run one benchmark, and print its results
+ * @param bench - the benchmark
+ * @param count - number of operations
+ */
+static void bench_run(const struct bench_case *bench, unsigned long count)
+{
+    unsigned long allocs;
+    unsigned long sum;
+    clock_t start;
+    double seconds;
+
+    allocs = bench_alloc_count();
+    start = clock();
+    sum = bench->function(count);
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    allocs = bench_alloc_count() - allocs;
+    printf("%-24s %10lu ops %12.1f ns/op", bench->name, count,
+        seconds * 1e9 / (double)count);
+    if (bench_alloc_counted()) {
+        printf(" %10.3f allocs/op", (double)allocs / (double)count);
+    } else {
+        printf(" %10s allocs/op", "-");
+    }
+    /* the checksum keeps the work from being optimized away */
+    printf("  [%lx]\n", sum & 0xFFFFUL);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long scale = 1;
+    unsigned long count;
+    unsigned i;
+    int argi;
+
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(argv[0]);
+            print_help();
+            return 0;
+        } else if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", argv[0], BACNET_VERSION_TEXT);
+            return 0;
+        } else if (strcmp(argv[argi], "--list") == 0) {
+            for (i = 0; i < sizeof(Bench_Cases) / sizeof(Bench_Cases[0]);
+                 i++) {
+                printf("%s\n", Bench_Cases[i].name);
+            }
+            return 0;
+        } else if (strcmp(argv[argi], "--scale") == 0) {
+            argv[argi] = NULL;
+            if (++argi < argc) {
+                scale = strtoul(argv[argi], NULL, 0);
+                argv[argi] = NULL;
+            }
+            if (scale == 0) {
+                scale = 1;
+            }
+        }
+    }
+    bench_handlers_init();
+    bench_sys_init();
+    for (i = 0; i < sizeof(Bench_Cases) / sizeof(Bench_Cases[0]); i++) {
+        if (!bench_chosen(Bench_Cases[i].name, argc, argv)) {
+            continue;
+        }
+        count = Bench_Cases[i].count / scale;
+        if (count == 0) {
+            count = 1;
+        }
+        bench_run(&Bench_Cases[i], count);
+    }
+
+    return 0;
+}
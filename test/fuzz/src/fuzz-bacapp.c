@@ -0,0 +1,56 @@
+/**
+ * @file
+ * @brief Fuzz harness of the BACnet application data decoder. The
+ *  first three octets of the input choose the object type and property,
+ *  and the rest is decoded as a list of values of that property.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "fuzz.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    BACNET_APPLICATION_DATA_VALUE value;
+    BACNET_OBJECT_TYPE object_type;
+    BACNET_PROPERTY_ID property;
+    uint8_t *apdu;
+    int apdu_len, len;
+
+    if ((size < 3) || (size > MAX_APDU)) {
+        return 0;
+    }
+    object_type = (BACNET_OBJECT_TYPE)data[0];
+    property = (BACNET_PROPERTY_ID)(((unsigned)data[1] << 8) | data[2]);
+    apdu = (uint8_t *)&data[3];
+    apdu_len = (int)size - 3;
+    /* as known property values */
+    while (apdu_len > 0) {
+        len = bacapp_decode_known_property(
+            apdu, apdu_len, &value, object_type, property);
+        if (len <= 0) {
+            break;
+        }
+        apdu += len;
+        apdu_len -= len;
+    }
+    /* as application tagged values */
+    apdu = (uint8_t *)&data[3];
+    apdu_len = (int)size - 3;
+    while (apdu_len > 0) {
+        len = bacapp_decode_application_data(
+            apdu, (uint32_t)apdu_len, &value);
+        if (len <= 0) {
+            break;
+        }
+        apdu += len;
+        apdu_len -= len;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @brief Fuzz harness of the BACnet/IP BVLL decoders. The input is a
+ *  BVLL message with its header, and is decoded by the function of its
+ *  BVLC message type, as the BBMD handler does.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/bip.h"
+#include "fuzz.h"
+
+/* entries of the tables that are decoded */
+#ifndef FUZZ_BVLC_TABLE_SIZE
+#define FUZZ_BVLC_TABLE_SIZE 16
+#endif
+
+static BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY
+    BDT_Table[FUZZ_BVLC_TABLE_SIZE];
+static BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY FDT_Table[FUZZ_BVLC_TABLE_SIZE];
+static uint8_t NPDU_Buffer[BIP_MPDU_MAX];
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    BACNET_IP_ADDRESS address;
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    uint16_t result_code = 0;
+    uint16_t npdu_len = 0;
+    uint16_t ttl_seconds = 0;
+    uint8_t *pdu;
+    uint16_t pdu_len;
+    int header_len;
+
+    if ((size == 0) || (size > BIP_MPDU_MAX)) {
+        return 0;
+    }
+    header_len = bvlc_decode_header(
+        (uint8_t *)data, (uint16_t)size, &message_type, &message_length);
+    if (header_len != 4) {
+        return 0;
+    }
+    pdu = (uint8_t *)&data[header_len];
+    pdu_len = (uint16_t)size - header_len;
+    switch (message_type) {
+        case BVLC_RESULT:
+            (void)bvlc_decode_result(pdu, pdu_len, &result_code);
+            break;
+        case BVLC_WRITE_BROADCAST_DISTRIBUTION_TABLE:
+            bvlc_broadcast_distribution_table_link_array(
+                BDT_Table, FUZZ_BVLC_TABLE_SIZE);
+            (void)bvlc_decode_write_broadcast_distribution_table(
+                pdu, pdu_len, BDT_Table);
+            break;
+        case BVLC_READ_BROADCAST_DIST_TABLE_ACK:
+            bvlc_broadcast_distribution_table_link_array(
+                BDT_Table, FUZZ_BVLC_TABLE_SIZE);
+            (void)bvlc_decode_read_broadcast_distribution_table_ack(
+                pdu, pdu_len, BDT_Table);
+            break;
+        case BVLC_FORWARDED_NPDU:
+            (void)bvlc_decode_forwarded_npdu(pdu, pdu_len, &address,
+                NPDU_Buffer, sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC_REGISTER_FOREIGN_DEVICE:
+            (void)bvlc_decode_register_foreign_device(
+                pdu, pdu_len, &ttl_seconds);
+            break;
+        case BVLC_READ_FOREIGN_DEVICE_TABLE_ACK:
+            bvlc_foreign_device_table_link_array(
+                FDT_Table, FUZZ_BVLC_TABLE_SIZE);
+            (void)bvlc_decode_read_foreign_device_table_ack(
+                pdu, pdu_len, FDT_Table);
+            break;
+        case BVLC_DELETE_FOREIGN_DEVICE_TABLE_ENTRY:
+            (void)bvlc_decode_delete_foreign_device(pdu, pdu_len, &address);
+            break;
+        case BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK:
+            (void)bvlc_decode_distribute_broadcast_to_network(pdu, pdu_len,
+                NPDU_Buffer, sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC_ORIGINAL_UNICAST_NPDU:
+            (void)bvlc_decode_original_unicast(pdu, pdu_len, NPDU_Buffer,
+                sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC_ORIGINAL_BROADCAST_NPDU:
+            (void)bvlc_decode_original_broadcast(pdu, pdu_len, NPDU_Buffer,
+                sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC_SECURE_BVLL:
+            (void)bvlc_decode_secure_bvll(pdu, pdu_len, NPDU_Buffer,
+                sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        default:
+            break;
+    }
+
+    return 0;
+}
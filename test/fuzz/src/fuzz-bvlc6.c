@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @brief Fuzz harness of the BACnet/IPv6 BVLL decoders. The input is a
+ *  BVLL message with its header, and is decoded by the function of its
+ *  BVLC message type, as the BBMD handler does.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/bip6.h"
+#include "fuzz.h"
+
+static uint8_t NPDU_Buffer[BIP6_MPDU_MAX];
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    BACNET_IP6_ADDRESS address;
+    uint8_t message_type = 0;
+    uint16_t message_length = 0;
+    uint16_t result_code = 0;
+    uint16_t npdu_len = 0;
+    uint16_t ttl_seconds = 0;
+    uint32_t vmac_src = 0;
+    uint32_t vmac_dst = 0;
+    uint8_t *pdu;
+    uint16_t pdu_len;
+    int header_len;
+
+    if ((size == 0) || (size > BIP6_MPDU_MAX)) {
+        return 0;
+    }
+    header_len = bvlc6_decode_header(
+        (uint8_t *)data, (uint16_t)size, &message_type, &message_length);
+    if (header_len != 4) {
+        return 0;
+    }
+    pdu = (uint8_t *)&data[header_len];
+    pdu_len = (uint16_t)size - header_len;
+    switch (message_type) {
+        case BVLC6_RESULT:
+            (void)bvlc6_decode_result(pdu, pdu_len, &vmac_src, &result_code);
+            break;
+        case BVLC6_ORIGINAL_UNICAST_NPDU:
+            (void)bvlc6_decode_original_unicast(pdu, pdu_len, &vmac_src,
+                &vmac_dst, NPDU_Buffer, sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC6_ORIGINAL_BROADCAST_NPDU:
+            (void)bvlc6_decode_original_broadcast(pdu, pdu_len, &vmac_src,
+                NPDU_Buffer, sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC6_ADDRESS_RESOLUTION:
+            (void)bvlc6_decode_address_resolution(
+                pdu, pdu_len, &vmac_src, &vmac_dst);
+            break;
+        case BVLC6_FORWARDED_ADDRESS_RESOLUTION:
+            (void)bvlc6_decode_forwarded_address_resolution(
+                pdu, pdu_len, &vmac_src, &vmac_dst, &address);
+            break;
+        case BVLC6_ADDRESS_RESOLUTION_ACK:
+            (void)bvlc6_decode_address_resolution_ack(
+                pdu, pdu_len, &vmac_src, &vmac_dst);
+            break;
+        case BVLC6_VIRTUAL_ADDRESS_RESOLUTION:
+            (void)bvlc6_decode_virtual_address_resolution(
+                pdu, pdu_len, &vmac_src);
+            break;
+        case BVLC6_VIRTUAL_ADDRESS_RESOLUTION_ACK:
+            (void)bvlc6_decode_virtual_address_resolution_ack(
+                pdu, pdu_len, &vmac_src, &vmac_dst);
+            break;
+        case BVLC6_FORWARDED_NPDU:
+            (void)bvlc6_decode_forwarded_npdu(pdu, pdu_len, &vmac_src,
+                &address, NPDU_Buffer, sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC6_REGISTER_FOREIGN_DEVICE:
+            (void)bvlc6_decode_register_foreign_device(
+                pdu, pdu_len, &vmac_src, &ttl_seconds);
+            break;
+        case BVLC6_DELETE_FOREIGN_DEVICE:
+            (void)bvlc6_decode_delete_foreign_device(
+                pdu, pdu_len, &vmac_src, &address);
+            break;
+        case BVLC6_SECURE_BVLL:
+            (void)bvlc6_decode_secure_bvll(pdu, pdu_len, NPDU_Buffer,
+                sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        case BVLC6_DISTRIBUTE_BROADCAST_TO_NETWORK:
+            (void)bvlc6_decode_distribute_broadcast_to_network(pdu, pdu_len,
+                &vmac_src, NPDU_Buffer, sizeof(NPDU_Buffer), &npdu_len);
+            break;
+        default:
+            break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * @brief Fuzz harness of the COV decoders. The input is decoded as a
+ *  COV notification, a SubscribeCOV request, and a SubscribeCOVProperty
+ *  request.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
+#include "fuzz.h"
+
+/* values of a COV notification that are decoded */
+#ifndef FUZZ_COV_PROPERTIES
+#define FUZZ_COV_PROPERTIES 4
+#endif
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    BACNET_PROPERTY_VALUE property_value[FUZZ_COV_PROPERTIES];
+    BACNET_SUBSCRIBE_COV_DATA subscribe_data;
+    BACNET_COV_DATA cov_data;
+
+    if ((size == 0) || (size > MAX_APDU)) {
+        return 0;
+    }
+    bacapp_property_value_list_init(&property_value[0], FUZZ_COV_PROPERTIES);
+    cov_data.listOfValues = &property_value[0];
+    (void)cov_notify_decode_service_request(
+        (uint8_t *)data, (unsigned)size, &cov_data);
+    (void)cov_subscribe_decode_service_request(
+        (uint8_t *)data, (unsigned)size, &subscribe_data);
+    (void)cov_subscribe_property_decode_service_request(
+        (uint8_t *)data, (unsigned)size, &subscribe_data);
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file
+ * @brief Fuzz harness of the EventNotification decoder
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacstr.h"
+#include "bacnet/event.h"
+#include "fuzz.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    BACNET_EVENT_NOTIFICATION_DATA event_data = { 0 };
+    BACNET_CHARACTER_STRING message_text;
+
+    if ((size == 0) || (size > MAX_APDU)) {
+        return 0;
+    }
+    characterstring_init_ansi(&message_text, "");
+    event_data.messageText = &message_text;
+    (void)event_notify_decode_service_request(
+        (uint8_t *)data, (unsigned)size, &event_data);
+
+    return 0;
+}
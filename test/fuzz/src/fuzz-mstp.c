@@ -0,0 +1,101 @@
+/**
+ * @file
+ * @brief Fuzz harness of the MS/TP receive frame state machine. The
+ *  input is the octets received from the RS-485 line, one octet for
+ *  each run of the state machine, and the line is then silent until
+ *  the frame is aborted.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/mstp.h"
+#include "bacnet/datalink/mstpdef.h"
+#include "fuzz.h"
+
+static uint8_t Input_Buffer[DLMSTP_MPDU_MAX];
+static uint8_t Output_Buffer[DLMSTP_MPDU_MAX];
+/* the RS-485 line silence time in milliseconds */
+static uint32_t Silence_Time;
+
+static uint32_t Timer_Silence(void *pArg)
+{
+    (void)pArg;
+
+    return Silence_Time;
+}
+
+static void Timer_Silence_Reset(void *pArg)
+{
+    (void)pArg;
+    Silence_Time = 0;
+}
+
+/* the MS/TP state machine calls these to put or get data */
+uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
+{
+    return mstp_port->DataLength;
+}
+
+uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    (void)mstp_port;
+    (void)timeout;
+
+    return 0;
+}
+
+uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
+{
+    (void)mstp_port;
+    (void)timeout;
+
+    return 0;
+}
+
+void MSTP_Send_Frame(
+    struct mstp_port_struct_t *mstp_port, uint8_t *buffer, uint16_t nbytes)
+{
+    (void)mstp_port;
+    (void)buffer;
+    (void)nbytes;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    struct mstp_port_struct_t mstp_port;
+    size_t i;
+
+    if (size > (2 * DLMSTP_MPDU_MAX)) {
+        return 0;
+    }
+    memset(&mstp_port, 0, sizeof(mstp_port));
+    mstp_port.InputBuffer = &Input_Buffer[0];
+    mstp_port.InputBufferSize = sizeof(Input_Buffer);
+    mstp_port.OutputBuffer = &Output_Buffer[0];
+    mstp_port.OutputBufferSize = sizeof(Output_Buffer);
+    mstp_port.SilenceTimer = Timer_Silence;
+    mstp_port.SilenceTimerReset = Timer_Silence_Reset;
+    mstp_port.This_Station = 1;
+    mstp_port.Nmax_info_frames = 1;
+    mstp_port.Nmax_master = 127;
+    MSTP_Init(&mstp_port);
+    Silence_Time = 0;
+    for (i = 0; i < size; i++) {
+        mstp_port.DataRegister = data[i];
+        mstp_port.DataAvailable = true;
+        MSTP_Receive_Frame_FSM(&mstp_port);
+        /* the frames are consumed as the node state machine does */
+        mstp_port.ReceivedValidFrame = false;
+        mstp_port.ReceivedInvalidFrame = false;
+    }
+    Silence_Time = mstp_port.Tframe_abort + 1;
+    MSTP_Receive_Frame_FSM(&mstp_port);
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Fuzz harness of the ReadPropertyMultiple decoders. The input is
+ *  decoded both as the service request and as the service ACK.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "fuzz.h"
+
+/**
+ * @brief Decode the value of each property of the ACK
+ * @param device_id - unused
+ * @param rp_data - the property, and its value
+ */
+static void fuzz_rpm_ack_property(
+    uint32_t device_id, BACNET_READ_PROPERTY_DATA *rp_data)
+{
+    BACNET_APPLICATION_DATA_VALUE value;
+    uint8_t *apdu;
+    int apdu_len, len;
+
+    (void)device_id;
+    if (rp_data->error_code != ERROR_CODE_SUCCESS) {
+        return;
+    }
+    apdu = rp_data->application_data;
+    apdu_len = rp_data->application_data_len;
+    while (apdu_len > 0) {
+        len = bacapp_decode_known_property(apdu, apdu_len, &value,
+            rp_data->object_type, rp_data->object_property);
+        if (len <= 0) {
+            break;
+        }
+        apdu += len;
+        apdu_len -= len;
+    }
+}
+
+/**
+ * @brief Decode a ReadPropertyMultiple-Request, as the handler does
+ * @param apdu - the service request
+ * @param apdu_len - number of octets of the service request
+ */
+static void fuzz_rpm_request(uint8_t *apdu, unsigned apdu_len)
+{
+    BACNET_RPM_DATA rpmdata;
+    int len;
+
+    while (apdu_len > 0) {
+        len = rpm_decode_object_id(apdu, apdu_len, &rpmdata);
+        if (len <= 0) {
+            return;
+        }
+        apdu += len;
+        apdu_len -= (unsigned)len;
+        for (;;) {
+            len = rpm_decode_object_end(apdu, apdu_len);
+            if (len > 0) {
+                apdu += len;
+                apdu_len -= (unsigned)len;
+                break;
+            }
+            len = rpm_decode_object_property(apdu, apdu_len, &rpmdata);
+            if (len <= 0) {
+                return;
+            }
+            apdu += len;
+            apdu_len -= (unsigned)len;
+        }
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    if ((size == 0) || (size > MAX_APDU)) {
+        return 0;
+    }
+    fuzz_rpm_request((uint8_t *)data, (unsigned)size);
+    rpm_ack_object_property_process((uint8_t *)data, (unsigned)size, 0,
+        &rp_data, fuzz_rpm_ack_property);
+
+    return 0;
+}
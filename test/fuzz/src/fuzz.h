@@ -0,0 +1,27 @@
+/**
+ * @file
+ * @brief API of the fuzz harnesses of the BACnet stack decoders
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ *
+ * Each harness is one translation unit that feeds an input to one
+ * decoder. It is linked either with libFuzzer, which provides main()
+ * and mutates the inputs, or with replay.c, which runs a corpus of
+ * inputs and times them.
+ */
+#ifndef BACNET_FUZZ_H
+#define BACNET_FUZZ_H
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Decode one input. A harness must not keep a pointer to the input,
+ * and must not write to it.
+ *
+ * @param data [in] the input
+ * @param size [in] number of octets of the input
+ * @return 0, as libFuzzer expects
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+#endif
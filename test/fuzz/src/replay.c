@@ -0,0 +1,321 @@
+/**
+ * @file
+ * @brief Replay a corpus of inputs through a fuzz harness, and time
+ *  them. An input whose decode takes far longer than the median of the
+ *  corpus is reported as slow, and the exit status is then non-zero,
+ *  so that a pathological decode path fails the build before it is
+ *  found by a packet on a network.
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/version.h"
+#include "fuzz.h"
+
+/* an input is run until one batch takes at least this long */
+#ifndef REPLAY_BATCH_CLOCKS
+#define REPLAY_BATCH_CLOCKS (CLOCKS_PER_SEC / 1000)
+#endif
+/* the fastest of this many batches is the time of an input */
+#ifndef REPLAY_BATCHES
+#define REPLAY_BATCHES 3
+#endif
+/* most runs in one batch */
+#ifndef REPLAY_RUNS_MAX
+#define REPLAY_RUNS_MAX (1UL << 20)
+#endif
+
+/* one input of the corpus, and its time */
+struct replay_input {
+    char *path;
+    double ns;
+};
+
+static struct replay_input *Replay_Inputs;
+static size_t Replay_Count;
+static size_t Replay_Size;
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s [--ratio R][--floor NS][--verbose]"
+           "[--version][--help] path...\n",
+        filename);
+}
+
+static void print_help(void)
+{
+    printf("Replay the inputs of a fuzz corpus through the decoder, and\n"
+           "print the time of each decode. The exit status is 1 if an\n"
+           "input is slow, and 2 if there are no inputs.\n"
+           "\n"
+           "path:\n"
+           "A file, or a directory of files, of the corpus.\n"
+           "\n"
+           "--ratio R:\n"
+           "An input is slow when it takes R times longer than the\n"
+           "median input, and longer than the floor. The default is 50.\n"
+           "\n"
+           "--floor NS:\n"
+           "Nanoseconds an input may always take. The default is 10000.\n"
+           "\n"
+           "--verbose:\n"
+           "Print the time of every input, not only of the slow ones.\n");
+}
+
+/**
+ * @brief Add a file to the inputs
+ * @param path - path of the file
+ * @return true if the path was added
+ */
+static bool replay_input_add(const char *path)
+{
+    struct replay_input *inputs;
+    size_t size;
+
+    if (Replay_Count >= Replay_Size) {
+        size = Replay_Size ? Replay_Size * 2 : 64;
+        inputs = realloc(Replay_Inputs, size * sizeof(*inputs));
+        if (!inputs) {
+            return false;
+        }
+        Replay_Inputs = inputs;
+        Replay_Size = size;
+    }
+    Replay_Inputs[Replay_Count].path = malloc(strlen(path) + 1);
+    if (!Replay_Inputs[Replay_Count].path) {
+        return false;
+    }
+    strcpy(Replay_Inputs[Replay_Count].path, path);
+    Replay_Inputs[Replay_Count].ns = 0.0;
+    Replay_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Add a file, or the files of a directory, to the inputs
+ * @param path - path of the file or directory
+ * @return true if the path could be read
+ */
+static bool replay_path_add(const char *path)
+{
+    struct stat path_stat;
+    struct dirent *entry;
+    char *name;
+    DIR *dir;
+    bool status = true;
+
+    if (stat(path, &path_stat) != 0) {
+        return false;
+    }
+    if (!S_ISDIR(path_stat.st_mode)) {
+        return replay_input_add(path);
+    }
+    dir = opendir(path);
+    if (!dir) {
+        return false;
+    }
+    while (status && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        name = malloc(strlen(path) + strlen(entry->d_name) + 2);
+        if (!name) {
+            status = false;
+            break;
+        }
+        sprintf(name, "%s/%s", path, entry->d_name);
+        if ((stat(name, &path_stat) == 0) && S_ISREG(path_stat.st_mode)) {
+            status = replay_input_add(name);
+        }
+        free(name);
+    }
+    closedir(dir);
+
+    return status;
+}
+
+/**
+ * @brief Read a file
+ * @param path - path of the file
+ * @param size - number of octets read
+ * @return the contents of the file, which the caller frees, or NULL
+ */
+static uint8_t *replay_file_read(const char *path, size_t *size)
+{
+    uint8_t *data = NULL;
+    long file_size;
+    FILE *file;
+
+    file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    if ((fseek(file, 0, SEEK_END) == 0) && ((file_size = ftell(file)) >= 0) &&
+        (fseek(file, 0, SEEK_SET) == 0)) {
+        /* the buffer is exactly the size of the input, so that a read
+           past its end is found by a sanitizer */
+        data = malloc(file_size ? (size_t)file_size : 1);
+        if (data &&
+            (fread(data, 1, (size_t)file_size, file) != (size_t)file_size)) {
+            free(data);
+            data = NULL;
+        }
+        *size = (size_t)file_size;
+    }
+    fclose(file);
+
+    return data;
+}
+
+/**
+ * @brief Time the decode of one input
+ * @param data - the input
+ * @param size - number of octets of the input
+ * @return nanoseconds of one decode
+ */
+static double replay_time(const uint8_t *data, size_t size)
+{
+    unsigned long runs = 1, i;
+    clock_t start, elapsed, best = 0;
+    unsigned batch;
+
+    /* find the number of runs in a batch that can be timed */
+    for (;;) {
+        start = clock();
+        for (i = 0; i < runs; i++) {
+            (void)LLVMFuzzerTestOneInput(data, size);
+        }
+        elapsed = clock() - start;
+        if ((elapsed >= REPLAY_BATCH_CLOCKS) || (runs >= REPLAY_RUNS_MAX)) {
+            break;
+        }
+        runs *= 2;
+    }
+    best = elapsed;
+    for (batch = 1; batch < REPLAY_BATCHES; batch++) {
+        start = clock();
+        for (i = 0; i < runs; i++) {
+            (void)LLVMFuzzerTestOneInput(data, size);
+        }
+        elapsed = clock() - start;
+        if (elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    return (double)best * 1e9 / CLOCKS_PER_SEC / (double)runs;
+}
+
+static int replay_path_compare(const void *a, const void *b)
+{
+    const struct replay_input *input_a = a;
+    const struct replay_input *input_b = b;
+
+    return strcmp(input_a->path, input_b->path);
+}
+
+static int replay_ns_compare(const void *a, const void *b)
+{
+    double ns_a = *(const double *)a;
+    double ns_b = *(const double *)b;
+
+    return (ns_a > ns_b) - (ns_a < ns_b);
+}
+
+int main(int argc, char *argv[])
+{
+    double ratio = 50.0, floor_ns = 10000.0;
+    double median, *ns_sorted;
+    bool verbose = false;
+    size_t i, slow = 0, max_index = 0;
+    uint8_t *data;
+    size_t size;
+    int argi;
+
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(argv[0]);
+            print_help();
+            return 0;
+        } else if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", argv[0], BACNET_VERSION_TEXT);
+            return 0;
+        } else if (strcmp(argv[argi], "--verbose") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[argi], "--ratio") == 0) {
+            if (++argi < argc) {
+                ratio = strtod(argv[argi], NULL);
+            }
+        } else if (strcmp(argv[argi], "--floor") == 0) {
+            if (++argi < argc) {
+                floor_ns = strtod(argv[argi], NULL);
+            }
+        } else if (!replay_path_add(argv[argi])) {
+            fprintf(stderr, "%s: unable to read %s\n", argv[0], argv[argi]);
+            return 2;
+        }
+    }
+    if (Replay_Count == 0) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    /* the inputs of a directory are reported in the order of their names */
+    qsort(Replay_Inputs, Replay_Count, sizeof(Replay_Inputs[0]),
+        replay_path_compare);
+    for (i = 0; i < Replay_Count; i++) {
+        data = replay_file_read(Replay_Inputs[i].path, &size);
+        if (!data) {
+            fprintf(stderr, "%s: unable to read %s\n", argv[0],
+                Replay_Inputs[i].path);
+            return 2;
+        }
+        Replay_Inputs[i].ns = replay_time(data, size);
+        free(data);
+        if (Replay_Inputs[i].ns > Replay_Inputs[max_index].ns) {
+            max_index = i;
+        }
+    }
+    ns_sorted = malloc(Replay_Count * sizeof(double));
+    if (!ns_sorted) {
+        return 2;
+    }
+    for (i = 0; i < Replay_Count; i++) {
+        ns_sorted[i] = Replay_Inputs[i].ns;
+    }
+    qsort(ns_sorted, Replay_Count, sizeof(double), replay_ns_compare);
+    median = ns_sorted[Replay_Count / 2];
+    free(ns_sorted);
+    for (i = 0; i < Replay_Count; i++) {
+        if ((Replay_Inputs[i].ns > floor_ns) &&
+            (Replay_Inputs[i].ns > (median * ratio))) {
+            slow++;
+            printf("SLOW %12.1f ns/op %10.1fx median  %s\n",
+                Replay_Inputs[i].ns, Replay_Inputs[i].ns / median,
+                Replay_Inputs[i].path);
+        } else if (verbose) {
+            printf("     %12.1f ns/op %10.1fx median  %s\n",
+                Replay_Inputs[i].ns, Replay_Inputs[i].ns / median,
+                Replay_Inputs[i].path);
+        }
+    }
+    printf("%lu inputs: median %.1f ns/op, max %.1f ns/op (%s), %lu slow\n",
+        (unsigned long)Replay_Count, median, Replay_Inputs[max_index].ns,
+        Replay_Inputs[max_index].path, (unsigned long)slow);
+    for (i = 0; i < Replay_Count; i++) {
+        free(Replay_Inputs[i].path);
+    }
+    free(Replay_Inputs);
+
+    return slow ? 1 : 0;
+}
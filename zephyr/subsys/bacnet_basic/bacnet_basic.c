@@ -28,6 +28,16 @@
 /* me */
 #include "bacnet_basic/bacnet_basic.h"
 
+/* milliseconds to wait in the datalink for a packet, when the network
+   stack wakes the thread waiting there instead of the thread polling */
+#ifndef BACNET_BASIC_RECEIVE_TIMEOUT
+#if defined(CONFIG_BACDL_BIP_NET_CONTEXT)
+#define BACNET_BASIC_RECEIVE_TIMEOUT 10
+#else
+#define BACNET_BASIC_RECEIVE_TIMEOUT 0
+#endif
+#endif
+
 /* 1s timer for basic non-critical timed tasks */
 static struct mstimer BACnet_Task_Timer;
 /* task timer for object functionality */
@@ -128,6 +138,8 @@ void bacnet_basic_init(void)
         SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, handler_write_property_multiple);
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY,
+        handler_cov_subscribe_property);
     /* handle communication so we can shutup when asked, or restart */
     apdu_set_confirmed_handler(SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL,
         handler_device_communication_control);
@@ -185,7 +197,8 @@ void bacnet_basic_task(void)
         Device_Timer(elapsed_milliseconds);
     }
     /* handle the messaging */
-    pdu_len = datalink_receive(&src, &PDUBuffer[0], sizeof(PDUBuffer), 0);
+    pdu_len = datalink_receive(&src, &PDUBuffer[0], sizeof(PDUBuffer),
+        BACNET_BASIC_RECEIVE_TIMEOUT);
     if (pdu_len) {
         npdu_handler(&src, &PDUBuffer[0], pdu_len);
         BACnet_Packet_Count++;
@@ -66,7 +66,9 @@ static void server_thread(void)
     }
     LOG_INF("BACnet Server: initialized");
     for (;;) {
+#if !defined(CONFIG_BACDL_BIP_NET_CONTEXT)
         k_sleep(K_MSEC(10));
+#endif
         bacnet_basic_task();
         bacnet_port_task();
     }